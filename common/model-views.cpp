@@ -185,101 +185,37 @@ namespace rs2
         return (int)(floor(scale));
     }
 
-    std::tuple<uint8_t, uint8_t, uint8_t> get_texcolor(video_frame texture, texture_coordinate texcoords)
-    {
-        const int w = texture.get_width(), h = texture.get_height();
-        int x = std::min(std::max(int(texcoords.u*w + .5f), 0), w - 1);
-        int y = std::min(std::max(int(texcoords.v*h + .5f), 0), h - 1);
-        int idx = x*texture.get_bytes_per_pixel() + y*texture.get_stride_in_bytes();
-        const auto texture_data = reinterpret_cast<const uint8_t*>(texture.get_data());
-        return std::tuple<uint8_t, uint8_t, uint8_t>(
-            texture_data[idx], texture_data[idx + 1], texture_data[idx + 2]);
-    }
-
     void export_to_ply(const std::string& fname, notifications_model& ns, frameset frames, video_frame texture)
     {
-        std::thread([&ns, frames, texture, fname]() mutable {
-            std::string texfname(fname);
-            texfname += ".png";
-
-            points p;
-
-            for (auto&& f : frames)
+        points p;
+        for (auto&& f : frames)
+        {
+            if (p = f.as<points>())
             {
-                if (p = f.as<points>())
-                {
-                    break;
-                }
+                break;
             }
+        }
+        export_to_ply(fname, ns, p, texture);
+    }
 
+    void export_to_ply(const std::string& fname, notifications_model& ns, points p, video_frame texture)
+    {
+        std::thread([&ns, p, texture, fname]() mutable {
             if (p)
             {
-                const auto vertices = p.get_vertices();
-                const auto texcoords = p.get_texture_coordinates();
-                const auto tex = reinterpret_cast<const uint8_t*>(texture.get_data());
-                std::vector<vertex> new_vertices;
-                //std::vector<texture_coordinate> new_texcoords;
-                std::vector<std::tuple<uint8_t, uint8_t, uint8_t>> new_tex;
-                new_vertices.reserve(p.size());
-                //new_texcoords.reserve(points.size());
-                new_tex.reserve(p.size());
-                assert(p.size());
-                for (size_t i = 0; i < p.size(); ++i)
-                    if (std::abs(vertices[i].x) >= 1e-6 || std::abs(vertices[i].y) >= 1e-6 || std::abs(vertices[i].z) >= 1e-6)
-                    {
-                        new_vertices.push_back(vertices[i]);
-                        if (texture)
-                        {
-                            //new_texcoords.push_back(texcoords[i]);
-                            auto color = get_texcolor(texture, texcoords[i]);
-                            new_tex.push_back(color);
-                        }
-
-                    }
-
-                std::ofstream out(fname);
-                out << "ply\n";
-                out << "format binary_little_endian 1.0\n" /*"format ascii 1.0\n"*/;
-                out << "comment pointcloud saved from Realsense Viewer\n";
-                //if (texture) out << "comment TextureFile " << get_file_name(texfname) << "\n";
-                out << "element vertex " << new_vertices.size() << "\n";
-                out << "property float" << sizeof(float) * 8 << " x\n";
-                out << "property float" << sizeof(float) * 8 << " y\n";
-                out << "property float" << sizeof(float) * 8 << " z\n";
-                if (texture)
+                try
                 {
-                    //out << "property float" << sizeof(float) * 8 << " u\n";
-                    //out << "property float" << sizeof(float) * 8 << " v\n";
-                    out << "property uchar red\n";
-                    out << "property uchar green\n";
-                    out << "property uchar blue\n";
+                    p.export_to_ply(fname, texture);
                 }
-                out << "end_header\n";
-                out.close();
-
-                out.open(fname, std::ios_base::app | std::ios_base::binary);
-                for (int i = 0; i < new_vertices.size(); ++i)
+                catch (const error& e)
                 {
-                    // we assume little endian architecture on your device
-                    out.write(reinterpret_cast<const char*>(&(new_vertices[i].x)), sizeof(float));
-                    out.write(reinterpret_cast<const char*>(&(new_vertices[i].y)), sizeof(float));
-                    out.write(reinterpret_cast<const char*>(&(new_vertices[i].z)), sizeof(float));
-                    //                out << new_vertices[i].x << ' ' << new_vertices[i].y << ' ' << new_vertices[i].z;
-                    if (texture)
-                    {
-                        //out.write(reinterpret_cast<const char*>(&(new_texcoords[i].u)), sizeof(float));
-                        //out.write(reinterpret_cast<const char*>(&(new_texcoords[i].v)), sizeof(float));
-                        out.write(reinterpret_cast<const char*>(&(std::get<0>(new_tex[i]))), sizeof(uint8_t));
-                        out.write(reinterpret_cast<const char*>(&(std::get<1>(new_tex[i]))), sizeof(uint8_t));
-                        out.write(reinterpret_cast<const char*>(&(std::get<2>(new_tex[i]))), sizeof(uint8_t));
-                        //                    out << std::hex << ' ' << std::get<0>(new_tex[i]) << ' ' << std::get<1>(new_tex[i]) << ' ' << std::get<2>(new_tex[i]);
-                    }
-                    //                out << '\n';
+                    ns.add_notification({ to_string() << "Failed to save 3D view to " << fname << ": " << error_to_string(e),
+                        std::chrono::duration_cast<std::chrono::duration<double,std::micro>>(std::chrono::high_resolution_clock::now().time_since_epoch()).count(),
+                        RS2_LOG_SEVERITY_ERROR,
+                        RS2_NOTIFICATION_CATEGORY_UNKNOWN_ERROR });
+                    return;
                 }
 
-                /* save texture to texfname */
-                //if (texture) stbi_write_png(texfname.data(), texture.get_width(), texture.get_height(), texture.get_bytes_per_pixel(), texture.get_data(), texture.get_width() * texture.get_bytes_per_pixel());
-
                 ns.add_notification({ to_string() << "Finished saving 3D view " << (texture ? "to " : "without texture to ") << fname,
                     std::chrono::duration_cast<std::chrono::duration<double,std::micro>>(std::chrono::high_resolution_clock::now().time_since_epoch()).count(),
                     RS2_LOG_SEVERITY_INFO,
@@ -651,6 +587,8 @@ namespace rs2
         {
             if (s->supports(RS2_OPTION_DEPTH_UNITS))
                 depth_units = s->get_option(RS2_OPTION_DEPTH_UNITS);
+            else if (s->is<depth_sensor>())
+                depth_units = s->as<depth_sensor>().get_depth_scale();
         }
         catch (...)
         {
@@ -662,6 +600,9 @@ namespace rs2
             auto colorizer = std::make_shared<processing_block_model>(
                 this, "Depth Visualization", depth_colorizer, 
                 [=](rs2::frame f) { return depth_colorizer->colorize(f); }, error_message);
+            colorizer->gpu_capable = true;
+            colorizer->use_gpu = true;
+            depth_visualization = colorizer;
             const_effects.push_back(colorizer);
 
             auto decimate = std::make_shared<rs2::decimation_filter>();
@@ -1300,6 +1241,8 @@ namespace rs2
                 frame_md.md_attributes[i].first = false;
         }
 
+        if (dev && dev->depth_visualization)
+            texture->gpu_colorize = dev->depth_visualization->use_gpu;
         texture->upload(f);
         return texture.get();
     }
@@ -1547,7 +1490,7 @@ namespace rs2
 
 
         const auto top_bar_height = 32.f;
-        const auto num_of_buttons = 4;
+        const auto num_of_buttons = depth_points_shader::get() ? 5 : 4;
 
         auto flags = ImGuiWindowFlags_NoResize |
             ImGuiWindowFlags_NoMove |
@@ -1764,7 +1707,14 @@ namespace rs2
 
                 std::string fname(ret);
                 if (!ends_with(to_lower(fname), ".ply")) fname += ".ply";
-                export_to_ply(fname.c_str(), not_model, model, tex);
+                if (gpu_pointcloud && last_depth)
+                {
+                    // The shown points only exist on the GPU, so the pointcloud block computes them for the file
+                    pointcloud pc;
+                    if (tex) pc.map_to(tex);
+                    export_to_ply(fname, not_model, pc.calculate(last_depth), tex);
+                }
+                else export_to_ply(fname.c_str(), not_model, model, tex);
             }
         }
         if (ImGui::IsItemHovered())
@@ -1781,6 +1731,32 @@ namespace rs2
 
         ImGui::SameLine();
 
+        if (depth_points_shader::get())
+        {
+            if (gpu_pointcloud)
+            {
+                ImGui::PushStyleColor(ImGuiCol_Text, light_blue);
+                ImGui::PushStyleColor(ImGuiCol_TextSelectedBg, light_blue);
+                if (ImGui::Button(u8"\uf1b2##GPU pointcloud", { 24, top_bar_height }))
+                {
+                    gpu_pointcloud = false;
+                }
+                if (ImGui::IsItemHovered())
+                    ImGui::SetTooltip("Calculate the pointcloud on the CPU");
+                ImGui::PopStyleColor(2);
+            }
+            else
+            {
+                if (ImGui::Button(u8"\uf1b2##GPU pointcloud", { 24, top_bar_height }))
+                {
+                    gpu_pointcloud = true;
+                }
+                if (ImGui::IsItemHovered())
+                    ImGui::SetTooltip("Calculate the pointcloud on the GPU, keeping the points in GPU memory");
+            }
+            ImGui::SameLine();
+        }
+
         if (support_non_syncronized_mode)
         {
             if (synchronization_enable)
@@ -1993,7 +1969,7 @@ namespace rs2
                 auto frame = texture->get_last_frame(true).as<video_frame>();
                 if (frame)
                 {
-                    save_to_png(filename.data(), frame.get_width(), frame.get_height(), frame.get_bytes_per_pixel(), frame.get_data(), frame.get_width() * frame.get_bytes_per_pixel());
+                    viewer.snapshots.save(frame, filename);
 
                     viewer.not_model.add_notification({ to_string() << "Snapshot was saved to " << filename,
                         0, RS2_LOG_SEVERITY_INFO,
@@ -2114,8 +2090,20 @@ namespace rs2
             ImGui::PushStyleColor(ImGuiCol_ButtonHovered, header_window_bg);
             ImGui::PushStyleColor(ImGuiCol_ButtonActive, header_window_bg);
             ImGui::PushStyleColor(ImGuiCol_WindowBg, from_rgba(9, 11, 13, 100));
+
+            // Frames of the stream still held, listed when the library tracks frames (LRS_FRAME_TRACKING)
+            int held_frames = 0, capacity = 0;
+            double oldest = 0;
+            for (auto&& f : rs2::query_outstanding_frames())
+            {
+                if (f.stream != profile.stream_type() || f.index != profile.stream_index()) continue;
+                held_frames++;
+                capacity = std::max(capacity, f.archive_capacity);
+                oldest = std::max(oldest, f.age);
+            }
+
             ImGui::SetNextWindowPos({ stream_rect.x + stream_rect.w - 275, stream_rect.y + 5 });
-            ImGui::SetNextWindowSize({ 270, 45 });
+            ImGui::SetNextWindowSize({ 270, held_frames ? 62.f : 45.f });
             std::string label = to_string() << "Stream Info of " << profile.unique_id();
             ImGui::Begin(label.c_str(), nullptr, flags);
 
@@ -2165,6 +2153,17 @@ namespace rs2
 
             ImGui::Columns(1);
 
+            if (held_frames)
+            {
+                label = to_string() << "Held frames: " << held_frames << "/" << capacity
+                    << ", oldest " << std::fixed << std::setprecision(0) << oldest << "ms";
+                ImGui::Text("%s", label.c_str());
+                if (ImGui::IsItemHovered())
+                {
+                    ImGui::SetTooltip("Frames of the stream not yet released by the application or processing, out of the frames queue size");
+                }
+            }
+
             ImGui::End();
             ImGui::PopStyleColor(6);
             ImGui::PopStyleVar(2);
@@ -2698,7 +2697,7 @@ namespace rs2
         return f;
     }
 
-    std::vector<rs2::frame> post_processing_filters::handle_frame(rs2::frame f)
+    std::vector<rs2::frame> post_processing_filters::handle_frame(rs2::frame f, pointcloud& pc)
     {
         std::vector<rs2::frame> res;
         auto filtered = apply_filters(f);
@@ -2708,22 +2707,28 @@ namespace rs2
         auto new_uid = filtered.get_profile().unique_id();
         viewer.streams_origin[new_uid] = uid;
 
+        // Colorize depth here rather than on the render thread
+        auto stream = viewer.streams.find(uid);
+        if (stream != viewer.streams.end() && stream->second.texture)
+            stream->second.texture->prepare(filtered);
+
         if(viewer.is_3d_view)
         {
-            if(viewer.is_3d_depth_source(f))
+            // Depth the viewer deprojects on the GPU reaches it as it is, rather than as points
+            if(viewer.is_3d_depth_source(f) && !(viewer.gpu_pointcloud && depth_points_shader::can_draw(filtered)))
             {
                 res.push_back(pc.calculate(filtered));
             }
             if(viewer.is_3d_texture_source(f))
             {
-                update_texture(filtered);
+                pc.map_to(filtered);
             }
         }
 
         return res;
     }
 
-    void post_processing_filters::proccess(rs2::frame f, const rs2::frame_source& source)
+    void post_processing_filters::proccess(rs2::frame f, const rs2::frame_source& source, pointcloud& pc)
     {
         points p;
         std::vector<frame> results;
@@ -2733,14 +2738,14 @@ namespace rs2
         {
             for (auto&& f : composite)
             {
-                auto res = handle_frame(f);
+                auto res = handle_frame(f, pc);
                 results.insert(results.end(), res.begin(), res.end());
             }
 
         }
         else
         {
-             auto res = handle_frame(f);
+             auto res = handle_frame(f, pc);
              results.insert(results.end(), res.begin(), res.end());
         }
 
@@ -2749,17 +2754,91 @@ namespace rs2
     }
 
 
+    post_processing_filters::device_worker::device_worker(post_processing_filters& owner)
+        : processing_block([this, &owner](rs2::frame f, const rs2::frame_source& source)
+          {
+              owner.proccess(std::move(f), source, pc);
+          }),
+          running(true)
+    {
+        processing_block.start(owner.resulting_queue);
+        thread = std::thread([this]()
+        {
+            while (true)
+            {
+                std::map<int, rs2::frame> frames;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    cv.wait(lock, [this]() { return !pending.empty() || !running; });
+                    if (!running) return;
+                    std::swap(frames, pending);
+                }
+
+                for (auto&& f : frames)
+                {
+                    try
+                    {
+                        processing_block.invoke(f.second);
+                    }
+                    catch (...) {}
+                }
+            }
+        });
+    }
+
+    void post_processing_filters::device_worker::post(rs2::frame f, int uid)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pending[uid] = std::move(f);
+        }
+        cv.notify_one();
+    }
+
+    void post_processing_filters::device_worker::stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            running = false;
+            pending.clear();
+        }
+        cv.notify_one();
+        thread.join();
+    }
+
+    const rs2_device* post_processing_filters::find_device(rs2::frame f) const
+    {
+        auto uid = f.get_profile().unique_id();
+        auto stream = viewer.streams.find(uid);
+        if (stream == viewer.streams.end() || !stream->second.dev) return nullptr;
+        return stream->second.dev->dev.get().get();
+    }
+
+    // Routes the frames to the worker of their device, the framesets of the syncer by their first frame
     void post_processing_filters::render_loop()
     {
         while (keep_calculating)
         {
-
             try
             {
                 frame frm;
                 if (frames_queue.poll_for_frame(&frm))
                 {
-                    processing_block.invoke(frm);
+                    frame first = frm;
+                    if (auto composite = frm.as<rs2::frameset>())
+                    {
+                        if (!composite.size()) continue;
+                        first = composite[0];
+                    }
+
+                    device_worker* worker;
+                    {
+                        std::lock_guard<std::mutex> lock(workers_mutex);
+                        auto&& w = workers[find_device(first)];
+                        if (!w) w.reset(new device_worker(*this));
+                        worker = w.get();
+                    }
+                    worker->post(std::move(frm), first.get_profile().unique_id());
                 }
                 else
                 {
@@ -2767,7 +2846,6 @@ namespace rs2
                 }
             }
             catch (...) {}
-
         }
     }
 
@@ -2907,6 +2985,7 @@ namespace rs2
     {
         texture_buffer* texture_frame = nullptr;
         points p;
+        depth_frame depth{ frame() };
         frame f{}, res{};
         try
         {
@@ -2929,6 +3008,9 @@ namespace rs2
                         if (frame.is<depth_frame>() && !paused)
                             res = frame;
 
+                        if (gpu_pointcloud && is_3d_view && is_3d_depth_source(frame) && depth_points_shader::can_draw(frame))
+                            depth = frame;
+
                         auto texture = upload_frame(std::move(frame));
 
                         if ((selected_tex_source_uid == -1 && frame.get_profile().format() == RS2_FORMAT_Z16) || frame.get_profile().format()!= RS2_FORMAT_ANY && is_3d_texture_source(frame))
@@ -2956,7 +3038,7 @@ namespace rs2
 
         window.begin_viewport();
 
-        draw_viewport(viewer_rect, window, devices, error_message, texture_frame, p);
+        draw_viewport(viewer_rect, window, devices, error_message, texture_frame, p, depth);
 
         not_model.draw(window.get_font(), window.width(), window.height());
 
@@ -3067,13 +3149,19 @@ namespace rs2
         }
     }
 
-    void viewer_model::render_3d_view(const rect& viewer_rect, texture_buffer* texture, rs2::points points)
+    void viewer_model::render_3d_view(const rect& viewer_rect, texture_buffer* texture, rs2::points points, rs2::depth_frame depth)
     {
         if(!paused)
         {
             if(points)
             {
                 last_points = points;
+                last_depth = rs2::frame();
+            }
+            else if(depth)
+            {
+                last_depth = depth;
+                last_points = rs2::points();
             }
             if(texture)
             {
@@ -3142,13 +3230,16 @@ namespace rs2
 
         glColor4f(1.f, 1.f, 1.f, 1.f);
 
+        rs2::stream_profile points_profile;
+        if (last_points) points_profile = last_points.get_profile();
+        else if (last_depth) points_profile = last_depth.get_profile();
 
-        if (draw_frustrum && last_points)
+        if (draw_frustrum && points_profile)
         {
             glLineWidth(1.f);
             glBegin(GL_LINES);
 
-            auto intrin = last_points.get_profile().as<video_stream_profile>().get_intrinsics();
+            auto intrin = points_profile.as<video_stream_profile>().get_intrinsics();
 
             glColor4f(sensor_bg.x, sensor_bg.y, sensor_bg.z, 0.5f);
 
@@ -3180,13 +3271,17 @@ namespace rs2
             glColor4f(1.f, 1.f, 1.f, 1.f);
         }
 
-        if (last_points)
+        if (points_profile)
         {
             // Non-linear correspondence customized for non-flat surface exploration
-            glPointSize(std::sqrt(viewer_rect.w / last_points.get_profile().as<video_stream_profile>().width()));
+            glPointSize(std::sqrt(viewer_rect.w / points_profile.as<video_stream_profile>().width()));
 
+            rs2::stream_profile texture_profile;
             if (selected_tex_source_uid >= 0)
             {
+                if (auto tex_frame = last_texture->get_last_frame())
+                    texture_profile = tex_frame.get_profile();
+
                 auto tex = last_texture->get_gl_handle();
                 glBindTexture(GL_TEXTURE_2D, tex);
                 glEnable(GL_TEXTURE_2D);
@@ -3197,21 +3292,18 @@ namespace rs2
 
             //glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, tex_border_color);
 
-            glBegin(GL_POINTS);
-
-            auto vertices = last_points.get_vertices();
-            auto tex_coords = last_points.get_texture_coordinates();
-
-            for (int i = 0; i < last_points.size(); i++)
+            if (last_points)
             {
-                if (vertices[i].z)
-                {
-                    glVertex3fv(vertices[i]);
-                    glTexCoord2fv(tex_coords[i]);
-                }
-
+                points_renderer.draw(last_points);
+            }
+            else if (auto shader = depth_points_shader::get())
+            {
+                auto depth_units = 1.f;
+                auto source = streams.find(selected_depth_source_uid);
+                if (source != streams.end() && source->second.dev)
+                    depth_units = source->second.dev->depth_units;
+                shader->draw(last_depth, depth_units, texture_profile);
             }
-            glEnd();
 
 
         }
@@ -3629,12 +3721,15 @@ namespace rs2
         rs2_playback_status current_playback_status = p.current_status();
         int64_t playback_total_duration = p.get_duration().count();
         auto progress = p.get_position();
-        double part = (1.0 * progress) / playback_total_duration;
-        seek_pos = static_cast<int>(std::max(0.0, std::min(part, 1.0)) * 100);
-
-        if (seek_pos != 0 && p.current_status() == RS2_PLAYBACK_STATUS_STOPPED)
+        if (!_seek_pending)
         {
-            seek_pos = 0;
+            double part = (1.0 * progress) / playback_total_duration;
+            seek_pos = static_cast<int>(std::max(0.0, std::min(part, 1.0)) * 100);
+
+            if (seek_pos != 0 && p.current_status() == RS2_PLAYBACK_STATUS_STOPPED)
+            {
+                seek_pos = 0;
+            }
         }
         float seek_bar_width = 290.0f;
         ImGui::PushItemWidth(seek_bar_width);
@@ -3645,7 +3740,20 @@ namespace rs2
             auto duration_db = std::chrono::duration_cast<std::chrono::duration<double, std::nano>>(p.get_duration());
             auto single_percent = duration_db.count() / 100;
             auto seek_time = std::chrono::duration<double, std::nano>(seek_pos * single_percent);
-            p.seek(std::chrono::duration_cast<std::chrono::nanoseconds>(seek_time));
+            _seek_target = std::chrono::duration_cast<std::chrono::nanoseconds>(seek_time);
+            _seek_pending = true;
+        }
+        if (_seek_pending)
+        {
+            if (ImGui::IsItemActive())
+            {
+                draw_seek_thumbnail(p, _seek_target);
+            }
+            else
+            {
+                p.seek(_seek_target);
+                _seek_pending = false;
+            }
         }
 
         ImGui::SetCursorPos({ pos.x, pos.y + 17 });
@@ -3662,6 +3770,61 @@ namespace rs2
         return 50;
     }
 
+    void device_model::draw_seek_thumbnail(playback& p, std::chrono::nanoseconds time)
+    {
+        if (time != _thumbnail_time)
+        {
+            _thumbnail_time = time;
+            _thumbnail_width = 0;
+            for (auto&& sub : subdevices)
+            {
+                if (!sub->streaming) continue;
+                for (auto&& profile : sub->get_selected_profiles())
+                {
+                    int width = 0, height = 0;
+                    rs2_format format = RS2_FORMAT_ANY;
+                    try
+                    {
+                        if (!p.get_thumbnail(profile, time, _thumbnail_data, width, height, format)) continue;
+                    }
+                    catch (...)
+                    {
+                        continue;
+                    }
+
+                    // Only thumbnails that show as they are, depth would need colorizing
+                    int channels = format == RS2_FORMAT_Y8 ? 1 : format == RS2_FORMAT_RGB8 || format == RS2_FORMAT_BGR8 ? 3 :
+                                   format == RS2_FORMAT_RGBA8 || format == RS2_FORMAT_BGRA8 ? 4 : 0;
+                    if (!channels || _thumbnail_data.size() < size_t(width * height * channels)) continue;
+
+                    bool swap = format == RS2_FORMAT_BGR8 || format == RS2_FORMAT_BGRA8;
+                    _thumbnail_rgba.resize(width * height * 4);
+                    for (int i = 0; i < width * height; i++)
+                    {
+                        auto in = _thumbnail_data.data() + i * channels;
+                        auto out = _thumbnail_rgba.data() + i * 4;
+                        out[0] = channels == 1 ? in[0] : in[swap ? 2 : 0];
+                        out[1] = channels == 1 ? in[0] : in[1];
+                        out[2] = channels == 1 ? in[0] : in[swap ? 0 : 2];
+                        out[3] = 255;
+                    }
+                    if (!_thumbnail_texture) _thumbnail_texture.reset(new texture_buffer());
+                    _thumbnail_texture->upload_image(width, height, _thumbnail_rgba.data());
+                    _thumbnail_width = width;
+                    _thumbnail_height = height;
+                    break;
+                }
+                if (_thumbnail_width) break;
+            }
+        }
+
+        if (!_thumbnail_width) return;
+        ImGui::BeginTooltip();
+        ImGui::Image((ImTextureID)(intptr_t)_thumbnail_texture->get_gl_handle(), ImVec2(float(_thumbnail_width), float(_thumbnail_height)));
+        ImGui::Text("%s", pretty_time(time).c_str());
+        ImGui::EndTooltip();
+    }
+
     int device_model::draw_playback_panel(ImFont* font, viewer_model& view)
     {
         ImGui::PushStyleColor(ImGuiCol_Button, sensor_bg);
@@ -4282,6 +4445,14 @@ namespace rs2
                     label = to_string() << pb->get_name() << "##" << id;
                     if (ImGui::TreeNode(label.c_str()))
                     {
+                        if (pb->gpu_capable && depth_shader::get())
+                        {
+                            label = to_string() << "Run on GPU##" << pb->get_name() << id;
+                            ImGui::Checkbox(label.c_str(), &pb->use_gpu);
+                            if (ImGui::IsItemHovered())
+                                ImGui::SetTooltip("Run the block in a shader while rendering, its output is only computed on the CPU when asked for");
+                        }
+
                         for (auto i = 0; i < RS2_OPTION_COUNT; i++)
                         {
                             auto opt = static_cast<rs2_option>(i);
@@ -4481,7 +4652,7 @@ namespace rs2
         ImGui::PopFont();
     }
 
-    void viewer_model::draw_viewport(const rect& viewer_rect, ux_window& window, int devices, std::string& error_message, texture_buffer* texture, points points)
+    void viewer_model::draw_viewport(const rect& viewer_rect, ux_window& window, int devices, std::string& error_message, texture_buffer* texture, points points, depth_frame depth)
     {
         if (!is_3d_view)
         {
@@ -4502,7 +4673,7 @@ namespace rs2
             rect fb_size{ 0, 0, (float)window.framebuf_width(), (float)window.framebuf_height() };
             rect new_rect = viewer_rect.normalize(window_size).unnormalize(fb_size);
 
-            render_3d_view(new_rect, texture, points);
+            render_3d_view(new_rect, texture, points, depth);
         }
 
         if (ImGui::IsKeyPressed(' '))
@@ -16,6 +16,8 @@
 #include <set>
 #include <array>
 #include <unordered_map>
+#include <condition_variable>
+#include <thread>
 
 #include "imgui-fonts-karla.hpp"
 #include "imgui-fonts-fontawesome.hpp"
@@ -187,6 +189,8 @@ namespace rs2
         rs2::frame invoke(rs2::frame f) const { return _invoker(f); }
 
         bool enabled = false;
+        bool gpu_capable = false;   // The viewer can run the block in a shader when it renders the result
+        bool use_gpu = false;
     private:
         std::shared_ptr<options> _block;
         std::map<int, option_model> options_metadata;
@@ -296,6 +300,7 @@ namespace rs2
         bool show_algo_roi = false;
 
         std::shared_ptr<rs2::colorizer> depth_colorizer;
+        std::shared_ptr<processing_block_model> depth_visualization;
         std::shared_ptr<processing_block_model> decimation_filter;
         std::shared_ptr<processing_block_model> spatial_filter;
         std::shared_ptr<processing_block_model> temporal_filter;
@@ -406,12 +411,23 @@ namespace rs2
         std::vector<std::string> restarting_device_info;
     private:
         int draw_seek_bar();
+        void draw_seek_thumbnail(playback& p, std::chrono::nanoseconds time);
         int draw_playback_controls(ImFont* font, viewer_model& view);
         advanced_mode_control amc;
         std::string pretty_time(std::chrono::nanoseconds duration);
 
         void play_defaults(viewer_model& view);
 
+        // While the seek bar is dragged only thumbnails are shown, the frames are read once it is let go
+        bool _seek_pending = false;
+        std::chrono::nanoseconds _seek_target{ 0 };
+        std::chrono::nanoseconds _thumbnail_time{ -1 };
+        std::vector<uint8_t> _thumbnail_data;
+        std::vector<uint8_t> _thumbnail_rgba;
+        int _thumbnail_width = 0;
+        int _thumbnail_height = 0;
+        std::unique_ptr<texture_buffer> _thumbnail_texture;
+
         std::shared_ptr<recorder> _recorder;
         std::vector<std::shared_ptr<subdevice_model>> live_subdevices;
     };
@@ -485,27 +501,29 @@ namespace rs2
     std::string get_file_name(const std::string& path);
 
     class viewer_model;
+    // Processes the frames of every device on a worker thread of its own, so that the devices do not wait for one
+    // another. A worker busy with a frame keeps only the newest frame of each stream that arrives meanwhile, the
+    // renderer shows the latest frames only, so the latency stays bounded whatever the number of cameras
     class post_processing_filters
     {
     public:
         post_processing_filters(viewer_model& viewer)
-            : processing_block([&](rs2::frame f, const rs2::frame_source& source)
-            {
-                proccess(std::move(f),source);
-            }),
-            viewer(viewer),
+            : viewer(viewer),
             keep_calculating(true),
             depth_stream_active(false),
             resulting_queue(3),
             frames_queue(4),
             t([this]() {render_loop(); })
         {
-            processing_block.start(resulting_queue);
         }
 
         ~post_processing_filters() { stop(); }
 
-        void update_texture(frame f) { pc.map_to(f); }
+        void update_texture(frame f)
+        {
+            std::lock_guard<std::mutex> lock(workers_mutex);
+            for (auto&& w : workers) w.second->pc.map_to(f);
+        }
 
         void stop()
         {
@@ -513,6 +531,10 @@ namespace rs2
             {
                 keep_calculating = false;
                 t.join();
+
+                std::lock_guard<std::mutex> lock(workers_mutex);
+                for (auto&& w : workers) w.second->stop();
+                workers.clear();
             }
         }
 
@@ -540,16 +562,34 @@ namespace rs2
         frame_queue resulting_queue;
 
     private:
+        // Processing of the frames of one device, with the newest frame of each of its streams waiting for it
+        struct device_worker
+        {
+            device_worker(post_processing_filters& owner);
+
+            void post(rs2::frame f, int uid);
+            void stop();
+
+            rs2::processing_block processing_block;
+            pointcloud pc;
+            std::mutex mutex;
+            std::condition_variable cv;
+            std::map<int, rs2::frame> pending; // By stream, older frames are replaced, as they would never be shown
+            bool running;
+            std::thread thread;
+        };
+
         viewer_model& viewer;
 
         void render_loop();
-        void proccess(rs2::frame f, const rs2::frame_source& source);
-        std::vector<rs2::frame> handle_frame(rs2::frame f);
+        void proccess(rs2::frame f, const rs2::frame_source& source, pointcloud& pc);
+        std::vector<rs2::frame> handle_frame(rs2::frame f, pointcloud& pc);
+        const rs2_device* find_device(rs2::frame f) const; // Null for the frames of no device of the viewer
 
         rs2::frame apply_filters(rs2::frame f);
         rs2::frame last_tex_frame;
-        rs2::processing_block processing_block;
-        pointcloud pc;
+        std::mutex workers_mutex;
+        std::map<const rs2_device*, std::unique_ptr<device_worker>> workers;
         rs2::frameset model;
         std::atomic<bool> keep_calculating;
 
@@ -613,7 +653,7 @@ namespace rs2
 
         void show_top_bar(ux_window& window, const rect& viewer_rect);
 
-        void render_3d_view(const rect& view_rect, texture_buffer* texture, rs2::points points);
+        void render_3d_view(const rect& view_rect, texture_buffer* texture, rs2::points points, rs2::depth_frame depth);
 
         void render_2d_view(const rect& view_rect, ux_window& win, int output_height,
             ImFont *font1, ImFont *font2, size_t dev_model_num, const mouse_info &mouse, std::string& error_message);
@@ -629,12 +669,13 @@ namespace rs2
         post_processing_filters ppf;
 
         notifications_model not_model;
+        frame_exporter snapshots{ "" }; // Writes snapshots off the render thread
         bool is_output_collapsed = false;
         bool is_3d_view = false;
         bool paused = false;
 
 
-        void draw_viewport(const rect& viewer_rect, ux_window& window, int devices, std::string& error_message, texture_buffer* texture, rs2::points  f = rs2::points());
+        void draw_viewport(const rect& viewer_rect, ux_window& window, int devices, std::string& error_message, texture_buffer* texture, rs2::points  f = rs2::points(), rs2::depth_frame depth = rs2::depth_frame(rs2::frame()));
 
         bool allow_3d_source_change = true;
         bool allow_stream_close = true;
@@ -643,6 +684,7 @@ namespace rs2
         bool draw_plane = false;
 
         bool draw_frustrum = true;
+        std::atomic<bool> gpu_pointcloud{ false };    // Deproject the depth in a shader rather than by the pointcloud block
         bool support_non_syncronized_mode = true;
         std::atomic<bool> synchronization_enable;
 
@@ -673,12 +715,15 @@ namespace rs2
         GLint texture_border_mode = GL_CLAMP_TO_EDGE; // GL_CLAMP_TO_BORDER
 
         rs2::points last_points;
+        rs2::depth_frame last_depth{ rs2::frame() };    // Drawn by depth_points_shader in place of last_points
+        points_buffer points_renderer;
         texture_buffer* last_texture;
         texture_buffer texture;
 
     };
 
     void export_to_ply(const std::string& file_name, notifications_model& ns, frameset points, video_frame texture);
+    void export_to_ply(const std::string& file_name, notifications_model& ns, points points, video_frame texture);
 
     // Wrapper for cross-platform dialog control
     enum file_dialog_mode {
@@ -21,6 +21,8 @@
 #define _USE_MATH_DEFINES
 #include <cmath>
 #include <map>
+#include <deque>
+#include <atomic>
 #include <mutex>
 
 #ifdef _MSC_VER
@@ -32,6 +34,38 @@
 #endif
 #endif
 
+// OpenGL 2.0 definitions for colorizing depth and deprojecting it in shaders, the functions are looked up at runtime
+#ifndef GL_FRAGMENT_SHADER
+#define GL_FRAGMENT_SHADER  0x8B30
+#define GL_COMPILE_STATUS   0x8B81
+#define GL_LINK_STATUS      0x8B82
+#endif
+#ifndef GL_VERTEX_SHADER
+#define GL_VERTEX_SHADER    0x8B31
+#endif
+#ifndef GL_TEXTURE0
+#define GL_TEXTURE0         0x84C0
+#define GL_TEXTURE1         0x84C1
+#endif
+// OpenGL 1.5 and 2.1 definitions for buffer objects, the functions are looked up at runtime as well
+#ifndef GL_ARRAY_BUFFER
+#define GL_ARRAY_BUFFER             0x8892
+#define GL_ELEMENT_ARRAY_BUFFER     0x8893
+#define GL_WRITE_ONLY               0x88B9
+#define GL_STREAM_DRAW              0x88E0
+#endif
+#ifndef GL_PIXEL_UNPACK_BUFFER
+#define GL_PIXEL_UNPACK_BUFFER      0x88EC
+#endif
+#ifndef GL_STATIC_DRAW
+#define GL_STATIC_DRAW              0x88E4
+#endif
+#ifdef _WIN32
+#define RS2_GL_CALL __stdcall
+#else
+#define RS2_GL_CALL
+#endif
+
 namespace rs2
 {
     class fps_calc
@@ -741,13 +775,687 @@ namespace rs2
         timer _t;
     };
 
+    // Looks up a function of an OpenGL version or extension the headers do not declare, in the current context
+    template<class T>
+    bool load_gl_function(T& f, const char* name)
+    {
+        f = reinterpret_cast<T>(glfwGetProcAddress(name));
+        return f != nullptr;
+    }
+
+    // Buffer objects of OpenGL 1.5, and pixel buffer objects when the driver offers OpenGL 2.1
+    class gl_buffers
+    {
+        typedef void(RS2_GL_CALL *gen_buffers_t)(GLsizei, GLuint*);
+        typedef void(RS2_GL_CALL *bind_buffer_t)(GLenum, GLuint);
+        typedef void(RS2_GL_CALL *buffer_data_t)(GLenum, ptrdiff_t, const void*, GLenum);
+        typedef void*(RS2_GL_CALL *map_buffer_t)(GLenum, GLenum);
+        typedef GLboolean(RS2_GL_CALL *unmap_buffer_t)(GLenum);
+
+        bool init()
+        {
+            if (!load_gl_function(gen_buffers, "glGenBuffers") || !load_gl_function(bind_buffer, "glBindBuffer") ||
+                !load_gl_function(buffer_data, "glBufferData") || !load_gl_function(map_buffer, "glMapBuffer") ||
+                !load_gl_function(unmap_buffer, "glUnmapBuffer"))
+                return false;
+
+            auto window = glfwGetCurrentContext();
+            auto major = glfwGetWindowAttrib(window, GLFW_CONTEXT_VERSION_MAJOR);
+            auto minor = glfwGetWindowAttrib(window, GLFW_CONTEXT_VERSION_MINOR);
+            pixel_buffers = major > 2 || (major == 2 && minor >= 1) || glfwExtensionSupported("GL_ARB_pixel_buffer_object");
+            return true;
+        }
+
+    public:
+        gen_buffers_t gen_buffers = nullptr;
+        bind_buffer_t bind_buffer = nullptr;
+        buffer_data_t buffer_data = nullptr;
+        map_buffer_t map_buffer = nullptr;
+        unmap_buffer_t unmap_buffer = nullptr;
+        bool pixel_buffers = false;     // GL_PIXEL_UNPACK_BUFFER can be bound
+
+        // Returns the functions, looked up in the GL context of the first call, or null when the driver lacks them
+        static gl_buffers* get()
+        {
+            static bool initialized = false;
+            static gl_buffers buffers;
+            static bool supported = false;
+            if (!initialized)
+            {
+                initialized = true;
+                supported = buffers.init();
+            }
+            return supported ? &buffers : nullptr;
+        }
+
+        // Fills the buffer bound to target with size bytes of data, in a new storage so that GL need not wait for the
+        // commands still reading the previous one
+        bool write(GLenum target, size_t size, const void* data)
+        {
+            buffer_data(target, static_cast<ptrdiff_t>(size), nullptr, GL_STREAM_DRAW);
+            auto p = map_buffer(target, GL_WRITE_ONLY);
+            if (!p) return false;
+            memcpy(p, data, size);
+            return unmap_buffer(target) == GL_TRUE;
+        }
+    };
+
+    // Draws a points frame with a single call. Points without depth are left out through an index list, built once per frame
+    // The vertices, texture coordinates and indices are copied into buffer objects once per frame as well, so that the
+    // redraws of the view until the next frame read them from GPU memory. Without buffer objects GL reads the vertices
+    // and texture coordinates straight from the frame on every draw
+    class points_buffer
+    {
+        rs2::points _points;
+        std::vector<uint32_t> _indices;
+        GLuint _buffers[2] = { 0, 0 };  // Vertices followed by texture coordinates, and indices
+        bool _uploaded = false;
+
+        bool upload(gl_buffers& gl)
+        {
+            auto count = _points.size();
+            size_t vertices_size = count * sizeof(rs2::vertex), coords_size = count * sizeof(rs2::texture_coordinate);
+            if (!_buffers[0])
+                gl.gen_buffers(2, _buffers);
+
+            gl.bind_buffer(GL_ARRAY_BUFFER, _buffers[0]);
+            gl.buffer_data(GL_ARRAY_BUFFER, static_cast<ptrdiff_t>(vertices_size + coords_size), nullptr, GL_STREAM_DRAW);
+            auto p = static_cast<uint8_t*>(gl.map_buffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY));
+            if (p)
+            {
+                memcpy(p, _points.get_vertices(), vertices_size);
+                memcpy(p + vertices_size, _points.get_texture_coordinates(), coords_size);
+            }
+            bool uploaded = p && gl.unmap_buffer(GL_ARRAY_BUFFER) == GL_TRUE;
+            gl.bind_buffer(GL_ARRAY_BUFFER, 0);
+
+            gl.bind_buffer(GL_ELEMENT_ARRAY_BUFFER, _buffers[1]);
+            uploaded = uploaded && gl.write(GL_ELEMENT_ARRAY_BUFFER, _indices.size() * sizeof(uint32_t), _indices.data());
+            gl.bind_buffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+            return uploaded;
+        }
+
+    public:
+        void draw(rs2::points points)
+        {
+            auto vertices = points.get_vertices();
+            auto tex_coords = points.get_texture_coordinates();
+            auto gl = gl_buffers::get();
+            if (points.get() != _points.get())
+            {
+                _points = points;
+                _indices.clear();
+                _indices.reserve(points.size());
+                for (uint32_t i = 0; i < points.size(); i++)
+                {
+                    if (vertices[i].z)
+                        _indices.push_back(i);
+                }
+                _uploaded = gl && upload(*gl);
+            }
+
+            glEnableClientState(GL_VERTEX_ARRAY);
+            glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+            if (gl && _uploaded)
+            {
+                // The pointers are offsets into the bound buffers
+                gl->bind_buffer(GL_ARRAY_BUFFER, _buffers[0]);
+                gl->bind_buffer(GL_ELEMENT_ARRAY_BUFFER, _buffers[1]);
+                glVertexPointer(3, GL_FLOAT, 0, nullptr);
+                glTexCoordPointer(2, GL_FLOAT, 0, reinterpret_cast<const void*>(points.size() * sizeof(rs2::vertex)));
+                glDrawElements(GL_POINTS, static_cast<GLsizei>(_indices.size()), GL_UNSIGNED_INT, nullptr);
+                gl->bind_buffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+                gl->bind_buffer(GL_ARRAY_BUFFER, 0);
+            }
+            else
+            {
+                glVertexPointer(3, GL_FLOAT, 0, vertices);
+                glTexCoordPointer(2, GL_FLOAT, 0, tex_coords);
+                glDrawElements(GL_POINTS, static_cast<GLsizei>(_indices.size()), GL_UNSIGNED_INT, _indices.data());
+            }
+            glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+            glDisableClientState(GL_VERTEX_ARRAY);
+        }
+    };
+
+    // Shader programs and vertex attributes of OpenGL 2.0. The rest of the rendering sticks to OpenGL 1.1, so the
+    // shaders built with them are only used when the driver offers OpenGL 2.0
+    class gl_shaders
+    {
+        typedef GLuint(RS2_GL_CALL *create_shader_t)(GLenum);
+        typedef void(RS2_GL_CALL *shader_source_t)(GLuint, GLsizei, const char* const*, const GLint*);
+        typedef void(RS2_GL_CALL *compile_shader_t)(GLuint);
+        typedef void(RS2_GL_CALL *get_iv_t)(GLuint, GLenum, GLint*);
+        typedef GLuint(RS2_GL_CALL *create_program_t)();
+        typedef void(RS2_GL_CALL *attach_shader_t)(GLuint, GLuint);
+        typedef void(RS2_GL_CALL *link_program_t)(GLuint);
+        typedef void(RS2_GL_CALL *use_program_t)(GLuint);
+        typedef GLint(RS2_GL_CALL *get_location_t)(GLuint, const char*);
+        typedef void(RS2_GL_CALL *uniform_1i_t)(GLint, GLint);
+        typedef void(RS2_GL_CALL *uniform_1f_t)(GLint, GLfloat);
+        typedef void(RS2_GL_CALL *uniform_2f_t)(GLint, GLfloat, GLfloat);
+        typedef void(RS2_GL_CALL *uniform_4f_t)(GLint, GLfloat, GLfloat, GLfloat, GLfloat);
+        typedef void(RS2_GL_CALL *uniform_fv_t)(GLint, GLsizei, const GLfloat*);
+        typedef void(RS2_GL_CALL *uniform_matrix_t)(GLint, GLsizei, GLboolean, const GLfloat*);
+        typedef void(RS2_GL_CALL *active_texture_t)(GLenum);
+        typedef void(RS2_GL_CALL *vertex_attrib_pointer_t)(GLuint, GLint, GLenum, GLboolean, GLsizei, const void*);
+        typedef void(RS2_GL_CALL *attrib_array_t)(GLuint);
+
+        create_shader_t create_shader = nullptr;
+        shader_source_t shader_source = nullptr;
+        compile_shader_t compile_shader = nullptr;
+        get_iv_t get_shader_iv = nullptr;
+        create_program_t create_program = nullptr;
+        attach_shader_t attach_shader = nullptr;
+        link_program_t link_program = nullptr;
+        get_iv_t get_program_iv = nullptr;
+
+        bool init()
+        {
+            return load_gl_function(create_shader, "glCreateShader") && load_gl_function(shader_source, "glShaderSource") &&
+                load_gl_function(compile_shader, "glCompileShader") && load_gl_function(get_shader_iv, "glGetShaderiv") &&
+                load_gl_function(create_program, "glCreateProgram") && load_gl_function(attach_shader, "glAttachShader") &&
+                load_gl_function(link_program, "glLinkProgram") && load_gl_function(get_program_iv, "glGetProgramiv") &&
+                load_gl_function(use_program, "glUseProgram") && load_gl_function(get_uniform_location, "glGetUniformLocation") &&
+                load_gl_function(get_attrib_location, "glGetAttribLocation") && load_gl_function(uniform_1i, "glUniform1i") &&
+                load_gl_function(uniform_1f, "glUniform1f") && load_gl_function(uniform_2f, "glUniform2f") &&
+                load_gl_function(uniform_4f, "glUniform4f") && load_gl_function(uniform_1fv, "glUniform1fv") &&
+                load_gl_function(uniform_matrix_4fv, "glUniformMatrix4fv") && load_gl_function(active_texture, "glActiveTexture") &&
+                load_gl_function(vertex_attrib_pointer, "glVertexAttribPointer") &&
+                load_gl_function(enable_vertex_attrib_array, "glEnableVertexAttribArray") &&
+                load_gl_function(disable_vertex_attrib_array, "glDisableVertexAttribArray");
+        }
+
+        bool compile(GLuint program, GLenum type, const char* source)
+        {
+            GLint status = 0;
+            auto shader = create_shader(type);
+            shader_source(shader, 1, &source, nullptr);
+            compile_shader(shader);
+            get_shader_iv(shader, GL_COMPILE_STATUS, &status);
+            if (status) attach_shader(program, shader);
+            return status != 0;
+        }
+
+    public:
+        use_program_t use_program = nullptr;
+        get_location_t get_uniform_location = nullptr;
+        get_location_t get_attrib_location = nullptr;
+        uniform_1i_t uniform_1i = nullptr;
+        uniform_1f_t uniform_1f = nullptr;
+        uniform_2f_t uniform_2f = nullptr;
+        uniform_4f_t uniform_4f = nullptr;
+        uniform_fv_t uniform_1fv = nullptr;
+        uniform_matrix_t uniform_matrix_4fv = nullptr;
+        active_texture_t active_texture = nullptr;
+        vertex_attrib_pointer_t vertex_attrib_pointer = nullptr;
+        attrib_array_t enable_vertex_attrib_array = nullptr;
+        attrib_array_t disable_vertex_attrib_array = nullptr;
+
+        // Returns the functions, looked up in the GL context of the first call, or null when the driver lacks them
+        static gl_shaders* get()
+        {
+            static bool initialized = false;
+            static gl_shaders shaders;
+            static bool supported = false;
+            if (!initialized)
+            {
+                initialized = true;
+                supported = shaders.init();
+            }
+            return supported ? &shaders : nullptr;
+        }
+
+        // Links a program of the shaders, the vertex shader may be null to keep the fixed function vertex processing
+        // Returns 0 when a shader fails to compile or the program fails to link
+        GLuint build(const char* vertex_source, const char* fragment_source)
+        {
+            auto program = create_program();
+            if ((vertex_source && !compile(program, GL_VERTEX_SHADER, vertex_source)) ||
+                !compile(program, GL_FRAGMENT_SHADER, fragment_source))
+                return 0;
+
+            GLint status = 0;
+            link_program(program);
+            get_program_iv(program, GL_LINK_STATUS, &status);
+            return status ? program : 0;
+        }
+    };
+
+    // Colorizes depth on the GPU, the fragment shader looking up the color of every pixel in the colors the colorizer gives
+    class depth_shader
+    {
+        gl_shaders* gl = nullptr;
+        GLuint program = 0;
+        GLuint depth_texture = 0;
+        GLuint lut_texture = 0;
+        int depth_width = 0;
+        int depth_height = 0;
+        std::vector<unsigned int> lut;
+
+        bool init()
+        {
+            gl = gl_shaders::get();
+            if (!gl) return false;
+
+            // Depth values are split into the column and row of their color in a 256x256 table
+            static const char* source =
+                "uniform sampler2D depth;\n"
+                "uniform sampler2D lut;\n"
+                "void main()\n"
+                "{\n"
+                "    float d = floor(texture2D(depth, gl_TexCoord[0].st).r * 65535.0 + 0.5);\n"
+                "    float row = floor(d / 256.0);\n"
+                "    vec2 cell = vec2(d - row * 256.0, row);\n"
+                "    gl_FragColor = vec4(texture2D(lut, (cell + 0.5) / 256.0).rgb, 1.0);\n"
+                "}\n";
+
+            program = gl->build(nullptr, source);
+            if (!program) return false;
+
+            gl->use_program(program);
+            gl->uniform_1i(gl->get_uniform_location(program, "depth"), 0);
+            gl->uniform_1i(gl->get_uniform_location(program, "lut"), 1);
+            gl->use_program(0);
+
+            glGenTextures(1, &depth_texture);
+            glGenTextures(1, &lut_texture);
+            for (auto t : { depth_texture, lut_texture })
+            {
+                glBindTexture(GL_TEXTURE_2D, t);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+            }
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 256, 256, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            glBindTexture(GL_TEXTURE_2D, 0);
+            lut.resize(0x10000);
+            return true;
+        }
+
+    public:
+        // Returns the shader, built in the GL context of the first call, or null when the driver cannot run it
+        static depth_shader* get()
+        {
+            static bool initialized = false;
+            static depth_shader shader;
+            static bool supported = false;
+            if (!initialized)
+            {
+                initialized = true;
+                supported = shader.init();
+            }
+            return supported ? &shader : nullptr;
+        }
+
+        // Renders the colorized frame into texture, whose storage must already be RGB of the size of the frame
+        // The frame is drawn to the bottom left corner of the framebuffer and copied from there, as draw_motion_data does
+        bool colorize(const video_frame& depth, colorizer& colors, GLuint texture)
+        {
+            auto width = depth.get_width(), height = depth.get_height();
+            int fb_width = 0, fb_height = 0;
+            glfwGetFramebufferSize(glfwGetCurrentContext(), &fb_width, &fb_height);
+            if (width > fb_width || height > fb_height)
+                return false;
+
+            colors.get_lut(depth, lut.data());
+
+            glPushAttrib(GL_ENABLE_BIT | GL_VIEWPORT_BIT | GL_TEXTURE_BIT);
+            glBindTexture(GL_TEXTURE_2D, lut_texture);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 256, 256, GL_RGBA, GL_UNSIGNED_BYTE, lut.data());
+            glBindTexture(GL_TEXTURE_2D, depth_texture);
+            if (width != depth_width || height != depth_height)
+            {
+                glTexImage2D(GL_TEXTURE_2D, 0, GL_LUMINANCE16, width, height, 0, GL_LUMINANCE, GL_UNSIGNED_SHORT, depth.get_data());
+                depth_width = width;
+                depth_height = height;
+            }
+            else glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_LUMINANCE, GL_UNSIGNED_SHORT, depth.get_data());
+
+            glDisable(GL_BLEND);
+            glDisable(GL_DEPTH_TEST);
+            glDisable(GL_SCISSOR_TEST);
+            glViewport(0, 0, width, height);
+            glMatrixMode(GL_PROJECTION);
+            glPushMatrix();
+            glLoadIdentity();
+            glOrtho(0, 1, 0, 1, -1, 1);
+            glMatrixMode(GL_MODELVIEW);
+            glPushMatrix();
+            glLoadIdentity();
+
+            gl->active_texture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_2D, lut_texture);
+            gl->active_texture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D, depth_texture);
+            gl->use_program(program);
+            glBegin(GL_QUADS);
+            glTexCoord2f(0, 0); glVertex2f(0, 0);
+            glTexCoord2f(1, 0); glVertex2f(1, 0);
+            glTexCoord2f(1, 1); glVertex2f(1, 1);
+            glTexCoord2f(0, 1); glVertex2f(0, 1);
+            glEnd();
+            gl->use_program(0);
+
+            glBindTexture(GL_TEXTURE_2D, texture);
+            glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 0, 0, width, height);
+
+            glPopMatrix();
+            glMatrixMode(GL_PROJECTION);
+            glPopMatrix();
+            glMatrixMode(GL_MODELVIEW);
+            glPopAttrib();
+            return true;
+        }
+    };
+
+    // Draws the pointcloud of a depth frame on the GPU, the vertex shader deprojecting every pixel and mapping it to the
+    // texture as the pointcloud processing block would. Only the depth is copied, once per frame, into a buffer object
+    // the redraws of the view read, while the pixel coordinates stay in a buffer of their own until the resolution changes
+    class depth_points_shader
+    {
+        gl_shaders* gl = nullptr;
+        gl_buffers* buffers = nullptr;
+        GLuint program = 0;
+        GLint pixel_attribute = -1;
+        GLint depth_attribute = -1;
+        GLuint pixels_buffer = 0;
+        GLuint depth_buffer = 0;
+        int pixels_width = 0;
+        int pixels_height = 0;
+        rs2::frame uploaded;
+
+        bool init()
+        {
+            gl = gl_shaders::get();
+            buffers = gl_buffers::get();
+            if (!gl || !buffers) return false;
+
+            // Points of pixels without depth are moved out of the clip volume
+            static const char* vertex_source =
+                "attribute vec2 pixel;\n"
+                "attribute float depth;\n"
+                "uniform float depth_units;\n"
+                "uniform vec4 depth_intrinsics;\n"
+                "uniform bool depth_distorted;\n"
+                "uniform float depth_coeffs[5];\n"
+                "uniform mat4 depth_to_texture;\n"
+                "uniform vec4 texture_intrinsics;\n"
+                "uniform vec2 texture_size;\n"
+                "uniform bool texture_distorted;\n"
+                "uniform float texture_coeffs[5];\n"
+                "varying vec2 texcoord;\n"
+                "void main()\n"
+                "{\n"
+                "    vec2 ray = (pixel - depth_intrinsics.zw) / depth_intrinsics.xy;\n"
+                "    if (depth_distorted)\n"
+                "    {\n"
+                "        float r2 = dot(ray, ray);\n"
+                "        float f = 1.0 + depth_coeffs[0] * r2 + depth_coeffs[1] * r2 * r2 + depth_coeffs[4] * r2 * r2 * r2;\n"
+                "        ray = vec2(ray.x * f + 2.0 * depth_coeffs[2] * ray.x * ray.y + depth_coeffs[3] * (r2 + 2.0 * ray.x * ray.x),\n"
+                "                   ray.y * f + 2.0 * depth_coeffs[3] * ray.x * ray.y + depth_coeffs[2] * (r2 + 2.0 * ray.y * ray.y));\n"
+                "    }\n"
+                "    float z = depth * depth_units;\n"
+                "    vec4 point = vec4(ray * z, z, 1.0);\n"
+                "\n"
+                "    vec4 mapped = depth_to_texture * point;\n"
+                "    vec2 p = mapped.xy / mapped.z;\n"
+                "    if (texture_distorted)\n"
+                "    {\n"
+                "        float r2 = dot(p, p);\n"
+                "        p *= 1.0 + texture_coeffs[0] * r2 + texture_coeffs[1] * r2 * r2 + texture_coeffs[4] * r2 * r2 * r2;\n"
+                "        p = vec2(p.x + 2.0 * texture_coeffs[2] * p.x * p.y + texture_coeffs[3] * (r2 + 2.0 * p.x * p.x),\n"
+                "                 p.y + 2.0 * texture_coeffs[3] * p.x * p.y + texture_coeffs[2] * (r2 + 2.0 * p.y * p.y));\n"
+                "    }\n"
+                "    texcoord = (p * texture_intrinsics.xy + texture_intrinsics.zw + 0.5) / texture_size;\n"
+                "    gl_FrontColor = gl_Color;\n"
+                "    gl_Position = z > 0.0 ? gl_ModelViewProjectionMatrix * point : vec4(2.0, 2.0, 2.0, 1.0);\n"
+                "}\n";
+            static const char* fragment_source =
+                "uniform sampler2D color;\n"
+                "uniform bool textured;\n"
+                "varying vec2 texcoord;\n"
+                "void main()\n"
+                "{\n"
+                "    gl_FragColor = textured ? texture2D(color, texcoord) : gl_Color;\n"
+                "}\n";
+
+            program = gl->build(vertex_source, fragment_source);
+            if (!program) return false;
+
+            pixel_attribute = gl->get_attrib_location(program, "pixel");
+            depth_attribute = gl->get_attrib_location(program, "depth");
+            if (pixel_attribute < 0 || depth_attribute < 0) return false;
+
+            gl->use_program(program);
+            gl->uniform_1i(gl->get_uniform_location(program, "color"), 0);
+            gl->use_program(0);
+
+            GLuint names[2];
+            buffers->gen_buffers(2, names);
+            pixels_buffer = names[0];
+            depth_buffer = names[1];
+            return true;
+        }
+
+        void set_intrinsics(const char* intrinsics, const char* distorted, const char* coeffs,
+                            const rs2_intrinsics& intrin, rs2_distortion model)
+        {
+            gl->uniform_4f(gl->get_uniform_location(program, intrinsics), intrin.fx, intrin.fy, intrin.ppx, intrin.ppy);
+            gl->uniform_1i(gl->get_uniform_location(program, distorted), intrin.model == model);
+            gl->uniform_1fv(gl->get_uniform_location(program, coeffs), 5, intrin.coeffs);
+        }
+
+        // Maps the points to the texture frame, or returns false when there is no way to
+        bool set_texture(const rs2::video_stream_profile& depth, const rs2::stream_profile& texture)
+        {
+            auto color = texture.as<video_stream_profile>();
+            if (!color) return false;
+
+            rs2_extrinsics extrinsics;
+            rs2_intrinsics intrin;
+            try
+            {
+                extrinsics = depth.get_extrinsics_to(color);
+                intrin = color.get_intrinsics();
+            }
+            catch (const error&)
+            {
+                return false;
+            }
+
+            // Column major, as the rotation of the extrinsics
+            float m[16] = {};
+            for (int c = 0; c < 3; c++)
+            {
+                for (int r = 0; r < 3; r++)
+                    m[c * 4 + r] = extrinsics.rotation[c * 3 + r];
+                m[12 + c] = extrinsics.translation[c];
+            }
+            m[15] = 1.f;
+            gl->uniform_matrix_4fv(gl->get_uniform_location(program, "depth_to_texture"), 1, GL_FALSE, m);
+            gl->uniform_2f(gl->get_uniform_location(program, "texture_size"),
+                           static_cast<float>(intrin.width), static_cast<float>(intrin.height));
+            set_intrinsics("texture_intrinsics", "texture_distorted", "texture_coeffs", intrin, RS2_DISTORTION_MODIFIED_BROWN_CONRADY);
+            return true;
+        }
+
+        void upload_pixels(int width, int height)
+        {
+            std::vector<float> pixels(static_cast<size_t>(width) * height * 2);
+            auto p = pixels.data();
+            for (int y = 0; y < height; y++)
+            {
+                for (int x = 0; x < width; x++)
+                {
+                    *p++ = static_cast<float>(x);
+                    *p++ = static_cast<float>(y);
+                }
+            }
+            buffers->bind_buffer(GL_ARRAY_BUFFER, pixels_buffer);
+            buffers->buffer_data(GL_ARRAY_BUFFER, static_cast<ptrdiff_t>(pixels.size() * sizeof(float)), pixels.data(), GL_STATIC_DRAW);
+            pixels_width = width;
+            pixels_height = height;
+        }
+
+    public:
+        // Returns the shader, built in the GL context of the first call, or null when the driver cannot run it
+        static depth_points_shader* get()
+        {
+            static bool initialized = false;
+            static depth_points_shader shader;
+            static bool supported = false;
+            if (!initialized)
+            {
+                initialized = true;
+                supported = shader.init();
+            }
+            return supported ? &shader : nullptr;
+        }
+
+        // Whether draw takes the frame, which has to be Z16 depth whose rows follow each other without padding
+        static bool can_draw(const rs2::frame& frame)
+        {
+            auto depth = frame.as<depth_frame>();
+            return depth && frame.get_profile().format() == RS2_FORMAT_Z16 &&
+                   depth.get_stride_in_bytes() == depth.get_width() * static_cast<int>(sizeof(uint16_t));
+        }
+
+        // Draws the points of the depth frame in the current model view, sampling the texture bound to the first unit at
+        // the pixels of the texture stream the points fall on when texture is given, or in the current color otherwise
+        void draw(const depth_frame& depth, float depth_units, const rs2::stream_profile& texture = rs2::stream_profile())
+        {
+            auto width = depth.get_width(), height = depth.get_height();
+            auto profile = depth.get_profile().as<video_stream_profile>();
+
+            buffers->bind_buffer(GL_ARRAY_BUFFER, depth_buffer);
+            if (depth.get() != uploaded.get())
+            {
+                buffers->write(GL_ARRAY_BUFFER, static_cast<size_t>(width) * height * sizeof(uint16_t), depth.get_data());
+                uploaded = depth;
+            }
+            gl->vertex_attrib_pointer(depth_attribute, 1, GL_UNSIGNED_SHORT, GL_FALSE, 0, nullptr);
+
+            if (width != pixels_width || height != pixels_height)
+                upload_pixels(width, height);
+            buffers->bind_buffer(GL_ARRAY_BUFFER, pixels_buffer);
+            gl->vertex_attrib_pointer(pixel_attribute, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+            buffers->bind_buffer(GL_ARRAY_BUFFER, 0);
+
+            gl->use_program(program);
+            gl->uniform_1f(gl->get_uniform_location(program, "depth_units"), depth_units);
+            set_intrinsics("depth_intrinsics", "depth_distorted", "depth_coeffs", profile.get_intrinsics(), RS2_DISTORTION_INVERSE_BROWN_CONRADY);
+            auto textured = texture && set_texture(profile, texture);
+            gl->uniform_1i(gl->get_uniform_location(program, "textured"), textured);
+
+            gl->enable_vertex_attrib_array(pixel_attribute);
+            gl->enable_vertex_attrib_array(depth_attribute);
+            glDrawArrays(GL_POINTS, 0, width * height);
+            gl->disable_vertex_attrib_array(depth_attribute);
+            gl->disable_vertex_attrib_array(pixel_attribute);
+            gl->use_program(0);
+        }
+    };
+
     class texture_buffer
     {
         GLuint texture;
         rs2::frame_queue last_queue[2];
         mutable rs2::frame last[2];
+
+        // Layout of the texture storage, which is only reallocated when a frame does not fit it
+        GLint storage_format = 0;
+        int storage_width = 0;
+        int storage_height = 0;
+
+        // Depth frames colorized ahead of their upload, by a thread other than the renderer
+        std::mutex prepared_mutex;
+        std::deque<std::pair<rs2::frame, rs2::frame>> prepared;
+        static const size_t max_prepared = 4;
+        std::atomic<bool> colorized_on_gpu{ false };
+
+        // Pixel buffer objects the frames are uploaded through, used in turn
+        GLuint pixel_buffers[2] = { 0, 0 };
+        int next_pixel_buffer = 0;
+
+        // Bytes GL reads for an image of the format and type under the current unpack parameters, 0 when unknown
+        static size_t unpacked_size(int width, int height, GLenum format, GLenum type)
+        {
+            size_t components = 0, component_size = 0;
+            switch (format)
+            {
+            case GL_LUMINANCE: case GL_GREEN: components = 1; break;
+            case GL_LUMINANCE_ALPHA: components = 2; break;
+            case GL_RGB: components = 3; break;
+            case GL_RGBA: components = 4; break;
+            }
+            switch (type)
+            {
+            case GL_UNSIGNED_BYTE: component_size = 1; break;
+            case GL_UNSIGNED_SHORT: component_size = 2; break;
+            case GL_FLOAT: component_size = 4; break;
+            }
+            if (!components || !component_size || width <= 0 || height <= 0)
+                return 0;
+
+            GLint row_length = 0, alignment = 4;
+            glGetIntegerv(GL_UNPACK_ROW_LENGTH, &row_length);
+            glGetIntegerv(GL_UNPACK_ALIGNMENT, &alignment);
+            auto pixel_size = components * component_size;
+            auto row = ((row_length > 0 ? row_length : width) * pixel_size + alignment - 1) / alignment * alignment;
+            return row * (height - 1) + width * pixel_size;
+        }
+
+        // Copies the pixels into the next pixel buffer object and updates the texture from it. GL then transfers them
+        // to the texture without blocking the render thread, while the next frame is copied into the other buffer
+        // Returns false when the driver has no pixel buffer objects, leaving the texture to a synchronous update
+        bool upload_pixels(int width, int height, GLenum format, GLenum type, const void* data)
+        {
+            auto gl = gl_buffers::get();
+            auto size = unpacked_size(width, height, format, type);
+            if (!gl || !gl->pixel_buffers || !data || !size)
+                return false;
+
+            if (!pixel_buffers[0])
+                gl->gen_buffers(2, pixel_buffers);
+            gl->bind_buffer(GL_PIXEL_UNPACK_BUFFER, pixel_buffers[next_pixel_buffer]);
+            next_pixel_buffer ^= 1;
+            bool written = gl->write(GL_PIXEL_UNPACK_BUFFER, size, data);
+            if (written)
+                glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, format, type, nullptr);
+            gl->bind_buffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            return written;
+        }
+
+        void tex_image(GLint internal_format, int width, int height, GLenum format, GLenum type, const void* data)
+        {
+            if (internal_format != storage_format || width != storage_width || height != storage_height)
+            {
+                glTexImage2D(GL_TEXTURE_2D, 0, internal_format, width, height, 0, format, type, data);
+                storage_format = internal_format;
+                storage_width = width;
+                storage_height = height;
+            }
+            else if (!upload_pixels(width, height, format, type, data))
+                glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, format, type, data);
+        }
+
+        rs2::frame take_prepared(const rs2::frame& frame)
+        {
+            std::lock_guard<std::mutex> lock(prepared_mutex);
+            while (!prepared.empty())
+            {
+                auto next = std::move(prepared.front());
+                prepared.pop_front();
+                if (next.first.get() == frame.get())
+                    return next.second;
+            }
+            return {};
+        }
     public:
         std::shared_ptr<colorizer> colorize;
+        bool gpu_colorize = true;   // Colorize depth in a shader when the driver can run it
 
         texture_buffer(const texture_buffer& other)
         {
@@ -762,6 +1470,9 @@ namespace rs2
         rs2::frame get_last_frame(bool with_texture = false) const {
             auto idx = with_texture ? 1 : 0;
             last_queue[idx].poll_for_frame(&last[idx]);
+            // Depth colorized on the GPU is only colorized on the CPU once its colors are asked for
+            if (with_texture && last[idx].is<depth_frame>() && last[idx].get_profile().format() != RS2_FORMAT_RGB8)
+                last[idx] = colorize->colorize(last[idx]);
             return last[idx];
         }
 
@@ -777,7 +1488,7 @@ namespace rs2
             if (!texture)
                 glGenTextures(1, &texture);
             glBindTexture(GL_TEXTURE_2D, texture);
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+            tex_image(GL_RGBA, w, h, GL_RGBA, GL_UNSIGNED_BYTE, data);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
@@ -785,6 +1496,24 @@ namespace rs2
             glBindTexture(GL_TEXTURE_2D, 0);
         }
 
+        // Colorizes a depth frame before upload is given it, so the render thread does not have to
+        void prepare(rs2::frame frame)
+        {
+            if (!frame.is<depth_frame>() || colorized_on_gpu)
+                return;
+            auto format = frame.get_profile().format();
+            if (format != RS2_FORMAT_Z16 && format != RS2_FORMAT_DISPARITY16)
+                return;
+
+            auto colorizer = colorize;
+            auto colorized = colorizer->colorize(frame);
+
+            std::lock_guard<std::mutex> lock(prepared_mutex);
+            if (prepared.size() == max_prepared)
+                prepared.pop_front();
+            prepared.emplace_back(frame, colorized);
+        }
+
         void upload(rs2::frame frame)
         {
             last_queue[0].enqueue(frame);
@@ -819,36 +1548,57 @@ namespace rs2
             case RS2_FORMAT_DISPARITY16:
                 if (frame.is<depth_frame>())
                 {
-                    if (rendered_frame = colorize->colorize(frame).as<video_frame>())
+                    auto shader = gpu_colorize ? depth_shader::get() : nullptr;
+                    if (shader && image)
+                    {
+                        if (storage_format != GL_RGB || storage_width != width || storage_height != height)
+                        {
+                            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
+                            storage_format = GL_RGB;
+                            storage_width = width;
+                            storage_height = height;
+                        }
+                        if (shader->colorize(image, *colorize, texture))
+                        {
+                            colorized_on_gpu = true;
+                            break;
+                        }
+                    }
+                    colorized_on_gpu = false;
+
+                    auto colorized = take_prepared(frame);
+                    if (!colorized)
+                        colorized = colorize->colorize(frame);
+                    if (rendered_frame = colorized.as<video_frame>())
                     {
                         data = rendered_frame.get_data();
-                        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB,
-                                     rendered_frame.get_width(),
-                                     rendered_frame.get_height(),
-                                     0, GL_RGB, GL_UNSIGNED_BYTE,
-                                     rendered_frame.get_data());
+                        tex_image(GL_RGB,
+                                  rendered_frame.get_width(),
+                                  rendered_frame.get_height(),
+                                  GL_RGB, GL_UNSIGNED_BYTE,
+                                  rendered_frame.get_data());
                     }
                 }
-                else glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_LUMINANCE, GL_UNSIGNED_SHORT, data);
+                else tex_image(GL_RGB, width, height, GL_LUMINANCE, GL_UNSIGNED_SHORT, data);
 
                 break;
             case RS2_FORMAT_XYZ32F:
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_FLOAT, data);
+                tex_image(GL_RGB, width, height, GL_RGB, GL_FLOAT, data);
                 break;
             case RS2_FORMAT_YUYV: // Display YUYV by showing the luminance channel and packing chrominance into ignored alpha channel
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_LUMINANCE_ALPHA, GL_UNSIGNED_BYTE, data);
+                tex_image(GL_RGB, width, height, GL_LUMINANCE_ALPHA, GL_UNSIGNED_BYTE, data);
                 break;
             case RS2_FORMAT_UYVY: // Use one color component only to avoid costly UVUY->RGB conversion
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_GREEN, GL_UNSIGNED_SHORT, data);
+                tex_image(GL_RGB, width, height, GL_GREEN, GL_UNSIGNED_SHORT, data);
                 break;
             case RS2_FORMAT_RGB8: case RS2_FORMAT_BGR8: // Display both RGB and BGR by interpreting them RGB, to show the flipped byte ordering. Obviously, GL_BGR could be used on OpenGL 1.2+
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
+                tex_image(GL_RGB, width, height, GL_RGB, GL_UNSIGNED_BYTE, data);
                 break;
             case RS2_FORMAT_RGBA8: case RS2_FORMAT_BGRA8: // Display both RGBA and BGRA by interpreting them RGBA, to show the flipped byte ordering. Obviously, GL_BGRA could be used on OpenGL 1.2+
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+                tex_image(GL_RGBA, width, height, GL_RGBA, GL_UNSIGNED_BYTE, data);
                 break;
             case RS2_FORMAT_Y8:
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_LUMINANCE, GL_UNSIGNED_BYTE, data);
+                tex_image(GL_RGB, width, height, GL_LUMINANCE, GL_UNSIGNED_BYTE, data);
                 break;
             case RS2_FORMAT_MOTION_XYZ32F:
             {
@@ -857,12 +1607,12 @@ namespace rs2
             }
             break;
             case RS2_FORMAT_Y16:
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_LUMINANCE, GL_UNSIGNED_SHORT, data);
+                tex_image(GL_RGB, width, height, GL_LUMINANCE, GL_UNSIGNED_SHORT, data);
                 break;
             case RS2_FORMAT_RAW8:
             case RS2_FORMAT_MOTION_RAW:
             case RS2_FORMAT_GPIO_RAW:
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_LUMINANCE, width, height, 0, GL_LUMINANCE, GL_UNSIGNED_BYTE, data);
+                tex_image(GL_LUMINANCE, width, height, GL_LUMINANCE, GL_UNSIGNED_BYTE, data);
                 break;
             //case RS2_FORMAT_RAW10:
             //{
@@ -1088,6 +1838,9 @@ namespace rs2
             }
 
             glCopyTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 0, 0, 1024, 1024, 0);
+            storage_format = GL_RGBA;
+            storage_width = 1024;
+            storage_height = 1024;
 
             glMatrixMode(GL_MODELVIEW);
             glPopMatrix();
@@ -13,8 +13,7 @@
 #include <cstring>
 
 void render_slider(rect location, float& clipping_dist);
-void remove_background(rs2::video_frame& other, const rs2::depth_frame& depth_frame, float depth_scale, float clipping_dist);
-float get_depth_scale(rs2::device dev);
+void remove_background(rs2::video_frame& other, const rs2::depth_frame& depth_frame, float clipping_dist);
 rs2_stream find_stream_to_align(const std::vector<rs2::stream_profile>& streams);
 bool profile_changed(const std::vector<rs2::stream_profile>& current, const std::vector<rs2::stream_profile>& prev);
 
@@ -33,10 +32,6 @@ int main(int argc, char * argv[]) try
     //The start function returns the pipeline profile which the pipeline used to start the device
     rs2::pipeline_profile profile = pipe.start();
 
-    // Each depth camera might have different units for depth pixels, so we get it here
-    // Using the pipeline's profile, we can retrieve the device that the pipeline uses
-    float depth_scale = get_depth_scale(profile.get_device());
-
     //Pipeline could choose a device that does not have a color stream
     //If there is no color stream, choose to align depth to another stream
     rs2_stream align_to = find_stream_to_align(profile.get_streams());
@@ -63,7 +58,6 @@ int main(int argc, char * argv[]) try
             profile = pipe.get_active_profile();
             align_to = find_stream_to_align(profile.get_streams());
             align = rs2::align(align_to);
-            depth_scale = get_depth_scale(profile.get_device());
         }
 
         //Get processed aligned frame
@@ -81,7 +75,7 @@ int main(int argc, char * argv[]) try
         // Passing both frames to remove_background so it will "strip" the background
         // NOTE: in this example, we alter the buffer of the other frame, instead of copying it and altering the copy
         //       This behavior is not recommended in real application since the other frame could be used elsewhere
-        remove_background(other_frame, aligned_depth_frame, depth_scale, depth_clipping_distance);
+        remove_background(other_frame, aligned_depth_frame, depth_clipping_distance);
 
         // Taking dimensions of the window for rendering purposes
         float w = static_cast<float>(app.width());
@@ -125,20 +119,6 @@ catch (const std::exception & e)
     return EXIT_FAILURE;
 }
 
-float get_depth_scale(rs2::device dev)
-{
-    // Go over the device's sensors
-    for (rs2::sensor& sensor : dev.query_sensors())
-    {
-        // Check if the sensor if a depth sensor
-        if (rs2::depth_sensor dpt = sensor.as<rs2::depth_sensor>())
-        {
-            return dpt.get_depth_scale();
-        }
-    }
-    throw std::runtime_error("Device does not have a depth sensor");
-}
-
 void render_slider(rect location, float& clipping_dist)
 {
     // Some trickery to display the control nicely
@@ -176,9 +156,10 @@ void render_slider(rect location, float& clipping_dist)
     ImGui::End();
 }
 
-void remove_background(rs2::video_frame& other_frame, const rs2::depth_frame& depth_frame, float depth_scale, float clipping_dist)
+void remove_background(rs2::video_frame& other_frame, const rs2::depth_frame& depth_frame, float clipping_dist)
 {
-    const uint16_t* p_depth_frame = reinterpret_cast<const uint16_t*>(depth_frame.get_data());
+    // Distances of all the pixels in meters, converted at once using the depth units of the frame
+    const std::vector<float> distances = depth_frame.get_distances();
     uint8_t* p_other_frame = reinterpret_cast<uint8_t*>(const_cast<void*>(other_frame.get_data()));
 
     int width = other_frame.get_width();
@@ -191,8 +172,8 @@ void remove_background(rs2::video_frame& other_frame, const rs2::depth_frame& de
         auto depth_pixel_index = y * width;
         for (int x = 0; x < width; x++, ++depth_pixel_index)
         {
-            // Get the depth value of the current pixel
-            auto pixels_distance = depth_scale * p_depth_frame[depth_pixel_index];
+            // Get the distance of the current pixel
+            auto pixels_distance = distances[depth_pixel_index];
 
             // Check if the depth value is invalid (<=0) or greater than the threashold
             if (pixels_distance <= 0.f || pixels_distance > clipping_dist)
@@ -7,10 +7,6 @@
 #include <iostream>             // Terminal IO
 #include <sstream>              // Stringstreams
 
-// 3rd party header for writing png files
-#define STB_IMAGE_WRITE_IMPLEMENTATION
-#include "stb_image_write.h"
-
 // Helper function for writing metadata to disk as a csv file
 void metadata_to_csv(const rs2::frame& frm, const std::string& filename);
 
@@ -21,6 +17,9 @@ int main(int argc, char * argv[]) try
     // Declare depth colorizer for pretty visualization of depth data
     rs2::colorizer color_map;
 
+    // Declare frame exporter, which writes images to disk on worker threads, so capture goes on meanwhile
+    rs2::frame_exporter exporter("rs-save-to-disk-output-");
+
     // Declare RealSense pipeline, encapsulating the actual device and sensors
     rs2::pipeline pipe;
     // Start streaming with default recommended configuration
@@ -43,9 +42,8 @@ int main(int argc, char * argv[]) try
             // Write images to disk
             std::stringstream png_file;
             png_file << "rs-save-to-disk-output-" << vf.get_profile().stream_name() << ".png";
-            stbi_write_png(png_file.str().c_str(), vf.get_width(), vf.get_height(),
-                           vf.get_bytes_per_pixel(), vf.get_data(), vf.get_stride_in_bytes());
-            std::cout << "Saved " << png_file.str() << std::endl;
+            exporter.save(vf, png_file.str());
+            std::cout << "Saving " << png_file.str() << std::endl;
 
             // Record per-frame metadata for UVC streams
             std::stringstream csv_file;
@@ -55,6 +53,9 @@ int main(int argc, char * argv[]) try
         }
     }
 
+    // Wait for the images to be written
+    exporter.flush();
+
     return EXIT_SUCCESS;
 }
 catch(const rs2::error & e)
@@ -16,6 +16,8 @@ extern "C" {
 
 /**
 * \brief Creates RealSense context that is required for the rest of the API.
+* The platform backend is initialized the first time the context queries or watches devices, so contexts used only
+* for recordings, software devices or processing blocks do not access USB devices.
 * \param[in] api_version Users are expected to pass their version of \c RS2_API_VERSION to make sure they are running the correct librealsense version.
 * \param[out] error  If non-null, receives any error that occurs during this call, otherwise, errors are ignored.
 * \return            Context object
@@ -49,7 +51,8 @@ void rs2_set_devices_changed_callback(rs2_context* context, rs2_devices_changed_
 /**
  * Create a new device and add it to the context
  * \param ctx   The context to which the new device will be added
- * \param file  The file from which the device should be created
+ * \param file  The file from which the device should be created, or "tcp://<host>:<port>" to play the device served
+ *              at that address, see rs2_create_network_server_device
  * \param[out] error     If non-null, receives any error that occurs during this call, otherwise, errors are ignored
  * @return  A pointer to a device that plays data from the file, or null in case of failure
  */
@@ -63,6 +66,15 @@ rs2_device* rs2_context_add_device(rs2_context* ctx, const char* file, rs2_error
  */
 void rs2_context_remove_device(rs2_context* ctx, const char* file, rs2_error** error);
 
+/**
+ * Selects the clock of the system time of frames, of their latency time points and of rs2_get_time
+ * The time is shared by the contexts of the process. Sensors opened earlier keep the clock they were opened with
+ * \param[in]  ctx       The context of live devices, playback contexts keep the time of their recording
+ * \param[in]  source    Clock to read the time from
+ * \param[out] error     If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ */
+void rs2_context_set_time_source(rs2_context* ctx, rs2_time_source source, rs2_error** error);
+
 /**
 * create a static snapshot of all connected devices at the time of the call
 * \param context     Object representing librealsense session
@@ -71,6 +83,16 @@ void rs2_context_remove_device(rs2_context* ctx, const char* file, rs2_error** e
 */
 rs2_device_list* rs2_query_devices(const rs2_context* context, rs2_error** error);
 
+/**
+* create a static snapshot of the connected devices, enumerating their video interfaces only
+* The enumeration skips the USB and HID queries, so recovery devices are not listed and the devices have no motion
+* sensors. While a devices changed callback is set, this and rs2_query_devices return the devices of the last change
+* \param context     Object representing librealsense session
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return            the list of devices, should be released by rs2_delete_device_list
+*/
+rs2_device_list* rs2_query_devices_lightweight(const rs2_context* context, rs2_error** error);
+
 /**
 * \brief Creates RealSense device_hub .
 * \param[in] context The context for the device hub
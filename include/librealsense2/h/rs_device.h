@@ -61,6 +61,16 @@ int rs2_device_list_contains(const rs2_device_list* info_list, const rs2_device*
 */
 rs2_device* rs2_create_device(const rs2_device_list* info_list, int index, rs2_error** error);
 
+/**
+* Creates all the devices of a list, opening and initializing them concurrently. Returns once all of them are done
+* \param[in]  info_list      the list containing the devices to create
+* \param[out] devices        Array of the size of the list, receives the devices in the order of the list, or null for devices that failed. Created devices should be released by rs2_delete_device
+* \param[out] device_errors  If non-null, array of the size of the list, receives the error of each device that failed, or null. Errors should be released by rs2_free_error
+* \param[out] error          If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return                    Number of devices created
+*/
+int rs2_create_devices(const rs2_device_list* info_list, rs2_device** devices, rs2_error** device_errors, rs2_error** error);
+
 /**
 * Delete RealSense device
 * \param[in]  device    Realsense device to delete
@@ -93,6 +103,27 @@ int rs2_supports_device_info(const rs2_device* device, rs2_camera_info info, rs2
  */
 void rs2_hardware_reset(const rs2_device * device, rs2_error ** error);
 
+/**
+* Capture the settings of a device: the writable options of its sensors and, when its advanced mode is enabled, the
+* advanced mode tables. Restoring them with rs2_restore_device_state brings the device back to these settings after a
+* hardware reset or a reconnection, without replaying them one at a time
+* \param[in]  device   The RealSense device
+* \param[out] error    If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return              The state of the device in a rs2_raw_data_buffer, which should be released by rs2_delete_raw_data
+*/
+const rs2_raw_data_buffer* rs2_capture_device_state(const rs2_device* device, rs2_error** error);
+
+/**
+* Restore the settings captured by rs2_capture_device_state, the advanced mode tables first and then the options of
+* every sensor, each group written in a single batch. Only the device the state was captured from, possibly after it
+* was reset or reconnected, accepts it. Streams are not started, the pipeline restarts its own
+* \param[in]  device   The RealSense device
+* \param[in]  state    The state returned by rs2_capture_device_state
+* \param[in]  size     Size of the state in bytes
+* \param[out] error    If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_restore_device_state(const rs2_device* device, const void* state, int size, rs2_error** error);
+
 /**
 * Send raw data to device
 * \param[in]  device                    RealSense device to send data to
@@ -103,6 +134,46 @@ void rs2_hardware_reset(const rs2_device * device, rs2_error ** error);
 */
 const rs2_raw_data_buffer* rs2_send_and_receive_raw_data(rs2_device* device, void* raw_data_to_send, unsigned size_of_raw_data_to_send, rs2_error** error);
 
+/**
+* Send raw commands to device in order as one batch, locking and powering the device once for all of them
+* Where the backend allows it several commands are in flight at once, overlapping the latency of their transfers
+* \param[in]  device        RealSense device to send the commands to
+* \param[in]  commands      Raw data of the commands
+* \param[in]  sizes         Size of every command in bytes
+* \param[in]  count         Number of commands
+* \param[out] responses     Receives the response of every command, each to be released by rs2_delete_raw_data
+* \param[out] received_ms   If non-null, receives for every command the milliseconds from the start of the batch until its response arrived
+* \param[out] error         If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_send_and_receive_raw_data_batch(rs2_device* device, const void** commands, const unsigned* sizes, int count,
+                                         const rs2_raw_data_buffer** responses, double* received_ms, rs2_error** error);
+
+/**
+* Start reading the firmware logs of the device on a background thread, into a ring that drops the oldest entries when full
+* Starting again clears the entries left from the previous capture
+* \param[in]  device    RealSense device to read the logs of
+* \param[in]  capacity  Number of entries the ring holds
+* \param[out] error     If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_start_fw_log_capture(rs2_device* device, unsigned capacity, rs2_error** error);
+
+/**
+* Stop reading the firmware logs of the device. The entries read until then can still be fetched
+* \param[in]  device    RealSense device to stop reading the logs of
+* \param[out] error     If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_stop_fw_log_capture(rs2_device* device, rs2_error** error);
+
+/**
+* Take the oldest captured firmware log entries, waiting for entries while there are none
+* \param[in]  device      RealSense device to take the log entries of
+* \param[in]  max_count   Most entries to take
+* \param[in]  timeout_ms  Longest time to wait for entries
+* \param[out] error       If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return                 The raw entries as the firmware wrote them, concatenated, in a rs2_raw_data_buffer which should be released by rs2_delete_raw_data
+*/
+const rs2_raw_data_buffer* rs2_fetch_fw_logs(rs2_device* device, unsigned max_count, unsigned timeout_ms, rs2_error** error);
+
 /**
  * Obtain the intrinsics of a specific stream configuration from the device.
  * \param[in]  device       RealSense device to query
@@ -129,6 +200,32 @@ int rs2_is_device_extendable_to(const rs2_device* device, rs2_extension extensio
 */
 rs2_sensor_list* rs2_query_sensors(const rs2_device* device, rs2_error** error);
 
+/**
+* Publish the video frames of a device to other processes of this machine, where the device is listed as a shared device.
+* The frame buffers of the sensors of the device are allocated in shared memory, so publishing them does not copy the frames.
+* Frames allocated elsewhere are copied. The sensors of the device must not be streaming, and their frame allocators are replaced
+* \param[in]  device    Device whose frames are published, it must remain open while publishing
+* \param[in]  name      Name of the shared device, unique on this machine
+* \param[in]  slots     Number of frames in shared memory, 0 for the default. Half of them keep the last published frames
+* \param[out] error     If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return               The publisher, should be released by rs2_delete_frame_publisher
+*/
+rs2_frame_publisher* rs2_create_frame_publisher(rs2_device* device, const char* name, int slots, rs2_error** error);
+
+/**
+* Publish a frame of the device, typically from the frame callback. Composite frames publish the frames they hold
+* \param[in]  publisher Publisher of the device of the frame
+* \param[in]  frame     Frame to publish, the reference remains owned by the caller
+* \param[out] error     If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_publish_frame(rs2_frame_publisher* publisher, rs2_frame* frame, rs2_error** error);
+
+/**
+* Stop publishing. Other processes keep the frames they hold, the shared device is no longer listed
+* \param[in]  publisher Publisher to delete
+*/
+void rs2_delete_frame_publisher(rs2_frame_publisher* publisher);
+
 #ifdef __cplusplus
 }
 #endif
@@ -20,6 +20,7 @@ typedef enum rs2_timestamp_domain
 {
     RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK, /**< Frame timestamp was measured in relation to the camera clock */
     RS2_TIMESTAMP_DOMAIN_SYSTEM_TIME,    /**< Frame timestamp was measured in relation to the OS system clock */
+    RS2_TIMESTAMP_DOMAIN_GLOBAL_TIME,    /**< Frame timestamp was measured by the camera clock and mapped to the OS system clock by a model of the camera clock, see RS2_OPTION_GLOBAL_TIME_ENABLED */
     RS2_TIMESTAMP_DOMAIN_COUNT           /**< Number of enumeration values. Not a valid input: intended to be used in for-loops. */
 } rs2_timestamp_domain;
 const char* rs2_timestamp_domain_to_string(rs2_timestamp_domain info);
@@ -40,6 +41,56 @@ typedef enum rs2_frame_metadata_value
 } rs2_frame_metadata_value;
 const char* rs2_frame_metadata_to_string(rs2_frame_metadata_value metadata);
 
+/** \brief Points along the path of a frame that are timestamped when latency instrumentation is enabled */
+typedef enum rs2_frame_latency_stage
+{
+    RS2_FRAME_LATENCY_STAGE_BACKEND_ARRIVAL , /**< The backend handed the frame buffer to the library */
+    RS2_FRAME_LATENCY_STAGE_UNPACK_DONE     , /**< The frame was unpacked into its output format */
+    RS2_FRAME_LATENCY_STAGE_SYNC_DONE       , /**< The frame was matched into a frameset */
+    RS2_FRAME_LATENCY_STAGE_PROCESSING_ENTER, /**< The processing block that produced the frame received its input */
+    RS2_FRAME_LATENCY_STAGE_PROCESSING_EXIT , /**< The processing block that produced the frame published it */
+    RS2_FRAME_LATENCY_STAGE_QUEUE_ENQUEUE   , /**< The frame was pushed into a frame queue or the pipeline queue */
+    RS2_FRAME_LATENCY_STAGE_QUEUE_DEQUEUE   , /**< The frame was pulled out of a frame queue or the pipeline queue */
+    RS2_FRAME_LATENCY_STAGE_CALLBACK_START  , /**< The frame was handed to a frame callback, the last one when it goes through several */
+    RS2_FRAME_LATENCY_STAGE_COUNT
+} rs2_frame_latency_stage;
+const char* rs2_frame_latency_stage_to_string(rs2_frame_latency_stage stage);
+
+/** \brief Points along the path of a frame where it may be dropped before reaching the application */
+typedef enum rs2_frame_drop_stage
+{
+    RS2_FRAME_DROP_STAGE_ALLOCATION     , /**< The sensor had no frame to fill, all of RS2_OPTION_FRAMES_QUEUE_SIZE frames being held by the application or processing */
+    RS2_FRAME_DROP_STAGE_SYNC           , /**< The syncer discarded the frame unmatched, its queue being full or its stream inactive */
+    RS2_FRAME_DROP_STAGE_PIPELINE_QUEUE , /**< The frames set was overwritten in the pipeline queue before the application retrieved it */
+    RS2_FRAME_DROP_STAGE_CALLBACK_LANE  , /**< The frame was overwritten in the callback lane of its stream while the callback was busy, see RS2_OPTION_CALLBACK_LANES */
+    RS2_FRAME_DROP_STAGE_DEVICE         , /**< The frame never reached the host, lost by the device, the USB transfer or the kernel buffers, as the gaps in the hardware frame counters show */
+    RS2_FRAME_DROP_STAGE_COUNT
+} rs2_frame_drop_stage;
+const char* rs2_frame_drop_stage_to_string(rs2_frame_drop_stage stage);
+
+/** \brief Frames of a stream dropped at every stage since streaming started, and the frames each stage currently holds */
+typedef struct rs2_frame_drop_stats
+{
+    unsigned long long dropped[RS2_FRAME_DROP_STAGE_COUNT]; /**< Frames dropped, indexed by rs2_frame_drop_stage */
+    int queue_depth[RS2_FRAME_DROP_STAGE_COUNT];            /**< Frames held, indexed by rs2_frame_drop_stage. The allocation stage counts all the frames of the sensor in use */
+    unsigned long long callbacks;                           /**< Frames of the stream delivered to the sensor callback */
+    float callback_duration_avg;                            /**< Average time in milliseconds the sensor callback took for a frame of the stream */
+    float callback_duration_max;                            /**< Longest time in milliseconds the sensor callback took for a frame of the stream */
+} rs2_frame_drop_stats;
+
+/** \brief Frame still held by the application or the processing, as listed by rs2_query_outstanding_frames */
+typedef struct rs2_outstanding_frame
+{
+    rs2_stream stream;              /**< Stream of the frame, RS2_STREAM_ANY until the frame has one */
+    int index;                      /**< Index of the stream */
+    unsigned long long frame_number;
+    double timestamp;               /**< Capture timestamp of the frame, in milliseconds */
+    double age;                     /**< Time in milliseconds since the frame was handed out */
+    int archive;                    /**< Identifier of the archive of the frame, the frames of a sensor stream or processing block output share one */
+    int archive_frames;             /**< Frames of the archive still held */
+    int archive_capacity;           /**< Frames the archive hands out at most at once, its frames queue size */
+} rs2_outstanding_frame;
+
 /** \brief 3D coordinates with origin at topmost left corner of the lense,
      with positive Z pointing away from the camera, positive X pointing camera right and positive Y pointing camera down */
 typedef struct rs2_vertex
@@ -53,6 +104,52 @@ typedef struct rs2_pixel
     int ij[2];
 } rs2_pixel;
 
+/** \brief One sample of a frame in the RS2_FORMAT_MOTION_XYZ32F_BATCH format. The frame itself carries the timestamp and number of its last sample */
+typedef struct rs2_motion_sample
+{
+    rs2_time_t timestamp; /**< Timestamp of the sample in milliseconds, in the timestamp domain of the frame */
+    float xyz[3];         /**< X, Y, and Z axis, as in the RS2_FORMAT_MOTION_XYZ32F format */
+} rs2_motion_sample;
+
+/** \brief Data of a frame in the RS2_FORMAT_ORIENTATION format, the orientation estimated at the timestamp of the frame */
+typedef struct rs2_orientation
+{
+    float rotation[4];          /**< Unit quaternion x, y, z, w of the rotation from the axes of the motion sensors to a world frame whose Z axis is along the acceleration measured at rest */
+    float angular_velocity[3];  /**< Last gyroscope sample, in radians per second, in the axes of the motion sensors */
+} rs2_orientation;
+
+/** \brief Fields of a frame read with a single call, see rs2_get_frame_view. Loops handling every frame read the fields directly instead of calling an accessor per field */
+typedef struct rs2_frame_view
+{
+    const void*               data;             /**< Pointer to the start of the frame data, valid while the frame is held */
+    int                       data_size;        /**< Size of the frame data in bytes */
+    int                       width;            /**< Width of the image in pixels, zero for frames that are not video frames */
+    int                       height;           /**< Height of the image in pixels, zero for frames that are not video frames */
+    int                       stride;           /**< Bytes from the start of one line to the next, zero for frames that are not video frames */
+    int                       bits_per_pixel;   /**< Bits per pixel, zero for frames that are not video frames */
+    unsigned long long        number;           /**< Frame number */
+    rs2_time_t                timestamp;        /**< Timestamp of the frame in milliseconds */
+    rs2_timestamp_domain      timestamp_domain; /**< Clock of the timestamp */
+    const rs2_stream_profile* profile;          /**< Stream profile of the frame, owned by the library */
+} rs2_frame_view;
+
+/** \brief Statistics of a depth frame computed by a depth statistics block, see rs2_depth_frame_get_statistics. Distances are in meters */
+typedef struct rs2_depth_statistics
+{
+    int   total_pixels;     /**< Pixels of the frame */
+    int   valid_pixels;     /**< Pixels with depth */
+    float fill_rate;        /**< Fraction of the pixels with depth */
+    float min_distance;     /**< Nearest distance of the pixels with depth, zero when there are none */
+    float max_distance;     /**< Farthest distance of the pixels with depth, zero when there are none */
+    float mean_distance;    /**< Mean distance of the pixels with depth, zero when there are none */
+    int   roi_pixels;       /**< Pixels of the region of interest, the frame less the margins of RS2_OPTION_CROP_LEFT, RS2_OPTION_CROP_TOP, RS2_OPTION_CROP_RIGHT and RS2_OPTION_CROP_BOTTOM */
+    int   roi_valid_pixels; /**< Pixels with depth in the region of interest */
+    int   roi_near_pixels;  /**< Pixels with depth nearer than RS2_OPTION_NEAR_DISTANCE in the region of interest */
+    int   histogram_bins;   /**< Bins of the histogram of distances, see rs2_depth_frame_get_histogram, zero when none was computed */
+    float histogram_min;    /**< Distance the first bin starts at */
+    float histogram_max;    /**< Distance the last bin ends at, the bins are all of the same width */
+} rs2_depth_statistics;
+
 
 /**
 * retrieve metadata from frame handle
@@ -70,6 +167,25 @@ rs2_metadata_type rs2_get_frame_metadata(const rs2_frame* frame, rs2_frame_metad
 */
 int rs2_supports_frame_metadata(const rs2_frame* frame, rs2_frame_metadata_value frame_metadata, rs2_error** error);
 
+/**
+* retrieve all the metadata of a frame in one call
+* \param[in] frame      handle returned from a callback
+* \param[out] values    array receiving the value of every attribute, indexed by rs2_frame_metadata_value. Attributes the frame does not have are set to zero
+* \param[out] supported array receiving non-zero for every attribute the frame has, indexed by rs2_frame_metadata_value
+* \param[in] count      number of elements in values and supported, at most RS2_FRAME_METADATA_COUNT
+* \param[out] error     if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return               the number of attributes the frame has
+*/
+int rs2_get_frame_metadata_all(const rs2_frame* frame, rs2_metadata_type* values, int* supported, int count, rs2_error** error);
+
+/**
+* retrieve the data pointer, size, dimensions, number, timestamp and profile of a frame in one call
+* \param[in] frame      handle returned from a callback
+* \param[out] view      receives the fields of the frame
+* \param[out] error     if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_get_frame_view(const rs2_frame* frame, rs2_frame_view* view, rs2_error** error);
+
 /**
 * retrieve timestamp domain from frame handle. timestamps can only be comparable if they are in common domain
 * (for example, depth timestamp might come from system time while color timestamp might come from the device)
@@ -104,6 +220,14 @@ unsigned long long rs2_get_frame_number(const rs2_frame* frame, rs2_error** erro
 */
 const void* rs2_get_frame_data(const rs2_frame* frame, rs2_error** error);
 
+/**
+* retrieve the size of the frame data
+* \param[in] frame      handle returned from a callback
+* \param[out] error     if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return               the size of the frame data in bytes
+*/
+int rs2_get_frame_data_size(const rs2_frame* frame, rs2_error** error);
+
 /**
 * retrieve frame width in pixels
 * \param[in] frame      handle returned from a callback
@@ -128,6 +252,39 @@ int rs2_get_frame_height(const rs2_frame* frame, rs2_error** error);
 */
 int rs2_get_frame_stride_in_bytes(const rs2_frame* frame, rs2_error** error);
 
+/**
+* Convert the pixels of a video frame into a buffer of the application in one pass, with the vectorized unpacking routines
+* of the library. Besides copies to the same format, the conversions are of YUYV and UYVY to RGB8, BGR8, RGBA8 and BGRA8,
+* YUYV to Y8 and Y16, RGB8 and BGR8 to one another and to RGBA8 and BGRA8, Y8 to Y16, Z16 to RS2_FORMAT_DISTANCE in meters,
+* and of YUYV, UYVY, Y8, RGB8, BGR8, RGBA8 and BGRA8 to RS2_FORMAT_NV12
+* \param[in] frame       video frame
+* \param[out] dst        buffer of at least dst_stride times the height of the frame bytes, and one and a half times that for RS2_FORMAT_NV12,
+*                        whose chroma plane follows the luma plane with the same stride
+* \param[in] dst_stride  bytes from the start of a row of dst to the start of the next, zero for rows without padding
+* \param[in] dst_format  format of the pixels written to dst
+* \param[out] error      if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_copy_frame_to(const rs2_frame* frame, void* dst, int dst_stride, rs2_format dst_format, rs2_error** error);
+
+/**
+* Retrieve the statistics a depth statistics block attached to a depth frame. Frames written after the block, or that did not go through one, have none
+* \param[in] frame       depth frame
+* \param[out] statistics receives the statistics of the frame
+* \param[out] error      if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return                non-zero when the frame has statistics, zero otherwise
+*/
+int rs2_depth_frame_get_statistics(const rs2_frame* frame, rs2_depth_statistics* statistics, rs2_error** error);
+
+/**
+* Retrieve the histogram of distances a depth statistics block attached to a depth frame, the pixels of each bin from the nearest bin to the farthest
+* \param[in] frame   depth frame
+* \param[out] bins   receives the first count bins of the histogram, may be null to query the number of bins
+* \param[in] count   number of entries of bins
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return            number of bins of the histogram, zero when the frame has none
+*/
+int rs2_depth_frame_get_histogram(const rs2_frame* frame, unsigned int* bins, int count, rs2_error** error);
+
 /**
 * retrieve bits per pixels in the frame image
 * (note that bits per pixel is not necessarily divided by 8, as in 12bpp)
@@ -178,6 +335,60 @@ rs2_pixel* rs2_get_frame_texture_coordinates(const rs2_frame* frame, rs2_error**
 */
 int rs2_get_frame_points_count(const rs2_frame* frame, rs2_error** error);
 
+/**
+* retrieve the monotonic timestamps recorded for a frame at each latency stage, see rs2_enable_latency_instrumentation
+* \param[in] frame         handle returned from a callback
+* \param[out] timestamps   array receiving the timestamp of every stage in milliseconds, indexed by rs2_frame_latency_stage. Stages the frame did not go through are set to zero
+* \param[in] count         number of elements in timestamps, at most RS2_FRAME_LATENCY_STAGE_COUNT
+* \param[out] error        if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_get_frame_latency_breakdown(const rs2_frame* frame, rs2_time_t* timestamps, int count, rs2_error** error);
+
+/**
+* When called on Points frame type, this method returns the storage format of the vertices
+* Vertices not stored as RS2_FORMAT_XYZ32F are accessible only through rs2_get_frame_data
+* \param[in] frame       Points frame
+* \param[out] error      If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return                Vertex format, one of RS2_FORMAT_XYZ32F, RS2_FORMAT_XYZ16F or RS2_FORMAT_XYZ16
+*/
+rs2_format rs2_get_frame_vertex_format(const rs2_frame* frame, rs2_error** error);
+
+/**
+* Writes the vertices of a Points frame that have depth to a binary little endian PLY file, coordinates in meters
+* \param[in] frame       Points frame
+* \param[in] fname       Path of the file
+* \param[in] texture     Video frame of RS2_FORMAT_RGB8, BGR8, RGBA8, BGRA8 or Y8 format the vertices are colored from,
+*                        or null to write the texture coordinates of the vertices instead
+* \param[out] error      If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_export_to_ply(const rs2_frame* frame, const char* fname, const rs2_frame* texture, rs2_error** error);
+
+/**
+* Writes the vertices of a Points frame that have depth to a binary PCD file, as rs2_export_to_ply does
+* \param[in] frame       Points frame
+* \param[in] fname       Path of the file
+* \param[in] texture     Video frame the vertices are colored from, as for rs2_export_to_ply, or null for no color
+* \param[out] error      If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_export_to_pcd(const rs2_frame* frame, const char* fname, const rs2_frame* texture, rs2_error** error);
+
+/**
+* When called on Points frame type, this method returns the index of the depth pixel every vertex was computed from
+* \param[in] frame       Points frame
+* \param[out] error      If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return                Pointer to an array of pixel indices, or null if the frame does not carry them. Lifetime is managed by the frame
+*/
+int* rs2_get_frame_point_indices(const rs2_frame* frame, rs2_error** error);
+
+/**
+* When called on Points frame type, this method returns the unit normal of the surface at every vertex, facing the camera
+* \param[in] frame       Points frame
+* \param[out] error      If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return                Pointer to an array of normals, zero for the vertices without one, or null if the frame does not carry them, as
+*                        only the normal estimation block and the blocks after it add them. Lifetime is managed by the frame
+*/
+rs2_vertex* rs2_get_frame_normals(const rs2_frame* frame, rs2_error** error);
+
 /**
 * Returns the stream profile that was used to start the stream of this frame
 * \param[in] frame       frame reference, owned by the user
@@ -241,6 +452,16 @@ rs2_frame* rs2_extract_frame(rs2_frame* composite, int index, rs2_error** error)
 */
 int rs2_embedded_frames_count(rs2_frame* composite, rs2_error** error);
 
+/**
+* Extract the first frame of a stream type from within a composite frame, without going over the other frames
+* \param[in] composite   Composite frame
+* \param[in] stream      Stream type of the frame to extract
+* \param[out] error      If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return                reference to the frame, with the same lifetime as the ones of rs2_extract_frame, or null when
+*                        the composite frame holds no frame of the stream type
+*/
+rs2_frame* rs2_extract_frame_by_stream(rs2_frame* composite, rs2_stream stream, rs2_error** error);
+
 /**
 * This method will dispatch frame callback on a frame
 * \param[in] source      Frame pool provided by the processing block
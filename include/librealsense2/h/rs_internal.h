@@ -15,6 +15,10 @@ extern "C" {
 #endif
 #include "rs_types.h"
 #include "rs_context.h"
+#include "rs_device.h"
+#include "rs_frame.h"
+#include "rs_option.h"
+#include "rs_sensor.h"
 
 /**
  * librealsense Recorder is intended for effective unit-testing
@@ -23,7 +27,7 @@ extern "C" {
 typedef enum rs2_recording_mode
 {
     RS2_RECORDING_MODE_BLANK_FRAMES, /* frame metadata will be recorded, but pixel data will be replaced with zeros to save space */
-    RS2_RECORDING_MODE_COMPRESSED,   /* frames will be encoded using a proprietary lossy encoding, aiming at x5 compression at some CPU expense */
+    RS2_RECORDING_MODE_COMPRESSED,   /* frames will be encoded losslessly, as differences of consecutive 16-bit words compressed with LZ4, fast enough to keep up with the sensors */
     RS2_RECORDING_MODE_BEST_QUALITY, /* frames will not be compressed, but rather stored as-is. This gives best quality and low CPU overhead, but you might run out of memory */
     RS2_RECORDING_MODE_COUNT
 } rs2_recording_mode;
@@ -49,6 +53,100 @@ rs2_context* rs2_create_recording_context(int api_version, const char* filename,
  */
 rs2_context* rs2_create_mock_context(int api_version, const char* filename, const char* section, rs2_error** error);
 
+/**
+ * Create librealsense context that given a file will respond to calls exactly as the recording did, replaying frames as fast as they are consumed
+ * \param[in] api_version  realsense API version as provided by RS2_API_VERSION macro
+ * \param[in] filename     string representing the name of the file to play back from
+ * \param[in] section      string representing the name of the section within existing recording
+ * \param[in] cache_frames non-zero keeps the recorded frames in memory once read, so that replaying them again as the recording cycles does not read the file. Intended for benchmarks, memory grows with the frames of the recording
+ * \param[out] error       if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ * \return                 context object, should be released by rs2_delete_context
+ */
+rs2_context* rs2_create_mock_context_ex(int api_version, const char* filename, const char* section, int cache_frames, rs2_error** error);
+
+/** \brief Definition of a video stream of a software sensor */
+typedef struct rs2_video_stream
+{
+    rs2_stream type;
+    int index;
+    int width;
+    int height;
+    int fps;
+    int bpp;                    /**< Bytes per pixel */
+    rs2_format fmt;
+    rs2_intrinsics intrinsics;
+} rs2_video_stream;
+
+/** \brief Video frame injected into a software sensor */
+typedef struct rs2_software_video_frame
+{
+    void* pixels;
+    void(*deleter)(void*);      /**< Called with the pixels once the library no longer needs them. When null the pixels are copied and stay owned by the caller */
+    int stride;                 /**< Bytes per row */
+    int bpp;                    /**< Bytes per pixel */
+    rs2_time_t timestamp;
+    rs2_timestamp_domain domain;
+    unsigned long long frame_number;
+    const rs2_stream_profile* profile;  /**< One of the profiles added to the sensor */
+} rs2_software_video_frame;
+
+/**
+ * Create a software device and add it to the context, so that pipelines of the context and the devices it lists include it
+ * Frames the application injects into its sensors go through the same archives, syncer and processing blocks as the frames of cameras
+ * \param[in] ctx     context to add the device to
+ * \param[in] name    unique name of the device in the context, reported as its serial number. rs2_context_remove_device with the name removes it
+ * \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ * \return            the device, should be released by rs2_delete_device
+ */
+rs2_device* rs2_context_add_software_device(rs2_context* ctx, const char* name, rs2_error** error);
+
+/**
+ * Add a sensor to a software device. Sensors are added before the device is streaming
+ * \param[in] dev          software device
+ * \param[in] sensor_name  name of the sensor
+ * \param[out] error       if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ * \return                 the sensor, should be released by rs2_delete_sensor
+ */
+rs2_sensor* rs2_software_device_add_sensor(rs2_device* dev, const char* sensor_name, rs2_error** error);
+
+/**
+ * Register the extrinsics between two streams of a software device, making them available through rs2_get_extrinsics and to align
+ * \param[in] dev     software device
+ * \param[in] from    profile of the origin stream
+ * \param[in] to      profile of the target stream
+ * \param[in] extrin  extrinsics from the origin to the target
+ * \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ */
+void rs2_software_device_register_extrinsics(rs2_device* dev, const rs2_stream_profile* from, const rs2_stream_profile* to, rs2_extrinsics extrin, rs2_error** error);
+
+/**
+ * Add a video stream profile to a software sensor. Profiles are added before the sensor is opened
+ * \param[in] sensor        software sensor
+ * \param[in] video_stream  definition of the profile, profiles of the same stream type and index belong to the same stream
+ * \param[out] error        if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ * \return                  the profile, owned by the sensor
+ */
+rs2_stream_profile* rs2_software_sensor_add_video_stream(rs2_sensor* sensor, rs2_video_stream video_stream, rs2_error** error);
+
+/**
+ * Inject a video frame into a software sensor. Frames of profiles that are not streaming are dropped
+ * With a deleter the pixels are adopted without copying, and the deleter is called once the last reference to the frame is released,
+ * also when the frame is dropped or the call fails
+ * \param[in] sensor  software sensor
+ * \param[in] frame   the frame, its profile must be one of the profiles of the sensor
+ * \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ */
+void rs2_software_sensor_on_video_frame(rs2_sensor* sensor, rs2_software_video_frame frame, rs2_error** error);
+
+/**
+ * Add a read-only option to a software sensor, or update its value. Depth sensors report their RS2_OPTION_DEPTH_UNITS this way
+ * \param[in] sensor  software sensor
+ * \param[in] option  the option
+ * \param[in] val     value of the option
+ * \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ */
+void rs2_software_sensor_add_read_only_option(rs2_sensor* sensor, rs2_option option, float val, rs2_error** error);
+
 #ifdef __cplusplus
 }
 #endif
@@ -60,6 +60,47 @@ typedef enum rs2_option
     RS2_OPTION_FILTER_MAGNITUDE                           , /**< The 2D-filter effect. The specific interpretation is given within the context of the filter */
     RS2_OPTION_FILTER_SMOOTH_ALPHA                        , /**< 2D-filter parameter controls the weight/radius for smoothing.*/
     RS2_OPTION_FILTER_SMOOTH_DELTA                        , /**< 2D-filter range/validity threshold*/
+    RS2_OPTION_ZERO_COPY_BUFFERS                          , /**< Number of extra kernel buffers that frames requiring no processing may hold without being copied. Zero disables the zero-copy passthrough */
+    RS2_OPTION_UNPACK_THREADS                             , /**< Number of row bands each frame is split into for unpacking on the shared worker threads. One unpacks frames on the capture thread */
+    RS2_OPTION_COMPACT_POINTS                             , /**< Pointcloud output layout: 0 - one point per depth pixel, 1 - only the points with valid depth, 2 - only the points with valid depth, followed by the index of their depth pixel */
+    RS2_OPTION_VERTEX_FORMAT                              , /**< Pointcloud vertex storage: 0 - 32-bit floats in meters, 1 - 16-bit floats in meters, 2 - 16-bit integers in millimeters */
+    RS2_OPTION_COMPACT_HISTORY                            , /**< Temporal filter history storage: 0 - validity of the last eight frames in a byte per pixel, 1 - validity of the last four frames in four bits per pixel */
+    RS2_OPTION_HISTOGRAM_SUBSAMPLING                      , /**< Colorizer histogram equalization samples one pixel out of every N by N block of the depth frame */
+    RS2_OPTION_FRAMES_IN_FLIGHT                           , /**< Number of consecutive frames a processing block may process concurrently on the shared worker threads, with their results delivered in order. One processes every frame on the calling thread */
+    RS2_OPTION_SYNC_TOLERANCE                             , /**< Maximal difference in milliseconds between the shared-clock timestamps of frames matched by the cross-device syncer. Zero uses half the frame interval */
+    RS2_OPTION_SYNC_MAX_LATENCY                           , /**< Maximal time in milliseconds the cross-device syncer holds a frame waiting for the frames of the other devices */
+    RS2_OPTION_MOTION_BATCH_SIZE                          , /**< Number of motion samples carried by every frame of the RS2_FORMAT_MOTION_XYZ32F_BATCH format. Takes effect on the next start */
+    RS2_OPTION_WARM_RESTART                               , /**< Keep the device powered and its streaming buffers allocated after the sensor is closed, so that opening it again is fast. Zero releases them on close */
+    RS2_OPTION_GLOBAL_TIME_ENABLED                        , /**< Map the hardware timestamps of the frames to the OS system clock, reporting them in RS2_TIMESTAMP_DOMAIN_GLOBAL_TIME */
+    RS2_OPTION_CLOCK_DRIFT                                , /**< Drift of the camera clock from the OS system clock in parts per million, as estimated while global time is enabled. Read-only */
+    RS2_OPTION_CLOCK_JITTER                               , /**< Standard deviation in milliseconds of the frame arrival times around the model of the camera clock. Read-only */
+    RS2_OPTION_AUTO_EXPOSURE_SAMPLE_STEP                  , /**< Pixels between the samples of the software auto-exposure histogram along rows and columns. Zero chooses a step sampling about 65536 pixels of the region of interest */
+    RS2_OPTION_COMPRESSION_TOLERANCE                      , /**< Largest difference of a depth pixel decoded from its compressed frame to its value, in depth units. Zero compresses losslessly */
+    RS2_OPTION_REALTIME_MODE                              , /**< Reserve the buffers of all the frames the sensor may deliver when it is opened, and keep memory allocation, blocking and logging off the path of the frames to the callback. Zero-copy and banded unpacking are disabled. Takes effect on the next open */
+    RS2_OPTION_HOLES_FILL                                 , /**< Value the holes of depth frames take: 0 - the valid pixel to the left, 1 - the farthest of the 8 neighbors, 2 - the nearest of the 8 neighbors */
+    RS2_OPTION_CROP_LEFT                                  , /**< Columns the threshold and crop block cuts off the left of depth frames, and the align and pointcloud blocks leave out of their output */
+    RS2_OPTION_CROP_TOP                                   , /**< Rows the threshold and crop block cuts off the top of depth frames, and the align and pointcloud blocks leave out of their output */
+    RS2_OPTION_CROP_RIGHT                                 , /**< Columns the threshold and crop block cuts off the right of depth frames, and the align and pointcloud blocks leave out of their output */
+    RS2_OPTION_CROP_BOTTOM                                , /**< Rows the threshold and crop block cuts off the bottom of depth frames, and the align and pointcloud blocks leave out of their output */
+    RS2_OPTION_FUSION_GAIN                                , /**< Weight of the accelerometer against the gyroscope in the orientation of the motion fusion block, the gain of its Madgwick filter */
+    RS2_OPTION_SAMPLING_STEP                              , /**< Distance between the pixels the align and pointcloud blocks process, in both directions. Their output has the resolution divided by the step, with intrinsics to match */
+    RS2_OPTION_CALLBACK_LANES                             , /**< Thread the frames of a sensor are delivered to its callback on: 0 - the capture thread, 1 - a thread per stream, keeping only the latest frame waiting, 2 - a thread per stream, keeping up to RS2_OPTION_FRAMES_QUEUE_SIZE frames waiting in order. Takes effect on the next start */
+    RS2_OPTION_METADATA_ONLY_STREAMS                      , /**< Streams delivered without pixels, one bit per rs2_stream value: their frames have no data and zero width and height, and keep their timestamps and metadata. Streams unpacked together with a stream that is not set keep their pixels. Takes effect on the next open */
+    RS2_OPTION_FRAME_RATE_DECIMATION                      , /**< Deliver only every Nth frame of the streams of the sensor. The other frames are returned to the driver before they are unpacked or allocated. Takes effect on the next open */
+    RS2_OPTION_FRAME_MEMORY_HUGE_PAGES                    , /**< Pages backing the large frame buffers of the sensor: 0 - regular pages, 1 - transparent huge pages, 2 - huge pages reserved by the system, transparent ones when none are left. Linux only. Takes effect on the next open */
+    RS2_OPTION_FRAME_MEMORY_NUMA_NODE                     , /**< NUMA node the large frame buffers of the sensor are preferably placed on, -1 for the node of the thread first writing them. Linux only. Takes effect on the next open */
+    RS2_OPTION_INTRA_SENSOR_FRAMESETS                     , /**< Deliver the streams unpacked from a single payload of the sensor, like the left and right infrared streams of Y8I, as one frameset rather than frame by frame. Takes effect on the next open */
+    RS2_OPTION_CHANGE_TILE_SIZE                           , /**< Width and height of the tiles the change detection block compares between consecutive depth frames, in pixels */
+    RS2_OPTION_CHANGE_THRESHOLD                           , /**< Mean absolute difference of the depth of a tile, in depth units, above which the change detection block marks it as changed */
+    RS2_OPTION_POWER_IDLE_TIMEOUT                         , /**< Milliseconds the device of the sensor stays powered once it is no longer used, so that bursts of option accesses and quick stop and start cycles skip powering it again. Zero powers it down right away */
+    RS2_OPTION_RETAIN_ORIGINAL_FRAME                      , /**< Whether the depth frames a processing block outputs keep the frame they were derived from, and the frames that one keeps, until they are released. When disabled each output only keeps its own buffer, its units and its sensor */
+    RS2_OPTION_HISTOGRAM_BINS                             , /**< Bins of the histogram of distances the depth statistics block computes, zero for none. The histogram spans RS2_OPTION_MIN_DISTANCE to RS2_OPTION_MAX_DISTANCE */
+    RS2_OPTION_NEAR_DISTANCE                              , /**< Distance below which the depth statistics block counts the pixels of its region of interest as near, in meters */
+    RS2_OPTION_VOXEL_SIZE                                 , /**< Edge of the voxels of the voxel grid filter, in meters */
+    RS2_OPTION_NORMAL_WINDOW_SIZE                         , /**< Pixels of the windows the normal estimation block averages on each side of a point */
+    RS2_OPTION_MAX_KERNEL_BUFFERS                         , /**< Upper bound of the kernel buffers the sensor streams into, chosen at each open from how long the frames of the previous sessions held them. Zero, or a bound below the buffers the sensor needs, keeps their number fixed. Linux only */
+    RS2_OPTION_PYRAMID_REDUCTION                          , /**< How the depth pyramid reduces every 2x2 pixels of a level to one of the next: 0 to their median, 1 to the nearest valid depth */
+    RS2_OPTION_FRAME_POOL_HIGH_WATER_MARK                 , /**< Frame buffers of each size the sensor keeps cached for its next frames once they are released, see rs2_get_frame_pool_stats. Takes effect on the next open */
     RS2_OPTION_COUNT                                      , /**< Number of enumeration values. Not a valid input: intended to be used in for-loops. */
 } rs2_option;
 const char* rs2_option_to_string(rs2_option option);
@@ -113,6 +154,15 @@ int rs2_is_option_read_only(const rs2_options* options, rs2_option option, rs2_e
 */
 float rs2_get_option(const rs2_options* options, rs2_option option, rs2_error** error);
 
+/**
+* read option value from the device, bypassing the values of device options that rs2_get_option caches
+* \param[in] options  the options container
+* \param[in] option   option id to be queried
+* \param[out] error   if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return value of the option
+*/
+float rs2_get_option_from_device(const rs2_options* options, rs2_option option, rs2_error** error);
+
 /**
 * write new value to sensor option
 * \param[in] sensor     the RealSense sensor
@@ -122,6 +172,27 @@ float rs2_get_option(const rs2_options* options, rs2_option option, rs2_error**
 */
 void rs2_set_option(const rs2_options* options, rs2_option option, float value, rs2_error** error);
 
+/**
+* read the values of several options in one call, the device is powered up once for all of them
+* \param[in] options     the options container
+* \param[in] option_ids  ids of the options to be queried, all of them must be supported
+* \param[out] values     receives the value of each option, of the same length as option_ids
+* \param[in] count       number of options
+* \param[out] error      if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_get_options(const rs2_options* options, const rs2_option* option_ids, float* values, int count, rs2_error** error);
+
+/**
+* write the values of several options in one call, the device is powered up once for all of them
+* options are set in the given order, so that e.g. auto exposure is disabled before setting the exposure
+* \param[in] options     the options container
+* \param[in] option_ids  ids of the options to be set
+* \param[in] values      new value of each option, of the same length as option_ids
+* \param[in] count       number of options
+* \param[out] error      if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_set_options(const rs2_options* options, const rs2_option* option_ids, const float* values, int count, rs2_error** error);
+
 /**
 * check if particular option is supported by a subdevice
 * \param[in] sensor     the RealSense sensor
@@ -15,6 +15,8 @@ extern "C" {
 #endif
 
 #include "rs_types.h"
+#include "rs_processing.h"
+#include "rs_record_playback.h"
 
     /**
     * Create a pipeline instance
@@ -71,6 +73,19 @@ extern "C" {
     */
     int rs2_pipeline_poll_for_frames(rs2_pipeline* pipe, rs2_frame** output_frame, rs2_error ** error);
 
+    /**
+    * Wait until a new set of frames becomes available, and retrieve it along with the other sets already queued, up to
+    * max_count of them, oldest first. Suits consumers processing the frames sets in batches, such as recorders, which
+    * should configure a frames queue deep enough to hold a batch with \c rs2_config_set_frames_queue_size
+    * \param[in] pipe the pipeline
+    * \param[out] frames      receives the handles of the frames sets, each to be released using rs2_release_frame
+    * \param[in] max_count    capacity of frames
+    * \param[in] timeout_ms   Max time in milliseconds to wait for the first frames set until an exception will be thrown
+    * \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+    * \return number of frames sets stored to frames
+    */
+    int rs2_pipeline_wait_for_frames_batch(rs2_pipeline* pipe, rs2_frame** frames, int max_count, unsigned int timeout_ms, rs2_error ** error);
+
 
     /**
     * Delete a pipeline instance.
@@ -79,6 +94,36 @@ extern "C" {
     */
     void rs2_delete_pipeline(rs2_pipeline* pipe);
 
+    /**
+    * Attach a processing graph to the pipeline, to run on every synchronized frames set before it is delivered by
+    * \c wait_for_frames() or \c poll_for_frames(). The output of the graph must be frames sets, such as the output of align
+    * The graph takes effect on the next start of the pipeline, passing null detaches it
+    * \param[in] pipe   pipeline
+    * \param[in] graph  processing graph created by rs2_create_processing_graph, or null
+    * \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+    */
+    void rs2_pipeline_set_processing_graph(rs2_pipeline* pipe, rs2_processing_block* graph, rs2_error ** error);
+
+    /**
+    * Retrieve the counters of the frames sets released by the pipeline synchronization, since the pipeline was last started
+    * \param[in] pipe    pipeline
+    * \param[out] stats  receives the counters, all zero when the pipeline was never started
+    * \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+    */
+    void rs2_pipeline_get_sync_stats(rs2_pipeline* pipe, rs2_sync_stats* stats, rs2_error ** error);
+
+    /**
+    * Subscribe to the frames sets of the pipeline. Every subscription gets its own queue of all the frames sets, besides
+    * the queue of \c wait_for_frames() and \c poll_for_frames(), and stays subscribed across restarts of the pipeline
+    * The subscribers share the frames, and a full or paused subscription drops only its own frames sets
+    * \param[in] pipe      pipeline
+    * \param[in] capacity  frames sets the subscription queues before dropping
+    * \param[in] policy    frames set dropped when the queue is full, RS2_QUEUE_POLICY_DROP_OLDEST or RS2_QUEUE_POLICY_DROP_NEWEST
+    * \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+    * \return handle to the subscription, which ends when it is released using rs2_delete_frame_subscription
+    */
+    rs2_frame_subscription* rs2_pipeline_subscribe(rs2_pipeline* pipe, int capacity, rs2_queue_policy policy, rs2_error ** error);
+
     /**
     * Start the pipeline streaming with its default configuration.
     * The pipeline streaming loop captures samples from the device, and delivers them to the attached computer vision modules
@@ -114,6 +159,29 @@ extern "C" {
     */
     rs2_pipeline_profile* rs2_pipeline_start_with_config(rs2_pipeline* pipe, rs2_config* config, rs2_error ** error);
 
+    /**
+    * Prepare the pipeline to start, doing all of the work of \c rs2_pipeline_start_with_config() except for delivering frames.
+    * The configuration is resolved and the sensors opened with their streams on, so that \c rs2_pipeline_start_prepared() only
+    * attaches the pipeline to them and the first frame follows it within about a frame period.
+    * The device streams, and uses its power and USB bandwidth, while prepared. Frames arriving before the start are dropped.
+    * \c rs2_pipeline_stop() releases a prepared pipeline that was not started.
+    *
+    * \param[in] pipe    a pointer to an instance of the pipeline
+    * \param[in] config  a rs2::config with requested filters on the pipeline configuration
+    * \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+    * \return            The device and streams profile the pipeline will stream
+    */
+    rs2_pipeline_profile* rs2_pipeline_prepare(rs2_pipeline* pipe, rs2_config* config, rs2_error ** error);
+
+    /**
+    * Start a pipeline prepared by \c rs2_pipeline_prepare()
+    *
+    * \param[in] pipe    a pointer to an instance of the pipeline
+    * \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+    * \return            The actual pipeline device and streams profile, as returned by rs2_pipeline_prepare
+    */
+    rs2_pipeline_profile* rs2_pipeline_start_prepared(rs2_pipeline* pipe, rs2_error ** error);
+
     /**
     * Return the active device and streams profiles, used by the pipeline.
     * The pipeline streams profiles are selected during \c start(). The method returns a valid result only when the pipeline is active -
@@ -150,6 +218,18 @@ extern "C" {
     */
     rs2_stream_profile_list* rs2_pipeline_profile_get_streams(rs2_pipeline_profile* profile, rs2_error** error);
 
+    /**
+    * Retrieve the frames of a stream dropped at each stage of the pipeline since it started, and the current depth of
+    * every stage queue, to tune the queue sizes and detect slow consumers.
+    * Available while the pipeline streams with this profile
+    *
+    * \param[in] profile  A pointer to the active profile of a pipeline
+    * \param[in] stream   One of the streams of the profile
+    * \param[out] stats   Receives the drop counters and queue depths of the stream
+    * \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+    */
+    void rs2_pipeline_profile_get_frame_drops(rs2_pipeline_profile* profile, const rs2_stream_profile* stream, rs2_frame_drop_stats* stats, rs2_error** error);
+
     /**
     * Deletes an instance of a pipeline profile
     *
@@ -252,6 +332,20 @@ extern "C" {
     */
     void rs2_config_enable_record_to_file(rs2_config* config, const char* file, rs2_error ** error);
 
+    /**
+    * Requires that the resolved device would be recorded to file, with the given file settings
+    * This request cannot be used if enable_device_from_file() is called for the current config, and vise versa
+    *
+    * \param[in] config               A pointer to an instance of a config
+    * \param[in] file                 The desired file for the output record
+    * \param[in] compression          Compression of the recorded chunks
+    * \param[in] chunk_size           Bytes of messages gathered in a chunk before it is compressed and written, 0 for the default
+    * \param[in] compression_threads  Number of threads compressing chunks in the background, 0 compresses them on the recording thread
+    * \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+    */
+    void rs2_config_enable_record_to_file_ex(rs2_config* config, const char* file, rs2_record_compression compression,
+        unsigned int chunk_size, unsigned int compression_threads, rs2_error ** error);
+
 
     /**
     * Disable a device stream explicitly, to remove any requests on this stream type.
@@ -286,6 +380,29 @@ extern "C" {
     */
     void rs2_config_disable_all_streams(rs2_config* config, rs2_error ** error);
 
+    /**
+    * Bound the time the pipeline synchronization holds frames of a stream waiting for the frames of the other streams.
+    * Past the bound, the frames set is delivered without the streams still missing, so a stalled stream does not delay
+    * the others. Applied when the pipeline is started with this config
+    *
+    * \param[in] config       A pointer to an instance of a config
+    * \param[in] stream       Stream type the bound applies to, RS2_STREAM_ANY sets the default of the streams without their own
+    * \param[in] max_wait_ms  Longest wait in milliseconds, zero waits for the whole set without a bound
+    * \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+    */
+    void rs2_config_set_sync_max_wait(rs2_config* config, rs2_stream stream, float max_wait_ms, rs2_error ** error);
+
+    /**
+    * Set how many frames sets the pipeline queues for \c wait_for_frames() and \c poll_for_frames(). Once the queue is full,
+    * the oldest set is dropped for each new one. A size of one keeps only the latest set, so real-time consumers never
+    * process stale data. Applied when the pipeline is started with this config
+    *
+    * \param[in] config    A pointer to an instance of a config
+    * \param[in] size      Number of frames sets to queue, 10 by default
+    * \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+    */
+    void rs2_config_set_frames_queue_size(rs2_config* config, int size, rs2_error ** error);
+
     /**
     * Resolve the configuration filters, to find a matching device and streams profiles.
     * The method resolves the user configuration filters for the device and streams, and combines them with the requirements of
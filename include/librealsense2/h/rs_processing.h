@@ -16,6 +16,34 @@ extern "C" {
 
 #include "rs_types.h"
 
+/** \brief What a processing graph node does with an input frame arriving while its queue is full */
+typedef enum rs2_queue_policy
+{
+    RS2_QUEUE_POLICY_DROP_OLDEST , /**< Drop the oldest queued frame to make room for the new one */
+    RS2_QUEUE_POLICY_DROP_NEWEST , /**< Drop the arriving frame */
+    RS2_QUEUE_POLICY_BLOCK       , /**< Block the node or the caller passing the frame until there is room, slowing down the stages before it */
+    RS2_QUEUE_POLICY_COUNT         /**< Number of enumeration values. Not a valid input: intended to be used in for-loops. */
+} rs2_queue_policy;
+const char* rs2_queue_policy_to_string(rs2_queue_policy policy);
+
+/** \brief Throughput statistics of a processing graph node */
+typedef struct rs2_processing_node_stats
+{
+    unsigned long long processed; /**< Frames the node finished processing */
+    unsigned long long dropped;   /**< Frames dropped at the node input because its queue was full */
+    int queue_depth;              /**< Frames currently waiting in the node queue */
+    float fps;                    /**< Recent rate at which the node finishes frames, in frames per second */
+    float processing_ms;          /**< Recent average time the node spends on a frame, in milliseconds */
+} rs2_processing_node_stats;
+
+/** \brief Counters of the framesets released by a sync processing block */
+typedef struct rs2_sync_stats
+{
+    unsigned long long complete; /**< Framesets released with every stream they were waiting for */
+    unsigned long long partial;  /**< Framesets released without some of their streams because they waited past the max wait */
+    unsigned long long dropped;  /**< Frames discarded by the syncer without leaving in any frameset */
+} rs2_sync_stats;
+
 /**
 * Creates Depth-Colorizer processing block that can be used to quickly visualize the depth data
 * This block will accept depth frames as input and replace them by depth frames with format RGB8
@@ -25,6 +53,16 @@ extern "C" {
 */
 rs2_processing_block* rs2_create_colorizer(rs2_error** error);
 
+/**
+* Computes the color a colorizer would give to every depth value of a depth frame, without colorizing the frame
+* This lets applications apply the colors themselves, for example on the GPU
+* \param[in] block  Colorizer processing block
+* \param[in] depth  Depth frame, whose histogram the colors are equalized by, or whose depth units they are cropped by
+* \param[out] lut   Receives 0x10000 colors, the color of depth value i being the RGB bytes in the low bits of lut[i]
+* \param[out] error if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_get_colorizer_lut(rs2_processing_block* block, rs2_frame* depth, unsigned int* lut, rs2_error** error);
+
 /**
 * Creates Sync processing block. This block accepts arbitrary frames and output composite frames of best matches
 * Some frames may be released within the syncer if they are waiting for match for too long
@@ -33,6 +71,35 @@ rs2_processing_block* rs2_create_colorizer(rs2_error** error);
 */
 rs2_processing_block* rs2_create_sync_processing_block(rs2_error** error);
 
+/**
+* Bound the time frames of a stream wait in a sync processing block for the frames they are matched with.
+* A frame waiting longer is released in a partial frameset without the streams still missing. The deadline is checked
+* whenever a frame arrives at the block, so the released set leaves with the next frame of any stream
+* \param[in] sync         sync processing block created by rs2_create_sync_processing_block
+* \param[in] stream       stream type the bound applies to, RS2_STREAM_ANY sets the default of the streams without their own
+* \param[in] max_wait_ms  longest wait in milliseconds, zero waits for the match without a bound
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_sync_set_max_wait(rs2_processing_block* sync, rs2_stream stream, float max_wait_ms, rs2_error** error);
+
+/**
+* Retrieve the counters of the framesets released by a sync processing block
+* \param[in] sync    sync processing block created by rs2_create_sync_processing_block
+* \param[out] stats  receives the counters
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_sync_get_stats(const rs2_processing_block* sync, rs2_sync_stats* stats, rs2_error** error);
+
+/**
+* Creates cross-device sync processing block. This block accepts frames and framesets of several devices, for example the
+* output of several pipelines, and outputs framesets of the frames captured at the same time by the different devices.
+* The hardware timestamps of every device are mapped onto the host clock by a linear fit against the frames system time.
+* A frameset is released once every active device contributed a frame, or after RS2_OPTION_SYNC_MAX_LATENCY milliseconds
+* without all of them, and may then miss the frames of some devices
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+rs2_processing_block* rs2_create_cross_device_syncer(rs2_error** error);
+
 /**
 * Creates Point-Cloud processing block. This block accepts depth frames and outputs Points frames
 * In addition, given non-depth frame, the block will align texture coordinate to the non-depth stream
@@ -68,6 +135,7 @@ void rs2_start_processing_queue(rs2_processing_block* block, rs2_frame_queue* qu
 
 /**
 * This method is used to pass frame into a processing block
+* The depth post-processing filters write into the passed frame itself when the block holds its only reference
 * \param[in] block          Processing block
 * \param[in] frame          Frame to process, ownership is moved to the block object
 * \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
@@ -119,6 +187,59 @@ int rs2_poll_for_frame(rs2_frame_queue* queue, rs2_frame** output_frame, rs2_err
 */
 void rs2_enqueue_frame(rs2_frame* frame, void* queue);
 
+/**
+* Subscribe to the output of a processing block. Every subscription gets its own queue of the frames the block outputs,
+* in addition to its callback or queue. The subscribers share the frames, holding references rather than copies, and a
+* full or paused subscription drops only its own frames, so a slow subscriber never holds back the others
+* \param[in] block     processing block
+* \param[in] capacity  frames the subscription queues before dropping
+* \param[in] policy    frame dropped when the queue is full, RS2_QUEUE_POLICY_DROP_OLDEST or RS2_QUEUE_POLICY_DROP_NEWEST
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return handle to the subscription, which ends when it is released using rs2_delete_frame_subscription
+*/
+rs2_frame_subscription* rs2_processing_block_subscribe(rs2_processing_block* block, int capacity, rs2_queue_policy policy, rs2_error** error);
+
+/**
+* End a subscription and release the frames it holds
+* \param[in] subscription  subscription to delete
+*/
+void rs2_delete_frame_subscription(rs2_frame_subscription* subscription);
+
+/**
+* Wait until a frame is available to the subscription and dequeue it
+* \param[in] subscription  subscription returned by rs2_processing_block_subscribe or rs2_pipeline_subscribe
+* \param[in] timeout_ms    max time in milliseconds to wait
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return frame handle to be released using rs2_release_frame
+*/
+rs2_frame* rs2_subscription_wait_for_frame(rs2_frame_subscription* subscription, unsigned int timeout_ms, rs2_error** error);
+
+/**
+* Dequeue a frame of the subscription if one is available
+* \param[in] subscription   subscription returned by rs2_processing_block_subscribe or rs2_pipeline_subscribe
+* \param[out] output_frame  frame handle to be released using rs2_release_frame
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return true if a frame was stored to output_frame
+*/
+int rs2_subscription_poll_for_frame(rs2_frame_subscription* subscription, rs2_frame** output_frame, rs2_error** error);
+
+/**
+* Pause or resume a subscription. A paused subscription releases the frames it holds and queues none until resumed,
+* without affecting the other subscribers
+* \param[in] subscription  subscription returned by rs2_processing_block_subscribe or rs2_pipeline_subscribe
+* \param[in] paused        non-zero to pause, zero to resume
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_subscription_set_paused(rs2_frame_subscription* subscription, int paused, rs2_error** error);
+
+/**
+* Retrieve the number of frames a subscription dropped as its queue was full
+* \param[in] subscription  subscription returned by rs2_processing_block_subscribe or rs2_pipeline_subscribe
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return frames dropped since the subscription was created
+*/
+unsigned long long rs2_subscription_get_dropped_frames(const rs2_frame_subscription* subscription, rs2_error** error);
+
 /**
 * Creates Align processing block.
 * \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
@@ -144,6 +265,245 @@ rs2_processing_block* rs2_create_temporal_filter_block(rs2_error** error);
 */
 rs2_processing_block* rs2_create_spatial_filter_block(rs2_error** error);
 
+/**
+* Creates Depth post-processing disparity transform block. This block converts Z16 depth frames of stereo depth sensors
+* to RS2_FORMAT_DISPARITY16 frames, in 1/32 pixels, or converts such frames back to depth. Running the spatial and
+* temporal filters between the two smooths in disparity, where the stereo error is the same at all distances
+* \param[in] transform_to_disparity  non-zero to convert depth to disparity, zero to convert disparity to depth
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+rs2_processing_block* rs2_create_disparity_transform_block(unsigned char transform_to_disparity, rs2_error** error);
+
+/**
+* Creates Depth post-processing distance transform block. This block converts Z16 depth frames to RS2_FORMAT_DISTANCE frames
+* of float meters, scaled by the depth units of each frame with vectorized code, for consumers of metric depth
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+rs2_processing_block* rs2_create_distance_transform_block(rs2_error** error);
+
+/**
+* Creates Depth post-processing hole filling block. This block fills the holes of depth frames, in the mode of RS2_OPTION_HOLES_FILL
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+rs2_processing_block* rs2_create_hole_filling_filter_block(rs2_error** error);
+
+/**
+* Creates Depth post-processing threshold and crop block. This block cuts the margins of RS2_OPTION_CROP_LEFT, RS2_OPTION_CROP_TOP,
+* RS2_OPTION_CROP_RIGHT and RS2_OPTION_CROP_BOTTOM off depth frames, and clears the depth closer than RS2_OPTION_MIN_DISTANCE or
+* farther than RS2_OPTION_MAX_DISTANCE. The cropped frames keep intrinsics that match their pixels, so align and pointcloud stay correct
+* Placed first, it shrinks the frames the following blocks process
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+rs2_processing_block* rs2_create_threshold_crop_block(rs2_error** error);
+
+/**
+* Creates a change detection block. This block compares Z16 depth frames, alone or in framesets, to the previous one in tiles of
+* RS2_OPTION_CHANGE_TILE_SIZE pixels, and marks on each frame the tiles whose mean absolute difference exceeds RS2_OPTION_CHANGE_THRESHOLD.
+* Pointcloud and align blocks receiving every frame of the block recompute only the changed tiles, and keep their previous results for
+* the others. Placed last before them, as writing to a frame drops its marks
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+rs2_processing_block* rs2_create_change_detection_block(rs2_error** error);
+
+/**
+* Creates a depth statistics block. This block computes the statistics of Z16 depth frames, alone or in framesets, in one pass over
+* their pixels: the fill rate, the nearest, farthest and mean distances, the pixels with depth and the near pixels of a region of interest,
+* and a histogram of RS2_OPTION_HISTOGRAM_BINS bins from RS2_OPTION_MIN_DISTANCE to RS2_OPTION_MAX_DISTANCE. The statistics are attached
+* to the frames, see rs2_depth_frame_get_statistics and rs2_depth_frame_get_histogram, which the block passes on otherwise unchanged
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+rs2_processing_block* rs2_create_depth_statistics_block(rs2_error** error);
+
+/**
+* Creates a voxel grid filter block. This block replaces the XYZ32F points of points frames, alone or in framesets, by the centroids
+* of the voxels of RS2_OPTION_VOXEL_SIZE meters they occupy, with the means of their texture coordinates and normals. The points
+* are gathered in parallel in hash tables, and the output holds the occupied voxels only, in no particular order
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+rs2_processing_block* rs2_create_voxel_grid_filter_block(rs2_error** error);
+
+/**
+* Creates a normal estimation block. This block adds normals, see rs2_get_frame_normals, to points frames of one XYZ32F point per
+* depth pixel, as the pointcloud outputs with RS2_OPTION_COMPACT_POINTS at 0. The normals are estimated in parallel over the grid of
+* the vertices, from the mean vertices of windows of RS2_OPTION_NORMAL_WINDOW_SIZE pixels on each side of a point, read from integral
+* images. Placed before a voxel grid filter, the filter keeps the mean normal of every voxel
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+rs2_processing_block* rs2_create_normal_estimation_block(rs2_error** error);
+
+/**
+* Creates a depth pyramid block. This block replaces Z16 depth frames, alone or in framesets, by a frameset of RS2_OPTION_FILTER_MAGNITUDE
+* levels of half, quarter, ... their resolution, built in a single pass over the input. Level k is a depth frame of stream index k whose
+* intrinsics are scaled by 1 / 2^k, and reduces every 2x2 pixels of the level above it to their median, or to the nearest valid depth,
+* as RS2_OPTION_PYRAMID_REDUCTION selects. The other frames of a frameset are passed on with the levels
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+rs2_processing_block* rs2_create_depth_pyramid_block(rs2_error** error);
+
+/**
+* Creates Depth post-processing filter chain block. This block runs the given threshold and crop, decimation, spatial, temporal, hole filling and disparity transform blocks
+* in order on every depth frame, writing all the stages into a single output frame
+* The filters keep their options, and should not be used on their own while part of the chain
+* \param[in] blocks  the filter blocks to run, in order of application
+* \param[in] count   number of blocks, at least one
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+rs2_processing_block* rs2_create_filter_chain(rs2_processing_block** blocks, int count, rs2_error** error);
+
+/**
+* Creates a depth compression block. This block replaces Z16 depth frames, alone or in framesets, by frames of the
+* RS2_FORMAT_Z16_COMPRESSED format, for transport or storage. Compression is lossless by default, a non-zero
+* RS2_OPTION_COMPRESSION_TOLERANCE trades precision, bounded by the tolerance, for size. Consecutive frames may be
+* compressed concurrently, see RS2_OPTION_FRAMES_IN_FLIGHT
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+rs2_processing_block* rs2_create_depth_encoder(rs2_error** error);
+
+/**
+* Creates a depth decompression block. This block replaces frames of the RS2_FORMAT_Z16_COMPRESSED format, alone
+* or in framesets, by the Z16 depth frames they encode. The compressed frames describe their own size and tolerance
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+rs2_processing_block* rs2_create_depth_decoder(rs2_error** error);
+
+/**
+* Creates an undistortion block. This block replaces video frames of 8 bit per channel formats, alone or in framesets, whose
+* intrinsics have forward distortion, such as color and fisheye frames, by undistorted frames of the same size, focal lengths
+* and principal point. The lookup table of every intrinsics is built once and shared with align, other frames pass through
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+rs2_processing_block* rs2_create_undistort_block(rs2_error** error);
+
+/**
+* Creates a motion fusion block. This block estimates the orientation of the device from its gyroscope and accelerometer frames,
+* alone or in framesets, integrating every sample of batched frames. Accelerometer frames pass through, every gyroscope frame
+* comes out in a frameset with an RS2_STREAM_POSE frame holding an rs2_orientation. Set as the callback of the motion sensor,
+* the orientation is available at the rate of the gyroscope with no work left to the application
+* The weight of the accelerometer is set by RS2_OPTION_FUSION_GAIN
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+rs2_processing_block* rs2_create_motion_fusion_block(rs2_error** error);
+
+/**
+* Creates a frame exporter block. This block writes every frame it is given, alone or in framesets, to a file of its
+* own and passes the frames on unchanged. Video frames of 8 bit per channel formats are written as PNG images, other
+* video frames as raw data and points as PLY. Files are named by the prefix, the stream and the frame number.
+* The files are written on the shared worker threads, the block only waits when max_pending frames are unwritten
+* \param[in] prefix       Start of the path of every file, such as a directory followed by a separator
+* \param[in] max_pending  Number of frames that may wait to be written
+* \param[out] error       if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+rs2_processing_block* rs2_create_frame_exporter(const char* prefix, int max_pending, rs2_error** error);
+
+/**
+* Writes a single frame to the given file through a frame exporter block, as the block writes the frames it processes
+* \param[in] block        Frame exporter block
+* \param[in] frame        Frame to write, ownership is moved to the block object
+* \param[in] filename     Path of the file, whose extension should match the way the frame is written
+* \param[out] error       if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_export_frame(rs2_processing_block* block, rs2_frame* frame, const char* filename, rs2_error** error);
+
+/**
+* Waits until the frames given to a frame exporter block so far were all written
+* \param[in] block        Frame exporter block
+* \param[out] error       if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_flush_frame_exporter(rs2_processing_block* block, rs2_error** error);
+
+/**
+* Creates a processing graph. The graph is a processing block running other processing blocks, its nodes, connected by
+* stream edges. Every node processes its frames on its own thread out of a bounded queue, so the stages of the graph
+* work on consecutive frames concurrently. Frames passed to the graph enter the nodes without incoming edges, and the
+* output of the nodes without outgoing edges is the output of the graph
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return           new processing graph, to be released by rs2_delete_processing_block
+*/
+rs2_processing_block* rs2_create_processing_graph(rs2_error** error);
+
+/**
+* Adds a node to a processing graph. The graph takes over the output of the block, which should not be started
+* or invoked on its own afterwards
+* \param[in] graph       processing graph created by rs2_create_processing_graph
+* \param[in] block       processing block to run as the node
+* \param[in] queue_size  maximal number of frames waiting for the node, at least one
+* \param[in] policy      what to do with frames arriving while the queue is full
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return           identifier of the new node within the graph
+*/
+int rs2_processing_graph_add_node(rs2_processing_block* graph, rs2_processing_block* block, int queue_size, rs2_queue_policy policy, rs2_error** error);
+
+/**
+* Connects two nodes of a processing graph, so frames produced by one are passed to the other
+* Composite frames are split by the edge, passing only the embedded frame of the requested stream type
+* \param[in] graph   processing graph
+* \param[in] from    node producing the frames
+* \param[in] to      node receiving the frames. Connections creating a cycle are rejected
+* \param[in] stream  stream type of the frames to pass, RS2_STREAM_ANY passes all the frames as they are
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_processing_graph_connect(rs2_processing_block* graph, int from, int to, rs2_stream stream, rs2_error** error);
+
+/**
+* Retrieves the throughput statistics of a processing graph node
+* \param[in] graph   processing graph
+* \param[in] node    node identifier returned by rs2_processing_graph_add_node
+* \param[out] stats  receives the statistics of the node
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_processing_graph_get_node_stats(const rs2_processing_block* graph, int node, rs2_processing_node_stats* stats, rs2_error** error);
+
+/**
+* Sets the latency a processing graph should hold. While the latency estimated from the queue depths and processing
+* times of the nodes is over the target, the graph applies the next step of its quality ladder, and once it stays
+* well under the target the last applied step is undone
+* \param[in] graph       processing graph
+* \param[in] latency_ms  latency target in milliseconds, 0 disables the quality ladder
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_processing_graph_set_latency_target(rs2_processing_block* graph, float latency_ms, rs2_error** error);
+
+/**
+* Appends a step setting an option of the block of a node to the quality ladder of a processing graph, such as a
+* larger decimation magnitude or fewer spatial filter iterations. Undoing the step restores the previous value
+* \param[in] graph   processing graph
+* \param[in] node    node whose block supports the option
+* \param[in] option  option to set
+* \param[in] value   value of the option while the step is applied
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_processing_graph_add_option_step(rs2_processing_block* graph, int node, rs2_option option, float value, rs2_error** error);
+
+/**
+* Appends a step lowering the rate of a node to the quality ladder of a processing graph. While the step is applied
+* the node processes only one of every divisor frames arriving at it, the others are skipped and not counted as dropped
+* \param[in] graph    processing graph
+* \param[in] node     node to slow down
+* \param[in] divisor  one frame of every divisor is processed, at least one
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_processing_graph_add_rate_step(rs2_processing_block* graph, int node, int divisor, rs2_error** error);
+
+/**
+* Retrieves how far down its quality ladder a processing graph is
+* \param[in] graph   processing graph
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+* \return           number of steps applied, 0 at full quality
+*/
+int rs2_processing_graph_get_quality_level(const rs2_processing_block* graph, rs2_error** error);
+
+/**
+* Sets the scheduling priority and deadline of a processing graph node. The parallel work of the node is picked by the
+* shared processing workers before the work of nodes of a lower priority, and frames waiting in the queue of the node
+* longer than its deadline are dropped instead of processed late. Nodes start with priority 0 and no deadline
+* \param[in] graph        processing graph
+* \param[in] node         node identifier returned by rs2_processing_graph_add_node
+* \param[in] priority     higher values are scheduled first
+* \param[in] deadline_ms  longest wait of a frame in the queue of the node in milliseconds, 0 never drops
+* \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_processing_graph_set_node_priority(rs2_processing_block* graph, int node, int priority, float deadline_ms, rs2_error** error);
+
 #ifdef __cplusplus
 }
 #endif
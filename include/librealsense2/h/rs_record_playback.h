@@ -15,6 +15,7 @@ extern "C" {
 #endif
 
 #include "rs_types.h"
+#include "rs_processing.h"
 
 typedef enum rs2_playback_status
 {
@@ -26,7 +27,54 @@ typedef enum rs2_playback_status
 } rs2_playback_status;
 const char* rs2_playback_status_to_string(rs2_playback_status status);
 
+/** \brief Compression of the chunks of messages a recording is written in */
+typedef enum rs2_record_compression
+{
+    RS2_RECORD_COMPRESSION_NONE, /**< Chunks are written as is, for the highest throughput on fast storage */
+    RS2_RECORD_COMPRESSION_LZ4,  /**< Chunks are compressed with LZ4. This is the default compression of recordings */
+    RS2_RECORD_COMPRESSION_LZ4_DEPTH, /**< Z16 depth frames are first encoded by a lossless depth codec, taking about half the space LZ4 alone would, then chunks are compressed with LZ4. Recordings can only be played back by versions supporting the codec */
+    RS2_RECORD_COMPRESSION_COUNT
+} rs2_record_compression;
+const char* rs2_record_compression_to_string(rs2_record_compression compression);
+
+/** \brief State of the queue of frames a recording device did not write to its file yet */
+typedef struct rs2_record_stats
+{
+    unsigned long long queued_bytes;     /**< Bytes of the frames waiting to be written */
+    unsigned long long max_queued_bytes; /**< Limit of the queued bytes, beyond which the queue policies of the streams apply */
+    unsigned long long written_frames;   /**< Frames written since the recording started */
+    unsigned long long dropped_frames;   /**< Frames dropped because the queue was full */
+    float write_rate;                    /**< Megabytes of frames written per second, over the last second */
+} rs2_record_stats;
+
+/** \brief Settings of a dataset reader. A zeroed configuration takes the defaults */
+typedef struct rs2_dataset_config
+{
+    int batch_size;      /**< Samples per batch, 0 for 32. Batches end early at the end of the recordings and where the resolution of a stream changes */
+    int threads;         /**< Slices of every recording decoded in parallel, 0 for one per hardware thread */
+    int prefetch;        /**< Batches gathered ahead of the one read, 0 for 2 */
+    rs2_stream align_to; /**< Stream the other streams are aligned to, RS2_STREAM_ANY to leave them unaligned */
+    int decimation;      /**< Decimation magnitude of the depth stream, applied after the alignment, 0 or 1 to keep its resolution */
+    int pinned;          /**< Non-zero to lock the memory of the batches, so that copies to GPUs need no staging. Where the platform or its limits do not allow it the memory stays unlocked */
+} rs2_dataset_config;
+
+/** \brief A stream of a batch of samples. Its frames are packed one after the other, without any padding of their rows */
+typedef struct rs2_dataset_stream
+{
+    rs2_stream stream;                       /**< Stream type */
+    int index;                               /**< Stream index */
+    rs2_format format;                       /**< Format of the pixels */
+    int width;                               /**< Width of the frames in pixels */
+    int height;                              /**< Height of the frames in pixels */
+    int bytes_per_pixel;                     /**< Bytes of every pixel */
+    const void* data;                        /**< Size x height x width x bytes_per_pixel bytes of pixels */
+    const double* timestamps;                /**< Timestamp of the frame of every sample, in milliseconds */
+    const unsigned long long* frame_numbers; /**< Frame number of the frame of every sample */
+} rs2_dataset_stream;
+
 typedef void (*rs2_playback_status_changed_callback_ptr)(rs2_playback_status);
+typedef void* (*rs2_recording_slice_process_ptr)(int slice, rs2_frame* frameset, int warm_up, void* user);
+typedef void (*rs2_recording_slice_result_ptr)(void* result, void* user);
 
 /**
  * Creates a recording device to record the given device and save it to the given file
@@ -37,6 +85,71 @@ typedef void (*rs2_playback_status_changed_callback_ptr)(rs2_playback_status);
  */
 rs2_device* rs2_create_record_device(const rs2_device* device, const char* file, rs2_error** error);
 
+/**
+ * Creates a recording device to record the given device and save it to the given file, with the given file settings
+ * \param[in]  device               The device to record
+ * \param[in]  file                 The desired path to which the recorder should save the data
+ * \param[in]  compression          Compression of the recorded chunks
+ * \param[in]  chunk_size           Bytes of messages gathered in a chunk before it is compressed and written, 0 for the default
+ * \param[in]  compression_threads  Number of threads compressing chunks in the background, 0 compresses them on the recording thread
+ * \param[out] error                If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ * \return A pointer to a device that records its data to file, or null in case of failure
+ */
+rs2_device* rs2_create_record_device_ex(const rs2_device* device, const char* file, rs2_record_compression compression,
+    unsigned int chunk_size, unsigned int compression_threads, rs2_error** error);
+
+/**
+ * Creates a recording device that records the frames the sensors unpack into larger formats as the sensors delivered
+ * them, as YUY2 color streamed as RGB8, to write fewer bytes. The application still gets the unpacked frames, and
+ * playback unpacks the recorded frames of the streams it plays. Recordings of other streams are unchanged
+ * \param[in]  device       The device to record
+ * \param[in]  file         The desired path to which the recorder should save the data
+ * \param[in]  compression  Compression of the recorded chunks
+ * \param[out] error        If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ * \return A pointer to a device that records its data to file, or null in case of failure
+ */
+rs2_device* rs2_create_record_device_raw(const rs2_device* device, const char* file, rs2_record_compression compression, rs2_error** error);
+
+/**
+ * Creates a recording device that splits its recording into segment files, continuing in a new file once the
+ * current one reaches the given size or recorded time. The given file is a manifest listing the segments, which are
+ * saved next to it, and is opened for playback like a single recording
+ * \param[in]  device            The device to record
+ * \param[in]  file              The desired path of the manifest of the recording
+ * \param[in]  compression       Compression of the recorded chunks
+ * \param[in]  segment_size      Bytes of a segment file, 0 for no limit
+ * \param[in]  segment_duration  Seconds recorded in a segment file, 0 for no limit
+ * \param[out] error             If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ * \return A pointer to a device that records its data to files, or null in case of failure
+ */
+rs2_device* rs2_create_record_device_segmented(const rs2_device* device, const char* file, rs2_record_compression compression,
+    unsigned long long segment_size, unsigned int segment_duration, rs2_error** error);
+
+/**
+ * Creates a recording device that writes the native format: the frames of each stream are appended to a file of
+ * their own with fixed-size headers, next to a compact index and a bag holding the device description and the
+ * option changes. Frames are cheaper to record and seek than in a single bag, and uncompressed frames are played
+ * from the mapped files without a copy. The given file is the index, opened for playback like a single recording
+ * \param[in]  device       The device to record
+ * \param[in]  file         The desired path of the index of the recording
+ * \param[in]  compression  Compression of the frames, RS2_RECORD_COMPRESSION_LZ4_DEPTH uses the depth codec for Z16 streams and LZ4 for the others
+ * \param[out] error        If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ * \return A pointer to a device that records its data to files, or null in case of failure
+ */
+rs2_device* rs2_create_record_device_native(const rs2_device* device, const char* file, rs2_record_compression compression, rs2_error** error);
+
+/**
+ * Creates a device that serves the frames of the given device to the clients connecting to the given TCP port.
+ * Clients open the device with rs2_context_add_device and the address "tcp://<host>:<port>", and play the streams
+ * they enable while the server streams them. Frames that a slow client can not take in time are dropped
+ * \param[in]  device          The device to serve
+ * \param[in]  port            TCP port to listen on
+ * \param[in]  compress_depth  Non-zero to send Z16 frames compressed by the lossless depth codec, which takes less bandwidth and more CPU
+ * \param[out] error           If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ * \return A pointer to a device that serves its frames over the network, or null in case of failure
+ */
+rs2_device* rs2_create_network_server_device(const rs2_device* device, unsigned int port, int compress_depth, rs2_error** error);
+
 /**
 * Pause the recording device without stopping the actual device from streaming.
 * Pausing will cause the device to stop writing new data to the file, in particular, frames and changes to extensions
@@ -52,6 +165,32 @@ void rs2_record_device_pause(const rs2_device* device, rs2_error** error);
 */
 void rs2_record_device_resume(const rs2_device* device, rs2_error** error);
 
+/**
+* Limit the bytes of frames a recording device holds before they are written to its file
+* \param[in]  device     A recording device
+* \param[in]  max_bytes  Maximal bytes of queued frames. The default is about a second of 1080p RGBA video at 30 FPS
+* \param[out] error      If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_record_device_set_queue_limit(const rs2_device* device, unsigned long long max_bytes, rs2_error** error);
+
+/**
+* Select what happens to a frame arriving while the queue of the recording device is full. By default, the arriving frame is dropped
+* RS2_QUEUE_POLICY_BLOCK holds the sensor delivering the frame until the disk catches up
+* \param[in]  device     A recording device
+* \param[in]  stream     Stream type the policy applies to, RS2_STREAM_ANY for all of them
+* \param[in]  policy     Queue policy of the stream
+* \param[out] error      If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_record_device_set_queue_policy(const rs2_device* device, rs2_stream stream, rs2_queue_policy policy, rs2_error** error);
+
+/**
+* Retrieve the state of the queue of frames and the write throughput of a recording device
+* \param[in]  device     A recording device
+* \param[out] stats      Receives the statistics
+* \param[out] error      If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_record_device_get_stats(const rs2_device* device, rs2_record_stats* stats, rs2_error** error);
+
 /**
 * Creates a playback device to play the content of the given file
 * \param[in]  file      Path to the file to play
@@ -84,6 +223,41 @@ unsigned long long int rs2_playback_get_duration(const rs2_device* device, rs2_e
  */
 void rs2_playback_seek(const rs2_device* device, long long int time, rs2_error** error);
 
+/**
+ * Set the playback to a frame of one of the streams of the played data, and the data of the other streams recorded at its time
+ * \param[in] device     A playback device
+ * \param[in] profile    A stream profile of the played data, only its stream type and index are used
+ * \param[in] frame      Index of the frame among the frames of the stream, starting from 0
+ * \param[out] error     If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ */
+void rs2_playback_seek_to_frame(const rs2_device* device, const rs2_stream_profile* profile, unsigned long long int frame, rs2_error** error);
+
+/**
+ * Gets the number of frames of one of the streams of the played data
+ * \param[in] device     A playback device
+ * \param[in] profile    A stream profile of the played data, only its stream type and index are used
+ * \param[out] error     If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ * \return Number of frames recorded for the stream
+ */
+unsigned long long int rs2_playback_get_frame_count(const rs2_device* device, const rs2_stream_profile* profile, rs2_error** error);
+
+/**
+ * Copies the thumbnail of one of the streams of the played data that was recorded last at or before a time point
+ * Thumbnails are small copies of video frames written while recording, a few every second, that can be shown while
+ * seeking without reading the frames themselves. Files of older versions have none
+ * \param[in] device       A playback device
+ * \param[in] profile      A stream profile of the played data, only its stream type and index are used
+ * \param[in] time         Time point in the file, in nanoseconds
+ * \param[out] buffer      Receives the pixels of the thumbnail, rows without padding. Only written when the pixels fit it, can be null
+ * \param[in] buffer_size  Size of the buffer in bytes
+ * \param[out] width       If non-null, receives the width of the thumbnail in pixels
+ * \param[out] height      If non-null, receives the height of the thumbnail in pixels
+ * \param[out] format      If non-null, receives the format of the pixels, the format of the stream
+ * \param[out] error       If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ * \return Size of the pixels of the thumbnail in bytes, 0 when the stream has no thumbnails
+ */
+int rs2_playback_get_thumbnail(const rs2_device* device, const rs2_stream_profile* profile, long long int time, void* buffer, int buffer_size, int* width, int* height, rs2_format* format, rs2_error** error);
+
 /**
  * Gets the current position of the playback in the file in terms of time. Units are expressed in nanoseconds
  * \param[in] device     A playback device
@@ -131,6 +305,155 @@ void rs2_playback_device_set_real_time(const rs2_device* device, int real_time,
  */
 int rs2_playback_device_is_real_time(const rs2_device* device, rs2_error** error);
 
+/**
+ * Set the playback to work in batch mode, for offline processing
+ *
+ * In batch mode, playback does not pace the frames by their recorded times, and reads the next frame as soon as
+ * the callbacks of the current one return. No frames are dropped, and files play as fast as they can be read and
+ * processed. Batch mode is meant for the pipeline and for sensor callbacks, frames can also be pulled in order
+ * with rs2_playback_next_frameset instead.
+ * \param[in] device    A playback device
+ * \param[in] batch     Indicates if batch mode is requested, 0 means false, otherwise true
+ * \param[out] error     If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ */
+void rs2_playback_device_set_batch_mode(const rs2_device* device, int batch, rs2_error** error);
+
+/**
+ * Indicates if playback is in batch mode
+ * \param[in] device    A playback device
+ * \param[out] error     If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ * \return True iff playback is in batch mode. 0 means false, otherwise true
+ */
+int rs2_playback_device_is_batch_mode(const rs2_device* device, rs2_error** error);
+
+/**
+ * Read the next set of frames of the opened streams, in the order of the file and without any pacing
+ *
+ * Frames are matched into sets by the same syncer the pipeline uses. The sensors of the playback must be opened
+ * and not started. Seeking starts matching anew from the new position.
+ * \param[in] device         A playback device
+ * \param[out] output_frame  The next set of frames, to be released using rs2_release_frame
+ * \param[out] error          If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ * \return true if a set of frames was read, false at the end of the file
+ */
+int rs2_playback_next_frameset(const rs2_device* device, rs2_frame** output_frame, rs2_error** error);
+
+/**
+ * Process a recording on several threads, splitting its duration into equal time slices
+ *
+ * Each slice is played on a thread of its own, by a playback of its own seeked through the index of the file, and
+ * its sets of frames are pulled in file order as with rs2_playback_next_frameset. \p process is called concurrently
+ * for the slices, with the index of the slice so that each slice keeps a processing chain of its own, and takes
+ * ownership of the frameset. The framesets recorded in the \p warm_up time before a slice are processed first with
+ * \p warm_up set, to fill the history of filters such as the temporal filter, and their results are released.
+ * The results are handed to \p on_result on the calling thread, in the order of the recording, and a null result
+ * is skipped. The results of later slices are kept until the earlier slices are delivered, and those not delivered
+ * when processing fails are passed to \p release.
+ * \param[in] ctx         The context of the playbacks
+ * \param[in] file        A recording or a manifest of a segmented recording
+ * \param[in] slices      Number of slices processed in parallel
+ * \param[in] warm_up     Nanoseconds processed before each slice but the first, without results
+ * \param[in] process     Processes a frameset of a slice and returns its result, called on the threads of the slices
+ * \param[in] on_result   Receives the results in order, called on the calling thread
+ * \param[in] release     Releases a result that is not delivered
+ * \param[in] user        Passed to the callbacks
+ * \param[out] error      If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ */
+void rs2_process_recording_slices(rs2_context* ctx, const char* file, int slices, long long warm_up,
+                                  rs2_recording_slice_process_ptr process, rs2_recording_slice_result_ptr on_result,
+                                  rs2_recording_slice_result_ptr release, void* user, rs2_error** error);
+
+/**
+ * Create a reader of batches of samples from recordings, for training models on them
+ *
+ * The recordings are read one after the other, each split into slices decoded in parallel as with
+ * rs2_process_recording_slices, and their sets of frames holding all the requested streams become samples in the
+ * order of the recordings. The streams are aligned and decimated on the threads of the slices, and the samples are
+ * gathered into batches in the background, every stream of a batch in a single buffer.
+ * \param[in] ctx          The context of the playbacks
+ * \param[in] files        Recordings or manifests of segmented recordings
+ * \param[in] file_count   Number of recordings
+ * \param[in] streams      Stream types of the samples
+ * \param[in] indices      Stream indices of the samples, -1 for any index. Null takes any index for all of them
+ * \param[in] stream_count Number of streams of the samples
+ * \param[in] config       Settings of the reader, null for the defaults
+ * \param[out] error       If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ * \return The reader, which starts reading at once
+ */
+rs2_dataset_reader* rs2_create_dataset_reader(rs2_context* ctx, const char** files, int file_count,
+                                              const rs2_stream* streams, const int* indices, int stream_count,
+                                              const rs2_dataset_config* config, rs2_error** error);
+
+/**
+ * Stop reading and delete the reader. Batches already read stay valid
+ * \param[in] reader       The reader
+ */
+void rs2_delete_dataset_reader(rs2_dataset_reader* reader);
+
+/**
+ * Wait for the next batch of samples
+ * \param[in] reader       The reader
+ * \param[out] error       If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ * \return The batch, to be released using rs2_delete_dataset_batch, or null at the end of the recordings
+ */
+rs2_dataset_batch* rs2_dataset_reader_next_batch(rs2_dataset_reader* reader, rs2_error** error);
+
+/**
+ * Delete a batch of samples, and the buffers of its streams
+ * \param[in] batch        The batch
+ */
+void rs2_delete_dataset_batch(rs2_dataset_batch* batch);
+
+/**
+ * \param[in] batch        A batch of samples
+ * \param[out] error       If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ * \return Number of samples of the batch
+ */
+int rs2_dataset_batch_get_size(const rs2_dataset_batch* batch, rs2_error** error);
+
+/**
+ * \param[in] batch        A batch of samples
+ * \param[out] error       If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ * \return Number of streams of the batch, as requested from the reader
+ */
+int rs2_dataset_batch_get_stream_count(const rs2_dataset_batch* batch, rs2_error** error);
+
+/**
+ * Get a stream of a batch of samples. Its buffers are valid until the batch is deleted
+ * \param[in] batch        A batch of samples
+ * \param[in] i            Index of the stream, in the order the streams were requested from the reader
+ * \param[out] stream      The stream
+ * \param[out] error       If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ */
+void rs2_dataset_batch_get_stream(const rs2_dataset_batch* batch, int i, rs2_dataset_stream* stream, rs2_error** error);
+
+/**
+ * \param[in] batch        A batch of samples
+ * \param[in] sample       Index of the sample in the batch
+ * \param[out] error       If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ * \return Index of the recording the sample was read from
+ */
+int rs2_dataset_batch_get_file(const rs2_dataset_batch* batch, int sample, rs2_error** error);
+
+/**
+ * Set how many frames the playback reads ahead of the frame it plays
+ *
+ * Frames are read from the file, decompressed and decoded ahead on a thread of their own, so that slow
+ * or networked storage does not hold back the playback. 0 reads each frame only when it is played.
+ * \param[in] device    A playback device
+ * \param[in] frames    Number of frames to read ahead, up to 8, the default is 4
+ * \param[out] error     If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ */
+void rs2_playback_device_set_read_ahead(const rs2_device* device, unsigned int frames, rs2_error** error);
+
+/**
+ * Gets how many frames the playback reads ahead of the frame it plays
+ * \param[in] device    A playback device
+ * \param[out] error     If non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ * \return Number of frames read ahead
+ */
+unsigned int rs2_playback_device_get_read_ahead(const rs2_device* device, rs2_error** error);
+
 /**
  * Register to receive callback from playback device upon its status changes
  *
@@ -44,6 +44,7 @@ typedef enum rs2_stream
     RS2_STREAM_GYRO                             , /**< Native stream of gyroscope motion data produced by RealSense device */
     RS2_STREAM_ACCEL                            , /**< Native stream of accelerometer motion data produced by RealSense device */
     RS2_STREAM_GPIO                             , /**< Signals from external device connected through GPIO */
+    RS2_STREAM_POSE                             , /**< Orientation of the device, estimated from its gyroscope and accelerometer by the motion fusion block */
     RS2_STREAM_COUNT
 } rs2_stream;
 const char* rs2_stream_to_string(rs2_stream stream);
@@ -69,6 +70,14 @@ typedef enum rs2_format
     RS2_FORMAT_MOTION_RAW      , /**< Raw data from the motion sensor */
     RS2_FORMAT_MOTION_XYZ32F   , /**< Motion data packed as 3 32-bit float values, for X, Y, and Z axis */
     RS2_FORMAT_GPIO_RAW        , /**< Raw data from the external sensors hooked to one of the GPIO's */
+    RS2_FORMAT_XYZ16F          , /**< 16-bit half-precision floating point 3D coordinates, in meters */
+    RS2_FORMAT_XYZ16           , /**< 16-bit signed integer 3D coordinates, in millimeters */
+    RS2_FORMAT_MOTION_XYZ32F_BATCH, /**< Several consecutive motion samples in one frame, each an rs2_motion_sample. The count is set by RS2_OPTION_MOTION_BATCH_SIZE */
+    RS2_FORMAT_Z16_COMPRESSED  , /**< Z16 depth compressed by rs2_create_depth_encoder, in a self-describing layout read by rs2_create_depth_decoder. The frame keeps the width and height of the depth image */
+    RS2_FORMAT_ORIENTATION     , /**< One rs2_orientation, see rs2_create_motion_fusion_block */
+    RS2_FORMAT_Y8I             , /**< 8-bit left and right infrared pixels interleaved as the camera sends them: byte 2x of a row is the left pixel x, byte 2x+1 the right one. Delivered on the first infrared stream */
+    RS2_FORMAT_DISTANCE        , /**< 32-bit floating point depth, in meters */
+    RS2_FORMAT_NV12            , /**< Plane of 8-bit luma followed by a plane of interleaved 8-bit U and V chroma samples at half the width and height */
     RS2_FORMAT_COUNT             /**< Number of enumeration values. Not a valid input: intended to be used in for-loops. */
 } rs2_format;
 const char* rs2_format_to_string(rs2_format format);
@@ -80,6 +89,14 @@ typedef struct rs2_extrinsics
     float translation[3]; /**< Three-element translation vector, in meters */
 } rs2_extrinsics;
 
+/** \brief Counters of the frame buffers a sensor recycles, see RS2_OPTION_FRAME_POOL_HIGH_WATER_MARK */
+typedef struct rs2_frame_pool_stats
+{
+    unsigned long long hits;      /**< Frames given a cached buffer */
+    unsigned long long misses;    /**< Frames that needed a new buffer */
+    unsigned long long evictions; /**< Buffers freed instead of cached, above the high-water mark, once idle or when the sensor stops */
+} rs2_frame_pool_stats;
+
 /**
 * Deletes sensors list, any sensors created from this list will remain unaffected
 * \param[in] info_list list to delete
@@ -171,6 +188,30 @@ void rs2_set_region_of_interest(const rs2_sensor* sensor, int min_x, int min_y,
  */
 void rs2_get_region_of_interest(const rs2_sensor* sensor, int* min_x, int* min_y, int* max_x, int* max_y, rs2_error** error);
 
+/**
+* set how long rs2_get_option returns the value of a device option last read, before reading it again
+* setting any option of the sensor or a notification from it drops the values, the default is 100 milliseconds
+* \param[in] sensor        the RealSense sensor
+* \param[in] staleness_ms  age after which values are read again, 0 to read every value from the device
+* \param[out] error        if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_set_option_cache_staleness(const rs2_sensor* sensor, unsigned int staleness_ms, rs2_error** error);
+
+/**
+* keep the device of the sensor powered until the matching rs2_release_sensor_power, so that the options accessed meanwhile
+* need no power transition each. Holds nest. Sensors whose power is not managed by the library ignore the call
+* \param[in] sensor        the RealSense sensor
+* \param[out] error        if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_hold_sensor_power(const rs2_sensor* sensor, rs2_error** error);
+
+/**
+* release a hold of rs2_hold_sensor_power. The device is powered down once unused for RS2_OPTION_POWER_IDLE_TIMEOUT
+* \param[in] sensor        the RealSense sensor
+* \param[out] error        if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_release_sensor_power(const rs2_sensor* sensor, rs2_error** error);
+
 /**
 * open subdevice for exclusive access, by committing to a configuration
 * \param[in] sensor relevant RealSense device
@@ -246,6 +287,35 @@ void rs2_set_notifications_callback(const rs2_sensor* sensor, rs2_notification_c
 */
 void rs2_set_notifications_callback_cpp(const rs2_sensor* sensor, rs2_notifications_callback* callback, rs2_error** error);
 
+/**
+* install a custom allocator for the frame buffers of the specified sensor, allowing the library to unpack frames directly into user memory
+* must be called while the sensor is not streaming. The allocator is kept alive for as long as frames allocated through it exist
+* \param[in] sensor     RealSense sensor
+* \param[in] on_alloc   function pointer returning a buffer of at least the requested size, aligned to the requested alignment. Returning null falls back to the internal allocator
+* \param[in] on_free    function pointer releasing a buffer previously returned by on_alloc
+* \param[in] alignment  required alignment of the frame buffers in bytes, must be a power of two
+* \param[in] user       auxiliary data passed to both callbacks
+* \param[out] error     if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_set_frame_allocator(const rs2_sensor* sensor, rs2_frame_alloc_ptr on_alloc, rs2_frame_free_ptr on_free, int alignment, void* user, rs2_error** error);
+
+/**
+* install a custom allocator for the frame buffers of the specified sensor
+* \param[in] sensor     RealSense sensor
+* \param[in] allocator  allocator object created from c++ application. ownership over the allocator object is moved into the sensor
+* \param[in] alignment  required alignment of the frame buffers in bytes, must be a power of two
+* \param[out] error     if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_set_frame_allocator_cpp(const rs2_sensor* sensor, rs2_frame_allocator* allocator, int alignment, rs2_error** error);
+
+/**
+* retrieve the counters of the frame buffers the sensor recycled since it was last opened
+* \param[in] sensor     RealSense sensor
+* \param[out] stats     receives the counters, all zero for sensors that were never opened
+* \param[out] error     if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+*/
+void rs2_get_frame_pool_stats(const rs2_sensor* sensor, rs2_frame_pool_stats* stats, rs2_error** error);
+
 /**
 * retrieve description from notification handle
 * \param[in] notification      handle returned from a callback
@@ -19,6 +19,7 @@ typedef enum rs2_notification_category{
     RS2_NOTIFICATION_CATEGORY_FRAME_CORRUPTED,  /**< Received partial/incomplete frame */
     RS2_NOTIFICATION_CATEGORY_HARDWARE_ERROR,   /**< Error reported from the device */
     RS2_NOTIFICATION_CATEGORY_UNKNOWN_ERROR,    /**< Received unknown error from the device */
+    RS2_NOTIFICATION_CATEGORY_FRAMES_LOST,      /**< Frames missing from the hardware frame counters of a stream, lost before reaching the host */
     RS2_NOTIFICATION_CATEGORY_COUNT             /**< Number of enumeration values. Not a valid input: intended to be used in for-loops. */
 } rs2_notification_category;
 const char* rs2_notification_category_to_string(rs2_notification_category category);
@@ -95,16 +96,70 @@ typedef enum rs2_extension
     RS2_EXTENSION_RECORD,
     RS2_EXTENSION_VIDEO_PROFILE,
     RS2_EXTENSION_PLAYBACK,
+    RS2_EXTENSION_SOFTWARE_DEVICE,
+    RS2_EXTENSION_SOFTWARE_SENSOR,
     RS2_EXTENSION_COUNT
 } rs2_extension;
 const char* rs2_extension_type_to_string(rs2_extension type);
 
+/** \brief Classes of the threads the library runs, each with its own placement policy */
+typedef enum rs2_thread_class
+{
+    RS2_THREAD_CLASS_CAPTURE,    /**< Threads receiving frames and motion samples from devices */
+    RS2_THREAD_CLASS_PROCESSING, /**< Threads delivering, synchronizing and processing frames */
+    RS2_THREAD_CLASS_IO,         /**< Threads watching devices, logging, recording, playing back and streaming over the network */
+    RS2_THREAD_CLASS_COUNT       /**< Number of enumeration values. Not a valid input: intended to be used in for-loops. */
+} rs2_thread_class;
+const char* rs2_thread_class_to_string(rs2_thread_class thread_class);
+
+/** \brief Kinds of the metrics the library keeps about its internals */
+typedef enum rs2_metric_type
+{
+    RS2_METRIC_TYPE_COUNTER,   /**< Count that only grows, like frames received or dropped */
+    RS2_METRIC_TYPE_GAUGE,     /**< Value at the time of the snapshot, like a queue depth or a temperature */
+    RS2_METRIC_TYPE_HISTOGRAM, /**< Distribution of measured values, like processing latencies */
+    RS2_METRIC_TYPE_COUNT      /**< Number of enumeration values. Not a valid input: intended to be used in for-loops. */
+} rs2_metric_type;
+const char* rs2_metric_type_to_string(rs2_metric_type type);
+
+/** \brief Clocks the library can take the system time of frames and its other time points from */
+typedef enum rs2_time_source
+{
+    RS2_TIME_SOURCE_SYSTEM_CLOCK, /**< Wall clock of the host, follows its adjustments, including steps back */
+    RS2_TIME_SOURCE_MONOTONIC,    /**< Steady clock of the host, offset to read as the wall clock did when selected. Never goes back */
+    RS2_TIME_SOURCE_COUNT         /**< Number of enumeration values. Not a valid input: intended to be used in for-loops. */
+} rs2_time_source;
+const char* rs2_time_source_to_string(rs2_time_source source);
+
+/** \brief Latencies a latency probe measures for the frames handed to it */
+typedef enum rs2_latency_measure
+{
+    RS2_LATENCY_MEASURE_CAPTURE_TO_CALLBACK,  /**< From the backend handing the frame to the library until the frame reached the probe */
+    RS2_LATENCY_MEASURE_EXPOSURE_TO_CALLBACK, /**< From the middle of the exposure until the frame reached the probe, for frames in the global time domain only */
+    RS2_LATENCY_MEASURE_STIMULUS_TO_CALLBACK, /**< From a stimulus marked by rs2_latency_probe_mark_stimulus until the first frame seeing it reached the probe */
+    RS2_LATENCY_MEASURE_COUNT                 /**< Number of enumeration values. Not a valid input: intended to be used in for-loops. */
+} rs2_latency_measure;
+const char* rs2_latency_measure_to_string(rs2_latency_measure measure);
+
+/** \brief Distribution of a latency measured by a latency probe, in milliseconds */
+typedef struct rs2_latency_stats
+{
+    unsigned long long count; /**< Frames measured since the probe was created, the distribution is of the latest ones */
+    float mean;
+    float min;
+    float p50;
+    float p90;
+    float p99;
+    float max;
+} rs2_latency_stats;
+
 typedef struct rs2_device_info rs2_device_info;
 typedef struct rs2_device rs2_device;
 typedef struct rs2_error rs2_error;
 typedef struct rs2_raw_data_buffer rs2_raw_data_buffer;
 typedef struct rs2_frame rs2_frame;
 typedef struct rs2_frame_queue rs2_frame_queue;
+typedef struct rs2_frame_subscription rs2_frame_subscription;
 typedef struct rs2_pipeline rs2_pipeline;
 typedef struct rs2_pipeline_profile rs2_pipeline_profile;
 typedef struct rs2_config rs2_config;
@@ -112,6 +167,7 @@ typedef struct rs2_device_list rs2_device_list;
 typedef struct rs2_stream_profile_list rs2_stream_profile_list;
 typedef struct rs2_stream_profile rs2_stream_profile;
 typedef struct rs2_frame_callback rs2_frame_callback;
+typedef struct rs2_frame_allocator rs2_frame_allocator;
 typedef struct rs2_log_callback rs2_log_callback;
 typedef struct rs2_syncer rs2_syncer;
 typedef struct rs2_device_serializer rs2_device_serializer;
@@ -127,9 +183,17 @@ typedef struct rs2_options rs2_options;
 typedef struct rs2_devices_changed_callback rs2_devices_changed_callback;
 typedef struct rs2_notification rs2_notification;
 typedef struct rs2_notifications_callback rs2_notifications_callback;
+typedef struct rs2_frame_publisher rs2_frame_publisher;
+typedef struct rs2_thread_list rs2_thread_list;
+typedef struct rs2_metrics_snapshot rs2_metrics_snapshot;
+typedef struct rs2_latency_probe rs2_latency_probe;
+typedef struct rs2_dataset_reader rs2_dataset_reader;
+typedef struct rs2_dataset_batch rs2_dataset_batch;
 typedef void (*rs2_notification_callback_ptr)(rs2_notification*, void*);
 typedef void (*rs2_devices_changed_callback_ptr)(rs2_device_list*, rs2_device_list*, void*);
 typedef void (*rs2_frame_callback_ptr)(rs2_frame*, void*);
+typedef void* (*rs2_frame_alloc_ptr)(int, int, void*);
+typedef void (*rs2_frame_free_ptr)(void*, void*);
 typedef void (*rs2_frame_processor_callback_ptr)(rs2_frame**, int, rs2_source*, void*);
 
 typedef double      rs2_time_t;     /**< Timestamp format. units are milliseconds */
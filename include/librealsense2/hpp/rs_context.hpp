@@ -8,6 +8,10 @@
 #include "rs_record_playback.hpp"
 #include "rs_processing.hpp"
 
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+
 namespace rs2
 {
     class event_information
@@ -70,6 +74,7 @@ namespace rs2
 
     class pipeline;
     class device_hub;
+    class software_device;
 
     /**
     * default librealsense context class
@@ -102,6 +107,25 @@ namespace rs2
             return device_list(list);
         }
 
+        /**
+        * create a static snapshot of the connected devices, see rs2_query_devices_lightweight
+        * \param[in] lightweight  Enumerate the video interfaces only, the devices have no motion sensors
+        * \return                 the list of devices connected devices at the time of the call
+        */
+        device_list query_devices(bool lightweight) const
+        {
+            if (!lightweight)
+                return query_devices();
+
+            rs2_error* e = nullptr;
+            std::shared_ptr<rs2_device_list> list(
+                rs2_query_devices_lightweight(_context.get(), &e),
+                rs2_delete_device_list);
+            error::handle(e);
+
+            return device_list(list);
+        }
+
         /**
          * @brief Generate a flat list of all available sensors from all RealSense devices
          * @return List of sensors
@@ -166,9 +190,101 @@ namespace rs2
             rs2::error::handle(e);
         }
 
+        /**
+        * Process a recording on several threads, splitting its duration into equal time slices, see rs2_process_recording_slices
+        * \param[in] file       A recording or a manifest of a segmented recording
+        * \param[in] slices     Number of slices processed in parallel
+        * \param[in] warm_up    Time processed before each slice but the first, without results
+        * \param[in] process    Called as process(int slice, rs2::frameset fs, bool warm_up) concurrently for the slices, returns the result of the frameset
+        * \param[in] on_result  Called with each result, in the order of the recording, on the calling thread
+        */
+        template<class Process, class OnResult>
+        void process_recording_slices(const std::string& file, int slices, std::chrono::nanoseconds warm_up,
+                                      Process process, OnResult on_result)
+        {
+            typedef typename std::decay<decltype(process(0, std::declval<frameset>(), false))>::type result_type;
+
+            // Errors of the callbacks stop the processing and are rethrown as they are
+            struct slicing
+            {
+                slicing(Process process, OnResult on_result) : process(std::move(process)), on_result(std::move(on_result)) {}
+                void fail()
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (!error) error = std::current_exception();
+                }
+
+                Process process;
+                OnResult on_result;
+                std::mutex mutex;
+                std::exception_ptr error;
+            } state(std::move(process), std::move(on_result));
+
+            rs2_recording_slice_process_ptr process_slice = [](int slice, rs2_frame* f, int warm, void* user) -> void*
+            {
+                auto s = static_cast<slicing*>(user);
+                try
+                {
+                    frameset fs{ frame(f) };
+                    if (warm)
+                    {
+                        s->process(slice, fs, true);
+                        return nullptr;
+                    }
+                    return new result_type(s->process(slice, fs, false));
+                }
+                catch (...)
+                {
+                    s->fail();
+                    throw std::runtime_error("Failed to process a slice of the recording");
+                }
+            };
+            rs2_recording_slice_result_ptr deliver = [](void* result, void* user)
+            {
+                auto s = static_cast<slicing*>(user);
+                std::unique_ptr<result_type> r(static_cast<result_type*>(result));
+                try
+                {
+                    s->on_result(std::move(*r));
+                }
+                catch (...)
+                {
+                    s->fail();
+                    throw std::runtime_error("Failed to handle a result of the recording");
+                }
+            };
+            rs2_recording_slice_result_ptr release = [](void* result, void*)
+            {
+                delete static_cast<result_type*>(result);
+            };
+
+            rs2_error* e = nullptr;
+            rs2_process_recording_slices(_context.get(), file.c_str(), slices, static_cast<long long>(warm_up.count()),
+                                         process_slice, deliver, release, &state, &e);
+            if (state.error)
+            {
+                if (e) rs2_free_error(e);
+                std::rethrow_exception(state.error);
+            }
+            rs2::error::handle(e);
+        }
+
+        /**
+        * Select the clock of the system time of frames, shared by the contexts of the process
+        * \param[in] source  Clock to read the time from
+        */
+        void set_time_source(rs2_time_source source)
+        {
+            rs2_error* e = nullptr;
+            rs2_context_set_time_source(_context.get(), source, &e);
+            rs2::error::handle(e);
+        }
+
 protected:
         friend class rs2::pipeline;
         friend class rs2::device_hub;
+        friend class rs2::software_device;
+        friend class dataset_reader;
 
         context(std::shared_ptr<rs2_context> ctx)
             : _context(ctx)
@@ -226,5 +342,119 @@ protected:
         std::shared_ptr<rs2_device_hub> _device_hub;
     };
 
+    /**
+    * Batch of samples read from recordings by a dataset reader. Copies of it share its buffers
+    */
+    class dataset_batch
+    {
+    public:
+        dataset_batch() = default;
+
+        /**
+        * \return Number of samples of the batch
+        */
+        int size() const
+        {
+            rs2_error* e = nullptr;
+            auto size = rs2_dataset_batch_get_size(_batch.get(), &e);
+            error::handle(e);
+            return size;
+        }
+
+        /**
+        * \return Number of streams of the batch, as requested from the reader
+        */
+        int get_stream_count() const
+        {
+            rs2_error* e = nullptr;
+            auto count = rs2_dataset_batch_get_stream_count(_batch.get(), &e);
+            error::handle(e);
+            return count;
+        }
+
+        /**
+        * Get a stream of the batch, with its frames packed one after the other. Its buffers are valid as long as the batch
+        * \param[in] i    Index of the stream, in the order the streams were requested from the reader
+        */
+        rs2_dataset_stream get_stream(int i) const
+        {
+            rs2_error* e = nullptr;
+            rs2_dataset_stream stream;
+            rs2_dataset_batch_get_stream(_batch.get(), i, &stream, &e);
+            error::handle(e);
+            return stream;
+        }
+
+        /**
+        * \param[in] sample   Index of a sample of the batch
+        * \return Index of the recording the sample was read from
+        */
+        int get_file(int sample) const
+        {
+            rs2_error* e = nullptr;
+            auto file = rs2_dataset_batch_get_file(_batch.get(), sample, &e);
+            error::handle(e);
+            return file;
+        }
+
+        operator bool() const { return _batch != nullptr; }
+
+    private:
+        friend class dataset_reader;
+        explicit dataset_batch(std::shared_ptr<rs2_dataset_batch> batch) : _batch(std::move(batch)) {}
+
+        std::shared_ptr<rs2_dataset_batch> _batch;
+    };
+
+    /**
+    * Reads batches of samples from recordings for training models, see rs2_create_dataset_reader
+    */
+    class dataset_reader
+    {
+    public:
+        /**
+        * Start reading the recordings
+        * \param[in] ctx      The context of the playbacks
+        * \param[in] files    Recordings or manifests of segmented recordings
+        * \param[in] streams  Stream types and indices of the samples, -1 for any index
+        * \param[in] config   Settings of the reader, zeroed for the defaults
+        */
+        dataset_reader(const context& ctx, const std::vector<std::string>& files,
+                       const std::vector<std::pair<rs2_stream, int>>& streams, const rs2_dataset_config& config = rs2_dataset_config())
+        {
+            std::vector<const char*> file_names;
+            for (auto&& f : files) file_names.push_back(f.c_str());
+            std::vector<rs2_stream> types;
+            std::vector<int> indices;
+            for (auto&& s : streams)
+            {
+                types.push_back(s.first);
+                indices.push_back(s.second);
+            }
+
+            rs2_error* e = nullptr;
+            _reader = std::shared_ptr<rs2_dataset_reader>(
+                rs2_create_dataset_reader(ctx._context.get(), file_names.data(), static_cast<int>(file_names.size()),
+                                          types.data(), indices.data(), static_cast<int>(types.size()), &config, &e),
+                rs2_delete_dataset_reader);
+            error::handle(e);
+        }
+
+        /**
+        * Wait for the next batch of samples
+        * \return The batch, empty at the end of the recordings
+        */
+        dataset_batch next_batch() const
+        {
+            rs2_error* e = nullptr;
+            auto batch = rs2_dataset_reader_next_batch(_reader.get(), &e);
+            error::handle(e);
+            return batch ? dataset_batch(std::shared_ptr<rs2_dataset_batch>(batch, rs2_delete_dataset_batch)) : dataset_batch();
+        }
+
+    private:
+        std::shared_ptr<rs2_dataset_reader> _reader;
+    };
+
 }
 #endif // LIBREALSENSE_RS2_CONTEXT_HPP
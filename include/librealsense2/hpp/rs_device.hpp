@@ -94,6 +94,41 @@ namespace rs2
             error::handle(e);
         }
 
+        /**
+        * Capture the options of the sensors and the advanced mode tables of the device, see rs2_capture_device_state
+        * \return  the state, to be passed to restore_state
+        */
+        std::vector<uint8_t> capture_state() const
+        {
+            std::vector<uint8_t> results;
+
+            rs2_error* e = nullptr;
+            std::shared_ptr<const rs2_raw_data_buffer> state(
+                    rs2_capture_device_state(_dev.get(), &e),
+                    rs2_delete_raw_data);
+            error::handle(e);
+
+            auto size = rs2_get_raw_data_size(state.get(), &e);
+            error::handle(e);
+
+            auto start = rs2_get_raw_data(state.get(), &e);
+            error::handle(e);
+
+            results.insert(results.begin(), start, start + size);
+            return results;
+        }
+
+        /**
+        * Restore a state of the device captured by capture_state, after a hardware reset or a reconnection
+        * \param[in] state  the state returned by capture_state
+        */
+        void restore_state(const std::vector<uint8_t>& state) const
+        {
+            rs2_error* e = nullptr;
+            rs2_restore_device_state(_dev.get(), state.data(), static_cast<int>(state.size()), &e);
+            error::handle(e);
+        }
+
         device& operator=(const std::shared_ptr<rs2_device> dev)
         {
             _dev.reset();
@@ -178,6 +213,93 @@ namespace rs2
 
             return results;
         }
+
+        /**
+        * Send raw commands as one batch, see rs2_send_and_receive_raw_data_batch
+        * \param[in]  inputs        Raw data of the commands
+        * \param[out] received_ms   If non-null, receives for every command the milliseconds from the start of the batch until its response arrived
+        * \return The responses of the commands, in order
+        */
+        std::vector<std::vector<uint8_t>> send_and_receive_raw_data_batch(const std::vector<std::vector<uint8_t>>& inputs,
+                                                                          std::vector<double>* received_ms = nullptr) const
+        {
+            std::vector<const void*> commands;
+            std::vector<unsigned> sizes;
+            for (auto&& input : inputs)
+            {
+                commands.push_back(input.data());
+                sizes.push_back(static_cast<unsigned>(input.size()));
+            }
+            std::vector<const rs2_raw_data_buffer*> buffers(inputs.size(), nullptr);
+            std::vector<double> times(inputs.size());
+
+            rs2_error* e = nullptr;
+            rs2_send_and_receive_raw_data_batch(_dev.get(), commands.data(), sizes.data(), static_cast<int>(inputs.size()),
+                                                buffers.data(), times.data(), &e);
+            error::handle(e);
+
+            // Each buffer is owned before anything may throw, so none of them leaks
+            std::vector<std::shared_ptr<const rs2_raw_data_buffer>> lists;
+            for (auto buffer : buffers)
+                lists.emplace_back(buffer, rs2_delete_raw_data);
+
+            std::vector<std::vector<uint8_t>> results;
+            for (auto&& list : lists)
+            {
+                auto size = rs2_get_raw_data_size(list.get(), &e);
+                error::handle(e);
+                auto start = rs2_get_raw_data(list.get(), &e);
+                error::handle(e);
+                results.emplace_back(start, start + size);
+            }
+            if (received_ms) *received_ms = times;
+            return results;
+        }
+
+        /**
+        * Start reading the firmware logs on a background thread, into a ring of capacity entries that drops the oldest when full
+        * \param[in] capacity  number of entries the ring holds
+        */
+        void start_fw_log_capture(unsigned capacity = 1024) const
+        {
+            rs2_error* e = nullptr;
+            rs2_start_fw_log_capture(_dev.get(), capacity, &e);
+            error::handle(e);
+        }
+
+        void stop_fw_log_capture() const
+        {
+            rs2_error* e = nullptr;
+            rs2_stop_fw_log_capture(_dev.get(), &e);
+            error::handle(e);
+        }
+
+        /**
+        * Take the oldest captured firmware log entries, waiting up to the timeout while there are none
+        * \param[in] max_count   most entries to take
+        * \param[in] timeout_ms  longest time to wait for entries
+        * \return the raw entries as the firmware wrote them, concatenated
+        */
+        std::vector<uint8_t> fetch_fw_logs(unsigned max_count, unsigned timeout_ms) const
+        {
+            std::vector<uint8_t> results;
+
+            rs2_error* e = nullptr;
+            std::shared_ptr<const rs2_raw_data_buffer> list(
+                    rs2_fetch_fw_logs(_dev.get(), max_count, timeout_ms, &e),
+                    rs2_delete_raw_data);
+            error::handle(e);
+
+            auto size = rs2_get_raw_data_size(list.get(), &e);
+            error::handle(e);
+
+            auto start = rs2_get_raw_data(list.get(), &e);
+            error::handle(e);
+
+            results.insert(results.begin(), start, start + size);
+
+            return results;
+        }
     };
 
     class device_list
@@ -221,6 +343,35 @@ namespace rs2
             return device(dev);
         }
 
+        /**
+        * Creates all the devices of the list, opening and initializing them concurrently
+        * Throws the error of the first device that failed, once all of them are done
+        * \return            the devices, in the order of the list
+        */
+        std::vector<device> create_all() const
+        {
+            auto count = size();
+            std::vector<rs2_device*> devs(count);
+            std::vector<rs2_error*> errors(count);
+            rs2_error* e = nullptr;
+            rs2_create_devices(_list.get(), devs.data(), errors.data(), &e);
+            error::handle(e);
+
+            std::vector<device> results;
+            rs2_error* first_error = nullptr;
+            for (uint32_t i = 0; i < count; i++)
+            {
+                if (devs[i])
+                    results.push_back(device(std::shared_ptr<rs2_device>(devs[i], rs2_delete_device)));
+                if (errors[i] && first_error)
+                    rs2_free_error(errors[i]);
+                else if (errors[i])
+                    first_error = errors[i];
+            }
+            error::handle(first_error);
+            return results;
+        }
+
         uint32_t size() const
         {
             rs2_error* e = nullptr;
@@ -285,5 +436,44 @@ namespace rs2
     private:
         std::shared_ptr<rs2_device_list> _list;
     };
+
+    class frame_publisher
+    {
+    public:
+        /**
+        * Publish the video frames of a device to other processes, where it is listed as a shared device
+        * The sensors of the device must not be streaming, their frame allocators are replaced
+        * \param[in] dev    device whose frames are published
+        * \param[in] name   name of the shared device, unique on this machine
+        * \param[in] slots  number of frames in shared memory, 0 for the default
+        */
+        frame_publisher(device dev, const std::string& name, int slots = 0)
+        {
+            rs2_error* e = nullptr;
+            _publisher = std::shared_ptr<rs2_frame_publisher>(
+                rs2_create_frame_publisher(dev.get().get(), name.c_str(), slots, &e),
+                rs2_delete_frame_publisher);
+            error::handle(e);
+        }
+
+        /**
+        * Publish a frame of the device, composite frames publish the frames they hold
+        * \param[in] f  frame to publish
+        */
+        void publish(const frame& f) const
+        {
+            rs2_error* e = nullptr;
+            rs2_publish_frame(_publisher.get(), f.get(), &e);
+            error::handle(e);
+        }
+
+        void operator()(frame f) const
+        {
+            publish(f);
+        }
+
+    private:
+        std::shared_ptr<rs2_frame_publisher> _publisher;
+    };
 }
 #endif // LIBREALSENSE_RS2_DEVICE_HPP
@@ -16,6 +16,7 @@ namespace rs2
     class sensor;
     class frame;
     class pipeline_profile;
+    class software_sensor;
 
     class stream_profile
     {
@@ -82,6 +83,7 @@ namespace rs2
         friend class rs2::sensor;
         friend class rs2::frame;
         friend class rs2::pipeline_profile;
+        friend class rs2::software_sensor;
 
         explicit stream_profile(const rs2_stream_profile* profile) : _profile(profile)
         {
@@ -231,6 +233,51 @@ namespace rs2
             return r != 0;
         }
 
+        /** retrieve all the metadata of the frame in one call
+        * \return            the value of every frame_metadata the frame has
+        */
+        std::map<rs2_frame_metadata_value, rs2_metadata_type> get_frame_metadata_all() const
+        {
+            std::vector<rs2_metadata_type> values(::RS2_FRAME_METADATA_COUNT);
+            std::vector<int> supported(::RS2_FRAME_METADATA_COUNT);
+            rs2_error* e = nullptr;
+            rs2_get_frame_metadata_all(frame_ref, values.data(), supported.data(), static_cast<int>(values.size()), &e);
+            error::handle(e);
+
+            std::map<rs2_frame_metadata_value, rs2_metadata_type> res;
+            for (size_t i = 0; i < values.size(); i++)
+            {
+                if (supported[i])
+                    res[static_cast<rs2_frame_metadata_value>(i)] = values[i];
+            }
+            return res;
+        }
+
+        /** retrieve the data, dimensions, number, timestamp and profile of the frame in one call, for loops
+        * handling every frame
+        * \return            the fields of the frame, the data pointer being valid while the frame is held
+        */
+        rs2_frame_view get_view() const
+        {
+            rs2_frame_view view;
+            rs2_error* e = nullptr;
+            rs2_get_frame_view(frame_ref, &view, &e);
+            error::handle(e);
+            return view;
+        }
+
+        /** retrieve the timestamps recorded while latency instrumentation is enabled
+        * \return            timestamp of every stage in milliseconds, indexed by rs2_frame_latency_stage. Stages the frame did not go through are zero
+        */
+        std::vector<rs2_time_t> get_latency_breakdown() const
+        {
+            std::vector<rs2_time_t> res(RS2_FRAME_LATENCY_STAGE_COUNT);
+            rs2_error* e = nullptr;
+            rs2_get_frame_latency_breakdown(frame_ref, res.data(), static_cast<int>(res.size()), &e);
+            error::handle(e);
+            return res;
+        }
+
         /**
         * retrieve frame number (from frame handle)
         * \return               the frame nubmer of the frame, in milliseconds since the device was started
@@ -255,6 +302,18 @@ namespace rs2
             return r;
         }
 
+        /**
+        * retrieve the size of the frame data
+        * \return               the size of the frame data in bytes
+        */
+        int get_data_size() const
+        {
+            rs2_error* e = nullptr;
+            auto r = rs2_get_frame_data_size(frame_ref, &e);
+            error::handle(e);
+            return r;
+        }
+
         stream_profile get_profile() const
         {
             rs2_error* e = nullptr;
@@ -361,6 +420,19 @@ namespace rs2
             return r;
         }
 
+        /**
+        * convert the pixels of the frame into a buffer of the application in one pass, see rs2_copy_frame_to for the conversions
+        * \param[out] dst    buffer of at least stride times the height of the frame bytes, one and a half times that for RS2_FORMAT_NV12
+        * \param[in] format  format of the pixels written to dst
+        * \param[in] stride  bytes from the start of a row of dst to the start of the next, zero for rows without padding
+        */
+        void copy_to(void* dst, rs2_format format, int stride = 0) const
+        {
+            rs2_error* e = nullptr;
+            rs2_copy_frame_to(get(), dst, stride, format, &e);
+            error::handle(e);
+        }
+
         /**
         * retrieve bits per pixel
         * \return            number of bits per one pixel
@@ -376,6 +448,48 @@ namespace rs2
         int get_bytes_per_pixel() const { return get_bits_per_pixel() / 8; }
     };
 
+    /** \brief Pixels of one side of an interleaved stereo frame, stepping over the pixels of the other side */
+    struct strided_view
+    {
+        const uint8_t* data;    /**< First pixel of the view */
+        int width;
+        int height;
+        int pixel_step;         /**< Bytes from a pixel to the next one of its row */
+        int row_step;           /**< Bytes from a row to the next one */
+
+        uint8_t at(int x, int y) const { return data[y * row_step + x * pixel_step]; }
+    };
+
+    /** \brief Frame of the RS2_FORMAT_Y8I format, both infrared images interleaved as the camera sends them */
+    class stereo_frame : public video_frame
+    {
+    public:
+        stereo_frame(const frame& f)
+            : video_frame(f)
+        {
+            if (*this && get_profile().format() != RS2_FORMAT_Y8I)
+                reset();
+        }
+
+        /**
+        * retrieve the view of the left infrared image, valid as long as the frame is held
+        * \return            view of the even bytes of every row
+        */
+        strided_view get_left_view() const { return get_view(0); }
+
+        /**
+        * retrieve the view of the right infrared image, valid as long as the frame is held
+        * \return            view of the odd bytes of every row
+        */
+        strided_view get_right_view() const { return get_view(1); }
+
+    private:
+        strided_view get_view(int side) const
+        {
+            return{ static_cast<const uint8_t*>(get_data()) + side, get_width(), get_height(), 2, get_stride_in_bytes() };
+        }
+    };
+
     struct vertex {
         float x, y, z;
         operator const float*() const { return &x; }
@@ -424,11 +538,61 @@ namespace rs2
             return (const texture_coordinate*)res;
         }
 
+        rs2_format get_vertex_format() const
+        {
+            rs2_error* e = nullptr;
+            auto res = rs2_get_frame_vertex_format(get(), &e);
+            error::handle(e);
+            return res;
+        }
+
+        const int* get_pixel_indices() const
+        {
+            rs2_error* e = nullptr;
+            auto res = rs2_get_frame_point_indices(get(), &e);
+            error::handle(e);
+            return res;
+        }
+
+        /**
+        * retrieve the unit normals of the vertices, see rs2_get_frame_normals, or null when the points carry none
+        */
+        const vertex* get_normals() const
+        {
+            rs2_error* e = nullptr;
+            auto res = rs2_get_frame_normals(get(), &e);
+            error::handle(e);
+            return (const vertex*)res;
+        }
+
         size_t size() const
         {
             return _size;
         }
 
+        /**
+        * Writes the points that have depth to a binary PLY file, coordinates in meters
+        * \param[in] fname    Path of the file
+        * \param[in] texture  Frame of 8 bit per channel color or Y8 format the points are colored from,
+        *                     or an empty frame to write their texture coordinates instead
+        */
+        void export_to_ply(const std::string& fname, const frame& texture = frame()) const
+        {
+            rs2_error* e = nullptr;
+            rs2_export_to_ply(get(), fname.c_str(), texture.get(), &e);
+            error::handle(e);
+        }
+
+        /**
+        * Writes the points that have depth to a binary PCD file, colored from the texture when one is given
+        */
+        void export_to_pcd(const std::string& fname, const frame& texture = frame()) const
+        {
+            rs2_error* e = nullptr;
+            rs2_export_to_pcd(get(), fname.c_str(), texture.get(), &e);
+            error::handle(e);
+        }
+
     private:
         size_t _size;
     };
@@ -454,6 +618,53 @@ namespace rs2
             error::handle(e);
             return r;
         }
+
+        /**
+        * retrieve the distances of all the pixels at once, much faster than get_distance on each of them
+        * \param[out] distances  buffer of get_width() times get_height() floats, receiving the distances in meters row by row
+        */
+        void get_distances(float* distances) const
+        {
+            copy_to(distances, RS2_FORMAT_DISTANCE);
+        }
+
+        std::vector<float> get_distances() const
+        {
+            std::vector<float> distances(size_t(get_width()) * get_height());
+            get_distances(distances.data());
+            return distances;
+        }
+
+        /**
+        * retrieve the statistics a depth statistics block attached to the frame
+        * \param[out] statistics  receives the statistics of the frame
+        * \return                 true when the frame has statistics
+        */
+        bool get_statistics(rs2_depth_statistics* statistics) const
+        {
+            rs2_error* e = nullptr;
+            auto r = rs2_depth_frame_get_statistics(get(), statistics, &e);
+            error::handle(e);
+            return r != 0;
+        }
+
+        /**
+        * retrieve the histogram of distances a depth statistics block attached to the frame, empty when it has none
+        */
+        std::vector<unsigned int> get_histogram() const
+        {
+            rs2_error* e = nullptr;
+            auto count = rs2_depth_frame_get_histogram(get(), nullptr, 0, &e);
+            error::handle(e);
+
+            std::vector<unsigned int> bins(count);
+            if (count)
+            {
+                rs2_depth_frame_get_histogram(get(), bins.data(), count, &e);
+                error::handle(e);
+            }
+            return bins;
+        }
     };
     class frameset : public frame
     {
@@ -480,14 +691,11 @@ namespace rs2
 
         frame first_or_default(rs2_stream s) const
         {
-            frame result;
-            foreach([&result, s](frame f){
-                if (!result && f.get_profile().stream_type() == s)
-                {
-                    result = std::move(f);
-                }
-            });
-            return result;
+            if (!get()) return frame();
+            rs2_error* e = nullptr;
+            auto fref = rs2_extract_frame_by_stream(get(), s, &e);
+            error::handle(e);
+            return frame(fref);
         }
 
         frame first(rs2_stream s) const
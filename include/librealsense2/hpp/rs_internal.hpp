@@ -5,6 +5,8 @@
 #define LIBREALSENSE_RS2_INTERNAL_HPP
 
 #include "rs_types.hpp"
+#include "rs_context.hpp"
+#include "rs_sensor.hpp"
 #include "../h/rs_internal.h"
 
 namespace rs2
@@ -37,13 +39,15 @@ namespace rs2
         * create librealsense context that given a file will respond to calls exactly as the recording did
         * if the user calls a method that was either not called during recording or violates causality of the recording error will be thrown
         * \param[in] filename string of the name of the file
+        * \param[in] cache_frames keep the recorded frames in memory once read, for benchmarks replaying the recording
         */
         mock_context(const std::string& filename,
-                     const std::string& section = "")
+                     const std::string& section = "",
+                     bool cache_frames = false)
         {
             rs2_error* e = nullptr;
             _context = std::shared_ptr<rs2_context>(
-                rs2_create_mock_context(RS2_API_VERSION, filename.c_str(), section.c_str(), &e),
+                rs2_create_mock_context_ex(RS2_API_VERSION, filename.c_str(), section.c_str(), cache_frames ? 1 : 0, &e),
                 rs2_delete_context);
             error::handle(e);
         }
@@ -51,6 +55,128 @@ namespace rs2
         mock_context() = delete;
     };
 
+    class software_sensor : public sensor
+    {
+    public:
+        software_sensor(sensor s)
+            : sensor(s.get())
+        {
+            rs2_error* e = nullptr;
+            if (rs2_is_sensor_extendable_to(_sensor.get(), RS2_EXTENSION_SOFTWARE_SENSOR, &e) == 0 && !e)
+            {
+                _sensor = nullptr;
+            }
+            error::handle(e);
+        }
+
+        /**
+        * Add a video stream profile to the sensor, before it is opened
+        * \param[in] video_stream  definition of the profile, profiles of the same stream type and index belong to the same stream
+        * \return                  the profile, to open the sensor with and to inject frames of
+        */
+        stream_profile add_video_stream(rs2_video_stream video_stream)
+        {
+            rs2_error* e = nullptr;
+            stream_profile profile(rs2_software_sensor_add_video_stream(_sensor.get(), video_stream, &e));
+            error::handle(e);
+            return profile;
+        }
+
+        /**
+        * Inject a video frame. With a deleter the pixels are adopted without copying, and the deleter is called once the library
+        * no longer needs them, also when the frame is dropped or the call fails
+        * \param[in] frame  the frame, of one of the profiles of the sensor
+        */
+        void on_video_frame(rs2_software_video_frame frame)
+        {
+            rs2_error* e = nullptr;
+            rs2_software_sensor_on_video_frame(_sensor.get(), frame, &e);
+            error::handle(e);
+        }
+
+        /**
+        * Add a read-only option to the sensor, or update its value, such as the RS2_OPTION_DEPTH_UNITS of a depth sensor
+        * \param[in] option  the option
+        * \param[in] val     value of the option
+        */
+        void add_read_only_option(rs2_option option, float val)
+        {
+            rs2_error* e = nullptr;
+            rs2_software_sensor_add_read_only_option(_sensor.get(), option, val, &e);
+            error::handle(e);
+        }
+
+        operator bool() const { return _sensor.get() != nullptr; }
+
+    private:
+        friend class software_device;
+
+        explicit software_sensor(std::shared_ptr<rs2_sensor> s) : sensor(s) {}
+    };
+
+    class software_device : public device
+    {
+    public:
+        /**
+        * Create a software device and add it to the context, so that pipelines of the context and the devices it lists include it
+        * \param[in] ctx   context to add the device to
+        * \param[in] name  unique name of the device in the context, reported as its serial number
+        */
+        software_device(const context& ctx, const std::string& name)
+            : device(create(ctx, name))
+        {
+        }
+
+        software_device(device d)
+            : device(d.get())
+        {
+            rs2_error* e = nullptr;
+            if (rs2_is_device_extendable_to(_dev.get(), RS2_EXTENSION_SOFTWARE_DEVICE, &e) == 0 && !e)
+            {
+                _dev = nullptr;
+            }
+            error::handle(e);
+        }
+
+        /**
+        * Add a sensor to the device, before the device is streaming
+        * \param[in] name  name of the sensor
+        */
+        software_sensor add_sensor(const std::string& name)
+        {
+            rs2_error* e = nullptr;
+            std::shared_ptr<rs2_sensor> sensor(
+                rs2_software_device_add_sensor(_dev.get(), name.c_str(), &e),
+                rs2_delete_sensor);
+            error::handle(e);
+            return software_sensor(sensor);
+        }
+
+        /**
+        * Register the extrinsics between two streams of the device
+        * \param[in] from        profile of the origin stream
+        * \param[in] to          profile of the target stream
+        * \param[in] extrinsics  extrinsics from the origin to the target
+        */
+        void register_extrinsics(const stream_profile& from, const stream_profile& to, const rs2_extrinsics& extrinsics)
+        {
+            rs2_error* e = nullptr;
+            rs2_software_device_register_extrinsics(_dev.get(), from.get(), to.get(), extrinsics, &e);
+            error::handle(e);
+        }
+
+    private:
+        static std::shared_ptr<rs2_device> create(const context& ctx, const std::string& name)
+        {
+            rs2_error* e = nullptr;
+            std::shared_ptr<rs2_device> dev(
+                rs2_context_add_software_device(ctx._context.get(), name.c_str(), &e),
+                rs2_delete_device);
+            error::handle(e);
+            return dev;
+        }
+    };
+
     namespace internal
     {
         /**
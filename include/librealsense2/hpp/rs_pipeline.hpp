@@ -7,6 +7,7 @@
 #include "rs_types.hpp"
 #include "rs_frame.hpp"
 #include "rs_context.hpp"
+#include "rs_processing.hpp"
 
 namespace rs2
 {
@@ -49,6 +50,22 @@ namespace rs2
             return results;
         }
 
+        /**
+        * Retrieve the frames of a stream dropped at each stage of the pipeline since it started, and the current depth of
+        * every stage queue. Available while the pipeline streams with this profile
+        *
+        * \param[in] stream   One of the streams of the profile
+        * \return             Drop counters and queue depths, indexed by rs2_frame_drop_stage
+        */
+        rs2_frame_drop_stats get_frame_drops(const stream_profile& stream) const
+        {
+            rs2_error* e = nullptr;
+            rs2_frame_drop_stats stats;
+            rs2_pipeline_profile_get_frame_drops(_pipeline_profile.get(), stream.get(), &stats, &e);
+            error::handle(e);
+            return stats;
+        }
+
         /**
         * Return the selected stream profile, which are enabled in this profile.
         *
@@ -242,6 +259,22 @@ namespace rs2
             error::handle(e);
         }
 
+        /**
+        * Requires that the resolved device would be recorded to file, with the given file settings
+        *
+        * \param[in] file_name            The desired file for the output record
+        * \param[in] compression          Compression of the recorded chunks
+        * \param[in] chunk_size           Bytes of messages gathered in a chunk before it is compressed and written, 0 for the default
+        * \param[in] compression_threads  Number of threads compressing chunks in the background, 0 compresses them on the recording thread
+        */
+        void enable_record_to_file(const std::string& file_name, rs2_record_compression compression,
+            unsigned int chunk_size = 0, unsigned int compression_threads = 0)
+        {
+            rs2_error* e = nullptr;
+            rs2_config_enable_record_to_file_ex(_config.get(), file_name.c_str(), compression, chunk_size, compression_threads, &e);
+            error::handle(e);
+        }
+
         /**
         * Disable a device stream explicitly, to remove any requests on this stream profile.
         * The stream can still be enabled due to pipeline computer vision module request. This call removes any filter on the
@@ -268,6 +301,42 @@ namespace rs2
             error::handle(e);
         }
 
+        /**
+        * Bound the time the pipeline synchronization holds frames of a stream waiting for the frames of the other streams.
+        * Past the bound, the frames set is delivered without the streams still missing, so a stalled stream does not delay
+        * the others
+        *
+        * \param[in] stream       Stream type the bound applies to, RS2_STREAM_ANY sets the default of the other streams
+        * \param[in] max_wait_ms  Longest wait in milliseconds, zero waits for the whole set without a bound
+        */
+        void set_sync_max_wait(rs2_stream stream, float max_wait_ms)
+        {
+            rs2_error* e = nullptr;
+            rs2_config_set_sync_max_wait(_config.get(), stream, max_wait_ms, &e);
+            error::handle(e);
+        }
+
+        /**
+        * Set how many frames sets the pipeline queues for \c wait_for_frames() and \c poll_for_frames(). Once the queue
+        * is full, the oldest set is dropped for each new one
+        *
+        * \param[in] size      Number of frames sets to queue, 10 by default
+        */
+        void set_frames_queue_size(int size)
+        {
+            rs2_error* e = nullptr;
+            rs2_config_set_frames_queue_size(_config.get(), size, &e);
+            error::handle(e);
+        }
+
+        /**
+        * Queue only the latest frames set, for real-time consumers that should never process stale data
+        */
+        void enable_latest_only()
+        {
+            set_frames_queue_size(1);
+        }
+
         /**
         * Resolve the configuration filters, to find a matching device and streams profiles.
         * The method resolves the user configuration filters for the device and streams, and combines them with the requirements
@@ -403,6 +472,48 @@ namespace rs2
             return pipeline_profile(p);
         }
 
+        /**
+        * Prepare the pipeline to start, doing all of the work of \c start() except for delivering frames, so that
+        * \c start_prepared() gets the first frame within about a frame period. The device streams while prepared,
+        * \c stop() releases it when the pipeline is not started after all.
+        *
+        * \param[in] config   A rs2::config with requested filters on the pipeline configuration. By default no filters are applied.
+        * \return             The device and streams profile the pipeline will stream.
+        */
+        pipeline_profile prepare(const config& config)
+        {
+            rs2_error* e = nullptr;
+            auto p = std::shared_ptr<rs2_pipeline_profile>(
+                rs2_pipeline_prepare(_pipeline.get(), config.get().get(), &e),
+                rs2_delete_pipeline_profile);
+
+            error::handle(e);
+            return pipeline_profile(p);
+        }
+
+        /**
+        * Prepare the pipeline to start with its default configuration, see \c prepare(const config&)
+        */
+        pipeline_profile prepare()
+        {
+            return prepare(config());
+        }
+
+        /**
+        * Start the pipeline prepared by \c prepare()
+        * \return             The actual pipeline device and streams profile, as returned by \c prepare()
+        */
+        pipeline_profile start_prepared()
+        {
+            rs2_error* e = nullptr;
+            auto p = std::shared_ptr<rs2_pipeline_profile>(
+                rs2_pipeline_start_prepared(_pipeline.get(), &e),
+                rs2_delete_pipeline_profile);
+
+            error::handle(e);
+            return pipeline_profile(p);
+        }
+
 
         /**
         * Stop the pipeline streaming.
@@ -418,6 +529,48 @@ namespace rs2
             error::handle(e);
         }
 
+        /**
+        * Attach a processing graph running on every synchronized frames set before it is delivered by \c wait_for_frames()
+        * or \c poll_for_frames(). The output of the graph must be frames sets, such as the output of align.
+        * The graph takes effect on the next start of the pipeline.
+        *
+        * \param[in] graph   The processing graph to run
+        */
+        void set_processing_graph(const processing_graph& graph)
+        {
+            rs2_error* e = nullptr;
+            rs2_pipeline_set_processing_graph(_pipeline.get(), graph.get().get(), &e);
+            error::handle(e);
+        }
+
+        /**
+        * Retrieve the counters of the complete and partial frames sets the pipeline synchronization released since the
+        * pipeline was last started, and of the frames it dropped
+        */
+        rs2_sync_stats get_sync_stats() const
+        {
+            rs2_error* e = nullptr;
+            rs2_sync_stats stats;
+            rs2_pipeline_get_sync_stats(_pipeline.get(), &stats, &e);
+            error::handle(e);
+            return stats;
+        }
+
+        /**
+        * Subscribe to the frames sets of the pipeline, in a queue of their own besides the one of wait_for_frames().
+        * Subscribers share the frames, so several consumers of the same frames sets need no copies, and a slow or paused
+        * subscriber drops only its own frames sets. The subscription lasts across restarts of the pipeline
+        * \param[in] capacity  frames sets the subscription queues before dropping
+        * \param[in] policy    frames set dropped when the queue is full, RS2_QUEUE_POLICY_DROP_OLDEST or RS2_QUEUE_POLICY_DROP_NEWEST
+        */
+        frame_subscription subscribe(int capacity = 1, rs2_queue_policy policy = RS2_QUEUE_POLICY_DROP_OLDEST) const
+        {
+            rs2_error* e = nullptr;
+            auto subscription = rs2_pipeline_subscribe(_pipeline.get(), capacity, policy, &e);
+            error::handle(e);
+            return frame_subscription(subscription);
+        }
+
         /**
         * Wait until a new set of frames becomes available.
         * The frames set includes time-synchronized frames of each enabled stream in the pipeline.
@@ -471,6 +624,28 @@ namespace rs2
             return res > 0;
         }
 
+        /**
+        * Wait until a new set of frames becomes available, and retrieve it along with the other sets already queued,
+        * oldest first. Suits consumers processing frames sets in batches, such as recorders, together with a frames queue
+        * deep enough to hold a batch, see \c config::set_frames_queue_size()
+        *
+        * \param[in] max_count    Most frames sets to retrieve
+        * \param[in] timeout_ms   Max time in milliseconds to wait for the first frames set until an exception will be thrown
+        * \return                 Between one and max_count sets of time synchronized frames
+        */
+        std::vector<frameset> wait_for_frames_batch(int max_count, unsigned int timeout_ms = 5000) const
+        {
+            std::vector<rs2_frame*> refs(max_count > 0 ? max_count : 0);
+            rs2_error* e = nullptr;
+            auto count = rs2_pipeline_wait_for_frames_batch(_pipeline.get(), refs.data(), max_count, timeout_ms, &e);
+            error::handle(e);
+
+            std::vector<frameset> result;
+            for (int i = 0; i < count; i++)
+                result.push_back(frameset(frame(refs[i])));
+            return result;
+        }
+
         /**
         * Return the active device and streams profiles, used by the pipeline.
         * The pipeline streams profiles are selected during \c start(). The method returns a valid result only when the pipeline is active -
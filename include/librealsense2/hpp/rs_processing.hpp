@@ -64,7 +64,7 @@ namespace rs2
     {
         T on_frame_function;
     public:
-        explicit frame_processor_callback(T on_frame) : on_frame_function(on_frame) {}
+        explicit frame_processor_callback(T on_frame) : on_frame_function(std::move(on_frame)) {}
 
         void on_frame(rs2_frame* f, rs2_source * source) override
         {
@@ -76,55 +76,6 @@ namespace rs2
         void release() override { delete this; }
     };
 
-    class processing_block : public options
-    {
-    public:
-        template<class S>
-        void start(S on_frame)
-        {
-            rs2_error* e = nullptr;
-            rs2_start_processing(_block.get(), new frame_callback<S>(on_frame), &e);
-            error::handle(e);
-        }
-
-        void invoke(frame f) const
-        {
-            rs2_frame* ptr = nullptr;
-            std::swap(f.frame_ref, ptr);
-
-            rs2_error* e = nullptr;
-            rs2_process_frame(_block.get(), ptr, &e);
-            error::handle(e);
-        }
-
-        void operator()(frame f) const
-        {
-            invoke(std::move(f));
-        }
-
-        processing_block(std::shared_ptr<rs2_processing_block> block)
-            : options((rs2_options*)block.get()),_block(block)
-        {
-        }
-
-        template<class S>
-        processing_block(S processing_function)
-        {
-           rs2_error* e = nullptr;
-            _block = std::shared_ptr<rs2_processing_block>(
-                        rs2_create_processing_block(new frame_processor_callback<S>(processing_function),&e),
-                        rs2_delete_processing_block);
-            options::operator=(_block);
-            error::handle(e);
-        }
-
-        operator rs2_options*() const { return (rs2_options*)_block.get(); }
-
-    private:
-        std::shared_ptr<rs2_processing_block> _block;
-    };
-
-
     class frame_queue
     {
     public:
@@ -187,23 +138,171 @@ namespace rs2
         }
 
     private:
+        friend class processing_block;
+
         std::shared_ptr<rs2_frame_queue> _queue;
     };
 
-    class pointcloud
+    /**
+        Queue of its own of the output of a processing block or a pipeline, see processing_block::subscribe and
+        pipeline::subscribe. Subscribers share the frames and drop only their own, the subscription ends with its last copy
+    */
+    class frame_subscription
+    {
+    public:
+        /**
+        * wait until a frame is available to the subscription and dequeue it
+        * \param[in] timeout_ms  max time in milliseconds to wait
+        */
+        frame wait_for_frame(unsigned int timeout_ms = 5000) const
+        {
+            rs2_error* e = nullptr;
+            auto frame_ref = rs2_subscription_wait_for_frame(_subscription.get(), timeout_ms, &e);
+            error::handle(e);
+            return{ frame_ref };
+        }
+
+        /**
+        * dequeue a frame of the subscription if one is available
+        * \param[out] f  frame handle
+        * \return true if a frame was stored to f
+        */
+        bool poll_for_frame(frame* f) const
+        {
+            rs2_error* e = nullptr;
+            rs2_frame* frame_ref = nullptr;
+            auto res = rs2_subscription_poll_for_frame(_subscription.get(), &frame_ref, &e);
+            error::handle(e);
+            if (res) *f = { frame_ref };
+            return res > 0;
+        }
+
+        /**
+        * pause or resume the subscription, a paused subscription releases its frames and queues none until resumed
+        */
+        void set_paused(bool paused) const
+        {
+            rs2_error* e = nullptr;
+            rs2_subscription_set_paused(_subscription.get(), paused ? 1 : 0, &e);
+            error::handle(e);
+        }
+
+        /**
+        * frames the subscription dropped as its queue was full
+        */
+        unsigned long long get_dropped_frames() const
+        {
+            rs2_error* e = nullptr;
+            auto dropped = rs2_subscription_get_dropped_frames(_subscription.get(), &e);
+            error::handle(e);
+            return dropped;
+        }
+
+        explicit frame_subscription(rs2_frame_subscription* subscription)
+            : _subscription(subscription, rs2_delete_frame_subscription)
+        {
+        }
+
+    private:
+        std::shared_ptr<rs2_frame_subscription> _subscription;
+    };
+
+    class processing_block : public options
+    {
+    public:
+        template<class S>
+        void start(S on_frame)
+        {
+            rs2_error* e = nullptr;
+            rs2_start_processing(_block.get(), new frame_callback<S>(std::move(on_frame)), &e);
+            error::handle(e);
+        }
+
+        /**
+        * Direct the output of the block to a frame queue. The library moves the frames into the queue itself,
+        * without calling back into the application for every frame
+        * \param[in] queue  Queue to receive the frames, kept alive for as long as the block may write to it
+        */
+        void start(const frame_queue& queue)
+        {
+            rs2_error* e = nullptr;
+            rs2_start_processing_queue(_block.get(), queue._queue.get(), &e);
+            error::handle(e);
+        }
+
+        void invoke(frame f) const
+        {
+            rs2_frame* ptr = nullptr;
+            std::swap(f.frame_ref, ptr);
+
+            rs2_error* e = nullptr;
+            rs2_process_frame(_block.get(), ptr, &e);
+            error::handle(e);
+        }
+
+        void operator()(frame f) const
+        {
+            invoke(std::move(f));
+        }
+
+        /**
+        * Subscribe to the output of the block, in addition to its callback or queue
+        * \param[in] capacity  frames the subscription queues before dropping
+        * \param[in] policy    frame dropped when the queue is full, RS2_QUEUE_POLICY_DROP_OLDEST or RS2_QUEUE_POLICY_DROP_NEWEST
+        */
+        frame_subscription subscribe(int capacity = 1, rs2_queue_policy policy = RS2_QUEUE_POLICY_DROP_OLDEST) const
+        {
+            rs2_error* e = nullptr;
+            auto subscription = rs2_processing_block_subscribe(_block.get(), capacity, policy, &e);
+            error::handle(e);
+            return frame_subscription(subscription);
+        }
+
+        processing_block(std::shared_ptr<rs2_processing_block> block)
+            : options((rs2_options*)block.get()),_block(block)
+        {
+        }
+
+        template<class S>
+        processing_block(S processing_function)
+        {
+           rs2_error* e = nullptr;
+            _block = std::shared_ptr<rs2_processing_block>(
+                        rs2_create_processing_block(new frame_processor_callback<S>(processing_function),&e),
+                        rs2_delete_processing_block);
+            options::operator=(_block);
+            error::handle(e);
+        }
+
+        operator rs2_options*() const { return (rs2_options*)_block.get(); }
+
+        rs2_processing_block* get() const { return _block.get(); }
+
+    private:
+        friend class processing_graph;
+        friend class asynchronous_syncer;
+
+        std::shared_ptr<rs2_processing_block> _block;
+    };
+
+
+    class pointcloud : public options
     {
     public:
         pointcloud() :  _queue(1)
         {
             rs2_error* e = nullptr;
 
-            _block = std::make_shared<processing_block>(
-                                std::shared_ptr<rs2_processing_block>(
-                                                    rs2_create_pointcloud(&e),
-                                                    rs2_delete_processing_block));
+            auto pb = std::shared_ptr<rs2_processing_block>(
+                                rs2_create_pointcloud(&e),
+                                rs2_delete_processing_block);
+            _block = std::make_shared<processing_block>(pb);
 
             error::handle(e);
 
+            // Redirect options API to the processing block
+            options::operator=(pb);
+
             _block->start(_queue);
         }
 
@@ -221,9 +320,11 @@ namespace rs2
         }
     private:
         friend class context;
+        friend class processing_graph;
 
-        std::shared_ptr<processing_block> _block;
+        // Declared first so the block, which may still be delivering pipelined frames, is released before the queue
         frame_queue _queue;
+        std::shared_ptr<processing_block> _block;
     };
 
     class asynchronous_syncer
@@ -250,6 +351,30 @@ namespace rs2
         {
             _processing_block->operator()(std::move(f));
         }
+
+        /**
+        * Bound the time frames of a stream wait for their match, past which they leave in a partial frameset
+        * \param[in] stream       Stream type the bound applies to, RS2_STREAM_ANY sets the default of the other streams
+        * \param[in] max_wait_ms  Longest wait in milliseconds, zero waits without a bound
+        */
+        void set_max_wait(rs2_stream stream, float max_wait_ms)
+        {
+            rs2_error* e = nullptr;
+            rs2_sync_set_max_wait(_processing_block->_block.get(), stream, max_wait_ms, &e);
+            error::handle(e);
+        }
+
+        /**
+        * Retrieve the counters of the complete and partial framesets released so far, and of the frames dropped
+        */
+        rs2_sync_stats get_stats() const
+        {
+            rs2_error* e = nullptr;
+            rs2_sync_stats stats;
+            rs2_sync_get_stats(_processing_block->_block.get(), &stats, &e);
+            error::handle(e);
+            return stats;
+        }
     private:
         std::shared_ptr<processing_block> _processing_block;
     };
@@ -293,11 +418,89 @@ namespace rs2
         {
             _sync(std::move(f));
         }
+
+        /**
+        * Bound the time frames of a stream wait for their match, past which they leave in a partial frameset
+        * \param[in] stream       Stream type the bound applies to, RS2_STREAM_ANY sets the default of the other streams
+        * \param[in] max_wait_ms  Longest wait in milliseconds, zero waits without a bound
+        */
+        void set_max_wait(rs2_stream stream, float max_wait_ms)
+        {
+            _sync.set_max_wait(stream, max_wait_ms);
+        }
+
+        /**
+        * Retrieve the counters of the complete and partial framesets released so far, and of the frames dropped
+        */
+        rs2_sync_stats get_stats() const
+        {
+            return _sync.get_stats();
+        }
     private:
         asynchronous_syncer _sync;
         frame_queue _results;
     };
 
+    /**
+        Matches the frames of several devices on a shared host clock, for capture rigs of multiple cameras
+        Pass it the frames or framesets of every device, for example the output of one pipeline per device, and
+        retrieve framesets holding the frames the devices captured at the same time
+    */
+    class cross_device_syncer : public options
+    {
+    public:
+        cross_device_syncer() : _results(1)
+        {
+            rs2_error* e = nullptr;
+            auto pb = std::shared_ptr<rs2_processing_block>(
+                rs2_create_cross_device_syncer(&e),
+                rs2_delete_processing_block);
+            error::handle(e);
+            _block = std::make_shared<processing_block>(pb);
+
+            // Redirect options API to the processing block
+            options::operator=(pb);
+
+            _block->start(_results);
+        }
+
+        /**
+        * Wait until a cross-device set of frames becomes available
+        * \param[in] timeout_ms   Max time in milliseconds to wait until an exception will be thrown
+        * \return Set of the frames captured at the same time by the devices
+        */
+        frameset wait_for_frames(unsigned int timeout_ms = 5000) const
+        {
+            return frameset(_results.wait_for_frame(timeout_ms));
+        }
+
+        /**
+        * Check if a cross-device set of frames is available
+        * \param[out] fs      New cross-device frameset
+        * \return true if new frameset was stored to fs
+        */
+        bool poll_for_frames(frameset* fs) const
+        {
+            frame result;
+            if (_results.poll_for_frame(&result))
+            {
+                *fs = frameset(result);
+                return true;
+            }
+            return false;
+        }
+
+        void operator()(frame f) const
+        {
+            (*_block)(std::move(f));
+        }
+    private:
+        friend class processing_graph;
+
+        frame_queue _results;
+        std::shared_ptr<processing_block> _block;
+    };
+
     /**
         Auxiliary processing block that performs image alignment using depth data and camera calibration
     */
@@ -345,9 +548,11 @@ namespace rs2
         }
     private:
         friend class context;
+        friend class processing_graph;
 
-        std::shared_ptr<processing_block> _block;
+        // Declared first so the block, which may still be delivering pipelined frames, is released before the queue
         frame_queue _queue;
+        std::shared_ptr<processing_block> _block;
     };
 
     class colorizer : public options
@@ -364,6 +569,7 @@ namespace rs2
 
             // Redirect options API to the processing block
             options::operator=(pb);
+            _pb = pb;
 
             _block->start(_queue);
         }
@@ -380,7 +586,22 @@ namespace rs2
 
         video_frame operator()(frame depth) const { return colorize(depth); }
 
+        /**
+        * Computes the color of every depth value instead of colorizing the frame, for applications that apply them by themselves
+        * \param[in] depth  Depth frame the colors are computed for
+        * \param[out] lut   Receives 0x10000 colors, the color of depth value i being the RGB bytes in the low bits of lut[i]
+        */
+        void get_lut(frame depth, unsigned int* lut) const
+        {
+            rs2_error* e = nullptr;
+            rs2_get_colorizer_lut(_pb.get(), depth.get(), lut, &e);
+            error::handle(e);
+        }
+
      private:
+         friend class processing_graph;
+
+         std::shared_ptr<rs2_processing_block> _pb;
          std::shared_ptr<processing_block> _block;
          frame_queue _queue;
      };
@@ -405,7 +626,7 @@ namespace rs2
 
         rs2::frame proccess(rs2::frame frame)
         {
-            (*_block)(frame);
+            (*_block)(std::move(frame));
             rs2::frame f;
             _queue.poll_for_frame(&f);
             return f;
@@ -415,8 +636,11 @@ namespace rs2
         {
             (*_block)(std::move(f));
         }
+
+        const processing_block& get_block() const { return *_block; }
     private:
         friend class context;
+        friend class processing_graph;
 
         std::shared_ptr<processing_block> _block;
         frame_queue _queue;
@@ -442,7 +666,7 @@ namespace rs2
 
         rs2::frame proccess(rs2::frame frame)
         {
-            (*_block)(frame);
+            (*_block)(std::move(frame));
             rs2::frame f;
             _queue.poll_for_frame(&f);
             return f;
@@ -452,8 +676,11 @@ namespace rs2
         {
             (*_block)(std::move(f));
         }
+
+        const processing_block& get_block() const { return *_block; }
     private:
         friend class context;
+        friend class processing_graph;
 
         std::shared_ptr<processing_block> _block;
         frame_queue _queue;
@@ -479,7 +706,7 @@ namespace rs2
 
         rs2::frame proccess(rs2::frame frame)
         {
-            (*_block)(frame);
+            (*_block)(std::move(frame));
             rs2::frame f;
             _queue.poll_for_frame(&f);
             return f;
@@ -489,11 +716,803 @@ namespace rs2
         {
             (*_block)(std::move(f));
         }
+
+        const processing_block& get_block() const { return *_block; }
     private:
         friend class context;
+        friend class processing_graph;
 
         std::shared_ptr<processing_block> _block;
         frame_queue _queue;
     };
+
+    class hole_filling_filter : public options
+    {
+    public:
+        hole_filling_filter() :_queue(1)
+        {
+            rs2_error* e = nullptr;
+            auto pb = std::shared_ptr<rs2_processing_block>(
+                rs2_create_hole_filling_filter_block(&e),
+                rs2_delete_processing_block);
+            _block = std::make_shared<processing_block>(pb);
+            error::handle(e);
+
+            // Redirect options API to the processing block
+            options::operator=(pb);
+
+            _block->start(_queue);
+        }
+
+        rs2::frame proccess(rs2::frame frame)
+        {
+            (*_block)(std::move(frame));
+            rs2::frame f;
+            _queue.poll_for_frame(&f);
+            return f;
+        }
+
+        void operator()(frame f) const
+        {
+            (*_block)(std::move(f));
+        }
+
+        const processing_block& get_block() const { return *_block; }
+    private:
+        friend class context;
+        friend class processing_graph;
+
+        std::shared_ptr<processing_block> _block;
+        frame_queue _queue;
+    };
+
+    /**
+        Crops depth frames and clears the depth outside a distance band, see rs2_create_threshold_crop_block
+    */
+    class threshold_crop_filter : public options
+    {
+    public:
+        threshold_crop_filter() :_queue(1)
+        {
+            rs2_error* e = nullptr;
+            auto pb = std::shared_ptr<rs2_processing_block>(
+                rs2_create_threshold_crop_block(&e),
+                rs2_delete_processing_block);
+            _block = std::make_shared<processing_block>(pb);
+            error::handle(e);
+
+            // Redirect options API to the processing block
+            options::operator=(pb);
+
+            _block->start(_queue);
+        }
+
+        rs2::frame proccess(rs2::frame frame)
+        {
+            (*_block)(std::move(frame));
+            rs2::frame f;
+            _queue.poll_for_frame(&f);
+            return f;
+        }
+
+        void operator()(frame f) const
+        {
+            (*_block)(std::move(f));
+        }
+
+        const processing_block& get_block() const { return *_block; }
+    private:
+        friend class context;
+        friend class processing_graph;
+
+        std::shared_ptr<processing_block> _block;
+        frame_queue _queue;
+    };
+
+    /**
+        Marks the tiles of depth frames that changed since the previous frame, see rs2_create_change_detection_block
+        Placed right before pointcloud or align, it lets them recompute only the changed tiles of mostly static scenes
+    */
+    class change_detector : public options
+    {
+    public:
+        change_detector() :_queue(1)
+        {
+            rs2_error* e = nullptr;
+            auto pb = std::shared_ptr<rs2_processing_block>(
+                rs2_create_change_detection_block(&e),
+                rs2_delete_processing_block);
+            _block = std::make_shared<processing_block>(pb);
+            error::handle(e);
+
+            // Redirect options API to the processing block
+            options::operator=(pb);
+
+            _block->start(_queue);
+        }
+
+        rs2::frame proccess(rs2::frame frame)
+        {
+            (*_block)(std::move(frame));
+            rs2::frame f;
+            _queue.poll_for_frame(&f);
+            return f;
+        }
+
+        void operator()(frame f) const
+        {
+            (*_block)(std::move(f));
+        }
+
+        const processing_block& get_block() const { return *_block; }
+    private:
+        friend class context;
+        friend class processing_graph;
+
+        std::shared_ptr<processing_block> _block;
+        frame_queue _queue;
+    };
+
+    /**
+        Converts depth frames to disparity frames, or back, see rs2_create_disparity_transform_block
+        Placed before and after the spatial and temporal filters, typically in one filter_chain, they smooth in disparity
+    */
+    class disparity_transform : public options
+    {
+    public:
+        disparity_transform(bool transform_to_disparity = true) :_queue(1)
+        {
+            rs2_error* e = nullptr;
+            auto pb = std::shared_ptr<rs2_processing_block>(
+                rs2_create_disparity_transform_block(uint8_t(transform_to_disparity), &e),
+                rs2_delete_processing_block);
+            _block = std::make_shared<processing_block>(pb);
+            error::handle(e);
+
+            // Redirect options API to the processing block
+            options::operator=(pb);
+
+            _block->start(_queue);
+        }
+
+        rs2::frame proccess(rs2::frame frame)
+        {
+            (*_block)(std::move(frame));
+            rs2::frame f;
+            _queue.poll_for_frame(&f);
+            return f;
+        }
+
+        void operator()(frame f) const
+        {
+            (*_block)(std::move(f));
+        }
+
+        const processing_block& get_block() const { return *_block; }
+    private:
+        friend class context;
+        friend class processing_graph;
+
+        std::shared_ptr<processing_block> _block;
+        frame_queue _queue;
+    };
+
+    /**
+        Downsamples points to the centroids of the voxels they occupy, see rs2_create_voxel_grid_filter_block
+    */
+    class voxel_grid_filter : public options
+    {
+    public:
+        voxel_grid_filter() :_queue(1)
+        {
+            rs2_error* e = nullptr;
+            auto pb = std::shared_ptr<rs2_processing_block>(
+                rs2_create_voxel_grid_filter_block(&e),
+                rs2_delete_processing_block);
+            _block = std::make_shared<processing_block>(pb);
+            error::handle(e);
+
+            // Redirect options API to the processing block
+            options::operator=(pb);
+
+            _block->start(_queue);
+        }
+
+        rs2::frame proccess(rs2::frame frame)
+        {
+            (*_block)(std::move(frame));
+            rs2::frame f;
+            _queue.poll_for_frame(&f);
+            return f;
+        }
+
+        void operator()(frame f) const
+        {
+            (*_block)(std::move(f));
+        }
+
+        const processing_block& get_block() const { return *_block; }
+    private:
+        friend class context;
+        friend class processing_graph;
+
+        std::shared_ptr<processing_block> _block;
+        frame_queue _queue;
+    };
+
+    /**
+        Adds normals to points of one vertex per depth pixel, see rs2_create_normal_estimation_block
+    */
+    class normal_estimator : public options
+    {
+    public:
+        normal_estimator() :_queue(1)
+        {
+            rs2_error* e = nullptr;
+            auto pb = std::shared_ptr<rs2_processing_block>(
+                rs2_create_normal_estimation_block(&e),
+                rs2_delete_processing_block);
+            _block = std::make_shared<processing_block>(pb);
+            error::handle(e);
+
+            // Redirect options API to the processing block
+            options::operator=(pb);
+
+            _block->start(_queue);
+        }
+
+        rs2::frame proccess(rs2::frame frame)
+        {
+            (*_block)(std::move(frame));
+            rs2::frame f;
+            _queue.poll_for_frame(&f);
+            return f;
+        }
+
+        void operator()(frame f) const
+        {
+            (*_block)(std::move(f));
+        }
+
+        const processing_block& get_block() const { return *_block; }
+    private:
+        friend class context;
+        friend class processing_graph;
+
+        std::shared_ptr<processing_block> _block;
+        frame_queue _queue;
+    };
+
+    /**
+        Builds levels of half, quarter, ... resolution of depth frames in one pass, see rs2_create_depth_pyramid_block
+        The level of scale 1 / 2^k is the depth frame of stream index k of the output frameset
+    */
+    class depth_pyramid : public options
+    {
+    public:
+        depth_pyramid() :_queue(1)
+        {
+            rs2_error* e = nullptr;
+            auto pb = std::shared_ptr<rs2_processing_block>(
+                rs2_create_depth_pyramid_block(&e),
+                rs2_delete_processing_block);
+            _block = std::make_shared<processing_block>(pb);
+            error::handle(e);
+
+            // Redirect options API to the processing block
+            options::operator=(pb);
+
+            _block->start(_queue);
+        }
+
+        rs2::frame proccess(rs2::frame frame)
+        {
+            (*_block)(std::move(frame));
+            rs2::frame f;
+            _queue.poll_for_frame(&f);
+            return f;
+        }
+
+        void operator()(frame f) const
+        {
+            (*_block)(std::move(f));
+        }
+
+        const processing_block& get_block() const { return *_block; }
+    private:
+        friend class context;
+        friend class processing_graph;
+
+        std::shared_ptr<processing_block> _block;
+        frame_queue _queue;
+    };
+
+    /**
+        Attaches statistics of depth frames to them, see rs2_create_depth_statistics_block and depth_frame::get_statistics
+    */
+    class depth_statistics : public options
+    {
+    public:
+        depth_statistics() :_queue(1)
+        {
+            rs2_error* e = nullptr;
+            auto pb = std::shared_ptr<rs2_processing_block>(
+                rs2_create_depth_statistics_block(&e),
+                rs2_delete_processing_block);
+            _block = std::make_shared<processing_block>(pb);
+            error::handle(e);
+
+            // Redirect options API to the processing block
+            options::operator=(pb);
+
+            _block->start(_queue);
+        }
+
+        rs2::frame proccess(rs2::frame frame)
+        {
+            (*_block)(std::move(frame));
+            rs2::frame f;
+            _queue.poll_for_frame(&f);
+            return f;
+        }
+
+        void operator()(frame f) const
+        {
+            (*_block)(std::move(f));
+        }
+
+        const processing_block& get_block() const { return *_block; }
+    private:
+        friend class context;
+        friend class processing_graph;
+
+        std::shared_ptr<processing_block> _block;
+        frame_queue _queue;
+    };
+
+    /**
+        Converts depth frames to RS2_FORMAT_DISTANCE frames of float meters, see rs2_create_distance_transform_block
+    */
+    class distance_transform : public options
+    {
+    public:
+        distance_transform() :_queue(1)
+        {
+            rs2_error* e = nullptr;
+            auto pb = std::shared_ptr<rs2_processing_block>(
+                rs2_create_distance_transform_block(&e),
+                rs2_delete_processing_block);
+            _block = std::make_shared<processing_block>(pb);
+            error::handle(e);
+
+            // Redirect options API to the processing block
+            options::operator=(pb);
+
+            _block->start(_queue);
+        }
+
+        rs2::frame proccess(rs2::frame frame)
+        {
+            (*_block)(std::move(frame));
+            rs2::frame f;
+            _queue.poll_for_frame(&f);
+            return f;
+        }
+
+        void operator()(frame f) const
+        {
+            (*_block)(std::move(f));
+        }
+
+        const processing_block& get_block() const { return *_block; }
+    private:
+        friend class context;
+        friend class processing_graph;
+
+        std::shared_ptr<processing_block> _block;
+        frame_queue _queue;
+    };
+
+    /**
+        Replaces Z16 depth frames by RS2_FORMAT_Z16_COMPRESSED frames, see rs2_create_depth_encoder
+    */
+    class depth_encoder : public options
+    {
+    public:
+        depth_encoder() :_queue(1)
+        {
+            rs2_error* e = nullptr;
+            auto pb = std::shared_ptr<rs2_processing_block>(
+                rs2_create_depth_encoder(&e),
+                rs2_delete_processing_block);
+            _block = std::make_shared<processing_block>(pb);
+            error::handle(e);
+
+            // Redirect options API to the processing block
+            options::operator=(pb);
+
+            _block->start(_queue);
+        }
+
+        rs2::frame proccess(rs2::frame frame)
+        {
+            (*_block)(std::move(frame));
+            rs2::frame f;
+            _queue.poll_for_frame(&f);
+            return f;
+        }
+
+        void operator()(frame f) const
+        {
+            (*_block)(std::move(f));
+        }
+    private:
+        friend class context;
+        friend class processing_graph;
+
+        std::shared_ptr<processing_block> _block;
+        frame_queue _queue;
+    };
+
+    /**
+        Replaces RS2_FORMAT_Z16_COMPRESSED frames by the Z16 depth frames they encode, see rs2_create_depth_decoder
+    */
+    class depth_decoder : public options
+    {
+    public:
+        depth_decoder() :_queue(1)
+        {
+            rs2_error* e = nullptr;
+            auto pb = std::shared_ptr<rs2_processing_block>(
+                rs2_create_depth_decoder(&e),
+                rs2_delete_processing_block);
+            _block = std::make_shared<processing_block>(pb);
+            error::handle(e);
+
+            // Redirect options API to the processing block
+            options::operator=(pb);
+
+            _block->start(_queue);
+        }
+
+        rs2::frame proccess(rs2::frame frame)
+        {
+            (*_block)(std::move(frame));
+            rs2::frame f;
+            _queue.poll_for_frame(&f);
+            return f;
+        }
+
+        void operator()(frame f) const
+        {
+            (*_block)(std::move(f));
+        }
+    private:
+        friend class context;
+        friend class processing_graph;
+
+        std::shared_ptr<processing_block> _block;
+        frame_queue _queue;
+    };
+
+    /**
+        Replaces color and fisheye frames of 8 bit per channel formats by undistorted frames, see rs2_create_undistort_block
+    */
+    class undistort : public options
+    {
+    public:
+        undistort() :_queue(1)
+        {
+            rs2_error* e = nullptr;
+            auto pb = std::shared_ptr<rs2_processing_block>(
+                rs2_create_undistort_block(&e),
+                rs2_delete_processing_block);
+            _block = std::make_shared<processing_block>(pb);
+            error::handle(e);
+
+            // Redirect options API to the processing block
+            options::operator=(pb);
+
+            _block->start(_queue);
+        }
+
+        rs2::frame proccess(rs2::frame frame)
+        {
+            (*_block)(std::move(frame));
+            rs2::frame f;
+            _queue.poll_for_frame(&f);
+            return f;
+        }
+
+        void operator()(frame f) const
+        {
+            (*_block)(std::move(f));
+        }
+    private:
+        friend class context;
+        friend class processing_graph;
+
+        std::shared_ptr<processing_block> _block;
+        frame_queue _queue;
+    };
+
+    /**
+        Adds the orientation of the device to its gyroscope frames, see rs2_create_motion_fusion_block
+    */
+    class motion_fusion : public options
+    {
+    public:
+        motion_fusion() :_queue(1)
+        {
+            rs2_error* e = nullptr;
+            auto pb = std::shared_ptr<rs2_processing_block>(
+                rs2_create_motion_fusion_block(&e),
+                rs2_delete_processing_block);
+            _block = std::make_shared<processing_block>(pb);
+            error::handle(e);
+
+            // Redirect options API to the processing block
+            options::operator=(pb);
+
+            _block->start(_queue);
+        }
+
+        rs2::frame proccess(rs2::frame frame)
+        {
+            (*_block)(std::move(frame));
+            rs2::frame f;
+            _queue.poll_for_frame(&f);
+            return f;
+        }
+
+        void operator()(frame f) const
+        {
+            (*_block)(std::move(f));
+        }
+    private:
+        friend class context;
+        friend class processing_graph;
+
+        std::shared_ptr<processing_block> _block;
+        frame_queue _queue;
+    };
+
+    /**
+        Writes the frames it processes to files, on the shared worker threads, and passes them on unchanged
+        Video frames of 8 bit per channel formats become PNG images, other video frames raw data and points PLY files
+    */
+    class frame_exporter
+    {
+    public:
+        /**
+        * \param[in] prefix       Start of the path of every file, followed by the stream, the frame number and the extension
+        * \param[in] max_pending  Number of frames that may wait to be written before processing waits for them
+        */
+        frame_exporter(const std::string& prefix, int max_pending = 16) :_queue(1)
+        {
+            rs2_error* e = nullptr;
+            _pb = std::shared_ptr<rs2_processing_block>(
+                rs2_create_frame_exporter(prefix.c_str(), max_pending, &e),
+                rs2_delete_processing_block);
+            error::handle(e);
+            _block = std::make_shared<processing_block>(_pb);
+
+            _block->start(_queue);
+        }
+
+        rs2::frame proccess(rs2::frame frame)
+        {
+            (*_block)(std::move(frame));
+            rs2::frame f;
+            _queue.poll_for_frame(&f);
+            return f;
+        }
+
+        void operator()(frame f) const
+        {
+            (*_block)(std::move(f));
+        }
+
+        /**
+        * Writes a single frame to the given file, without waiting for it to be written
+        * \param[in] f         Frame to write
+        * \param[in] filename  Path of the file, whose extension should match the way the frame is written
+        */
+        void save(frame f, const std::string& filename) const
+        {
+            rs2_error* e = nullptr;
+            rs2_frame_add_ref(f.get(), &e);
+            error::handle(e);
+            rs2_export_frame(_pb.get(), f.get(), filename.c_str(), &e);
+            error::handle(e);
+        }
+
+        /**
+        * Waits until all the frames given so far were written
+        */
+        void flush() const
+        {
+            rs2_error* e = nullptr;
+            rs2_flush_frame_exporter(_pb.get(), &e);
+            error::handle(e);
+        }
+    private:
+        friend class context;
+        friend class processing_graph;
+
+        std::shared_ptr<rs2_processing_block> _pb;
+        std::shared_ptr<processing_block> _block;
+        frame_queue _queue;
+    };
+
+    /**
+        Runs the given depth filters, in order, as a single processing block
+        All the stages are written into one output frame, so the frame is allocated once for the whole chain
+        The filters keep their options, and should not be used on their own while part of the chain
+    */
+    class filter_chain
+    {
+    public:
+        template<class... FILTERS>
+        filter_chain(const FILTERS&... filters) :_queue(1)
+        {
+            std::vector<rs2_processing_block*> blocks{ filters.get_block().get()... };
+
+            rs2_error* e = nullptr;
+            auto pb = std::shared_ptr<rs2_processing_block>(
+                rs2_create_filter_chain(blocks.data(), static_cast<int>(blocks.size()), &e),
+                rs2_delete_processing_block);
+            error::handle(e);
+            _block = std::make_shared<processing_block>(pb);
+
+            _block->start(_queue);
+        }
+
+        rs2::frame proccess(rs2::frame frame)
+        {
+            (*_block)(std::move(frame));
+            rs2::frame f;
+            _queue.poll_for_frame(&f);
+            return f;
+        }
+
+        void operator()(frame f) const
+        {
+            (*_block)(std::move(f));
+        }
+    private:
+        friend class processing_graph;
+
+        std::shared_ptr<processing_block> _block;
+        frame_queue _queue;
+    };
+
+    /**
+        Runs processing blocks, its nodes, connected by stream edges. Every node processes its frames on its own thread
+        out of a bounded queue, so the stages work on consecutive frames concurrently
+        Frames passed to the graph enter the nodes without incoming edges, and the output of the nodes without outgoing
+        edges is the output of the graph. Blocks added to the graph should not be used on their own afterwards
+    */
+    class processing_graph : public processing_block
+    {
+    public:
+        processing_graph() : processing_block(create()) {}
+
+        /**
+        * Add a node running the given block
+        * \param[in] block       processing block, or any of the provided blocks such as align, pointcloud or the depth filters
+        * \param[in] queue_size  maximal number of frames waiting for the node
+        * \param[in] policy      what to do with frames arriving while the queue is full
+        * \return                identifier of the node, to connect it to other nodes
+        */
+        int add(const processing_block& block, int queue_size = 1, rs2_queue_policy policy = RS2_QUEUE_POLICY_DROP_OLDEST)
+        {
+            rs2_error* e = nullptr;
+            auto node = rs2_processing_graph_add_node(_block.get(), block._block.get(), queue_size, policy, &e);
+            error::handle(e);
+            return node;
+        }
+
+        template<class T>
+        int add(const T& block, int queue_size = 1, rs2_queue_policy policy = RS2_QUEUE_POLICY_DROP_OLDEST)
+        {
+            return add(*block._block, queue_size, policy);
+        }
+
+        /**
+        * Pass the frames of the given stream type produced by one node to another
+        * \param[in] from    node producing the frames
+        * \param[in] to      node receiving the frames
+        * \param[in] stream  stream type to pass, by default the frames are passed as they are
+        */
+        void connect(int from, int to, rs2_stream stream = RS2_STREAM_ANY)
+        {
+            rs2_error* e = nullptr;
+            rs2_processing_graph_connect(_block.get(), from, to, stream, &e);
+            error::handle(e);
+        }
+
+        rs2_processing_node_stats get_node_stats(int node) const
+        {
+            rs2_error* e = nullptr;
+            rs2_processing_node_stats stats;
+            rs2_processing_graph_get_node_stats(_block.get(), node, &stats, &e);
+            error::handle(e);
+            return stats;
+        }
+
+        /**
+        * Hold the latency of the graph under a target by walking its quality ladder, see rs2_processing_graph_set_latency_target
+        * \param[in] latency_ms  latency target in milliseconds, 0 disables the quality ladder
+        */
+        void set_latency_target(float latency_ms)
+        {
+            rs2_error* e = nullptr;
+            rs2_processing_graph_set_latency_target(_block.get(), latency_ms, &e);
+            error::handle(e);
+        }
+
+        /**
+        * Append a step setting an option of the block of a node to the quality ladder
+        * \param[in] node    node whose block supports the option
+        * \param[in] option  option to set
+        * \param[in] value   value of the option while the step is applied
+        */
+        void add_option_step(int node, rs2_option option, float value)
+        {
+            rs2_error* e = nullptr;
+            rs2_processing_graph_add_option_step(_block.get(), node, option, value, &e);
+            error::handle(e);
+        }
+
+        /**
+        * Append a step processing only one of every divisor frames arriving at a node to the quality ladder
+        * \param[in] node     node to slow down
+        * \param[in] divisor  one frame of every divisor is processed
+        */
+        void add_rate_step(int node, int divisor)
+        {
+            rs2_error* e = nullptr;
+            rs2_processing_graph_add_rate_step(_block.get(), node, divisor, &e);
+            error::handle(e);
+        }
+
+        /**
+        * \return number of quality ladder steps applied, 0 at full quality
+        */
+        int get_quality_level() const
+        {
+            rs2_error* e = nullptr;
+            auto level = rs2_processing_graph_get_quality_level(_block.get(), &e);
+            error::handle(e);
+            return level;
+        }
+
+        /**
+        * Schedule the work of a node ahead of nodes of a lower priority, and drop its frames waiting longer than the deadline
+        * \param[in] node         node identifier
+        * \param[in] priority     higher values are scheduled first
+        * \param[in] deadline_ms  longest wait of a frame for the node in milliseconds, 0 never drops
+        */
+        void set_priority(int node, int priority, float deadline_ms = 0)
+        {
+            rs2_error* e = nullptr;
+            rs2_processing_graph_set_node_priority(_block.get(), node, priority, deadline_ms, &e);
+            error::handle(e);
+        }
+
+        std::shared_ptr<rs2_processing_block> get() const { return _block; }
+
+    private:
+        static std::shared_ptr<rs2_processing_block> create()
+        {
+            rs2_error* e = nullptr;
+            auto graph = std::shared_ptr<rs2_processing_block>(
+                rs2_create_processing_graph(&e),
+                rs2_delete_processing_block);
+            error::handle(e);
+            return graph;
+        }
+    };
 }
 #endif // LIBREALSENSE_RS2_PROCESSING_HPP
@@ -96,6 +96,57 @@ namespace rs2
             error::handle(e);
         }
 
+        /**
+        * Sets the playback to a frame of one of the streams of the played data
+        * \param[in] profile  A stream profile of the played data, only its stream type and index are used
+        * \param[in] frame    Index of the frame among the frames of the stream, starting from 0
+        */
+        void seek_to_frame(const stream_profile& profile, uint64_t frame)
+        {
+            rs2_error* e = nullptr;
+            rs2_playback_seek_to_frame(_dev.get(), profile.get(), frame, &e);
+            error::handle(e);
+        }
+
+        /**
+        * Retrieves the number of frames of one of the streams of the played data
+        * \param[in] profile  A stream profile of the played data, only its stream type and index are used
+        * \return Number of frames recorded for the stream
+        */
+        uint64_t get_frame_count(const stream_profile& profile) const
+        {
+            rs2_error* e = nullptr;
+            auto count = rs2_playback_get_frame_count(_dev.get(), profile.get(), &e);
+            error::handle(e);
+            return count;
+        }
+
+        /**
+        * Retrieves the thumbnail of one of the streams recorded last at or before a time point, for showing while seeking
+        * \param[in] profile  A stream profile of the played data, only its stream type and index are used
+        * \param[in] time     Time point in the file
+        * \param[out] data    Receives the pixels of the thumbnail, rows without padding. Reusing it saves an allocation
+        * \param[out] width   Receives the width of the thumbnail in pixels
+        * \param[out] height  Receives the height of the thumbnail in pixels
+        * \param[out] format  Receives the format of the pixels
+        * \return False when the stream has no thumbnails, as for files recorded by older versions
+        */
+        bool get_thumbnail(const stream_profile& profile, std::chrono::nanoseconds time, std::vector<uint8_t>& data, int& width, int& height, rs2_format& format) const
+        {
+            rs2_error* e = nullptr;
+            data.resize(data.capacity());
+            auto size = rs2_playback_get_thumbnail(_dev.get(), profile.get(), time.count(), data.data(), static_cast<int>(data.size()), &width, &height, &format, &e);
+            error::handle(e);
+            if (size > static_cast<int>(data.size()))
+            {
+                data.resize(size);
+                size = rs2_playback_get_thumbnail(_dev.get(), profile.get(), time.count(), data.data(), static_cast<int>(data.size()), &width, &height, &format, &e);
+                error::handle(e);
+            }
+            data.resize(std::min(size, static_cast<int>(data.size())));
+            return size > 0;
+        }
+
         /**
         * Indicates if playback is in real time mode or non real time
         * \return True iff playback is in real time mode
@@ -126,6 +177,68 @@ namespace rs2
             error::handle(e);
         }
 
+        /**
+        * Set the playback to work in batch mode, where frames are not paced by their recorded times and none are dropped
+        * \param[in] batch  Indicates if batch mode is requested
+        */
+        void set_batch_mode(bool batch) const
+        {
+            rs2_error* e = nullptr;
+            rs2_playback_device_set_batch_mode(_dev.get(), (batch ? 1 : 0), &e);
+            error::handle(e);
+        }
+
+        /**
+        * Indicates if playback is in batch mode
+        * \return True iff playback is in batch mode
+        */
+        bool is_batch_mode() const
+        {
+            rs2_error* e = nullptr;
+            auto batch = rs2_playback_device_is_batch_mode(_dev.get(), &e);
+            error::handle(e);
+            return batch != 0;
+        }
+
+        /**
+        * Read the next set of frames of the opened streams, in the order of the file and without any pacing.
+        * The sensors of the playback must be opened and not started
+        * \param[out] f  The next set of frames
+        * \return true if a set of frames was read, false at the end of the file
+        */
+        bool next_frameset(frameset* f) const
+        {
+            rs2_error* e = nullptr;
+            rs2_frame* frame_ref = nullptr;
+            auto res = rs2_playback_next_frameset(_dev.get(), &frame_ref, &e);
+            error::handle(e);
+            if (res) *f = frameset(frame(frame_ref));
+            return res != 0;
+        }
+
+        /**
+        * Set how many frames the playback reads ahead of the frame it plays
+        * \param[in] frames  Number of frames to read ahead, up to 8, 0 reads each frame only when it is played
+        */
+        void set_read_ahead(uint32_t frames) const
+        {
+            rs2_error* e = nullptr;
+            rs2_playback_device_set_read_ahead(_dev.get(), frames, &e);
+            error::handle(e);
+        }
+
+        /**
+        * Gets how many frames the playback reads ahead of the frame it plays
+        * \return Number of frames read ahead
+        */
+        uint32_t get_read_ahead() const
+        {
+            rs2_error* e = nullptr;
+            auto frames = rs2_playback_device_get_read_ahead(_dev.get(), &e);
+            error::handle(e);
+            return frames;
+        }
+
         /**
         * Set the playing speed
         * \param[in] speed  Indicates a multiplication of the speed to play (e.g: 1 = normal, 0.5 twice as slow)
@@ -219,6 +332,92 @@ namespace rs2
             rs2::error::handle(e);
         }
 
+        /**
+        * Creates a recording device to record the given device and save it to the given file as rosbag format
+        * \param[in]  file                 The desired path to which the recorder should save the data
+        * \param[in]  device               The device to record
+        * \param[in]  compression          Compression of the recorded chunks
+        * \param[in]  chunk_size           Bytes of messages gathered in a chunk before it is compressed and written, 0 for the default
+        * \param[in]  compression_threads  Number of threads compressing chunks in the background, 0 compresses them on the recording thread
+        */
+        recorder(const std::string& file, rs2::device device, rs2_record_compression compression,
+            unsigned int chunk_size = 0, unsigned int compression_threads = 0)
+        {
+            rs2_error* e = nullptr;
+            _dev = std::shared_ptr<rs2_device>(
+                rs2_create_record_device_ex(device.get().get(), file.c_str(), compression, chunk_size, compression_threads, &e),
+                rs2_delete_device);
+            rs2::error::handle(e);
+        }
+
+        /**
+        * Creates a recording device that records frames in the formats the sensors deliver them, see rs2_create_record_device_raw
+        * \param[in]  file         The desired path to which the recorder should save the data
+        * \param[in]  device       The device to record
+        * \param[in]  compression  Compression of the recorded chunks
+        */
+        static recorder raw(const std::string& file, rs2::device device, rs2_record_compression compression = RS2_RECORD_COMPRESSION_LZ4)
+        {
+            rs2_error* e = nullptr;
+            std::shared_ptr<rs2_device> dev(
+                rs2_create_record_device_raw(device.get().get(), file.c_str(), compression, &e),
+                rs2_delete_device);
+            rs2::error::handle(e);
+            return recorder(dev);
+        }
+
+        /**
+        * Creates a recording device that splits its recording into segment files, see rs2_create_record_device_segmented
+        * \param[in]  file              The desired path of the manifest of the recording
+        * \param[in]  device            The device to record
+        * \param[in]  compression       Compression of the recorded chunks
+        * \param[in]  segment_size      Bytes of a segment file, 0 for no limit
+        * \param[in]  segment_duration  Seconds recorded in a segment file, 0 for no limit
+        */
+        static recorder segmented(const std::string& file, rs2::device device, rs2_record_compression compression,
+            unsigned long long segment_size, unsigned int segment_duration)
+        {
+            rs2_error* e = nullptr;
+            std::shared_ptr<rs2_device> dev(
+                rs2_create_record_device_segmented(device.get().get(), file.c_str(), compression, segment_size, segment_duration, &e),
+                rs2_delete_device);
+            rs2::error::handle(e);
+            return recorder(dev);
+        }
+
+        /**
+        * Creates a recording device that writes the native format, see rs2_create_record_device_native
+        * \param[in]  file         The desired path of the index of the recording
+        * \param[in]  device       The device to record
+        * \param[in]  compression  Compression of the frames
+        */
+        static recorder native(const std::string& file, rs2::device device, rs2_record_compression compression = RS2_RECORD_COMPRESSION_NONE)
+        {
+            rs2_error* e = nullptr;
+            std::shared_ptr<rs2_device> dev(
+                rs2_create_record_device_native(device.get().get(), file.c_str(), compression, &e),
+                rs2_delete_device);
+            rs2::error::handle(e);
+            return recorder(dev);
+        }
+
+        /**
+        * Creates a device that serves the frames of the given device over TCP, see rs2_create_network_server_device
+        * Clients play it with context::load_device("tcp://<host>:<port>")
+        * \param[in]  device          The device to serve
+        * \param[in]  port            TCP port to listen on
+        * \param[in]  compress_depth  Send Z16 frames compressed by the lossless depth codec
+        */
+        static recorder network_server(rs2::device device, unsigned int port, bool compress_depth = false)
+        {
+            rs2_error* e = nullptr;
+            std::shared_ptr<rs2_device> dev(
+                rs2_create_network_server_device(device.get().get(), port, compress_depth ? 1 : 0, &e),
+                rs2_delete_device);
+            rs2::error::handle(e);
+            return recorder(dev);
+        }
+
         /**
         * Pause the recording device without stopping the actual device from streaming.
         */
@@ -238,6 +437,41 @@ namespace rs2
             rs2_record_device_resume(_dev.get(), &e);
             error::handle(e);
         }
+
+        /**
+        * Limit the bytes of frames held before they are written to the file
+        * \param[in]  max_bytes  Maximal bytes of queued frames
+        */
+        void set_queue_limit(unsigned long long max_bytes)
+        {
+            rs2_error* e = nullptr;
+            rs2_record_device_set_queue_limit(_dev.get(), max_bytes, &e);
+            error::handle(e);
+        }
+
+        /**
+        * Select what happens to a frame of the given stream type arriving while the queue is full
+        * \param[in]  stream  Stream type the policy applies to, RS2_STREAM_ANY for all of them
+        * \param[in]  policy  Queue policy of the stream, RS2_QUEUE_POLICY_BLOCK holds the sensor until the disk catches up
+        */
+        void set_queue_policy(rs2_stream stream, rs2_queue_policy policy)
+        {
+            rs2_error* e = nullptr;
+            rs2_record_device_set_queue_policy(_dev.get(), stream, policy, &e);
+            error::handle(e);
+        }
+
+        /**
+        * Retrieve the state of the queue of frames and the write throughput
+        */
+        rs2_record_stats get_stats() const
+        {
+            rs2_error* e = nullptr;
+            rs2_record_stats stats;
+            rs2_record_device_get_stats(_dev.get(), &stats, &e);
+            error::handle(e);
+            return stats;
+        }
     protected:
         explicit recorder(std::shared_ptr<rs2_device> dev) : device(dev)
         {
@@ -89,12 +89,33 @@ namespace rs2
         void release() override { delete this; }
     };
 
+    template<class A, class F>
+    class frame_allocator : public rs2_frame_allocator
+    {
+        A alloc_function;
+        F free_function;
+    public:
+        explicit frame_allocator(A on_alloc, F on_free) : alloc_function(on_alloc), free_function(on_free) {}
+
+        void* allocate(size_t size, size_t alignment) override
+        {
+            return alloc_function(size, alignment);
+        }
+
+        void deallocate(void* ptr) override
+        {
+            free_function(ptr);
+        }
+
+        void release() override { delete this; }
+    };
+
     template<class T>
     class frame_callback : public rs2_frame_callback
     {
         T on_frame_function;
     public:
-        explicit frame_callback(T on_frame) : on_frame_function(on_frame) {}
+        explicit frame_callback(T on_frame) : on_frame_function(std::move(on_frame)) {}
 
         void on_frame(rs2_frame* fref) override
         {
@@ -160,6 +181,19 @@ namespace rs2
             return res;
         }
 
+        /**
+        * read option value from the device, bypassing the cached value get_option may return
+        * \param[in] option   option id to be queried
+        * \return value of the option
+        */
+        float get_option_from_device(rs2_option option) const
+        {
+            rs2_error* e = nullptr;
+            auto res = rs2_get_option_from_device(_options, option, &e);
+            error::handle(e);
+            return res;
+        }
+
         /**
         * retrieve the available range of values of a supported option
         * \return option  range containing minimum and maximum values, step and default value
@@ -186,6 +220,42 @@ namespace rs2
             error::handle(e);
         }
 
+        /**
+        * read the values of several options in one call
+        * \param[in] option_ids  ids of the options to be queried
+        * \return values of the options, in the order of option_ids
+        */
+        std::vector<float> get_options(const std::vector<rs2_option>& option_ids) const
+        {
+            std::vector<float> values(option_ids.size());
+            if (option_ids.empty()) return values;
+
+            rs2_error* e = nullptr;
+            rs2_get_options(_options, option_ids.data(), values.data(), static_cast<int>(option_ids.size()), &e);
+            error::handle(e);
+            return values;
+        }
+
+        /**
+        * write the values of several options in one call, in the given order
+        * \param[in] values  pairs of option id and new value
+        */
+        void set_options(const std::vector<std::pair<rs2_option, float>>& values) const
+        {
+            if (values.empty()) return;
+
+            std::vector<rs2_option> ids;
+            std::vector<float> vals;
+            for (auto&& v : values)
+            {
+                ids.push_back(v.first);
+                vals.push_back(v.second);
+            }
+            rs2_error* e = nullptr;
+            rs2_set_options(_options, ids.data(), vals.data(), static_cast<int>(ids.size()), &e);
+            error::handle(e);
+        }
+
         /**
         * check if particular option is read-only
         * \param[in] option     option id to be checked
@@ -226,6 +296,36 @@ namespace rs2
     public:
 
         using options::supports;
+
+        /**
+        * set how long get_option returns the last value read from the device before reading it again
+        * \param[in] staleness  age after which values are read again, zero to read every value from the device
+        */
+        void set_option_cache_staleness(std::chrono::milliseconds staleness) const
+        {
+            rs2_error* e = nullptr;
+            rs2_set_option_cache_staleness(_sensor.get(), static_cast<unsigned int>(staleness.count()), &e);
+            error::handle(e);
+        }
+
+        /**
+        * keep the device of the sensor powered until the matching release_power, see rs2_hold_sensor_power
+        * power_scope holds the power for the lifetime of a scope
+        */
+        void hold_power() const
+        {
+            rs2_error* e = nullptr;
+            rs2_hold_sensor_power(_sensor.get(), &e);
+            error::handle(e);
+        }
+
+        void release_power() const
+        {
+            rs2_error* e = nullptr;
+            rs2_release_sensor_power(_sensor.get(), &e);
+            error::handle(e);
+        }
+
         /**
         * open sensor for exclusive access, by committing to a configuration
         * \param[in] profile    configuration committed by the sensor
@@ -334,6 +434,34 @@ namespace rs2
             error::handle(e);
         }
 
+        /**
+        * install a custom allocator for the frame buffers of this sensor, must be called while the sensor is not streaming
+        * \param[in] on_alloc   callable accepting (size_t size, size_t alignment) and returning void*, a null result falls back to the internal allocator
+        * \param[in] on_free    callable accepting the void* previously returned by on_alloc
+        * \param[in] alignment  required alignment of the frame buffers in bytes, must be a power of two
+        */
+        template<class A, class F>
+        void set_frame_allocator(A on_alloc, F on_free, size_t alignment = 64) const
+        {
+            rs2_error* e = nullptr;
+            rs2_set_frame_allocator_cpp(_sensor.get(),
+                new frame_allocator<A, F>(std::move(on_alloc), std::move(on_free)), static_cast<int>(alignment), &e);
+            error::handle(e);
+        }
+
+        /**
+        * retrieve the counters of the frame buffers this sensor recycled since it was last opened
+        * \return   hits, misses and evictions of the frame buffer pools of the sensor
+        */
+        rs2_frame_pool_stats get_frame_pool_stats() const
+        {
+            rs2_error* e = nullptr;
+            rs2_frame_pool_stats stats;
+            rs2_get_frame_pool_stats(_sensor.get(), &stats, &e);
+            error::handle(e);
+            return stats;
+        }
+
 
         /**
         * check if physical sensor is supported
@@ -430,6 +558,27 @@ namespace rs2
         }
     };
 
+    /**
+    * Keeps the device of a sensor powered while it lives, so that the options accessed meanwhile need no power transition each
+    */
+    class power_scope
+    {
+    public:
+        explicit power_scope(const sensor& s) : _sensor(s) { _sensor.hold_power(); }
+
+        ~power_scope()
+        {
+            try { _sensor.release_power(); }
+            catch (...) {}
+        }
+
+        power_scope(const power_scope&) = delete;
+        power_scope& operator=(const power_scope&) = delete;
+
+    private:
+        sensor _sensor;
+    };
+
     inline bool operator==(const sensor& lhs, const sensor& rhs)
     {
         if (!(lhs.supports(RS2_CAMERA_INFO_NAME) && lhs.supports(RS2_CAMERA_INFO_SERIAL_NUMBER)
@@ -23,6 +23,7 @@
 #include <condition_variable>
 #include <iterator>
 #include <sstream>
+#include <map>
 
 struct rs2_frame_callback
 {
@@ -31,6 +32,14 @@ struct rs2_frame_callback
     virtual                                 ~rs2_frame_callback() {}
 };
 
+struct rs2_frame_allocator
+{
+    virtual void*                           allocate(size_t size, size_t alignment) = 0;
+    virtual void                            deallocate(void* ptr) = 0;
+    virtual void                            release() = 0;
+    virtual                                 ~rs2_frame_allocator() {}
+};
+
 struct rs2_frame_processor_callback
 {
     virtual void                            on_frame(rs2_frame * f, rs2_source * source) = 0;
@@ -69,8 +69,240 @@ int rs2_get_api_version(rs2_error** error);
 
 void rs2_log_to_console(rs2_log_severity min_severity, rs2_error ** error);
 
+/**
+ * Enable or disable the timestamping of frames along their path through the library, disabled by default
+ * The timestamps are retrieved with rs2_get_frame_latency_breakdown
+ * \param[in] enable  non-zero to start recording the stages of new frames, zero to stop
+ * \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ */
+void rs2_enable_latency_instrumentation(int enable, rs2_error ** error);
+
+/**
+ * Keep the calibration tables read from devices in a file of the given directory, so that later processes opening
+ * the same devices do not read them again. Tables are keyed by serial number and firmware version. Disabled by default
+ * \param[in] directory  existing directory to keep the cache file in, null or empty to disable the cache
+ * \param[out] error     if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ */
+void rs2_set_calibration_cache_directory(const char* directory, rs2_error ** error);
+
+/**
+ * Drop cached calibration tables, to be called after a device was recalibrated
+ * \param[in] serial     serial number of the device whose tables are dropped, null to drop the tables of all devices
+ * \param[out] error     if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ */
+void rs2_invalidate_calibration_cache(const char* serial, rs2_error ** error);
+
 void rs2_log_to_file(rs2_log_severity min_severity, const char * file_path, rs2_error ** error);
 
+/**
+ * Place the threads of a class that the library runs, both those running and those started later.
+ * Threads are named after their role (for debuggers, top and the like) whether or not a policy is set
+ * \param[in] thread_class   class of the threads to place
+ * \param[in] affinity_mask  bit mask of the cores the threads may run on, zero to leave them on any core. Ignored on macOS
+ * \param[in] priority       zero to leave the scheduling of the threads as it is inherited. Positive values ask for real-time
+ *                           scheduling (SCHED_FIFO of that priority on Linux, raised thread priority on Windows), which may need
+ *                           privileges. Negative values lower the threads (nice value on Linux, lowered priority on Windows)
+ * \param[out] error         if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ */
+void rs2_set_thread_policy(rs2_thread_class thread_class, unsigned long long affinity_mask, int priority, rs2_error ** error);
+
+/**
+ * List the threads the library is running at the time of the call
+ * \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ * \return            list of threads, to be deleted with rs2_delete_thread_list
+ */
+rs2_thread_list* rs2_query_threads(rs2_error ** error);
+
+/**
+ * \param[in] list    list returned by rs2_query_threads
+ * \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ * \return            number of threads in the list
+ */
+int rs2_get_thread_count(const rs2_thread_list* list, rs2_error ** error);
+
+/**
+ * \param[in] list    list returned by rs2_query_threads
+ * \param[in] index   index of the thread in the list
+ * \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ * \return            name of the thread, valid as long as the list
+ */
+const char* rs2_get_thread_name(const rs2_thread_list* list, int index, rs2_error ** error);
+
+/**
+ * \param[in] list    list returned by rs2_query_threads
+ * \param[in] index   index of the thread in the list
+ * \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ * \return            class of the thread
+ */
+rs2_thread_class rs2_get_thread_class(const rs2_thread_list* list, int index, rs2_error ** error);
+
+/**
+ * \param[in] list    list returned by rs2_query_threads
+ * \param[in] index   index of the thread in the list
+ * \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ * \return            identifier of the thread in the operating system (the kernel thread id on Linux)
+ */
+unsigned long long rs2_get_thread_os_id(const rs2_thread_list* list, int index, rs2_error ** error);
+
+/**
+ * Delete a list returned by rs2_query_threads
+ * \param[in] list    list to delete
+ */
+void rs2_delete_thread_list(rs2_thread_list* list);
+
+/**
+ * Keep metrics of the library internals: frames received and dropped per stream, pipeline queue depths, processing
+ * latencies per block, device errors and temperatures while streaming. Metrics are also kept when LRS_METRICS is
+ * defined in the environment. Only sensors and processing blocks set up after metrics are enabled report them
+ * \param[in] enable  non-zero to keep metrics, zero to stop keeping them for sensors and blocks set up later
+ * \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ */
+void rs2_enable_metrics(int enable, rs2_error ** error);
+
+/**
+ * Take a snapshot of the metrics kept so far, sorted by name and labels
+ * \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ * \return            snapshot of the metrics, to be deleted with rs2_delete_metrics_snapshot
+ */
+rs2_metrics_snapshot* rs2_query_metrics(rs2_error ** error);
+
+/**
+ * \param[in] snapshot  snapshot returned by rs2_query_metrics
+ * \param[out] error    if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ * \return              number of metrics in the snapshot
+ */
+int rs2_get_metric_count(const rs2_metrics_snapshot* snapshot, rs2_error ** error);
+
+/**
+ * \param[in] snapshot  snapshot returned by rs2_query_metrics
+ * \param[in] index     index of the metric in the snapshot
+ * \param[out] error    if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ * \return              name of the metric, valid as long as the snapshot
+ */
+const char* rs2_get_metric_name(const rs2_metrics_snapshot* snapshot, int index, rs2_error ** error);
+
+/**
+ * \param[in] snapshot  snapshot returned by rs2_query_metrics
+ * \param[in] index     index of the metric in the snapshot
+ * \param[out] error    if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ * \return              labels of the metric as written in the Prometheus text format, as in sensor="Stereo Module",stream="Depth"
+ */
+const char* rs2_get_metric_labels(const rs2_metrics_snapshot* snapshot, int index, rs2_error ** error);
+
+/**
+ * \param[in] snapshot  snapshot returned by rs2_query_metrics
+ * \param[in] index     index of the metric in the snapshot
+ * \param[out] error    if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ * \return              kind of the metric
+ */
+rs2_metric_type rs2_get_metric_type(const rs2_metrics_snapshot* snapshot, int index, rs2_error ** error);
+
+/**
+ * \param[in] snapshot  snapshot returned by rs2_query_metrics
+ * \param[in] index     index of the metric in the snapshot
+ * \param[out] error    if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ * \return              value of a counter or a gauge, number of observations of a histogram
+ */
+double rs2_get_metric_value(const rs2_metrics_snapshot* snapshot, int index, rs2_error ** error);
+
+/**
+ * \param[in] snapshot  snapshot returned by rs2_query_metrics
+ * \param[in] index     index of the metric in the snapshot
+ * \param[out] error    if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ * \return              sum of the observations of a histogram, in milliseconds, zero for other metrics
+ */
+double rs2_get_metric_sum(const rs2_metrics_snapshot* snapshot, int index, rs2_error ** error);
+
+/**
+ * Format the snapshot in the Prometheus text exposition format, with the buckets of the histograms
+ * \param[in] snapshot  snapshot returned by rs2_query_metrics
+ * \param[out] error    if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ * \return              text of the snapshot, valid as long as the snapshot
+ */
+const char* rs2_get_metrics_text(rs2_metrics_snapshot* snapshot, rs2_error ** error);
+
+/**
+ * Delete a snapshot returned by rs2_query_metrics
+ * \param[in] snapshot  snapshot to delete
+ */
+void rs2_delete_metrics_snapshot(rs2_metrics_snapshot* snapshot);
+
+/**
+ * Record the frames handed out by the frame archives until they are released, to find the frames held too long.
+ * Frames are also recorded when LRS_FRAME_TRACKING is defined in the environment. Only the archives of sensors and
+ * processing blocks that start after tracking is enabled record their frames
+ * \param[in] enable  non-zero to record frames, zero to stop recording them for archives created later
+ * \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ */
+void rs2_enable_frame_tracking(int enable, rs2_error ** error);
+
+/**
+ * List the frames still held from the archives that record their frames, oldest first
+ * \param[out] frames      array receiving the first max_frames frames, may be null when max_frames is zero
+ * \param[in] max_frames   size of the array
+ * \param[out] error       if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ * \return                 number of frames held, which may be more than max_frames
+ */
+int rs2_query_outstanding_frames(rs2_outstanding_frame* frames, int max_frames, rs2_error ** error);
+
+/**
+ * Start recording the lifecycle of the frames: their dequeue from the driver (Linux), unpacking, publishing, synchronization,
+ * every processing block and the callbacks of the application, on the threads they run on. A trace started before restarts
+ * Available only when the library is built with BUILD_WITH_TRACING, elsewhere the call fails
+ * \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ */
+void rs2_start_trace(rs2_error ** error);
+
+/**
+ * Stop recording and write the events recorded since the trace started, in the Chrome trace event format that
+ * chrome://tracing and the Perfetto UI open. Each thread keeps its last 65536 events at most
+ * \param[in] filename  file to write the trace to
+ * \param[out] error    if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ */
+void rs2_stop_trace(const char* filename, rs2_error ** error);
+
+/**
+ * Create a latency probe, measuring how long the frames handed to it took to reach the application
+ * Creating a probe enables latency instrumentation, see rs2_enable_latency_instrumentation. Exposure latencies are
+ * measured for frames in the global time domain, see RS2_OPTION_GLOBAL_TIME_ENABLED
+ * \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ * \return            new latency probe, to be deleted with rs2_delete_latency_probe
+ */
+rs2_latency_probe* rs2_create_latency_probe(rs2_error ** error);
+
+/**
+ * \param[in] probe  latency probe to delete
+ */
+void rs2_delete_latency_probe(rs2_latency_probe* probe);
+
+/**
+ * Measure a frame as the application receives it, in its frame callback or once a wait for frames returned
+ * \param[in] probe  latency probe
+ * \param[in] frame  frame or frameset, the frames of a frameset are measured one by one. The frame is not released
+ * \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ */
+void rs2_latency_probe_add_frame(rs2_latency_probe* probe, const rs2_frame* frame, rs2_error ** error);
+
+/**
+ * Mark the start of a stimulus the cameras see, such as a screen or a LED in view turning bright. The first video frame
+ * of every stream whose center is clearly brighter than before the stimulus is measured from the given time
+ * \param[in] probe  latency probe
+ * \param[in] time   time the stimulus started, on the clock of rs2_get_time
+ * \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ */
+void rs2_latency_probe_mark_stimulus(rs2_latency_probe* probe, rs2_time_t time, rs2_error ** error);
+
+/**
+ * Retrieve the distribution of a latency of a stream, over the latest frames measured
+ * \param[in] probe    latency probe
+ * \param[in] stream   stream type
+ * \param[in] index    stream index
+ * \param[in] measure  latency to retrieve
+ * \param[out] stats   receives the distribution, all zero when no frame of the stream was measured
+ * \param[out] error  if non-null, receives any error that occurs during this call, otherwise, errors are ignored
+ */
+void rs2_latency_probe_get_stats(const rs2_latency_probe* probe, rs2_stream stream, int index, rs2_latency_measure measure, rs2_latency_stats* stats, rs2_error ** error);
+
 /**
  * Add custom message into librealsense log
  * \param[in] severity	The log level for the message to be written under
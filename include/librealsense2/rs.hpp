@@ -23,6 +23,27 @@ namespace rs2
         error::handle(e);
     }
 
+    inline void enable_latency_instrumentation(bool enable)
+    {
+        rs2_error* e = nullptr;
+        rs2_enable_latency_instrumentation(enable ? 1 : 0, &e);
+        error::handle(e);
+    }
+
+    inline void set_calibration_cache_directory(const std::string& directory)
+    {
+        rs2_error* e = nullptr;
+        rs2_set_calibration_cache_directory(directory.c_str(), &e);
+        error::handle(e);
+    }
+
+    inline void invalidate_calibration_cache(const std::string& serial = "")
+    {
+        rs2_error* e = nullptr;
+        rs2_invalidate_calibration_cache(serial.c_str(), &e);
+        error::handle(e);
+    }
+
     inline void log_to_file(rs2_log_severity min_severity, const char * file_path = nullptr)
     {
         rs2_error* e = nullptr;
@@ -30,6 +51,186 @@ namespace rs2
         error::handle(e);
     }
 
+    inline void set_thread_policy(rs2_thread_class thread_class, unsigned long long affinity_mask, int priority = 0)
+    {
+        rs2_error* e = nullptr;
+        rs2_set_thread_policy(thread_class, affinity_mask, priority, &e);
+        error::handle(e);
+    }
+
+    struct thread_info
+    {
+        std::string name;
+        rs2_thread_class thread_class;
+        unsigned long long os_id;
+    };
+
+    inline std::vector<thread_info> query_threads()
+    {
+        rs2_error* e = nullptr;
+        std::shared_ptr<rs2_thread_list> list(rs2_query_threads(&e), rs2_delete_thread_list);
+        error::handle(e);
+
+        auto count = rs2_get_thread_count(list.get(), &e);
+        error::handle(e);
+
+        std::vector<thread_info> results;
+        for (int i = 0; i < count; i++)
+        {
+            thread_info info;
+            info.name = rs2_get_thread_name(list.get(), i, &e);
+            error::handle(e);
+            info.thread_class = rs2_get_thread_class(list.get(), i, &e);
+            error::handle(e);
+            info.os_id = rs2_get_thread_os_id(list.get(), i, &e);
+            error::handle(e);
+            results.push_back(info);
+        }
+        return results;
+    }
+
+    inline void enable_metrics(bool enable = true)
+    {
+        rs2_error* e = nullptr;
+        rs2_enable_metrics(enable ? 1 : 0, &e);
+        error::handle(e);
+    }
+
+    struct metric
+    {
+        std::string name;
+        std::string labels;
+        rs2_metric_type type;
+        double value;
+        double sum;
+    };
+
+    // Snapshot of the metrics the library keeps once enable_metrics is called
+    class metrics_snapshot
+    {
+    public:
+        metrics_snapshot()
+        {
+            rs2_error* e = nullptr;
+            _snapshot = std::shared_ptr<rs2_metrics_snapshot>(rs2_query_metrics(&e), rs2_delete_metrics_snapshot);
+            error::handle(e);
+        }
+
+        std::vector<metric> get_metrics() const
+        {
+            rs2_error* e = nullptr;
+            auto count = rs2_get_metric_count(_snapshot.get(), &e);
+            error::handle(e);
+
+            std::vector<metric> results;
+            for (int i = 0; i < count; i++)
+            {
+                metric m;
+                m.name = rs2_get_metric_name(_snapshot.get(), i, &e);
+                error::handle(e);
+                m.labels = rs2_get_metric_labels(_snapshot.get(), i, &e);
+                error::handle(e);
+                m.type = rs2_get_metric_type(_snapshot.get(), i, &e);
+                error::handle(e);
+                m.value = rs2_get_metric_value(_snapshot.get(), i, &e);
+                error::handle(e);
+                m.sum = rs2_get_metric_sum(_snapshot.get(), i, &e);
+                error::handle(e);
+                results.push_back(m);
+            }
+            return results;
+        }
+
+        // The snapshot in the Prometheus text exposition format
+        std::string to_text() const
+        {
+            rs2_error* e = nullptr;
+            std::string text = rs2_get_metrics_text(_snapshot.get(), &e);
+            error::handle(e);
+            return text;
+        }
+
+    private:
+        std::shared_ptr<rs2_metrics_snapshot> _snapshot;
+    };
+
+    inline void enable_frame_tracking(bool enable = true)
+    {
+        rs2_error* e = nullptr;
+        rs2_enable_frame_tracking(enable ? 1 : 0, &e);
+        error::handle(e);
+    }
+
+    // Frames still held, oldest first, once enable_frame_tracking is called before the streams start
+    inline std::vector<rs2_outstanding_frame> query_outstanding_frames()
+    {
+        rs2_error* e = nullptr;
+        auto count = rs2_query_outstanding_frames(nullptr, 0, &e);
+        error::handle(e);
+
+        // Frames may be published between the two calls, the second one fills as many as fit
+        std::vector<rs2_outstanding_frame> frames(count + 16);
+        count = rs2_query_outstanding_frames(frames.data(), static_cast<int>(frames.size()), &e);
+        error::handle(e);
+        frames.resize(std::min(static_cast<size_t>(count), frames.size()));
+        return frames;
+    }
+
+    // Traces are available when the library is built with BUILD_WITH_TRACING
+    inline void start_trace()
+    {
+        rs2_error* e = nullptr;
+        rs2_start_trace(&e);
+        error::handle(e);
+    }
+
+    inline void stop_trace(const std::string& filename)
+    {
+        rs2_error* e = nullptr;
+        rs2_stop_trace(filename.c_str(), &e);
+        error::handle(e);
+    }
+
+    // Measures how long the frames handed to it took to reach the application, see rs2_create_latency_probe
+    class latency_probe
+    {
+    public:
+        latency_probe()
+        {
+            rs2_error* e = nullptr;
+            _probe = std::shared_ptr<rs2_latency_probe>(rs2_create_latency_probe(&e), rs2_delete_latency_probe);
+            error::handle(e);
+        }
+
+        // Frames of a frameset are measured one by one
+        void add(const frame& f) const
+        {
+            rs2_error* e = nullptr;
+            rs2_latency_probe_add_frame(_probe.get(), f.get(), &e);
+            error::handle(e);
+        }
+
+        // A stimulus in view of the cameras started at the given time of the library clock, see rs2_get_time
+        void mark_stimulus(rs2_time_t time) const
+        {
+            rs2_error* e = nullptr;
+            rs2_latency_probe_mark_stimulus(_probe.get(), time, &e);
+            error::handle(e);
+        }
+
+        rs2_latency_stats get_stats(rs2_stream stream, int index, rs2_latency_measure measure) const
+        {
+            rs2_error* e = nullptr;
+            rs2_latency_stats stats;
+            rs2_latency_probe_get_stats(_probe.get(), stream, index, measure, &stats, &e);
+            error::handle(e);
+            return stats;
+        }
+
+    private:
+        std::shared_ptr<rs2_latency_probe> _probe;
+    };
+
 	inline void log(rs2_log_severity severity, const char* message)
 	{
 		rs2_error* e = nullptr;
@@ -45,10 +246,15 @@ inline std::ostream & operator << (std::ostream & o, rs2_option option) { return
 inline std::ostream & operator << (std::ostream & o, rs2_log_severity severity) { return o << rs2_log_severity_to_string(severity); }
 inline std::ostream & operator << (std::ostream & o, rs2_camera_info camera_info) { return o << rs2_camera_info_to_string(camera_info); }
 inline std::ostream & operator << (std::ostream & o, rs2_frame_metadata_value metadata) { return o << rs2_frame_metadata_to_string(metadata); }
+inline std::ostream & operator << (std::ostream & o, rs2_frame_latency_stage stage) { return o << rs2_frame_latency_stage_to_string(stage); }
 inline std::ostream & operator << (std::ostream & o, rs2_timestamp_domain domain) { return o << rs2_timestamp_domain_to_string(domain); }
 inline std::ostream & operator << (std::ostream & o, rs2_notification_category notificaton) { return o << rs2_notification_category_to_string(notificaton); }
 inline std::ostream & operator << (std::ostream & o, rs2_sr300_visual_preset preset) { return o << rs2_sr300_visual_preset_to_string(preset); }
 inline std::ostream & operator << (std::ostream & o, rs2_exception_type exception_type) { return o << rs2_exception_type_to_string(exception_type); }
 inline std::ostream & operator << (std::ostream & o, rs2_playback_status status) { return o << rs2_playback_status_to_string(status); }
+inline std::ostream & operator << (std::ostream & o, rs2_thread_class thread_class) { return o << rs2_thread_class_to_string(thread_class); }
+inline std::ostream & operator << (std::ostream & o, rs2_metric_type type) { return o << rs2_metric_type_to_string(type); }
+inline std::ostream & operator << (std::ostream & o, rs2_time_source source) { return o << rs2_time_source_to_string(source); }
+inline std::ostream & operator << (std::ostream & o, rs2_latency_measure measure) { return o << rs2_latency_measure_to_string(measure); }
 
 #endif // LIBREALSENSE_RS2_HPP
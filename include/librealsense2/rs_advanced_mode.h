@@ -94,6 +94,12 @@ void rs2_load_json(rs2_device* dev, const void* json_content, unsigned content_s
 /* Serialize JSON content, returns 0 if success */
 rs2_raw_data_buffer* rs2_serialize_json(rs2_device* dev, rs2_error** error);
 
+/* Compile JSON into a binary preset for this device and firmware version, without applying it */
+rs2_raw_data_buffer* rs2_compile_json(rs2_device* dev, const void* json_content, unsigned content_size, rs2_error** error);
+
+/* Apply a binary preset returned by rs2_compile_json, without parsing JSON */
+void rs2_load_compiled_preset(rs2_device* dev, const void* blob, unsigned blob_size, rs2_error** error);
+
 #ifdef __cplusplus
 }
 #endif
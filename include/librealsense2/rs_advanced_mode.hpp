@@ -274,6 +274,40 @@ namespace rs400
                           &e);
             rs2::error::handle(e);
         }
+
+        /**
+        * Compile JSON into a binary preset that applies without parsing, for this device and its firmware version
+        * Values the JSON leaves out are taken from the device at the time of compiling
+        * \param[in] json_content  the JSON preset, as load_json takes it
+        * \return the preset blob, to keep and pass to load_compiled_preset
+        */
+        std::vector<uint8_t> compile_json(const std::string& json_content) const
+        {
+            rs2_error* e = nullptr;
+            std::shared_ptr<rs2_raw_data_buffer> blob(
+                    rs2_compile_json(_dev.get(), json_content.data(), json_content.size(), &e),
+                    rs2_delete_raw_data);
+            rs2::error::handle(e);
+
+            auto size = rs2_get_raw_data_size(blob.get(), &e);
+            rs2::error::handle(e);
+
+            auto start = rs2_get_raw_data(blob.get(), &e);
+            rs2::error::handle(e);
+
+            return std::vector<uint8_t>(start, start + size);
+        }
+
+        /**
+        * Apply a preset returned by compile_json. Fails when the device runs another firmware version
+        * \param[in] blob  the compiled preset
+        */
+        void load_compiled_preset(const std::vector<uint8_t>& blob)
+        {
+            rs2_error* e = nullptr;
+            rs2_load_compiled_preset(_dev.get(), blob.data(), static_cast<unsigned>(blob.size()), &e);
+            rs2::error::handle(e);
+        }
     };
 }
 
@@ -21,6 +21,11 @@ unsigned auto_exposure_state::get_auto_exposure_antiflicker_rate() const
     return rate;
 }
 
+unsigned auto_exposure_state::get_auto_exposure_sample_step() const
+{
+    return sample_step;
+}
+
 void auto_exposure_state::set_enable_auto_exposure(bool value)
 {
     is_auto_exposure = value;
@@ -36,34 +41,36 @@ void auto_exposure_state::set_auto_exposure_antiflicker_rate(unsigned value)
     rate = value;
 }
 
+void auto_exposure_state::set_auto_exposure_sample_step(unsigned value)
+{
+    sample_step = value;
+}
+
 
 auto_exposure_mechanism::auto_exposure_mechanism(option& gain_option, option& exposure_option, const auto_exposure_state& auto_exposure_state)
     : _auto_exposure_algo(auto_exposure_state),
       _keep_alive(true), _frames_counter(0),
-      _skip_frames(auto_exposure_state.skip_frames), _data_queue(queue_size),
+      _skip_frames(auto_exposure_state.skip_frames), _has_pending(false),
       _gain_option(gain_option), _exposure_option(exposure_option)
 {
     _exposure_thread = std::make_shared<std::thread>(
                 [this]()
     {
+        librealsense::thread_registration registration("rs-auto-exp", RS2_THREAD_CLASS_PROCESSING);
         while (_keep_alive)
         {
-            std::unique_lock<std::mutex> lk(_queue_mtx);
-            _cv.wait(lk, [&] {return (_data_queue.size() || !_keep_alive); });
-
-            if (!_keep_alive)
-                return;
-
             frame_and_callback frame_callback;
-            auto frame_sts = _data_queue.dequeue(&frame_callback);
+            {
+                std::unique_lock<std::mutex> lk(_queue_mtx);
+                _cv.wait(lk, [&] {return (_has_pending || !_keep_alive); });
 
-            lk.unlock();
+                if (!_keep_alive)
+                    return;
 
-            if (!frame_sts)
-            {
-                LOG_ERROR("After waiting on data_queue signalled there are no frames on queue");
-                continue;
+                frame_callback = std::move(_pending);
+                _has_pending = false;
             }
+
             try
             {
                 auto frame = std::move(frame_callback.f_holder);
@@ -125,16 +132,15 @@ auto_exposure_mechanism::~auto_exposure_mechanism()
     _exposure_thread->join();
 }
 
+// The algorithm guards its own state, the frames hand-off is not locked for it
 void auto_exposure_mechanism::update_auto_exposure_state(const auto_exposure_state& auto_exposure_state)
 {
-    std::lock_guard<std::mutex> lk(_queue_mtx);
     _skip_frames = auto_exposure_state.skip_frames;
     _auto_exposure_algo.update_options(auto_exposure_state);
 }
 
 void auto_exposure_mechanism::update_auto_exposure_roi(const region_of_interest& roi)
 {
-    std::lock_guard<std::mutex> lk(_queue_mtx);
     _auto_exposure_algo.update_roi(roi);
 }
 
@@ -148,9 +154,13 @@ void auto_exposure_mechanism::add_frame(frame_holder frame, callback_invocation_
 
     _frames_counter = 0;
 
+    // Only the latest frame is worth analyzing, a frame still waiting is released after the lock is dropped
+    frame_and_callback replaced;
     {
         std::lock_guard<std::mutex> lk(_queue_mtx);
-        _data_queue.enqueue({std::move(frame), std::move(callback)});
+        replaced = std::move(_pending);
+        _pending = { std::move(frame), std::move(callback) };
+        _has_pending = true;
     }
     _cv.notify_one();
 }
@@ -228,10 +238,13 @@ bool auto_exposure_algorithm::analyze_image(const frame_interface* image)
     }
 
     std::vector<int> H(256);
-    auto total_weight = number_of_pixels;
 
     auto cols = frame->get_width();
-    im_hist((uint8_t*)frame->get_frame_data(), image_roi, frame->get_bpp() / 8 * cols, &H[0]);
+    auto step = get_sample_step(image_roi);
+    // The score weighs the pixels sampled, fewer than those of the region when the step skips pixels
+    auto total_weight = im_hist((uint8_t*)frame->get_frame_data(), image_roi, frame->get_bpp() / 8 * cols, step, &H[0]);
+    if (total_weight == 0)
+        return false;
 
     histogram_metric score = {};
     histogram_score(H, total_weight, score);
@@ -283,17 +296,47 @@ void auto_exposure_algorithm::update_roi(const region_of_interest& ae_roi)
     is_roi_initialized = true;
 }
 
-void auto_exposure_algorithm::im_hist(const uint8_t* data, const region_of_interest& image_roi, const int rowStep, int h[])
+int auto_exposure_algorithm::get_sample_step(const region_of_interest& image_roi)
 {
     std::lock_guard<std::recursive_mutex> lock(state_mutex);
 
-    for (int i = 0; i < 256; ++i)
-        h[i] = 0;
+    auto step = state.get_auto_exposure_sample_step();
+    if (step > 0)
+        return static_cast<int>(step);
+
+    // Automatic: the same step along rows and columns, so that the region is sampled by about max_auto_samples pixels
+    auto pixels = static_cast<double>(image_roi.max_x - image_roi.min_x) * (image_roi.max_y - image_roi.min_y);
+    return std::max(1, static_cast<int>(std::ceil(std::sqrt(pixels / auto_exposure_state::max_auto_samples))));
+}
 
+int auto_exposure_algorithm::im_hist(const uint8_t* data, const region_of_interest& image_roi, const int rowStep, const int step, int h[])
+{
+    // Pixels are counted into four histograms in turn, so that neighbouring pixels of the same value increment
+    // different counters instead of waiting on each other's increment
+    std::vector<int> partial(4 * 256, 0);
+    auto h0 = &partial[0], h1 = &partial[256], h2 = &partial[512], h3 = &partial[768];
+
+    int samples = 0;
+    auto row_samples = image_roi.max_x > image_roi.min_x ? (image_roi.max_x - image_roi.min_x + step - 1) / step : 0;
     const uint8_t* rowData = data + (image_roi.min_y * rowStep);
-    for (int i = image_roi.min_y; i < image_roi.max_y; ++i, rowData += rowStep)
-        for (int j = image_roi.min_x; j < image_roi.max_x; j+=state.sample_rate)
-            ++h[rowData[j]];
+    for (int i = image_roi.min_y; i < image_roi.max_y; i += step, rowData += step * rowStep)
+    {
+        int j = image_roi.min_x;
+        for (; j + 3 * step < image_roi.max_x; j += 4 * step)
+        {
+            ++h0[rowData[j]];
+            ++h1[rowData[j + step]];
+            ++h2[rowData[j + 2 * step]];
+            ++h3[rowData[j + 3 * step]];
+        }
+        for (; j < image_roi.max_x; j += step)
+            ++h0[rowData[j]];
+        samples += row_samples;
+    }
+
+    for (int i = 0; i < 256; ++i)
+        h[i] = h0[i] + h1[i] + h2[i] + h3[i];
+    return samples;
 }
 
 void auto_exposure_algorithm::increase_exposure_target(float mult, float& target_exposure)
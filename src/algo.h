@@ -27,24 +27,28 @@ namespace librealsense
         auto_exposure_state() :
             is_auto_exposure(true),
             mode(auto_exposure_modes::auto_exposure_hybrid),
-            rate(60)
+            rate(60),
+            sample_step(0)
         {}
 
         bool get_enable_auto_exposure() const;
         auto_exposure_modes get_auto_exposure_mode() const;
         unsigned get_auto_exposure_antiflicker_rate() const;
+        unsigned get_auto_exposure_sample_step() const;
 
         void set_enable_auto_exposure(bool value);
         void set_auto_exposure_mode(auto_exposure_modes value);
         void set_auto_exposure_antiflicker_rate(unsigned value);
+        void set_auto_exposure_sample_step(unsigned value);
 
-        static const unsigned      sample_rate = 1;
         static const unsigned      skip_frames = 2;
+        static const unsigned      max_auto_samples = 1 << 16; // Pixels sampled by the automatic step
 
     private:
         bool                is_auto_exposure;
         auto_exposure_modes mode;
         unsigned            rate;
+        unsigned            sample_step;    // Pixels between samples along rows and columns, 0 for automatic
     };
 
 
@@ -60,7 +64,8 @@ namespace librealsense
         struct histogram_metric { int under_exposure_count; int over_exposure_count; int shadow_limit; int highlight_limit; int lower_q; int upper_q; float main_mean; float main_std; };
         enum class rounding_mode_type { round, ceil, floor };
 
-        inline void im_hist(const uint8_t* data, const region_of_interest& image_roi, const int rowStep, int h[]);
+        int im_hist(const uint8_t* data, const region_of_interest& image_roi, const int rowStep, const int step, int h[]);
+        int get_sample_step(const region_of_interest& image_roi);
         void increase_exposure_target(float mult, float& target_exposure);
         void decrease_exposure_target(float mult, float& target_exposure);
         void increase_exposure_gain(const float& target_exposure, const float& target_exposure0, float& exposure, float& gain);
@@ -122,16 +127,14 @@ namespace librealsense
         };
 
     private:
-        bool try_pop_front_data(frame_and_callback* data);
-
-        static const int                          queue_size = 2;
         option&                                   _gain_option;
         option&                                   _exposure_option;
         auto_exposure_algorithm                   _auto_exposure_algo;
         std::shared_ptr<std::thread>              _exposure_thread;
         std::condition_variable                   _cv;
         std::atomic<bool>                         _keep_alive;
-        single_consumer_queue<frame_and_callback> _data_queue;
+        frame_and_callback                        _pending;        // Latest frame not analyzed yet, replaced by newer frames
+        bool                                      _has_pending;
         std::mutex                                _queue_mtx;
         std::atomic<unsigned>                     _frames_counter;
         std::atomic<unsigned>                     _skip_frames;
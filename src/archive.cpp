@@ -1,8 +1,77 @@
 #include "metadata-parser.h"
 #include "archive.h"
 
+#include <chrono>
+#include <set>
+#include <unordered_map>
+
 namespace librealsense
 {
+    // Archives that track their frames, for listing the frames still held across all of them
+    class frame_tracking_registry
+    {
+    public:
+        static frame_tracking_registry& get()
+        {
+            // Never destroyed, as archives may be released by frames held past static destruction
+            static auto instance = new frame_tracking_registry();
+            return *instance;
+        }
+
+        std::atomic<bool> enabled;
+
+        int add(archive_interface* archive)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _archives.insert(archive);
+            return ++_last_id;
+        }
+
+        void remove(archive_interface* archive)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _archives.erase(archive);
+        }
+
+        std::vector<rs2_outstanding_frame> query(rs2_time_t now)
+        {
+            std::vector<rs2_outstanding_frame> frames;
+            {
+                // Archives remove themselves first thing when destroyed, so the ones listed are alive while the lock is held
+                std::lock_guard<std::mutex> lock(_mutex);
+                for (auto archive : _archives)
+                    archive->get_outstanding_frames(frames, now);
+            }
+            std::stable_sort(frames.begin(), frames.end(), [](const rs2_outstanding_frame& a, const rs2_outstanding_frame& b)
+            {
+                return a.age > b.age;
+            });
+            return frames;
+        }
+
+    private:
+        frame_tracking_registry() : enabled(getenv("LRS_FRAME_TRACKING") != nullptr), _last_id(0) {}
+
+        std::mutex _mutex;
+        std::set<archive_interface*> _archives;
+        int _last_id;
+    };
+
+    static rs2_time_t get_tracking_time()
+    {
+        return std::chrono::duration<rs2_time_t, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void enable_frame_tracking(bool enable)
+    {
+        frame_tracking_registry::get().enabled = enable;
+    }
+
+    std::vector<rs2_outstanding_frame> query_outstanding_frames()
+    {
+        return frame_tracking_registry::get().query(get_tracking_time());
+    }
+
     std::shared_ptr<sensor_interface> frame::get_sensor() const
     {
         auto res = sensor.lock();
@@ -13,7 +82,11 @@ namespace librealsense
         }
         return res;
     }
-    void frame::set_sensor(std::shared_ptr<sensor_interface> s) { sensor = s;}
+    void frame::set_sensor(std::shared_ptr<sensor_interface> s)
+    {
+        // Comparing the control blocks does not touch the reference counts
+        if (sensor.owner_before(s) || s.owner_before(sensor)) sensor = s;
+    }
 
     float3* points::get_vertices()
     {
@@ -23,32 +96,92 @@ namespace librealsense
 
     size_t points::get_vertex_count() const
     {
-        return data.size() / (sizeof(float3) + sizeof(int2));
+        return data.size() / get_point_size();
     }
 
     float2* points::get_texture_coordinates()
     {
-        auto xyz = (float3*)data.data();
-        auto ijs = (float2*)(xyz + get_vertex_count());
+        auto ijs = (float2*)(data.data() + get_vertex_count() * get_vertex_size(_vertex_format));
         return ijs;
     }
 
+    int* points::get_pixel_indices()
+    {
+        if (!_pixel_indices) return nullptr;
+        return (int*)(get_texture_coordinates() + get_vertex_count());
+    }
+
+    float3* points::get_normals()
+    {
+        if (!_normals) return nullptr;
+        auto after_texture = reinterpret_cast<byte*>(get_texture_coordinates() + get_vertex_count());
+        return (float3*)(after_texture + (_pixel_indices ? get_vertex_count() * sizeof(int) : 0));
+    }
+
+    void points::set_layout(rs2_format vertex_format, bool pixel_indices, bool normals)
+    {
+        _vertex_format = vertex_format;
+        _pixel_indices = pixel_indices;
+        _normals = normals;
+    }
+
+    size_t points::get_vertex_size(rs2_format vertex_format)
+    {
+        switch (vertex_format)
+        {
+        case RS2_FORMAT_XYZ32F: return sizeof(float3);
+        case RS2_FORMAT_XYZ16F:
+        case RS2_FORMAT_XYZ16: return 3 * sizeof(int16_t);
+        default: throw invalid_value_exception(to_string() << "unsupported vertex format " << get_string(vertex_format));
+        }
+    }
+
+    size_t points::get_size(size_t vertex_count, rs2_format vertex_format, bool pixel_indices, bool normals)
+    {
+        return vertex_count * (get_vertex_size(vertex_format) + sizeof(float2) + (pixel_indices ? sizeof(int) : 0)
+                               + (normals ? sizeof(float3) : 0));
+    }
+
     // Defines general frames storage model
     template<class T>
-    class frame_archive : public std::enable_shared_from_this<frame_archive<T>>, public archive_interface
+    class frame_archive : public archive_interface
     {
+        // The reference held by the frame source is the top bit of the count, the published frames are the rest,
+        // so publishing or releasing a frame costs a single atomic operation
+        static const uint32_t source_reference = 0x80000000;
+
         std::atomic<uint32_t>* max_frame_queue_size;
-        std::atomic<uint32_t> published_frames_count;
-        small_heap<T, RS2_USER_QUEUE_SIZE> published_frames;
+        std::atomic<uint32_t> references;
+        slot_allocator<T> published_frames;     // Sized by the frames queue size the archive was created with
 
         callbacks_heap callback_inflight;
 
-        std::vector<T> freelist; // return frames here
+        frame_buffer_pool<> buffer_pool; // return frame buffers here
+        frame_metadata_pool metadata_pool; // Sized as published_frames
+        frame_allocator_ptr allocator;   // optional user-supplied storage for frame buffers
+        size_t alignment = 0;
+        frame_storage::allocator_type storage_allocator;
         std::atomic<bool> recycle_frames;
+        std::atomic<bool> realtime;
+        std::atomic<uint32_t> realtime_allocations;
         int pending_frames = 0;
-        std::recursive_mutex mutex;
         std::shared_ptr<platform::time_service> _time_service;
         std::shared_ptr<metadata_parser_map> _metadata_parsers = nullptr;
+        std::array<md_attribute_parser_base*, ::RS2_FRAME_METADATA_COUNT> _md_parsers_table;  // Parsers of _metadata_parsers by attribute
+
+        // A frame handed out while the archive tracks its frames
+        struct tracked_frame
+        {
+            rs2_time_t published;
+            unsigned long long frame_number;
+            rs2_time_t timestamp;
+            std::shared_ptr<stream_profile_interface> stream;
+        };
+
+        // Zero when the archive does not track its frames
+        int tracking_id = 0;
+        mutable std::mutex tracking_mutex;
+        std::unordered_map<frame_interface*, tracked_frame> tracked_frames;
 
         std::weak_ptr<sensor_interface> _sensor;
         std::shared_ptr<sensor_interface> get_sensor() const override { return _sensor.lock(); }
@@ -58,44 +191,59 @@ namespace librealsense
         {
             T backbuffer;
             //const size_t size = modes[stream].get_image_size(stream);
+            if (requires_memory)
             {
-                std::lock_guard<std::recursive_mutex> guard(mutex);
-
-                if (requires_memory)
+                void* user_buffer = nullptr;
+                if (allocator && size)
                 {
-                    // Attempt to obtain a buffer of the appropriate size from the freelist
-                    for (auto it = begin(freelist); it != end(freelist); ++it)
+                    try { user_buffer = allocator->allocate(size, alignment); }
+                    catch (...)
                     {
-                        if (it->data.size() == size)
-                        {
-                            backbuffer = std::move(*it);
-                            freelist.erase(it);
-                            break;
-                        }
+                        LOG_ERROR("Received an exception from frame allocator!");
                     }
                 }
 
-                // Discard buffers that have been in the freelist for longer than 1s
-                for (auto it = begin(freelist); it != end(freelist);)
+                if (user_buffer)
                 {
-                    if (additional_data.timestamp > it->additional_data.timestamp + 1000) it = freelist.erase(it);
-                    else ++it;
+                    // The frame exposes the user buffer through its continuation, which returns it to the allocator on release
+                    auto a = allocator;
+                    backbuffer.attach_continuation(frame_continuation([a, user_buffer]() { a->deallocate(user_buffer); }, user_buffer));
+                    backbuffer.user_data_size = size;
+                }
+                else
+                {
+                    // Attempt to obtain a buffer of the appropriate size from the pool
+                    backbuffer.data = frame_storage(storage_allocator);
+                    // Nothing is logged on the frame path of a realtime sensor, the allocations are counted and
+                    // reported when the stream stops
+                    if (!buffer_pool.acquire(size, backbuffer.data, additional_data.timestamp) && realtime)
+                    {
+                        ++realtime_allocations;
+                        assert(!"Frame buffer allocated on the frame path of a realtime sensor");
+                    }
+                    backbuffer.data.resize(size);
                 }
             }
-
-            if (requires_memory)
+            backbuffer.additional_data = additional_data;
+            if (additional_data.metadata_source)
             {
-                backbuffer.data.resize(size, 0); // TODO: Allow users to provide a custom allocator for frame buffers
+                bool allocated = false;
+                auto buffer = metadata_pool.acquire(allocated);
+                if (allocated && realtime)
+                {
+                    ++realtime_allocations;
+                    assert(!"Frame metadata allocated on the frame path of a realtime sensor");
+                }
+                backbuffer.additional_data.metadata_blob.assign(additional_data.metadata_source, additional_data.metadata_size, std::move(buffer));
+                backbuffer.additional_data.metadata_source = nullptr;
             }
-            backbuffer.additional_data = additional_data;
             return backbuffer;
         }
 
         frame_interface* track_frame(frame& f)
         {
-            std::unique_lock<std::recursive_mutex> lock(mutex);
-
-            auto published_frame = f.publish(this->shared_from_this());
+            // Publishing takes a slot of the lock-free allocator, so concurrent capture threads need no lock here
+            auto published_frame = f.publish(this);
             if (published_frame)
             {
                 published_frame->acquire();
@@ -112,17 +260,26 @@ namespace librealsense
             {
                 auto f = (T*)frame;
                 log_frame_callback_end(f);
-                std::unique_lock<std::recursive_mutex> lock(mutex);
-
-                --published_frames_count;
 
                 if (recycle_frames)
                 {
-                    freelist.push_back(std::move(*f));
+                    buffer_pool.release(std::move(f->data), f->additional_data.timestamp);
+                }
+                f->native.reset();
+                f->additional_data.metadata_blob.reset();
+                f->changes.reset();
+                f->statistics.reset();
+
+                if (tracking_id)
+                {
+                    std::lock_guard<std::mutex> lock(tracking_mutex);
+                    tracked_frames.erase(f);
                 }
-                lock.unlock();
 
                 published_frames.deallocate(f);
+
+                // Nothing of the archive may be touched past this point
+                if (--references == 0) delete this;
             }
         }
 
@@ -130,7 +287,7 @@ namespace librealsense
         {
             auto f = (T*)frame;
 
-            if (published_frames_count >= *max_frame_queue_size)
+            if (get_published_frames_count() >= *max_frame_queue_size)
             {
                 LOG_DEBUG("User didn't release frame resource.");
                 return nullptr;
@@ -138,8 +295,17 @@ namespace librealsense
             auto new_frame = published_frames.allocate();
             if (new_frame)
             {
-                ++published_frames_count;
+                ++references;
                 *new_frame = std::move(*f);
+
+                // The slot keeps the stream of its previous frame until a different one is set
+                if (tracking_id)
+                {
+                    tracked_frame record{ get_tracking_time(), new_frame->additional_data.frame_number,
+                                          new_frame->additional_data.timestamp, new_frame->get_stream() };
+                    std::lock_guard<std::mutex> lock(tracking_mutex);
+                    tracked_frames[new_frame] = std::move(record);
+                }
             }
 
             return new_frame;
@@ -166,7 +332,76 @@ namespace librealsense
             }
         }
 
-        std::shared_ptr<metadata_parser_map> get_md_parsers() const { return _metadata_parsers; };
+        const std::shared_ptr<metadata_parser_map>& get_md_parsers() const override { return _metadata_parsers; };
+
+        md_attribute_parser_base* get_md_parser(rs2_frame_metadata_value frame_metadata) const override
+        {
+            if (frame_metadata >= 0 && frame_metadata < ::RS2_FRAME_METADATA_COUNT)
+                return _md_parsers_table[frame_metadata];
+
+            if (!_metadata_parsers)
+                return nullptr;
+            auto it = _metadata_parsers->find(frame_metadata);
+            return it != _metadata_parsers->end() ? it->second.get() : nullptr;
+        }
+
+        void on_stream_set(frame_interface* frame, const std::shared_ptr<stream_profile_interface>& sp) override
+        {
+            if (!tracking_id) return;
+            std::lock_guard<std::mutex> lock(tracking_mutex);
+            auto it = tracked_frames.find(frame);
+            if (it != tracked_frames.end()) it->second.stream = sp;
+        }
+
+        void get_outstanding_frames(std::vector<rs2_outstanding_frame>& frames, rs2_time_t now) const override
+        {
+            std::lock_guard<std::mutex> lock(tracking_mutex);
+            for (auto&& kvp : tracked_frames)
+            {
+                rs2_outstanding_frame f{};
+                f.stream = kvp.second.stream ? kvp.second.stream->get_stream_type() : RS2_STREAM_ANY;
+                f.index = kvp.second.stream ? kvp.second.stream->get_stream_index() : 0;
+                f.frame_number = kvp.second.frame_number;
+                f.timestamp = kvp.second.timestamp;
+                f.age = now - kvp.second.published;
+                f.archive = tracking_id;
+                f.archive_frames = static_cast<int>(tracked_frames.size());
+                f.archive_capacity = static_cast<int>(*max_frame_queue_size);
+                frames.push_back(f);
+            }
+        }
+
+        void set_frame_allocator(frame_allocator_ptr a, size_t align) override
+        {
+            allocator = a;
+            alignment = align;
+        }
+
+        void set_frame_memory(const frame_memory_policy& policy) override
+        {
+            storage_allocator = frame_storage::allocator_type(policy);
+            buffer_pool.set_allocator(storage_allocator);
+        }
+
+        void reserve_buffers(size_t size) override
+        {
+            // One more than may be published, for the frame being filled while all the others are held
+            realtime = true;
+            auto count = *max_frame_queue_size + 1;
+            if (buffer_pool.reserve(size, count) < count)
+                LOG_WARNING("Only part of the " << count << " frame buffers of " << size << " bytes could be reserved");
+            metadata_pool.reserve();
+        }
+
+        void set_buffer_pool_high_water_mark(uint32_t value) override
+        {
+            buffer_pool.set_high_water_mark(value);
+        }
+
+        frame_buffer_pool_stats get_buffer_pool_stats() const override
+        {
+            return buffer_pool.get_stats();
+        }
 
         friend class frame;
 
@@ -175,10 +410,25 @@ namespace librealsense
                              std::shared_ptr<platform::time_service> ts,
                              std::shared_ptr<metadata_parser_map> parsers)
             : max_frame_queue_size(in_max_frame_queue_size),
-              mutex(), recycle_frames(true), _time_service(ts),
+              references(source_reference),
+              published_frames(std::max<uint32_t>(1, std::min<uint32_t>(*in_max_frame_queue_size, RS2_USER_QUEUE_SIZE))),
+              metadata_pool(std::max<uint32_t>(1, std::min<uint32_t>(*in_max_frame_queue_size, RS2_USER_QUEUE_SIZE)) + 1),
+              recycle_frames(true), realtime(false), realtime_allocations(0), _time_service(ts),
               _metadata_parsers(parsers)
         {
-            published_frames_count = 0;
+            // The parsers are registered before the sensor opens, so they are indexed once per archive
+            _md_parsers_table.fill(nullptr);
+            if (_metadata_parsers)
+            {
+                for (auto&& kvp : *_metadata_parsers)
+                {
+                    if (kvp.first >= 0 && kvp.first < ::RS2_FRAME_METADATA_COUNT)
+                        _md_parsers_table[kvp.first] = kvp.second.get();
+                }
+            }
+
+            auto& tracking = frame_tracking_registry::get();
+            if (tracking.enabled) tracking_id = tracking.add(this);
         }
 
         callback_invocation_holder begin_callback()
@@ -191,10 +441,23 @@ namespace librealsense
             ref->release();
         }
 
+        uint32_t get_published_frames_count() const override
+        {
+            return references & ~source_reference;
+        }
+
+        void release_source() override
+        {
+            if (references.fetch_sub(source_reference) == source_reference) delete this;
+        }
+
         frame_interface* alloc_and_track(const size_t size, const frame_additional_data& additional_data, bool requires_memory)
         {
             auto frame = alloc_frame(size, additional_data, requires_memory);
-            return track_frame(frame);
+            auto published_frame = track_frame(frame);
+            if (published_frame)
+                static_cast<T*>(published_frame)->decode_metadata();
+            return published_frame;
         }
 
         void flush()
@@ -211,11 +474,18 @@ namespace librealsense
             // wait until user is done with all the stuff he chose to borrow
             callback_inflight.wait_until_empty();
 
+            buffer_pool.clear();
+
+            if (realtime_allocations > 0)
             {
-                std::lock_guard<std::recursive_mutex> guard(mutex);
-                freelist.clear();
+                LOG_WARNING(realtime_allocations << " frames of realtime stream 0x" << std::hex << this << std::dec
+                    << " needed new buffers, the frames were held longer than the frame queue size allows");
             }
 
+            auto stats = buffer_pool.get_stats();
+            LOG_DEBUG("Frame buffer pool 0x" << std::hex << this << std::dec << " hits: " << stats.hits
+                << ", misses: " << stats.misses << ", evictions: " << stats.evictions);
+
             pending_frames = published_frames.get_size();
             if (pending_frames > 0)
             {
@@ -228,6 +498,8 @@ namespace librealsense
 
         ~frame_archive()
         {
+            if (tracking_id) frame_tracking_registry::get().remove(this);
+
             if (pending_frames > 0)
             {
                 LOG_WARNING("All frames from stream 0x"
@@ -237,6 +509,16 @@ namespace librealsense
 
     };
 
+    template<class T>
+    std::shared_ptr<archive_interface> make_frame_archive(std::atomic<uint32_t>* in_max_frame_queue_size,
+                                                          std::shared_ptr<platform::time_service> ts,
+                                                          std::shared_ptr<metadata_parser_map> parsers)
+    {
+        // The frames still held after the source let go keep the archive around
+        return std::shared_ptr<archive_interface>(new frame_archive<T>(in_max_frame_queue_size, ts, parsers),
+                                                  [](archive_interface* a) { a->release_source(); });
+    }
+
     std::shared_ptr<archive_interface> make_archive(rs2_extension type,
                                                     std::atomic<uint32_t>* in_max_frame_queue_size,
                                                     std::shared_ptr<platform::time_service> ts,
@@ -245,19 +527,19 @@ namespace librealsense
         switch(type)
         {
         case RS2_EXTENSION_VIDEO_FRAME :
-            return std::make_shared<frame_archive<video_frame>>(in_max_frame_queue_size, ts, parsers);
+            return make_frame_archive<video_frame>(in_max_frame_queue_size, ts, parsers);
 
         case RS2_EXTENSION_COMPOSITE_FRAME :
-            return std::make_shared<frame_archive<composite_frame>>(in_max_frame_queue_size, ts, parsers);
+            return make_frame_archive<composite_frame>(in_max_frame_queue_size, ts, parsers);
 
         case RS2_EXTENSION_MOTION_FRAME:
-            return std::make_shared<frame_archive<frame>>(in_max_frame_queue_size, ts, parsers);
+            return make_frame_archive<frame>(in_max_frame_queue_size, ts, parsers);
 
         case RS2_EXTENSION_POINTS:
-            return std::make_shared<frame_archive<points>>(in_max_frame_queue_size, ts, parsers);
+            return make_frame_archive<points>(in_max_frame_queue_size, ts, parsers);
 
         case RS2_EXTENSION_DEPTH_FRAME:
-            return std::make_shared<frame_archive<depth_frame>>(in_max_frame_queue_size, ts, parsers);
+            return make_frame_archive<depth_frame>(in_max_frame_queue_size, ts, parsers);
 
         default:
             throw std::runtime_error("Requested frame type is not supported!");
@@ -274,7 +556,14 @@ void frame::release()
     }
 }
 
-frame_interface* frame::publish(std::shared_ptr<archive_interface> new_owner)
+void frame::set_stream(const std::shared_ptr<stream_profile_interface>& sp)
+{
+    if (stream == sp) return;
+    stream = sp;
+    if (owner) owner->on_stream_set(this, sp);
+}
+
+frame_interface* frame::publish(archive_interface* new_owner)
 {
     owner = new_owner;
     return owner->publish_frame(this);
@@ -282,35 +571,60 @@ frame_interface* frame::publish(std::shared_ptr<archive_interface> new_owner)
 
 rs2_metadata_type frame::get_frame_metadata(const rs2_frame_metadata_value& frame_metadata) const
 {
-    auto md_parsers = owner->get_md_parsers();
-
-    if (!md_parsers)
+    if (!owner->get_md_parsers())
         throw invalid_value_exception(to_string() << "metadata not available for "
                                       << get_string(get_stream()->get_stream_type())<<" stream");
 
-    auto it = md_parsers.get()->find(frame_metadata);
-    if (it == md_parsers.get()->end())          // Possible user error - md attribute is not supported by this frame type
+    auto parser = owner->get_md_parser(frame_metadata);
+    if (!parser)          // Possible user error - md attribute is not supported by this frame type
         throw invalid_value_exception(to_string() << get_string(frame_metadata)
                                       << " attribute is not applicable for "
                                       << get_string(get_stream()->get_stream_type()) << " stream ");
 
-    // Proceed to parse and extract the required data attribute
-    return it->second->get(*this);
+    if (md_decoded && frame_metadata < ::RS2_FRAME_METADATA_COUNT && (md_supported & (1u << frame_metadata)))
+        return md_values[frame_metadata];
+
+    // Proceed to parse and extract the required data attribute, which reports why it is not available
+    return parser->get(*this);
 }
 
 bool frame::supports_frame_metadata(const rs2_frame_metadata_value& frame_metadata) const
 {
-    auto md_parsers = owner->get_md_parsers();
-
     // verify preconditions
-    if (!md_parsers)
+    if (!owner->get_md_parsers())
         return false;                         // No parsers are available or no metadata was attached
 
-    auto it = md_parsers.get()->find(frame_metadata);
-    if (it == md_parsers.get()->end())          // Possible user error - md attribute is not supported by this frame type
+    if (md_decoded && frame_metadata < ::RS2_FRAME_METADATA_COUNT)
+        return (md_supported & (1u << frame_metadata)) != 0;
+
+    auto parser = owner->get_md_parser(frame_metadata);
+    if (!parser)          // Possible user error - md attribute is not supported by this frame type
         return false;
 
-    return it->second->supports(*this);
+    return parser->supports(*this);
+}
+
+void frame::decode_metadata()
+{
+    md_supported = 0;
+    md_decoded = false;
+    if (!owner->get_md_parsers())
+        return;
+
+    for (auto i = 0; i < ::RS2_FRAME_METADATA_COUNT; i++)
+    {
+        auto parser = owner->get_md_parser(static_cast<rs2_frame_metadata_value>(i));
+        if (!parser || !parser->supports(*this))
+            continue;
+
+        try
+        {
+            md_values[i] = parser->get(*this);
+            md_supported |= 1u << i;
+        }
+        catch (...) {}
+    }
+    md_decoded = true;
 }
 
 const byte* frame::get_frame_data() const
@@ -325,6 +639,11 @@ const byte* frame::get_frame_data() const
     return frame_data;
 }
 
+size_t frame::get_frame_data_size() const
+{
+    return on_release.get_data() ? user_data_size : data.size();
+}
+
 rs2_timestamp_domain frame::get_frame_timestamp_domain() const
 {
     return additional_data.timestamp_domain;
@@ -5,6 +5,9 @@
 
 #include "types.h"
 #include "core/streaming.h"
+#include "environment.h"
+#include "frame-storage.h"
+#include "frame-buffer-pool.h"
 
 #include <atomic>
 #include <array>
@@ -15,8 +18,118 @@ namespace librealsense
     class archive_interface;
     class md_attribute_parser_base;
     class frame;
+    struct change_mask;
+    struct depth_statistics;
 }
 
+// The raw metadata of a frame, held out of line so that frames without metadata carry no buffer and
+// frames derived from a frame share its buffer instead of copying it.
+// Parsers read their attributes at fixed offsets, so a buffer always exposes MAX_META_DATA_SIZE bytes
+class frame_metadata_blob
+{
+public:
+    typedef std::array<uint8_t, MAX_META_DATA_SIZE> buffer;
+
+    const uint8_t* data() const { return _buffer ? _buffer->data() : empty_buffer().data(); }
+
+    // Writing gives the blob a buffer of its own. The readers filling the metadata in place allocate it here,
+    // the frames of the sensors get theirs from the pool of their archive, see assign
+    uint8_t* data()
+    {
+        if (!_buffer)
+            _buffer = std::make_shared<buffer>();
+        else if (_buffer.use_count() > 1)
+            _buffer = std::make_shared<buffer>(*_buffer);
+        return _buffer->data();
+    }
+
+    size_t size() const { return MAX_META_DATA_SIZE; }
+
+    // Takes a buffer no other blob shares, the bytes past the metadata are cleared as in a new buffer
+    void assign(const uint8_t* source, size_t size, std::shared_ptr<buffer> dest)
+    {
+        auto end = std::copy(source, source + std::min<size_t>(size, MAX_META_DATA_SIZE), dest->begin());
+        std::fill(end, dest->end(), 0);
+        _buffer = std::move(dest);
+    }
+
+    void reset() { _buffer.reset(); }
+
+private:
+    static const buffer& empty_buffer()
+    {
+        static const buffer empty{ {} };
+        return empty;
+    }
+
+    std::shared_ptr<buffer> _buffer;
+};
+
+// Metadata buffers of the frames of an archive, a fixed array of slots claimed through an atomic flag.
+// A buffer is free again once only the pool holds it, that is once the frames sharing it were released
+class frame_metadata_pool
+{
+public:
+    explicit frame_metadata_pool(size_t capacity) : _slots(new slot[capacity]), _capacity(capacity), _next(0) {}
+
+    frame_metadata_pool(const frame_metadata_pool&) = delete;
+    frame_metadata_pool& operator=(const frame_metadata_pool&) = delete;
+
+    // Sets allocated when the buffer is new, either filling an empty slot or because all the buffers are held
+    std::shared_ptr<frame_metadata_blob::buffer> acquire(bool& allocated)
+    {
+        auto first = _next++;
+        for (size_t i = 0; i < _capacity; i++)
+        {
+            auto&& s = _slots[(first + i) % _capacity];
+            bool expected = false;
+            if (!s.claimed.compare_exchange_strong(expected, true, std::memory_order_acquire)) continue;
+
+            std::shared_ptr<frame_metadata_blob::buffer> result;
+            if (!s.buffer)
+            {
+                s.buffer = std::make_shared<frame_metadata_blob::buffer>();
+                allocated = true;
+                result = s.buffer;
+            }
+            else if (s.buffer.use_count() == 1)
+            {
+                // Pairs with the release of the last frame that held the buffer
+                std::atomic_thread_fence(std::memory_order_acquire);
+                result = s.buffer;
+            }
+            s.claimed.store(false, std::memory_order_release);
+            if (result) return result;
+        }
+        allocated = true;
+        return std::make_shared<frame_metadata_blob::buffer>();
+    }
+
+    // Fills the empty slots, so that acquiring allocates only once all the buffers are held
+    void reserve()
+    {
+        for (size_t i = 0; i < _capacity; i++)
+        {
+            auto&& s = _slots[i];
+            bool expected = false;
+            if (!s.claimed.compare_exchange_strong(expected, true, std::memory_order_acquire)) continue;
+            if (!s.buffer) s.buffer = std::make_shared<frame_metadata_blob::buffer>();
+            s.claimed.store(false, std::memory_order_release);
+        }
+    }
+
+private:
+    struct slot
+    {
+        std::atomic<bool> claimed{ false };
+        std::shared_ptr<frame_metadata_blob::buffer> buffer;
+    };
+
+    std::unique_ptr<slot[]> _slots;
+    size_t _capacity;
+    std::atomic<size_t> _next;
+};
+
 struct frame_additional_data
 {
     rs2_time_t timestamp = 0;
@@ -26,7 +139,9 @@ struct frame_additional_data
     rs2_time_t      frame_callback_started = 0;
     uint32_t        metadata_size = 0;
     bool            fisheye_ae_mode = false;
-    std::array<uint8_t,MAX_META_DATA_SIZE> metadata_blob;
+    frame_metadata_blob metadata_blob;
+    const uint8_t*  metadata_source = nullptr;  // Copied into metadata_blob when the archive allocates the frame
+    std::array<rs2_time_t, RS2_FRAME_LATENCY_STAGE_COUNT> latency_breakdown{ {} };
 
     frame_additional_data() {};
 
@@ -36,9 +151,9 @@ struct frame_additional_data
           system_time(in_system_time),
           metadata_size(md_size)
     {
-        // Copy up to 255 bytes to preserve metadata as raw data
+        // Up to 255 bytes are kept as raw data, copied into a buffer of the archive pool by alloc_frame
         if (metadata_size)
-            std::copy(md_buf,md_buf+ std::min(md_size,MAX_META_DATA_SIZE),metadata_blob.begin());
+            metadata_source = md_buf;
     }
 };
 
@@ -46,12 +161,24 @@ namespace librealsense
 {
     typedef std::map<rs2_frame_metadata_value, std::shared_ptr<md_attribute_parser_base>> metadata_parser_map;
 
+    // Payload of a frame as the sensor delivered it, before unpacking, kept for recordings of the native formats
+    struct native_payload
+    {
+        uint32_t fourcc;
+        std::vector<byte> data;
+    };
+
     // Define a movable but explicitly noncopyable buffer type to hold our frame data
     class frame : public frame_interface
     {
     public:
-        std::vector<byte> data;
+        frame_storage data;
         frame_additional_data additional_data;
+        size_t user_data_size = 0; // Size of the user-supplied buffer exposed through the continuation, if any
+        bool read_only_data = false; // The data exposed through the continuation may not be written, as when it is a mapped file
+        std::shared_ptr<const native_payload> native; // Set while a recorder keeps the native payloads of the sensor
+        std::shared_ptr<const change_mask> changes; // Set by a change detector, cleared when the frame is handed out for writing
+        std::shared_ptr<const depth_statistics> statistics; // Set by a statistics block, cleared when the frame is handed out for writing
 
         explicit frame() : ref_count(0), owner(nullptr), on_release() {}
         frame(const frame& r) = delete;
@@ -66,18 +193,30 @@ namespace librealsense
         frame& operator=(frame&& r)
         {
             data = move(r.data);
+            user_data_size = r.user_data_size;
+            read_only_data = r.read_only_data;
+            native = std::move(r.native);
+            changes = std::move(r.changes);
+            statistics = std::move(r.statistics);
             owner = r.owner;
             ref_count = r.ref_count.exchange(0);
             on_release = std::move(r.on_release);
             additional_data = std::move(r.additional_data);
-            r.owner.reset();
+            md_values = r.md_values;
+            md_supported = r.md_supported;
+            md_decoded = r.md_decoded;
+            r.owner = nullptr;
             return *this;
         }
 
         virtual ~frame() { on_release.reset(); }
         rs2_metadata_type get_frame_metadata(const rs2_frame_metadata_value& frame_metadata) const override;
         bool supports_frame_metadata(const rs2_frame_metadata_value& frame_metadata) const override;
+
+        // Parses all the metadata attributes once, before the frame is handed out
+        void decode_metadata();
         const byte* get_frame_data() const override;
+        size_t get_frame_data_size() const override;
         rs2_time_t get_frame_timestamp() const override;
         rs2_timestamp_domain get_frame_timestamp_domain() const override;
         void set_timestamp(double new_ts) override { additional_data.timestamp = new_ts; }
@@ -90,19 +229,23 @@ namespace librealsense
 
         rs2_time_t get_frame_system_time() const override;
 
-        std::shared_ptr<stream_profile_interface> get_stream() const override { return stream; }
-        void set_stream(std::shared_ptr<stream_profile_interface> sp) override { stream = std::move(sp); }
+        const std::shared_ptr<stream_profile_interface>& get_stream() const override { return stream; }
+        // Frame slots are reused for the same stream, so the profile is only replaced when it actually changes
+        void set_stream(const std::shared_ptr<stream_profile_interface>& sp) override;
 
         rs2_time_t get_frame_callback_start_time_point() const override;
         void update_frame_callback_start_ts(rs2_time_t ts) override;
 
         void acquire() override { ref_count.fetch_add(1); }
         void release() override;
-        frame_interface* publish(std::shared_ptr<archive_interface> new_owner) override;
+        frame_interface* publish(archive_interface* new_owner) override;
         void attach_continuation(frame_continuation&& continuation) override { on_release = std::move(continuation); }
         void disable_continuation() override { on_release.reset(); }
 
-        archive_interface* get_owner() const override { return owner.get(); }
+        archive_interface* get_owner() const override { return owner; }
+
+        // True while a single holder observes the frame, so its content may be modified without being seen by others
+        bool is_exclusive() const { return ref_count == 1; }
 
         std::shared_ptr<sensor_interface> get_sensor() const override;
         void set_sensor(std::shared_ptr<sensor_interface> s) override;
@@ -111,37 +254,87 @@ namespace librealsense
         void log_callback_start(rs2_time_t timestamp) override;
         void log_callback_end(rs2_time_t timestamp) const override;
 
+        rs2_time_t get_latency_timestamp(rs2_frame_latency_stage stage) const override { return additional_data.latency_breakdown[stage]; }
+        void set_latency_timestamp(rs2_frame_latency_stage stage, rs2_time_t timestamp) override { additional_data.latency_breakdown[stage] = timestamp; }
+
     private:
-        // TODO: check boost::intrusive_ptr or an alternative
         std::atomic<int> ref_count; // the reference count is on how many times this placeholder has been observed (not lifetime, not content)
-        std::shared_ptr<archive_interface> owner; // pointer to the owner to be returned to by last observe
+        archive_interface* owner; // the owner to be returned to by last observe, kept alive by the published frame itself
         std::weak_ptr<sensor_interface> sensor;
         frame_continuation on_release;
         std::shared_ptr<stream_profile_interface> stream;
+        std::array<rs2_metadata_type, ::RS2_FRAME_METADATA_COUNT> md_values{ {} };
+        uint32_t md_supported = 0;  // Bit per attribute decoded from the metadata
+        bool md_decoded = false;
     };
 
+    // The vertices are followed by their texture coordinates, and optionally by the index of the depth pixel of every vertex
     class points : public frame
     {
     public:
+        points() : frame(), _vertex_format(RS2_FORMAT_XYZ32F), _pixel_indices(false), _normals(false) {}
+
         float3* get_vertices();
         size_t get_vertex_count() const;
         float2* get_texture_coordinates();
+        int* get_pixel_indices(); // nullptr unless the points carry pixel indices
+        float3* get_normals(); // nullptr unless the points carry normals, which follow all the other fields
+
+        rs2_format get_vertex_format() const { return _vertex_format; }
+        void set_layout(rs2_format vertex_format, bool pixel_indices, bool normals = false);
+
+        static size_t get_vertex_size(rs2_format vertex_format);
+        static size_t get_size(size_t vertex_count, rs2_format vertex_format, bool pixel_indices, bool normals = false);
+
+    private:
+        size_t get_point_size() const { return get_size(1, _vertex_format, _pixel_indices, _normals); }
+
+        rs2_format _vertex_format;
+        bool _pixel_indices;
+        bool _normals;
     };
 
     MAP_EXTENSION(RS2_EXTENSION_POINTS, librealsense::points);
 
+    const size_t COMPOSITE_INLINE_FRAMES = 8; // Children a composite frame holds without a separate buffer
+
+    // The children of a composite frame are held inline, inside the frame object recycled by the archive.
+    // Only framesets of more than COMPOSITE_INLINE_FRAMES children keep them in the frame buffer
     class composite_frame : public frame
     {
     public:
-        composite_frame() : frame() {}
+        composite_frame() : frame(), _inline_frames(), _embedded_count(0) { _stream_index.fill(-1); }
+
+        frame_interface* get_frame(int i) const { return get_frames()[i]; }
 
-        frame_interface* get_frame(int i) const
+        frame_interface** get_frames() const
         {
+            return _embedded_count > COMPOSITE_INLINE_FRAMES ? (frame_interface**)data.data()
+                                                             : (frame_interface**)_inline_frames.data();
+        }
+
+        // The frame buffer must hold the pointers to the children beyond the inline capacity
+        void set_embedded_frames_count(size_t count) { _embedded_count = count; }
+
+        // Records the first child of every stream type, once all the children are in place
+        void index_streams()
+        {
+            _stream_index.fill(-1);
             auto frames = get_frames();
-            return frames[i];
+            for (size_t i = _embedded_count; i-- > 0;)
+            {
+                auto stream = frames[i] ? frames[i]->get_stream() : nullptr;
+                if (stream) _stream_index[stream->get_stream_type()] = static_cast<int>(i);
+            }
         }
 
-        frame_interface** get_frames() const { return (frame_interface**)data.data(); }
+        // First child of the stream type, or null
+        frame_interface* find_frame(rs2_stream stream) const
+        {
+            if (stream < 0 || stream >= RS2_STREAM_COUNT) return nullptr;
+            auto index = _stream_index[stream];
+            return index < 0 ? nullptr : get_frame(index);
+        }
 
         const frame_interface* first() const
         {
@@ -152,7 +345,7 @@ namespace librealsense
             return get_frame(0);
         }
 
-        size_t get_embedded_frames_count() const { return data.size() / sizeof(rs2_frame*); }
+        size_t get_embedded_frames_count() const { return _embedded_count; }
 
         // In the next section we make the composite frame "look and feel" like the first of its children
         rs2_metadata_type get_frame_metadata(const rs2_frame_metadata_value& frame_metadata) const override
@@ -190,10 +383,48 @@ namespace librealsense
         {
             return first()->get_sensor();
         }
+        rs2_time_t get_latency_timestamp(rs2_frame_latency_stage stage) const override
+        {
+            if (stage == RS2_FRAME_LATENCY_STAGE_PROCESSING_ENTER || stage == RS2_FRAME_LATENCY_STAGE_PROCESSING_EXIT)
+                return frame::get_latency_timestamp(stage);
+            return first()->get_latency_timestamp(stage);
+        }
+
+    private:
+        std::array<frame_interface*, COMPOSITE_INLINE_FRAMES> _inline_frames;
+        size_t _embedded_count;
+        std::array<int, RS2_STREAM_COUNT> _stream_index;
     };
 
     MAP_EXTENSION(RS2_EXTENSION_COMPOSITE_FRAME, librealsense::composite_frame);
 
+    // Monotonic time in milliseconds for the latency stages, or zero when latency instrumentation is disabled
+    inline rs2_time_t get_latency_time()
+    {
+        if (!environment::get_instance().is_latency_instrumentation_enabled()) return 0;
+        using namespace std::chrono;
+        return duration<rs2_time_t, std::milli>(steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Record the time a frame reached a latency stage. Stamping a frameset stamps all of its frames,
+    // except for the processing stages, which belong to the block that produced each frame
+    inline void log_latency_stage(frame_interface* f, rs2_frame_latency_stage stage, rs2_time_t timestamp)
+    {
+        if (!timestamp || !f) return;
+        f->set_latency_timestamp(stage, timestamp);
+        if (stage == RS2_FRAME_LATENCY_STAGE_PROCESSING_ENTER || stage == RS2_FRAME_LATENCY_STAGE_PROCESSING_EXIT) return;
+        if (auto composite = dynamic_cast<composite_frame*>(f))
+        {
+            for (size_t i = 0; i < composite->get_embedded_frames_count(); i++)
+                log_latency_stage(composite->get_frame(static_cast<int>(i)), stage, timestamp);
+        }
+    }
+
+    inline void log_latency_stage(frame_interface* f, rs2_frame_latency_stage stage)
+    {
+        log_latency_stage(f, stage, get_latency_time());
+    }
+
     class video_frame : public frame
     {
     public:
@@ -223,10 +454,23 @@ namespace librealsense
     class depth_frame : public video_frame
     {
     public:
-        depth_frame() : video_frame()
+        depth_frame() : video_frame(), _units(0)
         {
         }
 
+        depth_frame(depth_frame&& other)
+            : video_frame(std::move(other)), _original(std::move(other._original)), _units(other._units.load())
+        {
+        }
+
+        depth_frame& operator=(depth_frame&& other)
+        {
+            video_frame::operator=(std::move(other));
+            _original = std::move(other._original);
+            _units = other._units.load();
+            return *this;
+        }
+
         float get_distance(int x, int y) const
         {
             if (_original)
@@ -245,7 +489,17 @@ namespace librealsense
             return pixel * get_units();
         }
 
-        float get_units() const { return query_units(this->get_sensor()); }
+        // The sensor is queried once per frame, since get_distance is typically called for many of its pixels
+        float get_units() const
+        {
+            auto units = _units.load(std::memory_order_relaxed);
+            if (units == 0)
+            {
+                units = query_units(this->get_sensor());
+                _units.store(units, std::memory_order_relaxed);
+            }
+            return units;
+        }
 
         const frame_interface* get_original_depth() const
         {
@@ -259,6 +513,9 @@ namespace librealsense
             return res;
         }
 
+        // Units of a frame derived from another, which does not keep the original frame to query them
+        void set_units(float units) { _units.store(units, std::memory_order_relaxed); }
+
         void set_original(frame_holder h)
         {
             _original = std::move(h);
@@ -310,6 +567,7 @@ namespace librealsense
         }
 
         frame_holder _original;
+        mutable std::atomic<float> _units; // Zero until queried
     };
 
     MAP_EXTENSION(RS2_EXTENSION_DEPTH_FRAME, librealsense::depth_frame);
@@ -323,13 +581,43 @@ namespace librealsense
 
         virtual frame_interface* alloc_and_track(const size_t size, const frame_additional_data& additional_data, bool requires_memory) = 0;
 
-        virtual std::shared_ptr<metadata_parser_map> get_md_parsers() const = 0;
+        virtual const std::shared_ptr<metadata_parser_map>& get_md_parsers() const = 0;
+
+        // The parser of an attribute, or null when the frames of the archive do not have it
+        virtual md_attribute_parser_base* get_md_parser(rs2_frame_metadata_value frame_metadata) const = 0;
+
+        virtual void set_frame_allocator(frame_allocator_ptr allocator, size_t alignment) = 0;
+
+        // Placement of the buffers the archive allocates from now on
+        virtual void set_frame_memory(const frame_memory_policy& policy) = 0;
+
+        // Cache buffers for every frame of the size that may be published at once, for the realtime mode of sensors
+        // Frames that still need a new frame or metadata buffer afterwards are counted, reported on flush
+        // and assert in debug builds
+        virtual void reserve_buffers(size_t size) = 0;
+
+        // Buffers the archive caches per size class of frames, see frame_buffer_pool
+        virtual void set_buffer_pool_high_water_mark(uint32_t value) = 0;
+        virtual frame_buffer_pool_stats get_buffer_pool_stats() const = 0;
 
         virtual void flush() = 0;
 
         virtual frame_interface* publish_frame(frame_interface* frame) = 0;
         virtual void unpublish_frame(frame_interface* frame) = 0;
 
+        // Frames of the archive currently held by the application or processing
+        virtual uint32_t get_published_frames_count() const = 0;
+
+        // Archives that track their frames record the stream of a frame when it is set, after publishing
+        virtual void on_stream_set(frame_interface* frame, const std::shared_ptr<stream_profile_interface>& sp) = 0;
+
+        // Appends the frames still held to the list, when the archive tracks its frames
+        virtual void get_outstanding_frames(std::vector<rs2_outstanding_frame>& frames, rs2_time_t now) const = 0;
+
+        // The archive is referenced by its frame source and by each published frame, and deletes itself
+        // once the last of them is gone. Called by the deleter of the pointer make_archive returns
+        virtual void release_source() = 0;
+
         virtual ~archive_interface() = default;
 
     };
@@ -338,4 +626,11 @@ namespace librealsense
                                                     std::atomic<uint32_t>* in_max_frame_queue_size,
                                                     std::shared_ptr<platform::time_service> ts,
                                                     std::shared_ptr<metadata_parser_map> parsers);
+
+    // Archives created while frame tracking is enabled, or with LRS_FRAME_TRACKING defined in the environment,
+    // record every frame they hand out until it is released, so the holders of frames can be found
+    void enable_frame_tracking(bool enable);
+
+    // The frames still held from the tracking archives, oldest first
+    std::vector<rs2_outstanding_frame> query_outstanding_frames();
 }
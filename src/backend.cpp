@@ -13,6 +13,61 @@
 
 #include "backend.h"
 
+#ifdef RS2_PROCESSING_ONLY
+#include "types.h"
+
+namespace librealsense
+{
+    namespace platform
+    {
+        // realsense2-proc has no platform backend, its contexts list only the devices added to them
+        class null_device_watcher : public device_watcher
+        {
+        public:
+            void start(device_changed_callback) override {}
+            void stop() override {}
+        };
+
+        class null_backend : public backend
+        {
+        public:
+            std::shared_ptr<uvc_device> create_uvc_device(uvc_device_info) const override
+            {
+                throw not_implemented_exception("realsense2-proc does not access UVC devices");
+            }
+            std::vector<uvc_device_info> query_uvc_devices() const override { return {}; }
+
+            std::shared_ptr<usb_device> create_usb_device(usb_device_info) const override
+            {
+                throw not_implemented_exception("realsense2-proc does not access USB devices");
+            }
+            std::vector<usb_device_info> query_usb_devices() const override { return {}; }
+
+            std::shared_ptr<hid_device> create_hid_device(hid_device_info) const override
+            {
+                throw not_implemented_exception("realsense2-proc does not access HID devices");
+            }
+            std::vector<hid_device_info> query_hid_devices() const override { return {}; }
+
+            std::shared_ptr<time_service> create_time_service() const override
+            {
+                return std::make_shared<os_time_service>();
+            }
+
+            std::shared_ptr<device_watcher> create_device_watcher() const override
+            {
+                return std::make_shared<null_device_watcher>();
+            }
+        };
+
+        std::shared_ptr<backend> create_backend()
+        {
+            return std::make_shared<null_backend>();
+        }
+    }
+}
+#endif
+
 void librealsense::platform::control_range::populate_raw_data(std::vector<uint8_t>& vec, int32_t value)
 {
     vec.resize(sizeof(value));
@@ -11,6 +11,8 @@
 #include <memory>       // For shared_ptr
 #include <functional>   // For function
 #include <thread>       // For this_thread::sleep_for
+#include <chrono>
+#include <atomic>
 #include <vector>
 #include <algorithm>
 #include <set>
@@ -61,6 +63,71 @@ namespace librealsense
         return false;
     }
 
+    // Time budget of a device command, counting the wait for the device, the transfers and the retries, which another
+    // thread may also cancel. Copies share the cancellation. A transfer already sent is not interrupted, the command
+    // only gives up once it returns, and the transfer timeouts are shortened to what is left of the budget
+    class command_deadline
+    {
+    public:
+        typedef std::chrono::steady_clock clock;
+
+        // No time limit, only cancellation
+        command_deadline()
+            : _cancelled(std::make_shared<std::atomic<bool>>(false)), _end(clock::time_point::max()) {}
+        explicit command_deadline(std::chrono::milliseconds timeout)
+            : _cancelled(std::make_shared<std::atomic<bool>>(false)), _end(clock::now() + timeout) {}
+
+        void cancel() { *_cancelled = true; }
+        bool is_cancelled() const { return *_cancelled; }
+        bool is_bounded() const { return _end != clock::time_point::max(); }
+        bool has_passed() const { return is_cancelled() || (is_bounded() && clock::now() >= _end); }
+
+        // The timeout of a transfer, cut to the time left, 0 once the deadline has passed
+        int transfer_timeout(int timeout_ms) const
+        {
+            if (has_passed()) return 0;
+            if (!is_bounded()) return timeout_ms;
+            auto left = std::chrono::duration_cast<std::chrono::milliseconds>(_end - clock::now()).count();
+            return static_cast<int>(std::max<long long>(1, std::min<long long>(timeout_ms, left)));
+        }
+
+        // Waits before a retry, false without waiting past the deadline when there is no time left for one
+        bool sleep_before_retry(std::chrono::milliseconds delay) const
+        {
+            if (is_bounded() && clock::now() + delay >= _end) return false;
+            std::this_thread::sleep_for(delay);
+            return !has_passed();
+        }
+
+        // The deadline of the command in progress on this thread, so that the retries of the controls it reaches
+        // through the backend give up with it. Unbounded outside of a command
+        static command_deadline current()
+        {
+            auto deadline = current_slot();
+            return deadline ? *deadline : command_deadline();
+        }
+
+        class scope
+        {
+        public:
+            explicit scope(const command_deadline& deadline) : _previous(current_slot()) { current_slot() = &deadline; }
+            ~scope() { current_slot() = _previous; }
+        private:
+            scope(const scope&) = delete;
+            scope& operator=(const scope&) = delete;
+            const command_deadline* _previous;
+        };
+
+    private:
+        static const command_deadline*& current_slot()
+        {
+            static thread_local const command_deadline* deadline = nullptr;
+            return deadline;
+        }
+
+        std::shared_ptr<std::atomic<bool>> _cancelled;
+        clock::time_point _end;
+    };
 
     namespace platform
     {
@@ -105,6 +172,26 @@ namespace librealsense
             }
         };
 
+        // Time of the steady clock, mapped onto the system clock by the offset between the two when it is created,
+        // so it reads as system time does but never goes back nor jumps with adjustments of the wall clock
+        class monotonic_time_service : public time_service
+        {
+        public:
+            monotonic_time_service()
+                : _origin(std::chrono::steady_clock::now()),
+                  _system_origin(os_time_service().get_time())
+            {}
+
+            rs2_time_t get_time() const override
+            {
+                return _system_origin + std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - _origin).count();
+            }
+
+        private:
+            std::chrono::steady_clock::time_point _origin;
+            rs2_time_t _system_origin;
+        };
+
         struct guid { uint32_t data1; uint16_t data2, data3; uint8_t data4[8]; };
         // subdevice and node fields are assigned by Host driver; unit and GUID are hard-coded in camera firmware
         struct extension_unit { int subdevice, unit, node; guid id; };
@@ -117,6 +204,28 @@ namespace librealsense
                 int timeout_ms = 5000,
                 bool require_response = true) = 0;
 
+            // Sends the commands in order and returns their responses, backends that can keep several commands in
+            // flight override this to overlap the latency of the transfers
+            // Stops once the command deadline of the thread passes, returning only the responses received until then
+            // The time each response was received is added to received when given
+            virtual std::vector<std::vector<uint8_t>> send_receive_batch(
+                const std::vector<std::vector<uint8_t>>& commands,
+                int timeout_ms = 5000,
+                std::vector<command_deadline::clock::time_point>* received = nullptr)
+            {
+                auto deadline = command_deadline::current();
+                std::vector<std::vector<uint8_t>> results;
+                results.reserve(commands.size());
+                for (auto&& data : commands)
+                {
+                    auto timeout = deadline.transfer_timeout(timeout_ms);
+                    if (!timeout) break;
+                    results.push_back(send_receive(data, timeout, true));
+                    if (received) received->push_back(command_deadline::clock::now());
+                }
+                return results;
+            }
+
             virtual ~command_transfer() = default;
         };
 
@@ -339,6 +448,8 @@ namespace librealsense
         };
 
         typedef std::function<void(const sensor_data&)> hid_callback;
+        // Several samples delivered by a single call, in the order they arrived
+        typedef std::function<void(const sensor_data* samples, size_t count)> hid_batch_callback;
 
         class hid_device
         {
@@ -348,6 +459,11 @@ namespace librealsense
             virtual void close() = 0;
             virtual void stop_capture() = 0;
             virtual void start_capture(hid_callback callback) = 0;
+            // Backends that receive samples in groups override this to deliver each group with one call
+            virtual void start_batch_capture(hid_batch_callback callback)
+            {
+                start_capture([callback](const sensor_data& sample) { callback(&sample, 1); });
+            }
             virtual std::vector<hid_sensor> get_sensors() = 0;
             virtual std::vector<uint8_t> get_custom_report_data(const std::string& custom_sensor_name,
                                                                 const std::string& report_name,
@@ -385,8 +501,28 @@ namespace librealsense
             virtual void lock() const = 0;
             virtual void unlock() const = 0;
 
+            // While a lease is held the device stays locked against other processes, so that lock and unlock
+            // only do in-process bookkeeping. Taken around bursts of controls. Backends without a cross-process
+            // lock ignore it
+            virtual void acquire_lease() const {}
+            virtual void release_lease() const {}
+
             virtual std::string get_device_location() const = 0;
 
+            // Keep the streaming buffers of a closed profile while powered, so that committing the same profile
+            // again does not allocate them. Backends that cannot keep them ignore it
+            virtual void set_keep_buffers(bool keep) {}
+
+            // Lets the backend choose the number of streaming buffers of each commit, between the number requested and
+            // max_buffers, from how long the frames of the previous sessions held them. 0 allocates the number requested
+            virtual void set_adaptive_buffers(int max_buffers) {}
+            // Streaming buffers allocated for the committed profiles, 0 when the backend does not tell
+            virtual int get_buffer_count() const { return 0; }
+
+            // Calls the callback, from a thread of the backend, when the device signals a change of the control
+            // through its status interrupt endpoint, a null callback stops the calls. Backends and devices without
+            // such signals return false, the control must then be polled
+            virtual bool set_xu_change_callback(const extension_unit& xu, uint8_t ctrl, std::function<void()> callback) { return false; }
 
             virtual ~uvc_device() = default;
 
@@ -394,6 +530,20 @@ namespace librealsense
             std::function<void(const notification& n)> _error_handler;
         };
 
+        // Holds a lease of the device for its scope
+        class uvc_device_lease
+        {
+        public:
+            explicit uvc_device_lease(const uvc_device& dev) : _dev(dev) { _dev.acquire_lease(); }
+            ~uvc_device_lease() { try { _dev.release_lease(); } catch (...) {} }
+
+            uvc_device_lease(const uvc_device_lease&) = delete;
+            uvc_device_lease& operator=(const uvc_device_lease&) = delete;
+
+        private:
+            const uvc_device& _dev;
+        };
+
         class retry_controls_work_around : public uvc_device
         {
         public:
@@ -425,6 +575,26 @@ namespace librealsense
                 _dev->close(profile);
             }
 
+            void set_keep_buffers(bool keep) override
+            {
+                _dev->set_keep_buffers(keep);
+            }
+
+            void set_adaptive_buffers(int max_buffers) override
+            {
+                _dev->set_adaptive_buffers(max_buffers);
+            }
+
+            int get_buffer_count() const override
+            {
+                return _dev->get_buffer_count();
+            }
+
+            bool set_xu_change_callback(const extension_unit& xu, uint8_t ctrl, std::function<void()> callback) override
+            {
+                return _dev->set_xu_change_callback(xu, ctrl, std::move(callback));
+            }
+
             void set_power_state(power_state state) override
             {
                 _dev->set_power_state(state);
@@ -442,26 +612,12 @@ namespace librealsense
 
             bool set_xu(const extension_unit& xu, uint8_t ctrl, const uint8_t* data, int len) override
             {
-                for (auto i = 0; i < MAX_RETRIES; ++i)
-                {
-                    if (_dev->set_xu(xu, ctrl, data, len))
-                        return true;
-
-                    std::this_thread::sleep_for(std::chrono::milliseconds(DELAY_FOR_RETRIES));
-                }
-                return false;
+                return retry([&]() { return _dev->set_xu(xu, ctrl, data, len); });
             }
 
             bool get_xu(const extension_unit& xu, uint8_t ctrl, uint8_t* data, int len) const override
             {
-                for (auto i = 0; i < MAX_RETRIES; ++i)
-                {
-                    if (_dev->get_xu(xu, ctrl, data, len))
-                        return true;
-
-                    std::this_thread::sleep_for(std::chrono::milliseconds(DELAY_FOR_RETRIES));
-                }
-                return false;
+                return retry([&]() { return _dev->get_xu(xu, ctrl, data, len); });
             }
 
             control_range get_xu_range(const extension_unit& xu, uint8_t ctrl, int len) const override
@@ -471,26 +627,12 @@ namespace librealsense
 
             bool get_pu(rs2_option opt, int32_t& value) const override
             {
-                for (auto i = 0; i < MAX_RETRIES; ++i)
-                {
-                    if (_dev->get_pu(opt, value))
-                        return true;
-
-                    std::this_thread::sleep_for(std::chrono::milliseconds(DELAY_FOR_RETRIES));
-                }
-                return false;
+                return retry([&]() { return _dev->get_pu(opt, value); });
             }
 
             bool set_pu(rs2_option opt, int32_t value) override
             {
-                for (auto i = 0; i < MAX_RETRIES; ++i)
-                {
-                    if (_dev->set_pu(opt, value))
-                        return true;
-
-                    std::this_thread::sleep_for(std::chrono::milliseconds(DELAY_FOR_RETRIES));
-                }
-                return false;
+                return retry([&]() { return _dev->set_pu(opt, value); });
             }
 
             control_range get_pu_range(rs2_option opt) const override
@@ -511,7 +653,27 @@ namespace librealsense
             void lock() const override { _dev->lock(); }
             void unlock() const override { _dev->unlock(); }
 
+            void acquire_lease() const override { _dev->acquire_lease(); }
+            void release_lease() const override { _dev->release_lease(); }
+
         private:
+            // Up to MAX_RETRIES attempts, giving up early with the deadline of the command in progress on this thread,
+            // and without waiting after the last attempt
+            template<class T>
+            static bool retry(T attempt)
+            {
+                auto deadline = command_deadline::current();
+                for (auto i = 0; i < MAX_RETRIES; ++i)
+                {
+                    if (attempt())
+                        return true;
+
+                    if (i + 1 == MAX_RETRIES || !deadline.sleep_before_retry(std::chrono::milliseconds(DELAY_FOR_RETRIES)))
+                        break;
+                }
+                return false;
+            }
+
             std::shared_ptr<uvc_device> _dev;
         };
 
@@ -633,6 +795,11 @@ namespace librealsense
                 _dev.front()->start_capture(callback);
             }
 
+            void start_batch_capture(hid_batch_callback callback) override
+            {
+                _dev.front()->start_batch_capture(callback);
+            }
+
             std::vector<hid_sensor> get_sensors() override
             {
                 return _dev.front()->get_sensors();
@@ -699,6 +866,32 @@ namespace librealsense
                 _configured_indexes.erase(dev_index);
             }
 
+            void set_keep_buffers(bool keep) override
+            {
+                for (auto& elem : _dev)
+                {
+                    elem->set_keep_buffers(keep);
+                }
+            }
+
+            void set_adaptive_buffers(int max_buffers) override
+            {
+                for (auto& elem : _dev)
+                {
+                    elem->set_adaptive_buffers(max_buffers);
+                }
+            }
+
+            int get_buffer_count() const override
+            {
+                int count = 0;
+                for (auto& elem : _dev)
+                {
+                    count += elem->get_buffer_count();
+                }
+                return count;
+            }
+
             void set_power_state(power_state state) override
             {
                 for (auto& elem : _dev)
@@ -727,6 +920,11 @@ namespace librealsense
                 return _dev.front()->get_xu(xu, ctrl, data, len);
             }
 
+            bool set_xu_change_callback(const extension_unit& xu, uint8_t ctrl, std::function<void()> callback) override
+            {
+                return _dev.front()->set_xu_change_callback(xu, ctrl, std::move(callback));
+            }
+
             control_range get_xu_range(const extension_unit& xu, uint8_t ctrl, int len) const override
             {
                 return _dev.front()->get_xu_range(xu, ctrl, len);
@@ -792,6 +990,34 @@ namespace librealsense
                 }
             }
 
+            void acquire_lease() const override
+            {
+                std::vector<uvc_device*> leased_dev;
+                try {
+                    for (auto& elem : _dev)
+                    {
+                        elem->acquire_lease();
+                        leased_dev.push_back(elem.get());
+                    }
+                }
+                catch(...)
+                {
+                    for (auto& elem : leased_dev)
+                    {
+                        elem->release_lease();
+                    }
+                    throw;
+                }
+            }
+
+            void release_lease() const override
+            {
+                for (auto& elem : _dev)
+                {
+                    elem->release_lease();
+                }
+            }
+
         private:
             uint32_t get_dev_index_by_profiles(const stream_profile& profile) const
             {
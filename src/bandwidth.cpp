@@ -0,0 +1,204 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#include "bandwidth.h"
+#include "core/streaming.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+
+namespace librealsense
+{
+    // A USB 3 Gen 1 controller carries about 400 MB/s of payload, some of it is kept for the other devices on it
+    static const double DEFAULT_USB_BANDWIDTH = 350e6;
+
+    enum class admission_policy { warn, reject, off };
+
+    static admission_policy get_admission_policy()
+    {
+        auto value = getenv("LRS_USB_ADMISSION");
+        if (!value) return admission_policy::warn;
+        std::string policy(value);
+        if (policy == "reject") return admission_policy::reject;
+        if (policy == "off") return admission_policy::off;
+        return admission_policy::warn;
+    }
+
+    static double get_usb_bandwidth()
+    {
+        if (auto value = getenv("LRS_USB_BANDWIDTH"))
+        {
+            auto mb = atof(value);
+            if (mb > 0) return mb * 1e6;
+        }
+        return DEFAULT_USB_BANDWIDTH;
+    }
+
+    static double get_payload_rate(const request_mapping& mode, const platform::stream_profile& p)
+    {
+        return static_cast<double>(mode.pf->get_image_size(p.width, p.height)) * p.fps;
+    }
+
+    double get_payload_rate(const request_mapping& mode)
+    {
+        return get_payload_rate(mode, mode.profile);
+    }
+
+    std::string get_usb_controller(const std::string& device_location)
+    {
+        // Linux locations are sysfs paths, where the root hub of the controller is named usb followed by the bus number
+        auto pos = device_location.find("/usb");
+        while (pos != std::string::npos)
+        {
+            auto end = pos + 4;
+            while (end < device_location.size() && isdigit(static_cast<unsigned char>(device_location[end]))) end++;
+            if (end > pos + 4 && (end == device_location.size() || device_location[end] == '/'))
+                return device_location.substr(0, end);
+            pos = device_location.find("/usb", pos + 1);
+        }
+        // Other locations name the device alone, which then counts as being on a controller of its own
+        return device_location;
+    }
+
+    std::vector<platform::stream_profile> fit_bandwidth(const std::vector<request_mapping>& modes,
+                                                        const std::vector<platform::stream_profile>& available,
+                                                        double budget)
+    {
+        // The profiles each mode can be lowered to, heaviest first
+        std::vector<std::vector<platform::stream_profile>> steps(modes.size());
+        std::vector<size_t> current(modes.size(), 0);
+        double total = 0;
+        for (size_t i = 0; i < modes.size(); i++)
+        {
+            auto&& mode = modes[i];
+            for (auto&& p : available)
+                if (p.format == mode.profile.format && get_payload_rate(mode, p) <= get_payload_rate(mode))
+                    steps[i].push_back(p);
+            std::sort(steps[i].begin(), steps[i].end(), [&](const platform::stream_profile& a, const platform::stream_profile& b)
+            {
+                return get_payload_rate(mode, a) > get_payload_rate(mode, b);
+            });
+            if (steps[i].empty()) steps[i].push_back(mode.profile);
+            total += get_payload_rate(mode, steps[i].front());
+        }
+
+        while (total > budget)
+        {
+            // The heaviest mode that can still be lowered takes the next step down
+            int heaviest = -1;
+            for (size_t i = 0; i < modes.size(); i++)
+            {
+                if (current[i] + 1 >= steps[i].size()) continue;
+                if (heaviest < 0 || get_payload_rate(modes[i], steps[i][current[i]]) > get_payload_rate(modes[heaviest], steps[heaviest][current[heaviest]]))
+                    heaviest = static_cast<int>(i);
+            }
+            if (heaviest < 0) return{};
+
+            total -= get_payload_rate(modes[heaviest], steps[heaviest][current[heaviest]]);
+            current[heaviest]++;
+            total += get_payload_rate(modes[heaviest], steps[heaviest][current[heaviest]]);
+        }
+
+        std::vector<platform::stream_profile> result;
+        for (size_t i = 0; i < modes.size(); i++)
+            result.push_back(steps[i][current[i]]);
+        return result;
+    }
+
+    class bandwidth_registry
+    {
+    public:
+        static bandwidth_registry& get()
+        {
+            // Never destroyed, as sensors of other singletons may close after static destruction
+            static auto instance = new bandwidth_registry();
+            return *instance;
+        }
+
+        double reserved(const std::string& controller)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _reserved[controller];
+        }
+
+        void add(const std::string& controller, double rate)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _reserved[controller] += rate;
+        }
+
+        void remove(const std::string& controller, double rate)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto it = _reserved.find(controller);
+            if (it == _reserved.end()) return;
+            it->second -= rate;
+            if (it->second <= 0) _reserved.erase(it);
+        }
+
+    private:
+        std::mutex _mutex;
+        std::map<std::string, double> _reserved;
+    };
+
+    bandwidth_reservation::bandwidth_reservation(const std::string& controller, double rate)
+        : _controller(controller), _rate(rate)
+    {
+        bandwidth_registry::get().add(_controller, _rate);
+    }
+
+    bandwidth_reservation::~bandwidth_reservation()
+    {
+        bandwidth_registry::get().remove(_controller, _rate);
+    }
+
+    std::unique_ptr<bandwidth_reservation> reserve_bandwidth(const std::string& sensor_name,
+                                                             const std::string& device_location,
+                                                             const std::vector<request_mapping>& modes,
+                                                             const std::vector<platform::stream_profile>& available)
+    {
+        auto policy = get_admission_policy();
+        auto controller = get_usb_controller(device_location);
+        // Without a location the topology is unknown, and sensors of different devices can not be told apart
+        if (policy == admission_policy::off || controller.empty())
+            return nullptr;
+
+        double rate = 0;
+        for (auto&& mode : modes)
+            rate += get_payload_rate(mode);
+
+        // Checking and reserving are not one step, two sensors opened at once may both pass and be over the budget together
+        auto budget = get_usb_bandwidth();
+        auto reserved = bandwidth_registry::get().reserved(controller);
+        if (reserved + rate > budget)
+        {
+            to_string message;
+            message << sensor_name << " needs " << int(rate / 1e6) << " MB/s, " << int(reserved / 1e6)
+                    << " MB/s of the " << int(budget / 1e6) << " MB/s of its USB controller are taken";
+
+            auto fitting = fit_bandwidth(modes, available, budget - reserved);
+            if (fitting.empty())
+                message << ", no lower resolution or frame rate of the requested formats fits";
+            else
+            {
+                message << ", the highest payload that fits is";
+                for (size_t i = 0; i < fitting.size(); i++)
+                {
+                    message << (i ? ", " : " ");
+                    for (auto&& request : modes[i].original_requests)
+                        message << get_string(request->get_stream_type()) << " ";
+                    message << fitting[i].width << "x" << fitting[i].height << " at " << fitting[i].fps << " fps";
+                }
+            }
+
+            std::string text = message;
+            if (policy == admission_policy::reject)
+                throw invalid_value_exception(text);
+            LOG_WARNING(text << ", frames may be dropped");
+        }
+
+        return std::unique_ptr<bandwidth_reservation>(new bandwidth_reservation(controller, rate));
+    }
+}
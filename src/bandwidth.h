@@ -0,0 +1,46 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "types.h"
+#include "backend.h"
+
+namespace librealsense
+{
+    // Bytes per second the frames of the mode bring over the bus, from the size of its native pixel format
+    double get_payload_rate(const request_mapping& mode);
+
+    // The USB controller a device is connected to, taken from its location. Empty when the location does not tell
+    std::string get_usb_controller(const std::string& device_location);
+
+    // Lowers the modes, one step of resolution or frame rate of the same native format at a time starting from
+    // the heaviest, until their payload fits in the budget. Returns the profiles found, or none when nothing fits
+    std::vector<platform::stream_profile> fit_bandwidth(const std::vector<request_mapping>& modes,
+                                                        const std::vector<platform::stream_profile>& available,
+                                                        double budget);
+
+    // Payload of an opened sensor, counted against its controller for as long as the object lives
+    class bandwidth_reservation
+    {
+    public:
+        bandwidth_reservation(const std::string& controller, double rate);
+        ~bandwidth_reservation();
+
+        bandwidth_reservation(const bandwidth_reservation&) = delete;
+        bandwidth_reservation& operator=(const bandwidth_reservation&) = delete;
+
+    private:
+        std::string _controller;
+        double _rate;
+    };
+
+    // Checks the payload of the modes against what the other sensors on the controller already take. Over the budget
+    // the sensor is refused or a warning is logged, both naming the highest payload modes that would fit
+    // Defining LRS_USB_BANDWIDTH in the environment sets the budget of a controller in MB/s, and
+    // LRS_USB_ADMISSION to "reject" refuses oversubscribed sensors, to "off" disables the checks
+    std::unique_ptr<bandwidth_reservation> reserve_bandwidth(const std::string& sensor_name,
+                                                             const std::string& device_location,
+                                                             const std::vector<request_mapping>& modes,
+                                                             const std::vector<platform::stream_profile>& available);
+}
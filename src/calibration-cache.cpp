@@ -0,0 +1,167 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2015 Intel Corporation. All Rights Reserved.
+
+#include <cstdio>
+#include <fstream>
+#include "types.h"
+#include "calibration-cache.h"
+
+namespace librealsense
+{
+    // File layout: magic, then for each table the serial, firmware version and name as length prefixed strings,
+    // followed by the CRC32 of the table, its size and its bytes
+    static const uint32_t CALIBRATION_CACHE_MAGIC = 0x31434352; // "RCC1"
+    static const char* CALIBRATION_CACHE_FILE = "calibration.cache";
+    static const uint32_t MAX_CALIBRATION_TABLE_SIZE = 0x10000;
+
+    template<class T>
+    static bool read_value(std::istream& in, T& value)
+    {
+        return !!in.read(reinterpret_cast<char*>(&value), sizeof(value));
+    }
+
+    static bool read_string(std::istream& in, std::string& str)
+    {
+        uint16_t size;
+        if (!read_value(in, size))
+            return false;
+        str.resize(size);
+        return size == 0 || !!in.read(&str[0], size);
+    }
+
+    template<class T>
+    static void write_value(std::ostream& out, const T& value)
+    {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    static void write_string(std::ostream& out, const std::string& str)
+    {
+        write_value(out, static_cast<uint16_t>(str.size()));
+        out.write(str.data(), str.size());
+    }
+
+    calibration_cache::calibration_cache()
+        : _loaded(false)
+    {
+    }
+
+    void calibration_cache::set_directory(const std::string& directory)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _tables.clear();
+        _loaded = false;
+        _path.clear();
+        if (!directory.empty())
+        {
+            auto separator = directory.back() == '/' || directory.back() == '\\' ? "" : "/";
+            _path = directory + separator + CALIBRATION_CACHE_FILE;
+        }
+    }
+
+    std::vector<uint8_t> calibration_cache::get(const std::string& serial, const std::string& fw_version, const std::string& table,
+                                                std::function<std::vector<uint8_t>()> read)
+    {
+        auto k = std::make_tuple(serial, fw_version, table);
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_path.empty())
+                return read();
+
+            if (!_loaded)
+            {
+                load();
+                _loaded = true;
+            }
+            auto it = _tables.find(k);
+            if (it != _tables.end())
+                return it->second;
+        }
+
+        //Devices read their tables concurrently, the lock is not held while reading
+        auto data = read();
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_path.empty())
+            return data;
+        //Tables cached by other processes in the meantime are kept
+        load();
+        _tables[k] = data;
+        save();
+        return data;
+    }
+
+    void calibration_cache::invalidate(const std::string& serial)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_path.empty())
+            return;
+
+        load();
+        for (auto it = _tables.begin(); it != _tables.end();)
+        {
+            if (serial.empty() || std::get<0>(it->first) == serial)
+                it = _tables.erase(it);
+            else
+                ++it;
+        }
+        save();
+    }
+
+    // Adds the tables of the file that are not in memory, a damaged file is ignored from the damaged table on
+    void calibration_cache::load()
+    {
+        std::ifstream in(_path, std::ios::binary);
+        uint32_t magic;
+        if (!in || !read_value(in, magic) || magic != CALIBRATION_CACHE_MAGIC)
+            return;
+
+        while (true)
+        {
+            std::string serial, fw_version, table;
+            uint32_t crc, size;
+            if (!read_string(in, serial) || !read_string(in, fw_version) || !read_string(in, table) ||
+                !read_value(in, crc) || !read_value(in, size) || size > MAX_CALIBRATION_TABLE_SIZE)
+                return;
+
+            std::vector<uint8_t> data(size);
+            if (size > 0 && !in.read(reinterpret_cast<char*>(data.data()), size))
+                return;
+            if (calc_crc32(data.data(), data.size()) != crc)
+            {
+                LOG_WARNING("Calibration cache " << _path << " is damaged, its remaining tables are read from the devices");
+                return;
+            }
+            _tables.insert(std::make_pair(std::make_tuple(serial, fw_version, table), std::move(data)));
+        }
+    }
+
+    void calibration_cache::save()
+    {
+        auto temp_path = _path + ".tmp";
+        {
+            std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+            write_value(out, CALIBRATION_CACHE_MAGIC);
+            for (auto&& t : _tables)
+            {
+                write_string(out, std::get<0>(t.first));
+                write_string(out, std::get<1>(t.first));
+                write_string(out, std::get<2>(t.first));
+                write_value(out, calc_crc32(t.second.data(), t.second.size()));
+                write_value(out, static_cast<uint32_t>(t.second.size()));
+                out.write(reinterpret_cast<const char*>(t.second.data()), t.second.size());
+            }
+            if (!out.flush())
+            {
+                LOG_WARNING("Failed to write calibration cache " << temp_path);
+                return;
+            }
+        }
+        //rename does not replace an existing file on all platforms
+        std::remove(_path.c_str());
+        if (std::rename(temp_path.c_str(), _path.c_str()) != 0)
+        {
+            LOG_WARNING("Failed to replace calibration cache " << _path);
+        }
+    }
+}
@@ -0,0 +1,45 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2015 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace librealsense
+{
+    // Raw calibration tables of devices, kept in a file so that later processes do not read them from the device again
+    // Tables are keyed by the serial number and firmware version of their device, so tables of a previous firmware
+    // are never used. The cache is disabled until a directory is set
+    class calibration_cache
+    {
+    public:
+        calibration_cache();
+
+        // An empty directory disables the cache
+        void set_directory(const std::string& directory);
+
+        // Returns the cached table, or reads it with the given function and caches it
+        std::vector<uint8_t> get(const std::string& serial, const std::string& fw_version, const std::string& table,
+                                 std::function<std::vector<uint8_t>()> read);
+
+        // Drops the tables of a device, or of all the devices for an empty serial
+        void invalidate(const std::string& serial);
+
+    private:
+        using key = std::tuple<std::string, std::string, std::string>;
+
+        void load();
+        void save();
+
+        std::mutex _mutex;
+        std::string _path;
+        bool _loaded;
+        std::map<key, std::vector<uint8_t>> _tables;
+    };
+}
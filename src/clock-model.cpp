@@ -0,0 +1,86 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2015 Intel Corporation. All Rights Reserved.
+
+#include <cmath>
+
+#include "clock-model.h"
+
+namespace librealsense
+{
+    const size_t CLOCK_MODEL_WINDOW          = 64;      // Frames the clock of a device is fitted to
+    const double CLOCK_MODEL_MIN_SPAN_MS     = 1000;    // Shorter windows only estimate the offset, keeping the slope at one
+    const double CLOCK_MODEL_RESET_MS        = 1000;    // A larger prediction error means the device clock was reset
+
+    void device_clock_model::add_sample(double hw_time, double host_time)
+    {
+        if (!_samples.empty() && std::fabs(to_host(hw_time) - host_time) > CLOCK_MODEL_RESET_MS)
+            _samples.clear();
+
+        if (_samples.empty())
+        {
+            _hw_origin = hw_time;
+            _host_origin = host_time;
+        }
+
+        _samples.emplace_back(hw_time - _hw_origin, host_time - _host_origin);
+        if (_samples.size() > CLOCK_MODEL_WINDOW) _samples.pop_front();
+        fit();
+    }
+
+    double device_clock_model::to_host(double hw_time) const
+    {
+        return _host_origin + _offset + _slope * (hw_time - _hw_origin);
+    }
+
+    void device_clock_model::fit()
+    {
+        auto n = static_cast<double>(_samples.size());
+        double mx = 0, my = 0;
+        for (auto&& s : _samples)
+        {
+            mx += s.first;
+            my += s.second;
+        }
+        mx /= n;
+        my /= n;
+
+        double sxx = 0, sxy = 0;
+        for (auto&& s : _samples)
+        {
+            sxx += (s.first - mx) * (s.first - mx);
+            sxy += (s.first - mx) * (s.second - my);
+        }
+
+        // The host timestamps carry the transfer jitter, so the drift is only trusted over a long window
+        auto span = _samples.back().first - _samples.front().first;
+        _slope = (span >= CLOCK_MODEL_MIN_SPAN_MS && sxx > 0) ? sxy / sxx : 1.;
+        _offset = my - _slope * mx;
+
+        double sse = 0;
+        for (auto&& s : _samples)
+        {
+            auto residual = s.second - (_offset + _slope * s.first);
+            sse += residual * residual;
+        }
+        _jitter = std::sqrt(sse / n);
+    }
+
+    double shared_clock_model::add_and_map(double hw_time, double host_time)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _model.add_sample(hw_time, host_time);
+        return _model.to_host(hw_time);
+    }
+
+    double shared_clock_model::get_drift() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _model.get_drift();
+    }
+
+    double shared_clock_model::get_jitter() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _model.get_jitter();
+    }
+}
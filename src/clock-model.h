@@ -0,0 +1,74 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2015 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <mutex>
+
+#include "option.h"
+
+namespace librealsense
+{
+    // Maps the hardware timestamps of one device onto the host clock, by a least-squares line fitted to the
+    // (hardware timestamp, system time) pairs of its recent frames
+    class device_clock_model
+    {
+    public:
+        void add_sample(double hw_time, double host_time);
+        double to_host(double hw_time) const;
+        bool empty() const { return _samples.empty(); }
+
+        // Rate of the device clock relative to the host clock, in parts per million
+        double get_drift() const { return (_slope - 1.) * 1e6; }
+        // Standard deviation of the host timestamps around the fitted line, in milliseconds
+        double get_jitter() const { return _jitter; }
+
+    private:
+        void fit();
+
+        std::deque<std::pair<double, double>> _samples; // Relative to the first sample of the window
+        double _hw_origin = 0;
+        double _host_origin = 0;
+        double _slope = 1;
+        double _offset = 0;
+        double _jitter = 0;
+    };
+
+    // The clock model of a device, fed by the frames of all its sensors
+    class shared_clock_model
+    {
+    public:
+        // Adds the sample and returns the hardware timestamp on the host clock
+        double add_and_map(double hw_time, double host_time);
+
+        double get_drift() const;
+        double get_jitter() const;
+
+    private:
+        mutable std::mutex _mutex;
+        device_clock_model _model;
+    };
+
+    class clock_estimate_option : public readonly_option
+    {
+    public:
+        clock_estimate_option(std::shared_ptr<shared_clock_model> model, bool drift)
+            : _model(model), _drift(drift) {}
+
+        float query() const override { return static_cast<float>(_drift ? _model->get_drift() : _model->get_jitter()); }
+        option_range get_range() const override { return { -1e6f, 1e6f, 0, 0 }; }
+        bool is_enabled() const override { return true; }
+
+        const char* get_description() const override
+        {
+            return _drift ? "Drift of the device clock from the host clock in parts per million"
+                          : "Jitter of the frame arrival times around the device clock model in milliseconds";
+        }
+
+    private:
+        std::shared_ptr<shared_clock_model> _model;
+        bool _drift;
+    };
+}
@@ -7,7 +7,13 @@
 #include <condition_variable>
 #include <thread>
 #include <atomic>
+#include <cstddef>
 #include <functional>
+#include <type_traits>
+#include <memory>
+#include <vector>
+#include <string>
+#include "threading.h"
 
 const int QUEUE_MAX_SIZE = 10;
 // Simplest implementation of a blocking concurrent queue for thread messaging
@@ -122,6 +128,293 @@ public:
 };
 
 
+const int QUEUE_SPIN_COUNT = 64; // Polls of an empty queue before the consumer goes to sleep
+
+// Bounded lock-free counterpart of single_consumer_queue for the streaming hot paths
+// Items are kept in a ring of sequenced cells (Dmitry Vyukov's bounded MPMC queue), so producers
+// and the consumer never take a lock. Like single_consumer_queue, the oldest item is dropped when
+// the queue is full. An empty queue is polled a few times before the consumer parks on a condition
+// variable, and producers only touch the mutex when the consumer is actually parked
+// Unlike single_consumer_queue there is no peek, since producers may pop the front item at any time
+template<class T>
+class lock_free_queue
+{
+    struct cell
+    {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    std::unique_ptr<cell[]> cells;
+    size_t mask;
+    unsigned int cap;
+
+    // Producer and consumer positions are padded apart so they do not share a cache line
+    char pad0[64];
+    std::atomic<size_t> enqueue_pos;
+    char pad1[64];
+    std::atomic<size_t> dequeue_pos;
+    char pad2[64];
+
+    std::atomic<bool> accepting;
+    // flush mechanism is required to abort the wait when need to stop
+    std::atomic<bool> need_to_flush;
+    std::atomic<int> sleepers;
+    std::atomic<unsigned long long> dropped; // items overwritten by enqueue while the queue was full
+    std::mutex mutex;
+    std::condition_variable cv; // not empty signal
+
+    static size_t cells_count(unsigned int cap)
+    {
+        size_t count = 2;
+        while (count < cap) count <<= 1;
+        return count;
+    }
+
+    bool try_push(T& item)
+    {
+        auto pos = enqueue_pos.load(std::memory_order_relaxed);
+        while (true)
+        {
+            auto& c = cells[pos & mask];
+            auto seq = c.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq - pos);
+            if (diff == 0)
+            {
+                if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    c.data = std::move(item);
+                    c.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0) return false; // full
+            else pos = enqueue_pos.load(std::memory_order_relaxed);
+        }
+    }
+
+    bool try_pop(T& item)
+    {
+        auto pos = dequeue_pos.load(std::memory_order_relaxed);
+        while (true)
+        {
+            auto& c = cells[pos & mask];
+            auto seq = c.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq - (pos + 1));
+            if (diff == 0)
+            {
+                if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    item = std::move(c.data);
+                    c.data = T(); // release whatever the moved-from item still holds
+                    c.sequence.store(pos + mask + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0) return false; // empty
+            else pos = dequeue_pos.load(std::memory_order_relaxed);
+        }
+    }
+
+    // Returns false when the front cell is still being written by a producer
+    bool drop_oldest()
+    {
+        T dropped;
+        return try_pop(dropped);
+    }
+
+    void wake()
+    {
+        // Pairs with the fence in dequeue, so either the consumer sees the new item or we see the sleeper
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleepers.load(std::memory_order_relaxed))
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            cv.notify_one();
+        }
+    }
+
+public:
+    explicit lock_free_queue(unsigned int cap = QUEUE_MAX_SIZE)
+        : cells(new cell[cells_count(cap)]), mask(cells_count(cap) - 1), cap(cap),
+          enqueue_pos(0), dequeue_pos(0), accepting(true), need_to_flush(false), sleepers(0), dropped(0)
+    {
+        for (size_t i = 0; i <= mask; i++)
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    lock_free_queue(const lock_free_queue&) = delete;
+    lock_free_queue& operator=(const lock_free_queue&) = delete;
+
+    void enqueue(T&& item)
+    {
+        if (accepting)
+        {
+            while (size() >= cap && drop_oldest()) ++dropped;
+            while (!try_push(item)) if (drop_oldest()) ++dropped;
+        }
+        wake();
+    }
+
+    bool dequeue(T* item, unsigned int timeout_ms = 5000)
+    {
+        accepting = true;
+        for (auto i = 0; i < QUEUE_SPIN_COUNT; i++)
+        {
+            if (try_pop(*item)) return true;
+            if (need_to_flush) return false;
+            std::this_thread::yield();
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        ++sleepers;
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        bool ready = false;
+        cv.wait_for(lock, std::chrono::milliseconds(timeout_ms), [&]()
+        {
+            ready = try_pop(*item);
+            return ready || need_to_flush;
+        });
+        --sleepers;
+        return ready;
+    }
+
+    bool try_dequeue(T* item)
+    {
+        accepting = true;
+        return try_pop(*item);
+    }
+
+    void clear()
+    {
+        accepting = false;
+        need_to_flush = true;
+
+        while (size() > 0 && drop_oldest());
+
+        std::lock_guard<std::mutex> lock(mutex);
+        cv.notify_all();
+    }
+
+    void start()
+    {
+        need_to_flush = false;
+        accepting = true;
+    }
+
+    size_t size()
+    {
+        auto tail = dequeue_pos.load();
+        auto head = enqueue_pos.load();
+        return head > tail ? head - tail : 0;
+    }
+
+    unsigned long long get_dropped_count() const { return dropped; }
+};
+
+
+// Move-only counterpart of std::function that keeps callables of up to Capacity bytes in place, so
+// queueing them does not allocate. Larger callables, or ones that may throw when moved, go to the heap
+template<class Signature, size_t Capacity>
+class small_task;
+
+template<class R, class... Args, size_t Capacity>
+class small_task<R(Args...), Capacity>
+{
+    typedef typename std::aligned_storage<Capacity, alignof(std::max_align_t)>::type storage;
+
+    struct operations
+    {
+        R(*invoke)(void* target, Args&&... args);
+        void(*move)(void* from, void* to);
+        void(*destroy)(void* target);
+    };
+
+    template<class F>
+    struct inline_operations
+    {
+        static R invoke(void* target, Args&&... args) { return (*static_cast<F*>(target))(std::forward<Args>(args)...); }
+        static void move(void* from, void* to) { new (to) F(std::move(*static_cast<F*>(from))); destroy(from); }
+        static void destroy(void* target) { static_cast<F*>(target)->~F(); }
+    };
+
+    template<class F>
+    struct heap_operations
+    {
+        static F*& get(void* target) { return *static_cast<F**>(target); }
+        static R invoke(void* target, Args&&... args) { return (*get(target))(std::forward<Args>(args)...); }
+        static void move(void* from, void* to) { new (to) F*(get(from)); }
+        static void destroy(void* target) { delete get(target); }
+    };
+
+    template<class F>
+    struct fits_inline : std::integral_constant<bool,
+        sizeof(F) <= Capacity && alignof(F) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible<F>::value> {};
+
+    template<class F>
+    void emplace(F&& f, std::true_type)
+    {
+        typedef typename std::decay<F>::type callable;
+        new (&_storage) callable(std::forward<F>(f));
+        static const operations ops = { &inline_operations<callable>::invoke, &inline_operations<callable>::move, &inline_operations<callable>::destroy };
+        _ops = &ops;
+    }
+
+    template<class F>
+    void emplace(F&& f, std::false_type)
+    {
+        typedef typename std::decay<F>::type callable;
+        new (&_storage) callable*(new callable(std::forward<F>(f)));
+        static const operations ops = { &heap_operations<callable>::invoke, &heap_operations<callable>::move, &heap_operations<callable>::destroy };
+        _ops = &ops;
+    }
+
+    storage _storage;
+    const operations* _ops;
+
+public:
+    small_task() : _ops(nullptr) {}
+
+    template<class F, class = typename std::enable_if<!std::is_same<typename std::decay<F>::type, small_task>::value>::type>
+    small_task(F&& f) : _ops(nullptr)
+    {
+        emplace(std::forward<F>(f), fits_inline<typename std::decay<F>::type>());
+    }
+
+    small_task(small_task&& other) : _ops(other._ops)
+    {
+        if (_ops) _ops->move(&other._storage, &_storage);
+        other._ops = nullptr;
+    }
+
+    small_task& operator=(small_task&& other)
+    {
+        if (this != &other)
+        {
+            reset();
+            _ops = other._ops;
+            if (_ops) _ops->move(&other._storage, &_storage);
+            other._ops = nullptr;
+        }
+        return *this;
+    }
+
+    small_task(const small_task&) = delete;
+    small_task& operator=(const small_task&) = delete;
+
+    ~small_task() { reset(); }
+
+    void reset()
+    {
+        if (_ops) _ops->destroy(&_storage);
+        _ops = nullptr;
+    }
+
+    explicit operator bool() const { return _ops != nullptr; }
+
+    R operator()(Args... args) { return _ops->invoke(&_storage, std::forward<Args>(args)...); }
+};
+
 class dispatcher
 {
 public:
@@ -145,17 +438,22 @@ public:
         dispatcher* _owner;
     };
 
-    dispatcher(unsigned int cap)
+    // Room for the captures of the per-frame tasks of the recorder and the playback, a frame and a few pointers
+    static const size_t task_capacity = 12 * sizeof(void*);
+    typedef small_task<void(cancellable_timer), task_capacity> task;
+
+    dispatcher(unsigned int cap, std::string name = "rs-dispatcher", rs2_thread_class thread_class = RS2_THREAD_CLASS_PROCESSING)
         : _queue(cap),
           _was_stopped(true),
           _was_flushed(false),
           _is_alive(true)
     {
-        _thread = std::thread([&]()
+        _thread = std::thread([this, name, thread_class]()
         {
+            librealsense::thread_registration registration(name.c_str(), thread_class);
             while (_is_alive)
             {
-                std::function<void(cancellable_timer)> item;
+                task item;
 
                 if (_queue.dequeue(&item))
                 {
@@ -176,7 +474,7 @@ public:
     {
         if (!_was_stopped)
         {
-            _queue.enqueue(std::move(item));
+            _queue.enqueue(task(std::move(item)));
         }
     }
 
@@ -239,9 +537,12 @@ public:
         *wait_sucess = cv.wait_for(locker, std::chrono::seconds(10), [&]() { return invoked || _was_stopped; });
         return *wait_sucess;
     }
+
+    size_t size() { return _queue.size(); }
+    unsigned long long get_dropped_count() const { return _queue.get_dropped_count(); }
 private:
     friend cancellable_timer;
-    single_consumer_queue<std::function<void(cancellable_timer)>> _queue;
+    lock_free_queue<task> _queue;
     std::thread _thread;
 
     std::atomic<bool> _was_stopped;
@@ -259,8 +560,8 @@ template<class T = std::function<void(dispatcher::cancellable_timer)>>
 class active_object
 {
 public:
-    active_object(T operation)
-        : _operation(std::move(operation)), _dispatcher(1), _stopped(true)
+    active_object(T operation, std::string name = "rs-watcher", rs2_thread_class thread_class = RS2_THREAD_CLASS_IO)
+        : _operation(std::move(operation)), _dispatcher(1, std::move(name), thread_class), _stopped(true)
     {
     }
 
@@ -299,3 +600,164 @@ private:
     dispatcher _dispatcher;
     std::atomic<bool> _stopped;
 };
+
+// Fixed set of worker threads sharing the tasks of parallel jobs
+// The thread submitting a job processes tasks of its own job as well, so a job always completes
+// even when all workers are busy with jobs submitted concurrently from other threads
+// Single tasks may also be posted to run asynchronously on the workers
+// Jobs take the priority of the thread submitting them, and the workers pick the pending job of the highest priority
+class worker_pool
+{
+public:
+    // Sets the priority of the jobs submitted by the calling thread while the object lives
+    class priority_scope
+    {
+    public:
+        explicit priority_scope(int priority) : _previous(current_priority()) { current_priority() = priority; }
+        ~priority_scope() { current_priority() = _previous; }
+
+        priority_scope(const priority_scope&) = delete;
+        priority_scope& operator=(const priority_scope&) = delete;
+
+    private:
+        int _previous;
+    };
+
+    explicit worker_pool(unsigned int threads, const char* name = "rs-worker", rs2_thread_class thread_class = RS2_THREAD_CLASS_PROCESSING)
+        : _alive(true)
+    {
+        for (unsigned int i = 0; i < threads; i++)
+            _threads.push_back(std::thread([this, name, thread_class]()
+            {
+                librealsense::thread_registration registration(name, thread_class);
+                work();
+            }));
+    }
+
+    // Invoke task(0) ... task(count - 1) in parallel and return once all of them are done
+    void run(int count, std::function<void(int)> task)
+    {
+        auto j = std::make_shared<job>(std::move(task), count, current_priority());
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _jobs.push_back(j);
+        }
+        _cv.notify_all();
+
+        while (execute(*j));
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        remove(j);
+        _done_cv.wait(lock, [&]() { return j->done == j->count; });
+    }
+
+    // Invoke task once on one of the workers, without waiting for it
+    // Tasks still pending when the pool is destroyed are completed first
+    void post(std::function<void()> task)
+    {
+        auto j = std::make_shared<job>([task](int) { task(); }, 1, current_priority());
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _jobs.push_back(j);
+        }
+        _cv.notify_one();
+    }
+
+    size_t size() const { return _threads.size(); }
+
+    ~worker_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _alive = false;
+        }
+        _cv.notify_all();
+        for (auto&& t : _threads) t.join();
+    }
+
+    worker_pool(const worker_pool&) = delete;
+    worker_pool& operator=(const worker_pool&) = delete;
+
+private:
+    struct job
+    {
+        job(std::function<void(int)> task, int count, int priority)
+            : task(std::move(task)), count(count), priority(priority), next(0), done(0)
+        {}
+
+        std::function<void(int)> task;
+        const int count;
+        const int priority;
+        std::atomic<int> next;
+        std::atomic<int> done;
+    };
+
+    // Run the next pending task of the job, returns false once all of them were claimed
+    bool execute(job& j)
+    {
+        auto i = j.next++;
+        if (i >= j.count) return false;
+
+        j.task(i);
+        if (++j.done == j.count)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _done_cv.notify_all();
+        }
+        return true;
+    }
+
+    static int& current_priority()
+    {
+        static thread_local int priority = 0;
+        return priority;
+    }
+
+    // The first submitted of the jobs of the highest priority
+    std::shared_ptr<job> next_job() const
+    {
+        auto best = _jobs.front();
+        for (auto&& j : _jobs)
+            if (j->priority > best->priority) best = j;
+        return best;
+    }
+
+    void remove(const std::shared_ptr<job>& j)
+    {
+        for (auto it = _jobs.begin(); it != _jobs.end(); ++it)
+        {
+            if (*it == j)
+            {
+                _jobs.erase(it);
+                return;
+            }
+        }
+    }
+
+    void work()
+    {
+        while (true)
+        {
+            std::shared_ptr<job> j;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _cv.wait(lock, [this]() { return !_alive || !_jobs.empty(); });
+                if (_jobs.empty()) return;
+                j = next_job();
+            }
+
+            if (!execute(*j))
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                remove(j);
+            }
+        }
+    }
+
+    std::mutex _mutex;
+    std::condition_variable _cv;      // a job was submitted
+    std::condition_variable _done_cv; // a job completed
+    std::deque<std::shared_ptr<job>> _jobs;
+    std::vector<std::thread> _threads;
+    bool _alive;
+};
@@ -240,6 +240,15 @@ namespace librealsense
                 {
                     return _dev_to_profiles;
                 }
+
+                // The sensor streaming the profile of the given unique id, null when the profile is not part of the set
+                sensor_interface* get_sensor(int stream_id) const
+                {
+                    for (auto&& kvp : _dev_to_profiles)
+                        for (auto&& p : kvp.second)
+                            if (p->get_unique_id() == stream_id) return _results.at(kvp.first);
+                    return nullptr;
+                }
             private:
                 friend class config;
 
@@ -338,10 +347,85 @@ namespace librealsense
                return false;
            }
 
-            multistream resolve(device_interface* dev)
+            // A resolved configuration, as pairs of sensor index and position in the stream profiles of the sensor
+            using selection = std::vector<std::pair<int, size_t>>;
+
+            // A non empty selection is used instead of searching the profiles of the device,
+            // an empty one is filled with the result of the search
+            multistream resolve(device_interface* dev, selection* memo = nullptr)
+            {
+                std::multimap<int, std::shared_ptr<stream_profile_interface>> mapping;
+                if (memo && is_valid_selection(dev, *memo))
+                {
+                    for (auto&& s : *memo)
+                        mapping.emplace(s.first, dev->get_sensor(s.first).get_stream_profiles()[s.second]);
+                }
+                else
+                {
+                    mapping = map_streams(dev);
+                    validate_mapping(mapping);
+                    if (memo)
+                        *memo = to_selection(dev, mapping);
+                }
+
+                // Unpack the data returned by assign
+                std::map<int, stream_profiles> dev_to_profiles;
+                std::map<index_type, sensor_interface*> stream_to_dev;
+                std::map<index_type, std::shared_ptr<stream_profile_interface>> stream_to_profile;
+
+                std::map<int, sensor_interface*> sensors_map;
+                for(auto i = 0; i< dev->get_sensors_count(); i++)
+                {
+                    if (mapping.find(i) != mapping.end())
+                    {
+                        sensors_map[i] = &dev->get_sensor(i);
+                    }
+                }
+
+                for (auto && kvp : mapping) {
+                    dev_to_profiles[kvp.first].push_back(kvp.second);
+                    index_type idx{ kvp.second->get_stream_type(), kvp.second->get_stream_index() };
+                    stream_to_dev.emplace(idx, sensors_map.at(kvp.first));
+                    stream_to_profile[idx] = kvp.second;
+                }
+
+                // TODO: make sure it works
+                return multistream(std::move(sensors_map), std::move(stream_to_profile), std::move(dev_to_profiles));
+            }
+
+            static bool is_valid_selection(device_interface* dev, const selection& memo)
             {
-                 auto mapping = map_streams(dev);
+                if (memo.empty())
+                    return false;
+
+                for (auto&& s : memo)
+                {
+                    if (s.first < 0 || s.first >= static_cast<int>(dev->get_sensors_count()) ||
+                        s.second >= dev->get_sensor(s.first).get_stream_profiles().size())
+                        return false;
+                }
+                return true;
+            }
+
+        private:
 
+            static selection to_selection(device_interface* dev,
+                                          const std::multimap<int, std::shared_ptr<stream_profile_interface>>& mapping)
+            {
+                selection result;
+                for (auto&& kvp : mapping)
+                {
+                    auto profiles = dev->get_sensor(kvp.first).get_stream_profiles();
+                    auto it = std::find(profiles.begin(), profiles.end(), kvp.second);
+                    if (it == profiles.end())
+                        return {};
+                    result.emplace_back(kvp.first, std::distance(profiles.begin(), it));
+                }
+                return result;
+            }
+
+            void validate_mapping(const std::multimap<int, std::shared_ptr<stream_profile_interface>>& mapping) const
+            {
                 // If required, make sure we've succeeded at opening
                 // all the requested streams
                 if (require_all)
@@ -370,33 +454,8 @@ namespace librealsense
                             throw std::runtime_error("Config couldn't configure all streams");
                     }
                 }
-
-                // Unpack the data returned by assign
-                std::map<int, stream_profiles> dev_to_profiles;
-                std::map<index_type, sensor_interface*> stream_to_dev;
-                std::map<index_type, std::shared_ptr<stream_profile_interface>> stream_to_profile;
-
-                std::map<int, sensor_interface*> sensors_map;
-                for(auto i = 0; i< dev->get_sensors_count(); i++)
-                {
-                    if (mapping.find(i) != mapping.end())
-                    {
-                        sensors_map[i] = &dev->get_sensor(i);
-                    }
-                }
-
-                for (auto && kvp : mapping) {
-                    dev_to_profiles[kvp.first].push_back(kvp.second);
-                    index_type idx{ kvp.second->get_stream_type(), kvp.second->get_stream_index() };
-                    stream_to_dev.emplace(idx, sensors_map.at(kvp.first));
-                    stream_to_profile[idx] = kvp.second;
-                }
-
-                // TODO: make sure it works
-                return multistream(std::move(sensors_map), std::move(stream_to_profile), std::move(dev_to_profiles));
             }
 
-        private:
             static bool sort_highest_framerate(const std::shared_ptr<stream_profile_interface> lhs, const std::shared_ptr<stream_profile_interface> rhs) {
                 return lhs->get_framerate() < rhs->get_framerate();
             }
@@ -421,20 +480,132 @@ namespace librealsense
                 return sort_highest_framerate(lhs, rhs);
             }
 
-            static void auto_complete(std::vector<request_type> &requests, sensor_interface &target)
+            // The fields of a profile, read once per resolve so that matching and sorting compare plain values
+            // instead of going through virtual calls and casts of the profile for every comparison
+            struct profile_key
+            {
+                request_type fields;
+                bool video;
+            };
+
+            // The profiles of a sensor with their keys, and the positions of the profiles of each stream type
+            struct sensor_profiles
+            {
+                explicit sensor_profiles(sensor_interface& sensor)
+                    : profiles(sensor.get_stream_profiles())
+                {
+                    keys.reserve(profiles.size());
+                    for (size_t i = 0; i < profiles.size(); i++)
+                    {
+                        auto p = profiles[i].get();
+                        keys.push_back({ to_request(p), dynamic_cast<video_stream_profile_interface*>(p) != nullptr });
+                        auto stream = keys.back().fields.stream;
+                        if (stream >= 0 && stream < RS2_STREAM_COUNT)
+                            by_stream[stream].push_back(i);
+                    }
+                }
+
+                // Whether the predicate holds for the position of a profile that can be of the stream type of the request
+                // The profiles of a type are tried in their order on the sensor
+                template<class T>
+                bool any_of(const request_type& request, T predicate) const
+                {
+                    if (request.stream > RS2_STREAM_ANY && request.stream < RS2_STREAM_COUNT)
+                    {
+                        // Profiles of any stream type match requests of all types
+                        for (auto i : by_stream[request.stream]) if (predicate(i)) return true;
+                        for (auto i : by_stream[RS2_STREAM_ANY]) if (predicate(i)) return true;
+                        return false;
+                    }
+                    for (size_t i = 0; i < keys.size(); i++) if (predicate(i)) return true;
+                    return false;
+                }
+
+                stream_profiles profiles;
+                std::vector<profile_key> keys;
+                std::vector<size_t> by_stream[RS2_STREAM_COUNT];
+            };
+
+            static bool match(const profile_key& a, const request_type& b)
+            {
+                if (a.fields.stream != RS2_STREAM_ANY && b.stream != RS2_STREAM_ANY && (a.fields.stream != b.stream))
+                    return false;
+                if (a.fields.stream_index != -1 && b.stream_index != -1 && (a.fields.stream_index != b.stream_index))
+                    return false;
+                if (a.fields.format != RS2_FORMAT_ANY && b.format != RS2_FORMAT_ANY && (a.fields.format != b.format))
+                    return false;
+                if (a.fields.fps != 0 && b.fps != 0 && (a.fields.fps != b.fps))
+                    return false;
+
+                if (a.video)
+                {
+                    if (a.fields.width != 0 && b.width != 0 && (a.fields.width != b.width))
+                        return false;
+                    if (a.fields.height != 0 && b.height != 0 && (a.fields.height != b.height))
+                        return false;
+                }
+
+                return true;
+            }
+
+            static bool contradicts(const profile_key& a, const std::vector<request_type>& others)
+            {
+                for (auto&& request : others)
+                {
+                    if (a.fields.fps != 0 && request.fps != 0 && (a.fields.fps != request.fps))
+                        return true;
+                }
+
+                if (a.video)
+                {
+                    for (auto&& request : others)
+                    {
+                        // Patch for DS5U_S that allows different resolutions on multi-pin device
+                        if ((a.fields.height == a.fields.width) && (request.height == request.width))
+                            return false;
+                        if (a.fields.width != 0 && request.width != 0 && (a.fields.width != request.width))
+                            return true;
+                        if (a.fields.height != 0 && request.height != 0 && (a.fields.height != request.height))
+                            return true;
+                    }
+                }
+
+                return false;
+            }
+
+            static bool sort_highest_framerate(const profile_key& lhs, const profile_key& rhs) {
+                return lhs.fields.fps < rhs.fields.fps;
+            }
+
+            static bool sort_largest_image(const profile_key& lhs, const profile_key& rhs) {
+                if (lhs.video && rhs.video)
+                    return lhs.fields.width*lhs.fields.height < rhs.fields.width*rhs.fields.height;
+                return sort_highest_framerate(lhs, rhs);
+            }
+
+            static bool sort_best_quality(const profile_key& lhs, const profile_key& rhs) {
+                if (lhs.video && rhs.video)
+                {
+                    auto&& a = lhs.fields;
+                    auto&& b = rhs.fields;
+                    return std::make_tuple((a.height == 640 && a.height == 480), (a.fps == 30), (a.format == RS2_FORMAT_Z16), (a.format == RS2_FORMAT_Y8), (a.format == RS2_FORMAT_RGB8), int(a.format))
+                         < std::make_tuple((b.width == 640 && b.height == 480), (b.fps == 30), (b.format == RS2_FORMAT_Z16), (b.format == RS2_FORMAT_Y8), (b.format == RS2_FORMAT_RGB8), int(b.format));
+                }
+                return sort_highest_framerate(lhs, rhs);
+            }
+
+            static void auto_complete(std::vector<request_type> &requests, const sensor_profiles& candidates, sensor_interface &target)
             {
-                auto candidates = target.get_stream_profiles();
                 for (auto & request : requests)
                 {
                     if (!has_wildcards(request)) continue;
-                    for (auto candidate : candidates)
+                    candidates.any_of(request, [&](size_t i)
                     {
-                        if (match(candidate.get(), request) && !contradicts(candidate.get(), requests))
-                        {
-                            request = to_request(candidate.get());
-                            break;
-                        }
-                    }
+                        if (!match(candidates.keys[i], request) || contradicts(candidates.keys[i], requests))
+                            return false;
+                        request = candidates.keys[i].fields;
+                        return true;
+                    });
                     if (has_wildcards(request))
                         throw std::runtime_error(std::string("Couldn't autocomplete request for subdevice ") + target.get_info(RS2_CAMERA_INFO_NAME));
                 }
@@ -471,7 +642,12 @@ namespace librealsense
                 {
                     auto&& sub = dev->get_sensor(i);
                     std::vector<request_type> targets;
-                    auto profiles = sub.get_stream_profiles();
+                    sensor_profiles table(sub);
+                    auto&& keys = table.keys;
+
+                    // Presets reorder the profiles, the order being kept for the ones that follow and for the final match
+                    std::vector<size_t> order(keys.size());
+                    for (size_t j = 0; j < order.size(); j++) order[j] = j;
 
                     // deal with explicit requests
                     for (auto && kvp : _requests)
@@ -479,12 +655,7 @@ namespace librealsense
                         if (satisfied_streams.count(kvp.first)) continue; // skip satisfied requests
 
                         // if any profile on the subdevice can supply this request, consider it satisfiable
-                        auto it = std::find_if(begin(profiles), end(profiles),
-                            [&kvp](const std::shared_ptr<stream_profile_interface>& profile)
-                        {
-                            return match(profile.get(), kvp.second);
-                        });
-                        if (it != end(profiles))
+                        if (table.any_of(kvp.second, [&](size_t j) { return match(keys[j], kvp.second); }))
                         {
                             targets.push_back(kvp.second); // store that this request is going to this subdevice
                             satisfied_streams.insert(kvp.first); // mark stream as satisfied
@@ -499,26 +670,22 @@ namespace librealsense
 
                         auto result = [&]() -> request_type
                         {
+                            bool (*compare)(const profile_key&, const profile_key&) = nullptr;
                             switch (kvp.second)
                             {
-                            case config_preset::best_quality:
-                                std::sort(begin(profiles), end(profiles), sort_best_quality);
-                                break;
-                            case config_preset::largest_image:
-                                std::sort(begin(profiles), end(profiles), sort_largest_image);
-                                break;
-                            case config_preset::highest_framerate:
-                                std::sort(begin(profiles), end(profiles), sort_highest_framerate);
-                                break;
+                            case config_preset::best_quality: compare = sort_best_quality; break;
+                            case config_preset::largest_image: compare = sort_largest_image; break;
+                            case config_preset::highest_framerate: compare = sort_highest_framerate; break;
                             default: throw std::runtime_error("Unknown preset selected");
                             }
+                            std::sort(begin(order), end(order), [&](size_t a, size_t b) { return compare(keys[a], keys[b]); });
 
-                            for (auto itr: profiles)
+                            for (auto j : order)
                             {
-                                auto stream = index_type{ itr->get_stream_type() ,itr->get_stream_index() };
+                                auto stream = index_type{ keys[j].fields.stream, keys[j].fields.stream_index };
                                 if (match_stream(stream, kvp.first))
                                 {
-                                    return to_request(itr.get());
+                                    return keys[j].fields;
                                 }
                             }
 
@@ -535,15 +702,15 @@ namespace librealsense
 
                     if (targets.size() > 0) // if subdevice is handling any streams
                     {
-                        auto_complete(targets, sub);
+                        auto_complete(targets, table, sub);
 
                         for (auto && t : targets)
                         {
-                            for (auto && p : profiles)
+                            for (auto j : order)
                             {
-                                if (match(p.get(), t))
+                                if (match(keys[j], t))
                                 {
-                                    out.emplace((int)i, p);
+                                    out.emplace((int)i, table.profiles[j]);
                                     break;
                                 }
                             }
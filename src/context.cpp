@@ -8,16 +8,23 @@
 
 #include <array>
 #include <chrono>
+#ifndef RS2_PROCESSING_ONLY
 #include "ivcam/sr300.h"
 #include "ds5/ds5-factory.h"
 #include "ds5/ds5-timestamp.h"
+#endif
 #include "backend.h"
 #include "mock/recorder.h"
 #include <media/ros/ros_reader.h>
+#include <media/playback/segmented_reader.h>
+#include <media/network/network_reader.h>
+#include <media/native/native_reader.h>
 #include "types.h"
 #include "stream.h"
 #include "environment.h"
 #include "context.h"
+#include "shared-device.h"
+#include "software-device.h"
 
 template<unsigned... Is> struct seq{};
 template<unsigned N, unsigned... Is>
@@ -74,7 +81,8 @@ namespace librealsense
     context::context(backend_type type,
                      const char* filename,
                      const char* section,
-                     rs2_recording_mode mode)
+                     rs2_recording_mode mode,
+                     bool cache_frames)
         : _devices_changed_callback(nullptr, [](rs2_devices_changed_callback*){})
     {
         LOG_DEBUG("Librealsense " << std::string(std::begin(rs2_api_version),std::end(rs2_api_version)));
@@ -82,15 +90,22 @@ namespace librealsense
         switch(type)
         {
         case backend_type::standard:
-            _backend = platform::create_backend();
-            break;
+            // Created by get_backend, all the platform backends keep the time of the OS
+            environment::get_instance().set_time_service(std::make_shared<platform::os_time_service>());
+            return;
+#ifndef RS2_PROCESSING_ONLY
         case backend_type::record:
             _backend = std::make_shared<platform::record_backend>(platform::create_backend(), filename, section, mode);
             break;
         case backend_type::playback:
-            _backend = std::make_shared<platform::playback_backend>(filename, section);
+            _backend = std::make_shared<platform::playback_backend>(filename, section, cache_frames);
 
             break;
+#else
+        case backend_type::record:
+        case backend_type::playback:
+            throw not_implemented_exception("realsense2-proc does not record nor play back backend calls");
+#endif
         default: throw invalid_value_exception(to_string() << "Undefined backend type " << static_cast<int>(type));
         }
 
@@ -99,7 +114,31 @@ namespace librealsense
        _device_watcher = _backend->create_device_watcher();
     }
 
+    const platform::backend& context::get_backend() const
+    {
+        std::call_once(_backend_once, [this]()
+        {
+            if (_backend) return;
+            _backend = platform::create_backend();
+            _device_watcher = _backend->create_device_watcher();
+        });
+        return *_backend;
+    }
+
+    void context::set_time_source(rs2_time_source source)
+    {
+#ifndef RS2_PROCESSING_ONLY
+        if (std::dynamic_pointer_cast<platform::playback_backend>(_backend))
+            throw wrong_api_call_sequence_exception("Playback contexts keep the time of their recording");
+#endif
+
+        if (source == RS2_TIME_SOURCE_MONOTONIC)
+            environment::get_instance().set_time_service(std::make_shared<platform::monotonic_time_service>());
+        else
+            environment::get_instance().set_time_service(get_backend().create_time_service());
+    }
 
+#ifndef RS2_PROCESSING_ONLY
     class recovery_info : public device_info
     {
     public:
@@ -235,6 +274,7 @@ namespace librealsense
 
             color_ep->register_pixel_format(pf_yuy2);
             color_ep->register_pixel_format(pf_yuyv);
+            color_ep->register_pixel_format(pf_mjpg);
 
             color_ep->try_register_pu(RS2_OPTION_BACKLIGHT_COMPENSATION);
             color_ep->try_register_pu(RS2_OPTION_BRIGHTNESS);
@@ -261,18 +301,56 @@ namespace librealsense
         auto&& backend = ctx->get_backend();
         return std::make_shared<platform_camera>(ctx, _uvcs, this->get_device_data(), register_device_notifications);
     }
+#endif
 
     context::~context()
     {
-        _device_watcher->stop(); //ensure that the device watcher will stop before the _devices_changed_callback will be deleted
+        if (_device_watcher) _device_watcher->stop(); //ensure that the device watcher will stop before the _devices_changed_callback will be deleted
     }
 
-    std::vector<std::shared_ptr<device_info>> context::query_devices() const
+    std::vector<std::shared_ptr<device_info>> context::query_devices(bool lightweight) const
     {
+        std::vector<std::shared_ptr<device_info>> list;
+        {
+            auto&& backend = get_backend();
+            std::lock_guard<std::mutex> lock(_devices_cache_mutex);
+            if (_devices_cache_valid)
+            {
+                list = _cached_devices;
+            }
+            else if (lightweight)
+            {
+                platform::backend_device_group devices(backend.query_uvc_devices(), {}, {});
+                list = create_devices(devices, {});
+            }
+            else
+            {
+                platform::backend_device_group devices(backend.query_uvc_devices(), backend.query_usb_devices(), backend.query_hid_devices());
+                list = create_devices(devices, {});
+                //The watcher keeps the list up to date from now on
+                _cached_devices = list;
+                _devices_cache_valid = _watching_devices;
+            }
+        }
 
-        platform::backend_device_group devices(_backend->query_uvc_devices(), _backend->query_usb_devices(), _backend->query_hid_devices());
+        for (auto&& item : _playback_devices)
+        {
+            list.push_back(item.second);
+        }
+
+        //Devices published by other processes come and go without device events, they are never cached
+        auto ctx = const_cast<context*>(this)->shared_from_this();
+        auto shared_devices = shared_device_info::pick_shared_devices(ctx);
+        std::copy(begin(shared_devices), end(shared_devices), std::back_inserter(list));
+        return list;
+    }
 
-        return create_devices(devices, _playback_devices);
+    void context::update_devices_cache(const platform::backend_device_group& devices)
+    {
+        auto list = create_devices(devices, {});
+        std::lock_guard<std::mutex> lock(_devices_cache_mutex);
+        _cached_devices = std::move(list);
+        _devices_cache_valid = _watching_devices;
     }
 
     std::vector<std::shared_ptr<device_info>> context::create_devices(platform::backend_device_group devices,
@@ -284,6 +362,7 @@ namespace librealsense
         // to allow them to modify context later on
         auto ctx = t->shared_from_this();
 
+#ifndef RS2_PROCESSING_ONLY
         auto ds5_devices = ds5_info::pick_ds5_devices(ctx, devices);
         std::copy(begin(ds5_devices), end(ds5_devices), std::back_inserter(list));
 
@@ -295,6 +374,7 @@ namespace librealsense
 
         auto uvc_devices = platform_camera_info::pick_uvc_devices(ctx, devices.uvc_devices);
         std::copy(begin(uvc_devices), end(uvc_devices), std::back_inserter(list));
+#endif
 
         for (auto&& item : playback_devices)
         {
@@ -379,13 +459,23 @@ namespace librealsense
 
     void context::set_devices_changed_callback(devices_changed_callback_ptr callback)
     {
+        get_backend();
         _device_watcher->stop();
+        {
+            std::lock_guard<std::mutex> lock(_devices_cache_mutex);
+            _watching_devices = false;
+            _devices_cache_valid = false;
+        }
 
         _devices_changed_callback = std::move(callback);
         _device_watcher->start([this](platform::backend_device_group old, platform::backend_device_group curr)
         {
+            //Updated before the callbacks run, so devices they query are the ones reported to them
+            update_devices_cache(curr);
             on_device_changed(old, curr, _playback_devices, _playback_devices);
         });
+        std::lock_guard<std::mutex> lock(_devices_cache_mutex);
+        _watching_devices = true;
     }
 
     void context::unregister_internal_device_callback(uint64_t cb_id)
@@ -431,7 +521,16 @@ namespace librealsense
             //Already exists
             throw librealsense::invalid_value_exception(to_string() << "File \"" << file << "\" already loaded to context");
         }
-        auto playack_dev = std::make_shared<playback_device>(shared_from_this(), std::make_shared<ros_reader>(file, shared_from_this()));
+        std::shared_ptr<device_serializer::reader> reader;
+        if (is_network_address(file))
+            reader = std::make_shared<network_reader>(file, shared_from_this());
+        else if (is_segment_manifest(file))
+            reader = std::make_shared<segmented_reader>(file, shared_from_this());
+        else if (is_native_recording(file))
+            reader = std::make_shared<native_reader>(file, shared_from_this());
+        else
+            reader = std::make_shared<ros_reader>(file, shared_from_this());
+        auto playack_dev = std::make_shared<playback_device>(shared_from_this(), reader);
         auto dinfo = std::make_shared<playback_device_info>(playack_dev);
         auto prev_playback_devices = _playback_devices;
         _playback_devices[file] = dinfo;
@@ -439,6 +538,20 @@ namespace librealsense
         return playack_dev;
     }
 
+    std::shared_ptr<device_interface> context::add_software_device(const std::string& name)
+    {
+        if (_playback_devices.find(name) != _playback_devices.end())
+        {
+            throw librealsense::invalid_value_exception(to_string() << "Device \"" << name << "\" already added to context");
+        }
+        auto dev = std::make_shared<software_device>(shared_from_this(), name);
+        auto dinfo = std::make_shared<readonly_device_info>(dev);
+        auto prev_playback_devices = _playback_devices;
+        _playback_devices[name] = dinfo;
+        on_device_changed({}, {}, prev_playback_devices, _playback_devices);
+        return dev;
+    }
+
     void context::remove_device(const std::string& file)
     {
         auto it = _playback_devices.find(file);
@@ -109,12 +109,23 @@ namespace librealsense
         explicit context(backend_type type,
             const char* filename = nullptr,
             const char* section = nullptr,
-            rs2_recording_mode mode = RS2_RECORDING_MODE_COUNT);
+            rs2_recording_mode mode = RS2_RECORDING_MODE_COUNT,
+            bool cache_frames = false);
 
-        void stop(){_device_watcher->stop();}
+        void stop()
+        {
+            if (_device_watcher) _device_watcher->stop();
+            std::lock_guard<std::mutex> lock(_devices_cache_mutex);
+            _watching_devices = false;
+            _devices_cache_valid = false;
+        }
         ~context();
-        std::vector<std::shared_ptr<device_info>> query_devices() const;
-        const platform::backend& get_backend() const { return *_backend; }
+        // A lightweight query enumerates the UVC interfaces only, its devices have no motion sensors and recovery
+        // devices are not listed. While the device watcher runs, both return the devices it last reported
+        std::vector<std::shared_ptr<device_info>> query_devices(bool lightweight = false) const;
+        // The backend of a standard context is created on first use, so that contexts used only for recordings,
+        // software devices or processing never open the USB and video subsystems
+        const platform::backend& get_backend() const;
 
         uint64_t register_internal_device_callback(devices_changed_callback_ptr callback);
         void set_devices_changed_callback(devices_changed_callback_ptr callback);
@@ -125,17 +136,24 @@ namespace librealsense
 
 
         std::shared_ptr<device_interface> add_device(const std::string& file);
+        // Software device listed along with the devices added from files, remove_device with the name removes it
+        std::shared_ptr<device_interface> add_software_device(const std::string& name);
         void remove_device(const std::string& file);
 
+        // Replaces the time service of the environment, see rs2_context_set_time_source
+        void set_time_source(rs2_time_source source);
+
     private:
         void on_device_changed(platform::backend_device_group old, platform::backend_device_group curr, const std::map<std::string, std::shared_ptr<device_info>>& old_playback_devices, const std::map<std::string, std::shared_ptr<device_info>>& new_playback_devices);
 
         int find_stream_profile(const stream_interface& p);
         std::shared_ptr<lazy<rs2_extrinsics>> fetch_edge(int from, int to);
+        void update_devices_cache(const platform::backend_device_group& devices);
 
-        std::shared_ptr<platform::backend> _backend;
+        mutable std::once_flag _backend_once;
+        mutable std::shared_ptr<platform::backend> _backend;
 
-        std::shared_ptr<platform::device_watcher> _device_watcher;
+        mutable std::shared_ptr<platform::device_watcher> _device_watcher;
         std::map<std::string, std::shared_ptr<device_info>> _playback_devices;
         std::map<uint64_t, devices_changed_callback_ptr> _devices_changed_callbacks;
 
@@ -144,6 +162,12 @@ namespace librealsense
         std::map<int, std::weak_ptr<const stream_interface>> _streams;
         std::map<int, std::map<int, std::weak_ptr<lazy<rs2_extrinsics>>>> _extrinsics;
         std::mutex _streams_mutex, _devices_changed_callbacks_mtx;
+
+        // Devices of the backend as last reported by the device watcher, valid only while it runs
+        mutable std::mutex _devices_cache_mutex;
+        bool _watching_devices = false;
+        mutable bool _devices_cache_valid = false;
+        mutable std::vector<std::shared_ptr<device_info>> _cached_devices;
     };
 
     class readonly_device_info : public device_info
@@ -91,6 +91,8 @@ namespace librealsense
 
         virtual std::vector<uint8_t> serialize_json() const = 0;
         virtual void load_json(const std::string& json_content) = 0;
+        virtual std::vector<uint8_t> compile_json(const std::string& json_content) const = 0;
+        virtual void load_compiled_preset(const std::vector<uint8_t>& blob) = 0;
 
         virtual ~ds5_advanced_mode_interface() = default;
     };
@@ -139,6 +141,10 @@ namespace librealsense
 
         std::vector<uint8_t> serialize_json() const;
         void load_json(const std::string& json_content);
+        // The blob holds the encoded commands of the register groups and the values of the controls the JSON
+        // results in on this device, and is bound to the firmware version it was compiled with
+        std::vector<uint8_t> compile_json(const std::string& json_content) const override;
+        void load_compiled_preset(const std::vector<uint8_t>& blob) override;
 
     private:
         void set_exposure(uvc_sensor& sensor, const exposure_control& val);
@@ -197,34 +203,58 @@ namespace librealsense
         static const uint16_t HW_MONITOR_BUFFER_SIZE = 1024;
 
         preset get_all() const;
-        void set_all(const preset& p);
+        // With the current values given, only the register groups and controls that differ from them are written
+        void set_all(const preset& p, const preset* current = nullptr);
+        void set_groups(const std::vector<std::vector<uint8_t>>& commands);
+        void set_controls(const preset& p, const preset* current);
+        std::string get_firmware_version() const;
 
         std::vector<uint8_t> send_receive(const std::vector<uint8_t>& input) const;
 
+        std::vector<std::vector<uint8_t>> send_receive_batch(const std::vector<std::vector<uint8_t>>& inputs,
+                                                             std::chrono::milliseconds delay = std::chrono::milliseconds(0)) const;
+
+        // The firmware needs this long to apply a register group before the next command
+        static const int SET_ADV_DELAY_MS = 20;
+
         template<class T>
-        void set(const T& strct, EtAdvancedModeRegGroup cmd) const
+        std::vector<uint8_t> encode_set(const T& strct, EtAdvancedModeRegGroup cmd) const
         {
             auto ptr = (uint8_t*)(&strct);
             std::vector<uint8_t> data(ptr, ptr + sizeof(T));
+            return encode_command(ds::fw_cmd::SET_ADV, static_cast<uint32_t>(cmd), 0, 0, 0, data);
+        }
 
-            assert_no_error(ds::fw_cmd::SET_ADV,
-                send_receive(encode_command(ds::fw_cmd::SET_ADV, static_cast<uint32_t>(cmd), 0, 0, 0, data)));
-            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        template<class T>
+        void encode_set_if_changed(std::vector<std::vector<uint8_t>>& commands, const preset& p, const preset* current, T preset::* group) const
+        {
+            if (!current || memcmp(&(p.*group), &(current->*group), sizeof(T)) != 0)
+                commands.push_back(encode_set(p.*group, advanced_mode_traits<T>::group));
         }
 
         template<class T>
-        T get(EtAdvancedModeRegGroup cmd, T* ptr = static_cast<T*>(nullptr), int mode = 0) const
+        static T decode_get(const std::vector<uint8_t>& results)
         {
-            T res;
-            auto data = assert_no_error(ds::fw_cmd::GET_ADV,
-                send_receive(encode_command(ds::fw_cmd::GET_ADV,
-                static_cast<uint32_t>(cmd), mode)));
+            auto data = assert_no_error(ds::fw_cmd::GET_ADV, results);
             if (data.size() < sizeof(T))
             {
                 throw std::runtime_error("The camera returned invalid sized result!");
             }
-            res = *reinterpret_cast<T*>(data.data());
-            return res;
+            return *reinterpret_cast<T*>(data.data());
+        }
+
+        template<class T>
+        void set(const T& strct, EtAdvancedModeRegGroup cmd) const
+        {
+            assert_no_error(ds::fw_cmd::SET_ADV, send_receive(encode_set(strct, cmd)));
+            std::this_thread::sleep_for(std::chrono::milliseconds(SET_ADV_DELAY_MS));
+        }
+
+        template<class T>
+        T get(EtAdvancedModeRegGroup cmd, T* ptr = static_cast<T*>(nullptr), int mode = 0) const
+        {
+            return decode_get<T>(send_receive(encode_command(ds::fw_cmd::GET_ADV,
+                static_cast<uint32_t>(cmd), mode)));
         }
 
         static uint32_t pack(uint8_t c0, uint8_t c1, uint8_t c2, uint8_t c3);
@@ -5,6 +5,7 @@
 #include "streaming.h"
 #include "extension.h"
 #include <vector>
+#include <chrono>
 
 namespace librealsense
 {
@@ -12,6 +13,26 @@ namespace librealsense
     {
     public:
         virtual std::vector<uint8_t> send_receive_raw_data(const std::vector<uint8_t>& input) = 0;
+
+        // Sends the commands in order and returns their responses, with the milliseconds from the start of the batch
+        // to the arrival of each response. Devices sending them as one batch override this to pipeline the commands
+        virtual std::vector<std::vector<uint8_t>> send_receive_raw_data_batch(const std::vector<std::vector<uint8_t>>& inputs,
+                                                                              std::vector<double>& received_ms)
+        {
+            auto start = std::chrono::steady_clock::now();
+            std::vector<std::vector<uint8_t>> results;
+            for (auto&& input : inputs)
+            {
+                results.push_back(send_receive_raw_data(input));
+                received_ms.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+            }
+            return results;
+        }
+
+        // Firmware logs read in the background, see fw_log_reader
+        virtual void start_fw_log_capture(size_t capacity) = 0;
+        virtual void stop_fw_log_capture() = 0;
+        virtual std::vector<uint8_t> fetch_fw_logs(size_t max_count, std::chrono::milliseconds timeout) = 0;
     };
 
     MAP_EXTENSION(RS2_EXTENSION_DEBUG, librealsense::debug_interface);
@@ -3,6 +3,10 @@
 #pragma once
 
 #include <map>
+#include <vector>
+#include <chrono>
+#include <functional>
+#include <mutex>
 #include "../include/librealsense2/h/rs_option.h"
 #include "extension.h"
 #include "types.h"
@@ -28,10 +32,72 @@ namespace librealsense
         virtual const char* get_description() const = 0;
         virtual const char* get_value_description(float) const { return nullptr; }
         virtual void create_snapshot(std::shared_ptr<option>& snapshot) const override;
+        // Reads the value from the device even when query returns a cached value
+        virtual float query_from_device() const { return query(); }
 
         virtual ~option() = default;
     };
 
+    // Values of the options of a sensor as last read from the device, so that polling options does not reach the
+    // device on every query. A value is read again once it is older than the staleness. Setting any option or a
+    // notification from the device drops all the values, since one option may change others (e.g. auto exposure)
+    class option_cache
+    {
+    public:
+        option_cache() : _staleness(std::chrono::milliseconds(100)), _generation(0) {}
+
+        // Zero disables the cache
+        void set_staleness(std::chrono::milliseconds staleness)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _staleness = staleness;
+            _values.clear();
+            ++_generation;
+        }
+
+        float query(const option* opt, const std::function<float()>& read)
+        {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                auto it = _values.find(opt);
+                if (_staleness.count() > 0 && it != _values.end() &&
+                    std::chrono::steady_clock::now() - it->second.second < _staleness)
+                    return it->second.first;
+            }
+            return refresh(opt, read);
+        }
+
+        float refresh(const option* opt, const std::function<float()>& read)
+        {
+            uint64_t generation;
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                generation = _generation;
+            }
+            auto time = std::chrono::steady_clock::now();
+            auto value = read();
+
+            //A value read while an option was set may already be outdated, and is not kept
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_staleness.count() > 0 && generation == _generation)
+                _values[opt] = std::make_pair(value, time);
+            return value;
+        }
+
+        void invalidate()
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _values.clear();
+            ++_generation;
+        }
+
+    private:
+        std::mutex _mutex;
+        std::chrono::milliseconds _staleness;
+        uint64_t _generation;
+        std::map<const option*, std::pair<float, std::chrono::steady_clock::time_point>> _values;
+    };
+
 
     class options_interface : public recordable<options_interface>
     {
@@ -40,6 +106,22 @@ namespace librealsense
         virtual const option& get_option(rs2_option id) const = 0;
         virtual bool supports_option(rs2_option id) const = 0;
 
+        // Query or set many options at once, sets are applied in the given order
+        virtual std::vector<float> query_options(const std::vector<rs2_option>& ids) const
+        {
+            std::vector<float> values;
+            values.reserve(ids.size());
+            for (auto id : ids)
+                values.push_back(get_option(id).query());
+            return values;
+        }
+
+        virtual void set_options(const std::vector<std::pair<rs2_option, float>>& values)
+        {
+            for (auto&& v : values)
+                get_option(v.first).set(v.second);
+        }
+
         virtual ~options_interface() = default;
     };
 
@@ -29,9 +29,15 @@ namespace librealsense
                                                       int new_stride = 0,
                                                       rs2_extension frame_type = RS2_EXTENSION_VIDEO_FRAME) = 0;
 
-        virtual frame_interface* allocate_composite_frame(std::vector<frame_holder> frames) = 0;
+        // Takes the ownership of the frames, which are left empty
+        virtual frame_interface* allocate_composite_frame(frame_holder* frames, size_t count) = 0;
 
-        virtual frame_interface* allocate_points(std::shared_ptr<stream_profile_interface> stream, frame_interface* original) = 0;
+        virtual frame_interface* allocate_points(std::shared_ptr<stream_profile_interface> stream, frame_interface* original,
+                                                 size_t vertex_count, rs2_format vertex_format, bool pixel_indices,
+                                                 bool normals = false) = 0;
+
+        virtual frame_interface* allocate_motion_frame(std::shared_ptr<stream_profile_interface> stream, frame_interface* original,
+                                                       size_t size) = 0;
 
         virtual void frame_ready(frame_holder result) = 0;
         virtual rs2_source* get_c_wrapper() = 0;
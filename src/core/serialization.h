@@ -283,6 +283,19 @@ namespace librealsense
             status_file_eof = -404,             /**< EOF */
         };
 
+        const uint32_t MAX_RECORD_COMPRESSION_THREADS = 64;
+
+        // How a recording is written to its file
+        struct record_settings
+        {
+            rs2_record_compression compression = RS2_RECORD_COMPRESSION_LZ4;
+            uint32_t chunk_size = 0;            // Bytes of messages per chunk, 0 keeps the default of the file format
+            uint32_t compression_threads = 0;   // Chunks are compressed on this many threads, 0 compresses them while writing
+            uint64_t segment_size = 0;          // Bytes of a segment before the recording continues in a new file, 0 for no limit
+            nanoseconds segment_duration{ 0 };  // Recorded time of a segment before the recording continues in a new file, 0 for no limit
+            bool native_formats = false;        // Frames unpacked into larger formats are recorded as the sensor delivered them
+        };
+
         class writer
         {
         public:
@@ -294,6 +307,16 @@ namespace librealsense
             virtual ~writer() = default;
         };
 
+        // Downscaled copy of a recorded video frame, for showing while seeking
+        struct thumbnail
+        {
+            nanoseconds time;
+            uint32_t width = 0;
+            uint32_t height = 0;
+            rs2_format format = RS2_FORMAT_ANY;
+            std::vector<uint8_t> data;
+        };
+
         class reader
         {
         public:
@@ -301,6 +324,10 @@ namespace librealsense
             virtual device_snapshot query_device_description(const nanoseconds& time) = 0;
             virtual std::shared_ptr<serialized_data> read_next_data() = 0;
             virtual void seek_to_time(const nanoseconds& time) = 0;
+            virtual uint64_t query_frame_count(const stream_identifier& stream_id) = 0;
+            virtual nanoseconds query_frame_time(const stream_identifier& stream_id, uint64_t frame) = 0;
+            // Latest thumbnail of the stream at or before the time, false when there is none
+            virtual bool query_thumbnail(const stream_identifier& stream_id, const nanoseconds& time, thumbnail& result) = 0;
             virtual nanoseconds query_duration() const = 0;
             virtual void reset() = 0;
             virtual void enable_stream(const std::vector<device_serializer::stream_identifier>& stream_ids) = 0;
@@ -66,7 +66,7 @@ namespace librealsense
         virtual rs2_metadata_type get_frame_metadata(const rs2_frame_metadata_value& frame_metadata) const = 0;
         virtual bool supports_frame_metadata(const rs2_frame_metadata_value& frame_metadata) const = 0;
         virtual const byte* get_frame_data() const = 0;
-        //TODO: add virtual uint64_t get_frame_data_size() const = 0;
+        virtual size_t get_frame_data_size() const = 0;
         virtual rs2_time_t get_frame_timestamp() const = 0;
         virtual rs2_timestamp_domain get_frame_timestamp_domain() const = 0;
         virtual void set_timestamp(double new_ts) = 0;
@@ -75,21 +75,25 @@ namespace librealsense
         virtual void set_timestamp_domain(rs2_timestamp_domain timestamp_domain) = 0;
         virtual rs2_time_t get_frame_system_time() const = 0;
 
-        virtual std::shared_ptr<stream_profile_interface> get_stream() const = 0;
-        virtual void set_stream(std::shared_ptr<stream_profile_interface> sp) = 0;
+        // Returned by reference, the profile is queried per frame on the streaming paths
+        virtual const std::shared_ptr<stream_profile_interface>& get_stream() const = 0;
+        virtual void set_stream(const std::shared_ptr<stream_profile_interface>& sp) = 0;
 
         virtual rs2_time_t get_frame_callback_start_time_point() const = 0;
         virtual void update_frame_callback_start_ts(rs2_time_t ts) = 0;
 
         virtual void acquire() = 0;
         virtual void release() = 0;
-        virtual frame_interface* publish(std::shared_ptr<archive_interface> new_owner) = 0;
+        virtual frame_interface* publish(archive_interface* new_owner) = 0;
         virtual void attach_continuation(frame_continuation&& continuation) = 0;
         virtual void disable_continuation() = 0;
 
         virtual void log_callback_start(rs2_time_t timestamp) = 0;
         virtual void log_callback_end(rs2_time_t timestamp) const = 0;
 
+        virtual rs2_time_t get_latency_timestamp(rs2_frame_latency_stage stage) const = 0;
+        virtual void set_latency_timestamp(rs2_frame_latency_stage stage, rs2_time_t timestamp) = 0;
+
         virtual archive_interface* get_owner() const = 0;
 
         virtual ~frame_interface() = default;
@@ -107,6 +111,8 @@ namespace librealsense
 
         virtual void register_notifications_callback(notifications_callback_ptr callback) = 0;
 
+        virtual void set_frame_allocator(frame_allocator_ptr allocator, size_t alignment) = 0;
+
         virtual void start(frame_callback_ptr callback) = 0;
         virtual void stop() = 0;
 
@@ -153,6 +159,15 @@ namespace librealsense
 
     MAP_EXTENSION(RS2_EXTENSION_DEPTH_SENSOR, librealsense::depth_sensor);
 
+    // Depth sensors matching two imagers, whose depth converts to the disparity between them
+    class stereo_baseline_interface
+    {
+    public:
+        // Distance between the imagers, in millimeters
+        virtual float get_stereo_baseline_mm() const = 0;
+        virtual ~stereo_baseline_interface() = default;
+    };
+
     class depth_sensor_snapshot : public depth_sensor, public extension_snapshot
     {
     public:
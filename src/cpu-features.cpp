@@ -0,0 +1,54 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#include "cpu-features.h"
+
+#include <cstdlib>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+namespace librealsense
+{
+    static uint32_t detect_cpu_features()
+    {
+        uint32_t features = 0;
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+        features |= CPU_FEATURE_NEON;
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        int info[4];
+        __cpuid(info, 0);
+        auto max_leaf = info[0];
+
+        __cpuid(info, 1);
+        if (info[2] & (1 << 9))  features |= CPU_FEATURE_SSSE3;
+        if (info[2] & (1 << 19)) features |= CPU_FEATURE_SSE41;
+
+        // AVX state must also be enabled by the OS
+        auto os_avx = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && ((_xgetbv(0) & 6) == 6);
+        if (os_avx && max_leaf >= 7)
+        {
+            __cpuidex(info, 7, 0);
+            if (info[1] & (1 << 5)) features |= CPU_FEATURE_AVX2;
+        }
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("ssse3"))  features |= CPU_FEATURE_SSSE3;
+        if (__builtin_cpu_supports("sse4.1")) features |= CPU_FEATURE_SSE41;
+        if (__builtin_cpu_supports("avx2"))   features |= CPU_FEATURE_AVX2;
+#endif
+
+        if (getenv("LRS_DISABLE_SIMD")) features = 0;
+
+        return features;
+    }
+
+    uint32_t get_cpu_features()
+    {
+        static const uint32_t features = detect_cpu_features();
+        return features;
+    }
+}
@@ -0,0 +1,34 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include <cstdint>
+
+// Functions using AVX2 intrinsics are compiled for AVX2 individually, and must only be called when cpu_supports(CPU_FEATURE_AVX2)
+#if defined(__GNUC__) || defined(__clang__)
+    #define AVX2_TARGET __attribute__((target("avx2")))
+#else
+    #define AVX2_TARGET
+#endif
+
+namespace librealsense
+{
+    enum cpu_feature : uint32_t
+    {
+        CPU_FEATURE_SSSE3  = 1 << 0,
+        CPU_FEATURE_SSE41  = 1 << 1,
+        CPU_FEATURE_AVX2   = 1 << 2,
+        CPU_FEATURE_NEON   = 1 << 3,
+    };
+
+    // Instruction set extensions usable at runtime, detected once on first call
+    // Defining LRS_DISABLE_SIMD in the environment reports none of them, forcing the scalar
+    // reference implementations, which is useful to validate the vectorized code paths
+    uint32_t get_cpu_features();
+
+    inline bool cpu_supports(cpu_feature feature)
+    {
+        return (get_cpu_features() & feature) != 0;
+    }
+}
@@ -0,0 +1,205 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#include "device-state.h"
+#include "core/advanced_mode.h"
+#include "types.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace librealsense
+{
+    namespace
+    {
+        const uint32_t STATE_MAGIC = 0x53445352; // "RSDS"
+        const uint32_t STATE_VERSION = 1;
+
+        class state_writer
+        {
+        public:
+            void write(uint32_t value) { append(&value, sizeof(value)); }
+            void write(float value) { append(&value, sizeof(value)); }
+            void write(const std::vector<uint8_t>& bytes)
+            {
+                write(static_cast<uint32_t>(bytes.size()));
+                append(bytes.data(), bytes.size());
+            }
+
+            std::vector<uint8_t> data;
+
+        private:
+            void append(const void* src, size_t size)
+            {
+                auto bytes = static_cast<const uint8_t*>(src);
+                data.insert(data.end(), bytes, bytes + size);
+            }
+        };
+
+        class state_reader
+        {
+        public:
+            explicit state_reader(const std::vector<uint8_t>& data) : _data(data), _pos(0) {}
+
+            uint32_t read_uint() { uint32_t value; extract(&value, sizeof(value)); return value; }
+            float read_float() { float value; extract(&value, sizeof(value)); return value; }
+            std::vector<uint8_t> read_bytes()
+            {
+                auto size = read_uint();
+                if (size > _data.size() - _pos)
+                    throw invalid_value_exception("Device state is truncated");
+                std::vector<uint8_t> bytes(_data.begin() + _pos, _data.begin() + _pos + size);
+                _pos += size;
+                return bytes;
+            }
+
+        private:
+            void extract(void* dst, size_t size)
+            {
+                if (size > _data.size() - _pos)
+                    throw invalid_value_exception("Device state is truncated");
+                memcpy(dst, _data.data() + _pos, size);
+                _pos += size;
+            }
+
+            const std::vector<uint8_t>& _data;
+            size_t _pos;
+        };
+
+        std::vector<uint8_t> get_serial(const device_interface& dev)
+        {
+            if (!dev.supports_info(RS2_CAMERA_INFO_SERIAL_NUMBER)) return {};
+            auto&& serial = dev.get_info(RS2_CAMERA_INFO_SERIAL_NUMBER);
+            return std::vector<uint8_t>(serial.begin(), serial.end());
+        }
+
+        // Writable options of the sensor with their values, the automatic controls first so that the manual values
+        // they would override are only kept, and written after them, while the controls are off
+        std::vector<std::pair<rs2_option, float>> capture_options(const sensor_interface& sensor, bool skip_preset)
+        {
+            std::vector<rs2_option> ids;
+            for (int i = 0; i < RS2_OPTION_COUNT; i++)
+            {
+                auto id = static_cast<rs2_option>(i);
+                if (!sensor.supports_option(id) || sensor.get_option(id).is_read_only()) continue;
+                // The advanced mode tables already hold what the preset selected
+                if (skip_preset && id == RS2_OPTION_VISUAL_PRESET) continue;
+                ids.push_back(id);
+            }
+
+            std::vector<std::pair<rs2_option, float>> values;
+            try
+            {
+                auto read = sensor.query_options(ids);
+                for (size_t i = 0; i < ids.size(); i++)
+                    values.emplace_back(ids[i], read[i]);
+            }
+            catch (...)
+            {
+                // Options that can not be read right now are left out
+                for (auto id : ids)
+                {
+                    try { values.emplace_back(id, sensor.get_option(id).query()); }
+                    catch (...) {}
+                }
+            }
+
+            auto value_of = [&values](rs2_option id)
+            {
+                auto it = std::find_if(values.begin(), values.end(), [id](const std::pair<rs2_option, float>& v) { return v.first == id; });
+                return it != values.end() ? it->second : 0.f;
+            };
+            auto auto_exposure = value_of(RS2_OPTION_ENABLE_AUTO_EXPOSURE) != 0.f;
+            auto auto_white_balance = value_of(RS2_OPTION_ENABLE_AUTO_WHITE_BALANCE) != 0.f;
+            values.erase(std::remove_if(values.begin(), values.end(), [=](const std::pair<rs2_option, float>& v)
+            {
+                return (auto_exposure && (v.first == RS2_OPTION_EXPOSURE || v.first == RS2_OPTION_GAIN)) ||
+                       (auto_white_balance && v.first == RS2_OPTION_WHITE_BALANCE);
+            }), values.end());
+
+            std::stable_partition(values.begin(), values.end(), [](const std::pair<rs2_option, float>& v)
+            {
+                return v.first == RS2_OPTION_ENABLE_AUTO_EXPOSURE || v.first == RS2_OPTION_ENABLE_AUTO_WHITE_BALANCE;
+            });
+            return values;
+        }
+    }
+
+    std::vector<uint8_t> capture_device_state(const device_interface& dev)
+    {
+        std::vector<uint8_t> advanced;
+        if (auto advanced_mode = dynamic_cast<const ds5_advanced_mode_interface*>(&dev))
+        {
+            if (advanced_mode->is_enabled())
+            {
+                auto json = advanced_mode->serialize_json();
+                advanced = advanced_mode->compile_json(std::string(json.begin(), json.end()));
+            }
+        }
+
+        state_writer writer;
+        writer.write(STATE_MAGIC);
+        writer.write(STATE_VERSION);
+        writer.write(get_serial(dev));
+        writer.write(advanced);
+
+        auto count = dev.get_sensors_count();
+        writer.write(static_cast<uint32_t>(count));
+        for (size_t i = 0; i < count; i++)
+        {
+            auto values = capture_options(dev.get_sensor(i), !advanced.empty());
+            writer.write(static_cast<uint32_t>(values.size()));
+            for (auto&& v : values)
+            {
+                writer.write(static_cast<uint32_t>(v.first));
+                writer.write(v.second);
+            }
+        }
+        return std::move(writer.data);
+    }
+
+    void restore_device_state(device_interface& dev, const std::vector<uint8_t>& state)
+    {
+        state_reader reader(state);
+        if (reader.read_uint() != STATE_MAGIC)
+            throw invalid_value_exception("Not a device state");
+        auto version = reader.read_uint();
+        if (version != STATE_VERSION)
+            throw invalid_value_exception(to_string() << "Unsupported device state version " << version);
+        if (reader.read_bytes() != get_serial(dev))
+            throw invalid_value_exception("The device state was captured from another device");
+
+        auto advanced = reader.read_bytes();
+        auto count = reader.read_uint();
+        if (count != dev.get_sensors_count())
+            throw invalid_value_exception(to_string() << "The device state holds " << count << " sensors, the device has " << dev.get_sensors_count());
+
+        std::vector<std::vector<std::pair<rs2_option, float>>> options(count);
+        for (auto&& values : options)
+        {
+            auto size = reader.read_uint();
+            for (uint32_t i = 0; i < size; i++)
+            {
+                auto id = reader.read_uint();
+                auto value = reader.read_float();
+                if (id >= RS2_OPTION_COUNT)
+                    throw invalid_value_exception(to_string() << "Invalid option " << id << " in the device state");
+                values.emplace_back(static_cast<rs2_option>(id), value);
+            }
+        }
+
+        if (!advanced.empty())
+        {
+            auto advanced_mode = dynamic_cast<ds5_advanced_mode_interface*>(&dev);
+            if (!advanced_mode || !advanced_mode->is_enabled())
+                throw wrong_api_call_sequence_exception("The device state holds advanced mode tables, but the advanced mode of the device is disabled");
+            advanced_mode->load_compiled_preset(advanced);
+        }
+
+        for (uint32_t i = 0; i < count; i++)
+        {
+            if (!options[i].empty())
+                dev.get_sensor(i).set_options(options[i]);
+        }
+    }
+}
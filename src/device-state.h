@@ -0,0 +1,20 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "core/streaming.h"
+
+#include <vector>
+
+namespace librealsense
+{
+    // Snapshot of the settings of a device, to bring the same device back to them after a reset or a reconnection.
+    // It holds the writable options of every sensor and the advanced mode tables compiled for the firmware of the
+    // device, and is serialized so applications can keep it as a blob
+    std::vector<uint8_t> capture_device_state(const device_interface& dev);
+
+    // Writes the snapshot back, the advanced mode tables first and then the options of each sensor, every group
+    // in a single batch. Only the device the snapshot was captured from is accepted
+    void restore_device_state(device_interface& dev, const std::vector<uint8_t>& state);
+}
@@ -10,7 +10,8 @@ device::device(std::shared_ptr<context> ctx,
                const platform::backend_device_group group,
                bool device_changed_notifications)
     : _context(ctx), _group(group), _is_valid(true),
-      _device_changed_notifications(device_changed_notifications)
+      _device_changed_notifications(device_changed_notifications),
+      _clock_model(std::make_shared<shared_clock_model>())
 {
     if (_device_changed_notifications)
     {
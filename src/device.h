@@ -11,6 +11,7 @@
 #include "archive.h"
 #include "hw-monitor.h"
 #include "option.h"
+#include "clock-model.h"
 #include "sensor.h"
 #include "sync.h"
 #include "core/streaming.h"
@@ -49,6 +50,9 @@ namespace librealsense
             return _is_valid;
         }
 
+        // Model of the hardware clock shared by the sensors of the device
+        std::shared_ptr<shared_clock_model> get_clock_model() const { return _clock_model; }
+
     protected:
         int add_sensor(std::shared_ptr<sensor_interface> sensor_base);
         int assign_sensor(std::shared_ptr<sensor_interface> sensor_base, uint8_t idx);
@@ -67,5 +71,6 @@ namespace librealsense
         bool _is_valid, _device_changed_notifications;
         mutable std::mutex _device_changed_mtx;
         uint64_t _callback_id;
+        std::shared_ptr<shared_clock_model> _clock_model;
     };
 }
@@ -9,6 +9,8 @@
 
 namespace librealsense
 {
+    const int ds5_advanced_mode_base::SET_ADV_DELAY_MS;
+
     ds5_advanced_mode_base::ds5_advanced_mode_base(std::shared_ptr<hw_monitor> hwm,
                                                    uvc_sensor& depth_sensor)
         : _hw_monitor(hwm),
@@ -54,7 +56,8 @@ namespace librealsense
     void ds5_advanced_mode_base::apply_preset(const std::vector<platform::stream_profile>& configuration,
                                               rs2_rs400_visual_preset preset)
     {
-        auto p = get_all();
+        auto current = get_all();
+        auto p = current;
         auto res = get_res_type(configuration.front().width, configuration.front().height);
 
         switch (preset)
@@ -110,7 +113,7 @@ namespace librealsense
         default:
             throw invalid_value_exception(to_string() << "Invalid preset! " << preset);
         }
-        set_all(p);
+        set_all(p, &current);
     }
 
     void ds5_advanced_mode_base::get_depth_control_group(STDepthControlGroup* ptr, int mode) const
@@ -594,26 +597,215 @@ namespace librealsense
         if (!is_enabled())
             throw wrong_api_call_sequence_exception(to_string() << "load_json(...) failed! Device is not in Advanced-Mode.");
 
+        auto current = get_all();
+        auto p = current;
+        update_structs(json_content, p);
+        set_all(p, &current);
+    }
+
+    // Compiled presets start with the magic, the version of the layout, the firmware version and the commands
+    static const uint32_t COMPILED_PRESET_MAGIC = 0x50435352; // "RSCP"
+    static const uint16_t COMPILED_PRESET_VERSION = 1;
+
+    template<class T>
+    static void append(std::vector<uint8_t>& blob, const T& value)
+    {
+        auto bytes = reinterpret_cast<const uint8_t*>(&value);
+        blob.insert(blob.end(), bytes, bytes + sizeof(T));
+    }
+
+    class blob_reader
+    {
+    public:
+        explicit blob_reader(const std::vector<uint8_t>& blob) : _ptr(blob.data()), _end(blob.data() + blob.size()) {}
+
+        const uint8_t* take(size_t size)
+        {
+            if (size > static_cast<size_t>(_end - _ptr))
+                throw invalid_value_exception("Compiled preset is truncated");
+            auto ptr = _ptr;
+            _ptr += size;
+            return ptr;
+        }
+
+        template<class T>
+        T read()
+        {
+            T value;
+            memcpy(&value, take(sizeof(T)), sizeof(T));
+            return value;
+        }
+
+        bool done() const { return _ptr == _end; }
+
+    private:
+        const uint8_t* _ptr;
+        const uint8_t* _end;
+    };
+
+    // Visits the value and the was_set flag of every control, in the order they are kept in compiled presets
+    template<class T>
+    static void visit_controls(preset& p, T& visitor)
+    {
+        visitor(p.laser_state.laser_state, p.laser_state.was_set);
+        visitor(p.laser_power.laser_power, p.laser_power.was_set);
+        visitor(p.depth_exposure.exposure, p.depth_exposure.was_set);
+        visitor(p.depth_auto_exposure.auto_exposure, p.depth_auto_exposure.was_set);
+        visitor(p.depth_gain.gain, p.depth_gain.was_set);
+        visitor(p.depth_auto_white_balance.auto_white_balance, p.depth_auto_white_balance.was_set);
+        visitor(p.color_exposure.exposure, p.color_exposure.was_set);
+        visitor(p.color_auto_exposure.auto_exposure, p.color_auto_exposure.was_set);
+        visitor(p.color_backlight_compensation.backlight_compensation, p.color_backlight_compensation.was_set);
+        visitor(p.color_brightness.brightness, p.color_brightness.was_set);
+        visitor(p.color_contrast.contrast, p.color_contrast.was_set);
+        visitor(p.color_gain.gain, p.color_gain.was_set);
+        visitor(p.color_gamma.gamma, p.color_gamma.was_set);
+        visitor(p.color_hue.hue, p.color_hue.was_set);
+        visitor(p.color_saturation.saturation, p.color_saturation.was_set);
+        visitor(p.color_sharpness.sharpness, p.color_sharpness.was_set);
+        visitor(p.color_white_balance.white_balance, p.color_white_balance.was_set);
+        visitor(p.color_auto_white_balance.auto_white_balance, p.color_auto_white_balance.was_set);
+        visitor(p.color_power_line_frequency.power_line_frequency, p.color_power_line_frequency.was_set);
+    }
+
+    struct control_writer
+    {
+        std::vector<uint8_t>& blob;
+
+        template<class V>
+        void operator()(V& value, bool& was_set)
+        {
+            static_assert(sizeof(V) == sizeof(uint32_t), "Controls are kept as 32 bit values");
+            append(blob, value);
+            append(blob, static_cast<uint8_t>(was_set));
+        }
+    };
+
+    struct control_reader
+    {
+        blob_reader& reader;
+
+        template<class V>
+        void operator()(V& value, bool& was_set)
+        {
+            value = reader.read<V>();
+            was_set = reader.read<uint8_t>() != 0;
+        }
+    };
+
+    std::string ds5_advanced_mode_base::get_firmware_version() const
+    {
+        auto& dev = _depth_sensor.get_device();
+        return dev.supports_info(RS2_CAMERA_INFO_FIRMWARE_VERSION) ? dev.get_info(RS2_CAMERA_INFO_FIRMWARE_VERSION) : "";
+    }
+
+    std::vector<uint8_t> ds5_advanced_mode_base::compile_json(const std::string& json_content) const
+    {
+        if (!is_enabled())
+            throw wrong_api_call_sequence_exception(to_string() << "compile_json(...) failed! Device is not in Advanced-Mode.");
+
+        // Values the JSON leaves out are taken from the device, as load_json would keep them
         auto p = get_all();
         update_structs(json_content, p);
-        set_all(p);
+
+        std::vector<std::vector<uint8_t>> commands;
+        encode_set_if_changed(commands, p, nullptr, &preset::depth_controls);
+        encode_set_if_changed(commands, p, nullptr, &preset::rsm);
+        encode_set_if_changed(commands, p, nullptr, &preset::rsvc);
+        encode_set_if_changed(commands, p, nullptr, &preset::color_control);
+        encode_set_if_changed(commands, p, nullptr, &preset::rctc);
+        encode_set_if_changed(commands, p, nullptr, &preset::sctc);
+        encode_set_if_changed(commands, p, nullptr, &preset::spc);
+        encode_set_if_changed(commands, p, nullptr, &preset::hdad);
+        encode_set_if_changed(commands, p, nullptr, &preset::cc);
+        encode_set_if_changed(commands, p, nullptr, &preset::depth_table);
+        encode_set_if_changed(commands, p, nullptr, &preset::ae);
+        encode_set_if_changed(commands, p, nullptr, &preset::census);
+
+        std::vector<uint8_t> blob;
+        auto firmware = get_firmware_version();
+        append(blob, COMPILED_PRESET_MAGIC);
+        append(blob, COMPILED_PRESET_VERSION);
+        append(blob, static_cast<uint16_t>(firmware.size()));
+        blob.insert(blob.end(), firmware.begin(), firmware.end());
+        append(blob, static_cast<uint16_t>(commands.size()));
+        for (auto&& command : commands)
+        {
+            append(blob, static_cast<uint16_t>(command.size()));
+            blob.insert(blob.end(), command.begin(), command.end());
+        }
+        control_writer writer{ blob };
+        visit_controls(p, writer);
+        return blob;
+    }
+
+    void ds5_advanced_mode_base::load_compiled_preset(const std::vector<uint8_t>& blob)
+    {
+        if (!is_enabled())
+            throw wrong_api_call_sequence_exception(to_string() << "load_compiled_preset(...) failed! Device is not in Advanced-Mode.");
+
+        blob_reader reader(blob);
+        if (reader.read<uint32_t>() != COMPILED_PRESET_MAGIC)
+            throw invalid_value_exception("Not a compiled preset");
+        auto version = reader.read<uint16_t>();
+        if (version != COMPILED_PRESET_VERSION)
+            throw invalid_value_exception(to_string() << "Unsupported compiled preset version " << version);
+
+        auto firmware_size = reader.read<uint16_t>();
+        auto firmware_data = reinterpret_cast<const char*>(reader.take(firmware_size));
+        std::string firmware(firmware_data, firmware_data + firmware_size);
+        if (firmware != get_firmware_version())
+            throw invalid_value_exception(to_string() << "Preset was compiled for firmware " << firmware
+                                                      << ", the device runs " << get_firmware_version());
+
+        std::vector<std::vector<uint8_t>> commands(reader.read<uint16_t>());
+        for (auto&& command : commands)
+        {
+            auto size = reader.read<uint16_t>();
+            auto data = reader.take(size);
+            command.assign(data, data + size);
+        }
+
+        preset p;
+        control_reader controls{ reader };
+        visit_controls(p, controls);
+        if (!reader.done())
+            throw invalid_value_exception("Compiled preset has trailing data");
+
+        set_groups(commands);
+        set_controls(p, nullptr);
     }
 
     preset ds5_advanced_mode_base::get_all() const
     {
         preset p;
-        get_depth_control_group(&p.depth_controls);
-        get_rsm(&p.rsm);
-        get_rau_support_vector_control(&p.rsvc);
-        get_color_control(&p.color_control);
-        get_rau_color_thresholds_control(&p.rctc);
-        get_slo_color_thresholds_control(&p.sctc);
-        get_slo_penalty_control(&p.spc);
-        get_hdad(&p.hdad);
-        get_color_correction(&p.cc);
-        get_depth_table_control(&p.depth_table);
-        get_ae_control(&p.ae);
-        get_census_radius(&p.census);
+        // The register groups are read in one batch, see set_all
+        auto get_cmd = [this](EtAdvancedModeRegGroup group) { return encode_command(ds::fw_cmd::GET_ADV, static_cast<uint32_t>(group)); };
+        auto results = send_receive_batch({
+            get_cmd(advanced_mode_traits<STDepthControlGroup>::group),
+            get_cmd(advanced_mode_traits<STRsm>::group),
+            get_cmd(advanced_mode_traits<STRauSupportVectorControl>::group),
+            get_cmd(advanced_mode_traits<STColorControl>::group),
+            get_cmd(advanced_mode_traits<STRauColorThresholdsControl>::group),
+            get_cmd(advanced_mode_traits<STSloColorThresholdsControl>::group),
+            get_cmd(advanced_mode_traits<STSloPenaltyControl>::group),
+            get_cmd(advanced_mode_traits<STHdad>::group),
+            get_cmd(advanced_mode_traits<STColorCorrection>::group),
+            get_cmd(advanced_mode_traits<STDepthTableControl>::group),
+            get_cmd(advanced_mode_traits<STAEControl>::group),
+            get_cmd(advanced_mode_traits<STCensusRadius>::group) });
+        p.depth_controls = decode_get<STDepthControlGroup>(results[0]);
+        p.rsm = decode_get<STRsm>(results[1]);
+        p.rsvc = decode_get<STRauSupportVectorControl>(results[2]);
+        p.color_control = decode_get<STColorControl>(results[3]);
+        p.rctc = decode_get<STRauColorThresholdsControl>(results[4]);
+        p.sctc = decode_get<STSloColorThresholdsControl>(results[5]);
+        p.spc = decode_get<STSloPenaltyControl>(results[6]);
+        p.hdad = decode_get<STHdad>(results[7]);
+        p.cc = decode_get<STColorCorrection>(results[8]);
+        p.depth_table = decode_get<STDepthTableControl>(results[9]);
+        p.ae = decode_get<STAEControl>(results[10]);
+        p.census = decode_get<STCensusRadius>(results[11]);
         get_laser_power(&p.laser_power);
         get_laser_state(&p.laser_state);
         get_depth_exposure(&p.depth_exposure);
@@ -636,50 +828,109 @@ namespace librealsense
         return p;
     }
 
-    void ds5_advanced_mode_base::set_all(const preset& p)
+    // Leave out a control the device already holds the value of
+    template<class T, class V>
+    static void skip_if_unchanged(T& next, const T& current, V T::* value)
+    {
+        if (next.was_set && current.was_set && next.*value == current.*value)
+            next.was_set = false;
+    }
+
+    void ds5_advanced_mode_base::set_all(const preset& p, const preset* current)
     {
-        set_depth_control_group(p.depth_controls);
-        set_rsm(p.rsm);
-        set_rau_support_vector_control(p.rsvc);
-        set_color_control(p.color_control);
-        set_rau_color_thresholds_control(p.rctc);
-        set_slo_color_thresholds_control(p.sctc);
-        set_slo_penalty_control(p.spc);
-        set_hdad(p.hdad);
-        set_color_correction(p.cc);
-        set_depth_table_control(p.depth_table);
-        set_ae_control(p.ae);
-        set_census_radius(p.census);
+        // The register groups are written in one batch, powering and locking the device once
+        std::vector<std::vector<uint8_t>> commands;
+        encode_set_if_changed(commands, p, current, &preset::depth_controls);
+        encode_set_if_changed(commands, p, current, &preset::rsm);
+        encode_set_if_changed(commands, p, current, &preset::rsvc);
+        encode_set_if_changed(commands, p, current, &preset::color_control);
+        encode_set_if_changed(commands, p, current, &preset::rctc);
+        encode_set_if_changed(commands, p, current, &preset::sctc);
+        encode_set_if_changed(commands, p, current, &preset::spc);
+        encode_set_if_changed(commands, p, current, &preset::hdad);
+        encode_set_if_changed(commands, p, current, &preset::cc);
+        encode_set_if_changed(commands, p, current, &preset::depth_table);
+        encode_set_if_changed(commands, p, current, &preset::ae);
+        encode_set_if_changed(commands, p, current, &preset::census);
+        set_groups(commands);
+        set_controls(p, current);
+    }
+
+    void ds5_advanced_mode_base::set_groups(const std::vector<std::vector<uint8_t>>& commands)
+    {
+        if (commands.empty())
+            return;
 
-        set_laser_state(p.laser_state);
+        auto results = send_receive_batch(commands, std::chrono::milliseconds(SET_ADV_DELAY_MS));
+        for (auto&& result : results)
+            assert_no_error(ds::fw_cmd::SET_ADV, result);
+        std::this_thread::sleep_for(std::chrono::milliseconds(SET_ADV_DELAY_MS));
+    }
+
+    void ds5_advanced_mode_base::set_controls(const preset& p, const preset* current)
+    {
+        // The controls to write. Those depending on a mode are written again whenever the mode changes
+        auto w = p;
+        if (current)
+        {
+            auto&& c = *current;
+            skip_if_unchanged(w.laser_state, c.laser_state, &laser_state_control::laser_state);
+            if (!w.laser_state.was_set)
+                skip_if_unchanged(w.laser_power, c.laser_power, &laser_power_control::laser_power);
+
+            skip_if_unchanged(w.depth_auto_exposure, c.depth_auto_exposure, &auto_exposure_control::auto_exposure);
+            if (!w.depth_auto_exposure.was_set)
+            {
+                skip_if_unchanged(w.depth_gain, c.depth_gain, &gain_control::gain);
+                skip_if_unchanged(w.depth_exposure, c.depth_exposure, &exposure_control::exposure);
+            }
+            skip_if_unchanged(w.depth_auto_white_balance, c.depth_auto_white_balance, &auto_white_balance_control::auto_white_balance);
+
+            skip_if_unchanged(w.color_auto_exposure, c.color_auto_exposure, &auto_exposure_control::auto_exposure);
+            if (!w.color_auto_exposure.was_set)
+                skip_if_unchanged(w.color_exposure, c.color_exposure, &exposure_control::exposure);
+            skip_if_unchanged(w.color_backlight_compensation, c.color_backlight_compensation, &backlight_compensation_control::backlight_compensation);
+            skip_if_unchanged(w.color_brightness, c.color_brightness, &brightness_control::brightness);
+            skip_if_unchanged(w.color_contrast, c.color_contrast, &contrast_control::contrast);
+            skip_if_unchanged(w.color_gain, c.color_gain, &gain_control::gain);
+            skip_if_unchanged(w.color_gamma, c.color_gamma, &gamma_control::gamma);
+            skip_if_unchanged(w.color_hue, c.color_hue, &hue_control::hue);
+            skip_if_unchanged(w.color_saturation, c.color_saturation, &saturation_control::saturation);
+            skip_if_unchanged(w.color_sharpness, c.color_sharpness, &sharpness_control::sharpness);
+            skip_if_unchanged(w.color_auto_white_balance, c.color_auto_white_balance, &auto_white_balance_control::auto_white_balance);
+            if (!w.color_auto_white_balance.was_set)
+                skip_if_unchanged(w.color_white_balance, c.color_white_balance, &white_balance_control::white_balance);
+        }
+
+        set_laser_state(w.laser_state);
         if (p.laser_state.was_set && p.laser_state.laser_state == 1) // 1 - on
-            set_laser_power(p.laser_power);
+            set_laser_power(w.laser_power);
 
-        set_depth_auto_exposure(p.depth_auto_exposure);
+        set_depth_auto_exposure(w.depth_auto_exposure);
         if (p.depth_auto_exposure.was_set && p.depth_auto_exposure.auto_exposure == 0)
         {
-            set_depth_gain(p.depth_gain);
-            set_depth_exposure(p.depth_exposure);
+            set_depth_gain(w.depth_gain);
+            set_depth_exposure(w.depth_exposure);
         }
 
-        set_depth_auto_white_balance(p.depth_auto_white_balance);
+        set_depth_auto_white_balance(w.depth_auto_white_balance);
 
-        set_color_auto_exposure(p.color_auto_exposure);
+        set_color_auto_exposure(w.color_auto_exposure);
         if (p.color_auto_exposure.was_set && p.color_auto_exposure.auto_exposure == 0)
-            set_color_exposure(p.color_exposure);
-
-        set_color_backlight_compensation(p.color_backlight_compensation);
-        set_color_brightness(p.color_brightness);
-        set_color_contrast(p.color_contrast);
-        set_color_gain(p.color_gain);
-        set_color_gamma(p.color_gamma);
-        set_color_hue(p.color_hue);
-        set_color_saturation(p.color_saturation);
-        set_color_sharpness(p.color_sharpness);
-
-        set_color_auto_white_balance(p.color_auto_white_balance);
+            set_color_exposure(w.color_exposure);
+
+        set_color_backlight_compensation(w.color_backlight_compensation);
+        set_color_brightness(w.color_brightness);
+        set_color_contrast(w.color_contrast);
+        set_color_gain(w.color_gain);
+        set_color_gamma(w.color_gamma);
+        set_color_hue(w.color_hue);
+        set_color_saturation(w.color_saturation);
+        set_color_sharpness(w.color_sharpness);
+
+        set_color_auto_white_balance(w.color_auto_white_balance);
         if (p.color_auto_white_balance.was_set && p.color_auto_white_balance.auto_white_balance == 0)
-            set_color_white_balance(p.color_white_balance);
+            set_color_white_balance(w.color_white_balance);
 
         // TODO: Itay, check the issue of setting PWF to auto
         //set_color_power_line_frequency(p.color_power_line_frequency);
@@ -695,6 +946,20 @@ namespace librealsense
         return res;
     }
 
+    std::vector<std::vector<uint8_t>> ds5_advanced_mode_base::send_receive_batch(const std::vector<std::vector<uint8_t>>& inputs,
+                                                                                 std::chrono::milliseconds delay) const
+    {
+        auto results = _hw_monitor->send_batch(inputs, delay);
+        for (auto&& res : results)
+        {
+            if (res.empty())
+            {
+                throw std::runtime_error("Advanced mode write failed!");
+            }
+        }
+        return results;
+    }
+
     uint32_t ds5_advanced_mode_base::pack(uint8_t c0, uint8_t c1, uint8_t c2, uint8_t c3)
     {
         return (c0 << 24) | (c1 << 16) | (c2 << 8) | c3;
@@ -285,3 +285,22 @@ rs2_raw_data_buffer* rs2_serialize_json(rs2_device* dev, rs2_error** error) BEGI
     return new rs2_raw_data_buffer{ advanced_mode->serialize_json() };
 }
 HANDLE_EXCEPTIONS_AND_RETURN(nullptr, dev)
+
+rs2_raw_data_buffer* rs2_compile_json(rs2_device* dev, const void* json_content, unsigned content_size, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(dev);
+    VALIDATE_NOT_NULL(json_content);
+    auto advanced_mode = VALIDATE_INTERFACE(dev->device, librealsense::ds5_advanced_mode_interface);
+    return new rs2_raw_data_buffer{ advanced_mode->compile_json(std::string(static_cast<const char*>(json_content), content_size)) };
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, dev, json_content, content_size)
+
+void rs2_load_compiled_preset(rs2_device* dev, const void* blob, unsigned blob_size, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(dev);
+    VALIDATE_NOT_NULL(blob);
+    auto advanced_mode = VALIDATE_INTERFACE(dev->device, librealsense::ds5_advanced_mode_interface);
+    auto data = static_cast<const uint8_t*>(blob);
+    advanced_mode->load_compiled_preset(std::vector<uint8_t>(data, data + blob_size));
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, dev, blob, blob_size)
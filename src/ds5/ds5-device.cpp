@@ -66,13 +66,34 @@ namespace librealsense
         return _hw_monitor->send(input);
     }
 
+    std::vector<std::vector<uint8_t>> ds5_device::send_receive_raw_data_batch(const std::vector<std::vector<uint8_t>>& inputs,
+                                                                              std::vector<double>& received_ms)
+    {
+        return _hw_monitor->send_batch(inputs, received_ms);
+    }
+
+    void ds5_device::start_fw_log_capture(size_t capacity)
+    {
+        _fw_logs.start(capacity);
+    }
+
+    void ds5_device::stop_fw_log_capture()
+    {
+        _fw_logs.stop();
+    }
+
+    std::vector<uint8_t> ds5_device::fetch_fw_logs(size_t max_count, std::chrono::milliseconds timeout)
+    {
+        return _fw_logs.fetch(max_count, timeout);
+    }
+
     void ds5_device::hardware_reset()
     {
         command cmd(ds::HWRST);
         _hw_monitor->send(cmd);
     }
 
-    class ds5_depth_sensor : public uvc_sensor, public video_sensor_interface, public depth_sensor
+    class ds5_depth_sensor : public uvc_sensor, public video_sensor_interface, public depth_sensor, public stereo_baseline_interface
     {
     public:
         explicit ds5_depth_sensor(ds5_device* owner,
@@ -146,6 +167,11 @@ namespace librealsense
 
         float get_depth_scale() const override { return _depth_units; }
 
+        float get_stereo_baseline_mm() const override
+        {
+            return std::fabs(ds::check_calib<ds::coefficients_table>(*_owner->_coefficients_table_raw)->baseline);
+        }
+
         void create_snapshot(std::shared_ptr<depth_sensor>& snapshot) const  override
         {
             snapshot = std::make_shared<depth_sensor_snapshot>(get_depth_scale());
@@ -237,8 +263,19 @@ namespace librealsense
 
     std::vector<uint8_t> ds5_device::get_raw_calibration_table(ds::calibration_table_id table_id) const
     {
-        command cmd(ds::GETINTCAL, table_id);
-        return _hw_monitor->send(cmd);
+        return get_cached_table(to_string() << "calibration_table_" << static_cast<int>(table_id), [this, table_id]()
+        {
+            command cmd(ds::GETINTCAL, table_id);
+            return _hw_monitor->send(cmd);
+        });
+    }
+
+    std::vector<uint8_t> ds5_device::get_cached_table(const std::string& table, std::function<std::vector<uint8_t>()> read) const
+    {
+        if (!supports_info(RS2_CAMERA_INFO_SERIAL_NUMBER))
+            return read();
+
+        return environment::get_instance().get_calibration_cache().get(get_info(RS2_CAMERA_INFO_SERIAL_NUMBER), _fw_version, table, read);
     }
 
     std::shared_ptr<uvc_sensor> ds5_device::create_depth_device(std::shared_ptr<context> ctx,
@@ -272,7 +309,8 @@ namespace librealsense
           _depth_stream(new stream(RS2_STREAM_DEPTH)),
           _left_ir_stream(new stream(RS2_STREAM_INFRARED, 1)),
           _right_ir_stream(new stream(RS2_STREAM_INFRARED, 2)),
-          _depth_device_idx(add_sensor(create_depth_device(ctx, group.uvc_devices)))
+          _depth_device_idx(add_sensor(create_depth_device(ctx, group.uvc_devices))),
+          _fw_logs([this]() { return _hw_monitor->send(command(ds::GLD, FW_LOG_READ_SIZE)); }, FW_LOG_ENTRY_SIZE)
     {
         init(ctx, group);
     }
@@ -385,8 +423,11 @@ namespace librealsense
         _coefficients_table_raw = [this]() { return get_raw_calibration_table(coefficients_table_id); };
 
         std::string device_name = (rs400_sku_names.end() != rs400_sku_names.find(group.uvc_devices.front().pid)) ? rs400_sku_names.at(group.uvc_devices.front().pid) : "RS4xx";
-        _fw_version = firmware_version(_hw_monitor->get_firmware_version_string(GVD, camera_fw_version_offset));
-        auto serial = _hw_monitor->get_module_serial_string(GVD, module_serial_offset);
+        //GVD is read once, the version, serial and lock state are parsed from the same buffer
+        std::vector<uint8_t> gvd_buff(HW_MONITOR_BUFFER_SIZE);
+        _hw_monitor->get_gvd(gvd_buff.size(), gvd_buff.data(), GVD);
+        _fw_version = firmware_version(hw_monitor::get_firmware_version_string(gvd_buff, camera_fw_version_offset));
+        auto serial = hw_monitor::get_module_serial_string(gvd_buff, module_serial_offset);
 
         auto& depth_ep = get_depth_sensor();
         auto advanced_mode = is_camera_in_advanced_mode();
@@ -402,7 +443,7 @@ namespace librealsense
         std::string is_camera_locked{ "" };
         if (_fw_version >= firmware_version("5.6.3.0"))
         {
-            auto is_locked = _hw_monitor->is_camera_locked(GVD, is_camera_locked_offset);
+            auto is_locked = hw_monitor::is_camera_locked(gvd_buff, is_camera_locked_offset);
             is_camera_locked = (is_locked) ? "YES" : "NO";
 
 #ifdef HWM_OVER_XU
@@ -448,12 +489,18 @@ namespace librealsense
 
             auto error_control = std::unique_ptr<uvc_xu_option<uint8_t>>(new uvc_xu_option<uint8_t>(depth_ep, depth_xu, DS5_ERROR_REPORTING, "Error reporting"));
 
+            // Polled every second after an error, backing off to every 16 seconds while there is none, unless the
+            // backend signals the changes of the control
+            auto error_events = [&depth_ep](std::function<void()> on_error)
+            {
+                return depth_ep.set_xu_change_callback(depth_xu, DS5_ERROR_REPORTING, std::move(on_error));
+            };
             _polling_error_handler = std::unique_ptr<polling_error_handler>(
-                new polling_error_handler(1000,
+                new polling_error_handler(1000, 16000,
                     std::move(error_control),
                     depth_ep.get_notifications_proccessor(),
-
-                    std::unique_ptr<notification_decoder>(new ds5_notification_decoder())));
+                    std::unique_ptr<notification_decoder>(new ds5_notification_decoder()),
+                    error_events));
 
             depth_ep.register_option(RS2_OPTION_ERROR_POLLING_ENABLED, std::make_shared<polling_errors_disable>(_polling_error_handler.get()));
 
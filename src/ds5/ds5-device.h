@@ -10,6 +10,7 @@
 #include "core/debug.h"
 #include "core/advanced_mode.h"
 #include "device.h"
+#include "fw-logs.h"
 
 namespace librealsense
 {
@@ -28,6 +29,11 @@ namespace librealsense
                    const platform::backend_device_group& group);
 
         std::vector<uint8_t> send_receive_raw_data(const std::vector<uint8_t>& input) override;
+        std::vector<std::vector<uint8_t>> send_receive_raw_data_batch(const std::vector<std::vector<uint8_t>>& inputs,
+                                                                      std::vector<double>& received_ms) override;
+        void start_fw_log_capture(size_t capacity) override;
+        void stop_fw_log_capture() override;
+        std::vector<uint8_t> fetch_fw_logs(size_t max_count, std::chrono::milliseconds timeout) override;
 
         void hardware_reset() override;
         void create_snapshot(std::shared_ptr<debug_interface>& snapshot) const override;
@@ -39,6 +45,9 @@ namespace librealsense
 
         std::vector<uint8_t> get_raw_calibration_table(ds::calibration_table_id table_id) const;
 
+        // Reads a calibration table through the calibration cache of the environment
+        std::vector<uint8_t> get_cached_table(const std::string& table, std::function<std::vector<uint8_t>()> read) const;
+
         bool is_camera_in_advanced_mode() const;
 
         void init(std::shared_ptr<context> ctx,
@@ -59,6 +68,9 @@ namespace librealsense
 
         std::unique_ptr<polling_error_handler> _polling_error_handler;
         std::shared_ptr<lazy<rs2_extrinsics>> _left_right_extrinsics;
+
+        // Last, so it stops reading before the rest of the device goes
+        fw_log_reader _fw_logs;
     };
 
     class ds5u_device : public ds5_device
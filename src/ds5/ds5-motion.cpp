@@ -154,16 +154,22 @@ namespace librealsense
     {
         const int offset = 0x84;
         const int size = 0x98;
-        command cmd(ds::MMER, offset, size);
-        return _hw_monitor->send(cmd);
+        return get_cached_table("fisheye_intrinsics", [this]()
+        {
+            command cmd(ds::MMER, offset, size);
+            return _hw_monitor->send(cmd);
+        });
     }
 
     ds::imu_calibration_table ds5_motion::get_motion_module_calibration_table() const
     {
         const int offset = 0x134;
         const int size = sizeof(ds::imu_calibration_table);
-        command cmd(ds::MMER, offset, size);
-        auto result = _hw_monitor->send(cmd);
+        auto result = get_cached_table("motion_module_calibration", [this]()
+        {
+            command cmd(ds::MMER, offset, size);
+            return _hw_monitor->send(cmd);
+        });
         if (result.size() < sizeof(ds::imu_calibration_table))
             throw std::runtime_error("Not enough data returned from the device!");
 
@@ -174,8 +180,11 @@ namespace librealsense
 
     std::vector<uint8_t> ds5_motion::get_raw_fisheye_extrinsics_table() const
     {
-        command cmd(ds::GET_EXTRINSICS);
-        return _hw_monitor->send(cmd);
+        return get_cached_table("fisheye_extrinsics", [this]()
+        {
+            command cmd(ds::GET_EXTRINSICS);
+            return _hw_monitor->send(cmd);
+        });
     }
 
     std::shared_ptr<hid_sensor> ds5_motion::create_hid_device(std::shared_ptr<context> ctx,
@@ -247,6 +256,10 @@ namespace librealsense
                                                                                         option_range{50, 60, 10, 60},
                                                                                         std::map<float, std::string>{{50.f, "50Hz"},
                                                                                                                      {60.f, "60Hz"}}));
+        uvc_ep->register_option(RS2_OPTION_AUTO_EXPOSURE_SAMPLE_STEP,
+                                std::make_shared<auto_exposure_step_option>(auto_exposure,
+                                                                            ae_state,
+                                                                            option_range{0, 16, 1, 0}));
 
 
         uvc_ep->register_option(RS2_OPTION_GAIN,
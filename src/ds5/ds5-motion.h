@@ -57,6 +57,9 @@ namespace librealsense
              {"gyro_3d",  {RS2_STREAM_GYRO,  1, 1, 1, 200,  RS2_FORMAT_MOTION_XYZ32F}},
              {"gyro_3d",  {RS2_STREAM_GYRO,  1, 1, 1, 400,  RS2_FORMAT_MOTION_XYZ32F}},
              {"gyro_3d",  {RS2_STREAM_GYRO,  1, 1, 1, 1000, RS2_FORMAT_MOTION_XYZ32F}},
+             {"gyro_3d",  {RS2_STREAM_GYRO,  1, 1, 1, 200,  RS2_FORMAT_MOTION_XYZ32F_BATCH}},
+             {"gyro_3d",  {RS2_STREAM_GYRO,  1, 1, 1, 400,  RS2_FORMAT_MOTION_XYZ32F_BATCH}},
+             {"gyro_3d",  {RS2_STREAM_GYRO,  1, 1, 1, 1000, RS2_FORMAT_MOTION_XYZ32F_BATCH}},
              {"accel_3d", {RS2_STREAM_ACCEL, 1, 1, 1, 125,  RS2_FORMAT_MOTION_RAW}},
              {"accel_3d", {RS2_STREAM_ACCEL, 1, 1, 1, 250,  RS2_FORMAT_MOTION_RAW}},
              {"accel_3d", {RS2_STREAM_ACCEL, 1, 1, 1, 500,  RS2_FORMAT_MOTION_RAW}},
@@ -65,8 +68,14 @@ namespace librealsense
              {"accel_3d", {RS2_STREAM_ACCEL, 1, 1, 1, 250,  RS2_FORMAT_MOTION_XYZ32F}},
              {"accel_3d", {RS2_STREAM_ACCEL, 1, 1, 1, 500,  RS2_FORMAT_MOTION_XYZ32F}},
              {"accel_3d", {RS2_STREAM_ACCEL, 1, 1, 1, 1000, RS2_FORMAT_MOTION_XYZ32F}},
+             {"accel_3d", {RS2_STREAM_ACCEL, 1, 1, 1, 125,  RS2_FORMAT_MOTION_XYZ32F_BATCH}},
+             {"accel_3d", {RS2_STREAM_ACCEL, 1, 1, 1, 250,  RS2_FORMAT_MOTION_XYZ32F_BATCH}},
+             {"accel_3d", {RS2_STREAM_ACCEL, 1, 1, 1, 500,  RS2_FORMAT_MOTION_XYZ32F_BATCH}},
+             {"accel_3d", {RS2_STREAM_ACCEL, 1, 1, 1, 1000, RS2_FORMAT_MOTION_XYZ32F_BATCH}},
              {"HID Sensor Class Device: Gyroscope",     { RS2_STREAM_GYRO,  1, 1, 1, 1000, RS2_FORMAT_MOTION_XYZ32F}} ,
+             {"HID Sensor Class Device: Gyroscope",     { RS2_STREAM_GYRO,  1, 1, 1, 1000, RS2_FORMAT_MOTION_XYZ32F_BATCH}},
              {"HID Sensor Class Device: Accelerometer", { RS2_STREAM_ACCEL, 1, 1, 1, 1000, RS2_FORMAT_MOTION_XYZ32F}},
+             {"HID Sensor Class Device: Accelerometer", { RS2_STREAM_ACCEL, 1, 1, 1, 1000, RS2_FORMAT_MOTION_XYZ32F_BATCH}},
              {"HID Sensor Class Device: Custom",        { RS2_STREAM_ACCEL, 1, 1, 1, 1000, RS2_FORMAT_MOTION_XYZ32F}}};
 
         std::map<rs2_stream, std::map<unsigned, unsigned>> fps_and_sampling_frequency_per_rs2_stream =
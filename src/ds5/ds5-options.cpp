@@ -183,10 +183,11 @@ namespace librealsense
         mm_ep->register_on_before_frame_callback(
                     [this](rs2_stream stream, frame_interface* fr, callback_invocation_holder callback)
         {
-            if (_is_enabled.load() && fr->get_stream()->get_format() == RS2_FORMAT_MOTION_XYZ32F)
-            {
-                auto xyz = (float*)(fr->get_frame_data());
+            if (!_is_enabled.load()) return;
 
+            auto format = fr->get_stream()->get_format();
+            auto correct = [&](float* xyz)
+            {
                 if (stream == RS2_STREAM_ACCEL)
                 {
                     for (int i = 0; i < 3; i++)
@@ -198,6 +199,18 @@ namespace librealsense
                     for (int i = 0; i < 3; i++)
                         xyz[i] = xyz[i] * _gyro.scale[i] - _gyro.bias[i];
                 }
+            };
+
+            if (format == RS2_FORMAT_MOTION_XYZ32F)
+            {
+                correct((float*)(fr->get_frame_data()));
+            }
+            else if (format == RS2_FORMAT_MOTION_XYZ32F_BATCH)
+            {
+                auto samples = (rs2_motion_sample*)(fr->get_frame_data());
+                auto count = fr->get_frame_data_size() / sizeof(rs2_motion_sample);
+                for (size_t i = 0; i < count; i++)
+                    correct(samples[i].xyz);
             }
         });
     }
@@ -326,6 +339,29 @@ namespace librealsense
         }
     }
 
+    auto_exposure_step_option::auto_exposure_step_option(std::shared_ptr<auto_exposure_mechanism> auto_exposure,
+                                                         std::shared_ptr<auto_exposure_state> auto_exposure_state,
+                                                         const option_range& opt_range)
+        : option_base(opt_range),
+          _auto_exposure_state(auto_exposure_state),
+          _auto_exposure(auto_exposure)
+    {}
+
+    void auto_exposure_step_option::set(float value)
+    {
+        if (!is_valid(value))
+            throw invalid_value_exception(to_string() << "set(auto_exposure_step_option) failed! Given value " << value << " is out of range.");
+
+        _auto_exposure_state->set_auto_exposure_sample_step(static_cast<uint32_t>(value));
+        _auto_exposure->update_auto_exposure_state(*_auto_exposure_state);
+        _recording_function(*this);
+    }
+
+    float auto_exposure_step_option::query() const
+    {
+        return static_cast<float>(_auto_exposure_state->get_auto_exposure_sample_step());
+    }
+
     ds::depth_table_control depth_scale_option::get_depth_table(ds::advanced_query_mode mode) const
     {
         command cmd(ds::GET_ADV);
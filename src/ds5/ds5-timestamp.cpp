@@ -15,16 +15,19 @@
 
 namespace librealsense
 {
+    static int get_pin_index(const request_mapping& mode)
+    {
+        return mode.pf->fourcc == 0x5a313620 ? 1 : 0; // Z16
+    }
+
     ds5_timestamp_reader_from_metadata::ds5_timestamp_reader_from_metadata(std::unique_ptr<frame_timestamp_reader> backup_timestamp_reader)
         :_backup_timestamp_reader(std::move(backup_timestamp_reader)), _has_metadata(pins), one_time_note(false)
     {
         reset();
     }
 
-    bool ds5_timestamp_reader_from_metadata::has_metadata(const request_mapping& mode, const void * metadata, size_t metadata_size)
+    bool ds5_timestamp_reader_from_metadata::has_metadata(const request_mapping& mode, const void * metadata, size_t metadata_size) const
     {
-        std::lock_guard<std::recursive_mutex> lock(_mtx);
-
         if(metadata == nullptr || metadata_size == 0)
         {
             return false;
@@ -40,42 +43,33 @@ namespace librealsense
         return false;
     }
 
-    rs2_time_t ds5_timestamp_reader_from_metadata::get_frame_timestamp(const request_mapping& mode, const platform::frame_object& fo)
+    // Once a pin delivered metadata it is taken to have it until the next reset
+    bool ds5_timestamp_reader_from_metadata::pin_has_metadata(const request_mapping& mode, const platform::frame_object& fo) const
     {
-        std::lock_guard<std::recursive_mutex> lock(_mtx);
-        auto pin_index = 0;
-        if (mode.pf->fourcc == 0x5a313620) // Z16
-            pin_index = 1;
-
-        if(!_has_metadata[pin_index])
-        {
-           _has_metadata[pin_index] = has_metadata(mode, fo.metadata, fo.metadata_size);
-        }
+        auto& pin_has_md = _has_metadata.get(get_pin_index(mode));
+        if (!pin_has_md)
+            pin_has_md = has_metadata(mode, fo.metadata, fo.metadata_size);
+        return pin_has_md;
+    }
 
+    rs2_time_t ds5_timestamp_reader_from_metadata::get_frame_timestamp(const request_mapping& mode, const platform::frame_object& fo)
+    {
         auto md = (librealsense::metadata_intel_basic*)(fo.metadata);
-        if(_has_metadata[pin_index] && md)
+        if(pin_has_metadata(mode, fo) && md)
         {
             return (double)(md->header.timestamp)*TIMESTAMP_USEC_TO_MSEC;
         }
         else
         {
-            if (!one_time_note)
-            {
+            if (!one_time_note.exchange(true))
                 LOG_WARNING("UVC metadata payloads not available. Please refer to installation chapter for details.");
-                one_time_note = true;
-            }
             return _backup_timestamp_reader->get_frame_timestamp(mode, fo);
         }
     }
 
     unsigned long long ds5_timestamp_reader_from_metadata::get_frame_counter(const request_mapping & mode, const platform::frame_object& fo) const
     {
-        std::lock_guard<std::recursive_mutex> lock(_mtx);
-        auto pin_index = 0;
-        if (mode.pf->fourcc == 0x5a313620) // Z16
-            pin_index = 1;
-
-        if(_has_metadata[pin_index] && fo.metadata_size > platform::uvc_header_size)
+        if(_has_metadata.get(get_pin_index(mode)) && fo.metadata_size > platform::uvc_header_size)
         {
             auto md = (librealsense::metadata_intel_basic*)(fo.metadata);
             if (md->capture_valid())
@@ -87,23 +81,34 @@ namespace librealsense
 
     void ds5_timestamp_reader_from_metadata::reset()
     {
-        std::lock_guard<std::recursive_mutex> lock(_mtx);
         one_time_note = false;
-        for (auto i = 0; i < pins; ++i)
-        {
-            _has_metadata[i] = false;
-        }
+        _has_metadata.reset();
     }
 
     rs2_timestamp_domain ds5_timestamp_reader_from_metadata::get_frame_timestamp_domain(const request_mapping & mode, const platform::frame_object& fo) const
     {
-        std::lock_guard<std::recursive_mutex> lock(_mtx);
-        auto pin_index = 0;
-        if (mode.pf->fourcc == 0x5a313620) // Z16
-            pin_index = 1;
+        return _has_metadata.get(get_pin_index(mode)) ? RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK :
+                                                        _backup_timestamp_reader->get_frame_timestamp_domain(mode,fo);
+    }
+
+    frame_timestamp ds5_timestamp_reader_from_metadata::read_frame_timestamp(const request_mapping& mode, const platform::frame_object& fo)
+    {
+        auto md = (librealsense::metadata_intel_basic*)(fo.metadata);
+        if (!pin_has_metadata(mode, fo) || !md)
+        {
+            if (!one_time_note.exchange(true))
+                LOG_WARNING("UVC metadata payloads not available. Please refer to installation chapter for details.");
+            return _backup_timestamp_reader->read_frame_timestamp(mode, fo);
+        }
 
-        return _has_metadata[pin_index] ? RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK :
-                                          _backup_timestamp_reader->get_frame_timestamp_domain(mode,fo);
+        frame_timestamp res;
+        res.timestamp = (double)(md->header.timestamp)*TIMESTAMP_USEC_TO_MSEC;
+        res.domain = RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK;
+        if (fo.metadata_size > platform::uvc_header_size && md->capture_valid())
+            res.counter = md->payload.frame_counter;
+        else
+            res.counter = _backup_timestamp_reader->get_frame_counter(mode, fo);
+        return res;
     }
 
     ds5_timestamp_reader::ds5_timestamp_reader(std::shared_ptr<platform::time_service> ts)
@@ -114,27 +119,17 @@ namespace librealsense
 
     void ds5_timestamp_reader::reset()
     {
-        std::lock_guard<std::recursive_mutex> lock(_mtx);
-        for (auto i = 0; i < pins; ++i)
-        {
-            counter[i] = 0;
-        }
+        counter.reset();
     }
 
     rs2_time_t ds5_timestamp_reader::get_frame_timestamp(const request_mapping& mode, const platform::frame_object& fo)
     {
-        std::lock_guard<std::recursive_mutex> lock(_mtx);
         return _ts->get_time();
     }
 
     unsigned long long ds5_timestamp_reader::get_frame_counter(const request_mapping & mode, const platform::frame_object& fo) const
     {
-        std::lock_guard<std::recursive_mutex> lock(_mtx);
-        auto pin_index = 0;
-        if (mode.pf->fourcc == 0x5a313620) // Z16
-            pin_index = 1;
-
-        return ++counter[pin_index];
+        return ++counter.get(get_pin_index(mode));
     }
 
     rs2_timestamp_domain ds5_timestamp_reader::get_frame_timestamp_domain(const request_mapping & mode, const platform::frame_object& fo) const
@@ -143,36 +138,27 @@ namespace librealsense
     }
 
     ds5_iio_hid_timestamp_reader::ds5_iio_hid_timestamp_reader()
+        : started(false), counter(sensors)
     {
-        counter.resize(sensors);
         reset();
     }
 
     void ds5_iio_hid_timestamp_reader::reset()
     {
-        std::lock_guard<std::recursive_mutex> lock(_mtx);
         started = false;
-        for (auto i = 0; i < sensors; ++i)
-        {
-            counter[i] = 0;
-        }
+        counter.reset();
     }
 
     rs2_time_t ds5_iio_hid_timestamp_reader::get_frame_timestamp(const request_mapping& mode, const platform::frame_object& fo)
     {
-        std::lock_guard<std::recursive_mutex> lock(_mtx);
-
         if(has_metadata(mode, fo.metadata, fo.metadata_size))
         {
             auto timestamp = *((uint64_t*)((const uint8_t*)fo.metadata));
             return static_cast<rs2_time_t>(timestamp) * TIMESTAMP_USEC_TO_MSEC;
         }
 
-        if (!started)
-        {
+        if (!started.exchange(true))
             LOG_WARNING("HID timestamp not found! please apply HID patch.");
-            started = true;
-        }
 
         return std::chrono::duration<rs2_time_t, std::milli>(std::chrono::system_clock::now().time_since_epoch()).count();
     }
@@ -188,13 +174,12 @@ namespace librealsense
 
     unsigned long long ds5_iio_hid_timestamp_reader::get_frame_counter(const request_mapping & mode, const platform::frame_object& fo) const
     {
-        std::lock_guard<std::recursive_mutex> lock(_mtx);
         if (nullptr == mode.pf) return 0;                   // Windows support is limited
         int index = 0;
         if (mode.pf->fourcc == 'GYRO')
             index = 1;
 
-        return ++counter[index];
+        return ++counter.get(index);
     }
 
     rs2_timestamp_domain ds5_iio_hid_timestamp_reader::get_frame_timestamp_domain(const request_mapping & mode, const platform::frame_object& fo) const
@@ -207,23 +192,18 @@ namespace librealsense
     }
 
     ds5_custom_hid_timestamp_reader::ds5_custom_hid_timestamp_reader()
+        : counter(sensors)
     {
-        counter.resize(sensors);
         reset();
     }
 
     void ds5_custom_hid_timestamp_reader::reset()
     {
-        std::lock_guard<std::recursive_mutex> lock(_mtx);
-        for (auto i = 0; i < sensors; ++i)
-        {
-            counter[i] = 0;
-        }
+        counter.reset();
     }
 
     rs2_time_t ds5_custom_hid_timestamp_reader::get_frame_timestamp(const request_mapping& /*mode*/, const platform::frame_object& fo)
     {
-        std::lock_guard<std::recursive_mutex> lock(_mtx);
         static const uint8_t timestamp_offset = 17;
 
         auto timestamp = *((uint64_t*)((const uint8_t*)fo.pixels + timestamp_offset));
@@ -237,8 +217,8 @@ namespace librealsense
 
     unsigned long long ds5_custom_hid_timestamp_reader::get_frame_counter(const request_mapping & mode, const platform::frame_object& fo) const
     {
-        std::lock_guard<std::recursive_mutex> lock(_mtx);
-        return ++counter.front();
+        // The custom sensors all report on the same thread, so they share the first counter
+        return ++counter.get(0);
     }
 
     rs2_timestamp_domain ds5_custom_hid_timestamp_reader::get_frame_timestamp_domain(const request_mapping & /*mode*/, const platform::frame_object& /*fo*/) const
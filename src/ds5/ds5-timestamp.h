@@ -10,18 +10,20 @@
 
 namespace librealsense
 {
+    // Each reader keeps its state per stream, touched only by the capture thread of the stream
     class ds5_timestamp_reader_from_metadata : public frame_timestamp_reader
     {
        std::unique_ptr<frame_timestamp_reader> _backup_timestamp_reader;
        static const int pins = 2;
-       std::vector<std::atomic<bool>> _has_metadata;
-       bool one_time_note;
-       mutable std::recursive_mutex _mtx;
+       per_stream_state<bool> _has_metadata;
+       std::atomic<bool> one_time_note;
+
+       bool pin_has_metadata(const request_mapping& mode, const platform::frame_object& fo) const;
 
     public:
         ds5_timestamp_reader_from_metadata(std::unique_ptr<frame_timestamp_reader> backup_timestamp_reader);
 
-        bool has_metadata(const request_mapping& mode, const void * metadata, size_t metadata_size);
+        bool has_metadata(const request_mapping& mode, const void * metadata, size_t metadata_size) const;
 
         rs2_time_t get_frame_timestamp(const request_mapping& mode, const platform::frame_object& fo) override;
 
@@ -30,14 +32,15 @@ namespace librealsense
         void reset() override;
 
         rs2_timestamp_domain get_frame_timestamp_domain(const request_mapping & mode, const platform::frame_object& fo) const override;
+
+        frame_timestamp read_frame_timestamp(const request_mapping& mode, const platform::frame_object& fo) override;
     };
 
     class ds5_timestamp_reader : public frame_timestamp_reader
     {
         static const int pins = 2;
-        mutable std::vector<int64_t> counter;
+        per_stream_state<int64_t> counter;
         std::shared_ptr<platform::time_service> _ts;
-        mutable std::recursive_mutex _mtx;
     public:
         ds5_timestamp_reader(std::shared_ptr<platform::time_service> ts);
 
@@ -53,9 +56,8 @@ namespace librealsense
     class ds5_iio_hid_timestamp_reader : public frame_timestamp_reader
     {
         static const int sensors = 2;
-        bool started;
-        mutable std::vector<int64_t> counter;
-        mutable std::recursive_mutex _mtx;
+        std::atomic<bool> started;
+        per_stream_state<int64_t> counter;
     public:
         ds5_iio_hid_timestamp_reader();
 
@@ -74,8 +76,7 @@ namespace librealsense
     {
         static const int sensors = 4; // TODO: implement frame-counter for each GPIO or
                                       //       reading counter field report
-        mutable std::vector<int64_t> counter;
-        mutable std::recursive_mutex _mtx;
+        per_stream_state<int64_t> counter;
     public:
         ds5_custom_hid_timestamp_reader();
 
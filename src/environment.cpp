@@ -3,10 +3,13 @@
 
 #include "environment.h"
 
+#include <algorithm>
+#include <cstdlib>
+
 namespace librealsense
 {
     extrinsics_graph::extrinsics_graph()
-        : _locks_count(0)
+        : _locks_count(0), _version(0), _next_id(1)
     {
         _id = std::make_shared<lazy<rs2_extrinsics>>([]()
         {
@@ -32,17 +35,22 @@ namespace librealsense
         // First, trim any dead stream, to make sure we are not keep gaining memory
         cleanup_extrinsics();
 
-        // Second, register new extrinsics
-        auto from_idx = find_stream_profile(from);
-        // If this is a new index, add it to the map preemptively,
-        // This way find on to will be able to return another new index
-        if (_extrinsics.find(from_idx) == _extrinsics.end())
-            _extrinsics.insert({from_idx, {}});
-
-        auto to_idx = find_stream_profile(to);
+        // Second, register new extrinsics, joining the components of the two streams
+        auto&& from_node = add_node(from);
+        auto&& to_node = add_node(to);
+        if (from_node.owner != to_node.owner)
+        {
+            if (from_node.owner->streams.size() < to_node.owner->streams.size())
+                merge(to_node.owner, from_node.owner);
+            else
+                merge(from_node.owner, to_node.owner);
+        }
 
-        _extrinsics[from_idx][to_idx] = extr;
-        _extrinsics[to_idx][from_idx] = std::shared_ptr<lazy<rs2_extrinsics>>(nullptr);
+        auto c = from_node.owner;
+        std::lock_guard<std::mutex> component_lock(c->mutex);
+        c->extrinsics[from_node.id][to_node.id] = extr;
+        c->extrinsics[to_node.id][from_node.id] = std::shared_ptr<lazy<rs2_extrinsics>>(nullptr);
+        _version.fetch_add(1);
     }
 
     void extrinsics_graph::cleanup_extrinsics()
@@ -51,71 +59,184 @@ namespace librealsense
 
         auto counter = 0;
         auto dead_counter = 0;
-        for (auto&& kvp : _streams)
+        for (auto it = _nodes.begin(); it != _nodes.end();)
         {
-            if (!kvp.second.lock())
+            if (it->second.stream.lock())
             {
-                auto dead_id = kvp.first;
-                for (auto&& edge : _extrinsics[dead_id])
-                {
-                    if(edge.first == dead_id)
-                    {
-                        continue;
-                    }
-                    // First, delete any extrinsics going into the stream
-                    _extrinsics[edge.first].erase(dead_id);
-                    counter += 2;
-                }
-                // Then delete all extrinsics going out of this stream
-                _extrinsics.erase(dead_id);
-                dead_counter++;
+                ++it;
+                continue;
             }
+
+            counter += remove_edges(it->second);
+            it = _nodes.erase(it);
+            dead_counter++;
         }
         if (dead_counter)
-        LOG_INFO("Found " << dead_counter << " unreachable streams, " << counter << " extrinsics deleted");
+        {
+            _version.fetch_add(1);
+            LOG_INFO("Found " << dead_counter << " unreachable streams, " << counter << " extrinsics deleted");
+        }
     }
 
-    int extrinsics_graph::find_stream_profile(const stream_interface& p)
+    int extrinsics_graph::remove_edges(const node& n)
     {
-        auto sp = p.shared_from_this();
-        auto max = 0;
-        for (auto&& kvp : _streams)
+        auto counter = 0;
+        auto dead_id = n.id;
+        auto&& c = n.owner;
+        std::lock_guard<std::mutex> lock(c->mutex);
+        for (auto&& edge : c->extrinsics[dead_id])
         {
-            max = std::max(max, kvp.first);
-            if (kvp.second.lock().get() == sp.get())
-                return kvp.first;
+            if(edge.first == dead_id)
+            {
+                continue;
+            }
+            // First, delete any extrinsics going into the stream
+            c->extrinsics[edge.first].erase(dead_id);
+            counter += 2;
         }
-        _streams[max + 1] = sp;
-        return max + 1;
+        // Then delete all extrinsics going out of this stream
+        c->extrinsics.erase(dead_id);
+        c->streams.erase(dead_id);
+        return counter;
+    }
 
+    extrinsics_graph::node* extrinsics_graph::find_node(const stream_interface& p)
+    {
+        auto it = _nodes.find(&p);
+        // A stream created where an expired one was is a different stream
+        if (it == _nodes.end() || it->second.stream.lock().get() != &p)
+            return nullptr;
+        return &it->second;
     }
 
-    bool extrinsics_graph::try_fetch_extrinsics(const stream_interface& from, const stream_interface& to, rs2_extrinsics* extr)
+    extrinsics_graph::node& extrinsics_graph::add_node(const stream_interface& p)
     {
-        std::lock_guard<std::mutex> lock(_mutex);
-        cleanup_extrinsics();
-        auto from_idx = find_stream_profile(from);
-        auto to_idx = find_stream_profile(to);
+        if (auto n = find_node(p))
+            return *n;
+
+        // The stream that was at the same address is gone even while cleanup is held off
+        auto it = _nodes.find(&p);
+        if (it != _nodes.end())
+            remove_edges(it->second);
+
+        auto c = std::make_shared<component>();
+        node n{ _next_id++, p.shared_from_this(), c };
+        c->streams[n.id] = n.stream;
+        return _nodes[&p] = n;
+    }
+
+    void extrinsics_graph::merge(std::shared_ptr<component> into, std::shared_ptr<component> from)
+    {
+        std::lock(into->mutex, from->mutex);
+        std::lock_guard<std::mutex> into_lock(into->mutex, std::adopt_lock);
+        std::lock_guard<std::mutex> from_lock(from->mutex, std::adopt_lock);
 
-        if (from_idx == to_idx)
+        for (auto&& kvp : from->streams)
         {
-            *extr = identity_matrix();
+            into->streams[kvp.first] = kvp.second;
+            if (auto s = kvp.second.lock())
+            {
+                auto it = _nodes.find(s.get());
+                if (it != _nodes.end() && it->second.owner == from)
+                    it->second.owner = into;
+            }
+        }
+        for (auto&& kvp : from->extrinsics)
+            into->extrinsics[kvp.first].insert(kvp.second.begin(), kvp.second.end());
+
+        from->streams.clear();
+        from->extrinsics.clear();
+        from->merged = true;
+    }
+
+    bool extrinsics_graph::try_fetch_extrinsics(const stream_interface& from, const stream_interface& to, rs2_extrinsics* extr)
+    {
+        if (try_fetch_resolved(from, to, extr))
             return true;
+
+        int version, from_idx, to_idx;
+        std::vector<edge> path;
+        while (true)
+        {
+            std::shared_ptr<component> c;
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                cleanup_extrinsics();
+                version = _version.load();
+
+                auto from_node = find_node(from);
+                auto to_node = find_node(to);
+                if (&from != &to && (!from_node || !to_node || from_node->owner != to_node->owner))
+                    return false; // Streams of different components are not connected
+                if (from_node)
+                {
+                    from_idx = from_node->id;
+                    to_idx = to_node->id;
+                    c = from_node->owner;
+                }
+            }
+
+            if (&from == &to)
+            {
+                *extr = identity_matrix();
+                break;
+            }
+
+            // The search evaluates the extrinsics it finds, holding the lock of the component only
+            std::lock_guard<std::mutex> lock(c->mutex);
+            if (c->merged)
+                continue; // Joined with another component in the meantime, look the streams up again
+
+            std::set<int> visited;
+            if (!try_fetch_extrinsics(*c, from_idx, to_idx, visited, extr, path))
+                return false;
+            break;
         }
 
-        std::set<int> visited;
-        return try_fetch_extrinsics(from_idx, to_idx, visited, extr);
+        // Adding a result replaces the cache with a copy, lookups of the previous cache are not blocked
+        auto cache = std::make_shared<resolved_cache>();
+        auto current = std::atomic_load(&_resolved);
+        if (current && current->version == version)
+            cache->entries = current->entries;
+        cache->version = version;
+        cache->entries[std::make_pair(&from, &to)] = { from.shared_from_this(), to.shared_from_this(), path, *extr };
+        std::atomic_store(&_resolved, std::shared_ptr<const resolved_cache>(cache));
+        return true;
     }
 
-    bool extrinsics_graph::try_fetch_extrinsics(int from, int to, std::set<int>& visited, rs2_extrinsics* extr)
+    bool extrinsics_graph::try_fetch_resolved(const stream_interface& from, const stream_interface& to, rs2_extrinsics* extr) const
+    {
+        auto cache = std::atomic_load(&_resolved);
+        if (!cache || cache->version != _version.load())
+            return false;
+
+        auto it = cache->entries.find(std::make_pair(&from, &to));
+        if (it == cache->entries.end())
+            return false;
+
+        // A stream created where an expired one was is a different stream
+        auto&& resolved = it->second;
+        if (resolved.from.lock().get() != &from || resolved.to.lock().get() != &to)
+            return false;
+        for (auto&& e : resolved.path)
+        {
+            if (e.expired())
+                return false;
+        }
+
+        *extr = resolved.extr;
+        return true;
+    }
+
+    bool extrinsics_graph::try_fetch_extrinsics(const component& c, int from, int to, std::set<int>& visited, rs2_extrinsics* extr, std::vector<edge>& path)
     {
         if (visited.count(from)) return false;
 
-        auto it = _extrinsics.find(from);
-        if (it != _extrinsics.end())
+        auto it = c.extrinsics.find(from);
+        if (it != c.extrinsics.end())
         {
-            auto back_edge = fetch_edge(to, from);
-            auto fwd_edge = fetch_edge(from, to);
+            auto back_edge = fetch_edge(c, to, from);
+            auto fwd_edge = fetch_edge(c, from, to);
 
             // Make sure both parts of the edge are still available
             if (fwd_edge.get() || back_edge.get())
@@ -125,6 +246,7 @@ namespace librealsense
                 else
                     *extr = inverse(back_edge->operator*());
 
+                path.push_back(fwd_edge.get() ? fwd_edge : back_edge);
                 return true;
             }
             else
@@ -136,12 +258,13 @@ namespace librealsense
                     auto way = kvp.second;
 
                     // Lock down the edge in both directions to ensure we can evaluate the extrinsics
-                    back_edge = fetch_edge(new_from, from);
-                    fwd_edge = fetch_edge(from, new_from);
+                    back_edge = fetch_edge(c, new_from, from);
+                    fwd_edge = fetch_edge(c, from, new_from);
 
                     if ((back_edge.get() || fwd_edge.get()) &&
-                        try_fetch_extrinsics(new_from, to, visited, extr))
+                        try_fetch_extrinsics(c, new_from, to, visited, extr, path))
                     {
+                        path.push_back(fwd_edge.get() ? fwd_edge : back_edge);
                         const auto local = [&]() {
                             if (fwd_edge.get())
                                 return fwd_edge->operator*(); // Evaluate the expression
@@ -159,10 +282,10 @@ namespace librealsense
         return false;
     }
 
-    std::shared_ptr<lazy<rs2_extrinsics>> extrinsics_graph::fetch_edge(int from, int to)
+    std::shared_ptr<lazy<rs2_extrinsics>> extrinsics_graph::fetch_edge(const component& c, int from, int to)
     {
-        auto it = _extrinsics.find(from);
-        if (it != _extrinsics.end())
+        auto it = c.extrinsics.find(from);
+        if (it != c.extrinsics.end())
         {
             auto it2 = it->second.find(to);
             if (it2 != it->second.end())
@@ -186,13 +309,43 @@ namespace librealsense
         return _extrinsics;
     }
 
+    // Read on the frame paths while a context may replace it
     void environment::set_time_service(std::shared_ptr<platform::time_service> ts)
     {
-        _ts = ts;
+        std::atomic_store(&_ts, ts);
     }
 
     std::shared_ptr<platform::time_service> environment::get_time_service()
     {
-        return _ts;
+        return std::atomic_load(&_ts);
+    }
+
+    worker_pool& environment::get_worker_pool()
+    {
+        std::call_once(_worker_pool_created, [this]()
+        {
+            // The thread submitting work takes part in it, one worker less keeps every core busy
+            // Defining LRS_WORKER_THREADS in the environment overrides the number of workers
+            auto cores = std::thread::hardware_concurrency();
+            unsigned int workers = cores > 1 ? cores - 1 : 1;
+            if (auto value = getenv("LRS_WORKER_THREADS"))
+                workers = static_cast<unsigned int>(std::max(atoi(value), 1));
+            _worker_pool.reset(new worker_pool(workers));
+        });
+        return *_worker_pool;
+    }
+
+    worker_pool& environment::get_playback_pool()
+    {
+        std::call_once(_playback_pool_created, [this]()
+        {
+            // Reading is mostly waiting on the disk, a few threads serve many files without them competing for it
+            // Defining LRS_PLAYBACK_THREADS in the environment overrides the number of threads
+            unsigned int threads = 2;
+            if (auto value = getenv("LRS_PLAYBACK_THREADS"))
+                threads = static_cast<unsigned int>(std::max(atoi(value), 1));
+            _playback_pool.reset(new worker_pool(threads, "rs-playback-io", RS2_THREAD_CLASS_IO));
+        });
+        return *_playback_pool;
     }
 }
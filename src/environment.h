@@ -4,11 +4,14 @@
 #pragma once
 #include "core/streaming.h"
 #include "types.h"
+#include "calibration-cache.h"
 #include <memory>
 #include <mutex>
 
 namespace librealsense
 {
+    // Streams are kept in components of the streams connected by extrinsics. Streams of different cameras
+    // never share a component, so each camera has its own lock and searches visit only its own streams
     class extrinsics_graph
     {
     public:
@@ -23,7 +26,10 @@ namespace librealsense
             extrinsics_lock(extrinsics_graph& owner)
                 : _owner(owner)
             {
-                _owner.cleanup_extrinsics();
+                {
+                    std::lock_guard<std::mutex> lock(_owner._mutex);
+                    _owner.cleanup_extrinsics();
+                }
                 _owner._locks_count.fetch_add(1);
             }
 
@@ -43,16 +49,55 @@ namespace librealsense
         extrinsics_lock lock();
 
     private:
-        std::shared_ptr<lazy<rs2_extrinsics>> fetch_edge(int from, int to);
-        bool try_fetch_extrinsics(int from, int to, std::set<int>& visited, rs2_extrinsics* extr);
+        using edge = std::weak_ptr<lazy<rs2_extrinsics>>;
+
+        struct component
+        {
+            std::mutex mutex;
+            bool merged = false;    // Its streams were moved to another component
+            std::map<int, std::map<int, edge>> extrinsics;
+            std::map<int, std::weak_ptr<const stream_interface>> streams;
+        };
+
+        struct node
+        {
+            int id;
+            std::weak_ptr<const stream_interface> stream;
+            std::shared_ptr<component> owner;
+        };
+
+        // Extrinsics resolved between two streams, valid while the streams and the edges of the path are alive
+        struct resolved_extrinsics
+        {
+            std::weak_ptr<const stream_interface> from;
+            std::weak_ptr<const stream_interface> to;
+            std::vector<edge> path;
+            rs2_extrinsics extr;
+        };
+
+        // Replaced as a whole, so it is read without taking the mutex. Dropped when the graph changes
+        struct resolved_cache
+        {
+            int version;
+            std::map<std::pair<const stream_interface*, const stream_interface*>, resolved_extrinsics> entries;
+        };
+
+        bool try_fetch_resolved(const stream_interface& from, const stream_interface& to, rs2_extrinsics* extr) const;
+        static std::shared_ptr<lazy<rs2_extrinsics>> fetch_edge(const component& c, int from, int to);
+        static bool try_fetch_extrinsics(const component& c, int from, int to, std::set<int>& visited, rs2_extrinsics* extr, std::vector<edge>& path);
         void cleanup_extrinsics();
-        int find_stream_profile(const stream_interface& p);
+        int remove_edges(const node& n);
+        node* find_node(const stream_interface& p);
+        node& add_node(const stream_interface& p);
+        void merge(std::shared_ptr<component> into, std::shared_ptr<component> from);
 
         std::atomic<int> _locks_count;
-        std::mutex _mutex;
-        std::map<int, std::map<int, std::weak_ptr<lazy<rs2_extrinsics>>>> _extrinsics;
+        std::atomic<int> _version;
+        std::shared_ptr<const resolved_cache> _resolved;
+        std::mutex _mutex;                                    // Guards the nodes, taken before the mutex of a component
+        std::map<const stream_interface*, node> _nodes;
+        int _next_id;
         std::shared_ptr<lazy<rs2_extrinsics>> _id;
-        std::map<int, std::weak_ptr<const stream_interface>> _streams;
 
     };
 
@@ -69,6 +114,18 @@ namespace librealsense
         void set_time_service(std::shared_ptr<platform::time_service> ts);
         std::shared_ptr<platform::time_service> get_time_service();
 
+        // Threads shared by all sensors for splitting frame processing, created on first use
+        worker_pool& get_worker_pool();
+
+        // Threads shared by all playback devices for reading their files ahead, created on first use
+        worker_pool& get_playback_pool();
+
+        // Frames are timestamped at every rs2_frame_latency_stage only while enabled
+        void set_latency_instrumentation(bool enable) { _latency_instrumentation = enable; }
+        bool is_latency_instrumentation_enabled() const { return _latency_instrumentation.load(std::memory_order_relaxed); }
+
+        calibration_cache& get_calibration_cache() { return _calibration_cache; }
+
         environment(const environment&) = delete;
         environment(const environment&&) = delete;
         environment operator=(const environment&) = delete;
@@ -78,8 +135,14 @@ namespace librealsense
         extrinsics_graph _extrinsics;
         std::atomic<int> _stream_id;
         std::shared_ptr<platform::time_service> _ts;
-
-        environment(){_stream_id = 0;}
+        std::unique_ptr<worker_pool> _worker_pool;
+        std::once_flag _worker_pool_created;
+        std::unique_ptr<worker_pool> _playback_pool;
+        std::once_flag _playback_pool_created;
+        std::atomic<bool> _latency_instrumentation;
+        calibration_cache _calibration_cache;
+
+        environment() : _latency_instrumentation(false) {_stream_id = 0;}
 
     };
 }
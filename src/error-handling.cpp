@@ -1,18 +1,24 @@
 #include "error-handling.h"
+#include "metrics.h"
 
+#include <algorithm>
 #include <memory>
 
 
 namespace librealsense
 {
-    polling_error_handler::polling_error_handler(unsigned int poll_intervals_ms, std::unique_ptr<option> option,
-        std::shared_ptr <notifications_proccessor> proccessor, std::unique_ptr<notification_decoder> decoder)
+    polling_error_handler::polling_error_handler(unsigned int poll_intervals_ms, unsigned int max_poll_intervals_ms, std::unique_ptr<option> option,
+        std::shared_ptr <notifications_proccessor> proccessor, std::unique_ptr<notification_decoder> decoder,
+        error_event_source events)
         :_poll_intervals_ms(poll_intervals_ms),
+        _max_poll_intervals_ms(std::max(poll_intervals_ms, max_poll_intervals_ms)),
+        _current_interval_ms(poll_intervals_ms),
+        _option(std::move(option)),
+        _events(std::move(events)),
         _active_object([this](dispatcher::cancellable_timer cancellable_timer)
         {
             polling(cancellable_timer);
-        }),
-        _option(std::move(option)),
+        }, "rs-error-poll"),
         _notifications_proccessor(proccessor),
         _decoder(std::move(decoder))
     {
@@ -25,56 +31,117 @@ namespace librealsense
 
     void polling_error_handler::start()
     {
+        {
+            std::lock_guard<std::mutex> lock(_wait_mutex);
+            _stopping = false;
+            _signaled = false;
+            _current_interval_ms = _poll_intervals_ms;
+        }
+
+        _event_driven = false;
+        if (_events)
+        {
+            try
+            {
+                _event_driven = _events([this]() { signal(); });
+            }
+            catch (const std::exception& ex)
+            {
+                LOG_WARNING("Error events are not available, polling instead: " << ex.what());
+            }
+        }
         _active_object.start();
     }
+
     void polling_error_handler::stop()
     {
+        if (_event_driven)
+        {
+            try { _events(nullptr); }
+            catch (...) {}
+            _event_driven = false;
+        }
+        {
+            std::lock_guard<std::mutex> lock(_wait_mutex);
+            _stopping = true;
+        }
+        _wait_cv.notify_all();
         _active_object.stop();
     }
 
+    void polling_error_handler::signal()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_wait_mutex);
+            _signaled = true;
+        }
+        _wait_cv.notify_all();
+    }
+
     void polling_error_handler::polling(dispatcher::cancellable_timer cancellable_timer)
     {
-         if (cancellable_timer.try_sleep(_poll_intervals_ms))
-         {
-             auto val = 0;
-             try
-             {
-                 val = static_cast<int>(_option->query());
+        // With error events the control is read as soon as the device signals it, the polls only cover lost signals
+        auto interval = _event_driven ? _max_poll_intervals_ms : _current_interval_ms;
+        bool signaled = false;
+        {
+            std::unique_lock<std::mutex> lock(_wait_mutex);
+            _wait_cv.wait_for(lock, std::chrono::milliseconds(interval), [this]() { return _signaled || _stopping; });
+            if (_stopping)
+            {
+                LOG_DEBUG("Notification polling loop is being shut-down");
+                return;
+            }
+            std::swap(signaled, _signaled);
+        }
+
+        // Errors come in bursts, so the polls back off only while the device stays quiet
+        if (read_errors() || signaled)
+            _current_interval_ms = _poll_intervals_ms;
+        else
+            _current_interval_ms = std::min(_current_interval_ms * 2, _max_poll_intervals_ms);
+    }
+
+    bool polling_error_handler::read_errors()
+    {
+        auto val = 0;
+        try
+        {
+            // Read through the option cache the error would be reported again, and the control never seen cleared
+            val = static_cast<int>(_option->query_from_device());
 
-                 if (val != 0 && !_silenced)
-                 {
-                     auto n = _decoder->decode(val);
-                     auto strong = _notifications_proccessor.lock();
-                     if (strong) strong->raise_notification(n);
+            if (val != 0 && !_silenced)
+            {
+                auto n = _decoder->decode(val);
+                get_counter("rs_device_errors_total", "Errors the devices reported through their error polling",
+                            { { "category", get_string(n.category) }, { "error", n.description } }).add();
+                auto strong = _notifications_proccessor.lock();
+                if (strong) strong->raise_notification(n);
 
-                     val = static_cast<int>(_option->query());
-                     if (val != 0)
-                     {
-                         // Reading from last-error control is supposed to set it to zero in the firmware
-                         // If this is not happening there is some issue
-                         notification postcondition_failed{
-                             RS2_NOTIFICATION_CATEGORY_HARDWARE_ERROR,
-                             0,
-                             RS2_LOG_SEVERITY_WARN,
-                             "Error polling loop is not behaving as expected!\nThis can indicate an issue with camera firmware or the underlying OS..."
-                         };
-                         if (strong) strong->raise_notification(postcondition_failed);
-                         _silenced = true;
-                     }
-                 }
-             }
-             catch (const std::exception& ex)
-             {
-                 LOG_ERROR("Error during polling error handler: " << ex.what());
-             }
-             catch (...)
-             {
-                 LOG_ERROR("Unknown error during polling error handler!");
-             }
-         }
-         else
-         {
-             LOG_DEBUG("Notification polling loop is being shut-down");
-         }
+                val = static_cast<int>(_option->query_from_device());
+                if (val != 0)
+                {
+                    // Reading from last-error control is supposed to set it to zero in the firmware
+                    // If this is not happening there is some issue
+                    notification postcondition_failed{
+                        RS2_NOTIFICATION_CATEGORY_HARDWARE_ERROR,
+                        0,
+                        RS2_LOG_SEVERITY_WARN,
+                        "Error polling loop is not behaving as expected!\nThis can indicate an issue with camera firmware or the underlying OS..."
+                    };
+                    if (strong) strong->raise_notification(postcondition_failed);
+                    _silenced = true;
+                }
+                return true;
+            }
+        }
+        catch (const std::exception& ex)
+        {
+            LOG_ERROR("Error during polling error handler: " << ex.what());
+        }
+        catch (...)
+        {
+            LOG_ERROR("Unknown error during polling error handler!");
+        }
+        return false;
     }
 }
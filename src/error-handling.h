@@ -6,11 +6,18 @@
 
 namespace librealsense
 {
+    // Subscribes the callback to the error signals of the device, or unsubscribes on a null callback
+    // Returns false when the device or backend has no such signal, the errors are then polled
+    typedef std::function<bool(std::function<void()> on_error)> error_event_source;
+
     class polling_error_handler
     {
     public:
-        polling_error_handler(unsigned int poll_intervals_ms, std::unique_ptr<option> option,
-            std::shared_ptr<notifications_proccessor> proccessor, std::unique_ptr<notification_decoder> decoder);
+        // Polls every poll_intervals_ms after an error, backing off up to max_poll_intervals_ms while there is none
+        // When the event source signals errors, the polls only read the control on a signal, or at the longest interval
+        polling_error_handler(unsigned int poll_intervals_ms, unsigned int max_poll_intervals_ms, std::unique_ptr<option> option,
+            std::shared_ptr<notifications_proccessor> proccessor, std::unique_ptr<notification_decoder> decoder,
+            error_event_source events = nullptr);
         ~polling_error_handler();
 
         void start();
@@ -18,10 +25,22 @@ namespace librealsense
 
     private:
         void polling(dispatcher::cancellable_timer cancellable_timer);
+        bool read_errors();
+        void signal();
 
         unsigned int _poll_intervals_ms;
+        unsigned int _max_poll_intervals_ms;
+        unsigned int _current_interval_ms;
         bool _silenced = false;
         std::unique_ptr<option> _option;
+        error_event_source _events;
+        bool _event_driven = false;
+
+        std::mutex _wait_mutex;
+        std::condition_variable _wait_cv;
+        bool _signaled = false;
+        bool _stopping = false;
+
         active_object<> _active_object;
         std::weak_ptr<notifications_proccessor> _notifications_proccessor;
         std::unique_ptr<notification_decoder> _decoder;
@@ -0,0 +1,106 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#include "frame-broadcaster.h"
+
+#include <algorithm>
+
+namespace librealsense
+{
+    frame_subscription::frame_subscription(size_t capacity, rs2_queue_policy policy)
+        : _capacity(capacity), _policy(policy), _paused(false), _dropped(0)
+    {
+    }
+
+    void frame_subscription::set_paused(bool paused)
+    {
+        std::deque<frame_holder> released;
+        std::lock_guard<std::mutex> lock(_mutex);
+        _paused = paused;
+        if (paused) std::swap(released, _queue);
+    }
+
+    bool frame_subscription::is_paused() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _paused;
+    }
+
+    bool frame_subscription::dequeue(frame_holder* frame, unsigned int timeout_ms)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        if (!_cv.wait_for(lock, std::chrono::milliseconds(timeout_ms), [this]() { return !_queue.empty(); }))
+            return false;
+        *frame = std::move(_queue.front());
+        _queue.pop_front();
+        return true;
+    }
+
+    bool frame_subscription::try_dequeue(frame_holder* frame)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_queue.empty()) return false;
+        *frame = std::move(_queue.front());
+        _queue.pop_front();
+        return true;
+    }
+
+    unsigned long long frame_subscription::get_dropped_count() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _dropped;
+    }
+
+    // The frames dropped, like the frame itself, are released after the lock
+    void frame_subscription::push(frame_holder frame)
+    {
+        frame_holder dropped;
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_paused) return;
+        if (_queue.size() >= _capacity)
+        {
+            _dropped++;
+            if (_policy == RS2_QUEUE_POLICY_DROP_NEWEST) return;
+            dropped = std::move(_queue.front());
+            _queue.pop_front();
+        }
+        _queue.push_back(std::move(frame));
+        _cv.notify_one();
+    }
+
+    std::shared_ptr<frame_subscription> frame_broadcaster::subscribe(int capacity, rs2_queue_policy policy)
+    {
+        if (capacity < 1)
+            throw invalid_value_exception(to_string() << "Invalid subscription capacity " << capacity);
+        if (policy != RS2_QUEUE_POLICY_DROP_OLDEST && policy != RS2_QUEUE_POLICY_DROP_NEWEST)
+            throw invalid_value_exception(to_string() << "Subscriptions drop frames instead of blocking, "
+                                                      << rs2_queue_policy_to_string(policy) << " is not supported");
+
+        auto subscription = std::make_shared<frame_subscription>(static_cast<size_t>(capacity), policy);
+        std::lock_guard<std::mutex> lock(_mutex);
+        _subscriptions.push_back(subscription);
+        _count = _subscriptions.size();
+        return subscription;
+    }
+
+    void frame_broadcaster::publish(frame_interface* frame)
+    {
+        if (!frame || !has_subscribers()) return;
+
+        std::vector<std::shared_ptr<frame_subscription>> subscriptions;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _subscriptions.erase(std::remove_if(_subscriptions.begin(), _subscriptions.end(),
+                [](const std::weak_ptr<frame_subscription>& s) { return s.expired(); }), _subscriptions.end());
+            _count = _subscriptions.size();
+            for (auto&& s : _subscriptions)
+                if (auto subscription = s.lock()) subscriptions.push_back(subscription);
+        }
+
+        for (auto&& s : subscriptions)
+        {
+            frame->acquire();
+            s->push(frame_holder(frame));
+        }
+    }
+}
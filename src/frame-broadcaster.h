@@ -0,0 +1,64 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "archive.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+
+namespace librealsense
+{
+    // Queue of one subscriber of a frame_broadcaster. Only RS2_QUEUE_POLICY_DROP_OLDEST and RS2_QUEUE_POLICY_DROP_NEWEST
+    // are accepted, a subscriber that blocked would hold back the publisher and with it all the other subscribers
+    class frame_subscription
+    {
+    public:
+        frame_subscription(size_t capacity, rs2_queue_policy policy);
+
+        // Frames published while paused are not queued, and the frames queued are released on pausing
+        void set_paused(bool paused);
+        bool is_paused() const;
+
+        bool dequeue(frame_holder* frame, unsigned int timeout_ms);
+        bool try_dequeue(frame_holder* frame);
+
+        // Frames the subscription dropped as its queue was full
+        unsigned long long get_dropped_count() const;
+
+    private:
+        friend class frame_broadcaster;
+
+        void push(frame_holder frame);
+
+        const size_t _capacity;
+        const rs2_queue_policy _policy;
+        mutable std::mutex _mutex;
+        std::condition_variable _cv;
+        std::deque<frame_holder> _queue;
+        bool _paused;
+        unsigned long long _dropped;
+    };
+
+    // Hands every frame published to any number of subscriptions. The subscribers share the frames, each holding a
+    // reference and none a copy, and a slow or paused subscriber only drops its own frames
+    // A subscription ends when the last reference to it is released
+    class frame_broadcaster
+    {
+    public:
+        frame_broadcaster() : _count(0) {}
+
+        std::shared_ptr<frame_subscription> subscribe(int capacity, rs2_queue_policy policy);
+
+        bool has_subscribers() const { return _count > 0; }
+
+        void publish(frame_interface* frame);
+
+    private:
+        std::mutex _mutex;
+        std::vector<std::weak_ptr<frame_subscription>> _subscriptions;
+        std::atomic<size_t> _count;
+    };
+}
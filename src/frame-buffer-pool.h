@@ -0,0 +1,217 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "types.h"
+#include "frame-storage.h"
+
+#include <atomic>
+#include <array>
+#include <vector>
+
+namespace librealsense
+{
+    const uint32_t FRAME_POOL_DEFAULT_HIGH_WATER_MARK = 16;   // Max buffers cached per size class
+    const double   FRAME_POOL_MAX_IDLE_MS             = 1000; // Size classes not used for longer than this are drained
+
+    struct frame_buffer_pool_stats
+    {
+        uint64_t hits;      // Requests served from the pool
+        uint64_t misses;    // Requests that had to allocate a new buffer
+        uint64_t evictions; // Buffers dropped because of the high-water mark, idle time or flush
+    };
+
+    // Recycles frame buffers between frame_archive::unpublish_frame and frame_archive::alloc_frame
+    // Buffers are grouped by their byte size (one bucket per size class) and every bucket is a fixed
+    // array of slots guarded by an atomic state, so neither acquire nor release ever takes a lock
+    // A buffer handed out by the pool may have been obtained for a different size class in case of races,
+    // hence the caller is always responsible for resizing it to the required size
+    template<int BUCKETS = 8, int SLOTS = 32>
+    class frame_buffer_pool
+    {
+    public:
+        typedef frame_storage buffer_type;
+
+        explicit frame_buffer_pool(uint32_t high_water_mark = FRAME_POOL_DEFAULT_HIGH_WATER_MARK)
+            : _high_water_mark(std::min<uint32_t>(high_water_mark, SLOTS)),
+              _hits(0), _misses(0), _evictions(0)
+        {
+            for (auto&& b : _buckets)
+            {
+                b.size_class = 0;
+                b.count = 0;
+                b.last_used = 0;
+                b.pinned = false;
+                for (auto&& s : b.states) s = slot_empty;
+            }
+        }
+
+        frame_buffer_pool(const frame_buffer_pool&) = delete;
+        frame_buffer_pool& operator=(const frame_buffer_pool&) = delete;
+
+        // Try to move a cached buffer of the requested size into target. Returns false on a miss
+        bool acquire(size_t size, buffer_type& target, double now)
+        {
+            bool found = false;
+            if (auto b = find_bucket(size, false))
+            {
+                b->last_used = now;
+                for (auto i = 0; i < SLOTS && b->count; i++)
+                {
+                    int expected = slot_full;
+                    if (b->states[i].compare_exchange_strong(expected, slot_busy))
+                    {
+                        target.swap(b->buffers[i]);
+                        buffer_type().swap(b->buffers[i]);
+                        b->states[i] = slot_empty;
+                        --b->count;
+                        found = true;
+                        break;
+                    }
+                }
+            }
+
+            if (found) ++_hits;
+            else ++_misses;
+
+            drain_idle_buckets(now);
+            return found;
+        }
+
+        // Return a buffer into the pool. Buffers exceeding the high-water mark of their size class are freed
+        void release(buffer_type&& buf, double now)
+        {
+            if (buf.capacity() == 0) return;
+
+            auto b = find_bucket(buf.size(), true);
+            if (b && b->count++ < _high_water_mark)
+            {
+                b->last_used = now;
+                for (auto i = 0; i < SLOTS; i++)
+                {
+                    int expected = slot_empty;
+                    if (b->states[i].compare_exchange_strong(expected, slot_busy))
+                    {
+                        b->buffers[i].swap(buf);
+                        b->states[i] = slot_full;
+                        return;
+                    }
+                }
+            }
+            if (b) --b->count;
+
+            ++_evictions;
+            buffer_type().swap(buf);
+        }
+
+        // Cache up to count new buffers of the size class ahead of its use, raising the high-water mark as needed
+        // The size class is kept from idle draining until the next clear. Returns the number of buffers it holds
+        uint32_t reserve(size_t size, uint32_t count)
+        {
+            auto b = find_bucket(size, true);
+            if (!b) return 0;
+
+            b->pinned = true;
+            count = std::min<uint32_t>(count, SLOTS);
+            if (_high_water_mark < count) _high_water_mark = count;
+
+            for (uint32_t i = 0; i < count && b->count < count; i++)
+                release(buffer_type(size, _allocator), b->last_used);
+            return b->count;
+        }
+
+        // Drop all cached buffers. Safe to call concurrently with acquire / release
+        void clear()
+        {
+            for (auto&& b : _buckets)
+            {
+                b.pinned = false;
+                drain(b);
+            }
+        }
+
+        // Allocator of the buffers reserve creates, the buffers already cached keep theirs
+        void set_allocator(const buffer_type::allocator_type& allocator) { _allocator = allocator; }
+
+        void set_high_water_mark(uint32_t value) { _high_water_mark = std::min<uint32_t>(value, SLOTS); }
+        uint32_t get_high_water_mark() const { return _high_water_mark; }
+
+        frame_buffer_pool_stats get_stats() const
+        {
+            return{ _hits.load(), _misses.load(), _evictions.load() };
+        }
+
+    private:
+        enum slot_state { slot_empty, slot_busy, slot_full };
+
+        struct bucket
+        {
+            std::atomic<size_t> size_class;
+            std::atomic<uint32_t> count;
+            std::atomic<double> last_used;
+            std::atomic<bool> pinned;
+            std::array<std::atomic<int>, SLOTS> states;
+            std::array<buffer_type, SLOTS> buffers;
+        };
+
+        bucket* find_bucket(size_t size, bool create)
+        {
+            if (size == 0) return nullptr;
+
+            for (auto&& b : _buckets)
+                if (b.size_class == size) return &b;
+
+            if (!create) return nullptr;
+
+            // Claim a free bucket for the new size class
+            for (auto&& b : _buckets)
+            {
+                size_t expected = 0;
+                if (b.size_class.compare_exchange_strong(expected, size) || expected == size)
+                    return &b;
+            }
+            return nullptr;
+        }
+
+        void drain(bucket& b)
+        {
+            for (auto i = 0; i < SLOTS; i++)
+            {
+                int expected = slot_full;
+                if (b.states[i].compare_exchange_strong(expected, slot_busy))
+                {
+                    buffer_type().swap(b.buffers[i]);
+                    b.states[i] = slot_empty;
+                    --b.count;
+                    ++_evictions;
+                }
+            }
+        }
+
+        void drain_idle_buckets(double now)
+        {
+            for (auto&& b : _buckets)
+            {
+                // Empty size classes are handed back as well, or the buckets of sizes no longer used stay claimed
+                if (b.size_class && !b.pinned && now > b.last_used + FRAME_POOL_MAX_IDLE_MS)
+                {
+                    if (b.count) drain(b);
+                    // Hand the bucket back for reuse by a different size class
+                    if (!b.count)
+                    {
+                        auto size = b.size_class.load();
+                        b.size_class.compare_exchange_strong(size, 0);
+                    }
+                }
+            }
+        }
+
+        std::array<bucket, BUCKETS> _buckets;
+        buffer_type::allocator_type _allocator;
+        std::atomic<uint32_t> _high_water_mark;
+        std::atomic<uint64_t> _hits;
+        std::atomic<uint64_t> _misses;
+        std::atomic<uint64_t> _evictions;
+    };
+}
@@ -0,0 +1,66 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#include "frame-storage.h"
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace librealsense
+{
+#ifdef __linux__
+    static const size_t huge_page_size = 2 * 1024 * 1024;
+    static const int mpol_preferred = 1;    // From linux/mempolicy.h, which is not always installed
+
+    size_t map_frame_pages_size(size_t size, const frame_memory_policy& policy)
+    {
+        if (size < FRAME_STORAGE_PAGED_MIN || (policy.huge_pages == huge_pages_off && policy.numa_node < 0 && !policy.locked))
+            return 0;
+        // Huge pages are only used for whole ones, the length of a mapping has to be the same when it is unmapped
+        static const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        auto granularity = policy.huge_pages != huge_pages_off ? huge_page_size : page_size;
+        return (size + granularity - 1) / granularity * granularity;
+    }
+
+    void* map_frame_pages(size_t size, const frame_memory_policy& policy)
+    {
+        auto length = map_frame_pages_size(size, policy);
+        void* p = MAP_FAILED;
+#ifdef MAP_HUGETLB
+        if (policy.huge_pages == huge_pages_explicit)
+            p = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+        if (p == MAP_FAILED)
+        {
+            p = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (p == MAP_FAILED) throw std::bad_alloc();
+#ifdef MADV_HUGEPAGE
+            if (policy.huge_pages != huge_pages_off) madvise(p, length, MADV_HUGEPAGE);
+#endif
+        }
+
+        // Bound before the first write faults the pages in, a node without free pages falls back to the others
+        if (policy.numa_node >= 0 && policy.numa_node < static_cast<int>(sizeof(unsigned long) * 8))
+        {
+            unsigned long mask = 1ul << policy.numa_node;
+            syscall(SYS_mbind, p, length, mpol_preferred, &mask, static_cast<unsigned long>(sizeof(mask) * 8), 0);
+        }
+
+        // Pages beyond RLIMIT_MEMLOCK stay unlocked, unmapping them unlocks them
+        if (policy.locked) mlock(p, length);
+        return p;
+    }
+
+    void unmap_frame_pages(void* p, size_t size, const frame_memory_policy& policy)
+    {
+        munmap(p, map_frame_pages_size(size, policy));
+    }
+#else
+    size_t map_frame_pages_size(size_t, const frame_memory_policy&) { return 0; }
+    void* map_frame_pages(size_t, const frame_memory_policy&) { throw std::bad_alloc(); }
+    void unmap_frame_pages(void*, size_t, const frame_memory_policy&) {}
+#endif
+}
@@ -0,0 +1,112 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace librealsense
+{
+    // Frame buffers start on a cache line, so vector loads and stores of the unpackers and filters never split one
+    const size_t FRAME_STORAGE_ALIGNMENT = 64;
+
+    enum frame_huge_pages
+    {
+        huge_pages_off,
+        huge_pages_transparent,     // Advise the kernel to back the buffers with transparent huge pages
+        huge_pages_explicit         // Map the buffers from the reserved huge pages, transparent ones when none are left
+    };
+
+    // Placement of the frame buffers of a sensor. Buffers of at least FRAME_STORAGE_PAGED_MIN bytes are mapped
+    // as pages of their own when the policy asks for anything, the smaller ones and other platforms ignore it
+    struct frame_memory_policy
+    {
+        frame_huge_pages huge_pages = huge_pages_off;
+        int numa_node = -1;         // Node the pages are preferably taken from, -1 for the node of the first writer
+        bool locked = false;        // Lock the pages in memory, so copies to other devices such as GPUs need no staging
+
+        bool operator==(const frame_memory_policy& other) const
+        {
+            return huge_pages == other.huge_pages && numa_node == other.numa_node && locked == other.locked;
+        }
+        bool operator!=(const frame_memory_policy& other) const { return !(*this == other); }
+    };
+
+    const size_t FRAME_STORAGE_PAGED_MIN = 64 * 1024;
+
+    // Length of the pages mapped for a buffer of the size under the policy, zero when the buffer is left to the heap
+    // Pages the policy can not be applied to are mapped without it, map_frame_pages throws only when out of memory
+    size_t map_frame_pages_size(size_t size, const frame_memory_policy& policy);
+    void* map_frame_pages(size_t size, const frame_memory_policy& policy);
+    void unmap_frame_pages(void* p, size_t size, const frame_memory_policy& policy);
+
+    // Allocator of aligned memory that leaves the elements it constructs without arguments uninitialized
+    // Frame data is always written in full by the unpacker or filter producing it, so zero filling it would be wasted
+    // The memory policy moves along with the buffers, so a buffer is always freed the way it was allocated
+    template<class T, size_t ALIGNMENT = FRAME_STORAGE_ALIGNMENT>
+    class uninitialized_aligned_allocator
+    {
+    public:
+        typedef T value_type;
+        typedef std::true_type propagate_on_container_copy_assignment;
+        typedef std::true_type propagate_on_container_move_assignment;
+        typedef std::true_type propagate_on_container_swap;
+        template<class U> struct rebind { typedef uninitialized_aligned_allocator<U, ALIGNMENT> other; };
+
+        uninitialized_aligned_allocator() = default;
+        explicit uninitialized_aligned_allocator(const frame_memory_policy& policy) : _policy(policy) {}
+        template<class U> uninitialized_aligned_allocator(const uninitialized_aligned_allocator<U, ALIGNMENT>& other) : _policy(other.get_policy()) {}
+
+        const frame_memory_policy& get_policy() const { return _policy; }
+
+        T* allocate(size_t n)
+        {
+            if (!n) return nullptr;
+            if (map_frame_pages_size(n * sizeof(T), _policy))
+                return static_cast<T*>(map_frame_pages(n * sizeof(T), _policy));
+            void* p = nullptr;
+#ifdef _WIN32
+            p = _aligned_malloc(n * sizeof(T), ALIGNMENT);
+#else
+            if (posix_memalign(&p, ALIGNMENT, n * sizeof(T))) p = nullptr;
+#endif
+            if (!p) throw std::bad_alloc();
+            return static_cast<T*>(p);
+        }
+
+        void deallocate(T* p, size_t n)
+        {
+            if (map_frame_pages_size(n * sizeof(T), _policy))
+            {
+                unmap_frame_pages(p, n * sizeof(T), _policy);
+                return;
+            }
+#ifdef _WIN32
+            _aligned_free(p);
+#else
+            free(p);
+#endif
+        }
+
+        template<class U> void construct(U* p) { ::new(static_cast<void*>(p)) U; }
+        template<class U, class... Args> void construct(U* p, Args&&... args) { ::new(static_cast<void*>(p)) U(std::forward<Args>(args)...); }
+
+        template<class U> bool operator==(const uninitialized_aligned_allocator<U, ALIGNMENT>& other) const { return _policy == other.get_policy(); }
+        template<class U> bool operator!=(const uninitialized_aligned_allocator<U, ALIGNMENT>& other) const { return _policy != other.get_policy(); }
+
+    private:
+        frame_memory_policy _policy;
+    };
+
+    // Storage of the data of frames. Resizing it leaves the new bytes uninitialized
+    typedef std::vector<uint8_t, uninitialized_aligned_allocator<uint8_t>> frame_storage;
+}
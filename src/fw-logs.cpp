@@ -0,0 +1,112 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#include "types.h"
+#include "fw-logs.h"
+
+namespace librealsense
+{
+    // Time between reads while the firmware has no logs to give
+    static const int FW_LOG_POLL_MS = 100;
+
+    fw_log_reader::fw_log_reader(std::function<std::vector<uint8_t>()> read_logs, size_t entry_size)
+        : _read_logs(std::move(read_logs)), _entry_size(entry_size), _capacity(0), _head(0), _count(0), _capturing(false)
+    {
+    }
+
+    fw_log_reader::~fw_log_reader()
+    {
+        stop();
+    }
+
+    void fw_log_reader::start(size_t capacity)
+    {
+        if (!capacity)
+            throw invalid_value_exception("Firmware log capture needs room for at least one entry");
+
+        stop();
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _ring.assign(capacity * _entry_size, 0);
+            _capacity = capacity;
+            _head = 0;
+            _count = 0;
+            _capturing = true;
+        }
+        _thread.reset(new active_object<>([this](dispatcher::cancellable_timer timer) { read(timer); }, "rs-fw-logs"));
+        _thread->start();
+    }
+
+    void fw_log_reader::stop()
+    {
+        if (_thread)
+        {
+            _thread->stop();
+            _thread.reset();
+        }
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _capturing = false;
+        }
+        _cv.notify_all();
+    }
+
+    std::vector<uint8_t> fw_log_reader::fetch(size_t max_count, std::chrono::milliseconds timeout)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _cv.wait_for(lock, timeout, [this]() { return _count > 0 || !_capturing; });
+
+        auto count = std::min(max_count, _count);
+        std::vector<uint8_t> entries(count * _entry_size);
+        for (size_t i = 0; i < count; i++)
+        {
+            auto entry = _ring.data() + ((_head + i) % _capacity) * _entry_size;
+            std::copy(entry, entry + _entry_size, entries.data() + i * _entry_size);
+        }
+        if (count)
+            _head = (_head + count) % _capacity;
+        _count -= count;
+        return entries;
+    }
+
+    void fw_log_reader::read(dispatcher::cancellable_timer& timer)
+    {
+        std::vector<uint8_t> data;
+        try
+        {
+            data = _read_logs();
+        }
+        catch (const std::exception& e)
+        {
+            LOG_WARNING("Failed to read firmware logs: " << e.what());
+        }
+
+        auto entries = data.size() / _entry_size;
+        if (entries)
+        {
+            size_t dropped = 0;
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                for (size_t i = 0; i < entries; i++)
+                {
+                    if (_count == _capacity)
+                    {
+                        _head = (_head + 1) % _capacity;
+                        _count--;
+                        dropped++;
+                    }
+                    auto entry = _ring.data() + ((_head + _count) % _capacity) * _entry_size;
+                    std::copy(data.data() + i * _entry_size, data.data() + (i + 1) * _entry_size, entry);
+                    _count++;
+                }
+            }
+            _cv.notify_all();
+            if (dropped)
+                LOG_WARNING("Dropped " << dropped << " firmware log entries, the capture ring is full");
+        }
+
+        // The firmware may hold more logs than one read returns, so only an empty read waits
+        if (!entries)
+            timer.try_sleep(FW_LOG_POLL_MS);
+    }
+}
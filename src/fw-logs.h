@@ -0,0 +1,47 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "concurrency.h"
+
+namespace librealsense
+{
+    // Size of the firmware log entries of the DS5 and SR300 devices, and the most log data one read asks for
+    const size_t FW_LOG_ENTRY_SIZE = 20;
+    const int FW_LOG_READ_SIZE = 500;
+
+    // Reads the firmware logs of a device on its own thread into a ring of raw entries, parsed only by whoever fetches them
+    // When the ring is full the oldest entries are dropped. The read function returns the log data of one read,
+    // made of whole entries of entry_size bytes
+    class fw_log_reader
+    {
+    public:
+        fw_log_reader(std::function<std::vector<uint8_t>()> read_logs, size_t entry_size);
+        ~fw_log_reader();
+
+        // Starting again clears the entries left from the previous capture
+        void start(size_t capacity);
+        // The entries read until then can still be fetched
+        void stop();
+
+        // Waits up to the timeout for entries, then takes at most max_count of the oldest ones, concatenated
+        std::vector<uint8_t> fetch(size_t max_count, std::chrono::milliseconds timeout);
+
+    private:
+        void read(dispatcher::cancellable_timer& timer);
+
+        std::function<std::vector<uint8_t>()> _read_logs;
+        size_t _entry_size;
+
+        std::mutex _mutex;
+        std::condition_variable _cv;
+        std::vector<uint8_t> _ring;
+        size_t _capacity;
+        size_t _head;
+        size_t _count;
+        bool _capturing;
+
+        std::unique_ptr<active_object<>> _thread;
+    };
+}
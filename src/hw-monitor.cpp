@@ -40,10 +40,11 @@ namespace librealsense
     }
 
 
-    void hw_monitor::execute_usb_command(uint8_t *out, size_t outSize, uint32_t & op, uint8_t * in, size_t & inSize) const
+    void hw_monitor::execute_usb_command(uint8_t *out, size_t outSize, uint32_t & op, uint8_t * in, size_t & inSize,
+                                         int timeout_ms, const command_deadline& deadline) const
     {
         std::vector<uint8_t> out_vec(out, out + outSize);
-        auto res = _locked_transfer->send_receive(out_vec);
+        auto res = _locked_transfer->send_receive(out_vec, timeout_ms, true, deadline);
 
         // read
         if (in && inSize)
@@ -79,23 +80,88 @@ namespace librealsense
             librealsense::copy(details.receivedCommandData, outputBuffer + 4, details.receivedCommandDataLength);
     }
 
-    void hw_monitor::send_hw_monitor_command(hwmon_cmd_details& details) const
+    void hw_monitor::send_hw_monitor_command(hwmon_cmd_details& details, const command_deadline& deadline) const
     {
         unsigned char outputBuffer[HW_MONITOR_BUFFER_SIZE];
 
         uint32_t op{};
         size_t receivedCmdLen = HW_MONITOR_BUFFER_SIZE;
 
-        execute_usb_command(details.sendCommandData, details.sizeOfSendCommandData, op, outputBuffer, receivedCmdLen);
+        execute_usb_command(details.sendCommandData, details.sizeOfSendCommandData, op, outputBuffer, receivedCmdLen,
+                            static_cast<int>(details.TimeOut), deadline);
         update_cmd_details(details, receivedCmdLen, outputBuffer);
     }
 
-    std::vector<uint8_t> hw_monitor::send(std::vector<uint8_t> data) const
+    std::vector<uint8_t> hw_monitor::send(std::vector<uint8_t> data, const command_deadline& deadline) const
     {
-        return _locked_transfer->send_receive(data);
+        return _locked_transfer->send_receive(data, 5000, true, deadline);
     }
 
-    std::vector<uint8_t> hw_monitor::send(command cmd) const
+    std::vector<std::vector<uint8_t>> hw_monitor::send_batch(const std::vector<std::vector<uint8_t>>& data, std::chrono::milliseconds delay,
+                                                             const command_deadline& deadline,
+                                                             std::vector<command_deadline::clock::time_point>* received) const
+    {
+        return _locked_transfer->send_receive_batch(data, delay, 5000, deadline, received);
+    }
+
+    std::vector<std::vector<uint8_t>> hw_monitor::send_batch(const std::vector<std::vector<uint8_t>>& data, std::vector<double>& received_ms) const
+    {
+        std::vector<command_deadline::clock::time_point> received;
+        auto start = command_deadline::clock::now();
+        auto results = send_batch(data, std::chrono::milliseconds(0), command_deadline(), &received);
+        for (auto&& t : received)
+            received_ms.push_back(std::chrono::duration<double, std::milli>(t - start).count());
+        return results;
+    }
+
+    namespace
+    {
+        // Reports an error for a command dropped from the queue without running, so that no callback is lost
+        struct pending_command
+        {
+            pending_command(command cmd, command_deadline deadline, hw_monitor::command_callback on_complete)
+                : cmd(std::move(cmd)), deadline(std::move(deadline)), on_complete(std::move(on_complete)), completed(false) {}
+
+            ~pending_command()
+            {
+                if (completed) return;
+                try { on_complete({}, std::make_exception_ptr(io_exception("hw_monitor command was dropped before it was sent"))); }
+                catch (...) {}
+            }
+
+            command cmd;
+            command_deadline deadline;
+            hw_monitor::command_callback on_complete;
+            bool completed;
+        };
+    }
+
+    void hw_monitor::send_async(command cmd, command_deadline deadline, command_callback on_complete) const
+    {
+        if (!on_complete)
+            throw invalid_value_exception("hw_monitor::send_async requires a completion callback");
+
+        auto pending = std::make_shared<pending_command>(std::move(cmd), std::move(deadline), std::move(on_complete));
+        std::lock_guard<std::mutex> lock(_async_mutex);
+        if (!_async)
+        {
+            _async.reset(new dispatcher(64, "rs-hw-monitor", RS2_THREAD_CLASS_IO));
+            _async->start();
+        }
+        _async->invoke([this, pending](dispatcher::cancellable_timer)
+        {
+            std::vector<uint8_t> response;
+            std::exception_ptr error;
+            try { response = send(pending->cmd, pending->deadline); }
+            catch (...) { error = std::current_exception(); }
+
+            pending->completed = true;
+            try { pending->on_complete(response, error); }
+            catch (...) { LOG_ERROR("Exception thrown from an hw_monitor completion callback"); }
+        });
+    }
+
+    std::vector<uint8_t> hw_monitor::send(command cmd, const command_deadline& deadline) const
     {
         hwmon_cmd newCommand(cmd);
         auto opCodeXmit = static_cast<uint32_t>(newCommand.cmd);
@@ -114,7 +180,7 @@ namespace librealsense
             details.sendCommandData,
             details.sizeOfSendCommandData);
 
-        send_hw_monitor_command(details);
+        send_hw_monitor_command(details, deadline);
 
         // Error/exit conditions
         if (newCommand.oneDirection)
@@ -147,18 +213,35 @@ namespace librealsense
 
     std::string hw_monitor::get_firmware_version_string(int gvd_cmd, uint32_t offset) const
     {
-        std::vector<unsigned char> gvd(HW_MONITOR_BUFFER_SIZE);
+        std::vector<uint8_t> gvd(HW_MONITOR_BUFFER_SIZE);
         get_gvd(gvd.size(), gvd.data(), gvd_cmd);
+        return get_firmware_version_string(gvd, offset);
+    }
+
+    std::string hw_monitor::get_module_serial_string(uint8_t gvd_cmd, uint32_t offset) const
+    {
+        std::vector<uint8_t> gvd(HW_MONITOR_BUFFER_SIZE);
+        get_gvd(gvd.size(), gvd.data(), gvd_cmd);
+        return get_module_serial_string(gvd, offset);
+    }
+
+    bool hw_monitor::is_camera_locked(uint8_t gvd_cmd, uint32_t offset) const
+    {
+        std::vector<uint8_t> gvd(HW_MONITOR_BUFFER_SIZE);
+        get_gvd(gvd.size(), gvd.data(), gvd_cmd);
+        return is_camera_locked(gvd, offset);
+    }
+
+    std::string hw_monitor::get_firmware_version_string(const std::vector<uint8_t>& gvd, uint32_t offset)
+    {
         uint8_t fws[8];
         librealsense::copy(fws, gvd.data() + offset, 8);
         return to_string() << static_cast<int>(fws[3]) << "." << static_cast<int>(fws[2])
             << "." << static_cast<int>(fws[1]) << "." << static_cast<int>(fws[0]);
     }
 
-    std::string hw_monitor::get_module_serial_string(uint8_t gvd_cmd, uint32_t offset) const
+    std::string hw_monitor::get_module_serial_string(const std::vector<uint8_t>& gvd, uint32_t offset)
     {
-        std::vector<unsigned char> gvd(HW_MONITOR_BUFFER_SIZE);
-        get_gvd(gvd.size(), gvd.data(), gvd_cmd);
         unsigned char ss[8];
         librealsense::copy(ss, gvd.data() + offset, 8);
         std::stringstream formattedBuffer;
@@ -172,10 +255,8 @@ namespace librealsense
         return formattedBuffer.str();
     }
 
-    bool hw_monitor::is_camera_locked(uint8_t gvd_cmd, uint32_t offset) const
+    bool hw_monitor::is_camera_locked(const std::vector<uint8_t>& gvd, uint32_t offset)
     {
-        std::vector<unsigned char> gvd(HW_MONITOR_BUFFER_SIZE);
-        get_gvd(gvd.size(), gvd.data(), gvd_cmd);
         bool value;
         librealsense::copy(&value, gvd.data() + offset, 1);
         return value;
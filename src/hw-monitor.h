@@ -4,7 +4,11 @@
 #pragma once
 
 #include "sensor.h"
+#include "concurrency.h"
+#include <exception>
 #include <mutex>
+#include <thread>
+#include <chrono>
 
 const uint8_t   IV_COMMAND_FIRMWARE_UPDATE_MODE = 0x01;
 const uint8_t   IV_COMMAND_GET_CALIBRATION_DATA = 0x02;
@@ -53,24 +57,91 @@ namespace librealsense
              _uvc_sensor_base(uvc_ep)
         {}
 
+        // Throws io_exception, without waiting for the device any longer, once the deadline passes or is cancelled
         std::vector<uint8_t> send_receive(
             const std::vector<uint8_t>& data,
             int timeout_ms = 5000,
-            bool require_response = true)
+            bool require_response = true,
+            const command_deadline& deadline = command_deadline())
         {
-            std::lock_guard<std::recursive_mutex> lock(_local_mtx);
+            auto lock = acquire(deadline);
             return _uvc_sensor_base.invoke_powered([&]
                 (platform::uvc_device& dev)
                 {
                     std::lock_guard<platform::uvc_device> lock(dev);
-                    return _command_transfer->send_receive(data, timeout_ms, require_response);
+                    command_deadline::scope scope(deadline);
+                    return _command_transfer->send_receive(data, transfer_timeout(deadline, timeout_ms), require_response);
+                });
+        }
+
+        // Sends the commands in order while powering the sensor and locking the device once for all of them
+        // The firmware handles one command at a time, but without a delay between the commands the backend may send
+        // the next ones before the previous responses arrive. The time each response was received is added to received
+        std::vector<std::vector<uint8_t>> send_receive_batch(
+            const std::vector<std::vector<uint8_t>>& commands,
+            std::chrono::milliseconds delay = std::chrono::milliseconds(0),
+            int timeout_ms = 5000,
+            const command_deadline& deadline = command_deadline(),
+            std::vector<command_deadline::clock::time_point>* received = nullptr)
+        {
+            auto lock = acquire(deadline);
+            return _uvc_sensor_base.invoke_powered([&]
+                (platform::uvc_device& dev)
+                {
+                    std::lock_guard<platform::uvc_device> lock(dev);
+                    command_deadline::scope scope(deadline);
+                    if (delay.count() == 0)
+                    {
+                        auto results = _command_transfer->send_receive_batch(commands, transfer_timeout(deadline, timeout_ms), received);
+                        if (results.size() < commands.size())
+                            throw_passed(deadline);
+                        return results;
+                    }
+
+                    std::vector<std::vector<uint8_t>> results;
+                    results.reserve(commands.size());
+                    for (auto&& data : commands)
+                    {
+                        if (!results.empty() && delay.count() > 0 && !deadline.sleep_before_retry(delay))
+                            throw_passed(deadline);
+                        results.push_back(_command_transfer->send_receive(data, transfer_timeout(deadline, timeout_ms), true));
+                        if (received) received->push_back(command_deadline::clock::now());
+                    }
+                    return results;
                 });
         }
 
     private:
+        // Another thread may hold the device for as long as its own command takes, so the lock is awaited in slices
+        // to notice the deadline
+        std::unique_lock<std::recursive_timed_mutex> acquire(const command_deadline& deadline)
+        {
+            std::unique_lock<std::recursive_timed_mutex> lock(_local_mtx, std::defer_lock);
+            while (!lock.try_lock_for(std::chrono::milliseconds(10)))
+            {
+                if (deadline.has_passed())
+                    throw_passed(deadline);
+            }
+            return lock;
+        }
+
+        static int transfer_timeout(const command_deadline& deadline, int timeout_ms)
+        {
+            auto timeout = deadline.transfer_timeout(timeout_ms);
+            if (!timeout) throw_passed(deadline);
+            return timeout;
+        }
+
+        static void throw_passed(const command_deadline& deadline)
+        {
+            if (deadline.is_cancelled())
+                throw io_exception("hw_monitor command was cancelled");
+            throw io_exception("hw_monitor command deadline passed");
+        }
+
         std::shared_ptr<platform::command_transfer> _command_transfer;
         uvc_sensor& _uvc_sensor_base;
-        std::recursive_mutex _local_mtx;
+        std::recursive_timed_mutex _local_mtx;
     };
 
     struct command
@@ -152,21 +223,45 @@ namespace librealsense
         };
 
         static void fill_usb_buffer(int opCodeNumber, int p1, int p2, int p3, int p4, uint8_t* data, int dataLength, uint8_t* bufferToSend, int& length);
-        void execute_usb_command(uint8_t *out, size_t outSize, uint32_t& op, uint8_t* in, size_t& inSize) const;
+        void execute_usb_command(uint8_t *out, size_t outSize, uint32_t& op, uint8_t* in, size_t& inSize,
+                                 int timeout_ms, const command_deadline& deadline) const;
         static void update_cmd_details(hwmon_cmd_details& details, size_t receivedCmdLen, unsigned char* outputBuffer);
-        void send_hw_monitor_command(hwmon_cmd_details& details) const;
+        void send_hw_monitor_command(hwmon_cmd_details& details, const command_deadline& deadline) const;
 
         std::shared_ptr<locked_transfer> _locked_transfer;
+        // Worker of send_async, started with the first asynchronous command. Declared last to be stopped first
+        mutable std::mutex _async_mutex;
+        mutable std::unique_ptr<dispatcher> _async;
     public:
+        typedef std::function<void(const std::vector<uint8_t>& response, std::exception_ptr error)> command_callback;
+
         explicit hw_monitor(std::shared_ptr<locked_transfer> locked_transfer)
             : _locked_transfer(std::move(locked_transfer))
         {}
 
-        std::vector<uint8_t> send(std::vector<uint8_t> data) const;
-        std::vector<uint8_t> send(command cmd) const;
+        // The commands wait for the device and its response no longer than the deadline allows
+        std::vector<uint8_t> send(std::vector<uint8_t> data, const command_deadline& deadline = command_deadline()) const;
+        std::vector<uint8_t> send(command cmd, const command_deadline& deadline = command_deadline()) const;
+        // Sends raw commands in one locked and powered session, see locked_transfer::send_receive_batch
+        std::vector<std::vector<uint8_t>> send_batch(const std::vector<std::vector<uint8_t>>& data,
+                                                     std::chrono::milliseconds delay = std::chrono::milliseconds(0),
+                                                     const command_deadline& deadline = command_deadline(),
+                                                     std::vector<command_deadline::clock::time_point>* received = nullptr) const;
+        // Sends raw commands as one batch without delays, timing the milliseconds from the call to each response
+        std::vector<std::vector<uint8_t>> send_batch(const std::vector<std::vector<uint8_t>>& data, std::vector<double>& received_ms) const;
+        // Sends the command from a worker thread of the monitor and reports its response, or the error it failed
+        // with, to the callback on that thread. The commands run in order, the deadline counting from the call, so
+        // the ones queued behind a stuck command fail fast. The callback is invoked exactly once, with an error for
+        // the commands still queued when the monitor is destroyed
+        void send_async(command cmd, command_deadline deadline, command_callback on_complete) const;
         void get_gvd(size_t sz, unsigned char* gvd, uint8_t gvd_cmd) const;
         std::string get_firmware_version_string(int gvd_cmd, uint32_t offset) const;
         std::string get_module_serial_string(uint8_t gvd_cmd, uint32_t offset) const;
         bool is_camera_locked(uint8_t gvd_cmd, uint32_t offset) const;
+
+        // Parse a GVD buffer read once with get_gvd
+        static std::string get_firmware_version_string(const std::vector<uint8_t>& gvd, uint32_t offset);
+        static std::string get_module_serial_string(const std::vector<uint8_t>& gvd, uint32_t offset);
+        static bool is_camera_locked(const std::vector<uint8_t>& gvd, uint32_t offset);
     };
 }
@@ -4,10 +4,16 @@
 #define _USE_MATH_DEFINES
 #include <cmath>
 #include "image.h"
+#include "cpu-features.h"
 //#include "../include/librealsense2/rsutil.h" // For projection/deprojection logic
 
 #ifdef __SSSE3__
 #include <tmmintrin.h> // For SSE3 intrinsic used in unpack_yuy2_sse
+#include <immintrin.h> // For AVX2 intrinsic, only executed when supported by the running CPU
+#endif
+
+#ifdef RS2_USE_TURBOJPEG
+#include <turbojpeg.h>
 #endif
 
 #pragma pack(push, 1) // All structs in this file are assumed to be byte-packed
@@ -32,6 +38,8 @@ namespace librealsense
         case RS2_FORMAT_Z16: return  16;
         case RS2_FORMAT_DISPARITY16: return 16;
         case RS2_FORMAT_XYZ32F: return 12 * 8;
+        case RS2_FORMAT_XYZ16F: return 6 * 8;
+        case RS2_FORMAT_XYZ16: return 6 * 8;
         case RS2_FORMAT_YUYV:  return 16;
         case RS2_FORMAT_RGB8: return 24;
         case RS2_FORMAT_BGR8: return 24;
@@ -46,6 +54,12 @@ namespace librealsense
         case RS2_FORMAT_GPIO_RAW: return 1;
         case RS2_FORMAT_MOTION_RAW: return 1;
         case RS2_FORMAT_MOTION_XYZ32F: return 1;
+        case RS2_FORMAT_MOTION_XYZ32F_BATCH: return 1;
+        case RS2_FORMAT_Z16_COMPRESSED: return 8;
+        case RS2_FORMAT_ORIENTATION: return 1;
+        case RS2_FORMAT_Y8I: return 16;
+        case RS2_FORMAT_DISTANCE: return 32;
+        case RS2_FORMAT_NV12: return 12;
         default: assert(false); return 0;
         }
     }
@@ -116,20 +130,163 @@ namespace librealsense
         librealsense::copy(dest[0], source, SIZE * count);
     }
 
+    // Unpackers that only copy the native pixels can expose the backend buffer as is
+    bool is_plain_copy(const pixel_format_unpacker & unpacker)
+    {
+        return unpacker.outputs.size() == 1 &&
+            (unpacker.unpack == &copy_pixels<1> || unpacker.unpack == &copy_pixels<2>);
+    }
+
     void copy_raw10(byte * const dest[], const byte * source, int count)
     {
         librealsense::copy(dest[0], source, (5 * (count/4)));
     }
 
+    ////////////////////////////////
+    // Unpacker dispatching logic //
+    ////////////////////////////////
+
+    // Every vectorized unpacker has a scalar counterpart (suffixed _scalar) producing identical output,
+    // which serves both as the fallback and as the reference to validate the vectorized variants against
+    typedef void(*unpack_function)(byte * const dest[], const byte * source, int count);
+
+#ifdef __SSSE3__
+    #define SSSE3_UNPACKER(f) &f
+    #define AVX2_UNPACKER(f)  &f
+#else
+    #define SSSE3_UNPACKER(f) nullptr
+    #define AVX2_UNPACKER(f)  nullptr
+#endif
+
+    // Pick the fastest variant supported by the running CPU. Unpackers resolve it once, on their first invocation
+    inline unpack_function select_unpacker(unpack_function scalar, unpack_function ssse3, unpack_function avx2)
+    {
+        if (avx2 && cpu_supports(CPU_FEATURE_AVX2)) return avx2;
+        if (ssse3 && cpu_supports(CPU_FEATURE_SSSE3)) return ssse3;
+        return scalar;
+    }
+
+    // Hand the pixels left over by a vectorized loop to the scalar implementation
+    inline void unpack_tail(unpack_function scalar, byte * const dest[], const byte * source, int count, int done,
+                            int source_bpp, int dest0_bpp, int dest1_bpp = 0)
+    {
+        if (done >= count) return;
+        byte * const tail[] = { dest[0] + done * dest0_bpp, dest1_bpp ? dest[1] + done * dest1_bpp : nullptr };
+        scalar(tail, source + done * source_bpp, count - done);
+    }
+
     template<class SOURCE, class UNPACK> void unpack_pixels(byte * const dest[], int count, const SOURCE * source, UNPACK unpack)
     {
         auto out = reinterpret_cast<decltype(unpack(SOURCE())) *>(dest[0]);
         for(int i=0; i<count; ++i) *out++ = unpack(*source++);
     }
 
-    void unpack_y16_from_y8    (byte * const d[], const byte * s, int n) { unpack_pixels(d, n, reinterpret_cast<const uint8_t  *>(s), [](uint8_t  pixel) -> uint16_t { return pixel | pixel << 8; }); }
-    void unpack_y16_from_y16_10(byte * const d[], const byte * s, int n) { unpack_pixels(d, n, reinterpret_cast<const uint16_t *>(s), [](uint16_t pixel) -> uint16_t { return pixel << 6; }); }
-    void unpack_y8_from_y16_10 (byte * const d[], const byte * s, int n) { unpack_pixels(d, n, reinterpret_cast<const uint16_t *>(s), [](uint16_t pixel) -> uint8_t  { return pixel >> 2; }); }
+    void unpack_y16_from_y8_scalar    (byte * const d[], const byte * s, int n) { unpack_pixels(d, n, reinterpret_cast<const uint8_t  *>(s), [](uint8_t  pixel) -> uint16_t { return pixel | pixel << 8; }); }
+    void unpack_y16_from_y16_10_scalar(byte * const d[], const byte * s, int n) { unpack_pixels(d, n, reinterpret_cast<const uint16_t *>(s), [](uint16_t pixel) -> uint16_t { return pixel << 6; }); }
+    void unpack_y8_from_y16_10_scalar (byte * const d[], const byte * s, int n) { unpack_pixels(d, n, reinterpret_cast<const uint16_t *>(s), [](uint16_t pixel) -> uint8_t  { return pixel >> 2; }); }
+
+#ifdef __SSSE3__
+    void unpack_y16_from_y8_ssse3(byte * const d[], const byte * s, int n)
+    {
+        auto src = reinterpret_cast<const __m128i *>(s);
+        auto dst = reinterpret_cast<__m128i *>(d[0]);
+        int i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            __m128i in = _mm_loadu_si128(src++);
+            _mm_storeu_si128(dst++, _mm_unpacklo_epi8(in, in));
+            _mm_storeu_si128(dst++, _mm_unpackhi_epi8(in, in));
+        }
+        unpack_tail(&unpack_y16_from_y8_scalar, d, s, n, i, 1, 2);
+    }
+
+    void unpack_y16_from_y16_10_ssse3(byte * const d[], const byte * s, int n)
+    {
+        auto src = reinterpret_cast<const __m128i *>(s);
+        auto dst = reinterpret_cast<__m128i *>(d[0]);
+        int i = 0;
+        for (; i + 8 <= n; i += 8)
+            _mm_storeu_si128(dst++, _mm_slli_epi16(_mm_loadu_si128(src++), 6));
+        unpack_tail(&unpack_y16_from_y16_10_scalar, d, s, n, i, 2, 2);
+    }
+
+    void unpack_y8_from_y16_10_ssse3(byte * const d[], const byte * s, int n)
+    {
+        auto src = reinterpret_cast<const __m128i *>(s);
+        auto dst = reinterpret_cast<__m128i *>(d[0]);
+        const __m128i low_byte = _mm_set1_epi16(0xff);
+        int i = 0;
+        for (; i + 16 <= n; i += 16, src += 2)
+        {
+            // Mask the shifted values so that packing truncates exactly like the scalar code instead of saturating
+            __m128i lo = _mm_and_si128(_mm_srli_epi16(_mm_loadu_si128(src), 2), low_byte);
+            __m128i hi = _mm_and_si128(_mm_srli_epi16(_mm_loadu_si128(src + 1), 2), low_byte);
+            _mm_storeu_si128(dst++, _mm_packus_epi16(lo, hi));
+        }
+        unpack_tail(&unpack_y8_from_y16_10_scalar, d, s, n, i, 2, 1);
+    }
+
+    AVX2_TARGET void unpack_y16_from_y8_avx2(byte * const d[], const byte * s, int n)
+    {
+        auto src = reinterpret_cast<const __m128i *>(s);
+        auto dst = reinterpret_cast<__m256i *>(d[0]);
+        int i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            __m256i in = _mm256_cvtepu8_epi16(_mm_loadu_si128(src++));
+            _mm256_storeu_si256(dst++, _mm256_or_si256(in, _mm256_slli_epi16(in, 8)));
+        }
+        unpack_tail(&unpack_y16_from_y8_scalar, d, s, n, i, 1, 2);
+    }
+
+    AVX2_TARGET void unpack_y16_from_y16_10_avx2(byte * const d[], const byte * s, int n)
+    {
+        auto src = reinterpret_cast<const __m256i *>(s);
+        auto dst = reinterpret_cast<__m256i *>(d[0]);
+        int i = 0;
+        for (; i + 16 <= n; i += 16)
+            _mm256_storeu_si256(dst++, _mm256_slli_epi16(_mm256_loadu_si256(src++), 6));
+        unpack_tail(&unpack_y16_from_y16_10_scalar, d, s, n, i, 2, 2);
+    }
+
+    AVX2_TARGET void unpack_y8_from_y16_10_avx2(byte * const d[], const byte * s, int n)
+    {
+        auto src = reinterpret_cast<const __m256i *>(s);
+        auto dst = reinterpret_cast<__m256i *>(d[0]);
+        const __m256i low_byte = _mm256_set1_epi16(0xff);
+        int i = 0;
+        for (; i + 32 <= n; i += 32, src += 2)
+        {
+            __m256i lo = _mm256_and_si256(_mm256_srli_epi16(_mm256_loadu_si256(src), 2), low_byte);
+            __m256i hi = _mm256_and_si256(_mm256_srli_epi16(_mm256_loadu_si256(src + 1), 2), low_byte);
+            // Packing operates per 128-bit lane, restore the pixel order afterwards
+            _mm256_storeu_si256(dst++, _mm256_permute4x64_epi64(_mm256_packus_epi16(lo, hi), 0xd8));
+        }
+        unpack_tail(&unpack_y8_from_y16_10_scalar, d, s, n, i, 2, 1);
+    }
+#endif
+
+    void unpack_y16_from_y8(byte * const d[], const byte * s, int n)
+    {
+        static const auto unpack = select_unpacker(&unpack_y16_from_y8_scalar, SSSE3_UNPACKER(unpack_y16_from_y8_ssse3),
+                                                   AVX2_UNPACKER(unpack_y16_from_y8_avx2));
+        unpack(d, s, n);
+    }
+
+    void unpack_y16_from_y16_10(byte * const d[], const byte * s, int n)
+    {
+        static const auto unpack = select_unpacker(&unpack_y16_from_y16_10_scalar, SSSE3_UNPACKER(unpack_y16_from_y16_10_ssse3),
+                                                   AVX2_UNPACKER(unpack_y16_from_y16_10_avx2));
+        unpack(d, s, n);
+    }
+
+    void unpack_y8_from_y16_10(byte * const d[], const byte * s, int n)
+    {
+        static const auto unpack = select_unpacker(&unpack_y8_from_y16_10_scalar, SSSE3_UNPACKER(unpack_y8_from_y16_10_ssse3),
+                                                   AVX2_UNPACKER(unpack_y8_from_y16_10_avx2));
+        unpack(d, s, n);
+    }
+
     void unpack_rw10_from_rw8 (byte *  const d[], const byte * s, int n)
     {
 #ifdef __SSSE3__
@@ -163,10 +320,24 @@ namespace librealsense
 
     // Unpack luminocity 8 bit from 10-bit packed macro-pixels (4 pixels in 5 bytes):
     // The first four bytes store the 8 MSB of each pixel, and the last byte holds the 2 LSB for each pixel :8888[2222]
-    void unpack_y8_from_rw10(byte *  const d[], const byte * s, int n)
+    void unpack_y8_from_rw10_scalar(byte *  const d[], const byte * s, int n)
     {
+        auto from = reinterpret_cast<const uint8_t *>(s);
+        uint8_t* tgt = d[0];
+
+        for (int i = 0; i < n; i+=4, from+=5)
+        {
+            *tgt++ = from[0];
+            *tgt++ = from[1];
+            *tgt++ = from[2];
+            *tgt++ = from[3];
+        }
+    }
+
 #ifdef __SSSE3__
-        assert(!(n % 48));  //We process 12 macro-pixels simultaneously to achieve performance boost
+    void unpack_y8_from_rw10_ssse3(byte *  const d[], const byte * s, int n)
+    {
+        //We process 12 macro-pixels simultaneously to achieve performance boost
         auto src = reinterpret_cast<const uint8_t *>(s);
         auto dst = reinterpret_cast<uint8_t *>(d[0]);
 
@@ -185,7 +356,9 @@ namespace librealsense
         static const __m128i mask =_mm_setr_epi8(0x0, 0x1, 0x2, 0x3, 0x5, 0x6, 0x7, 0x8, 0xa, 0xb, 0xc, 0xd, -1, -1, -1, -1);
 
 
-        for (int i = 0; (i+48) < n; i += 48, src +=60, dst+=48)
+        // The last block is left to the scalar code, as the loads and stores spill past the current block
+        int i = 0;
+        for (; (i+48) < n; i += 48, src +=60, dst+=48)
         {
             blk_0_in = reinterpret_cast<const __m128i *>(src);
             blk_1_in = reinterpret_cast<const __m128i *>(src + 15);
@@ -207,18 +380,16 @@ namespace librealsense
             _mm_storeu_si128(blk_2_out, res[2]);
             _mm_storeu_si128(blk_3_out, res[3]);
         }
-#else  // Generic code for when SSSE3 is not available.
-        auto from = reinterpret_cast<const uint8_t *>(s);
-        uint8_t* tgt = d[0];
 
-        for (int i = 0; i < n; i+=4, from+=5)
-        {
-            *tgt++ = from[0];
-            *tgt++ = from[1];
-            *tgt++ = from[2];
-            *tgt++ = from[3];
-        }
+        byte * const tail[] = { d[0] + i };
+        unpack_y8_from_rw10_scalar(tail, s + i / 4 * 5, n - i);
+    }
 #endif
+
+    void unpack_y8_from_rw10(byte *  const d[], const byte * s, int n)
+    {
+        static const auto unpack = select_unpacker(&unpack_y8_from_rw10_scalar, SSSE3_UNPACKER(unpack_y8_from_rw10_ssse3), nullptr);
+        unpack(d, s, n);
     }
     /////////////////////////////
     // YUY2 unpacking routines //
@@ -226,153 +397,9 @@ namespace librealsense
 
     // This templated function unpacks YUY2 into Y8/Y16/RGB8/RGBA8/BGR8/BGRA8, depending on the compile-time parameter FORMAT.
     // It is expected that all branching outside of the loop control variable will be removed due to constant-folding.
-    template<rs2_format FORMAT> void unpack_yuy2(byte * const d [], const byte * s, int n)
+    template<rs2_format FORMAT> void unpack_yuy2_scalar(byte * const d [], const byte * s, int n)
     {
         assert(n % 16 == 0); // All currently supported color resolutions are multiples of 16 pixels. Could easily extend support to other resolutions by copying final n<16 pixels into a zero-padded buffer and recursively calling self for final iteration.
-#ifdef __SSSE3__
-        auto src = reinterpret_cast<const __m128i *>(s);
-        auto dst = reinterpret_cast<__m128i *>(d[0]);
-        #pragma omp parallel for
-        for(int i = 0; i < n/16; i++)
-        {
-            const __m128i zero = _mm_set1_epi8(0);
-            const __m128i n100 = _mm_set1_epi16(100 << 4);
-            const __m128i n208 = _mm_set1_epi16(208 << 4);
-            const __m128i n298 = _mm_set1_epi16(298 << 4);
-            const __m128i n409 = _mm_set1_epi16(409 << 4);
-            const __m128i n516 = _mm_set1_epi16(516 << 4);
-            const __m128i evens_odds = _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
-
-            // Load 8 YUY2 pixels each into two 16-byte registers
-            __m128i s0 = _mm_loadu_si128(&src[i*2]);
-            __m128i s1 = _mm_loadu_si128(&src[i*2+1]);
-
-            if(FORMAT == RS2_FORMAT_Y8)
-            {
-                // Align all Y components and output 16 pixels (16 bytes) at once
-                __m128i y0 = _mm_shuffle_epi8(s0, _mm_setr_epi8(1, 3, 5, 7, 9, 11, 13, 15,   0, 2, 4, 6, 8, 10, 12, 14));
-                __m128i y1 = _mm_shuffle_epi8(s1, _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14,   1, 3, 5, 7, 9, 11, 13, 15));
-                _mm_storeu_si128(&dst[i], _mm_alignr_epi8(y0, y1, 8));
-                continue;
-            }
-
-            // Shuffle all Y components to the low order bytes of the register, and all U/V components to the high order bytes
-            const __m128i evens_odd1s_odd3s = _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 5, 9, 13, 3, 7, 11, 15); // to get yyyyyyyyuuuuvvvv
-            __m128i yyyyyyyyuuuuvvvv0 = _mm_shuffle_epi8(s0, evens_odd1s_odd3s);
-            __m128i yyyyyyyyuuuuvvvv8 = _mm_shuffle_epi8(s1, evens_odd1s_odd3s);
-
-            // Retrieve all 16 Y components as 16-bit values (8 components per register))
-            __m128i y16__0_7 = _mm_unpacklo_epi8(yyyyyyyyuuuuvvvv0, zero);         // convert to 16 bit
-            __m128i y16__8_F = _mm_unpacklo_epi8(yyyyyyyyuuuuvvvv8, zero);         // convert to 16 bit
-
-            if(FORMAT == RS2_FORMAT_Y16)
-            {
-                // Output 16 pixels (32 bytes) at once
-                _mm_storeu_si128(&dst[i*2], _mm_slli_epi16(y16__0_7, 8));
-                _mm_storeu_si128(&dst[i*2+1], _mm_slli_epi16(y16__8_F, 8));
-                continue;
-            }
-
-            // Retrieve all 16 U and V components as 16-bit values (8 components per register)
-            __m128i uv = _mm_unpackhi_epi32(yyyyyyyyuuuuvvvv0, yyyyyyyyuuuuvvvv8); // uuuuuuuuvvvvvvvv
-            __m128i u = _mm_unpacklo_epi8(uv, uv);                                 //  uu uu uu uu uu uu uu uu  u's duplicated
-            __m128i v = _mm_unpackhi_epi8(uv, uv);                                 //  vv vv vv vv vv vv vv vv
-            __m128i u16__0_7 = _mm_unpacklo_epi8(u, zero);                         // convert to 16 bit
-            __m128i u16__8_F = _mm_unpackhi_epi8(u, zero);                         // convert to 16 bit
-            __m128i v16__0_7 = _mm_unpacklo_epi8(v, zero);                         // convert to 16 bit
-            __m128i v16__8_F = _mm_unpackhi_epi8(v, zero);                         // convert to 16 bit
-
-            // Compute R, G, B values for first 8 pixels
-            __m128i c16__0_7 = _mm_slli_epi16(_mm_subs_epi16(y16__0_7, _mm_set1_epi16(16)), 4);
-            __m128i d16__0_7 = _mm_slli_epi16(_mm_subs_epi16(u16__0_7, _mm_set1_epi16(128)), 4); // perhaps could have done these u,v to d,e before the duplication
-            __m128i e16__0_7 = _mm_slli_epi16(_mm_subs_epi16(v16__0_7, _mm_set1_epi16(128)), 4);
-            __m128i r16__0_7 = _mm_min_epi16(_mm_set1_epi16(255), _mm_max_epi16(zero, ((_mm_add_epi16(_mm_mulhi_epi16(c16__0_7, n298), _mm_mulhi_epi16(e16__0_7, n409))))));                                                 // (298 * c + 409 * e + 128) ; //
-            __m128i g16__0_7 = _mm_min_epi16(_mm_set1_epi16(255), _mm_max_epi16(zero, ((_mm_sub_epi16(_mm_sub_epi16(_mm_mulhi_epi16(c16__0_7, n298), _mm_mulhi_epi16(d16__0_7, n100)), _mm_mulhi_epi16(e16__0_7, n208)))))); // (298 * c - 100 * d - 208 * e + 128)
-            __m128i b16__0_7 = _mm_min_epi16(_mm_set1_epi16(255), _mm_max_epi16(zero, ((_mm_add_epi16(_mm_mulhi_epi16(c16__0_7, n298), _mm_mulhi_epi16(d16__0_7, n516))))));                                                 // clampbyte((298 * c + 516 * d + 128) >> 8);
-
-            // Compute R, G, B values for second 8 pixels
-            __m128i c16__8_F = _mm_slli_epi16(_mm_subs_epi16(y16__8_F, _mm_set1_epi16(16)), 4);
-            __m128i d16__8_F = _mm_slli_epi16(_mm_subs_epi16(u16__8_F, _mm_set1_epi16(128)), 4); // perhaps could have done these u,v to d,e before the duplication
-            __m128i e16__8_F = _mm_slli_epi16(_mm_subs_epi16(v16__8_F, _mm_set1_epi16(128)), 4);
-            __m128i r16__8_F = _mm_min_epi16(_mm_set1_epi16(255), _mm_max_epi16(zero, ((_mm_add_epi16(_mm_mulhi_epi16(c16__8_F, n298), _mm_mulhi_epi16(e16__8_F, n409))))));                                                 // (298 * c + 409 * e + 128) ; //
-            __m128i g16__8_F = _mm_min_epi16(_mm_set1_epi16(255), _mm_max_epi16(zero, ((_mm_sub_epi16(_mm_sub_epi16(_mm_mulhi_epi16(c16__8_F, n298), _mm_mulhi_epi16(d16__8_F, n100)), _mm_mulhi_epi16(e16__8_F, n208)))))); // (298 * c - 100 * d - 208 * e + 128)
-            __m128i b16__8_F = _mm_min_epi16(_mm_set1_epi16(255), _mm_max_epi16(zero, ((_mm_add_epi16(_mm_mulhi_epi16(c16__8_F, n298), _mm_mulhi_epi16(d16__8_F, n516))))));                                                 // clampbyte((298 * c + 516 * d + 128) >> 8);
-
-            if (FORMAT == RS2_FORMAT_RGB8 || FORMAT == RS2_FORMAT_RGBA8)
-            {
-                // Shuffle separate R, G, B values into four registers storing four pixels each in (R, G, B, A) order
-                __m128i rg8__0_7 = _mm_unpacklo_epi8(_mm_shuffle_epi8(r16__0_7, evens_odds), _mm_shuffle_epi8(g16__0_7, evens_odds)); // hi to take the odds which are the upper bytes we care about
-                __m128i ba8__0_7 = _mm_unpacklo_epi8(_mm_shuffle_epi8(b16__0_7, evens_odds), _mm_set1_epi8(-1));
-                __m128i rgba_0_3 = _mm_unpacklo_epi16(rg8__0_7, ba8__0_7);
-                __m128i rgba_4_7 = _mm_unpackhi_epi16(rg8__0_7, ba8__0_7);
-
-                __m128i rg8__8_F = _mm_unpacklo_epi8(_mm_shuffle_epi8(r16__8_F, evens_odds), _mm_shuffle_epi8(g16__8_F, evens_odds)); // hi to take the odds which are the upper bytes we care about
-                __m128i ba8__8_F = _mm_unpacklo_epi8(_mm_shuffle_epi8(b16__8_F, evens_odds), _mm_set1_epi8(-1));
-                __m128i rgba_8_B = _mm_unpacklo_epi16(rg8__8_F, ba8__8_F);
-                __m128i rgba_C_F = _mm_unpackhi_epi16(rg8__8_F, ba8__8_F);
-
-                if(FORMAT == RS2_FORMAT_RGBA8)
-                {
-                    // Store 16 pixels (64 bytes) at once
-                    _mm_storeu_si128(&dst[i*4], rgba_0_3);
-                    _mm_storeu_si128(&dst[i*4 + 1], rgba_4_7);
-                    _mm_storeu_si128(&dst[i*4 + 2], rgba_8_B);
-                    _mm_storeu_si128(&dst[i*4 + 3], rgba_C_F);
-                }
-
-                if(FORMAT == RS2_FORMAT_RGB8)
-                {
-                    // Shuffle rgb triples to the start and end of each register
-                    __m128i rgb0 = _mm_shuffle_epi8(rgba_0_3, _mm_setr_epi8(  3, 7, 11, 15,   0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14));
-                    __m128i rgb1 = _mm_shuffle_epi8(rgba_4_7, _mm_setr_epi8(0, 1, 2, 4,   3, 7, 11, 15,   5, 6, 8, 9, 10, 12, 13, 14));
-                    __m128i rgb2 = _mm_shuffle_epi8(rgba_8_B, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9,   3, 7, 11, 15,   10, 12, 13, 14));
-                    __m128i rgb3 = _mm_shuffle_epi8(rgba_C_F, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14,   3, 7, 11, 15  ));
-
-                    // Align registers and store 16 pixels (48 bytes) at once
-                    _mm_storeu_si128(&dst[i*3], _mm_alignr_epi8(rgb1, rgb0, 4));
-                    _mm_storeu_si128(&dst[i*3 + 1], _mm_alignr_epi8(rgb2, rgb1, 8));
-                    _mm_storeu_si128(&dst[i*3 + 2], _mm_alignr_epi8(rgb3, rgb2, 12));
-                }
-            }
-
-            if (FORMAT == RS2_FORMAT_BGR8 || FORMAT == RS2_FORMAT_BGRA8)
-            {
-                // Shuffle separate R, G, B values into four registers storing four pixels each in (B, G, R, A) order
-                __m128i bg8__0_7 = _mm_unpacklo_epi8(_mm_shuffle_epi8(b16__0_7, evens_odds), _mm_shuffle_epi8(g16__0_7, evens_odds)); // hi to take the odds which are the upper bytes we care about
-                __m128i ra8__0_7 = _mm_unpacklo_epi8(_mm_shuffle_epi8(r16__0_7, evens_odds), _mm_set1_epi8(-1));
-                __m128i bgra_0_3 = _mm_unpacklo_epi16(bg8__0_7, ra8__0_7);
-                __m128i bgra_4_7 = _mm_unpackhi_epi16(bg8__0_7, ra8__0_7);
-
-                __m128i bg8__8_F = _mm_unpacklo_epi8(_mm_shuffle_epi8(b16__8_F, evens_odds), _mm_shuffle_epi8(g16__8_F, evens_odds)); // hi to take the odds which are the upper bytes we care about
-                __m128i ra8__8_F = _mm_unpacklo_epi8(_mm_shuffle_epi8(r16__8_F, evens_odds), _mm_set1_epi8(-1));
-                __m128i bgra_8_B = _mm_unpacklo_epi16(bg8__8_F, ra8__8_F);
-                __m128i bgra_C_F = _mm_unpackhi_epi16(bg8__8_F, ra8__8_F);
-
-                if(FORMAT == RS2_FORMAT_BGRA8)
-                {
-                    // Store 16 pixels (64 bytes) at once
-                    _mm_storeu_si128(&dst[i*4], bgra_0_3);
-                    _mm_storeu_si128(&dst[i*4 + 1], bgra_4_7);
-                    _mm_storeu_si128(&dst[i*4 + 2], bgra_8_B);
-                    _mm_storeu_si128(&dst[i*4 + 3], bgra_C_F);
-                }
-
-                if(FORMAT == RS2_FORMAT_BGR8)
-                {
-                    // Shuffle rgb triples to the start and end of each register
-                    __m128i bgr0 = _mm_shuffle_epi8(bgra_0_3, _mm_setr_epi8(  3, 7, 11, 15,   0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14));
-                    __m128i bgr1 = _mm_shuffle_epi8(bgra_4_7, _mm_setr_epi8(0, 1, 2, 4,   3, 7, 11, 15,   5, 6, 8, 9, 10, 12, 13, 14));
-                    __m128i bgr2 = _mm_shuffle_epi8(bgra_8_B, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9,   3, 7, 11, 15,   10, 12, 13, 14));
-                    __m128i bgr3 = _mm_shuffle_epi8(bgra_C_F, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14,   3, 7, 11, 15  ));
-
-                    // Align registers and store 16 pixels (48 bytes) at once
-                    _mm_storeu_si128(&dst[i*3], _mm_alignr_epi8(bgr1, bgr0, 4));
-                    _mm_storeu_si128(&dst[i*3+1], _mm_alignr_epi8(bgr2, bgr1, 8));
-                    _mm_storeu_si128(&dst[i*3+2], _mm_alignr_epi8(bgr3, bgr2, 12));
-                }
-            }
-        }
-#else  // Generic code for when SSSE3 is not available.
         auto src = reinterpret_cast<const uint8_t *>(s);
         auto dst = reinterpret_cast<uint8_t *>(d[0]);
         for(; n; n -= 16, src += 32)
@@ -431,7 +458,7 @@ namespace librealsense
                 int32_t t;
                 #define clamp(x)  ((t=(x)) > 255 ? 255 : t < 0 ? 0 : t)
                 r[i] = clamp((298 * c           + 409 * e + 128) >> 8);
-                g[i] = clamp((298 * c - 100 * d - 409 * e + 128) >> 8);
+                g[i] = clamp((298 * c - 100 * d - 208 * e + 128) >> 8);
                 b[i] = clamp((298 * c + 516 * d           + 128) >> 8);
                 #undef clamp
             }
@@ -504,18 +531,16 @@ namespace librealsense
                 continue;
             }
         }
-#endif
     }
 
-    // This templated function unpacks UYVY into RGB8/RGBA8/BGR8/BGRA8, depending on the compile-time parameter FORMAT.
-    // It is expected that all branching outside of the loop control variable will be removed due to constant-folding.
-    template<rs2_format FORMAT> void unpack_uyvy(byte * const d[], const byte * s, int n)
+#ifdef __SSSE3__
+    template<rs2_format FORMAT> void unpack_yuy2_ssse3(byte * const d [], const byte * s, int n)
     {
         assert(n % 16 == 0); // All currently supported color resolutions are multiples of 16 pixels. Could easily extend support to other resolutions by copying final n<16 pixels into a zero-padded buffer and recursively calling self for final iteration.
-#ifdef __SSSE3__
         auto src = reinterpret_cast<const __m128i *>(s);
         auto dst = reinterpret_cast<__m128i *>(d[0]);
-        for (; n; n -= 16)
+        #pragma omp parallel for
+        for(int i = 0; i < n/16; i++)
         {
             const __m128i zero = _mm_set1_epi8(0);
             const __m128i n100 = _mm_set1_epi16(100 << 4);
@@ -525,13 +550,21 @@ namespace librealsense
             const __m128i n516 = _mm_set1_epi16(516 << 4);
             const __m128i evens_odds = _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
 
-            // Load 8 UYVY pixels each into two 16-byte registers
-            __m128i s0 = _mm_loadu_si128(src++);
-            __m128i s1 = _mm_loadu_si128(src++);
+            // Load 8 YUY2 pixels each into two 16-byte registers
+            __m128i s0 = _mm_loadu_si128(&src[i*2]);
+            __m128i s1 = _mm_loadu_si128(&src[i*2+1]);
 
+            if(FORMAT == RS2_FORMAT_Y8)
+            {
+                // Align all Y components and output 16 pixels (16 bytes) at once
+                __m128i y0 = _mm_shuffle_epi8(s0, _mm_setr_epi8(1, 3, 5, 7, 9, 11, 13, 15,   0, 2, 4, 6, 8, 10, 12, 14));
+                __m128i y1 = _mm_shuffle_epi8(s1, _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14,   1, 3, 5, 7, 9, 11, 13, 15));
+                _mm_storeu_si128(&dst[i], _mm_alignr_epi8(y1, y0, 8));
+                continue;
+            }
 
             // Shuffle all Y components to the low order bytes of the register, and all U/V components to the high order bytes
-            const __m128i evens_odd1s_odd3s = _mm_setr_epi8(1, 3, 5, 7, 9, 11, 13, 15, 0, 4, 8, 12, 2, 6, 10, 14); // to get yyyyyyyyuuuuvvvv
+            const __m128i evens_odd1s_odd3s = _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 5, 9, 13, 3, 7, 11, 15); // to get yyyyyyyyuuuuvvvv
             __m128i yyyyyyyyuuuuvvvv0 = _mm_shuffle_epi8(s0, evens_odd1s_odd3s);
             __m128i yyyyyyyyuuuuvvvv8 = _mm_shuffle_epi8(s1, evens_odd1s_odd3s);
 
@@ -539,6 +572,13 @@ namespace librealsense
             __m128i y16__0_7 = _mm_unpacklo_epi8(yyyyyyyyuuuuvvvv0, zero);         // convert to 16 bit
             __m128i y16__8_F = _mm_unpacklo_epi8(yyyyyyyyuuuuvvvv8, zero);         // convert to 16 bit
 
+            if(FORMAT == RS2_FORMAT_Y16)
+            {
+                // Output 16 pixels (32 bytes) at once
+                _mm_storeu_si128(&dst[i*2], _mm_slli_epi16(y16__0_7, 8));
+                _mm_storeu_si128(&dst[i*2+1], _mm_slli_epi16(y16__8_F, 8));
+                continue;
+            }
 
             // Retrieve all 16 U and V components as 16-bit values (8 components per register)
             __m128i uv = _mm_unpackhi_epi32(yyyyyyyyuuuuvvvv0, yyyyyyyyuuuuvvvv8); // uuuuuuuuvvvvvvvv
@@ -549,7 +589,7 @@ namespace librealsense
             __m128i v16__0_7 = _mm_unpacklo_epi8(v, zero);                         // convert to 16 bit
             __m128i v16__8_F = _mm_unpackhi_epi8(v, zero);                         // convert to 16 bit
 
-                                                                                   // Compute R, G, B values for first 8 pixels
+            // Compute R, G, B values for first 8 pixels
             __m128i c16__0_7 = _mm_slli_epi16(_mm_subs_epi16(y16__0_7, _mm_set1_epi16(16)), 4);
             __m128i d16__0_7 = _mm_slli_epi16(_mm_subs_epi16(u16__0_7, _mm_set1_epi16(128)), 4); // perhaps could have done these u,v to d,e before the duplication
             __m128i e16__0_7 = _mm_slli_epi16(_mm_subs_epi16(v16__0_7, _mm_set1_epi16(128)), 4);
@@ -557,7 +597,7 @@ namespace librealsense
             __m128i g16__0_7 = _mm_min_epi16(_mm_set1_epi16(255), _mm_max_epi16(zero, ((_mm_sub_epi16(_mm_sub_epi16(_mm_mulhi_epi16(c16__0_7, n298), _mm_mulhi_epi16(d16__0_7, n100)), _mm_mulhi_epi16(e16__0_7, n208)))))); // (298 * c - 100 * d - 208 * e + 128)
             __m128i b16__0_7 = _mm_min_epi16(_mm_set1_epi16(255), _mm_max_epi16(zero, ((_mm_add_epi16(_mm_mulhi_epi16(c16__0_7, n298), _mm_mulhi_epi16(d16__0_7, n516))))));                                                 // clampbyte((298 * c + 516 * d + 128) >> 8);
 
-                                                                                                                                                                                                                             // Compute R, G, B values for second 8 pixels
+            // Compute R, G, B values for second 8 pixels
             __m128i c16__8_F = _mm_slli_epi16(_mm_subs_epi16(y16__8_F, _mm_set1_epi16(16)), 4);
             __m128i d16__8_F = _mm_slli_epi16(_mm_subs_epi16(u16__8_F, _mm_set1_epi16(128)), 4); // perhaps could have done these u,v to d,e before the duplication
             __m128i e16__8_F = _mm_slli_epi16(_mm_subs_epi16(v16__8_F, _mm_set1_epi16(128)), 4);
@@ -578,27 +618,27 @@ namespace librealsense
                 __m128i rgba_8_B = _mm_unpacklo_epi16(rg8__8_F, ba8__8_F);
                 __m128i rgba_C_F = _mm_unpackhi_epi16(rg8__8_F, ba8__8_F);
 
-                if (FORMAT == RS2_FORMAT_RGBA8)
+                if(FORMAT == RS2_FORMAT_RGBA8)
                 {
                     // Store 16 pixels (64 bytes) at once
-                    _mm_storeu_si128(dst++, rgba_0_3);
-                    _mm_storeu_si128(dst++, rgba_4_7);
-                    _mm_storeu_si128(dst++, rgba_8_B);
-                    _mm_storeu_si128(dst++, rgba_C_F);
+                    _mm_storeu_si128(&dst[i*4], rgba_0_3);
+                    _mm_storeu_si128(&dst[i*4 + 1], rgba_4_7);
+                    _mm_storeu_si128(&dst[i*4 + 2], rgba_8_B);
+                    _mm_storeu_si128(&dst[i*4 + 3], rgba_C_F);
                 }
 
-                if (FORMAT == RS2_FORMAT_RGB8)
+                if(FORMAT == RS2_FORMAT_RGB8)
                 {
                     // Shuffle rgb triples to the start and end of each register
-                    __m128i rgb0 = _mm_shuffle_epi8(rgba_0_3, _mm_setr_epi8(3, 7, 11, 15, 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14));
-                    __m128i rgb1 = _mm_shuffle_epi8(rgba_4_7, _mm_setr_epi8(0, 1, 2, 4, 3, 7, 11, 15, 5, 6, 8, 9, 10, 12, 13, 14));
-                    __m128i rgb2 = _mm_shuffle_epi8(rgba_8_B, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 3, 7, 11, 15, 10, 12, 13, 14));
-                    __m128i rgb3 = _mm_shuffle_epi8(rgba_C_F, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, 3, 7, 11, 15));
+                    __m128i rgb0 = _mm_shuffle_epi8(rgba_0_3, _mm_setr_epi8(  3, 7, 11, 15,   0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14));
+                    __m128i rgb1 = _mm_shuffle_epi8(rgba_4_7, _mm_setr_epi8(0, 1, 2, 4,   3, 7, 11, 15,   5, 6, 8, 9, 10, 12, 13, 14));
+                    __m128i rgb2 = _mm_shuffle_epi8(rgba_8_B, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9,   3, 7, 11, 15,   10, 12, 13, 14));
+                    __m128i rgb3 = _mm_shuffle_epi8(rgba_C_F, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14,   3, 7, 11, 15  ));
 
                     // Align registers and store 16 pixels (48 bytes) at once
-                    _mm_storeu_si128(dst++, _mm_alignr_epi8(rgb1, rgb0, 4));
-                    _mm_storeu_si128(dst++, _mm_alignr_epi8(rgb2, rgb1, 8));
-                    _mm_storeu_si128(dst++, _mm_alignr_epi8(rgb3, rgb2, 12));
+                    _mm_storeu_si128(&dst[i*3], _mm_alignr_epi8(rgb1, rgb0, 4));
+                    _mm_storeu_si128(&dst[i*3 + 1], _mm_alignr_epi8(rgb2, rgb1, 8));
+                    _mm_storeu_si128(&dst[i*3 + 2], _mm_alignr_epi8(rgb3, rgb2, 12));
                 }
             }
 
@@ -615,31 +655,38 @@ namespace librealsense
                 __m128i bgra_8_B = _mm_unpacklo_epi16(bg8__8_F, ra8__8_F);
                 __m128i bgra_C_F = _mm_unpackhi_epi16(bg8__8_F, ra8__8_F);
 
-                if (FORMAT == RS2_FORMAT_BGRA8)
+                if(FORMAT == RS2_FORMAT_BGRA8)
                 {
                     // Store 16 pixels (64 bytes) at once
-                    _mm_storeu_si128(dst++, bgra_0_3);
-                    _mm_storeu_si128(dst++, bgra_4_7);
-                    _mm_storeu_si128(dst++, bgra_8_B);
-                    _mm_storeu_si128(dst++, bgra_C_F);
+                    _mm_storeu_si128(&dst[i*4], bgra_0_3);
+                    _mm_storeu_si128(&dst[i*4 + 1], bgra_4_7);
+                    _mm_storeu_si128(&dst[i*4 + 2], bgra_8_B);
+                    _mm_storeu_si128(&dst[i*4 + 3], bgra_C_F);
                 }
 
-                if (FORMAT == RS2_FORMAT_BGR8)
+                if(FORMAT == RS2_FORMAT_BGR8)
                 {
                     // Shuffle rgb triples to the start and end of each register
-                    __m128i bgr0 = _mm_shuffle_epi8(bgra_0_3, _mm_setr_epi8(3, 7, 11, 15, 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14));
-                    __m128i bgr1 = _mm_shuffle_epi8(bgra_4_7, _mm_setr_epi8(0, 1, 2, 4, 3, 7, 11, 15, 5, 6, 8, 9, 10, 12, 13, 14));
-                    __m128i bgr2 = _mm_shuffle_epi8(bgra_8_B, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 3, 7, 11, 15, 10, 12, 13, 14));
-                    __m128i bgr3 = _mm_shuffle_epi8(bgra_C_F, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, 3, 7, 11, 15));
+                    __m128i bgr0 = _mm_shuffle_epi8(bgra_0_3, _mm_setr_epi8(  3, 7, 11, 15,   0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14));
+                    __m128i bgr1 = _mm_shuffle_epi8(bgra_4_7, _mm_setr_epi8(0, 1, 2, 4,   3, 7, 11, 15,   5, 6, 8, 9, 10, 12, 13, 14));
+                    __m128i bgr2 = _mm_shuffle_epi8(bgra_8_B, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9,   3, 7, 11, 15,   10, 12, 13, 14));
+                    __m128i bgr3 = _mm_shuffle_epi8(bgra_C_F, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14,   3, 7, 11, 15  ));
 
                     // Align registers and store 16 pixels (48 bytes) at once
-                    _mm_storeu_si128(dst++, _mm_alignr_epi8(bgr1, bgr0, 4));
-                    _mm_storeu_si128(dst++, _mm_alignr_epi8(bgr2, bgr1, 8));
-                    _mm_storeu_si128(dst++, _mm_alignr_epi8(bgr3, bgr2, 12));
+                    _mm_storeu_si128(&dst[i*3], _mm_alignr_epi8(bgr1, bgr0, 4));
+                    _mm_storeu_si128(&dst[i*3+1], _mm_alignr_epi8(bgr2, bgr1, 8));
+                    _mm_storeu_si128(&dst[i*3+2], _mm_alignr_epi8(bgr3, bgr2, 12));
                 }
             }
         }
-#else  // Generic code for when SSSE3 is not available.
+    }
+#endif
+
+    // This templated function unpacks UYVY into RGB8/RGBA8/BGR8/BGRA8, depending on the compile-time parameter FORMAT.
+    // It is expected that all branching outside of the loop control variable will be removed due to constant-folding.
+    template<rs2_format FORMAT> void unpack_uyvy_scalar(byte * const d[], const byte * s, int n)
+    {
+        assert(n % 16 == 0); // All currently supported color resolutions are multiples of 16 pixels. Could easily extend support to other resolutions by copying final n<16 pixels into a zero-padded buffer and recursively calling self for final iteration.
         auto src = reinterpret_cast<const uint8_t *>(s);
         auto dst = reinterpret_cast<uint8_t *>(d[0]);
         for (; n; n -= 16, src += 32)
@@ -744,7 +791,151 @@ namespace librealsense
                 continue;
             }
         }
+    }
+
+#ifdef __SSSE3__
+    template<rs2_format FORMAT> void unpack_uyvy_ssse3(byte * const d[], const byte * s, int n)
+    {
+        assert(n % 16 == 0); // All currently supported color resolutions are multiples of 16 pixels. Could easily extend support to other resolutions by copying final n<16 pixels into a zero-padded buffer and recursively calling self for final iteration.
+        auto src = reinterpret_cast<const __m128i *>(s);
+        auto dst = reinterpret_cast<__m128i *>(d[0]);
+        for (; n; n -= 16)
+        {
+            const __m128i zero = _mm_set1_epi8(0);
+            const __m128i n100 = _mm_set1_epi16(100 << 4);
+            const __m128i n208 = _mm_set1_epi16(208 << 4);
+            const __m128i n298 = _mm_set1_epi16(298 << 4);
+            const __m128i n409 = _mm_set1_epi16(409 << 4);
+            const __m128i n516 = _mm_set1_epi16(516 << 4);
+            const __m128i evens_odds = _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
+
+            // Load 8 UYVY pixels each into two 16-byte registers
+            __m128i s0 = _mm_loadu_si128(src++);
+            __m128i s1 = _mm_loadu_si128(src++);
+
+
+            // Shuffle all Y components to the low order bytes of the register, and all U/V components to the high order bytes
+            const __m128i evens_odd1s_odd3s = _mm_setr_epi8(1, 3, 5, 7, 9, 11, 13, 15, 0, 4, 8, 12, 2, 6, 10, 14); // to get yyyyyyyyuuuuvvvv
+            __m128i yyyyyyyyuuuuvvvv0 = _mm_shuffle_epi8(s0, evens_odd1s_odd3s);
+            __m128i yyyyyyyyuuuuvvvv8 = _mm_shuffle_epi8(s1, evens_odd1s_odd3s);
+
+            // Retrieve all 16 Y components as 16-bit values (8 components per register))
+            __m128i y16__0_7 = _mm_unpacklo_epi8(yyyyyyyyuuuuvvvv0, zero);         // convert to 16 bit
+            __m128i y16__8_F = _mm_unpacklo_epi8(yyyyyyyyuuuuvvvv8, zero);         // convert to 16 bit
+
+
+            // Retrieve all 16 U and V components as 16-bit values (8 components per register)
+            __m128i uv = _mm_unpackhi_epi32(yyyyyyyyuuuuvvvv0, yyyyyyyyuuuuvvvv8); // uuuuuuuuvvvvvvvv
+            __m128i u = _mm_unpacklo_epi8(uv, uv);                                 //  uu uu uu uu uu uu uu uu  u's duplicated
+            __m128i v = _mm_unpackhi_epi8(uv, uv);                                 //  vv vv vv vv vv vv vv vv
+            __m128i u16__0_7 = _mm_unpacklo_epi8(u, zero);                         // convert to 16 bit
+            __m128i u16__8_F = _mm_unpackhi_epi8(u, zero);                         // convert to 16 bit
+            __m128i v16__0_7 = _mm_unpacklo_epi8(v, zero);                         // convert to 16 bit
+            __m128i v16__8_F = _mm_unpackhi_epi8(v, zero);                         // convert to 16 bit
+
+                                                                                   // Compute R, G, B values for first 8 pixels
+            __m128i c16__0_7 = _mm_slli_epi16(_mm_subs_epi16(y16__0_7, _mm_set1_epi16(16)), 4);
+            __m128i d16__0_7 = _mm_slli_epi16(_mm_subs_epi16(u16__0_7, _mm_set1_epi16(128)), 4); // perhaps could have done these u,v to d,e before the duplication
+            __m128i e16__0_7 = _mm_slli_epi16(_mm_subs_epi16(v16__0_7, _mm_set1_epi16(128)), 4);
+            __m128i r16__0_7 = _mm_min_epi16(_mm_set1_epi16(255), _mm_max_epi16(zero, ((_mm_add_epi16(_mm_mulhi_epi16(c16__0_7, n298), _mm_mulhi_epi16(e16__0_7, n409))))));                                                 // (298 * c + 409 * e + 128) ; //
+            __m128i g16__0_7 = _mm_min_epi16(_mm_set1_epi16(255), _mm_max_epi16(zero, ((_mm_sub_epi16(_mm_sub_epi16(_mm_mulhi_epi16(c16__0_7, n298), _mm_mulhi_epi16(d16__0_7, n100)), _mm_mulhi_epi16(e16__0_7, n208)))))); // (298 * c - 100 * d - 208 * e + 128)
+            __m128i b16__0_7 = _mm_min_epi16(_mm_set1_epi16(255), _mm_max_epi16(zero, ((_mm_add_epi16(_mm_mulhi_epi16(c16__0_7, n298), _mm_mulhi_epi16(d16__0_7, n516))))));                                                 // clampbyte((298 * c + 516 * d + 128) >> 8);
+
+                                                                                                                                                                                                                             // Compute R, G, B values for second 8 pixels
+            __m128i c16__8_F = _mm_slli_epi16(_mm_subs_epi16(y16__8_F, _mm_set1_epi16(16)), 4);
+            __m128i d16__8_F = _mm_slli_epi16(_mm_subs_epi16(u16__8_F, _mm_set1_epi16(128)), 4); // perhaps could have done these u,v to d,e before the duplication
+            __m128i e16__8_F = _mm_slli_epi16(_mm_subs_epi16(v16__8_F, _mm_set1_epi16(128)), 4);
+            __m128i r16__8_F = _mm_min_epi16(_mm_set1_epi16(255), _mm_max_epi16(zero, ((_mm_add_epi16(_mm_mulhi_epi16(c16__8_F, n298), _mm_mulhi_epi16(e16__8_F, n409))))));                                                 // (298 * c + 409 * e + 128) ; //
+            __m128i g16__8_F = _mm_min_epi16(_mm_set1_epi16(255), _mm_max_epi16(zero, ((_mm_sub_epi16(_mm_sub_epi16(_mm_mulhi_epi16(c16__8_F, n298), _mm_mulhi_epi16(d16__8_F, n100)), _mm_mulhi_epi16(e16__8_F, n208)))))); // (298 * c - 100 * d - 208 * e + 128)
+            __m128i b16__8_F = _mm_min_epi16(_mm_set1_epi16(255), _mm_max_epi16(zero, ((_mm_add_epi16(_mm_mulhi_epi16(c16__8_F, n298), _mm_mulhi_epi16(d16__8_F, n516))))));                                                 // clampbyte((298 * c + 516 * d + 128) >> 8);
+
+            if (FORMAT == RS2_FORMAT_RGB8 || FORMAT == RS2_FORMAT_RGBA8)
+            {
+                // Shuffle separate R, G, B values into four registers storing four pixels each in (R, G, B, A) order
+                __m128i rg8__0_7 = _mm_unpacklo_epi8(_mm_shuffle_epi8(r16__0_7, evens_odds), _mm_shuffle_epi8(g16__0_7, evens_odds)); // hi to take the odds which are the upper bytes we care about
+                __m128i ba8__0_7 = _mm_unpacklo_epi8(_mm_shuffle_epi8(b16__0_7, evens_odds), _mm_set1_epi8(-1));
+                __m128i rgba_0_3 = _mm_unpacklo_epi16(rg8__0_7, ba8__0_7);
+                __m128i rgba_4_7 = _mm_unpackhi_epi16(rg8__0_7, ba8__0_7);
+
+                __m128i rg8__8_F = _mm_unpacklo_epi8(_mm_shuffle_epi8(r16__8_F, evens_odds), _mm_shuffle_epi8(g16__8_F, evens_odds)); // hi to take the odds which are the upper bytes we care about
+                __m128i ba8__8_F = _mm_unpacklo_epi8(_mm_shuffle_epi8(b16__8_F, evens_odds), _mm_set1_epi8(-1));
+                __m128i rgba_8_B = _mm_unpacklo_epi16(rg8__8_F, ba8__8_F);
+                __m128i rgba_C_F = _mm_unpackhi_epi16(rg8__8_F, ba8__8_F);
+
+                if (FORMAT == RS2_FORMAT_RGBA8)
+                {
+                    // Store 16 pixels (64 bytes) at once
+                    _mm_storeu_si128(dst++, rgba_0_3);
+                    _mm_storeu_si128(dst++, rgba_4_7);
+                    _mm_storeu_si128(dst++, rgba_8_B);
+                    _mm_storeu_si128(dst++, rgba_C_F);
+                }
+
+                if (FORMAT == RS2_FORMAT_RGB8)
+                {
+                    // Shuffle rgb triples to the start and end of each register
+                    __m128i rgb0 = _mm_shuffle_epi8(rgba_0_3, _mm_setr_epi8(3, 7, 11, 15, 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14));
+                    __m128i rgb1 = _mm_shuffle_epi8(rgba_4_7, _mm_setr_epi8(0, 1, 2, 4, 3, 7, 11, 15, 5, 6, 8, 9, 10, 12, 13, 14));
+                    __m128i rgb2 = _mm_shuffle_epi8(rgba_8_B, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 3, 7, 11, 15, 10, 12, 13, 14));
+                    __m128i rgb3 = _mm_shuffle_epi8(rgba_C_F, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, 3, 7, 11, 15));
+
+                    // Align registers and store 16 pixels (48 bytes) at once
+                    _mm_storeu_si128(dst++, _mm_alignr_epi8(rgb1, rgb0, 4));
+                    _mm_storeu_si128(dst++, _mm_alignr_epi8(rgb2, rgb1, 8));
+                    _mm_storeu_si128(dst++, _mm_alignr_epi8(rgb3, rgb2, 12));
+                }
+            }
+
+            if (FORMAT == RS2_FORMAT_BGR8 || FORMAT == RS2_FORMAT_BGRA8)
+            {
+                // Shuffle separate R, G, B values into four registers storing four pixels each in (B, G, R, A) order
+                __m128i bg8__0_7 = _mm_unpacklo_epi8(_mm_shuffle_epi8(b16__0_7, evens_odds), _mm_shuffle_epi8(g16__0_7, evens_odds)); // hi to take the odds which are the upper bytes we care about
+                __m128i ra8__0_7 = _mm_unpacklo_epi8(_mm_shuffle_epi8(r16__0_7, evens_odds), _mm_set1_epi8(-1));
+                __m128i bgra_0_3 = _mm_unpacklo_epi16(bg8__0_7, ra8__0_7);
+                __m128i bgra_4_7 = _mm_unpackhi_epi16(bg8__0_7, ra8__0_7);
+
+                __m128i bg8__8_F = _mm_unpacklo_epi8(_mm_shuffle_epi8(b16__8_F, evens_odds), _mm_shuffle_epi8(g16__8_F, evens_odds)); // hi to take the odds which are the upper bytes we care about
+                __m128i ra8__8_F = _mm_unpacklo_epi8(_mm_shuffle_epi8(r16__8_F, evens_odds), _mm_set1_epi8(-1));
+                __m128i bgra_8_B = _mm_unpacklo_epi16(bg8__8_F, ra8__8_F);
+                __m128i bgra_C_F = _mm_unpackhi_epi16(bg8__8_F, ra8__8_F);
+
+                if (FORMAT == RS2_FORMAT_BGRA8)
+                {
+                    // Store 16 pixels (64 bytes) at once
+                    _mm_storeu_si128(dst++, bgra_0_3);
+                    _mm_storeu_si128(dst++, bgra_4_7);
+                    _mm_storeu_si128(dst++, bgra_8_B);
+                    _mm_storeu_si128(dst++, bgra_C_F);
+                }
+
+                if (FORMAT == RS2_FORMAT_BGR8)
+                {
+                    // Shuffle rgb triples to the start and end of each register
+                    __m128i bgr0 = _mm_shuffle_epi8(bgra_0_3, _mm_setr_epi8(3, 7, 11, 15, 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14));
+                    __m128i bgr1 = _mm_shuffle_epi8(bgra_4_7, _mm_setr_epi8(0, 1, 2, 4, 3, 7, 11, 15, 5, 6, 8, 9, 10, 12, 13, 14));
+                    __m128i bgr2 = _mm_shuffle_epi8(bgra_8_B, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 3, 7, 11, 15, 10, 12, 13, 14));
+                    __m128i bgr3 = _mm_shuffle_epi8(bgra_C_F, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, 3, 7, 11, 15));
+
+                    // Align registers and store 16 pixels (48 bytes) at once
+                    _mm_storeu_si128(dst++, _mm_alignr_epi8(bgr1, bgr0, 4));
+                    _mm_storeu_si128(dst++, _mm_alignr_epi8(bgr2, bgr1, 8));
+                    _mm_storeu_si128(dst++, _mm_alignr_epi8(bgr3, bgr2, 12));
+                }
+            }
+        }
+    }
 #endif
+
+    template<rs2_format FORMAT> void unpack_yuy2(byte * const d[], const byte * s, int n)
+    {
+        static const auto unpack = select_unpacker(&unpack_yuy2_scalar<FORMAT>, SSSE3_UNPACKER(unpack_yuy2_ssse3<FORMAT>), nullptr);
+        unpack(d, s, n);
+    }
+
+    template<rs2_format FORMAT> void unpack_uyvy(byte * const d[], const byte * s, int n)
+    {
+        static const auto unpack = select_unpacker(&unpack_uyvy_scalar<FORMAT>, SSSE3_UNPACKER(unpack_uyvy_ssse3<FORMAT>), nullptr);
+        unpack(d, s, n);
     }
 
     //////////////////////////////////////
@@ -763,7 +954,7 @@ namespace librealsense
     }
 
     struct y8i_pixel { uint8_t l, r; };
-    void unpack_y8_y8_from_y8i(byte * const dest[], const byte * source, int count)
+    void unpack_y8_y8_from_y8i_scalar(byte * const dest[], const byte * source, int count)
     {
         split_frame(dest, count, reinterpret_cast<const y8i_pixel *>(source),
             [](const y8i_pixel & p) -> uint8_t { return p.l; },
@@ -771,7 +962,7 @@ namespace librealsense
     }
 
     struct y12i_pixel { uint8_t rl : 8, rh : 4, ll : 4, lh : 8; int l() const { return lh << 4 | ll; } int r() const { return rh << 8 | rl; } };
-    void unpack_y16_y16_from_y12i_10(byte * const dest[], const byte * source, int count)
+    void unpack_y16_y16_from_y12i_10_scalar(byte * const dest[], const byte * source, int count)
     {
         split_frame(dest, count, reinterpret_cast<const y12i_pixel *>(source),
             [](const y12i_pixel & p) -> uint16_t { return p.l() << 6 | p.l() >> 4; },  // We want to convert 10-bit data to 16-bit data
@@ -779,48 +970,489 @@ namespace librealsense
     }
 
     struct f200_inzi_pixel { uint16_t z16; uint8_t y8; };
-    void unpack_z16_y8_from_f200_inzi(byte * const dest[], const byte * source, int count)
+    void unpack_z16_y8_from_f200_inzi_scalar(byte * const dest[], const byte * source, int count)
     {
         split_frame(dest, count, reinterpret_cast<const f200_inzi_pixel *>(source),
             [](const f200_inzi_pixel & p) -> uint16_t { return p.z16; },
             [](const f200_inzi_pixel & p) -> uint8_t { return p.y8; });
     }
 
-    void unpack_z16_y16_from_f200_inzi(byte * const dest[], const byte * source, int count)
+    void unpack_z16_y16_from_f200_inzi_scalar(byte * const dest[], const byte * source, int count)
     {
         split_frame(dest, count, reinterpret_cast<const f200_inzi_pixel *>(source),
             [](const f200_inzi_pixel & p) -> uint16_t { return p.z16; },
             [](const f200_inzi_pixel & p) -> uint16_t { return p.y8 | p.y8 << 8; });
     }
 
+    void unpack_rgb_from_bgr_scalar(byte * const dest[], const byte * source, int count)
+    {
+        auto in = reinterpret_cast<const uint8_t *>(source);
+        auto out = reinterpret_cast<uint8_t *>(dest[0]);
+
+        librealsense::copy(out, in, count * 3);
+        for (auto i = 0; i < count; i++)
+        {
+            std::swap(out[i * 3], out[i * 3 + 2]);
+        }
+    }
+
+#ifdef __SSSE3__
+    void unpack_y8_y8_from_y8i_ssse3(byte * const dest[], const byte * source, int count)
+    {
+        auto src = reinterpret_cast<const __m128i *>(source);
+        auto left = reinterpret_cast<__m128i *>(dest[0]);
+        auto right = reinterpret_cast<__m128i *>(dest[1]);
+        const __m128i evens_odds = _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
+        int i = 0;
+        for (; i + 16 <= count; i += 16, src += 2)
+        {
+            // Reorder 8 pixels into their 8 left values followed by their 8 right values
+            __m128i lr0 = _mm_shuffle_epi8(_mm_loadu_si128(src), evens_odds);
+            __m128i lr1 = _mm_shuffle_epi8(_mm_loadu_si128(src + 1), evens_odds);
+            _mm_storeu_si128(left++, _mm_unpacklo_epi64(lr0, lr1));
+            _mm_storeu_si128(right++, _mm_unpackhi_epi64(lr0, lr1));
+        }
+        unpack_tail(&unpack_y8_y8_from_y8i_scalar, dest, source, count, i, 2, 1, 1);
+    }
+
+    void unpack_y16_y16_from_y12i_10_ssse3(byte * const dest[], const byte * source, int count)
+    {
+        auto src = reinterpret_cast<const uint8_t *>(source);
+        auto left = reinterpret_cast<__m128i *>(dest[0]);
+        auto right = reinterpret_cast<__m128i *>(dest[1]);
+        // Gather the overlapping words of 4 pixels (12 bytes): right is bytes 0-1 masked to 12 bits, left is bytes 1-2 shifted by 4
+        const __m128i words = _mm_setr_epi8(0, 1, 3, 4, 6, 7, 9, 10, 1, 2, 4, 5, 7, 8, 10, 11);
+        const __m128i right_bits = _mm_set1_epi16(0x0fff);
+        int i = 0;
+        // 8 pixels span 24 bytes but are read by two 16 byte loads, so stay clear of the end of the source buffer
+        for (; i + 10 <= count; i += 8, src += 24)
+        {
+            __m128i w0 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src)), words);
+            __m128i w1 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 12)), words);
+            __m128i l = _mm_srli_epi16(_mm_unpackhi_epi64(w0, w1), 4);
+            __m128i r = _mm_and_si128(_mm_unpacklo_epi64(w0, w1), right_bits);
+            _mm_storeu_si128(left++, _mm_or_si128(_mm_slli_epi16(l, 6), _mm_srli_epi16(l, 4)));
+            _mm_storeu_si128(right++, _mm_or_si128(_mm_slli_epi16(r, 6), _mm_srli_epi16(r, 4)));
+        }
+        unpack_tail(&unpack_y16_y16_from_y12i_10_scalar, dest, source, count, i, 3, 2, 2);
+    }
+
+    template<bool Y16> void unpack_z16_from_f200_inzi_ssse3(byte * const dest[], const byte * source, int count)
+    {
+        auto src = reinterpret_cast<const uint8_t *>(source);
+        auto z = reinterpret_cast<__m128i *>(dest[0]);
+        auto y = dest[1];
+        // Gather the depth words of 4 pixels (12 bytes) followed by their luminance bytes
+        const __m128i z_then_y = _mm_setr_epi8(0, 1, 3, 4, 6, 7, 9, 10, 2, 5, 8, 11, -1, -1, -1, -1);
+        int i = 0;
+        // 8 pixels span 24 bytes but are read by two 16 byte loads, so stay clear of the end of the source buffer
+        for (; i + 10 <= count; i += 8, src += 24)
+        {
+            __m128i zy0 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src)), z_then_y);
+            __m128i zy1 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 12)), z_then_y);
+            _mm_storeu_si128(z++, _mm_unpacklo_epi64(zy0, zy1));
+
+            __m128i y8 = _mm_unpacklo_epi32(_mm_srli_si128(zy0, 8), _mm_srli_si128(zy1, 8));
+            if (Y16)
+            {
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(y), _mm_unpacklo_epi8(y8, y8));
+                y += 16;
+            }
+            else
+            {
+                _mm_storel_epi64(reinterpret_cast<__m128i *>(y), y8);
+                y += 8;
+            }
+        }
+        if (Y16) unpack_tail(&unpack_z16_y16_from_f200_inzi_scalar, dest, source, count, i, 3, 2, 2);
+        else     unpack_tail(&unpack_z16_y8_from_f200_inzi_scalar, dest, source, count, i, 3, 2, 1);
+    }
+
+    void unpack_rgb_from_bgr_ssse3(byte * const dest[], const byte * source, int count)
+    {
+        auto src = reinterpret_cast<const uint8_t *>(source);
+        auto dst = reinterpret_cast<uint8_t *>(dest[0]);
+        // Swap the blue and red bytes of 5 pixels (15 bytes), the 16th byte is rewritten by the next iteration
+        const __m128i swap_rb = _mm_setr_epi8(2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 14, 13, 12, 15);
+        int i = 0;
+        for (; i + 6 <= count; i += 5, src += 15, dst += 15)
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dst),
+                _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src)), swap_rb));
+        }
+        unpack_tail(&unpack_rgb_from_bgr_scalar, dest, source, count, i, 3, 3);
+    }
+
+    AVX2_TARGET void unpack_y8_y8_from_y8i_avx2(byte * const dest[], const byte * source, int count)
+    {
+        auto src = reinterpret_cast<const __m256i *>(source);
+        auto left = reinterpret_cast<__m256i *>(dest[0]);
+        auto right = reinterpret_cast<__m256i *>(dest[1]);
+        const __m256i evens_odds = _mm256_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15,
+                                                    0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
+        int i = 0;
+        for (; i + 32 <= count; i += 32, src += 2)
+        {
+            // Shuffling operates per 128-bit lane, move all the left values of 16 pixels to the low lane
+            __m256i lr0 = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(_mm256_loadu_si256(src), evens_odds), 0xd8);
+            __m256i lr1 = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(_mm256_loadu_si256(src + 1), evens_odds), 0xd8);
+            _mm256_storeu_si256(left++, _mm256_permute2x128_si256(lr0, lr1, 0x20));
+            _mm256_storeu_si256(right++, _mm256_permute2x128_si256(lr0, lr1, 0x31));
+        }
+        unpack_tail(&unpack_y8_y8_from_y8i_scalar, dest, source, count, i, 2, 1, 1);
+    }
+#endif
+
+    void unpack_y8_y8_from_y8i(byte * const dest[], const byte * source, int count)
+    {
+        static const auto unpack = select_unpacker(&unpack_y8_y8_from_y8i_scalar, SSSE3_UNPACKER(unpack_y8_y8_from_y8i_ssse3),
+                                                   AVX2_UNPACKER(unpack_y8_y8_from_y8i_avx2));
+        unpack(dest, source, count);
+    }
+
+    void unpack_y16_y16_from_y12i_10(byte * const dest[], const byte * source, int count)
+    {
+        static const auto unpack = select_unpacker(&unpack_y16_y16_from_y12i_10_scalar, SSSE3_UNPACKER(unpack_y16_y16_from_y12i_10_ssse3), nullptr);
+        unpack(dest, source, count);
+    }
+
+    void unpack_z16_y8_from_f200_inzi(byte * const dest[], const byte * source, int count)
+    {
+        static const auto unpack = select_unpacker(&unpack_z16_y8_from_f200_inzi_scalar, SSSE3_UNPACKER(unpack_z16_from_f200_inzi_ssse3<false>), nullptr);
+        unpack(dest, source, count);
+    }
+
+    void unpack_z16_y16_from_f200_inzi(byte * const dest[], const byte * source, int count)
+    {
+        static const auto unpack = select_unpacker(&unpack_z16_y16_from_f200_inzi_scalar, SSSE3_UNPACKER(unpack_z16_from_f200_inzi_ssse3<true>), nullptr);
+        unpack(dest, source, count);
+    }
+
+    // The infrared plane is followed by the depth plane, which is copied as is
     void unpack_z16_y8_from_sr300_inzi(byte * const dest[], const byte * source, int count)
     {
         auto in = reinterpret_cast<const uint16_t *>(source);
-        auto out_ir = reinterpret_cast<uint8_t *>(dest[1]);
-        for(int i=0; i<count; ++i) *out_ir++ = *in++ >> 2;
-        librealsense::copy(dest[0], in, count*2);
+        byte * const ir[] = { dest[1] };
+        unpack_y8_from_y16_10(ir, source, count);
+        librealsense::copy(dest[0], in + count, count*2);
     }
 
     void unpack_z16_y16_from_sr300_inzi (byte * const dest[], const byte * source, int count)
     {
         auto in = reinterpret_cast<const uint16_t *>(source);
-        auto out_ir = reinterpret_cast<uint16_t *>(dest[1]);
-        for(int i=0; i<count; ++i) *out_ir++ = *in++ << 6;
-        librealsense::copy(dest[0], in, count*2);
+        byte * const ir[] = { dest[1] };
+        unpack_y16_from_y16_10(ir, source, count);
+        librealsense::copy(dest[0], in + count, count*2);
     }
 
     void unpack_rgb_from_bgr(byte * const dest[], const byte * source, int count)
     {
-        auto in = reinterpret_cast<const uint8_t *>(source);
-        auto out = reinterpret_cast<uint8_t *>(dest[0]);
+        static const auto unpack = select_unpacker(&unpack_rgb_from_bgr_scalar, SSSE3_UNPACKER(unpack_rgb_from_bgr_ssse3), nullptr);
+        unpack(dest, source, count);
+    }
 
-        librealsense::copy(out, in, count * 3);
-        for (auto i = 0; i < count; i++)
+    ////////////////////////////////////////////
+    // Conversion into buffers of applications //
+    ////////////////////////////////////////////
+
+    // RGB8 or BGR8 to RGBA8 or BGRA8 with opaque alpha, swapping red and blue when SWAP
+    template<bool SWAP> void unpack_rgba_from_rgb_scalar(byte * const dest[], const byte * source, int count)
+    {
+        auto dst = dest[0];
+        for (int i = 0; i < count; i++, source += 3, dst += 4)
         {
-            std::swap(out[i * 3], out[i * 3 + 2]);
+            dst[0] = source[SWAP ? 2 : 0];
+            dst[1] = source[1];
+            dst[2] = source[SWAP ? 0 : 2];
+            dst[3] = 255;
         }
     }
 
+#ifdef __SSSE3__
+    template<bool SWAP> void unpack_rgba_from_rgb_ssse3(byte * const dest[], const byte * source, int count)
+    {
+        const __m128i spread = SWAP ? _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1)
+                                    : _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+        const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xff000000));
+        int i = 0;
+        // 16 bytes are loaded for the 12 of 4 pixels, the loads stay within the source
+        for (; i + 6 <= count; i += 4)
+        {
+            __m128i rgb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + i * 3));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(dest[0] + i * 4), _mm_or_si128(_mm_shuffle_epi8(rgb, spread), alpha));
+        }
+        unpack_tail(&unpack_rgba_from_rgb_scalar<SWAP>, dest, source, count, i, 3, 4);
+    }
+#endif
+
+    template<bool SWAP> void unpack_rgba_from_rgb(byte * const dest[], const byte * source, int count)
+    {
+        static const auto unpack = select_unpacker(&unpack_rgba_from_rgb_scalar<SWAP>, SSSE3_UNPACKER(unpack_rgba_from_rgb_ssse3<SWAP>), nullptr);
+        unpack(dest, source, count);
+    }
+
+    // Z16 to depth in meters. The vectorized variants convert and multiply exactly as the scalar one, with the same results
+    typedef void(*depth_to_meters_function)(float * dest, const uint16_t * source, int count, float units);
+
+    void convert_z16_to_meters_scalar(float * dest, const uint16_t * source, int count, float units)
+    {
+        for (int i = 0; i < count; i++) dest[i] = source[i] * units;
+    }
+
+#ifdef __SSSE3__
+    void convert_z16_to_meters_sse(float * dest, const uint16_t * source, int count, float units)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128 scale = _mm_set1_ps(units);
+        int i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m128i z = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + i));
+            _mm_storeu_ps(dest + i, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(z, zero)), scale));
+            _mm_storeu_ps(dest + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(z, zero)), scale));
+        }
+        convert_z16_to_meters_scalar(dest + i, source + i, count - i, units);
+    }
+#endif
+
+    void convert_z16_to_meters(float * dest, const uint16_t * source, int count, float units)
+    {
+        static const depth_to_meters_function convert =
+#ifdef __SSSE3__
+            cpu_supports(CPU_FEATURE_SSSE3) ? &convert_z16_to_meters_sse :
+#endif
+            &convert_z16_to_meters_scalar;
+        convert(dest, source, count, units);
+    }
+
+    // Row conversions of the unpackers. YUY2 and UYVY unpack whole blocks of 16 pixels
+    struct image_conversion { rs2_format from, to; unpack_function unpack; int block; };
+    static const image_conversion image_conversions[] = {
+        { RS2_FORMAT_YUYV, RS2_FORMAT_RGB8,  &unpack_yuy2<RS2_FORMAT_RGB8>,  16 }, { RS2_FORMAT_YUYV, RS2_FORMAT_BGR8,  &unpack_yuy2<RS2_FORMAT_BGR8>,  16 },
+        { RS2_FORMAT_YUYV, RS2_FORMAT_RGBA8, &unpack_yuy2<RS2_FORMAT_RGBA8>, 16 }, { RS2_FORMAT_YUYV, RS2_FORMAT_BGRA8, &unpack_yuy2<RS2_FORMAT_BGRA8>, 16 },
+        { RS2_FORMAT_YUYV, RS2_FORMAT_Y8,    &unpack_yuy2<RS2_FORMAT_Y8>,    16 }, { RS2_FORMAT_YUYV, RS2_FORMAT_Y16,   &unpack_yuy2<RS2_FORMAT_Y16>,   16 },
+        { RS2_FORMAT_UYVY, RS2_FORMAT_RGB8,  &unpack_uyvy<RS2_FORMAT_RGB8>,  16 }, { RS2_FORMAT_UYVY, RS2_FORMAT_BGR8,  &unpack_uyvy<RS2_FORMAT_BGR8>,  16 },
+        { RS2_FORMAT_UYVY, RS2_FORMAT_RGBA8, &unpack_uyvy<RS2_FORMAT_RGBA8>, 16 }, { RS2_FORMAT_UYVY, RS2_FORMAT_BGRA8, &unpack_uyvy<RS2_FORMAT_BGRA8>, 16 },
+        { RS2_FORMAT_RGB8, RS2_FORMAT_BGR8,  &unpack_rgb_from_bgr,            1 }, { RS2_FORMAT_BGR8, RS2_FORMAT_RGB8,  &unpack_rgb_from_bgr,            1 },
+        { RS2_FORMAT_RGB8, RS2_FORMAT_RGBA8, &unpack_rgba_from_rgb<false>,    1 }, { RS2_FORMAT_RGB8, RS2_FORMAT_BGRA8, &unpack_rgba_from_rgb<true>,     1 },
+        { RS2_FORMAT_BGR8, RS2_FORMAT_BGRA8, &unpack_rgba_from_rgb<false>,    1 }, { RS2_FORMAT_BGR8, RS2_FORMAT_RGBA8, &unpack_rgba_from_rgb<true>,     1 },
+        { RS2_FORMAT_Y8,   RS2_FORMAT_Y16,   &unpack_y16_from_y8,             1 },
+    };
+
+    // Unpack a row, the pixels past the last whole block through a zero padded block
+    static void unpack_row(const image_conversion & conversion, byte * dest, const byte * source, int width, int source_bpp, int dest_bpp)
+    {
+        auto whole = width - width % conversion.block;
+        byte * const d[] = { dest };
+        if (whole) conversion.unpack(d, source, whole);
+        if (whole == width) return;
+
+        std::vector<byte> padded_source(conversion.block * source_bpp), padded_dest(conversion.block * dest_bpp);
+        memcpy(padded_source.data(), source + whole * source_bpp, (width - whole) * source_bpp);
+        byte * const p[] = { padded_dest.data() };
+        conversion.unpack(p, padded_source.data(), conversion.block);
+        memcpy(dest + whole * dest_bpp, padded_dest.data(), (width - whole) * dest_bpp);
+    }
+
+    // BT.601 limited range, the inverse of the conversion of the YUY2 unpackers
+    inline uint8_t luma_of(int r, int g, int b) { return static_cast<uint8_t>(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16); }
+    inline uint8_t u_of(int r, int g, int b) { return static_cast<uint8_t>(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128); }
+    inline uint8_t v_of(int r, int g, int b) { return static_cast<uint8_t>(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128); }
+
+    // Two rows of the source into two rows of the luma plane and one row of the chroma plane, whose samples average
+    // the 2x2 pixels they cover
+    static void convert_rows_to_nv12(byte * luma0, byte * luma1, byte * chroma, const byte * row0, const byte * row1, int width, rs2_format format)
+    {
+        switch (format)
+        {
+        case RS2_FORMAT_YUYV:
+        case RS2_FORMAT_UYVY:
+        {
+            auto luma_offset = format == RS2_FORMAT_YUYV ? 0 : 1, chroma_offset = 1 - luma_offset;
+            if (format == RS2_FORMAT_YUYV)
+            {
+                image_conversion luma = { RS2_FORMAT_YUYV, RS2_FORMAT_Y8, &unpack_yuy2<RS2_FORMAT_Y8>, 16 };
+                unpack_row(luma, luma0, row0, width, 2, 1);
+                unpack_row(luma, luma1, row1, width, 2, 1);
+            }
+            else
+            {
+                for (int x = 0; x < width; x++)
+                {
+                    luma0[x] = row0[x * 2 + luma_offset];
+                    luma1[x] = row1[x * 2 + luma_offset];
+                }
+            }
+            // Chroma of a macropixel of 2 pixels, U first
+            for (int x = 0; x < width; x += 2)
+            {
+                chroma[x] = static_cast<uint8_t>((row0[x * 2 + chroma_offset] + row1[x * 2 + chroma_offset] + 1) / 2);
+                chroma[x + 1] = static_cast<uint8_t>((row0[x * 2 + 2 + chroma_offset] + row1[x * 2 + 2 + chroma_offset] + 1) / 2);
+            }
+            break;
+        }
+        case RS2_FORMAT_Y8:
+            memcpy(luma0, row0, width);
+            memcpy(luma1, row1, width);
+            memset(chroma, 128, width);
+            break;
+        default:
+        {
+            auto bpp = format == RS2_FORMAT_RGB8 || format == RS2_FORMAT_BGR8 ? 3 : 4;
+            auto r = format == RS2_FORMAT_RGB8 || format == RS2_FORMAT_RGBA8 ? 0 : 2, b = 2 - r;
+            for (int x = 0; x < width; x += 2)
+            {
+                auto p00 = row0 + x * bpp, p01 = p00 + bpp, p10 = row1 + x * bpp, p11 = p10 + bpp;
+                luma0[x] = luma_of(p00[r], p00[1], p00[b]);
+                luma0[x + 1] = luma_of(p01[r], p01[1], p01[b]);
+                luma1[x] = luma_of(p10[r], p10[1], p10[b]);
+                luma1[x + 1] = luma_of(p11[r], p11[1], p11[b]);
+
+                auto sum_r = p00[r] + p01[r] + p10[r] + p11[r] + 2;
+                auto sum_g = p00[1] + p01[1] + p10[1] + p11[1] + 2;
+                auto sum_b = p00[b] + p01[b] + p10[b] + p11[b] + 2;
+                chroma[x] = u_of(sum_r / 4, sum_g / 4, sum_b / 4);
+                chroma[x + 1] = v_of(sum_r / 4, sum_g / 4, sum_b / 4);
+            }
+            break;
+        }
+        }
+    }
+
+    void convert_image(byte * dest, int dest_stride, rs2_format dest_format, const byte * source, int source_stride, rs2_format source_format,
+                       int width, int height, float depth_units)
+    {
+        auto dest_row_bytes = dest_format == RS2_FORMAT_NV12 ? width : static_cast<int>(get_image_size(width, 1, dest_format));
+        if (!dest_stride) dest_stride = dest_row_bytes;
+        if (dest_stride < dest_row_bytes)
+            throw invalid_value_exception(to_string() << "Stride " << dest_stride << " is too short for " << width << " pixels of " << dest_format);
+
+        if (source_format == dest_format && dest_format != RS2_FORMAT_NV12)
+        {
+            auto row_bytes = static_cast<size_t>(dest_row_bytes);
+            if (dest_stride == source_stride)
+                librealsense::copy(dest, source, static_cast<size_t>(dest_stride) * (height - 1) + row_bytes);
+            else
+                for (int y = 0; y < height; y++)
+                    librealsense::copy(dest + y * dest_stride, source + y * source_stride, row_bytes);
+            return;
+        }
+
+        if (source_format == RS2_FORMAT_Z16 && dest_format == RS2_FORMAT_DISTANCE)
+        {
+            for (int y = 0; y < height; y++)
+                convert_z16_to_meters(reinterpret_cast<float *>(dest + y * dest_stride), reinterpret_cast<const uint16_t *>(source + y * source_stride), width, depth_units);
+            return;
+        }
+
+        if (dest_format == RS2_FORMAT_NV12)
+        {
+            if (source_format != RS2_FORMAT_YUYV && source_format != RS2_FORMAT_UYVY && source_format != RS2_FORMAT_Y8 &&
+                source_format != RS2_FORMAT_RGB8 && source_format != RS2_FORMAT_BGR8 && source_format != RS2_FORMAT_RGBA8 && source_format != RS2_FORMAT_BGRA8)
+                throw invalid_value_exception(to_string() << "Converting " << source_format << " to " << dest_format << " is not supported");
+            if (width % 2 || height % 2)
+                throw invalid_value_exception(to_string() << "Converting to " << dest_format << " requires an even width and height, not " << width << "x" << height);
+
+            auto chroma = dest + dest_stride * height;
+            for (int y = 0; y < height; y += 2)
+                convert_rows_to_nv12(dest + y * dest_stride, dest + (y + 1) * dest_stride, chroma + y / 2 * dest_stride,
+                                     source + y * source_stride, source + (y + 1) * source_stride, width, source_format);
+            return;
+        }
+
+        for (auto&& conversion : image_conversions)
+        {
+            if (conversion.from != source_format || conversion.to != dest_format) continue;
+            auto source_bpp = get_image_bpp(source_format) / 8, dest_bpp = get_image_bpp(dest_format) / 8;
+            for (int y = 0; y < height; y++)
+                unpack_row(conversion, dest + y * dest_stride, source + y * source_stride, width, source_bpp, dest_bpp);
+            return;
+        }
+        throw invalid_value_exception(to_string() << "Converting " << source_format << " to " << dest_format << " is not supported");
+    }
+
+    ///////////////////////////////
+    // Parallel unpacking support //
+    ///////////////////////////////
+
+    // Unpackers where every output pixel depends only on the source pixel at the same index, along with
+    // the source bytes each pixel takes. Any range of pixels of a frame can be unpacked by them independently
+    struct band_unpacker { unpack_function unpack; int source_bpp; };
+    static const band_unpacker band_unpackers[] = {
+        { &copy_pixels<1>, 1 },                         { &copy_pixels<2>, 2 },
+        { &unpack_y16_from_y8, 1 },                     { &unpack_y16_from_y16_10, 2 },
+        { &unpack_y8_from_y16_10, 2 },                  { &unpack_y8_y8_from_y8i, 2 },
+        { &unpack_y16_y16_from_y12i_10, 3 },            { &unpack_z16_y8_from_f200_inzi, 3 },
+        { &unpack_z16_y16_from_f200_inzi, 3 },          { &unpack_rgb_from_bgr, 3 },
+        { &unpack_yuy2<RS2_FORMAT_Y8>, 2 },             { &unpack_yuy2<RS2_FORMAT_Y16>, 2 },
+        { &unpack_yuy2<RS2_FORMAT_RGB8>, 2 },           { &unpack_yuy2<RS2_FORMAT_RGBA8>, 2 },
+        { &unpack_yuy2<RS2_FORMAT_BGR8>, 2 },           { &unpack_yuy2<RS2_FORMAT_BGRA8>, 2 },
+        { &unpack_uyvy<RS2_FORMAT_RGB8>, 2 },           { &unpack_uyvy<RS2_FORMAT_RGBA8>, 2 },
+        { &unpack_uyvy<RS2_FORMAT_BGR8>, 2 },           { &unpack_uyvy<RS2_FORMAT_BGRA8>, 2 },
+    };
+
+    int get_band_source_bpp(const pixel_format_unpacker & unpacker)
+    {
+        for (auto&& u : band_unpackers)
+            if (u.unpack == unpacker.unpack) return u.source_bpp;
+        return 0;
+    }
+
+    void unpack_in_bands(worker_pool & pool, const pixel_format_unpacker & unpacker, byte * const dest[], const byte * source, int width, int height, int bands)
+    {
+        auto source_bpp = get_band_source_bpp(unpacker);
+        if (!source_bpp) throw invalid_value_exception("unpacker does not support splitting frames into bands");
+
+        std::vector<int> dest_bpp;
+        for (auto&& output : unpacker.outputs) dest_bpp.push_back(get_image_bpp(output.second) / 8);
+
+        // Bands start on row boundaries, rounded down to whole 16 pixel blocks as required by the YUY2 unpackers
+        bands = std::max(1, std::min(bands, height));
+        auto rows_per_band = (height + bands - 1) / bands;
+        auto band_start = [=](int band) { return band >= bands ? width * height : (band * rows_per_band * width) & ~15; };
+
+        pool.run(bands, [&](int band)
+        {
+            auto first = band_start(band);
+            auto count = band_start(band + 1) - first;
+            if (count <= 0) return;
+
+            std::vector<byte *> band_dest;
+            for (size_t i = 0; i < dest_bpp.size(); i++) band_dest.push_back(dest[i] + first * dest_bpp[i]);
+            unpacker.unpack(band_dest.data(), source + first * source_bpp, count);
+        });
+    }
+
+    ////////////////////
+    // MJPEG decoding //
+    ////////////////////
+
+#ifdef RS2_USE_TURBOJPEG
+    // libjpeg-turbo decodes with its SIMD IDCT and color conversion straight into the requested format
+    // Each thread keeps its own decompressor, so the streams of several cameras are decoded concurrently
+    template<int TJ_FORMAT> void decode_mjpeg(byte * const dest[], const byte * source, size_t size, int width, int height)
+    {
+        static thread_local std::unique_ptr<void, int(*)(tjhandle)> decompressor(tjInitDecompress(), &tjDestroy);
+        if (!decompressor)
+        {
+            LOG_ERROR("Failed to create a JPEG decompressor: " << tjGetErrorStr());
+            return;
+        }
+
+        int jpeg_width, jpeg_height, subsampling, colorspace;
+        if (tjDecompressHeader3(decompressor.get(), source, static_cast<unsigned long>(size), &jpeg_width, &jpeg_height, &subsampling, &colorspace) != 0 ||
+            jpeg_width != width || jpeg_height != height)
+        {
+            LOG_WARNING("Corrupted MJPEG frame of " << size << " bytes");
+            return;
+        }
+
+        // Frames cut short by the transport decode with a warning, their missing rows are left gray
+        if (tjDecompress2(decompressor.get(), source, static_cast<unsigned long>(size), dest[0], width, 0, height, TJ_FORMAT, TJFLAG_FASTDCT | TJFLAG_NOREALLOC) != 0)
+            LOG_WARNING("Failed to decode MJPEG frame: " << tjGetErrorStr());
+    }
+#endif
+
     //////////////////////////
     // Native pixel formats //
     //////////////////////////
@@ -841,7 +1473,8 @@ namespace librealsense
 
     const native_pixel_format pf_y8         = { 'GREY', 1, 1,{  { true, &copy_pixels<1>,                                { { { RS2_STREAM_INFRARED, 1 }, RS2_FORMAT_Y8  } } } } };
     const native_pixel_format pf_y16        = { 'Y16 ', 1, 2,{  { true,  &unpack_y16_from_y16_10,                        { { { RS2_STREAM_INFRARED, 1 }, RS2_FORMAT_Y16 } } } } };
-    const native_pixel_format pf_y8i        = { 'Y8I ', 1, 2,{  { true,  &unpack_y8_y8_from_y8i,                         { { { RS2_STREAM_INFRARED, 1 }, RS2_FORMAT_Y8  },{ { RS2_STREAM_INFRARED, 2 }, RS2_FORMAT_Y8 } } } } };
+    const native_pixel_format pf_y8i        = { 'Y8I ', 1, 2,{  { true,  &unpack_y8_y8_from_y8i,                         { { { RS2_STREAM_INFRARED, 1 }, RS2_FORMAT_Y8  },{ { RS2_STREAM_INFRARED, 2 }, RS2_FORMAT_Y8 } } },
+                                                                { false, &copy_pixels<2>,                                { { { RS2_STREAM_INFRARED, 1 }, RS2_FORMAT_Y8I } } } } };
     const native_pixel_format pf_y12i       = { 'Y12I', 1, 3,{  { true,  &unpack_y16_y16_from_y12i_10,                   { { { RS2_STREAM_INFRARED, 1 }, RS2_FORMAT_Y16 },{ { RS2_STREAM_INFRARED, 2 }, RS2_FORMAT_Y16 } } } } };
     const native_pixel_format pf_z16        = { 'Z16 ', 1, 2,{  { true, &copy_pixels<2>,                                { { RS2_STREAM_DEPTH,    RS2_FORMAT_Z16 } } },
                                                                 // The Disparity_Z is not applicable for D4XX. TODO - merge with INVZ when confirmed
@@ -873,15 +1506,44 @@ namespace librealsense
                                                                 { true,  &unpack_yuy2<RS2_FORMAT_BGR8 >,                  { { RS2_STREAM_COLOR,    RS2_FORMAT_BGR8 } } },
                                                                 { true,  &unpack_yuy2<RS2_FORMAT_BGRA8>,                  { { RS2_STREAM_COLOR,    RS2_FORMAT_BGRA8 } } } } };
 
+    // Without libjpeg-turbo, MJPEG streams are not offered
+#ifdef RS2_USE_TURBOJPEG
+    const native_pixel_format pf_mjpg       = { 'MJPG', 1, 2,{  { true,  nullptr,                                        { { RS2_STREAM_COLOR,    RS2_FORMAT_RGB8 } },  &decode_mjpeg<TJPF_RGB> },
+                                                                { true,  nullptr,                                        { { RS2_STREAM_COLOR,    RS2_FORMAT_Y8 } },    &decode_mjpeg<TJPF_GRAY> },
+                                                                { true,  nullptr,                                        { { RS2_STREAM_COLOR,    RS2_FORMAT_RGBA8 } }, &decode_mjpeg<TJPF_RGBA> },
+                                                                { true,  nullptr,                                        { { RS2_STREAM_COLOR,    RS2_FORMAT_BGR8 } },  &decode_mjpeg<TJPF_BGR> },
+                                                                { true,  nullptr,                                        { { RS2_STREAM_COLOR,    RS2_FORMAT_BGRA8 } }, &decode_mjpeg<TJPF_BGRA> } } };
+#else
+    const native_pixel_format pf_mjpg       = { 'MJPG', 1, 2,{} };
+#endif
+
     const native_pixel_format pf_accel_axes = { 'ACCL', 1, 1,{  { true,  &unpack_accel_axes<RS2_FORMAT_MOTION_XYZ32F>,    { { RS2_STREAM_ACCEL,    RS2_FORMAT_MOTION_XYZ32F } } },
+                                                                { false, &unpack_accel_axes<RS2_FORMAT_MOTION_XYZ32F>,    { { RS2_STREAM_ACCEL,    RS2_FORMAT_MOTION_XYZ32F_BATCH } } },
                                                                 { false, &unpack_hid_raw_data,                            { { RS2_STREAM_ACCEL,    RS2_FORMAT_MOTION_RAW  } } }}};
     const native_pixel_format pf_gyro_axes  = { 'GYRO', 1, 1,{  { true,  &unpack_gyro_axes<RS2_FORMAT_MOTION_XYZ32F>,     { { RS2_STREAM_GYRO,     RS2_FORMAT_MOTION_XYZ32F } } },
+                                                                { false, &unpack_gyro_axes<RS2_FORMAT_MOTION_XYZ32F>,     { { RS2_STREAM_GYRO,     RS2_FORMAT_MOTION_XYZ32F_BATCH } } },
                                                                 { false, &unpack_hid_raw_data,                            { { RS2_STREAM_GYRO,     RS2_FORMAT_MOTION_RAW  } } }}};
     const native_pixel_format pf_gpio_timestamp = { 'GPIO', 1, 1,{  { false, &unpack_input_reports_data,                  { { { RS2_STREAM_GPIO, 1 },    RS2_FORMAT_GPIO_RAW },
                                                                                                                             { { RS2_STREAM_GPIO, 2 },    RS2_FORMAT_GPIO_RAW },
                                                                                                                             { { RS2_STREAM_GPIO, 3 },    RS2_FORMAT_GPIO_RAW },
                                                                                                                             { { RS2_STREAM_GPIO, 4 },    RS2_FORMAT_GPIO_RAW }} } } };
 
+    const pixel_format_unpacker* find_native_unpacker(uint32_t fourcc, rs2_stream stream, rs2_format format)
+    {
+        static const native_pixel_format* formats[] = { &pf_raw8, &pf_rw16, &pf_bayer16, &pf_rw10, &pf_w10, &pf_yuy2, &pf_y8, &pf_y16,
+                                                        &pf_y8i, &pf_y12i, &pf_z16, &pf_invz, &pf_f200_invi, &pf_f200_inzi, &pf_sr300_invi,
+                                                        &pf_sr300_inzi, &pf_uyvyl, &pf_rgb888, &pf_yuyv, &pf_mjpg };
+        for (auto pf : formats)
+        {
+            if (pf->fourcc != fourcc) continue;
+            for (auto&& unpacker : pf->unpackers)
+            {
+                if (unpacker.outputs.size() == 1 && unpacker.outputs.front().first.type == stream && unpacker.outputs.front().second == format)
+                    return &unpacker;
+            }
+        }
+        return nullptr;
+    }
 }
 
 #pragma pack(pop)
@@ -26,6 +26,17 @@ namespace librealsense
 
     std::vector<int> compute_rectification_table    (const rs2_intrinsics & rect_intrin, const rs2_extrinsics & rect_to_unrect, const rs2_intrinsics & unrect_intrin);
     void             rectify_image                  (uint8_t * rect_pixels, const std::vector<int> & rectification_table, const uint8_t * unrect_pixels, rs2_format format);
+    bool             is_plain_copy                  (const pixel_format_unpacker & unpacker);
+    int              get_band_source_bpp            (const pixel_format_unpacker & unpacker); // Zero when frames can't be split into bands
+    void             unpack_in_bands                (worker_pool & pool, const pixel_format_unpacker & unpacker, byte * const dest[], const byte * source,
+                                                     int width, int height, int bands);
+    // Convert an image into a buffer of another stride and format in one pass, with the vectorized unpackers where the
+    // formats have one. depth_units scales Z16 converted to RS2_FORMAT_DISTANCE. A zero stride is of rows without padding,
+    // the chroma plane of RS2_FORMAT_NV12 follows the luma plane with the same stride
+    void             convert_image                  (byte * dest, int dest_stride, rs2_format dest_format, const byte * source, int source_stride,
+                                                     rs2_format source_format, int width, int height, float depth_units);
+    // The single output unpacker of the native formats that makes the stream type and format from the fourcc, null if none does
+    const pixel_format_unpacker* find_native_unpacker(uint32_t fourcc, rs2_stream stream, rs2_format format);
 
     extern const native_pixel_format pf_fe_raw8_unpatched_kernel; // W/O for unpatched kernel
     extern const native_pixel_format pf_raw8;       // 8 bit luminance
@@ -35,6 +46,7 @@ namespace librealsense
     extern const native_pixel_format pf_bayer16;    // 16-bit Bayer raw
     extern const native_pixel_format pf_yuy2;       // Y0 U Y1 V ordered chroma subsampled macropixel
     extern const native_pixel_format pf_yuyv;       // Y0 U Y1 V ordered chroma subsampled macropixel
+    extern const native_pixel_format pf_mjpg;       // Motion JPEG, one JPEG image per frame
     extern const native_pixel_format pf_y8;         // 8 bit IR/Luminosity (left) imager
     extern const native_pixel_format pf_y8i;        // 8 bits left IR + 8 bits right IR per pixel
     extern const native_pixel_format pf_y16;        // 16 bit (left) IR image
@@ -192,7 +192,8 @@ namespace librealsense
           _hw_monitor(std::make_shared<hw_monitor>(std::make_shared<locked_transfer>(ctx->get_backend().create_usb_device(hwm_device), get_depth_sensor()))),
           _depth_stream(new stream(RS2_STREAM_DEPTH)),
           _ir_stream(new stream(RS2_STREAM_INFRARED)),
-          _color_stream(new stream(RS2_STREAM_COLOR))
+          _color_stream(new stream(RS2_STREAM_COLOR)),
+          _fw_logs([this]() { return _hw_monitor->send(command(ivcam::fw_cmd::GLD, FW_LOG_READ_SIZE)); }, FW_LOG_ENTRY_SIZE)
     {
         using namespace ivcam;
         static auto device_name = "Intel RealSense SR300";
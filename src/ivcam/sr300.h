@@ -17,6 +17,7 @@
 #include <cstddef>
 #include "environment.h"
 #include "core/debug.h"
+#include "fw-logs.h"
 #include "stream.h"
 
 namespace librealsense
@@ -419,6 +420,19 @@ namespace librealsense
             return _hw_monitor->send(input);
         }
 
+        std::vector<std::vector<uint8_t>> send_receive_raw_data_batch(const std::vector<std::vector<uint8_t>>& inputs,
+                                                                      std::vector<double>& received_ms) override
+        {
+            return _hw_monitor->send_batch(inputs, received_ms);
+        }
+
+        void start_fw_log_capture(size_t capacity) override { _fw_logs.start(capacity); }
+        void stop_fw_log_capture() override { _fw_logs.stop(); }
+        std::vector<uint8_t> fetch_fw_logs(size_t max_count, std::chrono::milliseconds timeout) override
+        {
+            return _fw_logs.fetch(max_count, timeout);
+        }
+
         void hardware_reset() override
         {
             force_hardware_reset();
@@ -553,5 +567,8 @@ namespace librealsense
         std::shared_ptr<lazy<rs2_extrinsics>> _depth_to_color_extrinsics;
 
         lazy<ivcam::camera_calib_params> _camer_calib_params;
+
+        // Last, so it stops reading before the rest of the device goes
+        fw_log_reader _fw_logs;
     };
 }
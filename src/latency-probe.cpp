@@ -0,0 +1,158 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#include <algorithm>
+#include <chrono>
+
+#include "archive.h"
+#include "environment.h"
+#include "latency-probe.h"
+
+namespace librealsense
+{
+    const size_t LATENCY_PROBE_SAMPLES = 10000;     // Latest measures kept per stream and measure
+    const double STIMULUS_THRESHOLD = 0.1;          // Rise of the brightness, of its full scale, seeing a stimulus
+    const int BRIGHTNESS_STEP = 4;                  // Pixels skipped between the samples of the brightness
+
+    // Mean brightness of the center of a video frame between 0 and 1, negative for frames of other formats
+    static double get_center_brightness(frame_interface* f)
+    {
+        auto video = dynamic_cast<video_frame*>(f);
+        if (!video || !video->get_frame_data()) return -1;
+
+        // Offset of the luma byte within a pixel, pixels of several bytes are averaged
+        int offset = 0, bytes = 1, count = 1;
+        double scale = 255;
+        switch (f->get_stream()->get_format())
+        {
+        case RS2_FORMAT_Y8: break;
+        case RS2_FORMAT_Y16: offset = 1; bytes = 2; break;
+        case RS2_FORMAT_YUYV: bytes = 2; break;
+        case RS2_FORMAT_UYVY: offset = 1; bytes = 2; break;
+        case RS2_FORMAT_RGB8: case RS2_FORMAT_BGR8: bytes = 3; count = 3; break;
+        case RS2_FORMAT_RGBA8: case RS2_FORMAT_BGRA8: bytes = 4; count = 3; break;
+        default: return -1;
+        }
+        scale *= count;
+
+        auto data = video->get_frame_data();
+        auto width = video->get_width(), height = video->get_height(), stride = video->get_stride();
+        double sum = 0;
+        int samples = 0;
+        for (int y = height / 4; y < height * 3 / 4; y += BRIGHTNESS_STEP)
+        {
+            auto row = data + y * stride;
+            for (int x = width / 4; x < width * 3 / 4; x += BRIGHTNESS_STEP)
+            {
+                auto pixel = row + x * bytes + offset;
+                for (int i = 0; i < count; i++) sum += pixel[i];
+                samples++;
+            }
+        }
+        return samples ? sum / samples / scale : -1;
+    }
+
+    latency_probe::latency_probe()
+        : _stimulus_time(0), _stimulus(0)
+    {
+        environment::get_instance().set_latency_instrumentation(true);
+    }
+
+    void latency_probe::add_frame(frame_interface* f)
+    {
+        auto now = environment::get_instance().get_time_service()->get_time();
+        auto steady_now = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (auto composite = dynamic_cast<composite_frame*>(f))
+        {
+            for (size_t i = 0; i < composite->get_embedded_frames_count(); i++)
+                add_single_frame(composite->get_frame(static_cast<int>(i)), now, steady_now);
+        }
+        else
+        {
+            add_single_frame(f, now, steady_now);
+        }
+    }
+
+    void latency_probe::add_single_frame(frame_interface* f, rs2_time_t now, double steady_now)
+    {
+        if (!f || !f->get_stream()) return;
+        auto&& stream = _streams[{ f->get_stream()->get_stream_type(), f->get_stream()->get_stream_index() }];
+
+        auto arrival = f->get_latency_timestamp(RS2_FRAME_LATENCY_STAGE_BACKEND_ARRIVAL);
+        if (arrival > 0)
+            add_sample(stream, RS2_LATENCY_MEASURE_CAPTURE_TO_CALLBACK, steady_now - arrival);
+
+        // The frame timestamp is taken when the readout starts, the sensor timestamp in the middle of the exposure
+        if (f->get_frame_timestamp_domain() == RS2_TIMESTAMP_DOMAIN_GLOBAL_TIME)
+        {
+            auto exposure = f->get_frame_timestamp();
+            if (f->supports_frame_metadata(RS2_FRAME_METADATA_FRAME_TIMESTAMP) && f->supports_frame_metadata(RS2_FRAME_METADATA_SENSOR_TIMESTAMP))
+                exposure -= (f->get_frame_metadata(RS2_FRAME_METADATA_FRAME_TIMESTAMP) - f->get_frame_metadata(RS2_FRAME_METADATA_SENSOR_TIMESTAMP)) / 1000.;
+            add_sample(stream, RS2_LATENCY_MEASURE_EXPOSURE_TO_CALLBACK, now - exposure);
+        }
+
+        auto brightness = get_center_brightness(f);
+        if (brightness < 0) return;
+        if (_stimulus && stream.stimulus_seen != _stimulus && f->get_frame_system_time() >= _stimulus_time)
+        {
+            if (stream.baseline < 0)
+            {
+                stream.baseline = brightness;
+            }
+            else if (brightness - stream.baseline > STIMULUS_THRESHOLD)
+            {
+                add_sample(stream, RS2_LATENCY_MEASURE_STIMULUS_TO_CALLBACK, now - _stimulus_time);
+                stream.stimulus_seen = _stimulus;
+            }
+        }
+        stream.brightness = brightness;
+    }
+
+    void latency_probe::add_sample(stream_measures& stream, rs2_latency_measure measure, double value)
+    {
+        auto&& samples = stream.samples[measure];
+        auto count = stream.counts[measure]++;
+        if (samples.size() < LATENCY_PROBE_SAMPLES)
+            samples.push_back(value);
+        else
+            samples[count % LATENCY_PROBE_SAMPLES] = value;
+    }
+
+    void latency_probe::mark_stimulus(rs2_time_t time)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stimulus_time = time;
+        _stimulus++;
+        // The stimulus is compared to the last frames before it, streams without one take their next frame
+        for (auto&& s : _streams)
+            s.second.baseline = s.second.brightness;
+    }
+
+    rs2_latency_stats latency_probe::get_stats(rs2_stream stream, int index, rs2_latency_measure measure) const
+    {
+        std::vector<double> samples;
+        rs2_latency_stats stats{};
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto it = _streams.find({ stream, index });
+            if (it == _streams.end()) return stats;
+            samples = it->second.samples[measure];
+            stats.count = it->second.counts[measure];
+        }
+        if (samples.empty()) return stats;
+
+        std::sort(samples.begin(), samples.end());
+        auto percentile = [&](double p) { return static_cast<float>(samples[static_cast<size_t>(p * (samples.size() - 1) + 0.5)]); };
+        double sum = 0;
+        for (auto s : samples) sum += s;
+        stats.mean = static_cast<float>(sum / samples.size());
+        stats.min = static_cast<float>(samples.front());
+        stats.p50 = percentile(0.5);
+        stats.p90 = percentile(0.9);
+        stats.p99 = percentile(0.99);
+        stats.max = static_cast<float>(samples.back());
+        return stats;
+    }
+}
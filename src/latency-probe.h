@@ -0,0 +1,54 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "../include/librealsense2/h/rs_types.h"
+#include "../include/librealsense2/h/rs_sensor.h"
+
+#include <array>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace librealsense
+{
+    class frame_interface;
+
+    // Measures how long frames took to reach the application, from the frames it hands over as it receives them
+    // Capture latencies come from the latency stages, so the probe turns latency instrumentation on. Exposure latencies
+    // need the hardware timestamps mapped to the host clock by the global time domain. Stimulus latencies come from
+    // the brightness of the center of video frames jumping after a stimulus, such as a blinking screen or emitter
+    class latency_probe
+    {
+    public:
+        latency_probe();
+
+        // Frames of a frameset are measured one by one
+        void add_frame(frame_interface* f);
+
+        // The stimulus started at the given time of the library clock, as rs2_get_time reads it
+        void mark_stimulus(rs2_time_t time);
+
+        rs2_latency_stats get_stats(rs2_stream stream, int index, rs2_latency_measure measure) const;
+
+    private:
+        struct stream_measures
+        {
+            std::array<std::vector<double>, RS2_LATENCY_MEASURE_COUNT> samples;   // Rings of the latest measures
+            std::array<unsigned long long, RS2_LATENCY_MEASURE_COUNT> counts{ {} };
+            double brightness = -1;         // Of the last video frame, negative until one was measured
+            double baseline = -1;           // Brightness before the pending stimulus
+            unsigned stimulus_seen = 0;     // Last stimulus found in the frames
+        };
+
+        void add_single_frame(frame_interface* f, rs2_time_t now, double steady_now);
+        void add_sample(stream_measures& stream, rs2_latency_measure measure, double value);
+
+        mutable std::mutex _mutex;
+        std::map<std::pair<rs2_stream, int>, stream_measures> _streams;
+        rs2_time_t _stimulus_time;
+        unsigned _stimulus;                 // Count of the stimuli marked
+    };
+}
@@ -307,6 +307,7 @@ namespace librealsense
                 _profiles.push_back(profile);
                 _callbacks.push_back(callback);
                 _stream_ctrls.push_back(ctrl);
+                _transfer_bufs.push_back(std::max(LIBUVC_NUM_TRANSFER_BUFS, std::min(buffers, LIBUVC_MAX_TRANSFER_BUFS)));
             }
 
             /* request to start streaming*/
@@ -320,11 +321,15 @@ namespace librealsense
                 context->_this = this;
                 context->_profile = _profiles[i];
 
-                res = uvc_start_streaming(_device_handle,
-                                          &_stream_ctrls[i],
-                                          internal_uvc_callback,
-                                          context,
-                                          0);
+                // Frames are unpacked within the callback, so it runs on the event thread over the
+                // stream buffer rather than on a thread of its own over a copy of the frame
+                res = uvc_start_streaming_ex(_device_handle,
+                                             &_stream_ctrls[i],
+                                             internal_uvc_callback,
+                                             context,
+                                             UVC_STREAM_CALLBACK_ON_EVENT_THREAD,
+                                             _transfer_bufs[i],
+                                             0);
 
                 if (res < 0) {
                   throw linux_backend_exception(
@@ -396,6 +401,9 @@ namespace librealsense
                     uvc_unref_device(_device);
                     uvc_stop_streaming(_device_handle);
                     _profiles.clear();
+                    _callbacks.clear();
+                    _stream_ctrls.clear();
+                    _transfer_bufs.clear();
                     uvc_close(_device_handle);
                     _device = NULL;
                     _device_handle = NULL;
@@ -646,6 +654,7 @@ namespace librealsense
             std::vector<stream_profile> _profiles;
             std::vector<frame_callback> _callbacks;
             std::vector<uvc_stream_ctrl_t> _stream_ctrls;
+            std::vector<int> _transfer_bufs;
             std::atomic<bool> _is_capturing;
             std::atomic<bool> _is_alive;
             std::atomic<bool> _is_started;
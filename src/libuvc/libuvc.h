@@ -454,6 +454,17 @@ typedef struct uvc_frame {
  */
 typedef void(uvc_frame_callback_t)(struct uvc_frame *frame, void *user_ptr);
 
+/** Stream setup flags
+ * @ingroup streaming
+ */
+enum uvc_stream_flags {
+    /** Call the frame callback on the libusb event thread as soon as a frame is
+     * complete, with the frame data pointing into the stream buffer. Saves the
+     * callback thread and the copy of the frame. The frame is only valid during
+     * the callback, and the callback delays the processing of the next transfers. */
+    UVC_STREAM_CALLBACK_ON_EVENT_THREAD = 0x2
+};
+
 /** Streaming mode, includes all information needed to select stream
  * @ingroup streaming
  */
@@ -605,6 +616,15 @@ uvc_error_t uvc_start_streaming(
         void *user_ptr,
         uint8_t flags);
 
+uvc_error_t uvc_start_streaming_ex(
+        uvc_device_handle_t *devh,
+        uvc_stream_ctrl_t *ctrl,
+        uvc_frame_callback_t *cb,
+        void *user_ptr,
+        uint8_t flags,
+        int num_transfer_bufs,
+        size_t transfer_size);
+
 uvc_error_t uvc_start_iso_streaming(
         uvc_device_handle_t *devh,
         uvc_stream_ctrl_t *ctrl,
@@ -619,6 +639,12 @@ uvc_error_t uvc_stream_start(uvc_stream_handle_t *strmh,
                              uvc_frame_callback_t *cb,
                              void *user_ptr,
                              uint8_t flags);
+uvc_error_t uvc_stream_start_ex(uvc_stream_handle_t *strmh,
+                                uvc_frame_callback_t *cb,
+                                void *user_ptr,
+                                uint8_t flags,
+                                int num_transfer_bufs,
+                                size_t transfer_size);
 uvc_error_t uvc_stream_start_iso(uvc_stream_handle_t *strmh,
                                  uvc_frame_callback_t *cb,
                                  void *user_ptr);
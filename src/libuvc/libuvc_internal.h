@@ -233,6 +233,8 @@ typedef struct uvc_device_info {
   and then allow the user to change the number of buffers as required.
  */
 #define LIBUVC_NUM_TRANSFER_BUFS 1
+/* upper bound of the transfer count requested with uvc_start_streaming_ex */
+#define LIBUVC_MAX_TRANSFER_BUFS 32
 
 #define LIBUVC_XFER_BUF_SIZE	( 16 * 1024 * 1024 )
 
@@ -262,8 +264,11 @@ struct uvc_stream_handle {
     uint32_t last_polled_seq;
     uvc_frame_callback_t *user_cb;
     void *user_ptr;
-    struct libusb_transfer *transfers[LIBUVC_NUM_TRANSFER_BUFS];
-    uint8_t *transfer_bufs[LIBUVC_NUM_TRANSFER_BUFS];
+    /* if true, user_cb runs on the libusb event thread over the hold buffer */
+    uint8_t cb_on_event_thread;
+    int num_transfer_bufs;
+    struct libusb_transfer *transfers[LIBUVC_MAX_TRANSFER_BUFS];
+    uint8_t *transfer_bufs[LIBUVC_MAX_TRANSFER_BUFS];
     struct uvc_frame frame;
     enum uvc_frame_format frame_format;
 };
@@ -71,6 +71,7 @@ uvc_frame_desc_t *uvc_find_frame_desc_stream(uvc_stream_handle_t *strmh,
 uvc_frame_desc_t *uvc_find_frame_desc(uvc_device_handle_t *devh,
                                       uint16_t format_id, uint16_t frame_id);
 void *_uvc_user_caller(void *arg);
+void _uvc_deliver_frame(uvc_stream_handle_t *strmh);
 void _uvc_populate_frame(uvc_stream_handle_t *strmh);
 
 struct format_table_entry {
@@ -713,6 +714,10 @@ void _uvc_swap_buffers(uvc_stream_handle_t *strmh) {
     pthread_cond_broadcast(&strmh->cb_cond);
     pthread_mutex_unlock(&strmh->cb_mutex);
 
+    /* only this thread writes the hold buffer, it is handed over without copying */
+    if (strmh->cb_on_event_thread && strmh->user_cb && strmh->running)
+        _uvc_deliver_frame(strmh);
+
     strmh->seq++;
     strmh->got_bytes = 0;
     strmh->last_scr = 0;
@@ -870,7 +875,7 @@ void LIBUSB_CALL _uvc_stream_callback(struct libusb_transfer *transfer) {
             pthread_mutex_lock(&strmh->cb_mutex);
 
             /* Mark transfer as deleted. */
-            for(i=0; i < LIBUVC_NUM_TRANSFER_BUFS; i++) {
+            for(i=0; i < strmh->num_transfer_bufs; i++) {
                 if(strmh->transfers[i] == transfer) {
                     UVC_DEBUG("Freeing transfer %d (%p)", i, transfer);
                     free(transfer->buffer);
@@ -879,7 +884,7 @@ void LIBUSB_CALL _uvc_stream_callback(struct libusb_transfer *transfer) {
                     break;
                 }
             }
-            if(i == LIBUVC_NUM_TRANSFER_BUFS ) {
+            if(i == strmh->num_transfer_bufs ) {
                 UVC_DEBUG("transfer %p not found; not freeing!", transfer);
             }
 
@@ -919,6 +924,29 @@ uvc_error_t uvc_start_streaming(
         uvc_frame_callback_t *cb,
         void *user_ptr,
         uint8_t flags
+) {
+    return uvc_start_streaming_ex(devh, ctrl, cb, user_ptr, flags, LIBUVC_NUM_TRANSFER_BUFS, 0);
+}
+
+/** Begin streaming video from the camera into the callback function, with the given transfers.
+ * @ingroup streaming
+ *
+ * @param devh UVC device
+ * @param ctrl Control block, processed using {uvc_probe_stream_ctrl} or
+ *             {uvc_get_stream_ctrl_format_size}
+ * @param cb   User callback function. See {uvc_frame_callback_t} for restrictions.
+ * @param flags Stream setup flags, see {uvc_stream_flags}
+ * @param num_transfer_bufs Number of USB transfers kept in flight, up to LIBUVC_MAX_TRANSFER_BUFS
+ * @param transfer_size Size of each transfer, 0 for the maximum payload size of the stream
+ */
+uvc_error_t uvc_start_streaming_ex(
+        uvc_device_handle_t *devh,
+        uvc_stream_ctrl_t *ctrl,
+        uvc_frame_callback_t *cb,
+        void *user_ptr,
+        uint8_t flags,
+        int num_transfer_bufs,
+        size_t transfer_size
 ) {
     uvc_error_t ret;
     uvc_stream_handle_t *strmh;
@@ -927,7 +955,7 @@ uvc_error_t uvc_start_streaming(
     if (ret != UVC_SUCCESS)
         return ret;
 
-    ret = uvc_stream_start(strmh, cb, user_ptr, flags);
+    ret = uvc_stream_start_ex(strmh, cb, user_ptr, flags, num_transfer_bufs, transfer_size);
     if (ret != UVC_SUCCESS) {
         uvc_stream_close(strmh);
         return ret;
@@ -1062,6 +1090,26 @@ uvc_error_t uvc_stream_start(
         uvc_frame_callback_t *cb,
         void *user_ptr,
         uint8_t flags
+) {
+    return uvc_stream_start_ex(strmh, cb, user_ptr, flags, LIBUVC_NUM_TRANSFER_BUFS, 0);
+}
+
+/** Begin streaming video from the stream into the callback function, with the given transfers.
+ * @ingroup streaming
+ *
+ * @param strmh UVC stream
+ * @param cb   User callback function. See {uvc_frame_callback_t} for restrictions.
+ * @param flags Stream setup flags, see {uvc_stream_flags}
+ * @param num_transfer_bufs Number of USB transfers kept in flight, up to LIBUVC_MAX_TRANSFER_BUFS
+ * @param transfer_size Size of each transfer, 0 for the maximum payload size of the stream
+ */
+uvc_error_t uvc_stream_start_ex(
+        uvc_stream_handle_t *strmh,
+        uvc_frame_callback_t *cb,
+        void *user_ptr,
+        uint8_t flags,
+        int num_transfer_bufs,
+        size_t transfer_size
 ) {
     /* USB interface we'll be using */
     const struct libusb_interface *interface;
@@ -1085,6 +1133,14 @@ uvc_error_t uvc_stream_start(
         return UVC_ERROR_BUSY;
     }
 
+    if (num_transfer_bufs < 1 || num_transfer_bufs > LIBUVC_MAX_TRANSFER_BUFS) {
+        UVC_EXIT(UVC_ERROR_INVALID_PARAM);
+        return UVC_ERROR_INVALID_PARAM;
+    }
+
+    if (transfer_size == 0)
+        transfer_size = strmh->cur_ctrl.dwMaxPayloadTransferSize;
+
     strmh->running = 1;
     strmh->seq = 1;
     strmh->fid = 0;
@@ -1108,30 +1164,31 @@ uvc_error_t uvc_stream_start(
      * (UVC 1.5: 2.4.3. VideoStreaming Interface) */
     isochronous = interface->num_altsetting > 1;
 
-    for (transfer_id = 0; transfer_id < LIBUVC_NUM_TRANSFER_BUFS;
+    strmh->num_transfer_bufs = num_transfer_bufs;
+    for (transfer_id = 0; transfer_id < strmh->num_transfer_bufs;
          ++transfer_id) {
         transfer = libusb_alloc_transfer(0);
         strmh->transfers[transfer_id] = transfer;
-        strmh->transfer_bufs[transfer_id] = malloc (
-                strmh->cur_ctrl.dwMaxPayloadTransferSize );
+        strmh->transfer_bufs[transfer_id] = malloc ( transfer_size );
         libusb_fill_bulk_transfer ( transfer, strmh->devh->usb_devh,
                                     format_desc->parent->bEndpointAddress,
                                     strmh->transfer_bufs[transfer_id],
-                                    strmh->cur_ctrl.dwMaxPayloadTransferSize, _uvc_stream_callback,
+                                    transfer_size, _uvc_stream_callback,
                                     ( void* ) strmh, 5000 );
     }
 
     strmh->user_cb = cb;
     strmh->user_ptr = user_ptr;
+    strmh->cb_on_event_thread = (flags & UVC_STREAM_CALLBACK_ON_EVENT_THREAD) != 0;
 
     /* If the user wants it, set up a thread that calls the user's function
      * with the contents of each frame.
      */
-    if (cb) {
+    if (cb && !strmh->cb_on_event_thread) {
         pthread_create(&strmh->cb_thread, NULL, _uvc_user_caller, (void*) strmh);
     }
 
-    for (transfer_id = 0; transfer_id < LIBUVC_NUM_TRANSFER_BUFS;
+    for (transfer_id = 0; transfer_id < strmh->num_transfer_bufs;
          transfer_id++) {
         ret = libusb_submit_transfer(strmh->transfers[transfer_id]);
         if (ret != UVC_SUCCESS) {
@@ -1201,11 +1258,9 @@ void *_uvc_user_caller(void *arg) {
 }
 
 /** @internal
- * @brief Populate the fields of a frame to be handed to user code
- * must be called with stream cb lock held!
+ * @brief Fill the fields of a frame other than its data
  */
-void _uvc_populate_frame(uvc_stream_handle_t *strmh) {
-    size_t alloc_size = strmh->cur_ctrl.dwMaxVideoFrameSize;
+static void _uvc_populate_frame_fields(uvc_stream_handle_t *strmh) {
     uvc_frame_t *frame = &strmh->frame;
     uvc_frame_desc_t *frame_desc;
 
@@ -1237,6 +1292,41 @@ void _uvc_populate_frame(uvc_stream_handle_t *strmh) {
     frame->sequence = strmh->hold_seq;
     /** @todo set the frame time */
     // frame->capture_time
+}
+
+/** @internal
+ * @brief Call the user callback on the event thread with the frame viewing the hold buffer
+ */
+void _uvc_deliver_frame(uvc_stream_handle_t *strmh) {
+    uvc_frame_t *frame = &strmh->frame;
+    void *data = frame->data;
+    size_t data_bytes = frame->data_bytes;
+    void *metadata = frame->metadata;
+    size_t metadata_bytes = frame->metadata_bytes;
+
+    _uvc_populate_frame_fields(strmh);
+    frame->data = strmh->holdbuf;
+    frame->data_bytes = strmh->hold_bytes;
+    frame->metadata = strmh->metadata_buf;
+    frame->metadata_bytes = strmh->metadata_bytes;
+
+    strmh->user_cb(frame, strmh->user_ptr);
+
+    /* the frame owns its own buffers again */
+    frame->data = data;
+    frame->data_bytes = data_bytes;
+    frame->metadata = metadata;
+    frame->metadata_bytes = metadata_bytes;
+}
+
+/** @internal
+ * @brief Populate the fields of a frame to be handed to user code
+ * must be called with stream cb lock held!
+ */
+void _uvc_populate_frame(uvc_stream_handle_t *strmh) {
+    uvc_frame_t *frame = &strmh->frame;
+
+    _uvc_populate_frame_fields(strmh);
 
     /* copy the image data from the hold buffer to the frame (unnecessary extra buf?) */
     if (frame->data_bytes < strmh->hold_bytes) {
@@ -1370,7 +1460,7 @@ uvc_error_t uvc_stream_stop(uvc_stream_handle_t *strmh) {
 
     pthread_mutex_lock(&strmh->cb_mutex);
 
-    for(i=0; i < LIBUVC_NUM_TRANSFER_BUFS; i++) {
+    for(i=0; i < strmh->num_transfer_bufs; i++) {
         if(strmh->transfers[i] != NULL) {
             int res = libusb_cancel_transfer(strmh->transfers[i]);
             if(res < 0 && res != LIBUSB_ERROR_NOT_FOUND ) {
@@ -1383,11 +1473,11 @@ uvc_error_t uvc_stream_stop(uvc_stream_handle_t *strmh) {
 
     /* Wait for transfers to complete/cancel */
     do {
-        for(i=0; i < LIBUVC_NUM_TRANSFER_BUFS; i++) {
+        for(i=0; i < strmh->num_transfer_bufs; i++) {
             if(strmh->transfers[i] != NULL)
                 break;
         }
-        if(i == LIBUVC_NUM_TRANSFER_BUFS )
+        if(i == strmh->num_transfer_bufs )
             break;
         pthread_cond_wait(&strmh->cb_cond, &strmh->cb_mutex);
     } while(1);
@@ -1397,7 +1487,7 @@ uvc_error_t uvc_stream_stop(uvc_stream_handle_t *strmh) {
 
     /** @todo stop the actual stream, camera side? */
 
-    if (strmh->user_cb) {
+    if (strmh->user_cb && !strmh->cb_on_event_thread) {
         /* wait for the thread to stop (triggered by
          * LIBUSB_TRANSFER_CANCELLED transfer) */
         pthread_join(strmh->cb_thread, NULL);
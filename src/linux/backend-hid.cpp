@@ -4,6 +4,7 @@
 #ifdef RS2_USE_V4L2_BACKEND
 
 #include "backend-hid.h"
+#include "backend-reactor.h"
 #include "backend.h"
 #include "types.h"
 
@@ -259,10 +260,21 @@ namespace librealsense
 
             _callback = sensor_callback;
             _is_capturing = true;
-            _hid_thread = std::unique_ptr<std::thread>(new std::thread([this, read_device_path_str](){
-                static const uint32_t buf_len = 128;
-                const uint32_t channel_size = 24; // TODO: why 24?
-                std::vector<uint8_t> raw_data(channel_size * buf_len);
+            static const uint32_t buf_len = 128;
+            _raw_data.resize(custom_channel_size * buf_len);
+
+            _callback = sensor_callback;
+            _is_capturing = true;
+            if (auto reactor = capture_reactor::get())
+            {
+                reactor->add(_fd, [this]() { read_samples(); },
+                    []() { LOG_WARNING("hid_custom_sensor: Frames didn't arrived within 5 seconds"); }, CAPTURE_TIMEOUT_MS);
+                return;
+            }
+
+            _hid_thread = std::unique_ptr<std::thread>(new std::thread([this](){
+                thread_registration registration("rs-hid-capture", RS2_THREAD_CLASS_CAPTURE);
+                capture_thread_settings::get().apply();
 
                 do {
                     fd_set fds;
@@ -271,7 +283,6 @@ namespace librealsense
                     FD_SET(_stop_pipe_fd[0], &fds);
 
                     int max_fd = std::max(_stop_pipe_fd[0], _fd);
-                    size_t read_size = 0;
 
                     struct timeval tv = {5,0};
                     auto val = select(max_fd + 1, &fds, NULL, NULL, &tv);
@@ -292,26 +303,7 @@ namespace librealsense
                         }
                         else if (FD_ISSET(_fd, &fds))
                         {
-                            read_size = read(_fd, raw_data.data(), raw_data.size());
-                            if (read_size <= 0 )
-                                continue;
-                        }
-                        else
-                        {
-                            // TODO: write to log?
-                            continue;
-                        }
-
-                        for (auto i = 0; i < read_size / channel_size; ++i)
-                        {
-                            auto p_raw_data = raw_data.data() + channel_size * i;
-
-                            // TODO: code refactoring to reduce latency
-                            sensor_data sens_data{};
-                            sens_data.sensor = hid_sensor{get_sensor_name()};
-
-                            sens_data.fo = {channel_size, channel_size, p_raw_data, p_raw_data};
-                            this->_callback(sens_data);
+                            read_samples();
                         }
                     }
                     else
@@ -322,14 +314,42 @@ namespace librealsense
             }));
         }
 
+        void hid_custom_sensor::read_samples()
+        {
+            const uint32_t channel_size = custom_channel_size;
+            auto read_size = read(_fd, _raw_data.data(), _raw_data.size());
+            if (read_size <= 0)
+                return;
+
+            for (auto i = 0; i < read_size / channel_size; ++i)
+            {
+                auto p_raw_data = _raw_data.data() + channel_size * i;
+
+                // TODO: code refactoring to reduce latency
+                sensor_data sens_data{};
+                sens_data.sensor = hid_sensor{get_sensor_name()};
+
+                sens_data.fo = {channel_size, channel_size, p_raw_data, p_raw_data};
+                this->_callback(sens_data);
+            }
+        }
+
         void hid_custom_sensor::stop_capture()
         {
             if (!_is_capturing)
                 return;
 
             _is_capturing = false;
-            signal_stop();
-            _hid_thread->join();
+            if (_hid_thread)
+            {
+                signal_stop();
+                _hid_thread->join();
+                _hid_thread.reset();
+            }
+            else
+            {
+                capture_reactor::get()->remove(_fd);
+            }
             enable(false);
             _callback = NULL;
 
@@ -508,12 +528,22 @@ namespace librealsense
 
             _callback = sensor_callback;
             _is_capturing = true;
-            _hid_thread = std::unique_ptr<std::thread>(new std::thread([this](){
-                const uint32_t channel_size = get_channel_size();
-                auto raw_data_size = channel_size*buf_len;
+            _channel_size = get_channel_size();
+            _raw_data.resize(_channel_size * _buffer_length);
+            _metadata = has_metadata();
 
-                std::vector<uint8_t> raw_data(raw_data_size);
-                auto metadata = has_metadata();
+            _callback = sensor_callback;
+            _is_capturing = true;
+            if (auto reactor = capture_reactor::get())
+            {
+                reactor->add(_fd, [this]() { read_samples(); },
+                    []() { LOG_WARNING("iio_hid_sensor: Frames didn't arrived within 5 seconds"); }, CAPTURE_TIMEOUT_MS);
+                return;
+            }
+
+            _hid_thread = std::unique_ptr<std::thread>(new std::thread([this](){
+                thread_registration registration("rs-hid-capture", RS2_THREAD_CLASS_CAPTURE);
+                capture_thread_settings::get().apply();
 
                 do {
                     fd_set fds;
@@ -522,7 +552,6 @@ namespace librealsense
                     FD_SET(_stop_pipe_fd[0], &fds);
 
                     int max_fd = std::max(_stop_pipe_fd[0], _fd);
-                    auto read_size = 0;
 
                     struct timeval tv = {5, 0};
                     auto val = select(max_fd + 1, &fds, NULL, NULL, &tv);
@@ -543,28 +572,7 @@ namespace librealsense
                         }
                         else if (FD_ISSET(_fd, &fds))
                         {
-                            read_size = read(_fd, raw_data.data(), raw_data_size);
-                            if (read_size < 0 )
-                                continue;
-                        }
-                        else
-                        {
-                            // TODO: write to log?
-                            continue;
-                        }
-
-                        // TODO: code refactoring to reduce latency
-                        for (auto i = 0; i < read_size / channel_size; ++i)
-                        {
-                            auto p_raw_data = raw_data.data() + channel_size * i;
-                            sensor_data sens_data{};
-                            sens_data.sensor = hid_sensor{get_sensor_name()};
-
-                            auto hid_data_size = channel_size - HID_METADATA_SIZE;
-
-                            sens_data.fo = {hid_data_size, metadata?HID_METADATA_SIZE: uint8_t(0),  p_raw_data,  metadata?p_raw_data + hid_data_size:nullptr};
-
-                            this->_callback(sens_data);
+                            read_samples();
                         }
                     }
                     else
@@ -575,14 +583,46 @@ namespace librealsense
             }));
         }
 
+        void iio_hid_sensor::read_samples()
+        {
+            sensor_data sens_data{};
+            sens_data.sensor = hid_sensor{get_sensor_name()};
+            auto hid_data_size = _channel_size - HID_METADATA_SIZE;
+
+            // Drain every pending sample in this wakeup, a read that does not fill the buffer leaves none behind
+            ssize_t read_size;
+            do
+            {
+                read_size = read(_fd, _raw_data.data(), _raw_data.size());
+                if (read_size < 0)
+                    return;
+
+                for (auto i = 0; i < read_size / _channel_size; ++i)
+                {
+                    auto p_raw_data = _raw_data.data() + _channel_size * i;
+                    sens_data.fo = {hid_data_size, _metadata?HID_METADATA_SIZE: uint8_t(0),  p_raw_data,  _metadata?p_raw_data + hid_data_size:nullptr};
+
+                    this->_callback(sens_data);
+                }
+            } while (read_size == static_cast<ssize_t>(_raw_data.size()) && _is_capturing);
+        }
+
         void iio_hid_sensor::stop_capture()
         {
             if (!_is_capturing)
                 return;
 
             _is_capturing = false;
-            signal_stop();
-            _hid_thread->join();
+            if (_hid_thread)
+            {
+                signal_stop();
+                _hid_thread->join();
+                _hid_thread.reset();
+            }
+            else
+            {
+                capture_reactor::get()->remove(_fd);
+            }
             _callback = NULL;
             _channels.clear();
 
@@ -729,7 +769,20 @@ namespace librealsense
                 input->enable(true);
 
             set_frequency(frequency);
-            write_integer_to_param("buffer/length", buf_len);
+
+            // The kernel buffer holds a fixed time of samples, and wakes the reader once a few milliseconds of
+            // samples accumulated, so high rates are read in batches instead of one wakeup per sample
+            _buffer_length = std::max(buf_len, frequency * max_buffer_ms / 1000);
+            write_integer_to_param("buffer/length", _buffer_length);
+            auto watermark = std::max(1u, frequency * watermark_ms / 1000);
+            try
+            {
+                write_integer_to_param("buffer/watermark", watermark);
+            }
+            catch (const linux_backend_exception&)
+            {
+                LOG_INFO("iio_hid_sensor: " << _iio_device_path << " does not support buffer watermark");
+            }
             write_integer_to_param("buffer/enable", 1);
         }
 
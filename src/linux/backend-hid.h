@@ -101,8 +101,13 @@ namespace librealsense
 
             void signal_stop();
 
+            // read the pending samples of _fd and pass them to the callback
+            void read_samples();
+
+            static const uint32_t custom_channel_size = 24; // TODO: why 24?
             int _stop_pipe_fd[2]; // write to _stop_pipe_fd[1] and read from _stop_pipe_fd[0]
             int _fd;
+            std::vector<uint8_t> _raw_data;
             std::map<std::string, std::string> _reports;
             std::string _custom_device_path;
             std::string _custom_sensor_name;
@@ -133,6 +138,9 @@ namespace librealsense
 
             void signal_stop();
 
+            // read the pending samples of _fd and pass them to the callback
+            void read_samples();
+
             bool has_metadata();
 
             static bool sort_hids(hid_input* first, hid_input* second);
@@ -157,8 +165,14 @@ namespace librealsense
             void write_integer_to_param(const std::string& param,int value);
 
             static const uint32_t buf_len = 128; // TODO
+            static const uint32_t max_buffer_ms = 100;      // Samples the kernel buffer holds, in time at the sampling frequency
+            static const uint32_t watermark_ms = 5;         // Samples accumulated in the kernel buffer before a wakeup
             int _stop_pipe_fd[2]; // write to _stop_pipe_fd[1] and read from _stop_pipe_fd[0]
             int _fd;
+            uint32_t _buffer_length = buf_len;              // In samples
+            uint32_t _channel_size = 0;
+            bool _metadata = false;
+            std::vector<uint8_t> _raw_data;
             int _iio_device_number;
             std::string _iio_device_path;
             std::string _sensor_name;
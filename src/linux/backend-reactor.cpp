@@ -0,0 +1,251 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#ifdef RS2_USE_V4L2_BACKEND
+
+#include "backend-reactor.h"
+#include "types.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <sstream>
+
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+namespace librealsense
+{
+    namespace platform
+    {
+        const int REACTOR_TICK_MS = 500;     // Longest wait for events, bounding the delay of the timeout checks
+        const int REACTOR_MAX_EVENTS = 16;
+
+        static double monotonic_time_ms()
+        {
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        const capture_thread_settings& capture_thread_settings::get()
+        {
+            static const capture_thread_settings settings = []()
+            {
+                capture_thread_settings s;
+                if (auto value = getenv("LRS_CAPTURE_THREADS"))
+                    s.threads = std::max(atoi(value), 0);
+                if (auto value = getenv("LRS_CAPTURE_CPUS"))
+                {
+                    std::stringstream list(value);
+                    std::string cpu;
+                    while (std::getline(list, cpu, ','))
+                        if (!cpu.empty()) s.cpus.push_back(atoi(cpu.c_str()));
+                }
+                if (auto value = getenv("LRS_CAPTURE_PRIORITY"))
+                    s.priority = std::max(atoi(value), 0);
+                return s;
+            }();
+            return settings;
+        }
+
+        void capture_thread_settings::apply() const
+        {
+            static std::atomic<unsigned int> next_cpu(0);
+
+            if (!cpus.empty())
+            {
+                auto cpu = cpus[next_cpu++ % cpus.size()];
+                cpu_set_t set;
+                CPU_ZERO(&set);
+                CPU_SET(cpu, &set);
+                if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0)
+                    LOG_WARNING("Failed to pin capture thread to CPU " << cpu);
+            }
+
+            if (priority > 0)
+            {
+                sched_param param{};
+                param.sched_priority = priority;
+                if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) != 0)
+                    LOG_WARNING("Failed to set capture thread priority " << priority << ", CAP_SYS_NICE is required");
+            }
+        }
+
+        capture_reactor* capture_reactor::get()
+        {
+            static std::unique_ptr<capture_reactor> reactor(capture_thread_settings::get().threads > 0 ?
+                new capture_reactor(capture_thread_settings::get().threads) : nullptr);
+            return reactor.get();
+        }
+
+        capture_reactor::capture_reactor(int threads)
+            : _epoll_fd(epoll_create1(EPOLL_CLOEXEC)),
+              _wake_fd(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)),
+              _alive(true)
+        {
+            if (_epoll_fd < 0 || _wake_fd < 0)
+                throw linux_backend_exception("capture_reactor: Cannot create epoll set");
+
+            // Level triggered, so that every thread sees it on shutdown
+            epoll_event ev{};
+            ev.events = EPOLLIN;
+            ev.data.fd = _wake_fd;
+            if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, _wake_fd, &ev) < 0)
+                throw linux_backend_exception("capture_reactor: epoll_ctl(EPOLL_CTL_ADD) failed");
+
+            for (auto i = 0; i < threads; i++)
+                _threads.emplace_back([this]() { run(); });
+        }
+
+        capture_reactor::~capture_reactor()
+        {
+            _alive = false;
+            uint64_t one = 1;
+            if (write(_wake_fd, &one, sizeof(one)) < 0)
+                LOG_ERROR("capture_reactor: Could not wake the capture threads");
+            for (auto&& t : _threads) t.join();
+
+            ::close(_wake_fd);
+            ::close(_epoll_fd);
+        }
+
+        void capture_reactor::add(int fd, std::function<void()> on_readable, std::function<void()> on_timeout, double timeout_ms)
+        {
+            auto r = std::make_shared<registration>();
+            r->fd = fd;
+            r->on_readable = std::move(on_readable);
+            r->on_timeout = std::move(on_timeout);
+            r->timeout_ms = timeout_ms;
+            r->last_activity = monotonic_time_ms();
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_registrations.count(fd))
+                throw wrong_api_call_sequence_exception("capture_reactor: descriptor is already registered");
+
+            // One shot, so that a single thread gets the descriptor until its handler returns and re-arms it
+            epoll_event ev{};
+            ev.events = EPOLLIN | EPOLLONESHOT;
+            ev.data.fd = fd;
+            if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0)
+                throw linux_backend_exception("capture_reactor: epoll_ctl(EPOLL_CTL_ADD) failed");
+            _registrations[fd] = r;
+        }
+
+        void capture_reactor::remove(int fd)
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            auto it = _registrations.find(fd);
+            if (it == _registrations.end()) return;
+
+            auto r = it->second;
+            r->removed = true;
+            _registrations.erase(it);
+            if (epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, fd, nullptr) < 0)
+                LOG_WARNING("capture_reactor: epoll_ctl(EPOLL_CTL_DEL) failed");
+
+            if (r->runner != std::this_thread::get_id())
+                _idle.wait(lock, [&]() { return !r->busy; });
+        }
+
+        void capture_reactor::run()
+        {
+            thread_registration registration("rs-capture", RS2_THREAD_CLASS_CAPTURE);
+            capture_thread_settings::get().apply();
+
+            epoll_event events[REACTOR_MAX_EVENTS];
+            while (_alive)
+            {
+                auto count = epoll_wait(_epoll_fd, events, REACTOR_MAX_EVENTS, REACTOR_TICK_MS);
+                if (count < 0)
+                {
+                    if (errno == EINTR) continue;
+                    LOG_ERROR("capture_reactor: epoll_wait failed, errno " << errno);
+                    return;
+                }
+
+                for (auto i = 0; i < count && _alive; i++)
+                {
+                    if (events[i].data.fd != _wake_fd)
+                        dispatch(events[i].data.fd);
+                }
+                check_timeouts();
+            }
+        }
+
+        void capture_reactor::dispatch(int fd)
+        {
+            std::shared_ptr<registration> r;
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                auto it = _registrations.find(fd);
+                if (it == _registrations.end()) return;
+                r = it->second;
+                r->busy = true;
+                r->runner = std::this_thread::get_id();
+            }
+
+            try
+            {
+                r->on_readable();
+            }
+            catch (const std::exception& ex)
+            {
+                LOG_ERROR("capture_reactor: " << ex.what());
+            }
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            r->busy = false;
+            r->runner = std::thread::id();
+            r->last_activity = monotonic_time_ms();
+            if (!r->removed)
+            {
+                epoll_event ev{};
+                ev.events = EPOLLIN | EPOLLONESHOT;
+                ev.data.fd = fd;
+                if (epoll_ctl(_epoll_fd, EPOLL_CTL_MOD, fd, &ev) < 0)
+                    LOG_ERROR("capture_reactor: epoll_ctl(EPOLL_CTL_MOD) failed");
+            }
+            _idle.notify_all();
+        }
+
+        void capture_reactor::check_timeouts()
+        {
+            auto now = monotonic_time_ms();
+            std::vector<std::shared_ptr<registration>> expired;
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                for (auto&& kvp : _registrations)
+                {
+                    auto&& r = kvp.second;
+                    if (!r->busy && r->on_timeout && now - r->last_activity > r->timeout_ms)
+                    {
+                        r->busy = true;
+                        r->runner = std::this_thread::get_id();
+                        r->last_activity = now;
+                        expired.push_back(r);
+                    }
+                }
+            }
+
+            for (auto&& r : expired)
+            {
+                try
+                {
+                    r->on_timeout();
+                }
+                catch (const std::exception& ex)
+                {
+                    LOG_ERROR("capture_reactor: " << ex.what());
+                }
+
+                std::lock_guard<std::mutex> lock(_mutex);
+                r->busy = false;
+                r->runner = std::thread::id();
+                _idle.notify_all();
+            }
+        }
+    }
+}
+
+#endif
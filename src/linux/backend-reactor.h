@@ -0,0 +1,83 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace librealsense
+{
+    namespace platform
+    {
+        const double CAPTURE_TIMEOUT_MS = 5000; // Devices delivering nothing for longer than this are reported
+
+        // Scheduling of the threads reading from the capture devices, taken from the environment:
+        // LRS_CAPTURE_THREADS  - number of threads servicing the descriptors of all the UVC and HID devices together.
+        //                        Unset or zero keeps a capture thread per device
+        // LRS_CAPTURE_CPUS     - comma separated list of CPUs the capture threads are pinned to, one per thread in turn
+        // LRS_CAPTURE_PRIORITY - SCHED_FIFO priority of the capture threads, which requires CAP_SYS_NICE
+        // These are applied after the policy of RS2_THREAD_CLASS_CAPTURE threads, so they take precedence over it
+        struct capture_thread_settings
+        {
+            int threads = 0;
+            std::vector<int> cpus;
+            int priority = 0;
+
+            static const capture_thread_settings& get();
+
+            // Pin the calling thread to the next CPU of the list and raise its priority
+            void apply() const;
+        };
+
+        // Waits on the descriptors of many capture devices with a single epoll set, from a small pool of threads
+        class capture_reactor
+        {
+        public:
+            // Null unless LRS_CAPTURE_THREADS asks for a shared reactor
+            static capture_reactor* get();
+
+            ~capture_reactor();
+
+            // Run on_readable on a reactor thread whenever fd has data, and on_timeout when none came for timeout_ms
+            // The handlers of one descriptor never run concurrently
+            void add(int fd, std::function<void()> on_readable, std::function<void()> on_timeout, double timeout_ms);
+
+            // Once returned, no handler of fd runs anymore. Called from a handler of fd, the handler itself may still be running
+            void remove(int fd);
+
+        private:
+            explicit capture_reactor(int threads);
+
+            struct registration
+            {
+                int fd;
+                std::function<void()> on_readable;
+                std::function<void()> on_timeout;
+                double timeout_ms;
+                double last_activity;
+                bool busy = false;
+                bool removed = false;
+                std::thread::id runner;
+            };
+
+            void run();
+            void dispatch(int fd);
+            void check_timeouts();
+
+            int _epoll_fd;
+            int _wake_fd;
+            std::mutex _mutex;
+            std::condition_variable _idle;
+            std::map<int, std::shared_ptr<registration>> _registrations;
+            std::vector<std::thread> _threads;
+            std::atomic<bool> _alive;
+        };
+    }
+}
@@ -4,9 +4,11 @@
 #ifdef RS2_USE_V4L2_BACKEND
 
 #include "backend-v4l2.h"
+#include "backend-reactor.h"
 #include "backend-hid.h"
 #include "backend.h"
 #include "types.h"
+#include "tracing.h"
 
 #include <cassert>
 #include <cstdlib>
@@ -43,6 +45,9 @@
 
 #include <sys/signalfd.h>
 #include <signal.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
 
 
 #pragma GCC diagnostic ignored "-Woverflow"
@@ -107,20 +112,53 @@ namespace librealsense
     {
         named_mutex::named_mutex(const std::string& device_path, unsigned timeout)
             : _device_path(device_path),
-              _timeout(timeout) // TODO: try to lock with timeout
+              _timeout(timeout), // TODO: try to lock with timeout
+              _holders(0)
         {
             create_named_mutex(_device_path);
         }
 
         bool named_mutex::try_lock()
         {
-            auto ret = lockf(_fildes, F_TLOCK, 0);
-            if (ret != 0)
+            auto holders = _holders.load();
+            while (holders > 0)
+                if (_holders.compare_exchange_weak(holders, holders + 1))
+                    return true;
+
+            std::lock_guard<std::mutex> lock(_file_lock_mutex);
+            if (_holders == 0 && lockf(_fildes, F_TLOCK, 0) != 0)
                 return false;
 
+            ++_holders;
             return true;
         }
 
+        // The file lock belongs to the process, so it is only taken when there is no holder yet
+        void named_mutex::hold()
+        {
+            auto holders = _holders.load();
+            while (holders > 0)
+                if (_holders.compare_exchange_weak(holders, holders + 1))
+                    return;
+
+            std::lock_guard<std::mutex> lock(_file_lock_mutex);
+            if (_holders == 0)
+                acquire();
+            ++_holders;
+        }
+
+        void named_mutex::drop()
+        {
+            auto holders = _holders.load();
+            while (holders > 1)
+                if (_holders.compare_exchange_weak(holders, holders - 1))
+                    return;
+
+            std::lock_guard<std::mutex> lock(_file_lock_mutex);
+            if (--_holders == 0)
+                release();
+        }
+
         named_mutex::~named_mutex()
         {
             try{
@@ -517,10 +555,69 @@ namespace librealsense
             if (_thread) _thread->join();
         }
 
-        void v4l_uvc_device::probe_and_commit(stream_profile profile, frame_callback callback, int buffers)
+        void v4l_uvc_device::set_adaptive_buffers(int max_buffers)
+        {
+            _max_adaptive_buffers = max_buffers;
+        }
+
+        // A session needs the buffers its frames held at most at once, or for as long as they held one at the frame
+        // rate, and two more the driver fills meanwhile. The number grows to that at once, and shrinks by one buffer
+        // a session, so that a single quiet session does not undo it
+        int v4l_uvc_device::choose_buffer_count(const stream_profile& profile, int requested)
+        {
+            auto stats = _hold_stats;
+            _hold_stats = std::make_shared<buffer_hold_stats>();
+
+            if (_max_adaptive_buffers <= requested)
+            {
+                _adaptive_buffers = 0;
+                return requested;
+            }
+            if (_adaptive_buffers == 0 || !(profile == _adaptive_profile))
+            {
+                _adaptive_profile = profile;
+                _adaptive_buffers = requested;
+                return requested;
+            }
+
+            static const int driver_buffers = 2;
+            auto hold_us = stats->max_hold_us.load();
+            auto held_at_rate = static_cast<int>((hold_us * profile.fps + 999999) / 1000000);
+            auto needed = std::max(static_cast<int>(stats->max_held.load()), held_at_rate) + driver_buffers;
+
+            auto count = _adaptive_buffers;
+            if (needed > count)
+                count = std::min(needed, _max_adaptive_buffers);
+            else if (needed < count)
+                count = std::max(count - 1, requested);
+            count = std::max(std::min(count, _max_adaptive_buffers), requested);
+
+            if (count != _adaptive_buffers)
+                LOG_INFO(_name << " streams into " << count << " kernel buffers, frames held " << stats->max_held.load()
+                         << " at once and one for up to " << hold_us / 1000 << "ms");
+            _adaptive_buffers = count;
+            return count;
+        }
+
+        void v4l_uvc_device::probe_and_commit(stream_profile profile, frame_callback callback, int requested_buffers)
         {
             if(!_is_capturing && !_callback)
             {
+                auto buffers = choose_buffer_count(profile, requested_buffers);
+                if (_has_kept_buffers)
+                {
+                    // Buffers still referenced by frames of the previous session cannot be queued again
+                    auto idle = std::all_of(_buffers.begin(), _buffers.end(), [](const std::shared_ptr<buffer>& b) { return b.use_count() == 1; });
+                    if (idle && profile == _profile && buffers == _requested_buffers)
+                    {
+                        LOG_DEBUG(_name << " reuses the kernel buffers kept for " << fourcc_to_string(profile.format) << " " << profile.width << "x" << profile.height);
+                        _has_kept_buffers = false;
+                        _callback = callback;
+                        return;
+                    }
+                    release_buffers();
+                }
+
                 v4l2_fmtdesc pixel_format = {};
                 pixel_format.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
                 while (ioctl(_fd, VIDIOC_ENUM_FMT, &pixel_format) == 0)
@@ -606,11 +703,16 @@ namespace librealsense
                         throw linux_backend_exception("xioctl(VIDIOC_REQBUFS) failed");
                 }
 
-                for(size_t i = 0; i < buffers; ++i)
+                // The driver may grant a different number of buffers than requested
+                if (req.count != static_cast<uint32_t>(buffers))
+                    LOG_WARNING(_name << " allocated " << req.count << " kernel buffers out of " << buffers << " requested");
+
+                for(size_t i = 0; i < req.count; ++i)
                 {
                     _buffers.push_back(std::make_shared<buffer>(_fd, _use_memory_map, i));
                 }
 
+                _requested_buffers = buffers;
                 _profile =  profile;
                 _callback = callback;
             }
@@ -634,7 +736,34 @@ namespace librealsense
                     throw linux_backend_exception("xioctl(VIDIOC_STREAMON) failed");
 
                 _is_capturing = true;
-                _thread = std::unique_ptr<std::thread>(new std::thread([this](){ capture_loop(); }));
+                if (auto reactor = capture_reactor::get())
+                {
+                    reactor->add(_fd, [this]()
+                    {
+                        try
+                        {
+                            dequeue_frame();
+                        }
+                        catch (const std::exception& ex)
+                        {
+                            LOG_ERROR(ex.what());
+                            capture_reactor::get()->remove(_fd);
+
+                            librealsense::notification n = {RS2_NOTIFICATION_CATEGORY_UNKNOWN_ERROR, 0, RS2_LOG_SEVERITY_ERROR, ex.what()};
+                            _error_handler(n);
+                        }
+                    },
+                    [this]()
+                    {
+                        LOG_WARNING("Frames didn't arrived within 5 seconds");
+                        librealsense::notification n = {RS2_NOTIFICATION_CATEGORY_FRAMES_TIMEOUT, 0, RS2_LOG_SEVERITY_WARN,  "Frames didn't arrived within 5 seconds"};
+                        _error_handler(n);
+                    }, CAPTURE_TIMEOUT_MS);
+                }
+                else
+                {
+                    _thread = std::unique_ptr<std::thread>(new std::thread([this](){ capture_loop(); }));
+                }
             }
         }
 
@@ -654,11 +783,17 @@ namespace librealsense
             {
                 _is_capturing = false;
                 _is_started = false;
-                signal_stop();
-
-                _thread->join();
-                _thread.reset();
+                if (_thread)
+                {
+                    signal_stop();
 
+                    _thread->join();
+                    _thread.reset();
+                }
+                else
+                {
+                    capture_reactor::get()->remove(_fd);
+                }
 
                 // Stop streamining
                 v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
@@ -672,25 +807,43 @@ namespace librealsense
                 {
                     _buffers[i]->detach_buffer();
                 }
-                _buffers.resize(0);
 
-                // Close memory mapped IO
-                struct v4l2_requestbuffers req = {};
-                req.count = 0;
-                req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-                req.memory = _use_memory_map ? V4L2_MEMORY_MMAP : V4L2_MEMORY_USERPTR;
-                if(xioctl(_fd, VIDIOC_REQBUFS, &req) < 0)
-                {
-                    if(errno == EINVAL)
-                        LOG_ERROR(_name + " does not support memory mapping");
-                    else
-                        throw linux_backend_exception("xioctl(VIDIOC_REQBUFS) failed");
-                }
+                // The format and the buffers stay configured, the next commit of the same profile only queues them
+                if (_keep_buffers)
+                    _has_kept_buffers = true;
+                else
+                    release_buffers();
 
                 _callback = nullptr;
             }
         }
 
+        void v4l_uvc_device::set_keep_buffers(bool keep)
+        {
+            _keep_buffers = keep;
+            if (!keep && _has_kept_buffers)
+                release_buffers();
+        }
+
+        void v4l_uvc_device::release_buffers()
+        {
+            _buffers.resize(0);
+            _has_kept_buffers = false;
+
+            // Close memory mapped IO
+            struct v4l2_requestbuffers req = {};
+            req.count = 0;
+            req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+            req.memory = _use_memory_map ? V4L2_MEMORY_MMAP : V4L2_MEMORY_USERPTR;
+            if(xioctl(_fd, VIDIOC_REQBUFS, &req) < 0)
+            {
+                if(errno == EINVAL)
+                    LOG_ERROR(_name + " does not support memory mapping");
+                else
+                    throw linux_backend_exception("xioctl(VIDIOC_REQBUFS) failed");
+            }
+        }
+
         std::string v4l_uvc_device::fourcc_to_string(uint32_t id) const
         {
             uint32_t device_fourcc = id;
@@ -752,68 +905,7 @@ namespace librealsense
                 {
                     FD_ZERO(&fds);
                     FD_SET(_fd, &fds);
-                    v4l2_buffer buf = {};
-                    buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-                    buf.memory = _use_memory_map ? V4L2_MEMORY_MMAP : V4L2_MEMORY_USERPTR;
-                    if(xioctl(_fd, VIDIOC_DQBUF, &buf) < 0)
-                    {
-                        if(errno == EAGAIN)
-                            return;
-
-                        throw linux_backend_exception("xioctl(VIDIOC_DQBUF) failed");
-                    }
-
-                    bool moved_qbuff = false;
-                    auto buffer = _buffers[buf.index];
-
-                    if (_is_started)
-                    {
-                        if((buf.bytesused < buffer->get_full_length() - MAX_META_DATA_SIZE) &&
-                                buf.bytesused > 0)
-                        {
-                            auto percentage = (100 * buf.bytesused) / buffer->get_full_length();
-                            std::stringstream s;
-                            s << "Incomplete frame detected!\nSize " << buf.bytesused
-                              << " out of " << buffer->get_full_length() << " bytes (" << percentage << "%)";
-                            librealsense::notification n = { RS2_NOTIFICATION_CATEGORY_FRAME_CORRUPTED, 0, RS2_LOG_SEVERITY_WARN, s.str()};
-
-                            _error_handler(n);
-                        }
-                        else
-                        {
-                            void* md_start = nullptr;
-                            uint8_t md_size = 0;
-                            if (has_metadata())
-                            {
-                                md_start = buffer->get_frame_start() + buffer->get_length_frame_only();
-                                md_size = (*(uint8_t*)md_start);
-                            }
-
-                            frame_object fo{ buffer->get_length_frame_only(), md_size,
-                                buffer->get_frame_start(), md_start };
-
-                             if (buf.bytesused > 0)
-                             {
-                                 buffer->attach_buffer(buf);
-                                 moved_qbuff = true;
-                                 auto fd = _fd;
-                                 _callback(_profile, fo,
-                                           [fd, buffer]() mutable {
-                                     buffer->request_next_frame(fd);
-                                 });
-                             }
-                             else
-                             {
-                                 LOG_WARNING("Empty frame has arrived.");
-                             }
-                        }
-                    }
-
-                    if (!moved_qbuff)
-                    {
-                        if (xioctl(_fd, VIDIOC_QBUF, &buf) < 0)
-                            throw linux_backend_exception("xioctl(VIDIOC_QBUF) failed");
-                    }
+                    dequeue_frame();
                 }
                 else
                 {
@@ -829,6 +921,81 @@ namespace librealsense
             }
         }
 
+        void v4l_uvc_device::dequeue_frame()
+        {
+            v4l2_buffer buf = {};
+            buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+            buf.memory = _use_memory_map ? V4L2_MEMORY_MMAP : V4L2_MEMORY_USERPTR;
+            if(xioctl(_fd, VIDIOC_DQBUF, &buf) < 0)
+            {
+                if(errno == EAGAIN)
+                    return;
+
+                throw linux_backend_exception("xioctl(VIDIOC_DQBUF) failed");
+            }
+            RS2_TRACE_INSTANT("v4l2 dequeue", buf.sequence);
+
+            bool moved_qbuff = false;
+            auto buffer = _buffers[buf.index];
+
+            if (_is_started)
+            {
+                // Compressed frames vary in size, only the bytes used hold the frame
+                auto compressed = _profile.format == 'MJPG';
+                if(!compressed && (buf.bytesused < buffer->get_full_length() - MAX_META_DATA_SIZE) &&
+                        buf.bytesused > 0)
+                {
+                    auto percentage = (100 * buf.bytesused) / buffer->get_full_length();
+                    std::stringstream s;
+                    s << "Incomplete frame detected!\nSize " << buf.bytesused
+                      << " out of " << buffer->get_full_length() << " bytes (" << percentage << "%)";
+                    librealsense::notification n = { RS2_NOTIFICATION_CATEGORY_FRAME_CORRUPTED, 0, RS2_LOG_SEVERITY_WARN, s.str()};
+
+                    _error_handler(n);
+                }
+                else
+                {
+                    void* md_start = nullptr;
+                    uint8_t md_size = 0;
+                    if (has_metadata())
+                    {
+                        md_start = buffer->get_frame_start() + buffer->get_length_frame_only();
+                        md_size = (*(uint8_t*)md_start);
+                    }
+
+                    frame_object fo{ compressed ? std::min<size_t>(buf.bytesused, buffer->get_length_frame_only()) : buffer->get_length_frame_only(), md_size,
+                        buffer->get_frame_start(), md_start };
+
+                     if (buf.bytesused > 0)
+                     {
+                         buffer->attach_buffer(buf);
+                         moved_qbuff = true;
+                         auto fd = _fd;
+                         auto stats = _hold_stats;
+                         buffer_hold_stats::raise(stats->max_held, ++stats->held);
+                         auto dequeued = std::chrono::steady_clock::now();
+                         _callback(_profile, fo,
+                                   [fd, buffer, stats, dequeued]() mutable {
+                             buffer->request_next_frame(fd);
+                             auto hold_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - dequeued).count();
+                             buffer_hold_stats::raise<int64_t>(stats->max_hold_us, hold_us);
+                             --stats->held;
+                         });
+                     }
+                     else
+                     {
+                         LOG_WARNING("Empty frame has arrived.");
+                     }
+                }
+            }
+
+            if (!moved_qbuff)
+            {
+                if (xioctl(_fd, VIDIOC_QBUF, &buf) < 0)
+                    throw linux_backend_exception("xioctl(VIDIOC_QBUF) failed");
+            }
+        }
+
         void v4l_uvc_device::set_power_state(power_state state)
         {
             if (state == D0 && _state == D3)
@@ -876,6 +1043,8 @@ namespace librealsense
             if (state == D3 && _state == D0)
             {
                 close(_profile);
+                if (_has_kept_buffers)
+                    release_buffers();
                 if(::close(_fd) < 0)
                     throw linux_backend_exception("v4l_uvc_device: close(_fd) failed");
 
@@ -1149,6 +1318,15 @@ namespace librealsense
             _named_mtx->unlock();
         }
 
+        void v4l_uvc_device::acquire_lease() const
+        {
+            _named_mtx->acquire_lease();
+        }
+        void v4l_uvc_device::release_lease() const
+        {
+            _named_mtx->release_lease();
+        }
+
         uint32_t v4l_uvc_device::get_cid(rs2_option option)
         {
             switch(option)
@@ -1173,6 +1351,9 @@ namespace librealsense
 
         void v4l_uvc_device::capture_loop()
         {
+            thread_registration registration("rs-v4l-capture", RS2_THREAD_CLASS_CAPTURE);
+            capture_thread_settings::get().apply();
+
             try
             {
                 while(_is_capturing)
@@ -1253,9 +1434,181 @@ namespace librealsense
             return std::make_shared<os_time_service>();
         }
 
+        // Events of udev are sent once its rules ran and the device nodes exist, raw kernel events are received
+        // too for systems without udev
+        const uint32_t UEVENT_KERNEL_GROUP = 1;
+        const uint32_t UEVENT_UDEV_GROUP = 2;
+        // A device shows up as a burst of events, the devices are queried once the burst is over
+        const int UEVENT_SETTLE_MS = 50;
+        // Without udev the device nodes can lag behind the kernel event, an unchanged query is retried this many times
+        const int UEVENT_RETRIES = 5;
+        const int UEVENT_RETRY_MS = 200;
+
+        udev_device_watcher::udev_device_watcher(const backend* backend_ref)
+            : _backend(backend_ref), _fallback(backend_ref), _use_fallback(false), _uevent_fd(-1), _stop_pipe_fd{ -1, -1 }
+        {
+        }
+
+        udev_device_watcher::~udev_device_watcher()
+        {
+            stop();
+        }
+
+        int udev_device_watcher::open_uevent_socket()
+        {
+            int fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC | SOCK_NONBLOCK, NETLINK_KOBJECT_UEVENT);
+            if (fd < 0)
+                return -1;
+
+            sockaddr_nl addr = {};
+            addr.nl_family = AF_NETLINK;
+            addr.nl_groups = UEVENT_KERNEL_GROUP | UEVENT_UDEV_GROUP;
+            if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0)
+            {
+                ::close(fd);
+                return -1;
+            }
+            return fd;
+        }
+
+        void udev_device_watcher::start(device_changed_callback callback)
+        {
+            stop();
+
+            _uevent_fd = open_uevent_socket();
+            if (_uevent_fd < 0 || pipe(_stop_pipe_fd) < 0)
+            {
+                LOG_WARNING("Failed to listen to device events (" << strerror(errno) << "), polling for device changes");
+                if (_uevent_fd >= 0)
+                    ::close(_uevent_fd);
+                _uevent_fd = -1;
+                _use_fallback = true;
+                _fallback.start(std::move(callback));
+                return;
+            }
+
+            _callback = std::move(callback);
+            _devices_data = { _backend->query_uvc_devices(),
+                              _backend->query_usb_devices(),
+                              _backend->query_hid_devices() };
+            _thread = std::unique_ptr<std::thread>(new std::thread([this]()
+            {
+                thread_registration registration("rs-udev-watch", RS2_THREAD_CLASS_IO);
+                watch();
+            }));
+        }
+
+        void udev_device_watcher::stop()
+        {
+            if (_use_fallback)
+            {
+                _fallback.stop();
+                _use_fallback = false;
+            }
+
+            if (_thread)
+            {
+                char buff[1] = {};
+                if (write(_stop_pipe_fd[1], buff, 1) < 0)
+                {
+                    LOG_ERROR("Failed to stop the device watcher: " << strerror(errno));
+                }
+                _thread->join();
+                _thread.reset();
+            }
+            _callback_inflight.wait_until_empty();
+
+            for (auto fd : { _uevent_fd, _stop_pipe_fd[0], _stop_pipe_fd[1] })
+            {
+                if (fd >= 0)
+                    ::close(fd);
+            }
+            _uevent_fd = _stop_pipe_fd[0] = _stop_pipe_fd[1] = -1;
+        }
+
+        // Drains the pending events, returns true if any of them is of a subsystem the backend enumerates
+        bool udev_device_watcher::read_uevents()
+        {
+            static const char* subsystems[] = { "SUBSYSTEM=usb", "SUBSYSTEM=video4linux", "SUBSYSTEM=hidraw", "SUBSYSTEM=iio" };
+
+            bool relevant = false;
+            char buff[8192];
+            ssize_t size;
+            while ((size = recv(_uevent_fd, buff, sizeof(buff), 0)) > 0)
+            {
+                //Both kernel and udev events hold their properties as null terminated KEY=VALUE strings
+                for (ssize_t i = 0; i < size && !relevant; i += strnlen(buff + i, size - i) + 1)
+                {
+                    for (auto subsystem : subsystems)
+                    {
+                        if (strncmp(buff + i, subsystem, size - i) == 0)
+                            relevant = true;
+                    }
+                }
+            }
+            return relevant;
+        }
+
+        void udev_device_watcher::update_devices(bool& changed)
+        {
+            backend_device_group curr(_backend->query_uvc_devices(), _backend->query_usb_devices(), _backend->query_hid_devices());
+
+            changed = list_changed(_devices_data.uvc_devices, curr.uvc_devices) ||
+                      list_changed(_devices_data.usb_devices, curr.usb_devices) ||
+                      list_changed(_devices_data.hid_devices, curr.hid_devices);
+            if (changed)
+            {
+                callback_invocation_holder callback = { _callback_inflight.allocate(), &_callback_inflight };
+                if (callback)
+                {
+                    _callback(_devices_data, curr);
+                    _devices_data = curr;
+                }
+            }
+        }
+
+        void udev_device_watcher::watch()
+        {
+            int retries = 0;
+            bool pending = false;
+            while (true)
+            {
+                pollfd fds[2] = { { _uevent_fd, POLLIN, 0 }, { _stop_pipe_fd[0], POLLIN, 0 } };
+                auto timeout = pending ? UEVENT_SETTLE_MS : (retries > 0 ? UEVENT_RETRY_MS : -1);
+                auto ready = poll(fds, 2, timeout);
+                if (ready < 0 && errno != EINTR)
+                {
+                    LOG_ERROR("Device watcher stopped: " << strerror(errno));
+                    return;
+                }
+                if (fds[1].revents)
+                {
+                    return;
+                }
+
+                if (ready > 0 && fds[0].revents)
+                {
+                    if (read_uevents())
+                    {
+                        pending = true;
+                        retries = UEVENT_RETRIES;
+                    }
+                    continue;
+                }
+
+                if (ready == 0 && (pending || retries > 0))
+                {
+                    pending = false;
+                    bool changed;
+                    update_devices(changed);
+                    retries = changed ? 0 : retries - 1;
+                }
+            }
+        }
+
         std::shared_ptr<device_watcher> v4l_backend::create_device_watcher() const
         {
-            return std::make_shared<polling_device_watcher>(this);
+            return std::make_shared<udev_device_watcher>(this);
         }
 
         std::shared_ptr<backend> create_backend()
@@ -54,14 +54,22 @@ namespace librealsense
 
             named_mutex(const named_mutex&) = delete;
 
-            void lock() { acquire(); }
-            void unlock() { release(); }
+            // lock and lease both hold the file lock, which is only taken by the first holder of the process
+            // and released by the last, so while a lease is held locking does no system call
+            void lock() { hold(); }
+            void unlock() { drop(); }
+
+            void acquire_lease() { hold(); }
+            void release_lease() { drop(); }
 
             bool try_lock();
 
             ~named_mutex();
 
         private:
+            void hold();
+            void drop();
+
             void acquire();
 
             void release();
@@ -73,6 +81,9 @@ namespace librealsense
             std::string _device_path;
             uint32_t _timeout;
             int _fildes;
+
+            std::atomic<int> _holders;
+            std::mutex _file_lock_mutex; // taken when the count of holders leaves or comes back to zero
         };
 
         static int xioctl(int fh, int request, void *arg);
@@ -141,7 +152,7 @@ namespace librealsense
 
             ~v4l_uvc_device();
 
-            void probe_and_commit(stream_profile profile, frame_callback callback, int buffers) override;
+            void probe_and_commit(stream_profile profile, frame_callback callback, int requested_buffers) override;
 
             void stream_on(std::function<void(const notification& n)> error_handler) override;
 
@@ -151,12 +162,20 @@ namespace librealsense
 
             void close(stream_profile) override;
 
+            void set_keep_buffers(bool keep) override;
+
+            void set_adaptive_buffers(int max_buffers) override;
+            int get_buffer_count() const override { return static_cast<int>(_buffers.size()); }
+
             std::string fourcc_to_string(uint32_t id) const;
 
             void signal_stop();
 
             void poll();
 
+            // Take the next filled buffer off the driver queue and deliver it
+            void dequeue_frame();
+
             void set_power_state(power_state state) override;
             power_state get_power_state() const override { return _state; }
 
@@ -176,6 +195,9 @@ namespace librealsense
             void lock() const override;
             void unlock() const override;
 
+            void acquire_lease() const override;
+            void release_lease() const override;
+
             std::string get_device_location() const override { return _device_path; }
         private:
             static uint32_t get_cid(rs2_option option);
@@ -184,6 +206,28 @@ namespace librealsense
 
             bool has_metadata();
 
+            // Frees the kernel buffers, including the ones kept after close
+            void release_buffers();
+
+            // How long the frames of a session held the buffers out of the driver, shared with the continuations
+            // of the frames since they may outlive the session
+            struct buffer_hold_stats
+            {
+                std::atomic<uint32_t> held{ 0 };
+                std::atomic<uint32_t> max_held{ 0 };
+                std::atomic<int64_t> max_hold_us{ 0 };
+
+                template<class T>
+                static void raise(std::atomic<T>& max, T value)
+                {
+                    auto current = max.load();
+                    while (value > current && !max.compare_exchange_weak(current, value));
+                }
+            };
+
+            // Number of buffers to commit the profile with, adapted to the previous sessions of the same profile
+            int choose_buffer_count(const stream_profile& profile, int requested);
+
             power_state _state = D3;
             std::string _name;
             std::string _device_path;
@@ -200,6 +244,41 @@ namespace librealsense
             std::unique_ptr<std::thread> _thread;
             std::unique_ptr<named_mutex> _named_mtx;
             bool _use_memory_map;
+            int _requested_buffers = 0;
+            bool _keep_buffers = false;
+            bool _has_kept_buffers = false;     // Buffers of _profile kept after close, until committed again
+            int _max_adaptive_buffers = 0;      // 0 for the number of buffers requested
+            int _adaptive_buffers = 0;          // Chosen for _adaptive_profile
+            stream_profile _adaptive_profile{};
+            std::shared_ptr<buffer_hold_stats> _hold_stats = std::make_shared<buffer_hold_stats>();
+        };
+
+        // Watches the uevents the kernel and udev broadcast on netlink, and queries the devices only when one of the
+        // relevant subsystems changes. Falls back to polling when the netlink socket is not available
+        class udev_device_watcher : public device_watcher
+        {
+        public:
+            udev_device_watcher(const backend* backend_ref);
+            ~udev_device_watcher();
+
+            void start(device_changed_callback callback) override;
+            void stop() override;
+
+        private:
+            static int open_uevent_socket();
+            bool read_uevents();
+            void watch();
+            void update_devices(bool& changed);
+
+            const backend* _backend;
+            polling_device_watcher _fallback;
+            bool _use_fallback;
+            int _uevent_fd;
+            int _stop_pipe_fd[2]; // write to _stop_pipe_fd[1] and read from _stop_pipe_fd[0]
+            std::unique_ptr<std::thread> _thread;
+            callbacks_heap _callback_inflight;
+            backend_device_group _devices_data;
+            device_changed_callback _callback;
         };
 
         class v4l_backend : public backend
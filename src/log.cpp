@@ -1,12 +1,114 @@
 #include "types.h"
 
+#include <atomic>
 #include <fstream>
 #include <iostream>
+#include <thread>
 
 INITIALIZE_EASYLOGGINGPP
 
 namespace librealsense
 {
+    std::atomic<int> minimum_log_output_severity{ RS2_LOG_SEVERITY_NONE };
+
+    static const unsigned int LOG_QUEUE_SIZE = 4096;
+
+    struct log_record
+    {
+        rs2_log_severity severity = RS2_LOG_SEVERITY_NONE;
+        const char* file = "";
+        int line = 0;
+        std::thread::id thread;
+        std::string message;
+    };
+
+    static el::Level severity_to_level(rs2_log_severity severity)
+    {
+        switch (severity)
+        {
+        case RS2_LOG_SEVERITY_DEBUG: return el::Level::Debug;
+        case RS2_LOG_SEVERITY_INFO: return el::Level::Info;
+        case RS2_LOG_SEVERITY_WARN: return el::Level::Warning;
+        case RS2_LOG_SEVERITY_ERROR: return el::Level::Error;
+        case RS2_LOG_SEVERITY_FATAL: return el::Level::Fatal;
+        default: return el::Level::Unknown;
+        }
+    }
+
+    // The record keeps the file and line of the caller, the thread is part of the message since the
+    // record is written by another thread
+    static void write_record(const log_record& record)
+    {
+        el::base::Writer(severity_to_level(record.severity), record.file, record.line, ELPP_FUNC)
+            .construct(1, "librealsense") << "[" << record.thread << "] " << record.message;
+    }
+
+    // Set while the writer thread runs, messages are written by the caller before it starts and after it stops
+    static std::atomic<bool> log_writer_running{ false };
+
+    // Writes the messages of the library on its own thread, so threads streaming frames only format a message
+    // and enqueue it. When the queue is full the oldest messages are dropped and their count is reported
+    class log_writer
+    {
+    public:
+        log_writer()
+            : _queue(LOG_QUEUE_SIZE), _stopping(false), _reported_drops(0)
+        {
+            _thread = std::thread([this]()
+            {
+                thread_registration registration("rs-log", RS2_THREAD_CLASS_IO);
+                run();
+            });
+            log_writer_running = true;
+        }
+
+        ~log_writer()
+        {
+            log_writer_running = false;
+            _stopping = true;
+            if (_thread.joinable())
+                _thread.join();
+        }
+
+        void enqueue(log_record&& record) { _queue.enqueue(std::move(record)); }
+
+    private:
+        void run()
+        {
+            log_record record;
+            while (!_stopping)
+            {
+                if (_queue.dequeue(&record, 100))
+                    write_record(record);
+                report_drops();
+            }
+            // Messages still queued when the library unloads are written before the thread exits
+            while (_queue.try_dequeue(&record))
+                write_record(record);
+        }
+
+        void report_drops()
+        {
+            auto dropped = _queue.get_dropped_count();
+            if (dropped == _reported_drops)
+                return;
+
+            log_record record;
+            record.severity = RS2_LOG_SEVERITY_WARN;
+            record.file = __FILE__;
+            record.line = __LINE__;
+            record.thread = std::this_thread::get_id();
+            record.message = to_string() << (dropped - _reported_drops) << " log messages were dropped, the log queue was full";
+            write_record(record);
+            _reported_drops = dropped;
+        }
+
+        lock_free_queue<log_record> _queue;
+        std::atomic<bool> _stopping;
+        unsigned long long _reported_drops;
+        std::thread _thread;
+    };
+
     class logger_type
     {
         rs2_log_severity minimum_log_severity = RS2_LOG_SEVERITY_NONE;
@@ -21,22 +123,13 @@ namespace librealsense
         std::string filename;
         const std::string log_id = "librealsense";
 
+        log_writer writer; // Declared last, so queued messages are written before the configuration goes away
+
     public:
-        static el::Level severity_to_level(rs2_log_severity severity)
+        void open()
         {
-            switch (severity)
-            {
-            case RS2_LOG_SEVERITY_DEBUG: return el::Level::Debug;
-            case RS2_LOG_SEVERITY_INFO: return el::Level::Info;
-            case RS2_LOG_SEVERITY_WARN: return el::Level::Warning;
-            case RS2_LOG_SEVERITY_ERROR: return el::Level::Error;
-            case RS2_LOG_SEVERITY_FATAL: return el::Level::Fatal;
-            default: return el::Level::Unknown;
-            }
-        }
+            minimum_log_output_severity = std::min(minimum_console_severity, minimum_file_severity);
 
-        void open() const
-        {
             el::Configurations defaultConf;
             defaultConf.setToDefault();
             // To set GLOBAL configurations you may use
@@ -45,7 +138,7 @@ namespace librealsense
             defaultConf.setGlobally(el::ConfigurationType::ToStandardOutput, "false");
             defaultConf.setGlobally(el::ConfigurationType::MaxLogFileSize, "2097152");
             defaultConf.setGlobally(el::ConfigurationType::LogFlushThreshold, "10");
-            defaultConf.setGlobally(el::ConfigurationType::Format, " %datetime{%d/%M %H:%m:%s,%g} %level [%thread] (%fbase:%line) %msg");
+            defaultConf.setGlobally(el::ConfigurationType::Format, " %datetime{%d/%M %H:%m:%s,%g} %level (%fbase:%line) %msg");
 
             for (int i = minimum_console_severity; i < RS2_LOG_SEVERITY_NONE; i++)
             {
@@ -63,8 +156,10 @@ namespace librealsense
             el::Loggers::reconfigureLogger(log_id, defaultConf);
         }
 
-        void open_def() const
+        void open_def()
         {
+            minimum_log_output_severity = RS2_LOG_SEVERITY_NONE;
+
             el::Configurations defaultConf;
             defaultConf.setToDefault();
             // To set GLOBAL configurations you may use
@@ -117,6 +212,15 @@ namespace librealsense
             return false;
         }
 
+        void log(log_record&& record)
+        {
+            // Fatal messages are written before the caller goes on, in case it does not survive them
+            if (record.severity == RS2_LOG_SEVERITY_FATAL || !log_writer_running)
+                write_record(record);
+            else
+                writer.enqueue(std::move(record));
+        }
+
         void log_to_console(rs2_log_severity min_severity)
         {
             minimum_console_severity = min_severity;
@@ -138,6 +242,17 @@ namespace librealsense
     static logger_type logger;
 }
 
+void librealsense::log_message(rs2_log_severity severity, const char* file, int line, std::string message)
+{
+    log_record record;
+    record.severity = severity;
+    record.file = file;
+    record.line = line;
+    record.thread = std::this_thread::get_id();
+    record.message = std::move(message);
+    logger.log(std::move(record));
+}
+
 void librealsense::log_to_console(rs2_log_severity min_severity)
 {
     logger.log_to_console(min_severity);
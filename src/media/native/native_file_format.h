@@ -0,0 +1,120 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include "core/serialization.h"
+
+namespace librealsense
+{
+    // A native recording keeps the frames of each stream in an append-only file of its own, with fixed-size record
+    // headers and no per-message topics or connections, next to a bag holding everything else:
+    //
+    //     <name>.rsn                                  Index, rewritten when the recording is closed
+    //     <name>_description.bag                      Device description, option changes, extrinsics and thumbnails
+    //     <name>_<sensor>_<stream>_<index>.frames     Frame records of one stream, in the order they were written
+    //
+    // The index starts with native_index_header and holds, for each stream, a native_index_stream followed by one
+    // native_index_entry per frame. A frame record is a native_frame_header, the metadata pairs of the frame and the
+    // payload. Records and payloads start at multiples of NATIVE_RECORD_ALIGNMENT, so the uncompressed frames of a
+    // mapped file are referenced in place
+    const uint64_t NATIVE_INDEX_MAGIC = 0x58444e494e535352; // "RSSNINDX"
+    const uint32_t NATIVE_FORMAT_VERSION = 1;
+    const uint32_t NATIVE_FRAME_MAGIC = 0x464e5352;         // "RSNF"
+    const uint32_t NATIVE_RECORD_ALIGNMENT = 64;
+
+    enum class native_compression : uint32_t
+    {
+        none,
+        lz4,
+        depth_codec     // The lossless depth codec, for Z16 streams
+    };
+
+    struct native_index_header
+    {
+        uint64_t magic;
+        uint32_t version;
+        uint32_t stream_count;
+    };
+
+    struct native_index_stream
+    {
+        uint32_t device_index;
+        uint32_t sensor_index;
+        uint32_t stream_type;
+        uint32_t stream_index;
+        uint32_t compression;
+        uint32_t reserved;
+        uint64_t frame_count;
+    };
+
+    struct native_index_entry
+    {
+        uint64_t time;          // Nanoseconds on the timeline of the recording
+        uint64_t offset;        // Of the record in the frames file of the stream
+        uint32_t size;          // Of the record, with its padding
+        uint32_t reserved;
+    };
+
+    struct native_frame_header
+    {
+        uint32_t magic;
+        uint32_t compression;
+        uint64_t time;
+        double timestamp;
+        double system_time;
+        uint64_t frame_number;
+        int32_t timestamp_domain;
+        uint32_t format;
+        uint32_t width;         // Video frames only
+        uint32_t height;
+        uint32_t stride;
+        uint32_t metadata_size; // Bytes of rs2_frame_metadata_value and rs2_metadata_type pairs after the header
+        uint32_t data_size;     // Bytes of the payload as stored
+        uint32_t raw_size;      // Bytes of the payload once decompressed
+    };
+
+    static_assert(sizeof(native_index_header) == 16, "The native index header is read and written as is");
+    static_assert(sizeof(native_index_stream) == 32, "The native index streams are read and written as is");
+    static_assert(sizeof(native_index_entry) == 24, "The native index entries are read and written as is");
+    static_assert(sizeof(native_frame_header) == 72, "The native frame headers are read and written as is");
+
+    inline uint64_t align_native_record(uint64_t size)
+    {
+        return (size + NATIVE_RECORD_ALIGNMENT - 1) / NATIVE_RECORD_ALIGNMENT * NATIVE_RECORD_ALIGNMENT;
+    }
+
+    inline bool is_native_recording(const std::string& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        native_index_header header{};
+        return file.read(reinterpret_cast<char*>(&header), sizeof(header)) && header.magic == NATIVE_INDEX_MAGIC;
+    }
+
+    // The files of a recording are named after its index, without the extension
+    inline std::string get_native_base_path(const std::string& index_path)
+    {
+        auto separator = index_path.find_last_of("/\\");
+        auto extension = index_path.find_last_of('.');
+        if (extension != std::string::npos && (separator == std::string::npos || extension > separator))
+            return index_path.substr(0, extension);
+        return index_path;
+    }
+
+    inline std::string get_native_description_path(const std::string& index_path)
+    {
+        return get_native_base_path(index_path) + "_description.bag";
+    }
+
+    inline std::string get_native_stream_path(const std::string& index_path, const device_serializer::stream_identifier& stream_id)
+    {
+        std::ostringstream path;
+        path << get_native_base_path(index_path) << "_" << stream_id.sensor_index << "_" << rs2_stream_to_string(stream_id.stream_type)
+             << "_" << stream_id.stream_index << ".frames";
+        return path.str();
+    }
+}
@@ -0,0 +1,351 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#include "native_reader.h"
+#include "media/ros/depth_codec.h"
+#include "image.h"
+#include "../../../third-party/realsense-file/lz4/lz4.h"
+
+using namespace librealsense;
+using namespace device_serializer;
+
+namespace
+{
+    std::shared_ptr<metadata_parser_map> create_metadata_parser_map()
+    {
+        auto md_parser_map = std::make_shared<metadata_parser_map>();
+        for (int i = 0; i < static_cast<int>(rs2_frame_metadata_value::RS2_FRAME_METADATA_COUNT); ++i)
+        {
+            auto frame_md_type = static_cast<rs2_frame_metadata_value>(i);
+            md_parser_map->insert(std::make_pair(frame_md_type, std::make_shared<md_constant_parser>(frame_md_type)));
+        }
+        return md_parser_map;
+    }
+
+    void decompress(const native_frame_header& header, const uint8_t* payload, uint8_t* out)
+    {
+        switch (static_cast<native_compression>(header.compression))
+        {
+        case native_compression::none:
+            if (header.data_size != header.raw_size)
+                throw io_exception("Invalid file format, frame of an unexpected size");
+            memcpy(out, payload, header.raw_size);
+            break;
+        case native_compression::lz4:
+        {
+            auto size = LZ4_decompress_safe(reinterpret_cast<const char*>(payload), reinterpret_cast<char*>(out),
+                                            static_cast<int>(header.data_size), static_cast<int>(header.raw_size));
+            if (size != static_cast<int>(header.raw_size))
+                throw io_exception("Invalid file format, failed to decompress a frame");
+            break;
+        }
+        case native_compression::depth_codec:
+            if (static_cast<uint64_t>(header.stride) * header.height > header.raw_size)
+                throw io_exception("Invalid file format, depth frame larger than its payload");
+            decode_depth(payload, header.data_size, header.width, header.height, header.stride, reinterpret_cast<uint16_t*>(out));
+            break;
+        default:
+            throw io_exception(to_string() << "Invalid file format, unknown compression " << header.compression);
+        }
+    }
+
+    // Bits per pixel of the rows of a recorded video frame. The rows of the planes of NV12 have a byte per pixel,
+    // compressed depth keeps the dimensions of the depth image with rows of any length, checked by its decoder
+    int get_row_bpp(rs2_format format)
+    {
+        if (format == RS2_FORMAT_NV12) return 8;
+        if (format == RS2_FORMAT_Z16_COMPRESSED) return 0;
+        return get_image_bpp(format);
+    }
+}
+
+native_reader::native_reader(const std::string& file, const std::shared_ptr<context>& ctx) :
+    m_file_path(file),
+    m_context(ctx),
+    m_description(get_native_description_path(file), ctx),
+    m_begin_time(0),
+    m_end_time(0),
+    m_position(0)
+{
+    read_index();
+    reset();
+}
+
+void native_reader::read_index()
+{
+    std::ifstream file(m_file_path, std::ios::binary);
+    native_index_header header{};
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != NATIVE_INDEX_MAGIC)
+    {
+        throw io_exception(to_string() << "\"" << m_file_path << "\" is not a native recording");
+    }
+    if (header.version != NATIVE_FORMAT_VERSION)
+    {
+        throw io_exception(to_string() << "Unsupported version " << header.version << " of the native recording " << m_file_path);
+    }
+
+    auto has_frames = false;
+    for (uint32_t i = 0; i < header.stream_count; i++)
+    {
+        native_index_stream info{};
+        if (!file.read(reinterpret_cast<char*>(&info), sizeof(info)))
+        {
+            throw io_exception(to_string() << "The index of " << m_file_path << " is truncated");
+        }
+        stream_data stream;
+        stream.id = { info.device_index, info.sensor_index, static_cast<rs2_stream>(info.stream_type), info.stream_index };
+        stream.index.resize(static_cast<size_t>(info.frame_count));
+        if (!file.read(reinterpret_cast<char*>(stream.index.data()), stream.index.size() * sizeof(native_index_entry)))
+        {
+            throw io_exception(to_string() << "The index of " << m_file_path << " is truncated");
+        }
+        if (!stream.index.empty())
+        {
+            stream.file = std::make_shared<mapped_file>(get_native_stream_path(m_file_path, stream.id));
+            auto begin = nanoseconds(stream.index.front().time);
+            auto end = nanoseconds(stream.index.back().time);
+            m_begin_time = has_frames ? std::min(m_begin_time, begin) : begin;
+            m_end_time = has_frames ? std::max(m_end_time, end) : end;
+            has_frames = true;
+        }
+        stream.next = 0;
+        stream.enabled = false;
+        m_streams.push_back(std::move(stream));
+    }
+}
+
+device_snapshot native_reader::query_device_description(const nanoseconds& time)
+{
+    return m_description.query_device_description(time);
+}
+
+// Frames of the enabled streams and option changes of the description, whichever comes first
+std::shared_ptr<serialized_data> native_reader::read_next_data()
+{
+    if (!m_next_option)
+    {
+        m_next_option = m_description.read_next_data();
+    }
+
+    stream_data* next = nullptr;
+    for (auto&& stream : m_streams)
+    {
+        if (!stream.enabled || stream.next >= stream.index.size())
+            continue;
+        if (!next || stream.index[stream.next].time < next->index[next->next].time)
+            next = &stream;
+    }
+
+    auto option_pending = !m_next_option->is<serialized_end_of_file>();
+    if (!next || (option_pending && m_next_option->get_timestamp().count() <= next->index[next->next].time))
+    {
+        if (!option_pending)
+        {
+            LOG_DEBUG("End of file reached");
+            return m_next_option;
+        }
+        std::shared_ptr<serialized_data> option;
+        std::swap(option, m_next_option);
+        m_position = option->get_timestamp();
+        return option;
+    }
+
+    auto&& entry = next->index[next->next++];
+    m_position = nanoseconds(entry.time);
+    return std::make_shared<serialized_frame>(m_position, next->id, create_frame(*next, entry));
+}
+
+frame_holder native_reader::create_frame(const stream_data& stream, const native_index_entry& entry)
+{
+    auto&& file = *stream.file;
+    if (entry.size < sizeof(native_frame_header) || entry.offset + entry.size > file.size())
+    {
+        throw io_exception(to_string() << "Invalid file format, frame of stream " << stream.id << " is out of its file");
+    }
+    auto record = file.data() + entry.offset;
+    native_frame_header header;
+    memcpy(&header, record, sizeof(header));
+    auto payload_offset = align_native_record(sizeof(header) + header.metadata_size);
+    if (header.magic != NATIVE_FRAME_MAGIC || payload_offset + header.data_size > entry.size)
+    {
+        throw io_exception(to_string() << "Invalid file format, corrupted frame of stream " << stream.id);
+    }
+    auto payload = record + payload_offset;
+
+    frame_additional_data additional_data{};
+    additional_data.timestamp = header.timestamp;
+    additional_data.frame_number = header.frame_number;
+    additional_data.system_time = header.system_time;
+    additional_data.timestamp_domain = static_cast<rs2_timestamp_domain>(header.timestamp_domain);
+    const size_t pair_size = sizeof(rs2_frame_metadata_value) + sizeof(rs2_metadata_type);
+    auto metadata_size = std::min<size_t>(header.metadata_size, additional_data.metadata_blob.size() / pair_size * pair_size);
+    memcpy(additional_data.metadata_blob.data(), record + sizeof(header), metadata_size);
+    additional_data.metadata_size = static_cast<uint32_t>(metadata_size);
+
+    if (header.format == RS2_FORMAT_ANY || header.format >= static_cast<uint32_t>(RS2_FORMAT_COUNT))
+    {
+        throw io_exception(to_string() << "Invalid file format, frame of stream " << stream.id << " has unknown format " << header.format);
+    }
+    auto format = static_cast<rs2_format>(header.format);
+    if (format == RS2_FORMAT_MOTION_XYZ32F || format == RS2_FORMAT_MOTION_XYZ32F_BATCH)
+    {
+        frame_interface* frame = m_frame_source->alloc_frame(RS2_EXTENSION_MOTION_FRAME, header.raw_size, additional_data, true);
+        if (frame == nullptr)
+        {
+            throw invalid_value_exception("Failed to allocate new frame");
+        }
+        decompress(header, payload, const_cast<byte*>(frame->get_frame_data()));
+
+        //attaching a temp stream to the frame. Playback sensor should assign the real stream
+        frame->set_stream(std::make_shared<stream_profile_base>(platform::stream_profile{}));
+        frame->get_stream()->set_format(format);
+        frame->get_stream()->set_stream_index(stream.id.stream_index);
+        frame->get_stream()->set_stream_type(stream.id.stream_type);
+        return frame_holder{ frame };
+    }
+
+    if (header.width == 0 || header.height == 0)
+    {
+        throw io_exception(to_string() << "Invalid file format, video frame of stream " << stream.id << " without dimensions");
+    }
+    // The frame exposes stride * height bytes, whether decompressed or read in place from the file
+    if (static_cast<uint64_t>(header.stride) * 8 < static_cast<uint64_t>(header.width) * get_row_bpp(format) ||
+        static_cast<uint64_t>(header.stride) * header.height > header.raw_size)
+    {
+        throw io_exception(to_string() << "Invalid file format, video frame of stream " << stream.id << " with stride " << header.stride
+                                       << " for " << header.width << "x" << header.height << " in " << header.raw_size << " bytes");
+    }
+    auto in_place = static_cast<native_compression>(header.compression) == native_compression::none;
+    frame_interface* frame = m_frame_source->alloc_frame(stream.id.stream_type == RS2_STREAM_DEPTH ? RS2_EXTENSION_DEPTH_FRAME : RS2_EXTENSION_VIDEO_FRAME,
+                                                        in_place ? 0 : header.raw_size, additional_data, !in_place);
+    if (frame == nullptr)
+    {
+        throw invalid_value_exception("Failed to allocate new frame");
+    }
+    auto video = static_cast<librealsense::video_frame*>(frame);
+    frame_holder result{ frame };
+    video->assign(header.width, header.height, header.stride, get_image_bpp(format));
+    if (in_place)
+    {
+        if (header.data_size != header.raw_size)
+        {
+            throw io_exception("Invalid file format, frame of an unexpected size");
+        }
+        //The frame keeps the mapping alive until it is released
+        auto mapping = stream.file;
+        video->attach_continuation(frame_continuation([mapping]() {}, payload));
+        video->user_data_size = header.data_size;
+        video->read_only_data = true;
+    }
+    else
+    {
+        video->data.resize(header.raw_size);
+        decompress(header, payload, video->data.data());
+    }
+
+    //attaching a temp stream to the frame. Playback sensor should assign the real stream
+    frame->set_stream(std::make_shared<video_stream_profile>(platform::stream_profile{}));
+    frame->get_stream()->set_format(format);
+    frame->get_stream()->set_stream_index(stream.id.stream_index);
+    frame->get_stream()->set_stream_type(stream.id.stream_type);
+    return result;
+}
+
+native_reader::stream_data* native_reader::find_stream(const stream_identifier& stream_id)
+{
+    auto it = std::find_if(m_streams.begin(), m_streams.end(), [&stream_id](const stream_data& s) { return s.id == stream_id; });
+    return it != m_streams.end() ? &*it : nullptr;
+}
+
+size_t native_reader::find_entry(const stream_data& stream, const nanoseconds& time) const
+{
+    auto it = std::lower_bound(stream.index.begin(), stream.index.end(), static_cast<uint64_t>(time.count()),
+                               [](const native_index_entry& entry, uint64_t t) { return entry.time < t; });
+    return static_cast<size_t>(it - stream.index.begin());
+}
+
+void native_reader::seek_to_time(const nanoseconds& seek_time)
+{
+    if (seek_time > query_duration() && seek_time > m_end_time)
+    {
+        throw invalid_value_exception(to_string() << "Requested time is out of playback length. (Requested = " << seek_time.count() << ", Duration = " << query_duration().count() << ")");
+    }
+    for (auto&& stream : m_streams)
+    {
+        stream.next = find_entry(stream, seek_time);
+    }
+    m_description.seek_to_time(seek_time);
+    m_next_option.reset();
+    m_position = seek_time;
+}
+
+uint64_t native_reader::query_frame_count(const stream_identifier& stream_id)
+{
+    auto stream = find_stream(stream_id);
+    return stream ? stream->index.size() : 0;
+}
+
+nanoseconds native_reader::query_frame_time(const stream_identifier& stream_id, uint64_t frame)
+{
+    auto stream = find_stream(stream_id);
+    auto count = stream ? stream->index.size() : 0;
+    if (frame >= count)
+    {
+        throw invalid_value_exception(to_string() << "Requested frame " << frame << " is out of the " << count << " frames of stream " << stream_id);
+    }
+    return nanoseconds(stream->index[frame].time);
+}
+
+bool native_reader::query_thumbnail(const stream_identifier& stream_id, const nanoseconds& time, thumbnail& result)
+{
+    return m_description.query_thumbnail(stream_id, time, result);
+}
+
+nanoseconds native_reader::query_duration() const
+{
+    return m_end_time - m_begin_time;
+}
+
+void native_reader::reset()
+{
+    m_description.reset();
+    for (auto&& stream : m_streams)
+    {
+        stream.next = 0;
+        stream.enabled = false;
+    }
+    m_next_option.reset();
+    m_position = nanoseconds(0);
+    m_frame_source = std::make_shared<frame_source>();
+    m_frame_source->init(create_metadata_parser_map());
+}
+
+// Streams enabled while playing start from the current position, as they do in bag files
+void native_reader::enable_stream(const std::vector<stream_identifier>& stream_ids)
+{
+    for (auto&& id : stream_ids)
+    {
+        if (auto stream = find_stream(id))
+        {
+            if (!stream->enabled)
+                stream->next = find_entry(*stream, m_position);
+            stream->enabled = true;
+        }
+    }
+    m_description.enable_stream(stream_ids);
+}
+
+void native_reader::disable_stream(const std::vector<stream_identifier>& stream_ids)
+{
+    for (auto&& id : stream_ids)
+    {
+        if (auto stream = find_stream(id))
+            stream->enabled = false;
+    }
+    m_description.disable_stream(stream_ids);
+}
+
+const std::string& native_reader::get_file_name() const
+{
+    return m_file_path;
+}
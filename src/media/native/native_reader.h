@@ -0,0 +1,58 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "media/ros/ros_reader.h"
+#include "media/ros/mapped_file.h"
+#include "native_file_format.h"
+
+namespace librealsense
+{
+    // Plays a recording written by native_writer
+    // The frames files are mapped, the uncompressed frames reference their pages instead of being copied, and
+    // seeking is a binary search of the index of each stream. The description bag is read by a ros_reader, whose
+    // option changes are merged with the frames by time
+    class native_reader : public device_serializer::reader
+    {
+    public:
+        native_reader(const std::string& file, const std::shared_ptr<context>& ctx);
+
+        device_serializer::device_snapshot query_device_description(const device_serializer::nanoseconds& time) override;
+        std::shared_ptr<device_serializer::serialized_data> read_next_data() override;
+        void seek_to_time(const device_serializer::nanoseconds& time) override;
+        uint64_t query_frame_count(const device_serializer::stream_identifier& stream_id) override;
+        device_serializer::nanoseconds query_frame_time(const device_serializer::stream_identifier& stream_id, uint64_t frame) override;
+        bool query_thumbnail(const device_serializer::stream_identifier& stream_id, const device_serializer::nanoseconds& time, device_serializer::thumbnail& result) override;
+        device_serializer::nanoseconds query_duration() const override;
+        void reset() override;
+        void enable_stream(const std::vector<device_serializer::stream_identifier>& stream_ids) override;
+        void disable_stream(const std::vector<device_serializer::stream_identifier>& stream_ids) override;
+        const std::string& get_file_name() const override;
+
+    private:
+        struct stream_data
+        {
+            device_serializer::stream_identifier id;
+            std::vector<native_index_entry> index;
+            std::shared_ptr<mapped_file> file;
+            size_t next;        // Entry of the next frame to read
+            bool enabled;
+        };
+
+        void read_index();
+        stream_data* find_stream(const device_serializer::stream_identifier& stream_id);
+        size_t find_entry(const stream_data& stream, const device_serializer::nanoseconds& time) const;
+        frame_holder create_frame(const stream_data& stream, const native_index_entry& entry);
+
+        std::string m_file_path;
+        std::shared_ptr<context> m_context;
+        ros_reader m_description;
+        std::vector<stream_data> m_streams;
+        std::shared_ptr<frame_source> m_frame_source;
+        std::shared_ptr<device_serializer::serialized_data> m_next_option;   // Read from the description, not played yet
+        device_serializer::nanoseconds m_begin_time;
+        device_serializer::nanoseconds m_end_time;
+        device_serializer::nanoseconds m_position;
+    };
+}
@@ -0,0 +1,183 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#include "native_writer.h"
+#include "media/ros/depth_codec.h"
+#include "../../../third-party/realsense-file/lz4/lz4.h"
+
+using namespace librealsense;
+using namespace device_serializer;
+
+native_writer::native_writer(const std::string& file, const record_settings& settings) :
+    m_file_path(file),
+    m_settings(settings),
+    m_description(get_native_description_path(file))
+{
+    //The index is written on close, until then it only marks the file as a native recording
+    write_index();
+}
+
+native_writer::~native_writer()
+{
+    try
+    {
+        for (auto&& stream : m_streams)
+        {
+            stream.second->file.close();
+        }
+        write_index();
+    }
+    catch (const std::exception& e)
+    {
+        LOG_ERROR("Failed to write the index of " << m_file_path << ": " << e.what());
+    }
+}
+
+void native_writer::write_device_description(const device_snapshot& device_description)
+{
+    m_description.write_device_description(device_description);
+}
+
+void native_writer::write_snapshot(uint32_t device_index, const nanoseconds& timestamp, rs2_extension type, const std::shared_ptr<extension_snapshot>& snapshot)
+{
+    m_description.write_snapshot(device_index, timestamp, type, snapshot);
+}
+
+void native_writer::write_snapshot(const sensor_identifier& sensor_id, const nanoseconds& timestamp, rs2_extension type, const std::shared_ptr<extension_snapshot>& snapshot)
+{
+    m_description.write_snapshot(sensor_id, timestamp, type, snapshot);
+}
+
+const std::string& native_writer::get_file_name() const
+{
+    return m_file_path;
+}
+
+native_writer::stream_file& native_writer::get_stream_file(const stream_identifier& stream_id, rs2_format format)
+{
+    auto it = m_streams.find(stream_id);
+    if (it != m_streams.end())
+        return *it->second;
+
+    std::unique_ptr<stream_file> stream(new stream_file());
+    auto path = get_native_stream_path(m_file_path, stream_id);
+    stream->file.open(path, std::ios::binary | std::ios::trunc);
+    if (!stream->file)
+    {
+        throw io_exception(to_string() << "Failed to create " << path);
+    }
+    stream->size = 0;
+    switch (m_settings.compression)
+    {
+    case RS2_RECORD_COMPRESSION_NONE: stream->compression = native_compression::none; break;
+    case RS2_RECORD_COMPRESSION_LZ4_DEPTH:
+        stream->compression = format == RS2_FORMAT_Z16 ? native_compression::depth_codec : native_compression::lz4;
+        break;
+    default: stream->compression = native_compression::lz4; break;
+    }
+    return *(m_streams[stream_id] = std::move(stream));
+}
+
+void native_writer::write_frame(const stream_identifier& stream_id, const nanoseconds& timestamp, frame_holder&& frame)
+{
+    m_description.write_frame_description(stream_id, timestamp, frame);
+
+    auto format = frame->get_stream()->get_format();
+    auto&& stream = get_stream_file(stream_id, format);
+
+    native_frame_header header{};
+    header.magic = NATIVE_FRAME_MAGIC;
+    header.time = timestamp.count();
+    header.timestamp = frame->get_frame_timestamp();
+    header.system_time = frame->get_frame_system_time();
+    header.frame_number = frame->get_frame_number();
+    header.timestamp_domain = frame->get_frame_timestamp_domain();
+    header.format = format;
+
+    auto data = frame->get_frame_data();
+    auto size = frame->get_frame_data_size();
+    auto video = dynamic_cast<librealsense::video_frame*>(frame.frame);
+    if (video)
+    {
+        header.width = static_cast<uint32_t>(video->get_width());
+        header.height = static_cast<uint32_t>(video->get_height());
+        header.stride = static_cast<uint32_t>(video->get_stride());
+        size = static_cast<size_t>(header.stride) * header.height;
+    }
+    header.raw_size = static_cast<uint32_t>(size);
+
+    m_metadata.clear();
+    for (int i = 0; i < static_cast<int>(rs2_frame_metadata_value::RS2_FRAME_METADATA_COUNT); i++)
+    {
+        auto type = static_cast<rs2_frame_metadata_value>(i);
+        if (!frame->supports_frame_metadata(type))
+            continue;
+        rs2_metadata_type value = frame->get_frame_metadata(type);
+        auto type_bytes = reinterpret_cast<const uint8_t*>(&type);
+        auto value_bytes = reinterpret_cast<const uint8_t*>(&value);
+        m_metadata.insert(m_metadata.end(), type_bytes, type_bytes + sizeof(type));
+        m_metadata.insert(m_metadata.end(), value_bytes, value_bytes + sizeof(value));
+    }
+    header.metadata_size = static_cast<uint32_t>(m_metadata.size());
+
+    auto compression = stream.compression;
+    if (compression == native_compression::depth_codec && (!video || format != RS2_FORMAT_Z16))
+        compression = native_compression::lz4;
+    if (compression == native_compression::depth_codec)
+    {
+        encode_depth(reinterpret_cast<const uint16_t*>(data), header.width, header.height, header.stride, m_compressed);
+        data = m_compressed.data();
+        size = m_compressed.size();
+    }
+    else if (compression == native_compression::lz4)
+    {
+        m_compressed.resize(LZ4_compressBound(static_cast<int>(size)));
+        auto compressed = LZ4_compress_default(reinterpret_cast<const char*>(data), reinterpret_cast<char*>(m_compressed.data()),
+                                               static_cast<int>(size), static_cast<int>(m_compressed.size()));
+        if (compressed <= 0)
+        {
+            throw io_exception(to_string() << "Failed to compress a frame of stream " << stream_id);
+        }
+        data = m_compressed.data();
+        size = static_cast<size_t>(compressed);
+    }
+    header.compression = static_cast<uint32_t>(compression);
+    header.data_size = static_cast<uint32_t>(size);
+
+    static const char padding[NATIVE_RECORD_ALIGNMENT] = {};
+    auto payload_offset = align_native_record(sizeof(header) + m_metadata.size());
+    auto record_size = align_native_record(payload_offset + size);
+    auto&& file = stream.file;
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(m_metadata.data()), m_metadata.size());
+    file.write(padding, payload_offset - sizeof(header) - m_metadata.size());
+    file.write(reinterpret_cast<const char*>(data), size);
+    file.write(padding, record_size - payload_offset - size);
+    if (!file)
+    {
+        throw io_exception(to_string() << "Failed to write a frame of stream " << stream_id << " to " << get_native_stream_path(m_file_path, stream_id));
+    }
+
+    stream.index.push_back({ timestamp.count(), stream.size, static_cast<uint32_t>(record_size), 0 });
+    stream.size += record_size;
+}
+
+void native_writer::write_index()
+{
+    std::ofstream file(m_file_path, std::ios::binary | std::ios::trunc);
+    native_index_header header{ NATIVE_INDEX_MAGIC, NATIVE_FORMAT_VERSION, static_cast<uint32_t>(m_streams.size()) };
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (auto&& stream : m_streams)
+    {
+        auto&& id = stream.first;
+        auto&& index = stream.second->index;
+        native_index_stream info{ id.device_index, id.sensor_index, static_cast<uint32_t>(id.stream_type), id.stream_index,
+                                  static_cast<uint32_t>(stream.second->compression), 0, index.size() };
+        file.write(reinterpret_cast<const char*>(&info), sizeof(info));
+        file.write(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(native_index_entry));
+    }
+    if (!file)
+    {
+        throw io_exception(to_string() << "Failed to write " << m_file_path);
+    }
+}
@@ -0,0 +1,48 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include <fstream>
+#include <map>
+#include "media/ros/ros_writer.h"
+#include "native_file_format.h"
+
+namespace librealsense
+{
+    // Writes a recording in the native format, see native_file_format.h
+    // A frame costs a fixed header and one append to the file of its stream, with no topic, connection or chunk
+    // index to maintain. Streams are compressed frame by frame as the settings select: none, LZ4, or with
+    // RS2_RECORD_COMPRESSION_LZ4_DEPTH the depth codec for Z16 streams and LZ4 for the others
+    class native_writer : public device_serializer::writer
+    {
+    public:
+        native_writer(const std::string& file, const device_serializer::record_settings& settings = device_serializer::record_settings());
+        ~native_writer();
+
+        void write_device_description(const device_serializer::device_snapshot& device_description) override;
+        void write_frame(const device_serializer::stream_identifier& stream_id, const device_serializer::nanoseconds& timestamp, frame_holder&& frame) override;
+        void write_snapshot(uint32_t device_index, const device_serializer::nanoseconds& timestamp, rs2_extension type, const std::shared_ptr<extension_snapshot>& snapshot) override;
+        void write_snapshot(const device_serializer::sensor_identifier& sensor_id, const device_serializer::nanoseconds& timestamp, rs2_extension type, const std::shared_ptr<extension_snapshot>& snapshot) override;
+        const std::string& get_file_name() const override;
+
+    private:
+        struct stream_file
+        {
+            std::ofstream file;
+            native_compression compression;
+            uint64_t size;
+            std::vector<native_index_entry> index;
+        };
+
+        stream_file& get_stream_file(const device_serializer::stream_identifier& stream_id, rs2_format format);
+        void write_index();
+
+        std::string m_file_path;
+        device_serializer::record_settings m_settings;
+        ros_writer m_description;
+        std::map<device_serializer::stream_identifier, std::unique_ptr<stream_file>> m_streams;
+        std::vector<uint8_t> m_metadata;       // Of the frame being written
+        std::vector<uint8_t> m_compressed;
+    };
+}
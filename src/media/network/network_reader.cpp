@@ -0,0 +1,411 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#include <algorithm>
+#include "network_reader.h"
+#include "media/ros/depth_codec.h"
+#include "core/info.h"
+#include "option.h"
+#include "stream.h"
+
+using namespace librealsense;
+using namespace device_serializer;
+
+// Frames waiting for the playback beyond this are dropped, oldest first
+static const uint32_t MAX_NETWORK_RECEIVED_FRAMES = 4;
+
+// The server is not authenticated, so enumerations are checked against their range before they index any table
+template<class T>
+static T read_enum(network_message_reader& msg, T count, const char* name)
+{
+    auto value = msg.read<typename std::underlying_type<T>::type>();
+    if (value < 0 || value >= count)
+        throw io_exception(to_string() << "Invalid " << name << " " << static_cast<int64_t>(value) << " was received");
+    return static_cast<T>(value);
+}
+
+static std::shared_ptr<info_container> read_infos(network_message_reader& msg)
+{
+    auto infos = std::make_shared<info_container>();
+    auto count = msg.read<uint32_t>();
+    for (uint32_t i = 0; i < count; i++)
+    {
+        auto info = static_cast<rs2_camera_info>(msg.read<uint32_t>());
+        infos->register_info(info, msg.read_string());
+    }
+    return infos;
+}
+
+static std::pair<rs2_option, std::shared_ptr<const_value_option>> read_option_value(network_message_reader& msg)
+{
+    auto id = static_cast<rs2_option>(msg.read<uint32_t>());
+    auto value = msg.read<float>();
+    auto description = msg.read_string();
+    return std::make_pair(id, std::make_shared<const_value_option>(description, value));
+}
+
+network_reader::network_reader(const std::string& address, const std::shared_ptr<context>& ctx) :
+    m_address(address),
+    m_context(ctx),
+    m_socket(network_socket::connect(address)),
+    m_queued_frames(0),
+    m_connected(true)
+{
+    m_socket->set_receive_timeout(5000);
+    network_message_type type;
+    std::vector<uint8_t> payload;
+    if (!m_socket->receive_message(type, payload) || type != network_message_type::description)
+        throw io_exception(to_string() << "No device description was received from " << address);
+    read_description(payload);
+    m_socket->set_receive_timeout(0);
+
+    m_frame_source = std::make_shared<frame_source>();
+    m_frame_source->init(std::make_shared<metadata_parser_map>());
+    m_connection_time = std::chrono::steady_clock::now();
+    m_thread = std::thread([this]()
+    {
+        thread_registration registration("rs-net-receive", RS2_THREAD_CLASS_IO);
+        receive_messages();
+    });
+}
+
+network_reader::~network_reader()
+{
+    m_socket->shutdown();
+    m_thread.join();
+}
+
+void network_reader::read_description(const std::vector<uint8_t>& payload)
+{
+    network_message_reader msg(payload);
+    if (msg.read<uint32_t>() != NETWORK_PROTOCOL_MAGIC)
+        throw io_exception(to_string() << m_address << " is not a device server");
+    auto version = msg.read<uint32_t>();
+    if (version != NETWORK_PROTOCOL_VERSION)
+        throw io_exception(to_string() << "Unsupported version " << version << " of the device server at " << m_address);
+
+    snapshot_collection device_extensions;
+    device_extensions[RS2_EXTENSION_INFO] = read_infos(msg);
+
+    std::vector<sensor_snapshot> sensors;
+    auto sensor_count = msg.read<uint32_t>();
+    for (uint32_t s = 0; s < sensor_count; s++)
+    {
+        auto sensor_index = msg.read<uint32_t>();
+        snapshot_collection sensor_extensions;
+        sensor_extensions[RS2_EXTENSION_INFO] = read_infos(msg);
+
+        auto options = std::make_shared<options_container>();
+        auto option_count = msg.read<uint32_t>();
+        for (uint32_t i = 0; i < option_count; i++)
+        {
+            auto option = read_option_value(msg);
+            options->register_option(option.first, option.second);
+        }
+        sensor_extensions[RS2_EXTENSION_OPTIONS] = options;
+        if (options->supports_option(RS2_OPTION_DEPTH_UNITS))
+        {
+            sensor_extensions[RS2_EXTENSION_DEPTH_SENSOR] = std::make_shared<depth_sensor_snapshot>(options->get_option(RS2_OPTION_DEPTH_UNITS).query());
+        }
+
+        stream_profiles profiles;
+        auto profile_count = msg.read<uint32_t>();
+        for (uint32_t i = 0; i < profile_count; i++)
+        {
+            auto kind = msg.read<uint8_t>();
+            auto stream = read_enum(msg, RS2_STREAM_COUNT, "stream");
+            auto index = msg.read<uint32_t>();
+            auto format = read_enum(msg, RS2_FORMAT_COUNT, "format");
+            auto fps = msg.read<uint32_t>();
+            auto width = msg.read<uint32_t>();
+            auto height = msg.read<uint32_t>();
+            auto has_intrinsics = msg.read<uint8_t>();
+            auto intrinsics = msg.read<rs2_intrinsics>();
+
+            std::shared_ptr<stream_profile_interface> profile;
+            if (kind == 0)
+            {
+                auto video = std::make_shared<video_stream_profile>(platform::stream_profile{ width, height, fps, static_cast<uint32_t>(format) });
+                video->set_dims(width, height);
+                if (has_intrinsics)
+                    video->set_intrinsics([intrinsics]() { return intrinsics; });
+                profile = video;
+            }
+            else
+            {
+                profile = std::make_shared<stream_profile_base>(platform::stream_profile{ 1, 1, fps, static_cast<uint32_t>(format) });
+            }
+            profile->set_stream_index(index);
+            profile->set_stream_type(stream);
+            profile->set_format(format);
+            profile->set_framerate(fps);
+            profiles.push_back(profile);
+        }
+        sensors.emplace_back(sensor_index, sensor_extensions, profiles);
+    }
+
+    std::map<stream_identifier, std::pair<uint32_t, rs2_extrinsics>> extrinsics_map;
+    auto extrinsics_count = msg.read<uint32_t>();
+    for (uint32_t i = 0; i < extrinsics_count; i++)
+    {
+        auto sensor_index = msg.read<uint32_t>();
+        auto stream = read_enum(msg, RS2_STREAM_COUNT, "stream");
+        auto index = msg.read<uint32_t>();
+        auto group = msg.read<uint32_t>();
+        extrinsics_map[stream_identifier{ 0, sensor_index, stream, index }] = std::make_pair(group, msg.read<rs2_extrinsics>());
+    }
+
+    m_description = device_snapshot(device_extensions, sensors, extrinsics_map);
+}
+
+nanoseconds network_reader::time_since_connection() const
+{
+    return std::chrono::duration_cast<nanoseconds>(std::chrono::steady_clock::now() - m_connection_time);
+}
+
+std::shared_ptr<serialized_data> network_reader::read_frame(network_message_reader& msg)
+{
+    stream_identifier stream_id{ 0 };
+    stream_id.sensor_index = msg.read<uint32_t>();
+    stream_id.stream_type = read_enum(msg, RS2_STREAM_COUNT, "stream");
+    stream_id.stream_index = msg.read<uint32_t>();
+    auto format = read_enum(msg, RS2_FORMAT_COUNT, "format");
+
+    frame_additional_data additional_data{};
+    additional_data.timestamp = msg.read<double>();
+    additional_data.timestamp_domain = read_enum(msg, RS2_TIMESTAMP_DOMAIN_COUNT, "timestamp domain");
+    additional_data.frame_number = msg.read<uint64_t>();
+    additional_data.system_time = msg.read<double>();
+
+    auto kind = msg.read<uint8_t>();
+    frame_interface* frame = nullptr;
+    frame_holder holder;
+    if (kind == 0)
+    {
+        auto width = msg.read<uint32_t>();
+        auto height = msg.read<uint32_t>();
+        auto stride = msg.read<uint32_t>();
+        auto bpp = msg.read<uint32_t>();
+        auto encoding = msg.read<uint8_t>();
+        uint32_t size;
+        auto data = msg.read_bytes(size);
+
+        // Checked before allocating, a decoded frame may not be larger than a message carrying it raw
+        auto frame_size = static_cast<uint64_t>(stride) * height;
+        if (bpp == 0 || static_cast<uint64_t>(stride) * 8 < static_cast<uint64_t>(width) * bpp || frame_size > MAX_NETWORK_MESSAGE_SIZE)
+            throw io_exception(to_string() << "Invalid frame of " << width << "x" << height << " with stride " << stride << " and " << bpp << " bits per pixel");
+        if (encoding == 1 ? bpp != 16 : size != frame_size)
+            throw io_exception(to_string() << "Invalid frame of " << size << " bytes for " << width << "x" << height << " with stride " << stride);
+
+        frame = m_frame_source->alloc_frame((stream_id.stream_type == RS2_STREAM_DEPTH) ? RS2_EXTENSION_DEPTH_FRAME : RS2_EXTENSION_VIDEO_FRAME,
+                                            static_cast<size_t>(frame_size), additional_data, true);
+        if (frame == nullptr)
+            return nullptr;
+        // Released if decoding throws
+        holder = frame_holder{ frame };
+        static_cast<video_frame*>(frame)->assign(width, height, stride, bpp);
+        auto pixels = const_cast<byte*>(frame->get_frame_data());
+        if (encoding == 1)
+            decode_depth(data, size, width, height, stride, reinterpret_cast<uint16_t*>(pixels));
+        else
+            memcpy(pixels, data, size);
+        //attaching a temp stream to the frame. Playback sensor should assign the real stream
+        frame->set_stream(std::make_shared<video_stream_profile>(platform::stream_profile{}));
+    }
+    else
+    {
+        uint32_t size;
+        auto data = msg.read_bytes(size);
+        frame = m_frame_source->alloc_frame(RS2_EXTENSION_MOTION_FRAME, size, additional_data, true);
+        if (frame == nullptr)
+            return nullptr;
+        holder = frame_holder{ frame };
+        memcpy(const_cast<byte*>(frame->get_frame_data()), data, size);
+        frame->set_stream(std::make_shared<stream_profile_base>(platform::stream_profile{}));
+    }
+    frame->get_stream()->set_format(format);
+    frame->get_stream()->set_stream_index(stream_id.stream_index);
+    frame->get_stream()->set_stream_type(stream_id.stream_type);
+
+    return std::make_shared<serialized_frame>(time_since_connection(), stream_id, std::move(holder));
+}
+
+std::shared_ptr<serialized_data> network_reader::read_option(network_message_reader& msg)
+{
+    sensor_identifier sensor_id{ 0, msg.read<uint32_t>() };
+    auto option = read_option_value(msg);
+    return std::make_shared<serialized_option>(time_since_connection(), sensor_id, option.first, option.second);
+}
+
+void network_reader::receive_messages()
+{
+    try
+    {
+        network_message_type type;
+        std::vector<uint8_t> payload;
+        while (m_socket->receive_message(type, payload))
+        {
+            network_message_reader msg(payload);
+            std::shared_ptr<serialized_data> data;
+            if (type == network_message_type::frame)
+            {
+                // Frames of disabled streams, sent before the server read the subscription, are not decoded
+                msg.read<uint32_t>();
+                auto stream = msg.read<rs2_stream>();
+                auto index = msg.read<uint32_t>();
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    if (std::none_of(m_enabled_streams.begin(), m_enabled_streams.end(), [&](const stream_identifier& s)
+                        { return s.stream_type == stream && s.stream_index == index; }))
+                        continue;
+                }
+                network_message_reader frame_msg(payload);
+                data = read_frame(frame_msg);
+                if (!data)
+                {
+                    LOG_DEBUG("Dropped a frame from " << m_address << ", no frame could be allocated");
+                    continue;
+                }
+            }
+            else if (type == network_message_type::option)
+            {
+                data = read_option(msg);
+            }
+            else
+            {
+                continue;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (data->is<serialized_frame>())
+                {
+                    if (m_queued_frames == MAX_NETWORK_RECEIVED_FRAMES)
+                    {
+                        auto oldest = std::find_if(m_queue.begin(), m_queue.end(), [](const std::shared_ptr<serialized_data>& d)
+                        {
+                            return d->is<serialized_frame>();
+                        });
+                        m_queue.erase(oldest);
+                        m_queued_frames--;
+                    }
+                    m_queued_frames++;
+                }
+                m_queue.push_back(data);
+            }
+            m_cv.notify_one();
+        }
+    }
+    catch (const std::exception& e)
+    {
+        LOG_ERROR("Failed to receive from " << m_address << ". Exception: " << e.what());
+    }
+
+    LOG_INFO("Disconnected from " << m_address);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_connected = false;
+    }
+    m_cv.notify_all();
+}
+
+device_snapshot network_reader::query_device_description(const nanoseconds& time)
+{
+    return m_description;
+}
+
+std::shared_ptr<serialized_data> network_reader::read_next_data()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait_for(lock, std::chrono::milliseconds(NETWORK_IDLE_TIMEOUT_MS), [this]() { return !m_connected || !m_queue.empty(); });
+    if (m_queue.empty())
+    {
+        LOG_DEBUG("End of stream from " << m_address);
+        return std::make_shared<serialized_end_of_file>();
+    }
+    auto data = m_queue.front();
+    m_queue.pop_front();
+    if (data->is<serialized_frame>())
+        m_queued_frames--;
+    return data;
+}
+
+// A live stream can not move back or ahead, it continues with the frames that arrive next
+void network_reader::seek_to_time(const nanoseconds& time)
+{
+}
+
+uint64_t network_reader::query_frame_count(const stream_identifier& stream_id)
+{
+    throw not_implemented_exception("Counting the frames of a network stream");
+}
+
+nanoseconds network_reader::query_frame_time(const stream_identifier& stream_id, uint64_t frame)
+{
+    throw not_implemented_exception("Querying the frame times of a network stream");
+}
+
+bool network_reader::query_thumbnail(const stream_identifier& stream_id, const nanoseconds& time, thumbnail& result)
+{
+    return false;
+}
+
+nanoseconds network_reader::query_duration() const
+{
+    return nanoseconds(0);
+}
+
+void network_reader::reset()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_queue.clear();
+    m_queued_frames = 0;
+}
+
+void network_reader::enable_stream(const std::vector<stream_identifier>& stream_ids)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto&& id : stream_ids)
+        {
+            if (std::find(m_enabled_streams.begin(), m_enabled_streams.end(), id) == m_enabled_streams.end())
+                m_enabled_streams.push_back(id);
+        }
+    }
+    subscribe();
+}
+
+void network_reader::disable_stream(const std::vector<stream_identifier>& stream_ids)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto&& id : stream_ids)
+        {
+            m_enabled_streams.erase(std::remove(m_enabled_streams.begin(), m_enabled_streams.end(), id), m_enabled_streams.end());
+        }
+    }
+    subscribe();
+}
+
+// The server sends only the enabled streams, so disabled ones take no bandwidth
+void network_reader::subscribe()
+{
+    network_message msg;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        msg.write(static_cast<uint32_t>(m_enabled_streams.size()));
+        for (auto&& id : m_enabled_streams)
+        {
+            msg.write(id.sensor_index);
+            msg.write(id.stream_type);
+            msg.write(id.stream_index);
+        }
+    }
+    if (!m_socket->send_message(network_message_type::subscribe, msg.data))
+        LOG_WARNING("Failed to send the enabled streams to " << m_address);
+}
+
+const std::string& network_reader::get_file_name() const
+{
+    return m_address;
+}
@@ -0,0 +1,65 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include "core/serialization.h"
+#include "source.h"
+#include "network_socket.h"
+
+namespace librealsense
+{
+    // Playback ends when the server sends nothing for this long, so a reader is never blocked forever
+    const uint32_t NETWORK_IDLE_TIMEOUT_MS = 2000;
+
+    // Plays the device served by a network_writer as it streams
+    // Frames are decoded as they arrive, on a thread of the reader, and are timed by their arrival so that the
+    // playback delays them no further. When the playback falls behind, the oldest frames are dropped
+    class network_reader : public device_serializer::reader
+    {
+    public:
+        network_reader(const std::string& address, const std::shared_ptr<context>& ctx);
+        ~network_reader();
+
+        device_serializer::device_snapshot query_device_description(const device_serializer::nanoseconds& time) override;
+        std::shared_ptr<device_serializer::serialized_data> read_next_data() override;
+        void seek_to_time(const device_serializer::nanoseconds& time) override;
+        uint64_t query_frame_count(const device_serializer::stream_identifier& stream_id) override;
+        device_serializer::nanoseconds query_frame_time(const device_serializer::stream_identifier& stream_id, uint64_t frame) override;
+        bool query_thumbnail(const device_serializer::stream_identifier& stream_id, const device_serializer::nanoseconds& time, device_serializer::thumbnail& result) override;
+        device_serializer::nanoseconds query_duration() const override;
+        void reset() override;
+        void enable_stream(const std::vector<device_serializer::stream_identifier>& stream_ids) override;
+        void disable_stream(const std::vector<device_serializer::stream_identifier>& stream_ids) override;
+        const std::string& get_file_name() const override;
+
+    private:
+        void read_description(const std::vector<uint8_t>& payload);
+        void receive_messages();
+        std::shared_ptr<device_serializer::serialized_data> read_frame(network_message_reader& msg);
+        std::shared_ptr<device_serializer::serialized_data> read_option(network_message_reader& msg);
+        void subscribe();
+        device_serializer::nanoseconds time_since_connection() const;
+
+        std::string m_address;
+        std::shared_ptr<context> m_context;
+        std::shared_ptr<network_socket> m_socket;
+        device_serializer::device_snapshot m_description;
+        std::shared_ptr<frame_source> m_frame_source;
+        std::chrono::steady_clock::time_point m_connection_time;
+
+        std::mutex m_mutex;                 // Guards the members below
+        std::condition_variable m_cv;
+        std::deque<std::shared_ptr<device_serializer::serialized_data>> m_queue;
+        uint32_t m_queued_frames;
+        std::vector<device_serializer::stream_identifier> m_enabled_streams;
+        bool m_connected;
+        std::thread m_thread;
+    };
+}
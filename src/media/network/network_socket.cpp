@@ -0,0 +1,201 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#include "network_socket.h"
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <mutex>
+typedef int socklen_t;
+#else
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+namespace librealsense
+{
+#ifdef _WIN32
+    typedef SOCKET native_socket;
+    static const native_socket invalid_socket = INVALID_SOCKET;
+
+    static void init_sockets()
+    {
+        static std::once_flag once;
+        std::call_once(once, []()
+        {
+            WSADATA data;
+            if (WSAStartup(MAKEWORD(2, 2), &data) != 0)
+                throw io_exception("Failed to initialize Windows sockets");
+        });
+    }
+
+    static void close_socket(native_socket s) { closesocket(s); }
+#else
+    typedef int native_socket;
+    static const native_socket invalid_socket = -1;
+
+    static void init_sockets() {}
+
+    static void close_socket(native_socket s) { ::close(s); }
+#endif
+
+    static native_socket native(intptr_t handle) { return static_cast<native_socket>(handle); }
+
+    // Frames are sent as soon as they are written, instead of waiting to fill a segment
+    static void set_no_delay(native_socket s)
+    {
+        int on = 1;
+        setsockopt(s, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&on), sizeof(on));
+    }
+
+    network_socket::~network_socket()
+    {
+        close_socket(native(_handle));
+    }
+
+    std::shared_ptr<network_socket> network_socket::connect(const std::string& address)
+    {
+        init_sockets();
+        auto host_port = address.substr(strlen(NETWORK_ADDRESS_PREFIX));
+        auto separator = host_port.rfind(':');
+        if (!is_network_address(address) || separator == std::string::npos || separator == 0)
+            throw invalid_value_exception(to_string() << "Invalid network address \"" << address << "\", expected tcp://host:port");
+        auto host = host_port.substr(0, separator);
+        auto port = host_port.substr(separator + 1);
+
+        addrinfo hints{};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo* results = nullptr;
+        if (getaddrinfo(host.c_str(), port.c_str(), &hints, &results) != 0 || !results)
+            throw io_exception(to_string() << "Failed to resolve " << address);
+
+        auto s = invalid_socket;
+        for (auto a = results; a && s == invalid_socket; a = a->ai_next)
+        {
+            s = socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+            if (s != invalid_socket && ::connect(s, a->ai_addr, static_cast<socklen_t>(a->ai_addrlen)) != 0)
+            {
+                close_socket(s);
+                s = invalid_socket;
+            }
+        }
+        freeaddrinfo(results);
+        if (s == invalid_socket)
+            throw io_exception(to_string() << "Failed to connect to " << address);
+
+        set_no_delay(s);
+        return std::shared_ptr<network_socket>(new network_socket(static_cast<intptr_t>(s)));
+    }
+
+    std::shared_ptr<network_socket> network_socket::listen(uint16_t port)
+    {
+        init_sockets();
+        auto s = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if (s == invalid_socket)
+            throw io_exception("Failed to create a socket");
+        std::shared_ptr<network_socket> result(new network_socket(static_cast<intptr_t>(s)));
+
+        int on = 1;
+        setsockopt(s, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&on), sizeof(on));
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_ANY);
+        address.sin_port = htons(port);
+        if (bind(s, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || ::listen(s, 4) != 0)
+            throw io_exception(to_string() << "Failed to listen on port " << port);
+        return result;
+    }
+
+    std::shared_ptr<network_socket> network_socket::accept(int timeout_ms)
+    {
+        auto s = native(_handle);
+        fd_set readable;
+        FD_ZERO(&readable);
+        FD_SET(s, &readable);
+        timeval timeout{ timeout_ms / 1000, (timeout_ms % 1000) * 1000 };
+        if (select(static_cast<int>(s) + 1, &readable, nullptr, nullptr, &timeout) <= 0)
+            return nullptr;
+
+        auto client = ::accept(s, nullptr, nullptr);
+        if (client == invalid_socket)
+            return nullptr;
+        set_no_delay(client);
+        return std::shared_ptr<network_socket>(new network_socket(static_cast<intptr_t>(client)));
+    }
+
+    void network_socket::set_receive_timeout(int timeout_ms)
+    {
+#ifdef _WIN32
+        DWORD timeout = timeout_ms;
+#else
+        timeval timeout{ timeout_ms / 1000, (timeout_ms % 1000) * 1000 };
+#endif
+        setsockopt(native(_handle), SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout));
+    }
+
+    void network_socket::shutdown()
+    {
+#ifdef _WIN32
+        ::shutdown(native(_handle), SD_BOTH);
+#else
+        ::shutdown(native(_handle), SHUT_RDWR);
+#endif
+    }
+
+    bool network_socket::send_all(const void* data, size_t size)
+    {
+        auto p = static_cast<const char*>(data);
+        while (size > 0)
+        {
+#ifdef MSG_NOSIGNAL
+            auto sent = send(native(_handle), p, static_cast<int>(std::min<size_t>(size, 1 << 30)), MSG_NOSIGNAL);
+#else
+            auto sent = send(native(_handle), p, static_cast<int>(std::min<size_t>(size, 1 << 30)), 0);
+#endif
+            if (sent <= 0)
+                return false;
+            p += sent;
+            size -= sent;
+        }
+        return true;
+    }
+
+    bool network_socket::receive_all(void* data, size_t size)
+    {
+        auto p = static_cast<char*>(data);
+        while (size > 0)
+        {
+            auto received = recv(native(_handle), p, static_cast<int>(std::min<size_t>(size, 1 << 30)), 0);
+            if (received <= 0)
+                return false;
+            p += received;
+            size -= received;
+        }
+        return true;
+    }
+
+    bool network_socket::send_message(network_message_type type, const std::vector<uint8_t>& payload)
+    {
+        uint32_t header[2] = { static_cast<uint32_t>(type), static_cast<uint32_t>(payload.size()) };
+        return send_all(header, sizeof(header)) && send_all(payload.data(), payload.size());
+    }
+
+    bool network_socket::receive_message(network_message_type& type, std::vector<uint8_t>& payload)
+    {
+        uint32_t header[2];
+        if (!receive_all(header, sizeof(header)))
+            return false;
+        if (header[1] > MAX_NETWORK_MESSAGE_SIZE)
+            throw io_exception(to_string() << "Invalid network message of " << header[1] << " bytes");
+        type = static_cast<network_message_type>(header[0]);
+        payload.resize(header[1]);
+        return receive_all(payload.data(), payload.size());
+    }
+}
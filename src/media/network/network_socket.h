@@ -0,0 +1,133 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+#include "types.h"
+
+namespace librealsense
+{
+    // Messages of the network streaming protocol: a type and a payload size, then the payload
+    // The server sends the description of its device to every client that connects, followed by its frames
+    // and option changes. Clients send the streams they play, the server sends them nothing else
+    enum class network_message_type : uint32_t
+    {
+        description = 1,
+        frame = 2,
+        option = 3,
+        subscribe = 4
+    };
+
+    const uint32_t NETWORK_PROTOCOL_MAGIC = 0x314e5352; // "RSN1"
+    const uint32_t NETWORK_PROTOCOL_VERSION = 1;
+    const uint32_t MAX_NETWORK_MESSAGE_SIZE = 256 * 1024 * 1024;
+    const char* const NETWORK_ADDRESS_PREFIX = "tcp://";
+
+    // Payload of a message, written in the byte order of the host
+    class network_message
+    {
+    public:
+        template<class T>
+        void write(const T& value)
+        {
+            auto p = reinterpret_cast<const uint8_t*>(&value);
+            data.insert(data.end(), p, p + sizeof(T));
+        }
+
+        void write_string(const std::string& str)
+        {
+            write(static_cast<uint32_t>(str.size()));
+            data.insert(data.end(), str.begin(), str.end());
+        }
+
+        void write_bytes(const void* bytes, size_t size)
+        {
+            write(static_cast<uint32_t>(size));
+            auto p = static_cast<const uint8_t*>(bytes);
+            data.insert(data.end(), p, p + size);
+        }
+
+        std::vector<uint8_t> data;
+    };
+
+    // Reads a payload, throws io_exception when it ends before the requested field
+    class network_message_reader
+    {
+    public:
+        explicit network_message_reader(const std::vector<uint8_t>& data) : _data(data), _position(0) {}
+
+        template<class T>
+        T read()
+        {
+            T value;
+            memcpy(&value, take(sizeof(T)), sizeof(T));
+            return value;
+        }
+
+        std::string read_string()
+        {
+            auto size = read<uint32_t>();
+            auto p = take(size);
+            return std::string(reinterpret_cast<const char*>(p), size);
+        }
+
+        // Returns the bytes in the payload, valid as long as the payload
+        const uint8_t* read_bytes(uint32_t& size)
+        {
+            size = read<uint32_t>();
+            return take(size);
+        }
+
+    private:
+        const uint8_t* take(size_t size)
+        {
+            if (size > _data.size() - _position)
+                throw io_exception("Truncated network message");
+            auto p = _data.data() + _position;
+            _position += size;
+            return p;
+        }
+
+        const std::vector<uint8_t>& _data;
+        size_t _position;
+    };
+
+    class network_socket
+    {
+    public:
+        ~network_socket();
+
+        // address is "tcp://host:port"
+        static std::shared_ptr<network_socket> connect(const std::string& address);
+        static std::shared_ptr<network_socket> listen(uint16_t port);
+
+        // Waits up to the timeout for a connection, returns nullptr when none was made
+        std::shared_ptr<network_socket> accept(int timeout_ms);
+
+        // 0 waits without a limit. A receive that times out fails
+        void set_receive_timeout(int timeout_ms);
+
+        bool send_message(network_message_type type, const std::vector<uint8_t>& payload);
+        bool receive_message(network_message_type& type, std::vector<uint8_t>& payload);
+
+        // Unblocks the calls in progress on other threads, which fail from now on
+        void shutdown();
+
+    private:
+        explicit network_socket(intptr_t handle) : _handle(handle) {}
+
+        bool send_all(const void* data, size_t size);
+        bool receive_all(void* data, size_t size);
+
+        intptr_t _handle;
+    };
+
+    inline bool is_network_address(const std::string& address)
+    {
+        return address.compare(0, strlen(NETWORK_ADDRESS_PREFIX), NETWORK_ADDRESS_PREFIX) == 0;
+    }
+}
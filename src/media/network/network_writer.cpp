@@ -0,0 +1,381 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#include <algorithm>
+#include "network_writer.h"
+#include "media/ros/depth_codec.h"
+#include "archive.h"
+#include "stream.h"
+
+using namespace librealsense;
+using namespace device_serializer;
+
+static void write_infos(network_message& msg, const info_interface& infos)
+{
+    std::vector<rs2_camera_info> supported;
+    for (int i = 0; i < static_cast<int>(RS2_CAMERA_INFO_COUNT); i++)
+    {
+        if (infos.supports_info(static_cast<rs2_camera_info>(i)))
+            supported.push_back(static_cast<rs2_camera_info>(i));
+    }
+    msg.write(static_cast<uint32_t>(supported.size()));
+    for (auto info : supported)
+    {
+        msg.write(static_cast<uint32_t>(info));
+        msg.write_string(infos.get_info(info));
+    }
+}
+
+static void write_option(network_message& msg, rs2_option id, const option& opt)
+{
+    auto description = opt.get_description();
+    msg.write(static_cast<uint32_t>(id));
+    msg.write(opt.query());
+    msg.write_string(description ? description : "");
+}
+
+// The description lists every profile of the device, so clients may open any of them
+static std::vector<uint8_t> describe_device(device_interface& device)
+{
+    network_message msg;
+    msg.write(NETWORK_PROTOCOL_MAGIC);
+    msg.write(NETWORK_PROTOCOL_VERSION);
+    write_infos(msg, device);
+
+    std::vector<std::tuple<uint32_t, rs2_stream, uint32_t, uint32_t, rs2_extrinsics>> extrinsics;
+    msg.write(static_cast<uint32_t>(device.get_sensors_count()));
+    for (uint32_t s = 0; s < device.get_sensors_count(); s++)
+    {
+        auto&& sensor = device.get_sensor(s);
+        msg.write(s);
+        write_infos(msg, sensor);
+
+        std::vector<rs2_option> options;
+        for (int i = 0; i < static_cast<int>(RS2_OPTION_COUNT); i++)
+        {
+            auto id = static_cast<rs2_option>(i);
+            if (sensor.supports_option(id))
+                options.push_back(id);
+        }
+        network_message option_values;
+        uint32_t option_count = 0;
+        for (auto id : options)
+        {
+            try
+            {
+                network_message value;
+                write_option(value, id, sensor.get_option(id));
+                option_values.data.insert(option_values.data.end(), value.data.begin(), value.data.end());
+                option_count++;
+            }
+            catch (const std::exception& e)
+            {
+                LOG_WARNING("Failed to read option " << id << " of sensor " << s << ". Exception: " << e.what());
+            }
+        }
+        msg.write(option_count);
+        msg.data.insert(msg.data.end(), option_values.data.begin(), option_values.data.end());
+
+        auto profiles = sensor.get_stream_profiles();
+        msg.write(static_cast<uint32_t>(profiles.size()));
+        std::set<std::pair<rs2_stream, uint32_t>> streams;
+        for (auto&& p : profiles)
+        {
+            auto video = std::dynamic_pointer_cast<video_stream_profile_interface>(p);
+            rs2_intrinsics intrinsics{};
+            uint8_t has_intrinsics = 0;
+            if (video)
+            {
+                try
+                {
+                    intrinsics = video->get_intrinsics();
+                    has_intrinsics = 1;
+                }
+                catch (...) {}
+            }
+            msg.write(static_cast<uint8_t>(video ? 0 : 1));
+            msg.write(p->get_stream_type());
+            msg.write(static_cast<uint32_t>(p->get_stream_index()));
+            msg.write(p->get_format());
+            msg.write(p->get_framerate());
+            msg.write(video ? video->get_width() : 0u);
+            msg.write(video ? video->get_height() : 0u);
+            msg.write(has_intrinsics);
+            msg.write(intrinsics);
+
+            if (!streams.insert(std::make_pair(p->get_stream_type(), static_cast<uint32_t>(p->get_stream_index()))).second)
+                continue;
+            try
+            {
+                auto e = device.get_extrinsics(*p);
+                extrinsics.push_back(std::make_tuple(s, p->get_stream_type(), static_cast<uint32_t>(p->get_stream_index()), e.first, e.second));
+            }
+            catch (...) {}
+        }
+    }
+
+    msg.write(static_cast<uint32_t>(extrinsics.size()));
+    for (auto&& e : extrinsics)
+    {
+        msg.write(std::get<0>(e));
+        msg.write(std::get<1>(e));
+        msg.write(std::get<2>(e));
+        msg.write(std::get<3>(e));
+        msg.write(std::get<4>(e));
+    }
+    return std::move(msg.data);
+}
+
+network_writer::network_writer(std::shared_ptr<device_interface> device, uint16_t port, bool compress_depth) :
+    m_description(describe_device(*device)),
+    m_compress_depth(compress_depth),
+    m_name(to_string() << NETWORK_ADDRESS_PREFIX << "0.0.0.0:" << port),
+    m_listener(network_socket::listen(port)),
+    m_alive(true)
+{
+    m_acceptor = std::thread([this]()
+    {
+        thread_registration registration("rs-net-accept", RS2_THREAD_CLASS_IO);
+        accept_clients();
+    });
+}
+
+network_writer::~network_writer()
+{
+    m_alive = false;
+    m_acceptor.join();
+
+    std::lock_guard<std::mutex> lock(m_clients_mutex);
+    for (auto&& c : m_clients)
+    {
+        close_client(*c);
+        c->sender.join();
+        c->receiver.join();
+    }
+}
+
+void network_writer::close_client(client& c)
+{
+    {
+        std::lock_guard<std::mutex> lock(c.mutex);
+        c.alive = false;
+        c.queue.clear();
+    }
+    c.cv.notify_all();
+    c.socket->shutdown();
+}
+
+void network_writer::accept_clients()
+{
+    while (m_alive)
+    {
+        auto socket = m_listener->accept(100);
+
+        std::lock_guard<std::mutex> lock(m_clients_mutex);
+        //Threads of disconnected clients ended, or are about to
+        for (auto it = m_clients.begin(); it != m_clients.end();)
+        {
+            bool alive;
+            {
+                std::lock_guard<std::mutex> client_lock((*it)->mutex);
+                alive = (*it)->alive;
+            }
+            if (alive)
+            {
+                ++it;
+                continue;
+            }
+            (*it)->sender.join();
+            (*it)->receiver.join();
+            it = m_clients.erase(it);
+        }
+
+        if (!socket)
+            continue;
+
+        LOG_INFO("Network client connected to " << m_name);
+        auto c = std::make_shared<client>();
+        c->socket = socket;
+        c->queue.emplace_back(network_message_type::description, std::make_shared<std::vector<uint8_t>>(m_description));
+        c->sender = std::thread([this, c]()
+        {
+            thread_registration registration("rs-net-send", RS2_THREAD_CLASS_IO);
+            send_messages(c);
+        });
+        c->receiver = std::thread([this, c]()
+        {
+            thread_registration registration("rs-net-receive", RS2_THREAD_CLASS_IO);
+            receive_messages(c);
+        });
+        m_clients.push_back(c);
+    }
+}
+
+void network_writer::send_messages(std::shared_ptr<client> c)
+{
+    while (true)
+    {
+        std::pair<network_message_type, std::shared_ptr<const std::vector<uint8_t>>> next;
+        {
+            std::unique_lock<std::mutex> lock(c->mutex);
+            c->cv.wait(lock, [&]() { return !c->alive || !c->queue.empty(); });
+            if (!c->alive)
+                return;
+            next = std::move(c->queue.front());
+            c->queue.pop_front();
+            if (next.first == network_message_type::frame)
+                c->queued_frames--;
+        }
+
+        if (!c->socket->send_message(next.first, *next.second))
+        {
+            LOG_INFO("Network client of " << m_name << " disconnected");
+            close_client(*c);
+            return;
+        }
+    }
+}
+
+void network_writer::receive_messages(std::shared_ptr<client> c)
+{
+    try
+    {
+        network_message_type type;
+        std::vector<uint8_t> payload;
+        while (c->socket->receive_message(type, payload))
+        {
+            if (type != network_message_type::subscribe)
+                continue;
+
+            network_message_reader msg(payload);
+            std::set<std::tuple<uint32_t, rs2_stream, uint32_t>> streams;
+            auto count = msg.read<uint32_t>();
+            for (uint32_t i = 0; i < count; i++)
+            {
+                auto sensor = msg.read<uint32_t>();
+                auto stream = msg.read<rs2_stream>();
+                streams.insert(std::make_tuple(sensor, stream, msg.read<uint32_t>()));
+            }
+
+            std::lock_guard<std::mutex> lock(c->mutex);
+            c->subscribed = true;
+            c->streams = std::move(streams);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        LOG_WARNING("Invalid message from network client of " << m_name << ". Exception: " << e.what());
+    }
+    close_client(*c);
+}
+
+void network_writer::send_to_clients(network_message_type type, std::shared_ptr<const std::vector<uint8_t>> payload,
+                                     const stream_identifier* stream_id)
+{
+    std::lock_guard<std::mutex> lock(m_clients_mutex);
+    for (auto&& c : m_clients)
+    {
+        {
+            std::lock_guard<std::mutex> client_lock(c->mutex);
+            if (!c->alive)
+                continue;
+            if (stream_id && c->subscribed &&
+                !c->streams.count(std::make_tuple(stream_id->sensor_index, stream_id->stream_type, stream_id->stream_index)))
+                continue;
+
+            if (stream_id && c->queued_frames == MAX_NETWORK_QUEUED_FRAMES)
+            {
+                auto oldest = std::find_if(c->queue.begin(), c->queue.end(), [](const std::pair<network_message_type, std::shared_ptr<const std::vector<uint8_t>>>& m)
+                {
+                    return m.first == network_message_type::frame;
+                });
+                c->queue.erase(oldest);
+                c->queued_frames--;
+            }
+            c->queue.emplace_back(type, payload);
+            if (stream_id)
+                c->queued_frames++;
+        }
+        c->cv.notify_one();
+    }
+}
+
+void network_writer::write_frame(const stream_identifier& stream_id, const nanoseconds& timestamp, frame_holder&& frame)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_clients_mutex);
+        if (m_clients.empty())
+            return;
+    }
+
+    auto f = frame.frame;
+    auto format = f->get_stream()->get_format();
+    network_message msg;
+    msg.write(stream_id.sensor_index);
+    msg.write(stream_id.stream_type);
+    msg.write(stream_id.stream_index);
+    msg.write(format);
+    msg.write(f->get_frame_timestamp());
+    msg.write(f->get_frame_timestamp_domain());
+    msg.write(static_cast<uint64_t>(f->get_frame_number()));
+    msg.write(f->get_frame_system_time());
+
+    if (auto video = dynamic_cast<video_frame*>(f))
+    {
+        auto compress = m_compress_depth && format == RS2_FORMAT_Z16;
+        msg.write(static_cast<uint8_t>(0));
+        msg.write(static_cast<uint32_t>(video->get_width()));
+        msg.write(static_cast<uint32_t>(video->get_height()));
+        msg.write(static_cast<uint32_t>(video->get_stride()));
+        msg.write(static_cast<uint32_t>(video->get_bpp()));
+        msg.write(static_cast<uint8_t>(compress ? 1 : 0));
+        if (compress)
+        {
+            std::vector<uint8_t> encoded;
+            encode_depth(reinterpret_cast<const uint16_t*>(video->get_frame_data()), video->get_width(), video->get_height(), video->get_stride(), encoded);
+            msg.write_bytes(encoded.data(), encoded.size());
+        }
+        else
+        {
+            msg.write_bytes(video->get_frame_data(), video->get_frame_data_size());
+        }
+    }
+    else if (format == RS2_FORMAT_MOTION_XYZ32F || format == RS2_FORMAT_MOTION_XYZ32F_BATCH)
+    {
+        msg.write(static_cast<uint8_t>(1));
+        msg.write_bytes(f->get_frame_data(), f->get_frame_data_size());
+    }
+    else
+    {
+        return;
+    }
+
+    //The frame is released before it is sent
+    frame = {};
+    send_to_clients(network_message_type::frame, std::make_shared<std::vector<uint8_t>>(std::move(msg.data)), &stream_id);
+}
+
+void network_writer::write_snapshot(const sensor_identifier& sensor_id, const nanoseconds& timestamp, rs2_extension type, const std::shared_ptr<extension_snapshot>& snapshot)
+{
+    auto options = std::dynamic_pointer_cast<options_interface>(snapshot);
+    if (type != RS2_EXTENSION_OPTIONS || !options)
+        return;
+
+    for (int i = 0; i < static_cast<int>(RS2_OPTION_COUNT); i++)
+    {
+        auto id = static_cast<rs2_option>(i);
+        try
+        {
+            if (!options->supports_option(id))
+                continue;
+            network_message msg;
+            msg.write(sensor_id.sensor_index);
+            write_option(msg, id, options->get_option(id));
+            send_to_clients(network_message_type::option, std::make_shared<std::vector<uint8_t>>(std::move(msg.data)), nullptr);
+        }
+        catch (const std::exception& e)
+        {
+            LOG_WARNING("Failed to send option " << id << " of sensor " << sensor_id.sensor_index << ". Exception: " << e.what());
+        }
+    }
+}
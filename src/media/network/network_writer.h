@@ -0,0 +1,68 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <tuple>
+#include "core/serialization.h"
+#include "network_socket.h"
+
+namespace librealsense
+{
+    // Frames queued for a client beyond this are dropped, oldest first, so that a slow link delays none by more
+    const uint32_t MAX_NETWORK_QUEUED_FRAMES = 4;
+
+    // Serves the frames of a device to the clients connecting to a TCP port, where they play as remote devices
+    // Each frame is encoded once, on the thread of the recording device, and sent to every client by a thread
+    // of that client, so encoding and sending overlap. Z16 frames may be encoded by the lossless depth codec
+    class network_writer : public device_serializer::writer
+    {
+    public:
+        network_writer(std::shared_ptr<device_interface> device, uint16_t port, bool compress_depth);
+        ~network_writer();
+
+        // Clients receive the description taken from the device when the writer was created, which has all of its profiles
+        void write_device_description(const device_serializer::device_snapshot& device_description) override {}
+        void write_frame(const device_serializer::stream_identifier& stream_id, const device_serializer::nanoseconds& timestamp, frame_holder&& frame) override;
+        void write_snapshot(uint32_t device_index, const device_serializer::nanoseconds& timestamp, rs2_extension type, const std::shared_ptr<extension_snapshot>& snapshot) override {}
+        void write_snapshot(const device_serializer::sensor_identifier& sensor_id, const device_serializer::nanoseconds& timestamp, rs2_extension type, const std::shared_ptr<extension_snapshot>& snapshot) override;
+        const std::string& get_file_name() const override { return m_name; }
+
+    private:
+        struct client
+        {
+            std::shared_ptr<network_socket> socket;
+            std::mutex mutex;
+            std::condition_variable cv;
+            std::deque<std::pair<network_message_type, std::shared_ptr<const std::vector<uint8_t>>>> queue;
+            uint32_t queued_frames = 0;
+            bool subscribed = false;            // Until the client subscribes, it receives every stream
+            std::set<std::tuple<uint32_t, rs2_stream, uint32_t>> streams;
+            bool alive = true;
+            std::thread sender;
+            std::thread receiver;
+        };
+
+        void accept_clients();
+        void send_messages(std::shared_ptr<client> c);
+        void receive_messages(std::shared_ptr<client> c);
+        void send_to_clients(network_message_type type, std::shared_ptr<const std::vector<uint8_t>> payload,
+                             const device_serializer::stream_identifier* stream_id);
+        void close_client(client& c);
+
+        std::vector<uint8_t> m_description;
+        bool m_compress_depth;
+        std::string m_name;
+        std::shared_ptr<network_socket> m_listener;
+        std::mutex m_clients_mutex;
+        std::vector<std::shared_ptr<client>> m_clients;
+        std::atomic<bool> m_alive;
+        std::thread m_acceptor;
+    };
+}
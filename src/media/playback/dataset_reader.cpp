@@ -0,0 +1,268 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#include "dataset_reader.h"
+#include "sliced_playback.h"
+#include "archive.h"
+#include "context.h"
+#include "threading.h"
+#include "proc/align.h"
+#include "proc/decimation-filter.h"
+
+#include <cstring>
+
+using namespace librealsense;
+
+const int DATASET_DEFAULT_BATCH_SIZE = 32;
+const int DATASET_DEFAULT_PREFETCH = 2;
+
+class sample_output_callback : public rs2_frame_callback
+{
+    std::function<void(frame_holder)> _on_frame;
+public:
+    explicit sample_output_callback(std::function<void(frame_holder)> on_frame) : _on_frame(std::move(on_frame)) {}
+
+    void on_frame(rs2_frame* f) override { _on_frame(frame_holder((frame_interface*)f)); }
+
+    void release() override { delete this; }
+};
+
+// The member of a frameset of the stream, of any index when the index is negative
+static frame_interface* find_stream(frame_interface* frameset, rs2_stream stream, int index)
+{
+    auto composite = dynamic_cast<composite_frame*>(frameset);
+    if (!composite) return nullptr;
+    for (size_t i = 0; i < composite->get_embedded_frames_count(); i++)
+    {
+        auto f = composite->get_frame(static_cast<int>(i));
+        if (f && f->get_stream()->get_stream_type() == stream && (index < 0 || f->get_stream()->get_stream_index() == index))
+            return f;
+    }
+    return nullptr;
+}
+
+dataset_reader::dataset_reader(std::shared_ptr<context> ctx, std::vector<std::string> files,
+                               std::vector<std::pair<rs2_stream, int>> streams, const rs2_dataset_config& config) :
+    _context(ctx),
+    _files(std::move(files)),
+    _streams(std::move(streams)),
+    _config(config),
+    _done(false),
+    _stopping(false)
+{
+    if (_files.empty())
+        throw invalid_value_exception("No recordings to read");
+    if (_streams.empty())
+        throw invalid_value_exception("No streams to read");
+
+    if (!_config.batch_size) _config.batch_size = DATASET_DEFAULT_BATCH_SIZE;
+    if (!_config.threads) _config.threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    if (!_config.prefetch) _config.prefetch = DATASET_DEFAULT_PREFETCH;
+    if (!_config.decimation) _config.decimation = 1;
+    if (_config.batch_size < 0 || _config.threads < 0 || _config.prefetch < 0)
+    {
+        throw invalid_value_exception(to_string() << "Invalid dataset reader settings, batch size " << _config.batch_size
+            << ", threads " << _config.threads << ", prefetch " << _config.prefetch);
+    }
+
+    // Settings the processing blocks reject are reported here rather than by the first batch
+    make_chain();
+
+    _thread = std::thread([this]() { read(); });
+}
+
+dataset_reader::~dataset_reader()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+        _cv.notify_all();
+    }
+    _thread.join();
+}
+
+std::shared_ptr<dataset_batch> dataset_reader::next_batch()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _cv.wait(lock, [this]() { return !_batches.empty() || _done; });
+    if (!_batches.empty())
+    {
+        auto batch = _batches.front();
+        _batches.pop_front();
+        _cv.notify_all();
+        return batch;
+    }
+    if (_error)
+        std::rethrow_exception(_error);
+    return nullptr;
+}
+
+void dataset_reader::read()
+{
+    thread_registration registration("rs-dataset-reader", RS2_THREAD_CLASS_IO);
+    try
+    {
+        for (int file = 0; file < static_cast<int>(_files.size()); file++)
+        {
+            // Each recording starts with processing blocks of its own, as they keep the profiles of their inputs
+            std::vector<std::unique_ptr<slice_chain>> chains;
+            for (int i = 0; i < _config.threads; i++)
+                chains.push_back(make_chain());
+
+            sliced_playback playback(_context, _files[file], _config.threads, std::chrono::nanoseconds(0));
+            playback.run(
+                [&](int slice, frame_holder frameset, bool) -> void*
+                {
+                    return make_sample(*chains[slice], file, std::move(frameset));
+                },
+                [this](void* result) { add_sample(std::unique_ptr<sample>(static_cast<sample*>(result))); },
+                [](void* result) { delete static_cast<sample*>(result); });
+        }
+        push_batch();
+    }
+    catch (...)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_stopping) _error = std::current_exception();
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _done = true;
+    _cv.notify_all();
+}
+
+std::unique_ptr<dataset_reader::slice_chain> dataset_reader::make_chain() const
+{
+    std::unique_ptr<slice_chain> chain(new slice_chain());
+    auto c = chain.get();
+    auto capture = [c]() -> frame_callback_ptr
+    {
+        return { new sample_output_callback([c](frame_holder f) { c->output = std::move(f); }),
+                 [](rs2_frame_callback* p) { p->release(); } };
+    };
+
+    if (_config.align_to != RS2_STREAM_ANY)
+    {
+        chain->align = std::make_shared<align>(_config.align_to);
+        chain->align->set_output_callback(capture());
+    }
+    if (_config.decimation != 1)
+    {
+        chain->decimation = std::make_shared<decimation_filter>();
+        chain->decimation->get_option(RS2_OPTION_FILTER_MAGNITUDE).set(static_cast<float>(_config.decimation));
+        chain->decimation->set_output_callback(capture());
+    }
+    return chain;
+}
+
+// The blocks run on the thread of the slice, and hand on their results before invoke returns
+dataset_reader::sample* dataset_reader::make_sample(slice_chain& chain, int file, frame_holder frameset) const
+{
+    if (!dynamic_cast<composite_frame*>(frameset.frame)) return nullptr;
+
+    // The aligned frameset holds the aligned stream and the one it was aligned to, the others come from the input
+    frame_holder aligned;
+    if (chain.align)
+    {
+        chain.align->invoke(frameset.clone());
+        aligned = std::move(chain.output);
+    }
+
+    std::unique_ptr<sample> result(new sample());
+    result->file = file;
+    for (auto&& requested : _streams)
+    {
+        auto f = aligned ? find_stream(aligned.frame, requested.first, requested.second) : nullptr;
+        if (!f) f = find_stream(frameset.frame, requested.first, requested.second);
+        // Framesets missing a stream, as when the streams run at different rates, give no sample
+        if (!dynamic_cast<video_frame*>(f)) return nullptr;
+
+        frame_holder decimated;
+        if (chain.decimation && requested.first == RS2_STREAM_DEPTH)
+        {
+            f->acquire();
+            chain.decimation->invoke(frame_holder(f));
+            decimated = std::move(chain.output);
+            f = decimated.frame;
+        }
+        auto video = dynamic_cast<video_frame*>(f);
+        if (!video) return nullptr;
+
+        sample::stream_frame out;
+        out.index = f->get_stream()->get_stream_index();
+        out.format = f->get_stream()->get_format();
+        out.width = video->get_width();
+        out.height = video->get_height();
+        out.bpp = video->get_bpp() / 8;
+        out.timestamp = f->get_frame_timestamp();
+        out.frame_number = f->get_frame_number();
+
+        auto row = static_cast<size_t>(out.width) * out.bpp;
+        out.data.resize(row * out.height);
+        auto data = video->get_frame_data();
+        for (int y = 0; y < out.height; y++)
+            memcpy(out.data.data() + row * y, data + static_cast<size_t>(video->get_stride()) * y, row);
+        result->frames.push_back(std::move(out));
+    }
+    return result.release();
+}
+
+void dataset_reader::add_sample(std::unique_ptr<sample> s)
+{
+    // The streams of a batch are arrays, so a sample of another resolution or format starts a new batch
+    if (!_pending.empty())
+    {
+        auto&& first = _pending.front()->frames;
+        for (size_t i = 0; i < first.size(); i++)
+        {
+            auto&& a = first[i];
+            auto&& b = s->frames[i];
+            if (a.index != b.index || a.format != b.format || a.width != b.width || a.height != b.height || a.bpp != b.bpp)
+            {
+                push_batch();
+                break;
+            }
+        }
+    }
+
+    _pending.push_back(std::move(s));
+    if (static_cast<int>(_pending.size()) == _config.batch_size)
+        push_batch();
+}
+
+void dataset_reader::push_batch()
+{
+    if (_pending.empty()) return;
+
+    frame_memory_policy policy;
+    policy.locked = _config.pinned != 0;
+
+    auto batch = std::make_shared<dataset_batch>();
+    for (auto&& s : _pending)
+        batch->files.push_back(s->file);
+    for (size_t i = 0; i < _streams.size(); i++)
+    {
+        auto&& first = _pending.front()->frames[i];
+        auto size = first.data.size();
+
+        dataset_batch::stream_data stream{ _streams[i].first, first.index, first.format, first.width, first.height, first.bpp,
+                                           frame_storage(uninitialized_aligned_allocator<uint8_t>(policy)), {}, {} };
+        stream.data.resize(size * _pending.size());
+        for (size_t j = 0; j < _pending.size(); j++)
+        {
+            auto&& f = _pending[j]->frames[i];
+            memcpy(stream.data.data() + size * j, f.data.data(), size);
+            stream.timestamps.push_back(f.timestamp);
+            stream.frame_numbers.push_back(f.frame_number);
+        }
+        batch->streams.push_back(std::move(stream));
+    }
+    _pending.clear();
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    _cv.wait(lock, [this]() { return _stopping || static_cast<int>(_batches.size()) < _config.prefetch; });
+    if (_stopping)
+        throw wrong_api_call_sequence_exception("The dataset reader was stopped");
+    _batches.push_back(batch);
+    _cv.notify_all();
+}
@@ -0,0 +1,105 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "types.h"
+#include "frame-storage.h"
+#include "../include/librealsense2/h/rs_record_playback.h"
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace librealsense
+{
+    class context;
+    class processing_block;
+
+    // Samples of a batch, every stream gathered into one buffer of size x height x width x bpp bytes
+    struct dataset_batch
+    {
+        struct stream_data
+        {
+            rs2_stream stream;
+            int index;
+            rs2_format format;
+            int width, height, bpp;
+            frame_storage data;
+            std::vector<double> timestamps;
+            std::vector<unsigned long long> frame_numbers;
+        };
+
+        std::vector<stream_data> streams;
+        std::vector<int> files;     // Recording of every sample
+
+        int size() const { return static_cast<int>(files.size()); }
+    };
+
+    // Reads batches of samples from recordings for training models. The recordings are played one after the other by
+    // a sliced playback, so that their slices are decoded, aligned and decimated in parallel, and the framesets holding
+    // all the requested streams are copied out as samples, since the frames of the later slices wait for the earlier
+    // ones to be delivered and would otherwise exhaust the frame pools. A thread of the reader gathers the samples
+    // into batches in the order of the recordings, up to prefetch batches ahead of the one read
+    class dataset_reader
+    {
+    public:
+        dataset_reader(std::shared_ptr<context> ctx, std::vector<std::string> files,
+                       std::vector<std::pair<rs2_stream, int>> streams, const rs2_dataset_config& config);
+        ~dataset_reader();
+
+        // Null at the end of the recordings, throws the error that stopped the reading once the batches before it are read
+        std::shared_ptr<dataset_batch> next_batch();
+
+    private:
+        struct sample
+        {
+            struct stream_frame
+            {
+                int index;
+                rs2_format format;
+                int width, height, bpp;
+                double timestamp;
+                unsigned long long frame_number;
+                std::vector<uint8_t> data;
+            };
+
+            int file;
+            std::vector<stream_frame> frames;   // In the order of the requested streams
+        };
+
+        // Processing blocks of a slice, run on the thread of the slice
+        struct slice_chain
+        {
+            std::shared_ptr<processing_block> align;
+            std::shared_ptr<processing_block> decimation;
+            frame_holder output;
+        };
+
+        void read();
+        std::unique_ptr<slice_chain> make_chain() const;
+        sample* make_sample(slice_chain& chain, int file, frame_holder frameset) const;
+        void add_sample(std::unique_ptr<sample> s);
+        void push_batch();
+
+        std::shared_ptr<context> _context;
+        std::vector<std::string> _files;
+        std::vector<std::pair<rs2_stream, int>> _streams;
+        rs2_dataset_config _config;
+
+        std::vector<std::unique_ptr<sample>> _pending;     // Samples of the batch being gathered, by the reading thread
+
+        std::mutex _mutex;
+        std::condition_variable _cv;
+        std::deque<std::shared_ptr<dataset_batch>> _batches;
+        bool _done;
+        bool _stopping;
+        std::exception_ptr _error;
+        std::thread _thread;
+    };
+}
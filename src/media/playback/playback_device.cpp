@@ -8,24 +8,39 @@
 #include "media/ros/ros_reader.h"
 #include "environment.h"
 #include "sync.h"
+#include "proc/synthetic-stream.h"
+#include "proc/syncer-processing-block.h"
 
 using namespace device_serializer;
 
+class batch_frameset_callback : public rs2_frame_callback
+{
+    std::function<void(frame_holder)> _on_frame;
+public:
+    explicit batch_frameset_callback(std::function<void(frame_holder)> on_frame) : _on_frame(std::move(on_frame)) {}
+
+    void on_frame(rs2_frame* f) override { _on_frame(frame_holder((frame_interface*)f)); }
+
+    void release() override { delete this; }
+};
+
 playback_device::playback_device(std::shared_ptr<context> ctx, std::shared_ptr<device_serializer::reader> serializer) :
     m_context(ctx),
     m_is_started(false),
     m_is_paused(false),
     m_sample_rate(1),
     m_real_time(false),
+    m_batch_mode(false),
     m_prev_timestamp(0),
-    m_read_thread([]() {return std::make_shared<dispatcher>(std::numeric_limits<unsigned int>::max()); })
+    m_read_thread([]() {return std::make_shared<dispatcher>(std::numeric_limits<unsigned int>::max(), "rs-playback", RS2_THREAD_CLASS_IO); })
 {
     if (serializer == nullptr)
     {
         throw invalid_value_exception("null serializer");
     }
 
-    m_reader = serializer;
+    //Frames are read and decoded ahead on a thread of the reader, while this device paces and dispatches them
+    m_reader = std::make_shared<read_ahead_reader>(serializer);
     (*m_read_thread)->start();
 
     //Read header and build device from recorded device snapshot
@@ -94,6 +109,7 @@ std::map<uint32_t, std::shared_ptr<playback_sensor>> playback_device::create_pla
             (*m_read_thread)->invoke([this, filters](dispatcher::cancellable_timer c)
             {
                 m_reader->enable_stream(filters);
+                reset_batch_syncer();
             });
         };
 
@@ -102,6 +118,7 @@ std::map<uint32_t, std::shared_ptr<playback_sensor>> playback_device::create_pla
             (*m_read_thread)->invoke([this, filters](dispatcher::cancellable_timer c)
             {
                 m_reader->disable_stream(filters);
+                reset_batch_syncer();
             });
         };
 
@@ -143,6 +160,7 @@ playback_device::~playback_device()
             if (sensor.second != nullptr)
                 sensor.second->stop();
         }
+        reset_batch_syncer();
     });
     if((*m_read_thread)->flush() == false)
     {
@@ -217,6 +235,7 @@ void playback_device::seek_to_time(std::chrono::nanoseconds time)
         m_device_description = m_reader->query_device_description(time);
         update_extensions(m_device_description);
         m_prev_timestamp = time; //Updating prev timestamp to make get_position return true indication even when playbakc is paused
+        reset_batch_syncer();
         catch_up();
     });
     if ((*m_read_thread)->flush() == false)
@@ -226,6 +245,69 @@ void playback_device::seek_to_time(std::chrono::nanoseconds time)
     }
 }
 
+device_serializer::stream_identifier playback_device::get_stream_identifier(const stream_interface& stream) const
+{
+    for (auto&& sensor_pair : m_sensors)
+    {
+        for (auto&& stream_profile : sensor_pair.second->get_stream_profiles())
+        {
+            if (stream_profile->get_stream_type() == stream.get_stream_type() && stream_profile->get_stream_index() == stream.get_stream_index())
+            {
+                return { get_device_index(), sensor_pair.first, stream.get_stream_type(), static_cast<uint32_t>(stream.get_stream_index()) };
+            }
+        }
+    }
+    throw invalid_value_exception(to_string() << "File does not contain a " << stream.get_stream_type() << " stream of index " << stream.get_stream_index());
+}
+
+// Run an action on the reading thread, where the reader is safe to use, and rethrow its errors on the calling thread
+void playback_device::invoke_and_wait(std::function<void()> action)
+{
+    auto error = std::make_shared<std::exception_ptr>();
+    (*m_read_thread)->invoke([action, error](dispatcher::cancellable_timer t)
+    {
+        try
+        {
+            action();
+        }
+        catch (...)
+        {
+            *error = std::current_exception();
+        }
+    });
+    if ((*m_read_thread)->flush() == false)
+    {
+        throw io_exception("Timeout waiting for the playback reader");
+    }
+    if (*error)
+    {
+        std::rethrow_exception(*error);
+    }
+}
+
+void playback_device::seek_to_frame(const stream_interface& stream, uint64_t frame)
+{
+    // The frame index of a stream is built once, from the index of the file, later seeks are a lookup
+    auto time = std::make_shared<device_serializer::nanoseconds>();
+    auto stream_id = get_stream_identifier(stream);
+    invoke_and_wait([this, stream_id, frame, time]() { *time = m_reader->query_frame_time(stream_id, frame); });
+    seek_to_time(*time);
+}
+
+uint64_t playback_device::get_frame_count(const stream_interface& stream)
+{
+    auto count = std::make_shared<uint64_t>(0);
+    auto stream_id = get_stream_identifier(stream);
+    invoke_and_wait([this, stream_id, count]() { *count = m_reader->query_frame_count(stream_id); });
+    return *count;
+}
+
+bool playback_device::get_thumbnail(const stream_interface& stream, std::chrono::nanoseconds time, device_serializer::thumbnail& result)
+{
+    // Thumbnails are read aside of the read position, without waiting for the playback thread
+    return m_reader->query_thumbnail(get_stream_identifier(stream), time, result);
+}
+
 rs2_playback_status playback_device::get_current_status() const
 {
     return m_is_started ?
@@ -299,7 +381,7 @@ void playback_device::resume()
 
 void playback_device::set_real_time(bool real_time)
 {
-    LOG_INFO("Set real time to " << (real_time) ? "True" : "False");
+    LOG_INFO("Set real time to " << (real_time ? "True" : "False"));
     m_real_time = real_time;
 }
 
@@ -308,6 +390,90 @@ bool playback_device::is_real_time() const
     return m_real_time;
 }
 
+void playback_device::set_batch_mode(bool batch)
+{
+    LOG_INFO("Set batch mode to " << (batch ? "True" : "False"));
+    m_batch_mode = batch;
+}
+
+bool playback_device::is_batch_mode() const
+{
+    return m_batch_mode;
+}
+
+frame_holder playback_device::next_frameset()
+{
+    auto result = std::make_shared<frame_holder>();
+    invoke_and_wait([this, result]()
+    {
+        if (m_is_started)
+        {
+            throw wrong_api_call_sequence_exception("Frames can not be pulled from the playback while its sensors are started");
+        }
+        if (!m_batch_syncer)
+        {
+            //Frames are grouped by the same syncer the pipeline uses, its output is delivered on this thread
+            m_batch_syncer = std::make_shared<syncer_proccess_unit>();
+            m_batch_syncer->set_output_callback({
+                new batch_frameset_callback([this](frame_holder f) { m_batch_framesets.push_back(std::move(f)); }),
+                [](rs2_frame_callback* p) { p->release(); }
+            });
+        }
+
+        while (m_batch_framesets.empty())
+        {
+            auto data = m_reader->read_next_data();
+            if (data->as<serialized_end_of_file>())
+            {
+                LOG_INFO("End of file reached");
+                return;
+            }
+            m_prev_timestamp = data->get_timestamp();
+
+            if (auto frame = data->as<serialized_frame>())
+            {
+                if (frame->stream_id.device_index != get_device_index() || frame->stream_id.sensor_index >= m_sensors.size())
+                {
+                    throw invalid_value_exception(to_string() << "Unexpected sensor index while playing file (Read index = " << frame->stream_id.sensor_index << ")");
+                }
+                if (m_sensors.at(frame->stream_id.sensor_index)->prepare_frame(frame->frame))
+                {
+                    m_batch_syncer->invoke(std::move(frame->frame));
+                }
+            }
+            else if (auto option_data = data->as<serialized_option>())
+            {
+                m_sensors.at(option_data->sensor_id.sensor_index)->update_option(option_data->option_id, option_data->option);
+            }
+        }
+        *result = std::move(m_batch_framesets.front());
+        m_batch_framesets.pop_front();
+    });
+    return std::move(*result);
+}
+
+// Framesets pulled by next_frameset() only follow each other in the file, frames waiting for a match are dropped when the position moves
+void playback_device::reset_batch_syncer()
+{
+    m_batch_framesets.clear();
+    m_batch_syncer.reset();
+}
+
+void playback_device::set_read_ahead(uint32_t frames)
+{
+    LOG_INFO("Set read ahead to " << frames << " frames");
+    if (frames > MAX_READ_AHEAD_DEPTH)
+    {
+        throw invalid_value_exception(to_string() << "Failed to set read ahead to " << frames << " frames, the maximum is " << MAX_READ_AHEAD_DEPTH);
+    }
+    m_reader->set_depth(frames);
+}
+
+uint32_t playback_device::get_read_ahead() const
+{
+    return m_reader->get_depth();
+}
+
 platform::backend_device_group playback_device::get_device_data() const
 {
     return platform::backend_device_group({ platform::playback_device_info{ m_reader->get_file_name() } });
@@ -409,6 +575,7 @@ void playback_device::stop_internal()
     }
     m_reader->reset();
     m_prev_timestamp = std::chrono::nanoseconds(0);
+    reset_batch_syncer();
     catch_up();
     playback_status_changed(RS2_PLAYBACK_STATUS_STOPPED);
 }
@@ -493,8 +660,8 @@ void playback_device::try_looping()
             update_time_base(timestamp);
         }
 
-        //Calculate the duration for the reader to sleep (i.e wait for next frame)
-        auto sleep_time = calc_sleep_time(timestamp);
+        //Calculate the duration for the reader to sleep (i.e wait for next frame), batch playback is not paced
+        auto sleep_time = m_batch_mode ? device_serializer::nanoseconds(0) : calc_sleep_time(timestamp);
         if (sleep_time.count() > 0)
         {
             if (m_sample_rate > 0)
@@ -513,7 +680,8 @@ void playback_device::try_looping()
             }
             LOG_DEBUG("Dispatching frame " << frame->stream_id);
             //Dispatch frame to the relevant sensor
-            m_sensors.at(frame->stream_id.sensor_index)->handle_frame(std::move(frame->frame), m_real_time);
+            //Batch playback waits for the callbacks of each frame, so none is dropped
+            m_sensors.at(frame->stream_id.sensor_index)->handle_frame(std::move(frame->frame), m_real_time || m_batch_mode);
             return true;
         }
 
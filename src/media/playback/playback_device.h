@@ -11,9 +11,12 @@
 #include "concurrency.h"
 #include "sensor.h"
 #include "playback_sensor.h"
+#include "read_ahead_reader.h"
 
 namespace librealsense
 {
+    class syncer_proccess_unit;
+
     class playback_device : public device_interface,
                             public extendable_interface,
                             public info_container
@@ -33,6 +36,9 @@ namespace librealsense
 
         void set_frame_rate(double rate);
         void seek_to_time(std::chrono::nanoseconds time);
+        void seek_to_frame(const stream_interface& stream, uint64_t frame);
+        uint64_t get_frame_count(const stream_interface& stream);
+        bool get_thumbnail(const stream_interface& stream, std::chrono::nanoseconds time, device_serializer::thumbnail& result);
         rs2_playback_status get_current_status() const;
         uint64_t get_duration() const;
         void pause();
@@ -40,6 +46,11 @@ namespace librealsense
         void stop();
         void set_real_time(bool real_time);
         bool is_real_time() const;
+        void set_batch_mode(bool batch);
+        bool is_batch_mode() const;
+        frame_holder next_frameset();
+        void set_read_ahead(uint32_t frames);
+        uint32_t get_read_ahead() const;
         const std::string& get_file_name() const;
         uint64_t get_position() const;
         signal<playback_device, rs2_playback_status> playback_status_changed;
@@ -57,15 +68,18 @@ namespace librealsense
         template <typename T> void do_loop(T op);
         std::map<uint32_t, std::shared_ptr<playback_sensor>> create_playback_sensors(const device_serializer::device_snapshot& device_description);
         std::shared_ptr<stream_profile_interface> get_stream(const std::map<unsigned, std::shared_ptr<playback_sensor>>& sensors_map, device_serializer::stream_identifier stream_id);
+        device_serializer::stream_identifier get_stream_identifier(const stream_interface& stream) const;
+        void invoke_and_wait(std::function<void()> action);
         rs2_extrinsics calc_extrinsic(const rs2_extrinsics& from, const rs2_extrinsics& to);
         void catch_up();
         void register_device_info(const device_serializer::device_snapshot& device_description);
         void register_extrinsics(const device_serializer::device_snapshot& device_description);
         void update_extensions(const device_serializer::device_snapshot& device_description);
+        void reset_batch_syncer();
 
     private:
         lazy<std::shared_ptr<dispatcher>> m_read_thread;
-        std::shared_ptr<device_serializer::reader> m_reader;
+        std::shared_ptr<read_ahead_reader> m_reader;
         device_serializer::device_snapshot m_device_description;
         std::atomic_bool m_is_started;
         std::atomic_bool m_is_paused;
@@ -75,6 +89,9 @@ namespace librealsense
         std::map<uint32_t, std::shared_ptr<playback_sensor>> m_active_sensors;
         std::atomic<double> m_sample_rate;
         std::atomic_bool m_real_time;
+        std::atomic_bool m_batch_mode;
+        std::shared_ptr<syncer_proccess_unit> m_batch_syncer; // !< Groups the frames pulled by next_frameset(), used only on the reading thread
+        std::deque<frame_holder> m_batch_framesets;
         device_serializer::nanoseconds m_prev_timestamp;
         std::shared_ptr<context> m_context;
         std::vector<std::shared_ptr<lazy<rs2_extrinsics>>> m_extrinsics_fetchers;
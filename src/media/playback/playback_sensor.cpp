@@ -63,7 +63,7 @@ void playback_sensor::open(const stream_profiles& requests)
     //For each stream, create a dedicated dispatching thread
     for (auto&& profile : requests)
     {
-        m_dispatchers.emplace(std::make_pair(profile->get_unique_id(), std::make_shared<dispatcher>(10))); //TODO: what size the queue should be?
+        m_dispatchers.emplace(std::make_pair(profile->get_unique_id(), std::make_shared<dispatcher>(10, "rs-playback-out"))); //TODO: what size the queue should be?
         m_dispatchers[profile->get_unique_id()]->start();
         device_serializer::stream_identifier f{ get_device_index(), m_sensor_id, profile->get_stream_type(), static_cast<uint32_t>(profile->get_stream_index()) };
         opened_streams.push_back(f);
@@ -97,6 +97,11 @@ void playback_sensor::register_notifications_callback(notifications_callback_ptr
     m_user_notification_callback = std::move(callback);
 }
 
+void playback_sensor::set_frame_allocator(frame_allocator_ptr allocator, size_t alignment)
+{
+    throw not_implemented_exception("Custom frame allocators are not supported by playback sensors");
+}
+
 void playback_sensor::start(frame_callback_ptr callback)
 {
     LOG_DEBUG("Start sensor " << m_sensor_id);
@@ -145,17 +150,12 @@ void playback_sensor::handle_frame(frame_holder frame, bool is_real_time)
     }
     if(m_is_started)
     {
-        frame->get_owner()->set_sensor(shared_from_this());
-        auto type = frame->get_stream()->get_stream_type();
-        auto index = static_cast<uint32_t>(frame->get_stream()->get_stream_index());
-        frame->set_stream(m_streams[std::make_pair(type, index)]);
-        frame->set_sensor(shared_from_this());
-        auto stream_id = frame.frame->get_stream()->get_unique_id();
         //TODO: remove this once filter is implemented (which will only read streams that were 'open'ed
-        if(m_dispatchers.find(stream_id) == m_dispatchers.end())
+        if(!prepare_frame(frame))
         {
             return;
         }
+        auto stream_id = frame.frame->get_stream()->get_unique_id();
         //TODO: Ziv, remove usage of shared_ptr when frame_holder is cpoyable
         auto pf = std::make_shared<frame_holder>(std::move(frame));
         m_dispatchers.at(stream_id)->invoke([this, pf](dispatcher::cancellable_timer t)
@@ -170,6 +170,17 @@ void playback_sensor::handle_frame(frame_holder frame, bool is_real_time)
         }
     }
 }
+// Attach the stream and the sensor to a frame read from the file, returns false if its stream was not opened
+bool playback_sensor::prepare_frame(frame_holder& frame)
+{
+    frame->get_owner()->set_sensor(shared_from_this());
+    auto type = frame->get_stream()->get_stream_type();
+    auto index = static_cast<uint32_t>(frame->get_stream()->get_stream_index());
+    frame->set_stream(m_streams[std::make_pair(type, index)]);
+    frame->set_sensor(shared_from_this());
+    return m_dispatchers.find(frame->get_stream()->get_unique_id()) != m_dispatchers.end();
+}
+
 void playback_sensor::update_option(rs2_option id, std::shared_ptr<option> option)
 {
     register_option(id, option);
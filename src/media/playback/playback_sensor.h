@@ -33,12 +33,14 @@ namespace librealsense
         void open(const stream_profiles& requests) override;
         void close() override;
         void register_notifications_callback(notifications_callback_ptr callback) override;
+        void set_frame_allocator(frame_allocator_ptr allocator, size_t alignment) override;
         void start(frame_callback_ptr callback) override;
         void stop() override;
         bool is_streaming() const override;
         bool extend_to(rs2_extension extension_type, void** ext) override;
         const device_interface& get_device() override;
         void handle_frame(frame_holder frame, bool is_real_time);
+        bool prepare_frame(frame_holder& frame);
         void update_option(rs2_option id, std::shared_ptr<option> option);
         void stop(bool invoke_required);
         void flush_pending_frames();
@@ -0,0 +1,213 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#include "read_ahead_reader.h"
+#include "environment.h"
+
+using namespace librealsense;
+using namespace device_serializer;
+
+read_ahead_reader::read_ahead_reader(std::shared_ptr<reader> reader, uint32_t depth) :
+    m_reader(reader),
+    m_depth(std::min(depth, MAX_READ_AHEAD_DEPTH)),
+    m_prefetching(false),
+    m_alive(true),
+    m_task_posted(false),
+    m_pool(environment::get_instance().get_playback_pool())
+{
+    if (m_reader == nullptr)
+    {
+        throw invalid_value_exception("null reader");
+    }
+}
+
+read_ahead_reader::~read_ahead_reader()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_alive = false;
+    m_cv.wait(lock, [this]() { return !m_task_posted; });
+}
+
+void read_ahead_reader::set_depth(uint32_t depth)
+{
+    std::lock_guard<std::mutex> read_lock(m_reader_mutex);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // Items already read ahead are kept, a smaller depth only stops the reading until they are consumed
+    m_depth = std::min(depth, MAX_READ_AHEAD_DEPTH);
+    if (m_depth == 0)
+    {
+        m_prefetching = false;
+    }
+    schedule_read_ahead();
+}
+
+uint32_t read_ahead_reader::get_depth() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_depth;
+}
+
+//Called while holding m_mutex
+void read_ahead_reader::schedule_read_ahead()
+{
+    if (!m_alive || m_task_posted || !m_prefetching || m_items.size() >= m_depth)
+        return;
+
+    m_task_posted = true;
+    m_pool.post([this]() { read_ahead(); });
+}
+
+void read_ahead_reader::read_ahead()
+{
+    {
+        std::lock_guard<std::mutex> read_lock(m_reader_mutex);
+        bool read = false;
+        {
+            //The read position could have moved since the task was posted
+            std::lock_guard<std::mutex> lock(m_mutex);
+            read = m_alive && m_prefetching && m_items.size() < m_depth;
+        }
+
+        if (read)
+        {
+            item next;
+            try
+            {
+                next.data = m_reader->read_next_data();
+            }
+            catch (...)
+            {
+                next.error = std::current_exception();
+            }
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            //Nothing follows the end of the file or a read error until the position moves
+            if (next.error || next.data->is<serialized_end_of_file>())
+            {
+                m_prefetching = false;
+            }
+            m_items.push_back(std::move(next));
+        }
+    }
+
+    //The next item is read by a new task, behind the ones other readers posted meanwhile
+    //Notified while holding the lock, as the destructor may run as soon as it is released
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_task_posted = false;
+    schedule_read_ahead();
+    m_cv.notify_all();
+}
+
+std::shared_ptr<serialized_data> read_ahead_reader::read_next_data()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_items.empty() && m_depth == 0)
+    {
+        lock.unlock();
+        std::lock_guard<std::mutex> read_lock(m_reader_mutex);
+        return m_reader->read_next_data();
+    }
+
+    if (!m_prefetching && m_items.empty())
+    {
+        m_prefetching = true;
+        schedule_read_ahead();
+    }
+    m_cv.wait(lock, [this]() { return !m_items.empty(); });
+
+    auto next = std::move(m_items.front());
+    m_items.pop_front();
+    //Refill the freed slot
+    schedule_read_ahead();
+    lock.unlock();
+
+    if (next.error)
+    {
+        std::rethrow_exception(next.error);
+    }
+    return next.data;
+}
+
+void read_ahead_reader::drop_read_ahead(bool rewind)
+{
+    //Called while holding m_reader_mutex, so nothing is being read ahead
+    std::deque<item> dropped;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_prefetching = false;
+        dropped.swap(m_items);
+    }
+
+    //Move the reader back to the first item that was read ahead and not consumed
+    if (rewind && !dropped.empty())
+    {
+        auto&& first = dropped.front();
+        if (!first.error && !first.data->is<serialized_end_of_file>())
+        {
+            m_reader->seek_to_time(first.data->get_timestamp());
+        }
+    }
+}
+
+device_snapshot read_ahead_reader::query_device_description(const nanoseconds& time)
+{
+    std::lock_guard<std::mutex> read_lock(m_reader_mutex);
+    return m_reader->query_device_description(time);
+}
+
+void read_ahead_reader::seek_to_time(const nanoseconds& time)
+{
+    std::lock_guard<std::mutex> read_lock(m_reader_mutex);
+    drop_read_ahead(false);
+    m_reader->seek_to_time(time);
+}
+
+uint64_t read_ahead_reader::query_frame_count(const stream_identifier& stream_id)
+{
+    std::lock_guard<std::mutex> read_lock(m_reader_mutex);
+    return m_reader->query_frame_count(stream_id);
+}
+
+nanoseconds read_ahead_reader::query_frame_time(const stream_identifier& stream_id, uint64_t frame)
+{
+    std::lock_guard<std::mutex> read_lock(m_reader_mutex);
+    return m_reader->query_frame_time(stream_id, frame);
+}
+
+bool read_ahead_reader::query_thumbnail(const stream_identifier& stream_id, const nanoseconds& time, thumbnail& result)
+{
+    std::lock_guard<std::mutex> read_lock(m_reader_mutex);
+    return m_reader->query_thumbnail(stream_id, time, result);
+}
+
+nanoseconds read_ahead_reader::query_duration() const
+{
+    return m_reader->query_duration();
+}
+
+void read_ahead_reader::reset()
+{
+    std::lock_guard<std::mutex> read_lock(m_reader_mutex);
+    drop_read_ahead(false);
+    m_reader->reset();
+}
+
+void read_ahead_reader::enable_stream(const std::vector<stream_identifier>& stream_ids)
+{
+    std::lock_guard<std::mutex> read_lock(m_reader_mutex);
+    //The reader continues from the time of the next item it reads
+    drop_read_ahead(true);
+    m_reader->enable_stream(stream_ids);
+}
+
+void read_ahead_reader::disable_stream(const std::vector<stream_identifier>& stream_ids)
+{
+    std::lock_guard<std::mutex> read_lock(m_reader_mutex);
+    drop_read_ahead(true);
+    m_reader->disable_stream(stream_ids);
+}
+
+const std::string& read_ahead_reader::get_file_name() const
+{
+    return m_reader->get_file_name();
+}
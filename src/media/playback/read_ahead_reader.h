@@ -0,0 +1,65 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <core/serialization.h>
+#include "concurrency.h"
+
+namespace librealsense
+{
+    const uint32_t DEFAULT_READ_AHEAD_DEPTH = 4;
+    // Prefetched frames are allocated from the reader's frame source, which can only hold 16 frames at once
+    const uint32_t MAX_READ_AHEAD_DEPTH = 8;
+
+    // Reads the data of another reader ahead of its consumer on the threads shared by all playback devices
+    // File I/O, chunk decompression and frame creation of the next items run while the consumer
+    // paces and dispatches the current one. Up to 'depth' items are kept ready, a depth of 0 reads
+    // on the calling thread. Any call that moves the read position drops the items read ahead.
+    // Each task reads a single item, so the files being played take turns on the shared threads
+    class read_ahead_reader : public device_serializer::reader
+    {
+    public:
+        read_ahead_reader(std::shared_ptr<device_serializer::reader> reader, uint32_t depth = DEFAULT_READ_AHEAD_DEPTH);
+        ~read_ahead_reader();
+
+        void set_depth(uint32_t depth);
+        uint32_t get_depth() const;
+
+        device_serializer::device_snapshot query_device_description(const device_serializer::nanoseconds& time) override;
+        std::shared_ptr<device_serializer::serialized_data> read_next_data() override;
+        void seek_to_time(const device_serializer::nanoseconds& time) override;
+        uint64_t query_frame_count(const device_serializer::stream_identifier& stream_id) override;
+        device_serializer::nanoseconds query_frame_time(const device_serializer::stream_identifier& stream_id, uint64_t frame) override;
+        bool query_thumbnail(const device_serializer::stream_identifier& stream_id, const device_serializer::nanoseconds& time, device_serializer::thumbnail& result) override;
+        device_serializer::nanoseconds query_duration() const override;
+        void reset() override;
+        void enable_stream(const std::vector<device_serializer::stream_identifier>& stream_ids) override;
+        void disable_stream(const std::vector<device_serializer::stream_identifier>& stream_ids) override;
+        const std::string& get_file_name() const override;
+
+    private:
+        struct item
+        {
+            std::shared_ptr<device_serializer::serialized_data> data;
+            std::exception_ptr error;
+        };
+
+        void schedule_read_ahead();
+        void read_ahead();
+        void drop_read_ahead(bool rewind);
+
+        std::shared_ptr<device_serializer::reader> m_reader;
+        std::mutex m_reader_mutex;          // Held while m_reader is used, taken before m_mutex
+        mutable std::mutex m_mutex;         // Guards the members below
+        std::condition_variable m_cv;
+        std::deque<item> m_items;
+        uint32_t m_depth;
+        bool m_prefetching;                 // Set by the consumer, cleared on end of file, errors and repositioning
+        bool m_alive;
+        bool m_task_posted;                 // A read of this reader is waiting for or running on the shared threads
+        worker_pool& m_pool;
+    };
+}
@@ -0,0 +1,157 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#include "segmented_reader.h"
+
+using namespace librealsense;
+using namespace device_serializer;
+
+segmented_reader::segmented_reader(const std::string& manifest_path, const std::shared_ptr<context>& ctx) :
+    m_manifest_path(manifest_path),
+    m_context(ctx),
+    m_segments(read_segment_manifest(manifest_path)),
+    m_readers(m_segments.size()),
+    m_current(0)
+{
+    get_segment_reader(0);
+}
+
+device_snapshot segmented_reader::query_device_description(const nanoseconds& time)
+{
+    if (time == get_static_file_info_timestamp())
+    {
+        return get_segment_reader(0)->query_device_description(time);
+    }
+    return get_segment_reader(find_segment(time))->query_device_description(time);
+}
+
+std::shared_ptr<serialized_data> segmented_reader::read_next_data()
+{
+    while (true)
+    {
+        auto data = get_segment_reader(m_current)->read_next_data();
+        if (!data->is<serialized_end_of_file>() || m_current + 1 >= m_segments.size())
+        {
+            return data;
+        }
+        LOG_DEBUG("End of segment " << m_current << ", continuing with " << m_segments[m_current + 1].file);
+        open_segment(m_current + 1);
+    }
+}
+
+void segmented_reader::seek_to_time(const nanoseconds& time)
+{
+    if (time > query_duration())
+    {
+        throw invalid_value_exception(to_string() << "Requested time is out of playback length. (Requested = " << time.count() << ", Duration = " << query_duration().count() << ")");
+    }
+
+    auto index = find_segment(time);
+    //A time between two segments plays the next one from its start
+    if (time > m_segments[index].end && index + 1 < m_segments.size())
+    {
+        open_segment(index + 1);
+        return;
+    }
+    if (index != m_current)
+    {
+        open_segment(index);
+    }
+    get_segment_reader(index)->seek_to_time(time);
+}
+
+uint64_t segmented_reader::query_frame_count(const stream_identifier& stream_id)
+{
+    uint64_t count = 0;
+    for (size_t i = 0; i < m_segments.size(); i++)
+    {
+        count += get_segment_reader(i)->query_frame_count(stream_id);
+    }
+    return count;
+}
+
+nanoseconds segmented_reader::query_frame_time(const stream_identifier& stream_id, uint64_t frame)
+{
+    auto remaining = frame;
+    for (size_t i = 0; i < m_segments.size(); i++)
+    {
+        auto reader = get_segment_reader(i);
+        auto count = reader->query_frame_count(stream_id);
+        if (remaining < count)
+        {
+            return reader->query_frame_time(stream_id, remaining);
+        }
+        remaining -= count;
+    }
+    throw invalid_value_exception(to_string() << "Requested frame " << frame << " is out of the " << frame - remaining << " frames of stream " << stream_id);
+}
+
+bool segmented_reader::query_thumbnail(const stream_identifier& stream_id, const nanoseconds& time, thumbnail& result)
+{
+    //Segments keep the times of the whole recording
+    return get_segment_reader(find_segment(time))->query_thumbnail(stream_id, time, result);
+}
+
+nanoseconds segmented_reader::query_duration() const
+{
+    return m_segments.back().end - m_segments.front().start;
+}
+
+void segmented_reader::reset()
+{
+    m_enabled_streams.clear();
+    open_segment(0);
+}
+
+void segmented_reader::enable_stream(const std::vector<stream_identifier>& stream_ids)
+{
+    for (auto&& id : stream_ids)
+    {
+        if (std::find(m_enabled_streams.begin(), m_enabled_streams.end(), id) == m_enabled_streams.end())
+            m_enabled_streams.push_back(id);
+    }
+    get_segment_reader(m_current)->enable_stream(stream_ids);
+}
+
+void segmented_reader::disable_stream(const std::vector<stream_identifier>& stream_ids)
+{
+    for (auto&& id : stream_ids)
+    {
+        m_enabled_streams.erase(std::remove(m_enabled_streams.begin(), m_enabled_streams.end(), id), m_enabled_streams.end());
+    }
+    get_segment_reader(m_current)->disable_stream(stream_ids);
+}
+
+const std::string& segmented_reader::get_file_name() const
+{
+    return m_manifest_path;
+}
+
+size_t segmented_reader::find_segment(const nanoseconds& time) const
+{
+    //Last segment starting at or before the time
+    auto it = std::upper_bound(m_segments.begin(), m_segments.end(), time, [](const nanoseconds& t, const recording_segment& s) { return t < s.start; });
+    return it == m_segments.begin() ? 0 : static_cast<size_t>(std::distance(m_segments.begin(), it) - 1);
+}
+
+std::shared_ptr<ros_reader> segmented_reader::get_segment_reader(size_t index)
+{
+    auto&& reader = m_readers.at(index);
+    if (!reader)
+    {
+        reader = std::make_shared<ros_reader>(m_segments[index].file, m_context);
+    }
+    return reader;
+}
+
+void segmented_reader::open_segment(size_t index)
+{
+    //Segments start reading from their beginning, with the streams that are played
+    auto reader = get_segment_reader(index);
+    reader->reset();
+    if (!m_enabled_streams.empty())
+    {
+        reader->enable_stream(m_enabled_streams);
+    }
+    m_current = index;
+}
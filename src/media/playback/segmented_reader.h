@@ -0,0 +1,43 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "media/ros/ros_reader.h"
+#include "media/ros/segment_manifest.h"
+
+namespace librealsense
+{
+    // Plays the segments of a segmented recording as one timeline
+    // Opening reads only the manifest and the first segment, the other segments are opened when the playback
+    // reaches them, so the time to open does not grow with the length of the recording
+    class segmented_reader : public device_serializer::reader
+    {
+    public:
+        segmented_reader(const std::string& manifest_path, const std::shared_ptr<context>& ctx);
+
+        device_serializer::device_snapshot query_device_description(const device_serializer::nanoseconds& time) override;
+        std::shared_ptr<device_serializer::serialized_data> read_next_data() override;
+        void seek_to_time(const device_serializer::nanoseconds& time) override;
+        uint64_t query_frame_count(const device_serializer::stream_identifier& stream_id) override;
+        device_serializer::nanoseconds query_frame_time(const device_serializer::stream_identifier& stream_id, uint64_t frame) override;
+        bool query_thumbnail(const device_serializer::stream_identifier& stream_id, const device_serializer::nanoseconds& time, device_serializer::thumbnail& result) override;
+        device_serializer::nanoseconds query_duration() const override;
+        void reset() override;
+        void enable_stream(const std::vector<device_serializer::stream_identifier>& stream_ids) override;
+        void disable_stream(const std::vector<device_serializer::stream_identifier>& stream_ids) override;
+        const std::string& get_file_name() const override;
+
+    private:
+        size_t find_segment(const device_serializer::nanoseconds& time) const;
+        std::shared_ptr<ros_reader> get_segment_reader(size_t index);
+        void open_segment(size_t index);
+
+        std::string m_manifest_path;
+        std::shared_ptr<context> m_context;
+        std::vector<recording_segment> m_segments;
+        std::vector<std::shared_ptr<ros_reader>> m_readers;     // Opened on first use
+        size_t m_current;
+        std::vector<device_serializer::stream_identifier> m_enabled_streams;
+    };
+}
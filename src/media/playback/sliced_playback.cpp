@@ -0,0 +1,170 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#include "sliced_playback.h"
+#include "playback_device.h"
+#include "segmented_reader.h"
+#include "media/ros/ros_reader.h"
+#include "media/native/native_reader.h"
+#include "threading.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <thread>
+
+using namespace librealsense;
+using namespace device_serializer;
+
+sliced_playback::sliced_playback(std::shared_ptr<context> ctx, const std::string& file, int slices, nanoseconds warm_up) :
+    _context(ctx),
+    _file(file),
+    _slices(slices),
+    _warm_up(warm_up)
+{
+    if (slices < 1)
+    {
+        throw invalid_value_exception(to_string() << "Invalid number of slices " << slices);
+    }
+    if (warm_up.count() < 0)
+    {
+        throw invalid_value_exception(to_string() << "Invalid warm-up time " << warm_up.count());
+    }
+}
+
+// Network streams can not be seeked, only files, native and segmented recordings are sliced
+std::shared_ptr<reader> sliced_playback::open_reader() const
+{
+    if (is_segment_manifest(_file))
+        return std::make_shared<segmented_reader>(_file, _context);
+    if (is_native_recording(_file))
+        return std::make_shared<native_reader>(_file, _context);
+    return std::make_shared<ros_reader>(_file, _context);
+}
+
+void sliced_playback::run(process_callback process, result_callback on_result, result_callback release)
+{
+    struct slice_results
+    {
+        std::deque<void*> results;
+        bool done = false;
+    };
+
+    auto first_reader = open_reader();
+    auto duration = first_reader->query_duration();
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<slice_results> slices(_slices);
+    std::exception_ptr error;
+    std::atomic<bool> abort(false);
+
+    auto fail = [&](std::exception_ptr e)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!error) error = e;
+        abort = true;
+        cv.notify_all();
+    };
+
+    std::vector<std::thread> workers;
+    for (int i = 0; i < _slices; i++)
+    {
+        auto reader = i == 0 ? first_reader : nullptr;
+        workers.emplace_back([&, i, reader]()
+        {
+            thread_registration registration("rs-playback-slice", RS2_THREAD_CLASS_PROCESSING);
+            try
+            {
+                auto dev = std::make_shared<playback_device>(_context, reader ? reader : open_reader());
+                std::vector<sensor_interface*> opened;
+                for (size_t s = 0; s < dev->get_sensors_count(); s++)
+                {
+                    auto&& sensor = dev->get_sensor(s);
+                    auto profiles = sensor.get_stream_profiles();
+                    if (profiles.empty()) continue;
+                    sensor.open(profiles);
+                    opened.push_back(&sensor);
+                }
+
+                auto begin = duration * i / _slices;
+                auto end = duration * (i + 1) / _slices;
+                auto start = begin > _warm_up ? begin - _warm_up : nanoseconds(0);
+                if (start.count() > 0)
+                    dev->seek_to_time(start);
+
+                while (!abort)
+                {
+                    auto frameset = dev->next_frameset();
+                    if (!frameset) break;
+
+                    // A frameset belongs to the slice in which its last frame was recorded
+                    auto position = nanoseconds(dev->get_position());
+                    if (i + 1 < _slices && position >= end) break;
+
+                    auto warm_up = position < begin;
+                    auto result = process(i, std::move(frameset), warm_up);
+                    if (!result) continue;
+                    if (warm_up)
+                    {
+                        release(result);
+                        continue;
+                    }
+
+                    std::lock_guard<std::mutex> lock(mutex);
+                    slices[i].results.push_back(result);
+                    cv.notify_all();
+                }
+
+                for (auto sensor : opened)
+                    sensor->close();
+            }
+            catch (...)
+            {
+                fail(std::current_exception());
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            slices[i].done = true;
+            cv.notify_all();
+        });
+    }
+
+    for (auto&& slice : slices)
+    {
+        while (true)
+        {
+            void* result = nullptr;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cv.wait(lock, [&]() { return abort || !slice.results.empty() || slice.done; });
+                if (abort || slice.results.empty()) break;
+                result = slice.results.front();
+                slice.results.pop_front();
+            }
+
+            try
+            {
+                on_result(result);
+            }
+            catch (...)
+            {
+                fail(std::current_exception());
+                break;
+            }
+        }
+        if (abort) break;
+    }
+
+    for (auto&& worker : workers)
+        worker.join();
+
+    for (auto&& slice : slices)
+    {
+        for (auto result : slice.results)
+            release(result);
+    }
+
+    if (error)
+        std::rethrow_exception(error);
+}
@@ -0,0 +1,41 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "archive.h"
+#include <core/serialization.h>
+
+#include <functional>
+
+namespace librealsense
+{
+    class context;
+
+    // Processes one recording on several threads, splitting its duration into equal time slices. Every slice is
+    // played by its own playback device and reader, seeked through the index of the file, and its framesets are
+    // pulled in file order and handed to process with the index of the slice, so that each slice keeps its own
+    // processing chain. The framesets of the warm-up before a slice, which feed the history of filters such as the
+    // temporal filter and let the frames match into sets again, are processed with warm_up set and give no result
+    // Results are handed to on_result on the calling thread in the order of the recording. Those of later slices
+    // wait for the earlier slices to be delivered, and are dropped through release when processing fails
+    class sliced_playback
+    {
+    public:
+        typedef std::function<void*(int slice, frame_holder frameset, bool warm_up)> process_callback;
+        typedef std::function<void(void* result)> result_callback;
+
+        sliced_playback(std::shared_ptr<context> ctx, const std::string& file, int slices, device_serializer::nanoseconds warm_up);
+
+        // Blocks until the whole recording is processed, and throws the first error of the slices
+        void run(process_callback process, result_callback on_result, result_callback release);
+
+    private:
+        std::shared_ptr<device_serializer::reader> open_reader() const;
+
+        std::shared_ptr<context> _context;
+        std::string _file;
+        int _slices;
+        device_serializer::nanoseconds _warm_up;
+    };
+}
@@ -9,10 +9,21 @@
 using namespace device_serializer;
 
 librealsense::record_device::record_device(std::shared_ptr<librealsense::device_interface> device,
-                                      std::shared_ptr<librealsense::device_serializer::writer> serializer):
-    m_write_thread([](){return std::make_shared<dispatcher>(std::numeric_limits<unsigned int>::max());}),
+                                      std::shared_ptr<librealsense::device_serializer::writer> serializer,
+                                      bool native_formats):
+    m_write_thread([](){return std::make_shared<dispatcher>(std::numeric_limits<unsigned int>::max(), "rs-record", RS2_THREAD_CLASS_IO);}),
     m_is_recording(true),
-    m_record_pause_time(0)
+    m_record_pause_time(0),
+    m_default_queue_policy(RS2_QUEUE_POLICY_DROP_NEWEST),
+    m_max_queued_bytes(MAX_CACHED_DATA_SIZE),
+    m_queued_bytes(0),
+    m_written_frames(0),
+    m_dropped_frames(0),
+    m_accepting_frames(true),
+    m_rate_window_bytes(0),
+    m_rate_window_start(std::chrono::steady_clock::now()),
+    m_write_rate(0),
+    m_options_write_scheduled(false)
 {
     if (device == nullptr)
     {
@@ -26,12 +37,12 @@ librealsense::record_device::record_device(std::shared_ptr<librealsense::device_
 
     m_device = device;
     m_ros_writer = serializer;
-    m_sensors = create_record_sensors(m_device);
+    m_sensors = create_record_sensors(m_device, native_formats);
     (*m_write_thread)->start();
     LOG_DEBUG("Created record_device");
 }
 
-std::vector<std::shared_ptr<record_sensor>> record_device::create_record_sensors(std::shared_ptr<device_interface> device)
+std::vector<std::shared_ptr<record_sensor>> record_device::create_record_sensors(std::shared_ptr<device_interface> device, bool native_formats)
 {
     std::vector<std::shared_ptr<record_sensor>> record_sensors;
     for (size_t sensor_index = 0; sensor_index < device->get_sensors_count(); sensor_index++)
@@ -47,7 +58,7 @@ std::vector<std::shared_ptr<record_sensor>> record_device::create_record_sensors
             write_sensor_extension_snapshot(sensor_index, ext, snapshot, on_error);
         };
 
-        auto recording_sensor = std::make_shared<record_sensor>(*this, live_sensor, sensor_frame_handler, sensor_snapshot_changes_handler);
+        auto recording_sensor = std::make_shared<record_sensor>(*this, live_sensor, sensor_frame_handler, sensor_snapshot_changes_handler, native_formats);
         record_sensors.emplace_back(recording_sensor);
     }
     return record_sensors;
@@ -55,6 +66,13 @@ std::vector<std::shared_ptr<record_sensor>> record_device::create_record_sensors
 
 librealsense::record_device::~record_device()
 {
+    {
+        // Release the sensors blocked on a full queue
+        std::lock_guard<std::mutex> lock(m_queue_mutex);
+        m_accepting_frames = false;
+    }
+    m_queue_cv.notify_all();
+
     if((*m_write_thread)->flush() == false)
     {
         LOG_ERROR("Error - timeout waiting for flush, possible deadlock detected");
@@ -117,23 +135,25 @@ void librealsense::record_device::write_data(size_t sensor_index, librealsense::
         initialize_recording();
     });
 
-    //TODO: restore: uint64_t data_size = frame.frame->get_frame_data_size();
-    uint64_t cached_data_size = m_cached_data_size; //TODO: restore: (+ data_size)
-    if (cached_data_size > MAX_CACHED_DATA_SIZE)
+    auto stream = frame.frame->get_stream()->get_stream_type();
+    auto entry = std::make_shared<queued_frame>();
+    if (!enqueue_frame(entry, stream, std::move(frame)))
     {
         LOG_WARNING("Recorder reached maximum cache size, frame dropped");
         on_error("Recorder reached maximum cache size, frame dropped");
         return;
     }
 
-    m_cached_data_size = cached_data_size;
     auto capture_time = get_capture_time();
-    //TODO: remove usage of shared pointer when frame_holder is copyable
-    auto frame_holder_ptr = std::make_shared<frame_holder>();
-    *frame_holder_ptr = std::move(frame);
-    (*m_write_thread)->invoke([this, frame_holder_ptr, sensor_index, capture_time/*, data_size*/, on_error](dispatcher::cancellable_timer t) {
+    (*m_write_thread)->invoke([this, entry, stream, sensor_index, capture_time, on_error](dispatcher::cancellable_timer t) {
+        auto f = dequeue_frame(entry, stream);
+        if (!f)
+        {
+            return; //Dropped to make room for newer frames
+        }
         if (m_is_recording == false)
         {
+            on_frame_done(entry->size, false);
             return; //Recording is paused
         }
         std::call_once(m_first_frame_flag, [&]()
@@ -152,18 +172,142 @@ void librealsense::record_device::write_data(size_t sensor_index, librealsense::
         try
         {
             const uint32_t device_index = 0;
-            auto stream_type = frame_holder_ptr->frame->get_stream()->get_stream_type();
-            auto stream_index = static_cast<uint32_t>(frame_holder_ptr->frame->get_stream()->get_stream_index());
-            m_ros_writer->write_frame({ device_index, static_cast<uint32_t>(sensor_index), stream_type, stream_index }, capture_time, std::move(*frame_holder_ptr));
-            //TODO: restore: std::lock_guard<std::mutex> locker(m_mutex);  m_cached_data_size -= data_size;
+            auto stream_index = static_cast<uint32_t>(f.frame->get_stream()->get_stream_index());
+            m_ros_writer->write_frame({ device_index, static_cast<uint32_t>(sensor_index), stream, stream_index }, capture_time, std::move(f));
+            on_frame_done(entry->size, true);
         }
         catch(std::exception& e)
         {
+            on_frame_done(entry->size, false);
             on_error(to_string() << "Failed to write frame. " << e.what());
         }
     });
 }
 
+bool librealsense::record_device::enqueue_frame(const std::shared_ptr<queued_frame>& entry, rs2_stream stream, frame_holder frame)
+{
+    auto size = static_cast<uint64_t>(frame.frame->get_frame_data_size());
+    std::vector<frame_holder> dropped; // Released once the queue is unlocked
+    std::unique_lock<std::mutex> lock(m_queue_mutex);
+
+    auto it = m_queue_policies.find(stream);
+    auto policy = it != m_queue_policies.end() ? it->second : m_default_queue_policy;
+    auto fits = [&]() { return m_queued_bytes == 0 || m_queued_bytes + size <= m_max_queued_bytes; };
+    auto&& queued = m_queued_frames[stream];
+
+    if (!fits())
+    {
+        switch (policy)
+        {
+        case RS2_QUEUE_POLICY_BLOCK:
+            // Slow the sensor down to the throughput of the disk
+            m_queue_cv.wait(lock, [&]() { return !m_accepting_frames || fits(); });
+            break;
+        case RS2_QUEUE_POLICY_DROP_OLDEST:
+            while (!fits() && !queued.empty())
+            {
+                auto oldest = queued.front();
+                queued.pop_front();
+                dropped.push_back(std::move(oldest->frame));
+                m_queued_bytes -= oldest->size;
+                m_dropped_frames++;
+            }
+            break;
+        default:
+            break;
+        }
+
+        if (!fits())
+        {
+            m_dropped_frames++;
+            return false;
+        }
+    }
+
+    entry->frame = std::move(frame);
+    entry->size = size;
+    queued.push_back(entry);
+    m_queued_bytes += size;
+    return true;
+}
+
+librealsense::frame_holder librealsense::record_device::dequeue_frame(const std::shared_ptr<queued_frame>& entry, rs2_stream stream)
+{
+    std::lock_guard<std::mutex> lock(m_queue_mutex);
+    if (!entry->frame)
+        return{};
+
+    // The frames of a stream are written in the order they were queued
+    auto&& queued = m_queued_frames[stream];
+    if (!queued.empty() && queued.front() == entry)
+        queued.pop_front();
+    return std::move(entry->frame);
+}
+
+void librealsense::record_device::on_frame_done(uint64_t size, bool written)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_queue_mutex);
+        m_queued_bytes -= size;
+        if (written)
+        {
+            m_written_frames++;
+            m_rate_window_bytes += size;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        std::chrono::duration<float> elapsed = now - m_rate_window_start;
+        if (elapsed.count() >= 1.f)
+        {
+            m_write_rate = m_rate_window_bytes / elapsed.count() / 1e6f;
+            m_rate_window_bytes = 0;
+            m_rate_window_start = now;
+        }
+    }
+    m_queue_cv.notify_all();
+}
+
+void librealsense::record_device::set_queue_limit(uint64_t max_bytes)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_queue_mutex);
+        m_max_queued_bytes = max_bytes;
+    }
+    m_queue_cv.notify_all();
+}
+
+void librealsense::record_device::set_queue_policy(rs2_stream stream, rs2_queue_policy policy)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_queue_mutex);
+        if (stream == RS2_STREAM_ANY)
+        {
+            m_default_queue_policy = policy;
+            m_queue_policies.clear();
+        }
+        else
+        {
+            m_queue_policies[stream] = policy;
+        }
+    }
+    m_queue_cv.notify_all();
+}
+
+rs2_record_stats librealsense::record_device::get_stats() const
+{
+    std::lock_guard<std::mutex> lock(m_queue_mutex);
+    rs2_record_stats stats;
+    stats.queued_bytes = m_queued_bytes;
+    stats.max_queued_bytes = m_max_queued_bytes;
+    stats.written_frames = m_written_frames;
+    stats.dropped_frames = m_dropped_frames;
+
+    // Once writing stalls for longer than a window, the rate of the current one is the relevant one
+    std::chrono::duration<float> elapsed = std::chrono::steady_clock::now() - m_rate_window_start;
+    stats.write_rate = elapsed.count() < 2.f ? m_write_rate : m_rate_window_bytes / elapsed.count() / 1e6f;
+    return stats;
+}
+
 const std::string& librealsense::record_device::get_info(rs2_camera_info info) const
 {
     //info has no setter, it does not change - nothing to record
@@ -243,6 +387,8 @@ snapshot_collection librealsense::record_device::get_extensions_snapshots(T* ext
             case RS2_EXTENSION_POINTS          : break;
             case RS2_EXTENSION_RECORD          : break;
             case RS2_EXTENSION_PLAYBACK        : break;
+            case RS2_EXTENSION_SOFTWARE_DEVICE : break;
+            case RS2_EXTENSION_SOFTWARE_SENSOR : break;
             case RS2_EXTENSION_COUNT           : break;
             case RS2_EXTENSION_UNKNOWN         : break;
             default:
@@ -283,6 +429,9 @@ void record_device::write_sensor_extension_snapshot(size_t sensor_index,
     const std::shared_ptr<extension_snapshot>& snapshot,
     std::function<void(std::string const&)> on_error)
 {
+    if (ext == RS2_EXTENSION_OPTIONS && coalesce_option_change(sensor_index, snapshot, on_error))
+        return;
+
     auto capture_time = get_capture_time();
     (*m_write_thread)->invoke([this, sensor_index, capture_time, ext, snapshot, on_error](dispatcher::cancellable_timer t)
     {
@@ -298,6 +447,73 @@ void record_device::write_sensor_extension_snapshot(size_t sensor_index,
     });
 }
 
+// Changes of a single option are kept as the latest value per option until the write thread gets to them,
+// so a burst of changes, such as auto exposure updating every frame, costs one message per option
+bool record_device::coalesce_option_change(size_t sensor_index,
+    const std::shared_ptr<extension_snapshot>& snapshot,
+    std::function<void(std::string const&)> on_error)
+{
+    auto options = As<options_interface>(snapshot);
+    if (!options)
+        return false;
+
+    rs2_option id = RS2_OPTION_COUNT;
+    for (int i = 0; i < static_cast<int>(RS2_OPTION_COUNT); i++)
+    {
+        if (!options->supports_option(static_cast<rs2_option>(i)))
+            continue;
+        if (id != RS2_OPTION_COUNT)
+            return false;
+        id = static_cast<rs2_option>(i);
+    }
+    if (id == RS2_OPTION_COUNT)
+        return false;
+
+    pending_option change{ get_capture_time(), snapshot, options->get_option(id).query(), on_error };
+    {
+        std::lock_guard<std::mutex> lock(m_options_mutex);
+        m_pending_options[option_key(sensor_index, id)] = std::move(change);
+        if (m_options_write_scheduled)
+            return true;
+        m_options_write_scheduled = true;
+    }
+
+    (*m_write_thread)->invoke([this](dispatcher::cancellable_timer t)
+    {
+        write_pending_options();
+    });
+    return true;
+}
+
+void record_device::write_pending_options()
+{
+    std::map<option_key, pending_option> pending;
+    {
+        std::lock_guard<std::mutex> lock(m_options_mutex);
+        pending.swap(m_pending_options);
+        m_options_write_scheduled = false;
+    }
+
+    for (auto&& kvp : pending)
+    {
+        // Values set again to what was last written add nothing to the file
+        auto written = m_written_option_values.find(kvp.first);
+        if (written != m_written_option_values.end() && written->second == kvp.second.value)
+            continue;
+
+        try
+        {
+            const uint32_t device_index = 0;
+            m_ros_writer->write_snapshot({ device_index, static_cast<uint32_t>(kvp.first.first) }, kvp.second.time, RS2_EXTENSION_OPTIONS, kvp.second.snapshot);
+            m_written_option_values[kvp.first] = kvp.second.value;
+        }
+        catch (const std::exception& e)
+        {
+            kvp.second.on_error(e.what());
+        }
+    }
+}
+
 template <rs2_extension E, typename P>
 bool librealsense::record_device::extend_to_aux(std::shared_ptr<P> p, void** ext)
 {
@@ -400,7 +616,6 @@ void record_device::initialize_recording()
 {
     //Expected to be called once when recording to file actually starts
     m_capture_time_base = std::chrono::high_resolution_clock::now();
-    m_cached_data_size = 0;
 }
 void record_device::stop_gracefully(to_string error_msg)
 {
@@ -2,6 +2,7 @@
 // Copyright(c) 2017 Intel Corporation. All Rights Reserved.
 
 #pragma once
+#include <deque>
 #include <core/roi.h>
 #include <core/extension.h>
 #include <core/serialization.h>
@@ -20,7 +21,8 @@ namespace librealsense
     public:
         static const uint64_t MAX_CACHED_DATA_SIZE = 1920 * 1080 * 4 * 30; // ~1 sec of HD video @ 30 FPS
 
-        record_device(std::shared_ptr<device_interface> device, std::shared_ptr<device_serializer::writer> serializer);
+        record_device(std::shared_ptr<device_interface> device, std::shared_ptr<device_serializer::writer> serializer,
+                      bool native_formats = false);
         virtual ~record_device();
 
         std::shared_ptr<context> get_context() const override;
@@ -38,19 +40,46 @@ namespace librealsense
 
         void pause_recording();
         void resume_recording();
+
+        // Bound the bytes of frames waiting to be written. A frame arriving while the limit is reached is handled
+        // by the queue policy of its stream type, RS2_STREAM_ANY setting the policy of all of them
+        void set_queue_limit(uint64_t max_bytes);
+        void set_queue_policy(rs2_stream stream, rs2_queue_policy policy);
+        rs2_record_stats get_stats() const;
         platform::backend_device_group get_device_data() const override;
         std::pair<uint32_t, rs2_extrinsics> get_extrinsics(const stream_interface& stream) const override;
         bool is_valid() const override;
 
     private:
+        struct queued_frame
+        {
+            frame_holder frame;     // Released when dropped to make room for newer frames of its stream
+            uint64_t size;
+        };
+
+        // Latest change of an option that the write thread has not reached yet
+        struct pending_option
+        {
+            std::chrono::nanoseconds time;
+            std::shared_ptr<extension_snapshot> snapshot;
+            float value;
+            std::function<void(std::string const&)> on_error;
+        };
+        typedef std::pair<size_t, rs2_option> option_key;   // Sensor index and option
+
         template <typename T> void write_device_extension_changes(const T& ext);
         template <rs2_extension E, typename P> bool extend_to_aux(std::shared_ptr<P> p, void** ext);
 
         void write_header();
         std::chrono::nanoseconds get_capture_time() const;
         void write_data(size_t sensor_index, frame_holder f, std::function<void(std::string const&)> on_error);
+        bool enqueue_frame(const std::shared_ptr<queued_frame>& entry, rs2_stream stream, frame_holder frame);
+        frame_holder dequeue_frame(const std::shared_ptr<queued_frame>& entry, rs2_stream stream);
+        void on_frame_done(uint64_t size, bool written);
         void write_sensor_extension_snapshot(size_t sensor_index, rs2_extension ext, const std::shared_ptr<extension_snapshot>& snapshot, std::function<void(std::string const&)> on_error);
-        std::vector<std::shared_ptr<record_sensor>> create_record_sensors(std::shared_ptr<device_interface> m_device);
+        bool coalesce_option_change(size_t sensor_index, const std::shared_ptr<extension_snapshot>& snapshot, std::function<void(std::string const&)> on_error);
+        void write_pending_options();
+        std::vector<std::shared_ptr<record_sensor>> create_record_sensors(std::shared_ptr<device_interface> m_device, bool native_formats);
         template <typename T> device_serializer::snapshot_collection get_extensions_snapshots(T* extendable);
         template <typename T, typename Ext> void try_add_snapshot(T* extendable, device_serializer::snapshot_collection& snapshots);
         std::shared_ptr<device_interface> m_device;
@@ -67,7 +96,25 @@ namespace librealsense
         bool m_is_recording;
         std::once_flag m_first_frame_flag;
 
-        uint64_t m_cached_data_size;
+        mutable std::mutex m_queue_mutex;
+        std::condition_variable m_queue_cv;
+        std::map<rs2_stream, std::deque<std::shared_ptr<queued_frame>>> m_queued_frames;
+        std::map<rs2_stream, rs2_queue_policy> m_queue_policies;
+        rs2_queue_policy m_default_queue_policy;
+        uint64_t m_max_queued_bytes;
+        uint64_t m_queued_bytes;
+        unsigned long long m_written_frames;
+        unsigned long long m_dropped_frames;
+        bool m_accepting_frames;
+        uint64_t m_rate_window_bytes;       // Bytes written since the rate window started
+        std::chrono::steady_clock::time_point m_rate_window_start;
+        float m_write_rate;                 // Megabytes per second over the last complete window
+
+        std::mutex m_options_mutex;
+        std::map<option_key, pending_option> m_pending_options;
+        bool m_options_write_scheduled;
+        std::map<option_key, float> m_written_option_values;    // Used by the write thread only
+
         std::once_flag m_first_call_flag;
         void initialize_recording();
         void stop_gracefully(to_string error_msg);
@@ -8,14 +8,16 @@
 librealsense::record_sensor::record_sensor(const device_interface& device,
                                             sensor_interface& sensor,
                                             frame_interface_callback_t on_frame,
-                                            snapshot_callback_t on_snapshot) :
+                                            snapshot_callback_t on_snapshot,
+                                            bool native_formats) :
     m_device_record_snapshot_handler(on_snapshot),
     m_sensor(sensor),
     m_user_notification_callback(nullptr, [](rs2_notifications_callback* n) {}),
     m_record_callback(on_frame),
     m_is_recording(false),
     m_is_pause(false),
-    m_parent_device(device)
+    m_parent_device(device),
+    m_native_formats(native_formats)
 {
     LOG_DEBUG("Created record_sensor");
 }
@@ -36,6 +38,9 @@ stream_profiles record_sensor::get_stream_profiles() const
 
 void librealsense::record_sensor::open(const stream_profiles& requests)
 {
+    // The live frames are still unpacked for the application, the recording takes the payloads they keep
+    if (auto uvc = dynamic_cast<uvc_sensor*>(&m_sensor))
+        uvc->keep_native_payloads(m_native_formats);
     m_sensor.open(requests);
 
     m_is_recording = true;
@@ -43,7 +48,9 @@ void librealsense::record_sensor::open(const stream_profiles& requests)
     {
         std::shared_ptr<stream_profile_interface> snapshot;
         request->create_snapshot(snapshot);
-        //TODO: handle non video profiles
+        //Motion profiles are written along with their first frame
+        if (!Is<video_stream_profile_interface>(snapshot))
+            continue;
         m_device_record_snapshot_handler(RS2_EXTENSION_VIDEO_PROFILE, std::dynamic_pointer_cast<extension_snapshot>(snapshot), [this](const std::string& err) { stop_with_error(err); });
     }
 }
@@ -51,6 +58,8 @@ void librealsense::record_sensor::open(const stream_profiles& requests)
 void librealsense::record_sensor::close()
 {
     m_sensor.close();
+    if (auto uvc = dynamic_cast<uvc_sensor*>(&m_sensor))
+        uvc->keep_native_payloads(false);
     m_is_recording = false;
 }
 
@@ -98,6 +107,11 @@ void librealsense::record_sensor::register_notifications_callback(notifications_
     m_sensor.register_notifications_callback(std::move(cb));
 }
 
+void librealsense::record_sensor::set_frame_allocator(frame_allocator_ptr allocator, size_t alignment)
+{
+    m_sensor.set_frame_allocator(allocator, alignment);
+}
+
 void librealsense::record_sensor::start(frame_callback_ptr callback)
 {
     if (m_frame_callback != nullptr)
@@ -109,7 +123,17 @@ void librealsense::record_sensor::start(frame_callback_ptr callback)
 
     auto record_cb = [this, callback](frame_holder frame)
     {
-        record_frame(frame.clone());
+        // Framesets of sensors delivering the streams of a payload together are recorded frame by frame
+        if (auto composite = dynamic_cast<composite_frame*>(frame.frame))
+        {
+            for (size_t i = 0; i < composite->get_embedded_frames_count(); i++)
+            {
+                auto f = composite->get_frame(static_cast<int>(i));
+                f->acquire();
+                record_frame(frame_holder(f));
+            }
+        }
+        else record_frame(frame.clone());
 
         //Raise to user callback
         frame_interface* ref = nullptr;
@@ -24,7 +24,8 @@ namespace librealsense
         record_sensor(const device_interface& device,
                       sensor_interface& sensor,
                       frame_interface_callback_t on_frame,
-                      snapshot_callback_t on_snapshot);
+                      snapshot_callback_t on_snapshot,
+                      bool native_formats = false);
         virtual ~record_sensor();
 
         stream_profiles get_stream_profiles() const override;
@@ -36,6 +37,7 @@ namespace librealsense
         bool supports_info(rs2_camera_info info) const override;
         bool supports_option(rs2_option id) const override;
         void register_notifications_callback(notifications_callback_ptr callback) override;
+        void set_frame_allocator(frame_allocator_ptr allocator, size_t alignment) override;
         void start(frame_callback_ptr callback) override;
         void stop() override;
         bool is_streaming() const override;
@@ -59,7 +61,7 @@ namespace librealsense
         bool m_is_pause;
         frame_callback_ptr m_frame_callback;
         const device_interface& m_parent_device;
-
+        bool m_native_formats;
     };
 
     class notification_callback : public rs2_notifications_callback
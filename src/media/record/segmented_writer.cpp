@@ -0,0 +1,127 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#include "segmented_writer.h"
+
+using namespace librealsense;
+using namespace device_serializer;
+
+segmented_writer::segmented_writer(const std::string& manifest_path, const record_settings& settings) :
+    m_manifest_path(manifest_path),
+    m_settings(settings),
+    m_segment_has_frames(false)
+{
+    start_segment(nanoseconds(0));
+}
+
+segmented_writer::~segmented_writer()
+{
+    try
+    {
+        close_segment();
+    }
+    catch (const std::exception& e)
+    {
+        LOG_ERROR("Failed to close recording segment: " << e.what());
+    }
+}
+
+void segmented_writer::write_device_description(const device_snapshot& device_description)
+{
+    m_device_description.reset(new device_snapshot(device_description));
+    m_writer->write_device_description(device_description);
+}
+
+void segmented_writer::write_frame(const stream_identifier& stream_id, const nanoseconds& timestamp, frame_holder&& frame)
+{
+    if (should_start_segment(timestamp))
+    {
+        close_segment();
+        start_segment(timestamp);
+    }
+
+    if (!m_segment_has_frames)
+    {
+        m_segment.start = timestamp;
+        m_segment_has_frames = true;
+    }
+    m_segment.end = std::max(m_segment.end, timestamp);
+    m_writer->write_frame(stream_id, timestamp, std::move(frame));
+}
+
+void segmented_writer::write_snapshot(uint32_t device_index, const nanoseconds& timestamp, rs2_extension type, const std::shared_ptr<extension_snapshot>& snapshot)
+{
+    keep_snapshot(device_index, static_cast<uint32_t>(-1), true, type, snapshot);
+    m_writer->write_snapshot(device_index, timestamp, type, snapshot);
+}
+
+void segmented_writer::write_snapshot(const sensor_identifier& sensor_id, const nanoseconds& timestamp, rs2_extension type, const std::shared_ptr<extension_snapshot>& snapshot)
+{
+    keep_snapshot(sensor_id.device_index, sensor_id.sensor_index, false, type, snapshot);
+    m_writer->write_snapshot(sensor_id, timestamp, type, snapshot);
+}
+
+const std::string& segmented_writer::get_file_name() const
+{
+    return m_manifest_path;
+}
+
+bool segmented_writer::should_start_segment(const nanoseconds& timestamp) const
+{
+    //A segment holds at least one frame, so oversized frames do not produce empty segments
+    if (!m_segment_has_frames)
+        return false;
+
+    if (m_settings.segment_size > 0 && m_writer->get_file_size() >= m_settings.segment_size)
+        return true;
+
+    return m_settings.segment_duration.count() > 0 && timestamp - m_segment.start >= m_settings.segment_duration;
+}
+
+void segmented_writer::start_segment(const nanoseconds& timestamp)
+{
+    auto index = static_cast<uint32_t>(m_segments.size());
+    m_segment = { get_segment_path(m_manifest_path, index), timestamp, timestamp };
+    m_segment_has_frames = false;
+    m_writer.reset(new ros_writer(m_segment.file, m_settings));
+
+    if (index == 0)
+        return;
+
+    //Later segments repeat the state recorded so far, as of the time they start at
+    if (m_device_description)
+    {
+        m_writer->write_device_description(*m_device_description);
+    }
+    for (auto&& kept : m_snapshots)
+    {
+        auto type = std::get<2>(kept.first);
+        if (kept.second.is_device)
+            m_writer->write_snapshot(kept.second.device_index, timestamp, type, kept.second.snapshot);
+        else
+            m_writer->write_snapshot({ kept.second.device_index, kept.second.sensor_index }, timestamp, type, kept.second.snapshot);
+    }
+}
+
+void segmented_writer::close_segment()
+{
+    //Closing the bag writes its index, only then the segment can be played
+    m_writer.reset();
+    if (m_segment_has_frames || m_segments.empty())
+    {
+        m_segments.push_back(m_segment);
+    }
+    write_segment_manifest(m_manifest_path, m_segments);
+}
+
+void segmented_writer::keep_snapshot(uint32_t device_index, uint32_t sensor_index, bool is_device, rs2_extension type, const std::shared_ptr<extension_snapshot>& snapshot)
+{
+    auto stream = RS2_STREAM_ANY;
+    int stream_index = 0;
+    if (auto profile = As<stream_profile_interface>(snapshot))
+    {
+        stream = profile->get_stream_type();
+        stream_index = profile->get_stream_index();
+    }
+    m_snapshots[std::make_tuple(device_index, sensor_index, type, stream, stream_index)] = { device_index, sensor_index, is_device, snapshot };
+}
@@ -0,0 +1,55 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include <map>
+#include <tuple>
+#include "media/ros/ros_writer.h"
+#include "media/ros/segment_manifest.h"
+
+namespace librealsense
+{
+    // Writes a recording as a sequence of bag files, continuing in a new file once the current one reaches
+    // the segment size or duration of the settings. Each segment is a complete recording of its own part of
+    // the timeline: it starts with the device description and the latest snapshots written before it.
+    // The manifest is rewritten whenever a segment is closed, so an interrupted recording loses only its last segment
+    class segmented_writer : public device_serializer::writer
+    {
+    public:
+        segmented_writer(const std::string& manifest_path, const device_serializer::record_settings& settings);
+        ~segmented_writer();
+
+        void write_device_description(const device_serializer::device_snapshot& device_description) override;
+        void write_frame(const device_serializer::stream_identifier& stream_id, const device_serializer::nanoseconds& timestamp, frame_holder&& frame) override;
+        void write_snapshot(uint32_t device_index, const device_serializer::nanoseconds& timestamp, rs2_extension type, const std::shared_ptr<extension_snapshot>& snapshot) override;
+        void write_snapshot(const device_serializer::sensor_identifier& sensor_id, const device_serializer::nanoseconds& timestamp, rs2_extension type, const std::shared_ptr<extension_snapshot>& snapshot) override;
+        const std::string& get_file_name() const override;
+
+    private:
+        // Device snapshots are kept with a sensor index of -1, video profiles are kept per stream
+        using snapshot_key = std::tuple<uint32_t, uint32_t, rs2_extension, rs2_stream, int>;
+
+        struct kept_snapshot
+        {
+            uint32_t device_index;
+            uint32_t sensor_index;
+            bool is_device;
+            std::shared_ptr<extension_snapshot> snapshot;
+        };
+
+        bool should_start_segment(const device_serializer::nanoseconds& timestamp) const;
+        void start_segment(const device_serializer::nanoseconds& timestamp);
+        void close_segment();
+        void keep_snapshot(uint32_t device_index, uint32_t sensor_index, bool is_device, rs2_extension type, const std::shared_ptr<extension_snapshot>& snapshot);
+
+        std::string m_manifest_path;
+        device_serializer::record_settings m_settings;
+        std::unique_ptr<ros_writer> m_writer;
+        std::vector<recording_segment> m_segments;      // Closed segments
+        recording_segment m_segment;                    // The segment being written
+        bool m_segment_has_frames;
+        std::unique_ptr<device_serializer::device_snapshot> m_device_description;
+        std::map<snapshot_key, kept_snapshot> m_snapshots;
+    };
+}
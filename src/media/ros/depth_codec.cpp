@@ -0,0 +1,323 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "types.h"
+#include "depth_codec.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace librealsense
+{
+    namespace
+    {
+        const int ESCAPE_LENGTH = 24;       // Unary prefixes this long are followed by the value in raw bits
+        const int PIXEL_RAW_BITS = 16;
+        const int RUN_RAW_BITS = 32;
+        const uint32_t CONTEXT_RESET = 64;  // The statistics of a context are halved every this many values
+        const int ACTIVITY_CONTEXTS = 6;
+
+        inline int count_leading_zeros(uint64_t v)
+        {
+            if (!v) return 64;
+#if defined(_MSC_VER) && defined(_M_X64)
+            unsigned long index;
+            _BitScanReverse64(&index, v);
+            return 63 - static_cast<int>(index);
+#elif defined(__GNUC__)
+            return __builtin_clzll(v);
+#else
+            int n = 0;
+            for (; !(v & (1ull << 63)); v <<= 1) n++;
+            return n;
+#endif
+        }
+
+        class bit_writer
+        {
+        public:
+            explicit bit_writer(std::vector<uint8_t>& out) : _out(out), _bits(0), _count(0) {}
+
+            void put(uint32_t value, int bits)
+            {
+                _bits = (_bits << bits) | value;
+                _count += bits;
+                while (_count >= 8)
+                {
+                    _count -= 8;
+                    _out.push_back(static_cast<uint8_t>(_bits >> _count));
+                }
+            }
+
+            void flush()
+            {
+                if (_count) _out.push_back(static_cast<uint8_t>(_bits << (8 - _count)));
+                _count = 0;
+            }
+
+        private:
+            std::vector<uint8_t>& _out;
+            uint64_t _bits;
+            int _count;
+        };
+
+        class bit_reader
+        {
+        public:
+            bit_reader(const uint8_t* data, size_t size) : _data(data), _size(size), _pos(0), _bits(0), _count(0) {}
+
+            int leading_zeros()
+            {
+                refill();
+                return count_leading_zeros(_bits);
+            }
+
+            void skip(int bits)
+            {
+                _bits <<= bits;
+                _count -= bits;
+            }
+
+            uint32_t get(int bits)
+            {
+                if (!bits) return 0;
+                refill();
+                auto value = static_cast<uint32_t>(_bits >> (64 - bits));
+                skip(bits);
+                return value;
+            }
+
+            // Past its end, the data reads as zeros
+            bool overrun() const { return _pos * 8 - _count > _size * 8; }
+
+        private:
+            void refill()
+            {
+                for (; _count <= 56; _count += 8, _pos++)
+                    _bits |= static_cast<uint64_t>(_pos < _size ? _data[_pos] : 0) << (56 - _count);
+            }
+
+            const uint8_t* _data;
+            size_t _size;
+            size_t _pos;
+            uint64_t _bits;     // Left aligned
+            int _count;
+        };
+
+        // Running mean of the values coded in one context, choosing their Rice parameter
+        struct rice_context
+        {
+            uint32_t sum = 4;
+            uint32_t count = 1;
+
+            int parameter() const
+            {
+                int k = 0;
+                while ((count << k) < sum && k < 16) k++;
+                return k;
+            }
+
+            void update(uint32_t value)
+            {
+                sum += value;
+                if (++count == CONTEXT_RESET)
+                {
+                    sum >>= 1;
+                    count >>= 1;
+                }
+            }
+
+            void encode(bit_writer& out, uint32_t value, int raw_bits)
+            {
+                auto k = parameter();
+                auto q = value >> k;
+                if (q < ESCAPE_LENGTH)
+                {
+                    out.put(1, static_cast<int>(q) + 1);
+                    if (k) out.put(value & ((1u << k) - 1), k);
+                }
+                else
+                {
+                    out.put(0, ESCAPE_LENGTH);
+                    out.put(value, raw_bits);
+                }
+                update(value);
+            }
+
+            uint32_t decode(bit_reader& in, int raw_bits)
+            {
+                auto k = parameter();
+                auto q = in.leading_zeros();
+                uint32_t value;
+                if (q >= ESCAPE_LENGTH)
+                {
+                    in.skip(ESCAPE_LENGTH);
+                    value = in.get(raw_bits);
+                }
+                else
+                {
+                    in.skip(q + 1);
+                    value = (static_cast<uint32_t>(q) << k) | in.get(k);
+                }
+                update(value);
+                return value;
+            }
+        };
+
+        struct codec_state
+        {
+            rice_context activity[ACTIVITY_CONTEXTS];
+            rice_context run;
+        };
+
+        // Left, top and top-left neighbours. Outside of the image, the missing ones repeat the available ones
+        inline void get_neighbours(const uint16_t* row, const uint16_t* prev, uint32_t x, int& a, int& b, int& c)
+        {
+            b = prev ? prev[x] : (x ? row[x - 1] : 0);
+            a = x ? row[x - 1] : b;
+            c = prev && x ? prev[x - 1] : b;
+        }
+
+        // Median edge detector of LOCO-I
+        inline int predict(int a, int b, int c)
+        {
+            if (c >= std::max(a, b)) return std::min(a, b);
+            if (c <= std::min(a, b)) return std::max(a, b);
+            return a + b - c;
+        }
+
+        inline rice_context& activity_context(codec_state& state, int a, int b, int c)
+        {
+            auto d = std::abs(a - c) + std::abs(b - c);
+            int i = d == 0 ? 0 : d <= 2 ? 1 : d <= 8 ? 2 : d <= 32 ? 3 : d <= 128 ? 4 : 5;
+            return state.activity[i];
+        }
+
+        inline void encode_pixel(bit_writer& out, codec_state& state, uint16_t value, int a, int b, int c)
+        {
+            auto residual = static_cast<int16_t>(value - predict(a, b, c));   // Modulo 2^16
+            auto mapped = static_cast<uint16_t>((residual << 1) ^ (residual >> 15));
+            activity_context(state, a, b, c).encode(out, mapped, PIXEL_RAW_BITS);
+        }
+
+        inline uint16_t decode_pixel(bit_reader& in, codec_state& state, int a, int b, int c)
+        {
+            auto mapped = activity_context(state, a, b, c).decode(in, PIXEL_RAW_BITS);
+            auto residual = static_cast<int>(mapped >> 1) ^ -static_cast<int>(mapped & 1);
+            return static_cast<uint16_t>(predict(a, b, c) + residual);
+        }
+
+        // Division by the quantization step as a multiplication by its rounded up reciprocal, in a branchless loop
+        // the compiler vectorizes. Exact while dividend * step < 2^32, so for any pixel with steps below 2^15
+        void quantize(const uint16_t* pixels, uint32_t width, uint32_t height, uint32_t stride, uint16_t tolerance, uint16_t* quantized)
+        {
+            const uint32_t step = 2u * tolerance + 1;
+            const uint64_t reciprocal = ((1ull << 32) + step - 1) / step;
+            for (uint32_t y = 0; y < height; y++)
+            {
+                auto row = reinterpret_cast<const uint16_t*>(reinterpret_cast<const uint8_t*>(pixels) + static_cast<size_t>(y) * stride);
+                auto out = quantized + static_cast<size_t>(y) * width;
+                for (uint32_t x = 0; x < width; x++)
+                    out[x] = static_cast<uint16_t>(((row[x] + tolerance) * reciprocal) >> 32);
+            }
+        }
+
+        void dequantize(uint16_t* pixels, uint32_t width, uint32_t height, uint32_t stride, uint16_t tolerance)
+        {
+            const uint32_t step = 2u * tolerance + 1;
+            for (uint32_t y = 0; y < height; y++)
+            {
+                auto row = reinterpret_cast<uint16_t*>(reinterpret_cast<uint8_t*>(pixels) + static_cast<size_t>(y) * stride);
+                for (uint32_t x = 0; x < width; x++)
+                    row[x] = static_cast<uint16_t>(std::min<uint32_t>(row[x] * step, 0xffff));
+            }
+        }
+    }
+
+    void encode_depth(const uint16_t* pixels, uint32_t width, uint32_t height, uint32_t stride, std::vector<uint8_t>& encoded,
+                      uint16_t tolerance)
+    {
+        if (tolerance)
+        {
+            if (tolerance >= MAX_DEPTH_TOLERANCE)
+                throw invalid_value_exception(to_string() << "Depth tolerance " << tolerance << " is out of range");
+            // Reused by the following frames encoded on the same thread
+            static thread_local std::vector<uint16_t> quantized;
+            quantized.resize(static_cast<size_t>(width) * height);
+            quantize(pixels, width, height, stride, tolerance, quantized.data());
+            encode_depth(quantized.data(), width, height, width * sizeof(uint16_t), encoded);
+            return;
+        }
+
+        encoded.clear();
+        encoded.reserve(static_cast<size_t>(width) * height);
+        bit_writer out(encoded);
+        codec_state state;
+
+        const uint16_t* prev = nullptr;
+        for (uint32_t y = 0; y < height; y++)
+        {
+            auto row = reinterpret_cast<const uint16_t*>(reinterpret_cast<const uint8_t*>(pixels) + static_cast<size_t>(y) * stride);
+            for (uint32_t x = 0; x < width; x++)
+            {
+                int a, b, c;
+                get_neighbours(row, prev, x, a, b, c);
+                if (a == b && b == c)
+                {
+                    // The pixel following an interrupted run is coded regularly, in any context
+                    uint32_t run = 0;
+                    while (x + run < width && row[x + run] == a) run++;
+                    state.run.encode(out, run, RUN_RAW_BITS);
+                    x += run;
+                    if (x == width) break;
+                    get_neighbours(row, prev, x, a, b, c);
+                }
+                encode_pixel(out, state, row[x], a, b, c);
+            }
+            prev = row;
+        }
+        out.flush();
+    }
+
+    void decode_depth(const uint8_t* encoded, size_t size, uint32_t width, uint32_t height, uint32_t stride, uint16_t* pixels,
+                      uint16_t tolerance)
+    {
+        if (stride < static_cast<uint64_t>(width) * sizeof(uint16_t))
+            throw invalid_value_exception(to_string() << "Stride " << stride << " is too short for a depth frame " << width << " pixels wide");
+
+        bit_reader in(encoded, size);
+        codec_state state;
+
+        const uint16_t* prev = nullptr;
+        for (uint32_t y = 0; y < height; y++)
+        {
+            auto row = reinterpret_cast<uint16_t*>(reinterpret_cast<uint8_t*>(pixels) + static_cast<size_t>(y) * stride);
+            for (uint32_t x = 0; x < width; x++)
+            {
+                int a, b, c;
+                get_neighbours(row, prev, x, a, b, c);
+                if (a == b && b == c)
+                {
+                    auto run = state.run.decode(in, RUN_RAW_BITS);
+                    if (run > width - x)
+                        throw invalid_value_exception("Corrupted depth frame data");
+                    std::fill(row + x, row + x + run, static_cast<uint16_t>(a));
+                    x += run;
+                    if (x == width) break;
+                    get_neighbours(row, prev, x, a, b, c);
+                }
+                row[x] = decode_pixel(in, state, a, b, c);
+            }
+            if (in.overrun())
+                throw invalid_value_exception("Depth frame data is truncated");
+            prev = row;
+        }
+
+        if (tolerance)
+            dequantize(pixels, width, height, stride, tolerance);
+    }
+}
@@ -0,0 +1,26 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace librealsense
+{
+    const uint16_t MAX_DEPTH_TOLERANCE = 16384;
+
+    // Lossless codec for Z16 depth images, in the spirit of JPEG-LS: every pixel is predicted from its left, top
+    // and top-left neighbours by the median edge detector, and the residual is Rice coded with a parameter adapted
+    // per gradient context. Flat areas, most notably the holes of invalid depth, are coded as runs
+    // Strides are in bytes, the encoded data depends only on the pixels of each row, not on their padding
+    // A non-zero tolerance quantizes the pixels in steps of 2 * tolerance + 1 before coding them, so each decoded
+    // pixel is within the tolerance of its value, and zeros stay zeros. The decoder must be given the same tolerance
+    void encode_depth(const uint16_t* pixels, uint32_t width, uint32_t height, uint32_t stride, std::vector<uint8_t>& encoded,
+                      uint16_t tolerance = 0);
+
+    // Throws invalid_value_exception if the stride is shorter than a row or the data ends before all of the pixels were decoded
+    void decode_depth(const uint8_t* encoded, size_t size, uint32_t width, uint32_t height, uint32_t stride, uint16_t* pixels,
+                      uint16_t tolerance = 0);
+}
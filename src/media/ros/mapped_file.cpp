@@ -0,0 +1,78 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#include "types.h"
+#include "mapped_file.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace librealsense
+{
+#ifdef _WIN32
+    mapped_file::mapped_file(const std::string& path)
+        : _data(nullptr), _size(0), _file(INVALID_HANDLE_VALUE), _mapping(nullptr)
+    {
+        _file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (_file == INVALID_HANDLE_VALUE)
+            throw io_exception(to_string() << "Failed to open " << path << " for mapping, error " << GetLastError());
+
+        LARGE_INTEGER size;
+        if (GetFileSizeEx(_file, &size) && size.QuadPart > 0 && static_cast<unsigned long long>(size.QuadPart) <= SIZE_MAX)
+        {
+            _mapping = CreateFileMappingA(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (_mapping)
+                _data = static_cast<const uint8_t*>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+        }
+        if (!_data)
+        {
+            auto error = GetLastError();
+            if (_mapping) CloseHandle(_mapping);
+            CloseHandle(_file);
+            throw io_exception(to_string() << "Failed to map " << path << ", error " << error);
+        }
+        _size = static_cast<size_t>(size.QuadPart);
+    }
+
+    mapped_file::~mapped_file()
+    {
+        UnmapViewOfFile(_data);
+        CloseHandle(_mapping);
+        CloseHandle(_file);
+    }
+#else
+    mapped_file::mapped_file(const std::string& path)
+        : _data(nullptr), _size(0)
+    {
+        auto fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw io_exception(to_string() << "Failed to open " << path << " for mapping, errno " << errno);
+
+        struct stat st;
+        void* data = MAP_FAILED;
+        if (fstat(fd, &st) == 0 && st.st_size > 0 && static_cast<unsigned long long>(st.st_size) <= SIZE_MAX)
+        {
+            data = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        }
+        auto error = errno;
+        // The mapping keeps the file referenced
+        close(fd);
+        if (data == MAP_FAILED)
+            throw io_exception(to_string() << "Failed to map " << path << ", errno " << error);
+
+        _data = static_cast<const uint8_t*>(data);
+        _size = static_cast<size_t>(st.st_size);
+    }
+
+    mapped_file::~mapped_file()
+    {
+        munmap(const_cast<uint8_t*>(_data), _size);
+    }
+#endif
+}
@@ -16,6 +16,30 @@
 
 namespace librealsense
 {
+    // Encoding of the image messages holding Z16 frames compressed by encode_depth
+    const std::string DEPTH_CODEC_ENCODING = "mono16; rs2_depth_codec";
+
+    // Images recorded as the sensor delivered them have the encoding of their stream followed by this and the fourcc
+    // of the payload, as in "rgb8; rs2_native YUY2". They are unpacked on playback by the unpacker of the fourcc
+    const std::string NATIVE_ENCODING_SUFFIX = "; rs2_native ";
+
+    inline std::string get_native_encoding(const std::string& encoding, uint32_t fourcc)
+    {
+        char chars[] = { char(fourcc >> 24), char(fourcc >> 16), char(fourcc >> 8), char(fourcc), 0 };
+        return encoding + NATIVE_ENCODING_SUFFIX + chars;
+    }
+
+    inline bool try_get_native_fourcc(const std::string& encoding, uint32_t& fourcc)
+    {
+        auto pos = encoding.find(NATIVE_ENCODING_SUFFIX);
+        if (pos == std::string::npos || encoding.size() != pos + NATIVE_ENCODING_SUFFIX.size() + 4)
+            return false;
+        fourcc = 0;
+        for (auto c : encoding.substr(pos + NATIVE_ENCODING_SUFFIX.size()))
+            fourcc = (fourcc << 8) | static_cast<uint8_t>(c);
+        return true;
+    }
+
     inline void convert(rs2_format source, std::string& target)
     {
         switch (source)
@@ -36,6 +60,9 @@ namespace librealsense
     inline void convert(const std::string& source, rs2_format& target)
     {
         if (source == sensor_msgs::image_encodings::MONO16) { target = RS2_FORMAT_Z16; return; }
+        if (source == DEPTH_CODEC_ENCODING) { target = RS2_FORMAT_Z16; return; }
+        auto native = source.find(NATIVE_ENCODING_SUFFIX);
+        if (native != std::string::npos) { convert(source.substr(0, native), target); return; }
         if (source == sensor_msgs::image_encodings::RGB8) { target = RS2_FORMAT_RGB8; return; }
         if (source == sensor_msgs::image_encodings::BGR8) { target = RS2_FORMAT_BGR8; return; }
         if (source == sensor_msgs::image_encodings::RGBA8) { target = RS2_FORMAT_RGBA8; return; }
@@ -353,10 +380,32 @@ namespace librealsense
         {
             return create_from({ stream_full_prefix(stream_id), "image", "data" });
         }
+        static std::string thumbnail_data_topic(const device_serializer::stream_identifier& stream_id)
+        {
+            return create_from({ stream_full_prefix(stream_id), "thumbnail", "data" });
+        }
         static std::string image_metadata_topic(const device_serializer::stream_identifier& stream_id)
         {
             return create_from({ stream_full_prefix(stream_id), "image", "metadata" });
         }
+        /*version 4 and up*/
+        static std::string image_metadata_record_topic(const device_serializer::stream_identifier& stream_id)
+        {
+            return create_from({ stream_full_prefix(stream_id), "image", "metadata_record" });
+        }
+        static std::string imu_data_topic(const device_serializer::stream_identifier& stream_id)
+        {
+            return create_from({ stream_full_prefix(stream_id), "imu", "data" });
+        }
+        static std::string imu_metadata_topic(const device_serializer::stream_identifier& stream_id)
+        {
+            return create_from({ stream_full_prefix(stream_id), "imu", "metadata" });
+        }
+        /*version 4 and up*/
+        static std::string imu_metadata_record_topic(const device_serializer::stream_identifier& stream_id)
+        {
+            return create_from({ stream_full_prefix(stream_id), "imu", "metadata_record" });
+        }
         static std::string stream_extrinsic_topic(const device_serializer::stream_identifier& stream_id, uint32_t ref_id)
         {
             return create_from({ stream_full_prefix(stream_id), "tf", std::to_string(ref_id) });
@@ -365,6 +414,10 @@ namespace librealsense
         {
             return create_from({ "additional_info" });
         }
+        static std::string file_index_topic()
+        {
+            return create_from({ "file_index" });
+        }
 
         static std::string stream_full_prefix(const device_serializer::stream_identifier& stream_id)
         {
@@ -438,9 +491,18 @@ namespace librealsense
     */
     constexpr uint32_t get_file_version()
     {
-        return 3u;
+        return 4u;
     }
 
+    /**
+    * Since version 4 the metadata of a frame is a single std_msgs::UInt8MultiArray message, instead of a
+    * KeyValue message per attribute. The record holds, little endian and unaligned:
+    *   double system_time, int32 timestamp_domain, then an int32 rs2_frame_metadata_value and an int64 value
+    *   per attribute, laid out as the metadata blob of the frames played back
+    */
+    const size_t METADATA_RECORD_HEADER_SIZE = sizeof(double) + sizeof(int32_t);
+    const size_t METADATA_RECORD_PAIR_SIZE = sizeof(rs2_frame_metadata_value) + sizeof(rs2_metadata_type);
+
     constexpr uint32_t get_minimum_supported_file_version()
     {
         return 2u;
@@ -456,6 +518,21 @@ namespace librealsense
         return device_serializer::nanoseconds::min();
     }
 
+    // Video frames get a downscaled copy at most this often, no wider than the width below
+    constexpr device_serializer::nanoseconds get_thumbnail_interval()
+    {
+        return device_serializer::nanoseconds(100000000);
+    }
+
+    constexpr uint32_t get_thumbnail_max_width()
+    {
+        return 160u;
+    }
+
+    // Keys of the messages of the file index topic, written when a recording ends. Files without it are scanned instead
+    constexpr const char* FRAMES_BEGIN_TIME_KEY = "frames_begin_time";
+    constexpr const char* FRAMES_END_TIME_KEY = "frames_end_time";
+
     inline device_serializer::nanoseconds to_nanoseconds(const ros::Time& t)
     {
         if (t == ros::TIME_MIN)
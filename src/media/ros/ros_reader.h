@@ -5,6 +5,7 @@
 #include <chrono>
 #include <mutex>
 #include <regex>
+#include <set>
 #include <core/serialization.h>
 #include "rosbag/view.h"
 #include "sensor_msgs/Imu.h"
@@ -13,9 +14,13 @@
 #include "std_msgs/UInt32.h"
 #include "std_msgs/Float32.h"
 #include "std_msgs/String.h"
+#include "std_msgs/UInt8MultiArray.h"
 #include "realsense_msgs/StreamInfo.h"
 #include "sensor_msgs/CameraInfo.h"
 #include "ros_file_format.h"
+#include "depth_codec.h"
+#include "mapped_file.h"
+#include "image.h"
 
 namespace librealsense
 {
@@ -26,6 +31,7 @@ namespace librealsense
     public:
         ros_reader(const std::string& file, const std::shared_ptr<context>& ctx) :
             m_total_duration(0),
+            m_end_time(0),
             m_file_path(file),
             m_context(ctx),
             m_version(0),
@@ -34,7 +40,10 @@ namespace librealsense
             try
             {
                 reset(); //Note: calling a virtual function inside c'tor, safe while base function is pure virtual
-                m_total_duration = get_file_duration(m_file);
+                if (!read_file_index(m_file, m_total_duration, m_end_time))
+                {
+                    read_file_times(m_file, m_total_duration, m_end_time);
+                }
             }
             catch (const std::exception& e)
             {
@@ -83,14 +92,17 @@ namespace librealsense
 
         void seek_to_time(const nanoseconds& seek_time) override
         {
-            if (seek_time > m_total_duration)
+            //Frames of a segment of a longer recording start after the duration of the segment
+            if (seek_time > m_total_duration && seek_time > m_end_time)
             {
                 throw invalid_value_exception(to_string() << "Requested time is out of playback length. (Requested = " << seek_time.count() << ", Duration = " << m_total_duration.count() << ")");
             }
-            auto seek_time_as_secs = std::chrono::duration_cast<std::chrono::duration<double>>(seek_time);
-            auto seek_time_as_rostime = ros::Time(seek_time_as_secs.count());
+            //Converting without going through seconds as a double, that could round a frame's time past it
+            ros::Time seek_time_as_rostime;
+            seek_time_as_rostime.fromNSec(seek_time.count());
 
             m_samples_view.reset(new rosbag::View(m_file, FalseQuery()));
+            m_metadata_cursors.clear();
             
             //Using cached topics here and not querying them (before reseting) since a previous call to seek
             // could have changed the view and some streams that should be streaming were dropped.
@@ -107,6 +119,46 @@ namespace librealsense
             return m_total_duration;
         }
 
+        uint64_t query_frame_count(const device_serializer::stream_identifier& stream_id) override
+        {
+            return get_frame_index(stream_id).size();
+        }
+
+        nanoseconds query_frame_time(const device_serializer::stream_identifier& stream_id, uint64_t frame) override
+        {
+            auto&& index = get_frame_index(stream_id);
+            if (frame >= index.size())
+            {
+                throw invalid_value_exception(to_string() << "Requested frame " << frame << " is out of the " << index.size() << " frames of stream " << stream_id);
+            }
+            return index[frame];
+        }
+
+        bool query_thumbnail(const device_serializer::stream_identifier& stream_id, const nanoseconds& time, thumbnail& result) override
+        {
+            auto&& index = get_thumbnail_index(stream_id);
+            if (index.empty())
+            {
+                return false;
+            }
+            //Before the first thumbnail, the first one is the closest
+            auto it = std::upper_bound(index.begin(), index.end(), time);
+            auto thumbnail_time = it == index.begin() ? *it : *(it - 1);
+
+            rosbag::View thumbnail_view(m_file, rosbag::TopicQuery(ros_topic::thumbnail_data_topic(stream_id)), to_rostime(thumbnail_time), to_rostime(thumbnail_time));
+            if (thumbnail_view.begin() == thumbnail_view.end())
+            {
+                return false;
+            }
+            auto msg = instantiate_msg<sensor_msgs::Image>(*thumbnail_view.begin());
+            result.time = thumbnail_time;
+            result.width = msg->width;
+            result.height = msg->height;
+            convert(msg->encoding, result.format);
+            result.data = msg->data;
+            return true;
+        }
+
         void reset() override
         {
             m_file.close();
@@ -118,7 +170,28 @@ namespace librealsense
                 throw std::runtime_error("unsupported file version");
             }
 
+            //The topics of the file are listed once, from the index the bag keeps in memory, so that
+            // topics that were never written are not queried one by one
+            m_topics.clear();
+            rosbag::View all_topics_view(m_file);
+            for (auto&& connection : all_topics_view.getConnections())
+            {
+                m_topics.insert(connection->topic);
+            }
+
+            //Frames read before the reset keep their own reference to the previous mapping
+            m_mapped_file = nullptr;
+            try
+            {
+                m_mapped_file = std::make_shared<mapped_file>(m_file_path);
+            }
+            catch (const std::exception& e)
+            {
+                LOG_WARNING("Frames will be copied from the file: " << e.what());
+            }
+
             m_samples_view = nullptr;
+            m_metadata_cursors.clear();
             m_frame_source = std::make_shared<frame_source>();
             m_frame_source->init(m_metadata_parser_map);
             m_initial_device_description = read_device_description(get_static_file_info_timestamp(), true);
@@ -225,16 +298,17 @@ namespace librealsense
             nanoseconds timestamp = to_nanoseconds(next_msg_time);
             stream_identifier stream_id = ros_topic::get_stream_identifier(next_msg_topic);
 
-            if (msg.isType<sensor_msgs::Image>())
+            // Batches of motion samples are stored as images on the motion stream topic
+            if (msg.isType<sensor_msgs::Imu>() || next_msg_topic == ros_topic::imu_data_topic(stream_id))
             {
-                frame_holder frame = create_image_from_message(msg);
+                frame_holder frame = create_motion_from_message(msg);
                 return std::make_shared<serialized_frame>(timestamp, stream_id, std::move(frame));
             }
 
-            if (msg.isType<sensor_msgs::Imu>())
+            if (msg.isType<sensor_msgs::Image>())
             {
-                //frame = create_motion_sample(msg);
-                //return std::make_shared<serialized_frame>(timestamp, stream_id, std::move(frame));
+                frame_holder frame = create_image_from_message(msg);
+                return std::make_shared<serialized_frame>(timestamp, stream_id, std::move(frame));
             }
 
             std::string err_msg = to_string() << "Unknown frame type: " << msg.getDataType() << "(Topic: " << next_msg_topic << ")";
@@ -253,17 +327,165 @@ namespace librealsense
             return md_parser_map;
         }
 
-        static nanoseconds get_file_duration(const rosbag::Bag& file)
+        //Times written by the recorder when it closed the file, false for files that have none
+        static bool read_file_index(const rosbag::Bag& file, nanoseconds& duration, nanoseconds& end_time)
+        {
+            rosbag::View index_view(file, rosbag::TopicQuery(ros_topic::file_index_topic()));
+            bool has_begin = false, has_end = false;
+            nanoseconds begin_time(0);
+            for (auto message_instance : index_view)
+            {
+                auto key_val_msg = instantiate_msg<diagnostic_msgs::KeyValue>(message_instance);
+                if (key_val_msg->key == FRAMES_BEGIN_TIME_KEY)
+                {
+                    begin_time = nanoseconds(std::stoll(key_val_msg->value));
+                    has_begin = true;
+                }
+                else if (key_val_msg->key == FRAMES_END_TIME_KEY)
+                {
+                    end_time = nanoseconds(std::stoll(key_val_msg->value));
+                    has_end = true;
+                }
+            }
+            if (!has_begin || !has_end)
+            {
+                return false;
+            }
+            duration = end_time - begin_time;
+            return true;
+        }
+
+        static void read_file_times(const rosbag::Bag& file, nanoseconds& duration, nanoseconds& end_time)
         {
             rosbag::View all_frames_view(file, FrameQuery());
             auto streaming_duration = all_frames_view.getEndTime() - all_frames_view.getBeginTime();
-            return nanoseconds(streaming_duration.toNSec());
+            duration = nanoseconds(streaming_duration.toNSec());
+            end_time = nanoseconds(all_frames_view.getEndTime().toNSec());
+        }
+
+        // Fields of a serialized sensor_msgs::Image, read in place without copying its pixels
+        struct image_message_fields
+        {
+            uint32_t seq;
+            ros::Time stamp;
+            uint32_t height;
+            uint32_t width;
+            std::string encoding;
+            uint32_t step;
+            const uint8_t* data;
+            uint32_t data_size;
+        };
+
+        static bool parse_image_message(const uint8_t* msg, size_t size, image_message_fields& fields)
+        {
+            auto end = msg + size;
+            auto read_uint32 = [&](uint32_t& value)
+            {
+                if (end - msg < 4) return false;
+                memcpy(&value, msg, 4);
+                msg += 4;
+                return true;
+            };
+            auto read_bytes = [&](const uint8_t*& bytes, uint32_t& length)
+            {
+                if (!read_uint32(length) || static_cast<size_t>(end - msg) < length) return false;
+                bytes = msg;
+                msg += length;
+                return true;
+            };
+
+            const uint8_t* frame_id;
+            uint32_t frame_id_length;
+            const uint8_t* encoding;
+            uint32_t encoding_length;
+            if (!read_uint32(fields.seq) || !read_uint32(fields.stamp.sec) || !read_uint32(fields.stamp.nsec) ||
+                !read_bytes(frame_id, frame_id_length) ||
+                !read_uint32(fields.height) || !read_uint32(fields.width) ||
+                !read_bytes(encoding, encoding_length))
+                return false;
+            if (end - msg < 1) return false;
+            msg++; //is_bigendian
+            if (!read_uint32(fields.step) || !read_bytes(fields.data, fields.data_size))
+                return false;
+
+            fields.encoding.assign(reinterpret_cast<const char*>(encoding), encoding_length);
+            return true;
+        }
+
+        video_frame* alloc_image_frame(const stream_identifier& stream_id, const frame_additional_data& additional_data, size_t size, bool requires_memory,
+                                       uint32_t width, uint32_t height, uint32_t step, const std::string& encoding) const
+        {
+            frame_interface* frame = m_frame_source->alloc_frame((stream_id.stream_type == RS2_STREAM_DEPTH) ? RS2_EXTENSION_DEPTH_FRAME : RS2_EXTENSION_VIDEO_FRAME,
+                                                                size, additional_data, requires_memory);
+            if (frame == nullptr)
+            {
+                throw invalid_value_exception("Failed to allocate new frame");
+            }
+            librealsense::video_frame* video_frame = static_cast<librealsense::video_frame*>(frame);
+            video_frame->assign(width, height, step, step / width * 8);
+            rs2_format stream_format;
+            convert(encoding, stream_format);
+            //attaching a temp stream to the frame. Playback sensor should assign the real stream
+            frame->set_stream(std::make_shared<video_stream_profile>(platform::stream_profile{}));
+            frame->get_stream()->set_format(stream_format);
+            frame->get_stream()->set_stream_index(stream_id.stream_index);
+            frame->get_stream()->set_stream_type(stream_id.stream_type);
+            return video_frame;
+        }
+
+        // Images stored as is, in uncompressed chunks, reference the mapped file instead of being copied
+        // Returns an empty frame for the images that have to be read into a buffer
+        frame_holder create_image_from_mapped_file(const rosbag::MessageInstance& image_data)
+        {
+            uint64_t offset;
+            uint32_t size;
+            if (m_mapped_file == nullptr || !m_file.getMessageDataLocation(image_data.getIndexEntry(), offset, size))
+            {
+                return {};
+            }
+            image_message_fields msg;
+            if (offset + size > m_mapped_file->size() || !parse_image_message(m_mapped_file->data() + offset, size, msg))
+            {
+                throw io_exception(to_string() << "Invalid file format, failed to read image message (Topic: " << image_data.getTopic() << ")");
+            }
+            uint32_t fourcc;
+            if (msg.encoding == DEPTH_CODEC_ENCODING || try_get_native_fourcc(msg.encoding, fourcc))
+            {
+                return {};
+            }
+
+            frame_additional_data additional_data {};
+            std::chrono::duration<double, std::milli> timestamp_us(std::chrono::duration<double>(msg.stamp.toSec()));
+            additional_data.timestamp = timestamp_us.count();
+            additional_data.frame_number = msg.seq;
+            additional_data.fisheye_ae_mode = false; //TODO: where should this come from?
+
+            auto stream_id = ros_topic::get_stream_identifier(image_data.getTopic());
+            read_frame_metadata(m_version >= 4 ? ros_topic::image_metadata_record_topic(stream_id) : ros_topic::image_metadata_topic(stream_id),
+                                image_data.getTime(), additional_data);
+            auto video_frame = alloc_image_frame(stream_id, additional_data, 0, false, msg.width, msg.height, msg.step, msg.encoding);
+
+            //The frame keeps the mapping alive until it is released
+            auto mapping = m_mapped_file;
+            video_frame->attach_continuation(frame_continuation([mapping]() {}, msg.data));
+            video_frame->user_data_size = msg.data_size;
+            video_frame->read_only_data = true;
+            librealsense::frame_holder fh{ video_frame };
+            LOG_DEBUG("Created mapped image frame: " << msg.encoding << " " << video_frame->get_width() << "x" << video_frame->get_height());
+
+            return std::move(fh);
         }
 
-        frame_holder create_image_from_message(const rosbag::MessageInstance &image_data) const
+        frame_holder create_image_from_message(const rosbag::MessageInstance &image_data)
         {
             LOG_DEBUG("Trying to create an image frame from message");
 
+            auto mapped = create_image_from_mapped_file(image_data);
+            if (mapped)
+            {
+                return mapped;
+            }
+
             auto msg = instantiate_msg<sensor_msgs::Image>(image_data);
 
             frame_additional_data additional_data {};
@@ -273,11 +495,130 @@ namespace librealsense
             additional_data.fisheye_ae_mode = false; //TODO: where should this come from?
 
             auto stream_id = ros_topic::get_stream_identifier(image_data.getTopic());
-            auto info_topic = ros_topic::image_metadata_topic(stream_id);
-            rosbag::View frame_metadata_view(m_file, rosbag::TopicQuery(info_topic), image_data.getTime(), image_data.getTime());
+            read_frame_metadata(m_version >= 4 ? ros_topic::image_metadata_record_topic(stream_id) : ros_topic::image_metadata_topic(stream_id),
+                                image_data.getTime(), additional_data);
+            auto is_encoded_depth = msg->encoding == DEPTH_CODEC_ENCODING;
+            uint32_t fourcc;
+            auto is_native = try_get_native_fourcc(msg->encoding, fourcc);
+            auto size = is_encoded_depth || is_native ? static_cast<size_t>(msg->step) * msg->height : msg->data.size();
+            auto video_frame = alloc_image_frame(stream_id, additional_data, size, true, msg->width, msg->height, msg->step, msg->encoding);
+            if (is_encoded_depth)
+            {
+                video_frame->data.resize(size);
+                decode_depth(msg->data.data(), msg->data.size(), msg->width, msg->height, msg->step, reinterpret_cast<uint16_t*>(video_frame->data.data()));
+            }
+            else if (is_native)
+            {
+                // Only the streams enabled for playback are read, so only their frames are unpacked
+                auto format = video_frame->get_stream()->get_format();
+                auto unpacker = find_native_unpacker(fourcc, stream_id.stream_type, format);
+                if (!unpacker)
+                {
+                    throw invalid_value_exception(to_string() << "No unpacker of the native format of " << msg->encoding << " (Topic: " << image_data.getTopic() << ")");
+                }
+                video_frame->data.resize(size);
+                byte* dest[] = { video_frame->data.data() };
+                if (unpacker->decode)
+                    unpacker->decode(dest, msg->data.data(), msg->data.size(), msg->width, msg->height);
+                else
+                    unpacker->unpack(dest, msg->data.data(), msg->width * msg->height);
+            }
+            else
+            {
+                video_frame->data.assign(msg->data.begin(), msg->data.end());
+            }
+            librealsense::frame_holder fh{ video_frame };
+            LOG_DEBUG("Created image frame: " << msg->encoding << " " << video_frame->get_width() << "x" << video_frame->get_height());
+
+            return std::move(fh);
+        }
+
+        frame_holder create_motion_from_message(const rosbag::MessageInstance& motion_data)
+        {
+            LOG_DEBUG("Trying to create a motion frame from message");
+
+            auto stream_id = ros_topic::get_stream_identifier(motion_data.getTopic());
+            frame_additional_data additional_data{};
+            std::vector<rs2_motion_sample> samples;
+            rs2_format format;
+            if (motion_data.isType<sensor_msgs::Imu>())
+            {
+                auto msg = instantiate_msg<sensor_msgs::Imu>(motion_data);
+                auto&& axes = (stream_id.stream_type == RS2_STREAM_ACCEL) ? msg->linear_acceleration : msg->angular_velocity;
+                std::chrono::duration<double, std::milli> timestamp_ms(std::chrono::duration<double>(msg->header.stamp.toSec()));
+                additional_data.timestamp = timestamp_ms.count();
+                additional_data.frame_number = msg->header.seq;
+                rs2_motion_sample sample{ additional_data.timestamp, { static_cast<float>(axes.x), static_cast<float>(axes.y), static_cast<float>(axes.z) } };
+                samples.push_back(sample);
+                format = RS2_FORMAT_MOTION_XYZ32F;
+            }
+            else
+            {
+                auto msg = instantiate_msg<sensor_msgs::Image>(motion_data);
+                samples.resize(msg->data.size() / sizeof(rs2_motion_sample));
+                if (samples.empty())
+                {
+                    throw io_exception(to_string() << "Empty motion batch (Topic: " << motion_data.getTopic() << ")");
+                }
+                memcpy(samples.data(), msg->data.data(), samples.size() * sizeof(rs2_motion_sample));
+                std::chrono::duration<double, std::milli> timestamp_ms(std::chrono::duration<double>(msg->header.stamp.toSec()));
+                additional_data.timestamp = timestamp_ms.count();
+                additional_data.frame_number = msg->header.seq;
+                format = RS2_FORMAT_MOTION_XYZ32F_BATCH;
+            }
+            read_frame_metadata(m_version >= 4 ? ros_topic::imu_metadata_record_topic(stream_id) : ros_topic::imu_metadata_topic(stream_id),
+                                motion_data.getTime(), additional_data);
+
+            auto size = (format == RS2_FORMAT_MOTION_XYZ32F) ? sizeof(samples[0].xyz) : samples.size() * sizeof(rs2_motion_sample);
+            frame_interface* frame = m_frame_source->alloc_frame(RS2_EXTENSION_MOTION_FRAME, size, additional_data, true);
+            if (frame == nullptr)
+            {
+                throw invalid_value_exception("Failed to allocate new frame");
+            }
+            auto data = const_cast<byte*>(frame->get_frame_data());
+            if (format == RS2_FORMAT_MOTION_XYZ32F)
+                memcpy(data, samples[0].xyz, size);
+            else
+                memcpy(data, samples.data(), size);
+
+            //attaching a temp stream to the frame. Playback sensor should assign the real stream
+            frame->set_stream(std::make_shared<stream_profile_base>(platform::stream_profile{}));
+            frame->get_stream()->set_format(format);
+            frame->get_stream()->set_stream_index(stream_id.stream_index);
+            frame->get_stream()->set_stream_type(stream_id.stream_type);
+            LOG_DEBUG("Created motion frame: " << format << " with " << samples.size() << " samples");
+
+            return frame_holder{ frame };
+        }
+
+        // Metadata messages are written with the time of their frame. Frames of a stream are read in time order,
+        // so each metadata topic is read sequentially by a view that is kept open from the previous frame on,
+        // instead of querying the bag index again for every frame
+        void read_frame_metadata(const std::string& metadata_topic, const ros::Time& time, frame_additional_data& additional_data)
+        {
+            auto&& cursor = m_metadata_cursors[metadata_topic];
+            if (cursor.view == nullptr || time < cursor.time)
+            {
+                cursor.view.reset(new rosbag::View(m_file, rosbag::TopicQuery(metadata_topic), time));
+                cursor.it = cursor.view->begin();
+            }
+            cursor.time = time;
+            while (cursor.it != cursor.view->end() && (*cursor.it).getTime() < time)
+            {
+                ++cursor.it;
+            }
+
+            if (m_version >= 4)
+            {
+                if (cursor.it != cursor.view->end() && (*cursor.it).getTime() == time)
+                    read_metadata_record(*cursor.it, additional_data);
+                return;
+            }
+
             uint32_t total_md_size = 0;
-            for (auto message_instance : frame_metadata_view)
+            for (; cursor.it != cursor.view->end() && (*cursor.it).getTime() == time; ++cursor.it)
             {
+                auto message_instance = *cursor.it;
                 auto key_val_msg = instantiate_msg<diagnostic_msgs::KeyValue>(message_instance);
 
                 if(key_val_msg->key == "timestamp_domain") //TODO: use constants
@@ -314,26 +655,29 @@ namespace librealsense
                 }
             }
             additional_data.metadata_size = total_md_size;
-            frame_interface* frame = m_frame_source->alloc_frame((stream_id.stream_type == RS2_STREAM_DEPTH) ? RS2_EXTENSION_DEPTH_FRAME : RS2_EXTENSION_VIDEO_FRAME,
-                                                                msg->data.size(), additional_data, true);
-            if (frame == nullptr)
+        }
+
+        // The attributes of the record are laid out as the metadata blob, so they are copied in one step
+        static void read_metadata_record(const rosbag::MessageInstance& message_instance, frame_additional_data& additional_data)
+        {
+            auto record = instantiate_msg<std_msgs::UInt8MultiArray>(message_instance);
+            auto&& data = record->data;
+            if (data.size() < METADATA_RECORD_HEADER_SIZE)
             {
-                throw invalid_value_exception("Failed to allocate new frame");
+                LOG_ERROR("Metadata record of " << data.size() << " bytes is too short (Topic: " << message_instance.getTopic() << ")");
+                return;
             }
-            librealsense::video_frame* video_frame = static_cast<librealsense::video_frame*>(frame);
-            video_frame->assign(msg->width, msg->height, msg->step, msg->step / msg->width * 8);
-            rs2_format stream_format;
-            convert(msg->encoding, stream_format);
-            //attaching a temp stream to the frame. Playback sensor should assign the real stream
-            frame->set_stream(std::make_shared<video_stream_profile>(platform::stream_profile{}));
-            frame->get_stream()->set_format(stream_format);
-            frame->get_stream()->set_stream_index(stream_id.stream_index);
-            frame->get_stream()->set_stream_type(stream_id.stream_type);
-            video_frame->data = msg->data;
-            librealsense::frame_holder fh{ video_frame };
-            LOG_DEBUG("Created image frame: " << stream_format << " " << video_frame->get_width() << "x" << video_frame->get_height() << " " << stream_format);
 
-            return std::move(fh);
+            int32_t timestamp_domain;
+            memcpy(&additional_data.system_time, data.data(), sizeof(double));
+            memcpy(&timestamp_domain, data.data() + sizeof(double), sizeof(timestamp_domain));
+            additional_data.timestamp_domain = static_cast<rs2_timestamp_domain>(timestamp_domain);
+
+            // Attributes beyond the size of the blob are dropped, as they are when reading the older format
+            auto pairs = (data.size() - METADATA_RECORD_HEADER_SIZE) / METADATA_RECORD_PAIR_SIZE;
+            auto size = std::min(pairs, additional_data.metadata_blob.size() / METADATA_RECORD_PAIR_SIZE) * METADATA_RECORD_PAIR_SIZE;
+            memcpy(additional_data.metadata_blob.data(), data.data() + METADATA_RECORD_HEADER_SIZE, size);
+            additional_data.metadata_size = static_cast<uint32_t>(size);
         }
 
         static uint32_t read_file_version(const rosbag::Bag& file)
@@ -366,9 +710,9 @@ namespace librealsense
             return true;
         }
 
-        static void update_sensor_options(const rosbag::Bag& file, uint32_t sensor_index, const nanoseconds& time, uint32_t file_version, snapshot_collection& sensor_extensions)
+        static void update_sensor_options(const rosbag::Bag& file, const std::set<std::string>& topics, uint32_t sensor_index, const nanoseconds& time, uint32_t file_version, snapshot_collection& sensor_extensions)
         {
-            auto sensor_options = read_sensor_options(file, { get_device_index(), sensor_index }, time, file_version);
+            auto sensor_options = read_sensor_options(file, topics, { get_device_index(), sensor_index }, time, file_version);
             sensor_extensions[RS2_EXTENSION_OPTIONS] = sensor_options;
             if (sensor_options->supports_option(RS2_OPTION_DEPTH_UNITS))
             {
@@ -411,7 +755,7 @@ namespace librealsense
                         auto sensor_info = read_info_snapshot(ros_topic::sensor_info_topic({ get_device_index(), sensor_index }));
                         sensor_extensions[RS2_EXTENSION_INFO] = sensor_info;
                         //Update options
-                        update_sensor_options(m_file, sensor_index, time, m_version, sensor_extensions);
+                        update_sensor_options(m_file, m_topics, sensor_index, time, m_version, sensor_extensions);
 
                         sensor_descriptions.emplace_back(sensor_index, sensor_extensions, streams_snapshots);
                     }
@@ -427,7 +771,7 @@ namespace librealsense
                 for (auto& sensor : device_snapshot.get_sensors_snapshots())
                 {
                     auto& sensor_extensions = sensor.get_sensor_extensions_snapshots();
-                    update_sensor_options(m_file, sensor.get_sensor_index(), time, m_version, sensor_extensions);
+                    update_sensor_options(m_file, m_topics, sensor.get_sensor_index(), time, m_version, sensor_extensions);
                 }
                 return device_snapshot;
             }
@@ -521,7 +865,12 @@ namespace librealsense
                 if (imu_intrinsic_view.size() > 0)
                 {
                     assert(imu_intrinsic_view.size() == 1);
-                    //TODO: implement when relevant
+                    auto profile = std::make_shared<stream_profile_base>(platform::stream_profile{ 1, 1, fps, static_cast<uint32_t>(format) });
+                    profile->set_stream_index(stream_id.stream_index);
+                    profile->set_stream_type(stream_id.stream_type);
+                    profile->set_format(format);
+                    profile->set_framerate(fps);
+                    streams.push_back(profile);
                 }
 
                 if (video_stream_infos_view.size() == 0 && imu_intrinsic_view.size() == 0)
@@ -571,7 +920,7 @@ namespace librealsense
             return std::make_pair(id, std::make_shared<const_value_option>(description, value));
         }
 
-        static std::shared_ptr<options_container> read_sensor_options(const rosbag::Bag& file, device_serializer::sensor_identifier sensor_id, const nanoseconds& timestamp, uint32_t file_version)
+        static std::shared_ptr<options_container> read_sensor_options(const rosbag::Bag& file, const std::set<std::string>& topics, device_serializer::sensor_identifier sensor_id, const nanoseconds& timestamp, uint32_t file_version)
         {
             auto options = std::make_shared<options_container>();
             if (file_version == 2)
@@ -590,6 +939,10 @@ namespace librealsense
                 {
                     rs2_option id = static_cast<rs2_option>(i);
                     std::string option_topic = ros_topic::option_value_topic(sensor_id, id);
+                    if (topics.find(option_topic) == topics.end())
+                    {
+                        continue;
+                    }
                     rosbag::View option_view(file, rosbag::TopicQuery(option_topic), to_rostime(get_static_file_info_timestamp()), to_rostime(timestamp));
                     auto it = option_view.begin();
                     if (it == option_view.end())
@@ -609,6 +962,51 @@ namespace librealsense
             return options;
         }
 
+        // Times of all the frames of a stream, read once from the index of the bag, which holds them in memory
+        // without reading the messages themselves
+        const std::vector<nanoseconds>& get_frame_index(const device_serializer::stream_identifier& stream_id)
+        {
+            auto it = m_frame_indexes.find(stream_id);
+            if (it != m_frame_indexes.end())
+            {
+                return it->second;
+            }
+
+            std::vector<nanoseconds> index;
+            rosbag::View frames_view(m_file, FalseQuery());
+            frames_view.addQuery(m_file, rosbag::TopicQuery(ros_topic::image_data_topic(stream_id)));
+            frames_view.addQuery(m_file, rosbag::TopicQuery(ros_topic::imu_data_topic(stream_id)));
+            index.reserve(frames_view.size());
+            for (auto&& msg : frames_view)
+            {
+                index.push_back(to_nanoseconds(msg.getTime()));
+            }
+            return m_frame_indexes[stream_id] = std::move(index);
+        }
+
+        // Times of the thumbnails of a stream, read once like the frame index. Files recorded without them have none
+        const std::vector<nanoseconds>& get_thumbnail_index(const device_serializer::stream_identifier& stream_id)
+        {
+            auto it = m_thumbnail_indexes.find(stream_id);
+            if (it != m_thumbnail_indexes.end())
+            {
+                return it->second;
+            }
+
+            std::vector<nanoseconds> index;
+            auto topic = ros_topic::thumbnail_data_topic(stream_id);
+            if (m_topics.find(topic) != m_topics.end())
+            {
+                rosbag::View thumbnails_view(m_file, rosbag::TopicQuery(topic));
+                index.reserve(thumbnails_view.size());
+                for (auto&& msg : thumbnails_view)
+                {
+                    index.push_back(to_nanoseconds(msg.getTime()));
+                }
+            }
+            return m_thumbnail_indexes[stream_id] = std::move(index);
+        }
+
         static std::vector<std::string> get_topics(std::unique_ptr<rosbag::View>& view)
         {
             std::vector<std::string> topics;
@@ -620,14 +1018,28 @@ namespace librealsense
             return topics;
         }
 
+        // Read position of a metadata topic
+        struct metadata_cursor
+        {
+            std::unique_ptr<rosbag::View> view;
+            rosbag::View::iterator it;
+            ros::Time time;
+        };
+
         device_snapshot                         m_initial_device_description;
         nanoseconds                             m_total_duration;
+        nanoseconds                             m_end_time;
         std::string                             m_file_path;
         std::shared_ptr<frame_source>           m_frame_source;
         rosbag::Bag                             m_file;
+        std::shared_ptr<mapped_file>            m_mapped_file;
         std::unique_ptr<rosbag::View>           m_samples_view;
         rosbag::View::iterator                  m_samples_itrator;
         std::vector<std::string>                m_enabled_streams_topics;
+        std::set<std::string>                   m_topics;
+        std::map<device_serializer::stream_identifier, std::vector<nanoseconds>> m_frame_indexes;
+        std::map<device_serializer::stream_identifier, std::vector<nanoseconds>> m_thumbnail_indexes;
+        std::map<std::string, metadata_cursor>  m_metadata_cursors;
         std::shared_ptr<metadata_parser_map>    m_metadata_parser_map;
         std::shared_ptr<context>                m_context;
         uint32_t                                m_version;
@@ -14,11 +14,70 @@
 #include "std_msgs/UInt32.h"
 #include "std_msgs/Float32.h"
 #include "std_msgs/String.h"
+#include "std_msgs/UInt8MultiArray.h"
 #include "diagnostic_msgs/KeyValue.h"
 #include "sensor_msgs/Image.h"
+#include "sensor_msgs/Imu.h"
+#include "realsense_msgs/ImuIntrinsic.h"
 #include "realsense_msgs/StreamInfo.h"
 #include "sensor_msgs/CameraInfo.h"
 #include "ros_file_format.h"
+#include "depth_codec.h"
+
+namespace librealsense
+{
+    // Recorded as a sensor_msgs::Image, but serializes the pixels straight from the frame buffer
+    // instead of owning a copy of them. The data member of the wrapped image is left empty
+    struct image_view
+    {
+        sensor_msgs::Image image;
+        const uint8_t* data;
+        uint32_t size;
+    };
+}
+
+namespace ros
+{
+    namespace message_traits
+    {
+        template<> struct IsMessage<librealsense::image_view> : TrueType {};
+        template<> struct HasHeader<librealsense::image_view> : TrueType {};
+        template<> struct MD5Sum<librealsense::image_view> : MD5Sum<sensor_msgs::Image> {
+            static const char* value(const librealsense::image_view&) { return MD5Sum<sensor_msgs::Image>::value(); }
+        };
+        template<> struct DataType<librealsense::image_view> : DataType<sensor_msgs::Image> {
+            static const char* value(const librealsense::image_view&) { return DataType<sensor_msgs::Image>::value(); }
+        };
+        template<> struct Definition<librealsense::image_view> : Definition<sensor_msgs::Image> {
+            static const char* value(const librealsense::image_view&) { return Definition<sensor_msgs::Image>::value(); }
+        };
+    }
+
+    namespace serialization
+    {
+        template<> struct Serializer<librealsense::image_view>
+        {
+            template<typename Stream>
+            inline static void write(Stream& stream, const librealsense::image_view& v)
+            {
+                stream.next(v.image.header);
+                stream.next(v.image.height);
+                stream.next(v.image.width);
+                stream.next(v.image.encoding);
+                stream.next(v.image.is_bigendian);
+                stream.next(v.image.step);
+                stream.next(v.size);
+                if (v.size) memcpy(stream.advance(v.size), v.data, v.size);
+            }
+
+            inline static uint32_t serializedLength(const librealsense::image_view& v)
+            {
+                // The image data is empty, leaving only its length prefix
+                return serializationLength(v.image) + v.size;
+            }
+        };
+    }
+}
 
 namespace librealsense
 {
@@ -27,13 +86,30 @@ namespace librealsense
     class ros_writer: public writer
     {
     public:
-        explicit ros_writer(const std::string& file) : m_file_path(file)
+        explicit ros_writer(const std::string& file, const record_settings& settings = record_settings()) : m_file_path(file),
+            m_encode_depth(settings.compression == RS2_RECORD_COMPRESSION_LZ4_DEPTH)
         {
             m_bag.open(file, rosbag::BagMode::Write);
-            m_bag.setCompression(rosbag::CompressionType::LZ4);
+            m_bag.setCompression(settings.compression == RS2_RECORD_COMPRESSION_NONE ?
+                rosbag::CompressionType::Uncompressed : rosbag::CompressionType::LZ4);
+            if (settings.chunk_size > 0)
+                m_bag.setChunkThreshold(settings.chunk_size);
+            m_bag.setCompressionThreads(settings.compression_threads);
             write_file_version();
         }
 
+        ~ros_writer()
+        {
+            try
+            {
+                write_file_index();
+            }
+            catch (const std::exception& e)
+            {
+                LOG_WARNING("Failed to write the index of " << m_file_path << ": " << e.what());
+            }
+        }
+
         void write_device_description(const librealsense::device_snapshot& device_description) override
         {
             for (auto&& device_extension_snapshot : device_description.get_device_extensions_snapshots().get_snapshots())
@@ -52,19 +128,22 @@ namespace librealsense
 
         void write_frame(const stream_identifier& stream_id, const nanoseconds& timestamp, frame_holder&& frame) 
         {
+            update_frame_times(timestamp);
+
             if (Is<video_frame>(frame.frame))
             {
                 write_video_frame(stream_id, timestamp, std::move(frame));
                 return;
             }
 
-           /* if (Is<motion_frame>(data.frame.get()))
+            auto format = frame->get_stream()->get_format();
+            if (format == RS2_FORMAT_MOTION_XYZ32F || format == RS2_FORMAT_MOTION_XYZ32F_BATCH)
             {
-                write_motion(data);
+                write_motion_frame(stream_id, timestamp, std::move(frame));
                 return;
             }
 
-            if (Is<pose_frame>(data.frame.get()))
+           /* if (Is<pose_frame>(data.frame.get()))
             {
                 write_pose(data);
                 return;
@@ -86,7 +165,66 @@ namespace librealsense
             return m_file_path;
         }
 
+        // What write_frame records along with a frame, but not the frame itself, for writers keeping the frames in
+        // files of their own: the times of the file index, the stream info of motion streams, the extrinsics and
+        // the thumbnails
+        void write_frame_description(const stream_identifier& stream_id, const nanoseconds& timestamp, const frame_holder& frame)
+        {
+            update_frame_times(timestamp);
+
+            if (auto vid_frame = dynamic_cast<librealsense::video_frame*>(frame.frame))
+            {
+                sensor_msgs::Image::_header_type header;
+                header.seq = static_cast<uint32_t>(vid_frame->get_frame_number());
+                std::chrono::duration<double, std::milli> timestamp_ms(vid_frame->get_frame_timestamp());
+                header.stamp = ros::Time(std::chrono::duration<double>(timestamp_ms).count());
+                write_thumbnail(stream_id, timestamp, vid_frame, header);
+            }
+            else
+            {
+                write_motion_stream_info(stream_id, frame.frame->get_stream());
+            }
+
+            try
+            {
+                write_extrinsics(stream_id, frame);
+            }
+            catch (std::exception const& e)
+            {
+                LOG_WARNING("Failed to write stream extrinsics for " << stream_id << ". Exception: " << e.what());
+            }
+        }
+
+        // Bytes written to the file so far, messages still gathered in the current chunk are not included
+        uint64_t get_file_size() const
+        {
+            return m_bag.getSize();
+        }
+
     private:
+        void update_frame_times(const nanoseconds& timestamp)
+        {
+            if (m_frames_begin_time > m_frames_end_time || timestamp < m_frames_begin_time) m_frames_begin_time = timestamp;
+            if (timestamp > m_frames_end_time) m_frames_end_time = timestamp;
+        }
+
+        // Times of the first and last frames, so that readers get the duration without going over the frames
+        void write_file_index()
+        {
+            if (m_frames_begin_time > m_frames_end_time)
+                return;
+
+            diagnostic_msgs::KeyValue begin_time;
+            begin_time.key = FRAMES_BEGIN_TIME_KEY;
+            begin_time.value = std::to_string(m_frames_begin_time.count());
+            write_message(ros_topic::file_index_topic(), get_static_file_info_timestamp(), begin_time);
+
+            diagnostic_msgs::KeyValue end_time;
+            end_time.key = FRAMES_END_TIME_KEY;
+            end_time.value = std::to_string(m_frames_end_time.count());
+            write_message(ros_topic::file_index_topic(), get_static_file_info_timestamp(), end_time);
+        }
+
         void write_file_version()
         {
             std_msgs::UInt32 msg;
@@ -96,28 +234,45 @@ namespace librealsense
 
         void write_video_frame(stream_identifier stream_id, const nanoseconds& timestamp, const frame_holder& frame)
         {
-            sensor_msgs::Image image;
+            image_view view;
+            auto& image = view.image;
             auto vid_frame = dynamic_cast<librealsense::video_frame*>(frame.frame);
             assert(vid_frame != nullptr);
 
             image.width = static_cast<uint32_t>(vid_frame->get_width());
             image.height = static_cast<uint32_t>(vid_frame->get_height());
             image.step = static_cast<uint32_t>(vid_frame->get_stride());
-            convert(vid_frame->get_stream()->get_format(), image.encoding);
+            auto format = vid_frame->get_stream()->get_format();
+            convert(format, image.encoding);
             image.is_bigendian = is_big_endian();
             auto size = vid_frame->get_stride() * vid_frame->get_height();
-            auto p_data = vid_frame->get_frame_data();
-            image.data.assign(p_data, p_data + size);
+            view.data = vid_frame->get_frame_data();
+            view.size = static_cast<uint32_t>(size);
+            if (m_encode_depth && format == RS2_FORMAT_Z16)
+            {
+                encode_depth(reinterpret_cast<const uint16_t*>(view.data), image.width, image.height, image.step, m_depth_buffer);
+                image.encoding = DEPTH_CODEC_ENCODING;
+                view.data = m_depth_buffer.data();
+                view.size = static_cast<uint32_t>(m_depth_buffer.size());
+            }
+            else if (vid_frame->native)
+            {
+                // Recorded as the sensor delivered it, the step stays the one of the unpacked frame
+                image.encoding = get_native_encoding(image.encoding, vid_frame->native->fourcc);
+                view.data = vid_frame->native->data.data();
+                view.size = static_cast<uint32_t>(vid_frame->native->data.size());
+            }
             image.header.seq = static_cast<uint32_t>(vid_frame->get_frame_number());
             std::chrono::duration<double, std::milli> timestamp_ms(vid_frame->get_frame_timestamp());
             image.header.stamp = ros::Time(std::chrono::duration<double>(timestamp_ms).count());
             std::string TODO_CORRECT_ME = "0";
             image.header.frame_id = TODO_CORRECT_ME;
             auto image_topic = ros_topic::image_data_topic(stream_id);
-            write_message(image_topic, timestamp, image);
+            write_message(image_topic, timestamp, view);
+            write_thumbnail(stream_id, timestamp, vid_frame, view.image.header);
             try
             {
-                write_image_metadata(stream_id, timestamp, vid_frame);
+                write_frame_metadata(ros_topic::image_metadata_record_topic(stream_id), timestamp, vid_frame);
             }
             catch (std::exception const& e)
             {
@@ -133,6 +288,149 @@ namespace librealsense
             }
         }
 
+        static uint32_t get_thumbnail_pixel_size(rs2_format format)
+        {
+            switch (format)
+            {
+            case RS2_FORMAT_Y8: return 1;
+            case RS2_FORMAT_Z16: case RS2_FORMAT_Y16: return 2;
+            case RS2_FORMAT_RGB8: case RS2_FORMAT_BGR8: return 3;
+            case RS2_FORMAT_RGBA8: case RS2_FORMAT_BGRA8: return 4;
+            default: return 0;
+            }
+        }
+
+        // Every few frames, a copy of the frame keeping one pixel out of each square of pixels of the downscale
+        void write_thumbnail(const stream_identifier& stream_id, const nanoseconds& timestamp, librealsense::video_frame* frame, const sensor_msgs::Image::_header_type& header)
+        {
+            auto format = frame->get_stream()->get_format();
+            auto pixel_size = get_thumbnail_pixel_size(format);
+            if (!pixel_size)
+                return;
+
+            auto last = m_last_thumbnail_times.find(stream_id);
+            if (last != m_last_thumbnail_times.end() && timestamp >= last->second && timestamp - last->second < get_thumbnail_interval())
+                return;
+            m_last_thumbnail_times[stream_id] = timestamp;
+
+            auto width = static_cast<uint32_t>(frame->get_width());
+            auto height = static_cast<uint32_t>(frame->get_height());
+            auto scale = (width + get_thumbnail_max_width() - 1) / get_thumbnail_max_width();
+            if (!scale)
+                return;
+
+            image_view view;
+            auto& image = view.image;
+            image.header = header;
+            image.width = width / scale;
+            image.height = height / scale;
+            image.step = image.width * pixel_size;
+            convert(format, image.encoding);
+            image.is_bigendian = is_big_endian();
+
+            m_thumbnail_buffer.resize(image.step * image.height);
+            auto source = frame->get_frame_data();
+            auto stride = frame->get_stride();
+            for (uint32_t y = 0; y < image.height; y++)
+            {
+                auto in = source + y * scale * stride;
+                auto out = m_thumbnail_buffer.data() + y * image.step;
+                for (uint32_t x = 0; x < image.width; x++, in += scale * pixel_size, out += pixel_size)
+                {
+                    memcpy(out, in, pixel_size);
+                }
+            }
+            view.data = m_thumbnail_buffer.data();
+            view.size = static_cast<uint32_t>(m_thumbnail_buffer.size());
+            write_message(ros_topic::thumbnail_data_topic(stream_id), timestamp, view);
+        }
+
+        // Single samples are written as standard IMU messages. A batch goes as is into one image message on the same
+        // topic, one rs2_motion_sample per column
+        void write_motion_frame(stream_identifier stream_id, const nanoseconds& timestamp, const frame_holder& frame)
+        {
+            write_motion_stream_info(stream_id, frame.frame->get_stream());
+
+            std::chrono::duration<double, std::milli> timestamp_ms(frame.frame->get_frame_timestamp());
+            auto topic = ros_topic::imu_data_topic(stream_id);
+            if (frame.frame->get_stream()->get_format() == RS2_FORMAT_MOTION_XYZ32F)
+            {
+                auto xyz = reinterpret_cast<const float*>(frame.frame->get_frame_data());
+                geometry_msgs::Vector3 axes;
+                axes.x = xyz[0];
+                axes.y = xyz[1];
+                axes.z = xyz[2];
+
+                sensor_msgs::Imu imu_msg;
+                imu_msg.orientation_covariance[0] = -1; // No orientation estimate
+                if (stream_id.stream_type == RS2_STREAM_ACCEL)
+                {
+                    imu_msg.linear_acceleration = axes;
+                    imu_msg.angular_velocity_covariance[0] = -1;
+                }
+                else
+                {
+                    imu_msg.angular_velocity = axes;
+                    imu_msg.linear_acceleration_covariance[0] = -1;
+                }
+                imu_msg.header.seq = static_cast<uint32_t>(frame.frame->get_frame_number());
+                imu_msg.header.stamp = ros::Time(std::chrono::duration<double>(timestamp_ms).count());
+                write_message(topic, timestamp, imu_msg);
+            }
+            else
+            {
+                auto samples = frame.frame->get_frame_data();
+                auto count = frame.frame->get_frame_data_size() / sizeof(rs2_motion_sample);
+
+                sensor_msgs::Image batch_msg;
+                batch_msg.width = static_cast<uint32_t>(count);
+                batch_msg.height = 1;
+                batch_msg.step = static_cast<uint32_t>(count * sizeof(rs2_motion_sample));
+                convert(RS2_FORMAT_MOTION_XYZ32F_BATCH, batch_msg.encoding);
+                batch_msg.is_bigendian = is_big_endian();
+                auto p_data = reinterpret_cast<const uint8_t*>(samples);
+                batch_msg.data.assign(p_data, p_data + batch_msg.step);
+                batch_msg.header.seq = static_cast<uint32_t>(frame.frame->get_frame_number());
+                batch_msg.header.stamp = ros::Time(std::chrono::duration<double>(timestamp_ms).count());
+                write_message(topic, timestamp, batch_msg);
+            }
+
+            try
+            {
+                write_frame_metadata(ros_topic::imu_metadata_record_topic(stream_id), timestamp, frame.frame);
+            }
+            catch (std::exception const& e)
+            {
+                LOG_WARNING("Failed to write imu metadata for " << stream_id.device_index << "/" << stream_id.sensor_index << "/" << stream_id.stream_type << "/" << stream_id.stream_index << " ts: " << timestamp.count() << ". Exception: " << e.what());
+            }
+            try
+            {
+                write_extrinsics(stream_id, frame);
+            }
+            catch (std::exception const& e)
+            {
+                LOG_WARNING("Failed to write stream extrinsics for " << stream_id.device_index << "/" << stream_id.sensor_index << "/" << stream_id.stream_type << "/" << stream_id.stream_index << " ts: " << timestamp.count() << ". Exception: " << e.what());
+            }
+        }
+
+        // Motion profiles carry no snapshot of their own, their stream info is written along with the first frame
+        void write_motion_stream_info(const stream_identifier& stream_id, const std::shared_ptr<stream_profile_interface>& profile)
+        {
+            if (!m_written_motion_infos.insert(stream_id).second)
+            {
+                return;
+            }
+
+            realsense_msgs::StreamInfo stream_info_msg;
+            stream_info_msg.is_recommended = profile->is_default();
+            convert(profile->get_format(), stream_info_msg.encoding);
+            stream_info_msg.fps = profile->get_framerate();
+            write_message(ros_topic::stream_info_topic(stream_id), get_static_file_info_timestamp(), stream_info_msg);
+
+            realsense_msgs::ImuIntrinsic intrinsic_msg;
+            write_message(ros_topic::imu_intrinsic_topic(stream_id), get_static_file_info_timestamp(), intrinsic_msg);
+        }
+
         void write_extrinsics(const stream_identifier& stream_id, const frame_holder& frame)
         {
             if(m_extrinsics_msgs.find(stream_id) != m_extrinsics_msgs.end())
@@ -149,31 +447,33 @@ namespace librealsense
             m_extrinsics_msgs[stream_id] = tf_msg;
         }
 
-        void write_image_metadata(const stream_identifier& stream_id, const nanoseconds& timestamp, video_frame* vid_frame)
+        // A single packed record per frame, see METADATA_RECORD_HEADER_SIZE for its layout
+        void write_frame_metadata(const std::string& metadata_topic, const nanoseconds& timestamp, frame_interface* frame)
         {
-            auto metadata_topic = ros_topic::image_metadata_topic(stream_id);
-            diagnostic_msgs::KeyValue system_time;
-            system_time.key = "system_time";
-            system_time.value = std::to_string(vid_frame->get_frame_system_time());
-            write_message(metadata_topic, timestamp, system_time);
+            std_msgs::UInt8MultiArray record;
+            auto append = [&record](const void* value, size_t size)
+            {
+                auto bytes = static_cast<const uint8_t*>(value);
+                record.data.insert(record.data.end(), bytes, bytes + size);
+            };
 
-            diagnostic_msgs::KeyValue timestamp_domain;
-            timestamp_domain.key = "timestamp_domain";
-            timestamp_domain.value = to_string() << vid_frame->get_frame_timestamp_domain();
-            write_message(metadata_topic, timestamp, timestamp_domain);
+            double system_time = frame->get_frame_system_time();
+            int32_t timestamp_domain = frame->get_frame_timestamp_domain();
+            record.data.reserve(METADATA_RECORD_HEADER_SIZE + RS2_FRAME_METADATA_COUNT * METADATA_RECORD_PAIR_SIZE);
+            append(&system_time, sizeof(system_time));
+            append(&timestamp_domain, sizeof(timestamp_domain));
 
             for (int i = 0; i < static_cast<rs2_frame_metadata_value>(rs2_frame_metadata_value::RS2_FRAME_METADATA_COUNT); i++)
             {
                 rs2_frame_metadata_value type = static_cast<rs2_frame_metadata_value>(i);
-                if (vid_frame->supports_frame_metadata(type))
+                if (frame->supports_frame_metadata(type))
                 {
-                    auto md = vid_frame->get_frame_metadata(type);
-                    diagnostic_msgs::KeyValue md_msg;
-                    md_msg.key = to_string() << type;
-                    md_msg.value = std::to_string(md);
-                    write_message(metadata_topic, timestamp, md_msg);
+                    rs2_metadata_type md = frame->get_frame_metadata(type);
+                    append(&type, sizeof(type));
+                    append(&md, sizeof(md));
                 }
             }
+            write_message(metadata_topic, timestamp, record);
         }
 
         void write_streaming_info(nanoseconds timestamp, const sensor_identifier& sensor_id, std::shared_ptr<video_stream_profile_interface> profile)
@@ -354,8 +654,15 @@ namespace librealsense
         }
 
         std::map<stream_identifier, geometry_msgs::Transform> m_extrinsics_msgs;
+        std::set<stream_identifier> m_written_motion_infos;
         std::string m_file_path;
         rosbag::Bag m_bag;
+        bool m_encode_depth;
+        std::vector<uint8_t> m_depth_buffer;   // Encoded depth of the frame being written
+        std::vector<uint8_t> m_thumbnail_buffer;
+        std::map<stream_identifier, nanoseconds> m_last_thumbnail_times;
         std::map<uint32_t, std::set<rs2_option>> m_written_options_descriptions;
+        nanoseconds m_frames_begin_time = nanoseconds::max();
+        nanoseconds m_frames_end_time = nanoseconds::min();
     };
 }
@@ -0,0 +1,96 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include "types.h"
+#include "segment_manifest.h"
+
+namespace librealsense
+{
+    static const char* SEGMENT_MANIFEST_HEADER = "#RSSEGMENTS V1";
+
+    static std::string::size_type get_file_name_start(const std::string& path)
+    {
+        auto separator = path.find_last_of("/\\");
+        return separator == std::string::npos ? 0 : separator + 1;
+    }
+
+    bool is_segment_manifest(const std::string& path)
+    {
+        std::ifstream file(path);
+        std::string header;
+        return file && std::getline(file, header) && header.compare(0, strlen(SEGMENT_MANIFEST_HEADER), SEGMENT_MANIFEST_HEADER) == 0;
+    }
+
+    std::vector<recording_segment> read_segment_manifest(const std::string& path)
+    {
+        std::ifstream file(path);
+        std::string line;
+        if (!file || !std::getline(file, line) || line.compare(0, strlen(SEGMENT_MANIFEST_HEADER), SEGMENT_MANIFEST_HEADER) != 0)
+        {
+            throw io_exception(to_string() << "\"" << path << "\" is not a segment manifest");
+        }
+
+        auto directory = path.substr(0, get_file_name_start(path));
+        std::vector<recording_segment> segments;
+        while (std::getline(file, line))
+        {
+            if (line.empty() || line[0] == '#')
+                continue;
+
+            std::istringstream fields(line);
+            long long start, end;
+            std::string name;
+            if (!(fields >> start >> end >> std::ws) || !std::getline(fields, name) || name.empty() || end < start)
+            {
+                throw io_exception(to_string() << "Invalid segment manifest \"" << path << "\", line: " << line);
+            }
+            segments.push_back({ directory + name, device_serializer::nanoseconds(start), device_serializer::nanoseconds(end) });
+        }
+        if (segments.empty())
+        {
+            throw io_exception(to_string() << "Segment manifest \"" << path << "\" lists no segments");
+        }
+        return segments;
+    }
+
+    void write_segment_manifest(const std::string& path, const std::vector<recording_segment>& segments)
+    {
+        auto temp_path = path + ".tmp";
+        {
+            std::ofstream file(temp_path, std::ios::trunc);
+            file << SEGMENT_MANIFEST_HEADER << "\n";
+            for (auto&& segment : segments)
+            {
+                file << segment.start.count() << " " << segment.end.count() << " " << segment.file.substr(get_file_name_start(segment.file)) << "\n";
+            }
+            if (!file.flush())
+            {
+                throw io_exception(to_string() << "Failed to write segment manifest \"" << temp_path << "\"");
+            }
+        }
+        //rename does not replace an existing file on all platforms
+        std::remove(path.c_str());
+        if (std::rename(temp_path.c_str(), path.c_str()) != 0)
+        {
+            throw io_exception(to_string() << "Failed to replace segment manifest \"" << path << "\"");
+        }
+    }
+
+    std::string get_segment_path(const std::string& manifest_path, uint32_t index)
+    {
+        auto base = manifest_path;
+        auto extension = base.find_last_of('.');
+        if (extension != std::string::npos && extension >= get_file_name_start(base))
+        {
+            base.erase(extension);
+        }
+        std::ostringstream segment_path;
+        segment_path << base << "_" << std::setw(4) << std::setfill('0') << index << ".bag";
+        return segment_path.str();
+    }
+}
@@ -0,0 +1,36 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include "core/serialization.h"
+
+namespace librealsense
+{
+    // A segmented recording is a set of bag files, listed in order by a small text manifest:
+    //
+    //     #RSSEGMENTS V1
+    //     <first frame time> <last frame time> <file name>
+    //     ...
+    //
+    // Times are nanoseconds on the timeline of the whole recording, file names are relative to the manifest
+    struct recording_segment
+    {
+        std::string file;
+        device_serializer::nanoseconds start;
+        device_serializer::nanoseconds end;
+    };
+
+    bool is_segment_manifest(const std::string& path);
+
+    // Returns the segments with their full paths, throws io_exception if the manifest can not be read
+    std::vector<recording_segment> read_segment_manifest(const std::string& path);
+
+    // Replaces the manifest in one step, so a reader never sees a partially written one
+    void write_segment_manifest(const std::string& path, const std::vector<recording_segment>& segments);
+
+    // Path of the n-th segment of the recording with the given manifest
+    std::string get_segment_path(const std::string& manifest_path, uint32_t index);
+}
@@ -0,0 +1,302 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#include "metrics.h"
+#include "types.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <tuple>
+
+#ifdef __GNUG__
+#include <cxxabi.h>
+#endif
+
+namespace librealsense
+{
+    static const double LATENCY_BOUNDS_MS[] = { 0.25, 0.5, 1, 2, 5, 10, 20, 50, 100, 250, 1000 };
+
+    metric_histogram::metric_histogram(std::vector<double> bounds)
+        : _bounds(std::move(bounds)), _counts(new std::atomic<uint64_t>[_bounds.size() + 1])
+    {
+        for (size_t i = 0; i <= _bounds.size(); i++) _counts[i] = 0;
+    }
+
+    void metric_histogram::observe(double value)
+    {
+        auto bucket = std::lower_bound(_bounds.begin(), _bounds.end(), value) - _bounds.begin();
+        _counts[bucket].fetch_add(1, std::memory_order_relaxed);
+        auto sum = _sum.load(std::memory_order_relaxed);
+        while (!_sum.compare_exchange_weak(sum, sum + value, std::memory_order_relaxed));
+    }
+
+    std::vector<uint64_t> metric_histogram::get_counts() const
+    {
+        std::vector<uint64_t> counts(_bounds.size() + 1);
+        for (size_t i = 0; i < counts.size(); i++) counts[i] = _counts[i].load(std::memory_order_relaxed);
+        return counts;
+    }
+
+    static std::string format_labels(const metric_labels& labels)
+    {
+        std::string result;
+        for (auto&& label : labels)
+        {
+            if (!result.empty()) result += ",";
+            result += label.first + "=\"";
+            for (auto c : label.second)
+            {
+                if (c == '\\' || c == '"') result += '\\';
+                if (c == '\n') { result += "\\n"; continue; }
+                result += c;
+            }
+            result += "\"";
+        }
+        return result;
+    }
+
+    class metrics_registry
+    {
+    public:
+        static metrics_registry& get()
+        {
+            // Never destroyed, as the frame paths of other singletons may update metrics after static destruction
+            static auto instance = new metrics_registry();
+            return *instance;
+        }
+
+        std::atomic<bool> enabled;
+
+        template<class T>
+        T& get_metric(std::map<std::pair<std::string, std::string>, std::unique_ptr<T>>& metrics,
+                      const std::string& name, const std::string& help, const metric_labels& labels,
+                      rs2_metric_type type, std::function<T*()> create)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto family = _families.find(name);
+            if (family == _families.end())
+                _families[name] = { help, type };
+            else if (family->second.type != type)
+                throw invalid_value_exception(to_string() << "Metric " << name << " is already a " << get_string(family->second.type));
+
+            auto&& metric = metrics[std::make_pair(name, format_labels(labels))];
+            if (!metric) metric.reset(create());
+            return *metric;
+        }
+
+        uint64_t add_sampler(const std::string& name, const std::string& help, const metric_labels& labels, std::function<double()> sample)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto id = ++_last_sampler;
+            _samplers[id] = { name, format_labels(labels), help, std::move(sample) };
+            return id;
+        }
+
+        void remove_sampler(uint64_t id)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _samplers.erase(id);
+        }
+
+        std::vector<metric_sample> query()
+        {
+            std::vector<metric_sample> samples;
+            std::vector<std::pair<size_t, std::function<double()>>> sample_functions;
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                for (auto&& kvp : counters)
+                    samples.push_back({ kvp.first.first, kvp.first.second, _families[kvp.first.first].help,
+                                        RS2_METRIC_TYPE_COUNTER, double(kvp.second->get()), 0, {} });
+                for (auto&& kvp : gauges)
+                    samples.push_back({ kvp.first.first, kvp.first.second, _families[kvp.first.first].help,
+                                        RS2_METRIC_TYPE_GAUGE, kvp.second->get(), 0, {} });
+                for (auto&& kvp : histograms)
+                {
+                    metric_sample sample{ kvp.first.first, kvp.first.second, _families[kvp.first.first].help,
+                                          RS2_METRIC_TYPE_HISTOGRAM, 0, kvp.second->get_sum(), {} };
+                    auto&& bounds = kvp.second->get_bounds();
+                    auto counts = kvp.second->get_counts();
+                    uint64_t total = 0;
+                    for (size_t i = 0; i < counts.size(); i++)
+                    {
+                        total += counts[i];
+                        sample.buckets.push_back({ i < bounds.size() ? bounds[i] : INFINITY, total });
+                    }
+                    sample.value = double(total);
+                    samples.push_back(sample);
+                }
+                for (auto&& kvp : _samplers)
+                {
+                    sample_functions.push_back({ samples.size(), kvp.second.sample });
+                    samples.push_back({ kvp.second.name, kvp.second.labels, kvp.second.help, RS2_METRIC_TYPE_GAUGE, 0, 0, {} });
+                }
+            }
+
+            // Sampled outside the lock, as reading a value may take a while, as for the temperature of a device
+            std::vector<bool> failed(samples.size(), false);
+            for (auto&& s : sample_functions)
+            {
+                try { samples[s.first].value = s.second(); }
+                catch (...) { failed[s.first] = true; }
+            }
+            std::vector<metric_sample> result;
+            for (size_t i = 0; i < samples.size(); i++)
+                if (!failed[i]) result.push_back(std::move(samples[i]));
+
+            std::stable_sort(result.begin(), result.end(), [](const metric_sample& a, const metric_sample& b)
+            {
+                return std::tie(a.name, a.labels) < std::tie(b.name, b.labels);
+            });
+            return result;
+        }
+
+        std::map<std::pair<std::string, std::string>, std::unique_ptr<metric_counter>> counters;
+        std::map<std::pair<std::string, std::string>, std::unique_ptr<metric_gauge>> gauges;
+        std::map<std::pair<std::string, std::string>, std::unique_ptr<metric_histogram>> histograms;
+
+    private:
+        struct family
+        {
+            std::string help;
+            rs2_metric_type type;
+        };
+
+        struct sampler
+        {
+            std::string name;
+            std::string labels;
+            std::string help;
+            std::function<double()> sample;
+        };
+
+        metrics_registry() : enabled(getenv("LRS_METRICS") != nullptr), _last_sampler(0) {}
+
+        std::mutex _mutex;
+        std::map<std::string, family> _families;
+        std::map<uint64_t, sampler> _samplers;
+        uint64_t _last_sampler;
+    };
+
+    void enable_metrics(bool enable)
+    {
+        metrics_registry::get().enabled = enable;
+    }
+
+    bool metrics_enabled()
+    {
+        return metrics_registry::get().enabled;
+    }
+
+    // While metrics are disabled, updates go to these, which no snapshot reports
+    static metric_counter unreported_counter;
+    static metric_gauge unreported_gauge;
+    static metric_histogram unreported_histogram({});
+
+    metric_counter& get_counter(const std::string& name, const std::string& help, const metric_labels& labels)
+    {
+        auto&& registry = metrics_registry::get();
+        if (!registry.enabled) return unreported_counter;
+        return registry.get_metric<metric_counter>(registry.counters, name, help, labels, RS2_METRIC_TYPE_COUNTER,
+            []() { return new metric_counter(); });
+    }
+
+    metric_gauge& get_gauge(const std::string& name, const std::string& help, const metric_labels& labels)
+    {
+        auto&& registry = metrics_registry::get();
+        if (!registry.enabled) return unreported_gauge;
+        return registry.get_metric<metric_gauge>(registry.gauges, name, help, labels, RS2_METRIC_TYPE_GAUGE,
+            []() { return new metric_gauge(); });
+    }
+
+    metric_histogram& get_histogram(const std::string& name, const std::string& help, const metric_labels& labels)
+    {
+        auto&& registry = metrics_registry::get();
+        if (!registry.enabled) return unreported_histogram;
+        return registry.get_metric<metric_histogram>(registry.histograms, name, help, labels, RS2_METRIC_TYPE_HISTOGRAM, []()
+        {
+            return new metric_histogram(std::vector<double>(std::begin(LATENCY_BOUNDS_MS), std::end(LATENCY_BOUNDS_MS)));
+        });
+    }
+
+    sampled_gauge::sampled_gauge(const std::string& name, const std::string& help, const metric_labels& labels, std::function<double()> sample)
+        : _id(0)
+    {
+        auto&& registry = metrics_registry::get();
+        if (registry.enabled) _id = registry.add_sampler(name, help, labels, std::move(sample));
+    }
+
+    sampled_gauge::~sampled_gauge()
+    {
+        if (_id) metrics_registry::get().remove_sampler(_id);
+    }
+
+    std::vector<metric_sample> query_metrics()
+    {
+        return metrics_registry::get().query();
+    }
+
+    static std::string format_value(double value)
+    {
+        if (std::isnan(value)) return "NaN";
+        if (std::isinf(value)) return value > 0 ? "+Inf" : "-Inf";
+        std::ostringstream s;
+        s << std::setprecision(15) << value;
+        return s.str();
+    }
+
+    static std::string with_labels(const std::string& name, const std::string& labels, const std::string& extra = "")
+    {
+        auto all = labels.empty() ? extra : extra.empty() ? labels : labels + "," + extra;
+        return all.empty() ? name : name + "{" + all + "}";
+    }
+
+    std::string format_metrics(const std::vector<metric_sample>& samples)
+    {
+        static const char* type_names[] = { "counter", "gauge", "histogram" };
+
+        std::ostringstream out;
+        const std::string* last_name = nullptr;
+        for (auto&& sample : samples)
+        {
+            if (!last_name || *last_name != sample.name)
+            {
+                if (!sample.help.empty()) out << "# HELP " << sample.name << " " << sample.help << "\n";
+                out << "# TYPE " << sample.name << " " << type_names[sample.type] << "\n";
+                last_name = &sample.name;
+            }
+
+            if (sample.type != RS2_METRIC_TYPE_HISTOGRAM)
+            {
+                out << with_labels(sample.name, sample.labels) << " " << format_value(sample.value) << "\n";
+                continue;
+            }
+            for (auto&& bucket : sample.buckets)
+                out << with_labels(sample.name + "_bucket", sample.labels, "le=\"" + format_value(bucket.first) + "\"")
+                    << " " << bucket.second << "\n";
+            out << with_labels(sample.name + "_sum", sample.labels) << " " << format_value(sample.sum) << "\n";
+            out << with_labels(sample.name + "_count", sample.labels) << " " << format_value(sample.value) << "\n";
+        }
+        return out.str();
+    }
+
+    std::string get_class_name(const std::type_info& type)
+    {
+        std::string name = type.name();
+#ifdef __GNUG__
+        int status = 0;
+        if (auto demangled = abi::__cxa_demangle(type.name(), nullptr, nullptr, &status))
+        {
+            name = demangled;
+            free(demangled);
+        }
+#endif
+        if (name.compare(0, 6, "class ") == 0) name = name.substr(6);
+        auto scope = name.rfind("::", name.find('<'));
+        return scope == std::string::npos ? name : name.substr(scope + 2);
+    }
+}
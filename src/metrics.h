@@ -0,0 +1,106 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "../include/librealsense2/h/rs_types.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+namespace librealsense
+{
+    // Metrics are updated with relaxed atomics, so the frame paths updating them never wait on a lock
+    // Only getting a metric takes the lock of the registry, which is done when a sensor or block is set up
+    class metric_counter
+    {
+    public:
+        void add(uint64_t n = 1) { _value.fetch_add(n, std::memory_order_relaxed); }
+        uint64_t get() const { return _value.load(std::memory_order_relaxed); }
+
+    private:
+        std::atomic<uint64_t> _value{ 0 };
+    };
+
+    class metric_gauge
+    {
+    public:
+        void set(double value) { _value.store(value, std::memory_order_relaxed); }
+        double get() const { return _value.load(std::memory_order_relaxed); }
+
+    private:
+        std::atomic<double> _value{ 0 };
+    };
+
+    // Counts of the observed values up to each bound, and their sum
+    class metric_histogram
+    {
+    public:
+        explicit metric_histogram(std::vector<double> bounds);
+
+        void observe(double value);
+
+        const std::vector<double>& get_bounds() const { return _bounds; }
+        // Counts up to each bound, not cumulative, the last one of the values above all the bounds
+        std::vector<uint64_t> get_counts() const;
+        double get_sum() const { return _sum.load(std::memory_order_relaxed); }
+
+    private:
+        std::vector<double> _bounds;
+        std::unique_ptr<std::atomic<uint64_t>[]> _counts;
+        std::atomic<double> _sum{ 0 };
+    };
+
+    typedef std::vector<std::pair<std::string, std::string>> metric_labels;
+
+    struct metric_sample
+    {
+        std::string name;
+        std::string labels;     // As written between the braces of the exposition format, empty for none
+        std::string help;
+        rs2_metric_type type;
+        double value;           // Value of counters and gauges, number of observations of histograms
+        double sum;             // Sum of the observations of histograms
+        std::vector<std::pair<double, uint64_t>> buckets;   // Cumulative counts of histograms up to each bound
+    };
+
+    // Metrics are kept only once enabled, by rs2_enable_metrics or by defining LRS_METRICS in the environment
+    // Sensors and blocks set up before that update metrics no snapshot reports
+    void enable_metrics(bool enable);
+    bool metrics_enabled();
+
+    // The metric of the name and labels, shared by everyone getting it. Metrics live as long as the process
+    // Histograms count latencies, with bounds in milliseconds
+    metric_counter& get_counter(const std::string& name, const std::string& help, const metric_labels& labels);
+    metric_gauge& get_gauge(const std::string& name, const std::string& help, const metric_labels& labels);
+    metric_histogram& get_histogram(const std::string& name, const std::string& help, const metric_labels& labels);
+
+    // Gauge read when a snapshot is taken, for values that are not updated on a path of the library
+    // The sample function runs on the thread taking the snapshot, until the object is destroyed
+    class sampled_gauge
+    {
+    public:
+        sampled_gauge(const std::string& name, const std::string& help, const metric_labels& labels, std::function<double()> sample);
+        ~sampled_gauge();
+
+        sampled_gauge(const sampled_gauge&) = delete;
+        sampled_gauge& operator=(const sampled_gauge&) = delete;
+
+    private:
+        uint64_t _id;
+    };
+
+    std::vector<metric_sample> query_metrics();
+
+    // Samples in the Prometheus text exposition format
+    std::string format_metrics(const std::vector<metric_sample>& samples);
+
+    // Name of a class without its namespace, for labels of metrics kept per class
+    std::string get_class_name(const std::type_info& type);
+}
@@ -6,6 +6,11 @@
 #include "sql.h"
 #include <algorithm>
 #include "types.h"
+#include "../../third-party/realsense-file/lz4/lz4.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 using namespace std;
 using namespace sql;
@@ -16,6 +21,8 @@ const char* CONFIG_CREATE = "CREATE TABLE rs_config(section NUMBER, key TEXT, va
 const char* CONFIG_INSERT = "INSERT OR REPLACE INTO rs_config(section, key, value) VALUES(?, ?, ?)";
 const char* API_VERSION_KEY = "api_version";
 const char* CREATED_AT_KEY = "created_at";
+const char* FRAME_CODEC_KEY = "frame_codec";
+const int FRAME_CODEC_VERSION = 3; // Highest frame_codec the recording may use
 
 const char* SECTIONS_TABLE = "rs_sections";
 const char* SECTIONS_SELECT_MAX_ID = "SELECT max(key) from rs_sections";
@@ -144,11 +151,84 @@ namespace librealsense
             return results;
         }
 
+        const vector<uint8_t>& compression_algorithm::encode_delta_lz4(const uint8_t* data, size_t size) const
+        {
+            static thread_local vector<uint8_t> delta;
+            static thread_local vector<uint8_t> results;
+
+            // Every 16-bit word becomes its difference from the previous one, an odd last byte is kept as is
+            delta.resize(size);
+            auto words = size / 2;
+            auto in = reinterpret_cast<const uint16_t*>(data);
+            auto out = reinterpret_cast<uint16_t*>(delta.data());
+            size_t i = 0;
+            if (words) out[i++] = in[0];
+#ifdef __SSE2__
+            for (; i + 8 <= words; i += 8)
+            {
+                auto curr = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+                auto prev = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i - 1));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_sub_epi16(curr, prev));
+            }
+#endif
+            for (; i < words; i++) out[i] = static_cast<uint16_t>(in[i] - in[i - 1]);
+            if (size % 2) delta[size - 1] = data[size - 1];
+
+            // The size of the frame leads the compressed data
+            uint32_t raw_size = static_cast<uint32_t>(size);
+            results.resize(sizeof(raw_size) + LZ4_compressBound(static_cast<int>(size)));
+            memcpy(results.data(), &raw_size, sizeof(raw_size));
+            auto compressed = LZ4_compress_default(reinterpret_cast<const char*>(delta.data()),
+                reinterpret_cast<char*>(results.data() + sizeof(raw_size)), static_cast<int>(size), static_cast<int>(results.size() - sizeof(raw_size)));
+            if (compressed <= 0 && size)
+                throw runtime_error("Failed to compress a frame of the recording!");
+            results.resize(sizeof(raw_size) + compressed);
+            return results;
+        }
+
+        vector<uint8_t> compression_algorithm::decode_delta_lz4(const vector<uint8_t>& input) const
+        {
+            uint32_t raw_size;
+            if (input.size() < sizeof(raw_size))
+                throw runtime_error("Compressed frame of the recording is truncated!");
+            memcpy(&raw_size, input.data(), sizeof(raw_size));
+
+            vector<uint8_t> results(raw_size);
+            auto decompressed = LZ4_decompress_safe(reinterpret_cast<const char*>(input.data() + sizeof(raw_size)),
+                reinterpret_cast<char*>(results.data()), static_cast<int>(input.size() - sizeof(raw_size)), static_cast<int>(raw_size));
+            if (decompressed != static_cast<int>(raw_size))
+                throw runtime_error("Compressed frame of the recording is corrupted!");
+
+            auto words = reinterpret_cast<uint16_t*>(results.data());
+            for (size_t i = 1; i < raw_size / 2; i++)
+                words[i] = static_cast<uint16_t>(words[i] + words[i - 1]);
+            return results;
+        }
+
         recording::recording(std::shared_ptr<time_service> ts, std::shared_ptr<playback_device_watcher> watcher)
             :_ts(ts), _watcher(watcher)
         {
         }
 
+        recording::~recording()
+        {
+            if (_spill)
+            {
+                _spill.reset();
+                std::remove(_spill_filename.c_str());
+            }
+        }
+
+        void recording::spill_blobs_to(const std::string& filename)
+        {
+            lock_guard<recursive_mutex> lock(_mutex);
+            std::unique_ptr<std::ofstream> spill(new std::ofstream(filename, std::ios::binary | std::ios::trunc));
+            if (!*spill)
+                throw runtime_error(to_string() << "Could not create " << filename << "!");
+            _spill = std::move(spill);
+            _spill_filename = filename;
+        }
+
         void recording::invoke_device_changed_event()
         {
             call* next;
@@ -172,6 +252,10 @@ namespace librealsense
             connection c(filename);
             LOG_WARNING("Saving recording to file, don't close the application");
 
+            // Rows are written in a single transaction, so the journal needs no sync per page
+            c.execute("PRAGMA journal_mode=WAL");
+            c.execute("PRAGMA synchronous=NORMAL");
+
             if (!c.table_exists(CONFIG_TABLE))
             {
                 c.execute(SECTIONS_CREATE);
@@ -246,69 +330,80 @@ namespace librealsense
                     insert.bind(3, datetime.c_str());
                     insert();
                 }
+
+                {
+                    statement insert(c, CONFIG_INSERT);
+                    insert.bind(1, section_id);
+                    insert.bind(2, FRAME_CODEC_KEY);
+                    auto version = std::to_string(FRAME_CODEC_VERSION);
+                    insert.bind(3, version.c_str());
+                    insert();
+                }
             }
 
             c.transaction([&]()
             {
+                // Every statement is prepared once and reset between its rows
+                statement insert_call(c, CALLS_INSERT);
                 for (auto&& cl : calls)
                 {
-                    statement insert(c, CALLS_INSERT);
-                    insert.bind(1, section_id);
-                    insert.bind(2, static_cast<int>(cl.type));
-                    insert.bind(3, cl.timestamp);
-                    insert.bind(4, cl.entity_id);
-                    insert.bind(5, cl.inline_string.c_str());
-                    insert.bind(6, cl.param1);
-                    insert.bind(7, cl.param2);
-                    insert.bind(8, cl.param3);
-                    insert.bind(9, cl.param4);
-                    insert.bind(10, cl.param5);
-                    insert.bind(11, cl.param6);
-                    insert.bind(12, cl.had_error ? 1 : 0);
-                    insert.bind(13, cl.param7);
-                    insert.bind(14, cl.param8);
-                    insert.bind(15, cl.param9);
-                    insert.bind(16, cl.param10);
-                    insert.bind(17, cl.param11);
-                    insert.bind(18, cl.param12);
-
-                    insert();
+                    insert_call.bind(1, section_id);
+                    insert_call.bind(2, static_cast<int>(cl.type));
+                    insert_call.bind(3, cl.timestamp);
+                    insert_call.bind(4, cl.entity_id);
+                    insert_call.bind(5, cl.inline_string.c_str());
+                    insert_call.bind(6, cl.param1);
+                    insert_call.bind(7, cl.param2);
+                    insert_call.bind(8, cl.param3);
+                    insert_call.bind(9, cl.param4);
+                    insert_call.bind(10, cl.param5);
+                    insert_call.bind(11, cl.param6);
+                    insert_call.bind(12, cl.had_error ? 1 : 0);
+                    insert_call.bind(13, cl.param7);
+                    insert_call.bind(14, cl.param8);
+                    insert_call.bind(15, cl.param9);
+                    insert_call.bind(16, cl.param10);
+                    insert_call.bind(17, cl.param11);
+                    insert_call.bind(18, cl.param12);
+
+                    insert_call();
+                    insert_call.reset();
                 }
 
+                statement insert_device(c, DEVICE_INFO_INSERT);
                 for (auto&& uvc_info : uvc_device_infos)
                 {
-                    statement insert(c, DEVICE_INFO_INSERT);
-                    insert.bind(1, section_id);
-                    insert.bind(2, (int)device_type::uvc);
-                    insert.bind(3, "");
-                    insert.bind(4, uvc_info.unique_id.c_str());
-                    insert.bind(5, (int)uvc_info.pid);
-                    insert.bind(6, (int)uvc_info.vid);
-                    insert.bind(7, (int)uvc_info.mi);
-                    insert();
+                    insert_device.bind(1, section_id);
+                    insert_device.bind(2, (int)device_type::uvc);
+                    insert_device.bind(3, "");
+                    insert_device.bind(4, uvc_info.unique_id.c_str());
+                    insert_device.bind(5, (int)uvc_info.pid);
+                    insert_device.bind(6, (int)uvc_info.vid);
+                    insert_device.bind(7, (int)uvc_info.mi);
+                    insert_device();
+                    insert_device.reset();
                 }
 
                 for (auto&& usb_info : usb_device_infos)
                 {
-                    statement insert(c, DEVICE_INFO_INSERT);
-                    insert.bind(1, section_id);
-                    insert.bind(2, (int)device_type::usb);
+                    insert_device.bind(1, section_id);
+                    insert_device.bind(2, (int)device_type::usb);
                     string id(usb_info.id.begin(), usb_info.id.end());
-                    insert.bind(3, id.c_str());
-                    insert.bind(4, usb_info.unique_id.c_str());
-                    insert.bind(5, (int)usb_info.pid);
-                    insert.bind(6, (int)usb_info.vid);
-                    insert.bind(7, (int)usb_info.mi);
-                    insert();
+                    insert_device.bind(3, id.c_str());
+                    insert_device.bind(4, usb_info.unique_id.c_str());
+                    insert_device.bind(5, (int)usb_info.pid);
+                    insert_device.bind(6, (int)usb_info.vid);
+                    insert_device.bind(7, (int)usb_info.mi);
+                    insert_device();
+                    insert_device.reset();
                 }
 
                 for (auto&& hid_info : hid_device_infos)
                 {
-                    statement insert(c, DEVICE_INFO_INSERT);
-                    insert.bind(1, section_id);
-                    insert.bind(2, (int)device_type::hid);
-                    insert.bind(3, hid_info.id.c_str());
-                    insert.bind(4, hid_info.unique_id.c_str());
+                    insert_device.bind(1, section_id);
+                    insert_device.bind(2, (int)device_type::hid);
+                    insert_device.bind(3, hid_info.id.c_str());
+                    insert_device.bind(4, hid_info.unique_id.c_str());
 
                     stringstream ss_vid(hid_info.vid);
                     stringstream ss_pid(hid_info.pid);
@@ -316,49 +411,70 @@ namespace librealsense
                     ss_vid >> hex >> vid;
                     ss_pid >> hex >> pid;
 
-                    insert.bind(5, (int)pid);
-                    insert.bind(6, (int)vid);
-                    insert.bind(7, hid_info.device_path.c_str());
-                    insert();
+                    insert_device.bind(5, (int)pid);
+                    insert_device.bind(6, (int)vid);
+                    insert_device.bind(7, hid_info.device_path.c_str());
+                    insert_device();
+                    insert_device.reset();
                 }
 
                 for (auto&& hid_info : hid_sensors)
                 {
-                    statement insert(c, DEVICE_INFO_INSERT);
-                    insert.bind(1, section_id);
-                    insert.bind(2, (int)device_type::hid_sensor);
-                    insert.bind(3, hid_info.name.c_str());
-                    insert.bind(4, "");
-                    insert();
+                    insert_device.bind(1, section_id);
+                    insert_device.bind(2, (int)device_type::hid_sensor);
+                    insert_device.bind(3, hid_info.name.c_str());
+                    insert_device.bind(4, "");
+                    insert_device();
+                    insert_device.reset();
                 }
 
                 for (auto&& hid_info : hid_sensor_inputs)
                 {
-                    statement insert(c, DEVICE_INFO_INSERT);
-                    insert.bind(1, section_id);
-                    insert.bind(2, (int)device_type::hid_input);
-                    insert.bind(3, hid_info.name.c_str());
-                    insert.bind(4, "");
-                    insert();
+                    insert_device.bind(1, section_id);
+                    insert_device.bind(2, (int)device_type::hid_input);
+                    insert_device.bind(3, hid_info.name.c_str());
+                    insert_device.bind(4, "");
+                    insert_device();
+                    insert_device.reset();
                 }
 
+                statement insert_profile(c, PROFILES_INSERT);
                 for (auto&& profile : this->stream_profiles)
                 {
-                    statement insert(c, PROFILES_INSERT);
-                    insert.bind(1, section_id);
-                    insert.bind(2, (int)profile.width);
-                    insert.bind(3, (int)profile.height);
-                    insert.bind(4, (int)profile.fps);
-                    insert.bind(5, (int)profile.format);
-                    insert();
+                    insert_profile.bind(1, section_id);
+                    insert_profile.bind(2, (int)profile.width);
+                    insert_profile.bind(3, (int)profile.height);
+                    insert_profile.bind(4, (int)profile.fps);
+                    insert_profile.bind(5, (int)profile.format);
+                    insert_profile();
+                    insert_profile.reset();
                 }
 
+                statement insert_blob(c, BLOBS_INSERT);
                 for (auto&& blob : blobs)
                 {
-                    statement insert(c, BLOBS_INSERT);
-                    insert.bind(1, section_id);
-                    insert.bind(2, blob);
-                    insert();
+                    insert_blob.bind(1, section_id);
+                    insert_blob.bind(2, blob);
+                    insert_blob();
+                    insert_blob.reset();
+                }
+
+                // The blobs of the session were appended to the spill file in the order of their ids
+                if (_spill)
+                {
+                    _spill->flush();
+                    std::ifstream spilled(_spill_filename, std::ios::binary);
+                    vector<uint8_t> blob;
+                    for (auto size : _spilled_sizes)
+                    {
+                        blob.resize(size);
+                        if (!spilled.read(reinterpret_cast<char*>(blob.data()), size))
+                            throw runtime_error(to_string() << "Could not read the blobs of the recording from " << _spill_filename << "!");
+                        insert_blob.bind(1, section_id);
+                        insert_blob.bind(2, blob);
+                        insert_blob();
+                        insert_blob.reset();
+                    }
                 }
             });
         }
@@ -405,6 +521,19 @@ namespace librealsense
                 LOG_WARNING("Loaded recording from API version " << api_version);
             }
 
+            // Recordings made before the key was added only use the older codecs
+            {
+                statement select_frame_codec(c, CONFIG_QUERY);
+                select_frame_codec.bind(1, section_id);
+                select_frame_codec.bind(2, FRAME_CODEC_KEY);
+                for (auto&& row : select_frame_codec)
+                {
+                    if (std::stoi(row[0].get_string()) > FRAME_CODEC_VERSION)
+                        throw runtime_error(to_string() << "Recording section " << section << " uses frame codec " << row[0].get_string()
+                                                        << ", newer than supported!");
+                }
+            }
+
             statement select_calls(c, CALLS_SELECT_ALL);
             select_calls.bind(1, section_id);
 
@@ -513,6 +642,16 @@ namespace librealsense
         int recording::save_blob(const void* ptr, size_t size)
         {
             lock_guard<recursive_mutex> lock(_mutex);
+            if (_spill)
+            {
+                _spill->write(static_cast<const char*>(ptr), size);
+                if (!*_spill)
+                    throw runtime_error(to_string() << "Could not write the blobs of the recording to " << _spill_filename << "!");
+                auto id = static_cast<int>(blobs.size() + _spilled_sizes.size());
+                _spilled_sizes.push_back(size);
+                return id;
+            }
+
             vector<uint8_t> holder;
             holder.resize(size);
             librealsense::copy(holder.data(), ptr, size);
@@ -643,20 +782,20 @@ namespace librealsense
                         {
                             c.param2 = rec1->save_blob(f.pixels, static_cast<int>(f.frame_size));
                             c.param4 = static_cast<int>(f.frame_size);
-                            c.param3 = 1;
+                            c.param3 = static_cast<int>(frame_codec::raw);
                         }
                         else if (_owner->get_mode() == RS2_RECORDING_MODE_BLANK_FRAMES)
                         {
                             c.param2 = -1;
                             c.param4 = static_cast<int>(f.frame_size);
-                            c.param3 = 0;
+                            c.param3 = static_cast<int>(frame_codec::blank);
                         }
                         else
                         {
-                            auto compressed = _compression->encode((uint8_t*)f.pixels, f.frame_size);
+                            auto&& compressed = _compression->encode_delta_lz4((const uint8_t*)f.pixels, f.frame_size);
                             c.param2 = rec1->save_blob(compressed.data(), static_cast<int>(compressed.size()));
                             c.param4 = static_cast<int>(compressed.size());
-                            c.param3 = 2;
+                            c.param3 = static_cast<int>(frame_codec::delta_lz4);
                         }
 
                         c.param5 = rec1->save_blob(f.metadata, static_cast<int>(f.metadata_size));
@@ -1059,7 +1198,9 @@ namespace librealsense
             : _source(source), _rec(std::make_shared<platform::recording>(create_time_service())), _entity_count(1),
             _filename(filename),
             _section(section), _compression(make_shared<compression_algorithm>()), _mode(mode)
-        {}
+        {
+            _rec->spill_blobs_to(_filename + ".blobs");
+        }
 
         record_backend::~record_backend()
         {
@@ -1093,7 +1234,7 @@ namespace librealsense
         {
             auto&& c = _rec->find_call(call_type::create_uvc_device, 0);
 
-            return make_shared<playback_uvc_device>(_rec, c.param1);
+            return make_shared<playback_uvc_device>(_rec, c.param1, _cache_frames);
         }
 
         vector<uvc_device_info> playback_backend::query_uvc_devices() const
@@ -1123,9 +1264,10 @@ namespace librealsense
             return _device_watcher;
         }
 
-        playback_backend::playback_backend(const char* filename, const char* section)
+        playback_backend::playback_backend(const char* filename, const char* section, bool cache_frames)
             : _device_watcher(new playback_device_watcher(0)),
-            _rec(platform::recording::load(filename, section, _device_watcher))
+            _rec(platform::recording::load(filename, section, _device_watcher)),
+            _cache_frames(cache_frames)
         {
 
             LOG_DEBUG("Starting section " << section);
@@ -1351,10 +1493,14 @@ namespace librealsense
             return c.inline_string;
         }
 
-        playback_uvc_device::playback_uvc_device(shared_ptr<recording> rec, int id)
-            : _rec(rec), _entity_id(id), _alive(true)
+        playback_uvc_device::playback_uvc_device(shared_ptr<recording> rec, int id, bool cache_frames)
+            : _rec(rec), _entity_id(id), _alive(true), _cache_frames(cache_frames)
         {
-            _callback_thread = std::thread([this]() { callback_thread(); });
+            _callback_thread = std::thread([this]()
+            {
+                thread_registration registration("rs-mock-capture", RS2_THREAD_CLASS_CAPTURE);
+                callback_thread();
+            });
         }
 
         void playback_hid_device::open(const std::vector<hid_profile>& hid_profiles)
@@ -1392,7 +1538,11 @@ namespace librealsense
             _callback = callback;
             _alive = true;
 
-            _callback_thread = std::thread([this]() { callback_thread(); });
+            _callback_thread = std::thread([this]()
+            {
+                thread_registration registration("rs-mock-capture", RS2_THREAD_CLASS_CAPTURE);
+                callback_thread();
+            });
         }
 
         vector<hid_sensor> playback_hid_device::get_sensors()
@@ -1475,6 +1625,31 @@ namespace librealsense
         }
 
 
+        playback_uvc_device::recorded_frame playback_uvc_device::load_frame(const call* frame)
+        {
+            recorded_frame res;
+            switch (static_cast<frame_codec>(frame->param3))
+            {
+            case frame_codec::blank:
+                res.pixels = vector<uint8_t>(frame->param4, 0);
+                break;
+            case frame_codec::raw:
+                res.pixels = _rec->load_blob(frame->param2);
+                break;
+            case frame_codec::lossy_rle:
+                res.pixels = _compression.decode(_rec->load_blob(frame->param2));
+                break;
+            case frame_codec::delta_lz4:
+                res.pixels = _compression.decode_delta_lz4(_rec->load_blob(frame->param2));
+                break;
+            default:
+                throw runtime_error(to_string() << "Unknown codec " << frame->param3 << " of a recorded frame!");
+            }
+
+            res.metadata = _rec->load_blob(frame->param5);
+            return res;
+        }
+
         void playback_uvc_device::callback_thread()
         {
             int next_timeout_ms = 0;
@@ -1498,9 +1673,6 @@ namespace librealsense
                                 auto p = get_profile(c_ptr);
                                 if(p == pair.first)
                                 {
-                                    vector<uint8_t> frame_blob;
-                                    vector<uint8_t> metadata_blob;
-
                                     if (prev_frame_ts > 0 &&
                                         c_ptr->timestamp > prev_frame_ts &&
                                         c_ptr->timestamp - prev_frame_ts <= 300)
@@ -1510,23 +1682,22 @@ namespace librealsense
 
                                     prev_frame_ts = c_ptr->timestamp;
 
-                                    if (c_ptr->param3 == 0) // frame was not saved
-                                    {
-                                        frame_blob = vector<uint8_t>(c_ptr->param4, 0);
-                                    }
-                                    else if (c_ptr->param3 == 1)// frame was saved
+                                    shared_ptr<recorded_frame> recorded;
+                                    if (_cache_frames)
                                     {
-                                        frame_blob = _rec->load_blob(c_ptr->param2);
+                                        auto&& cached = _frames_cache[c_ptr];
+                                        if (!cached)
+                                            cached = make_shared<recorded_frame>(load_frame(c_ptr));
+                                        recorded = cached;
                                     }
                                     else
                                     {
-                                        frame_blob = _compression.decode(_rec->load_blob(c_ptr->param2));
+                                        recorded = make_shared<recorded_frame>(load_frame(c_ptr));
                                     }
 
-                                    metadata_blob = _rec->load_blob(c_ptr->param5);
-                                    frame_object fo{ frame_blob.size(),
-                                                static_cast<uint8_t>(metadata_blob.size()), // Metadata is limited to 0xff bytes by design
-                                                frame_blob.data(),metadata_blob.data() };
+                                    frame_object fo{ recorded->pixels.size(),
+                                                static_cast<uint8_t>(recorded->metadata.size()), // Metadata is limited to 0xff bytes by design
+                                                recorded->pixels.data(), recorded->metadata.data() };
 
 
                                     pair.second(p, fo, []() {});
@@ -7,6 +7,8 @@
 #include "backend.h"
 #include "context.h"
 #include <vector>
+#include <deque>
+#include <fstream>
 #include <mutex>
 #include <chrono>
 #include <atomic>
@@ -57,6 +59,15 @@ namespace librealsense
             device_watcher_stop
         };
 
+        // Codecs of the frames of a recording, tagged by the codec field (param3) of their calls
+        enum class frame_codec
+        {
+            blank = 0,          // Not saved, played back as zeros
+            raw = 1,
+            lossy_rle = 2,      // Lossy run-length of close 32-bit blocks, of recordings made before delta_lz4
+            delta_lz4 = 3       // Lossless, differences of consecutive 16-bit words compressed with LZ4
+        };
+
         class compression_algorithm
         {
         public:
@@ -66,6 +77,10 @@ namespace librealsense
 
             std::vector<uint8_t> encode(uint8_t* data, size_t size) const;
 
+            // The encoded frame is kept in a buffer of the calling thread until its next call
+            const std::vector<uint8_t>& encode_delta_lz4(const uint8_t* data, size_t size) const;
+            std::vector<uint8_t> decode_delta_lz4(const std::vector<uint8_t>& input) const;
+
             int min_dist = 110;
             int max_length = 32;
         };
@@ -107,6 +122,11 @@ namespace librealsense
         {
         public:
             recording(std::shared_ptr<time_service> ts = nullptr, std::shared_ptr<playback_device_watcher> watcher = nullptr);
+            ~recording();
+
+            // Append the blobs saved from now on to the file instead of keeping them in memory, until the recording is saved
+            // Blobs written there are not available to load_blob
+            void spill_blobs_to(const std::string& filename);
 
             double get_time();
             void save(const char* filename, const char* section, bool append = false) const;
@@ -296,8 +316,11 @@ namespace librealsense
             size_t size() const { return calls.size(); }
 
         private:
-            std::vector<call> calls;
+            std::deque<call> calls;     // Calls stay in place as others are added, while their recorder fills them
             std::vector<std::vector<uint8_t>> blobs;
+            std::string _spill_filename;
+            std::unique_ptr<std::ofstream> _spill;
+            std::vector<size_t> _spilled_sizes;
             std::vector<uvc_device_info> uvc_device_infos;
             std::vector<usb_device_info> usb_device_infos;
             std::vector<stream_profile> stream_profiles;
@@ -521,13 +544,20 @@ namespace librealsense
             void unlock() const override;
             std::string get_device_location() const override;
 
-            explicit playback_uvc_device(std::shared_ptr<recording> rec, int id);
+            explicit playback_uvc_device(std::shared_ptr<recording> rec, int id, bool cache_frames = false);
 
             void callback_thread();
             ~playback_uvc_device();
 
         private:
+            struct recorded_frame
+            {
+                std::vector<uint8_t> pixels;
+                std::vector<uint8_t> metadata;
+            };
+
              stream_profile get_profile(call* frame) const;
+             recorded_frame load_frame(const call* frame);
 
             std::shared_ptr<recording> _rec;
             int _entity_id;
@@ -537,6 +567,8 @@ namespace librealsense
             configurations _commitments;
             std::mutex _callback_mutex;
             compression_algorithm _compression;
+            bool _cache_frames;
+            std::map<const call*, std::shared_ptr<recorded_frame>> _frames_cache; // Used by the callback thread only
         };
 
 
@@ -590,11 +622,13 @@ namespace librealsense
             std::shared_ptr<time_service> create_time_service() const override;
             std::shared_ptr<device_watcher> create_device_watcher() const override;
 
-            explicit playback_backend(const char* filename, const char* section);
+            // Caching keeps the decoded frames in memory, so frames played again as the recording cycles cost no reads
+            explicit playback_backend(const char* filename, const char* section, bool cache_frames = false);
         private:
 
             std::shared_ptr<playback_device_watcher> _device_watcher;
             std::shared_ptr<recording> _rec;
+            bool _cache_frames;
         };
 
         class recording_time_service : public time_service
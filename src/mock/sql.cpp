@@ -74,12 +74,17 @@ namespace sql
 
     void connection::transaction(std::function<void()> transaction) const
     {
-        char* errorMessage;
-        sqlite3_exec(m_handle.get(), "BEGIN TRANSACTION", NULL, NULL, &errorMessage);
-
-        transaction();
-
-        sqlite3_exec(m_handle.get(), "COMMIT TRANSACTION", NULL, NULL, &errorMessage);
+        execute("BEGIN TRANSACTION");
+        try
+        {
+            transaction();
+        }
+        catch (...)
+        {
+            sqlite3_exec(m_handle.get(), "ROLLBACK TRANSACTION", nullptr, nullptr, nullptr);
+            throw;
+        }
+        execute("COMMIT TRANSACTION");
     }
 
     statement::statement(const connection& conn, const char * sql)
@@ -105,6 +110,12 @@ namespace sql
         throw runtime_error(sqlite3_errmsg(sqlite3_db_handle(m_handle.get())));
     }
 
+    void statement::reset() const
+    {
+        sqlite3_reset(m_handle.get());
+        sqlite3_clear_bindings(m_handle.get());
+    }
+
     int statement::get_int(int const column) const
     {
         return sqlite3_column_int(m_handle.get(), column);
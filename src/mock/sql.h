@@ -75,6 +75,9 @@ namespace sql
 
         bool step() const;
 
+        // Ready the statement to be stepped again with new bindings, so inserts of many rows prepare it once
+        void reset() const;
+
         int get_int(int column = 0) const;
         double get_double(int column = 0) const;
         std::string get_string(int column = 0) const;
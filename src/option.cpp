@@ -20,9 +20,20 @@ void librealsense::uvc_pu_option::set(float value)
                 throw invalid_value_exception(to_string() << "set_pu(id=" << std::to_string(_id) << ") failed!" << " Last Error: " << strerror(errno));
             _record(*this);
         });
+    _ep.get_option_cache().invalidate();
 }
 
 float librealsense::uvc_pu_option::query() const
+{
+    return _ep.get_option_cache().query(this, [this]() { return read_pu(); });
+}
+
+float librealsense::uvc_pu_option::query_from_device() const
+{
+    return _ep.get_option_cache().refresh(this, [this]() { return read_pu(); });
+}
+
+float librealsense::uvc_pu_option::read_pu() const
 {
     return static_cast<float>(_ep.invoke_powered(
         [this](platform::uvc_device& dev)
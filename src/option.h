@@ -165,6 +165,7 @@ namespace librealsense
         void set(float value) override;
 
         float query() const override;
+        float query_from_device() const override;
 
         option_range get_range() const override;
 
@@ -196,6 +197,8 @@ namespace librealsense
             _record = record_action;
         }
     private:
+        float read_pu() const;
+
         uvc_sensor& _ep;
         rs2_option _id;
         const std::map<float, std::string> _description_per_value;
@@ -216,19 +219,17 @@ namespace librealsense
                         throw invalid_value_exception(to_string() << "set_xu(id=" << std::to_string(_id) << ") failed!" << " Last Error: " << strerror(errno));
                     _recording_function(*this);
                 });
+            _ep.get_option_cache().invalidate();
         }
 
         float query() const override
         {
-            return static_cast<float>(_ep.invoke_powered(
-                [this](platform::uvc_device& dev)
-                {
-                    T t;
-                    if (!dev.get_xu(_xu, _id, reinterpret_cast<uint8_t*>(&t), sizeof(T)))
-                        throw invalid_value_exception(to_string() << "get_xu(id=" << std::to_string(_id) << ") failed!" << " Last Error: " << strerror(errno));
+            return _ep.get_option_cache().query(this, [this]() { return read_xu(); });
+        }
 
-                    return static_cast<float>(t);
-                }));
+        float query_from_device() const override
+        {
+            return _ep.get_option_cache().refresh(this, [this]() { return read_xu(); });
         }
 
         option_range get_range() const override
@@ -266,6 +267,19 @@ namespace librealsense
             _recording_function = record_action;
         }
     protected:
+        float read_xu() const
+        {
+            return static_cast<float>(_ep.invoke_powered(
+                [this](platform::uvc_device& dev)
+                {
+                    T t;
+                    if (!dev.get_xu(_xu, _id, reinterpret_cast<uint8_t*>(&t), sizeof(T)))
+                        throw invalid_value_exception(to_string() << "get_xu(id=" << std::to_string(_id) << ") failed!" << " Last Error: " << strerror(errno));
+
+                    return static_cast<float>(t);
+                }));
+        }
+
         uvc_sensor&       _ep;
         platform::extension_unit _xu;
         uint8_t             _id;
@@ -431,6 +445,11 @@ namespace librealsense
            return _auto_disabling_control->query();
        }
 
+       float query_from_device() const override
+       {
+           return _auto_disabling_control->query_from_device();
+       }
+
        option_range get_range() const override
        {
            return _auto_disabling_control->get_range();
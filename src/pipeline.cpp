@@ -11,10 +11,18 @@
 
 namespace librealsense
 {
-    pipeline_processing_block::pipeline_processing_block(const std::vector<int>& streams_to_aggregate) :
-        _queue(new single_consumer_queue<frame_holder>()),
-        _streams_ids(streams_to_aggregate)
-    {
+    pipeline_processing_block::pipeline_processing_block(const std::vector<int>& streams_to_aggregate, unsigned int queue_size,
+                                                         std::shared_ptr<frame_broadcaster> broadcaster) :
+        _queue(new lock_free_queue<frame_holder>(queue_size)),
+        _streams_ids(streams_to_aggregate),
+        _dropped_metric(&get_counter("rs_pipeline_frames_dropped_total", "Framesets the pipelines dropped as the application did not wait for them", {})),
+        _broadcaster(broadcaster)
+    {
+        static std::atomic<int> pipelines{ 0 };
+        auto queue = _queue.get();
+        _queue_depth_metric.reset(new sampled_gauge("rs_pipeline_queue_depth", "Framesets waiting for the application in the queue of a pipeline",
+            { { "pipeline", std::to_string(++pipelines) } }, [queue]() { return double(queue->size()); }));
+
         auto processing_callback = [&](frame_holder frame, synthetic_source_interface* source)
         {
             handle_frame(std::move(frame), source);
@@ -42,18 +50,22 @@ namespace librealsense
                     return;
             }
 
-            std::vector<frame_holder> set;
+            frameset_builder set;
             for (auto&& s : _last_set)
             {
-                set.push_back(s.second.clone());
+                set.add(s.second.clone());
             }
-            auto fref = source->allocate_composite_frame(std::move(set));
+            auto fref = set.build(*source);
             if (!fref)
             {
                 LOG_ERROR("Failed to allocate composite frame");
                 return;
             }
+            log_latency_stage(fref, RS2_FRAME_LATENCY_STAGE_QUEUE_ENQUEUE);
+            if (_broadcaster) _broadcaster->publish(fref);
+            auto dropped = _queue->get_dropped_count();
             _queue->enqueue(fref);
+            _dropped_metric->add(_queue->get_dropped_count() - dropped);
         }
         else
         {
@@ -64,12 +76,16 @@ namespace librealsense
 
     bool pipeline_processing_block::dequeue(frame_holder* item, unsigned int timeout_ms)
     {
-        return _queue->dequeue(item, timeout_ms);
+        if (!_queue->dequeue(item, timeout_ms)) return false;
+        log_latency_stage(item->frame, RS2_FRAME_LATENCY_STAGE_QUEUE_DEQUEUE);
+        return true;
     }
 
     bool pipeline_processing_block::try_dequeue(frame_holder* item)
     {
-        return _queue->try_dequeue(item);
+        if (!_queue->try_dequeue(item)) return false;
+        log_latency_stage(item->frame, RS2_FRAME_LATENCY_STAGE_QUEUE_DEQUEUE);
+        return true;
     }
 
     /*
@@ -119,7 +135,7 @@ namespace librealsense
         _device_request.filename = file;
     }
 
-    void pipeline_config::enable_record_to_file(const std::string& file)
+    void pipeline_config::enable_record_to_file(const std::string& file, const device_serializer::record_settings& settings)
     {
         std::lock_guard<std::mutex> lock(_mtx);
         if (!_device_request.filename.empty())
@@ -128,6 +144,7 @@ namespace librealsense
         }
         _resolved_profile.reset();
         _device_request.record_output = file;
+        _device_request.record_settings = settings;
     }
 
     std::shared_ptr<pipeline_profile> pipeline_config::get_cached_resolved_profile()
@@ -163,6 +180,30 @@ namespace librealsense
         _resolved_profile.reset();
     }
 
+    void pipeline_config::set_sync_max_wait(rs2_stream stream, float max_wait_ms)
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        _sync_max_wait[stream] = max_wait_ms;
+    }
+
+    std::map<rs2_stream, float> pipeline_config::get_sync_max_wait()
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        return _sync_max_wait;
+    }
+
+    void pipeline_config::set_frames_queue_size(unsigned int size)
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        _frames_queue_size = size;
+    }
+
+    unsigned int pipeline_config::get_frames_queue_size()
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        return _frames_queue_size;
+    }
+
     std::shared_ptr<pipeline_profile> pipeline_config::resolve(std::shared_ptr<pipeline> pipe, const std::chrono::milliseconds& timeout)
     {
         std::lock_guard<std::mutex> lock(_mtx);
@@ -181,7 +222,7 @@ namespace librealsense
 
             util::config config;
             config.enable_all(util::best_quality);
-            _resolved_profile = std::make_shared<pipeline_profile>(requested_device, config, _device_request.record_output);
+            _resolved_profile = std::make_shared<pipeline_profile>(requested_device, config, get_selection(requested_device, false), _device_request.record_output, _device_request.record_settings);
             return _resolved_profile;
         }
         else
@@ -196,19 +237,25 @@ namespace librealsense
                     requested_device = pipe->wait_for_device(timeout);
                 }
 
-                auto default_profiles = get_default_configuration(requested_device);
-                for (auto prof : default_profiles)
+                //The default configuration of a device resolved before is not searched again
+                auto memo = get_selection(requested_device, true);
+                if (!memo || !util::config::is_valid_selection(requested_device.get(), *memo))
                 {
-                    auto p = dynamic_cast<video_stream_profile*>(prof.get());
-                    if (!p)
+                    if (memo) memo->clear();
+                    auto default_profiles = get_default_configuration(requested_device);
+                    for (auto prof : default_profiles)
                     {
-                        LOG_ERROR("prof is not video_stream_profile");
-                        throw std::logic_error("Failed to resolve request. internal error");
+                        auto p = dynamic_cast<video_stream_profile*>(prof.get());
+                        if (!p)
+                        {
+                            LOG_ERROR("prof is not video_stream_profile");
+                            throw std::logic_error("Failed to resolve request. internal error");
+                        }
+                        config.enable_stream(p->get_stream_type(), p->get_stream_index(), p->get_width(), p->get_height(), p->get_format(), p->get_framerate());
                     }
-                    config.enable_stream(p->get_stream_type(), p->get_stream_index(), p->get_width(), p->get_height(), p->get_format(), p->get_framerate());
                 }
 
-                _resolved_profile = std::make_shared<pipeline_profile>(requested_device, config, _device_request.record_output);
+                _resolved_profile = std::make_shared<pipeline_profile>(requested_device, config, memo, _device_request.record_output, _device_request.record_settings);
                 return _resolved_profile;
             }
             else
@@ -227,7 +274,7 @@ namespace librealsense
                     if (devs.empty())
                     {
                         auto dev = pipe->wait_for_device(timeout);
-                        _resolved_profile = std::make_shared<pipeline_profile>(dev, config, _device_request.record_output);
+                        _resolved_profile = std::make_shared<pipeline_profile>(dev, config, get_selection(dev, false), _device_request.record_output, _device_request.record_settings);
                         return _resolved_profile;
                     }
                     else
@@ -237,7 +284,7 @@ namespace librealsense
                             try
                             {
                                 auto dev = dev_info->create_device();
-                                _resolved_profile = std::make_shared<pipeline_profile>(dev, config, _device_request.record_output);
+                                _resolved_profile = std::make_shared<pipeline_profile>(dev, config, get_selection(dev, false), _device_request.record_output, _device_request.record_settings);
                                 return _resolved_profile;
                             }
                             catch (...) {}
@@ -249,7 +296,7 @@ namespace librealsense
                 else
                 {
                     //User specified a device, use it with the requested configuration
-                    _resolved_profile = std::make_shared<pipeline_profile>(requested_device, config, _device_request.record_output);
+                    _resolved_profile = std::make_shared<pipeline_profile>(requested_device, config, get_selection(requested_device, false), _device_request.record_output, _device_request.record_settings);
                     return _resolved_profile;
                 }
             }
@@ -258,6 +305,27 @@ namespace librealsense
         assert(0); //Unreachable code
     }
 
+    static const size_t MAX_SELECTIONS = 16;
+
+    util::config::selection* pipeline_config::get_selection(std::shared_ptr<device_interface> dev, bool is_default)
+    {
+        //Selections are positions in the profiles of the sensors, which are the same for devices with the same serial
+        if (!dev || !dev->supports_info(RS2_CAMERA_INFO_SERIAL_NUMBER))
+            return nullptr;
+
+        std::ostringstream key;
+        key << dev->get_info(RS2_CAMERA_INFO_SERIAL_NUMBER) << "|" << _enable_all_streams << is_default;
+        for (auto&& req : _stream_requests)
+        {
+            auto r = req.second;
+            key << "|" << r.stream << "," << r.stream_index << "," << r.width << "," << r.height << "," << r.format << "," << r.fps;
+        }
+
+        if (_selections.size() >= MAX_SELECTIONS && _selections.find(key.str()) == _selections.end())
+            _selections.clear();
+        return &_selections[key.str()];
+    }
+
     bool pipeline_config::can_resolve(std::shared_ptr<pipeline> pipe)
     {
         try
@@ -403,7 +471,7 @@ namespace librealsense
     };
 
     pipeline::pipeline(std::shared_ptr<librealsense::context> ctx)
-        :_ctx(ctx), _hub(ctx)
+        :_ctx(ctx), _hub(ctx), _broadcaster(std::make_shared<frame_broadcaster>())
     {}
 
     pipeline::~pipeline()
@@ -418,7 +486,7 @@ namespace librealsense
     std::shared_ptr<pipeline_profile> pipeline::start(std::shared_ptr<pipeline_config> conf)
     {
         std::lock_guard<std::mutex> lock(_mtx);
-        if (_active_profile)
+        if (_active_profile || _prepared_profile)
         {
             throw librealsense::wrong_api_call_sequence_exception("start() cannot be called before stop()");
         }
@@ -426,10 +494,32 @@ namespace librealsense
         return unsafe_get_active_profile();
     }
 
+    std::shared_ptr<pipeline_profile> pipeline::prepare(std::shared_ptr<pipeline_config> conf)
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        if (_active_profile || _prepared_profile)
+        {
+            throw librealsense::wrong_api_call_sequence_exception("prepare() cannot be called before stop()");
+        }
+        unsafe_prepare(conf);
+        return _prepared_profile;
+    }
+
+    std::shared_ptr<pipeline_profile> pipeline::start_prepared()
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        if (!_prepared_profile)
+        {
+            throw librealsense::wrong_api_call_sequence_exception("start_prepared() can only be called after prepare()");
+        }
+        unsafe_start_prepared();
+        return unsafe_get_active_profile();
+    }
+
     std::shared_ptr<pipeline_profile> pipeline::start_with_record(std::shared_ptr<pipeline_config> conf, const std::string& file)
     {
         std::lock_guard<std::mutex> lock(_mtx);
-        if (_active_profile)
+        if (_active_profile || _prepared_profile)
         {
             throw librealsense::wrong_api_call_sequence_exception("start() cannot be called before stop()");
         }
@@ -453,6 +543,12 @@ namespace librealsense
     }
 
     void pipeline::unsafe_start(std::shared_ptr<pipeline_config> conf)
+    {
+        unsafe_prepare(conf);
+        unsafe_start_prepared();
+    }
+
+    void pipeline::unsafe_prepare(std::shared_ptr<pipeline_config> conf)
     {
         std::shared_ptr<pipeline_profile> profile = nullptr;
         //first try to get the previously resolved profile (if exists)
@@ -489,7 +585,9 @@ namespace librealsense
         }
 
         _syncer = std::unique_ptr<syncer_proccess_unit>(new syncer_proccess_unit());
-        _pipeline_proccess = std::unique_ptr<pipeline_processing_block>(new pipeline_processing_block(unique_ids));
+        for (auto&& max_wait : conf->get_sync_max_wait())
+            _syncer->set_max_wait(max_wait.first, max_wait.second);
+        _pipeline_proccess = std::unique_ptr<pipeline_processing_block>(new pipeline_processing_block(unique_ids, conf->get_frames_queue_size(), _broadcaster));
 
         auto pipeline_proccess_callback = [&](frame_holder fref)
         {
@@ -501,28 +599,53 @@ namespace librealsense
             [](rs2_frame_callback* p) { p->release(); }
         };
 
-        _syncer->set_output_callback(to_pipeline_proccess);
+        _active_graph = _graph;
+        if (_active_graph)
+        {
+            _active_graph->set_output_callback(to_pipeline_proccess);
+
+            auto to_graph = [&](frame_holder fref)
+            {
+                _active_graph->invoke(std::move(fref));
+            };
+
+            _syncer->set_output_callback({
+                new internal_frame_callback<decltype(to_graph)>(to_graph),
+                [](rs2_frame_callback* p) { p->release(); }
+            });
+        }
+        else
+        {
+            _syncer->set_output_callback(to_pipeline_proccess);
+        }
 
         auto to_syncer = [&](frame_holder fref)
         {
             _syncer->invoke(std::move(fref));
         };
 
-        frame_callback_ptr syncer_callback = {
+        _prepared_callback = {
             new internal_frame_callback<decltype(to_syncer)>(to_syncer),
             [](rs2_frame_callback* p) { p->release(); }
         };
 
         profile->_multistream.open();
-        profile->_multistream.start(syncer_callback);
-        _active_profile = profile;
+        _prepared_profile = profile;
         _prev_conf = std::make_shared<pipeline_config>(*conf);
     }
 
+    void pipeline::unsafe_start_prepared()
+    {
+        _prepared_profile->_multistream.start(_prepared_callback);
+        _active_profile = std::move(_prepared_profile);
+        _active_profile->_pipeline = shared_from_this();
+        _prepared_callback.reset();
+    }
+
     void pipeline::stop()
     {
         std::lock_guard<std::mutex> lock(_mtx);
-        if (!_active_profile)
+        if (!_active_profile && !_prepared_profile)
         {
             throw librealsense::wrong_api_call_sequence_exception("stop() cannot be called before start()");
         }
@@ -542,14 +665,50 @@ namespace librealsense
             {
             } // Stop will throw if device was disconnected. TODO - refactoring anticipated
         }
+        else if (_prepared_profile)
+        {
+            try
+            {
+                _prepared_profile->_multistream.close();
+            }
+            catch (...)
+            {
+            }
+        }
         _active_profile.reset();
+        _prepared_profile.reset();
+        _prepared_callback.reset();
+        if (_syncer) _last_sync_stats = _syncer->get_stats();
         _syncer.reset();
+        if (_active_graph)
+        {
+            // Let the frames still in the graph through before detaching it
+            _active_graph->flush();
+            _active_graph->set_output_callback(nullptr);
+            _active_graph.reset();
+        }
         _pipeline_proccess.reset();
         _prev_conf.reset();
     }
     frame_holder pipeline::wait_for_frames(unsigned int timeout_ms)
     {
         std::lock_guard<std::mutex> lock(_mtx);
+        return unsafe_wait_for_frames(timeout_ms);
+    }
+
+    size_t pipeline::wait_for_frames_batch(frame_holder* frames, size_t max_count, unsigned int timeout_ms)
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        if (!max_count) return 0;
+
+        frames[0] = unsafe_wait_for_frames(timeout_ms);
+        size_t count = 1;
+        while (count < max_count && _pipeline_proccess->try_dequeue(&frames[count])) count++;
+        return count;
+    }
+
+    frame_holder pipeline::unsafe_wait_for_frames(unsigned int timeout_ms)
+    {
         if (!_active_profile)
         {
             throw librealsense::wrong_api_call_sequence_exception("wait_for_frames cannot be called before start()");
@@ -611,6 +770,74 @@ namespace librealsense
         return _ctx;
     }
 
+    void pipeline::set_processing_graph(std::shared_ptr<processing_graph> graph)
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        _graph = graph;
+    }
+
+    std::shared_ptr<frame_subscription> pipeline::subscribe(int capacity, rs2_queue_policy policy)
+    {
+        return _broadcaster->subscribe(capacity, policy);
+    }
+
+    rs2_sync_stats pipeline::get_sync_stats() const
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        return _syncer ? _syncer->get_stats() : _last_sync_stats;
+    }
+
+    rs2_frame_drop_stats pipeline::get_frame_drops(const pipeline_profile* profile, const stream_profile_interface& stream) const
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        if (!_active_profile || _active_profile.get() != profile)
+            throw wrong_api_call_sequence_exception("Frame drops are only available for the profile of a started pipeline");
+
+        // The stream is found among the active streams by its unique id, or else by its type and index
+        std::shared_ptr<stream_profile_interface> active;
+        for (auto&& s : _active_profile->get_active_streams())
+        {
+            if (s->get_unique_id() == stream.get_unique_id()) active = s;
+            else if (!active && s->get_stream_type() == stream.get_stream_type() && s->get_stream_index() == stream.get_stream_index())
+                active = s;
+        }
+        if (!active)
+            throw invalid_value_exception(to_string() << "Stream " << stream.get_stream_type() << " is not streamed by the pipeline");
+
+        rs2_frame_drop_stats stats = {};
+        auto stream_id = active->get_unique_id();
+
+        auto sensor = dynamic_cast<sensor_base*>(_active_profile->_multistream.get_sensor(stream_id));
+        if (sensor)
+        {
+            auto&& source = sensor->get_frame_source();
+            stats.dropped[RS2_FRAME_DROP_STAGE_ALLOCATION] = source.get_dropped_frames(stream_id);
+            stats.dropped[RS2_FRAME_DROP_STAGE_DEVICE] = source.get_lost_frames(stream_id);
+            stats.queue_depth[RS2_FRAME_DROP_STAGE_ALLOCATION] = static_cast<int>(source.get_published_frames_count());
+
+            auto callbacks = source.get_callback_stats(stream_id);
+            stats.dropped[RS2_FRAME_DROP_STAGE_CALLBACK_LANE] = callbacks.dropped;
+            stats.queue_depth[RS2_FRAME_DROP_STAGE_CALLBACK_LANE] = static_cast<int>(callbacks.queued);
+            stats.callbacks = callbacks.calls;
+            stats.callback_duration_avg = callbacks.calls ? static_cast<float>(callbacks.total_ms / callbacks.calls) : 0.f;
+            stats.callback_duration_max = static_cast<float>(callbacks.max_ms);
+        }
+
+        if (_syncer)
+        {
+            _syncer->get_stream_drops(stream_id, stats.dropped[RS2_FRAME_DROP_STAGE_SYNC],
+                                      stats.queue_depth[RS2_FRAME_DROP_STAGE_SYNC]);
+        }
+
+        // Every frames set of the pipeline queue holds all of the streams
+        if (_pipeline_proccess)
+        {
+            stats.dropped[RS2_FRAME_DROP_STAGE_PIPELINE_QUEUE] = _pipeline_proccess->get_dropped_count();
+            stats.queue_depth[RS2_FRAME_DROP_STAGE_PIPELINE_QUEUE] = static_cast<int>(_pipeline_proccess->get_queue_size());
+        }
+        return stats;
+    }
+
 
     /*
         .______   .______        ______    _______  __   __       _______
@@ -623,7 +850,9 @@ namespace librealsense
 
     pipeline_profile::pipeline_profile(std::shared_ptr<device_interface> dev,
                                        util::config config,
-                                       const std::string& to_file) :
+                                       util::config::selection* memo,
+                                       const std::string& to_file,
+                                       const device_serializer::record_settings& settings) :
         _dev(dev), _to_file(to_file)
     {
         if (!to_file.empty())
@@ -631,9 +860,9 @@ namespace librealsense
             if (!dev)
                 throw librealsense::invalid_value_exception("Failed to create a pipeline_profile, device is null");
 
-            _dev = std::make_shared<record_device>(dev, std::make_shared<ros_writer>(to_file));
+            _dev = std::make_shared<record_device>(dev, std::make_shared<ros_writer>(to_file, settings), settings.native_formats);
         }
-        _multistream = config.resolve(_dev.get());
+        _multistream = config.resolve(_dev.get(), memo);
     }
 
     std::shared_ptr<device_interface> pipeline_profile::get_device()
@@ -650,6 +879,14 @@ namespace librealsense
         return _dev;
     }
 
+    rs2_frame_drop_stats pipeline_profile::get_frame_drops(const stream_profile_interface& stream)
+    {
+        auto pipe = _pipeline.lock();
+        if (!pipe)
+            throw wrong_api_call_sequence_exception("Frame drops are only available for the profile of a started pipeline");
+        return pipe->get_frame_drops(this, stream);
+    }
+
     stream_profiles pipeline_profile::get_active_streams() const
     {
         auto profiles_per_sensor = _multistream.get_profiles_per_sensor();
@@ -9,6 +9,10 @@
 #include "device_hub.h"
 #include "sync.h"
 #include "config.h"
+#include "proc/processing-graph.h"
+#include "core/serialization.h"
+#include "metrics.h"
+#include "frame-broadcaster.h"
 
 namespace librealsense
 {
@@ -16,24 +20,35 @@ namespace librealsense
     class pipeline_processing_block : public processing_block
     {
         std::map<stream_id, frame_holder> _last_set;
-        std::unique_ptr<single_consumer_queue<frame_holder>> _queue;
+        std::unique_ptr<lock_free_queue<frame_holder>> _queue;
         std::vector<int> _streams_ids;
+        metric_counter* _dropped_metric;
+        std::unique_ptr<sampled_gauge> _queue_depth_metric;
+        std::shared_ptr<frame_broadcaster> _broadcaster;
         void handle_frame(frame_holder frame, synthetic_source_interface* source);
     public:
-        pipeline_processing_block(const std::vector<int>& streams_to_aggregate);
+        pipeline_processing_block(const std::vector<int>& streams_to_aggregate, unsigned int queue_size = QUEUE_MAX_SIZE,
+                                  std::shared_ptr<frame_broadcaster> broadcaster = nullptr);
         bool dequeue(frame_holder* item, unsigned int timeout_ms = 5000);
         bool try_dequeue(frame_holder* item);
+        unsigned long long get_dropped_count() const { return _queue->get_dropped_count(); }
+        size_t get_queue_size() const { return _queue->size(); }
     };
 
     class pipeline;
     class pipeline_profile
     {
     public:
-        pipeline_profile(std::shared_ptr<device_interface> dev, util::config config, const std::string& file = "");
+        pipeline_profile(std::shared_ptr<device_interface> dev, util::config config, util::config::selection* memo, const std::string& file = "",
+                         const device_serializer::record_settings& settings = device_serializer::record_settings());
         std::shared_ptr<device_interface> get_device();
         stream_profiles get_active_streams() const;
+        rs2_frame_drop_stats get_frame_drops(const stream_profile_interface& stream);
         util::config::multistream _multistream;
     private:
+        friend class pipeline;
+
+        std::weak_ptr<pipeline> _pipeline;     // The pipeline streaming the profile, unset for resolved profiles
         std::shared_ptr<device_interface> _dev;
         std::string _to_file;
     };
@@ -47,30 +62,50 @@ namespace librealsense
         ~pipeline();
         std::shared_ptr<pipeline_profile> start(std::shared_ptr<pipeline_config> conf);
         std::shared_ptr<pipeline_profile> start_with_record(std::shared_ptr<pipeline_config> conf, const std::string& file);
+        // Everything start does short of delivering frames, the sensors are opened and their streams on, so that
+        // start_prepared only has to attach the pipeline to them. stop releases a prepared pipeline too
+        std::shared_ptr<pipeline_profile> prepare(std::shared_ptr<pipeline_config> conf);
+        std::shared_ptr<pipeline_profile> start_prepared();
         void stop();
         std::shared_ptr<pipeline_profile> get_active_profile() const;
         frame_holder wait_for_frames(unsigned int timeout_ms = 5000);
+        // Wait for a frames set, then take as many of the other queued sets as fit, all under one lock
+        size_t wait_for_frames_batch(frame_holder* frames, size_t max_count, unsigned int timeout_ms = 5000);
         bool poll_for_frames(frame_holder* frame);
 
         //Non top level API
         std::shared_ptr<device_interface> wait_for_device(const std::chrono::milliseconds& timeout = std::chrono::hours::max(),
                                                             const std::string& serial = "");
         std::shared_ptr<librealsense::context> get_context() const;
+        void set_processing_graph(std::shared_ptr<processing_graph> graph);
+        rs2_sync_stats get_sync_stats() const;
+        rs2_frame_drop_stats get_frame_drops(const pipeline_profile* profile, const stream_profile_interface& stream) const;
+        // Queue of its own for the framesets of the pipeline, kept across restarts, see frame_broadcaster
+        std::shared_ptr<frame_subscription> subscribe(int capacity, rs2_queue_policy policy);
 
 
      private:
         void unsafe_start(std::shared_ptr<pipeline_config> conf);
+        void unsafe_prepare(std::shared_ptr<pipeline_config> conf);
+        void unsafe_start_prepared();
         void unsafe_stop();
+        frame_holder unsafe_wait_for_frames(unsigned int timeout_ms);
         std::shared_ptr<pipeline_profile> unsafe_get_active_profile() const;
 
         std::shared_ptr<librealsense::context> _ctx;
         mutable std::mutex _mtx;
         device_hub _hub;
         std::shared_ptr<pipeline_profile> _active_profile;
+        std::shared_ptr<pipeline_profile> _prepared_profile;   // Opened by prepare, not started yet
+        frame_callback_ptr _prepared_callback;
         frame_callback_ptr _callback;
         std::unique_ptr<syncer_proccess_unit> _syncer;
         std::unique_ptr<pipeline_processing_block> _pipeline_proccess;
+        std::shared_ptr<processing_graph> _graph;          // Attached by set_processing_graph, used from the next start
+        std::shared_ptr<processing_graph> _active_graph;   // Runs between the syncer and _pipeline_proccess while started
         std::shared_ptr<pipeline_config> _prev_conf;
+        rs2_sync_stats _last_sync_stats = {};             // Counters of the syncer of the last run, once stopped
+        std::shared_ptr<frame_broadcaster> _broadcaster;  // The subscriptions get every frames set enqueued for wait_for_frames
     };
 
     class pipeline_config
@@ -81,14 +116,18 @@ namespace librealsense
         void enable_all_stream();
         void enable_device(const std::string& serial);
         void enable_device_from_file(const std::string& file);
-        void enable_record_to_file(const std::string& file);
+        void enable_record_to_file(const std::string& file, const device_serializer::record_settings& settings = device_serializer::record_settings());
         void disable_stream(rs2_stream stream, int index = -1);
         void disable_all_streams();
+        void set_sync_max_wait(rs2_stream stream, float max_wait_ms);
+        void set_frames_queue_size(unsigned int size);
         std::shared_ptr<pipeline_profile> resolve(std::shared_ptr<pipeline> pipe, const std::chrono::milliseconds& timeout = std::chrono::milliseconds(0));
         bool can_resolve(std::shared_ptr<pipeline> pipe);
 
         //Non top level API
         std::shared_ptr<pipeline_profile> get_cached_resolved_profile();
+        std::map<rs2_stream, float> get_sync_max_wait();
+        unsigned int get_frames_queue_size();
 
         pipeline_config(const pipeline_config& other)
         {
@@ -99,6 +138,8 @@ namespace librealsense
             _stream_requests = other._stream_requests;
             _enable_all_streams = other._enable_all_streams;
             _stream_requests = other._stream_requests;
+            _sync_max_wait = other._sync_max_wait;
+            _frames_queue_size = other._frames_queue_size;
             _resolved_profile = nullptr;
         }
     private:
@@ -107,16 +148,21 @@ namespace librealsense
             std::string serial;
             std::string filename;
             std::string record_output;
+            device_serializer::record_settings record_settings;
         };
         std::shared_ptr<device_interface> get_or_add_playback_device(std::shared_ptr<pipeline> pipe, const std::string& file);
         std::shared_ptr<device_interface> resolve_device_requests(std::shared_ptr<pipeline> pipe, const std::chrono::milliseconds& timeout);
         stream_profiles get_default_configuration(std::shared_ptr<device_interface> dev);
+        util::config::selection* get_selection(std::shared_ptr<device_interface> dev, bool is_default);
 
         device_request _device_request;
         std::map<std::pair<rs2_stream, int>, util::config::request_type> _stream_requests;
         std::mutex _mtx;
         bool _enable_all_streams = false;
         std::shared_ptr<pipeline_profile> _resolved_profile;
+        std::map<std::string, util::config::selection> _selections;      // Resolved configurations per device and requests
+        std::map<rs2_stream, float> _sync_max_wait;
+        unsigned int _frames_queue_size = QUEUE_MAX_SIZE;
     };
 
 }
@@ -8,49 +8,313 @@
 #include "core/video.h"
 #include "proc/synthetic-stream.h"
 #include "environment.h"
+#include "cpu-features.h"
 #include "align.h"
+#include "undistort.h"
+#include "projection.h"
+#include "change-detection.h"
+
+#ifdef __SSSE3__
+#include <immintrin.h> // For AVX2 intrinsic, only executed when supported by the running CPU
+#endif
 
 namespace librealsense
 {
+    // The rsutil projection functions leave the pixels of these intrinsics undistorted, so deprojecting a pixel
+    // separates into its column and its row, which are served by the precomputed tables of align_rays
+    static bool is_distortion_free(const rs2_intrinsics & intrin)
+    {
+        switch (intrin.model)
+        {
+        case RS2_DISTORTION_NONE:
+        case RS2_DISTORTION_BROWN_CONRADY: return true; // Not applied by rsutil
+        case RS2_DISTORTION_FTHETA: return false;
+        default:
+            for (auto c : intrin.coeffs) if (c != 0) return false;
+            return true;
+        }
+    }
+
+    void align_rays::update(const rs2_intrinsics & depth_intrin)
+    {
+        if (left.size() == static_cast<size_t>(depth_intrin.width) && !memcmp(&intrin, &depth_intrin, sizeof(intrin)))
+            return;
+
+        intrin = depth_intrin;
+        left.resize(intrin.width); right.resize(intrin.width);
+        top.resize(intrin.height); bottom.resize(intrin.height);
+
+        // Same operations as rs2_deproject_pixel_to_point, so that using the tables stays bit-exact with it
+        for (int x = 0; x < intrin.width; ++x)
+        {
+            float pixel[2] = { x - 0.5f, x + 0.5f };
+            left[x] = (pixel[0] - intrin.ppx) / intrin.fx;
+            right[x] = (pixel[1] - intrin.ppx) / intrin.fx;
+        }
+        for (int y = 0; y < intrin.height; ++y)
+        {
+            float pixel[2] = { y - 0.5f, y + 0.5f };
+            top[y] = (pixel[0] - intrin.ppy) / intrin.fy;
+            bottom[y] = (pixel[1] - intrin.ppy) / intrin.fy;
+        }
+    }
+
+    // Map the top-left and bottom-right corners of a row of depth pixels onto the other image
+    // The vectorized variants follow the exact sequence of operations of rs2_transform_point_to_point
+    // and rs2_project_point_to_pixel for undistorted intrinsics, and produce the same pixels as the scalar code
+    typedef void(*project_row_function)(const float * depth, const float * left, const float * right, float top, float bottom, int count,
+                                        const rs2_extrinsics & depth_to_other, const rs2_intrinsics & other_intrin, int * corners[4]);
+
+    static void project_row_scalar(const float * depth, const float * left, const float * right, float top, float bottom, int count,
+                                   const rs2_extrinsics & depth_to_other, const rs2_intrinsics & other_intrin, int * corners[4])
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            float depth_point[3], other_point[3], other_pixel[2];
+            for (int c = 0; c < 2; ++c)
+            {
+                depth_point[0] = depth[i] * (c ? right[i] : left[i]);
+                depth_point[1] = depth[i] * (c ? bottom : top);
+                depth_point[2] = depth[i];
+                rs2_transform_point_to_point(other_point, &depth_to_other, depth_point);
+                rs2_project_point_to_pixel(other_pixel, &other_intrin, other_point);
+                corners[c * 2][i] = static_cast<int>(other_pixel[0] + 0.5f);
+                corners[c * 2 + 1][i] = static_cast<int>(other_pixel[1] + 0.5f);
+            }
+        }
+    }
+
+#ifdef __SSSE3__
+    AVX2_TARGET static void project_row_avx2(const float * depth, const float * left, const float * right, float top, float bottom, int count,
+                                             const rs2_extrinsics & depth_to_other, const rs2_intrinsics & other_intrin, int * corners[4])
+    {
+        __m256 r[9], t[3];
+        for (int k = 0; k < 9; ++k) r[k] = _mm256_set1_ps(depth_to_other.rotation[k]);
+        for (int k = 0; k < 3; ++k) t[k] = _mm256_set1_ps(depth_to_other.translation[k]);
+        const __m256 fx = _mm256_set1_ps(other_intrin.fx), ppx = _mm256_set1_ps(other_intrin.ppx);
+        const __m256 fy = _mm256_set1_ps(other_intrin.fy), ppy = _mm256_set1_ps(other_intrin.ppy);
+        const __m256 half = _mm256_set1_ps(0.5f);
+
+        int i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m256 d = _mm256_loadu_ps(depth + i);
+            for (int c = 0; c < 2; ++c)
+            {
+                const __m256 p0 = _mm256_mul_ps(d, _mm256_loadu_ps((c ? right : left) + i));
+                const __m256 p1 = _mm256_mul_ps(d, _mm256_set1_ps(c ? bottom : top));
+                const __m256 o0 = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(r[0], p0), _mm256_mul_ps(r[3], p1)), _mm256_mul_ps(r[6], d)), t[0]);
+                const __m256 o1 = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(r[1], p0), _mm256_mul_ps(r[4], p1)), _mm256_mul_ps(r[7], d)), t[1]);
+                const __m256 o2 = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(r[2], p0), _mm256_mul_ps(r[5], p1)), _mm256_mul_ps(r[8], d)), t[2]);
+                const __m256 x = _mm256_add_ps(_mm256_mul_ps(_mm256_div_ps(o0, o2), fx), ppx);
+                const __m256 y = _mm256_add_ps(_mm256_mul_ps(_mm256_div_ps(o1, o2), fy), ppy);
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(corners[c * 2] + i), _mm256_cvttps_epi32(_mm256_add_ps(x, half)));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(corners[c * 2 + 1] + i), _mm256_cvttps_epi32(_mm256_add_ps(y, half)));
+            }
+        }
+
+        int * tail[4] = { corners[0] + i, corners[1] + i, corners[2] + i, corners[3] + i };
+        project_row_scalar(depth + i, left + i, right + i, top, bottom, count - i, depth_to_other, other_intrin, tail);
+    }
+#endif
+
+    // Corners of a row of depth pixels of distorted images, without depth the corners of a pixel are left as they are
+    template<rs2_distortion DEPTH_MODEL>
+    struct project_distorted_row
+    {
+        template<rs2_distortion OTHER_MODEL>
+        struct kernel
+        {
+            typedef void(*function)(const float * depth, int depth_y, int begin, int end, const rs2_intrinsics & depth_intrin,
+                                    const rs2_extrinsics & depth_to_other, const rs2_intrinsics & other_intrin, int * corners[4]);
+
+            static void run(const float * depth, int depth_y, int begin, int end, const rs2_intrinsics & depth_intrin,
+                            const rs2_extrinsics & depth_to_other, const rs2_intrinsics & other_intrin, int * corners[4])
+            {
+                for (int depth_x = begin; depth_x < end; ++depth_x)
+                {
+                    if (!depth[depth_x])
+                        continue;
+
+                    // Map the top-left and the bottom-right corners of the depth pixel onto the other image
+                    for (int c = 0; c < 2; ++c)
+                    {
+                        float depth_pixel[2] = { depth_x + (c ? 0.5f : -0.5f), depth_y + (c ? 0.5f : -0.5f) }, depth_point[3], other_point[3], other_pixel[2];
+                        deproject_pixel_to_point<DEPTH_MODEL>(depth_point, depth_intrin, depth_pixel, depth[depth_x]);
+                        rs2_transform_point_to_point(other_point, &depth_to_other, depth_point);
+                        project_point_to_pixel<OTHER_MODEL>(other_pixel, other_intrin, other_point);
+                        corners[c * 2][depth_x] = static_cast<int>(other_pixel[0] + 0.5f);
+                        corners[c * 2 + 1][depth_x] = static_cast<int>(other_pixel[1] + 0.5f);
+                    }
+                }
+            }
+        };
+    };
+
+    static project_distorted_row<RS2_DISTORTION_NONE>::kernel<RS2_DISTORTION_NONE>::function select_project_distorted_row(
+        const rs2_intrinsics & depth_intrin, const rs2_intrinsics & other_intrin)
+    {
+        if (get_deprojection_model(depth_intrin.model) == RS2_DISTORTION_INVERSE_BROWN_CONRADY)
+            return select_projection_kernel<project_distorted_row<RS2_DISTORTION_INVERSE_BROWN_CONRADY>::kernel>(other_intrin.model);
+        return select_projection_kernel<project_distorted_row<RS2_DISTORTION_NONE>::kernel>(other_intrin.model);
+    }
+
+    static project_row_function select_project_row()
+    {
+#ifdef __SSSE3__
+        if (cpu_supports(CPU_FEATURE_AVX2)) return &project_row_avx2;
+#endif
+        return &project_row_scalar;
+    }
+
+    // Rows of the other image written by one task. Every pixel of the other image is written by a single task,
+    // in the order of the depth pixels, so the result is the same whatever the threads
+    const int align_band_height = 32;
+
+    // Corners of the depth pixels on the other image, as four planes of x0, y0, x1 and y1 per depth row
+    // Given a change mask, the corners of its clean tiles are those of the previous frame and are kept
     template<class GET_DEPTH, class TRANSFER_PIXEL>
-    void align_images(const rs2_intrinsics & depth_intrin, const rs2_extrinsics & depth_to_other,
-        const rs2_intrinsics & other_intrin, GET_DEPTH get_depth, TRANSFER_PIXEL transfer_pixel)
+    void align_images(const align_rays & rays, const rs2_intrinsics & depth_intrin, const rs2_extrinsics & depth_to_other,
+        const rs2_intrinsics & other_intrin, const remap_table * other_map, std::vector<int> & corners, const change_mask * changes,
+        GET_DEPTH get_depth, TRANSFER_PIXEL transfer_pixel)
     {
-        // Iterate over the pixels of the depth image
+        const int width = depth_intrin.width, height = depth_intrin.height;
+
+        // The rows of the other image each depth row reaches. Reused by the following frames aligned on the thread
+        static thread_local std::vector<int> row_range;
+        corners.resize(static_cast<size_t>(width) * height * 4);
+        row_range.resize(static_cast<size_t>(height) * 2);
+
+        // With a table of the distortion of the other image, the pixels are interpolated from it rather than distorted one by one
+        auto project_to_other = [&](float other_pixel[2], const float other_point[3])
+        {
+            if (!other_map)
+            {
+                rs2_project_point_to_pixel(other_pixel, &other_intrin, other_point);
+                return;
+            }
+            const float undistorted[2] = { other_point[0] / other_point[2] * other_intrin.fx + other_intrin.ppx,
+                                           other_point[1] / other_point[2] * other_intrin.fy + other_intrin.ppy };
+            other_map->distort_pixel(other_pixel, undistorted);
+        };
+
+        const bool distortion_free = is_distortion_free(depth_intrin) && is_distortion_free(other_intrin);
+        static const auto project_row = select_project_row();
+        const auto project_distorted = select_project_distorted_row(depth_intrin, other_intrin);
+
+        auto corners_data = corners.data();
+        auto row_range_data = row_range.data();
 #pragma omp parallel for schedule(dynamic)
-        for (int depth_y = 0; depth_y < depth_intrin.height; ++depth_y)
+        for (int depth_y = 0; depth_y < height; ++depth_y)
         {
-            int depth_pixel_index = depth_y * depth_intrin.width;
-            for (int depth_x = 0; depth_x < depth_intrin.width; ++depth_x, ++depth_pixel_index)
+            const int depth_row_index = depth_y * width;
+            int * other[4];
+            for (int c = 0; c < 4; ++c) other[c] = corners_data + (static_cast<size_t>(depth_row_index) * 4) + c * width;
+
+            std::vector<float> depth;
+            if (distortion_free || !other_map)
+            {
+                depth.resize(width);
+                for (int depth_x = 0; depth_x < width; ++depth_x)
+                    depth[depth_x] = get_depth(depth_row_index + depth_x);
+            }
+
+            // Project the corners of the depth pixels of the row in [begin, end)
+            auto project_span = [&](int begin, int end)
+            {
+                if (distortion_free)
+                {
+                    int * span[4] = { other[0] + begin, other[1] + begin, other[2] + begin, other[3] + begin };
+                    project_row(depth.data() + begin, rays.left.data() + begin, rays.right.data() + begin, rays.top[depth_y], rays.bottom[depth_y],
+                                end - begin, depth_to_other, other_intrin, span);
+                }
+                else if (!other_map)
+                    project_distorted(depth.data(), depth_y, begin, end, depth_intrin, depth_to_other, other_intrin, other);
+                else
+                {
+                    for (int depth_x = begin; depth_x < end; ++depth_x)
+                    {
+                        // Pixels without depth are skipped by the transfer, their corners are left as they are
+                        float depth = get_depth(depth_row_index + depth_x);
+                        if (!depth)
+                            continue;
+
+                        // Map the top-left and the bottom-right corners of the depth pixel onto the other image
+                        for (int c = 0; c < 2; ++c)
+                        {
+                            float depth_pixel[2] = { depth_x + (c ? 0.5f : -0.5f), depth_y + (c ? 0.5f : -0.5f) }, depth_point[3], other_point[3], other_pixel[2];
+                            rs2_deproject_pixel_to_point(depth_point, &depth_intrin, depth_pixel, depth);
+                            rs2_transform_point_to_point(other_point, &depth_to_other, depth_point);
+                            project_to_other(other_pixel, other_point);
+                            other[c * 2][depth_x] = static_cast<int>(other_pixel[0] + 0.5f);
+                            other[c * 2 + 1][depth_x] = static_cast<int>(other_pixel[1] + 0.5f);
+                        }
+                    }
+                }
+            };
+
+            if (!changes)
+                project_span(0, width);
+            else
+            {
+                // Only the runs of dirty tiles are projected again
+                const int tile_y = depth_y / changes->tile_size;
+                for (int tile_x = 0; tile_x < changes->tiles_x;)
+                {
+                    int end = tile_x;
+                    while (end < changes->tiles_x && changes->is_dirty(end, tile_y)) ++end;
+                    if (end > tile_x)
+                        project_span(tile_x * changes->tile_size, std::min(end * changes->tile_size, width));
+                    tile_x = end + 1;
+                }
+            }
+
+            int first = other_intrin.height, last = -1;
+            for (int depth_x = 0; depth_x < width; ++depth_x)
             {
                 // Skip over depth pixels with the value of zero, we have no depth data so we will not write anything into our aligned images
-                if (float depth = get_depth(depth_pixel_index))
+                if (!get_depth(depth_row_index + depth_x))
+                    continue;
+                if (other[0][depth_x] < 0 || other[1][depth_x] < 0 || other[2][depth_x] >= other_intrin.width || other[3][depth_x] >= other_intrin.height)
+                    continue;
+                first = std::min(first, other[1][depth_x]);
+                last = std::max(last, other[3][depth_x]);
+            }
+            row_range_data[depth_y * 2] = first;
+            row_range_data[depth_y * 2 + 1] = last;
+        }
+
+        // Transfer between the depth pixels and the pixels inside their rectangles on the other image, band by band
+        const int bands = (other_intrin.height + align_band_height - 1) / align_band_height;
+#pragma omp parallel for schedule(dynamic)
+        for (int band = 0; band < bands; ++band)
+        {
+            const int band_first = band * align_band_height;
+            const int band_last = std::min(band_first + align_band_height, other_intrin.height) - 1;
+            for (int depth_y = 0; depth_y < height; ++depth_y)
+            {
+                if (row_range_data[depth_y * 2] > band_last || row_range_data[depth_y * 2 + 1] < band_first)
+                    continue;
+
+                const int depth_row_index = depth_y * width;
+                const int * other[4];
+                for (int c = 0; c < 4; ++c) other[c] = corners_data + (static_cast<size_t>(depth_row_index) * 4) + c * width;
+
+                for (int depth_x = 0; depth_x < width; ++depth_x)
                 {
-                    // Map the top-left corner of the depth pixel onto the other image
-                    float depth_pixel[2] = { depth_x - 0.5f, depth_y - 0.5f }, depth_point[3], other_point[3], other_pixel[2];
-                    rs2_deproject_pixel_to_point(depth_point, &depth_intrin, depth_pixel, depth);
-                    rs2_transform_point_to_point(other_point, &depth_to_other, depth_point);
-                    rs2_project_point_to_pixel(other_pixel, &other_intrin, other_point);
-                    const int other_x0 = static_cast<int>(other_pixel[0] + 0.5f);
-                    const int other_y0 = static_cast<int>(other_pixel[1] + 0.5f);
-
-                    // Map the bottom-right corner of the depth pixel onto the other image
-                    depth_pixel[0] = depth_x + 0.5f; depth_pixel[1] = depth_y + 0.5f;
-                    rs2_deproject_pixel_to_point(depth_point, &depth_intrin, depth_pixel, depth);
-                    rs2_transform_point_to_point(other_point, &depth_to_other, depth_point);
-                    rs2_project_point_to_pixel(other_pixel, &other_intrin, other_point);
-                    const int other_x1 = static_cast<int>(other_pixel[0] + 0.5f);
-                    const int other_y1 = static_cast<int>(other_pixel[1] + 0.5f);
+                    if (!get_depth(depth_row_index + depth_x))
+                        continue;
 
+                    const int other_x0 = other[0][depth_x], other_y0 = other[1][depth_x];
+                    const int other_x1 = other[2][depth_x], other_y1 = other[3][depth_x];
                     if (other_x0 < 0 || other_y0 < 0 || other_x1 >= other_intrin.width || other_y1 >= other_intrin.height)
                         continue;
 
-                    // Transfer between the depth pixels and the pixels inside the rectangle on the other image
-                    for (int y = other_y0; y <= other_y1; ++y)
+                    for (int y = std::max(other_y0, band_first); y <= std::min(other_y1, band_last); ++y)
                     {
                         for (int x = other_x0; x <= other_x1; ++x)
                         {
-                            transfer_pixel(depth_pixel_index, y * other_intrin.width + x);
+                            transfer_pixel(depth_row_index + depth_x, y * other_intrin.width + x);
                         }
                     }
                 }
@@ -101,8 +365,36 @@ namespace librealsense
         }
     }
 
+    void align::update_sampled_profiles(const rs2_intrinsics& to_intrin)
+    {
+        if (_sampled_from_profile && !memcmp(&_sampled_intrinsics, &to_intrin, sizeof(to_intrin)))
+            return;
+
+        // Both frames of the output are in the geometry of the target, and share its extrinsics
+        auto make_profile = [&](const std::shared_ptr<stream_profile_interface>& profile)
+        {
+            auto res = profile->clone();
+            res->set_stream_type(profile->get_stream_type());
+            res->set_stream_index(profile->get_stream_index());
+            res->set_format(profile->get_format());
+            environment::get_instance().get_extrinsics_graph().register_same_extrinsics(*res, *_to_stream_profile);
+            if (auto video = As<video_stream_profile_interface>(res))
+            {
+                video->set_dims(to_intrin.width, to_intrin.height);
+                video->set_intrinsics([to_intrin]() { return to_intrin; });
+            }
+            return res;
+        };
+        _sampled_from_profile = make_profile(_from_stream_profile);
+        _sampled_to_profile = make_profile(_to_stream_profile);
+        _sampled_intrinsics = to_intrin;
+    }
+
     align::align(rs2_stream to_stream)
     {
+        // Frames of the target stream taken at every step-th pixel of the region inside the margins, with the source sampled alike
+        _sampling.register_options(*this, []() {});
+
         auto on_frame = [this, to_stream](rs2::frame f, const rs2::frame_source& source)
         {
             auto composite = f.as<rs2::frameset>();
@@ -149,40 +441,114 @@ namespace librealsense
 
             if (_from_intrinsics && _to_intrinsics && _extrinsics && _depth_units && _from_stream_profile && _to_stream_profile)
             {
-                std::vector<frame_holder> frames(2);
+                frame_holder frames[2];
                 bool from_depth = (*_from_stream_type == RS2_STREAM_DEPTH);
+                int output_image_bytes_per_pixel = _from_bytes_per_pixel.value();
+
+                // Both images are sampled with the same step, the margins apply to the output, which has the geometry of the target
+                auto from_sampling = _sampling.create(_from_intrinsics->width, _from_intrinsics->height, false);
+                auto to_sampling = _sampling.create(_to_intrinsics->width, _to_intrinsics->height, true);
+                auto from_intrin = from_sampling.apply(*_from_intrinsics);
+                auto to_intrin = to_sampling.apply(*_to_intrinsics);
+                bool sampled = !from_sampling.is_identity(_from_intrinsics->width, _from_intrinsics->height) ||
+                               !to_sampling.is_identity(_to_intrinsics->width, _to_intrinsics->height);
 
-                // Save the target ("to") frame as is
                 auto to_frame = (frame_interface*)to.get();
-                to_frame->acquire();
-                frames[0] = frame_holder{ to_frame };
+                auto out_profile = _from_stream_profile;
+                if (sampled)
+                {
+                    // The target frame is sampled as well, so that both frames of the output have the same intrinsics
+                    update_sampled_profiles(to_intrin);
+                    out_profile = _sampled_from_profile;
+                    auto to_video = to.as<rs2::video_frame>();
+                    int to_bytes_per_pixel = to_video.get_bytes_per_pixel();
+                    frame_holder sampled_to = get_source().allocate_video_frame(_sampled_to_profile, to_frame, to_bytes_per_pixel,
+                        to_intrin.width, to_intrin.height, to_intrin.width * to_bytes_per_pixel,
+                        to.is<rs2::depth_frame>() ? RS2_EXTENSION_DEPTH_FRAME : RS2_EXTENSION_VIDEO_FRAME);
+                    to_sampling.sample(reinterpret_cast<const uint8_t*>(to.get_data()), to_video.get_stride_in_bytes(),
+                        ((frame*)(sampled_to.frame))->data.data(), to_bytes_per_pixel);
+                    frames[0] = std::move(sampled_to);
+                }
+                else
+                {
+                    // Save the target ("to") frame as is
+                    to_frame->acquire();
+                    frames[0] = frame_holder{ to_frame };
+                }
 
                 auto from_frame = (frame_interface*)from.get();
 
                 // Create a new frame which will transform the "from" frame
-                int output_image_bytes_per_pixel = _from_bytes_per_pixel.value();
-                frame_holder out_frame = get_source().allocate_video_frame(_from_stream_profile, from_frame,
-                    output_image_bytes_per_pixel, _to_intrinsics->width, _to_intrinsics->height, 0, from_depth ? RS2_EXTENSION_DEPTH_FRAME : RS2_EXTENSION_VIDEO_FRAME);
+                frame_holder out_frame = get_source().allocate_video_frame(out_profile, from_frame,
+                    output_image_bytes_per_pixel, to_intrin.width, to_intrin.height, 0, from_depth ? RS2_EXTENSION_DEPTH_FRAME : RS2_EXTENSION_VIDEO_FRAME);
 
                 //Clear the new image buffer
                 auto p_out_frame = reinterpret_cast<uint8_t*>(((frame*)(out_frame.frame))->data.data());
                 int blank_color = (_from_stream_profile->get_format() == RS2_FORMAT_DISPARITY16) ? 0xFF : 0x00;
-                memset(p_out_frame, blank_color, _to_intrinsics->height * _to_intrinsics->width * output_image_bytes_per_pixel);
+                memset(p_out_frame, blank_color, to_intrin.height * to_intrin.width * output_image_bytes_per_pixel);
 
                 auto p_depth_frame = reinterpret_cast<const uint16_t*>(depth_frame.get_data());
                 auto p_from_frame = reinterpret_cast<const uint8_t*>(from.get_data());
+                if (!from_sampling.is_identity(_from_intrinsics->width, _from_intrinsics->height))
+                {
+                    // Reused by the following frames aligned on the same thread
+                    static thread_local std::vector<uint8_t> sampled_from;
+                    sampled_from.resize(from_intrin.width * from_intrin.height * output_image_bytes_per_pixel);
+                    from_sampling.sample(p_from_frame, from.as<rs2::video_frame>().get_stride_in_bytes(), sampled_from.data(), output_image_bytes_per_pixel);
+                    p_from_frame = sampled_from.data();
+                    if (from_depth) p_depth_frame = reinterpret_cast<const uint16_t*>(p_from_frame);
+                }
 
-                lock.unlock();
+                // Copied, as the sampling may change while the frame is aligned
+                _rays.update(from_intrin);
+                auto rays = _rays;
+                if (remap_table::needs_remap(to_intrin) && (!_to_map || memcmp(&_to_map->get_distorted_intrinsics(), &to_intrin, sizeof(to_intrin))))
+                    _to_map = remap_table::get(to_intrin);
+                auto to_map = remap_table::needs_remap(to_intrin) ? _to_map : nullptr;
+                bool z_buffer = from_depth && _from_stream_profile->get_format() == RS2_FORMAT_Z16;
                 float depth_units = _depth_units.value();
-                align_images(*_from_intrinsics, *_extrinsics, *_to_intrinsics,
-                    [p_depth_frame, depth_units, from_depth](int z_pixel_index) -> float
+                // Copied as well, the extrinsics are replaced under the lock while frames in flight are aligned
+                auto extrinsics = *_extrinsics;
+
+                // Following a frame of the same change detector aligned alike, only the corners of the changed tiles are projected
+                // The corners of the previous frame are taken over, frames in flight at the same time project all of theirs
+                static thread_local std::vector<int> thread_corners;
+                std::vector<int> frame_corners;
+                auto changes = from_depth && from_sampling.is_identity(_from_intrinsics->width, _from_intrinsics->height) ? get_change_mask(from) : nullptr;
+                bool keep_corners = false;
+                if (changes && changes->follows(_previous.sequence, from_intrin.width, from_intrin.height) && _previous.to_map == to_map.get() &&
+                    _previous.depth_units == depth_units && !memcmp(&_previous.from_intrinsics, &from_intrin, sizeof(from_intrin)) &&
+                    !memcmp(&_previous.to_intrinsics, &to_intrin, sizeof(to_intrin)) && !memcmp(&_previous.extrinsics, &extrinsics, sizeof(rs2_extrinsics)))
+                {
+                    frame_corners.swap(_previous.corners);
+                    _previous.sequence = 0;
+                    keep_corners = true;
+                }
+                auto& corners = changes ? frame_corners : thread_corners;
+                auto kept_changes = keep_corners ? changes : nullptr;
+
+                lock.unlock();
+                auto get_depth = [p_depth_frame, depth_units, from_depth](int z_pixel_index) -> float
                 {
                     if (from_depth)
                     {
                         return depth_units * p_depth_frame[z_pixel_index];
                     }
                     return 1;
-                },
+                };
+                if (z_buffer)
+                {
+                    // Z-buffer, the nearest of the depth pixels landing on a pixel wins
+                    auto p_out_depth = reinterpret_cast<uint16_t*>(p_out_frame);
+                    align_images(rays, from_intrin, extrinsics, to_intrin, to_map.get(), corners, kept_changes, get_depth,
+                        [p_out_depth, p_depth_frame](int from_pixel_index, int out_pixel_index)
+                    {
+                        const uint16_t z = p_depth_frame[from_pixel_index];
+                        uint16_t& out = p_out_depth[out_pixel_index];
+                        if (!out || z < out) out = z;
+                    });
+                }
+                else align_images(rays, from_intrin, extrinsics, to_intrin, to_map.get(), corners, kept_changes, get_depth,
                     [p_out_frame, p_from_frame, output_image_bytes_per_pixel](int from_pixel_index, int out_pixel_index)
                 {
                     //Tranfer n-bit pixel to n-bit pixel
@@ -195,12 +561,32 @@ namespace librealsense
                             : p_from_frame[from_offset];
                     }
                 });
+
+                if (changes)
+                {
+                    // Frames in flight may complete out of order, the corners of the latest frame are kept
+                    lock.lock();
+                    if (changes->sequence > _previous.sequence)
+                    {
+                        _previous.corners.swap(frame_corners);
+                        _previous.sequence = changes->sequence;
+                        _previous.from_intrinsics = from_intrin;
+                        _previous.to_intrinsics = to_intrin;
+                        _previous.extrinsics = extrinsics;
+                        _previous.depth_units = depth_units;
+                        _previous.to_map = to_map.get();
+                    }
+                    lock.unlock();
+                }
+
                 frames[1] = std::move(out_frame);
-                auto composite = get_source().allocate_composite_frame(std::move(frames));
+                auto composite = get_source().allocate_composite_frame(frames, 2);
                 get_source().frame_ready(std::move(composite));
             }
         };
         auto callback = new rs2::frame_processor_callback<decltype(on_frame)>(on_frame);
         processing_block::set_processing_callback(std::shared_ptr<rs2_frame_processor_callback>(callback));
+
+        enable_pipelining();
     }
 }
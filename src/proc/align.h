@@ -7,17 +7,32 @@
 #include "proc/synthetic-stream.h"
 #include "image.h"
 #include "source.h"
+#include "pixel-sampling.h"
 
 namespace librealsense
 {
+    // Normalized image plane coordinates of the edges of every depth pixel column and row,
+    // recomputed only when the depth intrinsics they were derived from change
+    class remap_table;
+
+    struct align_rays
+    {
+        rs2_intrinsics intrin;
+        std::vector<float> left, right, top, bottom;
+
+        void update(const rs2_intrinsics & depth_intrin);
+    };
+
     class align : public processing_block
     {
     public:
         align(rs2_stream align_to);
+        ~align() { flush_pipeline(); }
 
     private:
         static void update_frame_info(const frame_interface* frame, optional_value<rs2_intrinsics>& intrin, std::shared_ptr<stream_profile_interface>& profile, bool register_extrin);
         void update_align_info(const frame_interface* depth_frame);
+        void update_sampled_profiles(const rs2_intrinsics& to_intrin);
 
         std::mutex _mutex;
         optional_value<rs2_intrinsics> _from_intrinsics;
@@ -29,6 +44,23 @@ namespace librealsense
         rs2_stream _to_stream_type;
         std::shared_ptr<stream_profile_interface> _from_stream_profile;
         std::shared_ptr<stream_profile_interface> _to_stream_profile;
+        align_rays _rays;
+        std::shared_ptr<const remap_table> _to_map;
+        sampling_options _sampling;
+        std::shared_ptr<stream_profile_interface> _sampled_from_profile, _sampled_to_profile;
+        rs2_intrinsics _sampled_intrinsics;
+
+        // Corners of the latest frame aligned with a change mask, see align_images
+        struct previous_corners
+        {
+            std::vector<int> corners;
+            uint64_t sequence = 0;
+            rs2_intrinsics from_intrinsics, to_intrinsics;
+            rs2_extrinsics extrinsics;
+            float depth_units = 0;
+            const remap_table* to_map = nullptr;
+        };
+        previous_corners _previous;
         ;
     };
 }
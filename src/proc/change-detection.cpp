@@ -0,0 +1,198 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#include "../include/librealsense2/hpp/rs_sensor.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+
+#include "option.h"
+#include "archive.h"
+#include "cpu-features.h"
+#include "proc/synthetic-stream.h"
+#include "proc/change-detection.h"
+
+#include <algorithm>
+#include <limits>
+
+#ifdef __SSSE3__
+#include <emmintrin.h>
+#endif
+
+namespace librealsense
+{
+    const int change_tile_min = 8;
+    const int change_tile_max = 256;
+    const int change_tile_default = 32;
+
+    const float change_threshold_min = 0.f;
+    const float change_threshold_max = 1000.f;
+    const float change_threshold_default = 4.f;
+
+    // Shared by all the detectors, so a mask never follows the frame of another detector
+    static std::atomic<uint64_t> last_change_sequence{ 0 };
+
+    const uint64_t holes_changed = std::numeric_limits<uint64_t>::max();
+
+    // Sum of the absolute differences of two runs of depth pixels, or holes_changed when a pixel gained or lost its depth
+    // The results kept for clean tiles, like the corners of align, may then rely on their holes being the same
+    typedef uint64_t(*sad_function)(const uint16_t* a, const uint16_t* b, int count);
+
+    static uint64_t sad_scalar(const uint16_t* a, const uint16_t* b, int count)
+    {
+        uint64_t sum = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            if (!a[i] != !b[i]) return holes_changed;
+            sum += a[i] > b[i] ? a[i] - b[i] : b[i] - a[i];
+        }
+        return sum;
+    }
+
+#ifdef __SSSE3__
+    static uint64_t sad_sse(const uint16_t* a, const uint16_t* b, int count)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        __m128i sum = zero, holes = zero;
+        int i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+            const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i));
+            holes = _mm_or_si128(holes, _mm_xor_si128(_mm_cmpeq_epi16(va, zero), _mm_cmpeq_epi16(vb, zero)));
+            // |a - b| using saturated unsigned subtraction, widened to 32 bits as the differences may exceed 32767
+            const __m128i diff = _mm_or_si128(_mm_subs_epu16(va, vb), _mm_subs_epu16(vb, va));
+            const __m128i pairs = _mm_add_epi32(_mm_unpacklo_epi16(diff, zero), _mm_unpackhi_epi16(diff, zero));
+            // Accumulated in 64 bit lanes, so runs of any length fit
+            sum = _mm_add_epi64(sum, _mm_add_epi64(_mm_unpacklo_epi32(pairs, zero), _mm_unpackhi_epi32(pairs, zero)));
+        }
+        if (_mm_movemask_epi8(holes)) return holes_changed;
+
+        alignas(16) uint64_t lanes[2];
+        _mm_store_si128(reinterpret_cast<__m128i *>(lanes), sum);
+        auto tail = sad_scalar(a + i, b + i, count - i);
+        return tail == holes_changed ? holes_changed : lanes[0] + lanes[1] + tail;
+    }
+#endif
+
+    static sad_function select_sad()
+    {
+#ifdef __SSSE3__
+        if (cpu_supports(CPU_FEATURE_SSSE3)) return &sad_sse;
+#endif
+        return &sad_scalar;
+    }
+
+    const change_mask* get_change_mask(const rs2::frame& depth)
+    {
+        auto f = dynamic_cast<frame*>((frame_interface*)depth.get());
+        return f ? f->changes.get() : nullptr;
+    }
+
+    change_detector::change_detector()
+        : _tile_size(change_tile_default), _threshold(change_threshold_default),
+          _width(0), _height(0), _reference_tile_size(0), _last_sequence(0)
+    {
+        auto tile_size = std::make_shared<ptr_option<int>>(change_tile_min, change_tile_max, 1, change_tile_default,
+            &_tile_size, "Width and height of the tiles compared, in pixels");
+        auto threshold = std::make_shared<ptr_option<float>>(change_threshold_min, change_threshold_max, 0.5f, change_threshold_default,
+            &_threshold, "Mean absolute difference of the depth of a tile, in depth units, above which it changed");
+        register_option(RS2_OPTION_CHANGE_TILE_SIZE, tile_size);
+        register_option(RS2_OPTION_CHANGE_THRESHOLD, threshold);
+
+        unregister_option(RS2_OPTION_FRAMES_QUEUE_SIZE);
+        set_in_place_processing(true);
+
+        auto on_frame = [this](rs2::frame f, const rs2::frame_source& source)
+        {
+            bool composite = f.is<rs2::frameset>();
+            rs2::frame depth = composite ? f.as<rs2::frameset>().first_or_default(RS2_STREAM_DEPTH) : f;
+            if (!depth || depth.get_profile().format() != RS2_FORMAT_Z16)
+            {
+                source.frame_ready(f);
+                return;
+            }
+
+            auto vf = depth.as<rs2::video_frame>();
+            auto mask = detect(static_cast<const uint16_t*>(vf.get_data()), vf.get_width(), vf.get_height(), vf.get_stride_in_bytes());
+
+            // The mask goes on a frame of the block, the input itself when no one else holds it
+            rs2::frame tgt = source.allocate_video_frame(depth.get_profile(), depth, vf.get_bytes_per_pixel(),
+                vf.get_width(), vf.get_height(), vf.get_stride_in_bytes(), RS2_EXTENSION_DEPTH_FRAME);
+            if (tgt.get() != depth.get())
+                memcpy(const_cast<void*>(tgt.get_data()), vf.get_data(), vf.get_stride_in_bytes() * vf.get_height());
+            ((frame*)(frame_interface*)tgt.get())->changes = std::move(mask);
+
+            if (!composite)
+            {
+                source.frame_ready(tgt);
+                return;
+            }
+
+            // The other frames of the set stay, align needs them
+            std::vector<rs2::frame> frames;
+            for (auto&& member : f.as<rs2::frameset>())
+                frames.push_back(member.get() == depth.get() ? tgt : member);
+            source.frame_ready(source.allocate_composite_frame(std::move(frames)));
+        };
+
+        auto callback = new rs2::frame_processor_callback<decltype(on_frame)>(on_frame);
+        processing_block::set_processing_callback(std::shared_ptr<rs2_frame_processor_callback>(callback));
+    }
+
+    std::shared_ptr<change_mask> change_detector::detect(const uint16_t* depth, int width, int height, int stride)
+    {
+        static const auto sad = select_sad();
+
+        auto mask = std::make_shared<change_mask>();
+        mask->sequence = ++last_change_sequence;
+        mask->width = width;
+        mask->height = height;
+        mask->tile_size = _tile_size;
+        mask->tiles_x = (width + mask->tile_size - 1) / mask->tile_size;
+        mask->tiles_y = (height + mask->tile_size - 1) / mask->tile_size;
+
+        const int row_pixels = stride / static_cast<int>(sizeof(uint16_t));
+        // Nothing to compare the first frame, or one of another size or tiling, to: every tile changed
+        if (width != _width || height != _height || mask->tile_size != _reference_tile_size)
+        {
+            _width = width;
+            _height = height;
+            _reference_tile_size = mask->tile_size;
+            _reference.resize(static_cast<size_t>(width) * height);
+            for (int y = 0; y < height; ++y)
+                std::copy(depth + y * row_pixels, depth + y * row_pixels + width, _reference.data() + y * width);
+
+            mask->dirty.assign(mask->tiles_x * mask->tiles_y, 1);
+            mask->dirty_count = mask->dirty.size();
+            _last_sequence = mask->sequence;
+            return mask;
+        }
+
+        mask->previous_sequence = _last_sequence;
+        mask->dirty.assign(mask->tiles_x * mask->tiles_y, 0);
+        for (int tile_y = 0; tile_y < mask->tiles_y; ++tile_y)
+        {
+            const int y0 = tile_y * mask->tile_size, y1 = std::min(y0 + mask->tile_size, height);
+            for (int tile_x = 0; tile_x < mask->tiles_x; ++tile_x)
+            {
+                const int x0 = tile_x * mask->tile_size, x1 = std::min(x0 + mask->tile_size, width);
+                const uint64_t limit = static_cast<uint64_t>(_threshold * (x1 - x0) * (y1 - y0));
+
+                // A tile is known to have changed as soon as the sum exceeds the limit
+                uint64_t sum = 0;
+                for (int y = y0; y < y1 && sum <= limit; ++y)
+                {
+                    auto row_sum = sad(depth + y * row_pixels + x0, _reference.data() + y * width + x0, x1 - x0);
+                    sum = row_sum == holes_changed ? holes_changed : sum + row_sum;
+                }
+                if (sum <= limit) continue;
+
+                mask->dirty[tile_y * mask->tiles_x + tile_x] = 1;
+                mask->dirty_count++;
+                for (int y = y0; y < y1; ++y)
+                    std::copy(depth + y * row_pixels + x0, depth + y * row_pixels + x1, _reference.data() + y * width + x0);
+            }
+        }
+        _last_sequence = mask->sequence;
+        return mask;
+    }
+}
@@ -0,0 +1,54 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "../include/librealsense2/hpp/rs_frame.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+#include "synthetic-stream.h"
+
+namespace librealsense
+{
+    // Tiles of a depth frame that changed since the previous frame of the same change detector
+    // A tile is clean when it differs by no more than the threshold from its content when it was last marked dirty,
+    // so a consumer that processed every frame of the sequence may keep its previous results for the clean tiles
+    struct change_mask
+    {
+        uint64_t sequence = 0;              // Unique to the frame the mask was computed for
+        uint64_t previous_sequence = 0;     // Of the frame of the detector before it, zero when all the tiles are dirty
+        int width = 0, height = 0;          // Of the depth frame
+        int tile_size = 0;
+        int tiles_x = 0, tiles_y = 0;
+        std::vector<uint8_t> dirty;         // Non-zero for the tiles that changed, row by row
+        size_t dirty_count = 0;
+
+        bool is_dirty(int tile_x, int tile_y) const { return dirty[tile_y * tiles_x + tile_x] != 0; }
+
+        // True when the results of the frame of the given sequence, of the same size, can be kept for the clean tiles
+        bool follows(uint64_t sequence_processed, int frame_width, int frame_height) const
+        {
+            return previous_sequence && previous_sequence == sequence_processed && frame_width == width && frame_height == height;
+        }
+    };
+
+    // The changed tiles of a depth frame, when the frame went through a change detector and was not written since
+    const change_mask* get_change_mask(const rs2::frame& depth);
+
+    // Compares Z16 depth frames to the previous one, tile by tile, and attaches to each a mask of the tiles whose mean
+    // absolute difference exceeds RS2_OPTION_CHANGE_THRESHOLD. Pointcloud and align placed after it recompute
+    // only the changed tiles of mostly static scenes
+    class change_detector : public processing_block
+    {
+    public:
+        change_detector();
+
+    private:
+        std::shared_ptr<change_mask> detect(const uint16_t* depth, int width, int height, int stride);
+
+        int                     _tile_size;
+        float                   _threshold;
+        std::vector<uint16_t>   _reference;     // Content of every tile when it was last marked dirty
+        int                     _width, _height, _reference_tile_size;
+        uint64_t                _last_sequence;
+    };
+}
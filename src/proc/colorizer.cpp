@@ -9,6 +9,13 @@
 #include "environment.h"
 #include "option.h"
 #include "colorizer.h"
+#include "cpu-features.h"
+
+#include <algorithm>
+
+#ifdef __SSSE3__
+#include <immintrin.h> // For AVX2 intrinsic, only executed when supported by the running CPU
+#endif
 
 namespace librealsense
 {
@@ -123,8 +130,82 @@ namespace librealsense
         { 0, 0, 0 },
         } };
 
+    const int max_depth = 0x10000;
+
+    static uint32_t pack_color(const float3& c)
+    {
+        return uint32_t((uint8_t)c.x) | (uint32_t((uint8_t)c.y) << 8) | (uint32_t((uint8_t)c.z) << 16);
+    }
+
+    static void colorize_scalar(const uint16_t * depth, uint8_t * rgb, const uint32_t * lut, int count)
+    {
+        for (auto i = 0; i < count; ++i)
+        {
+            auto c = lut[depth[i]];
+            rgb[i * 3 + 0] = (uint8_t)c;
+            rgb[i * 3 + 1] = (uint8_t)(c >> 8);
+            rgb[i * 3 + 2] = (uint8_t)(c >> 16);
+        }
+    }
+
+#ifdef __SSSE3__
+    // Squeeze the colors of 16 pixels, given by 4 pixels in every register, into 48 RGB bytes
+    static void store_rgb(uint8_t * rgb, __m128i c0, __m128i c1, __m128i c2, __m128i c3)
+    {
+        const __m128i pack = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+        c0 = _mm_shuffle_epi8(c0, pack);
+        c1 = _mm_shuffle_epi8(c1, pack);
+        c2 = _mm_shuffle_epi8(c2, pack);
+        c3 = _mm_shuffle_epi8(c3, pack);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(rgb), _mm_or_si128(c0, _mm_slli_si128(c1, 12)));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(rgb + 16), _mm_or_si128(_mm_srli_si128(c1, 4), _mm_slli_si128(c2, 8)));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(rgb + 32), _mm_or_si128(_mm_srli_si128(c2, 8), _mm_slli_si128(c3, 4)));
+    }
+
+    static void colorize_sse(const uint16_t * depth, uint8_t * rgb, const uint32_t * lut, int count)
+    {
+        auto i = 0;
+        for (; i + 16 <= count; i += 16)
+        {
+            auto d = depth + i;
+            store_rgb(rgb + i * 3,
+                _mm_setr_epi32(lut[d[0]], lut[d[1]], lut[d[2]], lut[d[3]]),
+                _mm_setr_epi32(lut[d[4]], lut[d[5]], lut[d[6]], lut[d[7]]),
+                _mm_setr_epi32(lut[d[8]], lut[d[9]], lut[d[10]], lut[d[11]]),
+                _mm_setr_epi32(lut[d[12]], lut[d[13]], lut[d[14]], lut[d[15]]));
+        }
+        colorize_scalar(depth + i, rgb + i * 3, lut, count - i);
+    }
+
+    AVX2_TARGET static void colorize_avx2(const uint16_t * depth, uint8_t * rgb, const uint32_t * lut, int count)
+    {
+        auto table = reinterpret_cast<const int *>(lut);
+        auto i = 0;
+        for (; i + 16 <= count; i += 16)
+        {
+            const __m256i lo = _mm256_i32gather_epi32(table, _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(depth + i))), 4);
+            const __m256i hi = _mm256_i32gather_epi32(table, _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(depth + i + 8))), 4);
+            store_rgb(rgb + i * 3, _mm256_castsi256_si128(lo), _mm256_extracti128_si256(lo, 1),
+                                   _mm256_castsi256_si128(hi), _mm256_extracti128_si256(hi, 1));
+        }
+        colorize_scalar(depth + i, rgb + i * 3, lut, count - i);
+    }
+#endif
+
+    typedef void(*colorize_function)(const uint16_t * depth, uint8_t * rgb, const uint32_t * lut, int count);
+
+    static colorize_function select_colorize()
+    {
+#ifdef __SSSE3__
+        if (cpu_supports(CPU_FEATURE_AVX2)) return &colorize_avx2;
+        if (cpu_supports(CPU_FEATURE_SSSE3)) return &colorize_sse;
+#endif
+        return &colorize_scalar;
+    }
+
     colorizer::colorizer()
-        : _min(0.f), _max(6.f), _equalize(true), _stream()
+        : _min(0.f), _max(6.f), _equalize(true), _histogram_subsampling(1), _stream(),
+          _lut_map(nullptr), _lut_min(0.f), _lut_max(0.f), _lut_units(0.f)
     {
         _maps = { &jet, &classic, &grayscale, &inv_grayscale, &biomes, &cold, &warm, &quantized, &pattern };
 
@@ -191,6 +272,10 @@ namespace librealsense
         auto hist_opt = std::make_shared<ptr_option<bool>>(false, true, true, true, &_equalize, "Perform histogram equalization");
         register_option(RS2_OPTION_HISTOGRAM_EQUALIZATION_ENABLED, hist_opt);
 
+        auto subsampling_opt = std::make_shared<ptr_option<uint8_t>>(1, 8, 1, 1, &_histogram_subsampling,
+            "Count one pixel out of every N by N block into the equalization histogram");
+        register_option(RS2_OPTION_HISTOGRAM_SUBSAMPLING, subsampling_opt);
+
         auto on_frame = [this](rs2::frame f, const rs2::frame_source& source)
         {
             auto process_frame = [this, &source](const rs2::frame f)
@@ -204,72 +289,6 @@ namespace librealsense
                     }
                 }
 
-                auto make_equalized_histogram = [this](const rs2::video_frame& depth, rs2::video_frame rgb)
-                {
-                    const auto max_depth = 0x10000;
-                    static uint32_t histogram[max_depth];
-                    memset(histogram, 0, sizeof(histogram));
-
-                    const auto w = depth.get_width(), h = depth.get_height();
-                    const auto depth_data = reinterpret_cast<const uint16_t*>(depth.get_data());
-                    auto rgb_data = reinterpret_cast<uint8_t*>(const_cast<void *>(rgb.get_data()));
-
-                    for (auto i = 0; i < w*h; ++i) ++histogram[depth_data[i]];
-                    for (auto i = 2; i < max_depth; ++i) histogram[i] += histogram[i - 1]; // Build a cumulative histogram for the indices in [1,0xFFFF]
-                    auto cm = _maps[_map_index];
-                    for (auto i = 0; i < w*h; ++i)
-                    {
-                        auto d = depth_data[i];
-
-                        if (d)
-                        {
-                            auto f = histogram[d] / (float)histogram[0xFFFF]; // 0-255 based on histogram location
-
-                            auto c = cm->get(f);
-                            rgb_data[i * 3 + 0] = (uint8_t)c.x;
-                            rgb_data[i * 3 + 1] = (uint8_t)c.y;
-                            rgb_data[i * 3 + 2] = (uint8_t)c.z;
-                        }
-                        else
-                        {
-                            rgb_data[i * 3 + 0] = 0;
-                            rgb_data[i * 3 + 1] = 0;
-                            rgb_data[i * 3 + 2] = 0;
-                        }
-                    }
-                };
-                auto make_value_cropped_frame = [this](const rs2::video_frame& depth, rs2::video_frame rgb)
-                {
-                    const auto max_depth = 0x10000;
-                    const auto w = depth.get_width(), h = depth.get_height();
-                    const auto depth_data = reinterpret_cast<const uint16_t*>(depth.get_data());
-                    auto rgb_data = reinterpret_cast<uint8_t*>(const_cast<void *>(rgb.get_data()));
-
-                    auto fi = (frame_interface*)depth.get();
-                    auto df = dynamic_cast<librealsense::depth_frame*>(fi);
-                    auto depth_units = df->get_units();
-
-                    for (auto i = 0; i < w*h; ++i)
-                    {
-                        auto d = depth_data[i];
-
-                        if (d)
-                        {
-                            auto f = (d * depth_units - _min) / (_max - _min);
-
-                            auto c = _maps[_map_index]->get(f);
-                            rgb_data[i * 3 + 0] = (uint8_t)c.x;
-                            rgb_data[i * 3 + 1] = (uint8_t)c.y;
-                            rgb_data[i * 3 + 2] = (uint8_t)c.z;
-                        }
-                        else
-                        {
-                            rgb_data[i * 3 + 0] = 0;
-                            rgb_data[i * 3 + 1] = 0;
-                            rgb_data[i * 3 + 2] = 0;
-                        }
-                    }
-                };
                 rs2::frame ret = f;
 
                 if (f.get_profile().stream_type() == RS2_STREAM_DEPTH)
@@ -278,8 +297,10 @@ namespace librealsense
 
                     ret = source.allocate_video_frame(*_stream, f, 3, vf.get_width(), vf.get_height(), vf.get_width() * 3, RS2_EXTENSION_DEPTH_FRAME);
 
-                    if (_equalize) make_equalized_histogram(f, ret);
-                    else make_value_cropped_frame(f, ret);
+                    std::lock_guard<std::mutex> lock(_lut_mutex);
+                    make_lut(vf);
+                    colorize(reinterpret_cast<const uint16_t*>(vf.get_data()), reinterpret_cast<uint8_t*>(const_cast<void*>(ret.get_data())),
+                             vf.get_width() * vf.get_height());
                 }
 
                 source.frame_ready(ret);
@@ -292,4 +313,119 @@ namespace librealsense
         auto callback = new rs2::frame_processor_callback<decltype(on_frame)>(on_frame);
         processing_block::set_processing_callback(std::shared_ptr<rs2_frame_processor_callback>(callback));
     }
+
+    void colorizer::make_lut(const rs2::video_frame& depth)
+    {
+        auto cm = _maps[_map_index];
+        if (_equalize) make_equalized_lut(reinterpret_cast<const uint16_t*>(depth.get_data()), depth.get_width(), depth.get_height(), cm);
+        else
+        {
+            auto df = dynamic_cast<librealsense::depth_frame*>((frame_interface*)depth.get());
+            if (!df)
+                throw invalid_value_exception("Colors of fixed depth ranges need a depth frame");
+            make_value_cropped_lut(df->get_units(), cm);
+        }
+    }
+
+    void colorizer::get_lut(const rs2::video_frame& depth, uint32_t* lut)
+    {
+        std::lock_guard<std::mutex> lock(_lut_mutex);
+        make_lut(depth);
+        std::copy(_lut.begin(), _lut.end(), lut);
+    }
+
+    void colorizer::make_equalized_lut(const uint16_t* depth, int width, int height, const color_map* cm)
+    {
+        auto&& pool = environment::get_instance().get_worker_pool();
+        const int step = std::max<int>(_histogram_subsampling, 1);
+        const int rows = (height + step - 1) / step;
+        const int samples = rows * ((width + step - 1) / step);
+
+        // Every band counts its sampled rows into a histogram of its own, these are summed up afterwards,
+        // so a band is only worth its histogram when it samples at least as many pixels as there are bins
+        const int bands = static_cast<int>(std::max<size_t>(std::min<size_t>(samples / max_depth, pool.size() + 1), 1));
+        _histogram.resize(max_depth);
+        _band_histograms.resize(bands);
+        pool.run(bands, [&](int band)
+        {
+            auto&& histogram = (bands == 1) ? _histogram : _band_histograms[band];
+            histogram.assign(max_depth, 0);
+            for (auto j = rows * band / bands; j < rows * (band + 1) / bands; ++j)
+            {
+                auto row = depth + j * step * width;
+                for (auto i = 0; i < width; i += step) ++histogram[row[i]];
+            }
+        });
+        if (bands > 1)
+        {
+            pool.run(bands, [&](int band)
+            {
+                for (auto i = max_depth * band / bands; i < max_depth * (band + 1) / bands; ++i)
+                {
+                    uint32_t sum = 0;
+                    for (auto&& h : _band_histograms) sum += h[i];
+                    _histogram[i] = sum;
+                }
+            });
+        }
+
+        auto histogram = _histogram.data();
+        for (auto i = 2; i < max_depth; ++i) histogram[i] += histogram[i - 1]; // Build a cumulative histogram for the indices in [1,0xFFFF]
+
+        // Depth values that no pixel has share the color of the value below them, these are most of the range
+        const float total = static_cast<float>(std::max<uint32_t>(histogram[0xFFFF], 1));
+        _lut.resize(max_depth);
+        _lut_map = nullptr;
+        auto lut = _lut.data();
+        lut[0] = 0;
+        pool.run(bands, [&](int band)
+        {
+            auto begin = std::max(max_depth * band / bands, 1), end = max_depth * (band + 1) / bands;
+            for (auto i = begin; i < end; ++i)
+            {
+                if (i > begin && histogram[i] == histogram[i - 1]) lut[i] = lut[i - 1];
+                else lut[i] = pack_color(cm->get(histogram[i] / total)); // 0-255 based on histogram location
+            }
+        });
+    }
+
+    void colorizer::make_value_cropped_lut(float depth_units, const color_map* cm)
+    {
+        if (_lut.size() == max_depth && _lut_map == cm && _lut_min == _min && _lut_max == _max && _lut_units == depth_units)
+            return;
+
+        _lut.resize(max_depth);
+        auto lut = _lut.data();
+        lut[0] = 0;
+
+        auto&& pool = environment::get_instance().get_worker_pool();
+        const int bands = static_cast<int>(pool.size() + 1);
+        pool.run(bands, [&](int band)
+        {
+            for (auto d = std::max(max_depth * band / bands, 1); d < max_depth * (band + 1) / bands; ++d)
+                lut[d] = pack_color(cm->get((d * depth_units - _min) / (_max - _min)));
+        });
+
+        _lut_map = cm;
+        _lut_min = _min;
+        _lut_max = _max;
+        _lut_units = depth_units;
+    }
+
+    void colorizer::colorize(const uint16_t* depth, uint8_t* rgb, int count) const
+    {
+        static const auto colorize_pixels = select_colorize();
+
+        // Bands of whole vectors of pixels, the last one takes the remainder
+        auto&& pool = environment::get_instance().get_worker_pool();
+        const int bands = std::max(std::min(count / 16, static_cast<int>(pool.size() + 1)), 1);
+        const int band_size = count / bands / 16 * 16;
+        auto lut = _lut.data();
+        pool.run(bands, [&](int band)
+        {
+            auto begin = band * band_size;
+            auto end = (band == bands - 1) ? count : begin + band_size;
+            colorize_pixels(depth + begin, rgb + begin * 3, lut, end - begin);
+        });
+    }
 }
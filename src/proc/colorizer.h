@@ -9,6 +9,7 @@
 namespace rs2
 {
     class stream_profile;
+    class video_frame;
 }
 
 namespace librealsense {
@@ -111,13 +112,34 @@ namespace librealsense {
     public:
         colorizer();
 
+        // Copies the color of every depth value, as the frame would be colorized with, to a table of 0x10000 entries
+        void get_lut(const rs2::video_frame& depth, uint32_t* lut);
+
+    protected:
+        void make_lut(const rs2::video_frame& depth);
+        void make_equalized_lut(const uint16_t* depth, int width, int height, const color_map* cm);
+        void make_value_cropped_lut(float depth_units, const color_map* cm);
+        void colorize(const uint16_t* depth, uint8_t* rgb, int count) const;
+
     private:
         float _min, _max;
         bool _equalize;
         std::vector<color_map*> _maps;
         int _map_index = 0;
         int _preset = 0;
+        uint8_t _histogram_subsampling;
         std::mutex _mutex;
+        std::mutex _lut_mutex;                                  // Guards the colors below, which get_lut may ask for from other threads
         std::shared_ptr<rs2::stream_profile> _stream;
+
+        // Histograms belong to the instance and are only touched under _lut_mutex, so colorizers
+        // of different streams equalize their frames at the same time without sharing any state
+        std::vector<uint32_t> _histogram;                       // Cumulative histogram of the depth values
+        std::vector<std::vector<uint32_t>> _band_histograms;    // Histograms of the frame bands counted by the worker threads
+        std::vector<uint32_t> _lut;                             // Color of every depth value, as RGB bytes in the low bits of a word
+
+        // Parameters the value cropped colors were computed for, they are reused as long as these are unchanged
+        const color_map* _lut_map;
+        float _lut_min, _lut_max, _lut_units;
     };
 }
@@ -0,0 +1,147 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#include <cmath>
+
+#include "option.h"
+#include "sync.h"
+#include "proc/cross-device-syncer.h"
+
+namespace librealsense
+{
+    const size_t MAX_PENDING_FRAMES_PER_LANE = 16;
+    const double LANE_INACTIVE_MS            = 1000;    // Devices silent for longer are not waited for
+    const double DEFAULT_SYNC_TOLERANCE_MS   = 16;      // Until the frame rates are known
+
+    cross_device_syncer::cross_device_syncer()
+        : _tolerance(0), _max_latency(100)
+    {
+        auto tolerance = std::make_shared<ptr_option<float>>(0.f, 1000.f, 1.f, 0.f, &_tolerance,
+            "Maximal difference between the timestamps of matched frames in milliseconds, zero for half the frame interval");
+        register_option(RS2_OPTION_SYNC_TOLERANCE, tolerance);
+
+        auto max_latency = std::make_shared<ptr_option<float>>(1.f, 5000.f, 1.f, 100.f, &_max_latency,
+            "Maximal time in milliseconds a frame waits for the frames of the other devices");
+        register_option(RS2_OPTION_SYNC_MAX_LATENCY, max_latency);
+
+        auto on_frame = [this](frame_holder frame, synthetic_source_interface* source)
+        {
+            handle_frame(std::move(frame), source);
+        };
+
+        set_processing_callback(std::shared_ptr<rs2_frame_processor_callback>(
+            new internal_frame_processor_callback<decltype(on_frame)>(on_frame)));
+    }
+
+    cross_device_syncer::device_lane& cross_device_syncer::get_lane(const frame_holder& frame)
+    {
+        // Frames without a sensor, such as software frames, form a lane of their stream
+        const void* device = frame.frame->get_stream().get();
+        if (auto sensor = frame.frame->get_sensor())
+            device = &sensor->get_device();
+
+        for (auto&& lane : _lanes)
+            if (lane.device == device) return lane;
+
+        _lanes.emplace_back();
+        _lanes.back().device = device;
+        return _lanes.back();
+    }
+
+    void cross_device_syncer::handle_frame(frame_holder frame, synthetic_source_interface* source)
+    {
+        std::vector<frame_holder> ready;
+        {
+            std::lock_guard<std::mutex> lock(_sync_mutex);
+
+            auto hw_time = frame->get_frame_timestamp();
+            auto host_time = frame->get_frame_system_time();
+            auto&& lane = get_lane(frame);
+
+            auto time = hw_time;
+            // Frames in the global time domain are already on the host clock
+            if (frame->get_frame_timestamp_domain() == RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK)
+            {
+                lane.clock.add_sample(hw_time, host_time);
+                time = lane.clock.to_host(hw_time);
+            }
+
+            if (lane.last_time > 0 && time > lane.last_time)
+            {
+                auto interval = time - lane.last_time;
+                lane.interval = lane.interval > 0 ? lane.interval + 0.1 * (interval - lane.interval) : interval;
+            }
+            lane.last_time = time;
+            lane.last_arrival = host_time;
+
+            lane.frames.push_back({ std::move(frame), time, host_time });
+            if (lane.frames.size() > MAX_PENDING_FRAMES_PER_LANE) lane.frames.pop_front();
+
+            while (release_group(host_time, ready, source));
+        }
+
+        for (auto&& f : ready)
+            source->frame_ready(std::move(f));
+    }
+
+    bool cross_device_syncer::release_group(double now, std::vector<frame_holder>& ready, synthetic_source_interface* source)
+    {
+        auto tolerance = static_cast<double>(_tolerance);
+        if (tolerance <= 0)
+        {
+            tolerance = DEFAULT_SYNC_TOLERANCE_MS;
+            auto min_interval = 0.;
+            for (auto&& lane : _lanes)
+                if (lane.interval > 0 && (min_interval == 0 || lane.interval < min_interval)) min_interval = lane.interval;
+            if (min_interval > 0) tolerance = min_interval / 2;
+        }
+
+        // The group is built around the oldest pending frame
+        const pending_frame* oldest = nullptr;
+        for (auto&& lane : _lanes)
+            if (!lane.frames.empty() && (!oldest || lane.frames.front().time < oldest->time))
+                oldest = &lane.frames.front();
+        if (!oldest) return false;
+
+        auto group_end = oldest->time + tolerance;
+        if (now - oldest->arrival < _max_latency)
+        {
+            for (auto&& lane : _lanes)
+            {
+                if (!lane.frames.empty() || now - lane.last_arrival > LANE_INACTIVE_MS) continue;
+
+                // The next frame of the device is not waited for when it is expected after the group
+                auto expected = lane.last_time + lane.interval;
+                if (lane.interval > 0 && expected - tolerance > group_end) continue;
+
+                return false;
+            }
+        }
+
+        frameset_builder set;
+        for (auto&& lane : _lanes)
+        {
+            if (lane.frames.empty() || lane.frames.front().time > group_end) continue;
+
+            auto f = std::move(lane.frames.front().frame);
+            lane.frames.pop_front();
+
+            // Framesets of the devices are flattened into the cross-device frameset
+            if (auto composite = dynamic_cast<composite_frame*>(f.frame))
+            {
+                for (size_t i = 0; i < composite->get_embedded_frames_count(); i++)
+                {
+                    auto embedded = composite->get_frame(static_cast<int>(i));
+                    embedded->acquire();
+                    set.add(embedded);
+                }
+            }
+            else set.add(std::move(f));
+        }
+
+        frame_holder result = set.build(*source);
+        if (result) ready.push_back(std::move(result));
+        else LOG_ERROR("Failed to allocate cross-device frameset");
+        return true;
+    }
+}
@@ -0,0 +1,49 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include <deque>
+#include <vector>
+
+#include "synthetic-stream.h"
+#include "clock-model.h"
+
+namespace librealsense
+{
+    // Matches the frames of several devices on a clock shared by all of them, and outputs one frameset
+    // per group of frames captured at the same time. Each device is a lane; a group is released as soon as
+    // every active device contributed, or once its oldest frame waited longer than the latency bound
+    class cross_device_syncer : public processing_block
+    {
+    public:
+        cross_device_syncer();
+
+    private:
+        struct pending_frame
+        {
+            frame_holder frame;
+            double time;        // On the shared clock, in milliseconds
+            double arrival;     // Host time the frame was received at
+        };
+
+        struct device_lane
+        {
+            const void* device;
+            device_clock_model clock;
+            std::deque<pending_frame> frames;
+            double last_time = 0;       // Shared clock time of the last frame received
+            double last_arrival = 0;
+            double interval = 0;        // Average time between frames
+        };
+
+        void handle_frame(frame_holder frame, synthetic_source_interface* source);
+        device_lane& get_lane(const frame_holder& frame);
+        bool release_group(double now, std::vector<frame_holder>& ready, synthetic_source_interface* source);
+
+        std::deque<device_lane> _lanes;     // One per device, in order of appearance
+        std::mutex _sync_mutex;
+        float _tolerance;
+        float _max_latency;
+    };
+}
@@ -9,6 +9,10 @@
 #include "proc/synthetic-stream.h"
 #include "proc/decimation-filter.h"
 #include "environment.h"
+#include "cpu-features.h"
+#include "proc/median-network.h"
+
+#include <algorithm>
 
 namespace librealsense
 {
@@ -21,7 +25,8 @@ namespace librealsense
         _decimation_factor(decimation_default_val),
         _patch_size(0x1 << (uint8_t(decimation_default_val - 1))),
         _kernel_size(_patch_size*_patch_size),
-         _recalc_profile(false)
+        _width(0), _height(0),
+        _recalc_profile(false)
     {
         auto decimation_control = std::make_shared<ptr_option<uint8_t>>(
             decimation_min_val,
@@ -44,6 +49,7 @@ namespace librealsense
 
         register_option(RS2_OPTION_FILTER_MAGNITUDE, decimation_control);
         unregister_option(RS2_OPTION_FRAMES_QUEUE_SIZE);
+        set_in_place_processing(true);
 
         auto on_frame = [this](rs2::frame f, const rs2::frame_source& source)
         {
@@ -55,13 +61,11 @@ namespace librealsense
 
             if (depth) // Processing required
             {
-                update_output_profile(depth);
+                configure_stage(depth.get_profile());
                 if (tgt = prepare_target_frame(depth, source))
                 {
-                    auto src = depth.as<rs2::video_frame>();
-                    decimate_depth(static_cast<const uint16_t*>(src.get_data()),
-                        static_cast<uint16_t*>(const_cast<void*>(tgt.get_data())),
-                        src.get_width(), src.get_height(), this->_patch_size);
+                    run_stage(static_cast<const uint16_t*>(depth.get_data()),
+                        static_cast<uint16_t*>(const_cast<void*>(tgt.get_data())));
                 }
             }
 
@@ -74,11 +78,25 @@ namespace librealsense
         processing_block::set_processing_callback(std::shared_ptr<rs2_frame_processor_callback>(callback));
     }
 
-    void  decimation_filter::update_output_profile(const rs2::frame& f)
+    rs2::stream_profile decimation_filter::configure_stage(const rs2::stream_profile& input)
+    {
+        update_output_profile(input);
+        return _target_stream_profile;
+    }
+
+    void decimation_filter::run_stage(const uint16_t* input, uint16_t* output)
     {
-        if (f.get_profile().get() != _source_stream_profile.get())
+        // A single pixel patch within a chain may be asked to work in place
+        if (input == output && _patch_size == 1) return;
+
+        decimate_depth(input, output, _width, _height, _patch_size);
+    }
+
+    void  decimation_filter::update_output_profile(const rs2::stream_profile& profile)
+    {
+        if (profile.get() != _source_stream_profile.get())
         {
-            _source_stream_profile = f.get_profile();
+            _source_stream_profile = profile;
             _recalc_profile = true;
         }
 
@@ -90,8 +108,10 @@ namespace librealsense
             if ((vp.width() % _patch_size) || (vp.height() % _patch_size))
                 throw invalid_value_exception(to_string() << "Unsupported decimation patch: " << _patch_size
                     << " for frame size [" << vp.width() << "," << vp.height() << "]");
+            _width = vp.width();
+            _height = vp.height();
 
-            _target_stream_profile = _source_stream_profile.clone(RS2_STREAM_DEPTH, 0, RS2_FORMAT_Z16);
+            _target_stream_profile = _source_stream_profile.clone(RS2_STREAM_DEPTH, 0, _source_stream_profile.format());
             environment::get_instance().get_extrinsics_graph().register_same_extrinsics(*(stream_interface*)(_source_stream_profile.get()->profile), *(stream_interface*)(_target_stream_profile.get()->profile));
             auto src_vspi = dynamic_cast<video_stream_profile_interface*>(_source_stream_profile.get()->profile);
             auto tgt_vspi = dynamic_cast<video_stream_profile_interface*>(_target_stream_profile.get()->profile);
@@ -123,6 +143,81 @@ namespace librealsense
     }
 
 
+    // Median of every SCALE x SCALE block of one band of SCALE input rows
+    template<int SCALE>
+    static void decimate_row(const uint16_t * block_start, size_t width_in, uint16_t * out, size_t width_out)
+    {
+        const int kernel_size = SCALE * SCALE;
+        size_t i = 0;
+
+#if defined(__SSSE3__) || defined(MEDIAN_NETWORK_USE_NEON)
+        // Eight output pixels per step, lane l of kernel vector k holding element k of the block of pixel l
+#ifdef __SSSE3__
+        static const bool vectorize = cpu_supports(CPU_FEATURE_SSSE3);
+#else
+        static const bool vectorize = cpu_supports(CPU_FEATURE_NEON);
+#endif
+        for (; vectorize && i + 8 <= width_out; i += 8)
+        {
+            alignas(16) uint16_t lanes[kernel_size][8];
+            for (int n = 0; n < SCALE; n++)
+            {
+                auto row = block_start + width_in * n + i * SCALE;
+                for (int l = 0; l < 8; l++)
+                    for (int m = 0; m < SCALE; m++)
+                        lanes[n * SCALE + m][l] = row[l * SCALE + m];
+            }
+
+#ifdef __SSSE3__
+            const __m128i bias = _mm_set1_epi16((short)0x8000);
+            __m128i kernel[kernel_size];
+            for (int k = 0; k < kernel_size; k++)
+                kernel[k] = _mm_xor_si128(_mm_load_si128(reinterpret_cast<const __m128i*>(lanes[k])), bias);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_xor_si128(median_network<SCALE>::median(kernel), bias));
+#else
+            uint16x8_t kernel[kernel_size];
+            for (int k = 0; k < kernel_size; k++)
+                kernel[k] = vld1q_u16(lanes[k]);
+            vst1q_u16(out + i, median_network<SCALE>::median(kernel));
+#endif
+        }
+#endif
+
+        for (; i < width_out; i++)
+        {
+            uint16_t kernel[kernel_size];
+            for (int n = 0; n < SCALE; n++)
+                for (int m = 0; m < SCALE; m++)
+                    kernel[n * SCALE + m] = block_start[width_in * n + i * SCALE + m];
+            out[i] = median_network<SCALE>::median(kernel);
+        }
+    }
+
+    // Larger patches use a generic partial sort
+    static void decimate_row_generic(const uint16_t * block_start, size_t width_in, uint16_t * out, size_t width_out, size_t scale)
+    {
+        auto kernel_size = scale * scale;
+        std::vector<uint16_t> working_kernel(kernel_size);
+        auto wk_begin = working_kernel.data();
+
+        for (size_t i = 0, chunk_offset = 0; i < width_out; i++)
+        {
+            auto wk_itr = wk_begin;
+            // extract data the kernel to process
+            for (size_t n = 0; n < scale; ++n)
+            {
+                auto p = block_start + width_in * n + chunk_offset;
+                for (size_t m = 0; m < scale; ++m)
+                    *wk_itr++ = *(p + m);
+            }
+
+            std::nth_element(wk_begin, wk_begin + (kernel_size / 2), wk_begin + kernel_size);
+            *out++ = working_kernel[kernel_size / 2];
+
+            chunk_offset += scale;
+        }
+    }
+
     void decimation_filter::decimate_depth(const uint16_t * frame_data_in, uint16_t * frame_data_out,
         size_t width_in, size_t height_in, size_t scale)
     {
@@ -132,48 +227,25 @@ namespace librealsense
 
         auto width_out = width_in / scale;
         auto height_out = height_in / scale;
-        auto kernel_size = scale * scale;
 
-        // Use median filtering
-        std::vector<uint16_t> working_kernel(kernel_size);
-        auto wk_begin = working_kernel.data();
-        auto wk_itr = wk_begin;
-        std::vector<uint16_t*> pixel_raws(scale);
-        uint16_t* block_start = const_cast<uint16_t*>(frame_data_in);
+        // Use median filtering. Output rows are independent, so they are split into one band per thread
+        auto&& pool = environment::get_instance().get_worker_pool();
+        const int bands = static_cast<int>(std::min<size_t>(height_out, pool.size() + 1));
 
-        //#pragma omp parallel for schedule(dynamic) //Using OpenMP to try to parallelise the loop
-        //TODO SSE Optimizations
-        for (int j = 0; j < height_out; j++)
+        pool.run(bands, [&](int band)
         {
-            uint16_t *p{};
-            // Mark the beginning of each of the N lines that the filter will run upon
-            for (size_t i = 0; i < pixel_raws.size(); i++)
-                pixel_raws[i] = block_start + (width_in*i);
-
-            for (size_t i = 0, chunk_offset = 0; i < width_out; i++)
+            for (size_t j = height_out * band / bands; j < height_out * (band + 1) / bands; j++)
             {
-                wk_itr = wk_begin;
-                // extract data the kernel to process
-                for (size_t n = 0; n < scale; ++n)
+                auto block_start = frame_data_in + width_in * scale * j;
+                auto out = frame_data_out + width_out * j;
+                switch (scale)
                 {
-                    p = pixel_raws[n] + chunk_offset;
-                    for (size_t m = 0; m < scale; ++m)
-                    {
-                        *wk_itr++ = *(p + m);
-                        //*wk_itr++ = *(pixel_raws[n] + chunk_offset + m);
-                        //working_kernel[n*scale + m] = *(pixel_raws[n] + chunk_offset + m);
-                    }
+                case 1: std::copy(block_start, block_start + width_out, out); break;
+                case 2: decimate_row<2>(block_start, width_in, out, width_out); break;
+                case 4: decimate_row<4>(block_start, width_in, out, width_out); break;
+                default: decimate_row_generic(block_start, width_in, out, width_out, scale);
                 }
-
-                std::nth_element(wk_begin, wk_begin + (kernel_size / 2), wk_begin + kernel_size);
-                //std::sort(working_kernel.begin(),working_kernel.end());
-                *frame_data_out++ = working_kernel[kernel_size / 2];
-
-                chunk_offset += scale;
             }
-
-            // Skip N lines to the beginnig of the next processing segment
-            block_start += width_in*scale;
-        }
+        });
     }
 }
@@ -5,15 +5,19 @@
 
 #include "../include/librealsense2/hpp/rs_frame.hpp"
 #include "../include/librealsense2/hpp/rs_processing.hpp"
+#include "filter-chain.h"
 
 namespace librealsense
 {
 
-    class decimation_filter : public processing_block
+    class decimation_filter : public processing_block, public depth_filter_stage
     {
     public:
         decimation_filter();
 
+        rs2::stream_profile configure_stage(const rs2::stream_profile& input) override;
+        void run_stage(const uint16_t* input, uint16_t* output) override;
+
     protected:
         rs2::frame prepare_target_frame(const rs2::frame& f, const rs2::frame_source& source);
 
@@ -21,11 +25,12 @@ namespace librealsense
             size_t width_in, size_t height_in, size_t scale);
 
     private:
-        void    update_output_profile(const rs2::frame& f);
+        void    update_output_profile(const rs2::stream_profile& profile);
 
         uint8_t                 _decimation_factor;
         uint8_t                 _patch_size;
         uint8_t                 _kernel_size;
+        size_t                  _width, _height;
         rs2::stream_profile     _source_stream_profile;
         rs2::stream_profile     _target_stream_profile;
         bool                    _recalc_profile;
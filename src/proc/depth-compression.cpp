@@ -0,0 +1,139 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#include "../include/librealsense2/hpp/rs_sensor.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+
+#include "option.h"
+#include "context.h"
+#include "environment.h"
+#include "proc/depth-compression.h"
+#include "media/ros/depth_codec.h"
+
+namespace librealsense
+{
+    // Converts the frame, or each frame of a frameset. The frames the conversion returns as they are pass through
+    template<class T>
+    static rs2::frame convert_frames(const rs2::frame& f, const rs2::frame_source& source, T convert)
+    {
+        if (auto fs = f.as<rs2::frameset>())
+        {
+            std::vector<rs2::frame> frames;
+            bool converted = false;
+            for (size_t i = 0; i < fs.size(); i++)
+            {
+                auto in = fs[i];
+                auto out = convert(in);
+                converted |= out.get() != in.get();
+                frames.push_back(out);
+            }
+            return converted ? source.allocate_composite_frame(frames) : f;
+        }
+        return convert(f);
+    }
+
+    rs2::stream_profile format_converting_block::get_target_profile(const rs2::stream_profile& source, rs2_format format)
+    {
+        std::lock_guard<std::mutex> lock(_profile_mutex);
+        if (source.get() != _source_profile.get())
+        {
+            _source_profile = source;
+            _target_profile = source.clone(source.stream_type(), source.stream_index(), format);
+            environment::get_instance().get_extrinsics_graph().register_same_extrinsics(*(stream_interface*)(_source_profile.get()->profile), *(stream_interface*)(_target_profile.get()->profile));
+            auto src_vspi = dynamic_cast<video_stream_profile_interface*>(_source_profile.get()->profile);
+            auto tgt_vspi = dynamic_cast<video_stream_profile_interface*>(_target_profile.get()->profile);
+            if (src_vspi && tgt_vspi)
+            {
+                tgt_vspi->set_dims(src_vspi->get_width(), src_vspi->get_height());
+                try
+                {
+                    auto intrinsics = src_vspi->get_intrinsics();
+                    tgt_vspi->set_intrinsics([intrinsics]() { return intrinsics; });
+                }
+                catch (...) {}
+            }
+        }
+        return _target_profile;
+    }
+
+    depth_encoder::depth_encoder() :
+        _tolerance(0)
+    {
+        auto tolerance = std::make_shared<ptr_option<uint16_t>>(0, 255, 1, 0, &_tolerance,
+            "Largest difference of a decoded pixel from its depth, in depth units. Zero compresses losslessly");
+        register_option(RS2_OPTION_COMPRESSION_TOLERANCE, tolerance);
+        unregister_option(RS2_OPTION_FRAMES_QUEUE_SIZE);
+
+        auto on_frame = [this](rs2::frame f, const rs2::frame_source& source)
+        {
+            uint16_t tolerance = _tolerance;
+            auto out = convert_frames(f, source, [&](const rs2::frame& in) -> rs2::frame
+            {
+                auto vf = in.as<rs2::video_frame>();
+                if (!vf || in.get_profile().format() != RS2_FORMAT_Z16)
+                    return in;
+
+                // Reused by the following frames encoded on the same thread
+                static thread_local std::vector<uint8_t> encoded;
+                auto width = static_cast<uint32_t>(vf.get_width());
+                auto height = static_cast<uint32_t>(vf.get_height());
+                encode_depth(static_cast<const uint16_t*>(vf.get_data()), width, height, vf.get_stride_in_bytes(), encoded, tolerance);
+
+                compressed_depth_header header{ COMPRESSED_DEPTH_MAGIC, COMPRESSED_DEPTH_VERSION, tolerance, width, height,
+                                                static_cast<uint32_t>(encoded.size()) };
+                auto size = sizeof(header) + encoded.size();
+                auto stride = static_cast<int>((size + height - 1) / height);
+                auto target = source.allocate_video_frame(get_target_profile(in.get_profile(), RS2_FORMAT_Z16_COMPRESSED), in,
+                                                          1, width, height, stride, RS2_EXTENSION_VIDEO_FRAME);
+                auto data = static_cast<uint8_t*>(const_cast<void*>(target.get_data()));
+                memcpy(data, &header, sizeof(header));
+                memcpy(data + sizeof(header), encoded.data(), encoded.size());
+                memset(data + size, 0, static_cast<size_t>(stride) * height - size);
+                return target;
+            });
+            source.frame_ready(out);
+        };
+
+        auto callback = new rs2::frame_processor_callback<decltype(on_frame)>(on_frame);
+        processing_block::set_processing_callback(std::shared_ptr<rs2_frame_processor_callback>(callback));
+
+        enable_pipelining();
+    }
+
+    depth_decoder::depth_decoder()
+    {
+        unregister_option(RS2_OPTION_FRAMES_QUEUE_SIZE);
+
+        auto on_frame = [this](rs2::frame f, const rs2::frame_source& source)
+        {
+            auto out = convert_frames(f, source, [&](const rs2::frame& in) -> rs2::frame
+            {
+                if (in.get_profile().format() != RS2_FORMAT_Z16_COMPRESSED)
+                    return in;
+
+                compressed_depth_header header;
+                auto data = static_cast<const uint8_t*>(in.get_data());
+                auto size = static_cast<size_t>(in.get_data_size());
+                if (size < sizeof(header))
+                    throw invalid_value_exception("Compressed depth frame is truncated");
+                memcpy(&header, data, sizeof(header));
+                if (header.magic != COMPRESSED_DEPTH_MAGIC || header.version != COMPRESSED_DEPTH_VERSION)
+                    throw invalid_value_exception("Unsupported compressed depth frame");
+                if (header.size > size - sizeof(header))
+                    throw invalid_value_exception("Compressed depth frame is truncated");
+
+                auto target = source.allocate_video_frame(get_target_profile(in.get_profile(), RS2_FORMAT_Z16), in,
+                                                          2, header.width, header.height, header.width * 2, RS2_EXTENSION_DEPTH_FRAME);
+                decode_depth(data + sizeof(header), header.size, header.width, header.height, header.width * 2,
+                             static_cast<uint16_t*>(const_cast<void*>(target.get_data())), header.tolerance);
+                return target;
+            });
+            source.frame_ready(out);
+        };
+
+        auto callback = new rs2::frame_processor_callback<decltype(on_frame)>(on_frame);
+        processing_block::set_processing_callback(std::shared_ptr<rs2_frame_processor_callback>(callback));
+
+        enable_pipelining();
+    }
+}
@@ -0,0 +1,59 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "../include/librealsense2/hpp/rs_frame.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+#include "synthetic-stream.h"
+
+namespace librealsense
+{
+    const uint32_t COMPRESSED_DEPTH_MAGIC = 0x315a5352; // "RSZ1"
+    const uint16_t COMPRESSED_DEPTH_VERSION = 1;
+
+#pragma pack(push, 1)
+    // Start of the data of a RS2_FORMAT_Z16_COMPRESSED frame, followed by the encoded pixels
+    // The frame keeps the width and height of the depth image, its stride is the one that fits the encoded data
+    struct compressed_depth_header
+    {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t tolerance;     // Largest error of a decoded pixel, in depth units. Zero when lossless
+        uint32_t width;
+        uint32_t height;
+        uint32_t size;          // Bytes of encoded pixels
+    };
+#pragma pack(pop)
+
+    // Keeps the last profile derived from a source profile, for blocks that convert the format of a stream
+    class format_converting_block : public processing_block
+    {
+    protected:
+        rs2::stream_profile get_target_profile(const rs2::stream_profile& source, rs2_format format);
+
+    private:
+        std::mutex _profile_mutex;
+        rs2::stream_profile _source_profile;
+        rs2::stream_profile _target_profile;
+    };
+
+    // Replaces Z16 depth frames by RS2_FORMAT_Z16_COMPRESSED frames, lossless or within a tolerance
+    class depth_encoder : public format_converting_block
+    {
+    public:
+        depth_encoder();
+        ~depth_encoder() { flush_pipeline(); }
+
+    private:
+        uint16_t _tolerance;
+    };
+
+    // Replaces RS2_FORMAT_Z16_COMPRESSED frames by the Z16 depth frames they encode
+    class depth_decoder : public format_converting_block
+    {
+    public:
+        depth_decoder();
+        ~depth_decoder() { flush_pipeline(); }
+    };
+}
@@ -0,0 +1,225 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#include "../include/librealsense2/hpp/rs_sensor.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+
+#include "option.h"
+#include "context.h"
+#include "environment.h"
+#include "cpu-features.h"
+#include "proc/synthetic-stream.h"
+#include "proc/depth-pyramid.h"
+#include "proc/median-network.h"
+
+#include <algorithm>
+
+namespace librealsense
+{
+    const uint8_t pyramid_min_levels = 1;
+    const uint8_t pyramid_max_levels = 4;
+    const uint8_t pyramid_default_levels = 3;
+
+    enum pyramid_reduction : uint8_t
+    {
+        PYRAMID_REDUCTION_MEDIAN,
+        PYRAMID_REDUCTION_NEAREST
+    };
+
+    // One row of a level from the two rows of the level above it. The nearest valid depth is the minimum of the
+    // values less one, which wraps the zeros of missing depth around to the largest value
+    template<bool NEAREST>
+    static void reduce_row(const uint16_t* a, const uint16_t* b, uint16_t* out, int width_out)
+    {
+        int i = 0;
+
+#if defined(__SSSE3__) || defined(MEDIAN_NETWORK_USE_NEON)
+        // Eight output pixels per step, the even and odd input pixels of both rows split into four vectors
+#ifdef __SSSE3__
+        static const bool vectorize = cpu_supports(CPU_FEATURE_SSSE3);
+#else
+        static const bool vectorize = cpu_supports(CPU_FEATURE_NEON);
+#endif
+        for (; vectorize && i + 8 <= width_out; i += 8)
+        {
+#ifdef __SSSE3__
+            // The even pixels go to the low half of a register and the odd ones to its high half
+            const __m128i split = _mm_setr_epi8(0, 1, 4, 5, 8, 9, 12, 13, 2, 3, 6, 7, 10, 11, 14, 15);
+            const __m128i bias = _mm_set1_epi16((short)0x8000);
+            const __m128i offset = _mm_set1_epi16(NEAREST ? 1 : 0);
+            auto a0 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + 2 * i)), split);
+            auto a1 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + 2 * i + 8)), split);
+            auto b0 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + 2 * i)), split);
+            auto b1 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + 2 * i + 8)), split);
+            __m128i kernel[4] = { _mm_unpacklo_epi64(a0, a1), _mm_unpackhi_epi64(a0, a1),
+                                  _mm_unpacklo_epi64(b0, b1), _mm_unpackhi_epi64(b0, b1) };
+            for (auto&& k : kernel) k = _mm_xor_si128(_mm_sub_epi16(k, offset), bias);
+            auto result = NEAREST ? _mm_min_epi16(_mm_min_epi16(kernel[0], kernel[1]), _mm_min_epi16(kernel[2], kernel[3]))
+                                  : median_network<2>::median(kernel);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_add_epi16(_mm_xor_si128(result, bias), offset));
+#else
+            const uint16x8_t offset = vdupq_n_u16(NEAREST ? 1 : 0);
+            auto ra = vld2q_u16(a + 2 * i);
+            auto rb = vld2q_u16(b + 2 * i);
+            uint16x8_t kernel[4] = { ra.val[0], ra.val[1], rb.val[0], rb.val[1] };
+            for (auto&& k : kernel) k = vsubq_u16(k, offset);
+            auto result = NEAREST ? vminq_u16(vminq_u16(kernel[0], kernel[1]), vminq_u16(kernel[2], kernel[3]))
+                                  : median_network<2>::median(kernel);
+            vst1q_u16(out + i, vaddq_u16(result, offset));
+#endif
+        }
+#endif
+
+        for (; i < width_out; i++)
+        {
+            uint16_t kernel[4] = { a[2 * i], a[2 * i + 1], b[2 * i], b[2 * i + 1] };
+            if (NEAREST)
+            {
+                for (auto&& k : kernel) k = uint16_t(k - 1);
+                out[i] = uint16_t(std::min(std::min(kernel[0], kernel[1]), std::min(kernel[2], kernel[3])) + 1);
+            }
+            else
+            {
+                out[i] = median_network<2>::median(kernel);
+            }
+        }
+    }
+
+    depth_pyramid::depth_pyramid()
+        : _levels(pyramid_default_levels),
+          _reduction(PYRAMID_REDUCTION_MEDIAN),
+          _width(0), _height(0),
+          _recalc_profile(false)
+    {
+        auto levels = std::make_shared<ptr_option<uint8_t>>(pyramid_min_levels, pyramid_max_levels, 1,
+            pyramid_default_levels, &_levels, "Levels below the input, each of half the resolution of the previous one");
+        levels->on_set([this](float) { _recalc_profile = true; });
+        register_option(RS2_OPTION_FILTER_MAGNITUDE, levels);
+
+        auto reduction = std::make_shared<ptr_option<uint8_t>>(PYRAMID_REDUCTION_MEDIAN, PYRAMID_REDUCTION_NEAREST, 1,
+            PYRAMID_REDUCTION_MEDIAN, &_reduction, "Reduction of every 2x2 pixels");
+        reduction->set_description(PYRAMID_REDUCTION_MEDIAN, "Median");
+        reduction->set_description(PYRAMID_REDUCTION_NEAREST, "Nearest valid depth");
+        register_option(RS2_OPTION_PYRAMID_REDUCTION, reduction);
+
+        unregister_option(RS2_OPTION_FRAMES_QUEUE_SIZE);
+
+        auto on_frame = [this](rs2::frame f, const rs2::frame_source& source)
+        {
+            bool composite = f.is<rs2::frameset>();
+            rs2::frame depth = composite ? f.as<rs2::frameset>().first_or_default(RS2_STREAM_DEPTH) : f;
+            if (!depth || depth.get_profile().format() != RS2_FORMAT_Z16)
+            {
+                source.frame_ready(f);
+                return;
+            }
+
+            update_profiles(depth.get_profile());
+
+            std::vector<rs2::frame> frames;
+            std::vector<uint16_t*> levels;
+            for (int k = 1; k <= static_cast<int>(_level_profiles.size()); k++)
+            {
+                auto width = _width >> k, height = _height >> k;
+                auto level = source.allocate_video_frame(_level_profiles[k - 1], depth, sizeof(uint16_t),
+                    width, height, width * static_cast<int>(sizeof(uint16_t)), RS2_EXTENSION_DEPTH_FRAME);
+                if (!level) return;
+                levels.push_back(static_cast<uint16_t*>(const_cast<void*>(level.get_data())));
+                frames.push_back(level);
+            }
+
+            auto vf = depth.as<rs2::video_frame>();
+            build(static_cast<const uint16_t*>(depth.get_data()), vf.get_stride_in_bytes() / static_cast<int>(sizeof(uint16_t)), levels);
+
+            if (composite)
+            {
+                for (auto&& member : f.as<rs2::frameset>())
+                    if (member.get() != depth.get()) frames.push_back(member);
+            }
+            source.frame_ready(source.allocate_composite_frame(std::move(frames)));
+        };
+
+        auto callback = new rs2::frame_processor_callback<decltype(on_frame)>(on_frame);
+        processing_block::set_processing_callback(std::shared_ptr<rs2_frame_processor_callback>(callback));
+    }
+
+    void depth_pyramid::update_profiles(const rs2::stream_profile& input)
+    {
+        if (input.get() != _source_stream_profile.get())
+        {
+            _source_stream_profile = input;
+            _recalc_profile = true;
+        }
+        if (!_recalc_profile) return;
+
+        auto vp = _source_stream_profile.as<rs2::video_stream_profile>();
+        if ((vp.width() >> _levels) == 0 || (vp.height() >> _levels) == 0)
+            throw invalid_value_exception(to_string() << "Frame size [" << vp.width() << "," << vp.height()
+                << "] is too small for " << int(_levels) << " pyramid levels");
+        _width = vp.width();
+        _height = vp.height();
+
+        auto src_vspi = dynamic_cast<video_stream_profile_interface*>(_source_stream_profile.get()->profile);
+        auto src_intrin = src_vspi->get_intrinsics();
+        _level_profiles.clear();
+        for (int k = 1; k <= _levels; k++)
+        {
+            auto profile = _source_stream_profile.clone(RS2_STREAM_DEPTH, k, _source_stream_profile.format());
+            environment::get_instance().get_extrinsics_graph().register_same_extrinsics(
+                *(stream_interface*)(_source_stream_profile.get()->profile), *(stream_interface*)(profile.get()->profile));
+
+            auto tgt_vspi = dynamic_cast<video_stream_profile_interface*>(profile.get()->profile);
+            auto scale = float(1 << k);
+            rs2_intrinsics tgt_intrin = src_intrin;
+            tgt_intrin.width = _width >> k;
+            tgt_intrin.height = _height >> k;
+            tgt_intrin.fx = src_intrin.fx / scale;
+            tgt_intrin.fy = src_intrin.fy / scale;
+            tgt_intrin.ppx = src_intrin.ppx / scale;
+            tgt_intrin.ppy = src_intrin.ppy / scale;
+            tgt_vspi->set_intrinsics([tgt_intrin]() { return tgt_intrin; });
+            tgt_vspi->set_dims(tgt_intrin.width, tgt_intrin.height);
+            _level_profiles.push_back(profile);
+        }
+        _recalc_profile = false;
+    }
+
+    void depth_pyramid::build(const uint16_t* depth, int stride, const std::vector<uint16_t*>& levels)
+    {
+        auto count = static_cast<int>(levels.size());
+        auto nearest = _reduction == PYRAMID_REDUCTION_NEAREST;
+
+        // Row r of level k, level 0 being the input
+        auto row = [&](int k, int r) -> uint16_t*
+        {
+            return k == 0 ? const_cast<uint16_t*>(depth) + size_t(r) * stride : levels[k - 1] + size_t(r) * (_width >> k);
+        };
+        auto reduce = [&](int k, int r)
+        {
+            if (nearest)
+                reduce_row<true>(row(k - 1, 2 * r), row(k - 1, 2 * r + 1), row(k, r), _width >> k);
+            else
+                reduce_row<false>(row(k - 1, 2 * r), row(k - 1, 2 * r + 1), row(k, r), _width >> k);
+        };
+
+        // Each band covers whole rows of the smallest level, which depend on its own rows of the other levels only
+        auto top_rows = _height >> count;
+        auto&& pool = environment::get_instance().get_worker_pool();
+        const int bands = static_cast<int>(std::min<size_t>(top_rows, pool.size() + 1));
+        pool.run(bands, [&](int band)
+        {
+            for (int j = top_rows * band / bands; j < top_rows * (band + 1) / bands; j++)
+            {
+                for (int k = 1; k <= count; k++)
+                {
+                    auto span = 1 << (count - k);
+                    for (int r = j * span; r < (j + 1) * span; r++) reduce(k, r);
+                }
+            }
+        });
+
+        // Rows below the last row of the smallest level, when the height is not a multiple of its scale
+        for (int k = 1; k <= count; k++)
+            for (int r = top_rows << (count - k); r < (_height >> k); r++) reduce(k, r);
+    }
+}
@@ -0,0 +1,31 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "../include/librealsense2/hpp/rs_frame.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+#include "synthetic-stream.h"
+
+namespace librealsense
+{
+    // Builds the levels of half, quarter, ... resolution of Z16 depth frames in a single pass over the input. The input
+    // is split into bands of the rows a row of the smallest level covers, and every band reduces its rows level after
+    // level while they are in the cache. Level k is a depth frame of stream index k, with intrinsics scaled by 1 / 2^k
+    class depth_pyramid : public processing_block
+    {
+    public:
+        depth_pyramid();
+
+    private:
+        void update_profiles(const rs2::stream_profile& input);
+        void build(const uint16_t* depth, int stride, const std::vector<uint16_t*>& levels);
+
+        uint8_t                             _levels;
+        uint8_t                             _reduction;
+        int                                 _width, _height;
+        rs2::stream_profile                 _source_stream_profile;
+        std::vector<rs2::stream_profile>    _level_profiles;
+        bool                                _recalc_profile;
+    };
+}
@@ -0,0 +1,297 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#include "../include/librealsense2/hpp/rs_sensor.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+
+#include "option.h"
+#include "environment.h"
+#include "archive.h"
+#include "cpu-features.h"
+#include "proc/synthetic-stream.h"
+#include "proc/depth-statistics.h"
+
+#include <algorithm>
+#include <cmath>
+
+#ifdef __SSSE3__
+#include <emmintrin.h>
+#endif
+
+namespace librealsense
+{
+    const float statistics_distance_max = 65.f;
+    const float statistics_distance_step = 0.01f;
+    const float histogram_max_default = 10.f;
+    const float near_distance_default = 0.5f;
+
+    const int histogram_bins_max = 1024;
+    const int histogram_bins_default = 32;
+    const int roi_margin_max = 4096;
+
+    // Partial statistics of a run of depth pixels
+    struct run_statistics
+    {
+        uint64_t valid = 0, sum = 0, near = 0;
+        uint16_t min = 0xffff, max = 0;
+
+        void add(const run_statistics& other)
+        {
+            valid += other.valid;
+            sum += other.sum;
+            near += other.near;
+            min = std::min(min, other.min);
+            max = std::max(max, other.max);
+        }
+    };
+
+    // Accumulates the pixels with depth, their sum and extremes, and those below near, of a run of depth pixels
+    typedef void(*run_statistics_function)(const uint16_t* depth, int count, uint16_t near, run_statistics& stats);
+
+    static void run_statistics_scalar(const uint16_t* depth, int count, uint16_t near, run_statistics& stats)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            auto v = depth[i];
+            if (!v) continue;
+            stats.valid++;
+            stats.sum += v;
+            if (v < near) stats.near++;
+            if (v < stats.min) stats.min = v;
+            if (v > stats.max) stats.max = v;
+        }
+    }
+
+#ifdef __SSSE3__
+    // SSE2 compares signed 16 bit words only, so the unsigned depth values are compared with their sign bit flipped
+    static void run_statistics_sse(const uint16_t* depth, int count, uint16_t near, run_statistics& stats)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i sign = _mm_set1_epi16(static_cast<short>(0x8000));
+        const __m128i near_signed = _mm_set1_epi16(static_cast<short>(near ^ 0x8000));
+        __m128i holes = zero, nears = zero, sum = zero;
+        __m128i min = _mm_set1_epi16(0x7fff), max = _mm_set1_epi16(static_cast<short>(0x8000));
+        int i = 0;
+        // The counts of the 16 bit lanes can not overflow within a row of 65535 pixels
+        for (; i + 8 <= count && i < 0x7fff * 8; i += 8)
+        {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(depth + i));
+            const __m128i hole = _mm_cmpeq_epi16(v, zero);
+            const __m128i flipped = _mm_xor_si128(v, sign);
+            holes = _mm_sub_epi16(holes, hole);
+            // Holes become the largest value, which the minimum ignores
+            min = _mm_min_epi16(min, _mm_xor_si128(_mm_or_si128(v, hole), sign));
+            max = _mm_max_epi16(max, flipped);
+            nears = _mm_sub_epi16(nears, _mm_andnot_si128(hole, _mm_cmpgt_epi16(near_signed, flipped)));
+            const __m128i pairs = _mm_add_epi32(_mm_unpacklo_epi16(v, zero), _mm_unpackhi_epi16(v, zero));
+            sum = _mm_add_epi64(sum, _mm_add_epi64(_mm_unpacklo_epi32(pairs, zero), _mm_unpackhi_epi32(pairs, zero)));
+        }
+
+        alignas(16) uint16_t hole_lanes[8], near_lanes[8], min_lanes[8], max_lanes[8];
+        alignas(16) uint64_t sum_lanes[2];
+        _mm_store_si128(reinterpret_cast<__m128i *>(hole_lanes), holes);
+        _mm_store_si128(reinterpret_cast<__m128i *>(near_lanes), nears);
+        _mm_store_si128(reinterpret_cast<__m128i *>(min_lanes), _mm_xor_si128(min, sign));
+        _mm_store_si128(reinterpret_cast<__m128i *>(max_lanes), _mm_xor_si128(max, sign));
+        _mm_store_si128(reinterpret_cast<__m128i *>(sum_lanes), sum);
+
+        uint64_t hole_count = 0;
+        for (int lane = 0; lane < 8; ++lane)
+        {
+            hole_count += hole_lanes[lane];
+            stats.near += near_lanes[lane];
+            stats.min = std::min(stats.min, min_lanes[lane]);
+            stats.max = std::max(stats.max, max_lanes[lane]);
+        }
+        stats.valid += i - hole_count;
+        stats.sum += sum_lanes[0] + sum_lanes[1];
+        run_statistics_scalar(depth + i, count - i, near, stats);
+    }
+#endif
+
+    static run_statistics_function select_run_statistics()
+    {
+#ifdef __SSSE3__
+        if (cpu_supports(CPU_FEATURE_SSSE3)) return &run_statistics_sse;
+#endif
+        return &run_statistics_scalar;
+    }
+
+    const depth_statistics* get_depth_statistics(const frame_interface* depth)
+    {
+        auto f = dynamic_cast<const frame*>(depth);
+        return f ? f->statistics.get() : nullptr;
+    }
+
+    depth_statistics_block::depth_statistics_block()
+        : _bins(histogram_bins_default), _histogram_min(0.f), _histogram_max(histogram_max_default),
+          _near_distance(near_distance_default), _crop_left(0), _crop_top(0), _crop_right(0), _crop_bottom(0),
+          _lut_bins(0), _lut_min(0.f), _lut_max(0.f), _lut_units(0.f)
+    {
+        register_option(RS2_OPTION_HISTOGRAM_BINS, std::make_shared<ptr_option<int>>(0, histogram_bins_max, 1,
+            histogram_bins_default, &_bins, "Bins of the histogram of distances, zero for no histogram"));
+        register_option(RS2_OPTION_MIN_DISTANCE, std::make_shared<ptr_option<float>>(0.f, statistics_distance_max,
+            statistics_distance_step, 0.f, &_histogram_min, "Distance the first bin of the histogram starts at, in meters"));
+        register_option(RS2_OPTION_MAX_DISTANCE, std::make_shared<ptr_option<float>>(0.f, statistics_distance_max,
+            statistics_distance_step, histogram_max_default, &_histogram_max, "Distance the last bin of the histogram ends at, in meters"));
+        register_option(RS2_OPTION_NEAR_DISTANCE, std::make_shared<ptr_option<float>>(0.f, statistics_distance_max,
+            statistics_distance_step, near_distance_default, &_near_distance, "Distance below which the pixels of the region of interest are near, in meters"));
+
+        auto add_margin = [this](rs2_option id, int* margin, const char* description)
+        {
+            register_option(id, std::make_shared<ptr_option<int>>(0, roi_margin_max, 1, 0, margin, description));
+        };
+        add_margin(RS2_OPTION_CROP_LEFT, &_crop_left, "Columns left of the region of interest");
+        add_margin(RS2_OPTION_CROP_TOP, &_crop_top, "Rows above the region of interest");
+        add_margin(RS2_OPTION_CROP_RIGHT, &_crop_right, "Columns right of the region of interest");
+        add_margin(RS2_OPTION_CROP_BOTTOM, &_crop_bottom, "Rows below the region of interest");
+
+        unregister_option(RS2_OPTION_FRAMES_QUEUE_SIZE);
+        set_in_place_processing(true);
+
+        auto on_frame = [this](rs2::frame f, const rs2::frame_source& source)
+        {
+            bool composite = f.is<rs2::frameset>();
+            rs2::frame depth = composite ? f.as<rs2::frameset>().first_or_default(RS2_STREAM_DEPTH) : f;
+            auto df = depth ? dynamic_cast<depth_frame*>((frame_interface*)depth.get()) : nullptr;
+            if (!df || depth.get_profile().format() != RS2_FORMAT_Z16)
+            {
+                source.frame_ready(f);
+                return;
+            }
+
+            auto vf = depth.as<rs2::video_frame>();
+            auto statistics = compute(static_cast<const uint16_t*>(vf.get_data()), vf.get_width(), vf.get_height(),
+                                      vf.get_stride_in_bytes(), df->get_units());
+            auto changes = df->changes;
+
+            // The statistics go on a frame of the block, the input itself when no one else holds it
+            rs2::frame tgt = source.allocate_video_frame(depth.get_profile(), depth, vf.get_bytes_per_pixel(),
+                vf.get_width(), vf.get_height(), vf.get_stride_in_bytes(), RS2_EXTENSION_DEPTH_FRAME);
+            if (tgt.get() != depth.get())
+                memcpy(const_cast<void*>(tgt.get_data()), vf.get_data(), vf.get_stride_in_bytes() * vf.get_height());
+            // The pixels are the same, so the change mask of the input still holds
+            auto target = (frame*)(frame_interface*)tgt.get();
+            target->changes = std::move(changes);
+            target->statistics = std::move(statistics);
+
+            if (!composite)
+            {
+                source.frame_ready(tgt);
+                return;
+            }
+
+            std::vector<rs2::frame> frames;
+            for (auto&& member : f.as<rs2::frameset>())
+                frames.push_back(member.get() == depth.get() ? tgt : member);
+            source.frame_ready(source.allocate_composite_frame(std::move(frames)));
+        };
+
+        auto callback = new rs2::frame_processor_callback<decltype(on_frame)>(on_frame);
+        processing_block::set_processing_callback(std::shared_ptr<rs2_frame_processor_callback>(callback));
+    }
+
+    void depth_statistics_block::update_bins(float units)
+    {
+        if (_bins == _lut_bins && _histogram_min == _lut_min && _histogram_max == _lut_max && units == _lut_units)
+            return;
+
+        _lut_bins = _bins;
+        _lut_min = _histogram_min;
+        _lut_max = _histogram_max;
+        _lut_units = units;
+        if (!_lut_bins || !(_lut_max > _lut_min))
+        {
+            _bin_of.clear();
+            return;
+        }
+
+        _bin_of.assign(0x10000, 0);
+        auto bin_width = (_lut_max - _lut_min) / _lut_bins;
+        for (int v = 1; v < 0x10000; ++v)
+        {
+            auto distance = v * units;
+            if (distance >= _lut_min && distance < _lut_max)
+                _bin_of[v] = static_cast<uint16_t>(std::min(_lut_bins - 1, static_cast<int>((distance - _lut_min) / bin_width)) + 1);
+        }
+    }
+
+    std::shared_ptr<depth_statistics> depth_statistics_block::compute(const uint16_t* depth, int width, int height, int stride, float units)
+    {
+        static const auto run_statistics_of = select_run_statistics();
+
+        update_bins(units);
+        const int bins = _bin_of.empty() ? 0 : _lut_bins;
+        const uint16_t* bin_of = _bin_of.data();
+
+        // Pixels below the near distance are those of values below its ceiling in depth units
+        const float near_units = units > 0 ? std::ceil(_near_distance / units) : 0.f;
+        const uint16_t near = static_cast<uint16_t>(std::min(near_units, 65535.f));
+
+        const int left = std::min(_crop_left, width), right = std::min(_crop_right, width - left);
+        const int top = std::min(_crop_top, height), bottom = std::min(_crop_bottom, height - top);
+        const int roi_width = width - left - right;
+        const int row_pixels = stride / static_cast<int>(sizeof(uint16_t));
+
+        struct band_statistics
+        {
+            run_statistics all, roi;
+            std::vector<uint32_t> histogram;
+        };
+
+        auto&& pool = environment::get_instance().get_worker_pool();
+        const int min_band_pixels = 65536;
+        const int bands = std::max(1, std::min(static_cast<int>(pool.size()) + 1, width * height / min_band_pixels));
+        std::vector<band_statistics> results(bands);
+
+        pool.run(bands, [&](int band)
+        {
+            auto&& result = results[band];
+            result.histogram.assign(bins, 0);
+            for (int y = height * band / bands; y < height * (band + 1) / bands; ++y)
+            {
+                auto row = depth + y * row_pixels;
+                if (y < top || y >= height - bottom)
+                    run_statistics_of(row, width, 0, result.all);
+                else
+                {
+                    run_statistics_of(row, left, 0, result.all);
+                    run_statistics roi;
+                    run_statistics_of(row + left, roi_width, near, roi);
+                    result.roi.add(roi);
+                    run_statistics_of(row + left + roi_width, right, 0, result.all);
+                }
+
+                // Counted while the row is still in the cache
+                for (int x = 0; bins && x < width; ++x)
+                    if (auto b = bin_of[row[x]]) result.histogram[b - 1]++;
+            }
+        });
+
+        auto res = std::make_shared<depth_statistics>();
+        run_statistics all, roi;
+        res->histogram.assign(bins, 0);
+        for (auto&& result : results)
+        {
+            all.add(result.all);
+            roi.add(result.roi);
+            for (int b = 0; b < bins; ++b) res->histogram[b] += result.histogram[b];
+        }
+        all.add(roi);
+
+        auto&& summary = res->summary;
+        summary.total_pixels = width * height;
+        summary.valid_pixels = static_cast<int>(all.valid);
+        summary.fill_rate = summary.total_pixels ? float(all.valid) / summary.total_pixels : 0.f;
+        summary.min_distance = all.valid ? all.min * units : 0.f;
+        summary.max_distance = all.valid ? all.max * units : 0.f;
+        summary.mean_distance = all.valid ? float(double(all.sum) / all.valid * units) : 0.f;
+        summary.roi_pixels = roi_width * (height - top - bottom);
+        summary.roi_valid_pixels = static_cast<int>(roi.valid);
+        summary.roi_near_pixels = static_cast<int>(roi.near);
+        summary.histogram_bins = bins;
+        summary.histogram_min = bins ? _lut_min : 0.f;
+        summary.histogram_max = bins ? _lut_max : 0.f;
+        return res;
+    }
+}
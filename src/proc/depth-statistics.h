@@ -0,0 +1,41 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "../include/librealsense2/hpp/rs_frame.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+#include "synthetic-stream.h"
+
+namespace librealsense
+{
+    // Statistics of a depth frame, and its histogram of distances
+    struct depth_statistics
+    {
+        rs2_depth_statistics summary;
+        std::vector<uint32_t> histogram;
+    };
+
+    // The statistics of a depth frame, when the frame went through a statistics block and was not written since
+    const depth_statistics* get_depth_statistics(const frame_interface* depth);
+
+    // Computes the statistics of Z16 depth frames in one pass over the pixels, in bands on the shared worker threads,
+    // and attaches them to the frames, so that the monitors downstream read them instead of scanning the frames again
+    class depth_statistics_block : public processing_block
+    {
+    public:
+        depth_statistics_block();
+
+    private:
+        std::shared_ptr<depth_statistics> compute(const uint16_t* depth, int width, int height, int stride, float units);
+        void update_bins(float units);
+
+        int                     _bins;
+        float                   _histogram_min, _histogram_max;
+        float                   _near_distance;
+        int                     _crop_left, _crop_top, _crop_right, _crop_bottom;
+        std::vector<uint16_t>   _bin_of;    // One plus the bin of every depth value, zero for the values out of the histogram
+        int                     _lut_bins;
+        float                   _lut_min, _lut_max, _lut_units;
+    };
+}
@@ -0,0 +1,162 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#include "../include/librealsense2/hpp/rs_sensor.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+
+#include "context.h"
+#include "environment.h"
+#include "archive.h"
+#include "proc/disparity-transform.h"
+#include "cpu-features.h"
+
+#ifdef __SSSE3__
+#include <immintrin.h>
+#endif
+
+namespace librealsense
+{
+    static const size_t DISPARITY_LUT_SIZE = 0x10000;
+
+    static void apply_lut_scalar(const uint16_t* input, uint16_t* output, const uint16_t* lut, size_t count)
+    {
+        for (size_t i = 0; i < count; i++)
+            output[i] = lut[input[i]];
+    }
+
+#ifdef __SSSE3__
+    // Gathers 32 bit words at the table entries, so the table has one more entry for the last one to be read whole
+    AVX2_TARGET static void apply_lut_avx2(const uint16_t* input, uint16_t* output, const uint16_t* lut, size_t count)
+    {
+        auto table = reinterpret_cast<const int*>(lut);
+        const __m256i low_half = _mm256_set1_epi32(0xffff);
+        size_t i = 0;
+        for (; i + 16 <= count; i += 16)
+        {
+            const __m256i lo = _mm256_and_si256(_mm256_i32gather_epi32(table,
+                _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i))), 2), low_half);
+            const __m256i hi = _mm256_and_si256(_mm256_i32gather_epi32(table,
+                _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i + 8))), 2), low_half);
+            // Packing works within 128 bit lanes, the permutation restores the pixel order
+            const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(lo, hi), 0xd8);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i), packed);
+        }
+        apply_lut_scalar(input + i, output + i, lut, count - i);
+    }
+#endif
+
+    typedef void(*apply_lut_function)(const uint16_t* input, uint16_t* output, const uint16_t* lut, size_t count);
+
+    static apply_lut_function select_apply_lut()
+    {
+#ifdef __SSSE3__
+        if (cpu_supports(CPU_FEATURE_AVX2)) return &apply_lut_avx2;
+#endif
+        return &apply_lut_scalar;
+    }
+
+    disparity_transform::disparity_transform(bool to_disparity)
+        : _to_disparity(to_disparity), _depth_units(0), _baseline_mm(0), _focal_px(0), _lut_scale(0),
+          _current_frm_size_pixels(0)
+    {
+        unregister_option(RS2_OPTION_FRAMES_QUEUE_SIZE);
+
+        auto on_frame = [this](rs2::frame f, const rs2::frame_source& source)
+        {
+            rs2::frame out = f, tgt, depth;
+
+            bool composite = f.is<rs2::frameset>();
+
+            depth = (composite) ? f.as<rs2::frameset>().first_or_default(RS2_STREAM_DEPTH) : f;
+            auto input_format = _to_disparity ? RS2_FORMAT_Z16 : RS2_FORMAT_DISPARITY16;
+            if (depth && depth.get_profile().format() == input_format) // Processing required
+            {
+                prepare_stage(depth);
+                auto vp = configure_stage(depth.get_profile()).as<rs2::video_stream_profile>();
+                tgt = source.allocate_video_frame(vp, depth, 2, vp.width(), vp.height(), vp.width() * 2,
+                    RS2_EXTENSION_DEPTH_FRAME);
+
+                run_stage(static_cast<const uint16_t*>(depth.get_data()), static_cast<uint16_t*>(const_cast<void*>(tgt.get_data())));
+                out = composite ? source.allocate_composite_frame({ tgt }) : tgt;
+            }
+
+            source.frame_ready(out);
+        };
+
+        auto callback = new rs2::frame_processor_callback<decltype(on_frame)>(on_frame);
+        processing_block::set_processing_callback(std::shared_ptr<rs2_frame_processor_callback>(callback));
+    }
+
+    void disparity_transform::prepare_stage(const rs2::frame& source)
+    {
+        auto df = dynamic_cast<depth_frame*>((frame_interface*)source.get());
+        auto stereo = std::dynamic_pointer_cast<stereo_baseline_interface>(((frame_interface*)source.get())->get_sensor());
+        if (!df || !stereo)
+            throw invalid_value_exception("Disparity needs depth frames of a stereo depth sensor");
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        _depth_units = df->get_units();
+        _baseline_mm = stereo->get_stereo_baseline_mm();
+    }
+
+    rs2::stream_profile disparity_transform::configure_stage(const rs2::stream_profile& input)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (input.get() != _source_stream_profile.get())
+        {
+            _source_stream_profile = input;
+            _target_stream_profile = input.clone(RS2_STREAM_DEPTH, 0, _to_disparity ? RS2_FORMAT_DISPARITY16 : RS2_FORMAT_Z16);
+
+            environment::get_instance().get_extrinsics_graph().register_same_extrinsics(
+                *(stream_interface*)(input.get()->profile),
+                *(stream_interface*)(_target_stream_profile.get()->profile));
+
+            auto src_vspi = dynamic_cast<video_stream_profile_interface*>(input.get()->profile);
+            auto tgt_vspi = dynamic_cast<video_stream_profile_interface*>(_target_stream_profile.get()->profile);
+            auto intrinsics = src_vspi->get_intrinsics();
+            tgt_vspi->set_dims(src_vspi->get_width(), src_vspi->get_height());
+            tgt_vspi->set_intrinsics([intrinsics]() { return intrinsics; });
+
+            _focal_px = intrinsics.fx;
+            _current_frm_size_pixels = size_t(src_vspi->get_width()) * src_vspi->get_height();
+        }
+        update_lut();
+        return _target_stream_profile;
+    }
+
+    void disparity_transform::update_lut()
+    {
+        // Disparity in sub-pixels is scale / depth in depth units, and depth is the same scale / disparity
+        auto scale = DISPARITY_SUBPIXELS * _focal_px * _baseline_mm / (_depth_units * 1000.f);
+        if (!(scale > 0))
+            throw invalid_value_exception("Disparity needs the depth units, baseline and focal length of the frames");
+        if (scale == _lut_scale)
+            return;
+
+        _lut.assign(DISPARITY_LUT_SIZE + 1, 0);
+        for (size_t v = 1; v < DISPARITY_LUT_SIZE; v++)
+        {
+            auto converted = scale / v + 0.5f;
+            _lut[v] = converted < DISPARITY_LUT_SIZE ? static_cast<uint16_t>(converted) : 0;
+        }
+        _lut_scale = scale;
+    }
+
+    void disparity_transform::run_stage(const uint16_t* input, uint16_t* output)
+    {
+        static const auto apply_lut = select_apply_lut();
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto lut = _lut.data();
+        auto&& pool = environment::get_instance().get_worker_pool();
+        const size_t min_band_pixels = 65536;
+        const auto size = _current_frm_size_pixels;
+        const int bands = static_cast<int>(std::max<size_t>(1, std::min<size_t>(pool.size() + 1, size / min_band_pixels)));
+
+        pool.run(bands, [&](int band)
+        {
+            auto begin = size * band / bands, end = size * (band + 1) / bands;
+            apply_lut(input + begin, output + begin, lut, end - begin);
+        });
+    }
+}
@@ -0,0 +1,41 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include "types.h"
+#include "filter-chain.h"
+
+namespace librealsense
+{
+    // Sub-pixel steps of the DISPARITY16 values the disparity transform writes
+    const float DISPARITY_SUBPIXELS = 32.f;
+
+    // Converts Z16 depth to DISPARITY16 disparity, or back, through a table of all the 64K values. Disparity is
+    // inversely proportional to depth, so both directions share the table formula, built from the depth units and the
+    // stereo baseline of the sensor and the focal length of the frame. Values out of the 16 bit range become holes
+    // Running the spatial and temporal filters between a transform to disparity and one back smooths in disparity,
+    // where the stereo error is the same at all distances
+    class disparity_transform : public processing_block, public depth_filter_stage
+    {
+    public:
+        explicit disparity_transform(bool to_disparity);
+
+        void prepare_stage(const rs2::frame& source) override;
+        rs2::stream_profile configure_stage(const rs2::stream_profile& input) override;
+        void run_stage(const uint16_t* input, uint16_t* output) override;
+
+    private:
+        void update_lut();
+
+        bool _to_disparity;
+        std::mutex _mutex;
+        float _depth_units;
+        float _baseline_mm;
+        float _focal_px;
+        float _lut_scale;
+        std::vector<uint16_t> _lut;
+        size_t _current_frm_size_pixels;
+        rs2::stream_profile _source_stream_profile;
+        rs2::stream_profile _target_stream_profile;
+    };
+}
@@ -0,0 +1,82 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#include "../include/librealsense2/hpp/rs_sensor.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+
+#include "context.h"
+#include "environment.h"
+#include "archive.h"
+#include "image.h"
+#include "proc/synthetic-stream.h"
+#include "proc/distance-transform.h"
+
+namespace librealsense
+{
+    distance_transform::distance_transform()
+    {
+        unregister_option(RS2_OPTION_FRAMES_QUEUE_SIZE);
+
+        auto on_frame = [this](rs2::frame f, const rs2::frame_source& source)
+        {
+            rs2::frame out = f, tgt, depth;
+
+            bool composite = f.is<rs2::frameset>();
+
+            depth = (composite) ? f.as<rs2::frameset>().first_or_default(RS2_STREAM_DEPTH) : f;
+            if (depth && depth.get_profile().format() == RS2_FORMAT_Z16) // Processing required
+            {
+                auto df = dynamic_cast<depth_frame*>((frame_interface*)depth.get());
+                if (!df)
+                    throw invalid_value_exception("Distance transform needs depth frames");
+                auto units = df->get_units();
+
+                auto vp = configure(depth.get_profile()).as<rs2::video_stream_profile>();
+                tgt = source.allocate_video_frame(vp, depth, 4, vp.width(), vp.height(), vp.width() * 4,
+                    RS2_EXTENSION_VIDEO_FRAME);
+
+                auto input = static_cast<const byte*>(depth.get_data());
+                auto output = static_cast<byte*>(const_cast<void*>(tgt.get_data()));
+                auto width = vp.width(), height = vp.height();
+                auto input_stride = df->get_stride();
+
+                auto&& pool = environment::get_instance().get_worker_pool();
+                const int min_band_pixels = 65536;
+                const int bands = std::max(1, std::min(static_cast<int>(pool.size()) + 1, width * height / min_band_pixels));
+                pool.run(bands, [&](int band)
+                {
+                    auto begin = height * band / bands, end = height * (band + 1) / bands;
+                    convert_image(output + begin * width * 4, width * 4, RS2_FORMAT_DISTANCE, input + begin * input_stride, input_stride,
+                                  RS2_FORMAT_Z16, width, end - begin, units);
+                });
+                out = composite ? source.allocate_composite_frame({ tgt }) : tgt;
+            }
+
+            source.frame_ready(out);
+        };
+
+        auto callback = new rs2::frame_processor_callback<decltype(on_frame)>(on_frame);
+        processing_block::set_processing_callback(std::shared_ptr<rs2_frame_processor_callback>(callback));
+    }
+
+    rs2::stream_profile distance_transform::configure(const rs2::stream_profile& input)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (input.get() != _source_stream_profile.get())
+        {
+            _source_stream_profile = input;
+            _target_stream_profile = input.clone(RS2_STREAM_DEPTH, input.stream_index(), RS2_FORMAT_DISTANCE);
+
+            environment::get_instance().get_extrinsics_graph().register_same_extrinsics(
+                *(stream_interface*)(input.get()->profile),
+                *(stream_interface*)(_target_stream_profile.get()->profile));
+
+            auto src_vspi = dynamic_cast<video_stream_profile_interface*>(input.get()->profile);
+            auto tgt_vspi = dynamic_cast<video_stream_profile_interface*>(_target_stream_profile.get()->profile);
+            auto intrinsics = src_vspi->get_intrinsics();
+            tgt_vspi->set_dims(src_vspi->get_width(), src_vspi->get_height());
+            tgt_vspi->set_intrinsics([intrinsics]() { return intrinsics; });
+        }
+        return _target_stream_profile;
+    }
+}
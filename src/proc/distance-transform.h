@@ -0,0 +1,26 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "../include/librealsense2/hpp/rs_frame.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+#include "synthetic-stream.h"
+
+namespace librealsense
+{
+    // Converts Z16 depth frames to RS2_FORMAT_DISTANCE frames of float meters, scaling by the depth units of each frame
+    // with the vectorized conversion of rs2_copy_frame_to, in bands on the shared worker threads
+    class distance_transform : public processing_block
+    {
+    public:
+        distance_transform();
+
+    private:
+        rs2::stream_profile configure(const rs2::stream_profile& input);
+
+        std::mutex _mutex;
+        rs2::stream_profile _source_stream_profile;
+        rs2::stream_profile _target_stream_profile;
+    };
+}
@@ -0,0 +1,86 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#include "../include/librealsense2/hpp/rs_sensor.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+
+#include "option.h"
+#include "proc/filter-chain.h"
+
+namespace librealsense
+{
+    static size_t pixel_count(const rs2::stream_profile& profile)
+    {
+        auto vp = profile.as<rs2::video_stream_profile>();
+        return size_t(vp.width()) * vp.height();
+    }
+
+    filter_chain::filter_chain(std::vector<std::shared_ptr<processing_block_interface>> filters)
+        : _filters(std::move(filters))
+    {
+        if (_filters.empty())
+            throw invalid_value_exception("Filter chain requires at least one filter");
+
+        for (auto&& f : _filters)
+        {
+            auto stage = dynamic_cast<depth_filter_stage*>(f.get());
+            if (!stage)
+                throw invalid_value_exception("Filter chain accepts the threshold and crop, decimation, spatial, temporal, hole filling and disparity filters only");
+            _stages.push_back(stage);
+        }
+
+        unregister_option(RS2_OPTION_FRAMES_QUEUE_SIZE);
+        set_in_place_processing(true);
+
+        auto on_frame = [this](rs2::frame f, const rs2::frame_source& source)
+        {
+            rs2::frame out = f, tgt, depth;
+
+            bool composite = f.is<rs2::frameset>();
+
+            depth = (composite) ? f.as<rs2::frameset>().first_or_default(RS2_STREAM_DEPTH) : f;
+
+            if (depth) // Processing required
+            {
+                for (auto&& stage : _stages)
+                    stage->prepare_stage(depth);
+
+                std::vector<rs2::stream_profile> profiles{ depth.get_profile() };
+                for (auto&& stage : _stages)
+                    profiles.push_back(stage->configure_stage(profiles.back()));
+
+                auto vp = profiles.back().as<rs2::video_stream_profile>();
+                tgt = source.allocate_video_frame(vp, depth, 2, vp.width(), vp.height(), vp.width() * 2,
+                    RS2_EXTENSION_DEPTH_FRAME);
+
+                auto final_size = pixel_count(profiles.back());
+                auto target = static_cast<uint16_t*>(const_cast<void*>(tgt.get_data()));
+                auto src = static_cast<const uint16_t*>(depth.get_data());
+
+                // Stages producing a frame of the final size work in the output frame itself, earlier
+                // stages that reduce the resolution alternate between the two scratch buffers
+                for (size_t i = 0; i < _stages.size(); i++)
+                {
+                    auto size = pixel_count(profiles[i + 1]);
+                    uint16_t* dst = target;
+                    if (size != final_size)
+                    {
+                        auto&& scratch = (src == _scratch[0].data()) ? _scratch[1] : _scratch[0];
+                        scratch.resize(size);
+                        dst = scratch.data();
+                    }
+
+                    _stages[i]->run_stage(src, dst);
+                    src = dst;
+                }
+            }
+
+            out = composite ? source.allocate_composite_frame({ tgt }) : tgt;
+
+            source.frame_ready(out);
+        };
+
+        auto callback = new rs2::frame_processor_callback<decltype(on_frame)>(on_frame);
+        processing_block::set_processing_callback(std::shared_ptr<rs2_frame_processor_callback>(callback));
+    }
+}
@@ -0,0 +1,42 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include <vector>
+
+#include "../include/librealsense2/hpp/rs_frame.hpp"
+#include "synthetic-stream.h"
+
+namespace librealsense
+{
+    // Depth post-processing filters that can be run as a stage of a filter_chain
+    class depth_filter_stage
+    {
+    public:
+        // Called with the source depth frame before the stages are configured, for stages using its sensor
+        virtual void prepare_stage(const rs2::frame& source) {}
+
+        // Prepare the stage for 16 bit frames of the given profile and return the profile of its output
+        virtual rs2::stream_profile configure_stage(const rs2::stream_profile& input) = 0;
+
+        // Filter one frame of the configured profile. Stages that keep the frame size accept input == output
+        virtual void run_stage(const uint16_t* input, uint16_t* output) = 0;
+
+        virtual ~depth_filter_stage() = default;
+    };
+
+    // Runs an ordered list of depth filters as a single processing block. All the stages write into one
+    // output frame, so a frame is allocated once for the whole chain instead of once per filter.
+    // The filters keep their own options, and should not be invoked on their own while part of a chain
+    class filter_chain : public processing_block
+    {
+    public:
+        explicit filter_chain(std::vector<std::shared_ptr<processing_block_interface>> filters);
+
+    private:
+        std::vector<std::shared_ptr<processing_block_interface>> _filters;
+        std::vector<depth_filter_stage*> _stages;
+        std::vector<uint16_t> _scratch[2];    // Intermediate results of stages that change the frame size
+    };
+}
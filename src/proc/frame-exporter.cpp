@@ -0,0 +1,347 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#include "../include/librealsense2/hpp/rs_sensor.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+
+#include <fstream>
+#include "environment.h"
+#include "proc/frame-exporter.h"
+
+#define STB_IMAGE_WRITE_STATIC
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "../../third-party/stb_image_write.h"
+
+namespace librealsense
+{
+    // Channels of the formats written as PNG images, zero for the others
+    static int get_png_channels(rs2_format format)
+    {
+        switch (format)
+        {
+        case RS2_FORMAT_Y8: return 1;
+        case RS2_FORMAT_RGB8: case RS2_FORMAT_BGR8: return 3;
+        case RS2_FORMAT_RGBA8: case RS2_FORMAT_BGRA8: return 4;
+        default: return 0;
+        }
+    }
+
+    static void write_png(const std::string& filename, video_frame& f, rs2_format format)
+    {
+        auto channels = get_png_channels(format);
+        auto data = f.get_frame_data();
+        auto stride = f.get_stride();
+
+        // PNG has no blue first formats, so these are written through a copy with red and blue swapped
+        std::vector<byte> swapped;
+        if (format == RS2_FORMAT_BGR8 || format == RS2_FORMAT_BGRA8)
+        {
+            stride = f.get_width() * channels;
+            swapped.resize(stride * f.get_height());
+            for (int y = 0; y < f.get_height(); y++)
+            {
+                auto in = data + y * f.get_stride();
+                auto out = swapped.data() + y * stride;
+                for (int x = 0; x < f.get_width(); x++, in += channels, out += channels)
+                {
+                    out[0] = in[2]; out[1] = in[1]; out[2] = in[0];
+                    if (channels == 4) out[3] = in[3];
+                }
+            }
+            data = swapped.data();
+        }
+
+        if (!stbi_write_png(filename.c_str(), f.get_width(), f.get_height(), channels, data, stride))
+            throw io_exception(to_string() << "Failed to write " << filename);
+    }
+
+    static void write_raw(const std::string& filename, frame_interface* f)
+    {
+        std::ofstream out(filename, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(f->get_frame_data()), f->get_frame_data_size());
+        if (!out)
+            throw io_exception(to_string() << "Failed to write " << filename);
+    }
+
+    static float half_to_float(uint16_t h)
+    {
+        uint32_t sign = (h & 0x8000u) << 16;
+        uint32_t exponent = (h >> 10) & 0x1f;
+        uint32_t mantissa = h & 0x3ffu;
+        uint32_t bits;
+        if (exponent == 0x1f) bits = sign | 0x7f800000u | (mantissa << 13);    // Infinity or NaN
+        else if (exponent) bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+        else if (!mantissa) bits = sign;
+        else
+        {
+            // Subnormal halves are normal floats
+            exponent = 113;
+            while (!(mantissa & 0x400u)) { mantissa <<= 1; exponent--; }
+            bits = sign | (exponent << 23) | ((mantissa & 0x3ffu) << 13);
+        }
+        float f;
+        memcpy(&f, &bits, sizeof(f));
+        return f;
+    }
+
+    static float3 read_vertex(const byte* v, rs2_format format)
+    {
+        switch (format)
+        {
+        case RS2_FORMAT_XYZ16F:
+        {
+            uint16_t h[3];
+            memcpy(h, v, sizeof(h));
+            return{ half_to_float(h[0]), half_to_float(h[1]), half_to_float(h[2]) };
+        }
+        case RS2_FORMAT_XYZ16:
+        {
+            int16_t mm[3];
+            memcpy(mm, v, sizeof(mm));
+            return{ mm[0] * 0.001f, mm[1] * 0.001f, mm[2] * 0.001f };
+        }
+        default:
+        {
+            float3 f;
+            memcpy(&f, v, sizeof(f));
+            return f;
+        }
+        }
+    }
+
+    // Color of the texture at the coordinates, as red, green and blue bytes of a word
+    class texture_sampler
+    {
+    public:
+        explicit texture_sampler(frame_interface* texture)
+            : _texture(dynamic_cast<video_frame*>(texture))
+        {
+            if (!texture) return;
+            auto format = texture->get_stream()->get_format();
+            _channels = get_png_channels(format);
+            if (!_texture || !_channels)
+                throw invalid_value_exception(to_string() << "Points can not be colored from a texture of format " << get_string(format));
+            _swap = format == RS2_FORMAT_BGR8 || format == RS2_FORMAT_BGRA8;
+        }
+
+        explicit operator bool() const { return _texture != nullptr; }
+
+        uint32_t get(const float2& uv) const
+        {
+            const int w = _texture->get_width(), h = _texture->get_height();
+            int x = std::min(std::max(int(uv.x * w + .5f), 0), w - 1);
+            int y = std::min(std::max(int(uv.y * h + .5f), 0), h - 1);
+            auto p = _texture->get_frame_data() + y * _texture->get_stride() + x * _channels;
+            if (_channels == 1) return p[0] | (p[0] << 8) | (p[0] << 16);
+            if (_swap) return p[2] | (p[1] << 8) | (p[0] << 16);
+            return p[0] | (p[1] << 8) | (p[2] << 16);
+        }
+
+    private:
+        video_frame* _texture;
+        int _channels = 0;
+        bool _swap = false;
+    };
+
+    template<class T>
+    static void append(std::vector<byte>& data, const T& value)
+    {
+        auto bytes = reinterpret_cast<const byte*>(&value);
+        data.insert(data.end(), bytes, bytes + sizeof(T));
+    }
+
+    // Lay out the points that have depth as the records of a file, using the given writer for every record
+    template<class T>
+    static size_t gather_points(points& p, std::vector<byte>& data, size_t record_size, T write_record)
+    {
+        auto format = p.get_vertex_format();
+        auto count = p.get_vertex_count();
+        auto vertex_size = points::get_vertex_size(format);
+        auto vertices = reinterpret_cast<const byte*>(p.get_vertices());
+        auto tex_coords = p.get_texture_coordinates();
+
+        data.reserve(count * record_size);
+        size_t written = 0;
+        for (size_t i = 0; i < count; i++)
+        {
+            auto v = read_vertex(vertices + i * vertex_size, format);
+            if (!v.z) continue;
+            write_record(v, tex_coords[i]);
+            written++;
+        }
+        return written;
+    }
+
+    static void write_file(const std::string& filename, const std::string& header, const std::vector<byte>& data)
+    {
+        std::ofstream out(filename, std::ios::binary);
+        out.write(header.data(), header.size());
+        out.write(reinterpret_cast<const char*>(data.data()), data.size());
+        if (!out)
+            throw io_exception(to_string() << "Failed to write " << filename);
+    }
+
+    void export_to_ply(const std::string& filename, points& p, frame_interface* texture)
+    {
+        texture_sampler sampler(texture);
+        std::vector<byte> data;
+        auto count = gather_points(p, data, sampler ? 15 : 20, [&](const float3& v, const float2& uv)
+        {
+            append(data, v);
+            if (sampler)
+            {
+                auto color = sampler.get(uv);
+                data.push_back(static_cast<byte>(color));
+                data.push_back(static_cast<byte>(color >> 8));
+                data.push_back(static_cast<byte>(color >> 16));
+            }
+            else append(data, uv);
+        });
+
+        to_string header;
+        header << "ply\n"
+               << "format binary_little_endian 1.0\n"
+               << "comment pointcloud saved by librealsense\n"
+               << "element vertex " << count << "\n"
+               << "property float x\n"
+               << "property float y\n"
+               << "property float z\n";
+        if (sampler)
+            header << "property uchar red\n"
+                   << "property uchar green\n"
+                   << "property uchar blue\n";
+        else
+            header << "property float u\n"
+                   << "property float v\n";
+        header << "end_header\n";
+        write_file(filename, header, data);
+    }
+
+    void export_to_pcd(const std::string& filename, points& p, frame_interface* texture)
+    {
+        texture_sampler sampler(texture);
+        std::vector<byte> data;
+        auto count = gather_points(p, data, sampler ? 16 : 12, [&](const float3& v, const float2& uv)
+        {
+            append(data, v);
+            // PCL keeps the color as the bits of a float, blue in the low byte
+            if (sampler)
+            {
+                auto color = sampler.get(uv);
+                append(data, static_cast<uint32_t>(((color & 0xff) << 16) | (color & 0xff00) | ((color >> 16) & 0xff)));
+            }
+        });
+
+        to_string header;
+        header << "# .PCD v0.7 - Point Cloud Data file format\n"
+               << "VERSION 0.7\n"
+               << (sampler ? "FIELDS x y z rgb\nSIZE 4 4 4 4\nTYPE F F F F\nCOUNT 1 1 1 1\n"
+                           : "FIELDS x y z\nSIZE 4 4 4\nTYPE F F F\nCOUNT 1 1 1\n")
+               << "WIDTH " << count << "\n"
+               << "HEIGHT 1\n"
+               << "VIEWPOINT 0 0 0 1 0 0 0\n"
+               << "POINTS " << count << "\n"
+               << "DATA binary\n";
+        write_file(filename, header, data);
+    }
+
+    static void write_frame(frame_interface* f, const std::string& filename)
+    {
+        auto format = f->get_stream()->get_format();
+        if (auto p = dynamic_cast<points*>(f))
+            export_to_ply(filename, *p, nullptr);
+        else if (auto vf = dynamic_cast<video_frame*>(f))
+        {
+            if (get_png_channels(format)) write_png(filename, *vf, format);
+            else write_raw(filename, f);
+        }
+        else write_raw(filename, f);
+    }
+
+    frame_exporter::frame_exporter(const std::string& prefix, uint32_t max_pending)
+        : _prefix(prefix), _max_pending(std::max<uint32_t>(max_pending, 1)), _pending(0)
+    {
+        unregister_option(RS2_OPTION_FRAMES_QUEUE_SIZE);
+
+        auto on_frame = [this](rs2::frame f, const rs2::frame_source& source)
+        {
+            auto export_frame = [this](const rs2::frame& f)
+            {
+                auto ptr = (frame_interface*)f.get();
+                ptr->acquire();
+                frame_holder holder(ptr);
+                auto filename = get_filename(ptr);
+                post(std::move(holder), filename);
+            };
+
+            if (auto composite = f.as<rs2::frameset>()) composite.foreach(export_frame);
+            else export_frame(f);
+
+            source.frame_ready(f);
+        };
+
+        auto callback = new rs2::frame_processor_callback<decltype(on_frame)>(on_frame);
+        processing_block::set_processing_callback(std::shared_ptr<rs2_frame_processor_callback>(callback));
+    }
+
+    frame_exporter::~frame_exporter()
+    {
+        flush();
+    }
+
+    void frame_exporter::save(frame_holder f, const std::string& filename)
+    {
+        post(std::move(f), filename);
+    }
+
+    void frame_exporter::flush()
+    {
+        std::unique_lock<std::mutex> lock(_pending_mutex);
+        _pending_cv.wait(lock, [this]() { return _pending == 0; });
+    }
+
+    std::string frame_exporter::get_filename(frame_interface* f) const
+    {
+        auto stream = f->get_stream();
+        auto format = stream->get_format();
+        auto extension = dynamic_cast<points*>(f) ? ".ply"
+                       : dynamic_cast<video_frame*>(f) && get_png_channels(format) ? ".png" : ".raw";
+
+        to_string name;
+        name << _prefix << get_string(stream->get_stream_type());
+        if (stream->get_stream_index()) name << stream->get_stream_index();
+        name << "-" << f->get_frame_number() << extension;
+        return name;
+    }
+
+    void frame_exporter::post(frame_holder f, std::string filename)
+    {
+        {
+            std::unique_lock<std::mutex> lock(_pending_mutex);
+            _pending_cv.wait(lock, [this]() { return _pending < _max_pending; });
+            _pending++;
+        }
+
+        // The holder is moved into a shared pointer, as the tasks of the worker pool are copyable functions
+        auto frame = std::make_shared<frame_holder>(std::move(f));
+        environment::get_instance().get_worker_pool().post([this, frame, filename]()
+        {
+            try
+            {
+                write_frame(frame->frame, filename);
+            }
+            catch (const std::exception& e)
+            {
+                LOG_ERROR("Failed to export frame to " << filename << ": " << e.what());
+            }
+            // Released before the count drops, so flush returns with no frame of the exporter still held
+            *frame = {};
+
+            {
+                std::lock_guard<std::mutex> lock(_pending_mutex);
+                _pending--;
+            }
+            _pending_cv.notify_all();
+        });
+    }
+}
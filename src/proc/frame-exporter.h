@@ -0,0 +1,43 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include <condition_variable>
+#include "synthetic-stream.h"
+
+namespace librealsense
+{
+    // Write the points that have depth, in meters, to binary little endian files, each file with a single write
+    // With a texture of 8 bit per channel format the points get the color of their texture coordinates,
+    // without one PLY files keep the texture coordinates themselves and PCD files only the coordinates
+    void export_to_ply(const std::string& filename, points& p, frame_interface* texture);
+    void export_to_pcd(const std::string& filename, points& p, frame_interface* texture);
+
+    // Writes the frames it is given to files on the shared worker threads, and passes them on unchanged
+    // Video frames of 8 bit per channel formats are written as PNG images, other video frames as raw data, points as PLY
+    // At most max_pending frames wait to be written, beyond that the caller waits for one of them to be done
+    class frame_exporter : public processing_block
+    {
+    public:
+        frame_exporter(const std::string& prefix, uint32_t max_pending);
+        ~frame_exporter();
+
+        // Writes a single frame to the given file, the extension of the file is not checked against the format
+        void save(frame_holder f, const std::string& filename);
+
+        // Waits for all the frames given so far to be written
+        void flush();
+
+    private:
+        void post(frame_holder f, std::string filename);
+        std::string get_filename(frame_interface* f) const;
+
+        std::string _prefix;
+        uint32_t _max_pending;
+
+        std::mutex _pending_mutex;
+        std::condition_variable _pending_cv;
+        uint32_t _pending;
+    };
+}
@@ -0,0 +1,226 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#include "../include/librealsense2/hpp/rs_sensor.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+#include "option.h"
+#include "environment.h"
+#include "context.h"
+#include "proc/synthetic-stream.h"
+#include "proc/hole-filling-filter.h"
+#include "cpu-features.h"
+
+#include <algorithm>
+
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#endif
+
+namespace librealsense
+{
+    static void fill_from_left_scalar(const uint16_t* input, uint16_t* output, size_t begin, size_t width, uint16_t& last)
+    {
+        for (size_t x = begin; x < width; x++)
+        {
+            if (input[x]) last = input[x];
+            output[x] = last;
+        }
+    }
+
+    // Each row is filled from its left edge, holes left of the first valid pixel remain
+    static void fill_from_left_scalar(const uint16_t* input, uint16_t* output, size_t width)
+    {
+        uint16_t last = 0;
+        fill_from_left_scalar(input, output, 0, width, last);
+    }
+
+    // The smallest or largest valid value of the 8 neighbors of pixel x of the middle row
+    template<bool Farthest>
+    static uint16_t neighbors_scalar(const uint16_t* above, const uint16_t* row, const uint16_t* below, size_t x)
+    {
+        const uint16_t values[] = { above[x - 1], above[x], above[x + 1], row[x - 1], row[x + 1], below[x - 1], below[x], below[x + 1] };
+        uint16_t result = 0;
+        for (auto v : values)
+        {
+            // Holes are zero, so one less wraps them around to the largest value for the nearest mode
+            if (Farthest) result = std::max(result, v);
+            else result = static_cast<uint16_t>(std::min<uint16_t>(static_cast<uint16_t>(result - 1), static_cast<uint16_t>(v - 1)) + 1);
+        }
+        return result;
+    }
+
+    template<bool Farthest>
+    static void fill_neighbors_scalar(const uint16_t* above, const uint16_t* row, const uint16_t* below, uint16_t* output, size_t begin, size_t width)
+    {
+        // The rows are padded, so pixel x is at x + 1
+        for (size_t x = begin; x < width; x++)
+            output[x] = row[x + 1] ? row[x + 1] : neighbors_scalar<Farthest>(above, row, below, x + 1);
+    }
+
+#ifdef __SSSE3__
+    static void fill_from_left_sse(const uint16_t* input, uint16_t* output, size_t width)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        __m128i carry = zero;
+        size_t x = 0;
+        for (; x + 8 <= width; x += 8)
+        {
+            // Each hole takes the nearest valid pixel to its left within the 8 pixels in three doubling steps,
+            // the holes before the first valid pixel take the last pixel of the previous 8
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + x));
+            v = _mm_or_si128(v, _mm_and_si128(_mm_cmpeq_epi16(v, zero), _mm_slli_si128(v, 2)));
+            v = _mm_or_si128(v, _mm_and_si128(_mm_cmpeq_epi16(v, zero), _mm_slli_si128(v, 4)));
+            v = _mm_or_si128(v, _mm_and_si128(_mm_cmpeq_epi16(v, zero), _mm_slli_si128(v, 8)));
+            v = _mm_or_si128(v, _mm_and_si128(_mm_cmpeq_epi16(v, zero), carry));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output + x), v);
+            carry = _mm_shuffle_epi8(v, _mm_set1_epi16(0x0f0e));
+        }
+        auto last = static_cast<uint16_t>(_mm_extract_epi16(carry, 0));
+        fill_from_left_scalar(input, output, x, width, last);
+    }
+
+    template<bool Farthest>
+    static void fill_neighbors_sse(const uint16_t* above, const uint16_t* row, const uint16_t* below, uint16_t* output, size_t width)
+    {
+        // Unsigned comparisons are made signed by flipping the sign bits
+        const __m128i sign = _mm_set1_epi16(static_cast<short>(0x8000)), one = _mm_set1_epi16(1), zero = _mm_setzero_si128();
+        size_t x = 0;
+        for (; x + 8 <= width; x += 8)
+        {
+            const uint16_t* rows[] = { above, row, below };
+            __m128i result = Farthest ? _mm_set1_epi16(static_cast<short>(0x8000)) : _mm_set1_epi16(0x7fff);
+            for (int r = 0; r < 3; r++)
+            {
+                for (int dx = 0; dx < 3; dx++)
+                {
+                    if (r == 1 && dx == 1) continue;
+                    auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[r] + x + dx));
+                    // As in the scalar code, one less turns the holes into the largest value for the nearest mode
+                    if (Farthest) result = _mm_max_epi16(result, _mm_xor_si128(v, sign));
+                    else result = _mm_min_epi16(result, _mm_xor_si128(_mm_sub_epi16(v, one), sign));
+                }
+            }
+            result = _mm_xor_si128(result, sign);
+            if (!Farthest) result = _mm_add_epi16(result, one);
+
+            const __m128i center = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x + 1));
+            const __m128i hole = _mm_cmpeq_epi16(center, zero);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output + x), _mm_or_si128(center, _mm_and_si128(hole, result)));
+        }
+        fill_neighbors_scalar<Farthest>(above, row, below, output, x, width);
+    }
+#endif
+
+    struct hole_fill_functions
+    {
+        void(*from_left)(const uint16_t* input, uint16_t* output, size_t width);
+        void(*farthest)(const uint16_t* above, const uint16_t* row, const uint16_t* below, uint16_t* output, size_t width);
+        void(*nearest)(const uint16_t* above, const uint16_t* row, const uint16_t* below, uint16_t* output, size_t width);
+    };
+
+    template<bool Farthest>
+    static void fill_neighbors_scalar_row(const uint16_t* above, const uint16_t* row, const uint16_t* below, uint16_t* output, size_t width)
+    {
+        fill_neighbors_scalar<Farthest>(above, row, below, output, 0, width);
+    }
+
+    static hole_fill_functions select_hole_fill()
+    {
+#ifdef __SSSE3__
+        if (cpu_supports(CPU_FEATURE_SSSE3)) return{ &fill_from_left_sse, &fill_neighbors_sse<true>, &fill_neighbors_sse<false> };
+#endif
+        return{ &fill_from_left_scalar, &fill_neighbors_scalar_row<true>, &fill_neighbors_scalar_row<false> };
+    }
+
+    hole_filling_filter::hole_filling_filter()
+        : _holes_filling_mode(HOLE_FILL_FARTHEST), _width(0), _height(0)
+    {
+        auto holes_filling_mode = std::make_shared<ptr_option<uint8_t>>(
+            HOLE_FILL_FROM_LEFT, HOLE_FILL_COUNT - 1, 1, HOLE_FILL_FARTHEST,
+            &_holes_filling_mode, "Value the holes take");
+        holes_filling_mode->set_description(HOLE_FILL_FROM_LEFT, "Fill from left");
+        holes_filling_mode->set_description(HOLE_FILL_FARTHEST, "Farthest from around");
+        holes_filling_mode->set_description(HOLE_FILL_NEAREST, "Nearest from around");
+        register_option(RS2_OPTION_HOLES_FILL, holes_filling_mode);
+
+        unregister_option(RS2_OPTION_FRAMES_QUEUE_SIZE);
+        set_in_place_processing(true);
+
+        auto on_frame = [this](rs2::frame f, const rs2::frame_source& source)
+        {
+            rs2::frame out = f, tgt, depth;
+
+            bool composite = f.is<rs2::frameset>();
+
+            depth = (composite) ? f.as<rs2::frameset>().first_or_default(RS2_STREAM_DEPTH) : f;
+            if (depth) // Processing required
+            {
+                auto vp = configure_stage(depth.get_profile()).as<rs2::video_stream_profile>();
+                // In-place processing hands the source frame back as the target
+                tgt = source.allocate_video_frame(vp, depth, 2, vp.width(), vp.height(), vp.width() * 2,
+                    RS2_EXTENSION_DEPTH_FRAME);
+                run_stage(static_cast<const uint16_t*>(depth.get_data()), static_cast<uint16_t*>(const_cast<void*>(tgt.get_data())));
+            }
+
+            out = composite ? source.allocate_composite_frame({ tgt }) : tgt;
+
+            source.frame_ready(out);
+        };
+
+        auto callback = new rs2::frame_processor_callback<decltype(on_frame)>(on_frame);
+        processing_block::set_processing_callback(std::shared_ptr<rs2_frame_processor_callback>(callback));
+    }
+
+    rs2::stream_profile hole_filling_filter::configure_stage(const rs2::stream_profile& input)
+    {
+        update_configuration(input);
+        return _target_stream_profile;
+    }
+
+    void hole_filling_filter::update_configuration(const rs2::stream_profile& profile)
+    {
+        if (profile.get() != _source_stream_profile.get())
+        {
+            _source_stream_profile = profile;
+            _target_stream_profile = _source_stream_profile.clone(RS2_STREAM_DEPTH, 0, _source_stream_profile.format());
+
+            environment::get_instance().get_extrinsics_graph().register_same_extrinsics(
+                *(stream_interface*)(profile.get()->profile),
+                *(stream_interface*)(_target_stream_profile.get()->profile));
+
+            auto vp = _target_stream_profile.as<rs2::video_stream_profile>();
+            _width = vp.width();
+            _height = vp.height();
+        }
+    }
+
+    void hole_filling_filter::run_stage(const uint16_t* input, uint16_t* output)
+    {
+        static const auto fill = select_hole_fill();
+
+        auto mode = _holes_filling_mode;
+        if (mode == HOLE_FILL_FROM_LEFT)
+        {
+            for (size_t y = 0; y < _height; y++)
+                fill.from_left(input + y * _width, output + y * _width, _width);
+            return;
+        }
+
+        // The source rows around the one being filled are kept in padded copies, which the neighbor loads
+        // may cross at the row edges, and which keep their values while the output overwrites the input
+        auto stride = _width + 2;
+        _rows.assign(stride * 3, 0);
+        uint16_t* rows[] = { _rows.data(), _rows.data() + stride, _rows.data() + 2 * stride };
+        std::copy(input, input + _width, rows[2] + 1);
+
+        auto fill_row = mode == HOLE_FILL_NEAREST ? fill.nearest : fill.farthest;
+        for (size_t y = 0; y < _height; y++)
+        {
+            std::rotate(rows, rows + 1, rows + 3);
+            if (y + 1 < _height) std::copy(input + (y + 1) * _width, input + (y + 2) * _width, rows[2] + 1);
+            else std::fill(rows[2], rows[2] + stride, 0);
+
+            fill_row(rows[0], rows[1], rows[2], output + y * _width, _width);
+        }
+    }
+}
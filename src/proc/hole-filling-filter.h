@@ -0,0 +1,41 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include <vector>
+
+#include "../include/librealsense2/hpp/rs_frame.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+#include "filter-chain.h"
+
+namespace librealsense
+{
+    enum holes_filling_mode : uint8_t
+    {
+        HOLE_FILL_FROM_LEFT = 0,     // The last valid pixel to the left in the row
+        HOLE_FILL_FARTHEST  = 1,     // The largest valid value of the 8 neighbors
+        HOLE_FILL_NEAREST   = 2,     // The smallest valid value of the 8 neighbors
+        HOLE_FILL_COUNT
+    };
+
+    // Fills the zero pixels of depth frames in a single pass over the rows, in place when the frame allows it
+    // The neighbor modes read the neighbors as they were before filling, so holes without valid neighbors remain
+    class hole_filling_filter : public processing_block, public depth_filter_stage
+    {
+    public:
+        hole_filling_filter();
+
+        rs2::stream_profile configure_stage(const rs2::stream_profile& input) override;
+        void run_stage(const uint16_t* input, uint16_t* output) override;
+
+    private:
+        void update_configuration(const rs2::stream_profile& profile);
+
+        uint8_t                 _holes_filling_mode;
+        size_t                  _width, _height;
+        rs2::stream_profile     _source_stream_profile;
+        rs2::stream_profile     _target_stream_profile;
+        std::vector<uint16_t>   _rows;    // Three rows of the source, padded with a zero pixel on each side
+    };
+}
@@ -0,0 +1,77 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define MEDIAN_NETWORK_USE_NEON
+#endif
+
+namespace librealsense
+{
+    // Order a pair of values, used by the median selection networks on scalars and on vectors of 8 pixels
+    static inline void sort_pair(uint16_t & a, uint16_t & b)
+    {
+        auto lo = std::min(a, b);
+        b = std::max(a, b);
+        a = lo;
+    }
+
+#ifdef __SSSE3__
+    // The unsigned depth values are biased by 0x8000 so that SSE2 signed compares order them correctly
+    static inline void sort_pair(__m128i & a, __m128i & b)
+    {
+        auto lo = _mm_min_epi16(a, b);
+        b = _mm_max_epi16(a, b);
+        a = lo;
+    }
+#endif
+
+#ifdef MEDIAN_NETWORK_USE_NEON
+    static inline void sort_pair(uint16x8_t & a, uint16x8_t & b)
+    {
+        auto lo = vminq_u16(a, b);
+        b = vmaxq_u16(a, b);
+        a = lo;
+    }
+#endif
+
+    // Selection networks returning element SCALE * SCALE / 2 of the sorted kernel, like the nth_element of the generic path
+    template<int SCALE> struct median_network;
+
+    template<> struct median_network<2>
+    {
+        template<class T> static T median(T * v)
+        {
+            sort_pair(v[0], v[1]); sort_pair(v[2], v[3]);
+            sort_pair(v[0], v[2]); sort_pair(v[1], v[3]);
+            sort_pair(v[1], v[2]);
+            return v[2];
+        }
+    };
+
+    template<> struct median_network<4>
+    {
+        // Batcher's odd-even merge sort of 16 elements, keeping only the comparators element 8 depends on
+        template<class T> static T median(T * v)
+        {
+            static const uint8_t pairs[][2] = {
+                { 0, 1 }, { 2, 3 }, { 0, 2 }, { 1, 3 }, { 1, 2 }, { 4, 5 }, { 6, 7 }, { 4, 6 }, { 5, 7 }, { 5, 6 },
+                { 0, 4 }, { 2, 6 }, { 2, 4 }, { 1, 5 }, { 3, 7 }, { 3, 5 }, { 1, 2 }, { 3, 4 }, { 5, 6 },
+                { 8, 9 }, { 10, 11 }, { 8, 10 }, { 9, 11 }, { 9, 10 }, { 12, 13 }, { 14, 15 }, { 12, 14 }, { 13, 15 }, { 13, 14 },
+                { 8, 12 }, { 10, 14 }, { 10, 12 }, { 9, 13 }, { 11, 15 }, { 11, 13 }, { 9, 10 }, { 11, 12 }, { 13, 14 },
+                { 0, 8 }, { 4, 12 }, { 4, 8 }, { 2, 10 }, { 6, 14 }, { 6, 10 }, { 6, 8 },
+                { 1, 9 }, { 5, 13 }, { 5, 9 }, { 3, 11 }, { 7, 15 }, { 7, 11 }, { 7, 9 }, { 7, 8 } };
+            for (auto&& p : pairs) sort_pair(v[p[0]], v[p[1]]);
+            return v[8];
+        }
+    };
+}
@@ -0,0 +1,185 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#include "../include/librealsense2/hpp/rs_sensor.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+
+#include "option.h"
+#include "environment.h"
+#include "proc/motion-fusion.h"
+
+#include <cmath>
+
+namespace librealsense
+{
+    const float fusion_gain_default = 0.05f;
+
+    // Gaps longer than this, such as after a stop of the stream, restart the integration instead of being integrated
+    const rs2_time_t max_gyro_gap_ms = 100;
+
+    static void normalize(float* v, int count)
+    {
+        float norm = 0;
+        for (int i = 0; i < count; i++) norm += v[i] * v[i];
+        if (norm <= 0) return;
+        norm = 1.f / std::sqrt(norm);
+        for (int i = 0; i < count; i++) v[i] *= norm;
+    }
+
+    // Samples of the frame, with the timestamp of the frame for a single one
+    template<class T>
+    static void foreach_sample(frame_interface* f, T action)
+    {
+        auto format = f->get_stream()->get_format();
+        if (format == RS2_FORMAT_MOTION_XYZ32F_BATCH)
+        {
+            auto samples = reinterpret_cast<const rs2_motion_sample*>(f->get_frame_data());
+            auto count = f->get_frame_data_size() / sizeof(rs2_motion_sample);
+            for (size_t i = 0; i < count; i++)
+                action(samples[i].timestamp, samples[i].xyz);
+        }
+        else if (format == RS2_FORMAT_MOTION_XYZ32F)
+        {
+            float xyz[3];
+            memcpy(xyz, f->get_frame_data(), sizeof(xyz));
+            action(f->get_frame_timestamp(), xyz);
+        }
+    }
+
+    motion_fusion::motion_fusion()
+        : _gain(fusion_gain_default), _q{ 1, 0, 0, 0 }, _accel{}, _gyro{},
+          _has_accel(false), _initialized(false), _last_timestamp(0), _gyro_stream(nullptr)
+    {
+        auto gain = std::make_shared<ptr_option<float>>(0.f, 1.f, 0.001f, fusion_gain_default, &_gain,
+            "Weight of the accelerometer against the gyroscope. Higher values correct drift faster and follow vibrations more");
+        register_option(RS2_OPTION_FUSION_GAIN, gain);
+        unregister_option(RS2_OPTION_FRAMES_QUEUE_SIZE);
+
+        auto on_frame = [this](rs2::frame f, const rs2::frame_source& source)
+        {
+            std::vector<frame_interface*> inputs;
+            if (auto fs = f.as<rs2::frameset>())
+                for (size_t i = 0; i < fs.size(); i++) inputs.push_back((frame_interface*)fs[i].get());
+            else
+                inputs.push_back((frame_interface*)f.get());
+
+            // The accelerometer first, so the gyroscope samples of the same frameset are corrected by it
+            frame_interface* gyro = nullptr;
+            for (auto in : inputs)
+            {
+                auto stream = in->get_stream()->get_stream_type();
+                if (stream == RS2_STREAM_ACCEL)
+                    foreach_sample(in, [this](rs2_time_t, const float* xyz) { add_accel(xyz); });
+                else if (stream == RS2_STREAM_GYRO)
+                    gyro = in;
+            }
+            if (!gyro)
+            {
+                source.frame_ready(f);
+                return;
+            }
+            foreach_sample(gyro, [this](rs2_time_t timestamp, const float* xyz) { add_gyro(timestamp, xyz); });
+
+            frame_holder pose = get_source().allocate_motion_frame(get_pose_stream(gyro->get_stream()), gyro, sizeof(rs2_orientation));
+            rs2_orientation orientation;
+            {
+                std::lock_guard<std::mutex> lock(_state_mutex);
+                orientation = { { _q[1], _q[2], _q[3], _q[0] }, { _gyro[0], _gyro[1], _gyro[2] } };
+            }
+            memcpy(const_cast<byte*>(pose->get_frame_data()), &orientation, sizeof(orientation));
+
+            frameset_builder frames;
+            for (auto in : inputs)
+            {
+                in->acquire();
+                frames.add(frame_holder(in));
+            }
+            frames.add(std::move(pose));
+            get_source().frame_ready(frames.build(get_source()));
+        };
+
+        auto callback = new rs2::frame_processor_callback<decltype(on_frame)>(on_frame);
+        processing_block::set_processing_callback(std::shared_ptr<rs2_frame_processor_callback>(callback));
+    }
+
+    std::shared_ptr<stream_profile_interface> motion_fusion::get_pose_stream(const std::shared_ptr<stream_profile_interface>& gyro)
+    {
+        std::lock_guard<std::mutex> lock(_state_mutex);
+        if (_gyro_stream != gyro.get())
+        {
+            _pose_stream = gyro->clone();
+            _pose_stream->set_stream_type(RS2_STREAM_POSE);
+            _pose_stream->set_stream_index(0);
+            _pose_stream->set_format(RS2_FORMAT_ORIENTATION);
+            environment::get_instance().get_extrinsics_graph().register_same_extrinsics(*_pose_stream, *gyro);
+            _gyro_stream = gyro.get();
+        }
+        return _pose_stream;
+    }
+
+    void motion_fusion::add_accel(const float xyz[3])
+    {
+        std::lock_guard<std::mutex> lock(_state_mutex);
+        memcpy(_accel, xyz, sizeof(_accel));
+        _has_accel = _accel[0] || _accel[1] || _accel[2];
+        if (!_has_accel || _initialized)
+            return;
+
+        // Start from the rotation that brings the measured acceleration onto the Z axis, rather than converging to it
+        float a[3] = { _accel[0], _accel[1], _accel[2] };
+        normalize(a, 3);
+        if (a[2] > -0.999999f)
+        {
+            _q[0] = 1 + a[2]; _q[1] = a[1]; _q[2] = -a[0]; _q[3] = 0;
+            normalize(_q, 4);
+        }
+        else
+        {
+            _q[0] = 0; _q[1] = 1; _q[2] = 0; _q[3] = 0;
+        }
+        _initialized = true;
+    }
+
+    // The IMU update of Madgwick, "An efficient orientation filter for inertial and inertial/magnetic sensor arrays"
+    void motion_fusion::add_gyro(rs2_time_t timestamp, const float xyz[3])
+    {
+        std::lock_guard<std::mutex> lock(_state_mutex);
+        memcpy(_gyro, xyz, sizeof(_gyro));
+        auto dt = static_cast<float>((timestamp - _last_timestamp) / 1000.);
+        auto first = !_last_timestamp || timestamp <= _last_timestamp || timestamp - _last_timestamp > max_gyro_gap_ms;
+        _last_timestamp = timestamp;
+        if (first)
+            return;
+
+        float& q0 = _q[0]; float& q1 = _q[1]; float& q2 = _q[2]; float& q3 = _q[3];
+        const float gx = xyz[0], gy = xyz[1], gz = xyz[2];
+
+        // Rate of change of the quaternion from the gyroscope
+        float dq[4] = { 0.5f * (-q1 * gx - q2 * gy - q3 * gz),
+                        0.5f * (q0 * gx + q2 * gz - q3 * gy),
+                        0.5f * (q0 * gy - q1 * gz + q3 * gx),
+                        0.5f * (q0 * gz + q1 * gy - q2 * gx) };
+
+        if (_has_accel)
+        {
+            float a[3] = { _accel[0], _accel[1], _accel[2] };
+            normalize(a, 3);
+            const float ax = a[0], ay = a[1], az = a[2];
+
+            // Gradient descent step toward the orientation that explains the measured acceleration as gravity
+            const float _2q0 = 2 * q0, _2q1 = 2 * q1, _2q2 = 2 * q2, _2q3 = 2 * q3;
+            const float _4q0 = 4 * q0, _4q1 = 4 * q1, _4q2 = 4 * q2;
+            const float _8q1 = 8 * q1, _8q2 = 8 * q2;
+            const float q0q0 = q0 * q0, q1q1 = q1 * q1, q2q2 = q2 * q2, q3q3 = q3 * q3;
+            float s[4] = { _4q0 * q2q2 + _2q2 * ax + _4q0 * q1q1 - _2q1 * ay,
+                           _4q1 * q3q3 - _2q3 * ax + 4 * q0q0 * q1 - _2q0 * ay - _4q1 + _8q1 * q1q1 + _8q1 * q2q2 + _4q1 * az,
+                           4 * q0q0 * q2 + _2q0 * ax + _4q2 * q3q3 - _2q3 * ay - _4q2 + _8q2 * q1q1 + _8q2 * q2q2 + _4q2 * az,
+                           4 * q1q1 * q3 - _2q1 * ax + 4 * q2q2 * q3 - _2q2 * ay };
+            normalize(s, 4);
+            for (int i = 0; i < 4; i++) dq[i] -= _gain * s[i];
+        }
+
+        for (int i = 0; i < 4; i++) _q[i] += dq[i] * dt;
+        normalize(_q, 4);
+    }
+}
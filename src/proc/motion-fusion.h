@@ -0,0 +1,34 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "synthetic-stream.h"
+
+namespace librealsense
+{
+    // Estimates the orientation of the device from its gyroscope and accelerometer frames with a Madgwick filter,
+    // integrating every sample of batched frames. Accelerometer frames update the direction of gravity and pass through,
+    // every gyroscope frame comes out in a frameset with an RS2_STREAM_POSE frame of the orientation at its timestamp
+    class motion_fusion : public processing_block
+    {
+    public:
+        motion_fusion();
+
+    private:
+        void add_accel(const float xyz[3]);
+        void add_gyro(rs2_time_t timestamp, const float xyz[3]);
+        std::shared_ptr<stream_profile_interface> get_pose_stream(const std::shared_ptr<stream_profile_interface>& gyro);
+
+        std::mutex _state_mutex;
+        float _gain;
+        float _q[4];                // w, x, y, z
+        float _accel[3];
+        float _gyro[3];
+        bool _has_accel, _initialized;
+        rs2_time_t _last_timestamp;
+
+        std::shared_ptr<stream_profile_interface> _pose_stream;
+        stream_profile_interface* _gyro_stream;
+    };
+}
@@ -0,0 +1,165 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#include "../include/librealsense2/hpp/rs_sensor.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+
+#include "option.h"
+#include "environment.h"
+#include "archive.h"
+#include "proc/synthetic-stream.h"
+#include "proc/normal-estimation.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace librealsense
+{
+    const int normal_window_min = 1;
+    const int normal_window_max = 32;
+    const int normal_window_default = 4;
+
+    normal_estimator::normal_estimator()
+        : _window_size(normal_window_default)
+    {
+        register_option(RS2_OPTION_NORMAL_WINDOW_SIZE, std::make_shared<ptr_option<int>>(normal_window_min, normal_window_max, 1,
+            normal_window_default, &_window_size, "Pixels of the windows averaged on each side of a point"));
+
+        unregister_option(RS2_OPTION_FRAMES_QUEUE_SIZE);
+
+        auto on_frame = [this](rs2::frame f, const rs2::frame_source& source)
+        {
+            bool composite = f.is<rs2::frameset>();
+            rs2::frame input;
+            if (composite)
+            {
+                for (auto&& member : f.as<rs2::frameset>())
+                    if (member.is<rs2::points>()) { input = member; break; }
+            }
+            else if (f.is<rs2::points>()) input = f;
+            if (!input)
+            {
+                source.frame_ready(f);
+                return;
+            }
+
+            auto pts = (points*)(frame_interface*)input.get();
+            auto vp = input.get_profile().as<rs2::video_stream_profile>();
+            auto count = pts->get_vertex_count();
+            if (pts->get_vertex_format() != RS2_FORMAT_XYZ32F || !vp || size_t(vp.width()) * vp.height() != count)
+                throw invalid_value_exception("Normal estimation needs XYZ32F points of every depth pixel, "
+                                              "of a pointcloud with RS2_OPTION_COMPACT_POINTS at 0");
+
+            auto out = (points*)get_source().allocate_points(pts->get_stream(), pts, count, RS2_FORMAT_XYZ32F, false, true);
+            rs2::frame tgt((rs2_frame*)(frame_interface*)out);
+            std::copy_n(pts->get_vertices(), count, out->get_vertices());
+            std::copy_n(pts->get_texture_coordinates(), count, out->get_texture_coordinates());
+            estimate(pts->get_vertices(), vp.width(), vp.height(), out->get_normals());
+
+            if (!composite)
+            {
+                source.frame_ready(tgt);
+                return;
+            }
+
+            std::vector<rs2::frame> frames;
+            for (auto&& member : f.as<rs2::frameset>())
+                frames.push_back(member.get() == input.get() ? tgt : member);
+            source.frame_ready(source.allocate_composite_frame(std::move(frames)));
+        };
+
+        auto callback = new rs2::frame_processor_callback<decltype(on_frame)>(on_frame);
+        processing_block::set_processing_callback(std::shared_ptr<rs2_frame_processor_callback>(callback));
+    }
+
+    void normal_estimator::estimate(const float3* vertices, int width, int height, float3* normals)
+    {
+        const int stride = width + 1;
+        _integral.assign(size_t(stride) * (height + 1), integral_cell{ 0, 0, 0, 0 });
+        auto integral = _integral.data();
+
+        auto&& pool = environment::get_instance().get_worker_pool();
+        const int threads = static_cast<int>(pool.size()) + 1;
+        const int row_bands = std::max(1, std::min(threads, height));
+        const int column_bands = std::max(1, std::min(threads, width));
+
+        // Sums along the rows, then down the columns, each pass split between the threads
+        pool.run(row_bands, [&](int band)
+        {
+            for (int y = height * band / row_bands; y < height * (band + 1) / row_bands; ++y)
+            {
+                auto row = integral + (y + 1) * stride;
+                integral_cell sum{ 0, 0, 0, 0 };
+                for (int x = 0; x < width; ++x)
+                {
+                    auto&& v = vertices[y * width + x];
+                    if (v.z)
+                    {
+                        sum.x += v.x;
+                        sum.y += v.y;
+                        sum.z += v.z;
+                        sum.count += 1;
+                    }
+                    row[x + 1] = sum;
+                }
+            }
+        });
+        pool.run(column_bands, [&](int band)
+        {
+            for (int y = 1; y < height; ++y)
+            {
+                auto above = integral + y * stride, row = above + stride;
+                for (int x = width * band / column_bands + 1; x <= width * (band + 1) / column_bands; ++x)
+                {
+                    row[x].x += above[x].x;
+                    row[x].y += above[x].y;
+                    row[x].z += above[x].z;
+                    row[x].count += above[x].count;
+                }
+            }
+        });
+
+        // Mean of the vertices with depth of the columns [x0, x1) and rows [y0, y1), false when there are none
+        auto mean = [&](int x0, int y0, int x1, int y1, float3& result)
+        {
+            auto&& a = integral[y0 * stride + x0], &b = integral[y0 * stride + x1];
+            auto&& c = integral[y1 * stride + x0], &d = integral[y1 * stride + x1];
+            auto count = d.count - b.count - c.count + a.count;
+            if (count <= 0) return false;
+            result = { float((d.x - b.x - c.x + a.x) / count), float((d.y - b.y - c.y + a.y) / count),
+                       float((d.z - b.z - c.z + a.z) / count) };
+            return true;
+        };
+
+        const int r = _window_size;
+        pool.run(row_bands, [&](int band)
+        {
+            for (int y = height * band / row_bands; y < height * (band + 1) / row_bands; ++y)
+            {
+                const int y0 = std::max(0, y - r), y1 = std::min(height, y + r + 1);
+                for (int x = 0; x < width; ++x)
+                {
+                    auto&& v = vertices[y * width + x];
+                    auto&& n = normals[y * width + x];
+                    n = { 0, 0, 0 };
+                    if (!v.z) continue;
+
+                    const int x0 = std::max(0, x - r), x1 = std::min(width, x + r + 1);
+                    float3 left, right, top, bottom;
+                    if (!mean(x0, y0, x, y1, left) || !mean(x + 1, y0, x1, y1, right) ||
+                        !mean(x0, y0, x1, y, top) || !mean(x0, y + 1, x1, y1, bottom))
+                        continue;
+
+                    const float3 dx{ right.x - left.x, right.y - left.y, right.z - left.z };
+                    const float3 dy{ bottom.x - top.x, bottom.y - top.y, bottom.z - top.z };
+                    float3 c{ dx.y * dy.z - dx.z * dy.y, dx.z * dy.x - dx.x * dy.z, dx.x * dy.y - dx.y * dy.x };
+                    auto length = std::sqrt(c.x * c.x + c.y * c.y + c.z * c.z);
+                    if (!(length > 0)) continue;
+                    // Facing the camera, which sees the point along its own vertex
+                    if (c.x * v.x + c.y * v.y + c.z * v.z > 0) length = -length;
+                    n = c * (1.f / length);
+                }
+            }
+        });
+    }
+}
@@ -0,0 +1,33 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "../include/librealsense2/hpp/rs_frame.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+#include "synthetic-stream.h"
+
+namespace librealsense
+{
+    // Estimates the normals of organized points, one point per depth pixel, from the vertex grid itself. The gradients
+    // of a point are the differences of the mean vertices of the windows on either side of it, read from integral images
+    // in constant time whatever the window size. The normals point towards the camera, points without depth or without
+    // neighbours on some side get a zero normal
+    class normal_estimator : public processing_block
+    {
+    public:
+        normal_estimator();
+
+    private:
+        // Sums of the vertices with depth, and their count, of the rectangle from the origin of the grid
+        struct integral_cell
+        {
+            double x, y, z, count;
+        };
+
+        void estimate(const float3* vertices, int width, int height, float3* normals);
+
+        int                         _window_size;
+        std::vector<integral_cell>  _integral;
+    };
+}
@@ -0,0 +1,96 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "option.h"
+
+namespace librealsense
+{
+    // Every step-th pixel of every step-th row of the region inside the margins of an image, starting at its top-left pixel
+    // Sampled pixel (x, y) is pixel (left + x * step, top + y * step) of the image
+    struct pixel_sampling
+    {
+        int left = 0, top = 0, step = 1;
+        int width = 0, height = 0;  // Of the sampled image
+
+        static pixel_sampling create(int image_width, int image_height, int left, int top, int right, int bottom, int step)
+        {
+            if (left + right >= image_width || top + bottom >= image_height)
+                throw invalid_value_exception(to_string() << "Margins leave nothing of an image of size ["
+                    << image_width << "," << image_height << "]");
+            pixel_sampling s;
+            s.left = left;
+            s.top = top;
+            s.step = std::max(step, 1);
+            s.width = (image_width - left - right + s.step - 1) / s.step;
+            s.height = (image_height - top - bottom + s.step - 1) / s.step;
+            return s;
+        }
+
+        bool is_identity(int image_width, int image_height) const
+        {
+            return step == 1 && !left && !top && width == image_width && height == image_height;
+        }
+
+        // Intrinsics of the sampled image. Distortion applies to normalized coordinates, so its coefficients are kept
+        rs2_intrinsics apply(const rs2_intrinsics& intrin) const
+        {
+            auto res = intrin;
+            res.width = width;
+            res.height = height;
+            res.fx = intrin.fx / step;
+            res.fy = intrin.fy / step;
+            res.ppx = (intrin.ppx - left) / step;
+            res.ppy = (intrin.ppy - top) / step;
+            return res;
+        }
+
+        void sample(const uint8_t* src, int src_stride, uint8_t* dst, int bytes_per_pixel) const
+        {
+            for (int y = 0; y < height; y++)
+            {
+                auto in = src + (top + y * step) * src_stride + left * bytes_per_pixel;
+                if (step == 1)
+                {
+                    memcpy(dst, in, width * bytes_per_pixel);
+                    dst += width * bytes_per_pixel;
+                    continue;
+                }
+                for (int x = 0; x < width; x++, in += step * bytes_per_pixel, dst += bytes_per_pixel)
+                    memcpy(dst, in, bytes_per_pixel);
+            }
+        }
+    };
+
+    // RS2_OPTION_SAMPLING_STEP and the RS2_OPTION_CROP_ margins of the blocks that process a sampled image
+    struct sampling_options
+    {
+        int step = 1;
+        int margins[4] = {};    // Left, top, right, bottom
+
+        template<class T>
+        void register_options(options_container& block, T on_change)
+        {
+            auto step_opt = std::make_shared<ptr_option<int>>(1, 16, 1, 1, &step, "Process every N-th pixel of every N-th row");
+            step_opt->on_set([on_change](float) { on_change(); });
+            block.register_option(RS2_OPTION_SAMPLING_STEP, step_opt);
+
+            const rs2_option ids[] = { RS2_OPTION_CROP_LEFT, RS2_OPTION_CROP_TOP, RS2_OPTION_CROP_RIGHT, RS2_OPTION_CROP_BOTTOM };
+            const char* descriptions[] = { "Columns left out at the left of the image", "Rows left out at the top of the image",
+                                           "Columns left out at the right of the image", "Rows left out at the bottom of the image" };
+            for (int i = 0; i < 4; i++)
+            {
+                auto margin = std::make_shared<ptr_option<int>>(0, 4096, 1, 0, &margins[i], descriptions[i]);
+                margin->on_set([on_change](float) { on_change(); });
+                block.register_option(ids[i], margin);
+            }
+        }
+
+        pixel_sampling create(int image_width, int image_height, bool crop) const
+        {
+            return crop ? pixel_sampling::create(image_width, image_height, margins[0], margins[1], margins[2], margins[3], step)
+                        : pixel_sampling::create(image_width, image_height, 0, 0, 0, 0, step);
+        }
+    };
+}
@@ -7,35 +7,187 @@
 #include "proc/synthetic-stream.h"
 #include "environment.h"
 #include "pointcloud.h"
+#include "projection.h"
+#include "change-detection.h"
 #include "option.h"
 
+#include "cpu-features.h"
+
+#ifdef __SSSE3__
+#include <immintrin.h> // For AVX2 intrinsic, only executed when supported by the running CPU
+#endif
+
 namespace librealsense
 {
-    template<class MAP_DEPTH> void deproject_depth(float * points, const rs2_intrinsics & intrin, const uint16_t * depth, MAP_DEPTH map_depth)
+    // Deproject every sampled pixel at unit depth, the point of a pixel is then its ray scaled by the depth of the pixel
+    void deproject_rays(float2 * rays, const rs2_intrinsics & intrin, const pixel_sampling & sampling)
     {
-        for (int y = 0; y<intrin.height; ++y)
+        for (int y = 0; y < sampling.height; ++y)
         {
-            for (int x = 0; x<intrin.width; ++x)
+            for (int x = 0; x < sampling.width; ++x)
             {
-                const float pixel[] = { (float)x, (float)y };
-                rs2_deproject_pixel_to_point(points, &intrin, pixel, map_depth(*depth++));
-                points += 3;
+                const float pixel[] = { (float)(sampling.left + x * sampling.step), (float)(sampling.top + y * sampling.step) };
+                float point[3];
+                rs2_deproject_pixel_to_point(point, &intrin, pixel, 1.f);
+                *rays++ = { point[0], point[1] };
             }
         }
     }
 
-    const float3 * depth_to_points(uint8_t* image, const rs2_intrinsics &depth_intrinsics, const uint16_t * depth_image, float depth_scale)
-    {
-        deproject_depth(reinterpret_cast<float *>(image), depth_intrinsics, depth_image, [depth_scale](uint16_t z) { return depth_scale * z; });
-
-        return reinterpret_cast<float3 *>(image);
-    }
-
     float3 transform(const rs2_extrinsics *extrin, const float3 &point) { float3 p = {}; rs2_transform_point_to_point(&p.x, extrin, &point.x); return p; }
     float2 project(const rs2_intrinsics *intrin, const float3 & point) { float2 pixel = {}; rs2_project_point_to_pixel(&pixel.x, intrin, &point.x); return pixel; }
     float2 pixel_to_texcoord(const rs2_intrinsics *intrin, const float2 & pixel) { return{ (pixel.x + 1.5f) / intrin->width, (pixel.y + 0.5f) / intrin->height }; }
     float2 project_to_texcoord(const rs2_intrinsics *intrin, const float3 & point) { return pixel_to_texcoord(intrin, project(intrin, point)); }
 
+    // Compute the vertices of a run of depth pixels from their rays and, when texcoords is not null, map them onto the texture
+    // The vectorized variants perform the exact sequence of operations of the rsutil functions and produce identical results
+    typedef void(*points_function)(const uint16_t * depth, const float2 * rays, int count, float depth_scale, float3 * points,
+                                   float2 * texcoords, const rs2_extrinsics & extr, const rs2_intrinsics & mapped);
+
+    template<rs2_distortion MODEL>
+    struct compute_points_kernel
+    {
+        typedef points_function function;
+
+        static void run(const uint16_t * depth, const float2 * rays, int count, float depth_scale, float3 * points,
+                        float2 * texcoords, const rs2_extrinsics & extr, const rs2_intrinsics & mapped)
+        {
+            for (int i = 0; i < count; ++i)
+            {
+                const float z = depth_scale * depth[i];
+                points[i] = { z * rays[i].x, z * rays[i].y, z };
+
+                if (!texcoords) continue;
+                if (z)
+                {
+                    float2 pixel;
+                    auto mapped_point = transform(&extr, points[i]);
+                    project_point_to_pixel<MODEL>(&pixel.x, mapped, &mapped_point.x);
+                    texcoords[i] = pixel_to_texcoord(&mapped, pixel);
+                }
+                else
+                    texcoords[i] = { 0.f, 0.f };
+            }
+        }
+    };
+
+    // The projection model of the texture is chosen once per call, not per point
+    void compute_points_scalar(const uint16_t * depth, const float2 * rays, int count, float depth_scale, float3 * points,
+                               float2 * texcoords, const rs2_extrinsics & extr, const rs2_intrinsics & mapped)
+    {
+        auto kernel = texcoords ? select_projection_kernel<compute_points_kernel>(mapped.model) : &compute_points_kernel<RS2_DISTORTION_NONE>::run;
+        kernel(depth, rays, count, depth_scale, points, texcoords, extr, mapped);
+    }
+
+    // FTHETA projection relies on trigonometric functions and is only handled by the scalar code
+    static bool vectorizable_projection(const rs2_intrinsics & mapped)
+    {
+        return mapped.model != RS2_DISTORTION_FTHETA;
+    }
+
+#ifdef __SSSE3__
+    AVX2_TARGET void compute_points_avx2(const uint16_t * depth, const float2 * rays, int count, float depth_scale, float3 * points,
+                                         float2 * texcoords, const rs2_extrinsics & extr, const rs2_intrinsics & mapped)
+    {
+        __m256 r[9], t[3], k[5];
+        for (int j = 0; j < 9; ++j) r[j] = _mm256_set1_ps(extr.rotation[j]);
+        for (int j = 0; j < 3; ++j) t[j] = _mm256_set1_ps(extr.translation[j]);
+        for (int j = 0; j < 5; ++j) k[j] = _mm256_set1_ps(mapped.coeffs[j]);
+        const __m256 fx = _mm256_set1_ps(mapped.fx), ppx = _mm256_set1_ps(mapped.ppx);
+        const __m256 fy = _mm256_set1_ps(mapped.fy), ppy = _mm256_set1_ps(mapped.ppy);
+        const __m256 width = _mm256_set1_ps(static_cast<float>(mapped.width)), height = _mm256_set1_ps(static_cast<float>(mapped.height));
+        const __m256 scale = _mm256_set1_ps(depth_scale), zero = _mm256_setzero_ps();
+        const __m256 one = _mm256_set1_ps(1.f), two = _mm256_set1_ps(2.f), half = _mm256_set1_ps(0.5f), one_half = _mm256_set1_ps(1.5f);
+        const bool brown = mapped.model == RS2_DISTORTION_MODIFIED_BROWN_CONRADY;
+
+        int i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m256 z = _mm256_mul_ps(scale, _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(depth + i)))));
+
+            // Split the interleaved rays of 8 pixels into their x and y components
+            const __m256 rays0 = _mm256_loadu_ps(&rays[i].x), rays1 = _mm256_loadu_ps(&rays[i + 4].x);
+            const __m256 rx = _mm256_permutevar8x32_ps(_mm256_shuffle_ps(rays0, rays1, _MM_SHUFFLE(2, 0, 2, 0)), _mm256_setr_epi32(0, 1, 4, 5, 2, 3, 6, 7));
+            const __m256 ry = _mm256_permutevar8x32_ps(_mm256_shuffle_ps(rays0, rays1, _MM_SHUFFLE(3, 1, 3, 1)), _mm256_setr_epi32(0, 1, 4, 5, 2, 3, 6, 7));
+            const __m256 p0 = _mm256_mul_ps(z, rx), p1 = _mm256_mul_ps(z, ry);
+
+            alignas(32) float px[8], py[8], pz[8];
+            _mm256_store_ps(px, p0); _mm256_store_ps(py, p1); _mm256_store_ps(pz, z);
+            for (int j = 0; j < 8; ++j) points[i + j] = { px[j], py[j], pz[j] };
+
+            if (!texcoords) continue;
+
+            const __m256 o0 = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(r[0], p0), _mm256_mul_ps(r[3], p1)), _mm256_mul_ps(r[6], z)), t[0]);
+            const __m256 o1 = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(r[1], p0), _mm256_mul_ps(r[4], p1)), _mm256_mul_ps(r[7], z)), t[1]);
+            const __m256 o2 = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(r[2], p0), _mm256_mul_ps(r[5], p1)), _mm256_mul_ps(r[8], z)), t[2]);
+            __m256 x = _mm256_div_ps(o0, o2), y = _mm256_div_ps(o1, o2);
+            if (brown)
+            {
+                const __m256 r2 = _mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y));
+                const __m256 f = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(one, _mm256_mul_ps(k[0], r2)), _mm256_mul_ps(_mm256_mul_ps(k[1], r2), r2)),
+                                               _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(k[4], r2), r2), r2));
+                x = _mm256_mul_ps(x, f);
+                y = _mm256_mul_ps(y, f);
+                const __m256 dx = _mm256_add_ps(_mm256_add_ps(x, _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(two, k[2]), x), y)),
+                                                _mm256_mul_ps(k[3], _mm256_add_ps(r2, _mm256_mul_ps(_mm256_mul_ps(two, x), x))));
+                const __m256 dy = _mm256_add_ps(_mm256_add_ps(y, _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(two, k[3]), x), y)),
+                                                _mm256_mul_ps(k[2], _mm256_add_ps(r2, _mm256_mul_ps(_mm256_mul_ps(two, y), y))));
+                x = dx;
+                y = dy;
+            }
+            const __m256 valid = _mm256_cmp_ps(z, zero, _CMP_NEQ_UQ);
+            const __m256 u = _mm256_and_ps(valid, _mm256_div_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, fx), ppx), one_half), width));
+            const __m256 v = _mm256_and_ps(valid, _mm256_div_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(y, fy), ppy), half), height));
+
+            const __m256 uv_lo = _mm256_unpacklo_ps(u, v), uv_hi = _mm256_unpackhi_ps(u, v);
+            _mm256_storeu_ps(&texcoords[i].x, _mm256_permute2f128_ps(uv_lo, uv_hi, 0x20));
+            _mm256_storeu_ps(&texcoords[i + 4].x, _mm256_permute2f128_ps(uv_lo, uv_hi, 0x31));
+        }
+
+        compute_points_scalar(depth + i, rays + i, count - i, depth_scale, points + i, texcoords ? texcoords + i : nullptr, extr, mapped);
+    }
+#endif
+
+    static points_function select_compute_points()
+    {
+#ifdef __SSSE3__
+        if (cpu_supports(CPU_FEATURE_AVX2)) return &compute_points_avx2;
+#endif
+        return &compute_points_scalar;
+    }
+
+    // Compute the points of the runs of dirty tiles of every row, and copy the others from the previous output
+    static void compute_points_incremental(points_function compute_points, const change_mask & changes, const uint16_t * depth,
+                                           const float2 * rays, float depth_scale, points & previous, float3 * vertices,
+                                           float2 * texcoords, const rs2_extrinsics & extr, const rs2_intrinsics & mapped)
+    {
+        const float3 * previous_vertices = previous.get_vertices();
+        const float2 * previous_texcoords = previous.get_texture_coordinates();
+        for (int y = 0; y < changes.height; ++y)
+        {
+            const int tile_y = y / changes.tile_size;
+            for (int tile_x = 0; tile_x < changes.tiles_x;)
+            {
+                const bool dirty = changes.is_dirty(tile_x, tile_y);
+                int end = tile_x + 1;
+                while (end < changes.tiles_x && changes.is_dirty(end, tile_y) == dirty) ++end;
+
+                const int first = y * changes.width + tile_x * changes.tile_size;
+                const int count = std::min(end * changes.tile_size, changes.width) - tile_x * changes.tile_size;
+                if (dirty)
+                {
+                    compute_points(depth + first, rays + first, count, depth_scale, vertices + first,
+                                   texcoords ? texcoords + first : nullptr, extr, mapped);
+                }
+                else
+                {
+                    memcpy(vertices + first, previous_vertices + first, count * sizeof(float3));
+                    if (texcoords) memcpy(texcoords + first, previous_texcoords + first, count * sizeof(float2));
+                }
+                tile_x = end;
+            }
+        }
+    }
 
      bool pointcloud::stream_changed( stream_profile_interface* old, stream_profile_interface* curr)
      {
@@ -59,6 +211,9 @@ namespace librealsense
             environment::get_instance().get_extrinsics_graph().register_same_extrinsics(*_stream, *depth_frame->get_stream());
             _depth_intrinsics_ptr = nullptr;
             _depth_units_ptr = nullptr;
+
+            // The extrinsics to the mapped stream were fetched for the previous depth stream
+            _invalidate_mapped = true;
         }
 
         bool found_depth_intrinsics = false;
@@ -71,10 +226,23 @@ namespace librealsense
             {
                 _depth_intrinsics = video->get_intrinsics();
                 _depth_intrinsics_ptr = &_depth_intrinsics;
+                _invalidate_rays = true;
                 found_depth_intrinsics = true;
             }
         }
 
+        if (_depth_intrinsics_ptr && _invalidate_rays)
+        {
+            _invalidate_rays = false;
+            auto rays = std::make_shared<depth_rays>();
+            rays->source_width = _depth_intrinsics.width;
+            rays->source_height = _depth_intrinsics.height;
+            rays->sampling = _sampling.create(_depth_intrinsics.width, _depth_intrinsics.height, true);
+            rays->rays.resize(rays->sampling.width * rays->sampling.height);
+            deproject_rays(rays->rays.data(), _depth_intrinsics, rays->sampling);
+            _depth_rays = rays;
+        }
+
         if (!_depth_units_ptr)
         {
             auto sensor = depth_frame->get_sensor();
@@ -128,26 +296,94 @@ namespace librealsense
         }
     }
 
-    void pointcloud::process_depth_frame(const rs2::depth_frame& depth)
+    // IEEE 754 half-precision conversion, rounding to nearest even
+    static uint16_t to_half(float value)
+    {
+        uint32_t f;
+        memcpy(&f, &value, sizeof(f));
+        const uint16_t sign = (f >> 16) & 0x8000;
+        const int exponent = static_cast<int>((f >> 23) & 0xff) - 127 + 15;
+        uint32_t mantissa = f & 0x7fffff;
+
+        if (((f >> 23) & 0xff) == 0xff) return sign | 0x7c00 | (mantissa ? 0x200 : 0); // Infinity and NaN
+        if (exponent >= 31) return sign | 0x7c00;                                      // Overflow
+        if (exponent < -10) return sign;                                               // Underflow
+
+        int shift = 13;
+        uint32_t half = (exponent << 10) | (mantissa >> 13);
+        if (exponent <= 0)
+        {
+            // Subnormal half, the implicit leading bit becomes explicit
+            mantissa |= 0x800000;
+            shift = 14 - exponent;
+            half = mantissa >> shift;
+        }
+        const uint32_t rest = mantissa & ((1u << shift) - 1), halfway = 1u << (shift - 1);
+        if (rest > halfway || (rest == halfway && (half & 1))) ++half; // A carry into the exponent is still correct
+        return static_cast<uint16_t>(sign | half);
+    }
+
+    static int16_t to_millimeters(float meters)
+    {
+        auto mm = std::round(meters * 1000.f);
+        return static_cast<int16_t>(std::max(-32768.f, std::min(32767.f, mm)));
+    }
+
+    // Store the vertices in the requested format, dropping the ones without depth when compacting
+    static void pack_points(const float3 * vertices, const float2 * texcoords, int count, bool compact, rs2_format vertex_format, points * out)
     {
-        frame_holder res = get_source().allocate_points(_stream, (frame_interface*)depth.get());
+        auto dst = reinterpret_cast<byte*>(out->get_vertices());
+        auto tex = out->get_texture_coordinates();
+        auto indices = out->get_pixel_indices();
+
+        for (int i = 0; i < count; ++i)
+        {
+            auto&& v = vertices[i];
+            if (compact && !v.z) continue;
+
+            switch (vertex_format)
+            {
+            case RS2_FORMAT_XYZ16F:
+            {
+                const uint16_t h[] = { to_half(v.x), to_half(v.y), to_half(v.z) };
+                memcpy(dst, h, sizeof(h));
+                dst += sizeof(h);
+                break;
+            }
+            case RS2_FORMAT_XYZ16:
+            {
+                const int16_t mm[] = { to_millimeters(v.x), to_millimeters(v.y), to_millimeters(v.z) };
+                memcpy(dst, mm, sizeof(mm));
+                dst += sizeof(mm);
+                break;
+            }
+            default:
+                memcpy(dst, &v, sizeof(v));
+                dst += sizeof(v);
+            }
 
-        auto pframe = (points*)(res.frame);
+            *tex++ = texcoords ? texcoords[i] : float2{ 0.f, 0.f };
+            if (indices) *indices++ = i;
+        }
+    }
 
+    void pointcloud::process_depth_frame(const rs2::depth_frame& depth)
+    {
         auto depth_data = (const uint16_t*)depth.get_data();
         //auto original_depth = ((depth_frame*)depth.get())->get_original_depth();
         //if (original_depth) depth_data = (const uint16_t*)original_depth->get_frame_data();
 
-        auto points = depth_to_points((uint8_t*)pframe->get_vertices(), *_depth_intrinsics_ptr, depth_data, *_depth_units_ptr);
-
-        auto vid_frame = depth.as<rs2::video_frame>();
-        float2* tex_ptr = pframe->get_texture_coordinates();
-
         rs2_intrinsics mapped_intr;
         rs2_extrinsics extr;
         bool map_texture = false;
+        std::shared_ptr<const depth_rays> rays;
+        std::shared_ptr<stream_profile_interface> stream;
+        float depth_units;
         {
             std::lock_guard<std::mutex> lock(_mutex);
+            rays = _depth_rays;
+            stream = _stream;
+            depth_units = *_depth_units_ptr;
             if (_extrinsics_ptr && _mapped_intrinsics_ptr)
             {
                 mapped_intr = *_mapped_intrinsics_ptr;
@@ -156,32 +392,88 @@ namespace librealsense
             }
         }
 
-        if (map_texture)
+        static const auto compute_points_vectorized = select_compute_points();
+        auto compute_points = (!map_texture || vectorizable_projection(mapped_intr)) ? compute_points_vectorized : &compute_points_scalar;
+        // A frame of the previous depth stream, still in flight when the stream changed, is dropped
+        if (!rays || rays->source_width != depth.get_width() || rays->source_height != depth.get_height()) return;
+        const int count = rays->sampling.width * rays->sampling.height;
+
+        // Only the sampled pixels are processed, gathered into a buffer of their own
+        if (!rays->sampling.is_identity(depth.get_width(), depth.get_height()))
         {
-            auto height = vid_frame.get_height();
-            auto width = vid_frame.get_width();
+            static thread_local std::vector<uint16_t> sampled;
+            sampled.resize(count);
+            rays->sampling.sample(reinterpret_cast<const uint8_t*>(depth_data), depth.get_stride_in_bytes(),
+                                  reinterpret_cast<uint8_t*>(sampled.data()), sizeof(uint16_t));
+            depth_data = sampled.data();
+        }
+
+        static const rs2_format vertex_formats[] = { RS2_FORMAT_XYZ32F, RS2_FORMAT_XYZ16F, RS2_FORMAT_XYZ16 };
+        const auto vertex_format = vertex_formats[_vertex_format];
+        const bool compact = _compact_points != 0;
+        const bool pixel_indices = _compact_points == 2;
 
-            for (int y = 0; y < height; ++y)
+        // The default output is computed straight into the frame
+        if (!compact && vertex_format == RS2_FORMAT_XYZ32F)
+        {
+            frame_holder res = get_source().allocate_points(stream, (frame_interface*)depth.get(), count, vertex_format, false);
+            auto pframe = (points*)(res.frame);
+            auto vertices = pframe->get_vertices();
+            auto texcoords = map_texture ? pframe->get_texture_coordinates() : nullptr;
+
+            // Following a frame of the same change detector processed with the same parameters, only the changed tiles are computed
+            auto changes = rays->sampling.is_identity(depth.get_width(), depth.get_height()) ? get_change_mask(depth) : nullptr;
+            frame_holder previous;
+            if (changes)
             {
-                for (int x = 0; x < width; ++x)
-                {
-                    if (points->z)
-                    {
-                        auto trans = transform(&extr, *points);
-                        auto tex_xy = project_to_texcoord(&mapped_intr, trans);
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (changes->follows(_previous.sequence, depth.get_width(), depth.get_height()) && _previous.rays == rays &&
+                    _previous.depth_units == depth_units && _previous.map_texture == map_texture &&
+                    (!map_texture || (!memcmp(&_previous.mapped_intrinsics, &mapped_intr, sizeof(mapped_intr)) &&
+                                      !memcmp(&_previous.extrinsics, &extr, sizeof(extr)))))
+                    previous = _previous.points.clone();
+            }
 
-                        *tex_ptr = tex_xy;
-                    }
-                    else
-                    {
-                        *tex_ptr = { 0.f, 0.f };
-                    }
-                    ++points;
-                    ++tex_ptr;
+            if (previous)
+                compute_points_incremental(compute_points, *changes, depth_data, rays->rays.data(), depth_units, *(points*)(previous.frame),
+                                           vertices, texcoords, extr, mapped_intr);
+            else
+                compute_points(depth_data, rays->rays.data(), count, depth_units, vertices, texcoords, extr, mapped_intr);
+
+            if (changes)
+            {
+                // Frames in flight may complete out of order, the output of the latest frame is kept
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (changes->sequence > _previous.sequence)
+                {
+                    _previous.points = res.clone();
+                    _previous.sequence = changes->sequence;
+                    _previous.rays = rays;
+                    _previous.depth_units = depth_units;
+                    _previous.map_texture = map_texture;
+                    _previous.mapped_intrinsics = mapped_intr;
+                    _previous.extrinsics = extr;
                 }
             }
+
+            get_source().frame_ready(std::move(res));
+            return;
         }
 
+        // Consecutive frames may be processed concurrently, so every thread has intermediate buffers of its own
+        static thread_local std::vector<float3> vertices;
+        static thread_local std::vector<float2> texcoords;
+        vertices.resize(count);
+        texcoords.resize(count);
+        compute_points(depth_data, rays->rays.data(), count, depth_units,
+                       vertices.data(), map_texture ? texcoords.data() : nullptr, extr, mapped_intr);
+
+        size_t valid = count;
+        if (compact) valid = count - std::count(depth_data, depth_data + count, 0);
+
+        frame_holder res = get_source().allocate_points(stream, (frame_interface*)depth.get(), valid, vertex_format, pixel_indices);
+        pack_points(vertices.data(), map_texture ? texcoords.data() : nullptr, count, compact, vertex_format, (points*)(res.frame));
+
         get_source().frame_ready(std::move(res));
     }
 
@@ -190,8 +482,25 @@ namespace librealsense
         _depth_units_ptr(nullptr),
         _mapped_intrinsics_ptr(nullptr),
         _extrinsics_ptr(nullptr),
-        _mapped(nullptr), _invalidate_mapped(false)
+        _mapped(nullptr), _invalidate_mapped(false),
+        _compact_points(0), _vertex_format(0), _invalidate_rays(false)
     {
+        auto compact_opt = std::make_shared<ptr_option<int>>(0, 2, 1, 0, &_compact_points, "Output only the points with valid depth");
+        compact_opt->set_description(0, "One point per depth pixel");
+        compact_opt->set_description(1, "Valid points only");
+        compact_opt->set_description(2, "Valid points only, with their depth pixel indices");
+        register_option(RS2_OPTION_COMPACT_POINTS, compact_opt);
+
+        auto format_opt = std::make_shared<ptr_option<int>>(0, 2, 1, 0, &_vertex_format, "Storage of the vertex coordinates");
+        format_opt->set_description(0, "32-bit floats, meters");
+        format_opt->set_description(1, "16-bit floats, meters");
+        format_opt->set_description(2, "16-bit integers, millimeters");
+        register_option(RS2_OPTION_VERTEX_FORMAT, format_opt);
+
+        // Points of the sampled pixels only, the pixel indices of compacted points are indices of the sampled pixels
+        _sampling.register_options(*this, [this]() { _invalidate_rays = true; });
+        enable_pipelining();
+
 
         auto mapped_opt = std::make_shared<ptr_option<int>>(0, std::numeric_limits<int>::max(), 1, -1, &_mapped_stream_id, "Mapped stream ID");
         register_option(RS2_OPTION_TEXTURE_SOURCE, mapped_opt);
@@ -3,13 +3,22 @@
 
 #pragma once
 #include "../include/librealsense2/hpp/rs_frame.hpp"
+#include "pixel-sampling.h"
 namespace librealsense
 {
+    // Deprojection at unit depth of the sampled pixels of depth frames of the given size
+    struct depth_rays
+    {
+        int source_width, source_height;
+        pixel_sampling sampling;
+        std::vector<float2> rays;
+    };
 
     class pointcloud : public processing_block
     {
     public:
         pointcloud();
+        ~pointcloud() { flush_pipeline(); }
 
     private:
         std::mutex              _mutex;
@@ -23,12 +32,30 @@ namespace librealsense
         rs2_intrinsics          _mapped_intrinsics;
         float                   _depth_units;
         rs2_extrinsics          _extrinsics;
+        std::shared_ptr<const depth_rays> _depth_rays; // Replaced as a whole while frames may be in flight
+        sampling_options        _sampling;
+        std::atomic_bool        _invalidate_rays;
+        int                     _compact_points;
+        int                     _vertex_format;
         std::atomic_bool        _invalidate_mapped;
 
         std::shared_ptr<stream_profile_interface> _stream, _mapped;
         int                     _mapped_stream_id = -1;
         stream_profile_interface* _depth_stream = nullptr;
 
+        // Latest output computed from a depth frame with a change mask, the clean tiles of the next frame are copied from it
+        struct previous_points
+        {
+            frame_holder points;
+            uint64_t sequence = 0;
+            std::shared_ptr<const depth_rays> rays;
+            float depth_units = 0;
+            bool map_texture = false;
+            rs2_intrinsics mapped_intrinsics;
+            rs2_extrinsics extrinsics;
+        };
+        previous_points         _previous;
+
         void inspect_depth_frame(const rs2::frame& depth);
         void inspect_other_frame(const rs2::frame& other);
         void process_depth_frame(const rs2::depth_frame& depth);
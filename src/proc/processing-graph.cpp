@@ -0,0 +1,434 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#include <algorithm>
+#include <chrono>
+
+#include "archive.h"
+#include "proc/processing-graph.h"
+
+namespace librealsense
+{
+    const double NODE_STATS_SMOOTHING = 0.1; // Weight of the latest frame in the averaged node statistics
+    const double QUALITY_CONTROL_INTERVAL_MS = 250; // Leaves the averaged statistics time to follow the last step
+    const double QUALITY_RECOVERY_MARGIN = 0.5;     // Of the latency target, under which steps are undone
+    const int QUALITY_RECOVERY_EVALUATIONS = 4;     // In a row under the margin before undoing a step
+
+    static double steady_time_ms()
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    class node_output_callback : public rs2_frame_callback
+    {
+        std::function<void(frame_holder)> _on_frame;
+    public:
+        explicit node_output_callback(std::function<void(frame_holder)> on_frame) : _on_frame(std::move(on_frame)) {}
+
+        void on_frame(rs2_frame* f) override { _on_frame(frame_holder((frame_interface*)f)); }
+
+        void release() override { delete this; }
+    };
+
+    processing_graph::processing_graph()
+        : _alive(true), _quality_level(0), _latency_target_ms(0), _last_control(0), _calm_evaluations(0)
+    {
+    }
+
+    processing_graph::~processing_graph()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_graph_mutex);
+            _alive = false;
+            for (auto&& n : _nodes)
+            {
+                n->not_empty.notify_all();
+                n->not_full.notify_all();
+            }
+        }
+        for (auto&& n : _nodes) n->lane.join();
+
+        // The blocks may outlive the graph, and must not deliver into it anymore
+        for (auto&& n : _nodes)
+        {
+            if (auto pb = dynamic_cast<processing_block*>(n->block.get())) pb->flush_pipeline();
+            n->block->set_output_callback(nullptr);
+        }
+    }
+
+    int processing_graph::add_node(std::shared_ptr<processing_block_interface> block, int queue_size, rs2_queue_policy policy)
+    {
+        if (!block)
+            throw invalid_value_exception("Processing graph node requires a processing block");
+        if (block.get() == this)
+            throw invalid_value_exception("Processing graph cannot be a node of itself");
+
+        std::lock_guard<std::mutex> lock(_graph_mutex);
+        auto id = static_cast<int>(_nodes.size());
+
+        std::unique_ptr<node> n(new node());
+        n->block = block;
+        n->queue_size = queue_size;
+        n->policy = policy;
+
+        block->set_output_callback({
+            new node_output_callback([this, id](frame_holder f) { route(id, std::move(f)); }),
+            [](rs2_frame_callback* p) { p->release(); }
+        });
+
+        auto ptr = n.get();
+        n->lane = std::thread([this, ptr]()
+        {
+            thread_registration registration("rs-graph-lane", RS2_THREAD_CLASS_PROCESSING);
+            run_lane(*ptr);
+        });
+        _nodes.push_back(std::move(n));
+        return id;
+    }
+
+    bool processing_graph::reachable(int from, int to) const
+    {
+        if (from == to) return true;
+        for (auto&& e : _nodes[from]->edges)
+            if (reachable(e.to, to)) return true;
+        return false;
+    }
+
+    void processing_graph::connect(int from, int to, rs2_stream stream)
+    {
+        std::lock_guard<std::mutex> lock(_graph_mutex);
+        auto count = static_cast<int>(_nodes.size());
+        if (from < 0 || from >= count || to < 0 || to >= count)
+            throw invalid_value_exception(to_string() << "Processing graph has no node " << (from < 0 || from >= count ? from : to));
+        if (reachable(to, from))
+            throw invalid_value_exception(to_string() << "Connecting node " << from << " to node " << to << " would create a cycle");
+
+        _nodes[from]->edges.push_back({ to, stream });
+        _nodes[to]->has_inputs = true;
+    }
+
+    rs2_processing_node_stats processing_graph::get_node_stats(int id) const
+    {
+        std::lock_guard<std::mutex> lock(_graph_mutex);
+        if (id < 0 || id >= static_cast<int>(_nodes.size()))
+            throw invalid_value_exception(to_string() << "Processing graph has no node " << id);
+
+        auto&& n = *_nodes[id];
+        rs2_processing_node_stats stats;
+        stats.processed = n.processed;
+        stats.dropped = n.dropped;
+        stats.queue_depth = static_cast<int>(n.queue.size());
+        stats.fps = n.interval_ms > 0 ? static_cast<float>(1000. / n.interval_ms) : 0.f;
+        stats.processing_ms = static_cast<float>(n.processing_ms);
+        return stats;
+    }
+
+    void processing_graph::set_latency_target(float latency_ms)
+    {
+        if (latency_ms < 0)
+            throw invalid_value_exception(to_string() << "Invalid latency target " << latency_ms);
+
+        std::lock_guard<std::mutex> lock(_graph_mutex);
+        _latency_target_ms = latency_ms;
+        _calm_evaluations = 0;
+    }
+
+    void processing_graph::add_option_step(int id, rs2_option option, float value)
+    {
+        std::lock_guard<std::mutex> lock(_graph_mutex);
+        if (id < 0 || id >= static_cast<int>(_nodes.size()))
+            throw invalid_value_exception(to_string() << "Processing graph has no node " << id);
+
+        auto options = dynamic_cast<options_interface*>(_nodes[id]->block.get());
+        if (!options || !options->supports_option(option))
+            throw invalid_value_exception(to_string() << "Block of node " << id << " does not support option " << option);
+        auto range = options->get_option(option).get_range();
+        if (value < range.min || value > range.max)
+            throw invalid_value_exception(to_string() << "Value " << value << " is out of the range of option " << option);
+
+        _ladder.push_back({ id, option, value, 0.f });
+    }
+
+    void processing_graph::add_rate_step(int id, int divisor)
+    {
+        std::lock_guard<std::mutex> lock(_graph_mutex);
+        if (id < 0 || id >= static_cast<int>(_nodes.size()))
+            throw invalid_value_exception(to_string() << "Processing graph has no node " << id);
+        if (divisor < 1)
+            throw invalid_value_exception(to_string() << "Invalid rate divisor " << divisor);
+
+        _ladder.push_back({ id, RS2_OPTION_COUNT, static_cast<float>(divisor), 1.f });
+    }
+
+    int processing_graph::get_quality_level() const
+    {
+        std::lock_guard<std::mutex> lock(_graph_mutex);
+        return static_cast<int>(_quality_level);
+    }
+
+    void processing_graph::set_node_priority(int id, int priority, float deadline_ms)
+    {
+        if (deadline_ms < 0)
+            throw invalid_value_exception(to_string() << "Invalid deadline " << deadline_ms);
+
+        std::lock_guard<std::mutex> lock(_graph_mutex);
+        if (id < 0 || id >= static_cast<int>(_nodes.size()))
+            throw invalid_value_exception(to_string() << "Processing graph has no node " << id);
+
+        _nodes[id]->priority = priority;
+        _nodes[id]->deadline_ms = deadline_ms;
+    }
+
+    // Time a frame entering the node spends in the graph on its slowest path, from the queue depths and the
+    // processing times of the nodes
+    double processing_graph::path_latency(int from) const
+    {
+        auto&& n = *_nodes[from];
+        double downstream = 0;
+        for (auto&& e : n.edges)
+            downstream = std::max(downstream, path_latency(e.to));
+        return (n.queue.size() + 1) * n.processing_ms + downstream;
+    }
+
+    void processing_graph::control_quality()
+    {
+        std::unique_lock<std::mutex> lock(_graph_mutex);
+        if (_latency_target_ms <= 0 || _ladder.empty()) return;
+
+        auto now = steady_time_ms();
+        if (now - _last_control < QUALITY_CONTROL_INTERVAL_MS) return;
+        _last_control = now;
+
+        double latency = 0;
+        for (int i = 0; i < static_cast<int>(_nodes.size()); i++)
+            if (!_nodes[i]->has_inputs) latency = std::max(latency, path_latency(i));
+
+        size_t index;
+        bool degrade = latency > _latency_target_ms;
+        if (degrade)
+        {
+            _calm_evaluations = 0;
+            if (_quality_level == _ladder.size()) return;
+            index = _quality_level++;
+        }
+        else if (_quality_level > 0 && latency < _latency_target_ms * QUALITY_RECOVERY_MARGIN)
+        {
+            if (++_calm_evaluations < QUALITY_RECOVERY_EVALUATIONS) return;
+            _calm_evaluations = 0;
+            index = --_quality_level;
+        }
+        else
+        {
+            _calm_evaluations = 0;
+            return;
+        }
+
+        auto step = _ladder[index];
+        auto&& n = *_nodes[step.node];
+        LOG_DEBUG("Processing graph latency " << latency << "ms, " << (degrade ? "applying" : "undoing") << " quality step " << index);
+        if (step.option == RS2_OPTION_COUNT)
+        {
+            if (degrade) _ladder[index].restored = static_cast<float>(n.rate_divisor);
+            n.rate_divisor = static_cast<int>(degrade ? step.value : step.restored);
+            return;
+        }
+
+        // Options are set outside the lock, the blocks may take their own locks and deliver frames meanwhile
+        auto block = n.block;
+        lock.unlock();
+        try
+        {
+            auto&& opt = dynamic_cast<options_interface&>(*block).get_option(step.option);
+            if (degrade)
+            {
+                auto restored = opt.query();
+                opt.set(step.value);
+                lock.lock();
+                _ladder[index].restored = restored;
+            }
+            else
+            {
+                opt.set(step.restored);
+            }
+        }
+        catch (const std::exception& ex)
+        {
+            LOG_WARNING("Processing graph failed to change option " << step.option << " of node " << step.node << ": " << ex.what());
+        }
+    }
+
+    void processing_graph::invoke(frame_holder frame)
+    {
+        control_quality();
+
+        std::vector<node*> roots;
+        {
+            std::lock_guard<std::mutex> lock(_graph_mutex);
+            for (auto&& n : _nodes)
+                if (!n->has_inputs) roots.push_back(n.get());
+        }
+
+        if (roots.empty())
+        {
+            _source.invoke_callback(std::move(frame));
+            return;
+        }
+
+        for (size_t i = 1; i < roots.size(); i++) push(*roots[i], frame.clone());
+        push(*roots.front(), std::move(frame));
+    }
+
+    void processing_graph::push(node& n, frame_holder frame)
+    {
+        queued_frame dropped;
+        std::unique_lock<std::mutex> lock(_graph_mutex);
+        if (n.rate_divisor > 1 && ++n.arrivals % n.rate_divisor != 0)
+            return;
+        if (n.queue.size() >= static_cast<size_t>(n.queue_size))
+        {
+            switch (n.policy)
+            {
+            case RS2_QUEUE_POLICY_BLOCK:
+                n.not_full.wait(lock, [&]() { return !_alive || n.queue.size() < static_cast<size_t>(n.queue_size); });
+                if (!_alive) return;
+                break;
+            case RS2_QUEUE_POLICY_DROP_NEWEST:
+                n.dropped++;
+                lock.unlock();
+                return;
+            default:
+                dropped = std::move(n.queue.front());
+                n.queue.pop_front();
+                n.dropped++;
+                break;
+            }
+        }
+        n.queue.push_back({ std::move(frame), steady_time_ms() });
+        n.not_empty.notify_one();
+        lock.unlock();
+    }
+
+    void processing_graph::route(int from, frame_holder frame)
+    {
+        std::vector<std::pair<node*, rs2_stream>> targets;
+        {
+            std::lock_guard<std::mutex> lock(_graph_mutex);
+            for (auto&& e : _nodes[from]->edges)
+                targets.push_back({ _nodes[e.to].get(), e.stream });
+        }
+
+        if (targets.empty())
+        {
+            _source.invoke_callback(std::move(frame));
+            return;
+        }
+
+        for (auto&& t : targets)
+        {
+            auto stream = t.second;
+            frame_holder f;
+            if (stream == RS2_STREAM_ANY)
+            {
+                f = frame.clone();
+            }
+            else if (auto composite = dynamic_cast<composite_frame*>(frame.frame))
+            {
+                for (size_t i = 0; i < composite->get_embedded_frames_count(); i++)
+                {
+                    auto embedded = composite->get_frame(static_cast<int>(i));
+                    if (embedded->get_stream()->get_stream_type() == stream)
+                    {
+                        embedded->acquire();
+                        f = frame_holder(embedded);
+                        break;
+                    }
+                }
+            }
+            else if (frame->get_stream()->get_stream_type() == stream)
+            {
+                f = frame.clone();
+            }
+
+            if (f) push(*t.first, std::move(f));
+        }
+    }
+
+    void processing_graph::run_lane(node& n)
+    {
+        std::unique_lock<std::mutex> lock(_graph_mutex);
+        while (true)
+        {
+            n.not_empty.wait(lock, [&]() { return !_alive || !n.queue.empty(); });
+            if (!_alive) return;
+
+            auto f = std::move(n.queue.front());
+            n.queue.pop_front();
+            n.not_full.notify_one();
+            if (n.deadline_ms > 0 && steady_time_ms() - f.enqueued > n.deadline_ms)
+            {
+                n.dropped++;
+                lock.unlock();
+                f.frame = frame_holder();
+                lock.lock();
+                _idle_cv.notify_all();
+                continue;
+            }
+            n.busy = true;
+            auto priority = n.priority;
+            lock.unlock();
+
+            auto start = steady_time_ms();
+            try
+            {
+                worker_pool::priority_scope scope(priority);
+                n.block->invoke(std::move(f.frame));
+            }
+            catch (const std::exception& ex)
+            {
+                LOG_ERROR("Processing graph node failed: " << ex.what());
+            }
+            auto done = steady_time_ms();
+
+            lock.lock();
+            n.busy = false;
+            n.processed++;
+            if (n.last_done > 0)
+                n.interval_ms += NODE_STATS_SMOOTHING * ((done - n.last_done) - n.interval_ms);
+            n.processing_ms += NODE_STATS_SMOOTHING * ((done - start) - n.processing_ms);
+            n.last_done = done;
+            _idle_cv.notify_all();
+        }
+    }
+
+    void processing_graph::flush()
+    {
+        // Nodes delivering their output asynchronously from the worker threads are flushed as well,
+        // until no frame is left anywhere in the graph
+        while (true)
+        {
+            std::vector<std::shared_ptr<processing_block_interface>> blocks;
+            {
+                std::unique_lock<std::mutex> lock(_graph_mutex);
+                auto idle = [this]()
+                {
+                    for (auto&& n : _nodes)
+                        if (n->busy || !n->queue.empty()) return false;
+                    return true;
+                };
+                _idle_cv.wait(lock, [&]() { return !_alive || idle(); });
+                if (!_alive) return;
+
+                for (auto&& n : _nodes) blocks.push_back(n->block);
+            }
+
+            for (auto&& b : blocks)
+                if (auto pb = dynamic_cast<processing_block*>(b.get())) pb->flush_pipeline();
+
+            std::lock_guard<std::mutex> lock(_graph_mutex);
+            auto idle = true;
+            for (auto&& n : _nodes)
+                if (n->busy || !n->queue.empty()) idle = false;
+            if (idle) return;
+        }
+    }
+}
@@ -0,0 +1,115 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <thread>
+#include <vector>
+
+#include "synthetic-stream.h"
+
+namespace librealsense
+{
+    // Runs a set of processing blocks connected by stream edges. Every node owns an execution lane, a thread
+    // draining a bounded queue of input frames, so consecutive stages work on consecutive frames concurrently
+    // Frames passed to the graph enter the nodes without incoming edges, and the output of the nodes without
+    // outgoing edges is the output of the graph
+    class processing_graph : public processing_block
+    {
+    public:
+        processing_graph();
+        ~processing_graph();
+
+        // Add a node running the block on its own lane. The block must not be started or invoked on its own afterwards
+        int add_node(std::shared_ptr<processing_block_interface> block, int queue_size, rs2_queue_policy policy);
+
+        // Forward the frames of the given stream type produced by one node to another, RS2_STREAM_ANY forwards everything
+        void connect(int from, int to, rs2_stream stream);
+
+        rs2_processing_node_stats get_node_stats(int node) const;
+
+        // Hold the latency of the graph under the target by walking a ladder of quality steps, 0 disables the controller
+        // Steps are applied in the order they were added while the latency is over the target, and undone in reverse
+        // once it stays well under it
+        void set_latency_target(float latency_ms);
+        void add_option_step(int node, rs2_option option, float value);
+        void add_rate_step(int node, int divisor);    // Pass only one of every divisor frames arriving at the node
+        int get_quality_level() const;                // Number of steps applied
+
+        // Work of nodes of a higher priority is picked first by the shared worker pool, and frames waiting for a node
+        // longer than its deadline are dropped instead of processed late. A deadline of 0 never drops
+        void set_node_priority(int node, int priority, float deadline_ms);
+
+        void invoke(frame_holder frame) override;
+
+        // Wait until every frame passed to the graph so far went through all the nodes
+        void flush();
+
+    private:
+        struct edge
+        {
+            int to;
+            rs2_stream stream;
+        };
+
+        struct quality_step
+        {
+            int node;
+            rs2_option option;      // RS2_OPTION_COUNT for rate steps
+            float value;
+            float restored;         // Value before the step was applied
+        };
+
+        struct queued_frame
+        {
+            frame_holder frame;
+            double enqueued;
+        };
+
+        struct node
+        {
+            std::shared_ptr<processing_block_interface> block;
+            std::vector<edge> edges;
+            bool has_inputs = false;
+
+            std::deque<queued_frame> queue;
+            int queue_size = 1;
+            rs2_queue_policy policy = RS2_QUEUE_POLICY_DROP_OLDEST;
+            int rate_divisor = 1;
+            unsigned long long arrivals = 0;
+            int priority = 0;
+            double deadline_ms = 0;
+            bool busy = false;
+            std::condition_variable not_empty;
+            std::condition_variable not_full;
+            std::thread lane;
+
+            unsigned long long processed = 0;
+            unsigned long long dropped = 0;
+            double last_done = 0;
+            double interval_ms = 0;   // Exponential averages of the time between outputs and of the time per frame
+            double processing_ms = 0;
+        };
+
+        void push(node& n, frame_holder frame);
+        void route(int from, frame_holder frame);
+        void run_lane(node& n);
+        bool reachable(int from, int to) const;
+        double path_latency(int from) const;
+        void control_quality();
+
+        std::vector<std::unique_ptr<node>> _nodes;
+        mutable std::mutex _graph_mutex;
+        std::condition_variable _idle_cv;
+        bool _alive;
+
+        std::vector<quality_step> _ladder;
+        size_t _quality_level;
+        double _latency_target_ms;
+        double _last_control;
+        int _calm_evaluations;
+    };
+}
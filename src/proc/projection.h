@@ -0,0 +1,87 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "../include/librealsense2/h/rs_types.h"
+
+#include <math.h>
+
+namespace librealsense
+{
+    // The rsutil projection and deprojection functions with the distortion model fixed at compile time, so loops
+    // over the pixels of a frame choose the model once and run without branching on it. Every model performs the
+    // exact operations of the rsutil functions and produces identical results
+
+    // Models rs2_project_point_to_pixel tells apart, the others project as undistorted
+    inline rs2_distortion get_projection_model(rs2_distortion model)
+    {
+        return model == RS2_DISTORTION_MODIFIED_BROWN_CONRADY || model == RS2_DISTORTION_FTHETA ? model : RS2_DISTORTION_NONE;
+    }
+
+    // Models rs2_deproject_pixel_to_point tells apart, the others deproject as undistorted
+    inline rs2_distortion get_deprojection_model(rs2_distortion model)
+    {
+        return model == RS2_DISTORTION_INVERSE_BROWN_CONRADY ? model : RS2_DISTORTION_NONE;
+    }
+
+    template<rs2_distortion MODEL>
+    inline void project_point_to_pixel(float pixel[2], const rs2_intrinsics & intrin, const float point[3])
+    {
+        float x = point[0] / point[2], y = point[1] / point[2];
+
+        if (MODEL == RS2_DISTORTION_MODIFIED_BROWN_CONRADY)
+        {
+            float r2 = x*x + y*y;
+            float f = 1 + intrin.coeffs[0]*r2 + intrin.coeffs[1]*r2*r2 + intrin.coeffs[4]*r2*r2*r2;
+            x *= f;
+            y *= f;
+            float dx = x + 2*intrin.coeffs[2]*x*y + intrin.coeffs[3]*(r2 + 2*x*x);
+            float dy = y + 2*intrin.coeffs[3]*x*y + intrin.coeffs[2]*(r2 + 2*y*y);
+            x = dx;
+            y = dy;
+        }
+        if (MODEL == RS2_DISTORTION_FTHETA)
+        {
+            float r = sqrt(x*x + y*y);
+            auto rd = (1.0f / intrin.coeffs[0] * atan(2 * r* tan(intrin.coeffs[0] / 2.0f)));
+            x *= rd / r;
+            y *= rd / r;
+        }
+
+        pixel[0] = x * intrin.fx + intrin.ppx;
+        pixel[1] = y * intrin.fy + intrin.ppy;
+    }
+
+    template<rs2_distortion MODEL>
+    inline void deproject_pixel_to_point(float point[3], const rs2_intrinsics & intrin, const float pixel[2], float depth)
+    {
+        float x = (pixel[0] - intrin.ppx) / intrin.fx;
+        float y = (pixel[1] - intrin.ppy) / intrin.fy;
+        if (MODEL == RS2_DISTORTION_INVERSE_BROWN_CONRADY)
+        {
+            float r2 = x*x + y*y;
+            float f = 1 + intrin.coeffs[0]*r2 + intrin.coeffs[1]*r2*r2 + intrin.coeffs[4]*r2*r2*r2;
+            float ux = x*f + 2*intrin.coeffs[2]*x*y + intrin.coeffs[3]*(r2 + 2*x*x);
+            float uy = y*f + 2*intrin.coeffs[3]*x*y + intrin.coeffs[2]*(r2 + 2*y*y);
+            x = ux;
+            y = uy;
+        }
+        point[0] = depth * x;
+        point[1] = depth * y;
+        point[2] = depth;
+    }
+
+    // Instance of a kernel template for the projection model of the intrinsics, as given by get_projection_model
+    // KERNEL<MODEL>::run is a function, so the function pointer returned is chosen once and called per row or run
+    template<template<rs2_distortion> class KERNEL>
+    typename KERNEL<RS2_DISTORTION_NONE>::function select_projection_kernel(rs2_distortion model)
+    {
+        switch (get_projection_model(model))
+        {
+        case RS2_DISTORTION_MODIFIED_BROWN_CONRADY: return &KERNEL<RS2_DISTORTION_MODIFIED_BROWN_CONRADY>::run;
+        case RS2_DISTORTION_FTHETA: return &KERNEL<RS2_DISTORTION_FTHETA>::run;
+        default: return &KERNEL<RS2_DISTORTION_NONE>::run;
+        }
+    }
+}
@@ -10,6 +10,16 @@
 #include "context.h"
 #include "proc/synthetic-stream.h"
 #include "proc/spatial-filter.h"
+#include "cpu-features.h"
+
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define SPATIAL_USE_NEON
+#endif
 
 
 namespace librealsense
@@ -62,6 +72,7 @@ namespace librealsense
         register_option(RS2_OPTION_FILTER_MAGNITUDE, spatial_filter_iterations);
 
         unregister_option(RS2_OPTION_FRAMES_QUEUE_SIZE);
+        set_in_place_processing(true);
 
         auto on_frame = [this](rs2::frame f, const rs2::frame_source& source)
         {
@@ -72,14 +83,11 @@ namespace librealsense
             depth = (composite) ? f.as<rs2::frameset>().first_or_default(RS2_STREAM_DEPTH) : f;
             if (depth) // Processing required
             {
-                update_configuration(f);
+                configure_stage(depth.get_profile());
                 tgt = prepare_target_frame(depth, source);
 
-                // Spatial smooth with domain transform filter
-                dxf_smooth(static_cast<uint16_t*>(const_cast<void*>(tgt.get_data())),
-                    this->_spatial_alpha_param,
-                    this->_spatial_delta_param,
-                    this->_spatial_iterations);
+                auto data = static_cast<uint16_t*>(const_cast<void*>(tgt.get_data()));
+                run_stage(data, data);
             }
 
             out = composite ? source.allocate_composite_frame({ tgt }) : tgt;
@@ -91,15 +99,30 @@ namespace librealsense
         processing_block::set_processing_callback(std::shared_ptr<rs2_frame_processor_callback>(callback));
     }
 
-    void  spatial_filter::update_configuration(const rs2::frame& f)
+    rs2::stream_profile spatial_filter::configure_stage(const rs2::stream_profile& input)
     {
-        if (f.get_profile().get() != _source_stream_profile.get())
+        update_configuration(input);
+        return _target_stream_profile;
+    }
+
+    void spatial_filter::run_stage(const uint16_t* input, uint16_t* output)
+    {
+        if (input != output)
+            memcpy(output, input, _current_frm_size_pixels * 2); // Z16-specific
+
+        // Spatial smooth with domain transform filter
+        dxf_smooth(output, _spatial_alpha_param, _spatial_delta_param, _spatial_iterations);
+    }
+
+    void  spatial_filter::update_configuration(const rs2::stream_profile& profile)
+    {
+        if (profile.get() != _source_stream_profile.get())
         {
-            _source_stream_profile = f.get_profile();
-            _target_stream_profile = _source_stream_profile.clone(RS2_STREAM_DEPTH, 0, RS2_FORMAT_Z16);
+            _source_stream_profile = profile;
+            _target_stream_profile = _source_stream_profile.clone(RS2_STREAM_DEPTH, 0, _source_stream_profile.format());
 
             environment::get_instance().get_extrinsics_graph().register_same_extrinsics(
-                *(stream_interface*)(f.get_profile().get()->profile),
+                *(stream_interface*)(profile.get()->profile),
                 *(stream_interface*)(_target_stream_profile.get()->profile));
 
             auto vp = _target_stream_profile.as<rs2::video_stream_profile>();
@@ -120,7 +143,9 @@ namespace librealsense
             vf.get_stride_in_bytes(),
             RS2_EXTENSION_DEPTH_FRAME);
 
-        memmove(const_cast<void*>(tgt.get_data()), f.get_data(), _current_frm_size_pixels * 2); // Z16-specific
+        // In-place processing hands the source frame back as the target
+        if (tgt.get_data() != f.get_data())
+            memmove(const_cast<void*>(tgt.get_data()), f.get_data(), _current_frm_size_pixels * 2); // Z16-specific
         return tgt;
     }
 
@@ -134,83 +159,177 @@ namespace librealsense
         return true;
     }
 
-    void  spatial_filter::recursive_filter_horizontal(uint16_t *image, float alpha, float deltaZ)
+    // Left to right then right to left recursion over one row. Rows are independent of each other
+    static void filter_row(uint16_t * row, int width, float alpha, float deltaZ)
     {
-        int32_t v{}, u{};
+        // left to right
+        unsigned short *im = row;
+        unsigned short val0 = im[0];
+        for (int u = 1; u < width; u++) {
+            unsigned short val1 = im[1];
+            int delta = val0 - val1;
+            if (delta < deltaZ && delta > -deltaZ) {
+                float filtered = val1 * alpha + val0 * (1.0f - alpha);
+                val0 = (unsigned short)(filtered + 0.5f);
+                im[1] = val0;
+            }
+            im += 1;
+        }
 
-        for (v = 0; v < _height; v++) {
-            // left to right
-            unsigned short *im = image + v * _width;
+        // right to left
+        im = row + width - 2;  // end of row - two pixels
+        unsigned short val1 = im[1];
+        for (int u = width - 1; u > 0; u--) {
             unsigned short val0 = im[0];
-            for (u = 1; u < _width; u++) {
-                unsigned short val1 = im[1];
-                int delta = val0 - val1;
-                if (delta < deltaZ && delta > -deltaZ) {
-                    float filtered = val1 * alpha + val0 * (1.0f - alpha);
-                    val0 = (unsigned short)(filtered + 0.5f);
-                    im[1] = val0;
-                }
-                im += 1;
+            int delta = val0 - val1;
+            if (delta && delta < deltaZ && delta > -deltaZ) {
+                float filtered = val0 * alpha + val1 * (1.0f - alpha);
+                val1 = (unsigned short)(filtered + 0.5f);
+                im[0] = val1;
             }
+            im -= 1;
+        }
+    }
 
-            // right to left
-            im = image + (v + 1) * _width - 2;  // end of row - two pixels
-            unsigned short val1 = im[1];
-            for (u = _width - 1; u > 0; u--) {
-                unsigned short val0 = im[0];
-                int delta = val0 - val1;
-                if (delta && delta < deltaZ && delta > -deltaZ) {
-                    float filtered = val0 * alpha + val1 * (1.0f - alpha);
-                    val1 = (unsigned short)(filtered + 0.5f);
-                    im[0] = val1;
+    // One step of the vertical recursion: filters count adjacent pixels of a row against the already filtered
+    // pixels of the row above (going down) or below (going up). Going down, equal depths are left untouched
+    typedef void(*filter_step_function)(uint16_t * target, const uint16_t * source, int count, float alpha, float deltaZ, bool down);
+
+    static void filter_step_scalar(uint16_t * target, const uint16_t * source, int count, float alpha, float deltaZ, bool down)
+    {
+        for (int u = 0; u < count; u++) {
+            unsigned short im0 = source[u];
+            unsigned short imw = target[u];
+
+            if (im0 && imw) {
+                int delta = im0 - imw;
+                if ((delta || !down) && delta < deltaZ && delta > -deltaZ) {
+                    float filtered = imw * alpha + im0 * (1.0f - alpha);
+                    target[u] = (unsigned short)(filtered + 0.5f);
                 }
-                im -= 1;
             }
         }
     }
 
-    void spatial_filter::recursive_filter_vertical(uint16_t *image, float alpha, float deltaZ)
+#ifdef __SSSE3__
+    static void filter_step_sse(uint16_t * target, const uint16_t * source, int count, float alpha, float deltaZ, bool down)
     {
-        int32_t v{}, u{};
+        const __m128 a = _mm_set1_ps(alpha), b = _mm_set1_ps(1.0f - alpha), half = _mm_set1_ps(0.5f), dz = _mm_set1_ps(deltaZ);
+        const __m128i zero = _mm_setzero_si128(), bias = _mm_set1_epi32(0x8000), sign = _mm_set1_epi16((short)0x8000);
+        const __m128i keep_equal = down ? zero : _mm_set1_epi32(-1);
 
-        // we'll do one row at a time, top to bottom, then bottom to top
+        // Same operations in the same order as the scalar code, so the results are identical
+        int u = 0;
+        for (; u + 8 <= count; u += 8)
+        {
+            const __m128i src = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + u));
+            const __m128i tgt = _mm_loadu_si128(reinterpret_cast<const __m128i *>(target + u));
 
-        // top to bottom
+            __m128i res[2];
+            for (int k = 0; k < 2; k++)
+            {
+                const __m128i im0 = k ? _mm_unpackhi_epi16(src, zero) : _mm_unpacklo_epi16(src, zero);
+                const __m128i imw = k ? _mm_unpackhi_epi16(tgt, zero) : _mm_unpacklo_epi16(tgt, zero);
+                const __m128i delta = _mm_sub_epi32(im0, imw);
 
-        unsigned short *im = image;
-        for (v = 1; v < _height; v++) {
-            for (u = 0; u < _width; u++) {
-                unsigned short im0 = im[0];
-                unsigned short imw = im[_width];
+                const __m128i invalid = _mm_or_si128(_mm_cmpeq_epi32(im0, zero), _mm_cmpeq_epi32(imw, zero));
+                const __m128i equal = _mm_andnot_si128(keep_equal, _mm_cmpeq_epi32(delta, zero));
+                const __m128i close = _mm_castps_si128(_mm_cmplt_ps(_mm_cvtepi32_ps(_mm_abs_epi32(delta)), dz));
+                const __m128i mask = _mm_andnot_si128(_mm_or_si128(invalid, equal), close);
 
-                if (im0 && imw) {
-                    int delta = im0 - imw;
-                    if (delta && delta < deltaZ && delta > -deltaZ) {
-                        float filtered = imw * alpha + im0 * (1.0f - alpha);
-                        im[_width] = (unsigned short)(filtered + 0.5f);
-                    }
-                }
-                im += 1;
+                const __m128 filtered = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(imw), a), _mm_mul_ps(_mm_cvtepi32_ps(im0), b)), half);
+                res[k] = _mm_or_si128(_mm_and_si128(mask, _mm_cvttps_epi32(filtered)), _mm_andnot_si128(mask, imw));
             }
+
+            // Unsigned 32 to 16 bit narrowing through the signed saturating pack
+            const __m128i packed = _mm_packs_epi32(_mm_sub_epi32(res[0], bias), _mm_sub_epi32(res[1], bias));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(target + u), _mm_xor_si128(packed, sign));
         }
+        filter_step_scalar(target + u, source + u, count - u, alpha, deltaZ, down);
+    }
+#endif
 
-        // bottom to top
-        im = image + (_height - 2) * _width;
-        for (v = 1; v < _height; v++, im -= (_width * 2)) {
-            for (u = 0; u < _width; u++) {
-                unsigned short  im0 = im[0];
-                unsigned short  imw = im[_width];
-
-                if (im0 && imw) {
-                    int delta = im0 - imw;
-                    if (delta < deltaZ && delta > -deltaZ) {
-                        float filtered = im0 * alpha + imw * (1.0f - alpha);
-                        im[0] = (unsigned short)(filtered + 0.5f);
-                    }
-                }
-                im += 1;
+#ifdef SPATIAL_USE_NEON
+    static void filter_step_neon(uint16_t * target, const uint16_t * source, int count, float alpha, float deltaZ, bool down)
+    {
+        const float32x4_t a = vdupq_n_f32(alpha), b = vdupq_n_f32(1.0f - alpha), half = vdupq_n_f32(0.5f), dz = vdupq_n_f32(deltaZ);
+        const uint32x4_t keep_equal = vdupq_n_u32(down ? 0 : 0xffffffff);
+
+        // Separate multiplies and adds, a fused multiply-add would round differently from the scalar code
+        int u = 0;
+        for (; u + 8 <= count; u += 8)
+        {
+            const uint16x8_t src = vld1q_u16(source + u);
+            const uint16x8_t tgt = vld1q_u16(target + u);
+
+            uint32x4_t res[2];
+            for (int k = 0; k < 2; k++)
+            {
+                const uint32x4_t im0 = vmovl_u16(k ? vget_high_u16(src) : vget_low_u16(src));
+                const uint32x4_t imw = vmovl_u16(k ? vget_high_u16(tgt) : vget_low_u16(tgt));
+                const int32x4_t delta = vsubq_s32(vreinterpretq_s32_u32(im0), vreinterpretq_s32_u32(imw));
+
+                const uint32x4_t valid = vandq_u32(vtstq_u32(im0, im0), vtstq_u32(imw, imw));
+                const uint32x4_t differ = vorrq_u32(vmvnq_u32(vceqq_u32(im0, imw)), keep_equal);
+                const uint32x4_t close = vcltq_f32(vcvtq_f32_s32(vabsq_s32(delta)), dz);
+                const uint32x4_t mask = vandq_u32(vandq_u32(valid, differ), close);
+
+                const float32x4_t filtered = vaddq_f32(vaddq_f32(vmulq_f32(vcvtq_f32_u32(imw), a), vmulq_f32(vcvtq_f32_u32(im0), b)), half);
+                res[k] = vbslq_u32(mask, vcvtq_u32_f32(filtered), imw);
             }
+            vst1q_u16(target + u, vcombine_u16(vmovn_u32(res[0]), vmovn_u32(res[1])));
         }
+        filter_step_scalar(target + u, source + u, count - u, alpha, deltaZ, down);
+    }
+#endif
+
+    static filter_step_function select_filter_step()
+    {
+#ifdef __SSSE3__
+        if (cpu_supports(CPU_FEATURE_SSSE3)) return &filter_step_sse;
+#endif
+#ifdef SPATIAL_USE_NEON
+        if (cpu_supports(CPU_FEATURE_NEON)) return &filter_step_neon;
+#endif
+        return &filter_step_scalar;
+    }
+
+    void  spatial_filter::recursive_filter_horizontal(uint16_t *image, float alpha, float deltaZ)
+    {
+        // Rows are split into one band per thread
+        auto&& pool = environment::get_instance().get_worker_pool();
+        const int width = static_cast<int>(_width), height = static_cast<int>(_height);
+        const int bands = std::min<int>(height, static_cast<int>(pool.size()) + 1);
+
+        pool.run(bands, [&](int band)
+        {
+            for (int v = height * band / bands; v < height * (band + 1) / bands; v++)
+                filter_row(image + v * width, width, alpha, deltaZ);
+        });
+    }
+
+    void spatial_filter::recursive_filter_vertical(uint16_t *image, float alpha, float deltaZ)
+    {
+        static const auto filter_step = select_filter_step();
+
+        // Columns are independent of each other, so the image is split into tiles of columns small enough
+        // for all their rows to stay in cache for both directions, and the tiles are spread over the threads
+        const int tile_width = 64;
+        const int width = static_cast<int>(_width), height = static_cast<int>(_height);
+        const int tiles = (width + tile_width - 1) / tile_width;
+
+        environment::get_instance().get_worker_pool().run(tiles, [&](int tile)
+        {
+            const int x = tile * tile_width, count = std::min(tile_width, width - x);
+
+            // top to bottom
+            for (int v = 1; v < height; v++)
+                filter_step(image + v * width + x, image + (v - 1) * width + x, count, alpha, deltaZ, true);
+
+            // bottom to top
+            for (int v = height - 2; v >= 0; v--)
+                filter_step(image + v * width + x, image + (v + 1) * width + x, count, alpha, deltaZ, false);
+        });
     }
 
 }
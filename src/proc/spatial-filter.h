@@ -8,16 +8,20 @@
 
 #include "../include/librealsense2/hpp/rs_frame.hpp"
 #include "../include/librealsense2/hpp/rs_processing.hpp"
+#include "filter-chain.h"
 
 namespace librealsense
 {
-    class spatial_filter : public processing_block
+    class spatial_filter : public processing_block, public depth_filter_stage
     {
     public:
         spatial_filter();
 
+        rs2::stream_profile configure_stage(const rs2::stream_profile& input) override;
+        void run_stage(const uint16_t* input, uint16_t* output) override;
+
     protected:
-        void    update_configuration(const rs2::frame& f);
+        void    update_configuration(const rs2::stream_profile& profile);
 
         rs2::frame prepare_target_frame(const rs2::frame& f, const rs2::frame_source& source);
 
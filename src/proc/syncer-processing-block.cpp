@@ -6,6 +6,7 @@
 #include "sync.h"
 #include "proc/synthetic-stream.h"
 #include "proc/syncer-processing-block.h"
+#include "tracing.h"
 
 
 namespace librealsense
@@ -15,25 +16,30 @@ namespace librealsense
     {
         _matcher->set_callback([this](frame_holder f, syncronization_environment env)
         {
-
-            std::stringstream ss;
-            ss << "SYNCED: ";
-            auto composite = dynamic_cast<composite_frame*>(f.frame);
-            for (int i = 0; i < composite->get_embedded_frames_count(); i++)
+            if (is_log_enabled(RS2_LOG_SEVERITY_DEBUG))
             {
-                auto matched = composite->get_frame(i);
-                ss << matched->get_stream()->get_stream_type() << " " << matched->get_frame_number() << ", "<<std::fixed<< matched->get_frame_timestamp()<<" ";
-            }
+                // The matcher only outputs composite frames
+                std::stringstream ss;
+                ss << "SYNCED: ";
+                auto composite = static_cast<composite_frame*>(f.frame);
+                for (int i = 0; i < composite->get_embedded_frames_count(); i++)
+                {
+                    auto matched = composite->get_frame(i);
+                    ss << matched->get_stream()->get_stream_type() << " " << matched->get_frame_number() << ", "<<std::fixed<< matched->get_frame_timestamp()<<" ";
+                }
 
-            LOG_DEBUG(ss.str());
+                LOG_DEBUG(ss.str());
+            }
+            log_latency_stage(f, RS2_FRAME_LATENCY_STAGE_SYNC_DONE);
             env.matches.enqueue(std::move(f));
         });
 
         auto f = [&](frame_holder frame, synthetic_source_interface* source)
         {
-            single_consumer_queue<frame_holder> matches;
+            lock_free_queue<frame_holder> matches;
 
             {
+                RS2_TRACE_SCOPE("sync", frame->get_frame_number());
                 std::lock_guard<std::mutex> lock(_mutex);
                 _matcher->dispatch(std::move(frame), { source, matches });
             }
@@ -45,4 +51,22 @@ namespace librealsense
         set_processing_callback(std::shared_ptr<rs2_frame_processor_callback>(
             new internal_frame_processor_callback<decltype(f)>(f)));
     }
+
+    void syncer_proccess_unit::set_max_wait(rs2_stream stream, double max_wait_ms)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _matcher->set_max_wait(stream, max_wait_ms);
+    }
+
+    rs2_sync_stats syncer_proccess_unit::get_stats()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _matcher->get_stats();
+    }
+
+    void syncer_proccess_unit::get_stream_drops(int stream_id, unsigned long long& dropped, int& queued)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _matcher->get_stream_drops(stream_id, dropped, queued);
+    }
 } 
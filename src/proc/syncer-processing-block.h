@@ -23,6 +23,10 @@ namespace librealsense
         {
             _matcher.reset();
         }
+
+        void set_max_wait(rs2_stream stream, double max_wait_ms);
+        rs2_sync_stats get_stats();
+        void get_stream_drops(int stream_id, unsigned long long& dropped, int& queued);
     private:
         std::unique_ptr<timestamp_composite_matcher> _matcher;
         std::mutex _mutex;
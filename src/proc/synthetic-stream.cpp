@@ -3,6 +3,12 @@
 
 #include "core/video.h"
 #include "proc/synthetic-stream.h"
+#include "option.h"
+#include "environment.h"
+#include "metrics.h"
+#include "tracing.h"
+
+#include <algorithm>
 
 namespace librealsense
 {
@@ -18,37 +24,185 @@ namespace librealsense
     }
 
     processing_block::processing_block()
-        : _source_wrapper(_source)
+        : _source_wrapper(_source), _in_place(false), _frames_in_flight(1), _posted(0), _completing(0)
     {
         register_option(RS2_OPTION_FRAMES_QUEUE_SIZE, _source.get_published_size_option());
+        register_option(RS2_OPTION_RETAIN_ORIGINAL_FRAME, std::make_shared<ptr_option<bool>>(false, true, true, true,
+            _source_wrapper.get_retain_original(), "Keep the frame each output depth frame was derived from until the output is released"));
         _source.init(std::make_shared<metadata_parser_map>());
     }
 
+    // Time the processing block running on this thread received its input, for the frames it allocates
+    static thread_local rs2_time_t processing_enter_time = 0;
+
+    // Input frames of the in-place processing block running on this thread that no one else holds
+    static thread_local std::vector<frame_interface*>* exclusive_frames = nullptr;
+
+    // The frames of a composite are exclusive when the composite is, and it is their only holder
+    // Frames with read only data are never exclusive, since their data can not be written in place
+    static void collect_exclusive_frames(frame_interface* f, std::vector<frame_interface*>& result)
+    {
+        auto fr = dynamic_cast<frame*>(f);
+        if (!fr || !fr->is_exclusive() || fr->read_only_data) return;
+
+        if (auto c = dynamic_cast<composite_frame*>(f))
+        {
+            for (size_t i = 0; i < c->get_embedded_frames_count(); i++)
+                collect_exclusive_frames(c->get_frame(static_cast<int>(i)), result);
+        }
+        else result.push_back(f);
+    }
+
+    // Results of the invocation running on this thread, when its block holds them back to release them in order
+    static thread_local std::vector<frame_holder>* pipeline_results = nullptr;
+
+    void processing_block::enable_pipelining()
+    {
+        auto frames_in_flight = std::make_shared<ptr_option<uint32_t>>(1, 16, 1, 1, &_frames_in_flight,
+            "Number of consecutive frames processed concurrently on the shared worker threads");
+        register_option(RS2_OPTION_FRAMES_IN_FLIGHT, frames_in_flight);
+    }
+
     void processing_block::invoke(frame_holder f)
     {
+        auto enter_time = get_latency_time();
+        frame_interface* ptr = nullptr;
+        std::swap(f.frame, ptr);
+
+        std::shared_ptr<pipeline_slot> slot;
+        bool post = false;
+        {
+            std::lock_guard<std::mutex> lock(_pipeline_mutex);
+            if (_frames_in_flight > 1 || !_pipeline.empty())
+            {
+                slot = std::make_shared<pipeline_slot>();
+                _pipeline.push_back(slot);
+                post = _posted + 1 < _frames_in_flight;
+                if (post) ++_posted;
+            }
+        }
+
+        if (!slot) run_callback(ptr, enter_time, nullptr);
+        else if (post)
+        {
+            environment::get_instance().get_worker_pool().post([this, ptr, enter_time, slot]()
+            {
+                run_callback(ptr, enter_time, slot.get());
+                complete(*slot, true);
+            });
+        }
+        else
+        {
+            // All the frames in flight are taken, the calling thread processes this one itself
+            run_callback(ptr, enter_time, slot.get());
+            complete(*slot, false);
+        }
+    }
+
+    void processing_block::run_callback(frame_interface* ptr, rs2_time_t enter_time, pipeline_slot* slot)
+    {
+        frame_holder f(ptr);
         auto callback = _source.begin_callback();
+        auto outer_enter_time = processing_enter_time;
+        processing_enter_time = enter_time;
+
+        std::vector<frame_interface*> exclusive;
+        if (_in_place) collect_exclusive_frames(f.frame, exclusive);
+        auto outer_exclusive_frames = exclusive_frames;
+        exclusive_frames = &exclusive;
+
+        auto outer_pipeline_results = pipeline_results;
+        pipeline_results = slot ? &slot->results : nullptr;
+
+        // Registered on the first frame, as the class of the block is not known in the constructor
+        std::call_once(_metrics_registered, [this]()
+        {
+            auto name = get_class_name(typeid(*this));
+            _latency_metric = &get_histogram("rs_processing_latency_ms",
+                "Time the processing blocks take for a frame, including handing on their results", { { "block", name } });
+            _trace_name = intern_trace_name(name);
+        });
         try
         {
             if (_callback)
             {
+                RS2_TRACE_SCOPE(_trace_name, f->get_frame_number());
                 frame_interface* ptr = nullptr;
                 std::swap(f.frame, ptr);
 
+                // Timed whether or not latency instrumentation is enabled
+                auto start_time = std::chrono::steady_clock::now();
                 _callback->on_frame((rs2_frame*)ptr, _source_wrapper.get_c_wrapper());
+                _latency_metric->observe(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count());
             }
         }
         catch(...)
         {
             LOG_ERROR("Exception was thrown during user processing callback!");
         }
+        pipeline_results = outer_pipeline_results;
+        exclusive_frames = outer_exclusive_frames;
+        processing_enter_time = outer_enter_time;
+    }
+
+    void processing_block::complete(pipeline_slot& slot, bool posted)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_pipeline_mutex);
+            slot.done = true;
+            if (posted) --_posted;
+            ++_completing;
+        }
+
+        // Whoever completes the oldest invocation releases the results of all the consecutive completed ones
+        {
+            std::lock_guard<std::mutex> delivery(_delivery_mutex);
+            std::vector<frame_holder> ready;
+            {
+                std::lock_guard<std::mutex> lock(_pipeline_mutex);
+                while (!_pipeline.empty() && _pipeline.front()->done)
+                {
+                    for (auto&& r : _pipeline.front()->results) ready.push_back(std::move(r));
+                    _pipeline.pop_front();
+                }
+            }
+            for (auto&& r : ready) _source.invoke_callback(std::move(r));
+        }
+
+        std::lock_guard<std::mutex> lock(_pipeline_mutex);
+        --_completing;
+        _pipeline_cv.notify_all();
+    }
+
+    void processing_block::flush_pipeline()
+    {
+        std::unique_lock<std::mutex> lock(_pipeline_mutex);
+        _pipeline_cv.wait(lock, [this]() { return _pipeline.empty() && !_posted && !_completing; });
     }
 
     void synthetic_source::frame_ready(frame_holder result)
     {
+        log_latency_stage(result.frame, RS2_FRAME_LATENCY_STAGE_PROCESSING_EXIT);
+        if (pipeline_results)
+        {
+            pipeline_results->push_back(std::move(result));
+            return;
+        }
         _actual_source.invoke_callback(std::move(result));
     }
 
-    frame_interface* synthetic_source::allocate_points(std::shared_ptr<stream_profile_interface> stream, frame_interface* original)
+    // Synthesized frames carry on the stages of the frame they were computed from
+    static void inherit_latency_breakdown(frame_additional_data& data, frame_interface* original)
+    {
+        if (!processing_enter_time) return;
+        for (int i = 0; i < RS2_FRAME_LATENCY_STAGE_COUNT; i++)
+            data.latency_breakdown[i] = original->get_latency_timestamp(static_cast<rs2_frame_latency_stage>(i));
+        data.latency_breakdown[RS2_FRAME_LATENCY_STAGE_PROCESSING_ENTER] = processing_enter_time;
+    }
+
+    frame_interface* synthetic_source::allocate_points(std::shared_ptr<stream_profile_interface> stream, frame_interface* original,
+                                                       size_t vertex_count, rs2_format vertex_format, bool pixel_indices,
+                                                       bool normals)
     {
         auto vid_stream = dynamic_cast<video_stream_profile_interface*>(stream.get());
         if (vid_stream)
@@ -59,9 +213,11 @@ namespace librealsense
             data.timestamp_domain = original->get_frame_timestamp_domain();
             data.metadata_size = 0;
             data.system_time = _actual_source.get_time();
+            inherit_latency_breakdown(data, original);
 
-            auto res = _actual_source.alloc_frame(RS2_EXTENSION_POINTS, vid_stream->get_width() * vid_stream->get_height() * sizeof(float) * 5, data, true);
+            auto res = _actual_source.alloc_frame(RS2_EXTENSION_POINTS, points::get_size(vertex_count, vertex_format, pixel_indices, normals), data, true);
             if (!res) throw wrong_api_call_sequence_exception("Out of frame resources!");
+            dynamic_cast<points*>(res)->set_layout(vertex_format, pixel_indices, normals);
             res->set_sensor(original->get_sensor());
             res->set_stream(stream);
             return res;
@@ -69,6 +225,57 @@ namespace librealsense
         return nullptr;
     }
 
+    frame_interface* synthetic_source::allocate_motion_frame(std::shared_ptr<stream_profile_interface> stream, frame_interface* original,
+                                                             size_t size)
+    {
+        frame_additional_data data{};
+        data.frame_number = original->get_frame_number();
+        data.timestamp = original->get_frame_timestamp();
+        data.timestamp_domain = original->get_frame_timestamp_domain();
+        data.metadata_size = 0;
+        data.system_time = _actual_source.get_time();
+        inherit_latency_breakdown(data, original);
+
+        auto res = _actual_source.alloc_frame(RS2_EXTENSION_MOTION_FRAME, size, data, true);
+        if (!res) throw wrong_api_call_sequence_exception("Out of frame resources!");
+        res->set_sensor(original->get_sensor());
+        res->set_stream(stream);
+        return res;
+    }
+
+    frame_interface* synthetic_source::reuse_video_frame(std::shared_ptr<stream_profile_interface> stream,
+                                                         frame_interface* original,
+                                                         int new_bpp, int new_width, int new_height, int new_stride,
+                                                         rs2_extension frame_type)
+    {
+        if (!exclusive_frames) return nullptr;
+
+        auto it = std::find(exclusive_frames->begin(), exclusive_frames->end(), original);
+        if (it == exclusive_frames->end()) return nullptr;
+
+        video_frame* vf = nullptr;
+        if (frame_type == RS2_EXTENSION_DEPTH_FRAME) vf = dynamic_cast<depth_frame*>(original);
+        else if (frame_type == RS2_EXTENSION_VIDEO_FRAME) vf = dynamic_cast<video_frame*>(original);
+        if (!vf) return nullptr;
+
+        if ((new_bpp && new_bpp * 8 != vf->get_bpp()) ||
+            (new_width && new_width != vf->get_width()) ||
+            (new_height && new_height != vf->get_height()) ||
+            (new_stride && new_stride != vf->get_stride()))
+            return nullptr;
+
+        // The frame can be handed out once only, as the block may write to it, which invalidates its change mask and statistics
+        exclusive_frames->erase(it);
+        vf->changes.reset();
+        vf->statistics.reset();
+
+        original->acquire();
+        original->set_stream(stream);
+        if (processing_enter_time)
+            original->set_latency_timestamp(RS2_FRAME_LATENCY_STAGE_PROCESSING_ENTER, processing_enter_time);
+        return original;
+    }
+
     frame_interface* synthetic_source::allocate_video_frame(std::shared_ptr<stream_profile_interface> stream,
                                                             frame_interface* original,
                                                             int new_bpp,
@@ -77,6 +284,9 @@ namespace librealsense
                                                             int new_stride,
                                                             rs2_extension frame_type)
     {
+        if (auto res = reuse_video_frame(stream, original, new_bpp, new_width, new_height, new_stride, frame_type))
+            return res;
+
         video_frame* vf = nullptr;
 
         if (new_bpp == 0 || (new_width == 0 && new_stride == 0) || new_height == 0)
@@ -95,6 +305,7 @@ namespace librealsense
         data.timestamp_domain = original->get_frame_timestamp_domain();
         data.metadata_size = 0;
         data.system_time = _actual_source.get_time();
+        inherit_latency_breakdown(data, original);
 
         auto width = new_width;
         auto height = new_height;
@@ -134,71 +345,25 @@ namespace librealsense
 
         if (frame_type == RS2_EXTENSION_DEPTH_FRAME)
         {
-            original->acquire();
-            (dynamic_cast<depth_frame*>(res))->set_original(original);
-        }
-
-        return res;
-    }
-
-    int get_embeded_frames_size(frame_interface* f)
-    {
-        if (f == nullptr) return 0;
-        if (auto c = dynamic_cast<composite_frame*>(f))
-            return static_cast<int>(c->get_embedded_frames_count());
-        return 1;
-    }
-
-    void copy_frames(frame_holder from, frame_interface**& target)
-    {
-        if (auto comp = dynamic_cast<composite_frame*>(from.frame))
-        {
-            auto frame_buff = comp->get_frames();
-            for (size_t i = 0; i < comp->get_embedded_frames_count(); i++)
+            auto df = dynamic_cast<depth_frame*>(res);
+            if (_retain_original)
             {
-                std::swap(*target, frame_buff[i]);
-                target++;
+                original->acquire();
+                df->set_original(original);
             }
-            from.frame->disable_continuation();
-        }
-        else
-        {
-            *target = nullptr; // "move" the frame ref into target
-            std::swap(*target, from.frame);
-            target++;
-        }
-    }
-
-    frame_interface* synthetic_source::allocate_composite_frame(std::vector<frame_holder> holders)
-    {
-        frame_additional_data d {};
-
-        auto req_size = 0;
-        for (auto&& f : holders)
-            req_size += get_embeded_frames_size(f.frame);
-
-        auto res = _actual_source.alloc_frame(RS2_EXTENSION_COMPOSITE_FRAME, req_size * sizeof(rs2_frame*), d, true);
-        if (!res) return nullptr;
-
-        auto cf = static_cast<composite_frame*>(res);
-
-        auto frames = cf->get_frames();
-        for (auto&& f : holders)
-            copy_frames(std::move(f), frames);
-        frames -= req_size;
-
-        auto releaser = [frames, req_size]()
-        {
-            for (auto i = 0; i < req_size; i++)
+            // Only the units are taken from the original, so that the chains of frames deriving from one another
+            // no longer hold the buffers of all their stages
+            else if (auto original_depth = dynamic_cast<depth_frame*>(original))
             {
-                frames[i]->release();
-                frames[i] = nullptr;
+                df->set_units(original_depth->get_units());
             }
-        };
-        frame_continuation release_frames(releaser, nullptr);
-        cf->attach_continuation(std::move(release_frames));
-        cf->set_stream(cf->first()->get_stream());
+        }
 
         return res;
     }
+
+    frame_interface* synthetic_source::allocate_composite_frame(frame_holder* holders, size_t count)
+    {
+        return _actual_source.allocate_composite_frame(holders, count);
+    }
 }
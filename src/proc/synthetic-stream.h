@@ -7,13 +7,17 @@
 #include "image.h"
 #include "source.h"
 
+#include <deque>
+
 namespace librealsense
 {
+    class metric_histogram;
+
     class synthetic_source : public synthetic_source_interface
     {
     public:
         synthetic_source(frame_source& actual)
-            : _actual_source(actual), _c_wrapper(new rs2_source { this })
+            : _actual_source(actual), _c_wrapper(new rs2_source { this }), _retain_original(true)
         {
         }
 
@@ -25,17 +29,67 @@ namespace librealsense
                                               int new_stride = 0,
                                               rs2_extension frame_type = RS2_EXTENSION_VIDEO_FRAME) override;
 
-        frame_interface* allocate_composite_frame(std::vector<frame_holder> frames) override;
+        frame_interface* allocate_composite_frame(frame_holder* frames, size_t count) override;
 
-        frame_interface* allocate_points(std::shared_ptr<stream_profile_interface> stream, frame_interface* original) override;
+        frame_interface* allocate_points(std::shared_ptr<stream_profile_interface> stream, frame_interface* original,
+                                         size_t vertex_count, rs2_format vertex_format, bool pixel_indices,
+                                         bool normals = false) override;
+
+        frame_interface* allocate_motion_frame(std::shared_ptr<stream_profile_interface> stream, frame_interface* original,
+                                               size_t size) override;
 
         void frame_ready(frame_holder result) override;
 
         rs2_source* get_c_wrapper() override { return _c_wrapper.get(); }
 
+        // Whether the depth frames allocated keep their original frame, see RS2_OPTION_RETAIN_ORIGINAL_FRAME
+        bool* get_retain_original() { return &_retain_original; }
+
     private:
+        // Hand back the input frame itself as the target, when it is exclusive and of the requested layout
+        frame_interface* reuse_video_frame(std::shared_ptr<stream_profile_interface> stream,
+                                           frame_interface* original,
+                                           int new_bpp, int new_width, int new_height, int new_stride,
+                                           rs2_extension frame_type);
+
         frame_source& _actual_source;
         std::shared_ptr<rs2_source> _c_wrapper;
+        bool _retain_original;
+    };
+
+    // Gathers the frames of a frameset on the stack, up to COMPOSITE_INLINE_FRAMES of them
+    class frameset_builder
+    {
+    public:
+        frameset_builder() : _count(0) {}
+
+        void add(frame_holder f)
+        {
+            if (_count == COMPOSITE_INLINE_FRAMES)
+                for (auto&& h : _inline) _overflow.push_back(std::move(h));
+
+            if (_count < COMPOSITE_INLINE_FRAMES) _inline[_count] = std::move(f);
+            else _overflow.push_back(std::move(f));
+            _count++;
+        }
+
+        size_t size() const { return _count; }
+        frame_holder* begin() { return _count > COMPOSITE_INLINE_FRAMES ? _overflow.data() : _inline.data(); }
+        frame_holder* end() { return begin() + _count; }
+
+        // Allocate the composite frame of the gathered frames, leaving the builder empty
+        frame_interface* build(synthetic_source_interface& source)
+        {
+            auto res = source.allocate_composite_frame(begin(), _count);
+            _overflow.clear();
+            _count = 0;
+            return res;
+        }
+
+    private:
+        std::array<frame_holder, COMPOSITE_INLINE_FRAMES> _inline;
+        std::vector<frame_holder> _overflow;
+        size_t _count;
     };
 
     class processing_block : public processing_block_interface, public options_container
@@ -49,12 +103,52 @@ namespace librealsense
 
         synthetic_source_interface& get_source() override { return _source_wrapper; }
 
-        virtual ~processing_block(){_source.flush();}
+        // Queue of the frames the block outputs, alongside its output callback, see frame_broadcaster
+        std::shared_ptr<frame_subscription> subscribe(int capacity, rs2_queue_policy policy) { return _source.subscribe(capacity, policy); }
+
+        // Wait until the frames being processed concurrently were all delivered
+        void flush_pipeline();
+
+        virtual ~processing_block(){flush_pipeline(); _source.flush();}
     protected:
+        // Blocks whose callback is safe to run for consecutive frames at the same time expose RS2_OPTION_FRAMES_IN_FLIGHT.
+        // Frames beyond the first in flight are processed on the shared worker threads, and their results are released
+        // in the order the frames were received, once all the earlier ones are done. Such blocks call flush_pipeline
+        // in their own destructor, as the frames still in flight use their members
+        void enable_pipelining();
+
+        // Blocks that process in place get their input frame back from allocate_video_frame, instead of a new
+        // frame, whenever no one else holds the input and the requested layout matches it
+        void set_in_place_processing(bool value) { _in_place = value; }
+
         frame_source _source;
         std::mutex _mutex;
         frame_processor_callback_ptr _callback;
         synthetic_source _source_wrapper;
         rs2_extension _output_type;
+        bool _in_place;
+
+    private:
+        // Results of one invocation, held until the invocations received before it are done
+        struct pipeline_slot
+        {
+            std::vector<frame_holder> results;
+            bool done = false;
+        };
+
+        void run_callback(frame_interface* f, rs2_time_t enter_time, pipeline_slot* slot);
+        void complete(pipeline_slot& slot, bool posted);
+
+        uint32_t _frames_in_flight;
+        uint32_t _posted;                                       // Invocations handed to the worker threads and not completed yet
+        uint32_t _completing;                                   // Invocations delivering the results of the completed ones
+        std::deque<std::shared_ptr<pipeline_slot>> _pipeline;   // Invocations whose results were not delivered yet, oldest first
+        std::mutex _pipeline_mutex;
+        std::mutex _delivery_mutex;                             // Serializes the delivery, so the results leave in order
+        std::condition_variable _pipeline_cv;
+
+        std::once_flag _metrics_registered;
+        metric_histogram* _latency_metric = nullptr;
+        const char* _trace_name = nullptr;
     };
 }
@@ -9,6 +9,13 @@
 #include "context.h"
 #include "proc/synthetic-stream.h"
 #include "proc/temporal-filter.h"
+#include "cpu-features.h"
+
+#include <algorithm>
+
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#endif
 
 namespace librealsense
 {
@@ -35,7 +42,10 @@ namespace librealsense
         _one_minus_alpha(1- _alpha_param),
         _delta_param(temp_delta_default),
         _width(0), _height(0),
-        _current_frm_size_pixels(0)
+        _current_frm_size_pixels(0),
+        _current(0),
+        _uses(0),
+        _compact_history(0)
     {
         auto temporal_creadibility_control = std::make_shared<ptr_option<uint8_t>>(cred_min, cred_max, cred_step, cred_default,
             &_credibility_param, "Threshold of previous frames with valid data");
@@ -72,11 +82,19 @@ namespace librealsense
         register_option(RS2_OPTION_FILTER_SMOOTH_ALPHA, temporal_filter_alpha);
         register_option(RS2_OPTION_FILTER_SMOOTH_DELTA, temporal_filter_delta);
 
+        auto temporal_compact_history = std::make_shared<ptr_option<uint8_t>>(0, 1, 1, 0,
+            &_compact_history, "Store the validity of the last four frames only, in four bits per pixel");
+        temporal_compact_history->on_set([this](float val)
+        {
+            on_set_compact_history(static_cast<uint8_t>(val));
+        });
+        register_option(RS2_OPTION_COMPACT_HISTORY, temporal_compact_history);
+
         unregister_option(RS2_OPTION_FRAMES_QUEUE_SIZE);
+        set_in_place_processing(true);
 
         auto on_frame = [this](rs2::frame f, const rs2::frame_source& source)
         {
-            std::lock_guard<std::mutex> lock(_mutex);
             rs2::frame res = f, tgt, depth;
 
             bool composite = f.is<rs2::frameset>();
@@ -84,13 +102,11 @@ namespace librealsense
             depth = (composite) ? f.as<rs2::frameset>().first_or_default(RS2_STREAM_DEPTH) : f;
             if (depth) // Processing required
             {
-                update_configuration(f);
+                configure_stage(depth.get_profile());
                 tgt = prepare_target_frame(depth, source);
 
-                // Spatial smooth with domain transform filter
-                temp_jw_smooth(static_cast<uint16_t*>(const_cast<void*>(tgt.get_data())),   // current frame data
-                    _last_frame_map[_current_frm_size_pixels].data(),                       // previous frame
-                    _history[_current_frm_size_pixels].data());                             // history map
+                auto data = static_cast<uint16_t*>(const_cast<void*>(tgt.get_data()));
+                run_stage(data, data);
             }
 
             res = composite ? source.allocate_composite_frame({ tgt }) : tgt;
@@ -116,41 +132,98 @@ namespace librealsense
         std::lock_guard<std::mutex> lock(_mutex);
         _alpha_param = val;
         _one_minus_alpha = 1 - _alpha_param;
-        _cur_frame_index = 0;
+        for (auto&& s : _states) s.frame_index = 0;
     }
 
     void temporal_filter::on_set_delta(float val)
     {
         std::lock_guard<std::mutex> lock(_mutex);
         _delta_param = val;
-        _cur_frame_index = 0;
+        for (auto&& s : _states) s.frame_index = 0;
+    }
+
+    void temporal_filter::on_set_compact_history(uint8_t val)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _compact_history = val;
+        for (auto&& s : _states) s.frame_index = 0;
+    }
+
+    rs2::stream_profile temporal_filter::configure_stage(const rs2::stream_profile& input)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        update_configuration(input);
+        _stage.state = _current;
+        _stage.pixels = _current_frm_size_pixels;
+        _stage.alpha = _alpha_param;
+        _stage.one_minus_alpha = _one_minus_alpha;
+        _stage.delta = _delta_param;
+        _stage.compact = _compact_history != 0;
+        return _target_stream_profile;
+    }
+
+    void temporal_filter::run_stage(const uint16_t* input, uint16_t* output)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (input != output)
+            memcpy(output, input, _stage.pixels * 2); // Z16-specific
+
+        // The history is reset whenever its layout changes
+        auto&& state = _states[_stage.state];
+        auto history_size = _stage.compact ? (_stage.pixels + 1) / 2 : _stage.pixels;
+        if (state.history.size() != history_size) state.history.assign(history_size, 0);
+
+        temp_jw_smooth(output,                  // current frame data
+            state.last_frame.data(),            // previous frame
+            state.history.data());              // history map
     }
 
-    void  temporal_filter::update_configuration(const rs2::frame& f)
+    void  temporal_filter::update_configuration(const rs2::stream_profile& profile)
     {
-        if (f.get_profile().get() != _source_stream_profile.get())
+        auto id = profile.unique_id();
+        auto it = std::find_if(_states.begin(), _states.end(), [id](const stream_state& s) { return s.unique_id == id; });
+        if (it == _states.end())
+        {
+            if (_states.size() < TEMPORAL_MAX_STREAMS)
+            {
+                _states.emplace_back();
+                it = _states.end() - 1;
+            }
+            else
+            {
+                it = std::min_element(_states.begin(), _states.end(),
+                    [](const stream_state& a, const stream_state& b) { return a.last_use < b.last_use; });
+            }
+            it->unique_id = id;
+            it->source_profile = rs2::stream_profile();
+        }
+        it->last_use = ++_uses;
+        _current = static_cast<size_t>(it - _states.begin());
+
+        auto&& state = *it;
+        if (profile.get() != state.source_profile.get())
         {
-            _source_stream_profile = f.get_profile();
-            _target_stream_profile = _source_stream_profile.clone(RS2_STREAM_DEPTH, 0, RS2_FORMAT_Z16);
+            state.source_profile = profile;
+            state.target_profile = profile.clone(RS2_STREAM_DEPTH, 0, profile.format());
 
             environment::get_instance().get_extrinsics_graph().register_same_extrinsics(
-                *(stream_interface*)(f.get_profile().get()->profile),
-                *(stream_interface*)(_target_stream_profile.get()->profile));
-
-            auto vp = _target_stream_profile.as<rs2::video_stream_profile>();
-            _width = vp.width();
-            _height = vp.height();
-            _current_frm_size_pixels = _width * _height;
-
-            // Allocate internal calc buffers, if needed
-            auto lf_it = _last_frame_map.find(_current_frm_size_pixels);
-            if (lf_it == _last_frame_map.end())
-                _last_frame_map.emplace(_current_frm_size_pixels, std::vector<uint16_t>(_current_frm_size_pixels));
-
-            auto hist_it = _history.find(_current_frm_size_pixels);
-            if (hist_it == _history.end())
-                _history.emplace(_current_frm_size_pixels, std::vector<uint8_t>(_current_frm_size_pixels));
+                *(stream_interface*)(profile.get()->profile),
+                *(stream_interface*)(state.target_profile.get()->profile));
+
+            auto vp = state.target_profile.as<rs2::video_stream_profile>();
+            state.width = vp.width();
+            state.height = vp.height();
+
+            // The filtering starts over, in buffers that keep the capacity of the earlier streams of the state
+            state.last_frame.assign(state.width * state.height, 0);
+            state.history.clear();
+            state.frame_index = 0;
         }
+
+        _target_stream_profile = state.target_profile;
+        _width = state.width;
+        _height = state.height;
+        _current_frm_size_pixels = _width * _height;
     }
 
     rs2::frame temporal_filter::prepare_target_frame(const rs2::frame& f, const rs2::frame_source& source)
@@ -164,7 +237,9 @@ namespace librealsense
             vf.get_stride_in_bytes(),
             RS2_EXTENSION_DEPTH_FRAME);
 
-        memmove(const_cast<void*>(tgt.get_data()), f.get_data(), _current_frm_size_pixels * 2); // Z16-specific
+        // In-place processing hands the source frame back as the target
+        if (tgt.get_data() != f.get_data())
+            memmove(const_cast<void*>(tgt.get_data()), f.get_data(), _stage.pixels * 2); // Z16-specific
         return tgt;
     }
 
@@ -305,46 +380,222 @@ namespace librealsense
         }
     }
 
-    void temporal_filter::temp_jw_smooth(uint16_t * frame, uint16_t * _last_frame, uint8_t *history)
+    // Per-frame constants of the smoothing kernels
+    struct smooth_params
     {
-        unsigned char mask = 1 << _cur_frame_index;
+        float alpha, one_minus_alpha;
+        uint8_t delta;
+        uint8_t mask;                                  // bit of the current frame in the history of a pixel
+        const uint8_t * credibility_map;               // 8-bit history to credibility for all 8 phases
+        std::array<uint8_t, 32> credible;              // bit h % 8 of byte h / 8 tells whether 8-bit history h is credible for this frame
+        std::array<uint8_t, 16> compact_credible;      // 0xff when 4-bit history h is credible for this frame
+    };
+
+    // The compact history of a pixel holds its last four frames in a nibble, two pixels per byte
+    static uint8_t get_compact_history(const uint8_t * history, size_t i) { return (history[i / 2] >> ((i & 1) * 4)) & 0x0f; }
+    static void set_compact_history(uint8_t * history, size_t i, uint8_t hist)
+    {
+        auto shift = (i & 1) * 4;
+        history[i / 2] = static_cast<uint8_t>((history[i / 2] & ~(0x0f << shift)) | ((hist & 0x0f) << shift));
+    }
 
-        // pass one -- go through image and update all
-        for (size_t i = 0; i < _current_frm_size_pixels; i++) {
+    // Update pixels begin to end of the frame, the last frame and the history. Shared by all modes for the
+    // pixels left over by the vector loops
+    static void smooth_scalar(uint16_t * frame, uint16_t * _last_frame, uint8_t * history, bool compact, size_t begin, size_t end, const smooth_params & p)
+    {
+        const unsigned char mask = p.mask;
+
+        for (size_t i = begin; i < end; i++) {
             unsigned short newVal = frame[i];
             unsigned short oldVal = _last_frame[i];
+            unsigned char hist = compact ? get_compact_history(history, i) : history[i];
             if (newVal) {
                 if (!oldVal) {
                     _last_frame[i] = newVal;
-                    history[i] = mask;
+                    hist = mask;
                 }
                 else {  // old and new val
                     int diff = newVal - oldVal;
-                    if (diff < _delta_param && diff > -_delta_param) {  // old and new val agree
-                        history[i] |= mask;
-                        float filtered = _alpha_param * newVal + _one_minus_alpha * oldVal;
+                    if (diff < p.delta && diff > -p.delta) {  // old and new val agree
+                        hist |= mask;
+                        float filtered = p.alpha * newVal + p.one_minus_alpha * oldVal;
                         unsigned short result = (unsigned short)filtered;
                         frame[i] = result;
                         _last_frame[i] = result;
                     }
                     else {
                         _last_frame[i] = newVal;
-                        history[i] = mask;
+                        hist = mask;
                     }
                 }
             }
             else {  // no newVal
                 if (oldVal) { // only case we can help
-                    unsigned char hist = history[i];
-                    unsigned char classification = _credibility_map[hist];
-                    if (classification & mask) { // we have had enough samples lately
+                    bool credible = compact ? p.compact_credible[hist] != 0 : (p.credibility_map[hist] & mask) != 0;
+                    if (credible) { // we have had enough samples lately
                         frame[i] = oldVal;
                     }
                 }
-                history[i] &= ~mask;
+                hist &= ~mask;
             }
+
+            if (compact) set_compact_history(history, i, hist);
+            else history[i] = hist;
         }
+    }
+
+#ifdef __SSSE3__
+    // Filters 16 pixels whose history is given in hist, with one byte per pixel, and returns the updated history
+    static __m128i smooth_16_sse(uint16_t * frame, uint16_t * last_frame, __m128i hist, __m128i credible, const smooth_params & p)
+    {
+        const __m128i zero = _mm_setzero_si128(), all = _mm_set1_epi32(-1);
+        const __m128i delta = _mm_set1_epi16(static_cast<short>(p.delta - 1));
+        const __m128i bias = _mm_set1_epi32(0x8000), sign = _mm_set1_epi16((short)0x8000);
+        const __m128 alpha = _mm_set1_ps(p.alpha), one_minus_alpha = _mm_set1_ps(p.one_minus_alpha);
+
+        __m128i has_new[2], has_both[2], agree[2];
+        for (int k = 0; k < 2; k++)
+        {
+            const __m128i new_val = _mm_loadu_si128(reinterpret_cast<const __m128i *>(frame + k * 8));
+            const __m128i old_val = _mm_loadu_si128(reinterpret_cast<const __m128i *>(last_frame + k * 8));
+
+            has_new[k] = _mm_xor_si128(_mm_cmpeq_epi16(new_val, zero), all);
+            const __m128i has_old = _mm_xor_si128(_mm_cmpeq_epi16(old_val, zero), all);
+            has_both[k] = _mm_and_si128(has_new[k], has_old);
+
+            // |new - old| < delta, using saturated unsigned subtraction
+            const __m128i diff = _mm_or_si128(_mm_subs_epu16(new_val, old_val), _mm_subs_epu16(old_val, new_val));
+            agree[k] = _mm_and_si128(has_both[k], _mm_cmpeq_epi16(_mm_subs_epu16(diff, delta), zero));
+
+            // Same operations in the same order as the scalar code, so the results are identical
+            __m128i filtered[2];
+            for (int h = 0; h < 2; h++)
+            {
+                const __m128 n = _mm_cvtepi32_ps(h ? _mm_unpackhi_epi16(new_val, zero) : _mm_unpacklo_epi16(new_val, zero));
+                const __m128 o = _mm_cvtepi32_ps(h ? _mm_unpackhi_epi16(old_val, zero) : _mm_unpacklo_epi16(old_val, zero));
+                const __m128i r = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(alpha, n), _mm_mul_ps(one_minus_alpha, o)));
+                filtered[h] = _mm_sub_epi32(r, bias);
+            }
+            const __m128i result = _mm_xor_si128(_mm_packs_epi32(filtered[0], filtered[1]), sign);
+
+            // Holes are filled with the last value while the history is credible
+            const __m128i fill = _mm_andnot_si128(has_new[k], _mm_and_si128(has_old, k ? _mm_unpackhi_epi8(credible, credible) : _mm_unpacklo_epi8(credible, credible)));
+
+            const __m128i out = _mm_or_si128(_mm_and_si128(agree[k], result),
+                                _mm_or_si128(_mm_and_si128(fill, old_val), _mm_andnot_si128(_mm_or_si128(agree[k], fill), new_val)));
+            const __m128i last = _mm_or_si128(_mm_and_si128(agree[k], result),
+                                 _mm_or_si128(_mm_andnot_si128(has_new[k], old_val), _mm_andnot_si128(_mm_or_si128(agree[k], _mm_xor_si128(has_new[k], all)), new_val)));
+
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(frame + k * 8), out);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(last_frame + k * 8), last);
+        }
+
+        // History: agreeing pixels gain the current bit, other valid pixels restart from it, holes lose it
+        const __m128i mask = _mm_set1_epi8(static_cast<char>(p.mask));
+        const __m128i is_new = _mm_packs_epi16(has_new[0], has_new[1]);
+        const __m128i is_agree = _mm_packs_epi16(agree[0], agree[1]);
+        const __m128i kept = _mm_or_si128(_mm_and_si128(is_agree, hist), _mm_andnot_si128(is_new, _mm_andnot_si128(mask, hist)));
+        return _mm_or_si128(kept, _mm_and_si128(is_new, mask));
+    }
+
+    static void smooth_sse(uint16_t * frame, uint16_t * last_frame, uint8_t * history, bool compact, size_t begin, size_t end, const smooth_params & p)
+    {
+        const __m128i low_nibble = _mm_set1_epi8(0x0f), index_high = _mm_set1_epi8(15), select = _mm_set1_epi8((char)0x80);
+        const __m128i credible_low = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p.credible.data()));
+        const __m128i credible_high = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p.credible.data() + 16));
+        const __m128i compact_credible = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p.compact_credible.data()));
+        const __m128i bits = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, (char)128, 1, 2, 4, 8, 16, 32, 64, (char)128);
+        const __m128i even_odd = _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
+
+        size_t i = begin;
+        for (; i + 16 <= end; i += 16)
+        {
+            __m128i hist, credible;
+            if (compact)
+            {
+                // Spread the 16 nibbles into one byte per pixel, and look their credibility up in a single shuffle
+                const __m128i packed = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(history + i / 2));
+                hist = _mm_unpacklo_epi8(_mm_and_si128(packed, low_nibble), _mm_and_si128(_mm_srli_epi16(packed, 4), low_nibble));
+                credible = _mm_shuffle_epi8(compact_credible, hist);
+            }
+            else
+            {
+                // Byte h / 8 of the 32 bytes credibility bitmap comes from either half, then bit h % 8 is tested
+                hist = _mm_loadu_si128(reinterpret_cast<const __m128i *>(history + i));
+                const __m128i index = _mm_and_si128(_mm_srli_epi16(hist, 3), _mm_set1_epi8(0x1f));
+                const __m128i high = _mm_cmpgt_epi8(index, index_high);
+                const __m128i byte = _mm_or_si128(_mm_shuffle_epi8(credible_low, _mm_or_si128(index, _mm_and_si128(high, select))),
+                                                  _mm_shuffle_epi8(credible_high, _mm_or_si128(_mm_and_si128(index, low_nibble), _mm_andnot_si128(high, select))));
+                const __m128i bit = _mm_shuffle_epi8(bits, _mm_and_si128(hist, _mm_set1_epi8(7)));
+                credible = _mm_cmpeq_epi8(_mm_and_si128(byte, bit), bit);
+            }
+
+            hist = smooth_16_sse(frame + i, last_frame + i, hist, credible, p);
+
+            if (compact)
+            {
+                const __m128i split = _mm_shuffle_epi8(hist, even_odd);
+                const __m128i packed = _mm_or_si128(split, _mm_slli_epi16(_mm_srli_si128(split, 8), 4));
+                _mm_storel_epi64(reinterpret_cast<__m128i *>(history + i / 2), packed);
+            }
+            else _mm_storeu_si128(reinterpret_cast<__m128i *>(history + i), hist);
+        }
+        smooth_scalar(frame, last_frame, history, compact, i, end, p);
+    }
+#endif
+
+    typedef void(*smooth_function)(uint16_t * frame, uint16_t * last_frame, uint8_t * history, bool compact, size_t begin, size_t end, const smooth_params & p);
+
+    static smooth_function select_smooth()
+    {
+#ifdef __SSSE3__
+        if (cpu_supports(CPU_FEATURE_SSSE3)) return &smooth_sse;
+#endif
+        return &smooth_scalar;
+    }
+
+    void temporal_filter::temp_jw_smooth(uint16_t * frame, uint16_t * _last_frame, uint8_t *history)
+    {
+        static const auto smooth = select_smooth();
+        auto&& frame_index = _states[_stage.state].frame_index;
+
+        smooth_params p;
+        p.alpha = _stage.alpha;
+        p.one_minus_alpha = _stage.one_minus_alpha;
+        p.delta = _stage.delta;
+        p.mask = static_cast<uint8_t>(1 << (_stage.compact ? frame_index % 4 : frame_index));
+        p.credibility_map = _credibility_map.data();
+
+        p.credible.fill(0);
+        for (size_t h = 0; h < CREDIBILITY_MAP_SIZE; h++)
+            if (_credibility_map[h] & p.mask) p.credible[h / 8] |= 1 << (h % 8);
+
+        // A compact history maps onto the 8-bit history of the same frames, with the four older ones invalid
+        for (uint8_t h = 0; h < 16; h++)
+        {
+            uint8_t full = 0;
+            for (int age = 1; age <= 4; age++)
+            {
+                auto phase = (frame_index + 8 - age) % 8;
+                if (h & (1 << (phase % 4))) full |= 1 << phase;
+            }
+            p.compact_credible[h] = (_credibility_map[full] & (1 << frame_index)) ? 0xff : 0;
+        }
+
+        // Pixels are independent of each other, so the frame is split into bands for the shared worker threads.
+        // Bands start on multiples of 16 pixels, which keeps the pixels of a compact history byte together
+        auto&& pool = environment::get_instance().get_worker_pool();
+        const size_t min_band_pixels = 16384;
+        const size_t pixels = _stage.pixels;
+        const int bands = static_cast<int>(std::max<size_t>(1, std::min<size_t>(pool.size() + 1, pixels / min_band_pixels)));
+        auto band_start = [&](int band) { return band >= bands ? pixels : (pixels * band / bands) & ~size_t(15); };
+        const bool compact = _stage.compact;
+
+        pool.run(bands, [&](int band)
+        {
+            smooth(frame, _last_frame, history, compact, band_start(band), band_start(band + 1), p);
+        });
 
-        _cur_frame_index = (_cur_frame_index + 1) % 8;  // at end of cycle
+        frame_index = (frame_index + 1) % 8;  // at end of cycle
     }
 }
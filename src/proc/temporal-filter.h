@@ -3,27 +3,58 @@
 
 #pragma once
 #include "types.h"
+#include "filter-chain.h"
 
 namespace librealsense
 {
     const size_t CREDIBILITY_MAP_SIZE = 256;
+    const size_t TEMPORAL_MAX_STREAMS = 4;  // Source streams whose state is kept, the least recently filtered one is replaced
 
-    class temporal_filter : public processing_block
+    class temporal_filter : public processing_block, public depth_filter_stage
     {
     public:
         temporal_filter();
 
+        rs2::stream_profile configure_stage(const rs2::stream_profile& input) override;
+        void run_stage(const uint16_t* input, uint16_t* output) override;
+
     protected:
-        void    update_configuration(const rs2::frame& f);
+        void    update_configuration(const rs2::stream_profile& profile);
 
         rs2::frame prepare_target_frame(const rs2::frame& f, const rs2::frame_source& source);
 
         void temp_jw_smooth(uint16_t * frame_data, uint16_t * _last_frame_data, uint8_t *history);
 
     private:
+        // Filtering state of a source stream, so that the frames of several streams interleave without mixing their
+        // histories. A replaced state hands its buffers over to the next stream, which reuses their capacity
+        struct stream_state
+        {
+            int                     unique_id = -1;         // Of the source stream profile
+            rs2::stream_profile     source_profile;
+            rs2::stream_profile     target_profile;
+            size_t                  width = 0, height = 0;
+            std::vector<uint16_t>   last_frame;
+            std::vector<uint8_t>    history;                // represents the history over the last 8 frames, 1 bit per frame, or over the last 4 frames in a nibble per pixel when compact
+            uint8_t                 frame_index = 0;        // mod 8
+            uint64_t                last_use = 0;
+        };
+
+        // Settings of the frame being filtered, taken by configure_stage so that the options set before run_stage
+        // apply from the next frame on
+        struct stage_snapshot
+        {
+            size_t                  state = 0;              // Index in _states
+            size_t                  pixels = 0;
+            float                   alpha = 0, one_minus_alpha = 0;
+            uint8_t                 delta = 0;
+            bool                    compact = false;
+        };
+
         void on_set_confidence_control(uint8_t val);
         void on_set_alpha(float val);
         void on_set_delta(float val);
+        void on_set_compact_history(uint8_t val);
 
         void recalc_creadibility_map();
         std::mutex _mutex;
@@ -34,11 +65,12 @@ namespace librealsense
         uint8_t                 _delta_param;
         size_t                  _width, _height;
         size_t                  _current_frm_size_pixels;
-        rs2::stream_profile     _source_stream_profile;
         rs2::stream_profile     _target_stream_profile;
-        std::map < size_t, std::vector<uint16_t> > _last_frame_map; // Hold the last frame for each size
-        std::map < size_t, std::vector<uint8_t> > _history;    // represents the history over the last 8 frames, 1 bit per frame
-        uint8_t                 _cur_frame_index; // mod 8
+        std::vector<stream_state> _states;                  // Up to TEMPORAL_MAX_STREAMS
+        size_t                  _current;                   // State of the stream being filtered
+        uint64_t                _uses;                      // Counts the configurations, to find the least recently used state
+        uint8_t                 _compact_history;
+        stage_snapshot          _stage;
         std::array<uint8_t, CREDIBILITY_MAP_SIZE> _credibility_map;  // encodes whether a particular 8 bit history is good enough for all 8 phases of storage
     };
 }
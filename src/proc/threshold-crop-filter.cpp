@@ -0,0 +1,159 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#include "../include/librealsense2/hpp/rs_sensor.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+
+#include "option.h"
+#include "context.h"
+#include "environment.h"
+#include "archive.h"
+#include "proc/synthetic-stream.h"
+#include "proc/threshold-crop-filter.h"
+
+#include <algorithm>
+
+namespace librealsense
+{
+    const float distance_min_val = 0.f;
+    const float distance_max_val = 65.f;
+    const float distance_step = 0.01f;
+
+    const int crop_max_val = 4096;
+
+    threshold_crop_filter::threshold_crop_filter() :
+        _min_distance(distance_min_val),
+        _max_distance(distance_max_val),
+        _crop_left(0), _crop_top(0), _crop_right(0), _crop_bottom(0),
+        _depth_units(0),
+        _width(0), _height(0), _out_width(0), _out_height(0),
+        _threshold(false),
+        _recalc_profile(false)
+    {
+        auto min_distance = std::make_shared<ptr_option<float>>(distance_min_val, distance_max_val, distance_step,
+            distance_min_val, &_min_distance, "Nearest distance kept, in meters");
+        auto max_distance = std::make_shared<ptr_option<float>>(distance_min_val, distance_max_val, distance_step,
+            distance_max_val, &_max_distance, "Farthest distance kept, in meters");
+        register_option(RS2_OPTION_MIN_DISTANCE, min_distance);
+        register_option(RS2_OPTION_MAX_DISTANCE, max_distance);
+
+        auto add_margin = [this](rs2_option id, int* margin, const char* description)
+        {
+            auto option = std::make_shared<ptr_option<int>>(0, crop_max_val, 1, 0, margin, description);
+            option->on_set([this](float) { _recalc_profile = true; });
+            register_option(id, option);
+        };
+        add_margin(RS2_OPTION_CROP_LEFT, &_crop_left, "Columns cut off the left of the frame");
+        add_margin(RS2_OPTION_CROP_TOP, &_crop_top, "Rows cut off the top of the frame");
+        add_margin(RS2_OPTION_CROP_RIGHT, &_crop_right, "Columns cut off the right of the frame");
+        add_margin(RS2_OPTION_CROP_BOTTOM, &_crop_bottom, "Rows cut off the bottom of the frame");
+
+        unregister_option(RS2_OPTION_FRAMES_QUEUE_SIZE);
+        set_in_place_processing(true);
+
+        auto on_frame = [this](rs2::frame f, const rs2::frame_source& source)
+        {
+            rs2::frame out = f, tgt, depth;
+
+            bool composite = f.is<rs2::frameset>();
+
+            depth = (composite) ? f.as<rs2::frameset>().first_or_default(RS2_STREAM_DEPTH) : f;
+
+            if (depth) // Processing required
+            {
+                prepare_stage(depth);
+                auto vp = configure_stage(depth.get_profile()).as<rs2::video_stream_profile>();
+                // In-place processing hands the source frame back when the size is kept
+                tgt = source.allocate_video_frame(vp, depth, 2, vp.width(), vp.height(), vp.width() * 2,
+                    RS2_EXTENSION_DEPTH_FRAME);
+                run_stage(static_cast<const uint16_t*>(depth.get_data()),
+                    static_cast<uint16_t*>(const_cast<void*>(tgt.get_data())));
+            }
+
+            out = composite ? source.allocate_composite_frame({ tgt }) : tgt;
+
+            source.frame_ready(out);
+        };
+
+        auto callback = new rs2::frame_processor_callback<decltype(on_frame)>(on_frame);
+        processing_block::set_processing_callback(std::shared_ptr<rs2_frame_processor_callback>(callback));
+    }
+
+    void threshold_crop_filter::prepare_stage(const rs2::frame& source)
+    {
+        auto df = dynamic_cast<depth_frame*>((frame_interface*)source.get());
+        _depth_units = df ? df->get_units() : 0;
+    }
+
+    rs2::stream_profile threshold_crop_filter::configure_stage(const rs2::stream_profile& input)
+    {
+        // Earlier stages of a chain may have turned the depth into disparity, which is only cropped
+        _threshold = input.format() == RS2_FORMAT_Z16 && _depth_units > 0 &&
+            (_min_distance > distance_min_val || _max_distance < distance_max_val);
+        update_output_profile(input);
+        return _target_stream_profile;
+    }
+
+    void threshold_crop_filter::update_output_profile(const rs2::stream_profile& profile)
+    {
+        if (profile.get() != _source_stream_profile.get())
+        {
+            _source_stream_profile = profile;
+            _recalc_profile = true;
+        }
+
+        // Build a new target profile for every source or margin change
+        if (_recalc_profile)
+        {
+            auto vp = _source_stream_profile.as<rs2::video_stream_profile>();
+            if (_crop_left + _crop_right >= vp.width() || _crop_top + _crop_bottom >= vp.height())
+                throw invalid_value_exception(to_string() << "Crop margins leave nothing of a frame of size ["
+                    << vp.width() << "," << vp.height() << "]");
+            _width = vp.width();
+            _height = vp.height();
+            _out_width = _width - _crop_left - _crop_right;
+            _out_height = _height - _crop_top - _crop_bottom;
+
+            _target_stream_profile = _source_stream_profile.clone(RS2_STREAM_DEPTH, 0, _source_stream_profile.format());
+            environment::get_instance().get_extrinsics_graph().register_same_extrinsics(*(stream_interface*)(_source_stream_profile.get()->profile), *(stream_interface*)(_target_stream_profile.get()->profile));
+            auto src_vspi = dynamic_cast<video_stream_profile_interface*>(_source_stream_profile.get()->profile);
+            auto tgt_vspi = dynamic_cast<video_stream_profile_interface*>(_target_stream_profile.get()->profile);
+            tgt_vspi->set_dims(static_cast<uint32_t>(_out_width), static_cast<uint32_t>(_out_height));
+            try
+            {
+                // Cropping only moves the image, the focal lengths and the distortion stay
+                auto intrinsics = src_vspi->get_intrinsics();
+                intrinsics.width = static_cast<int>(_out_width);
+                intrinsics.height = static_cast<int>(_out_height);
+                intrinsics.ppx -= _crop_left;
+                intrinsics.ppy -= _crop_top;
+                tgt_vspi->set_intrinsics([intrinsics]() { return intrinsics; });
+            }
+            catch (...) {}
+
+            _recalc_profile = false;
+        }
+    }
+
+    void threshold_crop_filter::run_stage(const uint16_t* input, uint16_t* output)
+    {
+        // The rows move toward the start of the frame, so copying them in order also works in place
+        if (input != output || _out_width != _width)
+        {
+            for (size_t y = 0; y < _out_height; y++)
+                memmove(output + y * _out_width, input + (y + _crop_top) * _width + _crop_left, _out_width * sizeof(uint16_t));
+        }
+
+        if (_threshold)
+        {
+            auto min_value = static_cast<uint16_t>(std::min(_min_distance / _depth_units, 65535.f));
+            auto max_value = static_cast<uint16_t>(std::min(_max_distance / _depth_units, 65535.f));
+            auto count = _out_width * _out_height;
+            for (size_t i = 0; i < count; i++)
+            {
+                auto v = output[i];
+                output[i] = (v < min_value || v > max_value) ? 0 : v;
+            }
+        }
+    }
+}
@@ -0,0 +1,38 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "../include/librealsense2/hpp/rs_frame.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+#include "filter-chain.h"
+
+namespace librealsense
+{
+    // Cuts the given margins off depth frames and clears the depth outside the distance band, so the blocks after it
+    // process only the pixels that matter. The intrinsics of the cropped profile move the principal point by the
+    // margins, which keeps align and pointcloud correct. The distance band applies to Z16 frames only
+    class threshold_crop_filter : public processing_block, public depth_filter_stage
+    {
+    public:
+        threshold_crop_filter();
+
+        void prepare_stage(const rs2::frame& source) override;
+        rs2::stream_profile configure_stage(const rs2::stream_profile& input) override;
+        void run_stage(const uint16_t* input, uint16_t* output) override;
+
+    private:
+        void update_output_profile(const rs2::stream_profile& profile);
+
+        float                   _min_distance;
+        float                   _max_distance;
+        int                     _crop_left, _crop_top, _crop_right, _crop_bottom;
+        float                   _depth_units;
+        size_t                  _width, _height;            // Of the source
+        size_t                  _out_width, _out_height;
+        bool                    _threshold;
+        rs2::stream_profile     _source_stream_profile;
+        rs2::stream_profile     _target_stream_profile;
+        bool                    _recalc_profile;
+    };
+}
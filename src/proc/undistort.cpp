@@ -0,0 +1,276 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#include "../include/librealsense2/hpp/rs_sensor.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+#include "../include/librealsense2/rsutil.h"
+
+#include "context.h"
+#include "environment.h"
+#include "image.h"
+#include "proc/undistort.h"
+
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#endif
+
+namespace librealsense
+{
+    const size_t remap_table_cache_size = 8;
+
+    bool remap_table::needs_remap(const rs2_intrinsics& intrin)
+    {
+        return intrin.model == RS2_DISTORTION_MODIFIED_BROWN_CONRADY || intrin.model == RS2_DISTORTION_FTHETA;
+    }
+
+    std::shared_ptr<const remap_table> remap_table::get(const rs2_intrinsics& intrin)
+    {
+        static std::mutex mutex;
+        static std::deque<std::shared_ptr<const remap_table>> cache;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto&& table : cache)
+            if (!memcmp(&table->_intrin, &intrin, sizeof(intrin)))
+                return table;
+
+        auto table = std::make_shared<const remap_table>(intrin);
+        cache.push_front(table);
+        if (cache.size() > remap_table_cache_size)
+            cache.pop_back();
+        return table;
+    }
+
+    remap_table::remap_table(const rs2_intrinsics& intrin)
+        : _intrin(intrin)
+    {
+        const int width = intrin.width, height = intrin.height;
+        if (width < 2 || height < 2 || width > INT16_MAX || height > INT16_MAX)
+            throw invalid_value_exception(to_string() << "Can not remap images of size [" << width << "," << height << "]");
+
+        _coords.resize(width * height * 2);
+        _entries.resize(width * height);
+        for (int y = 0; y < height; y++)
+        {
+            for (int x = 0; x < width; x++)
+            {
+                const float point[3] = { (x - intrin.ppx) / intrin.fx, (y - intrin.ppy) / intrin.fy, 1.f };
+                float pixel[2];
+                rs2_project_point_to_pixel(pixel, &intrin, point);
+
+                const int i = y * width + x;
+                _coords[i * 2] = pixel[0];
+                _coords[i * 2 + 1] = pixel[1];
+
+                auto&& e = _entries[i];
+                if (!(pixel[0] >= 0 && pixel[1] >= 0 && pixel[0] <= width - 1 && pixel[1] <= height - 1))
+                {
+                    e = { -1, -1, 0, 0 };
+                    continue;
+                }
+                // The last column and row are reached with the full weight of the pixel after the top-left one
+                const int x0 = std::min(static_cast<int>(pixel[0]), width - 2);
+                const int y0 = std::min(static_cast<int>(pixel[1]), height - 2);
+                e.x = static_cast<int16_t>(x0);
+                e.y = static_cast<int16_t>(y0);
+                e.wx = static_cast<uint16_t>((pixel[0] - x0) * 256 + 0.5f);
+                e.wy = static_cast<uint16_t>((pixel[1] - y0) * 256 + 0.5f);
+            }
+        }
+    }
+
+    rs2_intrinsics remap_table::get_undistorted_intrinsics() const
+    {
+        auto intrin = _intrin;
+        intrin.model = RS2_DISTORTION_NONE;
+        for (auto&& c : intrin.coeffs) c = 0;
+        return intrin;
+    }
+
+    void remap_table::distort_pixel(float distorted[2], const float undistorted[2]) const
+    {
+        const int width = _intrin.width, height = _intrin.height;
+        const float u = undistorted[0], v = undistorted[1];
+        if (!(u >= 0 && v >= 0 && u <= width - 1 && v <= height - 1))
+        {
+            const float point[3] = { (u - _intrin.ppx) / _intrin.fx, (v - _intrin.ppy) / _intrin.fy, 1.f };
+            rs2_project_point_to_pixel(distorted, &_intrin, point);
+            return;
+        }
+
+        const int x0 = std::min(static_cast<int>(u), width - 2), y0 = std::min(static_cast<int>(v), height - 2);
+        const float fx = u - x0, fy = v - y0;
+        const float* top = _coords.data() + (y0 * width + x0) * 2;
+        const float* bottom = top + width * 2;
+        for (int c = 0; c < 2; c++)
+        {
+            const float t = top[c] + (top[c + 2] - top[c]) * fx;
+            const float b = bottom[c] + (bottom[c + 2] - bottom[c]) * fx;
+            distorted[c] = t + (b - t) * fy;
+        }
+    }
+
+    // Rounded to 8 bits horizontally, then vertically. The vectorized variant follows the same steps
+    static inline uint8_t interpolate(const uint8_t* top, const uint8_t* bottom, int step, int wx, int wy)
+    {
+        const int t = (top[0] * (256 - wx) + top[step] * wx + 128) >> 8;
+        const int b = (bottom[0] * (256 - wx) + bottom[step] * wx + 128) >> 8;
+        return static_cast<uint8_t>((t * (256 - wy) + b * wy + 128) >> 8);
+    }
+
+    void remap_table::remap(const uint8_t* src, int src_stride, uint8_t* dst, int dst_stride, int channels) const
+    {
+        auto&& pool = environment::get_instance().get_worker_pool();
+        const int width = _intrin.width, height = _intrin.height;
+        const int bands = std::min<int>(height, static_cast<int>(pool.size()) + 1);
+
+        pool.run(bands, [&](int band)
+        {
+            for (int y = height * band / bands; y < height * (band + 1) / bands; y++)
+            {
+                const entry* entries = _entries.data() + y * width;
+                uint8_t* out = dst + y * dst_stride;
+                auto remap_pixel = [&](int x)
+                {
+                    const entry& e = entries[x];
+                    if (e.x < 0)
+                    {
+                        memset(out + x * channels, 0, channels);
+                        return;
+                    }
+                    const uint8_t* top = src + e.y * src_stride + e.x * channels;
+                    for (int c = 0; c < channels; c++)
+                        out[x * channels + c] = interpolate(top + c, top + src_stride + c, channels, e.wx, e.wy);
+                };
+
+                int x = 0;
+#ifdef __SSSE3__
+                // Four pixels at a time, the weights of each interleaved with their complement for the multiply-adds
+                const __m128i round = _mm_set1_epi32(128);
+                for (; x + 4 <= width; x += 4)
+                {
+                    const entry* e = entries + x;
+                    if (e[0].x < 0 || e[1].x < 0 || e[2].x < 0 || e[3].x < 0)
+                    {
+                        for (int k = 0; k < 4; k++) remap_pixel(x + k);
+                        continue;
+                    }
+
+                    const __m128i wx = _mm_set_epi16(e[3].wx, 256 - e[3].wx, e[2].wx, 256 - e[2].wx,
+                                                     e[1].wx, 256 - e[1].wx, e[0].wx, 256 - e[0].wx);
+                    const __m128i wy = _mm_set_epi16(e[3].wy, 256 - e[3].wy, e[2].wy, 256 - e[2].wy,
+                                                     e[1].wy, 256 - e[1].wy, e[0].wy, 256 - e[0].wy);
+                    const uint8_t* p[4];
+                    for (int k = 0; k < 4; k++)
+                        p[k] = src + e[k].y * src_stride + e[k].x * channels;
+
+                    for (int c = 0; c < channels; c++)
+                    {
+                        const __m128i top = _mm_set_epi16(p[3][c + channels], p[3][c], p[2][c + channels], p[2][c],
+                                                          p[1][c + channels], p[1][c], p[0][c + channels], p[0][c]);
+                        const uint8_t* q[4] = { p[0] + src_stride, p[1] + src_stride, p[2] + src_stride, p[3] + src_stride };
+                        const __m128i bottom = _mm_set_epi16(q[3][c + channels], q[3][c], q[2][c + channels], q[2][c],
+                                                             q[1][c + channels], q[1][c], q[0][c + channels], q[0][c]);
+                        const __m128i t = _mm_srli_epi32(_mm_add_epi32(_mm_madd_epi16(top, wx), round), 8);
+                        const __m128i b = _mm_srli_epi32(_mm_add_epi32(_mm_madd_epi16(bottom, wx), round), 8);
+                        const __m128i v = _mm_srli_epi32(_mm_add_epi32(_mm_madd_epi16(_mm_or_si128(t, _mm_slli_epi32(b, 16)), wy), round), 8);
+
+                        uint8_t values[16];
+                        _mm_storeu_si128(reinterpret_cast<__m128i*>(values), v);
+                        for (int k = 0; k < 4; k++)
+                            out[(x + k) * channels + c] = values[k * 4];
+                    }
+                }
+#endif
+                for (; x < width; x++)
+                    remap_pixel(x);
+            }
+        });
+    }
+
+    // Channels of the formats remapped, zero for the others
+    static int get_remap_channels(rs2_format format)
+    {
+        switch (format)
+        {
+        case RS2_FORMAT_Y8: case RS2_FORMAT_RAW8: return 1;
+        case RS2_FORMAT_RGB8: case RS2_FORMAT_BGR8: return 3;
+        case RS2_FORMAT_RGBA8: case RS2_FORMAT_BGRA8: return 4;
+        default: return 0;
+        }
+    }
+
+    rs2::stream_profile undistort::get_target_profile(const rs2::stream_profile& source, const rs2_intrinsics& intrin)
+    {
+        std::lock_guard<std::mutex> lock(_profile_mutex);
+        auto it = _profiles.find(source.get());
+        if (it != _profiles.end())
+            return it->second.second;
+
+        auto target = source.clone(source.stream_type(), source.stream_index(), source.format());
+        environment::get_instance().get_extrinsics_graph().register_same_extrinsics(*(stream_interface*)(source.get()->profile), *(stream_interface*)(target.get()->profile));
+        auto tgt_vspi = dynamic_cast<video_stream_profile_interface*>(target.get()->profile);
+        tgt_vspi->set_dims(intrin.width, intrin.height);
+        auto undistorted = remap_table::get(intrin)->get_undistorted_intrinsics();
+        tgt_vspi->set_intrinsics([undistorted]() { return undistorted; });
+
+        _profiles[source.get()] = { source, target };
+        return target;
+    }
+
+    undistort::undistort()
+    {
+        unregister_option(RS2_OPTION_FRAMES_QUEUE_SIZE);
+
+        auto on_frame = [this](rs2::frame f, const rs2::frame_source& source)
+        {
+            auto convert = [&](const rs2::frame& in) -> rs2::frame
+            {
+                auto vf = in.as<rs2::video_frame>();
+                auto channels = vf ? get_remap_channels(in.get_profile().format()) : 0;
+                if (!channels)
+                    return in;
+
+                auto vspi = dynamic_cast<video_stream_profile_interface*>(in.get_profile().get()->profile);
+                rs2_intrinsics intrin;
+                try
+                {
+                    intrin = vspi->get_intrinsics();
+                }
+                catch (...)
+                {
+                    return in;
+                }
+                if (!remap_table::needs_remap(intrin) || intrin.width != vf.get_width() || intrin.height != vf.get_height())
+                    return in;
+
+                auto table = remap_table::get(intrin);
+                auto target = source.allocate_video_frame(get_target_profile(in.get_profile(), intrin), in,
+                                                          channels, intrin.width, intrin.height, intrin.width * channels,
+                                                          RS2_EXTENSION_VIDEO_FRAME);
+                table->remap(static_cast<const uint8_t*>(vf.get_data()), vf.get_stride_in_bytes(),
+                             static_cast<uint8_t*>(const_cast<void*>(target.get_data())), intrin.width * channels, channels);
+                return target;
+            };
+
+            if (auto fs = f.as<rs2::frameset>())
+            {
+                std::vector<rs2::frame> frames;
+                bool converted = false;
+                for (size_t i = 0; i < fs.size(); i++)
+                {
+                    auto in = fs[i];
+                    auto out = convert(in);
+                    converted |= out.get() != in.get();
+                    frames.push_back(out);
+                }
+                source.frame_ready(converted ? source.allocate_composite_frame(frames) : f);
+            }
+            else source.frame_ready(convert(f));
+        };
+
+        auto callback = new rs2::frame_processor_callback<decltype(on_frame)>(on_frame);
+        processing_block::set_processing_callback(std::shared_ptr<rs2_frame_processor_callback>(callback));
+
+        enable_pipelining();
+    }
+}
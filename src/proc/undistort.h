@@ -0,0 +1,60 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "synthetic-stream.h"
+
+namespace librealsense
+{
+    // Where every pixel of the undistorted image lies in the image of the given intrinsics, computed once per intrinsics
+    // The undistorted image has the size, focal lengths and principal point of the distorted one, and no distortion
+    class remap_table
+    {
+    public:
+        // Only the forward distortion models, which rsutil applies when projecting, have a table
+        static bool needs_remap(const rs2_intrinsics& intrin);
+
+        // Shared between the users of the same intrinsics, the few most recent tables stay cached
+        static std::shared_ptr<const remap_table> get(const rs2_intrinsics& intrin);
+
+        explicit remap_table(const rs2_intrinsics& intrin);
+
+        const rs2_intrinsics& get_distorted_intrinsics() const { return _intrin; }
+        rs2_intrinsics get_undistorted_intrinsics() const;
+
+        // Same result as rs2_project_point_to_pixel with the distorted intrinsics for the point of the given
+        // undistorted pixel. Inside the image the pixel is interpolated from the table, outside it is computed
+        void distort_pixel(float distorted[2], const float undistorted[2]) const;
+
+        // Bilinear remap of an image of the distorted intrinsics with 8 bit channels into the undistorted image
+        void remap(const uint8_t* src, int src_stride, uint8_t* dst, int dst_stride, int channels) const;
+
+    private:
+        // Top-left source pixel and the weights of the pixels to its right and below, in 1/256
+        struct entry
+        {
+            int16_t x, y;
+            uint16_t wx, wy;
+        };
+
+        rs2_intrinsics _intrin;
+        std::vector<float> _coords;     // Distorted x and y of every undistorted pixel
+        std::vector<entry> _entries;    // x of -1 for the pixels that fall outside the distorted image
+    };
+
+    // Remaps the video frames of 8 bit per channel formats whose intrinsics have forward distortion, such as the
+    // color and fisheye streams, into undistorted frames. Other frames pass through unchanged
+    class undistort : public processing_block
+    {
+    public:
+        undistort();
+        ~undistort() { flush_pipeline(); }
+
+    private:
+        rs2::stream_profile get_target_profile(const rs2::stream_profile& source, const rs2_intrinsics& intrin);
+
+        std::mutex _profile_mutex;
+        std::map<const rs2_stream_profile*, std::pair<rs2::stream_profile, rs2::stream_profile>> _profiles;
+    };
+}
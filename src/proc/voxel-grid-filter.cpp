@@ -0,0 +1,221 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#include "../include/librealsense2/hpp/rs_sensor.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+
+#include "option.h"
+#include "environment.h"
+#include "archive.h"
+#include "proc/synthetic-stream.h"
+#include "proc/voxel-grid-filter.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace librealsense
+{
+    const float voxel_size_min = 0.001f;
+    const float voxel_size_max = 1.f;
+    const float voxel_size_step = 0.001f;
+    const float voxel_size_default = 0.01f;
+
+    // Voxel coordinates take 21 bits each, offset so that they are never negative
+    const int voxel_coordinate_bits = 21;
+    const int64_t voxel_coordinate_offset = int64_t(1) << (voxel_coordinate_bits - 1);
+    const uint64_t no_voxel = ~uint64_t(0);
+
+    static uint64_t voxel_key(const float3& v, float inverse_size)
+    {
+        auto coordinate = [inverse_size](float value)
+        {
+            auto c = static_cast<int64_t>(std::floor(value * inverse_size)) + voxel_coordinate_offset;
+            return static_cast<uint64_t>(std::max<int64_t>(0, std::min<int64_t>((int64_t(1) << voxel_coordinate_bits) - 1, c)));
+        };
+        return (coordinate(v.x) << (2 * voxel_coordinate_bits)) | (coordinate(v.y) << voxel_coordinate_bits) | coordinate(v.z);
+    }
+
+    static uint64_t mix_key(uint64_t key)
+    {
+        key ^= key >> 33;
+        key *= 0xff51afd7ed558ccdULL;
+        key ^= key >> 33;
+        return key;
+    }
+
+    // Sums of the points of a voxel
+    struct voxel_sum
+    {
+        double x = 0, y = 0, z = 0;
+        float u = 0, v = 0;
+        float nx = 0, ny = 0, nz = 0;
+        int count = 0;
+    };
+
+    // Open addressing table of the voxels of one thread, in the order they were first met
+    class voxel_table
+    {
+    public:
+        voxel_table() : _mask(0) {}
+
+        voxel_sum& find_or_insert(uint64_t key, uint64_t hash)
+        {
+            if ((_voxels.size() + 1) * 2 > _slots.size()) grow();
+            for (auto i = hash & _mask;; i = (i + 1) & _mask)
+            {
+                auto&& slot = _slots[i];
+                if (slot.key == key) return _voxels[slot.index];
+                if (slot.key == no_voxel)
+                {
+                    slot.key = key;
+                    slot.index = static_cast<int>(_voxels.size());
+                    _voxels.emplace_back();
+                    return _voxels.back();
+                }
+            }
+        }
+
+        const std::vector<voxel_sum>& voxels() const { return _voxels; }
+
+    private:
+        struct slot
+        {
+            uint64_t key;
+            int index;
+        };
+
+        void grow()
+        {
+            std::vector<slot> old;
+            std::swap(old, _slots);
+            _slots.assign(std::max<size_t>(1024, old.size() * 2), slot{ no_voxel, 0 });
+            _mask = _slots.size() - 1;
+            for (auto&& s : old)
+            {
+                if (s.key == no_voxel) continue;
+                auto i = mix_key(s.key) & _mask;
+                while (_slots[i].key != no_voxel) i = (i + 1) & _mask;
+                _slots[i] = s;
+            }
+        }
+
+        std::vector<slot> _slots;
+        std::vector<voxel_sum> _voxels;
+        size_t _mask;
+    };
+
+    voxel_grid_filter::voxel_grid_filter()
+        : _voxel_size(voxel_size_default)
+    {
+        register_option(RS2_OPTION_VOXEL_SIZE, std::make_shared<ptr_option<float>>(voxel_size_min, voxel_size_max, voxel_size_step,
+            voxel_size_default, &_voxel_size, "Edge of the voxels, in meters"));
+
+        unregister_option(RS2_OPTION_FRAMES_QUEUE_SIZE);
+
+        auto on_frame = [this](rs2::frame f, const rs2::frame_source& source)
+        {
+            bool composite = f.is<rs2::frameset>();
+            rs2::frame input;
+            if (composite)
+            {
+                for (auto&& member : f.as<rs2::frameset>())
+                    if (member.is<rs2::points>()) { input = member; break; }
+            }
+            else if (f.is<rs2::points>()) input = f;
+            if (!input)
+            {
+                source.frame_ready(f);
+                return;
+            }
+
+            auto pts = (points*)(frame_interface*)input.get();
+            if (pts->get_vertex_format() != RS2_FORMAT_XYZ32F)
+                throw invalid_value_exception("Voxel grid filter needs XYZ32F points");
+
+            const auto count = static_cast<int>(pts->get_vertex_count());
+            const auto vertices = pts->get_vertices();
+            const auto texcoords = pts->get_texture_coordinates();
+            const auto normals = pts->get_normals();
+            const float inverse_size = 1.f / _voxel_size;
+
+            auto&& pool = environment::get_instance().get_worker_pool();
+            const int min_band_points = 16384;
+            const int bands = std::max(1, std::min(static_cast<int>(pool.size()) + 1, count / min_band_points));
+
+            // The keys, and the hashes that route them, are computed once, in parallel
+            std::vector<uint64_t> keys(count), hashes(count);
+            pool.run(bands, [&](int band)
+            {
+                for (int i = count * band / bands; i < count * (band + 1) / bands; ++i)
+                {
+                    keys[i] = vertices[i].z ? voxel_key(vertices[i], inverse_size) : no_voxel;
+                    hashes[i] = mix_key(keys[i]);
+                }
+            });
+
+            // Each thread gathers the voxels whose hash routes them to it, the high bits route and the low ones index
+            std::vector<voxel_table> tables(bands);
+            pool.run(bands, [&](int band)
+            {
+                auto&& table = tables[band];
+                for (int i = 0; i < count; ++i)
+                {
+                    if (keys[i] == no_voxel || static_cast<int>((hashes[i] >> 32) % bands) != band) continue;
+                    auto&& voxel = table.find_or_insert(keys[i], hashes[i]);
+                    auto&& v = vertices[i];
+                    voxel.x += v.x;
+                    voxel.y += v.y;
+                    voxel.z += v.z;
+                    voxel.u += texcoords[i].x;
+                    voxel.v += texcoords[i].y;
+                    if (normals)
+                    {
+                        voxel.nx += normals[i].x;
+                        voxel.ny += normals[i].y;
+                        voxel.nz += normals[i].z;
+                    }
+                    voxel.count++;
+                }
+            });
+
+            size_t total = 0;
+            for (auto&& table : tables) total += table.voxels().size();
+
+            auto out = (points*)get_source().allocate_points(pts->get_stream(), pts, total, RS2_FORMAT_XYZ32F, false, normals != nullptr);
+            rs2::frame tgt((rs2_frame*)(frame_interface*)out);
+            auto out_vertices = out->get_vertices();
+            auto out_texcoords = out->get_texture_coordinates();
+            auto out_normals = out->get_normals();
+            size_t i = 0;
+            for (auto&& table : tables)
+            {
+                for (auto&& voxel : table.voxels())
+                {
+                    auto inverse_count = 1.0 / voxel.count;
+                    out_vertices[i] = { float(voxel.x * inverse_count), float(voxel.y * inverse_count), float(voxel.z * inverse_count) };
+                    out_texcoords[i] = { float(voxel.u * inverse_count), float(voxel.v * inverse_count) };
+                    if (out_normals)
+                    {
+                        auto length = std::sqrt(voxel.nx * voxel.nx + voxel.ny * voxel.ny + voxel.nz * voxel.nz);
+                        out_normals[i] = length > 0 ? float3{ voxel.nx / length, voxel.ny / length, voxel.nz / length } : float3{ 0, 0, 0 };
+                    }
+                    ++i;
+                }
+            }
+
+            if (!composite)
+            {
+                source.frame_ready(tgt);
+                return;
+            }
+
+            std::vector<rs2::frame> frames;
+            for (auto&& member : f.as<rs2::frameset>())
+                frames.push_back(member.get() == input.get() ? tgt : member);
+            source.frame_ready(source.allocate_composite_frame(std::move(frames)));
+        };
+
+        auto callback = new rs2::frame_processor_callback<decltype(on_frame)>(on_frame);
+        processing_block::set_processing_callback(std::shared_ptr<rs2_frame_processor_callback>(callback));
+    }
+}
@@ -0,0 +1,23 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "../include/librealsense2/hpp/rs_frame.hpp"
+#include "../include/librealsense2/hpp/rs_processing.hpp"
+#include "synthetic-stream.h"
+
+namespace librealsense
+{
+    // Replaces the points of every voxel of a grid by their centroid, with the mean of their texture coordinates and of
+    // their normals when they have some. The voxels are gathered in hash tables, one per worker thread, each owning the
+    // voxels of the keys that hash to it, so the threads never share a voxel. The output holds the occupied voxels only
+    class voxel_grid_filter : public processing_block
+    {
+    public:
+        voxel_grid_filter();
+
+    private:
+        float _voxel_size;
+    };
+}
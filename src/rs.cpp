@@ -12,23 +12,52 @@
 #include "core/extension.h"
 #include "media/record/record_device.h"
 #include <media/ros/ros_writer.h>
+#include "media/record/segmented_writer.h"
+#include "media/native/native_writer.h"
+#include "media/network/network_writer.h"
 #include <media/ros/ros_reader.h>
 #include "core/advanced_mode.h"
 #include "source.h"
+#include "image.h"
 #include "core/processing.h"
 #include "proc/synthetic-stream.h"
 #include "proc/align.h"
 #include "proc/colorizer.h"
 #include "proc/pointcloud.h"
 #include "proc/syncer-processing-block.h"
+#include "proc/cross-device-syncer.h"
 #include "proc/decimation-filter.h"
 #include "proc/spatial-filter.h"
+#include "proc/filter-chain.h"
+#include "proc/disparity-transform.h"
+#include "proc/distance-transform.h"
+#include "proc/hole-filling-filter.h"
+#include "proc/threshold-crop-filter.h"
+#include "proc/change-detection.h"
+#include "proc/depth-statistics.h"
+#include "proc/voxel-grid-filter.h"
+#include "proc/normal-estimation.h"
+#include "proc/depth-pyramid.h"
+#include "proc/processing-graph.h"
 #include "media/playback/playback_device.h"
+#include "media/playback/sliced_playback.h"
+#include "media/playback/dataset_reader.h"
 #include "stream.h"
 #include "../include/librealsense2/h/rs_types.h"
 #include "pipeline.h"
 #include "environment.h"
 #include "proc/temporal-filter.h"
+#include "proc/depth-compression.h"
+#include "proc/undistort.h"
+#include "proc/motion-fusion.h"
+#include "proc/frame-exporter.h"
+#include "shared-device.h"
+#include "software-device.h"
+#include "device-state.h"
+#include "threading.h"
+#include "metrics.h"
+#include "tracing.h"
+#include "latency-probe.h"
 
 ////////////////////////
 // API implementation //
@@ -92,14 +121,45 @@ struct rs2_pipeline_profile
     std::shared_ptr<librealsense::pipeline_profile> profile;
 };
 
+struct rs2_frame_publisher
+{
+    std::shared_ptr<librealsense::frame_publisher> publisher;
+};
+
 struct rs2_frame_queue
 {
     explicit rs2_frame_queue(int cap)
-        : queue(cap)
+        : queue(std::make_shared<lock_free_queue<librealsense::frame_holder>>(cap))
+    {
+    }
+
+    // Shared with the callbacks that fill the queue, which may outlive the handle
+    std::shared_ptr<lock_free_queue<librealsense::frame_holder>> queue;
+};
+
+struct rs2_frame_subscription
+{
+    std::shared_ptr<librealsense::frame_subscription> subscription;
+};
+
+// Moves the frames it is given straight into a frame queue, for sensors and blocks started with a queue
+class frame_queue_callback : public rs2_frame_callback
+{
+public:
+    explicit frame_queue_callback(const rs2_frame_queue* queue) : _queue(queue->queue) {}
+
+    void on_frame(rs2_frame* frame) override
     {
+        librealsense::frame_holder fh;
+        fh.frame = (librealsense::frame_interface*)frame;
+        librealsense::log_latency_stage(fh.frame, RS2_FRAME_LATENCY_STAGE_QUEUE_ENQUEUE);
+        _queue->enqueue(std::move(fh));
     }
 
-    single_consumer_queue<librealsense::frame_holder> queue;
+    void release() override { delete this; }
+
+private:
+    std::shared_ptr<lock_free_queue<librealsense::frame_holder>> _queue;
 };
 
 struct rs2_processing_block : public rs2_options
@@ -114,11 +174,53 @@ struct rs2_processing_block : public rs2_options
     rs2_processing_block(const rs2_processing_block&) = delete;
 };
 
+static std::shared_ptr<librealsense::processing_graph> as_processing_graph(const rs2_processing_block* block)
+{
+    auto graph = std::dynamic_pointer_cast<librealsense::processing_graph>(block->block);
+    if (!graph)
+        throw librealsense::invalid_value_exception("Processing block is not a processing graph");
+    return graph;
+}
+
+static librealsense::syncer_proccess_unit* as_syncer(const rs2_processing_block* block)
+{
+    auto sync = dynamic_cast<librealsense::syncer_proccess_unit*>(block->block.get());
+    if (!sync)
+        throw librealsense::invalid_value_exception("Processing block is not a sync processing block");
+    return sync;
+}
+
 struct rs2_sensor_list
 {
     rs2_device dev;
 };
 
+struct rs2_thread_list
+{
+    std::vector<librealsense::thread_info> list;
+};
+
+struct rs2_latency_probe
+{
+    librealsense::latency_probe probe;
+};
+
+struct rs2_dataset_reader
+{
+    std::unique_ptr<librealsense::dataset_reader> reader;
+};
+
+struct rs2_dataset_batch
+{
+    std::shared_ptr<librealsense::dataset_batch> batch;
+};
+
+struct rs2_metrics_snapshot
+{
+    std::vector<librealsense::metric_sample> samples;
+    std::string text;   // Formatted when first asked for
+};
+
 int major(int version)
 {
     return version / 10000;
@@ -177,6 +279,11 @@ void verify_version_compatibility(int api_version)
 
 void notifications_proccessor::raise_notification(const notification n)
 {
+    {
+        std::lock_guard<std::mutex> lock(_observers_mutex);
+        for (auto&& observer : _observers)
+            observer(n);
+    }
     _dispatcher.invoke([this, n](dispatcher::cancellable_timer ct)
     {
         std::lock_guard<std::mutex> lock(_callback_mutex);
@@ -253,6 +360,20 @@ rs2_device_list* rs2_query_devices(const rs2_context* context, rs2_error** error
 }
 HANDLE_EXCEPTIONS_AND_RETURN(nullptr, context)
 
+rs2_device_list* rs2_query_devices_lightweight(const rs2_context* context, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(context);
+
+    std::vector<rs2_device_info> results;
+    for (auto&& dev_info : context->ctx->query_devices(true))
+    {
+        results.push_back({ context->ctx, dev_info });
+    }
+
+    return new rs2_device_list{ context->ctx, results };
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, context)
+
 rs2_sensor_list* rs2_query_sensors(const rs2_device* device, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(device);
@@ -318,6 +439,41 @@ rs2_device* rs2_create_device(const rs2_device_list* info_list, int index, rs2_e
 }
 HANDLE_EXCEPTIONS_AND_RETURN(nullptr, info_list, index)
 
+int rs2_create_devices(const rs2_device_list* info_list, rs2_device** devices, rs2_error** device_errors, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(info_list);
+    VALIDATE_NOT_NULL(devices);
+
+    // Opening a device is mostly blocking on its control transfers, so each device is opened on a thread of its own
+    std::atomic<int> created(0);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < info_list->list.size(); i++)
+    {
+        devices[i] = nullptr;
+        if (device_errors) device_errors[i] = nullptr;
+        threads.emplace_back([info_list, devices, device_errors, i, &created]()
+        {
+            try
+            {
+                auto&& info = info_list->list[i].info;
+                devices[i] = new rs2_device{ info_list->ctx, info, info->create_device() };
+                created++;
+            }
+            catch (...)
+            {
+                librealsense::translate_exception("rs2_create_devices", to_string() << "info_list:" << info_list << ", index:" << i,
+                    device_errors ? &device_errors[i] : nullptr);
+            }
+        });
+    }
+    for (auto&& t : threads)
+    {
+        t.join();
+    }
+    return created;
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0, info_list, devices, device_errors)
+
 void rs2_delete_device(rs2_device* device) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(device);
@@ -325,6 +481,33 @@ void rs2_delete_device(rs2_device* device) BEGIN_API_CALL
 }
 NOEXCEPT_RETURN(, device)
 
+rs2_frame_publisher* rs2_create_frame_publisher(rs2_device* device, const char* name, int slots, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    VALIDATE_NOT_NULL(name);
+    VALIDATE_RANGE(slots, 0, 0xffff);
+
+    auto publisher = std::make_shared<librealsense::frame_publisher>(device->device, name, static_cast<uint32_t>(slots));
+    return new rs2_frame_publisher{ publisher };
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, device, name, slots)
+
+void rs2_publish_frame(rs2_frame_publisher* publisher, rs2_frame* frame, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(publisher);
+    VALIDATE_NOT_NULL(frame);
+
+    publisher->publisher->publish((frame_interface*)frame);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, publisher, frame)
+
+void rs2_delete_frame_publisher(rs2_frame_publisher* publisher) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(publisher);
+    delete publisher;
+}
+NOEXCEPT_RETURN(, publisher)
+
 rs2_sensor* rs2_create_sensor(const rs2_sensor_list* list, int index, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(list);
@@ -467,6 +650,62 @@ const rs2_raw_data_buffer* rs2_send_and_receive_raw_data(rs2_device* device, voi
 }
 HANDLE_EXCEPTIONS_AND_RETURN(nullptr, device)
 
+void rs2_send_and_receive_raw_data_batch(rs2_device* device, const void** commands, const unsigned* sizes, int count,
+                                         const rs2_raw_data_buffer** responses, double* received_ms, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    VALIDATE_NOT_NULL(commands);
+    VALIDATE_NOT_NULL(sizes);
+    VALIDATE_NOT_NULL(responses);
+    VALIDATE_RANGE(count, 0, std::numeric_limits<int>::max());
+
+    auto debug_interface = VALIDATE_INTERFACE(device->device, librealsense::debug_interface);
+
+    std::vector<std::vector<uint8_t>> inputs;
+    for (int i = 0; i < count; i++)
+    {
+        VALIDATE_NOT_NULL(commands[i]);
+        auto data = static_cast<const uint8_t*>(commands[i]);
+        inputs.emplace_back(data, data + sizes[i]);
+    }
+
+    std::vector<double> times;
+    auto results = debug_interface->send_receive_raw_data_batch(inputs, times);
+    if (results.size() != inputs.size())
+        throw io_exception(to_string() << "Received " << results.size() << " responses to " << inputs.size() << " commands");
+
+    for (int i = 0; i < count; i++)
+    {
+        responses[i] = new rs2_raw_data_buffer{ std::move(results[i]) };
+        if (received_ms) received_ms[i] = i < static_cast<int>(times.size()) ? times[i] : 0;
+    }
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, device, commands, sizes, count, responses, received_ms)
+
+void rs2_start_fw_log_capture(rs2_device* device, unsigned capacity, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    auto debug_interface = VALIDATE_INTERFACE(device->device, librealsense::debug_interface);
+    debug_interface->start_fw_log_capture(capacity);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, device, capacity)
+
+void rs2_stop_fw_log_capture(rs2_device* device, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    auto debug_interface = VALIDATE_INTERFACE(device->device, librealsense::debug_interface);
+    debug_interface->stop_fw_log_capture();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, device)
+
+const rs2_raw_data_buffer* rs2_fetch_fw_logs(rs2_device* device, unsigned max_count, unsigned timeout_ms, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    auto debug_interface = VALIDATE_INTERFACE(device->device, librealsense::debug_interface);
+    return new rs2_raw_data_buffer{ debug_interface->fetch_fw_logs(max_count, std::chrono::milliseconds(timeout_ms)) };
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, device, max_count, timeout_ms)
+
 const unsigned char* rs2_get_raw_data(const rs2_raw_data_buffer* buffer, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(buffer);
@@ -488,6 +727,31 @@ void rs2_delete_raw_data(const rs2_raw_data_buffer* buffer) BEGIN_API_CALL
 }
 NOEXCEPT_RETURN(, buffer)
 
+void rs2_set_option_cache_staleness(const rs2_sensor* sensor, unsigned int staleness_ms, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(sensor);
+    // Only sensors reading options from a device cache them, other sensors have nothing to configure
+    if (auto s = dynamic_cast<librealsense::sensor_base*>(sensor->sensor))
+        s->get_option_cache().set_staleness(std::chrono::milliseconds(staleness_ms));
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, sensor, staleness_ms)
+
+void rs2_hold_sensor_power(const rs2_sensor* sensor, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(sensor);
+    if (auto s = dynamic_cast<librealsense::uvc_sensor*>(sensor->sensor))
+        s->hold_power();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, sensor)
+
+void rs2_release_sensor_power(const rs2_sensor* sensor, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(sensor);
+    if (auto s = dynamic_cast<librealsense::uvc_sensor*>(sensor->sensor))
+        s->release_held_power();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, sensor)
+
 void rs2_open(rs2_sensor* sensor, const rs2_stream_profile* profile, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(sensor);
@@ -537,6 +801,14 @@ float rs2_get_option(const rs2_options* options, rs2_option option, rs2_error**
 }
 HANDLE_EXCEPTIONS_AND_RETURN(0.0f, options, option)
 
+float rs2_get_option_from_device(const rs2_options* options, rs2_option option, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(options);
+    VALIDATE_ENUM(option);
+    return options->options->get_option(option).query_from_device();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0.0f, options, option)
+
 void rs2_set_option(const rs2_options* options, rs2_option option, float value, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(options);
@@ -545,6 +817,38 @@ void rs2_set_option(const rs2_options* options, rs2_option option, float value,
 }
 HANDLE_EXCEPTIONS_AND_RETURN(, options, option, value)
 
+void rs2_get_options(const rs2_options* options, const rs2_option* option_ids, float* values, int count, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(options);
+    VALIDATE_NOT_NULL(option_ids);
+    VALIDATE_NOT_NULL(values);
+    VALIDATE_RANGE(count, 0, std::numeric_limits<int>::max());
+    std::vector<rs2_option> ids(option_ids, option_ids + count);
+    for (auto id : ids)
+        VALIDATE_ENUM(id);
+
+    auto res = options->options->query_options(ids);
+    std::copy(res.begin(), res.end(), values);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, options, option_ids, values, count)
+
+void rs2_set_options(const rs2_options* options, const rs2_option* option_ids, const float* values, int count, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(options);
+    VALIDATE_NOT_NULL(option_ids);
+    VALIDATE_NOT_NULL(values);
+    VALIDATE_RANGE(count, 0, std::numeric_limits<int>::max());
+    std::vector<std::pair<rs2_option, float>> vals;
+    for (int i = 0; i < count; i++)
+    {
+        VALIDATE_ENUM(option_ids[i]);
+        vals.emplace_back(option_ids[i], values[i]);
+    }
+
+    options->options->set_options(vals);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, options, option_ids, values, count)
+
 
 int rs2_supports_option(const rs2_options* options, rs2_option option, rs2_error** error) BEGIN_API_CALL
 {
@@ -626,7 +930,7 @@ void rs2_start_queue(const rs2_sensor* sensor, rs2_frame_queue* queue, rs2_error
     VALIDATE_NOT_NULL(sensor);
     VALIDATE_NOT_NULL(queue);
     librealsense::frame_callback_ptr callback(
-        new librealsense::frame_callback(rs2_enqueue_frame, queue));
+        new frame_queue_callback(queue), [](rs2_frame_callback* p) { p->release(); });
     sensor->sensor->start(move(callback));
 }
 HANDLE_EXCEPTIONS_AND_RETURN(, sensor, queue)
@@ -642,6 +946,21 @@ void rs2_set_notifications_callback(const rs2_sensor* sensor, rs2_notification_c
 }
 HANDLE_EXCEPTIONS_AND_RETURN(, sensor, on_notification, user)
 
+void rs2_set_frame_allocator(const rs2_sensor* sensor, rs2_frame_alloc_ptr on_alloc, rs2_frame_free_ptr on_free, int alignment, void* user, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(sensor);
+    VALIDATE_NOT_NULL(on_alloc);
+    VALIDATE_NOT_NULL(on_free);
+    VALIDATE_RANGE(alignment, 1, 4096);
+    if (alignment & (alignment - 1))
+        throw invalid_value_exception(to_string() << "alignment must be a power of two, got " << alignment);
+    librealsense::frame_allocator_ptr allocator(
+        new librealsense::frame_allocator(on_alloc, on_free, user),
+        [](rs2_frame_allocator* p) { delete p; });
+    sensor->sensor->set_frame_allocator(allocator, alignment);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, sensor, on_alloc, on_free, alignment, user)
+
 void rs2_set_devices_changed_callback(const rs2_context* context, rs2_devices_changed_callback_ptr callback, void* user, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(context);
@@ -669,6 +988,31 @@ void rs2_set_notifications_callback_cpp(const rs2_sensor* sensor, rs2_notificati
 }
 HANDLE_EXCEPTIONS_AND_RETURN(, sensor, callback)
 
+void rs2_set_frame_allocator_cpp(const rs2_sensor* sensor, rs2_frame_allocator* allocator, int alignment, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(sensor);
+    VALIDATE_NOT_NULL(allocator);
+    librealsense::frame_allocator_ptr a(allocator, [](rs2_frame_allocator* p) { p->release(); });
+    VALIDATE_RANGE(alignment, 1, 4096);
+    if (alignment & (alignment - 1))
+        throw invalid_value_exception(to_string() << "alignment must be a power of two, got " << alignment);
+    sensor->sensor->set_frame_allocator(a, alignment);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, sensor, allocator, alignment)
+
+void rs2_get_frame_pool_stats(const rs2_sensor* sensor, rs2_frame_pool_stats* stats, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(sensor);
+    VALIDATE_NOT_NULL(stats);
+    *stats = { 0, 0, 0 };
+    if (auto s = dynamic_cast<librealsense::sensor_base*>(sensor->sensor))
+    {
+        auto pool = s->get_frame_source().get_buffer_pool_stats();
+        *stats = { pool.hits, pool.misses, pool.evictions };
+    }
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, sensor, stats)
+
 void rs2_set_devices_changed_callback_cpp(rs2_context* context, rs2_devices_changed_callback* callback, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(context);
@@ -700,6 +1044,25 @@ rs2_metadata_type rs2_get_frame_metadata(const rs2_frame* frame, rs2_frame_metad
 }
 HANDLE_EXCEPTIONS_AND_RETURN(0, frame, frame_metadata)
 
+int rs2_get_frame_metadata_all(const rs2_frame* frame, rs2_metadata_type* values, int* supported, int count, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(frame);
+    VALIDATE_NOT_NULL(values);
+    VALIDATE_NOT_NULL(supported);
+    VALIDATE_RANGE(count, 0, ::RS2_FRAME_METADATA_COUNT);
+    auto f = (frame_interface*)frame;
+    int found = 0;
+    for (int i = 0; i < count; i++)
+    {
+        auto md = static_cast<rs2_frame_metadata_value>(i);
+        supported[i] = f->supports_frame_metadata(md);
+        values[i] = supported[i] ? f->get_frame_metadata(md) : 0;
+        found += supported[i] ? 1 : 0;
+    }
+    return found;
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0, frame, values, supported, count)
+
 const char* rs2_get_notification_description(rs2_notification* notification, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(notification);
@@ -748,6 +1111,28 @@ int rs2_device_list_contains(const rs2_device_list* info_list, const rs2_device*
 }
 HANDLE_EXCEPTIONS_AND_RETURN(false, info_list, device)
 
+void rs2_get_frame_view(const rs2_frame* frame, rs2_frame_view* view, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(frame);
+    VALIDATE_NOT_NULL(view);
+    auto f = (frame_interface*)frame;
+    *view = {};
+    view->data = f->get_frame_data();
+    view->data_size = static_cast<int>(f->get_frame_data_size());
+    if (auto vf = dynamic_cast<video_frame*>(f))
+    {
+        view->width = vf->get_width();
+        view->height = vf->get_height();
+        view->stride = vf->get_stride();
+        view->bits_per_pixel = vf->get_bpp();
+    }
+    view->number = f->get_frame_number();
+    view->timestamp = f->get_frame_timestamp();
+    view->timestamp_domain = f->get_frame_timestamp_domain();
+    view->profile = f->get_stream()->get_c_wrapper();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, frame, view)
+
 rs2_time_t rs2_get_frame_timestamp(const rs2_frame* frame_ref, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(frame_ref);
@@ -769,6 +1154,13 @@ const void* rs2_get_frame_data(const rs2_frame* frame_ref, rs2_error** error) BE
 }
 HANDLE_EXCEPTIONS_AND_RETURN(nullptr, frame_ref)
 
+int rs2_get_frame_data_size(const rs2_frame* frame_ref, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(frame_ref);
+    return static_cast<int>(((frame_interface*)frame_ref)->get_frame_data_size());
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0, frame_ref)
+
 int rs2_get_frame_width(const rs2_frame* frame_ref, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(frame_ref);
@@ -793,6 +1185,54 @@ int rs2_get_frame_stride_in_bytes(const rs2_frame* frame_ref, rs2_error** error)
 }
 HANDLE_EXCEPTIONS_AND_RETURN(0, frame_ref)
 
+void rs2_copy_frame_to(const rs2_frame* frame_ref, void* dst, int dst_stride, rs2_format dst_format, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(frame_ref);
+    VALIDATE_NOT_NULL(dst);
+    VALIDATE_RANGE(dst_stride, 0, std::numeric_limits<int>::max());
+    VALIDATE_ENUM(dst_format);
+    auto vf = VALIDATE_INTERFACE(((frame_interface*)frame_ref), librealsense::video_frame);
+    auto format = vf->get_stream()->get_format();
+
+    float depth_units = 0.f;
+    if (dst_format == RS2_FORMAT_DISTANCE)
+    {
+        auto df = dynamic_cast<librealsense::depth_frame*>(vf);
+        if (!df)
+            throw invalid_value_exception("Only depth frames convert to RS2_FORMAT_DISTANCE");
+        depth_units = df->get_units();
+    }
+
+    convert_image(static_cast<byte*>(dst), dst_stride, dst_format, vf->get_frame_data(), vf->get_stride(), format,
+                  vf->get_width(), vf->get_height(), depth_units);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, frame_ref, dst, dst_stride, dst_format)
+
+int rs2_depth_frame_get_statistics(const rs2_frame* frame_ref, rs2_depth_statistics* statistics, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(frame_ref);
+    VALIDATE_NOT_NULL(statistics);
+    auto df = VALIDATE_INTERFACE(((frame_interface*)frame_ref), librealsense::depth_frame);
+    auto stats = get_depth_statistics(df);
+    if (!stats) return 0;
+    *statistics = stats->summary;
+    return 1;
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0, frame_ref, statistics)
+
+int rs2_depth_frame_get_histogram(const rs2_frame* frame_ref, unsigned int* bins, int count, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(frame_ref);
+    VALIDATE_RANGE(count, 0, std::numeric_limits<int>::max());
+    auto df = VALIDATE_INTERFACE(((frame_interface*)frame_ref), librealsense::depth_frame);
+    auto stats = get_depth_statistics(df);
+    if (!stats) return 0;
+    if (bins)
+        std::copy_n(stats->histogram.begin(), std::min<size_t>(count, stats->histogram.size()), bins);
+    return static_cast<int>(stats->histogram.size());
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0, frame_ref, bins, count)
+
 const rs2_stream_profile* rs2_get_frame_stream_profile(const rs2_frame* frame_ref, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(frame_ref);
@@ -862,10 +1302,11 @@ rs2_frame* rs2_wait_for_frame(rs2_frame_queue* queue, unsigned int timeout_ms, r
 {
     VALIDATE_NOT_NULL(queue);
     librealsense::frame_holder fh;
-    if (!queue->queue.dequeue(&fh, timeout_ms))
+    if (!queue->queue->dequeue(&fh, timeout_ms))
     {
         throw std::runtime_error("Frame did not arrive in time!");
     }
+    log_latency_stage(fh.frame, RS2_FRAME_LATENCY_STAGE_QUEUE_DEQUEUE);
 
     frame_interface* result = nullptr;
     std::swap(result, fh.frame);
@@ -878,8 +1319,9 @@ int rs2_poll_for_frame(rs2_frame_queue* queue, rs2_frame** output_frame, rs2_err
     VALIDATE_NOT_NULL(queue);
     VALIDATE_NOT_NULL(output_frame);
     librealsense::frame_holder fh;
-    if (queue->queue.try_dequeue(&fh))
+    if (queue->queue->try_dequeue(&fh))
     {
+        log_latency_stage(fh.frame, RS2_FRAME_LATENCY_STAGE_QUEUE_DEQUEUE);
         frame_interface* result = nullptr;
         std::swap(result, fh.frame);
         *output_frame = (rs2_frame*)result;
@@ -897,14 +1339,81 @@ void rs2_enqueue_frame(rs2_frame* frame, void* queue) BEGIN_API_CALL
     auto q = reinterpret_cast<rs2_frame_queue*>(queue);
     librealsense::frame_holder fh;
     fh.frame = (frame_interface*)frame;
-    q->queue.enqueue(std::move(fh));
+    log_latency_stage(fh.frame, RS2_FRAME_LATENCY_STAGE_QUEUE_ENQUEUE);
+    q->queue->enqueue(std::move(fh));
 }
 NOEXCEPT_RETURN(, frame, queue)
 
+rs2_frame_subscription* rs2_processing_block_subscribe(rs2_processing_block* block, int capacity, rs2_queue_policy policy, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(block);
+    VALIDATE_RANGE(capacity, 1, std::numeric_limits<int>::max());
+    VALIDATE_ENUM(policy);
+    auto pb = std::dynamic_pointer_cast<librealsense::processing_block>(block->block);
+    if (!pb)
+        throw librealsense::invalid_value_exception("Processing block does not support subscriptions");
+
+    return new rs2_frame_subscription{ pb->subscribe(capacity, policy) };
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, block, capacity, policy)
+
+void rs2_delete_frame_subscription(rs2_frame_subscription* subscription) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(subscription);
+    delete subscription;
+}
+NOEXCEPT_RETURN(, subscription)
+
+rs2_frame* rs2_subscription_wait_for_frame(rs2_frame_subscription* subscription, unsigned int timeout_ms, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(subscription);
+    librealsense::frame_holder fh;
+    if (!subscription->subscription->dequeue(&fh, timeout_ms))
+    {
+        throw std::runtime_error("Frame did not arrive in time!");
+    }
+
+    frame_interface* result = nullptr;
+    std::swap(result, fh.frame);
+    return (rs2_frame*)result;
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, subscription, timeout_ms)
+
+int rs2_subscription_poll_for_frame(rs2_frame_subscription* subscription, rs2_frame** output_frame, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(subscription);
+    VALIDATE_NOT_NULL(output_frame);
+    librealsense::frame_holder fh;
+    if (subscription->subscription->try_dequeue(&fh))
+    {
+        frame_interface* result = nullptr;
+        std::swap(result, fh.frame);
+        *output_frame = (rs2_frame*)result;
+        return true;
+    }
+
+    return false;
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0, subscription, output_frame)
+
+void rs2_subscription_set_paused(rs2_frame_subscription* subscription, int paused, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(subscription);
+    subscription->subscription->set_paused(paused != 0);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, subscription, paused)
+
+unsigned long long rs2_subscription_get_dropped_frames(const rs2_frame_subscription* subscription, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(subscription);
+    return subscription->subscription->get_dropped_count();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0, subscription)
+
 void rs2_flush_queue(rs2_frame_queue* queue, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(queue);
-    queue->queue.clear();
+    queue->queue->clear();
 }
 HANDLE_EXCEPTIONS_AND_RETURN(, queue)
 
@@ -941,6 +1450,23 @@ void rs2_hardware_reset(const rs2_device* device, rs2_error** error) BEGIN_API_C
 }
 HANDLE_EXCEPTIONS_AND_RETURN(, device)
 
+const rs2_raw_data_buffer* rs2_capture_device_state(const rs2_device* device, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    return new rs2_raw_data_buffer{ librealsense::capture_device_state(*device->device) };
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, device)
+
+void rs2_restore_device_state(const rs2_device* device, const void* state, int size, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    VALIDATE_NOT_NULL(state);
+    VALIDATE_RANGE(size, 1, std::numeric_limits<int>::max());
+    auto bytes = static_cast<const uint8_t*>(state);
+    librealsense::restore_device_state(*device->device, std::vector<uint8_t>(bytes, bytes + size));
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, device, state, size)
+
 // Verify  and provide API version encoded as integer value
 int rs2_get_api_version(rs2_error** error) BEGIN_API_CALL
 {
@@ -972,32 +1498,112 @@ rs2_context* rs2_create_mock_context(int api_version, const char* filename, cons
 }
 HANDLE_EXCEPTIONS_AND_RETURN(nullptr, api_version, filename, section)
 
-void rs2_set_region_of_interest(const rs2_sensor* sensor, int min_x, int min_y, int max_x, int max_y, rs2_error** error) BEGIN_API_CALL
+rs2_context* rs2_create_mock_context_ex(int api_version, const char* filename, const char* section, int cache_frames, rs2_error** error) BEGIN_API_CALL
 {
-    VALIDATE_NOT_NULL(sensor);
-
-    VALIDATE_LE(min_x, max_x);
-    VALIDATE_LE(min_y, max_y);
-    VALIDATE_LE(0, min_x);
-    VALIDATE_LE(0, min_y);
+    VALIDATE_NOT_NULL(filename);
+    VALIDATE_NOT_NULL(section);
+    verify_version_compatibility(api_version);
 
-    auto roi = VALIDATE_INTERFACE(sensor->sensor, librealsense::roi_sensor_interface);
-    roi->get_roi_method().set({ min_x, min_y, max_x, max_y });
+    return new rs2_context{ std::make_shared<librealsense::context>(librealsense::backend_type::playback, filename, section, RS2_RECORDING_MODE_COUNT, cache_frames != 0) };
 }
-HANDLE_EXCEPTIONS_AND_RETURN(, sensor, min_x, min_y, max_x, max_y)
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, api_version, filename, section, cache_frames)
 
-void rs2_get_region_of_interest(const rs2_sensor* sensor, int* min_x, int* min_y, int* max_x, int* max_y, rs2_error** error) BEGIN_API_CALL
+rs2_device* rs2_context_add_software_device(rs2_context* ctx, const char* name, rs2_error** error) BEGIN_API_CALL
 {
-    VALIDATE_NOT_NULL(sensor);
-    VALIDATE_NOT_NULL(min_x);
-    VALIDATE_NOT_NULL(min_y);
-    VALIDATE_NOT_NULL(max_x);
-    VALIDATE_NOT_NULL(max_y);
+    VALIDATE_NOT_NULL(ctx);
+    VALIDATE_NOT_NULL(name);
 
-    auto roi = VALIDATE_INTERFACE(sensor->sensor, librealsense::roi_sensor_interface);
-    auto rect = roi->get_roi_method().get();
+    return new rs2_device{ ctx->ctx, nullptr, ctx->ctx->add_software_device(name) };
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, ctx, name)
 
-    *min_x = rect.min_x;
+rs2_sensor* rs2_software_device_add_sensor(rs2_device* dev, const char* sensor_name, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(dev);
+    VALIDATE_NOT_NULL(sensor_name);
+    auto software_dev = VALIDATE_INTERFACE(dev->device, librealsense::software_device);
+
+    auto&& sensor = software_dev->add_software_sensor(sensor_name);
+    return new rs2_sensor{ *dev, &sensor, software_dev->find_sensor_idx(sensor) };
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, dev, sensor_name)
+
+void rs2_software_device_register_extrinsics(rs2_device* dev, const rs2_stream_profile* from, const rs2_stream_profile* to, rs2_extrinsics extrin, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(dev);
+    VALIDATE_NOT_NULL(from);
+    VALIDATE_NOT_NULL(to);
+    auto software_dev = VALIDATE_INTERFACE(dev->device, librealsense::software_device);
+
+    software_dev->register_extrinsics(*from->profile, *to->profile, extrin);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, dev, from, to)
+
+rs2_stream_profile* rs2_software_sensor_add_video_stream(rs2_sensor* sensor, rs2_video_stream video_stream, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(sensor);
+    VALIDATE_ENUM(video_stream.type);
+    VALIDATE_ENUM(video_stream.fmt);
+    auto software = VALIDATE_INTERFACE(sensor->sensor, librealsense::software_sensor);
+
+    return software->add_video_stream(video_stream)->get_c_wrapper();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, sensor)
+
+void rs2_software_sensor_on_video_frame(rs2_sensor* sensor, rs2_software_video_frame frame, rs2_error** error) BEGIN_API_CALL
+{
+    // The pixels are released even when the call fails, the sensor takes care of it from there on
+    librealsense::software_sensor* software = nullptr;
+    try
+    {
+        VALIDATE_NOT_NULL(sensor);
+        software = VALIDATE_INTERFACE(sensor->sensor, librealsense::software_sensor);
+    }
+    catch (...)
+    {
+        if (frame.deleter) frame.deleter(frame.pixels);
+        throw;
+    }
+    software->on_video_frame(frame);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, sensor)
+
+void rs2_software_sensor_add_read_only_option(rs2_sensor* sensor, rs2_option option, float val, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(sensor);
+    VALIDATE_ENUM(option);
+    auto software = VALIDATE_INTERFACE(sensor->sensor, librealsense::software_sensor);
+
+    software->add_read_only_option(option, val);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, sensor, option, val)
+
+void rs2_set_region_of_interest(const rs2_sensor* sensor, int min_x, int min_y, int max_x, int max_y, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(sensor);
+
+    VALIDATE_LE(min_x, max_x);
+    VALIDATE_LE(min_y, max_y);
+    VALIDATE_LE(0, min_x);
+    VALIDATE_LE(0, min_y);
+
+    auto roi = VALIDATE_INTERFACE(sensor->sensor, librealsense::roi_sensor_interface);
+    roi->get_roi_method().set({ min_x, min_y, max_x, max_y });
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, sensor, min_x, min_y, max_x, max_y)
+
+void rs2_get_region_of_interest(const rs2_sensor* sensor, int* min_x, int* min_y, int* max_x, int* max_y, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(sensor);
+    VALIDATE_NOT_NULL(min_x);
+    VALIDATE_NOT_NULL(min_y);
+    VALIDATE_NOT_NULL(max_x);
+    VALIDATE_NOT_NULL(max_y);
+
+    auto roi = VALIDATE_INTERFACE(sensor->sensor, librealsense::roi_sensor_interface);
+    auto rect = roi->get_roi_method().get();
+
+    *min_x = rect.min_x;
     *min_y = rect.min_y;
     *max_x = rect.max_x;
     *max_y = rect.max_y;
@@ -1018,14 +1624,22 @@ const char* rs2_camera_info_to_string(rs2_camera_info info) { return librealsens
 
 const char* rs2_frame_metadata_to_string(rs2_frame_metadata_value metadata) { return librealsense::get_string(metadata); }
 const char* rs2_timestamp_domain_to_string(rs2_timestamp_domain info){ return librealsense::get_string(info); }
+const char* rs2_frame_latency_stage_to_string(rs2_frame_latency_stage stage) { return librealsense::get_string(stage); }
+const char* rs2_queue_policy_to_string(rs2_queue_policy policy) { return librealsense::get_string(policy); }
+const char* rs2_frame_drop_stage_to_string(rs2_frame_drop_stage stage) { return librealsense::get_string(stage); }
+const char* rs2_latency_measure_to_string(rs2_latency_measure measure) { return librealsense::get_string(measure); }
 
 const char* rs2_notification_category_to_string(rs2_notification_category category) { return librealsense::get_string(category); }
 
 const char* rs2_sr300_visual_preset_to_string(rs2_sr300_visual_preset preset) { return librealsense::get_string(preset); }
 const char* rs2_log_severity_to_string(rs2_log_severity severity) { return librealsense::get_string(severity); }
+const char* rs2_thread_class_to_string(rs2_thread_class thread_class) { return librealsense::get_string(thread_class); }
+const char* rs2_metric_type_to_string(rs2_metric_type type) { return librealsense::get_string(type); }
+const char* rs2_time_source_to_string(rs2_time_source source) { return librealsense::get_string(source); }
 const char* rs2_exception_type_to_string(rs2_exception_type type) { return librealsense::get_string(type); }
 const char* rs2_extension_type_to_string(rs2_extension type) { return librealsense::get_string(type); }
 const char* rs2_playback_status_to_string(rs2_playback_status status) { return librealsense::get_string(status); }
+const char* rs2_record_compression_to_string(rs2_record_compression compression) { return librealsense::get_string(compression); }
 
 void rs2_log_to_console(rs2_log_severity min_severity, rs2_error** error) BEGIN_API_CALL
 {
@@ -1033,12 +1647,228 @@ void rs2_log_to_console(rs2_log_severity min_severity, rs2_error** error) BEGIN_
 }
 HANDLE_EXCEPTIONS_AND_RETURN(, min_severity)
 
+void rs2_enable_latency_instrumentation(int enable, rs2_error** error) BEGIN_API_CALL
+{
+    librealsense::environment::get_instance().set_latency_instrumentation(enable != 0);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, enable)
+
+void rs2_set_calibration_cache_directory(const char* directory, rs2_error** error) BEGIN_API_CALL
+{
+    librealsense::environment::get_instance().get_calibration_cache().set_directory(directory ? directory : "");
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, directory)
+
+void rs2_invalidate_calibration_cache(const char* serial, rs2_error** error) BEGIN_API_CALL
+{
+    librealsense::environment::get_instance().get_calibration_cache().invalidate(serial ? serial : "");
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, serial)
+
 void rs2_log_to_file(rs2_log_severity min_severity, const char* file_path, rs2_error** error) BEGIN_API_CALL
 {
     librealsense::log_to_file(min_severity, file_path);
 }
 HANDLE_EXCEPTIONS_AND_RETURN(, min_severity, file_path)
 
+void rs2_set_thread_policy(rs2_thread_class thread_class, unsigned long long affinity_mask, int priority, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_ENUM(thread_class);
+    librealsense::thread_policy policy;
+    policy.affinity_mask = affinity_mask;
+    policy.priority = priority;
+    librealsense::set_thread_policy(thread_class, policy);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, thread_class, affinity_mask, priority)
+
+rs2_thread_list* rs2_query_threads(rs2_error** error) BEGIN_API_CALL
+{
+    return new rs2_thread_list{ librealsense::query_threads() };
+}
+NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
+
+int rs2_get_thread_count(const rs2_thread_list* list, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(list);
+    return static_cast<int>(list->list.size());
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0, list)
+
+const char* rs2_get_thread_name(const rs2_thread_list* list, int index, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(list);
+    VALIDATE_RANGE(index, 0, (int)list->list.size() - 1);
+    return list->list[index].name.c_str();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, list, index)
+
+rs2_thread_class rs2_get_thread_class(const rs2_thread_list* list, int index, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(list);
+    VALIDATE_RANGE(index, 0, (int)list->list.size() - 1);
+    return list->list[index].thread_class;
+}
+HANDLE_EXCEPTIONS_AND_RETURN(RS2_THREAD_CLASS_COUNT, list, index)
+
+unsigned long long rs2_get_thread_os_id(const rs2_thread_list* list, int index, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(list);
+    VALIDATE_RANGE(index, 0, (int)list->list.size() - 1);
+    return list->list[index].os_id;
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0, list, index)
+
+void rs2_delete_thread_list(rs2_thread_list* list) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(list);
+    delete list;
+}
+NOEXCEPT_RETURN(, list)
+
+void rs2_enable_metrics(int enable, rs2_error** error) BEGIN_API_CALL
+{
+    librealsense::enable_metrics(enable != 0);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, enable)
+
+rs2_metrics_snapshot* rs2_query_metrics(rs2_error** error) BEGIN_API_CALL
+{
+    return new rs2_metrics_snapshot{ librealsense::query_metrics(), "" };
+}
+NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
+
+int rs2_get_metric_count(const rs2_metrics_snapshot* snapshot, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(snapshot);
+    return static_cast<int>(snapshot->samples.size());
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0, snapshot)
+
+const char* rs2_get_metric_name(const rs2_metrics_snapshot* snapshot, int index, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(snapshot);
+    VALIDATE_RANGE(index, 0, (int)snapshot->samples.size() - 1);
+    return snapshot->samples[index].name.c_str();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, snapshot, index)
+
+const char* rs2_get_metric_labels(const rs2_metrics_snapshot* snapshot, int index, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(snapshot);
+    VALIDATE_RANGE(index, 0, (int)snapshot->samples.size() - 1);
+    return snapshot->samples[index].labels.c_str();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, snapshot, index)
+
+rs2_metric_type rs2_get_metric_type(const rs2_metrics_snapshot* snapshot, int index, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(snapshot);
+    VALIDATE_RANGE(index, 0, (int)snapshot->samples.size() - 1);
+    return snapshot->samples[index].type;
+}
+HANDLE_EXCEPTIONS_AND_RETURN(RS2_METRIC_TYPE_COUNT, snapshot, index)
+
+double rs2_get_metric_value(const rs2_metrics_snapshot* snapshot, int index, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(snapshot);
+    VALIDATE_RANGE(index, 0, (int)snapshot->samples.size() - 1);
+    return snapshot->samples[index].value;
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0, snapshot, index)
+
+double rs2_get_metric_sum(const rs2_metrics_snapshot* snapshot, int index, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(snapshot);
+    VALIDATE_RANGE(index, 0, (int)snapshot->samples.size() - 1);
+    return snapshot->samples[index].sum;
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0, snapshot, index)
+
+const char* rs2_get_metrics_text(rs2_metrics_snapshot* snapshot, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(snapshot);
+    if (snapshot->text.empty()) snapshot->text = librealsense::format_metrics(snapshot->samples);
+    return snapshot->text.c_str();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, snapshot)
+
+void rs2_delete_metrics_snapshot(rs2_metrics_snapshot* snapshot) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(snapshot);
+    delete snapshot;
+}
+NOEXCEPT_RETURN(, snapshot)
+
+void rs2_enable_frame_tracking(int enable, rs2_error** error) BEGIN_API_CALL
+{
+    librealsense::enable_frame_tracking(enable != 0);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, enable)
+
+int rs2_query_outstanding_frames(rs2_outstanding_frame* frames, int max_frames, rs2_error** error) BEGIN_API_CALL
+{
+    if (max_frames > 0)
+    {
+        VALIDATE_NOT_NULL(frames);
+    }
+    auto outstanding = librealsense::query_outstanding_frames();
+    auto count = std::min(static_cast<int>(outstanding.size()), std::max(max_frames, 0));
+    std::copy(outstanding.begin(), outstanding.begin() + count, frames);
+    return static_cast<int>(outstanding.size());
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0, frames, max_frames)
+
+void rs2_start_trace(rs2_error** error) BEGIN_API_CALL
+{
+    librealsense::start_trace();
+}
+NOARGS_HANDLE_EXCEPTIONS_AND_RETURN()
+
+void rs2_stop_trace(const char* filename, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(filename);
+    librealsense::stop_trace(filename);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, filename)
+
+rs2_latency_probe* rs2_create_latency_probe(rs2_error** error) BEGIN_API_CALL
+{
+    return new rs2_latency_probe();
+}
+NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
+
+void rs2_delete_latency_probe(rs2_latency_probe* probe) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(probe);
+    delete probe;
+}
+NOEXCEPT_RETURN(, probe)
+
+void rs2_latency_probe_add_frame(rs2_latency_probe* probe, const rs2_frame* frame, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(probe);
+    VALIDATE_NOT_NULL(frame);
+    probe->probe.add_frame((librealsense::frame_interface*)frame);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, probe, frame)
+
+void rs2_latency_probe_mark_stimulus(rs2_latency_probe* probe, rs2_time_t time, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(probe);
+    probe->probe.mark_stimulus(time);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, probe, time)
+
+void rs2_latency_probe_get_stats(const rs2_latency_probe* probe, rs2_stream stream, int index, rs2_latency_measure measure, rs2_latency_stats* stats, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(probe);
+    VALIDATE_ENUM(stream);
+    VALIDATE_ENUM(measure);
+    VALIDATE_NOT_NULL(stats);
+    *stats = probe->probe.get_stats(stream, index, measure);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, probe, stream, index, measure, stats)
+
 int rs2_is_sensor_extendable_to(const rs2_sensor* sensor, rs2_extension extension_type, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(sensor);
@@ -1052,6 +1882,7 @@ int rs2_is_sensor_extendable_to(const rs2_sensor* sensor, rs2_extension extensio
         case RS2_EXTENSION_VIDEO :         return VALIDATE_INTERFACE_NO_THROW(sensor->sensor, librealsense::video_sensor_interface) != nullptr;
         case RS2_EXTENSION_ROI :           return VALIDATE_INTERFACE_NO_THROW(sensor->sensor, librealsense::roi_sensor_interface) != nullptr;
         case RS2_EXTENSION_DEPTH_SENSOR :  return VALIDATE_INTERFACE_NO_THROW(sensor->sensor, librealsense::depth_sensor) != nullptr;
+        case RS2_EXTENSION_SOFTWARE_SENSOR:return VALIDATE_INTERFACE_NO_THROW(sensor->sensor, librealsense::software_sensor) != nullptr;
         default:
             return false;
     }
@@ -1074,6 +1905,7 @@ int rs2_is_device_extendable_to(const rs2_device* dev, rs2_extension extension,
         case RS2_EXTENSION_ADVANCED_MODE : return VALIDATE_INTERFACE_NO_THROW(dev->device, librealsense::ds5_advanced_mode_interface) != nullptr;
         case RS2_EXTENSION_RECORD        : return VALIDATE_INTERFACE_NO_THROW(dev->device, librealsense::record_device)               != nullptr;
         case RS2_EXTENSION_PLAYBACK      : return VALIDATE_INTERFACE_NO_THROW(dev->device, librealsense::playback_device)             != nullptr;
+        case RS2_EXTENSION_SOFTWARE_DEVICE:return VALIDATE_INTERFACE_NO_THROW(dev->device, librealsense::software_device)             != nullptr;
         default:
             return false;
     }
@@ -1129,6 +1961,14 @@ void rs2_context_remove_device(rs2_context* ctx, const char* file, rs2_error** e
 }
 HANDLE_EXCEPTIONS_AND_RETURN(, ctx, file)
 
+void rs2_context_set_time_source(rs2_context* ctx, rs2_time_source source, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(ctx);
+    VALIDATE_ENUM(source);
+    ctx->ctx->set_time_source(source);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, ctx, source)
+
 const char* rs2_playback_device_get_file_path(const rs2_device* device, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(device);
@@ -1154,6 +1994,44 @@ void rs2_playback_seek(const rs2_device* device, long long int time, rs2_error**
 }
 HANDLE_EXCEPTIONS_AND_RETURN(, device)
 
+void rs2_playback_seek_to_frame(const rs2_device* device, const rs2_stream_profile* profile, unsigned long long int frame, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    VALIDATE_NOT_NULL(profile);
+    auto playback = VALIDATE_INTERFACE(device->device, librealsense::playback_device);
+    playback->seek_to_frame(*profile->profile, frame);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, device, profile, frame)
+
+unsigned long long int rs2_playback_get_frame_count(const rs2_device* device, const rs2_stream_profile* profile, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    VALIDATE_NOT_NULL(profile);
+    auto playback = VALIDATE_INTERFACE(device->device, librealsense::playback_device);
+    return playback->get_frame_count(*profile->profile);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0, device, profile)
+
+int rs2_playback_get_thumbnail(const rs2_device* device, const rs2_stream_profile* profile, long long int time, void* buffer, int buffer_size, int* width, int* height, rs2_format* format, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    VALIDATE_NOT_NULL(profile);
+    VALIDATE_RANGE(buffer_size, 0, std::numeric_limits<int>::max());
+    auto playback = VALIDATE_INTERFACE(device->device, librealsense::playback_device);
+    device_serializer::thumbnail thumbnail;
+    if (!playback->get_thumbnail(*profile->profile, std::chrono::nanoseconds(time), thumbnail))
+        return 0;
+
+    if (width) *width = static_cast<int>(thumbnail.width);
+    if (height) *height = static_cast<int>(thumbnail.height);
+    if (format) *format = thumbnail.format;
+    auto size = static_cast<int>(thumbnail.data.size());
+    if (buffer && size <= buffer_size)
+        memcpy(buffer, thumbnail.data.data(), thumbnail.data.size());
+    return size;
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0, device, profile, time, buffer, buffer_size)
+
 unsigned long long int rs2_playback_get_position(const rs2_device* device, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(device);
@@ -1194,6 +2072,168 @@ int rs2_playback_device_is_real_time(const rs2_device* device, rs2_error** error
 }
 HANDLE_EXCEPTIONS_AND_RETURN(0, device)
 
+void rs2_playback_device_set_batch_mode(const rs2_device* device, int batch, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    auto playback = VALIDATE_INTERFACE(device->device, librealsense::playback_device);
+    playback->set_batch_mode(batch != 0);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, device, batch)
+
+int rs2_playback_device_is_batch_mode(const rs2_device* device, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    auto playback = VALIDATE_INTERFACE(device->device, librealsense::playback_device);
+    return playback->is_batch_mode() ? 1 : 0;
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0, device)
+
+int rs2_playback_next_frameset(const rs2_device* device, rs2_frame** output_frame, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    VALIDATE_NOT_NULL(output_frame);
+    auto playback = VALIDATE_INTERFACE(device->device, librealsense::playback_device);
+
+    librealsense::frame_holder fh = playback->next_frameset();
+    if (fh)
+    {
+        frame_interface* result = nullptr;
+        std::swap(result, fh.frame);
+        *output_frame = (rs2_frame*)result;
+        return true;
+    }
+    return false;
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0, device, output_frame)
+
+void rs2_process_recording_slices(rs2_context* ctx, const char* file, int slices, long long warm_up,
+                                  rs2_recording_slice_process_ptr process, rs2_recording_slice_result_ptr on_result,
+                                  rs2_recording_slice_result_ptr release, void* user, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(ctx);
+    VALIDATE_NOT_NULL(file);
+    VALIDATE_NOT_NULL(process);
+    VALIDATE_NOT_NULL(on_result);
+    VALIDATE_NOT_NULL(release);
+
+    librealsense::sliced_playback playback(ctx->ctx, file, slices, std::chrono::nanoseconds(warm_up));
+    playback.run(
+        [process, user](int slice, librealsense::frame_holder frameset, bool warm)
+        {
+            frame_interface* f = nullptr;
+            std::swap(f, frameset.frame);
+            return process(slice, (rs2_frame*)f, warm ? 1 : 0, user);
+        },
+        [on_result, user](void* result) { on_result(result, user); },
+        [release, user](void* result) { release(result, user); });
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, ctx, file, slices, warm_up)
+
+rs2_dataset_reader* rs2_create_dataset_reader(rs2_context* ctx, const char** files, int file_count,
+                                              const rs2_stream* streams, const int* indices, int stream_count,
+                                              const rs2_dataset_config* config, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(ctx);
+    VALIDATE_NOT_NULL(files);
+    VALIDATE_NOT_NULL(streams);
+    VALIDATE_RANGE(file_count, 1, std::numeric_limits<int>::max());
+    VALIDATE_RANGE(stream_count, 1, std::numeric_limits<int>::max());
+
+    rs2_dataset_config settings{};
+    if (config)
+    {
+        VALIDATE_ENUM(config->align_to);
+        settings = *config;
+    }
+
+    std::vector<std::string> file_list;
+    for (int i = 0; i < file_count; i++)
+    {
+        VALIDATE_NOT_NULL(files[i]);
+        file_list.push_back(files[i]);
+    }
+    std::vector<std::pair<rs2_stream, int>> stream_list;
+    for (int i = 0; i < stream_count; i++)
+    {
+        VALIDATE_ENUM(streams[i]);
+        stream_list.emplace_back(streams[i], indices ? indices[i] : -1);
+    }
+
+    return new rs2_dataset_reader{ std::unique_ptr<librealsense::dataset_reader>(
+        new librealsense::dataset_reader(ctx->ctx, std::move(file_list), std::move(stream_list), settings)) };
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, ctx, files, file_count, streams, indices, stream_count, config)
+
+void rs2_delete_dataset_reader(rs2_dataset_reader* reader) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(reader);
+    delete reader;
+}
+NOEXCEPT_RETURN(, reader)
+
+rs2_dataset_batch* rs2_dataset_reader_next_batch(rs2_dataset_reader* reader, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(reader);
+    auto batch = reader->reader->next_batch();
+    return batch ? new rs2_dataset_batch{ batch } : nullptr;
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, reader)
+
+void rs2_delete_dataset_batch(rs2_dataset_batch* batch) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(batch);
+    delete batch;
+}
+NOEXCEPT_RETURN(, batch)
+
+int rs2_dataset_batch_get_size(const rs2_dataset_batch* batch, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(batch);
+    return batch->batch->size();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0, batch)
+
+int rs2_dataset_batch_get_stream_count(const rs2_dataset_batch* batch, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(batch);
+    return static_cast<int>(batch->batch->streams.size());
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0, batch)
+
+void rs2_dataset_batch_get_stream(const rs2_dataset_batch* batch, int i, rs2_dataset_stream* stream, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(batch);
+    VALIDATE_NOT_NULL(stream);
+    VALIDATE_RANGE(i, 0, static_cast<int>(batch->batch->streams.size()) - 1);
+    auto&& s = batch->batch->streams[i];
+    *stream = { s.stream, s.index, s.format, s.width, s.height, s.bpp, s.data.data(), s.timestamps.data(), s.frame_numbers.data() };
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, batch, i, stream)
+
+int rs2_dataset_batch_get_file(const rs2_dataset_batch* batch, int sample, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(batch);
+    VALIDATE_RANGE(sample, 0, batch->batch->size() - 1);
+    return batch->batch->files[sample];
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0, batch, sample)
+
+void rs2_playback_device_set_read_ahead(const rs2_device* device, unsigned int frames, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    auto playback = VALIDATE_INTERFACE(device->device, librealsense::playback_device);
+    playback->set_read_ahead(frames);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, device, frames)
+
+unsigned int rs2_playback_device_get_read_ahead(const rs2_device* device, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    auto playback = VALIDATE_INTERFACE(device->device, librealsense::playback_device);
+    return playback->get_read_ahead();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0, device)
+
 void rs2_playback_device_set_status_changed_callback(const rs2_device* device, rs2_playback_status_changed_callback* callback, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(device);
@@ -1242,6 +2282,97 @@ rs2_device* rs2_create_record_device(const rs2_device* device, const char* file,
 }
 HANDLE_EXCEPTIONS_AND_RETURN(nullptr, device, file)
 
+rs2_device* rs2_create_record_device_ex(const rs2_device* device, const char* file, rs2_record_compression compression,
+    unsigned int chunk_size, unsigned int compression_threads, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    VALIDATE_NOT_NULL(file);
+    VALIDATE_ENUM(compression);
+    VALIDATE_RANGE(compression_threads, 0, MAX_RECORD_COMPRESSION_THREADS);
+
+    device_serializer::record_settings settings;
+    settings.compression = compression;
+    settings.chunk_size = chunk_size;
+    settings.compression_threads = compression_threads;
+
+    return new rs2_device( {
+        device->ctx,
+        device->info,
+        std::make_shared<record_device>(device->device, std::make_shared<ros_writer>(file, settings))
+    });
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, device, file, compression, chunk_size, compression_threads)
+
+rs2_device* rs2_create_record_device_raw(const rs2_device* device, const char* file, rs2_record_compression compression, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    VALIDATE_NOT_NULL(file);
+    VALIDATE_ENUM(compression);
+
+    device_serializer::record_settings settings;
+    settings.compression = compression;
+    settings.native_formats = true;
+
+    return new rs2_device( {
+        device->ctx,
+        device->info,
+        std::make_shared<record_device>(device->device, std::make_shared<ros_writer>(file, settings), settings.native_formats)
+    });
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, device, file, compression)
+
+rs2_device* rs2_create_record_device_segmented(const rs2_device* device, const char* file, rs2_record_compression compression,
+    unsigned long long segment_size, unsigned int segment_duration, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    VALIDATE_NOT_NULL(file);
+    VALIDATE_ENUM(compression);
+    if (segment_size == 0 && segment_duration == 0)
+        throw invalid_value_exception("segment_size and segment_duration can not both be 0");
+
+    device_serializer::record_settings settings;
+    settings.compression = compression;
+    settings.segment_size = segment_size;
+    settings.segment_duration = std::chrono::duration_cast<device_serializer::nanoseconds>(std::chrono::seconds(segment_duration));
+
+    return new rs2_device( {
+        device->ctx,
+        device->info,
+        std::make_shared<record_device>(device->device, std::make_shared<segmented_writer>(file, settings))
+    });
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, device, file, compression, segment_size, segment_duration)
+
+rs2_device* rs2_create_record_device_native(const rs2_device* device, const char* file, rs2_record_compression compression, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    VALIDATE_NOT_NULL(file);
+    VALIDATE_ENUM(compression);
+
+    device_serializer::record_settings settings;
+    settings.compression = compression;
+
+    return new rs2_device( {
+        device->ctx,
+        device->info,
+        std::make_shared<record_device>(device->device, std::make_shared<native_writer>(file, settings))
+    });
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, device, file, compression)
+
+rs2_device* rs2_create_network_server_device(const rs2_device* device, unsigned int port, int compress_depth, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    VALIDATE_RANGE(port, 1, 65535);
+
+    return new rs2_device( {
+        device->ctx,
+        device->info,
+        std::make_shared<record_device>(device->device, std::make_shared<network_writer>(device->device, static_cast<uint16_t>(port), compress_depth != 0))
+    });
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, device, port, compress_depth)
+
 void rs2_record_device_pause(const rs2_device* device, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(device);
@@ -1258,6 +2389,33 @@ void rs2_record_device_resume(const rs2_device* device, rs2_error** error) BEGIN
 }
 HANDLE_EXCEPTIONS_AND_RETURN(, device)
 
+void rs2_record_device_set_queue_limit(const rs2_device* device, unsigned long long max_bytes, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    auto record_device = VALIDATE_INTERFACE(device->device, librealsense::record_device);
+    record_device->set_queue_limit(max_bytes);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, device, max_bytes)
+
+void rs2_record_device_set_queue_policy(const rs2_device* device, rs2_stream stream, rs2_queue_policy policy, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    VALIDATE_ENUM(stream);
+    VALIDATE_ENUM(policy);
+    auto record_device = VALIDATE_INTERFACE(device->device, librealsense::record_device);
+    record_device->set_queue_policy(stream, policy);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, device, stream, policy)
+
+void rs2_record_device_get_stats(const rs2_device* device, rs2_record_stats* stats, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(device);
+    VALIDATE_NOT_NULL(stats);
+    auto record_device = VALIDATE_INTERFACE(device->device, librealsense::record_device);
+    *stats = record_device->get_stats();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, device, stats)
+
 rs2_frame* rs2_allocate_synthetic_video_frame(rs2_source* source, const rs2_stream_profile* new_stream, rs2_frame* original,
     int new_bpp, int new_width, int new_height, int new_stride, rs2_extension frame_type, rs2_error** error) BEGIN_API_CALL
 {
@@ -1316,25 +2474,71 @@ int rs2_pipeline_poll_for_frames(rs2_pipeline * pipe, rs2_frame** output_frame,
 {
     VALIDATE_NOT_NULL(pipe);
 
-    librealsense::frame_holder fh;
-    if (pipe->pipe->poll_for_frames(&fh))
-    {
-        frame_interface* result = nullptr;
-        std::swap(result, fh.frame);
-        *output_frame = (rs2_frame*)result;
-        return true;
-    }
-    return false;
+    librealsense::frame_holder fh;
+    if (pipe->pipe->poll_for_frames(&fh))
+    {
+        frame_interface* result = nullptr;
+        std::swap(result, fh.frame);
+        *output_frame = (rs2_frame*)result;
+        return true;
+    }
+    return false;
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0, pipe, output_frame)
+
+int rs2_pipeline_wait_for_frames_batch(rs2_pipeline* pipe, rs2_frame** frames, int max_count, unsigned int timeout_ms, rs2_error ** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(pipe);
+    VALIDATE_NOT_NULL(frames);
+    VALIDATE_RANGE(max_count, 1, 1024);
+
+    std::vector<librealsense::frame_holder> batch(max_count);
+    auto count = pipe->pipe->wait_for_frames_batch(batch.data(), batch.size(), timeout_ms);
+    for (size_t i = 0; i < count; i++)
+    {
+        frames[i] = (rs2_frame*)batch[i].frame;
+        batch[i].frame = nullptr;
+    }
+    return static_cast<int>(count);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0, pipe, frames, max_count, timeout_ms)
+
+void rs2_delete_pipeline(rs2_pipeline* pipe) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(pipe);
+
+    delete pipe;
+}
+NOEXCEPT_RETURN(, pipe)
+
+void rs2_pipeline_set_processing_graph(rs2_pipeline* pipe, rs2_processing_block* graph, rs2_error ** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(pipe);
+
+    std::shared_ptr<librealsense::processing_graph> g;
+    if (graph) g = as_processing_graph(graph);
+    pipe->pipe->set_processing_graph(g);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, pipe, graph)
+
+void rs2_pipeline_get_sync_stats(rs2_pipeline* pipe, rs2_sync_stats* stats, rs2_error ** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(pipe);
+    VALIDATE_NOT_NULL(stats);
+
+    *stats = pipe->pipe->get_sync_stats();
 }
-HANDLE_EXCEPTIONS_AND_RETURN(0, pipe, output_frame)
+HANDLE_EXCEPTIONS_AND_RETURN(, pipe, stats)
 
-void rs2_delete_pipeline(rs2_pipeline* pipe) BEGIN_API_CALL
+rs2_frame_subscription* rs2_pipeline_subscribe(rs2_pipeline* pipe, int capacity, rs2_queue_policy policy, rs2_error ** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(pipe);
+    VALIDATE_RANGE(capacity, 1, std::numeric_limits<int>::max());
+    VALIDATE_ENUM(policy);
 
-    delete pipe;
+    return new rs2_frame_subscription{ pipe->pipe->subscribe(capacity, policy) };
 }
-NOEXCEPT_RETURN(, pipe)
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, pipe, capacity, policy)
 
 rs2_pipeline_profile* rs2_pipeline_start(rs2_pipeline* pipe, rs2_error ** error) BEGIN_API_CALL
 {
@@ -1351,6 +2555,21 @@ rs2_pipeline_profile* rs2_pipeline_start_with_config(rs2_pipeline* pipe, rs2_con
 }
 HANDLE_EXCEPTIONS_AND_RETURN(nullptr, pipe, config)
 
+rs2_pipeline_profile* rs2_pipeline_prepare(rs2_pipeline* pipe, rs2_config* config, rs2_error ** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(pipe);
+    VALIDATE_NOT_NULL(config);
+    return new rs2_pipeline_profile{ pipe->pipe->prepare(config->config) };
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, pipe, config)
+
+rs2_pipeline_profile* rs2_pipeline_start_prepared(rs2_pipeline* pipe, rs2_error ** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(pipe);
+    return new rs2_pipeline_profile{ pipe->pipe->start_prepared() };
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, pipe)
+
 rs2_pipeline_profile* rs2_pipeline_get_active_profile(rs2_pipeline* pipe, rs2_error ** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(pipe);
@@ -1376,6 +2595,16 @@ rs2_stream_profile_list* rs2_pipeline_profile_get_streams(rs2_pipeline_profile*
 }
 HANDLE_EXCEPTIONS_AND_RETURN(nullptr, profile)
 
+void rs2_pipeline_profile_get_frame_drops(rs2_pipeline_profile* profile, const rs2_stream_profile* stream, rs2_frame_drop_stats* stats, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(profile);
+    VALIDATE_NOT_NULL(stream);
+    VALIDATE_NOT_NULL(stats);
+
+    *stats = profile->profile->get_frame_drops(*stream->profile);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, profile, stream, stats)
+
 void rs2_delete_pipeline_profile(rs2_pipeline_profile* profile) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(profile);
@@ -1448,6 +2677,23 @@ void rs2_config_enable_record_to_file(rs2_config* config, const char* file, rs2_
 }
 HANDLE_EXCEPTIONS_AND_RETURN(, config, file)
 
+void rs2_config_enable_record_to_file_ex(rs2_config* config, const char* file, rs2_record_compression compression,
+    unsigned int chunk_size, unsigned int compression_threads, rs2_error ** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(config);
+    VALIDATE_NOT_NULL(file);
+    VALIDATE_ENUM(compression);
+    VALIDATE_RANGE(compression_threads, 0, MAX_RECORD_COMPRESSION_THREADS);
+
+    device_serializer::record_settings settings;
+    settings.compression = compression;
+    settings.chunk_size = chunk_size;
+    settings.compression_threads = compression_threads;
+
+    config->config->enable_record_to_file(file, settings);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, config, file, compression, chunk_size, compression_threads)
+
 void rs2_config_disable_stream(rs2_config* config, rs2_stream stream, rs2_error ** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(config);
@@ -1469,6 +2715,23 @@ void rs2_config_disable_all_streams(rs2_config* config, rs2_error ** error) BEGI
 }
 HANDLE_EXCEPTIONS_AND_RETURN(, config)
 
+void rs2_config_set_sync_max_wait(rs2_config* config, rs2_stream stream, float max_wait_ms, rs2_error ** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(config);
+    VALIDATE_ENUM(stream);
+    VALIDATE_RANGE(max_wait_ms, 0.f, 60000.f);
+    config->config->set_sync_max_wait(stream, max_wait_ms);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, config, stream, max_wait_ms)
+
+void rs2_config_set_frames_queue_size(rs2_config* config, int size, rs2_error ** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(config);
+    VALIDATE_RANGE(size, 1, 1024);
+    config->config->set_frames_queue_size(static_cast<unsigned int>(size));
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, config, size)
+
 rs2_pipeline_profile* rs2_config_resolve(rs2_config* config, rs2_pipeline* pipe, rs2_error ** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(config);
@@ -1502,6 +2765,33 @@ rs2_processing_block* rs2_create_sync_processing_block(rs2_error** error) BEGIN_
 }
 NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
 
+void rs2_sync_set_max_wait(rs2_processing_block* sync, rs2_stream stream, float max_wait_ms, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(sync);
+    VALIDATE_ENUM(stream);
+    VALIDATE_RANGE(max_wait_ms, 0.f, 60000.f);
+
+    as_syncer(sync)->set_max_wait(stream, max_wait_ms);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, sync, stream, max_wait_ms)
+
+void rs2_sync_get_stats(const rs2_processing_block* sync, rs2_sync_stats* stats, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(sync);
+    VALIDATE_NOT_NULL(stats);
+
+    *stats = as_syncer(sync)->get_stats();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, sync, stats)
+
+rs2_processing_block* rs2_create_cross_device_syncer(rs2_error** error) BEGIN_API_CALL
+{
+    auto block = std::make_shared<librealsense::cross_device_syncer>();
+
+    return new rs2_processing_block{ block };
+}
+NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
+
 void rs2_start_processing(rs2_processing_block* block, rs2_frame_callback* on_frame, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(block);
@@ -1515,7 +2805,7 @@ void rs2_start_processing_queue(rs2_processing_block* block, rs2_frame_queue* qu
     VALIDATE_NOT_NULL(block);
     VALIDATE_NOT_NULL(queue);
     librealsense::frame_callback_ptr callback(
-        new librealsense::frame_callback(rs2_enqueue_frame, queue));
+        new frame_queue_callback(queue), [](rs2_frame_callback* p) { p->release(); });
     block->block->set_output_callback(move(callback));
 }
 HANDLE_EXCEPTIONS_AND_RETURN(, block, queue)
@@ -1533,6 +2823,9 @@ void rs2_delete_processing_block(rs2_processing_block* block) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(block);
 
+    // Frames in flight on the worker threads still refer to the block and its output
+    if (auto pb = std::dynamic_pointer_cast<librealsense::processing_block>(block->block))
+        pb->flush_pipeline();
     delete block;
 }
 NOEXCEPT_RETURN(, block)
@@ -1550,18 +2843,31 @@ rs2_frame* rs2_extract_frame(rs2_frame* composite, int index, rs2_error** error)
 }
 HANDLE_EXCEPTIONS_AND_RETURN(nullptr, composite)
 
+rs2_frame* rs2_extract_frame_by_stream(rs2_frame* composite, rs2_stream stream, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(composite);
+    VALIDATE_ENUM(stream);
+
+    auto cf = VALIDATE_INTERFACE((frame_interface*)composite, librealsense::composite_frame);
+    auto res = cf->find_frame(stream);
+    if (!res) return nullptr;
+    res->acquire();
+    return (rs2_frame*)res;
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, composite, stream)
+
 rs2_frame* rs2_allocate_composite_frame(rs2_source* source, rs2_frame** frames, int count, rs2_error** error) BEGIN_API_CALL
 {
     VALIDATE_NOT_NULL(source)
     VALIDATE_NOT_NULL(frames)
     VALIDATE_RANGE(count, 1, 128);
 
-    std::vector<frame_holder> holders(count);
+    frameset_builder holders;
     for (int i = 0; i < count; i++)
     {
-        holders[i] = std::move(frame_holder((frame_interface*)frames[i]));
+        holders.add(frame_holder((frame_interface*)frames[i]));
     }
-    auto res = source->source->allocate_composite_frame(std::move(holders));
+    auto res = holders.build(*source->source);
 
     return (rs2_frame*)res;
 }
@@ -1581,6 +2887,9 @@ rs2_vertex* rs2_get_frame_vertices(const rs2_frame* frame, rs2_error** error) BE
 {
     VALIDATE_NOT_NULL(frame);
     auto points = VALIDATE_INTERFACE((frame_interface*)frame, librealsense::points);
+    if (points->get_vertex_format() != RS2_FORMAT_XYZ32F)
+        throw invalid_value_exception(to_string() << "Vertices are stored as " << get_string(points->get_vertex_format())
+                                                  << ", use rs2_get_frame_data to access them");
     return (rs2_vertex*)points->get_vertices();
 }
 HANDLE_EXCEPTIONS_AND_RETURN(nullptr, frame)
@@ -1601,6 +2910,58 @@ int rs2_get_frame_points_count(const rs2_frame* frame, rs2_error** error) BEGIN_
 }
 HANDLE_EXCEPTIONS_AND_RETURN(0, frame)
 
+void rs2_export_to_ply(const rs2_frame* frame, const char* fname, const rs2_frame* texture, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(frame);
+    VALIDATE_NOT_NULL(fname);
+    auto points = VALIDATE_INTERFACE((frame_interface*)frame, librealsense::points);
+    librealsense::export_to_ply(fname, *points, (frame_interface*)texture);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, frame, fname, texture)
+
+void rs2_export_to_pcd(const rs2_frame* frame, const char* fname, const rs2_frame* texture, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(frame);
+    VALIDATE_NOT_NULL(fname);
+    auto points = VALIDATE_INTERFACE((frame_interface*)frame, librealsense::points);
+    librealsense::export_to_pcd(fname, *points, (frame_interface*)texture);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, frame, fname, texture)
+
+void rs2_get_frame_latency_breakdown(const rs2_frame* frame, rs2_time_t* timestamps, int count, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(frame);
+    VALIDATE_NOT_NULL(timestamps);
+    VALIDATE_RANGE(count, 0, RS2_FRAME_LATENCY_STAGE_COUNT);
+    for (int i = 0; i < count; i++)
+        timestamps[i] = ((frame_interface*)frame)->get_latency_timestamp(static_cast<rs2_frame_latency_stage>(i));
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, frame, timestamps, count)
+
+rs2_format rs2_get_frame_vertex_format(const rs2_frame* frame, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(frame);
+    auto points = VALIDATE_INTERFACE((frame_interface*)frame, librealsense::points);
+    return points->get_vertex_format();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(RS2_FORMAT_ANY, frame)
+
+int* rs2_get_frame_point_indices(const rs2_frame* frame, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(frame);
+    auto points = VALIDATE_INTERFACE((frame_interface*)frame, librealsense::points);
+    return points->get_pixel_indices();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, frame)
+
+rs2_vertex* rs2_get_frame_normals(const rs2_frame* frame, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(frame);
+    auto points = VALIDATE_INTERFACE((frame_interface*)frame, librealsense::points);
+    return (rs2_vertex*)points->get_normals();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, frame)
+
 rs2_processing_block* rs2_create_pointcloud(rs2_error** error) BEGIN_API_CALL
 {
     auto block = std::make_shared<librealsense::pointcloud>();
@@ -1631,6 +2992,27 @@ rs2_processing_block* rs2_create_colorizer(rs2_error** error) BEGIN_API_CALL
 NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
 
 
+void rs2_get_colorizer_lut(rs2_processing_block* block, rs2_frame* depth, unsigned int* lut, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(block);
+    VALIDATE_NOT_NULL(depth);
+    VALIDATE_NOT_NULL(lut);
+
+    auto colorizer = std::dynamic_pointer_cast<librealsense::colorizer>(block->block);
+    if (!colorizer)
+        throw librealsense::invalid_value_exception("Processing block is not a colorizer");
+
+    // The frame stays owned by the caller, the wrapper holds a reference of its own
+    ((frame_interface*)depth)->acquire();
+    rs2::frame f(depth);
+    auto vf = f.as<rs2::video_frame>();
+    auto format = f.get_profile().format();
+    if (!vf || (format != RS2_FORMAT_Z16 && format != RS2_FORMAT_DISPARITY16))
+        throw librealsense::invalid_value_exception("Colors are only computed for depth frames");
+    colorizer->get_lut(vf, reinterpret_cast<uint32_t*>(lut));
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, block, depth, lut)
+
 rs2_processing_block* rs2_create_decimation_filter_block(rs2_error** error) BEGIN_API_CALL
 {
     auto block = std::make_shared<librealsense::decimation_filter>();
@@ -1655,6 +3037,253 @@ rs2_processing_block* rs2_create_spatial_filter_block(rs2_error** error) BEGIN_A
 }
 NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
 
+rs2_processing_block* rs2_create_disparity_transform_block(unsigned char transform_to_disparity, rs2_error** error) BEGIN_API_CALL
+{
+    auto block = std::make_shared<librealsense::disparity_transform>(transform_to_disparity != 0);
+
+    return new rs2_processing_block{ block };
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, transform_to_disparity)
+
+rs2_processing_block* rs2_create_distance_transform_block(rs2_error** error) BEGIN_API_CALL
+{
+    auto block = std::make_shared<librealsense::distance_transform>();
+
+    return new rs2_processing_block{ block };
+}
+NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
+
+rs2_processing_block* rs2_create_hole_filling_filter_block(rs2_error** error) BEGIN_API_CALL
+{
+    auto block = std::make_shared<librealsense::hole_filling_filter>();
+
+    return new rs2_processing_block{ block };
+}
+NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
+
+rs2_processing_block* rs2_create_threshold_crop_block(rs2_error** error) BEGIN_API_CALL
+{
+    auto block = std::make_shared<librealsense::threshold_crop_filter>();
+
+    return new rs2_processing_block{ block };
+}
+NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
+
+rs2_processing_block* rs2_create_change_detection_block(rs2_error** error) BEGIN_API_CALL
+{
+    auto block = std::make_shared<librealsense::change_detector>();
+
+    return new rs2_processing_block{ block };
+}
+NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
+
+rs2_processing_block* rs2_create_depth_statistics_block(rs2_error** error) BEGIN_API_CALL
+{
+    auto block = std::make_shared<librealsense::depth_statistics_block>();
+
+    return new rs2_processing_block{ block };
+}
+NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
+
+rs2_processing_block* rs2_create_voxel_grid_filter_block(rs2_error** error) BEGIN_API_CALL
+{
+    auto block = std::make_shared<librealsense::voxel_grid_filter>();
+
+    return new rs2_processing_block{ block };
+}
+NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
+
+rs2_processing_block* rs2_create_normal_estimation_block(rs2_error** error) BEGIN_API_CALL
+{
+    auto block = std::make_shared<librealsense::normal_estimator>();
+
+    return new rs2_processing_block{ block };
+}
+NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
+
+rs2_processing_block* rs2_create_depth_pyramid_block(rs2_error** error) BEGIN_API_CALL
+{
+    auto block = std::make_shared<librealsense::depth_pyramid>();
+
+    return new rs2_processing_block{ block };
+}
+NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
+
+rs2_processing_block* rs2_create_depth_encoder(rs2_error** error) BEGIN_API_CALL
+{
+    auto block = std::make_shared<librealsense::depth_encoder>();
+
+    return new rs2_processing_block{ block };
+}
+NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
+
+rs2_processing_block* rs2_create_depth_decoder(rs2_error** error) BEGIN_API_CALL
+{
+    auto block = std::make_shared<librealsense::depth_decoder>();
+
+    return new rs2_processing_block{ block };
+}
+NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
+
+rs2_processing_block* rs2_create_undistort_block(rs2_error** error) BEGIN_API_CALL
+{
+    auto block = std::make_shared<librealsense::undistort>();
+
+    return new rs2_processing_block{ block };
+}
+NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
+
+rs2_processing_block* rs2_create_motion_fusion_block(rs2_error** error) BEGIN_API_CALL
+{
+    auto block = std::make_shared<librealsense::motion_fusion>();
+
+    return new rs2_processing_block{ block };
+}
+NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
+
+static std::shared_ptr<librealsense::frame_exporter> as_frame_exporter(const rs2_processing_block* block)
+{
+    auto exporter = std::dynamic_pointer_cast<librealsense::frame_exporter>(block->block);
+    if (!exporter)
+        throw librealsense::invalid_value_exception("Processing block is not a frame exporter");
+    return exporter;
+}
+
+rs2_processing_block* rs2_create_frame_exporter(const char* prefix, int max_pending, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(prefix);
+    VALIDATE_RANGE(max_pending, 1, 1024);
+
+    auto block = std::make_shared<librealsense::frame_exporter>(prefix, static_cast<uint32_t>(max_pending));
+
+    return new rs2_processing_block{ block };
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, prefix, max_pending)
+
+void rs2_export_frame(rs2_processing_block* block, rs2_frame* frame, const char* filename, rs2_error** error) BEGIN_API_CALL
+{
+    // The frame is owned by the block from here on, whatever happens
+    frame_holder holder((frame_interface*)frame);
+    VALIDATE_NOT_NULL(block);
+    VALIDATE_NOT_NULL(frame);
+    VALIDATE_NOT_NULL(filename);
+
+    as_frame_exporter(block)->save(std::move(holder), filename);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, block, frame, filename)
+
+void rs2_flush_frame_exporter(rs2_processing_block* block, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(block);
+    as_frame_exporter(block)->flush();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, block)
+
+rs2_processing_block* rs2_create_filter_chain(rs2_processing_block** blocks, int count, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(blocks);
+    VALIDATE_RANGE(count, 1, std::numeric_limits<int>::max());
+
+    std::vector<std::shared_ptr<librealsense::processing_block_interface>> filters;
+    for (auto i = 0; i < count; i++)
+    {
+        VALIDATE_NOT_NULL(blocks[i]);
+        filters.push_back(blocks[i]->block);
+    }
+
+    auto block = std::make_shared<librealsense::filter_chain>(filters);
+
+    return new rs2_processing_block{ block };
+}
+HANDLE_EXCEPTIONS_AND_RETURN(nullptr, blocks, count)
+
+rs2_processing_block* rs2_create_processing_graph(rs2_error** error) BEGIN_API_CALL
+{
+    auto block = std::make_shared<librealsense::processing_graph>();
+
+    return new rs2_processing_block{ block };
+}
+NOARGS_HANDLE_EXCEPTIONS_AND_RETURN(nullptr)
+
+int rs2_processing_graph_add_node(rs2_processing_block* graph, rs2_processing_block* block, int queue_size, rs2_queue_policy policy, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(graph);
+    VALIDATE_NOT_NULL(block);
+    VALIDATE_RANGE(queue_size, 1, std::numeric_limits<int>::max());
+    VALIDATE_ENUM(policy);
+    auto g = as_processing_graph(graph);
+
+    return g->add_node(block->block, queue_size, policy);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(-1, graph, block, queue_size, policy)
+
+void rs2_processing_graph_connect(rs2_processing_block* graph, int from, int to, rs2_stream stream, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(graph);
+    VALIDATE_ENUM(stream);
+    auto g = as_processing_graph(graph);
+
+    g->connect(from, to, stream);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, graph, from, to, stream)
+
+void rs2_processing_graph_get_node_stats(const rs2_processing_block* graph, int node, rs2_processing_node_stats* stats, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(graph);
+    VALIDATE_NOT_NULL(stats);
+    auto g = as_processing_graph(graph);
+
+    *stats = g->get_node_stats(node);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, graph, node, stats)
+
+void rs2_processing_graph_set_latency_target(rs2_processing_block* graph, float latency_ms, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(graph);
+    auto g = as_processing_graph(graph);
+
+    g->set_latency_target(latency_ms);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, graph, latency_ms)
+
+void rs2_processing_graph_add_option_step(rs2_processing_block* graph, int node, rs2_option option, float value, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(graph);
+    VALIDATE_ENUM(option);
+    auto g = as_processing_graph(graph);
+
+    g->add_option_step(node, option, value);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, graph, node, option, value)
+
+void rs2_processing_graph_add_rate_step(rs2_processing_block* graph, int node, int divisor, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(graph);
+    VALIDATE_RANGE(divisor, 1, std::numeric_limits<int>::max());
+    auto g = as_processing_graph(graph);
+
+    g->add_rate_step(node, divisor);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, graph, node, divisor)
+
+int rs2_processing_graph_get_quality_level(const rs2_processing_block* graph, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(graph);
+    auto g = as_processing_graph(graph);
+
+    return g->get_quality_level();
+}
+HANDLE_EXCEPTIONS_AND_RETURN(0, graph)
+
+void rs2_processing_graph_set_node_priority(rs2_processing_block* graph, int node, int priority, float deadline_ms, rs2_error** error) BEGIN_API_CALL
+{
+    VALIDATE_NOT_NULL(graph);
+    auto g = as_processing_graph(graph);
+
+    g->set_node_priority(node, priority, deadline_ms);
+}
+HANDLE_EXCEPTIONS_AND_RETURN(, graph, node, priority, deadline_ms)
+
 
 float rs2_get_depth_scale(rs2_sensor* sensor, rs2_error** error) BEGIN_API_CALL
 {
@@ -11,13 +11,67 @@
 #include "device.h"
 #include "stream.h"
 #include "sensor.h"
+#include "tracing.h"
+#include "threading.h"
 
 namespace librealsense
 {
+    const size_t MAX_UNPACKER_OUTPUTS = 4;  // Streams a native format may be unpacked into, kept on the stack of the frame path
+
+    metric_labels sensor_base::get_metric_labels() const
+    {
+        metric_labels labels;
+        if (supports_info(RS2_CAMERA_INFO_SERIAL_NUMBER))
+            labels.push_back({ "serial", get_info(RS2_CAMERA_INFO_SERIAL_NUMBER) });
+        labels.push_back({ "sensor", get_info(RS2_CAMERA_INFO_NAME) });
+        return labels;
+    }
+
+    void sensor_base::on_frames_lost(const std::vector<std::shared_ptr<stream_profile_interface>>& requests,
+                                     unsigned long long counter, unsigned long long lost)
+    {
+        std::string streams;
+        for (auto&& request : requests)
+        {
+            if (!request) continue;
+            _source.on_frames_lost(request->get_unique_id(), lost);
+            streams += (streams.empty() ? "" : ", ") + std::string(get_string(request->get_stream_type()));
+        }
+        if (streams.empty()) return;
+
+        notification n(RS2_NOTIFICATION_CATEGORY_FRAMES_LOST, 0, RS2_LOG_SEVERITY_WARN,
+                       to_string() << lost << " frames of " << streams << " lost before reaching the host, before frame " << counter);
+        _notifications_proccessor->raise_notification(n);
+    }
+
+    void sensor_base::start_temperature_metrics()
+    {
+        _temperature_metrics.clear();
+        if (!metrics_enabled()) return;
+
+        // Reading a temperature takes a command to the device, so they are only read when a snapshot is taken
+        std::weak_ptr<sensor_base> weak = shared_from_this();
+        for (auto id : { RS2_OPTION_ASIC_TEMPERATURE, RS2_OPTION_PROJECTOR_TEMPERATURE, RS2_OPTION_MOTION_MODULE_TEMPERATURE })
+        {
+            if (!supports_option(id)) continue;
+            auto labels = get_metric_labels();
+            labels.push_back({ "source", get_string(id) });
+            _temperature_metrics.emplace_back(new sampled_gauge("rs_temperature_celsius", "Temperatures of the streaming sensors", labels,
+                [weak, id]() -> double
+            {
+                auto strong = weak.lock();
+                if (!strong || !strong->is_streaming())
+                    throw wrong_api_call_sequence_exception("Temperatures are read while streaming only");
+                return strong->get_option(id).query();
+            }));
+        }
+    }
+
     sensor_base::sensor_base(std::string name, device* dev)
         : _is_streaming(false),
           _is_opened(false),
           _notifications_proccessor(std::shared_ptr<notifications_proccessor>(new notifications_proccessor())),
+          _option_cache(std::make_shared<option_cache>()),
           _on_before_frame_callback(nullptr),
           _metadata_parsers(std::make_shared<metadata_parser_map>()),
           _on_open(nullptr),
@@ -25,6 +79,12 @@ namespace librealsense
           _profiles([this]() { return this->init_stream_profiles(); })
     {
         register_option(RS2_OPTION_FRAMES_QUEUE_SIZE, _source.get_published_size_option());
+        register_option(RS2_OPTION_CALLBACK_LANES, _source.get_callback_lanes_option());
+        register_option(RS2_OPTION_FRAME_POOL_HIGH_WATER_MARK, _source.get_buffer_pool_option());
+
+        //Notifications report changes of the device state, which may change option values
+        auto cache = _option_cache;
+        _notifications_proccessor->add_observer([cache](const notification&) { cache->invalidate(); });
 
         register_metadata(RS2_FRAME_METADATA_TIME_OF_ARRIVAL, std::make_shared<librealsense::md_time_of_arrival_parser>());
 
@@ -52,6 +112,14 @@ namespace librealsense
         _notifications_proccessor->set_callback(std::move(callback));
     }
 
+    void sensor_base::set_frame_allocator(frame_allocator_ptr allocator, size_t alignment)
+    {
+        if (_is_streaming)
+            throw wrong_api_call_sequence_exception("Frame allocator can not be changed while streaming!");
+
+        _source.set_frame_allocator(allocator, alignment);
+    }
+
     std::shared_ptr<notifications_proccessor> sensor_base::get_notifications_proccessor()
     {
         return _notifications_proccessor;
@@ -79,21 +147,77 @@ namespace librealsense
     }
 
     std::vector<request_mapping> sensor_base::resolve_requests(stream_profiles requests)
+    {
+        // Opening the same profiles again reuses the result of the search
+        requests_key key;
+        for (auto&& r : requests)
+        {
+            auto p = to_profile(r.get());
+            key.push_back(std::make_tuple(p.stream, p.index, p.width, p.height, p.fps, p.format));
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_resolved_requests_mutex);
+            auto it = _resolved_requests.find(key);
+            if (it != _resolved_requests.end())
+            {
+                std::vector<request_mapping> results;
+                for (auto&& resolved : it->second)
+                {
+                    request_mapping mapping;
+                    mapping.profile = resolved.profile;
+                    mapping.pf = &_pixel_formats[resolved.pf];
+                    mapping.unpacker = &mapping.pf->unpackers[resolved.unpacker];
+                    for (auto i : resolved.requests)
+                        mapping.original_requests.push_back(requests[i]);
+                    results.push_back(mapping);
+                }
+                return results;
+            }
+        }
+
+        auto results = search_requests(requests);
+
+        std::vector<resolved_mapping> resolved;
+        for (auto&& mapping : results)
+        {
+            resolved_mapping r{ mapping.profile,
+                                static_cast<size_t>(mapping.pf - _pixel_formats.data()),
+                                static_cast<size_t>(mapping.unpacker - mapping.pf->unpackers.data()), {} };
+            for (auto&& original : mapping.original_requests)
+                r.requests.push_back(std::distance(requests.begin(), std::find(requests.begin(), requests.end(), original)));
+            resolved.push_back(r);
+        }
+        std::lock_guard<std::mutex> lock(_resolved_requests_mutex);
+        _resolved_requests[key] = resolved;
+        return results;
+    }
+
+    std::vector<request_mapping> sensor_base::search_requests(stream_profiles requests)
     {
         // per requested profile, find all 4ccs that support that request.
         std::map<int, std::set<uint32_t>> legal_fourccs;
-        auto profiles = get_stream_profiles();
         for (auto&& r : requests)
         {
             auto sp = to_profile(r.get());
-            for (auto&& mode : profiles)
+            auto&& fourccs = get_native_fourccs(sp.width, sp.height, sp.fps);
+            legal_fourccs[sp.index].insert(fourccs.begin(), fourccs.end()); // TODO: Stread ID???
+        }
+
+        // per requested profile, the pixel format / unpacker combinations that can supply it,
+        // so the search below does not evaluate them again on every pass
+        std::map<std::shared_ptr<stream_profile_interface>, std::set<const pixel_format_unpacker*>> supported_by;
+        for (auto&& r : requests)
+        {
+            auto sp = to_profile(r.get());
+            auto&& fourccs = legal_fourccs[sp.index];
+            for (auto&& pf : _pixel_formats)
             {
-                if (auto backend_profile = dynamic_cast<backend_stream_profile*>(mode.get()))
+                if (!fourccs.count(pf.fourcc)) continue;
+                for (auto&& unpacker : pf.unpackers)
                 {
-                    auto m = to_profile(mode.get());
-
-                    if (m.fps == sp.fps && m.height == sp.height && m.width == sp.width)
-                        legal_fourccs[sp.index].insert(backend_profile->get_backend_profile().format); // TODO: Stread ID???
+                    if (unpacker.satisfies(sp))
+                        supported_by[r].insert(&unpacker);
                 }
             }
         }
@@ -110,16 +234,14 @@ namespace librealsense
             auto best_unpacker = &_pixel_formats.front().unpackers.front();
             for (auto&& pf : _pixel_formats)
             {
-                // Speeds up algorithm by skipping obviously useless 4ccs
-                // if (std::none_of(begin(legal_fourccs), end(legal_fourccs), [&](const uint32_t fourcc) {return fourcc == pf.fourcc; })) continue;
                 for (auto&& unpacker : pf.unpackers)
                 {
+                    // only count if the 4cc can be unpacked into the relevant stream/format
+                    // and also, the pixel format can be streamed in the requested dimensions/fps.
                     auto count = static_cast<int>(std::count_if(begin(requests), end(requests),
-                        [&pf, &legal_fourccs, &unpacker](const std::shared_ptr<stream_profile_interface>& r)
+                        [&supported_by, &unpacker](const std::shared_ptr<stream_profile_interface>& r)
                     {
-                        // only count if the 4cc can be unpacked into the relevant stream/format
-                        // and also, the pixel format can be streamed in the requested dimensions/fps.
-                        return unpacker.satisfies(to_profile(r.get())) && legal_fourccs[r->get_stream_index()].count(pf.fourcc);
+                        return supported_by[r].count(&unpacker) > 0;
                     }));
 
                     // Here we check if the current pixel format / unpacker combination is better than the current best.
@@ -142,9 +264,9 @@ namespace librealsense
             if (max == 0) break;
 
             requests.erase(std::remove_if(begin(requests), end(requests),
-                [best_unpacker, best_pf, &results, &legal_fourccs, this](const std::shared_ptr<stream_profile_interface>& r)
+                [best_unpacker, best_pf, &results, &supported_by, this](const std::shared_ptr<stream_profile_interface>& r)
             {
-                if (best_unpacker->satisfies(to_profile(r.get())) && legal_fourccs[r->get_stream_index()].count(best_pf->fourcc))
+                if (supported_by[r].count(best_unpacker))
                 {
                     auto request = dynamic_cast<const video_stream_profile*>(r.get());
                     if (!request) {
@@ -175,6 +297,37 @@ namespace librealsense
         throw invalid_value_exception("Subdevice unable to satisfy stream requests!");
     }
 
+    const std::set<uint32_t>& sensor_base::get_native_fourccs(uint32_t width, uint32_t height, uint32_t fps)
+    {
+        static const std::set<uint32_t> none;
+
+        // The native modes of the sensor do not change, they are indexed once
+        std::shared_ptr<native_fourccs_table> table;
+        {
+            std::lock_guard<std::mutex> lock(_resolved_requests_mutex);
+            table = _native_fourccs;
+        }
+        if (!table)
+        {
+            table = std::make_shared<native_fourccs_table>();
+            for (auto&& mode : get_stream_profiles())
+            {
+                if (auto backend_profile = dynamic_cast<backend_stream_profile*>(mode.get()))
+                {
+                    auto m = to_profile(mode.get());
+                    (*table)[std::make_tuple(m.width, m.height, m.fps)].insert(backend_profile->get_backend_profile().format);
+                }
+            }
+            std::lock_guard<std::mutex> lock(_resolved_requests_mutex);
+            if (!_native_fourccs)
+                _native_fourccs = table;
+            table = _native_fourccs;
+        }
+
+        auto it = table->find(std::make_tuple(width, height, fps));
+        return it != table->end() ? it->second : none;
+    }
+
     uvc_sensor::~uvc_sensor()
     {
         try
@@ -184,11 +337,36 @@ namespace librealsense
 
             if (_is_opened)
                 uvc_sensor::close();
+
+            // The sensor can no longer be locked by its power holders, the standby power is released directly
+            if (_standby_power)
+            {
+                _standby_power.reset();
+                release_power();
+            }
+            for (; _held_power > 0; --_held_power)
+                release_power();
+
+            // Idle power is dropped now rather than at the deadline
+            std::lock_guard<std::mutex> lock(_power_lock);
+            if (_powered_idle)
+            {
+                _powered_idle = false;
+                _device->set_power_state(platform::D3);
+            }
         }
         catch(...)
         {
             LOG_ERROR("An error has occurred while stop_streaming()!");
         }
+
+        // Without idle power the thread leaves its loop
+        {
+            std::lock_guard<std::mutex> lock(_power_lock);
+            _powered_idle = false;
+        }
+        _power_cv.notify_all();
+        if (_power_idle_thread.joinable()) _power_idle_thread.join();
     }
 
     region_of_interest_method& uvc_sensor::get_roi_method() const
@@ -301,7 +479,11 @@ namespace librealsense
     {
         if (_pixel_formats.end() == std::find_if(_pixel_formats.begin(), _pixel_formats.end(),
             [&pf](const native_pixel_format& cur) { return cur.fourcc == pf.fourcc; }))
+        {
+            std::lock_guard<std::mutex> lock(_resolved_requests_mutex);
             _pixel_formats.push_back(pf);
+            _resolved_requests.clear();
+        }
         else
             throw invalid_value_exception(to_string()
                 << "Pixel format " << std::hex << std::setw(8) << std::setfill('0') << pf.fourcc
@@ -312,7 +494,11 @@ namespace librealsense
     {
         auto it = std::find_if(_pixel_formats.begin(), _pixel_formats.end(), [&pf](const native_pixel_format& cur) { return cur.fourcc == pf.fourcc; });
         if (it != _pixel_formats.end())
+        {
+            std::lock_guard<std::mutex> lock(_resolved_requests_mutex);
             _pixel_formats.erase(it);
+            _resolved_requests.clear();
+        }
     }
 
     void uvc_sensor::open(const stream_profiles& requests)
@@ -324,105 +510,227 @@ namespace librealsense
             throw wrong_api_call_sequence_exception("open(...) failed. UVC device is already opened!");
 
         auto on = std::unique_ptr<power>(new power(std::dynamic_pointer_cast<uvc_sensor>(shared_from_this())));
+        _standby_power.reset();
+        frame_memory_policy memory_policy;
+        memory_policy.huge_pages = static_cast<frame_huge_pages>(_huge_pages);
+        memory_policy.numa_node = _numa_node;
+        _source.set_frame_memory(memory_policy);
         _source.init(_metadata_parsers);
         _source.set_sensor(this->shared_from_this());
         auto mapping = resolve_requests(requests);
 
+        // Released again if opening fails, as the reservation is only kept once the sensor is opened
+        auto bandwidth = reserve_bandwidth(get_info(RS2_CAMERA_INFO_NAME), _device->get_device_location(),
+                                           mapping, _device->get_profiles());
+
         auto timestamp_reader = _timestamp_reader.get();
 
         std::vector<platform::stream_profile> commited;
 
+        // Realtime sensors keep the frame path free of allocations, blocking and logging: the frame buffers are
+        // reserved here, frames are unpacked on the capture thread and none of them borrows a kernel buffer
+        bool realtime = _realtime_mode != 0;
+
         for (auto&& mode : mapping)
         {
+            if (mode.unpacker->outputs.size() > MAX_UNPACKER_OUTPUTS)
+                throw invalid_value_exception(to_string() << "open(...) failed. Unpacker has " << mode.unpacker->outputs.size() << " outputs");
+
+            // Frames of metadata only streams skip the unpacking and the frame buffers, and return the kernel
+            // buffer right away. An unpacker fills all its outputs at once, so all of them have to be set
+            bool metadata_only = std::all_of(mode.unpacker->outputs.begin(), mode.unpacker->outputs.end(),
+                [this](const std::pair<stream_descriptor, rs2_format>& output)
+            {
+                return (_metadata_only_streams & (1u << output.first.type)) != 0;
+            });
+
+            // Plain copies may instead expose the backend buffer directly, as long as enough
+            // kernel buffers remain queued for the driver. The rest of the frames are still copied
+            uint32_t zero_copy_buffers = is_plain_copy(*mode.unpacker) && !realtime && !metadata_only ? _zero_copy_buffers : 0;
+
+            // Payloads smaller than the frame unpacked from them are kept for recorders, see keep_native_payloads
+            bool keep_native = _keep_native_payloads && mode.unpacker->outputs.size() == 1 && !is_plain_copy(*mode.unpacker) && !metadata_only;
+            auto native_fourcc = mode.pf->fourcc;
+
+            auto frameset = _intra_sensor_framesets && mode.unpacker->outputs.size() > 1;
+            auto decimation = std::max<uint32_t>(_frame_rate_decimation, 1);
+            uint32_t decimation_count = 0;
+            auto lent_buffers = std::make_shared<std::atomic<uint32_t>>(0);
+
+            // Large frames may be unpacked in row bands by the shared worker threads
+            auto unpack_bands = get_band_source_bpp(*mode.unpacker) && !realtime ? _unpack_threads : 1;
+
+            // The profile requested for every output of the unpacker and its callback lane, resolved once rather than for every frame
+            std::vector<std::shared_ptr<stream_profile_interface>> output_requests;
+            std::vector<frame_source::callback_lane*> output_lanes;
+            std::vector<metric_counter*> received_metrics, dropped_metrics, lost_metrics;
+            frame_counter_tracker counter_tracker;
+            for (auto&& output : mode.unpacker->outputs)
+            {
+                auto labels = get_metric_labels();
+                labels.push_back({ "stream", to_string() << get_string(output.first.type) << (output.first.index ? to_string() << " " << output.first.index : std::string()) });
+                received_metrics.push_back(&get_counter("rs_frames_received_total", "Frames delivered by the sensors", labels));
+                dropped_metrics.push_back(&get_counter("rs_frames_dropped_total", "Frames the sensors dropped for lack of a free frame", labels));
+                lost_metrics.push_back(&get_counter("rs_frames_lost_total", "Frames missing from the hardware frame counters", labels));
+
+                std::shared_ptr<stream_profile_interface> request = nullptr;
+                for (auto&& original_prof : mode.original_requests)
+                {
+                    if (original_prof->get_format() == output.second &&
+                        original_prof->get_stream_type() == output.first.type &&
+                        original_prof->get_stream_index() == output.first.index)
+                    {
+                        request = original_prof;
+                    }
+                }
+                output_requests.push_back(request);
+                output_lanes.push_back(request ? _source.open_lane(request->get_unique_id()) : nullptr);
+
+                if (realtime && !metadata_only)
+                    _source.reserve_frames(stream_to_frame_types(output.first.type),
+                                           mode.profile.width * mode.profile.height * get_image_bpp(output.second) / 8);
+            }
+
             try
             {
                 _device->probe_and_commit(mode.profile,
-                [this, mode, timestamp_reader, requests](platform::stream_profile p, platform::frame_object f, std::function<void()> continuation) mutable
+                [this, mode, timestamp_reader, requests, zero_copy_buffers, lent_buffers, unpack_bands, output_requests, output_lanes, realtime, metadata_only, keep_native, native_fourcc, frameset, decimation, decimation_count, received_metrics, dropped_metrics, lost_metrics, counter_tracker](platform::stream_profile p, platform::frame_object f, std::function<void()> continuation) mutable
                 {
                     auto system_time = environment::get_instance().get_time_service()->get_time();
+                    auto arrival_time = get_latency_time();
 
                     if (!this->is_streaming())
                     {
-                        LOG_WARNING("Frame received with streaming inactive,"
-                            << librealsense::get_string(mode.unpacker->outputs.front().first.type)
-                            << mode.unpacker->outputs.front().first.index
-                                << ", Arrived," << std::fixed << system_time);
+                        if (!realtime)
+                            LOG_WARNING("Frame received with streaming inactive,"
+                                << librealsense::get_string(mode.unpacker->outputs.front().first.type)
+                                << mode.unpacker->outputs.front().first.index
+                                    << ", Arrived," << std::fixed << system_time);
                         return;
                     }
 
-                    frame_continuation release_and_enqueue(continuation, f.pixels);
+                    // Determine the timestamp for this frame, the counters of the frames skipped below are followed too
+                    auto frame_ts = timestamp_reader->read_frame_timestamp(mode, f);
+                    if (frame_ts.domain == RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK)
+                    {
+                        if (auto lost = counter_tracker.update(frame_ts.counter))
+                        {
+                            for (auto&& metric : lost_metrics) metric->add(lost);
+                            on_frames_lost(output_requests, frame_ts.counter, lost);
+                        }
+                    }
+                    else counter_tracker.reset();
 
-                    // Ignore any frames which appear corrupted or invalid
-                    // Determine the timestamp for this frame
-                    auto timestamp = timestamp_reader->get_frame_timestamp(mode, f);
-                    auto timestamp_domain = timestamp_reader->get_frame_timestamp_domain(mode, f);
+                    // Frames skipped by the decimation only return the kernel buffer
+                    if (decimation > 1 && decimation_count++ % decimation)
+                    {
+                        continuation();
+                        return;
+                    }
 
-                    auto frame_counter = timestamp_reader->get_frame_counter(mode, f);
+                    auto requires_processing = !metadata_only && mode.requires_processing();
+                    if (requires_processing && zero_copy_buffers)
+                    {
+                        if (lent_buffers->fetch_add(1) < zero_copy_buffers)
+                        {
+                            requires_processing = false;
+                            continuation = [continuation, lent_buffers]() { continuation(); --(*lent_buffers); };
+                        }
+                        else --(*lent_buffers);
+                    }
 
-                    auto requires_processing = mode.requires_processing();
+                    frame_continuation release_and_enqueue(std::move(continuation), f.pixels);
+
+                    auto timestamp = frame_ts.timestamp;
+                    auto timestamp_domain = frame_ts.domain;
+
+                    // The model of the device clock is fitted to the arrival times of the frames of all its sensors
+                    if (_global_time_enabled && timestamp_domain == RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK)
+                    {
+                        timestamp = _clock_model->add_and_map(timestamp, system_time);
+                        timestamp_domain = RS2_TIMESTAMP_DOMAIN_GLOBAL_TIME;
+                    }
+
+                    auto frame_counter = frame_ts.counter;
 
                     auto width = mode.profile.width;
                     auto height = mode.profile.height;
 
-                    std::vector<byte *> dest;
-                    std::vector<frame_holder> refs;
+                    std::array<byte*, MAX_UNPACKER_OUTPUTS> dest;
+                    std::array<frame_holder, MAX_UNPACKER_OUTPUTS> refs;
+                    size_t outputs = 0;
 
                     auto&& unpacker = *mode.unpacker;
                     for (auto&& output : unpacker.outputs)
                     {
-                        LOG_DEBUG("FrameAccepted," << librealsense::get_string(output.first.type) << "," << std::dec << frame_counter
-                            << output.first.index << "," << frame_counter
-                            << ",Arrived," << std::fixed << system_time
-                            << ",TS," << std::fixed << timestamp << ",TS_Domain," << rs2_timestamp_domain_to_string(timestamp_domain));
-
-                        std::shared_ptr<stream_profile_interface> request = nullptr;
-                        for (auto&& original_prof : mode.original_requests)
-                        {
-                            if (original_prof->get_format() == output.second &&
-                                original_prof->get_stream_type() == output.first.type &&
-                                original_prof->get_stream_index() == output.first.index)
-                            {
-                                request = original_prof;
-                            }
-                        }
+                        if (!realtime)
+                            LOG_DEBUG("FrameAccepted," << librealsense::get_string(output.first.type) << "," << std::dec << frame_counter
+                                << output.first.index << "," << frame_counter
+                                << ",Arrived," << std::fixed << system_time
+                                << ",TS," << std::fixed << timestamp << ",TS_Domain," << rs2_timestamp_domain_to_string(timestamp_domain));
 
+                        auto&& request = output_requests[outputs];
                         auto bpp = get_image_bpp(output.second);
                         frame_additional_data additional_data(timestamp,
                             frame_counter,
                             system_time,
                             static_cast<uint8_t>(f.metadata_size),
                             (const uint8_t*)f.metadata);
+                        additional_data.latency_breakdown[RS2_FRAME_LATENCY_STAGE_BACKEND_ARRIVAL] = arrival_time;
 
-                        frame_holder frame = _source.alloc_frame(stream_to_frame_types(output.first.type), width * height * bpp / 8, additional_data, requires_processing);
+                        auto size = metadata_only ? 0 : width * height * bpp / 8;
+                        frame_holder frame = _source.alloc_frame(stream_to_frame_types(output.first.type), size, additional_data, requires_processing);
                         if (frame.frame)
                         {
                             auto video = (video_frame*)frame.frame;
-                            video->assign(width, height, width * bpp / 8, bpp);
+                            if (metadata_only) video->assign(0, 0, 0, bpp);
+                            else video->assign(width, height, width * bpp / 8, bpp);
+                            if (keep_native && f.frame_size < static_cast<size_t>(size))
+                            {
+                                auto native = std::make_shared<native_payload>();
+                                native->fourcc = native_fourcc;
+                                native->data.assign(static_cast<const byte*>(f.pixels), static_cast<const byte*>(f.pixels) + f.frame_size);
+                                video->native = std::move(native);
+                            }
                             video->set_timestamp_domain(timestamp_domain);
-                            dest.push_back(const_cast<byte*>(video->get_frame_data()));
+                            dest[outputs] = const_cast<byte*>(video->get_frame_data());
                             frame->set_stream(request);
-                            refs.push_back(std::move(frame));
+                            refs[outputs++] = std::move(frame);
                         }
                         else
                         {
-                            LOG_INFO("Dropped frame. alloc_frame(...) returned nullptr");
+                            if (!realtime)
+                                LOG_INFO("Dropped frame. alloc_frame(...) returned nullptr");
+                            if (request) _source.on_frame_dropped(request->get_unique_id());
+                            dropped_metrics[outputs]->add();
                             return;
                         }
-
-                        // Obtain buffers for unpacking the frame
-                        //dest.push_back(archive->alloc_frame(output.first, additional_data, requires_processing));
                     }
 
                     // Unpack the frame
-                    if (requires_processing && (dest.size() > 0))
+                    if (requires_processing && outputs > 0)
                     {
-                        unpacker.unpack(dest.data(), reinterpret_cast<const byte *>(f.pixels), width * height);
+                        RS2_TRACE_SCOPE("unpack", frame_counter);
+                        if (unpacker.decode)
+                            unpacker.decode(dest.data(), reinterpret_cast<const byte *>(f.pixels), f.frame_size, width, height);
+                        else if (unpack_bands > 1)
+                            unpack_in_bands(environment::get_instance().get_worker_pool(), unpacker,
+                                            dest.data(), reinterpret_cast<const byte *>(f.pixels), width, height, unpack_bands);
+                        else
+                            unpacker.unpack(dest.data(), reinterpret_cast<const byte *>(f.pixels), width * height);
                     }
+                    auto unpack_time = get_latency_time();
 
                     // If any frame callbacks were specified, dispatch them now
-                    for (auto&& pref : refs)
+                    size_t ready = 0;
+                    std::array<frame_source::callback_lane*, MAX_UNPACKER_OUTPUTS> ready_lanes;
+                    for (size_t i = 0; i < outputs; i++)
                     {
-                        if (!requires_processing)
+                        auto&& pref = refs[i];
+                        log_latency_stage(pref, RS2_FRAME_LATENCY_STAGE_UNPACK_DONE, unpack_time);
+                        received_metrics[i]->add();
+
+                        if (!requires_processing && !metadata_only)
                         {
                             pref->attach_continuation(std::move(release_and_enqueue));
                         }
@@ -434,10 +742,29 @@ namespace librealsense
                             _on_before_frame_callback(stream_type, pref, std::move(callback));
                         }
 
-                        if (pref->get_stream().get())
-                            _source.invoke_callback(std::move(pref));
+                        if (!pref->get_stream().get()) continue;
+                        if (!frameset) _source.invoke_callback(std::move(pref), output_lanes[i]);
+                        else
+                        {
+                            ready_lanes[ready] = output_lanes[i];
+                            if (ready++ != i) refs[ready - 1] = std::move(pref);
+                        }
                     }
-                });
+
+                    // The outputs of a payload are in sync by construction, so they leave as one frameset
+                    // and the syncer only matches them with the other payloads
+                    if (ready > 1)
+                    {
+                        frame_holder set(_source.allocate_composite_frame(refs.data(), ready));
+                        if (set)
+                        {
+                            _source.invoke_callback(std::move(set), ready_lanes[0]);
+                            ready = 0;
+                        }
+                    }
+                    for (size_t i = 0; i < ready; i++)
+                        _source.invoke_callback(std::move(refs[i]), ready_lanes[i]);
+                }, DEFAULT_V4L2_FRAME_BUFFERS + zero_copy_buffers);
             }
             catch(...)
             {
@@ -451,11 +778,13 @@ namespace librealsense
         }
 
         _internal_config = commited;
+        get_gauge("rs_kernel_buffers", "Kernel buffers the sensors stream into", get_metric_labels()).set(_device->get_buffer_count());
 
         if (_on_open)
             _on_open(_internal_config);
 
         _power = move(on);
+        _bandwidth = move(bandwidth);
         _is_opened = true;
 
         try {
@@ -474,6 +803,7 @@ namespace librealsense
                 catch (...) {}
             }
             reset_streaming();
+            _bandwidth.reset();
             _is_opened = false;
             throw;
         }
@@ -492,7 +822,12 @@ namespace librealsense
             _device->close(profile);
         }
         reset_streaming();
-        _power.reset();
+        _bandwidth.reset();
+        // In warm restart mode the device stays powered, keeping the buffers the backend did not free
+        if (_warm_restart)
+            _standby_power = std::move(_power);
+        else
+            _power.reset();
         _is_opened = false;
     }
 
@@ -513,6 +848,7 @@ namespace librealsense
 
         _is_streaming = true;
         _device->start_callbacks();
+        start_temperature_metrics();
     }
 
     void uvc_sensor::stop()
@@ -523,6 +859,8 @@ namespace librealsense
 
         _is_streaming = false;
         _device->stop_callbacks();
+        _source.stop_lanes();
+        _temperature_metrics.clear();
     }
 
 
@@ -538,6 +876,12 @@ namespace librealsense
         std::lock_guard<std::mutex> lock(_power_lock);
         if (_user_count.fetch_add(1) == 0)
         {
+            // Still powered from its last use, with the extension units initialized
+            if (_powered_idle)
+            {
+                _powered_idle = false;
+                return;
+            }
             _device->set_power_state(platform::D0);
             for (auto& xu : _xus) _device->init_xu(xu);
         }
@@ -546,10 +890,67 @@ namespace librealsense
     void uvc_sensor::release_power()
     {
         std::lock_guard<std::mutex> lock(_power_lock);
-        if (_user_count.fetch_add(-1) == 1)
+        if (_user_count.fetch_add(-1) != 1)
+            return;
+
+        if (!_power_idle_timeout)
         {
             _device->set_power_state(platform::D3);
+            return;
+        }
+
+        _powered_idle = true;
+        _power_idle_deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(_power_idle_timeout);
+        if (!_power_idle_thread_running)
+        {
+            // The previous thread left the loop, holding the lock, so it can be joined right away
+            if (_power_idle_thread.joinable()) _power_idle_thread.join();
+            _power_idle_thread_running = true;
+            _power_idle_thread = std::thread([this]() { power_idle_loop(); });
+        }
+    }
+
+    void uvc_sensor::power_idle_loop()
+    {
+        thread_registration registration("rs-power-idle", RS2_THREAD_CLASS_IO);
+        std::unique_lock<std::mutex> lock(_power_lock);
+        // Users coming and going meanwhile only move the deadline
+        while (_powered_idle)
+        {
+            if (std::chrono::steady_clock::now() < _power_idle_deadline)
+            {
+                _power_cv.wait_until(lock, _power_idle_deadline);
+                continue;
+            }
+
+            _powered_idle = false;
+            try
+            {
+                _device->set_power_state(platform::D3);
+            }
+            catch (const std::exception& e)
+            {
+                LOG_WARNING("Failed to power down the idle sensor, " << e.what());
+            }
         }
+        _power_idle_thread_running = false;
+    }
+
+    void uvc_sensor::hold_power()
+    {
+        acquire_power();
+        _held_power.fetch_add(1);
+    }
+
+    void uvc_sensor::release_held_power()
+    {
+        int held = _held_power.load();
+        do
+        {
+            if (held <= 0)
+                throw wrong_api_call_sequence_exception("The power of the sensor is not held");
+        } while (!_held_power.compare_exchange_weak(held, held - 1));
+        release_power();
     }
 
     bool info_container::supports_info(rs2_camera_info info) const
@@ -607,6 +1008,21 @@ namespace librealsense
         register_option(id, std::make_shared<uvc_pu_option>(*this, id));
     }
 
+    std::vector<float> uvc_sensor::query_options(const std::vector<rs2_option>& ids) const
+    {
+        auto self = std::dynamic_pointer_cast<uvc_sensor>(const_cast<uvc_sensor*>(this)->shared_from_this());
+        power on(self);
+        platform::uvc_device_lease lease(*_device);
+        return sensor_base::query_options(ids);
+    }
+
+    void uvc_sensor::set_options(const std::vector<std::pair<rs2_option, float>>& values)
+    {
+        power on(std::dynamic_pointer_cast<uvc_sensor>(shared_from_this()));
+        platform::uvc_device_lease lease(*_device);
+        sensor_base::set_options(values);
+    }
+
     void uvc_sensor::try_register_pu(rs2_option id)
     {
         try
@@ -646,8 +1062,13 @@ namespace librealsense
       _hid_device(hid_device),
       _is_configured_stream(RS2_STREAM_COUNT),
       _hid_iio_timestamp_reader(move(hid_iio_timestamp_reader)),
-      _custom_hid_timestamp_reader(move(custom_hid_timestamp_reader))
+      _custom_hid_timestamp_reader(move(custom_hid_timestamp_reader)),
+      _motion_batch_size(10)
     {
+        register_option(RS2_OPTION_MOTION_BATCH_SIZE,
+            std::make_shared<ptr_option<uint32_t>>(1, 100, 1, 10, &_motion_batch_size,
+                "Number of motion samples carried by every frame of the batched motion format, takes effect on next start"));
+
         std::map<std::string, uint32_t> frequency_per_sensor;
         for (auto& elem : sensor_name_and_hid_profiles)
             frequency_per_sensor.insert(make_pair(elem.first, elem.second.fps));
@@ -784,84 +1205,141 @@ namespace librealsense
         _source.init(_metadata_parsers);
         _source.set_sensor(this->shared_from_this());
 
-        _hid_device->start_capture([this](const platform::sensor_data& sensor_data)
+        // Lane of the stream requested from every iio sensor, resolved once rather than for every sample
+        std::map<std::string, frame_source::callback_lane*> lanes;
+        for (auto&& kvp : _hid_mapping)
+            lanes[kvp.first] = _source.open_lane((*kvp.second.original_requests.begin())->get_unique_id());
+
+        size_t batch_size = _motion_batch_size;
+        for (auto&& batch : _motion_batches)
+        {
+            batch.clear();
+            batch.reserve(batch_size);
+        }
+        for (auto&& counters : _frame_counters) counters.reset();
+
+        // Samples delivered together share their arrival times
+        _hid_device->start_batch_capture([this, batch_size, lanes](const platform::sensor_data* samples, size_t count)
         {
             auto system_time = environment::get_instance().get_time_service()->get_time();
-            auto timestamp_reader = _hid_iio_timestamp_reader.get();
-
-            // TODO:
-            static const std::string custom_sensor_name = "custom";
-            auto sensor_name = sensor_data.sensor.name;
-            bool is_custom_sensor = false;
-            static const uint32_t custom_source_id_offset = 16;
-            uint8_t custom_gpio = 0;
-            auto custom_stream_type = RS2_STREAM_ANY;
-            if (sensor_name == custom_sensor_name)
+            auto arrival_time = get_latency_time();
+
+            for (size_t i = 0; i < count; i++)
             {
-                custom_gpio = *(reinterpret_cast<uint8_t*>((uint8_t*)(sensor_data.fo.pixels) + custom_source_id_offset));
-                custom_stream_type = custom_gpio_to_stream_type(custom_gpio);
+                auto&& sensor_data = samples[i];
+                auto timestamp_reader = _hid_iio_timestamp_reader.get();
+
+                // TODO:
+                static const std::string custom_sensor_name = "custom";
+                auto sensor_name = sensor_data.sensor.name;
+                bool is_custom_sensor = false;
+                static const uint32_t custom_source_id_offset = 16;
+                uint8_t custom_gpio = 0;
+                auto custom_stream_type = RS2_STREAM_ANY;
+                if (sensor_name == custom_sensor_name)
+                {
+                    custom_gpio = *(reinterpret_cast<uint8_t*>((uint8_t*)(sensor_data.fo.pixels) + custom_source_id_offset));
+                    custom_stream_type = custom_gpio_to_stream_type(custom_gpio);
 
-                if (!_is_configured_stream[custom_stream_type])
+                    if (!_is_configured_stream[custom_stream_type])
+                    {
+                        LOG_DEBUG("Unrequested " << rs2_stream_to_string(custom_stream_type) << " frame was dropped.");
+                        continue;
+                    }
+
+                    is_custom_sensor = true;
+                    timestamp_reader = _custom_hid_timestamp_reader.get();
+                }
+
+                if (!this->is_streaming())
                 {
-                    LOG_DEBUG("Unrequested " << rs2_stream_to_string(custom_stream_type) << " frame was dropped.");
-                    return;
+                    LOG_INFO("HID Frame received when Streaming is not active,"
+                                << get_string(_configured_profiles[sensor_name].stream)
+                                << ",Arrived," << std::fixed << system_time);
+                    continue;
                 }
 
-                is_custom_sensor = true;
-                timestamp_reader = _custom_hid_timestamp_reader.get();
-            }
+                auto mode = _hid_mapping[sensor_name];
+                auto request = *(mode.original_requests.begin());
+                auto data_size = sensor_data.fo.frame_size;
+                mode.profile.width = (uint32_t)data_size;
+                mode.profile.height = 1;
 
-            if (!this->is_streaming())
-            {
-                LOG_INFO("HID Frame received when Streaming is not active,"
-                            << get_string(_configured_profiles[sensor_name].stream)
-                            << ",Arrived," << std::fixed << system_time);
-                return;
-            }
+                // Determine the timestamp for this HID frame
+                auto frame_ts = timestamp_reader->read_frame_timestamp(mode, sensor_data.fo);
+                auto timestamp = frame_ts.timestamp;
+                auto frame_counter = frame_ts.counter;
 
-            auto mode = _hid_mapping[sensor_name];
-            auto request = *(mode.original_requests.begin());
-            auto data_size = sensor_data.fo.frame_size;
-            mode.profile.width = (uint32_t)data_size;
-            mode.profile.height = 1;
-
-            // Determine the timestamp for this HID frame
-            auto timestamp = timestamp_reader->get_frame_timestamp(mode, sensor_data.fo);
-            auto frame_counter = timestamp_reader->get_frame_counter(mode, sensor_data.fo);
-
-            frame_additional_data additional_data{};
-
-            additional_data.timestamp = timestamp;
-            additional_data.frame_number = frame_counter;
-            additional_data.timestamp_domain = timestamp_reader->get_frame_timestamp_domain(mode, sensor_data.fo);
-            additional_data.system_time = system_time;
-            LOG_DEBUG("FrameAccepted," << get_string(request->get_stream_type()) << "," << std::dec << frame_counter
-                      << ",Arrived," << std::fixed << system_time
-                      << ",TS," << std::fixed << timestamp
-                      << ",TS_Domain," << rs2_timestamp_domain_to_string(additional_data.timestamp_domain));
-
-            auto frame = _source.alloc_frame(RS2_EXTENSION_MOTION_FRAME, data_size, additional_data, true);
-            frame->set_stream(request);
-            if (!frame)
-            {
-                LOG_INFO("Dropped frame. alloc_frame(...) returned nullptr");
-                return;
-            }
+                auto&& counters = _frame_counters[request->get_stream_type()];
+                if (frame_ts.domain == RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK)
+                {
+                    if (auto lost = counters.update(frame_counter))
+                        on_frames_lost({ request }, frame_counter, lost);
+                }
+                else counters.reset();
+
+                frame_additional_data additional_data{};
+
+                additional_data.timestamp = timestamp;
+                additional_data.frame_number = frame_counter;
+                additional_data.timestamp_domain = frame_ts.domain;
+                additional_data.system_time = system_time;
+                additional_data.latency_breakdown[RS2_FRAME_LATENCY_STAGE_BACKEND_ARRIVAL] = arrival_time;
+                LOG_DEBUG("FrameAccepted," << get_string(request->get_stream_type()) << "," << std::dec << frame_counter
+                          << ",Arrived," << std::fixed << system_time
+                          << ",TS," << std::fixed << timestamp
+                          << ",TS_Domain," << rs2_timestamp_domain_to_string(additional_data.timestamp_domain));
+
+                // Batched streams unpack every sample in place, and publish a single frame once enough of them were collected
+                auto batched = request->get_format() == RS2_FORMAT_MOTION_XYZ32F_BATCH;
+                if (batched)
+                {
+                    auto&& batch = _motion_batches[request->get_stream_type()];
+                    rs2_motion_sample sample{ timestamp, {} };
+                    byte* sample_dest[] = { reinterpret_cast<byte*>(sample.xyz) };
+                    mode.unpacker->unpack(sample_dest, (const byte*)sensor_data.fo.pixels, (int)data_size);
+                    batch.push_back(sample);
+                    if (batch.size() < batch_size) continue;
+
+                    data_size = batch.size() * sizeof(rs2_motion_sample);
+                }
 
-            std::vector<byte*> dest{const_cast<byte*>(frame->get_frame_data())};
-            mode.unpacker->unpack(dest.data(),(const byte*)sensor_data.fo.pixels, (int)data_size);
+                auto frame = _source.alloc_frame(RS2_EXTENSION_MOTION_FRAME, data_size, additional_data, true);
+                if (!frame)
+                {
+                    LOG_INFO("Dropped frame. alloc_frame(...) returned nullptr");
+                    if (request) _source.on_frame_dropped(request->get_unique_id());
+                    if (batched) _motion_batches[request->get_stream_type()].clear();
+                    continue;
+                }
+                frame->set_stream(request);
 
-            if (_on_before_frame_callback)
-            {
-                auto callback = _source.begin_callback();
-                auto stream_type = frame->get_stream()->get_stream_type();
-                _on_before_frame_callback(stream_type, frame, std::move(callback));
-            }
+                if (batched)
+                {
+                    auto&& batch = _motion_batches[request->get_stream_type()];
+                    librealsense::copy(const_cast<byte*>(frame->get_frame_data()), batch.data(), data_size);
+                    batch.clear();
+                }
+                else
+                {
+                    byte* dest[] = { const_cast<byte*>(frame->get_frame_data()) };
+                    mode.unpacker->unpack(dest, (const byte*)sensor_data.fo.pixels, (int)data_size);
+                }
+                log_latency_stage(frame, RS2_FRAME_LATENCY_STAGE_UNPACK_DONE);
+
+                if (_on_before_frame_callback)
+                {
+                    auto callback = _source.begin_callback();
+                    auto stream_type = frame->get_stream()->get_stream_type();
+                    _on_before_frame_callback(stream_type, frame, std::move(callback));
+                }
 
-            _source.invoke_callback(std::move(frame));
+                _source.invoke_callback(std::move(frame), lanes.at(sensor_name));
+            }
         });
 
         _is_streaming = true;
+        start_temperature_metrics();
     }
 
     void hid_sensor::stop()
@@ -873,6 +1351,7 @@ namespace librealsense
 
         _hid_device->stop_capture();
         _is_streaming = false;
+        _temperature_metrics.clear();
         _source.flush();
         _source.reset();
         _hid_iio_timestamp_reader->reset();
@@ -940,7 +1419,77 @@ namespace librealsense
         : sensor_base(name, dev),
           _device(move(uvc_device)),
           _user_count(0),
-          _timestamp_reader(std::move(timestamp_reader))
+          _power_idle_timeout(0),
+          _powered_idle(false),
+          _power_idle_thread_running(false),
+          _held_power(0),
+          _timestamp_reader(std::move(timestamp_reader)),
+          _zero_copy_buffers(0),
+          _unpack_threads(1),
+          _warm_restart(0),
+          _max_kernel_buffers(0),
+          _global_time_enabled(0),
+          _realtime_mode(0),
+          _metadata_only_streams(0),
+          _frame_rate_decimation(1),
+          _huge_pages(huge_pages_off),
+          _numa_node(-1),
+          _intra_sensor_framesets(0),
+          _keep_native_payloads(false),
+          _clock_model(dev ? dev->get_clock_model() : std::make_shared<shared_clock_model>())
     {
+        register_option(RS2_OPTION_ZERO_COPY_BUFFERS,
+            std::make_shared<ptr_option<uint32_t>>(0, 16, 1, 0, &_zero_copy_buffers,
+                "Number of extra kernel buffers frames requiring no processing may hold without being copied, takes effect on next open"));
+        register_option(RS2_OPTION_UNPACK_THREADS,
+            std::make_shared<ptr_option<uint32_t>>(1, 16, 1, 1, &_unpack_threads,
+                "Number of row bands frames are split into for parallel unpacking, takes effect on next open"));
+
+        auto warm_restart = std::make_shared<ptr_option<uint32_t>>(0, 1, 1, 0, &_warm_restart,
+            "Keep the device powered and its buffers allocated after close, so that opening it again is fast");
+        warm_restart->on_set([this](float value)
+        {
+            std::lock_guard<std::mutex> lock(_configure_lock);
+            _device->set_keep_buffers(value > 0);
+            if (value == 0)
+                _standby_power.reset();
+        });
+        register_option(RS2_OPTION_WARM_RESTART, warm_restart);
+
+        auto max_kernel_buffers = std::make_shared<ptr_option<uint32_t>>(0, 32, 1, 0, &_max_kernel_buffers,
+            "Upper bound of the kernel buffers chosen at each open from how long frames held them, 0 for a fixed number");
+        max_kernel_buffers->on_set([this](float value)
+        {
+            std::lock_guard<std::mutex> lock(_configure_lock);
+            _device->set_adaptive_buffers(static_cast<int>(value));
+        });
+        register_option(RS2_OPTION_MAX_KERNEL_BUFFERS, max_kernel_buffers);
+
+        register_option(RS2_OPTION_GLOBAL_TIME_ENABLED,
+            std::make_shared<ptr_option<uint32_t>>(0, 1, 1, 0, &_global_time_enabled,
+                "Map the hardware timestamps of the frames to the system clock"));
+        register_option(RS2_OPTION_CLOCK_DRIFT, std::make_shared<clock_estimate_option>(_clock_model, true));
+        register_option(RS2_OPTION_CLOCK_JITTER, std::make_shared<clock_estimate_option>(_clock_model, false));
+        register_option(RS2_OPTION_REALTIME_MODE,
+            std::make_shared<ptr_option<uint32_t>>(0, 1, 1, 0, &_realtime_mode,
+                "Reserve all frame buffers on open and keep allocations, blocking and logging off the frame path, takes effect on next open"));
+        register_option(RS2_OPTION_METADATA_ONLY_STREAMS,
+            std::make_shared<ptr_option<uint32_t>>(0, float((1 << RS2_STREAM_COUNT) - 1), 1, 0, &_metadata_only_streams,
+                "Streams delivered with timestamps and metadata but without pixels, one bit per stream type, takes effect on next open"));
+        register_option(RS2_OPTION_FRAME_RATE_DECIMATION,
+            std::make_shared<ptr_option<uint32_t>>(1, 30, 1, 1, &_frame_rate_decimation,
+                "Deliver every Nth frame, the others are returned to the driver before unpacking, takes effect on next open"));
+        register_option(RS2_OPTION_FRAME_MEMORY_HUGE_PAGES,
+            std::make_shared<ptr_option<uint32_t>>(huge_pages_off, huge_pages_explicit, 1, huge_pages_off, &_huge_pages,
+                "Back large frame buffers with no huge pages (0), transparent huge pages (1) or reserved huge pages (2), takes effect on next open"));
+        register_option(RS2_OPTION_FRAME_MEMORY_NUMA_NODE,
+            std::make_shared<ptr_option<int>>(-1, 63, 1, -1, &_numa_node,
+                "NUMA node large frame buffers are preferably placed on, -1 for the node of the thread writing them, takes effect on next open"));
+        register_option(RS2_OPTION_INTRA_SENSOR_FRAMESETS,
+            std::make_shared<ptr_option<uint32_t>>(0, 1, 1, 0, &_intra_sensor_framesets,
+                "Deliver the streams unpacked from one payload, like the two infrared streams, as a single frameset, takes effect on next open"));
+        register_option(RS2_OPTION_POWER_IDLE_TIMEOUT,
+            std::make_shared<ptr_option<uint32_t>>(0, 60000, 1, 0, &_power_idle_timeout,
+                "Milliseconds the device stays powered once unused, so that bursts of option accesses and quick restarts skip powering it again"));
     }
 }
@@ -10,9 +10,15 @@
 #include "core/roi.h"
 #include "core/options.h"
 #include "source.h"
+#include "bandwidth.h"
+#include "metrics.h"
 
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <memory>
+#include <thread>
 #include <vector>
 #include <unordered_set>
 #include <limits.h>
@@ -43,13 +49,17 @@ namespace librealsense
         }
 
         void register_notifications_callback(notifications_callback_ptr callback) override;
+        void set_frame_allocator(frame_allocator_ptr allocator, size_t alignment) override;
         std::shared_ptr<notifications_proccessor> get_notifications_proccessor();
+        option_cache& get_option_cache() { return *_option_cache; }
 
         bool is_streaming() const override
         {
             return _is_streaming;
         }
 
+        const frame_source& get_frame_source() const { return _source; }
+
         virtual ~sensor_base() { _source.flush(); }
 
         void register_metadata(rs2_frame_metadata_value metadata, std::shared_ptr<md_attribute_parser_base> metadata_parser) const;
@@ -81,11 +91,24 @@ namespace librealsense
 
         std::vector<request_mapping> resolve_requests(stream_profiles requests);
 
+        // Serial number of the device and name of the sensor, labeling the metrics of the sensor
+        metric_labels get_metric_labels() const;
+
+        // Counts the frames of the requests of a native stream lost before reaching the host, up to the one of the
+        // counter, and raises a notification about them
+        void on_frames_lost(const std::vector<std::shared_ptr<stream_profile_interface>>& requests,
+                            unsigned long long counter, unsigned long long lost);
+
+        // Called when the sensor starts streaming, until it stops the temperatures it supports are reported as metrics
+        void start_temperature_metrics();
+        std::vector<std::unique_ptr<sampled_gauge>> _temperature_metrics;
+
         std::vector<platform::stream_profile> _internal_config;
 
         std::atomic<bool> _is_streaming;
         std::atomic<bool> _is_opened;
         std::shared_ptr<notifications_proccessor> _notifications_proccessor;
+        std::shared_ptr<option_cache> _option_cache;
         on_before_frame_callback _on_before_frame_callback;
         on_open _on_open;
         std::shared_ptr<metadata_parser_map> _metadata_parsers = nullptr;
@@ -94,8 +117,34 @@ namespace librealsense
         device* _owner;
 
     private:
+        // A result of resolve_requests, as positions in _pixel_formats and in the requests
+        struct resolved_mapping
+        {
+            platform::stream_profile profile;
+            size_t pf;
+            size_t unpacker;
+            std::vector<size_t> requests;
+        };
+        using requests_key = std::vector<std::tuple<rs2_stream, int, uint32_t, uint32_t, uint32_t, rs2_format>>;
+        using native_fourccs_table = std::map<std::tuple<uint32_t, uint32_t, uint32_t>, std::set<uint32_t>>;  // Native 4ccs per width, height and fps
+
+        std::vector<request_mapping> search_requests(stream_profiles requests);
+        const std::set<uint32_t>& get_native_fourccs(uint32_t width, uint32_t height, uint32_t fps);
+
         lazy<stream_profiles> _profiles;
         std::vector<native_pixel_format> _pixel_formats;
+        std::map<requests_key, std::vector<resolved_mapping>> _resolved_requests;  // Cleared when the pixel formats change
+        std::shared_ptr<native_fourccs_table> _native_fourccs;
+        std::mutex _resolved_requests_mutex;
+    };
+
+    class shared_clock_model;
+
+    struct frame_timestamp
+    {
+        double timestamp;
+        rs2_timestamp_domain domain;
+        unsigned long long counter;
     };
 
     struct frame_timestamp_reader
@@ -106,6 +155,70 @@ namespace librealsense
         virtual unsigned long long get_frame_counter(const request_mapping& mode, const platform::frame_object& fo) const = 0;
         virtual rs2_timestamp_domain get_frame_timestamp_domain(const request_mapping & mode, const platform::frame_object& fo) const = 0;
         virtual void reset() = 0;
+
+        // The three of them for a frame, which readers may get out of a single pass over the metadata
+        virtual frame_timestamp read_frame_timestamp(const request_mapping& mode, const platform::frame_object& fo)
+        {
+            frame_timestamp res;
+            res.timestamp = get_frame_timestamp(mode, fo);
+            res.domain = get_frame_timestamp_domain(mode, fo);
+            res.counter = get_frame_counter(mode, fo);
+            return res;
+        }
+    };
+
+    // Follows the hardware counters of the frames of a native stream. Frames missing from the sequence never reached the
+    // host, while the ones dropped by the library after their arrival still count as received
+    class frame_counter_tracker
+    {
+    public:
+        // Frames missing before the one of the counter. Counters that restart or go back only resynchronize
+        unsigned long long update(unsigned long long counter)
+        {
+            auto lost = _valid && counter > _last ? counter - _last - 1 : 0;
+            _last = counter;
+            _valid = true;
+            return lost;
+        }
+
+        void reset() { _valid = false; }
+
+    private:
+        unsigned long long _last = 0;
+        bool _valid = false;
+    };
+
+    // State of the frames of each stream of a timestamp reader, touched only by the capture thread of the stream, so without locks
+    // Resets from other threads bump a generation, and the state of a stream clears itself on its next frame when it is behind
+    template<class T>
+    class per_stream_state
+    {
+    public:
+        explicit per_stream_state(size_t streams) : _entries(streams), _generation(0) {}
+
+        T& get(size_t stream) const
+        {
+            auto&& e = _entries[stream];
+            auto generation = _generation.load(std::memory_order_acquire);
+            if (e.generation != generation)
+            {
+                e.value = T();
+                e.generation = generation;
+            }
+            return e.value;
+        }
+
+        void reset() { _generation.fetch_add(1, std::memory_order_release); }
+
+    private:
+        struct entry
+        {
+            T value{};
+            unsigned generation = 0;
+        };
+
+        mutable std::vector<entry> _entries;
+        std::atomic<unsigned> _generation;
     };
 
     class hid_sensor : public sensor_base
@@ -150,6 +263,9 @@ namespace librealsense
         std::map<std::string, request_mapping> _hid_mapping;
         std::unique_ptr<frame_timestamp_reader> _hid_iio_timestamp_reader;
         std::unique_ptr<frame_timestamp_reader> _custom_hid_timestamp_reader;
+        uint32_t _motion_batch_size;
+        std::array<std::vector<rs2_motion_sample>, RS2_STREAM_COUNT> _motion_batches; // Samples not delivered yet, per batched stream
+        std::array<frame_counter_tracker, RS2_STREAM_COUNT> _frame_counters;
 
         stream_profiles get_sensor_profiles(std::string sensor_name) const;
 
@@ -180,6 +296,10 @@ namespace librealsense
 
         void register_xu(platform::extension_unit xu);
 
+        // Frames unpacked into a single larger stream keep a copy of the payload the sensor delivered, for recording
+        // it instead of the unpacked frame. Takes effect on the next open
+        void keep_native_payloads(bool keep) { _keep_native_payloads = keep; }
+
         template<class T>
         auto invoke_powered(T action)
             -> decltype(action(*static_cast<platform::uvc_device*>(nullptr)))
@@ -188,9 +308,24 @@ namespace librealsense
             return action(*_device);
         }
 
+        // Keep the device powered, with its extension units initialized, until the matching release_held_power
+        // Holds nest, so bursts of option accesses between them need no power transitions
+        void hold_power();
+        void release_held_power();
+
+        // Forwards the changes of the control the device signals to the callback, false when they must be polled
+        bool set_xu_change_callback(const platform::extension_unit& xu, uint8_t ctrl, std::function<void()> callback)
+        {
+            return _device->set_xu_change_callback(xu, ctrl, std::move(callback));
+        }
+
         void register_pu(rs2_option id);
         void try_register_pu(rs2_option id);
 
+        // The device is powered once for all the options, instead of once per option
+        std::vector<float> query_options(const std::vector<rs2_option>& ids) const override;
+        void set_options(const std::vector<std::pair<rs2_option, float>>& values) override;
+
         void start(frame_callback_ptr callback) override;
 
         void stop() override;
@@ -205,6 +340,9 @@ namespace librealsense
 
         void release_power();
 
+        // Drops the device to D3 once it stayed unused for the idle timeout, and ends
+        void power_idle_loop();
+
         void reset_streaming();
 
         struct power
@@ -231,10 +369,32 @@ namespace librealsense
         std::shared_ptr<platform::uvc_device> _device;
         std::atomic<int> _user_count;
         std::mutex _power_lock;
+        uint32_t _power_idle_timeout;                           // Milliseconds the device stays in D0 once unused
+        bool _powered_idle;                                     // In D0 without users, until the deadline
+        std::chrono::steady_clock::time_point _power_idle_deadline;
+        std::condition_variable _power_cv;
+        std::thread _power_idle_thread;
+        bool _power_idle_thread_running;
+        std::atomic<int> _held_power;                           // Holds of hold_power not released yet
         std::mutex _configure_lock;
         std::vector<platform::extension_unit> _xus;
         std::unique_ptr<power> _power;
         std::unique_ptr<frame_timestamp_reader> _timestamp_reader;
         std::shared_ptr<region_of_interest_method> _roi_method = nullptr;
+        uint32_t _zero_copy_buffers;
+        uint32_t _unpack_threads;
+        uint32_t _warm_restart;
+        uint32_t _max_kernel_buffers;              // 0 for a fixed number of kernel buffers
+        std::unique_ptr<power> _standby_power;     // Power kept after close in warm restart mode
+        uint32_t _global_time_enabled;
+        uint32_t _realtime_mode;
+        uint32_t _metadata_only_streams;           // Bit per rs2_stream delivered without pixels
+        uint32_t _frame_rate_decimation;           // Every Nth frame is delivered
+        uint32_t _huge_pages;                      // frame_huge_pages of the frame buffers
+        int _numa_node;                            // Node of the frame buffers, -1 for any
+        uint32_t _intra_sensor_framesets;          // Outputs of an unpacker leave as one frameset
+        std::atomic<bool> _keep_native_payloads;
+        std::shared_ptr<shared_clock_model> _clock_model;
+        std::unique_ptr<bandwidth_reservation> _bandwidth;  // Payload counted against the USB controller while opened
     };
 }
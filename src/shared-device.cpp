@@ -0,0 +1,834 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2015 Intel Corporation. All Rights Reserved.
+
+#include <cstring>
+#include "image.h"
+#include "environment.h"
+#include "shared-device.h"
+
+#ifndef _WIN32
+#include <dirent.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace librealsense
+{
+    // Segment layout: the header, the slot headers, then the slot buffers, each aligned to a cache line
+    // A slot is free when no one holds a reference to it. The publisher takes it with the WRITING flag set, readers
+    // reference only slots without it. Published slots are found through the log, which is indexed by sequence
+    static const uint32_t SHARED_DEVICE_MAGIC = 0x31445352; // "RSD1"
+    static const uint32_t SHARED_DEVICE_VERSION = 1;
+    static const char* SHARED_DEVICE_PREFIX = "rs2-shared-";
+    static const size_t SHARED_INFO_SIZE = 64;
+    static const uint32_t MAX_SHARED_SENSORS = 8;
+    static const uint32_t MAX_SHARED_STREAMS = 16;
+    static const uint32_t MAX_SHARED_PROFILES = 1024;
+    static const uint32_t MAX_SHARED_SLOTS = 0xffff;
+    static const uint32_t SHARED_LOG_SIZE = 256;
+    static const uint32_t SLOT_WRITING = 0x80000000;
+    static const size_t SLOT_ALIGNMENT = 64;
+
+    static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t), "Shared memory counters must be plain integers");
+
+    struct shared_stream_desc
+    {
+        int32_t stream;
+        int32_t index;
+        uint32_t has_extrinsics;
+        rs2_extrinsics extrinsics;     // From the first stream
+    };
+
+    struct shared_profile_desc
+    {
+        uint32_t sensor;
+        uint32_t stream;               // Position in the streams of the header
+        int32_t format;
+        uint32_t width, height, fps;
+        std::atomic<uint32_t> has_intrinsics;
+        rs2_intrinsics intrinsics;
+    };
+
+    struct shared_segment_header
+    {
+        uint32_t magic;
+        uint32_t version;
+        int32_t owner_pid;
+        uint32_t slot_count;
+        uint64_t slot_size;
+        uint64_t data_offset;
+        char info[4][SHARED_INFO_SIZE];  // Name, serial number, firmware version and product id
+        uint32_t sensor_count;
+        char sensor_names[MAX_SHARED_SENSORS][SHARED_INFO_SIZE];
+        float depth_units[MAX_SHARED_SENSORS];  // Zero for sensors without depth
+        uint32_t stream_count;
+        shared_stream_desc streams[MAX_SHARED_STREAMS];
+        uint32_t profile_count;
+        shared_profile_desc profiles[MAX_SHARED_PROFILES];
+        std::atomic<uint64_t> published;
+        std::atomic<uint64_t> log[SHARED_LOG_SIZE];  // Sequence in the high bits, slot in the low 16 bits
+    };
+
+    struct shared_slot
+    {
+        std::atomic<uint32_t> refs;
+        std::atomic<uint64_t> sequence;
+        uint32_t profile;
+        int32_t timestamp_domain;
+        double timestamp;
+        double system_time;
+        uint64_t frame_number;
+        uint64_t data_size;
+        uint32_t width, height, stride, bpp;
+    };
+
+    static const rs2_camera_info shared_infos[] = { RS2_CAMERA_INFO_NAME, RS2_CAMERA_INFO_SERIAL_NUMBER,
+                                                    RS2_CAMERA_INFO_FIRMWARE_VERSION, RS2_CAMERA_INFO_PRODUCT_ID };
+
+    static size_t align_up(size_t size, size_t alignment)
+    {
+        return (size + alignment - 1) / alignment * alignment;
+    }
+
+    static void copy_info(char* dst, const std::string& src)
+    {
+        auto size = std::min(src.size(), SHARED_INFO_SIZE - 1);
+        memcpy(dst, src.data(), size);
+        dst[size] = 0;
+    }
+
+    static std::string segment_name(const std::string& name)
+    {
+        if (name.empty() || name.find('/') != std::string::npos || name.size() > 200)
+            throw invalid_value_exception(to_string() << "Invalid shared device name \"" << name << "\"");
+        return "/" + std::string(SHARED_DEVICE_PREFIX) + name;
+    }
+
+    // Mapping of a segment, shared by the frames it holds
+    class shared_memory
+    {
+    public:
+        static std::shared_ptr<shared_memory> create(const std::string& name, uint32_t slot_count, size_t slot_size);
+        static std::shared_ptr<shared_memory> open(const std::string& name);
+
+        // Pid of the publisher of the segment, zero when there is no live publisher
+        static int get_owner(const std::string& name);
+
+        ~shared_memory();
+
+        shared_segment_header& header() const { return *reinterpret_cast<shared_segment_header*>(_data); }
+
+        shared_slot& slot(uint32_t i) const
+        {
+            return reinterpret_cast<shared_slot*>(_data + sizeof(shared_segment_header))[i];
+        }
+
+        uint8_t* slot_data(uint32_t i) const
+        {
+            return _data + header().data_offset + i * header().slot_size;
+        }
+
+        int find_slot(const void* ptr) const
+        {
+            auto p = static_cast<const uint8_t*>(ptr);
+            auto begin = _data + header().data_offset;
+            if (p < begin || p >= _data + _size) return -1;
+            return static_cast<int>((p - begin) / header().slot_size);
+        }
+
+        // Takes a free slot for writing, or returns -1
+        int acquire_free(size_t size)
+        {
+            auto&& h = header();
+            if (size > h.slot_size) return -1;
+            for (uint32_t n = 0; n < h.slot_count; n++)
+            {
+                auto i = (_next_free + n) % h.slot_count;
+                uint32_t expected = 0;
+                if (slot(i).refs.compare_exchange_strong(expected, SLOT_WRITING | 1))
+                {
+                    _next_free = i + 1;
+                    return static_cast<int>(i);
+                }
+            }
+            return -1;
+        }
+
+        // Takes a reference to a published slot
+        bool acquire_published(uint32_t i)
+        {
+            auto&& refs = slot(i).refs;
+            auto r = refs.load();
+            while (r != 0 && !(r & SLOT_WRITING))
+            {
+                if (refs.compare_exchange_weak(r, r + 1))
+                    return true;
+            }
+            return false;
+        }
+
+        void publish(uint32_t i) { slot(i).refs.fetch_and(~SLOT_WRITING); }
+
+        void release(uint32_t i)
+        {
+            auto&& refs = slot(i).refs;
+            auto r = refs.load();
+            while (!refs.compare_exchange_weak(r, (r & ~SLOT_WRITING) - 1));
+        }
+
+        void unlink();
+
+    private:
+        shared_memory(std::string name, uint8_t* data, size_t size, bool owner)
+            : _name(std::move(name)), _data(data), _size(size), _owner(owner), _next_free(0) {}
+
+        std::string _name;
+        uint8_t* _data;
+        size_t _size;
+        bool _owner;
+        std::atomic<uint32_t> _next_free;
+    };
+
+    // Frame buffers of the sensors of a published device are taken from the slots of its segment
+    class shared_slot_allocator : public rs2_frame_allocator
+    {
+    public:
+        explicit shared_slot_allocator(std::shared_ptr<shared_memory> memory) : _memory(std::move(memory)) {}
+
+        void* allocate(size_t size, size_t) override
+        {
+            auto i = _memory->acquire_free(size);
+            return i < 0 ? nullptr : _memory->slot_data(i);
+        }
+
+        void deallocate(void* ptr) override
+        {
+            auto i = _memory->find_slot(ptr);
+            if (i >= 0) _memory->release(i);
+        }
+
+        void release() override { delete this; }
+
+    private:
+        std::shared_ptr<shared_memory> _memory;
+    };
+
+#ifndef _WIN32
+    std::shared_ptr<shared_memory> shared_memory::create(const std::string& name, uint32_t slot_count, size_t slot_size)
+    {
+        auto path = segment_name(name);
+        if (auto pid = get_owner(name))
+            throw invalid_value_exception(to_string() << "Shared device \"" << name << "\" is already published by process " << pid);
+        // The segment of a publisher that did not exit cleanly is replaced
+        shm_unlink(path.c_str());
+
+        slot_size = align_up(slot_size, SLOT_ALIGNMENT);
+        auto data_offset = align_up(sizeof(shared_segment_header) + slot_count * sizeof(shared_slot), SLOT_ALIGNMENT);
+        auto size = data_offset + slot_count * slot_size;
+
+        auto fd = shm_open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0660);
+        if (fd < 0)
+            throw io_exception(to_string() << "Failed to create shared memory " << path << ", error " << errno);
+        if (ftruncate(fd, static_cast<off_t>(size)) < 0)
+        {
+            ::close(fd);
+            shm_unlink(path.c_str());
+            throw io_exception(to_string() << "Failed to size shared memory " << path << " to " << size << " bytes, error " << errno);
+        }
+        auto data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (data == MAP_FAILED)
+        {
+            shm_unlink(path.c_str());
+            throw io_exception(to_string() << "Failed to map shared memory " << path << ", error " << errno);
+        }
+
+        auto memory = std::shared_ptr<shared_memory>(new shared_memory(path, static_cast<uint8_t*>(data), size, true));
+        auto&& h = memory->header();
+        h.slot_count = slot_count;
+        h.slot_size = slot_size;
+        h.data_offset = data_offset;
+        return memory;
+    }
+
+    std::shared_ptr<shared_memory> shared_memory::open(const std::string& name)
+    {
+        auto path = segment_name(name);
+        auto fd = shm_open(path.c_str(), O_RDWR, 0);
+        if (fd < 0)
+            throw io_exception(to_string() << "Shared device \"" << name << "\" is not published");
+
+        struct stat st;
+        void* data = MAP_FAILED;
+        if (fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= sizeof(shared_segment_header))
+            data = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (data == MAP_FAILED)
+            throw io_exception(to_string() << "Failed to map shared memory " << path);
+
+        auto memory = std::shared_ptr<shared_memory>(new shared_memory(path, static_cast<uint8_t*>(data), st.st_size, false));
+        auto&& h = memory->header();
+        if (h.magic != SHARED_DEVICE_MAGIC || h.version != SHARED_DEVICE_VERSION ||
+            h.data_offset + h.slot_count * h.slot_size > memory->_size)
+            throw invalid_value_exception(to_string() << "Shared memory " << path << " does not hold a shared device");
+        return memory;
+    }
+
+    int shared_memory::get_owner(const std::string& name)
+    {
+        auto fd = shm_open(segment_name(name).c_str(), O_RDONLY, 0);
+        if (fd < 0) return 0;
+
+        uint32_t fields[3] = {};
+        auto size = pread(fd, fields, sizeof(fields), 0);
+        ::close(fd);
+        auto pid = static_cast<int>(fields[2]);
+        if (size != sizeof(fields) || fields[0] != SHARED_DEVICE_MAGIC || fields[1] != SHARED_DEVICE_VERSION || pid <= 0)
+            return 0;
+        return kill(pid, 0) == 0 || errno == EPERM ? pid : 0;
+    }
+
+    shared_memory::~shared_memory()
+    {
+        unlink();
+        munmap(_data, _size);
+    }
+
+    void shared_memory::unlink()
+    {
+        if (_owner)
+        {
+            shm_unlink(_name.c_str());
+            _owner = false;
+        }
+    }
+#else
+    std::shared_ptr<shared_memory> shared_memory::create(const std::string&, uint32_t, size_t)
+    {
+        throw not_implemented_exception("Shared devices are not supported on this platform");
+    }
+
+    std::shared_ptr<shared_memory> shared_memory::open(const std::string&)
+    {
+        throw not_implemented_exception("Shared devices are not supported on this platform");
+    }
+
+    int shared_memory::get_owner(const std::string&) { return 0; }
+
+    shared_memory::~shared_memory() {}
+
+    void shared_memory::unlink() {}
+#endif
+
+    frame_publisher::frame_publisher(std::shared_ptr<device_interface> dev, const std::string& name, uint32_t slots)
+        : _dev(std::move(dev)), _sequence(0), _dropped(0)
+    {
+        if (slots == 0) slots = 8;
+        if (slots < 2 || slots > MAX_SHARED_SLOTS)
+            throw invalid_value_exception(to_string() << "Invalid shared device slot count " << slots);
+        // Half of the slots stay free for the frames being captured
+        _retained_count = slots / 2;
+
+        auto sensors = std::min(static_cast<uint32_t>(_dev->get_sensors_count()), MAX_SHARED_SENSORS);
+        std::vector<std::shared_ptr<video_stream_profile_interface>> profiles;
+        std::vector<uint32_t> profile_sensors;
+        std::vector<std::pair<rs2_stream, int>> streams;
+        size_t slot_size = 0;
+        for (uint32_t s = 0; s < sensors; s++)
+        {
+            for (auto&& p : _dev->get_sensor(s).get_stream_profiles())
+            {
+                auto video = std::dynamic_pointer_cast<video_stream_profile_interface>(p);
+                if (!video || profiles.size() == MAX_SHARED_PROFILES) continue;
+
+                auto stream = std::make_pair(p->get_stream_type(), p->get_stream_index());
+                if (std::find(streams.begin(), streams.end(), stream) == streams.end())
+                {
+                    if (streams.size() == MAX_SHARED_STREAMS) continue;
+                    streams.push_back(stream);
+                }
+                profiles.push_back(video);
+                profile_sensors.push_back(s);
+                slot_size = std::max(slot_size, size_t(video->get_width()) * video->get_height() * get_image_bpp(p->get_format()) / 8);
+            }
+        }
+        if (profiles.empty())
+            throw invalid_value_exception("The device has no video streams to share");
+
+        _memory = shared_memory::create(name, slots, slot_size);
+        auto&& h = _memory->header();
+
+        for (size_t i = 0; i < 4; i++)
+        {
+            if (_dev->supports_info(shared_infos[i]))
+                copy_info(h.info[i], _dev->get_info(shared_infos[i]));
+        }
+        h.sensor_count = sensors;
+        for (uint32_t s = 0; s < sensors; s++)
+        {
+            auto&& sensor = _dev->get_sensor(s);
+            if (sensor.supports_info(RS2_CAMERA_INFO_NAME))
+                copy_info(h.sensor_names[s], sensor.get_info(RS2_CAMERA_INFO_NAME));
+            if (auto depth = dynamic_cast<depth_sensor*>(&sensor))
+                h.depth_units[s] = depth->get_depth_scale();
+        }
+
+        h.stream_count = static_cast<uint32_t>(streams.size());
+        std::vector<std::shared_ptr<video_stream_profile_interface>> stream_profiles(streams.size());
+        h.profile_count = static_cast<uint32_t>(profiles.size());
+        for (uint32_t i = 0; i < h.profile_count; i++)
+        {
+            auto&& p = profiles[i];
+            auto stream = static_cast<uint32_t>(std::find(streams.begin(), streams.end(),
+                std::make_pair(p->get_stream_type(), p->get_stream_index())) - streams.begin());
+            if (!stream_profiles[stream]) stream_profiles[stream] = p;
+
+            auto&& desc = h.profiles[i];
+            desc.sensor = profile_sensors[i];
+            desc.stream = stream;
+            desc.format = p->get_format();
+            desc.width = p->get_width();
+            desc.height = p->get_height();
+            desc.fps = p->get_framerate();
+            _profiles[std::make_tuple(desc.sensor, p->get_stream_type(), p->get_stream_index(),
+                desc.width, desc.height, desc.fps, p->get_format())] = i;
+        }
+        _intrinsics_written.resize(h.profile_count);
+
+        for (uint32_t k = 0; k < h.stream_count; k++)
+        {
+            auto&& desc = h.streams[k];
+            desc.stream = streams[k].first;
+            desc.index = streams[k].second;
+            desc.has_extrinsics = environment::get_instance().get_extrinsics_graph().try_fetch_extrinsics(
+                *stream_profiles[0], *stream_profiles[k], &desc.extrinsics);
+        }
+
+        frame_allocator_ptr allocator(new shared_slot_allocator(_memory), [](rs2_frame_allocator* p) { p->release(); });
+        for (uint32_t s = 0; s < sensors; s++)
+            _dev->get_sensor(s).set_frame_allocator(allocator, SLOT_ALIGNMENT);
+
+#ifndef _WIN32
+        h.owner_pid = getpid();
+#endif
+        h.version = SHARED_DEVICE_VERSION;
+        h.magic = SHARED_DEVICE_MAGIC;
+    }
+
+    frame_publisher::~frame_publisher()
+    {
+        // Readers keep their mappings, new readers no longer find the segment
+        _memory->header().owner_pid = 0;
+        _memory->unlink();
+        for (auto i : _retained)
+            _memory->release(i);
+    }
+
+    int frame_publisher::find_profile(frame_interface* f) const
+    {
+        auto&& p = f->get_stream();
+        auto video = dynamic_cast<video_stream_profile_interface*>(p.get());
+        auto sensor = f->get_sensor();
+        if (!video || !sensor) return -1;
+
+        for (uint32_t s = 0; s < _dev->get_sensors_count(); s++)
+        {
+            if (&_dev->get_sensor(s) != sensor.get()) continue;
+
+            auto it = _profiles.find(std::make_tuple(s, p->get_stream_type(), p->get_stream_index(),
+                video->get_width(), video->get_height(), p->get_framerate(), p->get_format()));
+            return it == _profiles.end() ? -1 : static_cast<int>(it->second);
+        }
+        return -1;
+    }
+
+    void frame_publisher::publish(frame_interface* f)
+    {
+        if (auto composite = dynamic_cast<composite_frame*>(f))
+        {
+            for (size_t i = 0; i < composite->get_embedded_frames_count(); i++)
+                publish(composite->get_frame(static_cast<int>(i)));
+            return;
+        }
+
+        auto video = dynamic_cast<video_frame*>(f);
+        auto profile = video ? find_profile(f) : -1;
+        if (profile < 0)
+        {
+            ++_dropped;
+            return;
+        }
+
+        auto data = f->get_frame_data();
+        auto size = f->get_frame_data_size();
+        auto slot = _memory->find_slot(data);
+        if (slot >= 0)
+        {
+            // Allocated in the segment, the slot is written until published once
+            if (!(_memory->slot(slot).refs & SLOT_WRITING))
+                return;
+            _memory->slot(slot).refs.fetch_add(1);
+        }
+        else
+        {
+            slot = _memory->acquire_free(size);
+            if (slot < 0)
+            {
+                ++_dropped;
+                return;
+            }
+            memcpy(_memory->slot_data(slot), data, size);
+        }
+
+        auto&& s = _memory->slot(slot);
+        s.profile = profile;
+        s.timestamp_domain = f->get_frame_timestamp_domain();
+        s.timestamp = f->get_frame_timestamp();
+        s.system_time = f->get_frame_system_time();
+        s.frame_number = f->get_frame_number();
+        s.data_size = size;
+        s.width = video->get_width();
+        s.height = video->get_height();
+        s.stride = video->get_stride();
+        s.bpp = video->get_bpp();
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto&& h = _memory->header();
+        if (!_intrinsics_written[profile])
+        {
+            auto&& desc = h.profiles[profile];
+            try
+            {
+                desc.intrinsics = dynamic_cast<video_stream_profile_interface*>(f->get_stream().get())->get_intrinsics();
+                desc.has_intrinsics = 1;
+            }
+            catch (...) {}
+            _intrinsics_written[profile] = true;
+        }
+
+        auto sequence = ++_sequence;
+        s.sequence = sequence;
+        _memory->publish(slot);
+        h.log[sequence % SHARED_LOG_SIZE] = (sequence << 16) | static_cast<uint64_t>(slot);
+        h.published = sequence;
+
+        _retained.push_back(slot);
+        while (_retained.size() > _retained_count)
+        {
+            _memory->release(_retained.front());
+            _retained.pop_front();
+        }
+    }
+
+    class shared_sensor : public sensor_base
+    {
+    public:
+        shared_sensor(const std::string& name, uint32_t index, shared_device* owner)
+            : sensor_base(name, owner), _index(index), _device(owner),
+              _opened(owner->_memory->header().profile_count), _lanes(owner->_memory->header().profile_count),
+              _by_profile(owner->_memory->header().profile_count)
+        {
+        }
+
+        void open(const stream_profiles& requests) override
+        {
+            std::lock_guard<std::mutex> lock(_configure_lock);
+            if (_is_streaming)
+                throw wrong_api_call_sequence_exception("open(...) failed. Shared sensor is streaming!");
+            else if (_is_opened)
+                throw wrong_api_call_sequence_exception("open(...) failed. Shared sensor is already opened!");
+
+            get_stream_profiles();
+            std::vector<std::shared_ptr<stream_profile_interface>> opened(_opened.size());
+            for (auto&& r : requests)
+            {
+                auto p = to_profile(r.get());
+                auto it = std::find_if(_by_profile.begin(), _by_profile.end(), [&p](const std::shared_ptr<stream_profile_interface>& sp)
+                {
+                    return sp && to_profile(sp.get()) == p;
+                });
+                if (it == _by_profile.end())
+                    throw invalid_value_exception(to_string() << "Profile " << p.stream << " " << p.width << "x" << p.height
+                                                              << " " << p.format << " is not shared");
+                opened[it - _by_profile.begin()] = r;
+            }
+
+            _source.init(_metadata_parsers);
+            _source.set_sensor(shared_from_this());
+            std::vector<frame_source::callback_lane*> lanes(opened.size());
+            for (size_t i = 0; i < opened.size(); i++)
+                if (opened[i]) lanes[i] = _source.open_lane(opened[i]->get_unique_id());
+            _opened = std::move(opened);
+            _lanes = std::move(lanes);
+            _is_opened = true;
+        }
+
+        void close() override
+        {
+            std::lock_guard<std::mutex> lock(_configure_lock);
+            if (_is_streaming)
+                throw wrong_api_call_sequence_exception("close() failed. Shared sensor is streaming!");
+            else if (!_is_opened)
+                throw wrong_api_call_sequence_exception("close() failed. Shared sensor was not opened!");
+
+            _source.flush();
+            _source.reset();
+            std::fill(_opened.begin(), _opened.end(), nullptr);
+            std::fill(_lanes.begin(), _lanes.end(), nullptr);
+            _is_opened = false;
+        }
+
+        void start(frame_callback_ptr callback) override
+        {
+            std::lock_guard<std::mutex> lock(_configure_lock);
+            if (_is_streaming)
+                throw wrong_api_call_sequence_exception("start_streaming(...) failed. Shared sensor is already streaming!");
+            else if (!_is_opened)
+                throw wrong_api_call_sequence_exception("start_streaming(...) failed. Shared sensor was not opened!");
+
+            _source.set_callback(callback);
+            _is_streaming = true;
+            _device->start_reading();
+        }
+
+        void stop() override
+        {
+            std::lock_guard<std::mutex> lock(_configure_lock);
+            if (!_is_streaming)
+                throw wrong_api_call_sequence_exception("stop_streaming() failed. Shared sensor is not streaming!");
+
+            _is_streaming = false;
+        }
+
+        // Delivers the frame in the slot, which holds a reference taken by the caller
+        void dispatch(uint32_t i, const std::shared_ptr<shared_memory>& memory)
+        {
+            auto&& s = memory->slot(i);
+            std::shared_ptr<stream_profile_interface> request;
+            frame_source::callback_lane* lane = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(_configure_lock);
+                if (_is_streaming)
+                {
+                    request = _opened[s.profile];
+                    lane = _lanes[s.profile];
+                }
+            }
+            if (!request)
+            {
+                memory->release(i);
+                return;
+            }
+
+            frame_additional_data additional_data(s.timestamp, s.frame_number, s.system_time, 0, nullptr);
+            additional_data.timestamp_domain = static_cast<rs2_timestamp_domain>(s.timestamp_domain);
+            auto type = request->get_stream_type() == RS2_STREAM_DEPTH ? RS2_EXTENSION_DEPTH_FRAME : RS2_EXTENSION_VIDEO_FRAME;
+            frame_holder frame = _source.alloc_frame(type, 0, additional_data, false);
+            if (!frame.frame)
+            {
+                memory->release(i);
+                LOG_INFO("Dropped frame. alloc_frame(...) returned nullptr");
+                _source.on_frame_dropped(request->get_unique_id());
+                return;
+            }
+
+            auto video = static_cast<video_frame*>(frame.frame);
+            video->assign(s.width, s.height, s.stride, s.bpp);
+            video->set_timestamp_domain(additional_data.timestamp_domain);
+            // The frame keeps its slot referenced until it is released
+            video->attach_continuation(frame_continuation([memory, i]() { memory->release(i); }, memory->slot_data(i)));
+            video->user_data_size = static_cast<size_t>(s.data_size);
+            video->read_only_data = true;
+            frame->set_stream(request);
+            _source.invoke_callback(std::move(frame), lane);
+        }
+
+    protected:
+        stream_profiles init_stream_profiles() override
+        {
+            auto memory = _device->_memory;
+            auto&& h = memory->header();
+            stream_profiles results;
+            for (uint32_t i = 0; i < h.profile_count; i++)
+            {
+                auto&& desc = h.profiles[i];
+                if (desc.sensor != _index) continue;
+
+                auto&& stream = _device->_streams[desc.stream];
+                auto profile = std::make_shared<video_stream_profile>(platform::stream_profile{ desc.width, desc.height, desc.fps, 0 });
+                profile->set_dims(desc.width, desc.height);
+                profile->set_stream_type(stream->get_stream_type());
+                profile->set_stream_index(stream->get_stream_index());
+                profile->set_format(static_cast<rs2_format>(desc.format));
+                profile->set_framerate(desc.fps);
+                // Published with the first frame of the profile
+                profile->set_intrinsics([memory, i]() -> rs2_intrinsics
+                {
+                    auto&& d = memory->header().profiles[i];
+                    if (!d.has_intrinsics)
+                        throw not_implemented_exception("No intrinsics were published for this stream profile!");
+                    return d.intrinsics;
+                });
+                std::shared_ptr<stream_profile_interface> target = profile;
+                assign_stream(stream, target);
+                _by_profile[i] = target;
+                results.push_back(target);
+            }
+            return results;
+        }
+
+    private:
+        uint32_t _index;
+        shared_device* _device;
+        std::mutex _configure_lock;
+        std::vector<std::shared_ptr<stream_profile_interface>> _opened;      // Per profile of the segment
+        std::vector<frame_source::callback_lane*> _lanes;                    // Callback lane of each opened profile
+        std::vector<std::shared_ptr<stream_profile_interface>> _by_profile;  // Profiles of this sensor, per profile of the segment
+    };
+
+    class shared_depth_sensor : public shared_sensor, public depth_sensor
+    {
+    public:
+        shared_depth_sensor(const std::string& name, uint32_t index, shared_device* owner, float depth_units)
+            : shared_sensor(name, index, owner), _depth_units(depth_units) {}
+
+        float get_depth_scale() const override { return _depth_units; }
+
+        void create_snapshot(std::shared_ptr<depth_sensor>& snapshot) const override
+        {
+            snapshot = std::make_shared<depth_sensor_snapshot>(get_depth_scale());
+        }
+
+        void enable_recording(std::function<void(const depth_sensor&)> recording_function) override
+        {
+            //does not change over time
+        }
+
+    private:
+        float _depth_units;
+    };
+
+    shared_device::shared_device(std::shared_ptr<context> ctx, const std::string& name, const platform::backend_device_group& group)
+        : device(ctx, group), _memory(shared_memory::open(name)), _reading(false)
+    {
+        auto&& h = _memory->header();
+        for (size_t i = 0; i < 4; i++)
+        {
+            std::string info(h.info[i], strnlen(h.info[i], SHARED_INFO_SIZE));
+            if (!info.empty()) register_info(shared_infos[i], info);
+        }
+
+        auto memory = _memory;
+        for (uint32_t k = 0; k < std::min(h.stream_count, MAX_SHARED_STREAMS); k++)
+        {
+            auto stream = std::make_shared<librealsense::stream>(static_cast<rs2_stream>(h.streams[k].stream), h.streams[k].index);
+            _streams.push_back(stream);
+            register_stream_to_extrinsic_group(*stream, 0);
+            if (k == 0 || !h.streams[k].has_extrinsics) continue;
+
+            auto extrinsics = std::make_shared<lazy<rs2_extrinsics>>([memory, k]() { return memory->header().streams[k].extrinsics; });
+            environment::get_instance().get_extrinsics_graph().register_extrinsics(*_streams[0], *stream, extrinsics);
+            _extrinsics.push_back(extrinsics);
+        }
+
+        for (uint32_t s = 0; s < std::min(h.sensor_count, MAX_SHARED_SENSORS); s++)
+        {
+            std::string sensor_name(h.sensor_names[s], strnlen(h.sensor_names[s], SHARED_INFO_SIZE));
+            std::shared_ptr<shared_sensor> sensor;
+            if (h.depth_units[s] > 0)
+                sensor = std::make_shared<shared_depth_sensor>(sensor_name, s, this, h.depth_units[s]);
+            else
+                sensor = std::make_shared<shared_sensor>(sensor_name, s, this);
+            add_sensor(sensor);
+            _sensors.push_back(sensor);
+        }
+    }
+
+    shared_device::~shared_device()
+    {
+        _reading = false;
+        if (_reader.joinable())
+            _reader.join();
+    }
+
+    void shared_device::start_reading()
+    {
+        std::lock_guard<std::mutex> lock(_reader_mutex);
+        if (_reading) return;
+
+        _reading = true;
+        _reader = std::thread([this]()
+        {
+            thread_registration registration("rs-shared-read", RS2_THREAD_CLASS_CAPTURE);
+            read_frames();
+        });
+    }
+
+    // Polls the log of the segment, the publisher does not signal other processes
+    void shared_device::read_frames()
+    {
+        auto&& h = _memory->header();
+        auto read = h.published.load();
+        while (_reading)
+        {
+            auto published = h.published.load();
+            if (published == read)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                continue;
+            }
+
+            // Frames overwritten in the log before they were read are skipped
+            if (published - read > SHARED_LOG_SIZE)
+                read = published - SHARED_LOG_SIZE;
+            for (auto sequence = read + 1; sequence <= published; sequence++)
+            {
+                auto entry = h.log[sequence % SHARED_LOG_SIZE].load();
+                auto slot = static_cast<uint32_t>(entry & 0xffff);
+                if ((entry >> 16) != (sequence & 0xffffffffffffull) || slot >= h.slot_count ||
+                    !_memory->acquire_published(slot))
+                    continue;
+
+                auto&& s = _memory->slot(slot);
+                if (s.sequence != sequence || s.profile >= h.profile_count)
+                {
+                    _memory->release(slot);
+                    continue;
+                }
+                _sensors[h.profiles[s.profile].sensor]->dispatch(slot, _memory);
+            }
+            read = published;
+        }
+    }
+
+    std::vector<std::shared_ptr<device_info>> shared_device_info::pick_shared_devices(const std::shared_ptr<context>& ctx)
+    {
+        std::vector<std::shared_ptr<device_info>> results;
+#ifdef __linux__
+        // Segments are not enumerable through the POSIX API, Linux keeps them in /dev/shm
+        auto dir = opendir("/dev/shm");
+        if (!dir) return results;
+
+        std::string prefix = SHARED_DEVICE_PREFIX;
+        while (auto entry = readdir(dir))
+        {
+            std::string file = entry->d_name;
+            if (file.compare(0, prefix.size(), prefix) != 0) continue;
+
+            auto name = file.substr(prefix.size());
+            if (shared_memory::get_owner(name))
+                results.push_back(std::make_shared<shared_device_info>(ctx, name));
+        }
+        closedir(dir);
+#endif
+        return results;
+    }
+
+    std::shared_ptr<device_interface> shared_device_info::create(std::shared_ptr<context> ctx, bool) const
+    {
+        return std::make_shared<shared_device>(ctx, _name, get_device_data());
+    }
+}
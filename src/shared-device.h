@@ -0,0 +1,91 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2015 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "device.h"
+#include "stream.h"
+
+#include <atomic>
+#include <deque>
+#include <thread>
+
+namespace librealsense
+{
+    class shared_memory;
+    class shared_sensor;
+
+    // Publishes the video frames of a device into a shared memory segment, where other processes read them in place
+    // The frame buffers of the device sensors are allocated in the slots of the segment, so publishing such a frame
+    // does not copy it. Frames allocated elsewhere are copied into a free slot, or dropped when none is free
+    // The last published slots are kept for the readers even after the frames are released in this process
+    class frame_publisher
+    {
+    public:
+        // The sensors of the device must not be streaming, their frame allocators are replaced
+        frame_publisher(std::shared_ptr<device_interface> dev, const std::string& name, uint32_t slots);
+        ~frame_publisher();
+
+        // Composite frames publish their frames. Frames of streams the segment does not describe are dropped
+        void publish(frame_interface* f);
+
+        uint64_t get_dropped() const { return _dropped; }
+
+    private:
+        int find_profile(frame_interface* f) const;
+
+        std::shared_ptr<device_interface> _dev;
+        std::shared_ptr<shared_memory> _memory;
+        std::map<std::tuple<uint32_t, rs2_stream, int, uint32_t, uint32_t, uint32_t, rs2_format>, uint32_t> _profiles;
+        std::mutex _mutex;
+        std::vector<bool> _intrinsics_written;
+        std::deque<int> _retained;
+        size_t _retained_count;
+        uint64_t _sequence;
+        std::atomic<uint64_t> _dropped;
+    };
+
+    // Device reading the frames published by another process. It has one sensor per sensor of the published device,
+    // offering the video profiles of the published device
+    class shared_device : public device
+    {
+    public:
+        shared_device(std::shared_ptr<context> ctx, const std::string& name, const platform::backend_device_group& group);
+        ~shared_device();
+
+    private:
+        friend class shared_sensor;
+
+        void start_reading();
+        void read_frames();
+
+        std::shared_ptr<shared_memory> _memory;
+        std::vector<std::shared_ptr<shared_sensor>> _sensors;
+        std::vector<std::shared_ptr<stream_interface>> _streams;
+        std::vector<std::shared_ptr<lazy<rs2_extrinsics>>> _extrinsics;
+        std::mutex _reader_mutex;
+        std::atomic<bool> _reading;
+        std::thread _reader;
+    };
+
+    class shared_device_info : public device_info
+    {
+    public:
+        // Devices published by live processes of this machine
+        static std::vector<std::shared_ptr<device_info>> pick_shared_devices(const std::shared_ptr<context>& ctx);
+
+        shared_device_info(std::shared_ptr<context> ctx, std::string name)
+            : device_info(ctx), _name(std::move(name)) {}
+
+        platform::backend_device_group get_device_data() const override
+        {
+            return platform::backend_device_group({ platform::playback_device_info{ "shared:" + _name } });
+        }
+
+    protected:
+        std::shared_ptr<device_interface> create(std::shared_ptr<context> ctx, bool register_device_notifications) const override;
+
+    private:
+        std::string _name;
+    };
+}
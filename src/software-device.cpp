@@ -0,0 +1,256 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#include "software-device.h"
+#include "option.h"
+
+namespace librealsense
+{
+    software_device::software_device(std::shared_ptr<context> ctx, const std::string& name)
+        : device(ctx, platform::backend_device_group({ platform::playback_device_info{ "software:" + name } }))
+    {
+        register_info(RS2_CAMERA_INFO_NAME, "Software Device");
+        register_info(RS2_CAMERA_INFO_SERIAL_NUMBER, name);
+    }
+
+    software_sensor& software_device::add_software_sensor(const std::string& name)
+    {
+        auto sensor = std::make_shared<software_sensor>(name, this);
+        std::lock_guard<std::mutex> lock(_mutex);
+        add_sensor(sensor);
+        _software_sensors.push_back(sensor);
+        return *sensor;
+    }
+
+    software_sensor& software_device::get_software_sensor(size_t index)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (index >= _software_sensors.size())
+            throw invalid_value_exception(to_string() << "Software device has no sensor " << index);
+        return *_software_sensors[index];
+    }
+
+    std::shared_ptr<stream_interface> software_device::get_stream(rs2_stream type, int index)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto&& stream = _streams[std::make_pair(type, index)];
+        if (!stream)
+        {
+            stream = std::make_shared<librealsense::stream>(type, index);
+            register_stream_to_extrinsic_group(*stream, 0);
+        }
+        return stream;
+    }
+
+    void software_device::register_extrinsics(const stream_interface& from, const stream_interface& to, const rs2_extrinsics& extrinsics)
+    {
+        // The graph only keeps a weak reference to the extrinsics
+        auto value = extrinsics;
+        auto lazy_extrinsics = std::make_shared<lazy<rs2_extrinsics>>([value]() { return value; });
+        environment::get_instance().get_extrinsics_graph().register_extrinsics(from, to, lazy_extrinsics);
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        _extrinsics.push_back(lazy_extrinsics);
+    }
+
+    std::shared_ptr<matcher> software_device::create_matcher(const frame_holder& frame) const
+    {
+        std::vector<std::shared_ptr<matcher>> matchers;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            for (auto&& kvp : _streams)
+                matchers.push_back(std::make_shared<identity_matcher>(kvp.second->get_unique_id(), kvp.second->get_stream_type()));
+        }
+        return std::make_shared<timestamp_composite_matcher>(matchers);
+    }
+
+    software_sensor::software_sensor(const std::string& name, software_device* owner)
+        : sensor_base(name, owner), _device(owner)
+    {
+    }
+
+    std::shared_ptr<stream_profile_interface> software_sensor::add_video_stream(const rs2_video_stream& video_stream)
+    {
+        if (video_stream.width <= 0 || video_stream.height <= 0 || video_stream.bpp <= 0 || video_stream.fps < 0)
+            throw invalid_value_exception(to_string() << "Invalid video stream " << video_stream.width << "x" << video_stream.height
+                                                      << ", " << video_stream.bpp << " bytes per pixel, at " << video_stream.fps << " fps");
+
+        auto profile = std::make_shared<video_stream_profile>(platform::stream_profile{
+            static_cast<uint32_t>(video_stream.width), static_cast<uint32_t>(video_stream.height), static_cast<uint32_t>(video_stream.fps), 0 });
+        profile->set_dims(video_stream.width, video_stream.height);
+        profile->set_stream_type(video_stream.type);
+        profile->set_stream_index(video_stream.index);
+        profile->set_format(video_stream.fmt);
+        profile->set_framerate(video_stream.fps);
+        auto intrinsics = video_stream.intrinsics;
+        profile->set_intrinsics([intrinsics]() { return intrinsics; });
+
+        std::shared_ptr<stream_profile_interface> target = profile;
+        assign_stream(_device->get_stream(video_stream.type, video_stream.index), target);
+
+        std::lock_guard<std::mutex> lock(_configure_lock);
+        if (_is_opened)
+            throw wrong_api_call_sequence_exception("add_video_stream(...) failed. Software sensor is opened!");
+        _added.push_back(target);
+        _opened.push_back(nullptr);
+        _lanes.push_back(nullptr);
+        return target;
+    }
+
+    void software_sensor::add_read_only_option(rs2_option option, float value)
+    {
+        register_option(option, std::make_shared<const_value_option>("Read-only option of a software sensor", value));
+    }
+
+    stream_profiles software_sensor::get_stream_profiles() const
+    {
+        std::lock_guard<std::mutex> lock(_configure_lock);
+        return _added;
+    }
+
+    stream_profiles software_sensor::init_stream_profiles()
+    {
+        return get_stream_profiles();
+    }
+
+    void software_sensor::open(const stream_profiles& requests)
+    {
+        std::lock_guard<std::mutex> lock(_configure_lock);
+        if (_is_streaming)
+            throw wrong_api_call_sequence_exception("open(...) failed. Software sensor is streaming!");
+        else if (_is_opened)
+            throw wrong_api_call_sequence_exception("open(...) failed. Software sensor is already opened!");
+
+        std::vector<std::shared_ptr<stream_profile_interface>> opened(_added.size());
+        for (auto&& r : requests)
+        {
+            auto p = to_profile(r.get());
+            auto it = std::find_if(_added.begin(), _added.end(), [&p](const std::shared_ptr<stream_profile_interface>& sp)
+            {
+                return to_profile(sp.get()) == p;
+            });
+            if (it == _added.end())
+                throw invalid_value_exception(to_string() << "Profile " << p.stream << " " << p.width << "x" << p.height
+                                                          << " " << p.format << " was not added to the software sensor");
+            opened[it - _added.begin()] = r;
+        }
+
+        _source.init(_metadata_parsers);
+        _source.set_sensor(shared_from_this());
+        std::vector<frame_source::callback_lane*> lanes(opened.size());
+        for (size_t i = 0; i < opened.size(); i++)
+            if (opened[i]) lanes[i] = _source.open_lane(opened[i]->get_unique_id());
+        _opened = std::move(opened);
+        _lanes = std::move(lanes);
+        _is_opened = true;
+    }
+
+    void software_sensor::close()
+    {
+        std::lock_guard<std::mutex> lock(_configure_lock);
+        if (_is_streaming)
+            throw wrong_api_call_sequence_exception("close() failed. Software sensor is streaming!");
+        else if (!_is_opened)
+            throw wrong_api_call_sequence_exception("close() failed. Software sensor was not opened!");
+
+        _source.flush();
+        _source.reset();
+        std::fill(_opened.begin(), _opened.end(), nullptr);
+        std::fill(_lanes.begin(), _lanes.end(), nullptr);
+        _is_opened = false;
+    }
+
+    void software_sensor::start(frame_callback_ptr callback)
+    {
+        std::lock_guard<std::mutex> lock(_configure_lock);
+        if (_is_streaming)
+            throw wrong_api_call_sequence_exception("start_streaming(...) failed. Software sensor is already streaming!");
+        else if (!_is_opened)
+            throw wrong_api_call_sequence_exception("start_streaming(...) failed. Software sensor was not opened!");
+
+        _source.set_callback(callback);
+        _is_streaming = true;
+    }
+
+    void software_sensor::stop()
+    {
+        std::lock_guard<std::mutex> lock(_configure_lock);
+        if (!_is_streaming)
+            throw wrong_api_call_sequence_exception("stop_streaming() failed. Software sensor is not streaming!");
+
+        _is_streaming = false;
+    }
+
+    void software_sensor::on_video_frame(const rs2_software_video_frame& software_frame)
+    {
+        // From here on the pixels are released by the frame, or right away when there is none
+        frame_continuation release_pixels;
+        if (software_frame.deleter)
+        {
+            auto deleter = software_frame.deleter;
+            auto pixels = software_frame.pixels;
+            release_pixels = frame_continuation([deleter, pixels]() { deleter(pixels); }, pixels);
+        }
+
+        if (!software_frame.pixels)
+            throw invalid_value_exception("on_video_frame(...) failed. The frame has no pixels");
+
+        std::shared_ptr<stream_profile_interface> request;
+        frame_source::callback_lane* lane = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(_configure_lock);
+            auto it = std::find_if(_added.begin(), _added.end(), [&software_frame](const std::shared_ptr<stream_profile_interface>& sp)
+            {
+                return software_frame.profile && sp.get() == software_frame.profile->profile;
+            });
+            if (it == _added.end())
+                throw invalid_value_exception("on_video_frame(...) failed. The profile of the frame was not added to the software sensor");
+            if (_is_streaming)
+            {
+                request = _opened[it - _added.begin()];
+                lane = _lanes[it - _added.begin()];
+            }
+        }
+        if (!request) return;
+
+        auto video_profile = As<video_stream_profile_interface>(request);
+        if (!video_profile)
+            throw invalid_value_exception("on_video_frame(...) failed. The sensor was opened with a profile that is not of video");
+        auto width = static_cast<int>(video_profile->get_width());
+        auto height = static_cast<int>(video_profile->get_height());
+        if (software_frame.stride < width * software_frame.bpp)
+            throw invalid_value_exception(to_string() << "on_video_frame(...) failed. Stride " << software_frame.stride
+                                                      << " is too short for " << width << " pixels of " << software_frame.bpp << " bytes");
+
+        frame_additional_data additional_data(software_frame.timestamp, software_frame.frame_number, _source.get_time(), 0, nullptr);
+        additional_data.timestamp_domain = software_frame.domain;
+        additional_data.latency_breakdown[RS2_FRAME_LATENCY_STAGE_BACKEND_ARRIVAL] = get_latency_time();
+        auto type = request->get_stream_type() == RS2_STREAM_DEPTH ? RS2_EXTENSION_DEPTH_FRAME : RS2_EXTENSION_VIDEO_FRAME;
+        auto size = static_cast<size_t>(software_frame.stride) * height;
+
+        // Adopted pixels become the data of the frame, the others are copied into a buffer of the archive
+        bool adopt = release_pixels.get_data() != nullptr;
+        frame_holder frame = _source.alloc_frame(type, adopt ? 0 : size, additional_data, !adopt);
+        if (!frame.frame)
+        {
+            LOG_INFO("Dropped frame. alloc_frame(...) returned nullptr");
+            _source.on_frame_dropped(request->get_unique_id());
+            return;
+        }
+
+        auto video = static_cast<video_frame*>(frame.frame);
+        video->assign(width, height, software_frame.stride, software_frame.bpp * 8);
+        video->set_timestamp_domain(software_frame.domain);
+        if (adopt)
+        {
+            video->attach_continuation(std::move(release_pixels));
+            video->user_data_size = size;
+        }
+        else
+        {
+            memcpy(const_cast<byte*>(video->get_frame_data()), software_frame.pixels, size);
+        }
+        frame->set_stream(request);
+        _source.invoke_callback(std::move(frame), lane);
+    }
+}
@@ -0,0 +1,74 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "../include/librealsense2/h/rs_internal.h"
+#include "device.h"
+#include "stream.h"
+
+namespace librealsense
+{
+    class software_sensor;
+
+    // Device whose sensors deliver the frames the application injects, for testing and benchmarking the processing
+    // without hardware, or replaying frames kept in a format of the application. The frames go through the archives of
+    // the sensors like the frames of a camera, so the syncer, pipeline and processing blocks handle them the same
+    class software_device : public device
+    {
+    public:
+        software_device(std::shared_ptr<context> ctx, const std::string& name);
+
+        software_sensor& add_software_sensor(const std::string& name);
+        software_sensor& get_software_sensor(size_t index);
+
+        void register_extrinsics(const stream_interface& from, const stream_interface& to, const rs2_extrinsics& extrinsics);
+
+        // Frames of all the streams are matched by their timestamps
+        std::shared_ptr<matcher> create_matcher(const frame_holder& frame) const override;
+
+    private:
+        friend class software_sensor;
+
+        // The stream of the type and index, shared by all its profiles
+        std::shared_ptr<stream_interface> get_stream(rs2_stream type, int index);
+
+        std::vector<std::shared_ptr<software_sensor>> _software_sensors;
+        std::map<std::pair<rs2_stream, int>, std::shared_ptr<stream_interface>> _streams;
+        std::vector<std::shared_ptr<lazy<rs2_extrinsics>>> _extrinsics;
+        mutable std::mutex _mutex;
+    };
+
+    class software_sensor : public sensor_base
+    {
+    public:
+        software_sensor(const std::string& name, software_device* owner);
+
+        std::shared_ptr<stream_profile_interface> add_video_stream(const rs2_video_stream& video_stream);
+        void add_read_only_option(rs2_option option, float value);
+
+        // Adopts the pixels of the frame when it has a deleter, which is then called in all cases
+        void on_video_frame(const rs2_software_video_frame& software_frame);
+
+        // The profiles added so far, while profiles may still be added
+        stream_profiles get_stream_profiles() const override;
+
+        void open(const stream_profiles& requests) override;
+        void close() override;
+        void start(frame_callback_ptr callback) override;
+        void stop() override;
+
+    protected:
+        stream_profiles init_stream_profiles() override;
+
+    private:
+        software_device* _device;
+        mutable std::mutex _configure_lock;
+        stream_profiles _added;
+        std::vector<std::shared_ptr<stream_profile_interface>> _opened;     // The request opening each of the added profiles
+        std::vector<frame_source::callback_lane*> _lanes;                   // Callback lane of each of the opened profiles
+    };
+
+    MAP_EXTENSION(RS2_EXTENSION_SOFTWARE_DEVICE, software_device);
+    MAP_EXTENSION(RS2_EXTENSION_SOFTWARE_SENSOR, software_sensor);
+}
@@ -1,9 +1,12 @@
 // License: Apache 2.0. See LICENSE file in root directory.
 // Copyright(c) 2015 Intel Corporation. All Rights Reserved.
 
+#include <chrono>
+
 #include "source.h"
 #include "option.h"
 #include "environment.h"
+#include "tracing.h"
 
 namespace librealsense
 {
@@ -30,7 +33,8 @@ namespace librealsense
 
         const char* get_description() const override
         {
-            return "Max number of frames you can hold at a given time. Increasing this number will reduce frame drops but increase latency, and vice versa";
+            return "Max number of frames you can hold at a given time. Increasing this number will reduce frame drops but increase latency, and vice versa. "
+                   "Raising it while streaming takes effect the next time the sensor is opened";
         }
     private:
         std::atomic<uint32_t>* _ptr;
@@ -38,13 +42,32 @@ namespace librealsense
 
     std::shared_ptr<option> frame_source::get_published_size_option()
     {
-        return std::make_shared<frame_queue_size>(&_max_publish_list_size, option_range{ 1, 32, 1, 16 });
+        return std::make_shared<frame_queue_size>(&_max_publish_list_size, option_range{ 1, RS2_USER_QUEUE_SIZE, 1, 16 });
+    }
+
+    std::shared_ptr<option> frame_source::get_callback_lanes_option()
+    {
+        return std::make_shared<ptr_option<uint32_t>>(lanes_off, lanes_fifo, 1, lanes_off, &_lane_mode,
+            "Deliver frames on the capture thread (0), or on a thread per stream keeping the latest frame (1) or a queue of frames (2), "
+            "takes effect on next start");
+    }
+
+    std::shared_ptr<option> frame_source::get_buffer_pool_option()
+    {
+        return std::make_shared<ptr_option<uint32_t>>(0, 32, 1, FRAME_POOL_DEFAULT_HIGH_WATER_MARK, &_pool_high_water_mark,
+            "Frame buffers of each size cached for the next frames once released, takes effect on next open");
     }
 
     frame_source::frame_source()
             : _callback(nullptr, [](rs2_frame_callback*) {}),
               _max_publish_list_size(16),
-              _ts(environment::get_instance().get_time_service())
+              _allocator(nullptr),
+              _alignment(0),
+              _pool_high_water_mark(FRAME_POOL_DEFAULT_HIGH_WATER_MARK),
+              _ts(environment::get_instance().get_time_service()),
+              _lane_mode(lanes_off),
+              _active_lane_mode(lanes_off),
+              _broadcaster(std::make_shared<frame_broadcaster>())
     {}
 
     void frame_source::init(std::shared_ptr<metadata_parser_map> metadata_parsers)
@@ -54,12 +77,94 @@ namespace librealsense
         std::vector<rs2_extension> supported { RS2_EXTENSION_VIDEO_FRAME,
                                                RS2_EXTENSION_COMPOSITE_FRAME,
                                                RS2_EXTENSION_POINTS,
-                                               RS2_EXTENSION_DEPTH_FRAME };
+                                               RS2_EXTENSION_DEPTH_FRAME,
+                                               RS2_EXTENSION_MOTION_FRAME };
 
         for (auto type : supported)
         {
             _archive[type] = make_archive(type, &_max_publish_list_size, _ts, metadata_parsers);
+            _archive[type]->set_frame_allocator(_allocator, _alignment);
+            _archive[type]->set_frame_memory(_memory_policy);
+            _archive[type]->set_buffer_pool_high_water_mark(_pool_high_water_mark);
+        }
+
+        std::lock_guard<std::mutex> drops_lock(_drops_mutex);
+        _dropped_frames.clear();
+        _lost_frames.clear();
+
+        stop_lanes();
+        std::lock_guard<std::mutex> lanes_lock(_lanes_mutex);
+        _lanes.clear();
+    }
+
+    void frame_source::on_frame_dropped(int stream_id)
+    {
+        std::lock_guard<std::mutex> lock(_drops_mutex);
+        _dropped_frames[stream_id]++;
+    }
+
+    unsigned long long frame_source::get_dropped_frames(int stream_id) const
+    {
+        std::lock_guard<std::mutex> lock(_drops_mutex);
+        auto it = _dropped_frames.find(stream_id);
+        return it != _dropped_frames.end() ? it->second : 0;
+    }
+
+    void frame_source::on_frames_lost(int stream_id, unsigned long long count)
+    {
+        std::lock_guard<std::mutex> lock(_drops_mutex);
+        _lost_frames[stream_id] += count;
+    }
+
+    unsigned long long frame_source::get_lost_frames(int stream_id) const
+    {
+        std::lock_guard<std::mutex> lock(_drops_mutex);
+        auto it = _lost_frames.find(stream_id);
+        return it != _lost_frames.end() ? it->second : 0;
+    }
+
+    callback_stats frame_source::get_callback_stats(int stream_id) const
+    {
+        callback_stats stats = {};
+        std::lock_guard<std::mutex> lock(_lanes_mutex);
+        auto it = _lanes.find(stream_id);
+        if (it == _lanes.end()) return stats;
+
+        auto&& lane = *it->second;
+        stats.calls = lane.calls;
+        stats.total_ms = lane.total_us * 0.001;
+        stats.max_ms = lane.max_us * 0.001;
+        stats.dropped = lane.dropped;
+        if (lane.worker)
+        {
+            stats.dropped += lane.worker->get_dropped_count();
+            stats.queued = lane.worker->size();
         }
+        return stats;
+    }
+
+    uint32_t frame_source::get_published_frames_count() const
+    {
+        std::lock_guard<std::mutex> lock(_callback_mutex);
+        uint32_t count = 0;
+        for (auto&& a : _archive)
+            if (a.second) count += a.second->get_published_frames_count();
+        return count;
+    }
+
+    frame_buffer_pool_stats frame_source::get_buffer_pool_stats() const
+    {
+        std::lock_guard<std::mutex> lock(_callback_mutex);
+        frame_buffer_pool_stats stats{ 0, 0, 0 };
+        for (auto&& a : _archive)
+        {
+            if (!a.second) continue;
+            auto s = a.second->get_buffer_pool_stats();
+            stats.hits += s.hits;
+            stats.misses += s.misses;
+            stats.evictions += s.evictions;
+        }
+        return stats;
     }
 
     callback_invocation_holder frame_source::begin_callback()
@@ -78,13 +183,86 @@ namespace librealsense
         }
     }
 
-    frame_interface* frame_source::alloc_frame(rs2_extension type, size_t size, frame_additional_data additional_data, bool requires_memory) const
+    frame_interface* frame_source::alloc_frame(rs2_extension type, size_t size, const frame_additional_data& additional_data, bool requires_memory) const
     {
         auto it = _archive.find(type);
         if (it == _archive.end()) throw wrong_api_call_sequence_exception("Requested frame type is not supported!");
         return it->second->alloc_and_track(size, additional_data, requires_memory);
     }
 
+    static int get_embeded_frames_size(frame_interface* f)
+    {
+        if (f == nullptr) return 0;
+        if (auto c = dynamic_cast<composite_frame*>(f))
+            return static_cast<int>(c->get_embedded_frames_count());
+        return 1;
+    }
+
+    static void copy_frames(frame_holder from, frame_interface**& target)
+    {
+        if (auto comp = dynamic_cast<composite_frame*>(from.frame))
+        {
+            auto frame_buff = comp->get_frames();
+            for (size_t i = 0; i < comp->get_embedded_frames_count(); i++)
+            {
+                std::swap(*target, frame_buff[i]);
+                target++;
+            }
+            from.frame->disable_continuation();
+        }
+        else
+        {
+            *target = nullptr; // "move" the frame ref into target
+            std::swap(*target, from.frame);
+            target++;
+        }
+    }
+
+    frame_interface* frame_source::allocate_composite_frame(frame_holder* holders, size_t count) const
+    {
+        frame_additional_data d {};
+
+        auto req_size = 0;
+        for (size_t i = 0; i < count; i++)
+            req_size += get_embeded_frames_size(holders[i].frame);
+
+        // Small framesets live entirely in the recycled composite frame object
+        auto inline_frames = req_size <= static_cast<int>(COMPOSITE_INLINE_FRAMES);
+        auto res = alloc_frame(RS2_EXTENSION_COMPOSITE_FRAME,
+                                              inline_frames ? 0 : req_size * sizeof(rs2_frame*), d, !inline_frames);
+        if (!res) return nullptr;
+
+        auto cf = static_cast<composite_frame*>(res);
+        cf->set_embedded_frames_count(req_size);
+
+        auto frames = cf->get_frames();
+        for (size_t i = 0; i < count; i++)
+            copy_frames(std::move(holders[i]), frames);
+        frames -= req_size;
+        cf->index_streams();
+
+        auto releaser = [frames, req_size]()
+        {
+            for (auto i = 0; i < req_size; i++)
+            {
+                frames[i]->release();
+                frames[i] = nullptr;
+            }
+        };
+        frame_continuation release_frames(releaser, nullptr);
+        cf->attach_continuation(std::move(release_frames));
+        cf->set_stream(cf->first()->get_stream());
+
+        return res;
+    }
+
+    void frame_source::reserve_frames(rs2_extension type, size_t size) const
+    {
+        auto it = _archive.find(type);
+        if (it == _archive.end()) throw wrong_api_call_sequence_exception("Requested frame type is not supported!");
+        it->second->reserve_buffers(size);
+    }
+
     void frame_source::set_sensor(std::shared_ptr<sensor_interface> s)
     {
         for (auto&& a : _archive)
@@ -93,36 +271,141 @@ namespace librealsense
         }
     }
 
+    void frame_source::set_frame_allocator(frame_allocator_ptr allocator, size_t alignment)
+    {
+        std::lock_guard<std::mutex> lock(_callback_mutex);
+        _allocator = allocator;
+        _alignment = alignment;
+        for (auto&& a : _archive)
+        {
+            if (a.second) a.second->set_frame_allocator(allocator, alignment);
+        }
+    }
+
+    void frame_source::set_frame_memory(const frame_memory_policy& policy)
+    {
+        std::lock_guard<std::mutex> lock(_callback_mutex);
+        _memory_policy = policy;
+    }
+
+    void frame_source::start_lane_worker(callback_lane& lane) const
+    {
+        if (_active_lane_mode == lanes_off || lane.worker) return;
+        auto cap = _active_lane_mode == lanes_latest ? 1u : _max_publish_list_size.load();
+        lane.worker = std::make_shared<dispatcher>(cap, "rs-callback", RS2_THREAD_CLASS_PROCESSING);
+        lane.worker->start();
+    }
+
     void frame_source::set_callback(frame_callback_ptr callback)
     {
         std::lock_guard<std::mutex> lock(_callback_mutex);
         _callback = callback;
+        _active_lane_mode = static_cast<int>(_lane_mode);
+
+        std::lock_guard<std::mutex> lanes_lock(_lanes_mutex);
+        for (auto&& kvp : _lanes)
+            start_lane_worker(*kvp.second);
     }
 
-    void frame_source::invoke_callback(frame_holder frame) const
+    frame_source::callback_lane* frame_source::open_lane(int stream_id)
     {
-        if (frame)
+        std::lock_guard<std::mutex> lock(_lanes_mutex);
+        auto&& lane = _lanes[stream_id];
+        if (!lane) lane = std::make_shared<callback_lane>();
+        start_lane_worker(*lane);
+        return lane.get();
+    }
+
+    // Task of a lane worker, the frame it holds is released with the task when the lane drops it
+    struct frame_source::lane_delivery
+    {
+        // The lanes outlive their workers, which are stopped before the lanes are cleared
+        const frame_source* source;
+        callback_lane* lane;
+        frame_holder frame;
+
+        void operator()(dispatcher::cancellable_timer) { source->deliver(lane, std::move(frame)); }
+    };
+
+    void frame_source::invoke_callback(frame_holder frame, callback_lane* lane) const
+    {
+        if (!frame) return;
+        RS2_TRACE_INSTANT("publish", frame->get_frame_number());
+        _broadcaster->publish(frame.frame);
+
+        // Lanes off, the default, deliver on the calling thread
+        if (_active_lane_mode == lanes_off)
+        {
+            deliver(lane, std::move(frame));
+            return;
+        }
+
+        // The workers are replaced on stop and start, so they are taken under the lock
+        std::shared_ptr<dispatcher> worker;
         {
-            auto callback = frame.frame->get_owner()->begin_callback();
-            try
+            std::lock_guard<std::mutex> lock(_lanes_mutex);
+            if (!lane)
             {
-                frame->log_callback_start(_ts ? _ts->get_time() : 0);
-                if (_callback)
-                {
-                    frame_interface* ref = nullptr;
-                    std::swap(frame.frame, ref);
-                    _callback->on_frame((rs2_frame*)ref);
-                }
+                auto stream = frame->get_stream();
+                auto it = _lanes.find(stream ? stream->get_unique_id() : 0);
+                if (it != _lanes.end()) lane = it->second.get();
             }
-            catch(...)
+            if (lane) worker = lane->worker;
+        }
+
+        if (worker) worker->invoke(lane_delivery{ this, lane, std::move(frame) });
+        else deliver(lane, std::move(frame));
+    }
+
+    void frame_source::deliver(callback_lane* lane, frame_holder frame) const
+    {
+        auto start = std::chrono::steady_clock::now();
+        auto callback = frame.frame->get_owner()->begin_callback();
+        try
+        {
+            frame->log_callback_start(_ts ? _ts->get_time() : 0);
+            log_latency_stage(frame, RS2_FRAME_LATENCY_STAGE_CALLBACK_START);
+            if (_callback)
+            {
+                RS2_TRACE_SCOPE("user callback", frame->get_frame_number());
+                frame_interface* ref = nullptr;
+                std::swap(frame.frame, ref);
+                _callback->on_frame((rs2_frame*)ref);
+            }
+        }
+        catch(...)
+        {
+            LOG_ERROR("Exception was thrown during user callback!");
+        }
+
+        if (!lane) return;
+        unsigned long long us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+        lane->calls++;
+        lane->total_us += us;
+        auto max_us = lane->max_us.load();
+        while (us > max_us && !lane->max_us.compare_exchange_weak(max_us, us));
+    }
+
+    void frame_source::stop_lanes() const
+    {
+        std::vector<std::shared_ptr<dispatcher>> workers;
+        {
+            std::lock_guard<std::mutex> lock(_lanes_mutex);
+            for (auto&& kvp : _lanes)
             {
-                LOG_ERROR("Exception was thrown during user callback!");
+                auto&& lane = *kvp.second;
+                if (!lane.worker) continue;
+                lane.dropped += lane.worker->get_dropped_count();
+                workers.push_back(std::move(lane.worker));
             }
         }
+        // Each worker waits for the callback in progress, and drops the frames still queued
+        workers.clear();
     }
 
     void frame_source::flush() const
     {
+        stop_lanes();
         for (auto&& kvp : _archive)
         {
             if (kvp.second)
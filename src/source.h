@@ -7,11 +7,22 @@
 #include "concurrency.h"
 #include "archive.h"
 #include "metadata-parser.h"
+#include "frame-broadcaster.h"
 
 namespace librealsense
 {
     class option;
 
+    // Time the callback of a sensor took for the frames of a stream, and the frames dropped waiting for it
+    struct callback_stats
+    {
+        unsigned long long calls;
+        double total_ms;
+        double max_ms;
+        unsigned long long dropped;
+        size_t queued;
+    };
+
     class frame_source
     {
     public:
@@ -24,30 +35,105 @@ namespace librealsense
         void reset();
 
         std::shared_ptr<option> get_published_size_option();
+        std::shared_ptr<option> get_callback_lanes_option();
+        std::shared_ptr<option> get_buffer_pool_option();
+
+        frame_interface* alloc_frame(rs2_extension type, size_t size, const frame_additional_data& additional_data, bool requires_memory) const;
+
+        // Frameset of the frames, the frames of framesets among them are embedded one by one. Takes the ownership of the frames
+        frame_interface* allocate_composite_frame(frame_holder* holders, size_t count) const;
 
-        frame_interface* alloc_frame(rs2_extension type, size_t size, frame_additional_data additional_data, bool requires_memory) const;
+        // Cache the buffers of all the frames of the type and size that may be held at once, see archive_interface::reserve_buffers
+        void reserve_frames(rs2_extension type, size_t size) const;
 
         void set_callback(frame_callback_ptr callback);
 
-        void invoke_callback(frame_holder frame) const;
+        // Stream of frames to the callback. With lanes on every stream has its own thread, so a slow callback
+        // of a stream neither holds the capture thread nor the other streams
+        struct callback_lane
+        {
+            std::shared_ptr<dispatcher> worker;
+            std::atomic<unsigned long long> calls{ 0 };
+            std::atomic<unsigned long long> total_us{ 0 };
+            std::atomic<unsigned long long> max_us{ 0 };
+            unsigned long long dropped = 0;     // By the workers already stopped, under the lanes mutex
+        };
+
+        // Lane of a stream the sensor opens, created after init and valid until the next init. Sensors resolve the
+        // lanes of their streams once, so that delivering a frame needs neither a lookup nor a lock
+        callback_lane* open_lane(int stream_id);
+
+        // Frames without a lane are delivered on the lane of their stream, looked up only when lanes are on
+        void invoke_callback(frame_holder frame, callback_lane* lane = nullptr) const;
+
+        // Queue receiving the frames passed to the callback as well, sharing them with the callback and the other subscribers
+        std::shared_ptr<frame_subscription> subscribe(int capacity, rs2_queue_policy policy) { return _broadcaster->subscribe(capacity, policy); }
 
         void flush() const;
 
+        // Stop the threads of the callback lanes, discarding the frames waiting in them
+        void stop_lanes() const;
+
         virtual ~frame_source() { flush(); }
 
         double get_time() const { return _ts ? _ts->get_time() : 0; }
 
         void set_sensor(std::shared_ptr<sensor_interface> s);
 
+        void set_frame_allocator(frame_allocator_ptr allocator, size_t alignment);
+
+        // Placement of the frame buffers, for the archives of the next init
+        void set_frame_memory(const frame_memory_policy& policy);
+
+        // Count a frame of the stream that could not be allocated. The counters restart on init
+        void on_frame_dropped(int stream_id);
+        unsigned long long get_dropped_frames(int stream_id) const;
+        // Count frames of the stream missing from the hardware counters, lost before reaching the host
+        void on_frames_lost(int stream_id, unsigned long long count);
+        unsigned long long get_lost_frames(int stream_id) const;
+        uint32_t get_published_frames_count() const;
+        callback_stats get_callback_stats(int stream_id) const;
+        // Counters of the frame buffer pools of all the archives, since the last init
+        frame_buffer_pool_stats get_buffer_pool_stats() const;
+
     private:
         friend class syncer_proccess_unit;
 
-        std::mutex _callback_mutex;
+        enum lane_mode
+        {
+            lanes_off,
+            lanes_latest,
+            lanes_fifo
+        };
+
+        struct lane_delivery;
+
+        // Lane null for frames of streams no sensor opened, which are delivered without callback statistics
+        void deliver(callback_lane* lane, frame_holder frame) const;
+        // Under the lanes mutex, for the lane mode of the last set_callback
+        void start_lane_worker(callback_lane& lane) const;
+
+        mutable std::mutex _callback_mutex;
 
         std::map<rs2_extension, std::shared_ptr<archive_interface>> _archive;
 
         std::atomic<uint32_t> _max_publish_list_size;
         frame_callback_ptr _callback;
+        frame_allocator_ptr _allocator;
+        size_t _alignment;
+        frame_memory_policy _memory_policy;
+        uint32_t _pool_high_water_mark;
         std::shared_ptr<platform::time_service> _ts;
+
+        mutable std::mutex _drops_mutex;
+        std::map<int, unsigned long long> _dropped_frames;   // By stream unique id
+        std::map<int, unsigned long long> _lost_frames;      // By stream unique id
+
+        uint32_t _lane_mode;
+        std::atomic<int> _active_lane_mode;     // Of the last set_callback, read on every frame
+        mutable std::mutex _lanes_mutex;
+        mutable std::map<int, std::shared_ptr<callback_lane>> _lanes;   // By stream unique id
+
+        std::shared_ptr<frame_broadcaster> _broadcaster;
     };
 }
@@ -72,9 +72,12 @@ namespace librealsense
 
     void identity_matcher::dispatch(frame_holder f, syncronization_environment env)
     {
-        std::stringstream s;
-        s <<_name<<"--> "<< f->get_stream()->get_stream_type() << " " << f->get_frame_number() << ", "<<std::fixed<< f->get_frame_timestamp()<<"\n";
-        LOG_DEBUG(s.str());
+        if (is_log_enabled(RS2_LOG_SEVERITY_DEBUG))
+        {
+            std::stringstream s;
+            s <<_name<<"--> "<< f->get_stream()->get_stream_type() << " " << f->get_frame_number() << ", "<<std::fixed<< f->get_frame_timestamp()<<"\n";
+            LOG_DEBUG(s.str());
+        }
 
         sync(std::move(f), env);
     }
@@ -92,45 +95,193 @@ namespace librealsense
         return s.str();
     }
 
+    double system_time_ms()
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    void matcher_slot::enqueue(frame_holder f, double deadline)
+    {
+        if (!accepting)
+        {
+            ++dropped;
+            return;
+        }
+
+        if (count == ring.size())
+        {
+            ring[head] = frame_holder();
+            head = (head + 1) % ring.size();
+            --count;
+            ++dropped;
+        }
+        auto tail = (head + count) % ring.size();
+        ring[tail] = std::move(f);
+        deadlines[tail] = deadline;
+        ++count;
+    }
+
+    frame_holder matcher_slot::dequeue()
+    {
+        accepting = true;
+        if (!count) return frame_holder();
+
+        auto f = std::move(ring[head]);
+        head = (head + 1) % ring.size();
+        --count;
+        return f;
+    }
+
+    void matcher_slot::discard()
+    {
+        dropped += count;
+        while (count) dequeue();
+    }
+
+    void matcher_slot::clear()
+    {
+        discard();
+        accepting = false;
+    }
+
     composite_matcher::composite_matcher(std::vector<std::shared_ptr<matcher>> matchers, std::string name)
     {
+        _max_wait.fill(-1);
+
         for (auto&& matcher : matchers)
         {
-            for (auto&& stream : matcher->get_streams())
+            matcher->set_callback([&](frame_holder f, syncronization_environment env)
             {
-                matcher->set_callback([&](frame_holder f, syncronization_environment env)
-                {
-                    sync(std::move(f), env);
-                });
-                _matchers[stream] = matcher;
-                _streams_id.push_back(stream);
-            }
-            for (auto&& stream : matcher->get_streams_types())
+                sync(std::move(f), env);
+            });
+            add_slot(matcher);
+        }
+
+        _name = create_composite_name(matchers, name);
+    }
+
+    int composite_matcher::add_slot(std::shared_ptr<matcher> m)
+    {
+        auto index = static_cast<int>(_slots.size());
+        _slots.emplace_back();
+        _slots.back().owner = m;
+
+        for (auto stream : m->get_streams())
+        {
+            if (stream < 0) continue;
+            if (stream >= static_cast<int>(_stream_slots.size()))
+                _stream_slots.resize(stream + 1, -1);
+
+            // The queue of the matcher previously resolving the stream is dropped
+            auto previous = _stream_slots[stream];
+            if (previous >= 0)
             {
-                _streams_type.push_back(stream);
+                auto&& old = _slots[previous];
+                old.mapped_streams--;
+                old.discard();
+                old.queued = false;
+                old.accepting = true;
             }
+
+            _stream_slots[stream] = index;
+            _slots[index].mapped_streams++;
+            _streams_id.push_back(stream);
         }
+        for (auto stream : m->get_streams_types())
+        {
+            _streams_type.push_back(stream);
+        }
+        return index;
+    }
 
-        _name = create_composite_name(matchers, name);
+    void composite_matcher::set_max_wait(rs2_stream stream, double max_wait_ms)
+    {
+        if (stream == RS2_STREAM_ANY) _default_max_wait = max_wait_ms;
+        else _max_wait[stream] = max_wait_ms;
+
+        _has_max_wait = _default_max_wait > 0;
+        for (auto wait : _max_wait)
+            if (wait > 0) _has_max_wait = true;
+    }
+
+    rs2_sync_stats composite_matcher::get_stats() const
+    {
+        rs2_sync_stats stats;
+        stats.complete = _complete;
+        stats.partial = _partial;
+        stats.dropped = 0;
+        for (auto&& slot : _slots) stats.dropped += slot.dropped;
+        return stats;
+    }
+
+    void composite_matcher::get_stream_drops(stream_id stream, unsigned long long& dropped, int& queued) const
+    {
+        auto index = slot_of(stream);
+        if (index < 0) return;
+
+        auto&& slot = _slots[index];
+        dropped += slot.dropped;
+        queued += static_cast<int>(slot.count);
+        if (auto inner = dynamic_cast<const composite_matcher*>(slot.owner.get()))
+            inner->get_stream_drops(stream, dropped, queued);
+    }
+
+    double composite_matcher::get_deadline(const frame_holder& f, double now) const
+    {
+        auto deadline = std::numeric_limits<double>::infinity();
+        if (!_has_max_wait) return deadline;
+
+        auto add_stream = [&](rs2_stream stream)
+        {
+            auto wait = _max_wait[stream] >= 0 ? _max_wait[stream] : _default_max_wait;
+            if (wait > 0) deadline = std::min(deadline, now + wait);
+        };
+
+        // A set of frames waits as long as its most urgent stream allows
+        if (auto composite = dynamic_cast<composite_frame*>(f.frame))
+        {
+            for (size_t i = 0; i < composite->get_embedded_frames_count(); i++)
+                add_stream(composite->get_frame(static_cast<int>(i))->get_stream()->get_stream_type());
+        }
+        else
+        {
+            add_stream(f.frame->get_stream()->get_stream_type());
+        }
+        return deadline;
     }
 
     void composite_matcher::dispatch(frame_holder f, syncronization_environment env)
     {
-        std::stringstream s;
-        s <<"DISPATCH "<<_name<<"--> "<< f->get_stream()->get_stream_type() << " " << f->get_frame_number() << ", "<<std::fixed<< f->get_frame_timestamp()<<"\n";
-        LOG_DEBUG(s.str());
+        if (is_log_enabled(RS2_LOG_SEVERITY_DEBUG))
+        {
+            std::stringstream s;
+            s <<"DISPATCH "<<_name<<"--> "<< f->get_stream()->get_stream_type() << " " << f->get_frame_number() << ", "<<std::fixed<< f->get_frame_timestamp()<<"\n";
+            LOG_DEBUG(s.str());
+        }
 
         clean_inactive_streams(f);
-        auto matcher = find_matcher(f);
-        update_last_arrived(f, matcher.get());
+        auto index = find_slot(f);
+        update_last_arrived(f, index);
+        auto matcher = _slots[index].owner;
         matcher->dispatch(std::move(f), env);
     }
 
     std::shared_ptr<matcher> composite_matcher::find_matcher(const frame_holder& frame)
     {
-        std::shared_ptr<matcher> matcher;
-        auto stream_id = frame.frame->get_stream()->get_unique_id();
-        auto stream_type = frame.frame->get_stream()->get_stream_type();
+        return _slots[find_slot(frame)].owner;
+    }
+
+    int composite_matcher::find_slot(const frame_holder& frame)
+    {
+        auto&& profile = frame.frame->get_stream();
+        auto stream_id = profile->get_unique_id();
+
+        // Frames of known and active streams are resolved by their stream alone
+        auto index = slot_of(stream_id);
+        if (index >= 0 && _slots[index].owner->get_active())
+            return index;
+
+        auto stream_type = profile->get_stream_type();
 
         auto sensor = frame.frame->get_sensor().get(); //TODO: Potential deadlock if get_sensor() gets a hold of the last reference of that sensor
 
@@ -151,132 +302,95 @@ namespace librealsense
             if (dev)
             {
                 dev_exist = true;
-                matcher = _matchers[stream_id];
-                if (!matcher)
+                if (index < 0)
                 {
-                    matcher = dev->create_matcher(frame);
-
+                    auto matcher = dev->create_matcher(frame);
 
                     matcher->set_callback([&](frame_holder f, syncronization_environment env)
                     {
                         sync(std::move(f), env);
                     });
 
-                    for (auto stream : matcher->get_streams())
-                    {
-                        if (_matchers[stream])
-                        {
-                            _frames_queue.erase(_matchers[stream].get());
-                        }
-                        _matchers[stream] = matcher;
-                        _streams_id.push_back(stream);
-
-                    }
-                    for (auto stream : matcher->get_streams_types())
-                    {
-                        _streams_type.push_back(stream);
-                    }
+                    index = add_slot(matcher);
 
                     if (std::find(_streams_type.begin(), _streams_type.end(), stream_type) == _streams_type.end())
                     {
                         LOG_ERROR("Stream matcher not found! stream=" << rs2_stream_to_string(stream_type));
                     }
                 }
-
-                else if(!matcher->get_active())
+                else
                 {
-
-                     matcher->set_active(true);
-                     _frames_queue[matcher.get()].start();
+                    auto&& slot = _slots[index];
+                    slot.owner->set_active(true);
+                    slot.queued = true;
+                    slot.accepting = true;
                 }
             }
         }
 
-        if(!dev_exist)
+        if (!dev_exist && index < 0)
         {
-            matcher = _matchers[stream_id];
             // We don't know what device this frame came from, so just store it under device NULL with ID matcher
-            if (!matcher)
+            auto matcher = std::make_shared<identity_matcher>(stream_id, stream_type);
+            matcher->set_callback([&](frame_holder f, syncronization_environment env)
             {
-                if (_matchers[stream_id])
-                {
-                    _frames_queue.erase(_matchers[stream_id].get());
-                }
-                 _matchers[stream_id] = std::make_shared<identity_matcher>(stream_id, stream_type);
-                _streams_id.push_back(stream_id);
-                _streams_type.push_back(stream_type);
-                matcher = _matchers[stream_id];
-
-                matcher->set_callback([&](frame_holder f, syncronization_environment env)
-                {
-                    sync(std::move(f), env);
-                });
-            }
+                sync(std::move(f), env);
+            });
+            index = add_slot(matcher);
         }
-        return matcher;
+        return index;
     }
 
     void composite_matcher::sync(frame_holder f, syncronization_environment env)
     {
-        std::stringstream s;
-        s <<"SYNC "<<_name<<"--> "<< f->get_stream()->get_stream_type() << " " << f->get_frame_number() << ", "<<std::fixed<< f->get_frame_timestamp()<<"\n";
-        LOG_DEBUG(s.str());
-
-        update_next_expected(f);
-        auto matcher = find_matcher(f);
-        _frames_queue[matcher.get()].enqueue(std::move(f));
+        if (is_log_enabled(RS2_LOG_SEVERITY_DEBUG))
+        {
+            std::stringstream s;
+            s <<"SYNC "<<_name<<"--> "<< f->get_stream()->get_stream_type() << " " << f->get_frame_number() << ", "<<std::fixed<< f->get_frame_timestamp()<<"\n";
+            LOG_DEBUG(s.str());
+        }
 
-        std::vector<frame_holder*> frames_arrived;
-        std::vector<librealsense::matcher*> frames_arrived_matchers;
-        std::vector<librealsense::matcher*> synced_frames;
-        std::vector<librealsense::matcher*> missing_streams;
+        auto index = find_slot(f);
+        update_next_expected(f, index);
+        auto now = _has_max_wait ? system_time_ms() : 0;
+        auto deadline = get_deadline(f, now);
+        _slots[index].queued = true;
+        _slots[index].enqueue(std::move(f), deadline);
 
         do
         {
             auto old_frames = false;
 
-            synced_frames.clear();
-            missing_streams.clear();
-            frames_arrived_matchers.clear();
-            frames_arrived.clear();
-
+            _synced.clear();
+            _missing.clear();
+            _arrived.clear();
 
-            for (auto s = _frames_queue.begin(); s != _frames_queue.end(); s++)
+            for (auto i = 0; i < static_cast<int>(_slots.size()); i++)
             {
-                frame_holder* f;
-                if (s->second.peek(&f))
-                {
-                    frames_arrived.push_back(f);
-                    frames_arrived_matchers.push_back(s->first);
-                }
-                else
-                {
-                    missing_streams.push_back(s->first);
-                }
+                if (!_slots[i].queued) continue;
+                if (_slots[i].count) _arrived.push_back(i);
+                else _missing.push_back(i);
             }
 
-            if (frames_arrived.size() == 0)
+            if (_arrived.empty())
                 break;
 
-            frame_holder* curr_sync;
-            if (frames_arrived.size() > 0)
-            {
-                curr_sync = frames_arrived[0];
-                synced_frames.push_back(frames_arrived_matchers[0]);
-            }
+            auto curr_sync = _slots[_arrived[0]].front();
+            _synced.push_back(_arrived[0]);
 
-            for (auto i = 1; i < frames_arrived.size(); i++)
+            for (size_t i = 1; i < _arrived.size(); i++)
             {
-                if (are_equivalent(*curr_sync, *frames_arrived[i]))
+                auto candidate = _slots[_arrived[i]].front();
+                if (are_equivalent(*curr_sync, *candidate))
                 {
-                    synced_frames.push_back(frames_arrived_matchers[i]);
+                    _synced.push_back(_arrived[i]);
                 }
-                else if (is_smaller_than(*frames_arrived[i], *curr_sync))
+                else if (is_smaller_than(*candidate, *curr_sync))
                 {
                     old_frames = true;
-                    synced_frames.clear();
-                    synced_frames.push_back(frames_arrived_matchers[i]);
-                    curr_sync = frames_arrived[i];
+                    _synced.clear();
+                    _synced.push_back(_arrived[i]);
+                    curr_sync = candidate;
                 }
                 else
                 {
@@ -284,68 +398,75 @@ namespace librealsense
                 }
             }
 
+            auto partial = false;
             if (!old_frames)
             {
-                for (auto i : missing_streams)
+                // Once a frame of the set waited past its deadline, the set leaves without the streams still missing
+                auto expired = false;
+                for (auto i : _synced)
+                    if (_slots[i].front_deadline() <= now) expired = true;
+
+                for (auto i : _missing)
                 {
-                    if (!skip_missing_stream(synced_frames, i))
+                    if (!skip_missing_stream(_synced, i))
                     {
-                        synced_frames.clear();
+                        if (expired)
+                        {
+                            partial = true;
+                            continue;
+                        }
+                        _synced.clear();
                         break;
                     }
                 }
             }
 
-            if (synced_frames.size())
+            if (_synced.size())
             {
-                std::vector<frame_holder> match;
-                match.reserve(synced_frames.size());
+                if (partial) _partial++;
+                else _complete++;
 
-                for (auto index : synced_frames)
-                {
-                    frame_holder frame;
-                    _frames_queue[index].dequeue(&frame);
+                frameset_builder match;
+                for (auto index : _synced)
+                    match.add(_slots[index].dequeue());
 
-                    match.push_back(std::move(frame));
-                }
-
-                std::sort(match.begin(), match.end(), [](frame_holder& f1, frame_holder& f2)
+                // Frames leave ordered by their stream unique id, descending
+                std::sort(match.begin(), match.end(), [](frame_holder& a, frame_holder& b)
                 {
-                    return f1->get_stream()->get_unique_id()> f2->get_stream()->get_unique_id();
+                    return a->get_stream()->get_unique_id() > b->get_stream()->get_unique_id();
                 });
 
-
-                std::stringstream s;
-                s<<"MATCHED: ";
-                for(auto&& f: match)
+                if (is_log_enabled(RS2_LOG_SEVERITY_DEBUG))
                 {
-                    auto composite = dynamic_cast<composite_frame*>(f.frame);
-                    if(composite)
+                    std::stringstream s;
+                    s<<"MATCHED: ";
+                    for(auto&& f: match)
                     {
-                        for (int i = 0; i < composite->get_embedded_frames_count(); i++)
+                        auto composite = dynamic_cast<composite_frame*>(f.frame);
+                        if(composite)
                         {
-                            auto matched = composite->get_frame(i);
-                            s << matched->get_stream()->get_stream_type()<<" "<<f->get_frame_number()<<" "<<matched->get_frame_timestamp()<<" ";
+                            for (int i = 0; i < composite->get_embedded_frames_count(); i++)
+                            {
+                                auto matched = composite->get_frame(i);
+                                s << matched->get_stream()->get_stream_type()<<" "<<f->get_frame_number()<<" "<<matched->get_frame_timestamp()<<" ";
+                            }
+                        }
+                        else {
+                             s<<f->get_stream()->get_stream_type()<<" "<<f->get_frame_number()<<" "<<(double)f->get_frame_timestamp()<<" ";
                         }
-                    }
-                    else {
-                         s<<f->get_stream()->get_stream_type()<<" "<<f->get_frame_number()<<" "<<(double)f->get_frame_timestamp()<<" ";
-                    }
-
 
+                    }
+                    s<<"\n";
+                    LOG_DEBUG(s.str());
                 }
-                s<<"\n";
-                LOG_DEBUG(s.str());
-                frame_holder composite = env.source->allocate_composite_frame(std::move(match));
+                frame_holder composite = match.build(*env.source);
                 if (composite.frame)
                 {
-                    s <<"SYNCED "<<_name<<"--> "<< composite->get_stream()->get_stream_type() << " " << composite->get_frame_number() << ", "<<std::fixed<< composite->get_frame_timestamp()<<"\n";
-
                     auto cb = begin_callback();
                     _callback(std::move(composite), env);
                 }
             }
-        } while (synced_frames.size() > 0);
+        } while (_synced.size() > 0);
     }
 
     frame_number_composite_matcher::frame_number_composite_matcher(std::vector<std::shared_ptr<matcher>> matchers)
@@ -353,9 +474,9 @@ namespace librealsense
     {
     }
 
-    void frame_number_composite_matcher::update_last_arrived(frame_holder& f, matcher* m)
+    void frame_number_composite_matcher::update_last_arrived(frame_holder& f, int slot)
     {
-        _last_arrived[m] =f->get_frame_number();
+        _slots[slot].last_arrived_number = f->get_frame_number();
     }
 
     bool frame_number_composite_matcher::are_equivalent(frame_holder& a, frame_holder& b)
@@ -368,32 +489,25 @@ namespace librealsense
     }
     void frame_number_composite_matcher::clean_inactive_streams(frame_holder& f)
     {
-        std::vector<stream_id> inactive_matchers;
-        for(auto m: _matchers)
+        for (auto&& slot : _slots)
         {
-            if(_last_arrived[m.second.get()] && (f->get_frame_number() - _last_arrived[m.second.get()]) > 5)
+            if (slot.mapped_streams && slot.last_arrived_number && (f->get_frame_number() - slot.last_arrived_number) > 5)
             {
-                inactive_matchers.push_back(m.first);
-                m.second->set_active(false);
+                slot.owner->set_active(false);
+                slot.queued = true;
+                slot.clear();
             }
         }
-
-        for(auto id: inactive_matchers)
-        {
-            _frames_queue[_matchers[id].get()].clear();
-        }
     }
 
-    bool frame_number_composite_matcher::skip_missing_stream(std::vector<matcher*> synced, matcher* missing)
+    bool frame_number_composite_matcher::skip_missing_stream(const std::vector<int>& synced, int missing)
     {
-        frame_holder* synced_frame;
-
-         if(!missing->get_active())
-             return true;
+        if (!_slots[missing].owner->get_active())
+            return true;
 
-        _frames_queue[synced[0]].peek(&synced_frame);
+        auto synced_frame = _slots[synced[0]].front();
 
-        auto next_expected = _next_expected[missing];
+        auto next_expected = _slots[missing].next_expected;
 
         if((*synced_frame)->get_frame_number() - next_expected > 4)
         {
@@ -402,10 +516,9 @@ namespace librealsense
         return false;
     }
 
-    void frame_number_composite_matcher::update_next_expected(const frame_holder& f)
+    void frame_number_composite_matcher::update_next_expected(const frame_holder& f, int slot)
     {
-        auto matcher = find_matcher(f);
-        _next_expected[matcher.get()] = f.frame->get_frame_number()+1.;
+        _slots[slot].next_expected = f.frame->get_frame_number()+1.;
     }
 
     std::pair<double, double> extract_timestamps(frame_holder & a, frame_holder & b)
@@ -447,57 +560,50 @@ namespace librealsense
         return ts.first < ts.second;
     }
 
-    void timestamp_composite_matcher::update_last_arrived(frame_holder& f, matcher* m)
+    void timestamp_composite_matcher::update_last_arrived(frame_holder& f, int slot)
     {
-        _last_arrived[m] = std::chrono::duration<double, std::milli>(std::chrono::system_clock::now().time_since_epoch()).count();
+        _slots[slot].last_arrived = std::chrono::duration<double, std::milli>(std::chrono::system_clock::now().time_since_epoch()).count();
     }
 
-    void timestamp_composite_matcher::update_next_expected(const frame_holder & f)
+    void timestamp_composite_matcher::update_next_expected(const frame_holder & f, int slot)
     {
         auto fps = f.frame->get_stream()->get_framerate();
         auto gap = 1000 / fps;
 
-        auto matcher = find_matcher(f);
-
-        _next_expected[matcher.get()] = f.frame->get_frame_timestamp() + gap;
-        _next_expected_domain[matcher.get()] = f.frame->get_frame_timestamp_domain();
+        auto&& s = _slots[slot];
+        s.next_expected = f.frame->get_frame_timestamp() + gap;
+        s.next_expected_domain = f.frame->get_frame_timestamp_domain();
+        s.has_next_expected_domain = true;
     }
 
     void timestamp_composite_matcher::clean_inactive_streams(frame_holder& f)
     {
-        std::vector<stream_id> dead_matchers;
         auto now = std::chrono::duration<double, std::milli>(std::chrono::system_clock::now().time_since_epoch()).count();
-        for(auto m: _matchers)
+        for (auto&& slot : _slots)
         {
-            if(_last_arrived[m.second.get()] && (now - _last_arrived[m.second.get()]) > 500)
+            if (slot.mapped_streams && slot.last_arrived && (now - slot.last_arrived) > 500)
             {
-                dead_matchers.push_back(m.first);
-                m.second->set_active(false);
+                slot.owner->set_active(false);
+                // The stream no longer takes part in matching until it is back
+                slot.discard();
+                slot.queued = false;
             }
         }
-
-        for(auto id: dead_matchers)
-        {
-            _frames_queue[_matchers[id].get()].clear();
-            _frames_queue.erase(_matchers[id].get());
-        }
     }
 
-    bool timestamp_composite_matcher::skip_missing_stream(std::vector<matcher*> synced, matcher* missing)
+    bool timestamp_composite_matcher::skip_missing_stream(const std::vector<int>& synced, int missing)
     {
-        if(!missing->get_active())
+        auto&& m = _slots[missing];
+        if (!m.owner->get_active())
             return true;
 
-        frame_holder* synced_frame;
-
-        _frames_queue[synced[0]].peek(&synced_frame);
+        auto synced_frame = _slots[synced[0]].front();
 
-        auto next_expected = _next_expected[missing];
+        auto next_expected = m.next_expected;
 
-        auto it = _next_expected_domain.find(missing);
-        if (it != _next_expected_domain.end())
+        if (m.has_next_expected_domain)
         {
-            if (it->second != (*synced_frame)->get_frame_timestamp_domain())
+            if (m.next_expected_domain != (*synced_frame)->get_frame_timestamp_domain())
             {
                 return false;
             }
@@ -7,6 +7,7 @@
 #include "archive.h"
 
 #include <stdint.h>
+#include <array>
 #include <vector>
 #include <mutex>
 #include <memory>
@@ -74,7 +75,7 @@ namespace librealsense
     {
         synthetic_source_interface* source;
         //sync_lock& lock_ref;
-        single_consumer_queue<frame_holder>& matches;
+        lock_free_queue<frame_holder>& matches;
     };
 
     typedef int stream_id;
@@ -128,6 +129,37 @@ namespace librealsense
         rs2_stream _streams_type;
     };
 
+    // Matching state of one of the matchers of a composite_matcher
+    struct matcher_slot
+    {
+        std::shared_ptr<matcher> owner;
+        int mapped_streams = 0;     // Streams currently resolved to the slot, none once its matcher was replaced
+        bool queued = false;        // The slot takes part in matching
+        bool accepting = true;      // A cleared queue drops frames until it is dequeued from or restarted
+
+        // Fixed-capacity ring of the frames waiting for a match, dropping the oldest one when full
+        std::array<frame_holder, QUEUE_MAX_SIZE> ring;
+        std::array<double, QUEUE_MAX_SIZE> deadlines;   // System time each frame may be released without its match
+        size_t head = 0;
+        size_t count = 0;
+        unsigned long long dropped = 0;                 // Frames discarded before leaving in a set
+
+        double next_expected = 0;
+        rs2_timestamp_domain next_expected_domain = RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK;
+        bool has_next_expected_domain = false;
+        double last_arrived = 0;                 // System time of the last arrival, in milliseconds
+        unsigned long long last_arrived_number = 0;
+
+        frame_holder* front() { return count ? &ring[head] : nullptr; }
+        double front_deadline() const { return deadlines[head]; }
+        void enqueue(frame_holder f, double deadline);
+        frame_holder dequeue();
+        void discard();
+        void clear();
+    };
+
+    // Matchers get dense slot indices as their streams appear, and streams are resolved to their slot through
+    // an array indexed by the stream unique id. All the matching state lives in the flat array of slots
     class composite_matcher : public matcher
     {
     public:
@@ -136,36 +168,60 @@ namespace librealsense
 
         virtual bool are_equivalent(frame_holder& a, frame_holder& b) = 0;
         virtual bool is_smaller_than(frame_holder& a, frame_holder& b) = 0;
-        virtual bool skip_missing_stream(std::vector<matcher*> synced, matcher* missing)  = 0;
+        virtual bool skip_missing_stream(const std::vector<int>& synced, int missing)  = 0;
         virtual void clean_inactive_streams(frame_holder& f) = 0;
-        virtual void update_last_arrived(frame_holder& f, matcher* m) = 0;
+        virtual void update_last_arrived(frame_holder& f, int slot) = 0;
 
         void dispatch(frame_holder f, syncronization_environment env) override;
         void sync(frame_holder f, syncronization_environment env) override;
         std::shared_ptr<matcher> find_matcher(const frame_holder& f);
 
+        // Longest time in milliseconds a frame of the stream waits for its match before it is released in a
+        // partial set. RS2_STREAM_ANY sets the default of the streams without their own, zero waits without a bound
+        void set_max_wait(rs2_stream stream, double max_wait_ms);
+        rs2_sync_stats get_stats() const;
+
+        // Add the frames dropped by the slot of the stream and the frames it holds, including those of nested matchers
+        void get_stream_drops(stream_id stream, unsigned long long& dropped, int& queued) const;
+
     protected:
-        virtual void update_next_expected(const frame_holder& f) = 0;
+        virtual void update_next_expected(const frame_holder& f, int slot) = 0;
 
-        std::map<matcher*, single_consumer_queue<frame_holder>> _frames_queue;
-        std::map<stream_id, std::shared_ptr<matcher>> _matchers;
-        std::map<matcher*, double> _next_expected;
-        std::map<matcher*, rs2_timestamp_domain> _next_expected_domain;
+        int find_slot(const frame_holder& f);
+        int add_slot(std::shared_ptr<matcher> m);
+        int slot_of(stream_id stream) const
+        {
+            return stream >= 0 && stream < static_cast<int>(_stream_slots.size()) ? _stream_slots[stream] : -1;
+        }
+
+        std::vector<matcher_slot> _slots;
+        std::vector<int> _stream_slots;     // Slot of every stream unique id, -1 for unknown streams
+
+    private:
+        double get_deadline(const frame_holder& f, double now) const;
+
+        // Scratch of sync, reused between frames
+        std::vector<int> _arrived;
+        std::vector<int> _synced;
+        std::vector<int> _missing;
+
+        std::array<double, RS2_STREAM_COUNT> _max_wait;     // Negative for streams using the default
+        double _default_max_wait = 0;
+        bool _has_max_wait = false;
+        unsigned long long _complete = 0;
+        unsigned long long _partial = 0;
     };
 
     class frame_number_composite_matcher : public composite_matcher
     {
     public:
         frame_number_composite_matcher(std::vector<std::shared_ptr<matcher>> matchers);
-        virtual void update_last_arrived(frame_holder& f, matcher* m) override;
+        virtual void update_last_arrived(frame_holder& f, int slot) override;
         bool are_equivalent(frame_holder& a, frame_holder& b) override;
         bool is_smaller_than(frame_holder& a, frame_holder& b) override;
-        bool skip_missing_stream(std::vector<matcher*> synced, matcher* missing) override;
+        bool skip_missing_stream(const std::vector<int>& synced, int missing) override;
         void clean_inactive_streams(frame_holder& f) override;
-        void update_next_expected(const frame_holder& f) override;
-
-    private:
-         std::map<matcher*,unsigned long long> _last_arrived;
+        void update_next_expected(const frame_holder& f, int slot) override;
     };
 
     class timestamp_composite_matcher : public composite_matcher
@@ -174,14 +230,12 @@ namespace librealsense
         timestamp_composite_matcher(std::vector<std::shared_ptr<matcher>> matchers);
         bool are_equivalent(frame_holder& a, frame_holder& b) override;
         bool is_smaller_than(frame_holder& a, frame_holder& b) override;
-        virtual void update_last_arrived(frame_holder& f, matcher* m) override;
+        virtual void update_last_arrived(frame_holder& f, int slot) override;
         void clean_inactive_streams(frame_holder& f) override;
-        bool skip_missing_stream(std::vector<matcher*> synced, matcher* missing) override;
-        void update_next_expected(const frame_holder & f) override;
+        bool skip_missing_stream(const std::vector<int>& synced, int missing) override;
+        void update_next_expected(const frame_holder & f, int slot) override;
 
     private:
         bool are_equivalent(double a, double b, int fps);
-        std::map<matcher*, double> _last_arrived;
-
     };
 }
@@ -0,0 +1,224 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#include <map>
+#include <mutex>
+#include "types.h"
+#include "threading.h"
+#include "tracing.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+#endif
+
+namespace librealsense
+{
+    static const size_t MAX_THREAD_NAME = 15;
+
+#ifdef _WIN32
+    typedef HANDLE native_thread;
+
+    typedef HRESULT (WINAPI *set_thread_description_ptr)(HANDLE, PCWSTR);
+
+    static void set_current_thread_name(const std::string& name)
+    {
+        // Windows 10 1607 and later only, so looked up rather than linked
+        static auto set_description = reinterpret_cast<set_thread_description_ptr>(
+            GetProcAddress(GetModuleHandleW(L"kernel32.dll"), "SetThreadDescription"));
+        if (set_description)
+        {
+            std::wstring wide(name.begin(), name.end());
+            set_description(GetCurrentThread(), wide.c_str());
+        }
+    }
+
+    static uint64_t get_current_thread_id() { return GetCurrentThreadId(); }
+
+    static native_thread open_current_thread()
+    {
+        return OpenThread(THREAD_SET_INFORMATION | THREAD_QUERY_INFORMATION, FALSE, GetCurrentThreadId());
+    }
+
+    static void close_thread(native_thread thread) { if (thread) CloseHandle(thread); }
+
+    static void apply_policy(native_thread thread, uint64_t, const thread_policy& policy)
+    {
+        if (!thread) return;
+        if (policy.affinity_mask && !SetThreadAffinityMask(thread, static_cast<DWORD_PTR>(policy.affinity_mask)))
+            LOG_WARNING("Failed to set thread affinity, error " << GetLastError());
+
+        int priority = THREAD_PRIORITY_NORMAL;
+        if (policy.priority >= 50) priority = THREAD_PRIORITY_TIME_CRITICAL;
+        else if (policy.priority >= 10) priority = THREAD_PRIORITY_HIGHEST;
+        else if (policy.priority > 0) priority = THREAD_PRIORITY_ABOVE_NORMAL;
+        else if (policy.priority <= -10) priority = THREAD_PRIORITY_LOWEST;
+        else if (policy.priority < 0) priority = THREAD_PRIORITY_BELOW_NORMAL;
+        if (!SetThreadPriority(thread, priority))
+            LOG_WARNING("Failed to set thread priority, error " << GetLastError());
+    }
+#else
+    typedef pthread_t native_thread;
+
+    static void set_current_thread_name(const std::string& name)
+    {
+#if defined(__APPLE__)
+        pthread_setname_np(name.c_str());
+#elif defined(__linux__)
+        pthread_setname_np(pthread_self(), name.c_str());
+#endif
+    }
+
+    static uint64_t get_current_thread_id()
+    {
+#if defined(__APPLE__)
+        uint64_t id = 0;
+        pthread_threadid_np(nullptr, &id);
+        return id;
+#elif defined(__linux__)
+        return static_cast<uint64_t>(syscall(SYS_gettid));
+#else
+        return 0;
+#endif
+    }
+
+    static native_thread open_current_thread() { return pthread_self(); }
+    static void close_thread(native_thread) {}
+
+    static void apply_policy(native_thread thread, uint64_t os_id, const thread_policy& policy)
+    {
+#ifdef __linux__
+        if (policy.affinity_mask)
+        {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            for (int cpu = 0; cpu < 64 && cpu < CPU_SETSIZE; cpu++)
+                if (policy.affinity_mask & (uint64_t(1) << cpu)) CPU_SET(cpu, &set);
+            if (auto err = pthread_setaffinity_np(thread, sizeof(set), &set))
+                LOG_WARNING("Failed to set thread affinity, error " << err);
+        }
+#endif
+
+        // Real-time scheduling usually needs privileges, without them the thread keeps running as it did
+        sched_param param{};
+        auto policy_type = SCHED_OTHER;
+        if (policy.priority > 0)
+        {
+            policy_type = SCHED_FIFO;
+            param.sched_priority = std::min(std::max(policy.priority, sched_get_priority_min(SCHED_FIFO)),
+                                            sched_get_priority_max(SCHED_FIFO));
+        }
+        if (auto err = pthread_setschedparam(thread, policy_type, &param))
+            LOG_WARNING("Failed to set thread scheduling, error " << err);
+
+#ifdef __linux__
+        // Below zero the priority lowers the thread through its nice value, which Linux keeps per thread
+        if (policy.priority <= 0 && setpriority(PRIO_PROCESS, static_cast<id_t>(os_id), std::min(-policy.priority, 19)))
+            LOG_WARNING("Failed to set thread nice value, error " << errno);
+#else
+        (void)os_id;
+#endif
+    }
+#endif
+
+    class thread_registry
+    {
+    public:
+        static thread_registry& get()
+        {
+            // Never destroyed, as threads of other singletons may end after static destruction
+            static auto instance = new thread_registry();
+            return *instance;
+        }
+
+        uint64_t add(const std::string& name, rs2_thread_class thread_class)
+        {
+            entry e;
+            e.info = { name, thread_class, get_current_thread_id() };
+            e.thread = open_current_thread();
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_configured[thread_class])
+                apply_policy(e.thread, e.info.os_id, _policies[thread_class]);
+            auto id = ++_last_id;
+            _threads[id] = e;
+            return id;
+        }
+
+        void remove(uint64_t id)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto it = _threads.find(id);
+            if (it == _threads.end()) return;
+            close_thread(it->second.thread);
+            _threads.erase(it);
+        }
+
+        void set_policy(rs2_thread_class thread_class, const thread_policy& policy)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _policies[thread_class] = policy;
+            _configured[thread_class] = true;
+            for (auto&& kvp : _threads)
+                if (kvp.second.info.thread_class == thread_class)
+                    apply_policy(kvp.second.thread, kvp.second.info.os_id, policy);
+        }
+
+        std::vector<thread_info> query()
+        {
+            std::vector<thread_info> result;
+            std::lock_guard<std::mutex> lock(_mutex);
+            for (auto&& kvp : _threads)
+                result.push_back(kvp.second.info);
+            return result;
+        }
+
+    private:
+        struct entry
+        {
+            thread_info info;
+            native_thread thread;
+        };
+
+        thread_registry() : _last_id(0), _configured() {}
+
+        std::mutex _mutex;
+        std::map<uint64_t, entry> _threads;
+        uint64_t _last_id;
+        thread_policy _policies[RS2_THREAD_CLASS_COUNT];
+        bool _configured[RS2_THREAD_CLASS_COUNT];
+    };
+
+    thread_registration::thread_registration(const char* name, rs2_thread_class thread_class)
+    {
+        std::string short_name(name);
+        if (short_name.size() > MAX_THREAD_NAME) short_name.resize(MAX_THREAD_NAME);
+        set_current_thread_name(short_name);
+        set_trace_thread_name(short_name);
+        _id = thread_registry::get().add(short_name, thread_class);
+    }
+
+    thread_registration::~thread_registration()
+    {
+        thread_registry::get().remove(_id);
+    }
+
+    void set_thread_policy(rs2_thread_class thread_class, const thread_policy& policy)
+    {
+        if (!is_valid(thread_class))
+            throw invalid_value_exception(to_string() << "Invalid thread class " << int(thread_class));
+        thread_registry::get().set_policy(thread_class, policy);
+    }
+
+    std::vector<thread_info> query_threads()
+    {
+        return thread_registry::get().query();
+    }
+}
@@ -0,0 +1,47 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include "../include/librealsense2/h/rs_types.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace librealsense
+{
+    // Placement of the threads of a class. A zero mask leaves the threads on any core, a zero priority
+    // leaves their scheduling as inherited, positive priorities ask for real-time scheduling
+    struct thread_policy
+    {
+        uint64_t affinity_mask = 0;
+        int priority = 0;
+    };
+
+    struct thread_info
+    {
+        std::string name;
+        rs2_thread_class thread_class;
+        uint64_t os_id;
+    };
+
+    // Names the calling thread, applies the policy of its class and lists it while the object lives
+    // Threads of the library create one first thing in their body. Names are cut to 15 characters
+    class thread_registration
+    {
+    public:
+        thread_registration(const char* name, rs2_thread_class thread_class);
+        ~thread_registration();
+
+        thread_registration(const thread_registration&) = delete;
+        thread_registration& operator=(const thread_registration&) = delete;
+
+    private:
+        uint64_t _id;
+    };
+
+    // Applies to the running threads of the class and to the ones started later
+    void set_thread_policy(rs2_thread_class thread_class, const thread_policy& policy);
+    std::vector<thread_info> query_threads();
+}
@@ -0,0 +1,186 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#include "tracing.h"
+#include "types.h"
+
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+
+namespace librealsense
+{
+    std::atomic<bool> tracing_enabled{ false };
+
+    uint64_t get_trace_time()
+    {
+        using namespace std::chrono;
+        // Zero marks scopes that started while not tracing
+        return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count() + 1;
+    }
+
+    const char* intern_trace_name(const std::string& name)
+    {
+        static std::mutex mutex;
+        // Never destroyed, as threads of other singletons may trace after static destruction
+        static auto names = new std::set<std::string>();
+        std::lock_guard<std::mutex> lock(mutex);
+        return names->insert(name).first->c_str();
+    }
+
+#ifdef RS2_TRACING
+    // Events a thread keeps, the oldest being overwritten. A few of the oldest are not written out,
+    // as the thread may be overwriting them while the trace is written
+    static const size_t EVENTS_PER_THREAD = 1 << 16;
+    static const size_t OVERWRITE_MARGIN = 64;
+
+    struct trace_event
+    {
+        const char* name;
+        uint64_t id;
+        uint64_t start_us;
+        uint64_t duration_us;
+    };
+
+    // Written by its thread only, events up to the count are complete
+    struct trace_buffer
+    {
+        trace_buffer(uint64_t thread_id, const std::string& thread_name)
+            : id(thread_id), name(thread_name), events(EVENTS_PER_THREAD), written(0) {}
+
+        uint64_t id;
+        std::string name;
+        std::vector<trace_event> events;
+        std::atomic<uint64_t> written;
+    };
+
+    class trace_registry
+    {
+    public:
+        static trace_registry& get()
+        {
+            // Never destroyed, as threads of other singletons may trace after static destruction
+            static auto instance = new trace_registry();
+            return *instance;
+        }
+
+        std::shared_ptr<trace_buffer> add(const std::string& thread_name)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto buffer = std::make_shared<trace_buffer>(++_last_id, thread_name);
+            _buffers.push_back(buffer);
+            return buffer;
+        }
+
+        void start()
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            // Buffers held by the registry alone belong to threads that ended
+            std::vector<std::shared_ptr<trace_buffer>> alive;
+            for (auto&& b : _buffers)
+                if (b.use_count() > 1) alive.push_back(b);
+            _buffers.swap(alive);
+            _start_us = get_trace_time();
+            tracing_enabled = true;
+        }
+
+        void stop(const std::string& filename)
+        {
+            tracing_enabled = false;
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            std::ofstream out(filename);
+            out << "{\"traceEvents\":[";
+            bool first = true;
+            for (auto&& b : _buffers)
+            {
+                out << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << b->id
+                    << ",\"args\":{\"name\":\"" << escape(b->name) << "\"}}";
+                first = false;
+
+                auto written = b->written.load(std::memory_order_acquire);
+                auto begin = written > EVENTS_PER_THREAD - OVERWRITE_MARGIN ? written - (EVENTS_PER_THREAD - OVERWRITE_MARGIN) : 0;
+                for (auto i = begin; i < written; i++)
+                {
+                    auto&& e = b->events[i % EVENTS_PER_THREAD];
+                    if (e.start_us < _start_us) continue;
+                    out << ",\n{\"name\":\"" << escape(e.name) << "\",\"ph\":\"" << (e.duration_us ? "X" : "i")
+                        << "\",\"pid\":1,\"tid\":" << b->id << ",\"ts\":" << e.start_us - _start_us;
+                    if (e.duration_us) out << ",\"dur\":" << e.duration_us;
+                    else out << ",\"s\":\"t\"";
+                    out << ",\"args\":{\"frame\":" << e.id << "}}";
+                }
+            }
+            out << "\n]}\n";
+            if (!out)
+                throw io_exception(to_string() << "Failed to write " << filename);
+        }
+
+    private:
+        trace_registry() : _last_id(0), _start_us(0) {}
+
+        static std::string escape(const std::string& s)
+        {
+            std::string result;
+            for (auto c : s)
+            {
+                if (c == '"' || c == '\\') result += '\\';
+                if (static_cast<unsigned char>(c) < 0x20) continue;
+                result += c;
+            }
+            return result;
+        }
+
+        std::mutex _mutex;
+        std::vector<std::shared_ptr<trace_buffer>> _buffers;
+        uint64_t _last_id;
+        uint64_t _start_us;
+    };
+
+    static thread_local std::string trace_thread_name;
+    static thread_local std::shared_ptr<trace_buffer> trace_thread_buffer;
+
+    void set_trace_thread_name(const std::string& name)
+    {
+        trace_thread_name = name;
+    }
+
+    void add_trace_event(const char* name, uint64_t id, uint64_t start_us, uint64_t duration_us)
+    {
+        if (!trace_thread_buffer)
+            trace_thread_buffer = trace_registry::get().add(trace_thread_name.empty() ? "application" : trace_thread_name);
+
+        auto&& b = *trace_thread_buffer;
+        auto n = b.written.load(std::memory_order_relaxed);
+        b.events[n % EVENTS_PER_THREAD] = { name, id, start_us, duration_us };
+        b.written.store(n + 1, std::memory_order_release);
+    }
+
+    void start_trace()
+    {
+        trace_registry::get().start();
+    }
+
+    void stop_trace(const std::string& filename)
+    {
+        trace_registry::get().stop(filename);
+    }
+#else
+    void set_trace_thread_name(const std::string&) {}
+
+    void add_trace_event(const char*, uint64_t, uint64_t, uint64_t) {}
+
+    void start_trace()
+    {
+        throw not_implemented_exception("Tracing is only available in builds with BUILD_WITH_TRACING");
+    }
+
+    void stop_trace(const std::string&)
+    {
+        throw not_implemented_exception("Tracing is only available in builds with BUILD_WITH_TRACING");
+    }
+#endif
+}
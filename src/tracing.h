@@ -0,0 +1,59 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace librealsense
+{
+    // Frame lifecycle traces, recorded in builds with BUILD_WITH_TRACING only. Elsewhere the trace macros compile
+    // to nothing and starting a trace fails. Every thread records its events in a buffer of its own, without locking
+    void start_trace();
+    // Writes the events recorded since the trace started in the Chrome trace event format, which Perfetto also reads
+    void stop_trace(const std::string& filename);
+
+    extern std::atomic<bool> tracing_enabled;
+    inline bool is_tracing() { return tracing_enabled.load(std::memory_order_relaxed); }
+
+    // Events keep their names as pointers, so names are literals or kept by this until the process ends
+    const char* intern_trace_name(const std::string& name);
+
+    // Names the calling thread in the traces, as the thread registration does
+    void set_trace_thread_name(const std::string& name);
+
+    uint64_t get_trace_time();
+    // The id is shown with the event, usually the number of the frame it is about. Events of no duration are instants
+    void add_trace_event(const char* name, uint64_t id, uint64_t start_us, uint64_t duration_us);
+
+    class trace_scope
+    {
+    public:
+        trace_scope(const char* name, uint64_t id)
+            : _name(name), _id(id), _start(is_tracing() ? get_trace_time() : 0) {}
+        ~trace_scope()
+        {
+            if (_start) add_trace_event(_name, _id, _start, get_trace_time() - _start);
+        }
+
+        trace_scope(const trace_scope&) = delete;
+        trace_scope& operator=(const trace_scope&) = delete;
+
+    private:
+        const char* _name;
+        uint64_t _id;
+        uint64_t _start;
+    };
+}
+
+#ifdef RS2_TRACING
+#define RS2_TRACE_CONCAT_(a, b) a##b
+#define RS2_TRACE_CONCAT(a, b) RS2_TRACE_CONCAT_(a, b)
+#define RS2_TRACE_SCOPE(name, id) librealsense::trace_scope RS2_TRACE_CONCAT(trace_scope_, __LINE__)((name), static_cast<uint64_t>(id))
+#define RS2_TRACE_INSTANT(name, id) do { if (librealsense::is_tracing()) librealsense::add_trace_event((name), static_cast<uint64_t>(id), librealsense::get_trace_time(), 0); } while (0)
+#else
+#define RS2_TRACE_SCOPE(name, id)
+#define RS2_TRACE_INSTANT(name, id) do {} while (0)
+#endif
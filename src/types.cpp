@@ -119,6 +119,7 @@ namespace librealsense
         STRCASE(STREAM, GYRO)
         STRCASE(STREAM, ACCEL)
         STRCASE(STREAM, GPIO)
+        STRCASE(STREAM, POSE)
         default: assert(!is_valid(value)); return UNKNOWN_VALUE;
         }
         #undef CASE
@@ -167,6 +168,8 @@ namespace librealsense
             CASE(RECORD)
             CASE(VIDEO_PROFILE)
             CASE(PLAYBACK)
+            CASE(SOFTWARE_DEVICE)
+            CASE(SOFTWARE_SENSOR)
         default: assert(!is_valid(value)); return UNKNOWN_VALUE;
         }
         #undef CASE
@@ -186,6 +189,19 @@ namespace librealsense
 #undef CASE
     }
 
+    const char* get_string(rs2_record_compression value)
+    {
+#define CASE(X) STRCASE(RECORD_COMPRESSION, X)
+        switch (value)
+        {
+            CASE(NONE)
+            CASE(LZ4)
+            CASE(LZ4_DEPTH)
+            default: assert(!is_valid(value)); return UNKNOWN_VALUE;
+        }
+#undef CASE
+    }
+
     const char* get_string(rs2_log_severity value)
     {
 #define CASE(X) STRCASE(LOG_SEVERITY, X)
@@ -247,6 +263,47 @@ namespace librealsense
         CASE(FILTER_MAGNITUDE)
         CASE(FILTER_SMOOTH_ALPHA)
         CASE(FILTER_SMOOTH_DELTA)
+        CASE(ZERO_COPY_BUFFERS)
+        CASE(UNPACK_THREADS)
+        CASE(COMPACT_POINTS)
+        CASE(VERTEX_FORMAT)
+        CASE(COMPACT_HISTORY)
+        CASE(HISTOGRAM_SUBSAMPLING)
+        CASE(FRAMES_IN_FLIGHT)
+        CASE(SYNC_TOLERANCE)
+        CASE(SYNC_MAX_LATENCY)
+        CASE(MOTION_BATCH_SIZE)
+        CASE(WARM_RESTART)
+        CASE(GLOBAL_TIME_ENABLED)
+        CASE(CLOCK_DRIFT)
+        CASE(CLOCK_JITTER)
+        CASE(AUTO_EXPOSURE_SAMPLE_STEP)
+        CASE(COMPRESSION_TOLERANCE)
+        CASE(REALTIME_MODE)
+        CASE(HOLES_FILL)
+        CASE(CROP_LEFT)
+        CASE(CROP_TOP)
+        CASE(CROP_RIGHT)
+        CASE(CROP_BOTTOM)
+        CASE(FUSION_GAIN)
+        CASE(SAMPLING_STEP)
+        CASE(CALLBACK_LANES)
+        CASE(METADATA_ONLY_STREAMS)
+        CASE(FRAME_RATE_DECIMATION)
+        CASE(FRAME_MEMORY_HUGE_PAGES)
+        CASE(FRAME_MEMORY_NUMA_NODE)
+        CASE(INTRA_SENSOR_FRAMESETS)
+        CASE(CHANGE_TILE_SIZE)
+        CASE(CHANGE_THRESHOLD)
+        CASE(POWER_IDLE_TIMEOUT)
+        CASE(RETAIN_ORIGINAL_FRAME)
+        CASE(HISTOGRAM_BINS)
+        CASE(NEAR_DISTANCE)
+        CASE(VOXEL_SIZE)
+        CASE(NORMAL_WINDOW_SIZE)
+        CASE(MAX_KERNEL_BUFFERS)
+        CASE(PYRAMID_REDUCTION)
+        CASE(FRAME_POOL_HIGH_WATER_MARK)
         default: assert(!is_valid(value)); return UNKNOWN_VALUE;
         }
         #undef CASE
@@ -275,6 +332,14 @@ namespace librealsense
         CASE(MOTION_RAW)
         CASE(MOTION_XYZ32F)
         CASE(GPIO_RAW)
+        CASE(XYZ16F)
+        CASE(XYZ16)
+        CASE(MOTION_XYZ32F_BATCH)
+        CASE(Z16_COMPRESSED)
+        CASE(ORIENTATION)
+        CASE(Y8I)
+        CASE(DISTANCE)
+        CASE(NV12)
         default: assert(!is_valid(value)); return UNKNOWN_VALUE;
         }
         #undef CASE
@@ -331,6 +396,103 @@ namespace librealsense
         #undef CASE
     }
 
+    const char* get_string(rs2_frame_latency_stage value)
+    {
+#define CASE(X) STRCASE(FRAME_LATENCY_STAGE, X)
+        switch (value)
+        {
+        CASE(BACKEND_ARRIVAL)
+        CASE(UNPACK_DONE)
+        CASE(SYNC_DONE)
+        CASE(PROCESSING_ENTER)
+        CASE(PROCESSING_EXIT)
+        CASE(QUEUE_ENQUEUE)
+        CASE(QUEUE_DEQUEUE)
+        CASE(CALLBACK_START)
+        default: assert(!is_valid(value)); return UNKNOWN_VALUE;
+        }
+        #undef CASE
+    }
+
+    const char* get_string(rs2_thread_class value)
+    {
+#define CASE(X) STRCASE(THREAD_CLASS, X)
+        switch (value)
+        {
+        CASE(CAPTURE)
+        CASE(PROCESSING)
+        CASE(IO)
+        default: assert(!is_valid(value)); return UNKNOWN_VALUE;
+        }
+        #undef CASE
+    }
+
+    const char* get_string(rs2_metric_type value)
+    {
+#define CASE(X) STRCASE(METRIC_TYPE, X)
+        switch (value)
+        {
+        CASE(COUNTER)
+        CASE(GAUGE)
+        CASE(HISTOGRAM)
+        default: assert(!is_valid(value)); return UNKNOWN_VALUE;
+        }
+        #undef CASE
+    }
+
+    const char* get_string(rs2_time_source value)
+    {
+#define CASE(X) STRCASE(TIME_SOURCE, X)
+        switch (value)
+        {
+        CASE(SYSTEM_CLOCK)
+        CASE(MONOTONIC)
+        default: assert(!is_valid(value)); return UNKNOWN_VALUE;
+        }
+        #undef CASE
+    }
+
+    const char* get_string(rs2_queue_policy value)
+    {
+#define CASE(X) STRCASE(QUEUE_POLICY, X)
+        switch (value)
+        {
+        CASE(DROP_OLDEST)
+        CASE(DROP_NEWEST)
+        CASE(BLOCK)
+        default: assert(!is_valid(value)); return UNKNOWN_VALUE;
+        }
+        #undef CASE
+    }
+
+    const char* get_string(rs2_frame_drop_stage value)
+    {
+#define CASE(X) STRCASE(FRAME_DROP_STAGE, X)
+        switch (value)
+        {
+        CASE(ALLOCATION)
+        CASE(SYNC)
+        CASE(PIPELINE_QUEUE)
+        CASE(CALLBACK_LANE)
+        CASE(DEVICE)
+        default: assert(!is_valid(value)); return UNKNOWN_VALUE;
+        }
+        #undef CASE
+    }
+
+    const char* get_string(rs2_latency_measure value)
+    {
+#define CASE(X) STRCASE(LATENCY_MEASURE, X)
+        switch (value)
+        {
+        CASE(CAPTURE_TO_CALLBACK)
+        CASE(EXPOSURE_TO_CALLBACK)
+        CASE(STIMULUS_TO_CALLBACK)
+        default: assert(!is_valid(value)); return UNKNOWN_VALUE;
+        }
+        #undef CASE
+    }
+
     const char* get_string(rs2_timestamp_domain value)
     {
 #define CASE(X) STRCASE(TIMESTAMP_DOMAIN, X)
@@ -338,6 +500,7 @@ namespace librealsense
         {
         CASE(HARDWARE_CLOCK)
         CASE(SYSTEM_TIME)
+        CASE(GLOBAL_TIME)
         default: assert(!is_valid(value)); return UNKNOWN_VALUE;
         }
         #undef CASE
@@ -352,6 +515,7 @@ namespace librealsense
         CASE(FRAME_CORRUPTED)
         CASE(HARDWARE_ERROR)
         CASE(UNKNOWN_ERROR)
+        CASE(FRAMES_LOST)
         default: assert(!is_valid(value)); return UNKNOWN_VALUE;
         }
         #undef CASE
@@ -505,7 +669,7 @@ namespace librealsense
     }
 
     notifications_proccessor::notifications_proccessor()
-        :_dispatcher(10), _callback(nullptr , [](rs2_notifications_callback*) {})
+        :_dispatcher(10, "rs-notify", RS2_THREAD_CLASS_IO), _callback(nullptr , [](rs2_notifications_callback*) {})
     {
     }
 
@@ -525,6 +689,12 @@ namespace librealsense
         _dispatcher.start();
     }
 
+    void notifications_proccessor::add_observer(std::function<void(const notification&)> observer)
+    {
+        std::lock_guard<std::mutex> lock(_observers_mutex);
+        _observers.push_back(std::move(observer));
+    }
+
     void copy(void* dst, void const* src, size_t size)
     {
         auto from = reinterpret_cast<uint8_t const*>(src);
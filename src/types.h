@@ -21,6 +21,7 @@
 #include <map>
 #include <limits>
 #include <algorithm>
+#include <atomic>
 #include <condition_variable>
 #include <functional>
 #include "backend.h"
@@ -31,7 +32,7 @@
 
 typedef unsigned char byte;
 
-const int RS2_USER_QUEUE_SIZE = 128;
+const int RS2_USER_QUEUE_SIZE = 256; // Max frames a sensor archive can publish at once, see RS2_OPTION_FRAMES_QUEUE_SIZE
 
 #ifndef DBL_EPSILON
 const double DBL_EPSILON = 2.2204460492503131e-016;  // smallest such that 1.0+DBL_EPSILON != 1.0
@@ -50,6 +51,7 @@ namespace librealsense
     {
         std::ostringstream ss;
         template<class T> to_string & operator << (const T & val) { ss << val; return *this; }
+        to_string & operator << (std::ostream& (*manip)(std::ostream&)) { ss << manip; return *this; }
         operator std::string() const { return ss.str(); }
     };
 
@@ -64,11 +66,25 @@ namespace librealsense
     void log_to_console(rs2_log_severity min_severity);
     void log_to_file(rs2_log_severity min_severity, const char * file_path);
 
-#define LOG_DEBUG(...)   do { CLOG(DEBUG   ,"librealsense") << __VA_ARGS__; } while(false)
-#define LOG_INFO(...)    do { CLOG(INFO    ,"librealsense") << __VA_ARGS__; } while(false)
-#define LOG_WARNING(...) do { CLOG(WARNING ,"librealsense") << __VA_ARGS__; } while(false)
-#define LOG_ERROR(...)   do { CLOG(ERROR   ,"librealsense") << __VA_ARGS__; } while(false)
-#define LOG_FATAL(...)   do { CLOG(FATAL   ,"librealsense") << __VA_ARGS__; } while(false)
+    // Lowest severity reaching the console or the log file, kept by the logger
+    extern std::atomic<int> minimum_log_output_severity;
+
+    // True when messages of the given severity reach the console or the log file. Messages are
+    // formatted only then, so a disabled level costs a single comparison
+    inline bool is_log_enabled(rs2_log_severity severity)
+    {
+        return severity >= minimum_log_output_severity.load(std::memory_order_relaxed);
+    }
+
+    // Hands a formatted message to the thread writing the log, the caller does not wait for the output
+    void log_message(rs2_log_severity severity, const char* file, int line, std::string message);
+
+#define LOG_WITH_SEVERITY(severity, ...) do { if (librealsense::is_log_enabled(severity)) librealsense::log_message(severity, __FILE__, __LINE__, librealsense::to_string() << __VA_ARGS__); } while(false)
+#define LOG_DEBUG(...)   LOG_WITH_SEVERITY(RS2_LOG_SEVERITY_DEBUG, __VA_ARGS__)
+#define LOG_INFO(...)    LOG_WITH_SEVERITY(RS2_LOG_SEVERITY_INFO, __VA_ARGS__)
+#define LOG_WARNING(...) LOG_WITH_SEVERITY(RS2_LOG_SEVERITY_WARN, __VA_ARGS__)
+#define LOG_ERROR(...)   LOG_WITH_SEVERITY(RS2_LOG_SEVERITY_ERROR, __VA_ARGS__)
+#define LOG_FATAL(...)   LOG_WITH_SEVERITY(RS2_LOG_SEVERITY_FATAL, __VA_ARGS__)
 
 
     //////////////////////////
@@ -234,17 +250,10 @@ namespace librealsense
         lazy(lazy&& other) noexcept
         {
             std::lock_guard<std::mutex> lock(other._mtx);
-            if (!other._was_init)
-            {
-                _init = move(other._init);
-                _was_init = false;
-            }
-            else
-            {
-                _init = move(other._init);
-                _was_init = true;
-                _ptr = move(other._ptr);
-            }
+            _init = move(other._init);
+            _ptr = move(other._ptr);
+            _value.store(_ptr.get(), std::memory_order_release);
+            other._value.store(nullptr, std::memory_order_release);
         }
 
         lazy& operator=(std::function<T()> func) noexcept
@@ -256,35 +265,32 @@ namespace librealsense
         {
             std::lock_guard<std::mutex> lock1(_mtx);
             std::lock_guard<std::mutex> lock2(other._mtx);
-            if (!other._was_init)
-            {
-                _init = move(other._init);
-                _was_init = false;
-            }
-            else
-            {
-                _init = move(other._init);
-                _was_init = true;
-                _ptr = move(other._ptr);
-            }
+            _init = move(other._init);
+            _ptr = move(other._ptr);
+            _value.store(_ptr.get(), std::memory_order_release);
+            other._value.store(nullptr, std::memory_order_release);
 
             return *this;
         }
 
     private:
+        // Once initialized a read is a single load, the mutex only orders the threads racing to initialize
         T* operate() const
         {
+            if (auto value = _value.load(std::memory_order_acquire))
+                return value;
+
             std::lock_guard<std::mutex> lock(_mtx);
-            if (!_was_init)
+            if (!_ptr)
             {
                 _ptr = std::unique_ptr<T>(new T(_init()));
-                _was_init = true;
+                _value.store(_ptr.get(), std::memory_order_release);
             }
             return _ptr.get();
         }
 
         mutable std::mutex _mtx;
-        mutable bool _was_init = false;
+        mutable std::atomic<T*> _value{ nullptr };
         std::function<T()> _init;
         mutable std::unique_ptr<T> _ptr;
     };
@@ -343,12 +349,20 @@ namespace librealsense
     RS2_ENUM_HELPERS(rs2_camera_info, CAMERA_INFO)
     RS2_ENUM_HELPERS(rs2_frame_metadata_value, FRAME_METADATA)
     RS2_ENUM_HELPERS(rs2_timestamp_domain, TIMESTAMP_DOMAIN)
+    RS2_ENUM_HELPERS(rs2_frame_latency_stage, FRAME_LATENCY_STAGE)
+    RS2_ENUM_HELPERS(rs2_queue_policy, QUEUE_POLICY)
+    RS2_ENUM_HELPERS(rs2_frame_drop_stage, FRAME_DROP_STAGE)
+    RS2_ENUM_HELPERS(rs2_latency_measure, LATENCY_MEASURE)
     RS2_ENUM_HELPERS(rs2_sr300_visual_preset, SR300_VISUAL_PRESET)
     RS2_ENUM_HELPERS(rs2_extension, EXTENSION)
     RS2_ENUM_HELPERS(rs2_exception_type, EXCEPTION_TYPE)
     RS2_ENUM_HELPERS(rs2_log_severity, LOG_SEVERITY)
     RS2_ENUM_HELPERS(rs2_notification_category, NOTIFICATION_CATEGORY)
     RS2_ENUM_HELPERS(rs2_playback_status, PLAYBACK_STATUS)
+    RS2_ENUM_HELPERS(rs2_thread_class, THREAD_CLASS)
+    RS2_ENUM_HELPERS(rs2_metric_type, METRIC_TYPE)
+    RS2_ENUM_HELPERS(rs2_time_source, TIME_SOURCE)
+    RS2_ENUM_HELPERS(rs2_record_compression, RECORD_COMPRESSION)
 
     ////////////////////////////////////////////
     // World's tiniest linear algebra library //
@@ -444,6 +458,8 @@ namespace librealsense
         bool requires_processing;
         void(*unpack)(byte * const dest[], const byte * source, int count);
         std::vector<std::pair<stream_descriptor, rs2_format>> outputs;
+        // Set instead of unpack for compressed formats, whose frames vary in size
+        void(*decode)(byte * const dest[], const byte * source, size_t size, int width, int height);
 
         bool satisfies(const stream_profile& request) const
         {
@@ -700,6 +716,28 @@ namespace librealsense
         void release() override { delete this; }
     };
 
+    typedef void*(*frame_alloc_function_ptr)(int size, int alignment, void * user);
+    typedef void(*frame_free_function_ptr)(void * ptr, void * user);
+
+    class frame_allocator : public rs2_frame_allocator
+    {
+        frame_alloc_function_ptr aptr;
+        frame_free_function_ptr fptr;
+        void * user;
+    public:
+        frame_allocator(frame_alloc_function_ptr on_alloc, frame_free_function_ptr on_free, void * user) : aptr(on_alloc), fptr(on_free), user(user) {}
+
+        void* allocate(size_t size, size_t alignment) override { return aptr(static_cast<int>(size), static_cast<int>(alignment), user); }
+        void deallocate(void* ptr) override {
+            try { fptr(ptr, user); }
+            catch (...)
+            {
+                LOG_ERROR("Received an execption from frame free callback!");
+            }
+        }
+        void release() override { delete this; }
+    };
+
     typedef void(*notifications_callback_function_ptr)(rs2_notification * notification, void * user);
 
     class notifications_callback : public rs2_notifications_callback
@@ -751,6 +789,7 @@ namespace librealsense
     typedef std::unique_ptr<rs2_log_callback, void(*)(rs2_log_callback*)> log_callback_ptr;
     typedef std::shared_ptr<rs2_frame_callback> frame_callback_ptr;
     typedef std::shared_ptr<rs2_frame_processor_callback> frame_processor_callback_ptr;
+    typedef std::shared_ptr<rs2_frame_allocator> frame_allocator_ptr;
     typedef std::unique_ptr<rs2_notifications_callback, void(*)(rs2_notifications_callback*)> notifications_callback_ptr;
     typedef std::shared_ptr<rs2_devices_changed_callback> devices_changed_callback_ptr;
 
@@ -805,10 +844,14 @@ namespace librealsense
 
         void set_callback(notifications_callback_ptr callback);
         void raise_notification(const notification);
+        // Observers are called on the raising thread, before the notification is dispatched to the callback
+        void add_observer(std::function<void(const notification&)> observer);
 
     private:
         notifications_callback_ptr _callback;
         std::mutex _callback_mutex;
+        std::vector<std::function<void(const notification&)>> _observers;
+        std::mutex _observers_mutex;
         dispatcher _dispatcher;
     };
     ////////////////////////////////////////
@@ -920,6 +963,101 @@ namespace librealsense
         int get_size() const { return size; }
     };
 
+    // Pool of objects sized at runtime. Free slots are kept on a stack of indices whose head is tagged against ABA,
+    // so allocate and deallocate never lock. The mutex only serves waiting until all the objects are returned
+    template<class T>
+    class slot_allocator
+    {
+        static const uint32_t none = 0xffffffff;
+
+        std::unique_ptr<T[]> buffer;
+        std::unique_ptr<std::atomic<uint32_t>[]> next_free;
+        uint32_t capacity;
+        std::atomic<uint64_t> head;     // Modification tag in the upper half, index of the top free slot in the lower
+        std::atomic<int> size;
+        std::atomic<bool> keep_allocating;
+        std::mutex mutex;
+        std::condition_variable cv;
+
+        void push(uint32_t index)
+        {
+            auto top = head.load(std::memory_order_relaxed);
+            uint64_t updated;
+            do
+            {
+                next_free[index].store(static_cast<uint32_t>(top), std::memory_order_relaxed);
+                updated = (((top >> 32) + 1) << 32) | index;
+            } while (!head.compare_exchange_weak(top, updated, std::memory_order_release, std::memory_order_relaxed));
+        }
+
+    public:
+        explicit slot_allocator(uint32_t capacity)
+            : buffer(new T[capacity]), next_free(new std::atomic<uint32_t>[capacity]), capacity(capacity),
+              head(none), size(0), keep_allocating(true)
+        {
+            for (auto i = capacity; i > 0; i--) push(i - 1);
+        }
+
+        slot_allocator(const slot_allocator&) = delete;
+        slot_allocator& operator=(const slot_allocator&) = delete;
+
+        T* allocate()
+        {
+            if (!keep_allocating) return nullptr;
+
+            auto top = head.load(std::memory_order_acquire);
+            while (true)
+            {
+                auto index = static_cast<uint32_t>(top);
+                if (index == none) return nullptr;
+
+                // A stale next index fails the exchange, since the tag changed meanwhile
+                uint64_t updated = (((top >> 32) + 1) << 32) | next_free[index].load(std::memory_order_relaxed);
+                if (head.compare_exchange_weak(top, updated, std::memory_order_acquire, std::memory_order_acquire))
+                {
+                    size++;
+                    return &buffer[index];
+                }
+            }
+        }
+
+        void deallocate(T* item)
+        {
+            if (item < buffer.get() || item >= buffer.get() + capacity)
+            {
+                throw invalid_value_exception("Trying to return item to a heap that didn't allocate it!");
+            }
+            auto i = static_cast<uint32_t>(item - buffer.get());
+            auto old_value = std::move(buffer[i]);
+            buffer[i] = std::move(T());
+            push(i);
+
+            if (--size == 0)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                cv.notify_all();
+            }
+        }
+
+        void stop_allocation()
+        {
+            keep_allocating = false;
+        }
+
+        void wait_until_empty()
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            if (!is_empty() && !cv.wait_for(lock, std::chrono::hours(1000), [this]() { return is_empty(); }))
+            {
+                throw invalid_value_exception("Could not flush one of the user controlled objects!");
+            }
+        }
+
+        bool is_empty() const { return size == 0; }
+        int get_size() const { return size; }
+        uint32_t get_capacity() const { return capacity; }
+    };
+
     struct uvc_device_info
     {
         std::string id = ""; // to distinguish between different pins of the same device
@@ -1125,7 +1263,7 @@ namespace librealsense
     public:
         frame_continuation() : continuation([]() {}) {}
 
-        explicit frame_continuation(std::function<void()> continuation, const void* protected_data) : continuation(continuation), protected_data(protected_data) {}
+        explicit frame_continuation(std::function<void()> continuation, const void* protected_data) : continuation(std::move(continuation)), protected_data(protected_data) {}
 
 
         frame_continuation(frame_continuation && other) : continuation(std::move(other.continuation)), protected_data(other.protected_data)
@@ -1206,7 +1344,7 @@ namespace librealsense
             _backend(backend_ref),_active_object([this](dispatcher::cancellable_timer cancellable_timer)
         {
             polling(cancellable_timer);
-        }), _devices_data()
+        }, "rs-device-poll"), _devices_data()
         {
         }
 
@@ -152,7 +152,11 @@ namespace librealsense
                 if (!_data._stopped) throw wrong_api_call_sequence_exception("Cannot start a running device_watcher");
                 _data._stopped = false;
                 _data._callback = std::move(callback);
-                _thread = std::thread([this]() { run(); });
+                _thread = std::thread([this]()
+                {
+                    thread_registration registration("rs-device-watch", RS2_THREAD_CLASS_IO);
+                    run();
+                });
             }
 
             void stop() override
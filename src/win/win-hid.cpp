@@ -26,6 +26,8 @@
 #include <propkeydef.h>
 #include <comutil.h>
 
+#include <mutex>
+
 #pragma comment(lib, "Sensorsapi.lib")
 #pragma comment(lib, "PortableDeviceGuids.lib")
 
@@ -38,7 +40,26 @@ namespace librealsense
         public:
             virtual ~sensor_events() = default;
 
-            explicit sensor_events(hid_callback callback) : m_cRef(0), _callback(callback) {}
+            // The samples of a batch are kept in preallocated reports, which are handed to the callback once all are filled
+            sensor_events(hid_batch_callback callback, size_t batch_size)
+                : m_cRef(0), _callback(callback), _samples(batch_size), _reports(batch_size), _count(0)
+            {
+                for (size_t i = 0; i < batch_size; i++)
+                {
+                    _reports[i].sensor.name = "";
+                    _reports[i].fo.pixels = &_samples[i];
+                    _reports[i].fo.metadata = NULL;
+                    _reports[i].fo.metadata_size = 0;
+                    _reports[i].fo.frame_size = sizeof(hid_sensor_data);
+                }
+            }
+
+            // Delivers the samples of a partial batch, when the capture stops
+            void flush()
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                deliver();
+            }
 
             STDMETHODIMP QueryInterface(REFIID iid, void** ppv)
             {
@@ -130,20 +151,15 @@ namespace librealsense
 
                 PropVariantClear(&var);
 
-                sensor_data d;
-                hid_sensor_data data;
-
+                std::lock_guard<std::mutex> lock(_mutex);
+                auto&& data = _samples[_count++];
                 data.x = rawX;
                 data.y = rawY;
                 data.z = rawZ;
                 data.ts_low = customTimestampLow;
                 data.ts_high = customTimestampHigh;
-                d.sensor.name = "";
-
-                d.fo.pixels = &data;
-                d.fo.metadata = NULL;
-                d.fo.frame_size = sizeof(data);
-                _callback(d);
+                if (_count == _samples.size())
+                    deliver();
 
                 return S_OK;
             }
@@ -187,29 +203,97 @@ namespace librealsense
             }
 
         private:
+            void deliver()
+            {
+                if (_count == 0) return;
+                _callback(_reports.data(), _count);
+                _count = 0;
+            }
+
             long m_cRef;
-            hid_callback _callback;
+            hid_batch_callback _callback;
+            std::mutex _mutex;
+            std::vector<hid_sensor_data> _samples;
+            std::vector<sensor_data> _reports;
+            size_t _count;
         };
 
+        // The profiles of all the sensors of the device are given, the one of this sensor is found by its type
+        uint32_t wmf_hid_device::get_requested_frequency(const std::vector<hid_profile>& profiles) const
+        {
+            SENSOR_TYPE_ID type{};
+            LOG_HR(_sensor->GetType(&type));
+            std::string name;
+            if (IsEqualGUID(type, SENSOR_TYPE_GYROMETER_3D)) name = "gyro_3d";
+            else if (IsEqualGUID(type, SENSOR_TYPE_ACCELEROMETER_3D)) name = "accel_3d";
+
+            uint32_t frequency = 0;
+            for (auto&& profile : profiles)
+            {
+                if (profile.sensor_name == name)
+                    return profile.frequency;
+                frequency = std::max(frequency, profile.frequency);
+            }
+            return frequency;
+        }
+
+        // An interval of 0 restores the default of the sensor
+        void wmf_hid_device::set_report_interval(ULONG interval_ms)
+        {
+            if (interval_ms > 0)
+            {
+                PROPVARIANT min_interval = {};
+                if (SUCCEEDED(_sensor->GetProperty(SENSOR_PROPERTY_MIN_REPORT_INTERVAL, &min_interval)) && min_interval.vt == VT_UI4)
+                    interval_ms = std::max(interval_ms, min_interval.ulVal);
+                PropVariantClear(&min_interval);
+            }
+
+            CComPtr<IPortableDeviceValues> values = nullptr;
+            CComPtr<IPortableDeviceValues> results = nullptr;
+            CHECK_HR(values.CoCreateInstance(CLSID_PortableDeviceValues));
+            CHECK_HR(values->SetUnsignedIntegerValue(SENSOR_PROPERTY_CURRENT_REPORT_INTERVAL, interval_ms));
+            LOG_HR(_sensor->SetProperties(values, &results));
+        }
+
+        // The Sensor API reports one sample per event, so the report interval is set to the requested rate and the
+        // samples are delivered in batches of batch_latency_ms
         void wmf_hid_device::open(const std::vector<hid_profile>&iio_profiles)
         {
+            auto frequency = get_requested_frequency(iio_profiles);
+            _batch_size = std::max<size_t>(1, frequency * batch_latency_ms / 1000);
+            if (frequency > 0)
+                set_report_interval(std::max<ULONG>(1, 1000 / frequency));
         }
 
         void wmf_hid_device::close()
         {
+            set_report_interval(0);
+            _batch_size = 1;
         }
 
         void wmf_hid_device::stop_capture()
         {
             _sensor->SetEventSink(NULL);
+            if (_events) _events->flush();
+            _events = nullptr;
             _cb = nullptr;
 
         }
 
         void wmf_hid_device::start_capture(hid_callback callback)
+        {
+            start_batch_capture([callback](const sensor_data* samples, size_t count)
+            {
+                for (size_t i = 0; i < count; i++)
+                    callback(samples[i]);
+            });
+        }
+
+        void wmf_hid_device::start_batch_capture(hid_batch_callback callback)
         {
             // Hack, start default profile
-            _cb = new sensor_events(callback);
+            _events = new sensor_events(callback, _batch_size);
+            _cb = _events;
             ISensorEvents* sensorEvents = nullptr;
             CHECK_HR(_cb->QueryInterface(IID_PPV_ARGS(&sensorEvents)));
             CHECK_HR(_sensor->SetEventSink(sensorEvents));
@@ -12,6 +12,8 @@ namespace librealsense
 {
     namespace platform
     {
+        class sensor_events;
+
         class wmf_hid_device : public hid_device
         {
         public:
@@ -23,14 +25,21 @@ namespace librealsense
             void close() override;
             void stop_capture() override;
             void start_capture(hid_callback callback) override;
+            void start_batch_capture(hid_batch_callback callback) override;
             std::vector<hid_sensor> get_sensors() override;
             std::vector<uint8_t> get_custom_report_data(const std::string& custom_sensor_name,
                 const std::string& report_name,
                 custom_sensor_report_field report_field) override;
 
         private:
+            uint32_t get_requested_frequency(const std::vector<hid_profile>& profiles) const;
+            void set_report_interval(ULONG interval_ms);
+
+            static const uint32_t batch_latency_ms = 10;    // Samples collected before they are delivered, in time at the report rate
             CComPtr<ISensor> _sensor = nullptr;
             CComPtr<ISensorEvents> _cb = nullptr;
+            sensor_events* _events = nullptr;               // Owned by _cb
+            size_t _batch_size = 1;
         };
     }
 }
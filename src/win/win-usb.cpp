@@ -7,6 +7,7 @@
 #error At least Visual Studio 2013 Update 4 is required to compile this backend
 #endif
 
+#include "../types.h"
 #include "win-usb.h"
 #include <atlstr.h>
 #include <Windows.h>
@@ -419,6 +420,13 @@ namespace librealsense
                 throw winapi_error("WinUsb_ResetPipe failed!");
         }
 
+        // Cancels the transfers in flight on the bulk pipes, which then complete with ERROR_OPERATION_ABORTED
+        void usb_interface::abort_pipes() const
+        {
+            if (!WinUsb_AbortPipe(_interface_handle, _out_pipe_id) || !WinUsb_AbortPipe(_interface_handle, _in_pipe_id))
+                throw winapi_error("WinUsb_AbortPipe failed!");
+        }
+
         void usb_interface::reset_pipe(pipe_direction pipeDirection) const
         {
             BOOL sts;
@@ -577,6 +585,125 @@ namespace librealsense
             return output;
         }
 
+        // Commands of a batch written and awaiting their responses at a time
+        static const size_t max_outstanding_commands = 4;
+
+        // The commands are written up to max_outstanding_commands ahead of their responses, each with a read queued
+        // behind its write. The pipes complete their transfers in the order they were queued, so the reads receive the
+        // responses of the commands in order, and the completions of all of them are collected on one port
+        std::vector<std::vector<uint8_t>> winusb_bulk_transfer::send_receive_batch(const std::vector<std::vector<uint8_t>>& commands, int timeout_ms,
+                                                                                   std::vector<command_deadline::clock::time_point>* received)
+        {
+            if (commands.size() < 2)
+                return usb_device::send_receive_batch(commands, timeout_ms, received);
+
+            struct transfer
+            {
+                OVERLAPPED ovl;     // First, a completed OVERLAPPED is the address of its transfer
+                size_t command;
+                bool is_read;
+            };
+
+            std::lock_guard<named_mutex> lock(_named_mutex);
+            winusb_device usbDevice(_lp_device_path);
+            auto&& usb = usbDevice.get_interface();
+
+            auto port = CreateIoCompletionPort(usbDevice.get_handle(), nullptr, 0, 0);
+            if (!port)
+                throw winapi_error("CreateIoCompletionPort failed.");
+            std::shared_ptr<void> port_closer(port, CloseHandle);
+
+            size_t depth = max_outstanding_commands;
+            if (commands.size() < depth) depth = commands.size();
+            std::vector<transfer> writes(depth), reads(depth);
+            std::vector<std::vector<uint8_t>> results(commands.size());
+            size_t issued = 0, completed = 0, in_flight = 0;
+
+            auto start = [&](transfer& t, size_t command, bool is_read)
+            {
+                ZeroMemory(&t.ovl, sizeof(t.ovl));
+                t.command = command;
+                t.is_read = is_read;
+                ULONG length = 0;
+                auto res = is_read ? usb.read_pipe(results[command].data(), HW_MONITOR_BUFFER_SIZE, &length, &t.ovl)
+                                   : usb.write_pipe(commands[command].data(), static_cast<ULONG>(commands[command].size()), &length, &t.ovl);
+                if (!res && GetLastError() != ERROR_IO_PENDING)
+                    return false;
+                in_flight++;
+                return true;
+            };
+            auto issue = [&]()
+            {
+                auto slot = issued % depth;
+                results[issued].resize(HW_MONITOR_BUFFER_SIZE);
+                if (!start(writes[slot], issued, false) || !start(reads[slot], issued, true))
+                    return false;
+                issued++;
+                return true;
+            };
+
+            auto failed = false;
+            while (issued < depth && !failed)
+                failed = !issue();
+
+            // Commands complete in order, until a transfer fails, times out or the deadline of the batch passes
+            auto deadline = command_deadline::current();
+            while (!failed && completed < commands.size())
+            {
+                auto timeout = deadline.transfer_timeout(timeout_ms);
+                DWORD length = 0;
+                ULONG_PTR key = 0;
+                LPOVERLAPPED ovl = nullptr;
+                if (!timeout || !GetQueuedCompletionStatus(port, &length, &key, &ovl, timeout))
+                {
+                    if (ovl) in_flight--;
+                    failed = true;
+                    break;
+                }
+                in_flight--;
+
+                auto t = reinterpret_cast<transfer*>(ovl);
+                if (!t->is_read) continue;
+
+                results[t->command].resize(length);
+                if (received) received->push_back(command_deadline::clock::now());
+                completed++;
+                if (issued < commands.size())
+                    failed = !issue();
+            }
+
+            if (in_flight > 0)
+            {
+                // The transfers must finish while their buffers are still in place. Aborted transfers complete right
+                // away, and the timeout policy of the pipes bounds the others
+                try
+                {
+                    usb.abort_pipes();
+                }
+                catch (const std::exception& e)
+                {
+                    LOG_WARNING("Failed to abort a USB command batch: " << e.what());
+                }
+                while (in_flight > 0)
+                {
+                    DWORD length = 0;
+                    ULONG_PTR key = 0;
+                    LPOVERLAPPED ovl = nullptr;
+                    if (!GetQueuedCompletionStatus(port, &length, &key, &ovl, INFINITE) && !ovl)
+                        break;
+                    in_flight--;
+                }
+                usb.reset_pipe(pipe_direction::InPipe);
+                usb.reset_pipe(pipe_direction::OutPipe);
+            }
+
+            if (failed && !deadline.has_passed())
+                throw std::runtime_error("USB command batch failed or timed-out!");
+
+            results.resize(completed);
+            return results;
+        }
+
         const wchar_t* winusb_bulk_transfer::get_path() const
         {
             return _lp_device_path.c_str();
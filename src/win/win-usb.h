@@ -31,6 +31,7 @@ namespace librealsense
             bool read_pipe(unsigned char* buffer, ULONG bufferLength, PULONG lengthTransferred, LPOVERLAPPED hOvl) const;
             bool write_pipe(const unsigned char* buffer, ULONG bufferLength, PULONG lengthTransferred, LPOVERLAPPED hOvl) const;
             void reset_pipe(pipe_direction outPipe) const;
+            void abort_pipes() const;
             bool read_interupt_pipe(unsigned char* buffer, ULONG bufferLength, PULONG lengthTransferred, LPOVERLAPPED hOvl) const;
             void reset_interrupt_pipe() const;
 
@@ -55,6 +56,7 @@ namespace librealsense
             explicit winusb_device(std::wstring lpDevicePath);
             ~winusb_device();
             usb_interface& get_interface() const;
+            HANDLE get_handle() const { return _device_handle; }
             void recreate_interface();
 
         private:
@@ -83,6 +85,11 @@ namespace librealsense
                 int timeout_ms = 5000,
                 bool require_response = true) override;
 
+            std::vector<std::vector<uint8_t>> send_receive_batch(
+                const std::vector<std::vector<uint8_t>>& commands,
+                int timeout_ms = 5000,
+                std::vector<command_deadline::clock::time_point>* received = nullptr) override;
+
             explicit winusb_bulk_transfer(const usb_device_info& info);
             const wchar_t* get_path() const;
 
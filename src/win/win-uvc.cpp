@@ -188,6 +188,7 @@ namespace librealsense
 
                 if (sample)
                 {
+                    CComPtr<IMFSample> sample_ref(sample);
                     CComPtr<IMFMediaBuffer> buffer = nullptr;
                     if (SUCCEEDED(sample->GetBufferByIndex(0, &buffer)))
                     {
@@ -207,7 +208,9 @@ namespace librealsense
                                 auto profile = stream.profile;
                                 frame_object f{ current_length, metadata_size, byte_buffer, metadata };
 
-                                auto continuation = [buffer, this]()
+                                // Frames that do not copy the data keep the sample out of the reader pool until they
+                                // are released, the other requests in flight keep the stream going meanwhile
+                                auto continuation = [buffer, sample_ref]()
                                 {
                                     buffer->Unlock();
                                 };
@@ -986,16 +989,17 @@ namespace librealsense
             }
         }
 
-        void wmf_uvc_device::probe_and_commit(stream_profile profile, frame_callback callback, int /*buffers*/)
+        void wmf_uvc_device::probe_and_commit(stream_profile profile, frame_callback callback, int buffers)
         {
             if (_streaming)
                 throw std::runtime_error("Device is already streaming!");
 
             _profiles.push_back(profile);
             _frame_callbacks.push_back(callback);
+            _frame_buffers.push_back(std::max(1, buffers));
         }
 
-        void wmf_uvc_device::play_profile(stream_profile profile, frame_callback callback)
+        void wmf_uvc_device::play_profile(stream_profile profile, frame_callback callback, int buffers)
         {
             CComPtr<IMFMediaType> pMediaType = nullptr;
             for (unsigned int sIndex = 0; sIndex < _streams.size(); ++sIndex)
@@ -1072,8 +1076,11 @@ namespace librealsense
                                         _streams[sIndex].callback = callback;
                                     }
 
+                                    // Each completed request issues the next one, so the requests in flight stay
+                                    // constant and a sample being delivered does not leave the reader idle
                                     _readsample_result = S_OK;
-                                    CHECK_HR(_reader->ReadSample(sIndex, 0, nullptr, nullptr, nullptr, nullptr));
+                                    for (auto i = 0; i < buffers; ++i)
+                                        CHECK_HR(_reader->ReadSample(sIndex, 0, nullptr, nullptr, nullptr, nullptr));
 
                                     const auto timeout_ms = 5000;
                                     if (_has_started.wait(timeout_ms))
@@ -1114,7 +1121,7 @@ namespace librealsense
             {
                 for (uint32_t i = 0; i < _profiles.size(); ++i)
                 {
-                    play_profile(_profiles[i], _frame_callbacks[i]);
+                    play_profile(_profiles[i], _frame_callbacks[i], _frame_buffers[i]);
                 }
 
                 _streaming = true;
@@ -1127,6 +1134,7 @@ namespace librealsense
 
                 _profiles.clear();
                 _frame_callbacks.clear();
+                _frame_buffers.clear();
 
                 throw;
             }
@@ -1158,6 +1166,7 @@ namespace librealsense
             {
                 _profiles.erase(_profiles.begin() + pos);
                 _frame_callbacks.erase(_frame_callbacks.begin() + pos);
+                _frame_buffers.erase(_frame_buffers.begin() + pos);
             }
 
             if (_profiles.empty())
@@ -82,7 +82,7 @@ namespace librealsense
         private:
             friend class source_reader_callback;
 
-            void play_profile(stream_profile profile, frame_callback callback);
+            void play_profile(stream_profile profile, frame_callback callback, int buffers);
             void stop_stream_cleanup(const stream_profile& profile, std::vector<profile_and_callback>::iterator& elem);
             void flush(int sIndex);
             void check_connection() const;
@@ -117,6 +117,7 @@ namespace librealsense
             std::string                             _location;
             std::vector<stream_profile>             _profiles;
             std::vector<frame_callback>             _frame_callbacks;
+            std::vector<int>                        _frame_buffers;
             bool                                    _streaming = false;
             std::atomic<bool>                       _is_started = false;
         };
@@ -52,11 +52,15 @@
 
 //#include "ros/subscription_callback_helper.h"
 
+#include <condition_variable>
+#include <deque>
 #include <ios>
 #include <map>
+#include <mutex>
 #include <queue>
 #include <set>
 #include <stdexcept>
+#include <thread>
 
 #include <boost/format.hpp>
 //#include <boost/iterator/iterator_facade.hpp>
@@ -122,6 +126,18 @@ public:
     CompressionType getCompression() const;                       //!< Get the compression method to use for writing chunks
     void            setChunkThreshold(uint32_t chunk_threshold);  //!< Set the threshold for creating new chunks
     uint32_t        getChunkThreshold() const;                    //!< Get the threshold for creating new chunks
+    void            setCompressionThreads(uint32_t threads);      //!< Compress chunks on this many threads in the background, 0 compresses them while writing
+    uint32_t        getCompressionThreads() const;                //!< Get the number of threads compressing chunks
+
+    //! Locate the serialized data of a message in the bag file
+    /*!
+     * \param index_entry The index entry of the message
+     * \param offset      Receives the offset of the message data in the file
+     * \param size        Receives the size of the message data
+     *
+     * \return false if the message data is not stored as is in the file, e.g. in a compressed chunk
+     */
+    bool getMessageDataLocation(IndexEntry const& index_entry, uint64_t& offset, uint32_t& size) const;
 
     //! Write a message into the bag file
     /*!
@@ -200,13 +216,34 @@ private:
     void appendConnectionRecordToBuffer(Buffer& buf, ConnectionInfo const* connection_info);
     template<class T>
     void writeMessageDataRecord(uint32_t conn_id, ros::Time const& time, T const& msg);
-    void writeIndexRecords();
+    void writeIndexRecords(std::map<uint32_t, std::multiset<IndexEntry> > const& indexes);
     void writeConnectionRecords();
     void writeChunkInfoRecords();
     void startWritingChunk(ros::Time time);
     void writeChunkHeader(CompressionType compression, uint32_t compressed_size, uint32_t uncompressed_size);
     void stopWritingChunk();
 
+    // Chunks compressed in parallel are kept in memory and written to the file in order once compressed
+
+    struct PendingChunk
+    {
+        CompressionType                                compression;
+        ChunkInfo                                      info;
+        std::map<uint32_t, std::multiset<IndexEntry> > indexes;
+        Buffer                                         data;
+        std::vector<char>                              compressed;
+        uint32_t                                       compressed_size = 0;
+        bool                                           done = false;
+        std::string                                    error;
+    };
+
+    bool isCompressingInParallel() const;
+    void queueChunkCompression();
+    void compressPendingChunks();
+    void writePendingChunks(size_t max_pending);
+    void writeCompressedChunk(PendingChunk& chunk);
+    void stopCompressionThreads();
+
     // Reading
 
     void readVersion();
@@ -309,6 +346,18 @@ private:
     mutable Buffer*  current_buffer_;
 
     mutable uint64_t decompressed_chunk_;      //!< position of decompressed chunk
+    mutable uint64_t located_chunk_;           //!< position of the chunk last located by getMessageDataLocation
+    mutable uint64_t located_chunk_data_pos_;  //!< position of the data of the located chunk, 0 if it is compressed
+
+    uint32_t                                  compression_threads_;
+    std::vector<std::thread>                  compression_workers_;
+    std::deque<std::shared_ptr<PendingChunk> > pending_chunks_;     //!< chunks not written yet, in file order
+    std::deque<std::shared_ptr<PendingChunk> > compression_queue_;  //!< chunks not picked by a compression thread yet
+    std::mutex                                compression_mutex_;
+    std::condition_variable                   compression_cv_;
+    std::condition_variable                   compressed_cv_;
+    bool                                      compression_stop_;
+    Buffer                                    spare_chunk_buffer_;  //!< data buffer of the last written chunk, reused by the next one
 };
 
 } // namespace rosbag
@@ -542,7 +591,9 @@ void Bag::doWrite(std::string const& topic, ros::Time const& time, T const& msg,
             }
             connections_[conn_id] = connection_info;
 
-            writeConnectionRecord(connection_info);
+            // Chunks compressed in parallel are written from the outgoing chunk buffer only
+            if (!isCompressingInParallel())
+                writeConnectionRecord(connection_info);
             appendConnectionRecordToBuffer(outgoing_chunk_buffer_, connection_info);
         }
 
@@ -554,8 +605,11 @@ void Bag::doWrite(std::string const& topic, ros::Time const& time, T const& msg,
 
         std::multiset<IndexEntry>& chunk_connection_index = curr_chunk_connection_indexes_[connection_info->id];
         chunk_connection_index.insert(chunk_connection_index.end(), index_entry);
-        std::multiset<IndexEntry>& connection_index = connection_indexes_[connection_info->id];
-        connection_index.insert(connection_index.end(), index_entry);
+        // The position of a chunk compressed in parallel is known once it is written, and indexed then
+        if (!isCompressingInParallel()) {
+            std::multiset<IndexEntry>& connection_index = connection_indexes_[connection_info->id];
+            connection_index.insert(connection_index.end(), index_entry);
+        }
 
         // Increment the connection count
         curr_chunk_info_.connection_counts[connection_info->id]++;
@@ -584,36 +638,33 @@ void Bag::writeMessageDataRecord(uint32_t conn_id, ros::Time const& time, T cons
     header[CONNECTION_FIELD_NAME] = toHeaderString(&conn_id);
     header[TIME_FIELD_NAME]       = toHeaderString(&time);
 
-    // Assemble message in memory first, because we need to write its length
     uint32_t msg_ser_len = ros::serialization::serializationLength(msg);
 
-    record_buffer_.setSize(msg_ser_len);
-
-    ros::serialization::OStream s(record_buffer_.getData(), msg_ser_len);
-
-    // todo: serialize into the outgoing_chunk_buffer & remove record_buffer_
-    ros::serialization::serialize(s, msg);
-
-    // We do an extra seek here since writing our data record may
-    // have indirectly moved our file-pointer if it was a
-    // MessageInstance for our own bag
-    seek(0, std::ios::end);
-    file_size_ = file_.getOffset();
-
-    CONSOLE_BRIDGE_logDebug("Writing MSG_DATA [%llu:%d]: conn=%d sec=%d nsec=%d data_len=%d",
-              (unsigned long long) file_.getOffset(), getChunkOffset(), conn_id, time.sec, time.nsec, msg_ser_len);
-
-    writeHeader(header);
-    writeDataLength(msg_ser_len);
-    write((char*) record_buffer_.getData(), msg_ser_len);
-
     // todo: use better abstraction than appendHeaderToBuffer
     appendHeaderToBuffer(outgoing_chunk_buffer_, header);
     appendDataLengthToBuffer(outgoing_chunk_buffer_, msg_ser_len);
 
+    // Serialize straight into the outgoing chunk, which the file is then written from
     uint32_t offset = outgoing_chunk_buffer_.getSize();
     outgoing_chunk_buffer_.setSize(outgoing_chunk_buffer_.getSize() + msg_ser_len);
-    memcpy(outgoing_chunk_buffer_.getData() + offset, record_buffer_.getData(), msg_ser_len);
+
+    ros::serialization::OStream s(outgoing_chunk_buffer_.getData() + offset, msg_ser_len);
+    ros::serialization::serialize(s, msg);
+
+    if (!isCompressingInParallel()) {
+        // We do an extra seek here since writing our data record may
+        // have indirectly moved our file-pointer if it was a
+        // MessageInstance for our own bag
+        seek(0, std::ios::end);
+        file_size_ = file_.getOffset();
+
+        CONSOLE_BRIDGE_logDebug("Writing MSG_DATA [%llu:%d]: conn=%d sec=%d nsec=%d data_len=%d",
+                  (unsigned long long) file_.getOffset(), getChunkOffset(), conn_id, time.sec, time.nsec, msg_ser_len);
+
+        writeHeader(header);
+        writeDataLength(msg_ser_len);
+        write((char*) outgoing_chunk_buffer_.getData() + offset, msg_ser_len);
+    }
 
     // Update the current chunk time range
     if (time > curr_chunk_info_.end_time)
@@ -93,6 +93,9 @@ public:
     //! Size of serialized message
     uint32_t size() const;
 
+    //! Get the index entry that locates the message in its bag
+    IndexEntry const& getIndexEntry() const;
+
 private:
     MessageInstance(ConnectionInfo const* connection_info, IndexEntry const& index, Bag const& bag);
 
@@ -72,7 +72,11 @@ Bag::Bag() :
     chunk_open_(false),
     curr_chunk_data_pos_(0),
     current_buffer_(0),
-    decompressed_chunk_(0)
+    decompressed_chunk_(0),
+    located_chunk_(0),
+    located_chunk_data_pos_(0),
+    compression_threads_(0),
+    compression_stop_(false)
 {
 }
 
@@ -88,7 +92,11 @@ Bag::Bag(string const& filename, uint32_t mode) :
     chunk_open_(false),
     curr_chunk_data_pos_(0),
     current_buffer_(0),
-    decompressed_chunk_(0)
+    decompressed_chunk_(0),
+    located_chunk_(0),
+    located_chunk_data_pos_(0),
+    compression_threads_(0),
+    compression_stop_(false)
 {
     open(filename, mode);
 }
@@ -166,6 +174,8 @@ void Bag::close() {
 
     file_.close();
 
+    decompressed_chunk_ = 0;
+    located_chunk_ = 0;
     topic_connection_ids_.clear();
     header_connection_ids_.clear();
     for (map<uint32_t, ConnectionInfo*>::iterator i = connections_.begin(); i != connections_.end(); i++)
@@ -177,7 +187,14 @@ void Bag::close() {
 }
 
 void Bag::closeWrite() {
-    stopWriting();
+    try {
+        stopWriting();
+    }
+    catch (...) {
+        stopCompressionThreads();
+        throw;
+    }
+    stopCompressionThreads();
 }
 
 string   Bag::getFileName() const { return file_.getFileName(); }
@@ -193,6 +210,19 @@ void Bag::setChunkThreshold(uint32_t chunk_threshold) {
     chunk_threshold_ = chunk_threshold;
 }
 
+uint32_t Bag::getCompressionThreads() const { return compression_threads_; }
+
+void Bag::setCompressionThreads(uint32_t threads) {
+    if (file_.isOpen() && chunk_open_)
+        stopWritingChunk();
+
+    // Compress the chunks queued so far with the threads that picked them
+    writePendingChunks(0);
+    stopCompressionThreads();
+
+    compression_threads_ = threads;
+}
+
 CompressionType Bag::getCompression() const { return compression_; }
 
 void Bag::setCompression(CompressionType compression) {
@@ -254,6 +284,7 @@ void Bag::startWriting() {
 void Bag::stopWriting() {
     if (chunk_open_)
         stopWritingChunk();
+    writePendingChunks(0);
 
     seek(0, std::ios::end);
 
@@ -399,7 +430,9 @@ void Bag::readFileHeaderRecord() {
 }
 
 uint32_t Bag::getChunkOffset() const {
-    if (compression_ == compression::Uncompressed)
+    if (isCompressingInParallel())
+        return outgoing_chunk_buffer_.getSize();
+    else if (compression_ == compression::Uncompressed)
         return static_cast<uint32_t>(file_.getOffset() - curr_chunk_data_pos_);
     else
         return file_.getCompressedBytesIn();
@@ -411,6 +444,12 @@ void Bag::startWritingChunk(Time time) {
     curr_chunk_info_.start_time = time;
     curr_chunk_info_.end_time   = time;
 
+    // The chunk is assembled in the outgoing chunk buffer, and written once compressed
+    if (isCompressingInParallel()) {
+        chunk_open_ = true;
+        return;
+    }
+
     // Write the chunk header, with a place-holder for the data sizes (we'll fill in when the chunk is finished)
     writeChunkHeader(compression_, 0, 0);
 
@@ -424,6 +463,15 @@ void Bag::startWritingChunk(Time time) {
 }
 
 void Bag::stopWritingChunk() {
+    if (isCompressingInParallel()) {
+        queueChunkCompression();
+
+        curr_chunk_connection_indexes_.clear();
+        curr_chunk_info_.connection_counts.clear();
+        chunk_open_ = false;
+        return;
+    }
+
     // Add this chunk to the index
     chunks_.push_back(curr_chunk_info_);
 
@@ -440,7 +488,7 @@ void Bag::stopWritingChunk() {
 
     // Write out the indexes and clear them
     seek(end_of_chunk_pos);
-    writeIndexRecords();
+    writeIndexRecords(curr_chunk_connection_indexes_);
     curr_chunk_connection_indexes_.clear();
 
     // Clear the connection counts
@@ -450,6 +498,135 @@ void Bag::stopWritingChunk() {
     chunk_open_ = false;
 }
 
+// Parallel chunk compression
+
+bool Bag::isCompressingInParallel() const {
+    return compression_threads_ > 0 && compression_ != compression::Uncompressed;
+}
+
+void Bag::queueChunkCompression() {
+    if (compression_workers_.empty()) {
+        compression_stop_ = false;
+        for (uint32_t i = 0; i < compression_threads_; i++)
+            compression_workers_.emplace_back([this]() { compressPendingChunks(); });
+    }
+
+    std::shared_ptr<PendingChunk> chunk = std::make_shared<PendingChunk>();
+    chunk->compression = compression_;
+    chunk->info = curr_chunk_info_;
+    chunk->indexes.swap(curr_chunk_connection_indexes_);
+    chunk->data.swap(outgoing_chunk_buffer_);
+    outgoing_chunk_buffer_.swap(spare_chunk_buffer_);
+
+    {
+        std::lock_guard<std::mutex> lock(compression_mutex_);
+        pending_chunks_.push_back(chunk);
+        compression_queue_.push_back(chunk);
+    }
+    compression_cv_.notify_one();
+
+    // Write whatever is compressed already, and bound the memory held by the chunks still waiting
+    writePendingChunks(2 * compression_threads_);
+}
+
+void Bag::compressPendingChunks() {
+    std::unique_lock<std::mutex> lock(compression_mutex_);
+    while (true) {
+        compression_cv_.wait(lock, [this]() { return compression_stop_ || !compression_queue_.empty(); });
+        if (compression_queue_.empty())
+            return;
+
+        std::shared_ptr<PendingChunk> chunk = compression_queue_.front();
+        compression_queue_.pop_front();
+        lock.unlock();
+
+        if (chunk->compression == compression::LZ4) {
+            // Worst case of LZ4 plus the framing of roslz4, grown further if that is not enough
+            uint32_t size = chunk->data.getSize();
+            chunk->compressed.resize(size + size / 255 + 1024);
+            while (true) {
+                unsigned int compressed_size = static_cast<unsigned int>(chunk->compressed.size());
+                int ret = roslz4_buffToBuffCompress((char*) chunk->data.getData(), size,
+                                                    chunk->compressed.data(), &compressed_size, 6);
+                if (ret == ROSLZ4_OK) {
+                    chunk->compressed_size = compressed_size;
+                    break;
+                }
+                if (ret != ROSLZ4_OUTPUT_SMALL) {
+                    chunk->error = (format("LZ4 chunk compression failed: %1%") % ret).str();
+                    break;
+                }
+                chunk->compressed.resize(chunk->compressed.size() * 2);
+            }
+        }
+        else {
+            chunk->error = (format("Unsupported compression type for parallel compression: %i") % chunk->compression).str();
+        }
+
+        lock.lock();
+        chunk->done = true;
+        compressed_cv_.notify_all();
+    }
+}
+
+void Bag::writePendingChunks(size_t max_pending) {
+    while (true) {
+        std::shared_ptr<PendingChunk> chunk;
+        {
+            std::unique_lock<std::mutex> lock(compression_mutex_);
+            if (pending_chunks_.empty())
+                return;
+            if (!pending_chunks_.front()->done) {
+                if (pending_chunks_.size() <= max_pending)
+                    return;
+                compressed_cv_.wait(lock, [this]() { return pending_chunks_.front()->done; });
+            }
+            chunk = pending_chunks_.front();
+            pending_chunks_.pop_front();
+        }
+
+        if (!chunk->error.empty())
+            throw BagIOException(chunk->error);
+        writeCompressedChunk(*chunk);
+    }
+}
+
+void Bag::writeCompressedChunk(PendingChunk& chunk) {
+    seek(0, std::ios::end);
+    chunk.info.pos = file_.getOffset();
+
+    writeChunkHeader(chunk.compression, chunk.compressed_size, chunk.data.getSize());
+    write(chunk.compressed.data(), chunk.compressed_size);
+    writeIndexRecords(chunk.indexes);
+    file_size_ = file_.getOffset();
+
+    chunks_.push_back(chunk.info);
+    for (map<uint32_t, multiset<IndexEntry> >::iterator i = chunk.indexes.begin(); i != chunk.indexes.end(); i++) {
+        multiset<IndexEntry>& connection_index = connection_indexes_[i->first];
+        foreach(IndexEntry e, i->second) {
+            e.chunk_pos = chunk.info.pos;
+            connection_index.insert(connection_index.end(), e);
+        }
+    }
+
+    spare_chunk_buffer_.swap(chunk.data);
+}
+
+void Bag::stopCompressionThreads() {
+    {
+        std::lock_guard<std::mutex> lock(compression_mutex_);
+        compression_stop_ = true;
+    }
+    compression_cv_.notify_all();
+    for (size_t i = 0; i < compression_workers_.size(); i++)
+        compression_workers_[i].join();
+    compression_workers_.clear();
+
+    std::lock_guard<std::mutex> lock(compression_mutex_);
+    pending_chunks_.clear();
+    compression_queue_.clear();
+}
+
 void Bag::writeChunkHeader(CompressionType compression, uint32_t compressed_size, uint32_t uncompressed_size) {
     ChunkHeader chunk_header;
     switch (compression) {
@@ -491,8 +668,8 @@ void Bag::readChunkHeader(ChunkHeader& chunk_header) const {
 
 // Index records
 
-void Bag::writeIndexRecords() {
-    for (map<uint32_t, multiset<IndexEntry> >::const_iterator i = curr_chunk_connection_indexes_.begin(); i != curr_chunk_connection_indexes_.end(); i++) {
+void Bag::writeIndexRecords(map<uint32_t, multiset<IndexEntry> > const& indexes) {
+    for (map<uint32_t, multiset<IndexEntry> >::const_iterator i = indexes.begin(); i != indexes.end(); i++) {
         uint32_t                    connection_id = i->first;
         multiset<IndexEntry> const& index         = i->second;
 
@@ -841,6 +1018,43 @@ void Bag::decompressLz4Chunk(ChunkHeader const& chunk_header) const {
     // todo check read was successful
 }
 
+bool Bag::getMessageDataLocation(IndexEntry const& index_entry, uint64_t& offset, uint32_t& size) const {
+    if (version_ != 200)
+        return false;
+
+    if (located_chunk_ != index_entry.chunk_pos) {
+        seek(index_entry.chunk_pos);
+
+        ChunkHeader chunk_header;
+        readChunkHeader(chunk_header);
+
+        located_chunk_data_pos_ = chunk_header.compression == COMPRESSION_NONE ? file_.getOffset() : 0;
+        located_chunk_ = index_entry.chunk_pos;
+    }
+    if (located_chunk_data_pos_ == 0)
+        return false;
+
+    // Skip the connection records that precede the message data record
+    seek(located_chunk_data_pos_ + index_entry.offset);
+    uint8_t op = 0xFF;
+    do {
+        ros::Header header;
+        if (!readHeader(header) || !readDataLength(size))
+            throw BagFormatException("Error reading message record");
+
+        readField(*header.getValues(), OP_FIELD_NAME, true, &op);
+        if (op == OP_MSG_DEF || op == OP_CONNECTION)
+            seek(size, std::ios::cur);
+    }
+    while (op == OP_MSG_DEF || op == OP_CONNECTION);
+
+    if (op != OP_MSG_DATA)
+        throw BagFormatException("Expected MSG_DATA op not found");
+
+    offset = file_.getOffset();
+    return true;
+}
+
 ros::Header Bag::readMessageDataHeader(IndexEntry const& index_entry) {
     ros::Header header;
     uint32_t data_size;
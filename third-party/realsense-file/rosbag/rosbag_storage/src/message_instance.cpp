@@ -62,4 +62,6 @@ uint32_t MessageInstance::size() const {
     return bag_->readMessageDataSize(index_entry_);
 }
 
+IndexEntry const& MessageInstance::getIndexEntry() const { return index_entry_; }
+
 } // namespace rosbag
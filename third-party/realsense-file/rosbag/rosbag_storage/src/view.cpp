@@ -281,9 +281,12 @@ void View::updateQueries(BagQuery* q) {
         multiset<IndexEntry> const& index = j->second;
 
         // lower_bound/upper_bound do a binary search to find the appropriate range of Index Entries given our time range
+        // The members of the multiset are used, std::lower_bound would walk its bidirectional iterators linearly
 
-        std::multiset<IndexEntry>::const_iterator begin = std::lower_bound(index.begin(), index.end(), q->query.getStartTime(), IndexEntryCompare());
-        std::multiset<IndexEntry>::const_iterator end   = std::upper_bound(index.begin(), index.end(), q->query.getEndTime(),   IndexEntryCompare());		
+        IndexEntry start_key = { q->query.getStartTime(), 0, 0 };
+        IndexEntry end_key   = { q->query.getEndTime(), 0, 0 };
+        std::multiset<IndexEntry>::const_iterator begin = index.lower_bound(start_key);
+        std::multiset<IndexEntry>::const_iterator end   = index.upper_bound(end_key);
 
         // Make sure we are at the right beginning
         while (begin != index.begin())
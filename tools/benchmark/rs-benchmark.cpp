@@ -0,0 +1,413 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#include <librealsense2/rs.hpp>
+#include <librealsense2/hpp/rs_internal.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+#include "tclap/CmdLine.h"
+#include "concurrency.h"
+
+using namespace std;
+using namespace TCLAP;
+using namespace rs2;
+
+// Allocations made through the global operator new, which on Linux includes the allocations of the library
+static atomic<unsigned long long> allocations{ 0 };
+
+void* operator new(size_t size)
+{
+    ++allocations;
+    if (auto p = malloc(size ? size : 1))
+        return p;
+    throw bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    free(p);
+}
+
+struct measurement
+{
+    vector<double> durations_ms;
+    unsigned long long allocations = 0;
+    double rate = 0;    // Calls per second of overlapping calls, whose rate does not follow from their durations
+};
+
+double percentile(vector<double> values, double p)
+{
+    if (values.empty())
+        return 0;
+    sort(values.begin(), values.end());
+    auto index = static_cast<size_t>(p * (values.size() - 1) + 0.5);
+    return values[index];
+}
+
+void print_header()
+{
+    cout << left << setw(28) << "Stage" << setw(14) << "Resolution" << right
+         << setw(10) << "Calls" << setw(12) << "FPS"
+         << setw(10) << "p50 ms" << setw(10) << "p90 ms" << setw(10) << "p99 ms"
+         << setw(12) << "Allocs/call" << endl;
+}
+
+// Streamed frames overlap in the pipeline, their rows print no FPS since it would not follow from their latency
+void print_row(const string& stage, const string& resolution, const measurement& m, bool sequential = true)
+{
+    auto total = 0.0;
+    for (auto d : m.durations_ms) total += d;
+    auto calls = m.durations_ms.size();
+
+    cout << left << setw(28) << stage << setw(14) << resolution << right << fixed << setprecision(3)
+         << setw(10) << calls
+         << setw(12) << setprecision(1) << (sequential && total > 0 ? to_string(static_cast<int>(calls * 1000.0 / total))
+                                            : m.rate > 0 ? to_string(static_cast<int>(m.rate)) : "-") << setprecision(3)
+         << setw(10) << percentile(m.durations_ms, 0.5)
+         << setw(10) << percentile(m.durations_ms, 0.9)
+         << setw(10) << percentile(m.durations_ms, 0.99)
+         << setw(12) << setprecision(1) << (calls ? double(m.allocations) / calls : 0.0) << endl;
+}
+
+// Counts of latencies up to each bound, the last bucket holding the longer ones
+void print_histogram(const measurement& m)
+{
+    static const vector<double> bounds_ms = { 0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10, 25, 50 };
+    vector<size_t> counts(bounds_ms.size() + 1);
+    for (auto d : m.durations_ms)
+        counts[lower_bound(bounds_ms.begin(), bounds_ms.end(), d) - bounds_ms.begin()]++;
+
+    for (size_t i = 0; i < counts.size(); i++)
+    {
+        if (!counts[i])
+            continue;
+        auto label = i < bounds_ms.size() ? "<= " + to_string(bounds_ms[i]).substr(0, 4) + " ms" : "> " + to_string(bounds_ms.back()).substr(0, 4) + " ms";
+        auto bar = static_cast<size_t>(50.0 * counts[i] / m.durations_ms.size());
+        cout << "    " << left << setw(12) << label << right << setw(8) << counts[i] << " " << string(bar, '#') << endl;
+    }
+}
+
+// Consecutive points recorded by latency instrumentation, and the full path of a frame from the backend to the application
+struct latency_segment
+{
+    string name;
+    rs2_frame_latency_stage from;
+    rs2_frame_latency_stage to;
+};
+
+static const vector<latency_segment> latency_segments = {
+    { "unpack",       RS2_FRAME_LATENCY_STAGE_BACKEND_ARRIVAL, RS2_FRAME_LATENCY_STAGE_UNPACK_DONE },
+    { "sync",         RS2_FRAME_LATENCY_STAGE_UNPACK_DONE,     RS2_FRAME_LATENCY_STAGE_SYNC_DONE },
+    { "enqueue",      RS2_FRAME_LATENCY_STAGE_SYNC_DONE,       RS2_FRAME_LATENCY_STAGE_QUEUE_ENQUEUE },
+    { "queue wait",   RS2_FRAME_LATENCY_STAGE_QUEUE_ENQUEUE,   RS2_FRAME_LATENCY_STAGE_QUEUE_DEQUEUE },
+    { "end to end",   RS2_FRAME_LATENCY_STAGE_BACKEND_ARRIVAL, RS2_FRAME_LATENCY_STAGE_QUEUE_DEQUEUE },
+};
+
+string resolution_of(const frame& f)
+{
+    if (auto vf = f.as<video_frame>())
+        return to_string(vf.get_width()) + "x" + to_string(vf.get_height());
+    return "-";
+}
+
+// Runs an action on each of the inputs in turn, timing every call
+template<class T>
+measurement run(const vector<T>& inputs, int iterations, function<void(const T&)> action)
+{
+    measurement m;
+    if (inputs.empty())
+        return m;
+
+    // The first call of a block allocates its lookup tables and output profiles
+    action(inputs.front());
+
+    auto allocations_before = allocations.load();
+    for (int i = 0; i < iterations; i++)
+    {
+        auto&& input = inputs[i % inputs.size()];
+        auto start = chrono::high_resolution_clock::now();
+        action(input);
+        auto end = chrono::high_resolution_clock::now();
+        m.durations_ms.push_back(chrono::duration<double, milli>(end - start).count());
+    }
+    m.allocations = allocations.load() - allocations_before;
+    return m;
+}
+
+const unsigned int QUEUE_CAPACITY = 16;                        // Frames queue size of the sensors
+const int QUEUE_SATURATED_ITEMS = 200000;                      // Items sent by every producer as fast as the queue takes them
+const int QUEUE_PACED_ITEMS = 2000;                            // Items sent by every producer at the pace of frames
+const chrono::microseconds QUEUE_PACE(250);
+
+// Producers pass timestamps to one consumer through the queue, which drops the oldest item when full like the frame
+// queues of the library. Saturated producers wait for room in the queue, so that the rate is the one of the queue
+// rather than of its drops, paced producers leave the consumer idle between items, waking it for every item.
+// Measures the time from enqueue to dequeue of the items received
+template<class Q>
+measurement run_queue(int producers, bool paced, unsigned long long& dropped)
+{
+    const int items = paced ? QUEUE_PACED_ITEMS : QUEUE_SATURATED_ITEMS;
+    typedef chrono::steady_clock clock;
+    Q queue(QUEUE_CAPACITY);
+    atomic<int> running{ producers };
+
+    measurement m;
+    m.durations_ms.reserve(static_cast<size_t>(producers) * items);
+
+    auto allocations_before = allocations.load();
+    auto start = clock::now();
+    vector<thread> threads;
+    for (int i = 0; i < producers; i++)
+    {
+        threads.emplace_back([&]()
+        {
+            auto next = clock::now();
+            for (int j = 0; j < items; j++)
+            {
+                if (paced)
+                {
+                    next += QUEUE_PACE;
+                    this_thread::sleep_until(next);
+                }
+                else
+                {
+                    while (queue.size() >= QUEUE_CAPACITY) this_thread::yield();
+                }
+                queue.enqueue(clock::now());
+            }
+            --running;
+        });
+    }
+
+    clock::time_point item;
+    while (true)
+    {
+        if (queue.dequeue(&item, 10))
+            m.durations_ms.push_back(chrono::duration<double, milli>(clock::now() - item).count());
+        else if (!running)
+            break;
+    }
+    auto seconds = chrono::duration<double>(clock::now() - start).count();
+    for (auto&& t : threads) t.join();
+
+    m.allocations = allocations.load() - allocations_before;
+    m.rate = m.durations_ms.size() / seconds;
+    dropped = static_cast<unsigned long long>(producers) * items - m.durations_ms.size();
+    return m;
+}
+
+void compare_queues()
+{
+    typedef chrono::steady_clock::time_point item;
+
+    print_header();
+    for (auto paced : { false, true })
+    {
+        for (auto producers : { 1, 2, 4 })
+        {
+            unsigned long long dropped[2];
+            auto blocking = run_queue<single_consumer_queue<item>>(producers, paced, dropped[0]);
+            auto lock_free = run_queue<lock_free_queue<item>>(producers, paced, dropped[1]);
+
+            // The resolution column holds the mode and the number of producers
+            auto mode = string(paced ? "paced x" : "saturated x") + to_string(producers);
+            print_row("single_consumer_queue", mode, blocking, false);
+            print_row("lock_free_queue", mode, lock_free, false);
+            if (dropped[0] || dropped[1])
+                cout << "    dropped " << dropped[0] << " and " << dropped[1] << " items" << endl;
+        }
+    }
+}
+
+int main(int argc, char** argv) try
+{
+    log_to_console(RS2_LOG_SEVERITY_WARN);
+
+    CmdLine cmd("librealsense rs-benchmark tool", ' ');
+    ValueArg<string> bag_file("f", "file", "Recording (.bag) to play instead of a live device", false, "", "");
+    ValueArg<string> mock_file("m", "mock", "Backend recording to replay through the mock context, frames are unpacked as from a live device", false, "", "");
+    ValueArg<string> record_file("r", "record", "Record the backend calls of the live device to a file the mock context can replay", false, "", "");
+    ValueArg<int>    stream_frames("s", "stream_frames", "Number of framesets to stream for the unpack and sync measurements", false, 300, "");
+    ValueArg<int>    capture_frames("c", "capture_frames", "Number of framesets kept as input of the processing blocks", false, 5, "");
+    ValueArg<int>    iterations("i", "iterations", "Number of calls of every processing block", false, 200, "");
+    SwitchArg        histograms("g", "histograms", "Print the histogram of every latency measured while streaming", false);
+    SwitchArg        queues("q", "queues", "Compare the lock-based and lock-free frame queues of the library, without streaming", false);
+
+    cmd.add(bag_file);
+    cmd.add(mock_file);
+    cmd.add(record_file);
+    cmd.add(stream_frames);
+    cmd.add(capture_frames);
+    cmd.add(iterations);
+    cmd.add(histograms);
+    cmd.add(queues);
+    cmd.parse(argc, argv);
+
+    if (queues.getValue())
+    {
+        compare_queues();
+        return EXIT_SUCCESS;
+    }
+
+    // A backend recording is replayed as fast as the library consumes it, with its frames kept in memory so that
+    // reading the file does not bound the frame rate as the recording cycles
+    context ctx;
+    if (mock_file.isSet())
+        ctx = mock_context(mock_file.getValue(), "", true);
+    else if (record_file.isSet())
+        ctx = recording_context(record_file.getValue(), "", RS2_RECORDING_MODE_COMPRESSED);
+
+    pipeline pipe(ctx);
+    config cfg;
+    if (bag_file.isSet())
+        cfg.enable_device_from_file(bag_file.getValue());
+
+    // Streaming: the library records when every frame passes each stage from the backend to the application
+    enable_latency_instrumentation(true);
+    auto profile = pipe.start(cfg);
+    if (auto pb = profile.get_device().as<playback>())
+        pb.set_real_time(false);
+
+    map<pair<string, rs2_stream>, measurement> latencies;
+    map<rs2_stream, size_t> stream_frame_counts;
+    size_t framesets = 0;
+    vector<frameset> captured;
+    auto streaming_start = chrono::high_resolution_clock::now();
+    for (int i = 0; i < stream_frames.getValue(); i++)
+    {
+        frameset fs;
+        try
+        {
+            fs = pipe.wait_for_frames();
+        }
+        catch (const error&)
+        {
+            break; // End of the recording
+        }
+
+        framesets++;
+        for (auto&& f : fs)
+        {
+            auto stages = f.get_latency_breakdown();
+            auto stream = f.get_profile().stream_type();
+            stream_frame_counts[stream]++;
+            // Stages a frame did not go through are zero, played back frames are not unpacked
+            for (auto&& segment : latency_segments)
+            {
+                if (stages[segment.from] > 0 && stages[segment.to] > 0)
+                    latencies[{ segment.name, stream }].durations_ms.push_back(stages[segment.to] - stages[segment.from]);
+            }
+        }
+
+        // The last framesets are kept, holding more would starve the frame pool of the sensors
+        captured.push_back(fs);
+        if (captured.size() > static_cast<size_t>(capture_frames.getValue()))
+            captured.erase(captured.begin());
+    }
+    auto streaming_seconds = chrono::duration<double>(chrono::high_resolution_clock::now() - streaming_start).count();
+    pipe.stop();
+    enable_latency_instrumentation(false);
+
+    if (captured.empty())
+        throw runtime_error("No frames were received");
+
+    cout << "Streamed " << framesets << " framesets in " << fixed << setprecision(2) << streaming_seconds << " s, "
+         << setprecision(1) << framesets / streaming_seconds << " framesets/s" << endl;
+    for (auto&& count : stream_frame_counts)
+        cout << "    " << left << setw(12) << rs2_stream_to_string(count.first) << right << setw(10) << count.second / streaming_seconds << " frames/s" << endl;
+    cout << endl;
+
+    print_header();
+    for (auto&& segment : latency_segments)
+    {
+        for (auto&& m : latencies)
+        {
+            if (m.first.first != segment.name)
+                continue;
+            print_row(segment.name + " " + rs2_stream_to_string(m.first.second), "-", m.second, false);
+            if (histograms.getValue())
+                print_histogram(m.second);
+        }
+    }
+
+    // Processing blocks run on the captured frames, at their resolution and decimated by 2 and 4
+    vector<frame> depth;
+    vector<frameset> aligned_inputs;
+    for (auto&& fs : captured)
+    {
+        if (auto d = fs.get_depth_frame())
+        {
+            depth.push_back(d);
+            if (fs.get_color_frame())
+                aligned_inputs.push_back(fs);
+        }
+    }
+    if (depth.empty())
+    {
+        cout << "No depth frames were received, the processing blocks are not measured" << endl;
+        return EXIT_SUCCESS;
+    }
+
+    auto n = iterations.getValue();
+    map<int, vector<frame>> scaled;
+    scaled[1] = depth;
+    for (auto magnitude : { 2, 4 })
+    {
+        decimation_filter dec;
+        dec.set_option(RS2_OPTION_FILTER_MAGNITUDE, static_cast<float>(magnitude));
+        print_row("decimation_filter x" + to_string(magnitude), resolution_of(depth.front()),
+            run<frame>(depth, n, [&](const frame& f) { dec.proccess(f); }));
+        for (auto&& f : depth)
+            scaled[magnitude].push_back(dec.proccess(f));
+    }
+
+    for (auto&& inputs : scaled)
+    {
+        auto resolution = resolution_of(inputs.second.front());
+
+        spatial_filter spatial;
+        print_row("spatial_filter", resolution, run<frame>(inputs.second, n, [&](const frame& f) { spatial.proccess(f); }));
+
+        temporal_filter temporal;
+        print_row("temporal_filter", resolution, run<frame>(inputs.second, n, [&](const frame& f) { temporal.proccess(f); }));
+
+        colorizer color_map;
+        print_row("colorizer", resolution, run<frame>(inputs.second, n, [&](const frame& f) { color_map.colorize(f); }));
+
+        pointcloud pc;
+        print_row("pointcloud", resolution, run<frame>(inputs.second, n, [&](const frame& f) { pc.calculate(f); }));
+    }
+
+    if (!aligned_inputs.empty())
+    {
+        auto resolution = resolution_of(aligned_inputs.front().get_depth_frame());
+
+        rs2::align align_to_color(RS2_STREAM_COLOR);
+        print_row("align to color", resolution, run<frameset>(aligned_inputs, n, [&](const frameset& fs) { align_to_color.proccess(fs); }));
+
+        rs2::align align_to_depth(RS2_STREAM_DEPTH);
+        print_row("align to depth", resolution, run<frameset>(aligned_inputs, n, [&](const frameset& fs) { align_to_depth.proccess(fs); }));
+    }
+
+    return EXIT_SUCCESS;
+}
+catch (const error & e)
+{
+    cerr << "RealSense error calling " << e.get_failed_function() << "(" << e.get_failed_args() << "):\n    " << e.what() << endl;
+    return EXIT_FAILURE;
+}
+catch (const exception & e)
+{
+    cerr << e.what() << endl;
+    return EXIT_FAILURE;
+}
@@ -13,6 +13,10 @@
 #include <cctype>
 #include <thread>
 #include <array>
+#include <deque>
+#include <mutex>
+#include <memory>
+#include <iomanip>
 
 using namespace std;
 using namespace TCLAP;
@@ -123,28 +127,108 @@ void configure_stream(rs2::config& cfg, std::string filename)
     }
 }
 
-void save_data_to_file(std::array<list<frame_data>, NUM_OF_STREAMS> buffer, const string& filename)
+// Writes frame data to a csv file as it is collected, on a thread of its own
+// Records are gathered in slabs of a fixed size, allocated up front, that are passed to the writer once full,
+// so a collection of any length takes the same memory and the collecting thread only synchronizes once per slab
+class frame_data_writer
 {
-    // Save to file
-    ofstream csv;
-    csv.open(filename);
-    csv << "Stream Type,F#,Timestamp,Arrival Time\n";
+public:
+    frame_data_writer(const string& filename, size_t slab_size = 4096, size_t slabs = 8)
+        : _slab_size(slab_size), _alive(true)
+    {
+        _csv.open(filename);
+        if (!_csv.is_open())
+            throw runtime_error("Failed to open " + filename);
+        _csv << "Stream Type,F#,Timestamp,Arrival Time\n";
+
+        for (size_t i = 0; i < slabs; i++)
+        {
+            _free.emplace_back();
+            _free.back().reserve(slab_size);
+        }
+        _current = take_free_slab();
+        _writer = thread([this]() { write_slabs(); });
+    }
 
-    for (int stream_index = 0; stream_index < NUM_OF_STREAMS; stream_index++)
+    ~frame_data_writer()
     {
-        auto buffer_size = buffer[stream_index].size();
-        for (auto i = 0; i < buffer_size; i++)
         {
-            ostringstream line;
-            auto data = buffer[stream_index].front();
-            line << rs2_stream_to_string(data.stream_type) << "," << data.frame_number << "," << std::fixed << std::setprecision(3) << data.ts << "," << data.arrival_time << "\n";
-            buffer[stream_index].pop_front();
-            csv << line.str();
+            lock_guard<mutex> lock(_mutex);
+            _full.push_back(std::move(_current));
+            _alive = false;
         }
+        _cv.notify_all();
+        _writer.join();
     }
 
-    csv.close();
-}
+    void add(const frame_data& data)
+    {
+        _current.push_back(data);
+        if (_current.size() == _slab_size)
+        {
+            {
+                lock_guard<mutex> lock(_mutex);
+                _full.push_back(std::move(_current));
+            }
+            _cv.notify_all();
+            _current = take_free_slab();
+        }
+    }
+
+private:
+    // Waits for the writer to return a slab when all are full, which keeps memory bounded when the disk falls behind
+    vector<frame_data> take_free_slab()
+    {
+        unique_lock<mutex> lock(_mutex);
+        _cv.wait(lock, [this]() { return !_free.empty(); });
+        auto slab = std::move(_free.front());
+        _free.pop_front();
+        return slab;
+    }
+
+    void write_slabs()
+    {
+        ostringstream lines;
+        lines << std::fixed << std::setprecision(3);
+        while (true)
+        {
+            vector<frame_data> slab;
+            {
+                unique_lock<mutex> lock(_mutex);
+                _cv.wait(lock, [this]() { return !_alive || !_full.empty(); });
+                if (_full.empty())
+                    break;
+                slab = std::move(_full.front());
+                _full.pop_front();
+            }
+
+            lines.str("");
+            for (auto&& data : slab)
+                lines << rs2_stream_to_string(data.stream_type) << "," << data.frame_number << "," << data.ts << "," << data.arrival_time << "\n";
+            _csv << lines.str();
+
+            slab.clear();
+            {
+                lock_guard<mutex> lock(_mutex);
+                _free.push_back(std::move(slab));
+            }
+            _cv.notify_all();
+        }
+        _csv.close();
+    }
+
+    size_t _slab_size;
+    vector<frame_data> _current;    // Filled by the collecting thread, without locking
+
+    mutex _mutex;                   // Guards the members below
+    condition_variable _cv;
+    deque<vector<frame_data>> _free;
+    deque<vector<frame_data>> _full;
+    bool _alive;
+
+    ofstream _csv;
+    thread _writer;
+};
 
 int main(int argc, char** argv) try
 {
@@ -156,11 +240,13 @@ int main(int argc, char** argv) try
     ValueArg<int>    max_frames("m", "MaxFrames_Number", "Maximun number of frames data to receive", false, 100, "");
     ValueArg<string> filename("f", "FullFilePath", "the file which the data will be saved to", false, "", "");
     ValueArg<string> config_file("c", "ConfigurationFile", "Specify file path with the requested configuration", false, "", "");
+    ValueArg<string> trace_file("r", "TraceFile", "Record a trace of the frame lifecycles while collecting, for libraries built with tracing", false, "", "");
 
     cmd.add(timeout);
     cmd.add(max_frames);
     cmd.add(filename);
     cmd.add(config_file);
+    cmd.add(trace_file);
     cmd.parse(argc, argv);
 
     std::string output_file = filename.isSet() ? filename.getValue() : "frames_data.csv";
@@ -183,6 +269,7 @@ int main(int argc, char** argv) try
 
         rs2::pipeline_profile profile = pipe.start(config);
         auto dev = profile.get_device();
+        if (trace_file.isSet()) rs2::start_trace();
 
         std::atomic_bool need_to_reset(false);
         for (auto sub : dev.query_sensors())
@@ -196,7 +283,8 @@ int main(int argc, char** argv) try
             });
         }
 
-        std::array<std::list<frame_data>, NUM_OF_STREAMS> buffer;
+        std::array<unsigned long long, NUM_OF_STREAMS> collected{};
+        std::unique_ptr<frame_data_writer> writer(new frame_data_writer(output_file));
         auto start_time = chrono::high_resolution_clock::now();
         const auto ready = [&]()
         {
@@ -214,7 +302,7 @@ int main(int argc, char** argv) try
             bool collected_enough_frames = true;
             for (auto&& profile : pipe.get_active_profile().get_streams())
             {
-                if (buffer[(int)profile.stream_type()].size() < max_frames_number)
+                if (collected[(int)profile.stream_type()] < max_frames_number)
                 {
                     collected_enough_frames = false;
                 }
@@ -239,9 +327,10 @@ int main(int argc, char** argv) try
                                 arrival_time.count(),
                                 f.get_frame_timestamp_domain(),
                                 f.get_profile().stream_type()};
-                if (buffer[(int)data.stream_type].size() < max_frames_number)
+                if (collected[(int)data.stream_type] < max_frames_number)
                 {
-                    buffer[(int)data.stream_type].push_back(data);
+                    collected[(int)data.stream_type]++;
+                    writer->add(data);
                 }
             }
 
@@ -255,7 +344,9 @@ int main(int argc, char** argv) try
 
         if(ready())
         {
-            save_data_to_file(buffer, output_file);
+            // Flushes the remaining data and closes the file
+            writer.reset();
+            if (trace_file.isSet()) rs2::stop_trace(trace_file.getValue());
             pipe.stop();
             succeed = true;
         }
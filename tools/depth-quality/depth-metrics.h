@@ -7,6 +7,7 @@
 #include <vector>
 #include <mutex>
 #include <array>
+#include <thread>
 #include <imgui.h>
 #include <librealsense2/rsutil.h>
 #include <librealsense2/rs.hpp>
@@ -47,25 +48,46 @@ namespace rs2
             return{ normal.x, normal.y, normal.z, -(normal.x*point.x + normal.y*point.y + normal.z*point.z) };
         }
 
-        inline plane plane_from_points(const std::vector<rs2::float3> points)
+        // Sums of the coordinates of points and of their products, all that a plane fit needs to know of the points
+        // These are accumulated as the points are computed, and the sums of separate sets of points add up
+        struct plane_fit_sums
         {
-            if (points.size() < 3) throw std::runtime_error("Not enough points to calculate plane");
-
-            rs2::float3 sum = { 0,0,0 };
-            for (auto point : points) sum = sum + point;
+            size_t count = 0;
+            double x = 0, y = 0, z = 0;
+            double xx = 0, xy = 0, xz = 0, yy = 0, yz = 0, zz = 0;
 
-            rs2::float3 centroid = sum / float(points.size());
+            void add(const rs2::float3& p)
+            {
+                count++;
+                x += p.x; y += p.y; z += p.z;
+                xx += p.x * p.x; xy += p.x * p.y; xz += p.x * p.z;
+                yy += p.y * p.y; yz += p.y * p.z; zz += p.z * p.z;
+            }
 
-            double xx = 0, xy = 0, xz = 0, yy = 0, yz = 0, zz = 0;
-            for (auto point : points) {
-                rs2::float3 temp = point - centroid;
-                xx += temp.x * temp.x;
-                xy += temp.x * temp.y;
-                xz += temp.x * temp.z;
-                yy += temp.y * temp.y;
-                yz += temp.y * temp.z;
-                zz += temp.z * temp.z;
+            plane_fit_sums& operator+=(const plane_fit_sums& o)
+            {
+                count += o.count;
+                x += o.x; y += o.y; z += o.z;
+                xx += o.xx; xy += o.xy; xz += o.xz;
+                yy += o.yy; yz += o.yz; zz += o.zz;
+                return *this;
             }
+        };
+
+        inline plane plane_from_sums(const plane_fit_sums& s)
+        {
+            if (s.count < 3) throw std::runtime_error("Not enough points to calculate plane");
+
+            const double n = double(s.count);
+            rs2::float3 centroid = { float(s.x / n), float(s.y / n), float(s.z / n) };
+
+            // Sums of the products of the coordinates relative to the centroid
+            double xx = s.xx - s.x * s.x / n;
+            double xy = s.xy - s.x * s.y / n;
+            double xz = s.xz - s.x * s.z / n;
+            double yy = s.yy - s.y * s.y / n;
+            double yz = s.yz - s.y * s.z / n;
+            double zz = s.zz - s.z * s.z / n;
 
             double det_x = yy*zz - yz*yz;
             double det_y = xx*zz - xz*xz;
@@ -97,6 +119,13 @@ namespace rs2
             return plane_from_point_and_normal(centroid, dir.normalize());
         }
 
+        inline plane plane_from_points(const std::vector<rs2::float3>& points)
+        {
+            plane_fit_sums sums;
+            for (auto&& point : points) sums.add(point);
+            return plane_from_sums(sums);
+        }
+
         inline double evaluate_pixel(const plane& p, const rs2_intrinsics* intrin, float x, float y, float distance, float3& output)
         {
             float pixel[2] = { x, y };
@@ -138,35 +167,71 @@ namespace rs2
 
             snapshot_metrics result{ w, h, roi, {} };
 
-            std::mutex m;
-
-            std::vector<rs2::float3> roi_pixels;
-
-//#pragma omp parallel for - TODO optimization envisaged
-            for (int y = roi.min_y; y < roi.max_y; ++y)
-                for (int x = roi.min_x; x < roi.max_x; ++x)
+            // Without distortion to undo, a point is its depth times the ray of its pixel, and the rays of a row
+            // differ only by their column, so these are computed once
+            const bool undistorted = intrin->model != RS2_DISTORTION_INVERSE_BROWN_CONRADY;
+            std::vector<float> column_rays(std::max(roi.max_x - roi.min_x, 0));
+            for (int x = roi.min_x; x < roi.max_x; ++x)
+                column_rays[x - roi.min_x] = (x - intrin->ppx) / intrin->fx;
+
+            // Bands of rows are deprojected by threads of their own, each summing up its points for the plane fit
+            // The points of the bands are joined in the order of the rows
+            const int rows = std::max(roi.max_y - roi.min_y, 0);
+            const int min_band_rows = 32;
+            const int bands = std::max(1, std::min<int>(std::thread::hardware_concurrency(), rows / min_band_rows));
+            std::vector<std::vector<rs2::float3>> band_points(bands);
+            std::vector<plane_fit_sums> band_sums(bands);
+
+            auto deproject_band = [&](int band)
+            {
+                auto&& points = band_points[band];
+                auto&& sums = band_sums[band];
+                points.reserve(column_rays.size() * (rows / bands + 1));
+                for (int y = roi.min_y + rows * band / bands; y < roi.min_y + rows * (band + 1) / bands; ++y)
                 {
-                    auto depth_raw = pixels[y*w + x];
-
-                    if (depth_raw)
+                    auto row = pixels + y*w;
+                    const float row_ray = (y - intrin->ppy) / intrin->fy;
+                    for (int x = roi.min_x; x < roi.max_x; ++x)
                     {
-                        // units is float
-                        float pixel[2] = { float(x), float(y) };
-                        float point[3];
-                        auto distance = depth_raw * units;
-
-                        rs2_deproject_pixel_to_point(point, intrin, pixel, distance);
+                        auto depth_raw = row[x];
+                        if (!depth_raw) continue;
 
-                        std::lock_guard<std::mutex> lock(m);
-                        roi_pixels.push_back({ point[0], point[1], point[2] });
+                        auto distance = depth_raw * units;
+                        rs2::float3 point;
+                        if (undistorted)
+                        {
+                            point = { distance * column_rays[x - roi.min_x], distance * row_ray, distance };
+                        }
+                        else
+                        {
+                            float pixel[2] = { float(x), float(y) };
+                            rs2_deproject_pixel_to_point(&point.x, intrin, pixel, distance);
+                        }
+                        points.push_back(point);
+                        sums.add(point);
                     }
                 }
+            };
 
-            if (roi_pixels.size() < 3) { // Not enough pixels in RoI to fit a plane
+            std::vector<std::thread> threads;
+            for (int band = 1; band < bands; ++band)
+                threads.emplace_back(deproject_band, band);
+            deproject_band(0);
+            for (auto&& t : threads) t.join();
+
+            plane_fit_sums sums;
+            for (auto&& s : band_sums) sums += s;
+
+            if (sums.count < 3) { // Not enough pixels in RoI to fit a plane
                 return result;
             }
 
-            plane p = plane_from_points(roi_pixels);
+            std::vector<rs2::float3> roi_pixels = std::move(band_points[0]);
+            roi_pixels.reserve(sums.count);
+            for (int band = 1; band < bands; ++band)
+                roi_pixels.insert(roi_pixels.end(), band_points[band].begin(), band_points[band].end());
+
+            plane p = plane_from_sums(sums);
 
             if (p == plane{ 0, 0, 0, 0 }) { // The points in RoI don't span a valid plane
                 return result;
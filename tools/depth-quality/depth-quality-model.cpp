@@ -831,7 +831,7 @@ namespace rs2
 
                         std::string stream_desc = rs2_stream_to_string(frame.get_profile().stream_type());
                         std::string filename = filename_base + "_" + stream_desc + ".png";
-                        save_to_png(filename.data(), frame.get_width(), frame.get_height(), frame.get_bytes_per_pixel(), frame.get_data(), frame.get_width() * frame.get_bytes_per_pixel());
+                        _viewer_model.snapshots.save(frame, filename);
 
                         _viewer_model.not_model.add_notification({ to_string() << stream_desc << " snapshot was saved to " << filename,
                             0, RS2_LOG_SEVERITY_INFO,
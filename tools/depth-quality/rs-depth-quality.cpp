@@ -98,9 +98,12 @@ int main(int argc, const char * argv[]) try
         if (ground_truth_mm) gt_errors.reserve(points.size());
 
         // Remove outliers [below 0.5% and above 99.5%)
-        std::sort(points_set.begin(), points_set.end(), [](const rs2::float3& a, const rs2::float3& b) { return a.z < b.z; });
+        // Only the outliers need to be told apart from the rest, so the points are partitioned rather than sorted
+        auto by_depth = [](const rs2::float3& a, const rs2::float3& b) { return a.z < b.z; };
         size_t outliers = points_set.size() / 200;
+        std::nth_element(points_set.begin(), points_set.begin() + outliers, points_set.end(), by_depth);
         points_set.erase(points_set.begin(), points_set.begin() + outliers); // crop min 0.5% of the dataset
+        std::nth_element(points_set.begin(), points_set.end() - outliers, points_set.end(), by_depth);
         points_set.resize(points_set.size() - outliers); // crop max 0.5% of the dataset
 
         // Convert Z values into Depth values by aligning the Fitted plane with the Ground Truth (GT) plane
@@ -125,7 +128,7 @@ int main(int argc, const char * argv[]) try
         z_accuracy->enable(ground_truth_mm > 0);
         if (ground_truth_mm)
         {
-            std::sort(begin(gt_errors), end(gt_errors));
+            std::nth_element(begin(gt_errors), begin(gt_errors) + gt_errors.size() / 2, end(gt_errors));
             auto gt_median = gt_errors[gt_errors.size() / 2];
             auto accuracy = TO_PERCENT * (gt_median / ground_truth_mm);
             z_accuracy->add_value(accuracy);
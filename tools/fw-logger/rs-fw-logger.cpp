@@ -78,12 +78,9 @@ int main(int argc, char* argv[])
             auto dev = hub.wait_for_device();
             cout << "RealSense device was connected...\n";
 
-            vector<uint8_t> input;
-            auto str_op_code = dev.get_info(RS2_CAMERA_INFO_DEBUG_OP_CODE);
-            auto op_code = static_cast<uint8_t>(stoi(str_op_code));
-            input = {0x14, 0x00, 0xab, 0xcd, op_code, 0x00, 0x00, 0x00,
-                     0xf4, 0x01, 0x00, 0x00, 0x00,    0x00, 0x00, 0x00,
-                     0x00, 0x00, 0x00, 0x00, 0x00,    0x00, 0x00, 0x00};
+            // The library reads the logs in the background, so none are lost while this thread parses and prints
+            auto debug = dev.as<debug_protocol>();
+            debug.start_fw_log_capture();
 
             cout << "Device Name: " << dev.get_info(RS2_CAMERA_INFO_NAME) << endl <<
                     "Device Location: " << dev.get_info(RS2_CAMERA_INFO_PHYSICAL_PORT) << endl << endl;
@@ -92,17 +89,14 @@ int main(int argc, char* argv[])
 
             while (hub.is_connected(dev))
             {
-                this_thread::sleep_for(chrono::milliseconds(100));
-
-                auto raw_data = dev.as<debug_protocol>().send_and_receive_raw_data(input);
+                auto raw_data = debug.fetch_fw_logs(100, 100);
                 vector<string> fw_log_lines = {""};
-                if (raw_data.size() <= 4)
+                if (raw_data.empty())
                     continue;
 
                 if (use_xml_file)
                 {
                     fw_logs_binary_data fw_logs_binary_data = {raw_data};
-                    fw_logs_binary_data.logs_buffer.erase(fw_logs_binary_data.logs_buffer.begin(),fw_logs_binary_data.logs_buffer.begin()+4);
                     fw_log_lines = fw_log_parser->get_fw_log_lines(fw_logs_binary_data);
                     for (auto& elem : fw_log_lines)
                         elem = datetime_string() + "  " + elem;
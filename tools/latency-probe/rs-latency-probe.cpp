@@ -0,0 +1,127 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#include <librealsense2/rs.hpp>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include "tclap/CmdLine.h"
+
+using namespace std;
+using namespace TCLAP;
+
+rs2_time_t get_library_time()
+{
+    rs2_error* e = nullptr;
+    auto time = rs2_get_time(&e);
+    rs2::error::handle(e);
+    return time;
+}
+
+void print_device(const rs2::device& dev)
+{
+    auto info = [&](rs2_camera_info i) { return dev.supports(i) ? string(dev.get_info(i)) : string("-"); };
+    cout << "Library " << RS2_API_VERSION_STR << ", " << info(RS2_CAMERA_INFO_NAME)
+         << ", firmware " << info(RS2_CAMERA_INFO_FIRMWARE_VERSION) << endl << endl;
+}
+
+void print_stats(const rs2::latency_probe& probe, const rs2::pipeline_profile& profile)
+{
+    cout << left << setw(14) << "Stream" << setw(24) << "Latency" << right << setw(8) << "Frames"
+         << setw(9) << "mean ms" << setw(9) << "min ms" << setw(9) << "p50 ms"
+         << setw(9) << "p90 ms" << setw(9) << "p99 ms" << setw(9) << "max ms" << endl;
+    cout << fixed << setprecision(2);
+    for (auto&& stream : profile.get_streams())
+    {
+        for (int i = 0; i < RS2_LATENCY_MEASURE_COUNT; i++)
+        {
+            auto measure = static_cast<rs2_latency_measure>(i);
+            auto stats = probe.get_stats(stream.stream_type(), stream.stream_index(), measure);
+            if (!stats.count) continue;
+            cout << left << setw(14) << stream.stream_name() << setw(24) << measure << right << setw(8) << stats.count
+                 << setw(9) << stats.mean << setw(9) << stats.min << setw(9) << stats.p50
+                 << setw(9) << stats.p90 << setw(9) << stats.p99 << setw(9) << stats.max << endl;
+        }
+    }
+}
+
+int main(int argc, char** argv) try
+{
+    CmdLine cmd("librealsense rs-latency-probe tool", ' ', RS2_API_VERSION_STR);
+    ValueArg<int> duration("t", "time", "Seconds to measure for", false, 10, "seconds");
+    SwitchArg blink("b", "blink", "Blink the emitter and measure how long the infrared stream takes to see it");
+    cmd.add(duration);
+    cmd.add(blink);
+    cmd.parse(argc, argv);
+
+    // The probe turns latency instrumentation on, so it is created before the streams start
+    rs2::latency_probe probe;
+
+    rs2::pipeline pipe;
+    rs2::config cfg;
+    if (blink.getValue())
+    {
+        cfg.enable_stream(RS2_STREAM_DEPTH);
+        cfg.enable_stream(RS2_STREAM_COLOR);
+        cfg.enable_stream(RS2_STREAM_INFRARED, 1);
+    }
+    auto profile = pipe.start(cfg);
+    auto dev = profile.get_device();
+    print_device(dev);
+
+    // Exposure latencies are measured for the frames mapped to the host clock
+    for (auto&& sensor : dev.query_sensors())
+    {
+        if (sensor.supports(RS2_OPTION_GLOBAL_TIME_ENABLED))
+            sensor.set_option(RS2_OPTION_GLOBAL_TIME_ENABLED, 1.f);
+    }
+
+    atomic<bool> running{ true };
+    thread blinker;
+    if (blink.getValue())
+    {
+        auto depth = dev.first<rs2::depth_sensor>();
+        if (!depth.supports(RS2_OPTION_EMITTER_ENABLED))
+            throw runtime_error("The device has no emitter to blink");
+
+        // The stimulus is marked when the emitter is asked to turn on, so the latencies include the control transfer
+        blinker = thread([&, depth]() mutable
+        {
+            while (running)
+            {
+                depth.set_option(RS2_OPTION_EMITTER_ENABLED, 0.f);
+                this_thread::sleep_for(chrono::milliseconds(500));
+                probe.mark_stimulus(get_library_time());
+                depth.set_option(RS2_OPTION_EMITTER_ENABLED, 1.f);
+                this_thread::sleep_for(chrono::milliseconds(500));
+            }
+        });
+    }
+
+    cout << "Measuring for " << duration.getValue() << " seconds" << endl << endl;
+    auto end = chrono::steady_clock::now() + chrono::seconds(duration.getValue());
+    while (chrono::steady_clock::now() < end)
+    {
+        probe.add(pipe.wait_for_frames());
+    }
+
+    running = false;
+    if (blinker.joinable()) blinker.join();
+    pipe.stop();
+
+    print_stats(probe, profile);
+    return EXIT_SUCCESS;
+}
+catch (const rs2::error& e)
+{
+    cerr << "RealSense error calling " << e.get_failed_function() << "(" << e.get_failed_args() << "):\n    " << e.what() << endl;
+    return EXIT_FAILURE;
+}
+catch (const exception& e)
+{
+    cerr << e.what() << endl;
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,154 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#include <librealsense2/rs.hpp>
+#include <atomic>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include "tclap/CmdLine.h"
+
+#ifdef _WIN32
+#include <winsock2.h>
+typedef SOCKET socket_handle;
+#define close_socket closesocket
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+typedef int socket_handle;
+#define INVALID_SOCKET (-1)
+#define close_socket close
+#endif
+
+using namespace std;
+using namespace TCLAP;
+
+static atomic<bool> running{ true };
+
+void on_signal(int) { running = false; }
+
+void send_all(socket_handle client, const string& data)
+{
+    size_t sent = 0;
+    while (sent < data.size())
+    {
+        auto n = send(client, data.data() + sent, static_cast<int>(data.size() - sent), 0);
+        if (n <= 0) return;
+        sent += n;
+    }
+}
+
+// Answers a single request of the client and closes the connection, which is what Prometheus expects of an exporter
+void serve(socket_handle client)
+{
+    char buffer[1024];
+    auto n = recv(client, buffer, sizeof(buffer) - 1, 0);
+    if (n <= 0) return;
+    buffer[n] = 0;
+
+    string request(buffer);
+    string status = "404 Not Found", content_type = "text/plain", body = "Metrics are served at /metrics\n";
+    if (request.compare(0, 13, "GET /metrics ") == 0 || request.compare(0, 13, "GET /metrics?") == 0)
+    {
+        status = "200 OK";
+        content_type = "text/plain; version=0.0.4";
+        body = rs2::metrics_snapshot().to_text();
+    }
+
+    stringstream response;
+    response << "HTTP/1.0 " << status << "\r\n"
+             << "Content-Type: " << content_type << "\r\n"
+             << "Content-Length: " << body.size() << "\r\n"
+             << "Connection: close\r\n\r\n"
+             << body;
+    send_all(client, response.str());
+}
+
+int main(int argc, char** argv) try
+{
+    CmdLine cmd("librealsense rs-metrics-exporter tool", ' ', RS2_API_VERSION_STR);
+    ValueArg<int> port("p", "port", "Port to serve the metrics on", false, 9464, "port");
+    ValueArg<string> file("f", "file", "Recording (.bag) to play instead of a live device", false, "", "file");
+    cmd.add(port);
+    cmd.add(file);
+    cmd.parse(argc, argv);
+
+    // Metrics are kept only for the sensors and blocks set up once enabled, so before the pipeline starts
+    rs2::enable_metrics();
+
+    rs2::pipeline pipe;
+    rs2::config cfg;
+    if (file.isSet()) cfg.enable_device_from_file(file.getValue());
+    pipe.start(cfg);
+
+    // The frames are only consumed, so the metrics show the library running at its own pace
+    thread consumer([&]()
+    {
+        while (running)
+        {
+            // Timeouts are expected, as when the device is unplugged, the metrics are served regardless
+            try { pipe.wait_for_frames(1000); }
+            catch (const rs2::error&) {}
+        }
+    });
+
+#ifdef _WIN32
+    WSADATA wsa;
+    WSAStartup(MAKEWORD(2, 2), &wsa);
+#endif
+    auto server = socket(AF_INET, SOCK_STREAM, 0);
+    if (server == INVALID_SOCKET) throw runtime_error("Failed to create a socket");
+    int reuse = 1;
+    setsockopt(server, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(static_cast<uint16_t>(port.getValue()));
+    if (::bind(server, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(server, 8) != 0)
+    {
+        close_socket(server);
+        throw runtime_error("Failed to listen on port " + to_string(port.getValue()));
+    }
+
+    signal(SIGINT, on_signal);
+    cout << "Serving metrics at http://localhost:" << port.getValue() << "/metrics, press Ctrl+C to stop" << endl;
+    while (running)
+    {
+        // Waits with a timeout, so the tool notices it was interrupted
+        fd_set set;
+        FD_ZERO(&set);
+        FD_SET(server, &set);
+        timeval timeout{ 1, 0 };
+        if (select(static_cast<int>(server) + 1, &set, nullptr, nullptr, &timeout) <= 0) continue;
+
+        auto client = accept(server, nullptr, nullptr);
+        if (client == INVALID_SOCKET) continue;
+        serve(client);
+        close_socket(client);
+    }
+
+    close_socket(server);
+#ifdef _WIN32
+    WSACleanup();
+#endif
+    consumer.join();
+    pipe.stop();
+    return EXIT_SUCCESS;
+}
+catch (const rs2::error & e)
+{
+    cerr << "RealSense error calling " << e.get_failed_function() << "(" << e.get_failed_args() << "):\n    " << e.what() << endl;
+    return EXIT_FAILURE;
+}
+catch (const exception& e)
+{
+    cerr << e.what() << endl;
+    return EXIT_FAILURE;
+}
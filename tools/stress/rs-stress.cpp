@@ -0,0 +1,773 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+#include <librealsense2/rs.hpp>
+#include <librealsense2/hpp/rs_internal.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "tclap/CmdLine.h"
+
+#ifdef __linux__
+#include <dirent.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+using namespace TCLAP;
+using namespace rs2;
+
+static atomic<bool> running{ true };
+
+void on_signal(int) { running = false; }
+
+double now_ms()
+{
+    return chrono::duration<double, milli>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Latencies counted in logarithmic buckets 5% apart, from 10us to over 100s, so hours of frames take constant memory
+class latency_histogram
+{
+public:
+    latency_histogram() : _counts(bucket_count, 0), _total(0) {}
+
+    void add(double ms)
+    {
+        int bucket = ms <= min_ms ? 0 : static_cast<int>(log(ms / min_ms) / log(growth)) + 1;
+        _counts[min(bucket, bucket_count - 1)]++;
+        _total++;
+    }
+
+    void add(const latency_histogram& other)
+    {
+        for (int i = 0; i < bucket_count; i++) _counts[i] += other._counts[i];
+        _total += other._total;
+    }
+
+    // Upper bound of the bucket holding the percentile, or zero without samples
+    double percentile(double p) const
+    {
+        if (!_total) return 0;
+        auto rank = static_cast<unsigned long long>(ceil(p * _total));
+        unsigned long long seen = 0;
+        for (int i = 0; i < bucket_count; i++)
+        {
+            seen += _counts[i];
+            if (seen >= rank && seen) return min_ms * pow(growth, i);
+        }
+        return min_ms * pow(growth, bucket_count - 1);
+    }
+
+private:
+    static const int bucket_count = 340;
+    static constexpr double min_ms = 0.01;
+    static constexpr double growth = 1.05;
+
+    vector<unsigned long long> _counts;
+    unsigned long long _total;
+};
+
+struct stream_stats
+{
+    unsigned long long frames = 0;
+    unsigned long long gaps = 0;        // Frames missing from the sequence of frame numbers
+    unsigned long long drops = 0;       // Frames the library reported dropping
+    latency_histogram latency;
+
+    void add(const stream_stats& other)
+    {
+        frames += other.frames;
+        gaps += other.gaps;
+        drops += other.drops;
+        latency.add(other.latency);
+    }
+};
+
+// A block of the processing chain, applied to the frameset of every wait in turn
+typedef function<frameset(frameset)> processing_step;
+
+// Frames of a set with the frame of the same stream replaced, the others kept as they were
+frameset replace(frameset fs, const frame& f, const frame_source& source)
+{
+    auto type = f.get_profile().stream_type();
+    auto index = f.get_profile().stream_index();
+    vector<frame> frames;
+    for (auto&& member : fs)
+        frames.push_back(member.get_profile().stream_type() == type && member.get_profile().stream_index() == index ? f : member);
+    return source.allocate_composite_frame(move(frames));
+}
+
+// Wraps a block taking single frames so that it filters the depth frame of the framesets
+template<class FILTER>
+processing_step depth_step()
+{
+    auto filter = make_shared<FILTER>();
+    // A block of the tool rebuilds the set around the filtered depth, as framesets are immutable
+    auto compose = make_shared<processing_block>([filter](frame f, const frame_source& source)
+    {
+        auto fs = f.as<frameset>();
+        auto filtered = filter->proccess(fs.get_depth_frame());
+        source.frame_ready(filtered ? frame(replace(fs, filtered, source)) : f);
+    });
+    auto output = make_shared<frame_queue>(1);
+    compose->start(*output);
+
+    return [compose, output](frameset fs) -> frameset
+    {
+        if (!fs.get_depth_frame()) return fs;
+        compose->invoke(fs);
+        frame out;
+        return output->poll_for_frame(&out) ? out.as<frameset>() : fs;
+    };
+}
+
+processing_step make_step(const string& name)
+{
+    if (name == "decimation") return depth_step<decimation_filter>();
+    if (name == "spatial") return depth_step<spatial_filter>();
+    if (name == "temporal") return depth_step<temporal_filter>();
+    if (name == "hole_filling") return depth_step<hole_filling_filter>();
+    if (name == "threshold") return depth_step<threshold_crop_filter>();
+    if (name == "change")
+    {
+        auto detector = make_shared<change_detector>();
+        return [detector](frameset fs) -> frameset
+        {
+            auto f = detector->proccess(fs);
+            return f ? f.as<frameset>() : fs;
+        };
+    }
+    if (name == "align")
+    {
+        auto aligner = make_shared<rs2::align>(RS2_STREAM_COLOR);
+        return [aligner](frameset fs) { return aligner->proccess(fs); };
+    }
+    // The last two keep their output alive only until the next frame, which is what a consumer would do
+    if (name == "colorizer")
+    {
+        auto color_map = make_shared<colorizer>();
+        auto last = make_shared<frame>();
+        return [color_map, last](frameset fs) -> frameset
+        {
+            if (auto depth = fs.get_depth_frame()) *last = color_map->colorize(depth);
+            return fs;
+        };
+    }
+    if (name == "pointcloud")
+    {
+        auto pc = make_shared<pointcloud>();
+        auto last = make_shared<frame>();
+        return [pc, last](frameset fs) -> frameset
+        {
+            if (auto depth = fs.get_depth_frame()) *last = pc->calculate(depth);
+            return fs;
+        };
+    }
+    throw invalid_argument("Unknown processing block " + name + ", expected decimation, spatial, temporal, hole_filling, threshold, change, align, colorizer or pointcloud");
+}
+
+struct profile_request
+{
+    rs2_stream stream;
+    int width, height, fps;
+    rs2_format format;
+};
+
+template<class T>
+bool parse_enum(const string& text, T count, const char*(*to_string)(T), T& value)
+{
+    for (int i = 0; i < static_cast<int>(count); i++)
+    {
+        string name = to_string(static_cast<T>(i));
+        string lower(name);
+        transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+        if (text == name || text == lower)
+        {
+            value = static_cast<T>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+// "stream,width,height,fps,format", for example "depth,640,480,30,z16"
+profile_request parse_profile(const string& text)
+{
+    vector<string> fields;
+    stringstream ss(text);
+    string field;
+    while (getline(ss, field, ',')) fields.push_back(field);
+
+    profile_request r;
+    if (fields.size() != 5 || !parse_enum(fields[0], RS2_STREAM_COUNT, rs2_stream_to_string, r.stream) ||
+        !parse_enum(fields[4], RS2_FORMAT_COUNT, rs2_format_to_string, r.format))
+        throw invalid_argument("Invalid profile " + text + ", expected stream,width,height,fps,format");
+    r.width = stoi(fields[1]);
+    r.height = stoi(fields[2]);
+    r.fps = stoi(fields[3]);
+    return r;
+}
+
+int bytes_per_pixel(rs2_format format)
+{
+    switch (format)
+    {
+    case RS2_FORMAT_Y8: return 1;
+    case RS2_FORMAT_Z16: case RS2_FORMAT_Y16: case RS2_FORMAT_YUYV: case RS2_FORMAT_UYVY: case RS2_FORMAT_DISPARITY16: return 2;
+    case RS2_FORMAT_RGB8: case RS2_FORMAT_BGR8: return 3;
+    case RS2_FORMAT_RGBA8: case RS2_FORMAT_BGRA8: return 4;
+    default: return 0;
+    }
+}
+
+// Frames generated for a stream of a software device
+struct synthetic_stream
+{
+    software_sensor sensor;
+    stream_profile profile;
+    profile_request request;
+    int bpp;
+    double next_ms;
+    unsigned long long number;
+};
+
+// Device injecting synthetic frames at the requested rates, to load the library without cameras
+class synthetic_device
+{
+public:
+    synthetic_device(const context& ctx, const string& name, const vector<profile_request>& requests)
+        : _device(ctx, name)
+    {
+        for (auto&& r : requests)
+        {
+            auto bpp = bytes_per_pixel(r.format);
+            if (!bpp)
+                throw invalid_argument(string("Synthetic devices do not generate ") + rs2_format_to_string(r.format));
+
+            rs2_intrinsics intrinsics{ r.width, r.height, r.width / 2.f, r.height / 2.f, float(r.width), float(r.width), RS2_DISTORTION_NONE, { 0, 0, 0, 0, 0 } };
+            rs2_video_stream vs{ r.stream, 0, r.width, r.height, r.fps, bpp, r.format, intrinsics };
+            auto sensor = _device.add_sensor(string(rs2_stream_to_string(r.stream)) + " sensor");
+            if (r.stream == RS2_STREAM_DEPTH)
+                sensor.add_read_only_option(RS2_OPTION_DEPTH_UNITS, 0.001f);
+            auto profile = sensor.add_video_stream(vs);
+            _streams.push_back({ sensor, profile, r, bpp, 0, 0 });
+        }
+
+        rs2_extrinsics identity{ { 1, 0, 0, 0, 1, 0, 0, 0, 1 }, { 0, 0, 0 } };
+        for (size_t i = 1; i < _streams.size(); i++)
+            _device.register_extrinsics(_streams[0].profile, _streams[i].profile, identity);
+    }
+
+    ~synthetic_device() { stop(); }
+
+    void start()
+    {
+        _running = true;
+        _generator = thread([this]() { generate(); });
+    }
+
+    void stop()
+    {
+        _running = false;
+        if (_generator.joinable()) _generator.join();
+    }
+
+private:
+    // Depth that moves a little every frame, so the filters and change detection have work to do
+    static void fill(const synthetic_stream& s, uint8_t* pixels)
+    {
+        auto stride = s.request.width * s.bpp;
+        if (s.request.format == RS2_FORMAT_Z16)
+        {
+            for (int y = 0; y < s.request.height; y++)
+            {
+                auto row = reinterpret_cast<uint16_t*>(pixels + y * stride);
+                for (int x = 0; x < s.request.width; x++)
+                    row[x] = static_cast<uint16_t>(500 + ((x + y + s.number) & 1023));
+            }
+        }
+        else
+        {
+            for (int y = 0; y < s.request.height; y++)
+                memset(pixels + y * stride, static_cast<int>((y + s.number) & 0xff), stride);
+        }
+    }
+
+    void generate()
+    {
+        auto start = now_ms();
+        for (auto&& s : _streams) s.next_ms = start;
+
+        while (_running)
+        {
+            auto next = min_element(_streams.begin(), _streams.end(),
+                [](const synthetic_stream& a, const synthetic_stream& b) { return a.next_ms < b.next_ms; });
+            auto wait = next->next_ms - now_ms();
+            if (wait > 0) this_thread::sleep_for(chrono::duration<double, milli>(min(wait, 100.0)));
+            if (now_ms() < next->next_ms) continue;
+
+            auto& s = *next;
+            auto size = s.request.width * s.request.height * s.bpp;
+            auto pixels = new uint8_t[size];
+            fill(s, pixels);
+
+            rs2_software_video_frame frame;
+            frame.pixels = pixels;
+            frame.deleter = [](void* p) { delete[] static_cast<uint8_t*>(p); };
+            frame.stride = s.request.width * s.bpp;
+            frame.bpp = s.bpp;
+            // Frames generated on the same tick carry the same timestamp, so the syncer matches them
+            frame.timestamp = chrono::duration<double, milli>(chrono::system_clock::now().time_since_epoch()).count();
+            frame.domain = RS2_TIMESTAMP_DOMAIN_SYSTEM_TIME;
+            frame.frame_number = ++s.number;
+            frame.profile = s.profile.get();
+            s.sensor.on_video_frame(frame);
+
+            s.next_ms += 1000.0 / max(s.request.fps, 1);
+        }
+    }
+
+    software_device _device;
+    vector<synthetic_stream> _streams;
+    atomic<bool> _running{ false };
+    thread _generator;
+};
+
+// One pipeline and its consumer thread, over a live camera, a recording or a synthetic device
+class source
+{
+public:
+    source(const context& ctx, const string& label, config cfg, bool loop, const vector<string>& blocks)
+        : _label(label), _pipe(ctx), _cfg(cfg), _loop(loop)
+    {
+        for (auto&& b : blocks) _steps.push_back(make_step(b));
+    }
+
+    ~source() { stop(); }
+
+    const string& label() const { return _label; }
+
+    void start()
+    {
+        restart();
+        _worker = thread([this]() { consume(); });
+    }
+
+    void stop()
+    {
+        if (_worker.joinable()) _worker.join();
+        try { _pipe.stop(); } catch (...) {}
+    }
+
+    // Statistics of the streams since the previous call, keyed by stream name
+    map<string, stream_stats> take()
+    {
+        lock_guard<mutex> lock(_mutex);
+        pipeline_profile profile = _profile;
+        if (profile)
+        {
+            for (auto&& sp : profile.get_streams())
+            {
+                auto stats = profile.get_frame_drops(sp);
+                unsigned long long dropped = 0;
+                for (int i = 0; i < RS2_FRAME_DROP_STAGE_COUNT; i++) dropped += stats.dropped[i];
+
+                // The counters restart with the streaming, as recordings do when they loop
+                auto& reported = _drops_reported[sp.stream_name()];
+                _interval[sp.stream_name()].drops += dropped >= reported ? dropped - reported : dropped;
+                reported = dropped;
+            }
+        }
+        map<string, stream_stats> result;
+        swap(result, _interval);
+        return result;
+    }
+
+    string error() const
+    {
+        lock_guard<mutex> lock(_mutex);
+        return _error;
+    }
+
+private:
+    void restart()
+    {
+        auto profile = _pipe.start(_cfg);
+        if (auto pb = profile.get_device().as<playback>())
+            pb.set_real_time(true);
+
+        lock_guard<mutex> lock(_mutex);
+        _profile = profile;
+        _drops_reported.clear();
+        _last_numbers.clear();
+    }
+
+    void consume()
+    {
+        while (running)
+        {
+            try
+            {
+                frameset fs;
+                if (!_pipe.poll_for_frames(&fs))
+                {
+                    if (_loop && ended())
+                    {
+                        _pipe.stop();
+                        restart();
+                    }
+                    this_thread::sleep_for(chrono::milliseconds(1));
+                    continue;
+                }
+                record(fs);
+                for (auto&& step : _steps)
+                    if (fs) fs = step(fs);
+            }
+            catch (const exception& e)
+            {
+                lock_guard<mutex> lock(_mutex);
+                _error = e.what();
+                return;
+            }
+        }
+    }
+
+    bool ended()
+    {
+        auto pb = _pipe.get_active_profile().get_device().as<playback>();
+        return pb && pb.current_status() == RS2_PLAYBACK_STATUS_STOPPED;
+    }
+
+    // Latency from the arrival of each frame in the library to its retrieval by the application
+    void record(frameset fs)
+    {
+        auto now = now_ms();
+        lock_guard<mutex> lock(_mutex);
+        for (auto&& f : fs)
+        {
+            auto name = f.get_profile().stream_name();
+            auto& stats = _interval[name];
+            stats.frames++;
+
+            auto number = f.get_frame_number();
+            auto it = _last_numbers.find(name);
+            if (it != _last_numbers.end() && number > it->second + 1)
+                stats.gaps += number - it->second - 1;
+            _last_numbers[name] = number;
+
+            auto arrival = f.get_latency_breakdown()[RS2_FRAME_LATENCY_STAGE_BACKEND_ARRIVAL];
+            if (arrival > 0) stats.latency.add(now - arrival);
+        }
+    }
+
+    string _label;
+    pipeline _pipe;
+    config _cfg;
+    bool _loop;
+    vector<processing_step> _steps;
+    thread _worker;
+
+    mutable mutex _mutex;
+    pipeline_profile _profile;
+    map<string, stream_stats> _interval;
+    map<string, unsigned long long> _drops_reported;
+    map<string, unsigned long long> _last_numbers;
+    string _error;
+};
+
+// CPU time of the threads of the process, in clock ticks, from /proc
+class cpu_sampler
+{
+public:
+    // Percent of a core each thread name used since the previous call, threads of the same name summed
+    map<string, double> sample(double elapsed_s)
+    {
+        map<string, double> usage;
+#ifdef __linux__
+        map<string, pair<string, unsigned long long>> current;
+        if (auto dir = opendir("/proc/self/task"))
+        {
+            while (auto entry = readdir(dir))
+            {
+                string tid = entry->d_name;
+                if (tid == "." || tid == "..") continue;
+                ifstream stat("/proc/self/task/" + tid + "/stat");
+                string line;
+                if (!getline(stat, line)) continue;
+
+                // The name is in parentheses and may hold spaces, utime and stime are the 12th and 13th fields after it
+                auto open = line.find('('), close = line.rfind(')');
+                if (open == string::npos || close == string::npos) continue;
+                stringstream fields(line.substr(close + 2));
+                vector<string> values;
+                string value;
+                while (fields >> value) values.push_back(value);
+                if (values.size() < 13) continue;
+                current[tid] = { line.substr(open + 1, close - open - 1), stoull(values[11]) + stoull(values[12]) };
+            }
+            closedir(dir);
+        }
+
+        static const double ticks_per_s = static_cast<double>(sysconf(_SC_CLK_TCK));
+        for (auto&& kvp : current)
+        {
+            auto previous = _ticks.find(kvp.first);
+            auto ticks = kvp.second.second - (previous != _ticks.end() ? previous->second.second : 0);
+            usage[kvp.second.first] += elapsed_s > 0 ? 100.0 * ticks / ticks_per_s / elapsed_s : 0;
+        }
+        _ticks = move(current);
+#else
+        (void)elapsed_s;
+#endif
+        return usage;
+    }
+
+private:
+    map<string, pair<string, unsigned long long>> _ticks;     // Name and CPU ticks of each thread id
+};
+
+// Resident memory of the process in MB, or zero where it is not known
+double resident_mb()
+{
+#ifdef __linux__
+    ifstream statm("/proc/self/statm");
+    unsigned long long size = 0, resident = 0;
+    if (statm >> size >> resident)
+        return resident * static_cast<double>(sysconf(_SC_PAGESIZE)) / (1024 * 1024);
+#endif
+    return 0;
+}
+
+// Rows of the report, all of a kind filling the same columns
+struct report_row
+{
+    double time_s;
+    string kind;        // stream, thread or process
+    string device;
+    string name;
+    unsigned long long frames, gaps, drops;
+    double fps, p50_ms, p90_ms, p99_ms, cpu_percent, rss_mb;
+};
+
+class report_writer
+{
+public:
+    report_writer(ostream& out, bool json) : _out(out), _json(json)
+    {
+        if (!_json)
+            _out << "time_s,kind,device,name,frames,fps,gaps,drops,p50_ms,p90_ms,p99_ms,cpu_percent,rss_mb" << endl;
+    }
+
+    void write(const report_row& r)
+    {
+        _out << fixed << setprecision(3);
+        if (!_json)
+        {
+            _out << r.time_s << "," << r.kind << "," << r.device << "," << r.name << "," << r.frames << "," << r.fps << ","
+                 << r.gaps << "," << r.drops << "," << r.p50_ms << "," << r.p90_ms << "," << r.p99_ms << ","
+                 << r.cpu_percent << "," << r.rss_mb << endl;
+            return;
+        }
+
+        // One object per line, with the fields of its kind
+        _out << "{\"time_s\":" << r.time_s << ",\"kind\":\"" << r.kind << "\"";
+        if (r.kind == "stream")
+            _out << ",\"device\":\"" << r.device << "\",\"name\":\"" << r.name << "\",\"frames\":" << r.frames << ",\"fps\":" << r.fps
+                 << ",\"gaps\":" << r.gaps << ",\"drops\":" << r.drops << ",\"p50_ms\":" << r.p50_ms << ",\"p90_ms\":" << r.p90_ms
+                 << ",\"p99_ms\":" << r.p99_ms;
+        else if (r.kind == "thread")
+            _out << ",\"name\":\"" << r.name << "\",\"cpu_percent\":" << r.cpu_percent;
+        else
+            _out << ",\"cpu_percent\":" << r.cpu_percent << ",\"rss_mb\":" << r.rss_mb;
+        _out << "}" << endl;
+    }
+
+private:
+    ostream& _out;
+    bool _json;
+};
+
+int main(int argc, char** argv) try
+{
+    CmdLine cmd("librealsense rs-stress tool", ' ', RS2_API_VERSION_STR);
+    ValueArg<int> devices_arg("n", "devices", "Connected cameras to stream, 0 for all of them", false, 0, "count");
+    MultiArg<string> files_arg("f", "file", "Recording to play in a loop, may be given several times", false, "file");
+    ValueArg<int> synthetic_arg("w", "synthetic", "Software devices generating frames of the requested profiles", false, 0, "count");
+    MultiArg<string> profile_arg("p", "profile", "Profile to stream, as stream,width,height,fps,format, may be given several times", false, "profile");
+    ValueArg<string> blocks_arg("b", "blocks", "Processing blocks applied to every frameset, in order, comma separated", false, "", "blocks");
+    ValueArg<int> duration_arg("t", "time", "Duration of the run in seconds, 0 until interrupted", false, 60, "seconds");
+    ValueArg<int> interval_arg("i", "interval", "Seconds between reports", false, 10, "seconds");
+    ValueArg<string> output_arg("o", "output", "File to write the report to, instead of the console", false, "", "file");
+    SwitchArg json_arg("j", "json", "Write the report as JSON lines instead of CSV");
+    cmd.add(devices_arg);
+    cmd.add(files_arg);
+    cmd.add(synthetic_arg);
+    cmd.add(profile_arg);
+    cmd.add(blocks_arg);
+    cmd.add(duration_arg);
+    cmd.add(interval_arg);
+    cmd.add(output_arg);
+    cmd.add(json_arg);
+    cmd.parse(argc, argv);
+
+    vector<profile_request> profiles;
+    for (auto&& p : profile_arg.getValue()) profiles.push_back(parse_profile(p));
+    vector<string> blocks;
+    {
+        stringstream ss(blocks_arg.getValue());
+        string block;
+        while (getline(ss, block, ','))
+            if (!block.empty()) blocks.push_back(block);
+    }
+
+    signal(SIGINT, on_signal);
+    enable_latency_instrumentation(true);
+
+    auto make_config = [&profiles]()
+    {
+        config cfg;
+        for (auto&& p : profiles) cfg.enable_stream(p.stream, 0, p.width, p.height, p.format, p.fps);
+        return cfg;
+    };
+
+    context ctx;
+    vector<unique_ptr<synthetic_device>> synthetic;
+    vector<unique_ptr<source>> sources;
+
+    if (synthetic_arg.getValue() > 0)
+    {
+        if (profiles.empty())
+            profiles = { { RS2_STREAM_DEPTH, 640, 480, 30, RS2_FORMAT_Z16 }, { RS2_STREAM_COLOR, 640, 480, 30, RS2_FORMAT_RGB8 } };
+        for (int i = 0; i < synthetic_arg.getValue(); i++)
+        {
+            auto name = "synthetic-" + to_string(i);
+            synthetic.emplace_back(new synthetic_device(ctx, name, profiles));
+            auto cfg = make_config();
+            cfg.enable_device(name);
+            sources.emplace_back(new source(ctx, name, cfg, false, blocks));
+        }
+    }
+
+    for (auto&& file : files_arg.getValue())
+    {
+        config cfg;
+        cfg.enable_device_from_file(file);
+        sources.emplace_back(new source(ctx, file, cfg, true, blocks));
+    }
+
+    if (devices_arg.isSet() || sources.empty())
+    {
+        int count = 0;
+        for (auto&& dev : ctx.query_devices())
+        {
+            if (devices_arg.getValue() > 0 && count >= devices_arg.getValue()) break;
+            if (software_device(dev)) continue;
+            string serial = dev.get_info(RS2_CAMERA_INFO_SERIAL_NUMBER);
+            auto cfg = make_config();
+            cfg.enable_device(serial);
+            sources.emplace_back(new source(ctx, serial, cfg, false, blocks));
+            count++;
+        }
+    }
+
+    if (sources.empty())
+    {
+        cerr << "No device to stream, connect a camera or use -f or -w" << endl;
+        return EXIT_FAILURE;
+    }
+
+    ofstream file;
+    if (!output_arg.getValue().empty())
+    {
+        file.open(output_arg.getValue());
+        if (!file) throw runtime_error("Could not open " + output_arg.getValue());
+    }
+    report_writer writer(file.is_open() ? file : cout, json_arg.getValue());
+
+    for (auto&& s : sources) s->start();
+    for (auto&& d : synthetic) d->start();
+
+    cpu_sampler cpu;
+    auto start = now_ms(), last = start;
+    auto rss_start = resident_mb();
+    cpu.sample(0);
+    map<pair<string, string>, stream_stats> totals;
+
+    auto duration_ms = duration_arg.getValue() * 1000.0;
+    auto interval_ms = max(interval_arg.getValue(), 1) * 1000.0;
+    while (running && (duration_ms <= 0 || now_ms() - start < duration_ms))
+    {
+        auto next = min(last + interval_ms, duration_ms > 0 ? start + duration_ms : last + interval_ms);
+        while (running && now_ms() < next) this_thread::sleep_for(chrono::milliseconds(100));
+
+        auto now = now_ms();
+        auto elapsed_s = (now - last) / 1000;
+        auto time_s = (now - start) / 1000;
+        last = now;
+
+        for (auto&& s : sources)
+        {
+            for (auto&& kvp : s->take())
+            {
+                auto& st = kvp.second;
+                writer.write({ time_s, "stream", s->label(), kvp.first, st.frames, st.gaps, st.drops, st.frames / elapsed_s,
+                               st.latency.percentile(0.5), st.latency.percentile(0.9), st.latency.percentile(0.99), 0, 0 });
+                totals[{ s->label(), kvp.first }].add(st);
+            }
+            auto error = s->error();
+            if (!error.empty())
+                cerr << s->label() << " stopped: " << error << endl;
+        }
+
+        double process_cpu = 0;
+        for (auto&& kvp : cpu.sample(elapsed_s))
+        {
+            writer.write({ time_s, "thread", "", kvp.first, 0, 0, 0, 0, 0, 0, 0, kvp.second, 0 });
+            process_cpu += kvp.second;
+        }
+        writer.write({ time_s, "process", "", "", 0, 0, 0, 0, 0, 0, 0, process_cpu, resident_mb() });
+    }
+
+    running = false;
+    for (auto&& d : synthetic) d->stop();
+    for (auto&& s : sources) s->stop();
+
+    auto run_s = (now_ms() - start) / 1000;
+    cerr << endl << "Streamed for " << fixed << setprecision(0) << run_s << " s, resident memory grew by "
+         << setprecision(1) << resident_mb() - rss_start << " MB" << endl;
+    cerr << left << setw(32) << "Device" << setw(14) << "Stream" << right << setw(12) << "Frames" << setw(8) << "FPS"
+         << setw(8) << "Gaps" << setw(8) << "Drops" << setw(10) << "p50 ms" << setw(10) << "p99 ms" << endl;
+    for (auto&& kvp : totals)
+    {
+        auto& st = kvp.second;
+        cerr << left << setw(32) << kvp.first.first << setw(14) << kvp.first.second << right << setw(12) << st.frames
+             << setw(8) << setprecision(1) << (run_s > 0 ? st.frames / run_s : 0) << setw(8) << st.gaps << setw(8) << st.drops
+             << setw(10) << setprecision(2) << st.latency.percentile(0.5) << setw(10) << st.latency.percentile(0.99) << endl;
+    }
+    return EXIT_SUCCESS;
+}
+catch (const error& e)
+{
+    cerr << "RealSense error calling " << e.get_failed_function() << "(" << e.get_failed_args() << "):\n    " << e.what() << endl;
+    return EXIT_FAILURE;
+}
+catch (const exception& e)
+{
+    cerr << e.what() << endl;
+    return EXIT_FAILURE;
+}
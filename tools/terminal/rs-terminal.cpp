@@ -2,6 +2,7 @@
 // Copyright(c) 2015 Intel Corporation. All Rights Reserved.
 
 #include <librealsense2/rs.hpp>
+#include <chrono>
 #include <iostream>
 #include <fstream>
 
@@ -37,7 +38,7 @@ vector<uint8_t> build_raw_command_data(const command& command, const vector<stri
     return raw_data;
 }
 
-void xml_mode(const string& line, const commands_xml& cmd_xml, device& dev, map<string, xml_parser_function>& format_type_to_lambda)
+command encode_xml_command(const string& line, const commands_xml& cmd_xml, vector<uint8_t>& raw_data)
 {
     vector<string> tokens;
     stringstream ss(line);
@@ -61,15 +62,15 @@ void xml_mode(const string& line, const commands_xml& cmd_xml, device& dev, map<
     for (auto i = 1; i < tokens.size(); ++i)
         params.push_back(tokens[i]);
 
-    auto raw_data = build_raw_command_data(command, params);
-
-    for (auto b : raw_data)
-    {
-        cout << hex << fixed << setfill('0') << setw(2) << (int)b << " ";
-    }
-    cout << endl;
+    raw_data = build_raw_command_data(command, params);
+    return command;
+}
 
-    auto result = dev.as<debug_protocol>().send_and_receive_raw_data(raw_data);
+void print_xml_response(const command& command, const commands_xml& cmd_xml, const vector<uint8_t>& result,
+                        map<string, xml_parser_function>& format_type_to_lambda)
+{
+    if (result.empty())
+        throw runtime_error("Empty response!");
 
     unsigned returned_opcode = *result.data();
     // check returned opcode
@@ -92,7 +93,22 @@ void xml_mode(const string& line, const commands_xml& cmd_xml, device& dev, map<
     }
 }
 
-void hex_mode(const string& line, device& dev)
+void xml_mode(const string& line, const commands_xml& cmd_xml, device& dev, map<string, xml_parser_function>& format_type_to_lambda)
+{
+    vector<uint8_t> raw_data;
+    auto command = encode_xml_command(line, cmd_xml, raw_data);
+
+    for (auto b : raw_data)
+    {
+        cout << hex << fixed << setfill('0') << setw(2) << (int)b << " ";
+    }
+    cout << endl;
+
+    auto result = dev.as<debug_protocol>().send_and_receive_raw_data(raw_data);
+    print_xml_response(command, cmd_xml, result, format_type_to_lambda);
+}
+
+vector<uint8_t> parse_hex_line(const string& line)
 {
     vector<uint8_t> raw_data;
     stringstream ss(line);
@@ -107,14 +123,88 @@ void hex_mode(const string& line, device& dev)
     }
     if (raw_data.empty())
         throw runtime_error("Wrong input!");
+    return raw_data;
+}
 
-    auto result = dev.as<debug_protocol>().send_and_receive_raw_data(raw_data);
-
+void print_hex_response(const vector<uint8_t>& result)
+{
     cout << endl;
     for (auto& elem : result)
         cout << setfill('0') << setw(2) << hex << static_cast<int>(elem) << " ";
 }
 
+void hex_mode(const string& line, device& dev)
+{
+    auto raw_data = parse_hex_line(line);
+    auto result = dev.as<debug_protocol>().send_and_receive_raw_data(raw_data);
+    print_hex_response(result);
+}
+
+// Encodes all the commands of the script before sending any of them, so that a typo does not leave the device
+// half configured, and sends them in one batch. The responses are printed in order with the time each one took
+// after the previous response, which is the cost the command adds to the cycle time of the script
+bool batch_mode(const vector<string>& lines, bool is_hex, const commands_xml& cmd_xml, device& dev,
+                map<string, xml_parser_function>& format_type_to_lambda)
+{
+    auto encode_start = chrono::steady_clock::now();
+    vector<string> sources;
+    vector<command> commands;
+    vector<vector<uint8_t>> raw_data;
+    for (size_t i = 0; i < lines.size(); ++i)
+    {
+        if (lines[i].find_first_not_of(" \t\r") == string::npos)
+            continue;
+        try
+        {
+            vector<uint8_t> data;
+            if (is_hex)
+                data = parse_hex_line(lines[i]);
+            else
+                commands.push_back(encode_xml_command(lines[i], cmd_xml, data));
+            raw_data.push_back(data);
+            sources.push_back(lines[i]);
+        }
+        catch (const exception& ex)
+        {
+            stringstream msg;
+            msg << "Line " << dec << i + 1 << ": " << ex.what();
+            throw runtime_error(msg.str());
+        }
+    }
+    auto encode_ms = chrono::duration<double, milli>(chrono::steady_clock::now() - encode_start).count();
+
+    vector<double> received_ms;
+    auto results = dev.as<debug_protocol>().send_and_receive_raw_data_batch(raw_data, &received_ms);
+
+    auto failures = 0;
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        cout << endl << "[" << dec << i + 1 << "] " << sources[i];
+        try
+        {
+            if (is_hex)
+                print_hex_response(results[i]);
+            else
+                print_xml_response(commands[i], cmd_xml, results[i], format_type_to_lambda);
+        }
+        catch (const exception& ex)
+        {
+            cout << endl << ex.what() << endl;
+            ++failures;
+        }
+        auto previous = i ? received_ms[i - 1] : 0.;
+        cout << endl << fixed << setprecision(3) << dec << "    " << received_ms[i] - previous << " ms, done at " << received_ms[i] << " ms" << endl;
+    }
+
+    auto total_ms = received_ms.empty() ? 0. : received_ms.back();
+    cout << endl << dec << results.size() << " commands, " << failures << " failed" << fixed << setprecision(3)
+         << ", encoded in " << encode_ms << " ms, sent in " << total_ms << " ms";
+    if (!results.empty())
+        cout << " (" << total_ms / results.size() << " ms per command)";
+    cout << endl;
+    return failures == 0;
+}
+
 auto_complete get_auto_complete_obj(bool is_application_in_hex_mode, const map<string, command>& commands_map)
 {
     set<string> commands;
@@ -157,11 +247,14 @@ int main(int argc, char** argv)
     ValueArg<string> hex_cmd_arg("s", "send", "Hexadecimal raw data", false, "", "Send hexadecimal raw data to device");
     ValueArg<string> hex_script_arg("r", "raw", "Full file path of hexadecimal raw data script", false, "", "Send raw data line by line from script file");
     ValueArg<string> commands_script_arg("c", "cmd", "Full file path of commands script", false, "", "Send commands line by line from script file");
+    ValueArg<string> batch_script_arg("b", "batch", "Full file path of a script of commands, or of hexadecimal raw data without -l", false, "",
+                                      "Send all the commands of a script file as one pipelined batch, timing each of them");
     cmd.add(xml_arg);
     cmd.add(device_id_arg);
     cmd.add(hex_cmd_arg);
     cmd.add(hex_script_arg);
     cmd.add(commands_script_arg);
+    cmd.add(batch_script_arg);
     cmd.parse(argc, argv);
 
     // parse command.xml
@@ -226,6 +319,10 @@ int main(int argc, char** argv)
         {
             script_file = commands_script_arg.getValue();
         }
+        else if (batch_script_arg.isSet())
+        {
+            script_file = batch_script_arg.getValue();
+        }
 
         if (!script_file.empty())
             read_script_file(script_file, script_lines);
@@ -263,6 +360,19 @@ int main(int argc, char** argv)
             return EXIT_SUCCESS;
         }
 
+        if (batch_script_arg.isSet())
+        {
+            try
+            {
+                return batch_mode(script_lines, is_application_in_hex_mode, cmd_xml, dev, format_type_to_lambda) ? EXIT_SUCCESS : EXIT_FAILURE;
+            }
+            catch (const exception& ex)
+            {
+                cout << endl << ex.what() << endl;
+                return EXIT_FAILURE;
+            }
+        }
+
 
 
 
@@ -0,0 +1,356 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2017 Intel Corporation. All Rights Reserved.
+
+///////////////////////////////////////////////////////////////////////////////////////////////
+// This set of tests needs no camera, it runs against software devices and library internals //
+///////////////////////////////////////////////////////////////////////////////////////////////
+
+// Runs on its own, without the recording and playback modes of the live tests
+#define CATCH_CONFIG_MAIN
+#include "unit-tests-common.h"
+#include "../src/media/ros/depth_codec.h"
+#include "../src/frame-buffer-pool.h"
+
+#include <vector>
+#include <cstdlib>
+#include <cstdio>
+#include <thread>
+
+using namespace librealsense;
+
+// Depth of a scene with a slope, a step, holes of invalid depth and some noise
+static std::vector<uint16_t> make_depth_image(uint32_t width, uint32_t height, uint32_t stride)
+{
+    std::vector<uint16_t> pixels(stride / sizeof(uint16_t) * height, 0xdead);
+    std::srand(1);
+    for (uint32_t y = 0; y < height; y++)
+    {
+        auto row = pixels.data() + y * stride / sizeof(uint16_t);
+        for (uint32_t x = 0; x < width; x++)
+        {
+            if (x > width / 4 && x < width / 3 && y > height / 2) row[x] = 0;
+            else if (x > width / 2) row[x] = static_cast<uint16_t>(3000 + y * 4 + std::rand() % 8);
+            else row[x] = static_cast<uint16_t>(1000 + x * 2 + y);
+        }
+    }
+    return pixels;
+}
+
+TEST_CASE("Depth codec round-trips the pixels", "[offline][depth-codec]")
+{
+    const uint32_t width = 97, height = 61, stride = width * sizeof(uint16_t) + 6;
+    auto pixels = make_depth_image(width, height, stride);
+
+    std::vector<uint8_t> encoded;
+    encode_depth(pixels.data(), width, height, stride, encoded);
+    REQUIRE(encoded.size() < width * height * sizeof(uint16_t));
+
+    // Decoded into a tight buffer, the padding of the source rows does not matter
+    std::vector<uint16_t> decoded(width * height);
+    decode_depth(encoded.data(), encoded.size(), width, height, width * sizeof(uint16_t), decoded.data());
+    for (uint32_t y = 0; y < height; y++)
+        for (uint32_t x = 0; x < width; x++)
+            REQUIRE(decoded[y * width + x] == pixels[y * stride / sizeof(uint16_t) + x]);
+}
+
+TEST_CASE("Depth codec keeps the pixels within the tolerance", "[offline][depth-codec]")
+{
+    const uint32_t width = 64, height = 48, stride = width * sizeof(uint16_t);
+    const uint16_t tolerance = 4;
+    auto pixels = make_depth_image(width, height, stride);
+
+    std::vector<uint8_t> encoded;
+    encode_depth(pixels.data(), width, height, stride, encoded, tolerance);
+    std::vector<uint16_t> decoded(width * height);
+    decode_depth(encoded.data(), encoded.size(), width, height, stride, decoded.data(), tolerance);
+    for (size_t i = 0; i < decoded.size(); i++)
+    {
+        if (pixels[i] == 0) REQUIRE(decoded[i] == 0);
+        else REQUIRE(std::abs(decoded[i] - pixels[i]) <= tolerance);
+    }
+}
+
+TEST_CASE("Depth codec rejects corrupted input", "[offline][depth-codec]")
+{
+    const uint32_t width = 64, height = 48, stride = width * sizeof(uint16_t);
+    auto pixels = make_depth_image(width, height, stride);
+    std::vector<uint8_t> encoded;
+    encode_depth(pixels.data(), width, height, stride, encoded);
+
+    // The output buffer has a guard past the image, which decoding must leave alone
+    std::vector<uint16_t> decoded(width * height + 1, 0xbeef);
+
+    SECTION("truncated data")
+    {
+        REQUIRE_THROWS_AS(decode_depth(encoded.data(), encoded.size() / 2, width, height, stride, decoded.data()), invalid_value_exception);
+        REQUIRE_THROWS_AS(decode_depth(encoded.data(), 0, width, height, stride, decoded.data()), invalid_value_exception);
+    }
+    SECTION("stride shorter than a row")
+    {
+        REQUIRE_THROWS_AS(decode_depth(encoded.data(), encoded.size(), width, height, width, decoded.data()), invalid_value_exception);
+    }
+    SECTION("random data")
+    {
+        std::srand(2);
+        for (auto&& b : encoded) b = static_cast<uint8_t>(std::rand());
+        try { decode_depth(encoded.data(), encoded.size(), width, height, stride, decoded.data()); }
+        catch (const invalid_value_exception&) {}
+    }
+    REQUIRE(decoded.back() == 0xbeef);
+}
+
+static uint16_t native_test_pixel(unsigned long long frame_number, int x, int y)
+{
+    return (x > 20 && x < 30) ? 0 : static_cast<uint16_t>(1000 + frame_number * 7 + x * 3 + y);
+}
+
+TEST_CASE("Native recording round-trips the frames of a software device", "[offline][native-format]")
+{
+    const int width = 64, height = 48, frames = 5;
+    const std::string file = "offline-test-native.rsn";
+
+    auto compression = RS2_RECORD_COMPRESSION_NONE;
+    SECTION("uncompressed") { compression = RS2_RECORD_COMPRESSION_NONE; }
+    SECTION("depth codec") { compression = RS2_RECORD_COMPRESSION_LZ4_DEPTH; }
+
+    {
+        rs2::context ctx;
+        rs2::software_device dev(ctx, "offline-test");
+        auto sensor = dev.add_sensor("Depth");
+        sensor.add_read_only_option(RS2_OPTION_DEPTH_UNITS, 0.001f);
+        rs2_video_stream stream{ RS2_STREAM_DEPTH, 0, width, height, 30, 2, RS2_FORMAT_Z16, rs2_intrinsics{ width, height } };
+        auto profile = sensor.add_video_stream(stream);
+
+        auto rec = rs2::recorder::native(file, dev, compression);
+        auto recorded = rec.query_sensors().front();
+        recorded.open(recorded.get_stream_profiles().front());
+        recorded.start([](rs2::frame) {});
+
+        std::vector<uint16_t> pixels(width * height);
+        for (int i = 0; i < frames; i++)
+        {
+            for (int y = 0; y < height; y++)
+                for (int x = 0; x < width; x++)
+                    pixels[y * width + x] = native_test_pixel(i, x, y);
+            sensor.on_video_frame({ pixels.data(), nullptr, width * 2, 2, 1000.0 + i * 33, RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK,
+                                    static_cast<unsigned long long>(i), profile.get() });
+        }
+        recorded.stop();
+        recorded.close();
+    }
+
+    rs2::context ctx;
+    auto playback = ctx.load_device(file);
+    playback.set_real_time(false);
+    auto sensor = playback.query_sensors().front();
+
+    std::mutex m;
+    std::condition_variable cv;
+    std::vector<unsigned long long> played;
+    bool matched = true;
+    sensor.open(sensor.get_stream_profiles().front());
+    sensor.start([&](rs2::frame f)
+    {
+        auto video = f.as<rs2::video_frame>();
+        auto data = static_cast<const uint8_t*>(video.get_data());
+        bool same = video.get_width() == width && video.get_height() == height && video.get_bytes_per_pixel() == 2;
+        for (int y = 0; y < height && same; y++)
+        {
+            auto row = reinterpret_cast<const uint16_t*>(data + y * video.get_stride_in_bytes());
+            for (int x = 0; x < width && same; x++)
+                same = row[x] == native_test_pixel(f.get_frame_number(), x, y);
+        }
+        std::lock_guard<std::mutex> lock(m);
+        matched = matched && same;
+        played.push_back(f.get_frame_number());
+        cv.notify_one();
+    });
+    {
+        std::unique_lock<std::mutex> lock(m);
+        cv.wait_for(lock, std::chrono::seconds(10), [&]() { return played.size() == static_cast<size_t>(frames); });
+    }
+    sensor.stop();
+    sensor.close();
+    ctx.unload_device(file);
+    std::remove(file.c_str());
+    std::remove("offline-test-native_description.bag");
+    std::remove("offline-test-native_0_Depth_0.frames");
+
+    REQUIRE(played.size() == static_cast<size_t>(frames));
+    REQUIRE(matched);
+    for (int i = 0; i < frames; i++)
+        REQUIRE(played[i] == static_cast<unsigned long long>(i));
+}
+
+TEST_CASE("Frame buffer pool recycles the buffers of a size class", "[offline][frame-buffer-pool]")
+{
+    frame_buffer_pool<> pool;
+    frame_storage missed;
+    REQUIRE_FALSE(pool.acquire(1024, missed, 0));
+
+    frame_storage buffer(1024);
+    auto data = buffer.data();
+    pool.release(std::move(buffer), 0);
+    REQUIRE(buffer.capacity() == 0);
+
+    frame_storage other_size;
+    REQUIRE_FALSE(pool.acquire(2048, other_size, 1));
+
+    frame_storage recycled;
+    REQUIRE(pool.acquire(1024, recycled, 1));
+    REQUIRE(recycled.data() == data);
+    REQUIRE_FALSE(pool.acquire(1024, missed, 1));
+
+    auto stats = pool.get_stats();
+    REQUIRE(stats.hits == 1);
+    REQUIRE(stats.misses == 3);
+    REQUIRE(stats.evictions == 0);
+}
+
+TEST_CASE("Frame buffer pool frees the buffers past its high-water mark", "[offline][frame-buffer-pool]")
+{
+    frame_buffer_pool<> pool(2);
+    for (int i = 0; i < 3; i++)
+        pool.release(frame_storage(1024), 0);
+    REQUIRE(pool.get_stats().evictions == 1);
+
+    frame_storage buffer;
+    REQUIRE(pool.acquire(1024, buffer, 0));
+    REQUIRE(pool.acquire(1024, buffer, 0));
+    REQUIRE_FALSE(pool.acquire(1024, buffer, 0));
+}
+
+TEST_CASE("Frame buffer pool drains the size classes left idle, except reserved ones", "[offline][frame-buffer-pool]")
+{
+    frame_buffer_pool<> pool;
+    REQUIRE(pool.reserve(4096, 4) == 4);
+    pool.release(frame_storage(1024), 0);
+
+    // Any acquire drains the size classes idle for too long
+    frame_storage buffer;
+    auto later = FRAME_POOL_MAX_IDLE_MS * 2;
+    REQUIRE_FALSE(pool.acquire(512, buffer, later));
+    REQUIRE(pool.get_stats().evictions == 1);
+    REQUIRE_FALSE(pool.acquire(1024, buffer, later));
+    for (int i = 0; i < 4; i++)
+        REQUIRE(pool.acquire(4096, buffer, later));
+
+    pool.clear();
+    pool.release(frame_storage(4096), later);
+    pool.clear();
+    REQUIRE_FALSE(pool.acquire(4096, buffer, later));
+}
+
+TEST_CASE("Frame buffer pool hands a buffer to one thread at a time", "[offline][frame-buffer-pool]")
+{
+    const int threads = 4, iterations = 2000;
+    const size_t size = 256;
+    frame_buffer_pool<> pool(4);
+    std::atomic<bool> shared{ false };
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++)
+    {
+        workers.emplace_back([&, t]()
+        {
+            for (int i = 0; i < iterations; i++)
+            {
+                frame_storage buffer;
+                if (!pool.acquire(size, buffer, 0)) buffer = frame_storage(size);
+                std::fill(buffer.begin(), buffer.end(), static_cast<uint8_t>(t));
+                std::this_thread::yield();
+                if (std::any_of(buffer.begin(), buffer.end(), [t](uint8_t b) { return b != t; })) shared = true;
+                pool.release(std::move(buffer), 0);
+            }
+        });
+    }
+    for (auto&& w : workers) w.join();
+
+    REQUIRE_FALSE(shared);
+    auto stats = pool.get_stats();
+    REQUIRE(stats.hits + stats.misses == static_cast<uint64_t>(threads * iterations));
+}
+
+TEST_CASE("Lock-free queue keeps the order of the items", "[offline][lock-free-queue]")
+{
+    lock_free_queue<int> queue(8);
+    for (int i = 0; i < 5; i++) queue.enqueue(int(i));
+    REQUIRE(queue.size() == 5);
+
+    int item = -1;
+    for (int i = 0; i < 5; i++)
+    {
+        REQUIRE(queue.try_dequeue(&item));
+        REQUIRE(item == i);
+    }
+    REQUIRE_FALSE(queue.try_dequeue(&item));
+    REQUIRE_FALSE(queue.dequeue(&item, 10));
+}
+
+TEST_CASE("Lock-free queue drops the oldest items when full", "[offline][lock-free-queue]")
+{
+    lock_free_queue<int> queue(4);
+    for (int i = 0; i < 6; i++) queue.enqueue(int(i));
+    REQUIRE(queue.size() == 4);
+    REQUIRE(queue.get_dropped_count() == 2);
+
+    int item = -1;
+    for (int i = 2; i < 6; i++)
+    {
+        REQUIRE(queue.dequeue(&item, 10));
+        REQUIRE(item == i);
+    }
+}
+
+TEST_CASE("Lock-free queue stops accepting items once cleared", "[offline][lock-free-queue]")
+{
+    lock_free_queue<int> queue(4);
+    queue.enqueue(1);
+    queue.clear();
+    REQUIRE(queue.size() == 0);
+
+    // Enqueued items are ignored until the consumer dequeues again, and a cleared queue does not wait
+    queue.enqueue(2);
+    REQUIRE(queue.size() == 0);
+    int item = -1;
+    auto start = std::chrono::steady_clock::now();
+    REQUIRE_FALSE(queue.dequeue(&item, 5000));
+    REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::seconds(1));
+
+    queue.start();
+    queue.enqueue(3);
+    REQUIRE(queue.dequeue(&item, 10));
+    REQUIRE(item == 3);
+}
+
+TEST_CASE("Lock-free queue delivers the items of concurrent producers", "[offline][lock-free-queue]")
+{
+    const int producers = 4, items = 10000;
+    lock_free_queue<int> queue(producers * items);
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++)
+    {
+        threads.emplace_back([&queue, p]()
+        {
+            for (int i = 0; i < items; i++) queue.enqueue(p * items + i);
+        });
+    }
+
+    // Every producer's items arrive in its order, none is lost or duplicated
+    std::vector<int> last(producers, -1);
+    int received = 0, item = -1;
+    bool ordered = true;
+    while (received < producers * items && queue.dequeue(&item, 1000))
+    {
+        auto p = item / items;
+        ordered = ordered && item % items == last[p] + 1;
+        last[p] = item % items;
+        received++;
+    }
+    for (auto&& t : threads) t.join();
+
+    REQUIRE(ordered);
+    REQUIRE(received == producers * items);
+    REQUIRE(queue.get_dropped_count() == 0);
+}
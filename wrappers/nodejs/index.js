@@ -2068,6 +2068,7 @@ class Pipeline {
     this.cxxPipeline.create(this.ctx.cxxCtx);
     this.started = false;
     this.frameSet = new FrameSet();
+    this.pendingWaits = 0;
     internal.addObject(this);
   }
 
@@ -2079,6 +2080,12 @@ class Pipeline {
   destroy() {
     if (this.started === true) this.stop();
 
+    // The native pipeline is destroyed once the pending asynchronous waits complete
+    if (this.pendingWaits > 0) {
+      this.destroyPending = true;
+      return;
+    }
+
     if (this.cxxPipeline) {
       this.cxxPipeline.destroy();
       this.cxxPipeline = undefined;
@@ -2167,6 +2174,36 @@ class Pipeline {
     throw new TypeError('Pipeline.waitForFrames() expects an integer timeout argument');
   }
 
+  /**
+   * Wait for a new set of frames on a worker thread, without blocking the event loop.
+   * Unlike {@link Pipeline#waitForFrames}, every call resolves to its own FrameSet, so several
+   * framesets, of several pipelines, can be in use at the same time. Frame data is not copied, the
+   * ArrayBuffer of a frame keeps the frame alive until the buffer is garbage collected.
+   *
+   * @param {Integer} timeout - max time to wait, in milliseconds, default to 5000 ms
+   * @return {Promise<FrameSet>} resolved with the FrameSet, rejected on timeout or error
+   */
+  waitForFramesAsync(timeout) {
+    if (arguments.length > 1 || (arguments.length === 1 && !isNumber(timeout))) {
+      throw new TypeError('Pipeline.waitForFramesAsync() expects an integer timeout argument');
+    }
+    return new Promise((resolve, reject) => {
+      this.pendingWaits++;
+      this.cxxPipeline.waitForFramesAsync(timeout || 5000, (err, cxxFrameSet) => {
+        this.pendingWaits--;
+        if (this.destroyPending && this.pendingWaits === 0) {
+          this.destroyPending = false;
+          this.destroy();
+        }
+        if (err) {
+          reject(err);
+        } else {
+          resolve(new FrameSet(cxxFrameSet));
+        }
+      });
+    });
+  }
+
   get latestFrame() {
     return this.frameSet;
   }
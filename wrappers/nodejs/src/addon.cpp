@@ -483,6 +483,35 @@ Nan::Persistent<v8::Function> RSStreamProfile::constructor_;
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 
+// Holds a reference of a frame for as long as an ArrayBuffer viewing its data
+// is alive, so the data is exposed to JS without copying it
+class FrameBufferOwner {
+ public:
+  static v8::Local<v8::ArrayBuffer> NewArrayBuffer(rs2_frame* frame,
+      void* data, size_t length, rs2_error** error) {
+    auto array_buffer = v8::ArrayBuffer::New(v8::Isolate::GetCurrent(), data,
+        length, v8::ArrayBufferCreationMode::kExternalized);
+    rs2_frame_add_ref(frame, error);
+    auto owner = new FrameBufferOwner(frame);
+    owner->buffer_.Reset(array_buffer);
+    owner->buffer_.SetWeak(owner, Release, Nan::WeakCallbackType::kParameter);
+    return array_buffer;
+  }
+
+ private:
+  explicit FrameBufferOwner(rs2_frame* frame) : frame_(frame) {}
+
+  static void Release(const Nan::WeakCallbackInfo<FrameBufferOwner>& info) {
+    auto owner = info.GetParameter();
+    owner->buffer_.Reset();
+    rs2_release_frame(owner->frame_);
+    delete owner;
+  }
+
+  rs2_frame* frame_;
+  Nan::Persistent<v8::ArrayBuffer> buffer_;
+};
+
 class RSFrame : public Nan::ObjectWrap {
  public:
   static void Init(v8::Local<v8::Object> exports) {
@@ -599,10 +628,8 @@ class RSFrame : public Nan::ObjectWrap {
       const auto height = rs2_get_frame_height(me->frame_, &me->error_);
       const auto length = stride * height;
       if (buffer) {
-        auto array_buffer = v8::ArrayBuffer::New(
-            v8::Isolate::GetCurrent(),
-            static_cast<uint8_t*>(const_cast<void*>(buffer)), length,
-            v8::ArrayBufferCreationMode::kExternalized);
+        auto array_buffer = FrameBufferOwner::NewArrayBuffer(me->frame_,
+            const_cast<void*>(buffer), length, &me->error_);
 
         info.GetReturnValue().Set(array_buffer);
         return;
@@ -3206,6 +3233,48 @@ class RSConfig : public Nan::ObjectWrap  {
 
 Nan::Persistent<v8::Function> RSConfig::constructor_;
 
+// Waits for a frameset on a libuv worker thread, so the event loop keeps
+// running, and delivers it to the callback on the main thread
+class PipelineWaitForFramesWorker : public Nan::AsyncWorker {
+ public:
+  PipelineWaitForFramesWorker(Nan::Callback* callback,
+      v8::Local<v8::Object> pipeline, rs2_pipeline* pipeline_ptr,
+      unsigned int timeout) : Nan::AsyncWorker(callback),
+      pipeline_(pipeline_ptr), timeout_(timeout), frames_(nullptr) {
+    // Keeps the pipeline from being collected while waiting
+    SaveToPersistent("pipeline", pipeline);
+  }
+
+  ~PipelineWaitForFramesWorker() {
+    if (frames_) rs2_release_frame(frames_);
+  }
+
+  void Execute() override {
+    rs2_error* error = nullptr;
+    frames_ = rs2_pipeline_wait_for_frames(pipeline_, timeout_, &error);
+    if (error) {
+      SetErrorMessage(rs2_get_error_message(error));
+      rs2_free_error(error);
+      frames_ = nullptr;
+    }
+  }
+
+  void HandleOKCallback() override {
+    Nan::HandleScope scope;
+    v8::Local<v8::Value> argv[2] = {
+      Nan::Null(), RSFrameSet::NewInstance(frames_)
+    };
+    // The frameset object owns the frames now
+    frames_ = nullptr;
+    callback->Call(2, argv);
+  }
+
+ private:
+  rs2_pipeline* pipeline_;
+  unsigned int timeout_;
+  rs2_frame* frames_;
+};
+
 class RSPipeline : public Nan::ObjectWrap {
  public:
   static void Init(v8::Local<v8::Object> exports) {
@@ -3218,6 +3287,7 @@ class RSPipeline : public Nan::ObjectWrap {
     Nan::SetPrototypeMethod(tpl, "stop", Stop);
     Nan::SetPrototypeMethod(tpl, "waitForFrames", WaitForFrames);
     Nan::SetPrototypeMethod(tpl, "pollForFrames", PollForFrames);
+    Nan::SetPrototypeMethod(tpl, "waitForFramesAsync", WaitForFramesAsync);
     Nan::SetPrototypeMethod(tpl, "getActiveProfile", GetActiveProfile);
     Nan::SetPrototypeMethod(tpl, "create", Create);
     Nan::SetPrototypeMethod(tpl, "destroy", Destroy);
@@ -3341,6 +3411,23 @@ class RSPipeline : public Nan::ObjectWrap {
     info.GetReturnValue().Set(Nan::False());
   }
 
+  static NAN_METHOD(WaitForFramesAsync) {
+    auto me = Nan::ObjectWrap::Unwrap<RSPipeline>(info.Holder());
+    auto timeout = info[0]->IntegerValue();
+    auto callback = new Nan::Callback(info[1].As<v8::Function>());
+    if (me && me->pipeline_) {
+      Nan::AsyncQueueWorker(new PipelineWaitForFramesWorker(callback,
+          info.Holder(), me->pipeline_, static_cast<unsigned int>(timeout)));
+    } else {
+      v8::Local<v8::Value> argv[1] = {
+        Nan::Error("The pipeline is destroyed")
+      };
+      callback->Call(1, argv);
+      delete callback;
+    }
+    info.GetReturnValue().Set(Nan::Undefined());
+  }
+
   static NAN_METHOD(GetActiveProfile) {
     auto me = Nan::ObjectWrap::Unwrap<RSPipeline>(info.Holder());
     if (me) {
@@ -3826,6 +3913,7 @@ void InitModule(v8::Local<v8::Object> exports) {
   // rs2_timestamp_domain
   _FORCE_SET_ENUM(RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK);
   _FORCE_SET_ENUM(RS2_TIMESTAMP_DOMAIN_SYSTEM_TIME);
+  _FORCE_SET_ENUM(RS2_TIMESTAMP_DOMAIN_GLOBAL_TIME);
   _FORCE_SET_ENUM(RS2_TIMESTAMP_DOMAIN_COUNT);
 
   // rs2_recording_mode
@@ -7,8 +7,53 @@
 #include <opencv2/opencv.hpp>   // Include OpenCV API
 #include <exception>
 
+// Matrices over the data of a frame hold the frame through this allocator, so the data stays valid
+// for as long as any matrix or region of it is alive, and the frame returns to its pool after the last one
+class frame_mat_allocator : public cv::MatAllocator
+{
+public:
+    static frame_mat_allocator& get()
+    {
+        static frame_mat_allocator instance;
+        return instance;
+    }
+
+    // Points the matrix at the data of the frame, the matrix being its first owner
+    void attach(cv::Mat& m, const rs2::frame& f) const
+    {
+        auto u = new cv::UMatData(this);
+        u->data = u->origdata = m.data;
+        u->size = m.total() * m.elemSize();
+        u->handle = new rs2::frame(f);
+        u->refcount = 1;
+        m.allocator = const_cast<frame_mat_allocator*>(this);
+        m.u = u;
+    }
+
+    cv::UMatData* allocate(int dims, const int* sizes, int type, void* data, size_t* step, int flags, cv::UMatUsageFlags usageFlags) const override
+    {
+        // New matrices, such as results of operations, are not backed by frames
+        return cv::Mat::getStdAllocator()->allocate(dims, sizes, type, data, step, flags, usageFlags);
+    }
+
+    bool allocate(cv::UMatData* data, int accessflags, cv::UMatUsageFlags usageFlags) const override
+    {
+        return false;
+    }
+
+    void deallocate(cv::UMatData* u) const override
+    {
+        if (!u) return;
+        delete static_cast<rs2::frame*>(u->handle);
+        u->handle = nullptr;
+        delete u;
+    }
+};
+
 // Convert rs2::frame to cv::Mat
-cv::Mat frame_to_mat(const rs2::frame& f)
+// BGR8, Z16 and Y8 frames are wrapped without copying, the matrix keeps the frame alive
+// RGB8 frames are converted to a new BGR matrix, streaming color in BGR8 avoids the conversion
+inline cv::Mat frame_to_mat(const rs2::frame& f)
 {
     using namespace cv;
     using namespace rs2;
@@ -16,42 +61,54 @@ cv::Mat frame_to_mat(const rs2::frame& f)
     auto vf = f.as<video_frame>();
     const int w = vf.get_width();
     const int h = vf.get_height();
+    const size_t stride = vf.get_stride_in_bytes();
+    auto format = f.get_profile().format();
 
-    if (f.get_profile().format() == RS2_FORMAT_BGR8)
-    {
-        return Mat(Size(w, h), CV_8UC3, (void*)f.get_data(), Mat::AUTO_STEP);
-    }
-    else if (f.get_profile().format() == RS2_FORMAT_RGB8)
+    int type;
+    switch (format)
     {
-        auto r = Mat(Size(w, h), CV_8UC3, (void*)f.get_data(), Mat::AUTO_STEP);
-        cv::cvtColor(r, r, CV_BGR2RGB);
-        return r;
+    case RS2_FORMAT_BGR8: case RS2_FORMAT_RGB8: type = CV_8UC3; break;
+    case RS2_FORMAT_Z16: type = CV_16UC1; break;
+    case RS2_FORMAT_Y8: type = CV_8UC1; break;
+    default: throw std::runtime_error("Frame format is not supported yet!");
     }
-    else if (f.get_profile().format() == RS2_FORMAT_Z16)
-    {
-        return Mat(Size(w, h), CV_16UC1, (void*)f.get_data(), Mat::AUTO_STEP);
-    }
-    else if (f.get_profile().format() == RS2_FORMAT_Y8)
+
+    Mat m(Size(w, h), type, (void*)f.get_data(), stride);
+    if (format == RS2_FORMAT_RGB8)
     {
-        return Mat(Size(w, h), CV_8UC1, (void*)f.get_data(), Mat::AUTO_STEP);;
+        Mat bgr;
+        cvtColor(m, bgr, COLOR_RGB2BGR);
+        return bgr;
     }
+    frame_mat_allocator::get().attach(m, f);
+    return m;
+}
 
-    throw std::runtime_error("Frame format is not supported yet!");
+// Converts a depth frame to distances in meters, into a matrix of doubles that is only allocated
+// when it does not match the frame already, so a matrix kept across frames is reused
+inline void depth_frame_to_meters(const rs2::depth_frame& f, float depth_scale, cv::Mat& meters)
+{
+    cv::Mat dm(cv::Size(f.get_width(), f.get_height()), CV_16UC1, (void*)f.get_data(), f.get_stride_in_bytes());
+    dm.convertTo(meters, CV_64F, depth_scale);
 }
 
 // Converts depth frame to a matrix of doubles with distances in meters
-cv::Mat depth_frame_to_meters(const rs2::pipeline& pipe, const rs2::depth_frame& f)
+inline cv::Mat depth_frame_to_meters(const rs2::pipeline& pipe, const rs2::depth_frame& f)
 {
-    using namespace cv;
     using namespace rs2;
 
-    Mat dm = frame_to_mat(f);
-    dm.convertTo(dm, CV_64F);
     auto depth_scale = pipe.get_active_profile()
         .get_device()
         .first<depth_sensor>()
         .get_depth_scale();
-    dm = dm * depth_scale;
-    return dm;
+    cv::Mat meters;
+    depth_frame_to_meters(f, depth_scale, meters);
+    return meters;
+}
+
+// Copies the frame into a matrix that can live on the GPU with OpenCL, reusing its memory when it matches the frame
+inline void frame_to_umat(const rs2::frame& f, cv::UMat& out)
+{
+    frame_to_mat(f).copyTo(out);
 }
 
@@ -28,8 +28,13 @@ int main(int argc, char** argv) try
                                "MobileNetSSD_deploy.caffemodel");
 
     // Start streaming from Intel RealSense Camera
+    // Color is streamed in BGR, the order OpenCV expects, so frames are used without conversion
     pipeline pipe;
-    auto config = pipe.start();
+    rs2::config cfg;
+    cfg.enable_stream(RS2_STREAM_COLOR, RS2_FORMAT_BGR8);
+    cfg.enable_stream(RS2_STREAM_DEPTH);
+    auto config = pipe.start(cfg);
+    auto depth_scale = config.get_device().first<depth_sensor>().get_depth_scale();
     auto profile = config.get_stream(RS2_STREAM_COLOR)
                          .as<video_stream_profile>();
     rs2::align align_to(RS2_STREAM_COLOR);
@@ -53,6 +58,8 @@ int main(int argc, char** argv) try
     const auto window_name = "Display Image";
     namedWindow(window_name, WINDOW_AUTOSIZE);
 
+    // Kept across frames, so the conversion to meters does not allocate each time
+    Mat depth_meters;
     while (cvGetWindowHandle(window_name))
     {
         // Wait for the next set of frames
@@ -71,7 +78,8 @@ int main(int argc, char** argv) try
 
         // Convert RealSense frame to OpenCV matrix:
         auto color_mat = frame_to_mat(color_frame);
-        auto depth_mat = depth_frame_to_meters(pipe, depth_frame);
+        depth_frame_to_meters(depth_frame, depth_scale, depth_meters);
+        auto depth_mat = depth_meters;
 
         Mat inputBlob = blobFromImage(color_mat, inScaleFactor,
                                       Size(inWidth, inHeight), meanVal, false); //Convert Mat to batch of images
@@ -0,0 +1,113 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2015-2017 Intel Corporation. All Rights Reserved.
+
+#pragma once
+
+#include <librealsense2/rs.hpp>
+
+#include <pcl/point_types.h>
+#include <pcl/point_cloud.h>
+#include <Eigen/Core>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace rs2
+{
+    namespace pcl_support
+    {
+        // Vertices of other formats are kept in fewer bits, the pointcloud block has to produce float vertices
+        inline void check_vertex_format(const rs2::points& points)
+        {
+            if (points.get_vertex_format() != RS2_FORMAT_XYZ32F)
+                throw std::runtime_error("Points are converted to PCL from 32 bit float vertices only");
+        }
+
+        // View of the vertices of a points frame as the columns of an Eigen matrix, without copying them
+        // The view holds the frame, so the vertices stay valid for as long as it lives
+        class points_view
+        {
+        public:
+            typedef Eigen::Map<const Eigen::Matrix<float, 3, Eigen::Dynamic>> matrix_type;
+
+            explicit points_view(const rs2::points& points)
+                : _points((check_vertex_format(points), points)),
+                  _matrix(reinterpret_cast<const float*>(points.get_vertices()), 3, static_cast<Eigen::DenseIndex>(points.size()))
+            {}
+
+            const matrix_type& matrix() const { return _matrix; }
+            size_t size() const { return _points.size(); }
+            const rs2::points& frame() const { return _points; }
+
+        private:
+            rs2::points _points;
+            matrix_type _matrix;
+        };
+
+        // PCL clouds own their points in 16 byte aligned records, so filling one is a copy. It is done in a single pass
+        // Organized clouds keep the layout of the depth image, compact clouds of only the valid points are a single row
+        template<class PointT>
+        void init_cloud(const rs2::points& points, pcl::PointCloud<PointT>& cloud)
+        {
+            check_vertex_format(points);
+            auto sp = points.get_profile().as<rs2::video_stream_profile>();
+            cloud.width = sp.width();
+            cloud.height = sp.height();
+            cloud.is_dense = false;
+            if (points.size() != cloud.width * cloud.height)
+            {
+                cloud.width = static_cast<uint32_t>(points.size());
+                cloud.height = 1;
+                cloud.is_dense = true;
+            }
+            cloud.points.resize(points.size());
+        }
+
+        inline pcl::PointCloud<pcl::PointXYZ>::Ptr points_to_pcl(const rs2::points& points)
+        {
+            pcl::PointCloud<pcl::PointXYZ>::Ptr cloud(new pcl::PointCloud<pcl::PointXYZ>);
+            init_cloud(points, *cloud);
+
+            auto vertices = points.get_vertices();
+            auto out = cloud->points.data();
+            for (size_t i = 0; i < points.size(); i++)
+            {
+                out[i].getVector4fMap() << vertices[i].x, vertices[i].y, vertices[i].z, 1.f;
+            }
+            return cloud;
+        }
+
+        // Points colored by the pixel of the texture at their texture coordinates, which are clamped to the texture
+        // The texture is expected in RGB8, RGBA8, BGR8 or BGRA8 format, as the color stream is usually configured
+        inline pcl::PointCloud<pcl::PointXYZRGB>::Ptr points_to_pcl(const rs2::points& points, const rs2::video_frame& texture)
+        {
+            auto format = texture.get_profile().format();
+            int channels = format == RS2_FORMAT_RGB8 || format == RS2_FORMAT_BGR8 ? 3 :
+                           format == RS2_FORMAT_RGBA8 || format == RS2_FORMAT_BGRA8 ? 4 : 0;
+            if (!channels)
+                throw std::runtime_error("Points can only be colored from an 8 bit per channel RGB or BGR texture");
+            bool bgr = format == RS2_FORMAT_BGR8 || format == RS2_FORMAT_BGRA8;
+
+            pcl::PointCloud<pcl::PointXYZRGB>::Ptr cloud(new pcl::PointCloud<pcl::PointXYZRGB>);
+            init_cloud(points, *cloud);
+
+            const int width = texture.get_width(), height = texture.get_height(), stride = texture.get_stride_in_bytes();
+            auto pixels = static_cast<const uint8_t*>(texture.get_data());
+            auto vertices = points.get_vertices();
+            auto tex_coords = points.get_texture_coordinates();
+            auto out = cloud->points.data();
+            for (size_t i = 0; i < points.size(); i++)
+            {
+                out[i].getVector4fMap() << vertices[i].x, vertices[i].y, vertices[i].z, 1.f;
+
+                int x = std::min(std::max(static_cast<int>(tex_coords[i].u * width + .5f), 0), width - 1);
+                int y = std::min(std::max(static_cast<int>(tex_coords[i].v * height + .5f), 0), height - 1);
+                auto p = pixels + y * stride + x * channels;
+                out[i].r = p[bgr ? 2 : 0];
+                out[i].g = p[1];
+                out[i].b = p[bgr ? 0 : 2];
+            }
+            return cloud;
+        }
+    }
+}
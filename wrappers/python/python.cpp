@@ -15,6 +15,10 @@
 #include "../include/librealsense2/rs.h"
 #include "../include/librealsense2/rs.hpp"
 #include "../include/librealsense2/rs_advanced_mode.hpp"
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
 #define NAME pyrealsense2
 #define SNAME "pyrealsense2"
 #define BIND_RAW_ARRAY(class, name, type, size) #name, [](const class &c) -> const std::array<type, size>& { return reinterpret_cast<const std::array<type, size>&>(c.name); }
@@ -26,6 +30,160 @@
 namespace py = pybind11;
 using namespace pybind11::literals;
 
+// Copy of a frame, owned by a capture slot
+struct captured_frame
+{
+    std::vector<uint8_t> data;
+    rs2_format format = RS2_FORMAT_ANY;
+    int width = 0, height = 0, stride = 0, bpp = 0;
+    double timestamp = 0;
+    unsigned long long number = 0;
+};
+
+// Frames of one frameset, copied out of the library so that the frames themselves are released right away
+struct capture_slot
+{
+    unsigned long long sequence = 0;
+    std::map<std::pair<rs2_stream, int>, captured_frame> frames;
+
+    const captured_frame& get(rs2_stream stream, int index) const
+    {
+        auto it = frames.find({ stream, index });
+        if (it == frames.end())
+            throw std::runtime_error("The slot holds no frame of the requested stream");
+        return it->second;
+    }
+};
+
+// Pulls framesets from a started pipeline on a native thread, without the GIL, and copies them into a ring of slots
+// Slots still referenced from Python are never written, the ring replaces them with new slots instead
+class capture_ring
+{
+public:
+    capture_ring(rs2::pipeline pipe, size_t capacity)
+        : _pipe(pipe), _slots(std::max<size_t>(capacity, 1)), _written(0), _read(0), _dropped(0), _running(false)
+    {}
+
+    ~capture_ring() { stop(); }
+
+    void start()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_running)
+            return;
+        _running = true;
+        _thread = std::thread([this]() { run(); });
+    }
+
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (!_running)
+                return;
+            _running = false;
+        }
+        _cv.notify_all();
+        _thread.join();
+    }
+
+    // Latest slot not returned yet, older slots not read are dropped
+    std::shared_ptr<capture_slot> poll()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return take_latest();
+    }
+
+    std::shared_ptr<capture_slot> wait(unsigned int timeout_ms)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        if (!_cv.wait_for(lock, std::chrono::milliseconds(timeout_ms), [&]() { return _written > _read || !_running; }) || _written == _read)
+            throw std::runtime_error("Capture ring did not receive frames in time");
+        return take_latest();
+    }
+
+    unsigned long long get_dropped() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _dropped;
+    }
+
+private:
+    std::shared_ptr<capture_slot> take_latest()
+    {
+        if (_written == _read)
+            return nullptr;
+        _dropped += _written - _read - 1;
+        _read = _written;
+        return _slots[(_written - 1) % _slots.size()];
+    }
+
+    void run()
+    {
+        while (true)
+        {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (!_running)
+                    return;
+            }
+
+            // Short waits so that stop does not wait for a frame
+            rs2::frameset fs;
+            try
+            {
+                fs = _pipe.wait_for_frames(100);
+            }
+            catch (...)
+            {
+                continue;
+            }
+
+            std::shared_ptr<capture_slot> slot;
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                auto&& current = _slots[_written % _slots.size()];
+                if (!current || current.use_count() > 1)
+                    current = std::make_shared<capture_slot>();
+                slot = current;
+            }
+
+            // The slot is filled outside the lock, it is published only once filled
+            for (auto&& f : fs)
+            {
+                auto profile = f.get_profile();
+                auto&& copy = slot->frames[{ profile.stream_type(), profile.stream_index() }];
+                auto data = static_cast<const uint8_t*>(f.get_data());
+                copy.data.assign(data, data + f.get_data_size());
+                copy.format = profile.format();
+                copy.timestamp = f.get_timestamp();
+                copy.number = f.get_frame_number();
+                if (auto vf = f.as<rs2::video_frame>())
+                {
+                    copy.width = vf.get_width();
+                    copy.height = vf.get_height();
+                    copy.stride = vf.get_stride_in_bytes();
+                    copy.bpp = vf.get_bytes_per_pixel();
+                }
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                slot->sequence = ++_written;
+            }
+            _cv.notify_all();
+        }
+    }
+
+    rs2::pipeline _pipe;
+    std::vector<std::shared_ptr<capture_slot>> _slots;
+    unsigned long long _written, _read, _dropped;
+    bool _running;
+    mutable std::mutex _mutex;
+    std::condition_variable _cv;
+    std::thread _thread;
+};
+
 PYBIND11_PLUGIN(NAME) {
     py::module m(SNAME, "Library for accessing Intel RealSenseTM cameras");
 
@@ -37,13 +195,20 @@ PYBIND11_PLUGIN(NAME) {
         size_t _ndim = 0;             // Number of dimensions
         std::vector<size_t> _shape;   // Shape of the tensor (1 entry per dimension)
         std::vector<size_t> _strides; // Number of entries between adjacent entries (for each per dimension)
+        std::shared_ptr<void> _owner; // Keeps the storage alive for as long as the buffer, and the arrays viewing it, exist
     public:
         BufData(void *ptr, size_t itemsize, const std::string& format, size_t ndim, const std::vector<size_t> &shape, const std::vector<size_t> &strides)
             : _ptr(ptr), _itemsize(itemsize), _format(format), _ndim(ndim), _shape(shape), _strides(strides) {}
         BufData(void *ptr, size_t itemsize, const std::string &format, size_t size)
             : BufData(ptr, itemsize, format, 1, std::vector<size_t> { size }, std::vector<size_t> { itemsize }) { }
+
+        BufData& owned_by(std::shared_ptr<void> owner) { _owner = std::move(owner); return *this; }
     };
 
+    // The buffer holds its own reference of the frame, so views of it stay valid after the callback returns
+    // and after the Python frame object is gone, without copying the data
+    auto frame_owner = [](const rs2::frame& f) { return std::static_pointer_cast<void>(std::make_shared<rs2::frame>(f)); };
+
     py::class_<BufData> BufData_py(m, "BufData", py::buffer_protocol());
     BufData_py.def_buffer([](BufData& self)
     { return py::buffer_info(
@@ -144,6 +309,7 @@ PYBIND11_PLUGIN(NAME) {
                          .value("frame_corrupted", rs2_notification_category::RS2_NOTIFICATION_CATEGORY_FRAME_CORRUPTED)
                          .value("hardware_error", rs2_notification_category::RS2_NOTIFICATION_CATEGORY_HARDWARE_ERROR)
                          .value("unknown_error", rs2_notification_category::RS2_NOTIFICATION_CATEGORY_UNKNOWN_ERROR)
+                         .value("frames_lost", rs2_notification_category::RS2_NOTIFICATION_CATEGORY_FRAMES_LOST)
                          .value("count", rs2_notification_category::RS2_NOTIFICATION_CATEGORY_COUNT);
 
     py::enum_<rs2_log_severity> log_severity(m, "log_severity");
@@ -201,6 +367,7 @@ PYBIND11_PLUGIN(NAME) {
     py::enum_<rs2_timestamp_domain> ts_domain(m, "timestamp_domain");
     ts_domain.value("hardware_clock", RS2_TIMESTAMP_DOMAIN_HARDWARE_CLOCK)
              .value("system_time", RS2_TIMESTAMP_DOMAIN_SYSTEM_TIME)
+             .value("global_time", RS2_TIMESTAMP_DOMAIN_GLOBAL_TIME)
              .value("count", RS2_TIMESTAMP_DOMAIN_COUNT);
 
     py::enum_<rs2_distortion> distortion(m, "distortion");
@@ -239,8 +406,10 @@ PYBIND11_PLUGIN(NAME) {
     /* rs2_context.hpp */
     py::class_<rs2::context> context(m, "context");
     context.def(py::init<>())
-           .def("query_devices", &rs2::context::query_devices, "Create a static"
+           .def("query_devices", (rs2::device_list(rs2::context::*)() const) &rs2::context::query_devices, "Create a static"
                 " snapshot of all connected devices a the time of the call.")
+           .def("query_devices", (rs2::device_list(rs2::context::*)(bool) const) &rs2::context::query_devices, "Create a static"
+                " snapshot of the connected devices, enumerating only their video interfaces when lightweight is set.", "lightweight"_a)
            .def("query_all_sensors", &rs2::context::query_all_sensors, "Generate a flat list of "
                 "all available sensors from all RealSense devices.")
            .def("get_sensor_parent", &rs2::context::get_sensor_parent, "s"_a)
@@ -319,6 +488,16 @@ PYBIND11_PLUGIN(NAME) {
                           "list of all newly connected devices");
 
     /* rs2_frame.hpp */
+    py::class_<rs2_frame_view> frame_view(m, "frame_view");
+    frame_view.def_readonly("data_size", &rs2_frame_view::data_size)
+              .def_readonly("width", &rs2_frame_view::width)
+              .def_readonly("height", &rs2_frame_view::height)
+              .def_readonly("stride", &rs2_frame_view::stride)
+              .def_readonly("bits_per_pixel", &rs2_frame_view::bits_per_pixel)
+              .def_readonly("number", &rs2_frame_view::number)
+              .def_readonly("timestamp", &rs2_frame_view::timestamp)
+              .def_readonly("timestamp_domain", &rs2_frame_view::timestamp_domain);
+
     py::class_<rs2::frame> frame(m, "frame");
     frame.def(py::init<>())
 //         .def(py::self = py::self) // can't overload assignment in python
@@ -332,8 +511,12 @@ PYBIND11_PLUGIN(NAME) {
               "of a single frame_metadata.", "frame_metadata"_a)
          .def("supports_frame_metadata", &rs2::frame::supports_frame_metadata, "Determine if the device "
               "allows a specific metadata to be queried.", "frame_metadata"_a)
+         .def("get_frame_metadata_all", &rs2::frame::get_frame_metadata_all, "Retrieve the values of all the "
+              "frame_metadata the frame has.")
+         .def("get_view", &rs2::frame::get_view, "Retrieve the size, dimensions, number and timestamp "
+              "of the frame in one call.")
          .def("get_frame_number", &rs2::frame::get_frame_number, "Retrieve the frame number.")
-         .def("get_data", [](const rs2::frame& self) ->  BufData
+         .def("get_data", [frame_owner](const rs2::frame& self) ->  BufData
               {
                   if (auto vf = self.as<rs2::video_frame>()) {
                       std::map<size_t,std::string> bytes_per_pixel_to_format = {{1, std::string("@B")}, {2, std::string("@H")}, {3, std::string("@I")}, {4, std::string("@I")}};
@@ -341,21 +524,19 @@ PYBIND11_PLUGIN(NAME) {
                         case RS2_FORMAT_RGB8: case RS2_FORMAT_BGR8:
                           return BufData(const_cast<void*>(vf.get_data()), 1, bytes_per_pixel_to_format[1], 3,
                                          { static_cast<size_t>(vf.get_height()), static_cast<size_t>(vf.get_width()), 3 },
-                                         { static_cast<size_t>(vf.get_stride_in_bytes()), static_cast<size_t>(vf.get_bytes_per_pixel()), 1 });
-                          break;
+                                         { static_cast<size_t>(vf.get_stride_in_bytes()), static_cast<size_t>(vf.get_bytes_per_pixel()), 1 }).owned_by(frame_owner(self));
                         case RS2_FORMAT_RGBA8: case RS2_FORMAT_BGRA8:
                           return BufData(const_cast<void*>(vf.get_data()), 1, bytes_per_pixel_to_format[1], 3,
                                          { static_cast<size_t>(vf.get_height()), static_cast<size_t>(vf.get_width()), 4 },
-                                         { static_cast<size_t>(vf.get_stride_in_bytes()), static_cast<size_t>(vf.get_bytes_per_pixel()), 1 });
-                          break;
+                                         { static_cast<size_t>(vf.get_stride_in_bytes()), static_cast<size_t>(vf.get_bytes_per_pixel()), 1 }).owned_by(frame_owner(self));
                         default:
                           return BufData(const_cast<void*>(vf.get_data()), static_cast<size_t>(vf.get_bytes_per_pixel()), bytes_per_pixel_to_format[vf.get_bytes_per_pixel()], 2,
                                          { static_cast<size_t>(vf.get_height()), static_cast<size_t>(vf.get_width()) },
-                                         { static_cast<size_t>(vf.get_stride_in_bytes()), static_cast<size_t>(vf.get_bytes_per_pixel()) });
+                                         { static_cast<size_t>(vf.get_stride_in_bytes()), static_cast<size_t>(vf.get_bytes_per_pixel()) }).owned_by(frame_owner(self));
                       }
                   } else
-                      return BufData(const_cast<void*>(self.get_data()), 1, std::string("@B"), 0); },
-              "retrieve data from the frame handle.", py::keep_alive<0, 1>())
+                      return BufData(const_cast<void*>(self.get_data()), 1, std::string("@B"), static_cast<size_t>(self.get_data_size())).owned_by(frame_owner(self)); },
+              "Retrieve data from the frame handle, without copying it. The buffer keeps the frame alive.")
          .def("get_profile", &rs2::frame::get_profile)
          .def(BIND_DOWNCAST(frame, frame))
          .def(BIND_DOWNCAST(frame, points))
@@ -393,16 +574,16 @@ PYBIND11_PLUGIN(NAME) {
     py::class_<rs2::points, rs2::frame> points(m, "points");
     points.def(py::init<>())
           .def(py::init<rs2::frame>())
-          .def("get_vertices", [](rs2::points& self) -> BufData
+          .def("get_vertices", [frame_owner](rs2::points& self) -> BufData
                {
                    return BufData(const_cast<rs2::vertex*>(self.get_vertices()),
-                                          sizeof(rs2::vertex), std::string("@fff"), self.size());
-               }, py::keep_alive<0, 1>())
-          .def("get_texture_coordinates", [](rs2::points& self) -> BufData
+                                          sizeof(rs2::vertex), std::string("@fff"), self.size()).owned_by(frame_owner(self));
+               })
+          .def("get_texture_coordinates", [frame_owner](rs2::points& self) -> BufData
                {
                    return BufData(const_cast<rs2::texture_coordinate*>(self.get_texture_coordinates()),
-                                          sizeof(rs2::texture_coordinate), std::string("@ff"), self.size());
-               }, py::keep_alive<0, 1>())
+                                          sizeof(rs2::texture_coordinate), std::string("@ff"), self.size()).owned_by(frame_owner(self));
+               })
           .def("size", &rs2::points::size);
 
     py::class_<rs2::frameset, rs2::frame> frameset(m, "composite_frame");
@@ -446,7 +627,8 @@ PYBIND11_PLUGIN(NAME) {
                             {
                                 self.start(f);
                             }, "callback"_a)
-                    .def("invoke", &rs2::processing_block::invoke, "f"_a)
+                    .def("invoke", [](const rs2::processing_block& self, rs2::frame f)
+                         { py::gil_scoped_release lock; self.invoke(f); }, "f"_a)
                     /*.def("__call__", &rs2::processing_block::operator(), "f"_a)*/;
 
     // Not binding syncer_processing_block, not in Python API
@@ -456,10 +638,11 @@ PYBIND11_PLUGIN(NAME) {
                     "cross-platform synchronization primitive provided by librealsense to help "
                     "developers who are not using async APIs.")
                .def(py::init<>())
-        .def("wait_for_frame", [](const rs2::frame_queue& self, unsigned int timeout_ms) { py::gil_scoped_release(); self.wait_for_frame(timeout_ms); }, "Wait until a new frame "
+        .def("wait_for_frame", [](const rs2::frame_queue& self, unsigned int timeout_ms) { py::gil_scoped_release lock; return self.wait_for_frame(timeout_ms); }, "Wait until a new frame "
                     "becomes available in the queue and dequeue it.", "timeout_ms"_a=5000)
                .def("poll_for_frame", [](const rs2::frame_queue &self)
                     {
+                        py::gil_scoped_release lock;
                         rs2::frame frame;
                         self.poll_for_frame(&frame);
                         return frame;
@@ -471,6 +654,9 @@ PYBIND11_PLUGIN(NAME) {
     options.def("is_option_read_only", &rs2::options::is_option_read_only, "Check if particular option "
         "is read only.", "option"_a)
         .def("get_option", &rs2::options::get_option, "Read option value from the device.", "option"_a)
+        .def("get_option_from_device", &rs2::options::get_option_from_device, "Read option value from the device, bypassing the option cache.", "option"_a)
+        .def("get_options", &rs2::options::get_options, "Read the values of several options in one call.", "options"_a)
+        .def("set_options", &rs2::options::set_options, "Write the values of several options in one call, in the given order.", "values"_a)
         .def("get_option_range", &rs2::options::get_option_range, "Retrieve the available range of values "
             "of a supported option", "option"_a)
         .def("set_option", &rs2::options::set_option, "Write new value to device option", "option"_a, "value"_a)
@@ -482,15 +668,16 @@ PYBIND11_PLUGIN(NAME) {
 
     py::class_<rs2::pointcloud> pointcloud(m, "pointcloud");
     pointcloud.def(py::init<>())
-        .def("calculate", &rs2::pointcloud::calculate, "depth"_a)
-        .def("map_to", &rs2::pointcloud::map_to, "mapped"_a);
+        .def("calculate", [](rs2::pointcloud& self, rs2::frame depth) { py::gil_scoped_release lock; return self.calculate(depth); }, "depth"_a)
+        .def("map_to", [](rs2::pointcloud& self, rs2::frame mapped) { py::gil_scoped_release lock; self.map_to(mapped); }, "mapped"_a);
 
     py::class_<rs2::syncer> syncer(m, "syncer");
     syncer.def(py::init<>())
-          .def("wait_for_frames", &rs2::syncer::wait_for_frames, "Wait until a coherent set "
-               "of frames becomes available", "timeout_ms"_a = 5000)
+          .def("wait_for_frames", [](const rs2::syncer& self, unsigned int timeout_ms) { py::gil_scoped_release lock; return self.wait_for_frames(timeout_ms); },
+               "Wait until a coherent set of frames becomes available", "timeout_ms"_a = 5000)
           .def("poll_for_frames", [](const rs2::syncer &self)
                {
+                   py::gil_scoped_release lock;
                    rs2::frameset frames;
                    self.poll_for_frames(&frames);
                    return frames;
@@ -499,12 +686,12 @@ PYBIND11_PLUGIN(NAME) {
 
     py::class_<rs2::colorizer, rs2::options> colorizer(m, "colorizer");
     colorizer.def(py::init<>())
-             .def("colorize", &rs2::colorizer::colorize, "depth"_a)
+             .def("colorize", [](const rs2::colorizer& self, rs2::frame depth) { py::gil_scoped_release lock; return self.colorize(depth); }, "depth"_a)
              /*.def("__call__", &rs2::colorizer::operator())*/;
 
     py::class_<rs2::align> align(m, "align");
     align.def(py::init<rs2_stream>(), "align_to"_a)
-        .def("proccess", &rs2::align::proccess, "depth"_a);
+        .def("proccess", [](rs2::align& self, rs2::frameset frames) { py::gil_scoped_release lock; return self.proccess(frames); }, "depth"_a);
 
     /* rs2_record_playback.hpp */
     py::class_<rs2::playback, rs2::device> playback(m, "playback");
@@ -517,6 +704,14 @@ PYBIND11_PLUGIN(NAME) {
             .def("seek", &rs2::playback::seek, "time"_a)
             .def("is_real_time", &rs2::playback::is_real_time)
             .def("set_real_time", &rs2::playback::set_real_time, "real_time"_a)
+            .def("is_batch_mode", &rs2::playback::is_batch_mode)
+            .def("set_batch_mode", &rs2::playback::set_batch_mode, "batch"_a)
+            .def("next_frameset", [](const rs2::playback &self)
+                 {
+                     rs2::frameset frames;
+                     self.next_frameset(&frames);
+                     return frames;
+                 }, "Read the next set of frames of the opened streams, an empty set at the end of the file")
             .def("set_status_changed_callback", [](rs2::playback& self, std::function<void(rs2_playback_status)> callback)
                  { self.set_status_changed_callback(callback); }, "callback"_a)
             .def("current_status", &rs2::playback::current_status);
@@ -526,6 +721,77 @@ PYBIND11_PLUGIN(NAME) {
             .def("pause", &rs2::recorder::pause)
             .def("resume", &rs2::recorder::resume);
 
+    py::class_<rs2_dataset_stream> dataset_stream(m, "dataset_stream");
+    dataset_stream.def_readonly("stream", &rs2_dataset_stream::stream)
+                  .def_readonly("index", &rs2_dataset_stream::index)
+                  .def_readonly("format", &rs2_dataset_stream::format)
+                  .def_readonly("width", &rs2_dataset_stream::width)
+                  .def_readonly("height", &rs2_dataset_stream::height)
+                  .def_readonly("bytes_per_pixel", &rs2_dataset_stream::bytes_per_pixel);
+
+    // The arrays of a batch keep their own copy of it, which shares its buffers, so they outlive the Python batch
+    auto batch_owner = [](const rs2::dataset_batch& b) { return std::static_pointer_cast<void>(std::make_shared<rs2::dataset_batch>(b)); };
+
+    py::class_<rs2::dataset_batch> dataset_batch(m, "dataset_batch");
+    dataset_batch.def("size", &rs2::dataset_batch::size)
+                 .def("__len__", &rs2::dataset_batch::size)
+                 .def("__nonzero__", &rs2::dataset_batch::operator bool)
+                 .def("get_stream_count", &rs2::dataset_batch::get_stream_count)
+                 .def("get_stream", &rs2::dataset_batch::get_stream, "i"_a)
+                 .def("get_file", &rs2::dataset_batch::get_file, "Index of the recording a sample was read from", "sample"_a)
+                 .def("get_data", [batch_owner](const rs2::dataset_batch& self, int i) -> BufData
+                      {
+                          auto s = self.get_stream(i);
+                          auto n = static_cast<size_t>(self.size()), h = static_cast<size_t>(s.height), w = static_cast<size_t>(s.width);
+                          auto bpp = static_cast<size_t>(s.bytes_per_pixel);
+                          std::map<size_t, std::string> bytes_per_pixel_to_format = { { 1, std::string("@B") }, { 2, std::string("@H") }, { 4, std::string("@I") } };
+                          auto color = s.format == RS2_FORMAT_RGB8 || s.format == RS2_FORMAT_BGR8 || s.format == RS2_FORMAT_RGBA8 || s.format == RS2_FORMAT_BGRA8;
+                          if (color || !bytes_per_pixel_to_format.count(bpp))
+                              return BufData(const_cast<void*>(s.data), 1, std::string("@B"), 4, { n, h, w, bpp },
+                                             { h * w * bpp, w * bpp, bpp, 1 }).owned_by(batch_owner(self));
+                          return BufData(const_cast<void*>(s.data), bpp, bytes_per_pixel_to_format[bpp], 3, { n, h, w },
+                                         { h * w * bpp, w * bpp, bpp }).owned_by(batch_owner(self));
+                      }, "Retrieve the frames of a stream as one contiguous array of the samples, without copying them. The buffer keeps the batch alive.", "i"_a)
+                 .def("get_timestamps", [batch_owner](const rs2::dataset_batch& self, int i) -> BufData
+                      {
+                          auto s = self.get_stream(i);
+                          return BufData(const_cast<double*>(s.timestamps), sizeof(double), std::string("@d"), static_cast<size_t>(self.size())).owned_by(batch_owner(self));
+                      }, "Retrieve the timestamps of the frames of a stream, in milliseconds", "i"_a)
+                 .def("get_frame_numbers", [batch_owner](const rs2::dataset_batch& self, int i) -> BufData
+                      {
+                          auto s = self.get_stream(i);
+                          return BufData(const_cast<unsigned long long*>(s.frame_numbers), sizeof(unsigned long long), std::string("@Q"), static_cast<size_t>(self.size())).owned_by(batch_owner(self));
+                      }, "Retrieve the frame numbers of the frames of a stream", "i"_a);
+
+    // Batches are decoded in the background, waiting for the next one releases the GIL for the training loop threads
+    auto next_dataset_batch = [](const rs2::dataset_reader& self)
+    {
+        rs2::dataset_batch batch;
+        {
+            py::gil_scoped_release lock;
+            batch = self.next_batch();
+        }
+        if (!batch)
+            throw py::stop_iteration();
+        return batch;
+    };
+
+    py::class_<rs2::dataset_reader> dataset_reader(m, "dataset_reader");
+    dataset_reader.def("__init__", [](rs2::dataset_reader& self, const rs2::context& ctx, const std::vector<std::string>& files,
+                                      const std::vector<std::pair<rs2_stream, int>>& streams, int batch_size, int threads,
+                                      int prefetch, rs2_stream align_to, int decimation, bool pinned)
+                       {
+                           rs2_dataset_config config{ batch_size, threads, prefetch, align_to, decimation, pinned ? 1 : 0 };
+                           new (&self) rs2::dataset_reader(ctx, files, streams, config);
+                       }, "Read batches of samples from recordings, with the streams given as (stream, index) pairs, -1 for any index. "
+                       "Zero settings take the defaults", "ctx"_a, "files"_a, "streams"_a, "batch_size"_a = 0, "threads"_a = 0,
+                       "prefetch"_a = 0, "align_to"_a = RS2_STREAM_ANY, "decimation"_a = 0, "pinned"_a = false)
+                  .def("next_batch", [](const rs2::dataset_reader& self) { py::gil_scoped_release lock; return self.next_batch(); },
+                       "Wait for the next batch of samples, an empty batch at the end of the recordings")
+                  .def("__iter__", [](rs2::dataset_reader& self) -> rs2::dataset_reader& { return self; }, py::return_value_policy::reference_internal)
+                  .def("__next__", next_dataset_batch)
+                  .def("next", next_dataset_batch);
+
     /* rs2_sensor.hpp */
     py::class_<rs2::stream_profile> stream_profile(m, "stream_profile");
     stream_profile.def(py::init<>())
@@ -601,9 +867,9 @@ PYBIND11_PLUGIN(NAME) {
                "more stream profiles.", "profiles"_a)
           .def("close", [](const rs2::sensor& self){ py::gil_scoped_release lock; self.close(); }, "Close sensor for exclusive access.")
           .def("start", [](const rs2::sensor& self, std::function<void(rs2::frame)> callback)
-               { self.start(callback); }, "Start passing frames into user provided callback.", "callback"_a)
-          .def("start", [](const rs2::sensor& self, rs2::frame_queue& queue) { self.start(queue); })
-          .def("stop", &rs2::sensor::stop, "Stop streaming.")
+               { py::gil_scoped_release lock; self.start(callback); }, "Start passing frames into user provided callback.", "callback"_a)
+          .def("start", [](const rs2::sensor& self, rs2::frame_queue& queue) { py::gil_scoped_release lock; self.start(queue); })
+          .def("stop", [](const rs2::sensor& self) { py::gil_scoped_release lock; self.stop(); }, "Stop streaming.")
           .def("get_stream_profiles", &rs2::sensor::get_stream_profiles, "Check if physical sensor is supported.")
           .def("get_motion_intrinsics", &rs2::sensor::get_motion_intrinsics, "Returns scale and bias of a motion stream.",
                "stream"_a)
@@ -629,13 +895,66 @@ PYBIND11_PLUGIN(NAME) {
 
     py::class_<rs2::pipeline> pipeline(m, "pipeline");
     pipeline.def(py::init<rs2::context>(), "ctx"_a = rs2::context())
-    .def("start", (rs2::pipeline_profile (rs2::pipeline::*)(const rs2::config&)) &rs2::pipeline::start, "config")
-    .def("start", (rs2::pipeline_profile (rs2::pipeline::*)() ) &rs2::pipeline::start)
-    .def("stop", &rs2::pipeline::stop)
-    .def("wait_for_frames", &rs2::pipeline::wait_for_frames, "timeout_ms"_a = 5000)
-    .def("poll_for_frames", &rs2::pipeline::poll_for_frames, "frameset*"_a)
+    .def("start", [](rs2::pipeline& self, const rs2::config& config) { py::gil_scoped_release lock; return self.start(config); }, "config")
+    .def("start", [](rs2::pipeline& self) { py::gil_scoped_release lock; return self.start(); })
+    .def("stop", [](rs2::pipeline& self) { py::gil_scoped_release lock; self.stop(); })
+    .def("wait_for_frames", [](const rs2::pipeline& self, unsigned int timeout_ms) { py::gil_scoped_release lock; return self.wait_for_frames(timeout_ms); }, "timeout_ms"_a = 5000)
+    .def("poll_for_frames", [](const rs2::pipeline& self)
+         {
+             py::gil_scoped_release lock;
+             rs2::frameset frames;
+             self.poll_for_frames(&frames);
+             return frames;
+         }, "Check if a new set of frames is available")
     .def("get_active_profile", &rs2::pipeline::get_active_profile);
 
+    py::class_<capture_slot, std::shared_ptr<capture_slot>> capture_slot_py(m, "capture_slot");
+    capture_slot_py.def_readonly("sequence", &capture_slot::sequence)
+        .def("get_streams", [](const capture_slot& self)
+             {
+                 std::vector<std::pair<rs2_stream, int>> streams;
+                 for (auto&& f : self.frames)
+                     streams.push_back(f.first);
+                 return streams;
+             }, "List the (stream, index) pairs of the frames in the slot.")
+        .def("get_timestamp", [](const capture_slot& self, rs2_stream stream, int index) { return self.get(stream, index).timestamp; },
+             "stream"_a, "index"_a = 0)
+        .def("get_frame_number", [](const capture_slot& self, rs2_stream stream, int index) { return self.get(stream, index).number; },
+             "stream"_a, "index"_a = 0)
+        .def("get_data", [](std::shared_ptr<capture_slot> self, rs2_stream stream, int index) -> BufData
+             {
+                 auto&& f = self->get(stream, index);
+                 auto ptr = const_cast<uint8_t*>(f.data.data());
+                 std::map<size_t, std::string> bytes_per_pixel_to_format = { { 1, std::string("@B") },{ 2, std::string("@H") },{ 3, std::string("@I") },{ 4, std::string("@I") } };
+                 if (f.bpp == 0 || bytes_per_pixel_to_format.find(f.bpp) == bytes_per_pixel_to_format.end())
+                     return BufData(ptr, 1, std::string("@B"), f.data.size()).owned_by(self);
+                 switch (f.format) {
+                 case RS2_FORMAT_RGB8: case RS2_FORMAT_BGR8:
+                     return BufData(ptr, 1, bytes_per_pixel_to_format[1], 3,
+                                    { static_cast<size_t>(f.height), static_cast<size_t>(f.width), 3 },
+                                    { static_cast<size_t>(f.stride), static_cast<size_t>(f.bpp), 1 }).owned_by(self);
+                 case RS2_FORMAT_RGBA8: case RS2_FORMAT_BGRA8:
+                     return BufData(ptr, 1, bytes_per_pixel_to_format[1], 3,
+                                    { static_cast<size_t>(f.height), static_cast<size_t>(f.width), 4 },
+                                    { static_cast<size_t>(f.stride), static_cast<size_t>(f.bpp), 1 }).owned_by(self);
+                 default:
+                     return BufData(ptr, static_cast<size_t>(f.bpp), bytes_per_pixel_to_format[f.bpp], 2,
+                                    { static_cast<size_t>(f.height), static_cast<size_t>(f.width) },
+                                    { static_cast<size_t>(f.stride), static_cast<size_t>(f.bpp) }).owned_by(self);
+                 }
+             }, "Retrieve the copied data of a frame in the slot, the slot is never written while referenced.",
+             "stream"_a, "index"_a = 0);
+
+    py::class_<capture_ring> capture_ring_py(m, "capture_ring", "Copies the framesets of a started pipeline into a ring of slots "
+                                             "on a native thread, so capture does not wait for the Python interpreter.");
+    capture_ring_py.def(py::init<rs2::pipeline, size_t>(), "pipe"_a, "capacity"_a = 4)
+        .def("start", &capture_ring::start, "Start copying framesets.")
+        .def("stop", [](capture_ring& self) { py::gil_scoped_release lock; self.stop(); }, "Stop copying framesets.")
+        .def("wait_for_slot", [](capture_ring& self, unsigned int timeout_ms) { py::gil_scoped_release lock; return self.wait(timeout_ms); },
+             "Wait for a slot not returned yet and return the latest one.", "timeout_ms"_a = 5000)
+        .def("poll_for_slot", &capture_ring::poll, "Return the latest slot not returned yet, or None.")
+        .def("get_dropped_count", &capture_ring::get_dropped, "Number of slots overwritten before being read.");
+
     struct pipeline_wrapper //Workaround to allow python implicit conversion of pipeline to std::shared_ptr<rs2_pipeline>
     {
         std::shared_ptr<rs2_pipeline> _ptr;
@@ -664,7 +983,7 @@ PYBIND11_PLUGIN(NAME) {
             .def("enable_all_streams", &rs2::config::enable_all_streams)
             .def("enable_device", &rs2::config::enable_device, "serial"_a)
             .def("enable_device_from_file", &rs2::config::enable_device_from_file, "file_name"_a)
-            .def("enable_record_to_file", &rs2::config::enable_record_to_file, "file_name"_a)
+            .def("enable_record_to_file", (void (rs2::config::*)(const std::string&)) &rs2::config::enable_record_to_file, "file_name"_a)
             .def("disable_stream", &rs2::config::disable_stream, "stream"_a, "index"_a = -1)
             .def("disable_all_streams", &rs2::config::disable_all_streams)
             .def("resolve", [](rs2::config* c, pipeline_wrapper pw) -> rs2::pipeline_profile { return c->resolve(pw._ptr); })